@@ -0,0 +1,134 @@
+#include "common.hpp"
+
+#include <vector>
+
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+#include <daxa/utils/pipeline_manager.hpp>
+#endif
+
+namespace benchmarks
+{
+    constexpr u32 COMMANDS_PER_LIST = 10'000;
+
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+    struct RecordingPipelines
+    {
+        daxa::PipelineManager pipeline_manager = {};
+        std::shared_ptr<daxa::ComputePipeline> compute = {};
+        std::shared_ptr<daxa::RasterPipeline> raster = {};
+        daxa::ImageId color_target = {};
+    };
+
+    // The commands are only recorded, never submitted, so the shaders do nothing.
+    auto recording_pipelines() -> RecordingPipelines &
+    {
+        static RecordingPipelines pipelines = []()
+        {
+            RecordingPipelines ret = {};
+            ret.pipeline_manager = daxa::PipelineManager({
+                .device = device(),
+                .shader_compile_options = {.language = daxa::ShaderLanguage::GLSL},
+                .name = "benchmark pipeline manager",
+            });
+            ret.compute = ret.pipeline_manager.add_compute_pipeline({
+                .shader_info = {.source = daxa::ShaderCode{"layout(local_size_x = 1) in;\nvoid main() {}\n"}},
+                .name = "benchmark dispatch",
+            }).value();
+            ret.raster = ret.pipeline_manager.add_raster_pipeline({
+                .vertex_shader_info = daxa::ShaderCompileInfo{.source = daxa::ShaderCode{"void main() { gl_Position = vec4(0.0); }\n"}},
+                .fragment_shader_info = daxa::ShaderCompileInfo{.source = daxa::ShaderCode{"layout(location = 0) out vec4 color;\nvoid main() { color = vec4(1.0); }\n"}},
+                .color_attachments = {{.format = daxa::Format::R8G8B8A8_UNORM}},
+                .name = "benchmark draw",
+            }).value();
+            ret.color_target = device().create_image({
+                .size = {64, 64, 1},
+                .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT,
+                .name = "benchmark color target",
+            });
+            return ret;
+        }();
+        return pipelines;
+    }
+
+    void record_dispatches(benchmark::State & state)
+    {
+        auto & pipelines = recording_pipelines();
+        auto recorder = device().create_command_recorder({.name = "benchmark dispatch recorder"});
+        for (auto _ : state)
+        {
+            recorder.set_pipeline(*pipelines.compute);
+            for (u32 i = 0; i < COMMANDS_PER_LIST; ++i)
+            {
+                recorder.dispatch({.x = 1});
+            }
+            auto commands = recorder.complete_current_commands();
+            benchmark::DoNotOptimize(commands);
+        }
+        state.SetItemsProcessed(state.iterations() * COMMANDS_PER_LIST);
+        settle_device();
+    }
+    BENCHMARK(record_dispatches)->Unit(benchmark::kMicrosecond);
+
+    void record_draws(benchmark::State & state)
+    {
+        auto & pipelines = recording_pipelines();
+        auto recorder = device().create_command_recorder({.name = "benchmark draw recorder"});
+        for (auto _ : state)
+        {
+            auto render_recorder = std::move(recorder).begin_renderpass({
+                .color_attachments = std::array{daxa::RenderAttachmentInfo{.image_view = pipelines.color_target.default_view()}},
+                .render_area = {.width = 64, .height = 64},
+            });
+            render_recorder.set_pipeline(*pipelines.raster);
+            for (u32 i = 0; i < COMMANDS_PER_LIST; ++i)
+            {
+                render_recorder.draw({.vertex_count = 3});
+            }
+            recorder = std::move(render_recorder).end_renderpass();
+            auto commands = recorder.complete_current_commands();
+            benchmark::DoNotOptimize(commands);
+        }
+        state.SetItemsProcessed(state.iterations() * COMMANDS_PER_LIST);
+        settle_device();
+    }
+    BENCHMARK(record_draws)->Unit(benchmark::kMicrosecond);
+#endif
+
+    // Measures daxa_dvc_submit with empty command lists, so the gpu work does not affect the cpu timings.
+    // Every submit waits on the previous one through a timeline semaphore, like a frame loop does.
+    void submit(benchmark::State & state)
+    {
+        auto & dvc = device();
+        auto const lists_per_submit = static_cast<usize>(state.range(0));
+        auto timeline = dvc.create_timeline_semaphore({.name = "benchmark submit timeline"});
+        u64 timeline_value = 0;
+        std::vector<daxa::ExecutableCommandList> command_lists = {};
+        {
+            auto recorder = dvc.create_command_recorder({.name = "benchmark submit recorder"});
+            for (usize i = 0; i < lists_per_submit; ++i)
+            {
+                command_lists.push_back(recorder.complete_current_commands());
+            }
+        }
+        for (auto _ : state)
+        {
+            dvc.submit_commands({
+                .command_lists = command_lists,
+                .wait_timeline_semaphores = std::array{std::pair{timeline, timeline_value}},
+                .signal_timeline_semaphores = std::array{std::pair{timeline, timeline_value + 1}},
+            });
+            timeline_value += 1;
+            // Keeps the number of pending submits bounded.
+            if ((timeline_value % 1024) == 0)
+            {
+                state.PauseTiming();
+                settle_device();
+                state.ResumeTiming();
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+        command_lists.clear();
+        settle_device();
+    }
+    BENCHMARK(submit)->Arg(1)->Arg(8);
+} // namespace benchmarks
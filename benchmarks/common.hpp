@@ -0,0 +1,40 @@
+#pragma once
+
+#include <daxa/daxa.hpp>
+#include <benchmark/benchmark.h>
+
+namespace benchmarks
+{
+    using namespace daxa::types;
+
+    struct Context
+    {
+        daxa::Instance instance = {};
+        daxa::Device device = {};
+    };
+
+    // One device shared by all benchmarks, so device creation is never part of a measurement.
+    inline auto context() -> Context &
+    {
+        static Context ctx = []()
+        {
+            Context ret = {};
+            ret.instance = daxa::create_instance({});
+            ret.device = ret.instance.create_device_2(ret.instance.choose_device({}, daxa::DeviceInfo2{.name = "benchmark device"}));
+            return ret;
+        }();
+        return ctx;
+    }
+
+    inline auto device() -> daxa::Device &
+    {
+        return context().device;
+    }
+
+    // Leaves no pending submits or zombies behind for the next benchmark.
+    inline void settle_device()
+    {
+        device().wait_idle();
+        device().collect_garbage();
+    }
+} // namespace benchmarks
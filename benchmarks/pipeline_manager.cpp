@@ -0,0 +1,81 @@
+#include "common.hpp"
+
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+#include <daxa/utils/pipeline_manager.hpp>
+
+#include <filesystem>
+
+namespace benchmarks
+{
+    constexpr char const * COMPILE_BENCHMARK_SHADER = R"glsl(
+#include <daxa/daxa.inl>
+layout(local_size_x = 64) in;
+layout(push_constant) uniform Push { daxa_u64 address; daxa_u32 count; } push;
+void main()
+{
+    daxa_u32 index = gl_GlobalInvocationID.x;
+    if (index >= push.count) { return; }
+    daxa_f32 value = daxa_f32(index);
+    for (daxa_u32 i = 0; i < 16; ++i) { value = sin(value) * cos(value) + sqrt(abs(value)); }
+}
+)glsl";
+
+    auto compile_benchmark_pipeline(daxa::PipelineManager & pipeline_manager) -> std::shared_ptr<daxa::ComputePipeline>
+    {
+        return pipeline_manager.add_compute_pipeline({
+            .shader_info = {.source = daxa::ShaderCode{COMPILE_BENCHMARK_SHADER}},
+            .push_constant_size = 16,
+            .name = "benchmark compile",
+        }).value();
+    }
+
+    auto compile_benchmark_pipeline_manager(std::shared_ptr<daxa::ShaderCacheBackend> cache) -> daxa::PipelineManager
+    {
+        return daxa::PipelineManager({
+            .device = device(),
+            .shader_compile_options = {
+                .root_paths = {DAXA_SHADER_INCLUDE_DIR},
+                .language = daxa::ShaderLanguage::GLSL,
+            },
+            .shader_cache_backend = std::move(cache),
+            .name = "benchmark pipeline manager",
+        });
+    }
+
+    // Every iteration uses a new pipeline manager without a shader cache, so the shader is always compiled.
+    void pipeline_compile_cold(benchmark::State & state)
+    {
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            auto pipeline_manager = compile_benchmark_pipeline_manager({});
+            state.ResumeTiming();
+            benchmark::DoNotOptimize(compile_benchmark_pipeline(pipeline_manager));
+        }
+        settle_device();
+    }
+    BENCHMARK(pipeline_compile_cold)->Unit(benchmark::kMillisecond);
+
+    // The shader is compiled once up front, every iteration then loads its spirv from the cache and only creates the pipeline.
+    void pipeline_compile_warm(benchmark::State & state)
+    {
+        auto const cache_folder = std::filesystem::temp_directory_path() / "daxa_benchmarks_shader_cache";
+        std::filesystem::remove_all(cache_folder);
+        auto const cache = daxa::create_archive_shader_cache(cache_folder);
+        {
+            auto pipeline_manager = compile_benchmark_pipeline_manager(cache);
+            compile_benchmark_pipeline(pipeline_manager);
+        }
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            auto pipeline_manager = compile_benchmark_pipeline_manager(cache);
+            state.ResumeTiming();
+            benchmark::DoNotOptimize(compile_benchmark_pipeline(pipeline_manager));
+        }
+        settle_device();
+        std::filesystem::remove_all(cache_folder);
+    }
+    BENCHMARK(pipeline_compile_warm)->Unit(benchmark::kMillisecond);
+} // namespace benchmarks
+#endif
@@ -0,0 +1,39 @@
+#include <daxa/daxa.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+// Replays a capture written with daxa::Device::begin_capture and prints the gpu timings of its submits.
+// Usage: daxa_replay <capture file> [--repeat N]
+auto main(int argc, char const * argv[]) -> int
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: daxa_replay <capture file> [--repeat N]" << std::endl;
+        return 1;
+    }
+    daxa::ReplayInfo info = {.path = argv[1], .repeat_count = 10};
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (std::string_view{argv[i]} == "--repeat")
+        {
+            info.repeat_count = static_cast<daxa::u32>(std::strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+
+    daxa::Instance instance = daxa::create_instance({});
+    daxa::Device device = instance.create_device_2(instance.choose_device({}, daxa::DeviceInfo2{.name = "replay device", .capturable = true}));
+    daxa::ReplayStats const stats = device.replay_capture(info);
+
+    std::cout << "resources:      " << stats.buffer_count << " buffers, " << stats.image_count << " images, "
+              << stats.image_view_count << " image views, " << stats.sampler_count << " samplers" << std::endl;
+    std::cout << "pipelines:      " << stats.pipeline_count << std::endl;
+    std::cout << "command lists:  " << stats.command_list_count << " (" << stats.skipped_command_list_count << " skipped in submits)" << std::endl;
+    std::cout << "commands:       " << stats.command_count << " (" << stats.skipped_command_count << " skipped)" << std::endl;
+    std::cout << "submits:        " << stats.submit_count << std::endl;
+    std::cout << "failed creates: " << stats.failed_creation_count << std::endl;
+    std::cout << "time:           min " << static_cast<double>(stats.min_ns) / 1e6 << " ms, mean " << static_cast<double>(stats.mean_ns) / 1e6
+              << " ms, max " << static_cast<double>(stats.max_ns) / 1e6 << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "common.hpp"
+
+#include <vector>
+
+namespace benchmarks
+{
+    // Resources are created and destroyed in batches, collecting the zombies between batches is not measured.
+    constexpr usize RESOURCE_BATCH_SIZE = 256;
+
+    void buffer_create_destroy(benchmark::State & state)
+    {
+        auto & dvc = device();
+        auto const size = static_cast<usize>(state.range(0));
+        std::vector<daxa::BufferId> buffers(RESOURCE_BATCH_SIZE);
+        for (auto _ : state)
+        {
+            for (auto & buffer : buffers)
+            {
+                buffer = dvc.create_buffer({.size = size, .name = "benchmark buffer"});
+            }
+            for (auto const & buffer : buffers)
+            {
+                dvc.destroy_buffer(buffer);
+            }
+            state.PauseTiming();
+            dvc.collect_garbage();
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<i64>(RESOURCE_BATCH_SIZE));
+    }
+    BENCHMARK(buffer_create_destroy)->Arg(256)->Arg(1 << 20)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+    void image_create_destroy(benchmark::State & state)
+    {
+        auto & dvc = device();
+        auto const extent = static_cast<u32>(state.range(0));
+        std::vector<daxa::ImageId> images(RESOURCE_BATCH_SIZE);
+        for (auto _ : state)
+        {
+            for (auto & image : images)
+            {
+                image = dvc.create_image({
+                    .size = {extent, extent, 1},
+                    .usage = daxa::ImageUsageFlagBits::SHADER_SAMPLED | daxa::ImageUsageFlagBits::TRANSFER_DST,
+                    .name = "benchmark image",
+                });
+            }
+            for (auto const & image : images)
+            {
+                dvc.destroy_image(image);
+            }
+            state.PauseTiming();
+            dvc.collect_garbage();
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<i64>(RESOURCE_BATCH_SIZE));
+    }
+    BENCHMARK(image_create_destroy)->Arg(64)->Arg(1024)->Threads(1)->Threads(4)->Threads(8)->UseRealTime();
+
+    // Measures collect_garbage with the given number of destroyed buffers waiting in the zombie queue.
+    // With zero zombies this is the cost paid every frame by applications that call it unconditionally.
+    void collect_garbage_zombies(benchmark::State & state)
+    {
+        auto & dvc = device();
+        auto const zombie_count = static_cast<usize>(state.range(0));
+        std::vector<daxa::BufferId> buffers(zombie_count);
+        settle_device();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            for (auto & buffer : buffers)
+            {
+                buffer = dvc.create_buffer({.size = 256, .name = "benchmark zombie"});
+            }
+            for (auto const & buffer : buffers)
+            {
+                dvc.destroy_buffer(buffer);
+            }
+            state.ResumeTiming();
+            dvc.collect_garbage();
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<i64>(zombie_count));
+    }
+    BENCHMARK(collect_garbage_zombies)->Arg(0)->Arg(256)->Arg(4096);
+} // namespace benchmarks
@@ -0,0 +1,96 @@
+#include "common.hpp"
+
+#if DAXA_BUILT_WITH_UTILS_TASK_GRAPH
+#include <daxa/utils/task_graph.hpp>
+
+#include <array>
+#include <optional>
+#include <string>
+
+namespace benchmarks
+{
+    constexpr usize TASK_GRAPH_BUFFER_COUNT = 16;
+
+    // Every task reads the buffer written by the previous task and writes the next one,
+    // so the graph has a dependency between every pair of neighbouring tasks.
+    auto build_task_graph(usize task_count) -> daxa::TaskGraph
+    {
+        auto task_graph = daxa::TaskGraph({
+            .device = device(),
+            .name = "benchmark task graph",
+        });
+        std::array<daxa::TaskBufferView, TASK_GRAPH_BUFFER_COUNT> buffers = {};
+        for (usize i = 0; i < buffers.size(); ++i)
+        {
+            buffers[i] = task_graph.create_transient_buffer({.size = 256, .name = std::string("benchmark buffer ") + std::to_string(i)});
+        }
+        for (usize i = 0; i < task_count; ++i)
+        {
+            auto const & written = buffers[i % TASK_GRAPH_BUFFER_COUNT];
+            if (i == 0)
+            {
+                task_graph.add_task({
+                    .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_WRITE, written)},
+                    .task = [](daxa::TaskInterface) {},
+                    .name = "benchmark task",
+                });
+            }
+            else
+            {
+                auto const & read = buffers[(i - 1) % TASK_GRAPH_BUFFER_COUNT];
+                task_graph.add_task({
+                    .attachments = {
+                        daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_READ, read),
+                        daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_WRITE, written),
+                    },
+                    .task = [](daxa::TaskInterface) {},
+                    .name = "benchmark task",
+                });
+            }
+        }
+        task_graph.submit({});
+        return task_graph;
+    }
+
+    // Only complete is measured, recording the tasks is not.
+    void task_graph_complete(benchmark::State & state)
+    {
+        auto const task_count = static_cast<usize>(state.range(0));
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            std::optional<daxa::TaskGraph> task_graph = build_task_graph(task_count);
+            state.ResumeTiming();
+            task_graph->complete({});
+            state.PauseTiming();
+            task_graph.reset();
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<i64>(task_count));
+        settle_device();
+    }
+    BENCHMARK(task_graph_complete)->Arg(50)->Arg(500)->Unit(benchmark::kMicrosecond);
+
+    void task_graph_execute(benchmark::State & state)
+    {
+        auto const task_count = static_cast<usize>(state.range(0));
+        auto task_graph = build_task_graph(task_count);
+        task_graph.complete({});
+        u64 executions = 0;
+        for (auto _ : state)
+        {
+            task_graph.execute({});
+            // Keeps the number of pending submits bounded.
+            if ((++executions % 64) == 0)
+            {
+                state.PauseTiming();
+                settle_device();
+                state.ResumeTiming();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<i64>(task_count));
+        settle_device();
+    }
+    BENCHMARK(task_graph_execute)->Arg(50)->Arg(500)->Unit(benchmark::kMicrosecond);
+} // namespace benchmarks
+#endif
@@ -42,9 +42,19 @@ if(DAXA_ENABLE_UTILS_PIPELINE_MANAGER_SPIRV_VALIDATION)
 find_package(SPIRV-Tools CONFIG REQUIRED)
 ]=])
 endif()
+if(DAXA_ENABLE_UTILS_PIPELINE_MANAGER_SPIRV_OPTIMIZATION)
+    file(APPEND ${CMAKE_BINARY_DIR}/config.cmake.in [=[
+find_package(SPIRV-Tools-opt CONFIG REQUIRED)
+]=])
+endif()
 if(DAXA_ENABLE_UTILS_TASK_GRAPH)
 # No package management work to do
 endif()
+if(DAXA_ENABLE_PROFILING_TRACY)
+    file(APPEND ${CMAKE_BINARY_DIR}/config.cmake.in [=[
+find_package(Tracy CONFIG REQUIRED)
+]=])
+endif()
 
 configure_package_config_file(${CMAKE_BINARY_DIR}/config.cmake.in
     ${CMAKE_CURRENT_BINARY_DIR}/daxa-config.cmake
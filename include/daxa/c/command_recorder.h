@@ -25,10 +25,41 @@ typedef struct
 {
     daxa_QueueFamily queue_family;
     daxa_SmallString name;
+    // Skips remembering the ids used in commands. Submits of these command lists will not validate ids.
+    daxa_Bool8 disable_submit_id_validation;
+    // Executable command lists can be submitted many times and be pending on the gpu multiple times at once.
+    // Deferred destructions only happen on the first submit.
+    daxa_Bool8 reusable;
+    // Before flushing, memory barriers with identical stages are combined and
+    // image barriers on adjacent subresources of the same image are collapsed into one.
+    daxa_Bool8 merge_barriers;
+    // Ending renderpasses is deferred until the next command that can not be recorded inside of them.
+    // A following renderpass loading the same attachments in the same render area continues the deferred one,
+    // the attachments are then neither stored nor loaded in between. Labels and timestamps do not end deferred renderpasses.
+    // Barriers in between that only order attachment accesses to these attachments without a layout change are dropped.
+    daxa_Bool8 merge_renderpasses;
 } daxa_CommandRecorderInfo;
 
 static daxa_CommandRecorderInfo const DAXA_DEFAULT_COMMAND_RECORDER_INFO = DAXA_ZERO_INIT;
 
+// Counts of state commands that were dropped because they would not have changed the bound state.
+// Accumulated over the whole lifetime of the recorder.
+typedef struct
+{
+    uint64_t filtered_pipeline_binds;
+    uint64_t filtered_viewports;
+    uint64_t filtered_scissors;
+    uint64_t filtered_index_buffer_binds;
+    // Barriers that were folded into another barrier by the merge pass.
+    uint64_t merged_barriers;
+    // Renderpasses that continued the previous renderpass instead of beginning a new one.
+    uint64_t merged_renderpasses;
+    // Pipeline changes that kept the device table bound, as the new pipeline has the same layout.
+    uint64_t filtered_gpu_sro_table_binds;
+    // Draws and dispatches dropped because the bound pipeline was still compiling and had no ready fallback.
+    uint64_t skipped_pending_pipeline_commands;
+} daxa_CommandRecorderStats;
+
 typedef struct
 {
     daxa_ImageId src_image;
@@ -196,6 +227,9 @@ typedef struct
     daxa_Optional(daxa_RenderAttachmentInfo) depth_attachment;
     daxa_Optional(daxa_RenderAttachmentInfo) stencil_attachment;
     VkRect2D render_area;
+    // The renderpass contents are recorded by secondary command recorders and executed with daxa_cmd_execute_commands.
+    // No draws can be recorded directly into such a renderpass.
+    daxa_Bool8 secondary_command_lists;
 } daxa_RenderPassBeginInfo;
 
 static daxa_RenderPassBeginInfo const DAXA_DEFAULT_RENDERPASS_BEGIN_INFO = DAXA_ZERO_INIT;
@@ -243,6 +277,98 @@ typedef struct
 
 static daxa_DispatchIndirectInfo const DAXA_DEFAULT_DISPATCH_INDIRECT_INFO = DAXA_ZERO_INIT;
 
+// Draws and dispatches between begin and end are discarded when the 32 bit value at offset is zero, or non zero when inverted.
+typedef struct
+{
+    daxa_BufferId buffer;
+    // Must be a multiple of 4.
+    size_t offset;
+    daxa_Bool8 inverted;
+} daxa_ConditionalRenderingInfo;
+
+static daxa_ConditionalRenderingInfo const DAXA_DEFAULT_CONDITIONAL_RENDERING_INFO = DAXA_ZERO_INIT;
+
+// One GDeflate 1.0 stream, both addresses must be 4 byte aligned and decompressed_size must not exceed 65536.
+typedef struct
+{
+    daxa_DeviceAddress src_address;
+    daxa_DeviceAddress dst_address;
+    daxa_u64 compressed_size;
+    daxa_u64 decompressed_size;
+} daxa_MemoryDecompressionRegion;
+
+typedef struct
+{
+    daxa_MemoryDecompressionRegion const * regions;
+    size_t region_count;
+} daxa_DecompressMemoryInfo;
+
+static daxa_DecompressMemoryInfo const DAXA_DEFAULT_DECOMPRESS_MEMORY_INFO = DAXA_ZERO_INIT;
+
+typedef struct
+{
+    daxa_IndirectCommandsLayout layout;
+    daxa_IndirectExecutionSet execution_set;
+    daxa_BufferId indirect_buffer;
+    size_t indirect_offset;
+    // Range sized by daxa_dvc_generated_commands_memory_requirements.
+    daxa_BufferId preprocess_buffer;
+    size_t preprocess_offset;
+    size_t preprocess_size;
+    uint32_t max_sequence_count;
+    // Optional, when empty max_sequence_count sequences are executed.
+    daxa_BufferId sequence_count_buffer;
+    size_t sequence_count_offset;
+    uint32_t max_draw_count;
+} daxa_ExecuteGeneratedCommandsInfo;
+
+static daxa_ExecuteGeneratedCommandsInfo const DAXA_DEFAULT_EXECUTE_GENERATED_COMMANDS_INFO = DAXA_ZERO_INIT;
+
+// Shader objects carry no fixed function state, it is given here with the same meaning as in daxa_RasterPipelineInfo.
+// Stages left null are unbound. Either vertex or mesh must be set.
+typedef struct
+{
+    daxa_ShaderObject vertex;
+    daxa_ShaderObject tesselation_control;
+    daxa_ShaderObject tesselation_evaluation;
+    daxa_ShaderObject fragment;
+    daxa_ShaderObject task;
+    daxa_ShaderObject mesh;
+    // Only the blend state is used, formats come from the current renderpass.
+    daxa_FixedList(daxa_RenderAttachment, 8) color_attachments;
+    daxa_Optional(daxa_DepthTestInfo) depth_test;
+    daxa_Optional(daxa_TesselationInfo) tesselation;
+    daxa_RasterizerInfo raster;
+} daxa_SetRasterShaderObjectsInfo;
+
+static daxa_SetRasterShaderObjectsInfo const DAXA_DEFAULT_SET_RASTER_SHADER_OBJECTS_INFO = {
+    .vertex = DAXA_ZERO_INIT,
+    .tesselation_control = DAXA_ZERO_INIT,
+    .tesselation_evaluation = DAXA_ZERO_INIT,
+    .fragment = DAXA_ZERO_INIT,
+    .task = DAXA_ZERO_INIT,
+    .mesh = DAXA_ZERO_INIT,
+    .color_attachments = DAXA_ZERO_INIT,
+    .depth_test = DAXA_ZERO_INIT,
+    .tesselation = DAXA_ZERO_INIT,
+    .raster = {
+        .primitive_topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        .primitive_restart_enable = 0,
+        .polygon_mode = VK_POLYGON_MODE_FILL,
+        .face_culling = VK_CULL_MODE_NONE,
+        .front_face_winding = VK_FRONT_FACE_CLOCKWISE,
+        .depth_clamp_enable = 0,
+        .rasterizer_discard_enable = 0,
+        .depth_bias_enable = 0,
+        .depth_bias_constant_factor = 0.0f,
+        .depth_bias_clamp = 0.0f,
+        .depth_bias_slope_factor = 0.0f,
+        .line_width = 1.0f,
+        .conservative_raster_info = {.has_value = 0},
+        .static_state_sample_count = {.value = VK_SAMPLE_COUNT_1_BIT, .has_value = 1},
+    },
+};
+
 typedef struct
 {
     daxa_BufferId indirect_buffer;
@@ -309,6 +435,53 @@ static daxa_DrawIndexedInfo const DAXA_DEFAULT_DRAW_INDEXED_INFO = {
     .first_instance = 0,
 };
 
+// Layout matches VkMultiDrawInfoEXT.
+typedef struct
+{
+    uint32_t first_vertex;
+    uint32_t vertex_count;
+} daxa_DrawRange;
+
+// Layout matches VkMultiDrawIndexedInfoEXT.
+typedef struct
+{
+    uint32_t first_index;
+    uint32_t index_count;
+    int32_t vertex_offset;
+} daxa_DrawIndexedRange;
+
+// All ranges are drawn with the same instance range.
+typedef struct
+{
+    daxa_DrawRange const * ranges;
+    size_t range_count;
+    uint32_t instance_count;
+    uint32_t first_instance;
+} daxa_DrawMultiInfo;
+
+static daxa_DrawMultiInfo const DAXA_DEFAULT_DRAW_MULTI_INFO = {
+    .ranges = DAXA_ZERO_INIT,
+    .range_count = 0,
+    .instance_count = 1,
+    .first_instance = 0,
+};
+
+// All ranges are drawn with the same instance range.
+typedef struct
+{
+    daxa_DrawIndexedRange const * ranges;
+    size_t range_count;
+    uint32_t instance_count;
+    uint32_t first_instance;
+} daxa_DrawMultiIndexedInfo;
+
+static daxa_DrawMultiIndexedInfo const DAXA_DEFAULT_DRAW_MULTI_INDEXED_INFO = {
+    .ranges = DAXA_ZERO_INIT,
+    .range_count = 0,
+    .instance_count = 1,
+    .first_instance = 0,
+};
+
 typedef struct
 {
     daxa_BufferId indirect_buffer;
@@ -373,6 +546,45 @@ typedef struct
     uint32_t count;
 } daxa_ResetTimestampsInfo;
 
+// Each query writes its 64 bit timestamp followed by its 64 bit availability, availability is zero for unwritten queries.
+typedef struct
+{
+    daxa_TimelineQueryPool * query_pool;
+    uint32_t start_index;
+    uint32_t count;
+    daxa_BufferId dst_buffer;
+    size_t dst_offset;
+} daxa_CopyTimestampsToBufferInfo;
+
+typedef struct
+{
+    daxa_MemoryBarrierInfo const * memory_barriers;
+    uint64_t memory_barrier_count;
+    daxa_ImageMemoryBarrierInfo const * image_memory_barriers;
+    uint64_t image_memory_barrier_count;
+} daxa_PipelineBarriersInfo;
+
+typedef struct
+{
+    daxa_QueryPool * query_pool;
+    uint32_t query_index;
+    // Only for occlusion queries, counts the exact number of passed samples instead of only being non zero.
+    daxa_Bool8 precise;
+} daxa_BeginQueryInfo;
+
+typedef struct
+{
+    daxa_QueryPool * query_pool;
+    uint32_t query_index;
+} daxa_EndQueryInfo;
+
+typedef struct
+{
+    daxa_QueryPool * query_pool;
+    uint32_t start_index;
+    uint32_t count;
+} daxa_ResetQueriesInfo;
+
 typedef struct
 {
     daxa_f32vec4 label_color;
@@ -415,8 +627,113 @@ typedef struct
     size_t blas_build_info_count;
 } daxa_BuildAccelerationStucturesInfo;
 
+typedef struct
+{
+    daxa_BlasId const * blas;
+    size_t blas_count;
+    // Must be a VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR pool.
+    daxa_QueryPool * query_pool;
+    uint32_t first_query_index;
+} daxa_WriteBlasCompactedSizesInfo;
+
+static daxa_WriteBlasCompactedSizesInfo const DAXA_DEFAULT_WRITE_BLAS_COMPACTED_SIZES_INFO = DAXA_ZERO_INIT;
+
+typedef struct
+{
+    daxa_BlasId src_blas;
+    daxa_BlasId dst_blas;
+    // VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR requires the src blas to be built with ALLOW_COMPACTION.
+    VkCopyAccelerationStructureModeKHR mode;
+} daxa_CopyAccelerationStructureInfo;
+
+static daxa_CopyAccelerationStructureInfo const DAXA_DEFAULT_COPY_ACCELERATION_STRUCTURE_INFO = {
+    .src_blas = DAXA_ZERO_INIT,
+    .dst_blas = DAXA_ZERO_INIT,
+    .mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR,
+};
+
 static daxa_BuildAccelerationStucturesInfo const DAXA_DEFAULT_BUILD_ACCELERATION_STRUCTURES_INFO = DAXA_ZERO_INIT;
 
+typedef struct
+{
+    daxa_MicromapBuildInfo const * builds;
+    size_t build_count;
+} daxa_BuildMicromapsInfo;
+
+static daxa_BuildMicromapsInfo const DAXA_DEFAULT_BUILD_MICROMAPS_INFO = DAXA_ZERO_INIT;
+
+// Region of an image view read or written by a video command.
+// The image must be in the video layout of its use, see VK_IMAGE_LAYOUT_VIDEO_*.
+typedef struct
+{
+    daxa_ImageViewId view;
+    VkOffset2D coded_offset;
+    VkExtent2D coded_extent;
+    // Relative to the first layer of the view.
+    uint32_t base_array_layer;
+} daxa_VideoPictureResource;
+
+typedef struct
+{
+    // DPB slot of the picture. Negative in begin video coding deactivates the slot of the picture.
+    int32_t slot_index;
+    daxa_VideoPictureResource picture;
+    // Codec specific VkVideo{Decode,Encode}{H264,H265}DpbSlotInfoKHR, may be null in begin video coding.
+    void const * codec_info;
+} daxa_VideoReferenceSlot;
+
+typedef struct
+{
+    daxa_VideoSession session;
+    // Every DPB slot the following decodes or encodes reference or set up.
+    daxa_VideoReferenceSlot const * reference_slots;
+    size_t reference_slot_count;
+} daxa_BeginVideoCodingInfo;
+
+static daxa_BeginVideoCodingInfo const DAXA_DEFAULT_BEGIN_VIDEO_CODING_INFO = DAXA_ZERO_INIT;
+
+typedef struct
+{
+    // VK_VIDEO_CODING_CONTROL_RESET_BIT_KHR must be recorded once before the first decode or encode of a session.
+    VkVideoCodingControlFlagsKHR flags;
+    // Optional rate control or quality level structs chained into VkVideoCodingControlInfoKHR.
+    void const * next;
+} daxa_VideoCodingControlInfo;
+
+static daxa_VideoCodingControlInfo const DAXA_DEFAULT_VIDEO_CODING_CONTROL_INFO = DAXA_ZERO_INIT;
+
+typedef struct
+{
+    daxa_BufferId src_buffer;
+    uint64_t src_offset;
+    uint64_t src_range;
+    daxa_VideoPictureResource dst_picture;
+    // Without a value the decoded picture does not become a reference picture.
+    daxa_Optional(daxa_VideoReferenceSlot) setup_reference_slot;
+    daxa_VideoReferenceSlot const * reference_slots;
+    size_t reference_slot_count;
+    // Codec specific VkVideoDecodeH264PictureInfoKHR or VkVideoDecodeH265PictureInfoKHR.
+    void const * codec_info;
+} daxa_VideoDecodeInfo;
+
+static daxa_VideoDecodeInfo const DAXA_DEFAULT_VIDEO_DECODE_INFO = DAXA_ZERO_INIT;
+
+typedef struct
+{
+    daxa_BufferId dst_buffer;
+    uint64_t dst_offset;
+    uint64_t dst_range;
+    daxa_VideoPictureResource src_picture;
+    // Without a value the reconstructed picture does not become a reference picture.
+    daxa_Optional(daxa_VideoReferenceSlot) setup_reference_slot;
+    daxa_VideoReferenceSlot const * reference_slots;
+    size_t reference_slot_count;
+    // Codec specific VkVideoEncodeH264PictureInfoKHR or VkVideoEncodeH265PictureInfoKHR.
+    void const * codec_info;
+} daxa_VideoEncodeInfo;
+
+static daxa_VideoEncodeInfo const DAXA_DEFAULT_VIDEO_ENCODE_INFO = DAXA_ZERO_INIT;
+
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_set_rasterization_samples(daxa_CommandRecorder cmd_enc, VkSampleCountFlagBits samples);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -429,8 +746,43 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_copy_image_to_image(daxa_CommandRecorder cmd_enc, daxa_ImageCopyInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_blit_image_to_image(daxa_CommandRecorder cmd_enc, daxa_ImageBlitInfo const * info);
+/// @return DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING,
+///         DAXA_RESULT_ERROR_ACCELERATION_STRUCTURE_UPDATE_WITHOUT_ALLOW_UPDATE when a refit lacks DAXA_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE.
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_build_acceleration_structures(daxa_CommandRecorder cmd_rec, daxa_BuildAccelerationStucturesInfo const * info);
+/// @brief  Writes the compacted size of each blas into consecutive queries, the queries must be reset beforehand.
+///         The blas must be built with ALLOW_COMPACTION and the builds made visible with a barrier to acceleration structure build reads.
+/// @return DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING,
+///         DAXA_RESULT_ERROR_INVALID_QUERY_TYPE when the query pool is not a compacted size pool.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_write_blas_compacted_sizes(daxa_CommandRecorder cmd_rec, daxa_WriteBlasCompactedSizesInfo const * info);
+/// @brief  Copies or compacts a blas into another one. A compacting copy needs a dst blas at least as large as the queried compacted size.
+///         Runs in the acceleration structure build stage.
+/// @return DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_copy_acceleration_structure(daxa_CommandRecorder cmd_rec, daxa_CopyAccelerationStructureInfo const * info);
+/// @brief  Builds opacity micromaps, runs in the micromap build stage.
+///         Blas builds referencing the micromaps must wait for the builds with a barrier to acceleration structure build reads.
+/// @return DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_build_micromaps(daxa_CommandRecorder cmd_rec, daxa_BuildMicromapsInfo const * info);
+
+/// @brief  Begins a video coding scope of a session, decodes, encodes and coding controls must be recorded inside of one.
+///         Must be recorded on a recorder of the video queue family matching the sessions codec operation.
+/// @return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_VIDEO.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_begin_video_coding(daxa_CommandRecorder cmd_rec, daxa_BeginVideoCodingInfo const * info);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_end_video_coding(daxa_CommandRecorder cmd_rec);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_control_video_coding(daxa_CommandRecorder cmd_rec, daxa_VideoCodingControlInfo const * info);
+/// @brief  Decodes one picture from the bitstream range of the src buffer, runs in the video decode stage.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_decode_video(daxa_CommandRecorder cmd_rec, daxa_VideoDecodeInfo const * info);
+/// @brief  Encodes one picture into the dst buffer range, runs in the video encode stage.
+///         The written size is reported by a VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR query around the encode.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_encode_video(daxa_CommandRecorder cmd_rec, daxa_VideoEncodeInfo const * info);
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_clear_buffer(daxa_CommandRecorder cmd_enc, daxa_BufferClearInfo const * info);
@@ -447,6 +799,9 @@ daxa_cmd_pipeline_barrier(daxa_CommandRecorder cmd_enc, daxa_MemoryBarrierInfo c
 /// @param info parameters.
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_pipeline_barrier_image_transition(daxa_CommandRecorder cmd_enc, daxa_ImageMemoryBarrierInfo const * info);
+/// @brief  Adds many barriers at once, they are combined with the other successive pipeline barrier calls.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_pipeline_barriers(daxa_CommandRecorder cmd_enc, daxa_PipelineBarriersInfo const * info);
 DAXA_EXPORT void
 daxa_cmd_signal_event(daxa_CommandRecorder cmd_enc, daxa_EventSignalInfo const * info);
 DAXA_EXPORT void
@@ -458,17 +813,53 @@ daxa_cmd_reset_event(daxa_CommandRecorder cmd_enc, daxa_ResetEventInfo const * i
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_push_constant(daxa_CommandRecorder cmd_enc, daxa_PushConstantInfo const * info);
+/// @brief  Writes several fields of the push constant block with a single vkCmdPushConstants.
+///         Bytes between the fields keep the values of earlier pushes from this recorder.
+/// @param fields fields to write, may overlap and be in any order, later fields win.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_push_constant_range(daxa_CommandRecorder cmd_enc, daxa_PushConstantInfo const * fields, size_t field_count);
 DAXA_EXPORT void
 daxa_cmd_set_ray_tracing_pipeline(daxa_CommandRecorder cmd_enc, daxa_RayTracingPipeline pipeline);
 DAXA_EXPORT void
 daxa_cmd_set_compute_pipeline(daxa_CommandRecorder cmd_enc, daxa_ComputePipeline pipeline);
 DAXA_EXPORT void
 daxa_cmd_set_raster_pipeline(daxa_CommandRecorder cmd_enc, daxa_RasterPipeline pipeline);
+/// @brief  Binds a compute shader object in place of a compute pipeline.
+/// @return DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE when the shader object is not a compute shader.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_set_compute_shader_object(daxa_CommandRecorder cmd_enc, daxa_ShaderObject shader_object);
+/// @brief  Binds graphics shader objects in place of a raster pipeline and sets all state a raster pipeline would hold statically.
+///         Viewport and scissor keep their current values.
+/// @return DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE when a shader object is bound to the wrong stage or neither vertex nor mesh is set,
+///         DAXA_RESULT_ERROR_SHADER_OBJECT_PUSH_CONSTANT_SIZE_MISMATCH when the shader objects differ in push constant size.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_set_raster_shader_objects(daxa_CommandRecorder cmd_enc, daxa_SetRasterShaderObjectsInfo const * info);
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_dispatch(daxa_CommandRecorder cmd_enc, daxa_DispatchInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_dispatch_indirect(daxa_CommandRecorder cmd_enc, daxa_DispatchIndirectInfo const * info);
+/// @brief  Executes the sequences in the indirect buffer as laid out by info->layout.
+///         A pipeline compatible with the execution set must be bound. Bound pipeline, push constants and index buffer are undefined afterwards.
+/// @return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS.
+///         DAXA_RESULT_INVALID_BUFFER_OFFSET when the indirect offset is not inside the indirect buffer.
+///         DAXA_RESULT_INVALID_BUFFER_RANGE when the preprocess range does not fit into the preprocess buffer.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_execute_generated_commands(daxa_CommandRecorder cmd_enc, daxa_ExecuteGeneratedCommandsInfo const * info);
+/// @brief  Predicates the following draws and dispatches on a value in a buffer, written by earlier gpu work.
+///         Must be ended in the same renderpass, or outside of a renderpass when begun outside of one.
+/// @return DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING,
+///         DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_SCOPE_MISMATCH when conditional rendering is already active.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_begin_conditional_rendering(daxa_CommandRecorder cmd_enc, daxa_ConditionalRenderingInfo const * info);
+/// @return DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_SCOPE_MISMATCH when conditional rendering is not active or was begun in a different renderpass scope.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_end_conditional_rendering(daxa_CommandRecorder cmd_enc);
+/// @brief  Decompresses GDeflate streams from one device address to another on the gpu.
+///         Reads and writes must be synchronized with all commands barriers, as decompression has no stage of its own in daxa.
+/// @return DAXA_RESULT_ERROR_MEMORY_DECOMPRESSION_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_DECOMPRESSION.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_decompress_memory(daxa_CommandRecorder cmd_enc, daxa_DecompressMemoryInfo const * info);
 
 /// @brief  Destroys the buffer AFTER the gpu is finished executing the command list.
 ///         Useful for large uploads exceeding staging memory pools.
@@ -506,6 +897,20 @@ daxa_cmd_begin_renderpass(daxa_CommandRecorder cmd_enc, daxa_RenderPassBeginInfo
 ///         Between the begin and end renderpass commands, the renderpass persists and draw-calls can be recorded.
 DAXA_EXPORT void
 daxa_cmd_end_renderpass(daxa_CommandRecorder cmd_enc);
+/// @brief  Creates a recorder for secondary command lists, continuing the current renderpass of cmd_enc.
+///         The renderpass must be begun with secondary_command_lists set. The queue family of info is ignored and taken from cmd_enc.
+///         The new recorder is independent of cmd_enc and can record on another thread.
+///         Viewport and scissor start out covering the render area, all other state starts out unset.
+/// @return DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH when cmd_enc is secondary or not in a renderpass begun for secondary command lists.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_create_secondary_command_recorder(daxa_CommandRecorder cmd_enc, daxa_CommandRecorderInfo const * info, daxa_CommandRecorder * out_cmd_enc);
+/// @brief  Executes secondary command lists in the current renderpass, with a single vkCmdExecuteCommands.
+///         The command lists stay alive until the command list recorded by cmd_enc is destroyed.
+///         Their used ids and deferred destructions are moved into the commands of cmd_enc.
+/// @return DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH when a command list is not secondary,
+///         or cmd_enc is secondary or not in a renderpass begun for secondary command lists.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_execute_commands(daxa_CommandRecorder cmd_enc, daxa_ExecutableCommandList const * executable_cmds, size_t executable_cmd_count);
 DAXA_EXPORT void
 daxa_cmd_set_viewport(daxa_CommandRecorder cmd_enc, VkViewport const * info);
 DAXA_EXPORT void
@@ -519,6 +924,14 @@ DAXA_EXPORT void
 daxa_cmd_draw(daxa_CommandRecorder cmd_enc, daxa_DrawInfo const * info);
 DAXA_EXPORT void
 daxa_cmd_draw_indexed(daxa_CommandRecorder cmd_enc, daxa_DrawIndexedInfo const * info);
+/// @brief  Records one draw per range.
+///         Uses vkCmdDrawMultiEXT when the device has DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW, otherwise loops over vkCmdDraw.
+DAXA_EXPORT void
+daxa_cmd_draw_multi(daxa_CommandRecorder cmd_enc, daxa_DrawMultiInfo const * info);
+/// @brief  Records one indexed draw per range.
+///         Uses vkCmdDrawMultiIndexedEXT when the device has DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW, otherwise loops over vkCmdDrawIndexed.
+DAXA_EXPORT void
+daxa_cmd_draw_multi_indexed(daxa_CommandRecorder cmd_enc, daxa_DrawMultiIndexedInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_draw_indirect(daxa_CommandRecorder cmd_enc, daxa_DrawIndirectInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -534,12 +947,32 @@ DAXA_EXPORT void
 daxa_cmd_write_timestamp(daxa_CommandRecorder cmd_enc, daxa_WriteTimestampInfo const * info);
 DAXA_EXPORT void
 daxa_cmd_reset_timestamps(daxa_CommandRecorder cmd_enc, daxa_ResetTimestampsInfo const * info);
+/// @brief  Copies timestamps on the gpu without waiting for them, synchronized as a transfer write to the buffer.
+/// @return DAXA_RESULT_RANGE_OUT_OF_BOUNDS when the queries exceed the pool,
+///         DAXA_RESULT_ERROR_COPY_OUT_OF_BOUNDS when the results exceed the buffer.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_copy_timestamps_to_buffer(daxa_CommandRecorder cmd_enc, daxa_CopyTimestampsToBufferInfo const * info);
+/// @brief  Queries must be reset before they are begun. The query counts the work recorded until it is ended in the same command list.
+/// @return DAXA_RESULT_ERROR_PRECISE_OCCLUSION_QUERY_NOT_SUPPORTED when precise is set and the device lacks DAXA_IMPLICIT_FEATURE_FLAG_PRECISE_OCCLUSION_QUERY,
+///         DAXA_RESULT_ERROR_INVALID_QUERY_TYPE when precise is set for a pipeline statistics query or the pool is a compacted size pool.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_begin_query(daxa_CommandRecorder cmd_enc, daxa_BeginQueryInfo const * info);
+DAXA_EXPORT void
+daxa_cmd_end_query(daxa_CommandRecorder cmd_enc, daxa_EndQueryInfo const * info);
+/// @brief  Must be recorded outside of a renderpass.
+DAXA_EXPORT void
+daxa_cmd_reset_queries(daxa_CommandRecorder cmd_enc, daxa_ResetQueriesInfo const * info);
 
 DAXA_EXPORT void
 daxa_cmd_begin_label(daxa_CommandRecorder cmd_enc, daxa_CommandLabelInfo const * info);
 DAXA_EXPORT void
 daxa_cmd_end_label(daxa_CommandRecorder cmd_enc);
 
+// Selects the physical devices of a device group that execute the following commands, bit i selects device i. Zero selects all of them.
+// Must be recorded outside of a renderpass.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_set_device_mask(daxa_CommandRecorder cmd_enc, daxa_u32 device_mask);
+
 // Is called by all other commands. Flushes internal pipeline barrier list to actual vulkan call.
 DAXA_EXPORT void
 daxa_cmd_flush_barriers(daxa_CommandRecorder cmd_enc);
@@ -547,6 +980,10 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_complete_current_commands(daxa_CommandRecorder cmd_enc, daxa_ExecutableCommandList * out_executable_cmds);
 DAXA_EXPORT daxa_CommandRecorderInfo const *
 daxa_cmd_info(daxa_CommandRecorder cmd_enc);
+/// @brief  Pipeline, viewport, scissor and index buffer commands are dropped when they would rebind the currently bound state.
+///         The bound state is forgotten with each new command buffer and after executing secondary command lists.
+DAXA_EXPORT daxa_CommandRecorderStats const *
+daxa_cmd_stats(daxa_CommandRecorder cmd_enc);
 DAXA_EXPORT VkCommandBuffer
 daxa_cmd_get_vk_command_buffer(daxa_CommandRecorder cmd_enc);
 DAXA_EXPORT VkCommandPool
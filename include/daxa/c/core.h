@@ -46,7 +46,13 @@ typedef struct daxa_ImplBinarySemaphore * daxa_BinarySemaphore;
 typedef struct daxa_ImplTimelineSemaphore * daxa_TimelineSemaphore;
 typedef struct daxa_ImplEvent * daxa_Event;
 typedef struct daxa_ImplTimelineQueryPool * daxa_TimelineQueryPool;
+typedef struct daxa_ImplQueryPool * daxa_QueryPool;
 typedef struct daxa_ImplMemoryBlock * daxa_MemoryBlock;
+typedef struct daxa_ImplIndirectCommandsLayout * daxa_IndirectCommandsLayout;
+typedef struct daxa_ImplIndirectExecutionSet * daxa_IndirectExecutionSet;
+typedef struct daxa_ImplShaderObject * daxa_ShaderObject;
+typedef struct daxa_ImplMicromap * daxa_Micromap;
+typedef struct daxa_ImplVideoSession * daxa_VideoSession;
 
 typedef uint64_t daxa_Flags;
 
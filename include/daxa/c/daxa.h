@@ -7,5 +7,6 @@
 #include <daxa/c/pipeline.h>
 #include <daxa/c/device.h>
 #include <daxa/c/instance.h>
+#include <daxa/c/profiling.h>
 
 #endif // #ifndef __DAXA_H__
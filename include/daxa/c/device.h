@@ -11,6 +11,8 @@
 
 #define DAXA_MAX_COMPUTE_QUEUE_COUNT 8u
 #define DAXA_MAX_TRANSFER_QUEUE_COUNT 2u
+#define DAXA_MAX_VIDEO_DECODE_QUEUE_COUNT 1u
+#define DAXA_MAX_VIDEO_ENCODE_QUEUE_COUNT 1u
 
 typedef enum
 {
@@ -198,6 +200,59 @@ typedef struct
     daxa_Bool8 prefers_compact_primitive_output;
 } daxa_MeshShaderProperties;
 
+// MUST BE ABI COMPATIBLE WITH VkComponentTypeKHR!
+typedef enum
+{
+    DAXA_COMPONENT_TYPE_FLOAT16 = 0,
+    DAXA_COMPONENT_TYPE_FLOAT32 = 1,
+    DAXA_COMPONENT_TYPE_FLOAT64 = 2,
+    DAXA_COMPONENT_TYPE_SINT8 = 3,
+    DAXA_COMPONENT_TYPE_SINT16 = 4,
+    DAXA_COMPONENT_TYPE_SINT32 = 5,
+    DAXA_COMPONENT_TYPE_SINT64 = 6,
+    DAXA_COMPONENT_TYPE_UINT8 = 7,
+    DAXA_COMPONENT_TYPE_UINT16 = 8,
+    DAXA_COMPONENT_TYPE_UINT32 = 9,
+    DAXA_COMPONENT_TYPE_UINT64 = 10,
+    DAXA_COMPONENT_TYPE_MAX_ENUM = 0x7FFFFFFF,
+} daxa_ComponentType;
+
+// MUST BE ABI COMPATIBLE WITH VkScopeKHR!
+typedef enum
+{
+    DAXA_SCOPE_DEVICE = 1,
+    DAXA_SCOPE_WORKGROUP = 2,
+    DAXA_SCOPE_SUBGROUP = 3,
+    DAXA_SCOPE_QUEUE_FAMILY = 5,
+    DAXA_SCOPE_MAX_ENUM = 0x7FFFFFFF,
+} daxa_Scope;
+
+// One supported matrix multiply-add D = A * B + C with A being MxK, B KxN and C, D MxN.
+// Is NOT ABI Compatible with VkCooperativeMatrixPropertiesKHR!
+typedef struct
+{
+    uint32_t m_size;
+    uint32_t n_size;
+    uint32_t k_size;
+    daxa_ComponentType a_type;
+    daxa_ComponentType b_type;
+    daxa_ComponentType c_type;
+    daxa_ComponentType result_type;
+    daxa_Bool8 saturating_accumulation;
+    daxa_Scope scope;
+} daxa_CooperativeMatrixShape;
+
+#define DAXA_MAX_COOPERATIVE_MATRIX_SHAPES 32
+
+typedef struct
+{
+    // Stages in which cooperative matrix instructions are supported.
+    VkShaderStageFlags supported_stages;
+    uint32_t shape_count;
+    // Shapes beyond DAXA_MAX_COOPERATIVE_MATRIX_SHAPES are dropped, drivers report far fewer.
+    daxa_CooperativeMatrixShape shapes[DAXA_MAX_COOPERATIVE_MATRIX_SHAPES];
+} daxa_CooperativeMatrixProperties;
+
 typedef enum
 {
     DAXA_MISSING_REQUIRED_VK_FEATURE_NONE,
@@ -249,6 +304,12 @@ typedef enum
     DAXA_EXPLICIT_FEATURE_FLAG_ACCELERATION_STRUCTURE_CAPTURE_REPLAY = 0x1 << 1,
     DAXA_EXPLICIT_FEATURE_FLAG_VK_MEMORY_MODEL = 0x1 << 2,
     DAXA_EXPLICIT_FEATURE_FLAG_ROBUSTNESS_2 = 0x1 << 3,
+    // Backs the bindless resource table with a VK_EXT_descriptor_buffer instead of a descriptor set.
+    // Descriptors are then written directly into host visible memory on resource creation and destruction.
+    DAXA_EXPLICIT_FEATURE_FLAG_DESCRIPTOR_BUFFER = 0x1 << 4,
+    // Tensor core matrix multiply-add in shaders through VK_KHR_cooperative_matrix, also enables the vulkan memory model it requires.
+    // Shaders compiled by the pipeline manager of such a device see DAXA_COOPERATIVE_MATRIX defined to 1.
+    DAXA_EXPLICIT_FEATURE_FLAG_COOPERATIVE_MATRIX = 0x1 << 5,
 } daxa_DeviceExplicitFeatureFlagBits;
 
 typedef daxa_DeviceExplicitFeatureFlagBits daxa_ExplicitFeatureFlags;
@@ -269,6 +330,28 @@ typedef enum
     DAXA_IMPLICIT_FEATURE_FLAG_DYNAMIC_STATE_3 =  0x1 << 10,
     DAXA_IMPLICIT_FEATURE_FLAG_SHADER_ATOMIC_FLOAT =  0x1 << 11,
     DAXA_IMPLICIT_FEATURE_FLAG_SWAPCHAIN =  0x1 << 12,
+    DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_BUDGET =  0x1 << 13,
+    DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING =  0x1 << 14,
+    DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW =  0x1 << 15,
+    DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS =  0x1 << 16,
+    DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_BINARY =  0x1 << 17,
+    DAXA_IMPLICIT_FEATURE_FLAG_GRAPHICS_PIPELINE_LIBRARY =  0x1 << 18,
+    DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT =  0x1 << 19,
+    DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING =  0x1 << 20,
+    DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_STATISTICS_QUERY =  0x1 << 21,
+    DAXA_IMPLICIT_FEATURE_FLAG_PRECISE_OCCLUSION_QUERY =  0x1 << 22,
+    DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_DECOMPRESSION =  0x1 << 23,
+    DAXA_IMPLICIT_FEATURE_FLAG_PRESENT_WAIT =  0x1 << 24,
+    DAXA_IMPLICIT_FEATURE_FLAG_LOW_LATENCY =  0x1 << 25,
+    DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING =  0x1 << 26,
+    DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP =  0x1 << 27,
+    DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS =  0x1 << 28,
+    // Exportable and importable buffer, image and timeline semaphore memory through opaque fds on linux and win32 handles on windows.
+    // dma-buf handles additionally need VK_EXT_external_memory_dma_buf.
+    DAXA_IMPLICIT_FEATURE_FLAG_EXTERNAL_MEMORY =  0x1 << 29,
+    // Video sessions, video usages on images and buffers and the video decode and encode queue families when the device exposes them.
+    // Supported codecs are listed in daxa_DeviceProperties::video_decode_codec_operations and video_encode_codec_operations.
+    DAXA_IMPLICIT_FEATURE_FLAG_VIDEO =  0x1 << 30,
 } daxa_DeviceImplicitFeatureFlagBits;
 
 typedef daxa_DeviceImplicitFeatureFlagBits daxa_ImplicitFeatureFlags;
@@ -292,6 +375,20 @@ typedef struct
     daxa_ImplicitFeatureFlags implicit_features;
     daxa_ExplicitFeatureFlags explicit_features;
     daxa_MissingRequiredVkFeature missing_required_feature;
+    // Size of the largest device local heap with host visible memory types, zero when there is none.
+    // Without resizable bar this is usually 256mb, with it the heap spans the whole vram.
+    daxa_u64 device_local_host_visible_heap_size;
+    // Set when DAXA_EXPLICIT_FEATURE_FLAG_COOPERATIVE_MATRIX is supported.
+    daxa_Optional(daxa_CooperativeMatrixProperties) cooperative_matrix_properties;
+    // Physical devices in the vulkan device group of this device, including itself.
+    // With more than one, daxa_DeviceInfo2::device_group creates a single device spanning all of them.
+    daxa_u32 device_group_size;
+    // Queues of the dedicated video families, zero without DAXA_IMPLICIT_FEATURE_FLAG_VIDEO.
+    daxa_u32 video_decode_queue_count;
+    daxa_u32 video_encode_queue_count;
+    // Codecs supported by the video queue families, see daxa_VideoCodecOperation.
+    VkVideoCodecOperationFlagsKHR video_decode_codec_operations;
+    VkVideoCodecOperationFlagsKHR video_encode_codec_operations;
 } daxa_DeviceProperties;
 
 /// DEPRECATED: use daxa_instance_create_device_2 and daxa_DeviceInfo2 instead!
@@ -346,11 +443,23 @@ typedef struct
 {
     daxa_u32 physical_device_index;                     // Index into list of devices returned from daxa_instance_list_devices_properties.
     daxa_ExplicitFeatureFlags explicit_features;  // Explicit features must be manually enabled.
+    // Upper bounds, image and buffer descriptors are allocated on demand.
     uint32_t max_allowed_images;
     uint32_t max_allowed_buffers;
     uint32_t max_allowed_samplers;
     uint32_t max_allowed_acceleration_structures;
     daxa_SmallString name;
+    // Spawns a device owned thread that collects garbage as soon as submits retire.
+    daxa_Bool8 background_garbage_collection;
+    // Optional directory the pipeline cache is loaded from at creation and saved to at destruction.
+    // The file name contains the pipeline cache uuid of the driver, so caches of different drivers do not collide.
+    // With DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_BINARY, captured pipeline binaries are archived there as well.
+    char const * pipeline_cache_directory;
+    // Creates the device over all physical devices of the device group of physical_device_index, see daxa_DeviceProperties::device_group_size.
+    // Memory is allocated once per physical device, submits and command recorders select the executing physical devices with device masks.
+    daxa_Bool8 device_group;
+    // Pipelines keep a copy of their create info and spirv, required by daxa_dvc_begin_capture.
+    daxa_Bool8 capturable;
 } daxa_DeviceInfo2;
 
 static daxa_DeviceInfo2 const DAXA_DEFAULT_DEVICE_INFO_2 = {
@@ -361,6 +470,10 @@ static daxa_DeviceInfo2 const DAXA_DEFAULT_DEVICE_INFO_2 = {
     .max_allowed_samplers = 400,
     .max_allowed_acceleration_structures = 10000,
     .name = DAXA_ZERO_INIT,
+    .background_garbage_collection = 0,
+    .pipeline_cache_directory = DAXA_ZERO_INIT,
+    .device_group = 0,
+    .capturable = 0,
 };
 
 typedef struct
@@ -380,11 +493,15 @@ static daxa_Queue const DAXA_QUEUE_COMPUTE_6 = { DAXA_QUEUE_FAMILY_COMPUTE, 6 };
 static daxa_Queue const DAXA_QUEUE_COMPUTE_7 = { DAXA_QUEUE_FAMILY_COMPUTE, 7 };
 static daxa_Queue const DAXA_QUEUE_TRANSFER_0 = { DAXA_QUEUE_FAMILY_TRANSFER, 0 };
 static daxa_Queue const DAXA_QUEUE_TRANSFER_1 = { DAXA_QUEUE_FAMILY_TRANSFER, 1 };
+static daxa_Queue const DAXA_QUEUE_VIDEO_DECODE_0 = { DAXA_QUEUE_FAMILY_VIDEO_DECODE, 0 };
+static daxa_Queue const DAXA_QUEUE_VIDEO_ENCODE_0 = { DAXA_QUEUE_FAMILY_VIDEO_ENCODE, 0 };
 
 typedef struct
 {
     daxa_Queue queue;
-    VkPipelineStageFlags wait_stages;
+    // Stage mask used for all semaphore waits without an explicit stage mask.
+    // Zero is treated as VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT.
+    VkPipelineStageFlags2 wait_stages;
     daxa_ExecutableCommandList const * command_lists;
     uint64_t command_list_count;
     daxa_BinarySemaphore const * wait_binary_semaphores;
@@ -395,6 +512,11 @@ typedef struct
     uint64_t wait_timeline_semaphore_count;
     daxa_TimelinePair const * signal_timeline_semaphores;
     uint64_t signal_timeline_semaphore_count;
+    // Optional per semaphore wait stage masks. When not null, they must hold one entry per wait semaphore.
+    VkPipelineStageFlags2 const * wait_binary_semaphore_stages;
+    VkPipelineStageFlags2 const * wait_timeline_semaphore_stages;
+    // Physical devices of a device group that execute the command lists, bit i selects device i. Zero selects all of them.
+    daxa_u32 device_mask;
 } daxa_CommandSubmitInfo;
 
 static daxa_CommandSubmitInfo const DAXA_DEFAULT_COMMAND_SUBMIT_INFO = DAXA_ZERO_INIT;
@@ -409,11 +531,131 @@ typedef struct
 
 static daxa_PresentInfo const DAXA_DEFAULT_PRESENT_INFO = DAXA_ZERO_INIT;
 
+typedef struct
+{
+    // Maximum number of zombies destroyed by one call. Zero means no limit.
+    uint64_t max_destroyed_zombies;
+    // Maximum time spent destroying zombies in one call. Zero means no limit.
+    uint64_t max_nanoseconds;
+    // Returns DAXA_RESULT_NOT_READY instead of blocking, when command recorders or submits currently hold the resource lifetime lock.
+    daxa_Bool8 non_blocking;
+} daxa_GarbageCollectInfo;
+
+static daxa_GarbageCollectInfo const DAXA_DEFAULT_GARBAGE_COLLECT_INFO = DAXA_ZERO_INIT;
+
+typedef struct
+{
+    // Receives the copies from the old to the new allocations of the moved resources.
+    daxa_CommandRecorder command_recorder;
+    // Maximum number of bytes moved by one pass. Zero means no limit.
+    // Both limits are taken from the first pass of a defragmentation and kept until it completes.
+    daxa_u64 max_bytes_per_pass;
+    // Maximum number of allocations moved by one pass. Zero means no limit.
+    daxa_u32 max_allocations_per_pass;
+    // Layout all movable images are in when the copies execute, the new images are left in it. Must not be UNDEFINED.
+    daxa_ImageLayout image_layout;
+} daxa_DefragmentationPassInfo;
+
+typedef struct
+{
+    daxa_Bool8 device_local;
+    daxa_u64 size;
+    // Budget and usage of the whole process, reported by VK_EXT_memory_budget when available, estimated otherwise.
+    daxa_u64 budget;
+    daxa_u64 usage;
+    // Memory allocated by daxa, block_bytes includes the free space of its memory blocks.
+    daxa_u64 block_bytes;
+    daxa_u64 allocation_bytes;
+} daxa_MemoryHeapReport;
+
+typedef enum
+{
+    DAXA_MEMORY_REPORT_RESOURCE_TYPE_BUFFER,
+    DAXA_MEMORY_REPORT_RESOURCE_TYPE_IMAGE,
+    DAXA_MEMORY_REPORT_RESOURCE_TYPE_MAX_ENUM = 0x7fffffff,
+} daxa_MemoryReportResourceType;
+
+typedef struct
+{
+    daxa_SmallString name;
+    daxa_MemoryReportResourceType type;
+    daxa_u64 size;
+} daxa_MemoryReportAllocation;
+
+#define DAXA_MEMORY_REPORT_MAX_HEAPS 16
+#define DAXA_MEMORY_REPORT_MAX_LARGEST_ALLOCATIONS 16
+
+typedef struct
+{
+    daxa_FixedList(daxa_MemoryHeapReport, DAXA_MEMORY_REPORT_MAX_HEAPS) heaps;
+    // Sizes of the allocations owned by resources, resources placed in memory blocks are counted in memory_block_bytes.
+    daxa_u64 buffer_bytes;
+    daxa_u64 image_bytes;
+    // Acceleration structures live in buffers, so their bytes are also part of buffer_bytes.
+    daxa_u64 acceleration_structure_bytes;
+    daxa_u64 memory_block_bytes;
+    daxa_u32 buffer_count;
+    daxa_u32 image_count;
+    daxa_u32 acceleration_structure_count;
+    // Sorted by size, largest first.
+    daxa_FixedList(daxa_MemoryReportAllocation, DAXA_MEMORY_REPORT_MAX_LARGEST_ALLOCATIONS) largest_allocations;
+} daxa_MemoryReport;
+
+// A device timestamp and the std::chrono::steady_clock time in nanoseconds, sampled at the same moment.
+typedef struct
+{
+    // Same clock as the timestamps of timeline query pools, in ticks of daxa_DeviceProperties::limits.timestamp_period nanoseconds.
+    daxa_u64 device_ticks;
+    daxa_u64 host_ns;
+    // Upper bound of the time between sampling the two clocks.
+    daxa_u64 max_deviation_ns;
+} daxa_CalibratedTimestamps;
+
+typedef struct
+{
+    char const * path;
+    // Also captures the contents of all buffers at the start of the capture and of host visible buffers before each submit.
+    // Without it, replays run on zeroed buffers, which is enough for commands that do not depend on the data.
+    daxa_Bool8 capture_buffer_contents;
+} daxa_CaptureInfo;
+
+typedef struct
+{
+    char const * path;
+    // The captured submits are replayed this many times, at least once.
+    daxa_u32 repeat_count;
+} daxa_ReplayInfo;
+
+typedef struct
+{
+    daxa_u32 buffer_count;
+    daxa_u32 image_count;
+    daxa_u32 image_view_count;
+    daxa_u32 sampler_count;
+    daxa_u32 pipeline_count;
+    daxa_u32 command_list_count;
+    daxa_u32 submit_count;
+    // Resources and pipelines of the capture that could not be recreated, commands using them are skipped.
+    daxa_u32 failed_creation_count;
+    daxa_u64 command_count;
+    // Commands that can not be captured, like acceleration structure builds, queries and secondary command lists.
+    daxa_u64 skipped_command_count;
+    // Command lists recorded before the capture began, or failing to record on replay. Submits skip them.
+    daxa_u64 skipped_command_list_count;
+    // Host time from the first submit of a repetition until the device is idle after the last one.
+    daxa_u64 min_ns;
+    daxa_u64 mean_ns;
+    daxa_u64 max_ns;
+} daxa_ReplayStats;
+
 typedef struct
 {
     daxa_BufferInfo buffer_info;
     daxa_MemoryBlock * memory_block;
     size_t offset;
+    // Only for device group devices. Every physical device accesses the memory instance of this physical device instead of its own.
+    // Supported peer accesses depend on the memory heap, see vkGetDeviceGroupPeerMemoryFeatures. Copy destinations work on at least one device local heap.
+    daxa_Optional(daxa_u32) peer_device_index;
 } daxa_MemoryBlockBufferInfo;
 
 static daxa_MemoryBlockBufferInfo const DAXA_DEFAULT_MEMORY_BLOCK_BUFFER_INFO = DAXA_ZERO_INIT;
@@ -427,6 +669,89 @@ typedef struct
 
 static daxa_MemoryBlockImageInfo const DAXA_DEFAULT_MEMORY_BLOCK_IMAGE_INFO = DAXA_ZERO_INIT;
 
+typedef struct
+{
+    VkExtent3D image_granularity;
+    daxa_Bool8 single_mip_tail;
+    // Mip levels at and above mip_tail_first_lod are bound as a whole with opaque binds.
+    uint32_t mip_tail_first_lod;
+    uint64_t mip_tail_size;
+    uint64_t mip_tail_offset;
+    uint64_t mip_tail_stride;
+} daxa_SparseImageMemoryRequirements;
+
+typedef struct
+{
+    daxa_IndirectCommandsLayout layout;
+    daxa_IndirectExecutionSet execution_set;
+    uint32_t max_sequence_count;
+    // Only used by layouts ending in DRAW_COUNT, DRAW_INDEXED_COUNT or DRAW_MESH_TASKS_COUNT tokens.
+    uint32_t max_draw_count;
+} daxa_GeneratedCommandsMemoryRequirementsInfo;
+
+typedef struct
+{
+    daxa_BufferId buffer;
+    uint64_t offset;
+    uint64_t size;
+    // Null unbinds the range.
+    daxa_MemoryBlock memory_block;
+    uint64_t memory_block_offset;
+} daxa_SparseBufferBind;
+
+// Binds memory to the opaque memory range of an image, used for the mip tail.
+typedef struct
+{
+    daxa_ImageId image;
+    uint64_t offset;
+    uint64_t size;
+    // Null unbinds the range.
+    daxa_MemoryBlock memory_block;
+    uint64_t memory_block_offset;
+} daxa_SparseImageOpaqueBind;
+
+// Offset and extent are in texels and must be multiples of the image granularity, except at the edges of the mip level.
+typedef struct
+{
+    daxa_ImageId image;
+    daxa_ImageSlice slice;
+    VkOffset3D offset;
+    VkExtent3D extent;
+    // Null unbinds the region.
+    daxa_MemoryBlock memory_block;
+    uint64_t memory_block_offset;
+} daxa_SparseImageBind;
+
+typedef struct
+{
+    daxa_Queue queue;
+    daxa_SparseBufferBind const * buffer_binds;
+    uint64_t buffer_bind_count;
+    daxa_SparseImageOpaqueBind const * image_opaque_binds;
+    uint64_t image_opaque_bind_count;
+    daxa_SparseImageBind const * image_binds;
+    uint64_t image_bind_count;
+    daxa_BinarySemaphore const * wait_binary_semaphores;
+    uint64_t wait_binary_semaphore_count;
+    daxa_BinarySemaphore const * signal_binary_semaphores;
+    uint64_t signal_binary_semaphore_count;
+    daxa_TimelinePair const * wait_timeline_semaphores;
+    uint64_t wait_timeline_semaphore_count;
+    daxa_TimelinePair const * signal_timeline_semaphores;
+    uint64_t signal_timeline_semaphore_count;
+} daxa_BindSparseInfo;
+
+static daxa_BindSparseInfo const DAXA_DEFAULT_BIND_SPARSE_INFO = DAXA_ZERO_INIT;
+
+// Byte range of a host visible buffer, offset is relative to the start of the buffer.
+// A size of VK_WHOLE_SIZE covers the rest of the buffer.
+typedef struct
+{
+    daxa_BufferId buffer;
+    uint64_t offset;
+    uint64_t size;
+} daxa_BufferRange;
+
 typedef struct
 {
     daxa_TlasInfo tlas_info;
@@ -452,21 +777,45 @@ typedef struct
     uint64_t build_scratch_size;
 } daxa_AccelerationStructureBuildSizesInfo;
 
+typedef struct
+{
+    uint64_t micromap_size;
+    uint64_t build_scratch_size;
+} daxa_MicromapBuildSizesInfo;
+
 DAXA_EXPORT VkMemoryRequirements
 daxa_dvc_buffer_memory_requirements(daxa_Device device, daxa_BufferInfo const * info);
 DAXA_EXPORT VkMemoryRequirements
 daxa_dvc_image_memory_requirements(daxa_Device device, daxa_ImageInfo const * info);
+/// @brief  Memory requirements of a buffer created with daxa_dvc_create_sparse_buffer. The alignment is the sparse page size.
+DAXA_EXPORT VkMemoryRequirements
+daxa_dvc_sparse_buffer_memory_requirements(daxa_Device device, daxa_BufferInfo const * info);
+/// @brief  Page granularity and mip tail of an image created with DAXA_IMAGE_FLAG_SPARSE_RESIDENCY, for its first aspect.
+///         The page size is the alignment reported by daxa_dvc_image_memory_requirements for the same info.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_sparse_image_memory_requirements(daxa_Device device, daxa_ImageInfo const * info, daxa_SparseImageMemoryRequirements * out_requirements);
+/// @brief  Memory requirements of the preprocess buffer range needed to execute generated commands with the given layout and execution set.
+///         Returns zeroed requirements when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS.
+DAXA_EXPORT VkMemoryRequirements
+daxa_dvc_generated_commands_memory_requirements(daxa_Device device, daxa_GeneratedCommandsMemoryRequirementsInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_memory(daxa_Device device, daxa_MemoryBlockInfo const * info, daxa_MemoryBlock * out_memory_block);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_get_tlas_build_sizes(daxa_Device device, daxa_TlasBuildInfo const * build_info, daxa_AccelerationStructureBuildSizesInfo * out);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_get_blas_build_sizes(daxa_Device device, daxa_BlasBuildInfo const * build_info, daxa_AccelerationStructureBuildSizesInfo * out);
+/// @return DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_get_micromap_build_sizes(daxa_Device device, daxa_MicromapBuildInfo const * build_info, daxa_MicromapBuildSizesInfo * out);
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_buffer(daxa_Device device, daxa_BufferInfo const * info, daxa_BufferId * out_id);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_image(daxa_Device device, daxa_ImageInfo const * info, daxa_ImageId * out_id);
+/// @brief  Creates a sparse resident buffer without memory, info->allocate_info is ignored.
+///         Memory is bound with daxa_dvc_bind_sparse.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_sparse_buffer(daxa_Device device, daxa_BufferInfo const * info, daxa_BufferId * out_id);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_buffer_from_memory_block(daxa_Device device, daxa_MemoryBlockBufferInfo const * info, daxa_BufferId * out_id);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -483,6 +832,18 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_tlas_from_buffer(daxa_Device device, daxa_BufferTlasInfo const * info, daxa_TlasId * out_id);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_blas_from_buffer(daxa_Device device, daxa_BufferBlasInfo const * info, daxa_BlasId * out_id);
+/// @brief  Creates all resources or none of them.
+///         Slots are reserved at once and all descriptors are written with a single vkUpdateDescriptorSets.
+///         Prefer these over many single creations when loading large amounts of resources.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_buffers(daxa_Device device, daxa_BufferInfo const * infos, size_t info_count, daxa_BufferId * out_ids);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_images(daxa_Device device, daxa_ImageInfo const * infos, size_t info_count, daxa_ImageId * out_ids);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_image_views(daxa_Device device, daxa_ImageViewInfo const * infos, size_t info_count, daxa_ImageViewId * out_ids);
+/// @brief  Creates all images or none of them, each bound to its memory block at its offset.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_images_from_block(daxa_Device device, daxa_MemoryBlockImageInfo const * infos, size_t info_count, daxa_ImageId * out_ids);
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_destroy_buffer(daxa_Device device, daxa_BufferId buffer);
@@ -496,6 +857,17 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_destroy_tlas(daxa_Device device, daxa_TlasId tlas);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_destroy_blas(daxa_Device device, daxa_BlasId blas);
+/// @brief  Destroys many resources with a single zombie lock acquisition and timeline read.
+///         Invalid ids are skipped, all valid ids are still destroyed.
+/// @return DAXA_RESULT_INVALID_*_ID when any id was invalid.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_destroy_buffers(daxa_Device device, daxa_BufferId const * buffers, size_t buffer_count);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_destroy_images(daxa_Device device, daxa_ImageId const * images, size_t image_count);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_destroy_image_views(daxa_Device device, daxa_ImageViewId const * ids, size_t id_count);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_destroy_samplers(daxa_Device device, daxa_SamplerId const * samplers, size_t sampler_count);
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_info_buffer(daxa_Device device, daxa_BufferId buffer, daxa_BufferInfo * out_info);
@@ -536,10 +908,53 @@ daxa_dvc_get_vk_tlas(daxa_Device device, daxa_TlasId tlas, VkAccelerationStructu
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_get_vk_blas(daxa_Device device, daxa_BlasId blas, VkAccelerationStructureInstanceKHR* out_vk_handle);
 
+// Per buffer data read by device and host address lookups.
+typedef struct
+{
+    daxa_DeviceAddress device_address;
+    void * host_address;
+} daxa_BufferHotSlot;
+
+// Read only view of the buffer slots of a device, read by the header only lookups in daxa/resource_pool_view.hpp.
+// Slots live in pages of 1 << page_bits slots. Pages are allocated on demand and are only freed with the device.
+// pages points to the page table, valid_page_count to the std::atomic_uint32_t counting the allocated pages.
+// The version of a slot is a std::atomic_uint64_t at versions_offset + slot * 8 in its page.
+typedef struct
+{
+    void const * const * pages;
+    void const * valid_page_count;
+    uint32_t page_bits;
+    uint32_t versions_offset;
+    uint32_t hot_slots_offset;
+    uint32_t slots_offset;
+    uint32_t slot_stride;
+} daxa_BufferPoolView;
+
+/// @brief  The view stays valid for the lifetime of the device.
+///         Each slot starts with its daxa_BufferInfo, the hot slots are daxa_BufferHotSlot.
+DAXA_EXPORT daxa_BufferPoolView
+daxa_dvc_buffer_pool_view(daxa_Device device);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_buffer_device_address(daxa_Device device, daxa_BufferId buffer, daxa_DeviceAddress * out_addr);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_buffer_host_address(daxa_Device device, daxa_BufferId buffer, void ** out_addr);
+/// @brief  Creates a new fd or win32 HANDLE referencing the memory of a resource allocated with an external_memory handle type.
+///         The caller owns the handle. The allocation size of images is given by daxa_dvc_image_memory_requirements.
+/// @return DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED when the memory was not allocated exportable.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_export_buffer_memory(daxa_Device device, daxa_BufferId buffer, uint64_t * out_handle);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_export_image_memory(daxa_Device device, daxa_ImageId image, uint64_t * out_handle);
+/// @brief  Makes host writes to the ranges visible to the device, with a single vmaFlushAllocations.
+///         Only needed for non coherent memory, ranges of coherent buffers are skipped by vma.
+/// @return DAXA_RESULT_BUFFER_NOT_HOST_VISIBLE when a buffer has no host address.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_flush_buffer_ranges(daxa_Device device, daxa_BufferRange const * ranges, uint32_t range_count);
+/// @brief  Makes device writes to the ranges visible to the host, with a single vmaInvalidateAllocations.
+///         The device writes must be complete and made available to the host, for example by waiting on the submit.
+/// @return DAXA_RESULT_BUFFER_NOT_HOST_VISIBLE when a buffer has no host address.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_invalidate_buffer_ranges(daxa_Device device, daxa_BufferRange const * ranges, uint32_t range_count);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_tlas_device_address(daxa_Device device, daxa_TlasId tlas, daxa_DeviceAddress * out_addr);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -549,6 +964,23 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo const * info, daxa_RasterPipeline * out_pipeline);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineInfo const * info, daxa_ComputePipeline * out_pipeline);
+/// @brief  Creates info_count compute pipelines, compiling them on multiple threads.
+///         Either all pipelines are created or none, on failure the result of the first failing info is returned.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_compute_pipelines(daxa_Device device, daxa_ComputePipelineInfo const * infos, size_t info_count, daxa_ComputePipeline * out_pipelines);
+/// @brief  Returns the pipeline without waiting for its compilation, which runs on a pool of device owned worker threads.
+///         The worker threads are started with the first asynchronous creation, half of the hardware threads are used.
+///         The byte code and specialization constants of the info are copied, they do not have to outlive the call.
+///         Until the pipeline is ready, command recorders bind the optional fallback in its place.
+///         Without a ready fallback only the pipeline layout is bound, so push constants still work,
+///         and draws and dispatches are skipped until the next pipeline bind, see daxa_CommandRecorderStats::skipped_pending_pipeline_commands.
+///         Query the compilation with daxa_compute_pipeline_status or wait for it with daxa_compute_pipeline_wait.
+///         Destroying a pending pipeline cancels its compilation when it has not started yet, otherwise it waits for it.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_compute_pipeline_async(daxa_Device device, daxa_ComputePipelineInfo const * info, daxa_ComputePipeline fallback, daxa_ComputePipeline * out_pipeline);
+/// @brief  Raster variant of daxa_dvc_create_compute_pipeline_async.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_raster_pipeline_async(daxa_Device device, daxa_RasterPipelineInfo const * info, daxa_RasterPipeline fallback, daxa_RasterPipeline * out_pipeline);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_ray_tracing_pipeline(daxa_Device device, daxa_RayTracingPipelineInfo const * info, daxa_RayTracingPipeline * out_pipeline);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -563,6 +995,29 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_event(daxa_Device device, daxa_EventInfo const * info, daxa_Event * out_event);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_timeline_query_pool(daxa_Device device, daxa_TimelineQueryPoolInfo const * info, daxa_TimelineQueryPool * out_timeline_query_pool);
+/// @return DAXA_RESULT_ERROR_INVALID_QUERY_TYPE when the type is neither occlusion nor pipeline statistics,
+///         DAXA_RESULT_ERROR_PIPELINE_STATISTICS_QUERY_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_STATISTICS_QUERY.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_query_pool(daxa_Device device, daxa_QueryPoolInfo const * info, daxa_QueryPool * out_query_pool);
+/// @return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS,
+///         DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT when the token list is malformed.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_indirect_commands_layout(daxa_Device device, daxa_IndirectCommandsLayoutInfo const * info, daxa_IndirectCommandsLayout * out_layout);
+/// @return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_indirect_execution_set(daxa_Device device, daxa_IndirectExecutionSetInfo const * info, daxa_IndirectExecutionSet * out_execution_set);
+/// @return DAXA_RESULT_ERROR_SHADER_OBJECT_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT,
+///         DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE when the stage is not a single supported shader stage.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_shader_object(daxa_Device device, daxa_ShaderObjectInfo const * info, daxa_ShaderObject * out_shader_object);
+/// @brief  Creates the micromap in a dedicated buffer of info->size bytes, see daxa_dvc_get_micromap_build_sizes.
+/// @return DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_micromap(daxa_Device device, daxa_MicromapInfo const * info, daxa_Micromap * out_micromap);
+/// @brief  Creates the session with its own memory and, when info->codec_parameters is set, its session parameters.
+/// @return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_VIDEO or the queue family of the codec operation.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_video_session(daxa_Device device, daxa_VideoSessionInfo const * info, daxa_VideoSession * out_video_session);
 
 DAXA_EXPORT VkDevice
 daxa_dvc_get_vk_device(daxa_Device device);
@@ -576,12 +1031,113 @@ daxa_dvc_queue_count(daxa_Device device, daxa_QueueFamily queue_family, daxa_u32
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_wait_idle(daxa_Device device);
+/// @brief  Waits until all, or any when wait_any is set, semaphores reach their values with a single vkWaitSemaphores.
+/// @return DAXA_RESULT_SUCCESS when the wait completed, DAXA_RESULT_TIMEOUT when the timeout expired first.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_wait_semaphores(daxa_Device device, daxa_TimelinePair const * pairs, size_t pair_count, daxa_Bool8 wait_any, uint64_t timeout);
+/// @brief  Called with reached set once the semaphore reached the value.
+///         On device destruction, callbacks still pending are called with reached unset, so that user_data can be freed.
+typedef void (*daxa_TimelineCallback)(void * user_data, daxa_Bool8 reached);
+/// @brief  Registers a callback that the device reactor thread calls once pair->semaphore reaches pair->value.
+///         The reactor thread is started on the first registration and waits on all pending callbacks with one vkWaitSemaphores.
+///         Callbacks run on the reactor thread and must not block, long running work should be handed to other threads.
+///         The semaphore is kept alive until the callback was called.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_on_timeline(daxa_Device device, daxa_TimelinePair const * pair, daxa_TimelineCallback callback, void * user_data);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_submit(daxa_Device device, daxa_CommandSubmitInfo const * info);
+/// @brief  Every submit takes the next value of the device submit timeline. Returns the value of the latest submit.
+DAXA_EXPORT uint64_t
+daxa_dvc_latest_submit_index(daxa_Device device);
+/// @brief  All submits up to and including out_index finished on the gpu.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_completed_submit_index(daxa_Device device, uint64_t * out_index);
+/// @brief  Submits all infos to the same queue with a single vkQueueSubmit2.
+///         Validation, the lifetime lock and the submit timeline bump happen once for the whole batch.
+///         All infos must target the same queue.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_submit_batch(daxa_Device device, daxa_CommandSubmitInfo const * infos, size_t info_count);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_present(daxa_Device device, daxa_PresentInfo const * info);
+/// @brief  Binds memory block ranges to sparse buffers and images on a queue with sparse binding support.
+///         Memory blocks must stay alive as long as they are bound.
+/// @return DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED when the device or the queue does not support sparse binding.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_bind_sparse(daxa_Device device, daxa_BindSparseInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_collect_garbage(daxa_Device device);
+/// @brief  Writes the pipeline cache to the pipeline cache directory of the device info. Also happens on device destruction.
+///         Does nothing when no directory is set.
+/// @return DAXA_RESULT_ERROR_PIPELINE_CACHE_WRITE_FAILED when the file could not be written.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_save_pipeline_cache(daxa_Device device);
+/// @brief  Destroys ready zombies until the budget in info is used up.
+///         Holds the resource lifetime lock exclusively for the whole call, creating command recorders and submitting block meanwhile.
+/// @return DAXA_RESULT_SUCCESS when all ready zombies were destroyed,
+///         DAXA_RESULT_INCOMPLETE when the budget ran out first,
+///         DAXA_RESULT_NOT_READY when info->non_blocking is set and the lifetime lock could not be taken.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_collect_garbage_incremental(daxa_Device device, daxa_GarbageCollectInfo const * info);
+
+/// @brief  Reports per heap budget and usage, per resource type totals and the largest resource allocations.
+///         Resources created or destroyed on other threads while the report is built may or may not be included.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_memory_report(daxa_Device device, daxa_MemoryReport * out_report);
+
+/// @brief  Samples the device timestamp clock together with the std::chrono::steady_clock of the host.
+///         Pairs of calibrations convert timeline query pool timestamps to host time and back.
+/// @return DAXA_RESULT_ERROR_CALIBRATED_TIMESTAMPS_NOT_SUPPORTED when the device lacks DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_calibrated_timestamps(daxa_Device device, daxa_CalibratedTimestamps * out_timestamps);
+
+/// @brief  Picks movable resources (DAXA_MEMORY_FLAG_MOVABLE) to compact the device memory, creates their new buffers and images
+///         and records the copies into info->command_recorder.
+///         Moved images are transitioned from info->image_layout for the copies, the new images are left in info->image_layout.
+///         Must be followed by daxa_dvc_end_defragmentation_pass after the recorded copies finished on the gpu.
+///         Until then, movable resources must not be used on the gpu or destroyed.
+/// @param out_move_count receives the number of resources moved by this pass. Zero means the memory is already compact.
+/// @return DAXA_RESULT_ERROR_DEFRAGMENTATION_PASS_MISMATCH when a pass was already begun and not ended yet,
+///         DAXA_RESULT_ERROR_INVALID_IMAGE_LAYOUT when info->image_layout is UNDEFINED.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_begin_defragmentation_pass(daxa_Device device, daxa_DefragmentationPassInfo const * info, daxa_u32 * out_move_count);
+/// @brief  Swaps the moved resources to their new buffers and images and frees the old allocations.
+///         Ids stay the same, descriptors are rewritten in place. Device addresses and host addresses of moved buffers change.
+/// @return DAXA_RESULT_SUCCESS when defragmentation is complete,
+///         DAXA_RESULT_INCOMPLETE when another pass can compact the memory further,
+///         DAXA_RESULT_ERROR_DEFRAGMENTATION_PASS_MISMATCH when no pass was begun.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_end_defragmentation_pass(daxa_Device device);
+
+/// @brief  Writes the resources alive at this point into the capture file at info->path.
+///         From then on, the device appends created resources and pipelines, submitted command lists and the submits themselves.
+///         Only command lists recorded after this call are captured.
+/// @return DAXA_RESULT_ERROR_DEVICE_NOT_CAPTURABLE when daxa_DeviceInfo2::capturable was not set,
+///         DAXA_RESULT_ERROR_CAPTURE_MISMATCH when a capture is already active,
+///         DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID when the file could not be written.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_begin_capture(daxa_Device device, daxa_CaptureInfo const * info);
+/// @return DAXA_RESULT_ERROR_CAPTURE_MISMATCH when no capture is active,
+///         DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID when writing the file failed at any point of the capture.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_end_capture(daxa_Device device);
+/// @brief  Recreates the resources and pipelines of a capture with their captured ids, records the captured command lists
+///         and replays the submits info->repeat_count times, waiting for the device to be idle after each repetition.
+///         Destroys everything it created before returning. Waits for the device to be idle.
+///         No other thread may create resources on the device during the replay.
+/// @return DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID when the file could not be read or is not a capture of this version,
+///         DAXA_RESULT_ERROR_REPLAY_ID_CONFLICT when ids of the capture are already taken on this device.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_replay_capture(daxa_Device device, daxa_ReplayInfo const * info, daxa_ReplayStats * out_stats);
+
+/// @brief  Sets the address of the ring that daxa_assert and daxa_printf in shaders write into, 0 disables them.
+///         The address is stored past the buffer addresses in the buffer device address buffer, shaders read it on every write.
+///         Takes effect for gpu work executing after the call, work that is already executing may see either address.
+///         See daxa::ShaderDebugRing for the layout of the ring and its readback.
+DAXA_EXPORT void
+daxa_dvc_set_shader_debug_address(daxa_Device device, daxa_DeviceAddress address);
+/// @brief  Returns the address last set with daxa_dvc_set_shader_debug_address, 0 when shader debug output is disabled.
+DAXA_EXPORT daxa_DeviceAddress
+daxa_dvc_shader_debug_address(daxa_Device device);
 
 DAXA_EXPORT daxa_DeviceInfo2 const *
 daxa_dvc_info(daxa_Device device);
@@ -31,16 +31,44 @@ typedef struct
     uint64_t address;
 } daxa_DeviceAddress;
 
+// Matches VkExternalMemoryHandleTypeFlagBits.
+typedef enum
+{
+    DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_NONE = 0,
+    DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD = 0x00000001,
+    DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32 = 0x00000002,
+    DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF = 0x00000200,
+    DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_MAX_ENUM = 0x7FFFFFFF,
+} daxa_ExternalMemoryHandleType;
+
+// Memory shared with other apis or processes, for example CUDA or a hardware video decoder.
+// External resources get a dedicated device local allocation, they can not be sparse or placed in a memory block.
+typedef struct
+{
+    daxa_ExternalMemoryHandleType handle_type;
+    // Without a value the memory is allocated exportable, see daxa_dvc_export_buffer_memory and daxa_dvc_export_image_memory.
+    // With a value the memory is imported from this fd or win32 HANDLE. A successful fd import transfers ownership of the fd to the device.
+    daxa_Optional(uint64_t) import_handle;
+} daxa_ExternalMemoryInfo;
+
 typedef struct
 {
     size_t size;
-    // Ignored when allocating with a memory block.
+    // Ignored when allocating with a memory block or external memory.
     daxa_MemoryFlags allocate_info;
     daxa_SmallString name;
+    daxa_ExternalMemoryInfo external_memory;
+    // Adds the video decode and encode usages for bitstream buffers and creates the buffer independent of any video profile.
+    // Requires DAXA_IMPLICIT_FEATURE_FLAG_VIDEO.
+    daxa_Bool8 video_bitstream;
 } daxa_BufferInfo;
 
 typedef uint32_t daxa_ImageFlags;
 static daxa_ImageFlags const DAXA_IMAGE_FLAG_NONE = 0x00000000;
+// Sparse images get no memory on creation, memory is bound with daxa_dvc_bind_sparse.
+static daxa_ImageFlags const DAXA_IMAGE_FLAG_SPARSE_BINDING = 0x00000001;
+static daxa_ImageFlags const DAXA_IMAGE_FLAG_SPARSE_RESIDENCY = 0x00000002;
+static daxa_ImageFlags const DAXA_IMAGE_FLAG_SPARSE_ALIASED = 0x00000004;
 static daxa_ImageFlags const DAXA_IMAGE_FLAG_ALLOW_MUTABLE_FORMAT = 0x00000008;
 static daxa_ImageFlags const DAXA_IMAGE_FLAG_COMPATIBLE_CUBE = 0x00000010;
 static daxa_ImageFlags const DAXA_IMAGE_FLAG_COMPATIBLE_2D_ARRAY = 0x00000020;
@@ -57,6 +85,13 @@ static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_DEPTH_STENCIL_ATTACHMENT =
 static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_TRANSIENT_ATTACHMENT = 0x00000040;
 static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_FRAGMENT_DENSITY_MAP = 0x00000200;
 static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_FRAGMENT_SHADING_RATE_ATTACHMENT = 0x00000100;
+// Video usages require DAXA_IMPLICIT_FEATURE_FLAG_VIDEO, DPB images also need daxa_ImageInfo::video_profile.
+static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_VIDEO_DECODE_DST = 0x00000400;
+static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_VIDEO_DECODE_SRC = 0x00000800;
+static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_VIDEO_DECODE_DPB = 0x00001000;
+static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_VIDEO_ENCODE_DST = 0x00002000;
+static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_VIDEO_ENCODE_SRC = 0x00004000;
+static daxa_ImageUsageFlags const DAXA_IMAGE_USE_FLAG_VIDEO_ENCODE_DPB = 0x00008000;
 
 typedef enum
 {
@@ -75,9 +110,13 @@ typedef struct
     uint32_t sample_count;
     daxa_ImageUsageFlags usage;
     daxa_SharingMode sharing_mode;
-    // Ignored when allocating with a memory block.
+    // Ignored when allocating with a memory block or external memory.
     daxa_MemoryFlags allocate_info;
     daxa_SmallString name;
+    // DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF images are created with linear tiling.
+    daxa_ExternalMemoryInfo external_memory;
+    // Only used with video usages. DAXA_VIDEO_CODEC_OPERATION_NONE creates a video profile independent image, which can not be used as DPB.
+    daxa_VideoProfileInfo video_profile;
 } daxa_ImageInfo;
 
 typedef struct
@@ -114,6 +153,8 @@ static daxa_BufferInfo const DAXA_DEFAULT_BUFFER_INFO = {
     .size = 0,
     .allocate_info = DAXA_MEMORY_FLAG_NONE,
     .name = {.data = DAXA_ZERO_INIT, .size = 0},
+    .external_memory = {.handle_type = DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_NONE},
+    .video_bitstream = 0,
 };
 static daxa_ImageInfo const DAXA_DEFAULT_IMAGE_INFO = {
     .flags = 0,
@@ -127,6 +168,8 @@ static daxa_ImageInfo const DAXA_DEFAULT_IMAGE_INFO = {
     .sharing_mode = DAXA_SHARING_MODE_EXCLUSIVE,
     .allocate_info = DAXA_MEMORY_FLAG_NONE,
     .name = {.data = DAXA_ZERO_INIT, .size = 0},
+    .external_memory = {.handle_type = DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_NONE},
+    .video_profile = {.codec_operation = DAXA_VIDEO_CODEC_OPERATION_NONE},
 };
 static daxa_ImageViewInfo const DAXA_DEFAULT_IMAGE_VIEW_INFO = {
     .type = VK_IMAGE_VIEW_TYPE_2D,
@@ -156,6 +199,100 @@ static daxa_SamplerInfo const DAXA_DEFAULT_SAMPLER_INFO = {
 DAXA_EXPORT VmaAllocation
 daxa_memory_block_get_vma_allocation(daxa_MemoryBlock memory_block);
 
+// OPACITY MICROMAPS
+// Per micro triangle opacity of blas triangles, lets traversal skip any hit shaders for fully opaque or transparent micro triangles.
+// Require DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP.
+typedef struct
+{
+    uint64_t size;
+    daxa_SmallString name;
+} daxa_MicromapInfo;
+
+static daxa_MicromapInfo const DAXA_DEFAULT_MICROMAP_INFO = {
+    .size = DAXA_ZERO_INIT,
+    .name = {
+        .data = DAXA_ZERO_INIT,
+        .size = 0,
+    },
+};
+
+typedef struct
+{
+    VkBuildMicromapFlagsEXT flags;
+    daxa_Micromap dst_micromap;
+    // Number of triangles per subdivision level and format contained in data.
+    VkMicromapUsageEXT const * usage_counts;
+    size_t usage_count;
+    // Packed opacity values of all triangles.
+    daxa_DeviceAddress data;
+    // Array of VkMicromapTriangleEXT, giving the offset into data, subdivision level and format of each triangle.
+    daxa_DeviceAddress triangle_array;
+    uint64_t triangle_array_stride;
+    daxa_DeviceAddress scratch_data;
+} daxa_MicromapBuildInfo;
+
+static daxa_MicromapBuildInfo const DAXA_DEFAULT_MICROMAP_BUILD_INFO = {
+    .flags = VK_BUILD_MICROMAP_PREFER_FAST_TRACE_BIT_EXT,
+    .dst_micromap = DAXA_ZERO_INIT,
+    .usage_counts = DAXA_ZERO_INIT,
+    .usage_count = 0,
+    .data = DAXA_ZERO_INIT,
+    .triangle_array = DAXA_ZERO_INIT,
+    .triangle_array_stride = sizeof(VkMicromapTriangleEXT),
+    .scratch_data = DAXA_ZERO_INIT,
+};
+
+DAXA_EXPORT daxa_MicromapInfo const *
+daxa_micromap_info(daxa_Micromap micromap);
+// Buffer backing the micromap, destroyed together with it. Task graphs track micromap builds and blas build reads through it.
+DAXA_EXPORT daxa_BufferId
+daxa_micromap_buffer_id(daxa_Micromap micromap);
+
+DAXA_EXPORT uint64_t
+daxa_micromap_inc_refcnt(daxa_Micromap micromap);
+DAXA_EXPORT uint64_t
+daxa_micromap_dec_refcnt(daxa_Micromap micromap);
+
+// VIDEO SESSIONS
+// Decoder or encoder state of one video stream, used by the video coding commands of recorders on the video queues.
+// Require DAXA_IMPLICIT_FEATURE_FLAG_VIDEO.
+typedef struct
+{
+    // Decode profiles create a session for the video decode queue, encode profiles one for the video encode queue.
+    daxa_VideoProfileInfo profile;
+    VkFormat picture_format;
+    VkExtent2D max_coded_extent;
+    VkFormat reference_picture_format;
+    uint32_t max_dpb_slots;
+    uint32_t max_active_reference_pictures;
+    // Optional codec specific VkVideo{Decode,Encode}{H264,H265}SessionParametersCreateInfoKHR holding the parameter sets of the stream.
+    // Only read during creation. Without it the session has no parameters object.
+    void const * codec_parameters;
+    daxa_SmallString name;
+} daxa_VideoSessionInfo;
+
+static daxa_VideoSessionInfo const DAXA_DEFAULT_VIDEO_SESSION_INFO = {
+    .profile = {.codec_operation = DAXA_VIDEO_CODEC_OPERATION_NONE},
+    .picture_format = VK_FORMAT_G8_B8R8_2PLANE_420_UNORM,
+    .max_coded_extent = {0, 0},
+    .reference_picture_format = VK_FORMAT_G8_B8R8_2PLANE_420_UNORM,
+    .max_dpb_slots = 0,
+    .max_active_reference_pictures = 0,
+    .codec_parameters = DAXA_ZERO_INIT,
+    .name = {
+        .data = DAXA_ZERO_INIT,
+        .size = 0,
+    },
+};
+
+DAXA_EXPORT daxa_VideoSessionInfo const *
+daxa_video_session_info(daxa_VideoSession video_session);
+
+DAXA_EXPORT uint64_t
+daxa_video_session_inc_refcnt(daxa_VideoSession video_session);
+DAXA_EXPORT uint64_t
+daxa_video_session_dec_refcnt(daxa_VideoSession video_session);
+
 typedef enum
 {
     DAXA_GEOMETRY_OPAQUE = 0x1 << 0,
@@ -175,6 +312,16 @@ typedef struct
     daxa_DeviceAddress transform_data;
     uint32_t count;
     daxa_GeometryFlags flags;
+    // Optional, requires DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP.
+    // Triangles pick their micromap triangle from opacity_micromap_index_data, offset by opacity_micromap_base_triangle.
+    // Negative indices of VkOpacityMicromapSpecialIndexEXT mark whole triangles as opaque or transparent.
+    daxa_Micromap opacity_micromap;
+    VkMicromapUsageEXT const * opacity_micromap_usage_counts;
+    size_t opacity_micromap_usage_count;
+    VkIndexType opacity_micromap_index_type;
+    daxa_DeviceAddress opacity_micromap_index_data;
+    uint64_t opacity_micromap_index_stride;
+    uint32_t opacity_micromap_base_triangle;
 } daxa_BlasTriangleGeometryInfo;
 
 static daxa_BlasTriangleGeometryInfo const DAXA_DEFAULT_BLAS_TRIANGLE_GEPMETRY_INFO = {
@@ -187,6 +334,13 @@ static daxa_BlasTriangleGeometryInfo const DAXA_DEFAULT_BLAS_TRIANGLE_GEPMETRY_I
     .transform_data = DAXA_ZERO_INIT,
     .count = 0,
     .flags = DAXA_GEOMETRY_OPAQUE,
+    .opacity_micromap = DAXA_ZERO_INIT,
+    .opacity_micromap_usage_counts = DAXA_ZERO_INIT,
+    .opacity_micromap_usage_count = 0,
+    .opacity_micromap_index_type = VK_INDEX_TYPE_UINT32,
+    .opacity_micromap_index_data = DAXA_ZERO_INIT,
+    .opacity_micromap_index_stride = 4,
+    .opacity_micromap_base_triangle = 0,
 };
 
 typedef struct
@@ -251,6 +405,8 @@ typedef uint32_t daxa_BuildAcclelerationStructureFlags;
 typedef struct
 {
     daxa_BuildAcclelerationStructureFlags flags;
+    // Refits src_tlas into dst_tlas, both built with the same flags including DAXA_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE.
+    // A null src_tlas refits dst_tlas in place.
     daxa_Bool8 update;
     daxa_TlasId src_tlas;
     daxa_TlasId dst_tlas;
@@ -272,6 +428,8 @@ static daxa_TlasBuildInfo const DAXA_DEFAULT_TLAS_BUILD_INFO = {
 typedef struct
 {
     daxa_BuildAcclelerationStructureFlags flags;
+    // Refits src_blas into dst_blas, both built with the same flags including DAXA_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE.
+    // A null src_blas refits dst_blas in place. Geometry and primitive counts must match the original build.
     daxa_Bool8 update;
     daxa_BlasId src_blas;
     daxa_BlasId dst_blas;
@@ -3,6 +3,13 @@
 
 #include <daxa/c/types.h>
 
+// Values are bit casted to the 32 bit type of the constant (bool, int, uint or float).
+typedef struct
+{
+    uint32_t constant_id;
+    uint32_t value;
+} daxa_SpecializationConstant;
+
 typedef struct
 {
     uint32_t const * byte_code;
@@ -10,8 +17,21 @@ typedef struct
     VkPipelineShaderStageCreateFlags create_flags;
     daxa_Optional(uint32_t) required_subgroup_size;
     daxa_SmallString entry_point;
+    // Constant ids must be unique.
+    daxa_SpanToConst(daxa_SpecializationConstant) specialization_constants;
 } daxa_ShaderInfo;
 
+// Compilation state of pipelines created with daxa_dvc_create_compute_pipeline_async or daxa_dvc_create_raster_pipeline_async.
+// All other pipelines are READY from their creation on.
+typedef enum
+{
+    DAXA_PIPELINE_STATUS_PENDING = 0,
+    DAXA_PIPELINE_STATUS_READY = 1,
+    // The compilation failed, the pipeline stays unusable. daxa_compute_pipeline_wait returns the error.
+    DAXA_PIPELINE_STATUS_FAILED = 2,
+    DAXA_PIPELINE_STATUS_MAX_ENUM = 0x7fffffff,
+} daxa_PipelineStatus;
+
 // RAY TRACING PIPELINE
 typedef struct
 {
@@ -72,10 +92,19 @@ typedef struct
     daxa_ShaderInfo shader_info;
     uint32_t push_constant_size;
     daxa_SmallString name;
+    // Allows placing the pipeline in indirect execution sets. Requires DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS.
+    daxa_Bool8 indirect_bindable;
 } daxa_ComputePipelineInfo;
 
 DAXA_EXPORT daxa_ComputePipelineInfo const *
 daxa_compute_pipeline_info(daxa_ComputePipeline compute_pipeline);
+/// @brief  Never waits.
+DAXA_EXPORT daxa_PipelineStatus
+daxa_compute_pipeline_status(daxa_ComputePipeline compute_pipeline);
+/// @brief  Blocks until the pipeline is no longer pending.
+/// @return DAXA_RESULT_SUCCESS when it is ready, otherwise the error its compilation failed with.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_compute_pipeline_wait(daxa_ComputePipeline compute_pipeline);
 
 DAXA_EXPORT uint64_t
 daxa_compute_pipeline_inc_refcnt(daxa_ComputePipeline pipeline);
@@ -176,6 +205,18 @@ typedef struct
     VkTessellationDomainOrigin origin;
 } daxa_TesselationInfo;
 
+typedef enum
+{
+    // All state is compiled into one pipeline.
+    DAXA_RASTER_PIPELINE_LINK_MODE_MONOLITHIC = 0,
+    // The vertex input, pre-rasterization, fragment shader and fragment output parts are compiled as separate pipeline libraries.
+    // Parts are cached on the device, pipelines sharing a part only compile the parts that differ and are linked without optimization.
+    DAXA_RASTER_PIPELINE_LINK_MODE_FAST_LINK = 1,
+    // Same parts as FAST_LINK, linked with link time optimization. Slower to create, as fast to execute as a monolithic pipeline.
+    DAXA_RASTER_PIPELINE_LINK_MODE_OPTIMIZED_LINK = 2,
+    DAXA_RASTER_PIPELINE_LINK_MODE_MAX_ENUM = 0x7fffffff,
+} daxa_RasterPipelineLinkMode;
+
 typedef struct
 {
     daxa_Optional(daxa_ShaderInfo) mesh_shader_info;
@@ -190,14 +231,128 @@ typedef struct
     daxa_RasterizerInfo raster;
     uint32_t push_constant_size;
     daxa_SmallString name;
+    // Allows placing the pipeline in indirect execution sets. Requires DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS.
+    daxa_Bool8 indirect_bindable;
+    // Falls back to MONOLITHIC without DAXA_IMPLICIT_FEATURE_FLAG_GRAPHICS_PIPELINE_LIBRARY, without fast linking support and for indirect bindable pipelines.
+    daxa_RasterPipelineLinkMode link_mode;
 } daxa_RasterPipelineInfo;
 
 DAXA_EXPORT daxa_RasterPipelineInfo const *
 daxa_raster_pipeline_info(daxa_RasterPipeline raster_pipeline);
+/// @brief  Never waits.
+DAXA_EXPORT daxa_PipelineStatus
+daxa_raster_pipeline_status(daxa_RasterPipeline raster_pipeline);
+/// @brief  Blocks until the pipeline is no longer pending.
+/// @return DAXA_RESULT_SUCCESS when it is ready, otherwise the error its compilation failed with.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_raster_pipeline_wait(daxa_RasterPipeline raster_pipeline);
 
 DAXA_EXPORT uint64_t
 daxa_raster_pipeline_inc_refcnt(daxa_RasterPipeline pipeline);
 DAXA_EXPORT uint64_t
 daxa_raster_pipeline_dec_refcnt(daxa_RasterPipeline pipeline);
 
+// DEVICE GENERATED COMMANDS
+// Values match VkIndirectCommandsTokenTypeEXT.
+typedef enum
+{
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_EXECUTION_SET = 0,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_PUSH_CONSTANT = 1,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_SEQUENCE_INDEX = 2,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_INDEX_BUFFER = 3,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_INDEXED = 5,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW = 6,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_INDEXED_COUNT = 7,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_COUNT = 8,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DISPATCH = 9,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_MESH_TASKS = 1000328000,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_MESH_TASKS_COUNT = 1000328001,
+    DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_MAX_ENUM = 0x7fffffff,
+} daxa_IndirectCommandsTokenType;
+
+typedef struct
+{
+    daxa_IndirectCommandsTokenType type;
+    // Byte offset of the token data within one sequence of the indirect buffer.
+    uint32_t offset;
+    // Only used by PUSH_CONSTANT and SEQUENCE_INDEX tokens.
+    uint32_t push_constant_offset;
+    uint32_t push_constant_size;
+} daxa_IndirectCommandsToken;
+
+// Tokens must contain exactly one EXECUTION_SET token as the first token and end with exactly one action token (draw or dispatch).
+// The shader stages are derived from the action token.
+typedef struct
+{
+    daxa_IndirectCommandsToken const * tokens;
+    uint64_t token_count;
+    // Byte stride between sequences in the indirect buffer.
+    uint32_t indirect_stride;
+    // Push constant size of all pipelines used with this layout.
+    uint32_t push_constant_size;
+    daxa_Bool8 unordered_sequences;
+    daxa_SmallString name;
+} daxa_IndirectCommandsLayoutInfo;
+
+DAXA_EXPORT daxa_IndirectCommandsLayoutInfo const *
+daxa_indirect_commands_layout_info(daxa_IndirectCommandsLayout layout);
+
+DAXA_EXPORT uint64_t
+daxa_indirect_commands_layout_inc_refcnt(daxa_IndirectCommandsLayout layout);
+DAXA_EXPORT uint64_t
+daxa_indirect_commands_layout_dec_refcnt(daxa_IndirectCommandsLayout layout);
+
+// Exactly one of the initial pipelines must be set. It occupies index 0 of the set.
+// All pipelines in the set must be created with indirect_bindable and share the same push constant size.
+// Asynchronously created pipelines must be ready, otherwise DAXA_RESULT_ERROR_PIPELINE_NOT_READY is returned.
+typedef struct
+{
+    daxa_ComputePipeline initial_compute_pipeline;
+    daxa_RasterPipeline initial_raster_pipeline;
+    uint32_t max_pipeline_count;
+    daxa_SmallString name;
+} daxa_IndirectExecutionSetInfo;
+
+DAXA_EXPORT daxa_IndirectExecutionSetInfo const *
+daxa_indirect_execution_set_info(daxa_IndirectExecutionSet execution_set);
+/// @brief  Writes a compute pipeline into the execution set. The set keeps the pipeline alive until it is overwritten or the set is destroyed.
+///         The slot must not be in use by any pending execution.
+/// @return DAXA_RESULT_RANGE_OUT_OF_BOUNDS when index is not smaller than max_pipeline_count,
+///         DAXA_RESULT_ERROR_PIPELINE_NOT_READY when the pipeline is still pending or failed.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_indirect_execution_set_write_compute_pipeline(daxa_IndirectExecutionSet execution_set, uint32_t index, daxa_ComputePipeline pipeline);
+/// @brief  Writes a raster pipeline into the execution set. The set keeps the pipeline alive until it is overwritten or the set is destroyed.
+///         The slot must not be in use by any pending execution.
+/// @return DAXA_RESULT_RANGE_OUT_OF_BOUNDS when index is not smaller than max_pipeline_count,
+///         DAXA_RESULT_ERROR_PIPELINE_NOT_READY when the pipeline is still pending or failed.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_indirect_execution_set_write_raster_pipeline(daxa_IndirectExecutionSet execution_set, uint32_t index, daxa_RasterPipeline pipeline);
+
+DAXA_EXPORT uint64_t
+daxa_indirect_execution_set_inc_refcnt(daxa_IndirectExecutionSet execution_set);
+DAXA_EXPORT uint64_t
+daxa_indirect_execution_set_dec_refcnt(daxa_IndirectExecutionSet execution_set);
+
+// SHADER OBJECTS
+// A single shader stage compiled without any pipeline state. All fixed function state is given when the shader objects are bound.
+typedef struct
+{
+    daxa_ShaderInfo shader_info;
+    // One of VERTEX, TESSELLATION_CONTROL, TESSELLATION_EVALUATION, FRAGMENT, TASK, MESH or COMPUTE.
+    VkShaderStageFlagBits stage;
+    // All shader objects bound together must share the same push constant size.
+    uint32_t push_constant_size;
+    // Mesh shaders only. Mesh shaders created with it must be bound without a task shader, all others require one.
+    daxa_Bool8 no_task_shader;
+    daxa_SmallString name;
+} daxa_ShaderObjectInfo;
+
+DAXA_EXPORT daxa_ShaderObjectInfo const *
+daxa_shader_object_info(daxa_ShaderObject shader_object);
+
+DAXA_EXPORT uint64_t
+daxa_shader_object_inc_refcnt(daxa_ShaderObject shader_object);
+DAXA_EXPORT uint64_t
+daxa_shader_object_dec_refcnt(daxa_ShaderObject shader_object);
+
 #endif // #ifndef __DAXA_PIPELINE_H__
@@ -0,0 +1,31 @@
+#ifndef __DAXA_PROFILING_H__
+#define __DAXA_PROFILING_H__
+
+#include <daxa/c/types.h>
+
+// Number of finished zones the builtin recorder keeps, older zones are overwritten.
+#define DAXA_PROFILE_ZONE_RING_CAPACITY 16384
+
+// A cpu zone of daxa, recorded by the builtin recorder when daxa is built with DAXA_ENABLE_PROFILING_BUILTIN.
+typedef struct
+{
+    // Static string, stays valid for the lifetime of the program.
+    char const * name;
+    // std::chrono::steady_clock nanoseconds.
+    daxa_u64 begin_ns;
+    daxa_u64 end_ns;
+    // Dense index of the recording thread, assigned in order of the first zone of each thread.
+    daxa_u32 thread_index;
+    // Number of zones this zone is nested in on its thread.
+    daxa_u32 depth;
+} daxa_ProfileZone;
+
+/// @brief  Copies the zones finished since the last call into out_zones, oldest first.
+///         Without the builtin recorder no zones are recorded and inout_count is always set to zero.
+///         Zones that are overwritten before they are collected are lost.
+/// @param  inout_count capacity of out_zones, receives the number of copied zones.
+/// @return DAXA_RESULT_INCOMPLETE when out_zones was filled before all zones were collected.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_collect_profile_zones(daxa_ProfileZone * out_zones, daxa_u32 * inout_count);
+
+#endif // #ifndef __DAXA_PROFILING_H__
@@ -22,6 +22,48 @@ typedef enum
     DAXA_NATIVE_WINDOW_PLATFORM_MAX_ENUM = 0x7fffffff,
 } daxa_NativeWindowPlatform;
 
+// Unsupported modes fall back to the next lower mode the device supports.
+typedef enum
+{
+    // Frames are only limited by max_allowed_frames_in_flight.
+    DAXA_SWAPCHAIN_LATENCY_MODE_DEFAULT,
+    // daxa_swp_wait_for_frame_start waits until the frame max_allowed_frames_in_flight frames back is on screen.
+    // Requires DAXA_IMPLICIT_FEATURE_FLAG_PRESENT_WAIT.
+    DAXA_SWAPCHAIN_LATENCY_MODE_PRESENT_WAIT,
+    // daxa_swp_wait_for_frame_start sleeps until the driver reported optimal cpu start time (VK_NV_low_latency2).
+    // Requires DAXA_IMPLICIT_FEATURE_FLAG_LOW_LATENCY.
+    DAXA_SWAPCHAIN_LATENCY_MODE_LOW_LATENCY,
+    DAXA_SWAPCHAIN_LATENCY_MODE_MAX_ENUM = 0x7fffffff,
+} daxa_SwapchainLatencyMode;
+
+#define DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT 64
+
+/// @brief  Timings of one presented frame, all times are in nanoseconds.
+///         Timestamps use the monotonic clock of the presentation engine (CLOCK_MONOTONIC on linux).
+///         Values that are not known (yet) are 0.
+typedef struct
+{
+    // Cpu timeline value of the frame. 0 for unused entries.
+    uint64_t frame_index;
+    // Time acquire blocked on the frames in flight limit plus vkAcquireNextImageKHR.
+    uint64_t acquire_wait_ns;
+    // Time from the end of acquire to the present call.
+    uint64_t cpu_frame_time_ns;
+    // Time from the present call until the gpu timeline semaphore reached frame_index.
+    // Observed by polling in acquire, so it is rounded up to the acquire granularity.
+    uint64_t gpu_completion_time_ns;
+    // Timestamp of the present call.
+    uint64_t present_call_time_ns;
+    // Timestamp of the frame reaching the display.
+    // Exact with DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING, observed when daxa_swp_wait_for_frame_start returns in DAXA_SWAPCHAIN_LATENCY_MODE_PRESENT_WAIT.
+    uint64_t actual_present_time_ns;
+    // Earliest timestamp the frame could have been displayed at, a later actual_present_time_ns means the frame missed refresh cycles.
+    // Requires DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING.
+    uint64_t earliest_present_time_ns;
+    // Requires DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING.
+    uint64_t refresh_duration_ns;
+} daxa_SwapchainFrameStatistics;
+
 typedef struct
 {
     daxa_NativeWindowHandle native_window;
@@ -33,6 +75,7 @@ typedef struct
     size_t max_allowed_frames_in_flight;
     daxa_QueueFamily queue_family;
     daxa_SmallString name;
+    daxa_SwapchainLatencyMode latency_mode;
 } daxa_SwapchainInfo;
 
 DAXA_EXPORT VkExtent2D
@@ -44,6 +87,11 @@ daxa_swp_resize(daxa_Swapchain swapchain);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_swp_set_present_mode(daxa_Swapchain swapchain, VkPresentModeKHR present_mode);
 
+/// @brief  Blocks until the cpu should start simulating the next frame, depending on the latency mode.
+///         Call it right before sampling input, ahead of acquiring the next image.
+///         Does nothing in DAXA_SWAPCHAIN_LATENCY_MODE_DEFAULT.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_swp_wait_for_frame_start(daxa_Swapchain swapchain);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_swp_acquire_next_image(daxa_Swapchain swapchain, daxa_ImageId * out_image_id);
 DAXA_EXPORT daxa_BinarySemaphore *
@@ -54,6 +102,11 @@ DAXA_EXPORT uint64_t
 daxa_swp_current_cpu_timeline_value(daxa_Swapchain swapchain);
 DAXA_EXPORT daxa_TimelineSemaphore *
 daxa_swp_gpu_timeline_semaphore(daxa_Swapchain swapchain);
+/// @brief  Returns a ring of DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT entries, frame n is stored at n % DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT.
+///         Entries are filled in over the following frames, as gpu completion and display times become known.
+///         The pointer stays valid for the lifetime of the swapchain.
+DAXA_EXPORT daxa_SwapchainFrameStatistics const *
+daxa_swp_frame_statistics(daxa_Swapchain swapchain);
 
 DAXA_EXPORT daxa_SwapchainInfo const *
 daxa_swp_info(daxa_Swapchain swapchain);
@@ -37,6 +37,9 @@ static daxa_Access const DAXA_ACCESS_TASK_SHADER_READ = {.stages = VK_PIPELINE_S
 static daxa_Access const DAXA_ACCESS_MESH_SHADER_READ = {.stages = VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT, .access_type = VK_ACCESS_2_MEMORY_READ_BIT};
 static daxa_Access const DAXA_ACCESS_ACCELERATION_STRUCTURE_BUILD_READ = {.stages = VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_READ_BIT};
 static daxa_Access const DAXA_ACCESS_RAY_TRACING_SHADER_READ = {.stages = VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_READ_BIT};
+static daxa_Access const DAXA_ACCESS_MICROMAP_BUILD_READ = {.stages = VK_PIPELINE_STAGE_2_MICROMAP_BUILD_BIT_EXT, .access_type = VK_ACCESS_2_MEMORY_READ_BIT};
+static daxa_Access const DAXA_ACCESS_VIDEO_DECODE_READ = {.stages = VK_PIPELINE_STAGE_2_VIDEO_DECODE_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_READ_BIT};
+static daxa_Access const DAXA_ACCESS_VIDEO_ENCODE_READ = {.stages = VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_READ_BIT};
 
 static daxa_Access const DAXA_ACCESS_TOP_OF_PIPE_WRITE = {.stages = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
 static daxa_Access const DAXA_ACCESS_DRAW_INDIRECT_WRITE = {.stages = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
@@ -64,6 +67,9 @@ static daxa_Access const DAXA_ACCESS_TASK_SHADER_WRITE = {.stages = VK_PIPELINE_
 static daxa_Access const DAXA_ACCESS_MESH_SHADER_WRITE = {.stages = VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
 static daxa_Access const DAXA_ACCESS_ACCELERATION_STRUCTURE_BUILD_WRITE = {.stages = VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
 static daxa_Access const DAXA_ACCESS_RAY_TRACING_SHADER_WRITE = {.stages = VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
+static daxa_Access const DAXA_ACCESS_MICROMAP_BUILD_WRITE = {.stages = VK_PIPELINE_STAGE_2_MICROMAP_BUILD_BIT_EXT, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
+static daxa_Access const DAXA_ACCESS_VIDEO_DECODE_WRITE = {.stages = VK_PIPELINE_STAGE_2_VIDEO_DECODE_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
+static daxa_Access const DAXA_ACCESS_VIDEO_ENCODE_WRITE = {.stages = VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR, .access_type = VK_ACCESS_2_MEMORY_WRITE_BIT};
 
 static daxa_Access const DAXA_ACCESS_TOP_OF_PIPE_READ_WRITE = {.stages = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, .access_type = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT};
 static daxa_Access const DAXA_ACCESS_DRAW_INDIRECT_READ_WRITE = {.stages = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, .access_type = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT};
@@ -124,10 +130,29 @@ daxa_binary_semaphore_inc_refcnt(daxa_BinarySemaphore binary_semaphore);
 DAXA_EXPORT uint64_t
 daxa_binary_semaphore_dec_refcnt(daxa_BinarySemaphore binary_semaphore);
 
+// Matches VkExternalSemaphoreHandleTypeFlagBits.
+typedef enum
+{
+    DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_NONE = 0,
+    DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD = 0x00000001,
+    DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32 = 0x00000002,
+    DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_MAX_ENUM = 0x7FFFFFFF,
+} daxa_ExternalSemaphoreHandleType;
+
+// Timeline semaphore shared with other apis or processes, for example a CUDA external semaphore.
+typedef struct
+{
+    daxa_ExternalSemaphoreHandleType handle_type;
+    // Without a value the semaphore is created exportable, see daxa_timeline_semaphore_export_handle.
+    // With a value the payload is imported from this fd or win32 HANDLE. A successful fd import transfers ownership of the fd to the device.
+    daxa_Optional(uint64_t) import_handle;
+} daxa_ExternalSemaphoreInfo;
+
 typedef struct
 {
     uint64_t initial_value;
     daxa_SmallString name;
+    daxa_ExternalSemaphoreInfo external_semaphore;
 } daxa_TimelineSemaphoreInfo;
 
 DAXA_EXPORT daxa_TimelineSemaphoreInfo const *
@@ -145,6 +170,12 @@ daxa_timeline_semaphore_wait_for_value(daxa_TimelineSemaphore timeline_semaphore
 DAXA_EXPORT VkSemaphore
 daxa_timeline_semaphore_get_vk_semaphore(daxa_TimelineSemaphore timeline_semaphore);
 
+/// @brief  Creates a new fd or win32 HANDLE referencing the payload of a semaphore created with an external_semaphore handle type.
+///         The caller owns the handle.
+/// @return DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED when the semaphore was not created with a handle type.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_timeline_semaphore_export_handle(daxa_TimelineSemaphore timeline_semaphore, uint64_t * out_handle);
+
 DAXA_EXPORT uint64_t
 daxa_timeline_semaphore_inc_refcnt(daxa_TimelineSemaphore timeline_semaphore);
 DAXA_EXPORT uint64_t
@@ -123,6 +123,36 @@ typedef enum
     DAXA_RESULT_ERROR_DEVICE_NOT_SUPPORTED = (1 << 30) + 69,
     DAXA_RESULT_DEVICE_DOES_NOT_SUPPORT_ACCELERATION_STRUCTURE_COUNT = (1 << 30) + 70,
     DAXA_RESULT_ERROR_NO_SUITABLE_DEVICE_FOUND = (1 << 30) + 71,
+    DAXA_RESULT_ERROR_SUBMIT_BATCH_QUEUE_MISMATCH = (1 << 30) + 72,
+    DAXA_RESULT_ERROR_DEFRAGMENTATION_PASS_MISMATCH = (1 << 30) + 73,
+    DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED = (1 << 30) + 74,
+    DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH = (1 << 30) + 75,
+    DAXA_RESULT_ERROR_REUSABLE_COMMAND_LIST_OUTDATED = (1 << 30) + 76,
+    DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED = (1 << 30) + 77,
+    DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT = (1 << 30) + 78,
+    DAXA_RESULT_ERROR_PIPELINE_CACHE_WRITE_FAILED = (1 << 30) + 79,
+    DAXA_RESULT_ERROR_SHADER_OBJECT_NOT_SUPPORTED = (1 << 30) + 80,
+    DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE = (1 << 30) + 81,
+    DAXA_RESULT_ERROR_SHADER_OBJECT_PUSH_CONSTANT_SIZE_MISMATCH = (1 << 30) + 82,
+    DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_NOT_SUPPORTED = (1 << 30) + 83,
+    DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_SCOPE_MISMATCH = (1 << 30) + 84,
+    DAXA_RESULT_ERROR_PIPELINE_STATISTICS_QUERY_NOT_SUPPORTED = (1 << 30) + 85,
+    DAXA_RESULT_ERROR_PRECISE_OCCLUSION_QUERY_NOT_SUPPORTED = (1 << 30) + 86,
+    DAXA_RESULT_ERROR_INVALID_QUERY_TYPE = (1 << 30) + 87,
+    DAXA_RESULT_ERROR_MEMORY_DECOMPRESSION_NOT_SUPPORTED = (1 << 30) + 88,
+    DAXA_RESULT_ERROR_ACCELERATION_STRUCTURE_UPDATE_WITHOUT_ALLOW_UPDATE = (1 << 30) + 89,
+    DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED = (1 << 30) + 90,
+    DAXA_RESULT_ERROR_CALIBRATED_TIMESTAMPS_NOT_SUPPORTED = (1 << 30) + 91,
+    DAXA_RESULT_ERROR_EXCEEDED_MAX_PUSH_CONSTANT_SIZE = (1 << 30) + 92,
+    DAXA_RESULT_ERROR_INVALID_DEVICE_MASK = (1 << 30) + 93,
+    DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED = (1 << 30) + 94,
+    DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED = (1 << 30) + 95,
+    DAXA_RESULT_ERROR_DEVICE_NOT_CAPTURABLE = (1 << 30) + 96,
+    DAXA_RESULT_ERROR_CAPTURE_MISMATCH = (1 << 30) + 97,
+    DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID = (1 << 30) + 98,
+    DAXA_RESULT_ERROR_REPLAY_ID_CONFLICT = (1 << 30) + 99,
+    DAXA_RESULT_ERROR_PIPELINE_NOT_READY = (1 << 30) + 100,
+    DAXA_RESULT_ERROR_INVALID_IMAGE_LAYOUT = (1 << 30) + 101,
     DAXA_RESULT_MAX_ENUM = 0x7FFFFFFF,
 } daxa_Result;
 
@@ -136,6 +166,10 @@ typedef enum
     DAXA_IMAGE_LAYOUT_READ_ONLY_OPTIMAL = 1000314000,
     DAXA_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL = 1000314001,
     DAXA_IMAGE_LAYOUT_PRESENT_SRC = 1000001002,
+    DAXA_IMAGE_LAYOUT_VIDEO_DECODE_DST = 1000024000,
+    DAXA_IMAGE_LAYOUT_VIDEO_DECODE_DPB = 1000024002,
+    DAXA_IMAGE_LAYOUT_VIDEO_ENCODE_SRC = 1000299001,
+    DAXA_IMAGE_LAYOUT_VIDEO_ENCODE_DPB = 1000299002,
     DAXA_IMAGE_LAYOUT_MAX_ENUM = 0x7FFFFFFF,
 } daxa_ImageLayout;
 
@@ -208,6 +242,14 @@ static daxa_MemoryFlags const DAXA_MEMORY_FLAG_HOST_ACCESS_SEQUENTIAL_WRITE = 0x
 static daxa_MemoryFlags const DAXA_MEMORY_FLAG_HOST_ACCESS_RANDOM = 0x00000800;
 static daxa_MemoryFlags const DAXA_MEMORY_FLAG_STRATEGY_MIN_MEMORY = 0x00010000;
 static daxa_MemoryFlags const DAXA_MEMORY_FLAG_STRATEGY_MIN_TIME = 0x00020000;
+// Daxa only flag, allows defragmentation to move the resource, see daxa_dvc_begin_defragmentation_pass.
+static daxa_MemoryFlags const DAXA_MEMORY_FLAG_MOVABLE = 0x10000000;
+// Daxa only flag, implies HOST_ACCESS_RANDOM and prefers host cached memory for fast readbacks.
+// Cached memory may be non coherent, see daxa_dvc_invalidate_buffer_ranges and daxa_dvc_flush_buffer_ranges.
+static daxa_MemoryFlags const DAXA_MEMORY_FLAG_HOST_CACHED = 0x20000000;
+// Daxa only flag, implies HOST_ACCESS_SEQUENTIAL_WRITE and prefers device local host visible memory (bar / resizable bar).
+// Falls back to host memory when no such memory type exists or its heap is exhausted, see daxa_DeviceProperties::device_local_host_visible_heap_size.
+static daxa_MemoryFlags const DAXA_MEMORY_FLAG_PREFER_DEVICE_LOCAL_HOST_VISIBLE = 0x40000000;
 
 typedef struct
 {
@@ -240,11 +282,65 @@ daxa_timeline_query_pool_inc_refcnt(daxa_TimelineQueryPool timeline_query_pool);
 DAXA_EXPORT uint64_t
 daxa_timeline_query_pool_dec_refcnt(daxa_TimelineQueryPool timeline_query_pool);
 
+// Matches VkVideoCodecOperationFlagBitsKHR.
+typedef enum
+{
+    DAXA_VIDEO_CODEC_OPERATION_NONE = 0,
+    DAXA_VIDEO_CODEC_OPERATION_DECODE_H264 = 0x00000001,
+    DAXA_VIDEO_CODEC_OPERATION_DECODE_H265 = 0x00000002,
+    DAXA_VIDEO_CODEC_OPERATION_ENCODE_H264 = 0x00010000,
+    DAXA_VIDEO_CODEC_OPERATION_ENCODE_H265 = 0x00020000,
+    DAXA_VIDEO_CODEC_OPERATION_MAX_ENUM = 0x7FFFFFFF,
+} daxa_VideoCodecOperation;
+
+// Describes the coded video stream of a video session and the images and queries used with it.
+typedef struct
+{
+    daxa_VideoCodecOperation codec_operation;
+    VkVideoChromaSubsamplingFlagsKHR chroma_subsampling;
+    VkVideoComponentBitDepthFlagsKHR luma_bit_depth;
+    VkVideoComponentBitDepthFlagsKHR chroma_bit_depth;
+    // StdVideoH264ProfileIdc or StdVideoH265ProfileIdc, matching the codec operation.
+    uint32_t std_profile_idc;
+} daxa_VideoProfileInfo;
+
+typedef struct
+{
+    // VK_QUERY_TYPE_OCCLUSION, VK_QUERY_TYPE_PIPELINE_STATISTICS, VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR or VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR.
+    VkQueryType query_type;
+    // Only used for VK_QUERY_TYPE_PIPELINE_STATISTICS.
+    VkQueryPipelineStatisticFlags pipeline_statistics;
+    uint32_t query_count;
+    daxa_SmallString name;
+    // Only used for VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR, the profile of the encode session the queries are used in.
+    daxa_VideoProfileInfo video_profile;
+} daxa_QueryPoolInfo;
+
+DAXA_EXPORT daxa_QueryPoolInfo const *
+daxa_query_pool_info(daxa_QueryPool query_pool);
+
+/// @brief  Writes the values of each query followed by its availability.
+///         Occlusion queries have one value, the passed samples.
+///         Pipeline statistics queries have one value per enabled statistic, ordered by bit position.
+///         Video encode feedback queries have two values, the offset and the bytes written of the encoded bitstream.
+/// @return DAXA_RESULT_NOT_READY when some of the queries are not available yet.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_query_pool_query_results(daxa_QueryPool query_pool, uint32_t start, uint32_t count, uint64_t * out_results);
+
+DAXA_EXPORT uint64_t
+daxa_query_pool_inc_refcnt(daxa_QueryPool query_pool);
+DAXA_EXPORT uint64_t
+daxa_query_pool_dec_refcnt(daxa_QueryPool query_pool);
+
 typedef enum
 {
     DAXA_QUEUE_FAMILY_MAIN,
     DAXA_QUEUE_FAMILY_COMPUTE,
     DAXA_QUEUE_FAMILY_TRANSFER,
+    // Only present with DAXA_IMPLICIT_FEATURE_FLAG_VIDEO, see daxa_DeviceProperties::video_decode_queue_count.
+    DAXA_QUEUE_FAMILY_VIDEO_DECODE,
+    // Only present with DAXA_IMPLICIT_FEATURE_FLAG_VIDEO, see daxa_DeviceProperties::video_encode_queue_count.
+    DAXA_QUEUE_FAMILY_VIDEO_ENCODE,
     DAXA_QUEUE_FAMILY_MAX_ENUM
 } daxa_QueueFamily;
 
@@ -22,6 +22,37 @@ namespace daxa
     {
         QueueFamily queue_family = {};
         SmallString name = {};
+        /// @brief  Skips remembering the ids used in recorded commands.
+        ///         Submits of the resulting command lists will not check if these ids are still valid.
+        ///         Saves cpu time for command lists referencing many resources, once the code is known to be correct.
+        bool disable_submit_id_validation = false;
+        /// @brief  Completed command lists can be submitted many times, also while previous submits are still pending.
+        ///         Meant for static workloads that would otherwise be re-recorded every frame.
+        ///         Deferred destructions only happen on the first submit.
+        ///         Submits fail with DAXA_RESULT_ERROR_REUSABLE_COMMAND_LIST_OUTDATED once the resource table grew since recording,
+        ///         the commands must then be recorded again.
+        bool reusable = false;
+        /// @brief  Combines memory barriers with identical stages and collapses image barriers on adjacent subresources of the same image
+        ///         before they are flushed. Costs a little cpu time per flush, reduces the barrier count seen by the driver.
+        bool merge_barriers = false;
+        /// @brief  Defers ending renderpasses until the next command that can not be recorded inside of them.
+        ///         A following renderpass that loads the same attachments in the same render area continues the deferred one,
+        ///         avoiding the store and load of the attachments in between. Mostly benefits tiled gpus.
+        ///         Barriers recorded in between that only order attachment accesses to these attachments without a layout change are dropped.
+        bool merge_renderpasses = false;
+    };
+
+    /// @brief  Counts of commands the recorder dropped because they would not have changed the bound state.
+    struct CommandRecorderStats
+    {
+        u64 filtered_pipeline_binds = {};
+        u64 filtered_viewports = {};
+        u64 filtered_scissors = {};
+        u64 filtered_index_buffer_binds = {};
+        u64 merged_barriers = {};
+        u64 merged_renderpasses = {};
+        u64 filtered_gpu_sro_table_binds = {};
+        u64 skipped_pending_pipeline_commands = {};
     };
 
     struct ImageBlitInfo
@@ -129,6 +160,9 @@ namespace daxa
         Optional<RenderAttachmentInfo> depth_attachment = {};
         Optional<RenderAttachmentInfo> stencil_attachment = {};
         Rect2D render_area = {};
+        /// @brief  The renderpass contents are recorded by secondary recorders, see RenderCommandRecorder::create_secondary_recorder.
+        ///         No draws can be recorded directly into such a renderpass, only RenderCommandRecorder::execute_commands.
+        bool secondary_command_lists = false;
     };
 
     struct TraceRaysInfo
@@ -166,6 +200,63 @@ namespace daxa
         usize offset = {};
     };
 
+    /// @brief  Draws and dispatches between begin and end are discarded when the 32 bit value at offset is zero, or non zero when inverted.
+    struct ConditionalRenderingInfo
+    {
+        BufferId buffer = {};
+        /// @brief  Must be a multiple of 4.
+        usize offset = {};
+        bool inverted = {};
+    };
+
+    /// @brief  One GDeflate 1.0 stream, both addresses must be 4 byte aligned and decompressed_size must not exceed 65536.
+    struct MemoryDecompressionRegion
+    {
+        DeviceAddress src_address = {};
+        DeviceAddress dst_address = {};
+        u64 compressed_size = {};
+        u64 decompressed_size = {};
+    };
+
+    struct DecompressMemoryInfo
+    {
+        std::span<MemoryDecompressionRegion const> regions = {};
+    };
+
+    struct ExecuteGeneratedCommandsInfo
+    {
+        IndirectCommandsLayout layout = {};
+        IndirectExecutionSet execution_set = {};
+        BufferId indirect_buffer = {};
+        usize indirect_offset = {};
+        /// Range sized by Device::generated_commands_memory_requirements.
+        BufferId preprocess_buffer = {};
+        usize preprocess_offset = {};
+        usize preprocess_size = {};
+        u32 max_sequence_count = {};
+        /// Optional, when empty max_sequence_count sequences are executed.
+        BufferId sequence_count_buffer = {};
+        usize sequence_count_offset = {};
+        u32 max_draw_count = {};
+    };
+
+    /// @brief  Shader objects carry no fixed function state, it is given here with the same meaning as in RasterPipelineInfo.
+    ///         Stages left empty are unbound. Either vertex or mesh must be set.
+    struct SetRasterShaderObjectsInfo
+    {
+        ShaderObject vertex = {};
+        ShaderObject tesselation_control = {};
+        ShaderObject tesselation_evaluation = {};
+        ShaderObject fragment = {};
+        ShaderObject task = {};
+        ShaderObject mesh = {};
+        /// Only the blend state is used, formats come from the current renderpass.
+        FixedList<RenderAttachment, 8> color_attachments = {};
+        Optional<DepthTestInfo> depth_test = {};
+        Optional<TesselationInfo> tesselation = {};
+        RasterizerInfo raster = {};
+    };
+
     struct DrawMeshTasksIndirectInfo
     {
         BufferId indirect_buffer = {};
@@ -201,6 +292,33 @@ namespace daxa
         u32 first_instance = {};
     };
 
+    struct DrawRange
+    {
+        u32 first_vertex = {};
+        u32 vertex_count = {};
+    };
+
+    struct DrawIndexedRange
+    {
+        u32 first_index = {};
+        u32 index_count = {};
+        i32 vertex_offset = {};
+    };
+
+    struct DrawMultiInfo
+    {
+        std::span<DrawRange const> ranges = {};
+        u32 instance_count = 1;
+        u32 first_instance = {};
+    };
+
+    struct DrawMultiIndexedInfo
+    {
+        std::span<DrawIndexedRange const> ranges = {};
+        u32 instance_count = 1;
+        u32 first_instance = {};
+    };
+
     struct DrawIndirectInfo
     {
         BufferId draw_command_buffer = {};
@@ -246,6 +364,42 @@ namespace daxa
         u32 count = {};
     };
 
+    struct CopyTimestampsToBufferInfo
+    {
+        TimelineQueryPool & query_pool;
+        u32 start_index = {};
+        u32 count = {};
+        BufferId dst_buffer = {};
+        usize dst_offset = {};
+    };
+
+    struct PipelineBarriersInfo
+    {
+        std::span<MemoryBarrierInfo const> memory_barriers = {};
+        std::span<ImageMemoryBarrierInfo const> image_barriers = {};
+    };
+
+    struct BeginQueryInfo
+    {
+        QueryPool & query_pool;
+        u32 query_index = {};
+        /// @brief  Only for occlusion queries, requires ImplicitFeatureFlagBits::PRECISE_OCCLUSION_QUERY.
+        bool precise = {};
+    };
+
+    struct EndQueryInfo
+    {
+        QueryPool & query_pool;
+        u32 query_index = {};
+    };
+
+    struct ResetQueriesInfo
+    {
+        QueryPool & query_pool;
+        u32 start_index = {};
+        u32 count = {};
+    };
+
     struct CommandLabelInfo
     {
         std::array<f32, 4> label_color = {0.463f, 0.333f, 0.671f, 1.0f};
@@ -281,6 +435,108 @@ namespace daxa
         std::span<BlasBuildInfo const> blas_build_infos = {};
     };
 
+    struct BuildMicromapsInfo
+    {
+        std::span<MicromapBuildInfo const> builds = {};
+    };
+
+    /// @brief  Region of an image view read or written by a video command.
+    ///         The image must be in the video layout of its use, see ImageLayout::VIDEO_*.
+    struct VideoPictureResource
+    {
+        ImageViewId view = {};
+        Offset2D coded_offset = {};
+        Extent2D coded_extent = {};
+        /// @brief  Relative to the first layer of the view.
+        u32 base_array_layer = {};
+    };
+
+    struct VideoReferenceSlot
+    {
+        /// @brief  DPB slot of the picture. Negative in begin_video_coding deactivates the slot of the picture.
+        i32 slot_index = -1;
+        VideoPictureResource picture = {};
+        /// @brief  Codec specific VkVideo{Decode,Encode}{H264,H265}DpbSlotInfoKHR, may be null in begin_video_coding.
+        void const * codec_info = {};
+    };
+
+    struct BeginVideoCodingInfo
+    {
+        VideoSession session = {};
+        /// @brief  Every DPB slot the following decodes or encodes reference or set up.
+        std::span<VideoReferenceSlot const> reference_slots = {};
+    };
+
+    struct VideoCodingControlFlagsProperties
+    {
+        using Data = u32;
+    };
+    using VideoCodingControlFlags = Flags<VideoCodingControlFlagsProperties>;
+    struct VideoCodingControlFlagBits
+    {
+        static inline constexpr VideoCodingControlFlags NONE = {0x00000000};
+        /// @brief  Must be recorded once before the first decode or encode of a session.
+        static inline constexpr VideoCodingControlFlags RESET = {0x00000001};
+        static inline constexpr VideoCodingControlFlags ENCODE_RATE_CONTROL = {0x00000002};
+        static inline constexpr VideoCodingControlFlags ENCODE_QUALITY_LEVEL = {0x00000004};
+    };
+
+    struct VideoCodingControlInfo
+    {
+        VideoCodingControlFlags flags = {};
+        /// @brief  Optional rate control or quality level structs chained into VkVideoCodingControlInfoKHR.
+        void const * next = {};
+    };
+
+    struct VideoDecodeInfo
+    {
+        BufferId src_buffer = {};
+        u64 src_offset = {};
+        u64 src_range = {};
+        VideoPictureResource dst_picture = {};
+        /// @brief  Without a value the decoded picture does not become a reference picture.
+        Optional<VideoReferenceSlot> setup_reference_slot = {};
+        std::span<VideoReferenceSlot const> reference_slots = {};
+        /// @brief  Codec specific VkVideoDecodeH264PictureInfoKHR or VkVideoDecodeH265PictureInfoKHR.
+        void const * codec_info = {};
+    };
+
+    struct VideoEncodeInfo
+    {
+        BufferId dst_buffer = {};
+        u64 dst_offset = {};
+        u64 dst_range = {};
+        VideoPictureResource src_picture = {};
+        /// @brief  Without a value the reconstructed picture does not become a reference picture.
+        Optional<VideoReferenceSlot> setup_reference_slot = {};
+        std::span<VideoReferenceSlot const> reference_slots = {};
+        /// @brief  Codec specific VkVideoEncodeH264PictureInfoKHR or VkVideoEncodeH265PictureInfoKHR.
+        void const * codec_info = {};
+    };
+
+    struct WriteBlasCompactedSizesInfo
+    {
+        std::span<BlasId const> blas = {};
+        /// @brief  Must be a QueryType::ACCELERATION_STRUCTURE_COMPACTED_SIZE pool.
+        QueryPool & query_pool;
+        u32 first_query_index = {};
+    };
+
+    enum struct AccelerationStructureCopyMode
+    {
+        CLONE = 0,
+        COMPACT = 1,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    struct CopyAccelerationStructureInfo
+    {
+        BlasId src_blas = {};
+        BlasId dst_blas = {};
+        /// @brief  COMPACT requires src_blas to be built with AccelerationStructureBuildFlagBits::ALLOW_COMPACTION.
+        AccelerationStructureCopyMode mode = AccelerationStructureCopyMode::COMPACT;
+    };
+
     struct DAXA_EXPORT_CXX ExecutableCommandList : ManagedPtr<ExecutableCommandList, daxa_ExecutableCommandList>
     {
       protected:
@@ -291,10 +547,11 @@ namespace daxa
     };
 
     struct CommandRecorder;
+    struct SecondaryRenderCommandRecorder;
 
     struct DAXA_EXPORT_CXX RenderCommandRecorder
     {
-      private:
+      protected:
         daxa_CommandRecorder internal = {};
         friend struct CommandRecorder;
 
@@ -310,6 +567,14 @@ namespace daxa
         ///         Between the begin and end renderpass commands, the renderpass persists and drawcalls can be recorded.
         [[nodiscard]] auto end_renderpass() && -> CommandRecorder;
 
+        /// @brief  Creates a recorder continuing this renderpass in secondary command lists, which can record on another thread.
+        ///         The renderpass must be begun with RenderPassBeginInfo::secondary_command_lists.
+        ///         The queue family of info is ignored, secondary recorders always record for the queue family of their parent.
+        [[nodiscard]] auto create_secondary_recorder(CommandRecorderInfo const & info = {}) -> SecondaryRenderCommandRecorder;
+        /// @brief  Executes completed secondary command lists with a single vkCmdExecuteCommands.
+        ///         The executed lists are kept alive by the commands of this recorder.
+        void execute_commands(std::span<ExecutableCommandList const> executable_commands);
+
         void push_constant_vptr(PushConstantInfo const & info);
         template <typename T>
         void push_constant(T const & constant, u32 offset = 0)
@@ -320,7 +585,12 @@ namespace daxa
                 .offset = offset,
             });
         }
+        /// @brief  Writes all fields with a single push, bytes between the fields keep their previously pushed values.
+        void push_constant_range(std::span<PushConstantInfo const> fields);
         void set_pipeline(RasterPipeline const & pipeline);
+        /// @brief  Binds graphics shader objects in place of a raster pipeline, requires ImplicitFeatureFlagBits::SHADER_OBJECT.
+        ///         Viewport and scissor keep their current values.
+        void set_shader_objects(SetRasterShaderObjectsInfo const & info);
         void set_viewport(ViewportInfo const & info);
         void set_scissor(Rect2D const & info);
         void set_rasterization_samples(RasterizationSamples info);
@@ -329,11 +599,51 @@ namespace daxa
 
         void draw(DrawInfo const & info);
         void draw_indexed(DrawIndexedInfo const & info);
+        /// @brief  Records one draw per range with a single call into the driver when VK_EXT_multi_draw is available.
+        void draw_multi(DrawMultiInfo const & info);
+        /// @brief  Records one indexed draw per range with a single call into the driver when VK_EXT_multi_draw is available.
+        void draw_multi_indexed(DrawMultiIndexedInfo const & info);
         void draw_indirect(DrawIndirectInfo const & info);
         void draw_indirect_count(DrawIndirectCountInfo const & info);
         void draw_mesh_tasks(u32 x, u32 y, u32 z);
         void draw_mesh_tasks_indirect(DrawMeshTasksIndirectInfo const & info);
         void draw_mesh_tasks_indirect_count(DrawMeshTasksIndirectCountInfo const & info);
+        /// @brief  Executes gpu generated draws. Pipeline, push constants and index buffer have to be set again afterwards.
+        void execute_generated_commands(ExecuteGeneratedCommandsInfo const & info);
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the device is destroyed.
+        /// @return reference to the redundant state statistics of the recorder.
+        [[nodiscard]] auto stats() const -> CommandRecorderStats const &;
+    };
+
+    /**
+     * @brief   SecondaryRenderCommandRecorder records draws into secondary command lists continuing a renderpass.
+     *          The completed command lists are executed by the RenderCommandRecorder it was created from.
+     *
+     * GENERAL:
+     * * inherits the attachment formats and render area of its parents renderpass.
+     * * viewport and scissor start out covering the render area, pipelines and other state must be set again.
+     * * can not end the renderpass, create nested secondary recorders or be submitted directly.
+     *
+     * THREADSAFETY:
+     * * independent of its parent, may record on another thread while the parent records or other secondaries record.
+     * * may only be accessed by one thread at a time
+     */
+    struct DAXA_EXPORT_CXX SecondaryRenderCommandRecorder : RenderCommandRecorder
+    {
+        friend struct RenderCommandRecorder;
+
+        auto end_renderpass() && -> CommandRecorder = delete;
+        auto create_secondary_recorder(CommandRecorderInfo const & info = {}) -> SecondaryRenderCommandRecorder = delete;
+        void execute_commands(std::span<ExecutableCommandList const> executable_commands) = delete;
+
+        [[nodiscard]] auto complete_current_commands() -> ExecutableCommandList;
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the device is destroyed.
+        /// @return reference to info of object.
+        [[nodiscard]] auto info() const -> CommandRecorderInfo const &;
     };
 
     /**
@@ -388,6 +698,8 @@ namespace daxa
         ///         As soon as a non-pipeline barrier command is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
         /// @param info parameters.
         void pipeline_barrier_image_transition(ImageMemoryBarrierInfo const & info);
+        /// @brief  Adds many barriers with one call, they are combined with the other successive pipeline barrier calls.
+        void pipeline_barriers(PipelineBarriersInfo const & info);
         void signal_event(EventSignalInfo const & info);
         void wait_events(std::span<EventWaitInfo const> const & infos);
         void wait_event(EventWaitInfo const & info);
@@ -416,16 +728,40 @@ namespace daxa
 
         void write_timestamp(WriteTimestampInfo const & info);
         void reset_timestamps(ResetTimestampsInfo const & info);
+        /// @brief  Writes each timestamp followed by its availability as two u64 into the buffer, without waiting for the gpu.
+        ///         Unwritten queries have an availability of zero. Synchronized as a transfer write to the buffer.
+        void copy_timestamps_to_buffer(CopyTimestampsToBufferInfo const & info);
 
         void begin_label(CommandLabelInfo const & info);
         void end_label();
 
+        /// @brief  Begins a video coding scope of a session, requires ImplicitFeatureFlagBits::VIDEO.
+        ///         Must be recorded on a recorder of the video queue family matching the sessions codec operation.
+        ///         Decodes, encodes and coding controls must be recorded inside of the scope.
+        void begin_video_coding(BeginVideoCodingInfo const & info);
+        void end_video_coding();
+        void control_video_coding(VideoCodingControlInfo const & info);
+        /// @brief  Decodes one picture from the bitstream range of the src buffer, runs in the video decode stage.
+        void decode_video(VideoDecodeInfo const & info);
+        /// @brief  Encodes one picture into the dst buffer range, runs in the video encode stage.
+        ///         The written size is reported by a QueryType::VIDEO_ENCODE_FEEDBACK query around the encode.
+        void encode_video(VideoEncodeInfo const & info);
+
+        /// @brief  Selects the physical devices of a device group that execute the following commands, bit i selects device i.
+        ///         Zero selects all of them. Barriers recorded afterwards also only apply to the selected devices.
+        ///         Must be recorded outside of a renderpass.
+        void set_device_mask(u32 device_mask);
+
         [[nodiscard]] auto complete_current_commands() -> ExecutableCommandList;
 
         /// THREADSAFETY:
         /// * reference MUST NOT be read after the device is destroyed.
         /// @return reference to info of object.
         [[nodiscard]] auto info() const -> CommandRecorderInfo const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the device is destroyed.
+        /// @return reference to the redundant state statistics of the recorder.
+        [[nodiscard]] auto stats() const -> CommandRecorderStats const &;
     };
 
     /**
@@ -463,15 +799,47 @@ namespace daxa
                 .offset = offset,
             });
         }
+        /// @brief  Writes all fields with a single push, bytes between the fields keep their previously pushed values.
+        void push_constant_range(std::span<PushConstantInfo const> fields);
 
         void build_acceleration_structures(BuildAccelerationStructuresInfo const & info);
+        /// @brief  Writes the compacted size of each blas into consecutive queries, the queries must be reset beforehand.
+        ///         The builds must be made visible with a barrier to ACCELERATION_STRUCTURE_BUILD_READ first.
+        void write_blas_compacted_sizes(WriteBlasCompactedSizesInfo const & info);
+        /// @brief  A compacting copy needs a dst blas at least as large as the queried compacted size.
+        ///         Runs in the acceleration structure build stage.
+        void copy_acceleration_structure(CopyAccelerationStructureInfo const & info);
+        /// @brief  Builds opacity micromaps, requires ImplicitFeatureFlagBits::OPACITY_MICROMAP. Runs in the micromap build stage.
+        ///         Blas builds referencing the micromaps must wait for the builds with a barrier to AccessConsts::ACCELERATION_STRUCTURE_BUILD_READ.
+        void build_micromaps(BuildMicromapsInfo const & info);
 
         void set_pipeline(ComputePipeline const & pipeline);
 
+        /// @brief  Binds a compute shader object in place of a compute pipeline, requires ImplicitFeatureFlagBits::SHADER_OBJECT.
+        void set_shader_object(ShaderObject const & shader_object);
+
         void dispatch(DispatchInfo const & info);
 
         void dispatch_indirect(DispatchIndirectInfo const & info);
 
+        /// @brief  Executes gpu generated dispatches. Pipeline and push constants have to be set again afterwards.
+        void execute_generated_commands(ExecuteGeneratedCommandsInfo const & info);
+
+        /// @brief  Predicates the following draws and dispatches on a value in a buffer, requires ImplicitFeatureFlagBits::CONDITIONAL_RENDERING.
+        ///         When begun outside of a renderpass, it also applies to the draws of renderpasses recorded before the end.
+        void begin_conditional_rendering(ConditionalRenderingInfo const & info);
+        void end_conditional_rendering();
+
+        /// @brief  Decompresses GDeflate streams on the gpu, requires ImplicitFeatureFlagBits::MEMORY_DECOMPRESSION.
+        ///         Decompression has no stage of its own in daxa, synchronize it with all commands barriers.
+        void decompress_memory(DecompressMemoryInfo const & info);
+
+        /// @brief  Counts the samples passed or the pipeline statistics of the work recorded until the query is ended in the same command list.
+        ///         Queries must be reset outside of a renderpass before they are begun.
+        void begin_query(BeginQueryInfo const & info);
+        void end_query(EndQueryInfo const & info);
+        void reset_queries(ResetQueriesInfo const & info);
+
         void set_pipeline(RayTracingPipeline const & pipeline);
 
         void trace_rays(TraceRaysInfo const & info);
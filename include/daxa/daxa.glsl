@@ -24,6 +24,11 @@
 #if DAXA_IMAGE_INT64
 #extension GL_EXT_shader_image_int64 : require
 #endif
+// Defined by the pipeline manager when the device enabled DAXA_EXPLICIT_FEATURE_FLAG_COOPERATIVE_MATRIX.
+#if DAXA_COOPERATIVE_MATRIX
+#extension GL_KHR_cooperative_matrix : require
+#extension GL_EXT_shader_explicit_arithmetic_types : require
+#endif
 
 #define DAXA_ID_INDEX_BITS 20
 #define DAXA_ID_INDEX_MASK ((uint64_t(1) << DAXA_ID_INDEX_BITS) - uint64_t(1))
@@ -197,17 +202,27 @@ daxa_u64 daxa_id_to_address(daxa_BufferId buffer_id)
 #define as_address(x) uint64_t(x)
 #endif
 
+/// @brief  Retrieves a typed pointer to the start of the buffer of the given buffer id.
+///         Every call loads the address from the device address buffer before the buffer itself can be accessed.
+///         Hot shaders should get their pointers resolved at record time instead,
+///         for example with DAXA_TH_BUFFER_PTR attachments or addresses written into push constants.
+/// @param STRUCT_TYPE Struct type contained by the buffer device address block / "pointed to type".
+/// @param BUFFER_ID The buffer of which the pointer is retrieved for.
+#define daxa_id_to_ptr(STRUCT_TYPE, BUFFER_ID) daxa_BufferPtr(STRUCT_TYPE)(daxa_id_to_address(BUFFER_ID))
+/// @brief  Read write variant of daxa_id_to_ptr.
+#define daxa_id_to_rwptr(STRUCT_TYPE, BUFFER_ID) daxa_RWBufferPtr(STRUCT_TYPE)(daxa_id_to_address(BUFFER_ID))
+
 /// @brief Defines the buffer reference used in all buffer references in daxa glsl. Can also be used to declare new buffer references.
 #define DAXA_DECL_BUFFER_REFERENCE_ALIGN(ALIGN) layout(buffer_reference, scalar, buffer_reference_align = ALIGN) buffer
 #define DAXA_DECL_BUFFER_REFERENCE DAXA_DECL_BUFFER_REFERENCE_ALIGN(4)
 
 /// @brief Defines the storage image layout used in all buffer references in daxa glsl with format specification.
-#define DAXA_STORAGE_IMAGE_LAYOUT_WITH_FORMAT(FORMAT) layout(FORMAT, binding = DAXA_STORAGE_IMAGE_BINDING, set = 0)
+#define DAXA_STORAGE_IMAGE_LAYOUT_WITH_FORMAT(FORMAT) layout(FORMAT, binding = DAXA_STORAGE_IMAGE_BINDING, set = DAXA_STORAGE_IMAGE_SET)
 
 /// @brief Defines the storage image layout used for all storage images in daxa glsl.
-#define DAXA_STORAGE_IMAGE_LAYOUT layout(binding = DAXA_STORAGE_IMAGE_BINDING, set = 0)
+#define DAXA_STORAGE_IMAGE_LAYOUT layout(binding = DAXA_STORAGE_IMAGE_BINDING, set = DAXA_STORAGE_IMAGE_SET)
 /// @brief Defines the sampled image layout used for all sampled images in daxa glsl.
-#define DAXA_SAMPLED_IMAGE_LAYOUT layout(binding = DAXA_SAMPLED_IMAGE_BINDING, set = 0)
+#define DAXA_SAMPLED_IMAGE_LAYOUT layout(binding = DAXA_SAMPLED_IMAGE_BINDING, set = DAXA_SAMPLED_IMAGE_SET)
 /// @brief Defines the sampler layout used for all samplers in daxa glsl.
 #define DAXA_SAMPLER_LAYOUT layout(binding = DAXA_SAMPLER_BINDING, set = 0)
 #if defined(DAXA_RAY_TRACING)
@@ -619,3 +634,54 @@ DAXA_DECL_BUFFER_PTR(daxa_u64vec3)
 DAXA_DECL_BUFFER_PTR(daxa_BufferId)
 DAXA_DECL_BUFFER_PTR(daxa_ImageViewId)
 DAXA_DECL_BUFFER_PTR(daxa_SamplerId)
+
+#if !defined(DAXA_DISABLE_SHADER_DEBUG)
+/// @brief  Address of the shader debug ring, stored past the buffer addresses. 0 when no ring is set, see Device::set_shader_debug_address.
+daxa_u64 daxa_shader_debug_address()
+{
+    return daxa_buffer_device_address_buffer.addresses[daxa_buffer_device_address_buffer.addresses.length() - 1];
+}
+
+// Daxa implementation detail begin
+void _daxa_shader_debug_write(daxa_u32 type, daxa_u32 id, daxa_u32 line, daxa_u32vec4 args)
+{
+    daxa_u64 address = daxa_shader_debug_address();
+    if (address == 0)
+    {
+        return;
+    }
+    daxa_RWBufferPtr(daxa_u32) ring = daxa_RWBufferPtr(daxa_u32)(address);
+    // The count keeps growing past the capacity, so the cpu knows how many messages were dropped.
+    daxa_u32 index = atomicAdd(deref_i(ring, 0), 1);
+    if (index >= deref_i(ring, 1))
+    {
+        return;
+    }
+    daxa_RWBufferPtr(daxa_u32vec4) message = daxa_RWBufferPtr(daxa_u32vec4)(address + DAXA_SHADER_DEBUG_HEADER_SIZE + daxa_u64(index) * DAXA_SHADER_DEBUG_MESSAGE_SIZE);
+    deref_i(message, 0) = daxa_u32vec4(type, id, line, 0);
+    deref_i(message, 1) = args;
+}
+// Daxa implementation detail end
+
+/// @brief  Writes a message with the id and the line into the shader debug ring when the condition is false.
+///         A passing assertion only costs the branch, the ring address is loaded when the condition fails.
+/// @param CONDITION Checked condition, not evaluated with DAXA_DISABLE_SHADER_DEBUG.
+/// @param ID User chosen u32 that identifies the assertion on the cpu.
+#define daxa_assert(CONDITION, ID) daxa_assert_args(CONDITION, ID, daxa_u32vec4(0))
+/// @brief  daxa_assert with four u32 arguments, floats can be passed with floatBitsToUint.
+#define daxa_assert_args(CONDITION, ID, ARGS)                                                                                  \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        if (!(CONDITION))                                                                                                      \
+        {                                                                                                                      \
+            _daxa_shader_debug_write(DAXA_SHADER_DEBUG_MESSAGE_ASSERT, daxa_u32(ID), daxa_u32(__LINE__), daxa_u32vec4(ARGS)); \
+        }                                                                                                                      \
+    } while (false)
+/// @brief  Writes a message with the id, the line and four u32 arguments into the shader debug ring.
+///         There are no format strings in shaders, the cpu formats the message by its id.
+#define daxa_printf(ID, ARGS) _daxa_shader_debug_write(DAXA_SHADER_DEBUG_MESSAGE_PRINTF, daxa_u32(ID), daxa_u32(__LINE__), daxa_u32vec4(ARGS))
+#else
+#define daxa_assert(CONDITION, ID)
+#define daxa_assert_args(CONDITION, ID, ARGS)
+#define daxa_printf(ID, ARGS)
+#endif
@@ -8,3 +8,4 @@
 #include <daxa/command_recorder.hpp>
 #include <daxa/device.hpp>
 #include <daxa/instance.hpp>
+#include <daxa/profiling.hpp>
@@ -7,6 +7,17 @@
 #define DAXA_SAMPLER_BINDING 3
 #define DAXA_BUFFER_DEVICE_ADDRESS_BUFFER_BINDING 4
 #define DAXA_ACCELERATION_STRUCTURE_BINDING 5
+// The large binding arrays live in their own sets, so that the resource table can grow them independently.
+#define DAXA_STORAGE_BUFFER_SET 1
+#define DAXA_STORAGE_IMAGE_SET 2
+#define DAXA_SAMPLED_IMAGE_SET 3
+// Layout of the shader debug ring that daxa_assert and daxa_printf write into, see daxa::ShaderDebugRing.
+// A header of the u32 message count and the u32 message capacity, followed by the messages.
+// Each message is its u32 type, id, line and padding followed by four u32 arguments.
+#define DAXA_SHADER_DEBUG_HEADER_SIZE 16
+#define DAXA_SHADER_DEBUG_MESSAGE_SIZE 32
+#define DAXA_SHADER_DEBUG_MESSAGE_ASSERT 1
+#define DAXA_SHADER_DEBUG_MESSAGE_PRINTF 2
 
 #if defined(_STDC_) // C
 #define DAXA_SHADER 0
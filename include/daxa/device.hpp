@@ -8,11 +8,14 @@
 #include <daxa/sync.hpp>
 
 #include <bit>
+#include <functional>
 
 namespace daxa
 {
     static constexpr inline u32 MAX_COMPUTE_QUEUE_COUNT = 8u;
     static constexpr inline u32 MAX_TRANSFER_QUEUE_COUNT = 2u;
+    static constexpr inline u32 MAX_VIDEO_DECODE_QUEUE_COUNT = 1u;
+    static constexpr inline u32 MAX_VIDEO_ENCODE_QUEUE_COUNT = 1u;
 
     enum struct DeviceType
     {
@@ -195,6 +198,58 @@ namespace daxa
         u32 invocation_reorder_mode = {};
     };
 
+    /// Values match VkComponentTypeKHR.
+    enum struct ComponentType
+    {
+        FLOAT16 = 0,
+        FLOAT32 = 1,
+        FLOAT64 = 2,
+        SINT8 = 3,
+        SINT16 = 4,
+        SINT32 = 5,
+        SINT64 = 6,
+        UINT8 = 7,
+        UINT16 = 8,
+        UINT32 = 9,
+        UINT64 = 10,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    /// Values match VkScopeKHR.
+    enum struct Scope
+    {
+        DEVICE = 1,
+        WORKGROUP = 2,
+        SUBGROUP = 3,
+        QUEUE_FAMILY = 5,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    /// @brief  One supported matrix multiply-add D = A * B + C, with A being MxK, B KxN and C, D MxN.
+    struct CooperativeMatrixShape
+    {
+        u32 m_size = {};
+        u32 n_size = {};
+        u32 k_size = {};
+        ComponentType a_type = {};
+        ComponentType b_type = {};
+        ComponentType c_type = {};
+        ComponentType result_type = {};
+        bool saturating_accumulation = {};
+        Scope scope = {};
+    };
+
+    static inline constexpr u32 MAX_COOPERATIVE_MATRIX_SHAPES = 32;
+
+    struct CooperativeMatrixProperties
+    {
+        /// @brief  Values match VkShaderStageFlagBits.
+        u32 supported_stages = {};
+        u32 shape_count = {};
+        /// @brief  Shapes beyond MAX_COOPERATIVE_MATRIX_SHAPES are dropped, drivers report far fewer.
+        std::array<CooperativeMatrixShape, MAX_COOPERATIVE_MATRIX_SHAPES> shapes = {};
+    };
+
     struct DeviceFlagsProperties
     {
         using Data = u32;
@@ -273,6 +328,8 @@ namespace daxa
         static inline constexpr ExplicitFeatureFlags ACCELERATION_STRUCTURE_CAPTURE_REPLAY = {0x1 << 1};
         static inline constexpr ExplicitFeatureFlags VK_MEMORY_MODEL = {0x1 << 2};
         static inline constexpr ExplicitFeatureFlags ROBUSTNESS_2 = {0x1 << 3};
+        static inline constexpr ExplicitFeatureFlags DESCRIPTOR_BUFFER = {0x1 << 4};
+        static inline constexpr ExplicitFeatureFlags COOPERATIVE_MATRIX = {0x1 << 5};
     };
 
     struct ImplicitFeatureProperties
@@ -296,6 +353,25 @@ namespace daxa
         static inline constexpr ImplicitFeatureFlags DYNAMIC_STATE_3 = {0x1 << 10};
         static inline constexpr ImplicitFeatureFlags SHADER_ATOMIC_FLOAT = {0x1 << 11};
         static inline constexpr ImplicitFeatureFlags SWAPCHAIN = {0x1 << 12};
+        static inline constexpr ImplicitFeatureFlags MEMORY_BUDGET = {0x1 << 13};
+        static inline constexpr ImplicitFeatureFlags SPARSE_BINDING = {0x1 << 14};
+        static inline constexpr ImplicitFeatureFlags MULTI_DRAW = {0x1 << 15};
+        static inline constexpr ImplicitFeatureFlags DEVICE_GENERATED_COMMANDS = {0x1 << 16};
+        static inline constexpr ImplicitFeatureFlags PIPELINE_BINARY = {0x1 << 17};
+        static inline constexpr ImplicitFeatureFlags GRAPHICS_PIPELINE_LIBRARY = {0x1 << 18};
+        static inline constexpr ImplicitFeatureFlags SHADER_OBJECT = {0x1 << 19};
+        static inline constexpr ImplicitFeatureFlags CONDITIONAL_RENDERING = {0x1 << 20};
+        static inline constexpr ImplicitFeatureFlags PIPELINE_STATISTICS_QUERY = {0x1 << 21};
+        static inline constexpr ImplicitFeatureFlags PRECISE_OCCLUSION_QUERY = {0x1 << 22};
+        static inline constexpr ImplicitFeatureFlags MEMORY_DECOMPRESSION = {0x1 << 23};
+        static inline constexpr ImplicitFeatureFlags PRESENT_WAIT = {0x1 << 24};
+        static inline constexpr ImplicitFeatureFlags LOW_LATENCY = {0x1 << 25};
+        static inline constexpr ImplicitFeatureFlags DISPLAY_TIMING = {0x1 << 26};
+        static inline constexpr ImplicitFeatureFlags OPACITY_MICROMAP = {0x1 << 27};
+        static inline constexpr ImplicitFeatureFlags CALIBRATED_TIMESTAMPS = {0x1 << 28};
+        static inline constexpr ImplicitFeatureFlags EXTERNAL_MEMORY = {0x1 << 29};
+        /// @brief  Video sessions, video usages on images and buffers and the video decode and encode queue families when the device exposes them.
+        static inline constexpr ImplicitFeatureFlags VIDEO = {0x1 << 30};
     };
 
     struct DeviceProperties
@@ -317,6 +393,20 @@ namespace daxa
         ImplicitFeatureFlags implicit_features;
         ExplicitFeatureFlags explicit_features;
         MissingRequiredVkFeature missing_required_feature;
+        /// @brief  Size of the largest device local heap with host visible memory types, zero when there is none.
+        ///         Without resizable bar this is usually 256mb, with it the heap spans the whole vram.
+        u64 device_local_host_visible_heap_size = {};
+        /// @brief  Set when ExplicitFeatureFlagBits::COOPERATIVE_MATRIX is supported.
+        Optional<CooperativeMatrixProperties> cooperative_matrix_properties = {};
+        /// @brief  Physical devices in the vulkan device group of this device, including itself.
+        ///         With more than one, DeviceInfo2::device_group creates a single device spanning all of them.
+        u32 device_group_size = {};
+        /// @brief  Queues of the dedicated video families, zero without ImplicitFeatureFlagBits::VIDEO.
+        u32 video_decode_queue_count = {};
+        u32 video_encode_queue_count = {};
+        /// @brief  Codecs supported by the video queue families, bitmask of VideoCodecOperation values.
+        u32 video_decode_codec_operations = {};
+        u32 video_encode_codec_operations = {};
     };
 
     [[deprecated("Use create_device_2 and Instance::choose_device instead")]] DAXA_EXPORT_CXX auto default_device_score(DeviceProperties const & device_props) -> i32;
@@ -342,11 +432,26 @@ namespace daxa
         u32 physical_device_index = ~0u;
         ExplicitFeatureFlags explicit_features = {};
         // Make sure your device actually supports the max numbers, as device creation will fail otherwise.
+        // Image and buffer descriptors are allocated on demand, the max numbers only bound how far the table can grow.
         u32 max_allowed_images = 10'000;
         u32 max_allowed_buffers = 10'000;
         u32 max_allowed_samplers = 400;
         u32 max_allowed_acceleration_structures = 10'000;
         SmallString name = {};
+        /// @brief  Spawns a device owned thread that waits on the queue timelines and collects garbage as soon as submits retire.
+        ///         The thread never blocks on the resource lifetime lock, it skips collection while command recorders are alive.
+        ///         Manual collect_garbage calls stay valid.
+        bool background_garbage_collection = false;
+        /// @brief  Optional directory the pipeline cache is loaded from at creation and saved to at destruction.
+        ///         The file name contains the pipeline cache uuid of the driver, so caches of different drivers do not collide.
+        ///         With ImplicitFeatureFlagBits::PIPELINE_BINARY, compute and raster pipelines are recreated from archived binaries on later runs.
+        char const * pipeline_cache_directory = {};
+        /// @brief  Creates the device over all physical devices of the device group of physical_device_index, see DeviceProperties::device_group_size.
+        ///         Memory is allocated once per physical device. Submits, command recorders and task graph tasks select the executing physical devices with device masks.
+        ///         Requires identical gpus linked by the driver, for example with SLI or Crossfire.
+        bool device_group = false;
+        /// @brief  Pipelines keep a copy of their create info and spirv so they can be written into captures, see Device::begin_capture.
+        bool capturable = false;
     };
 
     struct Queue
@@ -366,16 +471,27 @@ namespace daxa
     static constexpr inline Queue QUEUE_COMPUTE_7 = Queue{QueueFamily::COMPUTE, 7};
     static constexpr inline Queue QUEUE_TRANSFER_0 = Queue{QueueFamily::TRANSFER, 0};
     static constexpr inline Queue QUEUE_TRANSFER_1 = Queue{QueueFamily::TRANSFER, 1};
+    static constexpr inline Queue QUEUE_VIDEO_DECODE_0 = Queue{QueueFamily::VIDEO_DECODE, 0};
+    static constexpr inline Queue QUEUE_VIDEO_ENCODE_0 = Queue{QueueFamily::VIDEO_ENCODE, 0};
 
     struct CommandSubmitInfo
     {
         Queue queue = daxa::QUEUE_MAIN;
+        /// @brief  Stage mask used for all semaphore waits without an explicit stage mask.
+        ///         An empty mask waits with ALL_COMMANDS.
         PipelineStageFlags wait_stages = {};
         std::span<ExecutableCommandList const> command_lists = {};
         std::span<BinarySemaphore const> wait_binary_semaphores = {};
         std::span<BinarySemaphore const> signal_binary_semaphores = {};
         std::span<std::pair<TimelineSemaphore, u64> const> wait_timeline_semaphores = {};
         std::span<std::pair<TimelineSemaphore, u64> const> signal_timeline_semaphores = {};
+        /// @brief  Optional per semaphore wait stage masks.
+        ///         Must either be empty or have the same size as the matching wait semaphore span.
+        std::span<PipelineStageFlags const> wait_binary_semaphore_stages = {};
+        std::span<PipelineStageFlags const> wait_timeline_semaphore_stages = {};
+        /// @brief  Physical devices of a device group that execute the command lists, bit i selects device i.
+        ///         Zero selects all of them. Semaphores are waited and signaled on device 0.
+        u32 device_mask = {};
     };
 
     struct PresentInfo
@@ -385,11 +501,131 @@ namespace daxa
         Queue queue = QUEUE_MAIN;
     };
 
+    struct GarbageCollectInfo
+    {
+        /// @brief  Maximum number of zombies destroyed by one call. Zero means no limit.
+        u64 max_destroyed_zombies = {};
+        /// @brief  Maximum time in nanoseconds spent destroying zombies in one call. Zero means no limit.
+        u64 max_nanoseconds = {};
+        /// @brief  Return immediately instead of waiting, when command recorders or submits hold the resource lifetime lock.
+        bool non_blocking = {};
+    };
+
+    struct DefragmentationPassInfo
+    {
+        /// @brief  Receives the copies from the old to the new allocations of the moved resources.
+        CommandRecorder & command_recorder;
+        /// @brief  Maximum number of bytes moved by one pass. Zero means no limit.
+        u64 max_bytes_per_pass = {};
+        /// @brief  Maximum number of allocations moved by one pass. Zero means no limit.
+        u32 max_allocations_per_pass = {};
+        /// @brief  Layout all movable images are in when the copies execute, the new images are left in it.
+        ImageLayout image_layout = ImageLayout::GENERAL;
+    };
+
+    struct MemoryHeapReport
+    {
+        bool device_local = {};
+        u64 size = {};
+        /// @brief  Budget and usage of the whole process, reported by VK_EXT_memory_budget when available, estimated otherwise.
+        u64 budget = {};
+        u64 usage = {};
+        /// @brief  Memory allocated by daxa, block_bytes includes the free space of its memory blocks.
+        u64 block_bytes = {};
+        u64 allocation_bytes = {};
+    };
+
+    enum struct MemoryReportResourceType
+    {
+        BUFFER,
+        IMAGE,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    struct MemoryReportAllocation
+    {
+        SmallString name = {};
+        MemoryReportResourceType type = {};
+        u64 size = {};
+    };
+
+    struct MemoryReport
+    {
+        FixedList<MemoryHeapReport, 16> heaps = {};
+        /// @brief  Sizes of the allocations owned by resources, resources placed in memory blocks are counted in memory_block_bytes.
+        u64 buffer_bytes = {};
+        u64 image_bytes = {};
+        /// @brief  Acceleration structures live in buffers, so their bytes are also part of buffer_bytes.
+        u64 acceleration_structure_bytes = {};
+        u64 memory_block_bytes = {};
+        u32 buffer_count = {};
+        u32 image_count = {};
+        u32 acceleration_structure_count = {};
+        /// @brief  Sorted by size, largest first.
+        FixedList<MemoryReportAllocation, 16> largest_allocations = {};
+    };
+
+    /// @brief  A device timestamp and the std::chrono::steady_clock time in nanoseconds, sampled at the same moment.
+    struct CalibratedTimestamps
+    {
+        /// @brief  Same clock as the timestamps of TimelineQueryPool, in ticks of DeviceProperties::limits.timestamp_period nanoseconds.
+        u64 device_ticks = {};
+        u64 host_ns = {};
+        /// @brief  Upper bound of the time between sampling the two clocks.
+        u64 max_deviation_ns = {};
+
+        /// @brief  Converts a timestamp of a TimelineQueryPool to std::chrono::steady_clock nanoseconds.
+        [[nodiscard]] auto device_ticks_to_host_ns(u64 ticks, f32 timestamp_period) const -> u64;
+        /// @brief  Converts std::chrono::steady_clock nanoseconds to the device timestamp clock.
+        [[nodiscard]] auto host_ns_to_device_ticks(u64 ns, f32 timestamp_period) const -> u64;
+    };
+
+    struct CaptureInfo
+    {
+        char const * path = {};
+        /// @brief  Also captures the contents of all buffers at the start of the capture and of host visible buffers before each submit.
+        ///         Without it, replays run on zeroed buffers, which is enough for commands that do not depend on the data.
+        bool capture_buffer_contents = {};
+    };
+
+    struct ReplayInfo
+    {
+        char const * path = {};
+        /// @brief  The captured submits are replayed this many times, at least once.
+        u32 repeat_count = 1;
+    };
+
+    struct ReplayStats
+    {
+        u32 buffer_count = {};
+        u32 image_count = {};
+        u32 image_view_count = {};
+        u32 sampler_count = {};
+        u32 pipeline_count = {};
+        u32 command_list_count = {};
+        u32 submit_count = {};
+        /// @brief  Resources and pipelines of the capture that could not be recreated, commands using them are skipped.
+        u32 failed_creation_count = {};
+        u64 command_count = {};
+        /// @brief  Commands that can not be captured, like acceleration structure builds, queries and secondary command lists.
+        u64 skipped_command_count = {};
+        /// @brief  Command lists recorded before the capture began, or failing to record on replay. Submits skip them.
+        u64 skipped_command_list_count = {};
+        /// @brief  Host time from the first submit of a repetition until the device is idle after the last one.
+        u64 min_ns = {};
+        u64 mean_ns = {};
+        u64 max_ns = {};
+    };
+
     struct MemoryBlockBufferInfo
     {
         BufferInfo buffer_info = {};
         MemoryBlock & memory_block;
         usize offset = {};
+        /// @brief  Only for device group devices. Every physical device accesses the memory instance of this physical device instead of its own.
+        ///         Supported peer accesses depend on the memory heap, see vkGetDeviceGroupPeerMemoryFeatures. Copy destinations work on at least one device local heap.
+        ///         Lets a gpu copy its results into the memory of another, for example to compose split frame rendering.
+        Optional<u32> peer_device_index = {};
     };
 
     struct MemoryBlockImageInfo
@@ -399,6 +635,79 @@ namespace daxa
         usize offset = {};
     };
 
+    struct SparseImageMemoryRequirements
+    {
+        Extent3D image_granularity = {};
+        bool single_mip_tail = {};
+        /// @brief  Mip levels at and above mip_tail_first_lod are bound as a whole with opaque binds.
+        u32 mip_tail_first_lod = {};
+        u64 mip_tail_size = {};
+        u64 mip_tail_offset = {};
+        u64 mip_tail_stride = {};
+    };
+
+    struct GeneratedCommandsMemoryRequirementsInfo
+    {
+        IndirectCommandsLayout layout = {};
+        IndirectExecutionSet execution_set = {};
+        u32 max_sequence_count = {};
+        /// Only used by layouts ending in DRAW_COUNT, DRAW_INDEXED_COUNT or DRAW_MESH_TASKS_COUNT tokens.
+        u32 max_draw_count = {};
+    };
+
+    struct SparseBufferBind
+    {
+        BufferId buffer = {};
+        u64 offset = {};
+        u64 size = {};
+        /// @brief  An empty memory block unbinds the range.
+        MemoryBlock memory_block = {};
+        u64 memory_block_offset = {};
+    };
+
+    /// @brief  Binds memory to the opaque memory range of an image, used for the mip tail.
+    struct SparseImageOpaqueBind
+    {
+        ImageId image = {};
+        u64 offset = {};
+        u64 size = {};
+        /// @brief  An empty memory block unbinds the range.
+        MemoryBlock memory_block = {};
+        u64 memory_block_offset = {};
+    };
+
+    /// @brief  Offset and extent are in texels and must be multiples of the image granularity, except at the edges of the mip level.
+    struct SparseImageBind
+    {
+        ImageId image = {};
+        ImageSlice slice = {};
+        Offset3D offset = {};
+        Extent3D extent = {};
+        /// @brief  An empty memory block unbinds the region.
+        MemoryBlock memory_block = {};
+        u64 memory_block_offset = {};
+    };
+
+    struct BindSparseInfo
+    {
+        Queue queue = daxa::QUEUE_MAIN;
+        std::span<SparseBufferBind const> buffer_binds = {};
+        std::span<SparseImageOpaqueBind const> image_opaque_binds = {};
+        std::span<SparseImageBind const> image_binds = {};
+        std::span<BinarySemaphore const> wait_binary_semaphores = {};
+        std::span<BinarySemaphore const> signal_binary_semaphores = {};
+        std::span<std::pair<TimelineSemaphore, u64> const> wait_timeline_semaphores = {};
+        std::span<std::pair<TimelineSemaphore, u64> const> signal_timeline_semaphores = {};
+    };
+
+    struct BufferRange
+    {
+        BufferId buffer = {};
+        u64 offset = {};
+        /// @brief  The default covers the rest of the buffer.
+        u64 size = std::numeric_limits<u64>::max();
+    };
+
     struct AccelerationStructureBuildSizesInfo
     {
         u64 acceleration_structure_size;
@@ -406,6 +715,12 @@ namespace daxa
         u64 build_scratch_size;
     };
 
+    struct MicromapBuildSizesInfo
+    {
+        u64 micromap_size;
+        u64 build_scratch_size;
+    };
+
     struct BufferTlasInfo
     {
         TlasInfo tlas_info = {};
@@ -440,14 +755,26 @@ namespace daxa
         [[nodiscard]] auto blas_build_sizes(BlasBuildInfo const & info) -> AccelerationStructureBuildSizesInfo;
         [[nodiscard]] auto as_build_sizes(TlasBuildInfo const & info) { return tlas_build_sizes(info); }
         [[nodiscard]] auto as_build_sizes(BlasBuildInfo const & info) { return blas_build_sizes(info); }
+        [[nodiscard]] auto micromap_build_sizes(MicromapBuildInfo const & info) -> MicromapBuildSizesInfo;
 
         [[nodiscard]] auto buffer_memory_requirements(BufferInfo const & info) const -> MemoryRequirements;
         [[nodiscard]] auto image_memory_requirements(ImageInfo const & info) const -> MemoryRequirements;
         [[nodiscard]] auto memory_requirements(BufferInfo const & info) const { return buffer_memory_requirements(info); }
         [[nodiscard]] auto memory_requirements(ImageInfo const & info) const { return image_memory_requirements(info); }
+        /// @brief  Memory requirements of a sparse buffer, the alignment is the sparse page size.
+        [[nodiscard]] auto sparse_buffer_memory_requirements(BufferInfo const & info) const -> MemoryRequirements;
+        /// @brief  Page granularity and mip tail of an image with ImageCreateFlagBits::SPARSE_RESIDENCY, for its first aspect.
+        ///         The page size is the alignment reported by image_memory_requirements for the same info.
+        [[nodiscard]] auto sparse_image_memory_requirements(ImageInfo const & info) const -> SparseImageMemoryRequirements;
+        /// @brief  Memory requirements of the preprocess buffer range needed by CommandRecorder::execute_generated_commands.
+        [[nodiscard]] auto generated_commands_memory_requirements(GeneratedCommandsMemoryRequirementsInfo const & info) const -> MemoryRequirements;
 
         [[nodiscard]] auto create_buffer(BufferInfo const & info) -> BufferId;
         [[nodiscard]] auto create_image(ImageInfo const & info) -> ImageId;
+        /// @brief  Creates a sparse resident buffer without memory, info.allocate_info is ignored.
+        ///         Sparse images are created with create_image and ImageCreateFlagBits::SPARSE_BINDING.
+        ///         Memory is bound to both with bind_sparse.
+        [[nodiscard]] auto create_sparse_buffer(BufferInfo const & info) -> BufferId;
         [[nodiscard]] auto create_buffer_from_memory_block(MemoryBlockBufferInfo const & info) -> BufferId;
         [[nodiscard]] auto create_image_from_memory_block(MemoryBlockImageInfo const & info) -> ImageId;
         [[nodiscard]] auto create_image_view(ImageViewInfo const & info) -> ImageViewId;
@@ -456,6 +783,12 @@ namespace daxa
         [[nodiscard]] auto create_blas(BlasInfo const & info) -> BlasId;
         [[nodiscard]] auto create_tlas_from_buffer(BufferTlasInfo const & info) -> TlasId;
         [[nodiscard]] auto create_blas_from_buffer(BufferBlasInfo const & info) -> BlasId;
+        /// @brief  Creates all resources or none of them.
+        ///         Much cheaper than single creations for many resources, as slots and descriptor writes are batched.
+        [[nodiscard]] auto create_buffers(std::span<BufferInfo const> infos) -> std::vector<BufferId>;
+        [[nodiscard]] auto create_images(std::span<ImageInfo const> infos) -> std::vector<ImageId>;
+        [[nodiscard]] auto create_image_views(std::span<ImageViewInfo const> infos) -> std::vector<ImageViewId>;
+        [[nodiscard]] auto create_images_from_memory_block(std::span<MemoryBlockImageInfo const> infos) -> std::vector<ImageId>;
         [[nodiscard]] auto create(BufferInfo const & info) { return create_buffer(info); }
         [[nodiscard]] auto create(ImageInfo const & info) { return create_image(info); }
         [[nodiscard]] auto create(MemoryBlockBufferInfo const & info) { return create_buffer_from_memory_block(info); }
@@ -479,6 +812,12 @@ namespace daxa
         void destroy(SamplerId id) { destroy_sampler(id); }
         void destroy(TlasId id) { destroy_tlas(id); }
         void destroy(BlasId id) { destroy_blas(id); }
+        /// @brief  Destroys many resources with a single zombie lock acquisition.
+        ///         Cheaper than destroying each id on its own, for example when unloading levels.
+        void destroy_buffers(std::span<BufferId const> ids);
+        void destroy_images(std::span<ImageId const> ids);
+        void destroy_image_views(std::span<ImageViewId const> ids);
+        void destroy_samplers(std::span<SamplerId const> ids);
 
         // TODO: deprecate?
 
@@ -534,9 +873,30 @@ namespace daxa
             }
             return {};
         }
+        /// @brief  Creates a new fd or win32 HANDLE referencing the memory of a resource created with an ExternalMemoryInfo::handle_type.
+        ///         The caller owns the handle, pass it to for example cudaImportExternalMemory.
+        ///         The allocation size of images is given by image_memory_requirements.
+        [[nodiscard]] auto export_memory(BufferId id) const -> u64;
+        [[nodiscard]] auto export_memory(ImageId id) const -> u64;
+        /// @brief  Makes host writes visible to the device, needed for non coherent memory like MemoryFlagBits::HOST_CACHED.
+        ///         All ranges are flushed with a single vmaFlushAllocations, coherent ranges are skipped.
+        void flush_ranges(std::span<BufferRange const> ranges);
+        /// @brief  Makes finished device writes visible to the host, needed for non coherent memory like MemoryFlagBits::HOST_CACHED.
+        ///         All ranges are invalidated with a single vmaInvalidateAllocations, coherent ranges are skipped.
+        void invalidate_ranges(std::span<BufferRange const> ranges);
 
         [[nodiscard]] auto create_raster_pipeline(RasterPipelineInfo const & info) -> RasterPipeline;
         [[nodiscard]] auto create_compute_pipeline(ComputePipelineInfo const & info) -> ComputePipeline;
+        /// @brief  Creates all pipelines, compiling them on multiple threads. Throws if any creation fails, no pipeline is created then.
+        [[nodiscard]] auto create_compute_pipelines(std::span<ComputePipelineInfo const> infos) -> std::vector<ComputePipeline>;
+        /// @brief  Returns the pipeline without waiting for its compilation, which runs on device owned worker threads.
+        ///         Until it is ready, recorders bind the fallback in its place. Without a ready fallback only its layout is bound
+        ///         and draws and dispatches are skipped until the next pipeline bind.
+        /// NOTE:
+        /// * the byte code and specialization constants of the info are copied, they do not have to outlive the call.
+        /// * destroying a pending pipeline cancels its compilation when it has not started yet, otherwise it waits for it.
+        [[nodiscard]] auto create_compute_pipeline_async(ComputePipelineInfo const & info, ComputePipeline const & fallback = {}) -> ComputePipeline;
+        [[nodiscard]] auto create_raster_pipeline_async(RasterPipelineInfo const & info, RasterPipeline const & fallback = {}) -> RasterPipeline;
         [[nodiscard]] auto create_ray_tracing_pipeline(RayTracingPipelineInfo const & info) -> RayTracingPipeline;
 
         [[nodiscard]] auto create_swapchain(SwapchainInfo const & info) -> Swapchain;
@@ -547,14 +907,43 @@ namespace daxa
         [[nodiscard]] auto create_timeline_semaphore(TimelineSemaphoreInfo const & info) -> TimelineSemaphore;
         [[nodiscard]] auto create_event(EventInfo const & info) -> Event;
         [[nodiscard]] auto create_timeline_query_pool(TimelineQueryPoolInfo const & info) -> TimelineQueryPool;
+        [[nodiscard]] auto create_query_pool(QueryPoolInfo const & info) -> QueryPool;
+        [[nodiscard]] auto create_indirect_commands_layout(IndirectCommandsLayoutInfo const & info) -> IndirectCommandsLayout;
+        [[nodiscard]] auto create_indirect_execution_set(IndirectExecutionSetInfo const & info) -> IndirectExecutionSet;
+        [[nodiscard]] auto create_shader_object(ShaderObjectInfo const & info) -> ShaderObject;
+        /// @brief  Creates the micromap in a dedicated buffer of info.size bytes, see micromap_build_sizes.
+        [[nodiscard]] auto create_micromap(MicromapInfo const & info) -> Micromap;
+        /// @brief  Creates the session with its own memory and, when info.codec_parameters is set, its session parameters.
+        [[nodiscard]] auto create_video_session(VideoSessionInfo const & info) -> VideoSession;
 
         void wait_idle();
+        /// @brief  Waits until all, or any when wait_any is set, semaphores reach their values with a single vkWaitSemaphores.
+        /// @return false when the timeout expired first.
+        [[nodiscard]] auto wait_semaphores(std::span<std::pair<TimelineSemaphore, u64> const> pairs, bool wait_any = false, u64 timeout_nanos = ~0ull) -> bool;
+        /// @brief  Calls callback from the device reactor thread once semaphore reaches value, replaces polling many in flight timelines.
+        ///         Callbacks must not block, they share one thread. Callbacks still pending on device destruction are dropped.
+        void on_timeline(TimelineSemaphore const & semaphore, u64 value, std::function<void()> callback);
 
         void queue_wait_idle(Queue queue);
         auto queue_count(QueueFamily queue_count) -> u32;
 
         void submit_commands(CommandSubmitInfo const & submit_info);
+        /// @brief  Every submit takes the next value of the device submit timeline.
+        /// @return value of the latest submit.
+        [[nodiscard]] auto latest_submit_index() const -> u64;
+        /// @return value up to which all submits finished on the gpu.
+        [[nodiscard]] auto completed_submit_index() const -> u64;
+        /// @brief  Submits all infos with a single queue submit call.
+        ///         All infos must target the same queue.
+        ///         Cheaper than calling submit_commands for each info, as validation and locking is done once per batch.
+        void submit_batch(std::span<CommandSubmitInfo const> submit_infos);
         void present_frame(PresentInfo const & info);
+        /// @brief  Binds memory block ranges to sparse buffers and images.
+        ///         Requires ImplicitFeatureFlagBits::SPARSE_BINDING and a queue with sparse binding support, usually the main queue.
+        /// NOTE:
+        /// * memory blocks must stay alive as long as they are bound.
+        /// * binds are ordered with other queue work through the semaphores in info only.
+        void bind_sparse(BindSparseInfo const & info);
 
         /// @brief  Actually destroys all resources that are ready to be destroyed.
         ///         When calling destroy, or removing all references to an object, it is zombified not really destroyed.
@@ -566,6 +955,59 @@ namespace daxa
         /// * SoftwareCommandRecorder is exempt from this limitation,
         ///   you can freely record those in parallel with collect_garbage
         void collect_garbage();
+        /// @brief  Like collect_garbage, but stops once the budget in info is used up.
+        ///         Meant to be called every frame. A non_blocking call never waits for threads that record or submit commands.
+        /// NOTE:
+        /// * the resource lifetime lock is held exclusively for the whole call, like collect_garbage
+        /// * while it runs, creating command recorders and submitting block, the budget bounds how long
+        /// @return true when all zombies that were ready got destroyed.
+        ///         false when the budget ran out first or the lifetime lock could not be taken without blocking.
+        [[nodiscard]] auto collect_garbage_incremental(GarbageCollectInfo const & info) -> bool;
+        /// @brief  Writes the pipeline cache to DeviceInfo2::pipeline_cache_directory. Also happens on device destruction.
+        void save_pipeline_cache();
+        /// @brief  Per heap budget and usage, per resource type totals and the largest resource allocations.
+        ///         Poll it to evict before running out of memory.
+        /// THREADSAFETY:
+        /// * resources created or destroyed on other threads while the report is built may or may not be included.
+        [[nodiscard]] auto memory_report() const -> MemoryReport;
+        /// @brief  Requires ImplicitFeatureFlagBits::CALIBRATED_TIMESTAMPS.
+        ///         Samples the device timestamp clock together with std::chrono::steady_clock.
+        ///         The clocks drift apart slowly, calibrate again every few seconds when correlating long captures.
+        [[nodiscard]] auto calibrated_timestamps() const -> CalibratedTimestamps;
+        /// @brief  Moves resources created with MemoryFlagBits::MOVABLE to compact the device memory.
+        ///         Records the copies of the moved resources into info.command_recorder.
+        ///         Moved images are transitioned from info.image_layout for the copies, the new images are left in info.image_layout.
+        ///         Submit the recorder, wait for it to finish and call end_defragmentation_pass.
+        /// NOTE:
+        /// * movable resources must not be used on the gpu or destroyed between begin and end of the pass.
+        /// * ids stay the same, device and host addresses of moved buffers change.
+        /// * buffers backing acceleration structures must not be movable.
+        /// @return number of moved resources. Zero means the memory is already compact.
+        [[nodiscard]] auto begin_defragmentation_pass(DefragmentationPassInfo const & info) -> u32;
+        /// @brief  Swaps the moved resources to their new allocations and frees the old ones.
+        /// @return true when defragmentation is complete, false when another pass can compact the memory further.
+        auto end_defragmentation_pass() -> bool;
+        /// @brief  Requires DeviceInfo2::capturable. Writes the resources alive at this point into a capture file.
+        ///         From then on, created resources and pipelines, submitted command lists and the submits are appended to it.
+        ///         Only command lists recorded after this call are captured.
+        ///         Replay the file with replay_capture, or the daxa_replay tool, to time the captured gpu work without the application.
+        /// NOTE:
+        /// * image contents are not captured, images start out undefined on replay.
+        /// * device addresses inside of push constants and buffer contents are translated on replay by value,
+        ///   any 8 byte aligned value inside the address range of a captured buffer is treated as an address.
+        /// * acceleration structure, query, video and secondary command list commands are not captured.
+        void begin_capture(CaptureInfo const & info);
+        void end_capture();
+        /// @brief  Recreates the resources and pipelines of a capture with their captured ids, records the captured command lists
+        ///         and replays the submits info.repeat_count times. Destroys everything it created before returning.
+        /// THREADSAFETY:
+        /// * no other thread may create resources on the device during the replay.
+        /// * the ids of the capture must not be taken on this device, replay on a fresh device.
+        [[nodiscard]] auto replay_capture(ReplayInfo const & info) -> ReplayStats;
+        /// @brief  Sets the address of the ring that daxa_assert and daxa_printf in shaders write into, 0 disables them.
+        ///         Takes effect for gpu work executing after the call. Usually set by ShaderDebugRing from daxa/utils/mem.hpp.
+        void set_shader_debug_address(DeviceAddress address);
+        [[nodiscard]] auto shader_debug_address() const -> DeviceAddress;
 
         /// THREADSAFETY:
         /// * reference MUST NOT be read after the device is destroyed.
@@ -607,4 +1049,7 @@ namespace daxa
         static auto inc_refcnt(ImplHandle const * object) -> u64;
         static auto dec_refcnt(ImplHandle const * object) -> u64;
     };
+
+    /// @brief  Borrowed device for task callbacks and other hot paths, see BorrowedPtr.
+    using DeviceRef = BorrowedPtr<Device>;
 } // namespace daxa
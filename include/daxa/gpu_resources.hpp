@@ -89,12 +89,36 @@ namespace daxa
 
     DAXA_EXPORT_CXX auto to_string(GPUResourceId const & id) -> std::string;
 
+    enum struct ExternalMemoryHandleType
+    {
+        NONE = 0,
+        OPAQUE_FD = 0x00000001,
+        OPAQUE_WIN32 = 0x00000002,
+        DMA_BUF = 0x00000200,
+        MAX_ENUM = 0x7FFFFFFF,
+    };
+
+    /// @brief  Memory shared with other apis or processes, for example CUDA or a hardware video decoder.
+    ///         External resources get a dedicated device local allocation, they can not be sparse or placed in a memory block.
+    ///         Requires ImplicitFeatureFlagBits::EXTERNAL_MEMORY.
+    struct ExternalMemoryInfo
+    {
+        ExternalMemoryHandleType handle_type = ExternalMemoryHandleType::NONE;
+        /// @brief  Without a value the memory is allocated exportable, see Device::export_memory.
+        ///         With a value the memory is imported from this fd or win32 HANDLE. A successful fd import transfers ownership of the fd to the device.
+        Optional<u64> import_handle = {};
+    };
+
     struct BufferInfo
     {
         usize size = {};
-        // Ignored when allocating with a memory block.
+        // Ignored when allocating with a memory block or external memory.
         MemoryFlags allocate_info = {};
         SmallString name = {};
+        ExternalMemoryInfo external_memory = {};
+        // Adds the video decode and encode usages for bitstream buffers and creates the buffer independent of any video profile.
+        // Requires ImplicitFeatureFlagBits::VIDEO.
+        bool video_bitstream = {};
     };
 
     struct DAXA_EXPORT_CXX ImageCreateFlagsProperties
@@ -105,6 +129,11 @@ namespace daxa
     struct ImageCreateFlagBits
     {
         static inline constexpr ImageCreateFlags NONE = {0x00000000};
+        /// @brief  Sparse images get no memory on creation, memory is bound with Device::bind_sparse.
+        static inline constexpr ImageCreateFlags SPARSE_BINDING = {0x00000001};
+        /// @brief  Allows binding memory to parts of the image, requires SPARSE_BINDING.
+        static inline constexpr ImageCreateFlags SPARSE_RESIDENCY = {0x00000002};
+        static inline constexpr ImageCreateFlags SPARSE_ALIASED = {0x00000004};
         static inline constexpr ImageCreateFlags ALLOW_MUTABLE_FORMAT = {0x00000008};
         static inline constexpr ImageCreateFlags COMPATIBLE_CUBE = {0x00000010};
         static inline constexpr ImageCreateFlags COMPATIBLE_2D_ARRAY = {0x00000020};
@@ -128,9 +157,13 @@ namespace daxa
         u32 sample_count = 1;
         ImageUsageFlags usage = {};
         SharingMode sharing_mode = SharingMode::EXCLUSIVE;
-        // Ignored when allocating with a memory block.
+        // Ignored when allocating with a memory block or external memory.
         MemoryFlags allocate_info = {};
         SmallString name = {};
+        // ExternalMemoryHandleType::DMA_BUF images are created with linear tiling.
+        ExternalMemoryInfo external_memory = {};
+        // Only used with video usages. VideoCodecOperation::NONE creates a video profile independent image, which can not be used as DPB.
+        VideoProfileInfo video_profile = {};
     };
 
     struct ImageViewInfo
@@ -163,6 +196,123 @@ namespace daxa
         SmallString name = {};
     };
 
+    /// Values match VkOpacityMicromapFormatEXT.
+    enum struct OpacityMicromapFormat
+    {
+        OPACITY_2_STATE = 1,
+        OPACITY_4_STATE = 2,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    /// Layout of VkMicromapUsageEXT.
+    struct MicromapUsage
+    {
+        u32 count = {};
+        u32 subdivision_level = {};
+        OpacityMicromapFormat format = OpacityMicromapFormat::OPACITY_2_STATE;
+    };
+
+    struct MicromapBuildFlagsProperties
+    {
+        using Data = u32;
+    };
+    using MicromapBuildFlags = Flags<MicromapBuildFlagsProperties>;
+    struct MicromapBuildFlagBits
+    {
+        static inline constexpr MicromapBuildFlags PREFER_FAST_TRACE = {0x00000001};
+        static inline constexpr MicromapBuildFlags PREFER_FAST_BUILD = {0x00000002};
+        static inline constexpr MicromapBuildFlags ALLOW_COMPACTION = {0x00000004};
+    };
+
+    struct MicromapInfo
+    {
+        u64 size = {};
+        SmallString name = {};
+    };
+
+    /**
+     * @brief   Per micro triangle opacity of blas triangles, requires ImplicitFeatureFlagBits::OPACITY_MICROMAP.
+     *          Traversal skips any hit shaders for micro triangles that are known to be fully opaque or transparent.
+     *          Built with ComputeCommandRecorder::build_micromaps and attached to BlasTriangleGeometryInfo::opacity_micromap.
+     *
+     * THREADSAFETY:
+     * * is internally synchronized
+     * * may be passed to different threads
+     * * may be used by multiple threads at the same time.
+     */
+    struct DAXA_EXPORT_CXX Micromap final : ManagedPtr<Micromap, daxa_Micromap>
+    {
+        Micromap() = default;
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        [[nodiscard]] auto info() const -> MicromapInfo const &;
+        /// @brief  Buffer backing the micromap, destroyed together with it.
+        ///         Used as the task buffer of MICROMAP_BUILD_WRITE and ACCELERATION_STRUCTURE_BUILD_READ attachments.
+        [[nodiscard]] auto buffer_id() const -> BufferId;
+
+      protected:
+        template <typename T, typename H_T>
+        friend struct ManagedPtr;
+        static auto inc_refcnt(ImplHandle const * object) -> u64;
+        static auto dec_refcnt(ImplHandle const * object) -> u64;
+    };
+
+    struct VideoSessionInfo
+    {
+        /// @brief  Decode profiles create a session for the video decode queue, encode profiles one for the video encode queue.
+        VideoProfileInfo profile = {};
+        Format picture_format = Format::G8_B8R8_2PLANE_420_UNORM;
+        Extent2D max_coded_extent = {};
+        Format reference_picture_format = Format::G8_B8R8_2PLANE_420_UNORM;
+        u32 max_dpb_slots = {};
+        u32 max_active_reference_pictures = {};
+        /// @brief  Optional codec specific VkVideo{Decode,Encode}{H264,H265}SessionParametersCreateInfoKHR holding the parameter sets of the stream.
+        ///         Only read during creation. Without it the session has no parameters object.
+        void const * codec_parameters = {};
+        SmallString name = {};
+    };
+
+    /**
+     * @brief   Decoder or encoder state of one video stream, requires ImplicitFeatureFlagBits::VIDEO.
+     *          Used by the video coding commands of TransferCommandRecorders on the video queue family of its codec operation.
+     *
+     * THREADSAFETY:
+     * * is internally synchronized
+     * * may be passed to different threads
+     * * may be used by multiple threads at the same time.
+     */
+    struct DAXA_EXPORT_CXX VideoSession final : ManagedPtr<VideoSession, daxa_VideoSession>
+    {
+        VideoSession() = default;
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        [[nodiscard]] auto info() const -> VideoSessionInfo const &;
+
+      protected:
+        template <typename T, typename H_T>
+        friend struct ManagedPtr;
+        static auto inc_refcnt(ImplHandle const * object) -> u64;
+        static auto dec_refcnt(ImplHandle const * object) -> u64;
+    };
+
+    struct MicromapBuildInfo
+    {
+        MicromapBuildFlags flags = MicromapBuildFlagBits::PREFER_FAST_TRACE;
+        Micromap dst_micromap = {};
+        /// Number of triangles per subdivision level and format contained in data.
+        Span<MicromapUsage const> usage_counts = {};
+        /// Packed opacity values of all triangles.
+        DeviceAddress data = {};
+        /// Array of VkMicromapTriangleEXT, giving the offset into data, subdivision level and format of each triangle.
+        DeviceAddress triangle_array = {};
+        u64 triangle_array_stride = 8;
+        DeviceAddress scratch_data = {};
+    };
+
     struct GeometryFlagsProperties
     {
         using Data = u32;
@@ -186,6 +336,15 @@ namespace daxa
         DeviceAddress transform_data = {};
         u32 count = {};
         GeometryFlags flags = GeometryFlagBits::OPAQUE;
+        /// @brief  Optional, requires ImplicitFeatureFlagBits::OPACITY_MICROMAP.
+        ///         Triangles pick their micromap triangle from opacity_micromap_index_data, offset by opacity_micromap_base_triangle.
+        ///         Negative indices of VkOpacityMicromapSpecialIndexEXT mark whole triangles as opaque or transparent.
+        Micromap opacity_micromap = {};
+        Span<MicromapUsage const> opacity_micromap_usage_counts = {};
+        IndexType opacity_micromap_index_type = IndexType::uint32;
+        DeviceAddress opacity_micromap_index_data = {};
+        u64 opacity_micromap_index_stride = 4;
+        u32 opacity_micromap_base_triangle = {};
     };
 
     struct BlasAabbGeometryInfo
@@ -223,6 +382,8 @@ namespace daxa
     struct TlasBuildInfo
     {
         AccelerationStructureBuildFlags flags = daxa::AccelerationStructureBuildFlagBits::PREFER_FAST_TRACE;
+        /// @brief  Refits src_tlas into dst_tlas, both built with the same flags including ALLOW_UPDATE. A null src_tlas refits dst_tlas in place.
+        ///         Refits need update_scratch_size scratch memory, see Device::tlas_build_sizes.
         bool update = false;
         TlasId src_tlas = {};
         TlasId dst_tlas = {};
@@ -233,6 +394,9 @@ namespace daxa
     struct BlasBuildInfo
     {
         AccelerationStructureBuildFlags flags = daxa::AccelerationStructureBuildFlagBits::PREFER_FAST_TRACE;
+        /// @brief  Refits src_blas into dst_blas, both built with the same flags including ALLOW_UPDATE. A null src_blas refits dst_blas in place.
+        ///         Geometry and primitive counts must match the original build, only vertex, aabb and transform data may change.
+        ///         Refits need update_scratch_size scratch memory, see Device::blas_build_sizes.
         bool update = false;
         BlasId src_blas = {};
         BlasId dst_blas = {};
@@ -18,6 +18,13 @@ namespace daxa
         static inline constexpr ShaderCreateFlags REQUIRE_FULL_SUBGROUPS  = {0x00000002};
     };
 
+    /// Values are bit casted to the 32 bit type of the constant (bool, int, uint or float).
+    struct SpecializationConstant
+    {
+        u32 constant_id = {};
+        u32 value = {};
+    };
+
     struct ShaderInfo
     {
         u32 const * byte_code = {};
@@ -25,6 +32,8 @@ namespace daxa
         ShaderCreateFlags create_flags = {};
         Optional<u32> required_subgroup_size = {};
         SmallString entry_point = "main";
+        /// Constant ids must be unique. Like the byte code, only read while the pipeline is created.
+        Span<SpecializationConstant const> specialization_constants = {};
     };
 
     // TODO: find a better way to link shader groups to shaders than by index
@@ -94,11 +103,20 @@ namespace daxa
         static auto dec_refcnt(ImplHandle const * object) -> u64;
     };
 
+    enum struct PipelineStatus
+    {
+        PENDING = 0,
+        READY = 1,
+        /// The compilation failed, the pipeline stays unusable. wait() throws the error.
+        FAILED = 2,
+    };
+
     struct ComputePipelineInfo
     {
         ShaderInfo shader_info = {};
         u32 push_constant_size = {};
         SmallString name = {};
+        bool indirect_bindable = false;
     };
 
     /**
@@ -117,6 +135,10 @@ namespace daxa
         /// * reference MUST NOT be read after the object is destroyed.
         /// @return reference to info of object.
         [[nodiscard]] auto info() const -> ComputePipelineInfo const &;
+        /// @brief  Pipelines created with Device::create_compute_pipeline_async are PENDING until their compilation finished. Never waits.
+        [[nodiscard]] auto status() const -> PipelineStatus;
+        /// @brief  Blocks until the pipeline is no longer pending. Throws when its compilation failed.
+        void wait() const;
 
       protected:
         template <typename T, typename H_T>
@@ -179,6 +201,18 @@ namespace daxa
         TesselationDomainOrigin origin = {};
     };
 
+    enum struct RasterPipelineLinkMode
+    {
+        /// All state is compiled into one pipeline.
+        MONOLITHIC = 0,
+        /// The vertex input, pre-rasterization, fragment shader and fragment output parts are compiled as separate pipeline libraries.
+        /// Parts are cached on the device, pipelines sharing a part only compile the parts that differ and are linked without optimization.
+        FAST_LINK = 1,
+        /// Same parts as FAST_LINK, linked with link time optimization. Slower to create, as fast to execute as a monolithic pipeline.
+        OPTIMIZED_LINK = 2,
+        MAX_ENUM = 0x7fffffff,
+    };
+
     struct RasterPipelineInfo
     {
         Optional<ShaderInfo> mesh_shader_info = {};
@@ -193,6 +227,9 @@ namespace daxa
         RasterizerInfo raster = {};
         u32 push_constant_size = {};
         SmallString name = {};
+        bool indirect_bindable = false;
+        /// Falls back to MONOLITHIC without ImplicitFeatureFlagBits::GRAPHICS_PIPELINE_LIBRARY, without fast linking support and for indirect bindable pipelines.
+        RasterPipelineLinkMode link_mode = RasterPipelineLinkMode::MONOLITHIC;
     };
 
     /**
@@ -211,6 +248,161 @@ namespace daxa
         /// * reference MUST NOT be read after the object is destroyed.
         /// @return reference to info of object.
         [[nodiscard]] auto info() const -> RasterPipelineInfo const &;
+        /// @brief  Pipelines created with Device::create_raster_pipeline_async are PENDING until their compilation finished. Never waits.
+        [[nodiscard]] auto status() const -> PipelineStatus;
+        /// @brief  Blocks until the pipeline is no longer pending. Throws when its compilation failed.
+        void wait() const;
+
+      protected:
+        template <typename T, typename H_T>
+        friend struct ManagedPtr;
+        static auto inc_refcnt(ImplHandle const * object) -> u64;
+        static auto dec_refcnt(ImplHandle const * object) -> u64;
+    };
+
+    /// Values match VkIndirectCommandsTokenTypeEXT.
+    enum struct IndirectCommandsTokenType
+    {
+        EXECUTION_SET = 0,
+        PUSH_CONSTANT = 1,
+        SEQUENCE_INDEX = 2,
+        INDEX_BUFFER = 3,
+        DRAW_INDEXED = 5,
+        DRAW = 6,
+        DRAW_INDEXED_COUNT = 7,
+        DRAW_COUNT = 8,
+        DISPATCH = 9,
+        DRAW_MESH_TASKS = 1000328000,
+        DRAW_MESH_TASKS_COUNT = 1000328001,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    struct IndirectCommandsToken
+    {
+        IndirectCommandsTokenType type = {};
+        /// Byte offset of the token data within one sequence of the indirect buffer.
+        u32 offset = {};
+        /// Only used by PUSH_CONSTANT and SEQUENCE_INDEX tokens.
+        u32 push_constant_offset = {};
+        u32 push_constant_size = {};
+    };
+
+    /// The first token must be the only EXECUTION_SET token, the last token must be the only action token (draw or dispatch).
+    /// The shader stages are derived from the action token.
+    struct IndirectCommandsLayoutInfo
+    {
+        Span<IndirectCommandsToken const> tokens = {};
+        u32 indirect_stride = {};
+        /// Push constant size of all pipelines used with this layout.
+        u32 push_constant_size = {};
+        bool unordered_sequences = false;
+        SmallString name = {};
+    };
+
+    /**
+     * @brief   Describes how sequences in an indirect buffer are turned into commands by the gpu.
+     *
+     * THREADSAFETY:
+     * * is internally synchronized
+     * * may be passed to different threads
+     * * may be used by multiple threads at the same time.
+     */
+    struct DAXA_EXPORT_CXX IndirectCommandsLayout final : ManagedPtr<IndirectCommandsLayout, daxa_IndirectCommandsLayout>
+    {
+        IndirectCommandsLayout() = default;
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        [[nodiscard]] auto info() const -> IndirectCommandsLayoutInfo const &;
+
+      protected:
+        template <typename T, typename H_T>
+        friend struct ManagedPtr;
+        static auto inc_refcnt(ImplHandle const * object) -> u64;
+        static auto dec_refcnt(ImplHandle const * object) -> u64;
+    };
+
+    /// Exactly one of the initial pipelines must be set, it occupies index 0 of the set.
+    /// All pipelines in the set must be created with indirect_bindable and share the same push constant size.
+    struct IndirectExecutionSetInfo
+    {
+        ComputePipeline initial_compute_pipeline = {};
+        RasterPipeline initial_raster_pipeline = {};
+        u32 max_pipeline_count = 1;
+        SmallString name = {};
+    };
+
+    /**
+     * @brief   Table of pipelines the gpu can switch between while executing generated commands.
+     *
+     * THREADSAFETY:
+     * * is internally synchronized
+     * * may be passed to different threads
+     * * may be used by multiple threads at the same time.
+     * * slots MUST NOT be written while a pending execution uses them.
+     */
+    struct DAXA_EXPORT_CXX IndirectExecutionSet final : ManagedPtr<IndirectExecutionSet, daxa_IndirectExecutionSet>
+    {
+        IndirectExecutionSet() = default;
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        [[nodiscard]] auto info() const -> IndirectExecutionSetInfo const &;
+
+        /// @brief  Writes a pipeline into a slot, the set keeps it alive until the slot is overwritten or the set is destroyed.
+        void write_pipeline(u32 index, ComputePipeline const & pipeline);
+        void write_pipeline(u32 index, RasterPipeline const & pipeline);
+
+      protected:
+        template <typename T, typename H_T>
+        friend struct ManagedPtr;
+        static auto inc_refcnt(ImplHandle const * object) -> u64;
+        static auto dec_refcnt(ImplHandle const * object) -> u64;
+    };
+
+    /// Values match VkShaderStageFlagBits.
+    enum struct ShaderObjectStage
+    {
+        VERTEX = 0x00000001,
+        TESSELLATION_CONTROL = 0x00000002,
+        TESSELLATION_EVALUATION = 0x00000004,
+        FRAGMENT = 0x00000010,
+        COMPUTE = 0x00000020,
+        TASK = 0x00000040,
+        MESH = 0x00000080,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    struct ShaderObjectInfo
+    {
+        ShaderInfo shader_info = {};
+        ShaderObjectStage stage = ShaderObjectStage::COMPUTE;
+        /// All shader objects bound together must share the same push constant size.
+        u32 push_constant_size = {};
+        /// Mesh shaders only. Mesh shaders created with it must be bound without a task shader, all others require one.
+        bool no_task_shader = false;
+        SmallString name = {};
+    };
+
+    /**
+     * @brief   A single shader stage compiled without any pipeline state, requires ImplicitFeatureFlagBits::SHADER_OBJECT.
+     *          All fixed function state is given when the shader objects are bound.
+     *
+     * THREADSAFETY:
+     * * is internally synchronized
+     * * may be passed to different threads
+     * * may be used by multiple threads at the same time.
+     */
+    struct DAXA_EXPORT_CXX ShaderObject final : ManagedPtr<ShaderObject, daxa_ShaderObject>
+    {
+        ShaderObject() = default;
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        [[nodiscard]] auto info() const -> ShaderObjectInfo const &;
 
       protected:
         template <typename T, typename H_T>
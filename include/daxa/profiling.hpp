@@ -0,0 +1,28 @@
+#pragma once
+
+#include <daxa/types.hpp>
+
+#include <vector>
+
+namespace daxa
+{
+    /// @brief  A cpu zone of daxa, recorded by the builtin recorder when daxa is built with DAXA_ENABLE_PROFILING_BUILTIN.
+    ///         Built with DAXA_ENABLE_PROFILING_TRACY, the zones are sent to tracy instead.
+    struct ProfileZone
+    {
+        /// @brief  Static string, stays valid for the lifetime of the program.
+        char const * name = {};
+        /// @brief  std::chrono::steady_clock nanoseconds.
+        u64 begin_ns = {};
+        u64 end_ns = {};
+        /// @brief  Dense index of the recording thread, assigned in order of the first zone of each thread.
+        u32 thread_index = {};
+        /// @brief  Number of zones this zone is nested in on its thread.
+        u32 depth = {};
+    };
+
+    /// @brief  Returns the zones finished since the last call, oldest first.
+    ///         The builtin recorder keeps the last DAXA_PROFILE_ZONE_RING_CAPACITY zones, collect at least once per frame.
+    ///         Always empty without the builtin recorder.
+    [[nodiscard]] DAXA_EXPORT_CXX auto collect_profile_zones() -> std::vector<ProfileZone>;
+} // namespace daxa
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <daxa/device.hpp>
+#include <daxa/c/device.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace daxa
+{
+    /// @brief  Header only buffer lookups, for hot paths that can not afford a call into daxa per lookup.
+    ///         Each lookup is a handful of loads into the buffer pool of the device, an invalid id never reads unallocated memory.
+    ///         Validates ids the same way Device::is_id_valid does, but never throws.
+    ///         The view stays valid for the lifetime of the device.
+    ///         Not included by daxa.hpp, include daxa/resource_pool_view.hpp to use it.
+    struct BufferPoolView
+    {
+        daxa_BufferPoolView pool = {};
+
+        explicit BufferPoolView(Device const & device) : pool{daxa_dvc_buffer_pool_view(device.get())} {}
+
+        [[nodiscard]] auto is_valid(BufferId id) const -> bool
+        {
+            return page_of(id) != nullptr;
+        }
+
+        [[nodiscard]] auto device_address(BufferId id) const -> Optional<DeviceAddress>
+        {
+            std::byte const * page = page_of(id);
+            if (page == nullptr)
+            {
+                return None;
+            }
+            return hot_slot(page, id).device_address;
+        }
+
+        /// @brief  Empty for invalid ids and buffers that are not host visible.
+        [[nodiscard]] auto host_address(BufferId id) const -> Optional<std::byte *>
+        {
+            std::byte const * page = page_of(id);
+            if (page == nullptr || hot_slot(page, id).host_address == nullptr)
+            {
+                return None;
+            }
+            return static_cast<std::byte *>(hot_slot(page, id).host_address);
+        }
+
+        template <typename T>
+        [[nodiscard]] auto host_address_as(BufferId id) const -> Optional<T *>
+        {
+            auto opt = host_address(id);
+            if (opt.has_value())
+            {
+                return {reinterpret_cast<T *>(opt.value())};
+            }
+            return {};
+        }
+
+        [[nodiscard]] auto info(BufferId id) const -> Optional<BufferInfo>
+        {
+            std::byte const * page = page_of(id);
+            if (page == nullptr)
+            {
+                return None;
+            }
+            // The slot may be recycled while it is copied, the version is checked again after the copy.
+            BufferInfo ret = {};
+            std::memcpy(&ret, page + pool.slots_offset + slot_offset(id) * pool.slot_stride, sizeof(BufferInfo));
+            if (version(page, id) != id.version)
+            {
+                return None;
+            }
+            return ret;
+        }
+
+      private:
+        [[nodiscard]] auto slot_offset(BufferId id) const -> u64
+        {
+            return static_cast<u64>(id.index) & ((1ull << pool.page_bits) - 1ull);
+        }
+
+        [[nodiscard]] auto version(std::byte const * page, BufferId id) const -> u64
+        {
+            auto const * versions = reinterpret_cast<std::atomic_uint64_t const *>(page + pool.versions_offset);
+            return versions[slot_offset(id)].load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] auto hot_slot(std::byte const * page, BufferId id) const -> daxa_BufferHotSlot const &
+        {
+            return reinterpret_cast<daxa_BufferHotSlot const *>(page + pool.hot_slots_offset)[slot_offset(id)];
+        }
+
+        // The page holding the slot of the id, nullptr when the id is invalid.
+        [[nodiscard]] auto page_of(BufferId id) const -> std::byte const *
+        {
+            u64 const page_index = static_cast<u64>(id.index) >> pool.page_bits;
+            u32 const valid_page_count = static_cast<std::atomic_uint32_t const *>(pool.valid_page_count)->load(std::memory_order_acquire);
+            if (id.version == 0 || page_index >= valid_page_count)
+            {
+                return nullptr;
+            }
+            auto const * page = static_cast<std::byte const *>(pool.pages[page_index]);
+            if (version(page, id) != id.version)
+            {
+                return nullptr;
+            }
+            return page;
+        }
+    };
+} // namespace daxa
@@ -19,6 +19,48 @@ namespace daxa
         }
     }
 
+    /// @brief  Unsupported modes fall back to the next lower mode the device supports.
+    enum struct SwapchainLatencyMode
+    {
+        /// @brief  Frames are only limited by max_allowed_frames_in_flight.
+        DEFAULT,
+        /// @brief  Swapchain::wait_for_frame_start waits until the frame max_allowed_frames_in_flight frames back is on screen.
+        ///         Requires ImplicitFeatureFlagBits::PRESENT_WAIT.
+        PRESENT_WAIT,
+        /// @brief  Swapchain::wait_for_frame_start sleeps until the driver reported optimal cpu start time (VK_NV_low_latency2).
+        ///         Requires ImplicitFeatureFlagBits::LOW_LATENCY.
+        LOW_LATENCY,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    static inline constexpr usize SWAPCHAIN_FRAME_STATISTICS_COUNT = 64;
+
+    /// @brief  Timings of one presented frame, all times are in nanoseconds.
+    ///         Timestamps use the monotonic clock of the presentation engine (CLOCK_MONOTONIC on linux).
+    ///         Values that are not known (yet) are 0.
+    struct SwapchainFrameStatistics
+    {
+        /// @brief  Cpu timeline value of the frame. 0 for unused entries.
+        u64 frame_index = {};
+        /// @brief  Time acquire blocked on the frames in flight limit plus vkAcquireNextImageKHR.
+        u64 acquire_wait_ns = {};
+        /// @brief  Time from the end of acquire to the present call.
+        u64 cpu_frame_time_ns = {};
+        /// @brief  Time from the present call until the gpu timeline semaphore reached frame_index.
+        ///         Observed by polling in acquire, so it is rounded up to the acquire granularity.
+        u64 gpu_completion_time_ns = {};
+        /// @brief  Timestamp of the present call.
+        u64 present_call_time_ns = {};
+        /// @brief  Timestamp of the frame reaching the display.
+        ///         Exact with ImplicitFeatureFlagBits::DISPLAY_TIMING, observed when wait_for_frame_start returns in SwapchainLatencyMode::PRESENT_WAIT.
+        u64 actual_present_time_ns = {};
+        /// @brief  Earliest timestamp the frame could have been displayed at, a later actual_present_time_ns means the frame missed refresh cycles.
+        ///         Requires ImplicitFeatureFlagBits::DISPLAY_TIMING.
+        u64 earliest_present_time_ns = {};
+        /// @brief  Requires ImplicitFeatureFlagBits::DISPLAY_TIMING.
+        u64 refresh_duration_ns = {};
+    };
+
     struct SwapchainInfo
     {
         NativeWindowHandle native_window;
@@ -30,6 +72,7 @@ namespace daxa
         usize max_allowed_frames_in_flight = 2;
         QueueFamily queue_family = {};
         SmallString name = {};
+        SwapchainLatencyMode latency_mode = SwapchainLatencyMode::DEFAULT;
     };
 
     /**
@@ -54,6 +97,10 @@ namespace daxa
         /// * ImageIds returned from the swapchain are INVALID after calling either resize OR set_present_mode!
         /// @return A swapchain image, that will be ready to render to when the acquire semaphore is signaled. This may return an empty image id if the swapchain is out of date.
         [[nodiscard]] auto acquire_next_image() -> ImageId;
+        /// @brief  Blocks until the cpu should start the next frame, call it right before sampling input and acquiring the next image.
+        ///         Trades throughput for input to photon latency, depending on SwapchainInfo::latency_mode.
+        ///         Does nothing in SwapchainLatencyMode::DEFAULT.
+        void wait_for_frame_start();
         /// The acquire semaphore must be waited on in the first submission that uses the last acquired image.
         /// This semaphore may change between acquires, so it needs to be re-queried after every current_acquire_semaphore call.
         /// @return The binary semaphore that is signaled when the last acquired image is ready to be used.
@@ -77,16 +124,20 @@ namespace daxa
         ///         The difference between cpu and gpu timeline describes how many frames in flight the gpu is behind the cpu.
         /// @return Returns pair of a gpu timeline and cpu timeline value.
         [[nodiscard]] auto current_timeline_pair() const -> std::pair<TimelineSemaphore, u64>;
+        /// @brief  Entries are filled in over the following frames, as gpu completion and display times become known.
+        ///         Frame n is stored at n % SWAPCHAIN_FRAME_STATISTICS_COUNT, look up entries with current_cpu_timeline_value().
+        /// @return Ring of the statistics of the last SWAPCHAIN_FRAME_STATISTICS_COUNT frames.
+        [[nodiscard]] auto frame_statistics() const -> std::span<SwapchainFrameStatistics const, SWAPCHAIN_FRAME_STATISTICS_COUNT>;
 
         /// @brief  When the window size changes the swapchain is in an invalid state for new commands.
         ///         Calling resize will recreate the swapchain with the proper window size.
         /// WARNING:
-        /// * Due to wsi limitations this function will WAIT IDLE THE DEVICE.
+        /// * Waits for the queues of the present queue family to be idle, other queues keep running.
         /// * If the function throws an error, The swapchain will be invalidated and unusable!
         void resize();
         /// @brief Recreates swapchain with new present mode.
         /// WARNING:
-        /// * Due to wsi limitations this function will WAIT IDLE THE DEVICE.
+        /// * Waits for the queues of the present queue family to be idle, other queues keep running.
         /// * If the function throws an error, The swapchain will be invalidated and unusable!
         void set_present_mode(PresentMode present_mode);
         /// THREADSAFETY:
@@ -48,10 +48,29 @@ namespace daxa
         static auto dec_refcnt(ImplHandle const * object) -> u64;
     };
 
+    enum struct ExternalSemaphoreHandleType
+    {
+        NONE = 0,
+        OPAQUE_FD = 0x00000001,
+        OPAQUE_WIN32 = 0x00000002,
+        MAX_ENUM = 0x7FFFFFFF,
+    };
+
+    /// @brief  Timeline semaphore shared with other apis or processes, for example a CUDA external semaphore.
+    ///         Requires ImplicitFeatureFlagBits::EXTERNAL_MEMORY.
+    struct ExternalSemaphoreInfo
+    {
+        ExternalSemaphoreHandleType handle_type = ExternalSemaphoreHandleType::NONE;
+        /// @brief  Without a value the semaphore is created exportable, see TimelineSemaphore::export_handle.
+        ///         With a value the payload is imported from this fd or win32 HANDLE. A successful fd import transfers ownership of the fd to the device.
+        Optional<u64> import_handle = {};
+    };
+
     struct TimelineSemaphoreInfo
     {
         u64 initial_value = {};
         SmallString name = {};
+        ExternalSemaphoreInfo external_semaphore = {};
     };
 
     struct DAXA_EXPORT_CXX TimelineSemaphore final : ManagedPtr<TimelineSemaphore, daxa_TimelineSemaphore>
@@ -66,6 +85,9 @@ namespace daxa
         [[nodiscard]] auto value() const -> u64;
         void set_value(u64 value);
         [[nodiscard]] auto wait_for_value(u64 value, u64 timeout_nanos = ~0ull) -> bool;
+        /// @brief  Creates a new fd or win32 HANDLE referencing the payload, the caller owns it.
+        ///         Only for semaphores created with an ExternalSemaphoreInfo::handle_type.
+        [[nodiscard]] auto export_handle() const -> u64;
 
       protected:
         template <typename T, typename H_T>
@@ -74,6 +96,9 @@ namespace daxa
         static auto dec_refcnt(ImplHandle const * object) -> u64;
     };
 
+    /// @brief  Borrowed timeline semaphore, see BorrowedPtr.
+    using TimelineSemaphoreRef = BorrowedPtr<TimelineSemaphore>;
+
     struct EventInfo
     {
         SmallString name = {};
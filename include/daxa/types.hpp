@@ -9,6 +9,7 @@
 #include <concepts>
 #include <span>
 #include <limits>
+#include <new>
 
 #include <daxa/core.hpp>
 
@@ -79,6 +80,9 @@ namespace daxa
         auto get() const -> HANDLE_T { return object; }
 
       protected:
+        template <typename T>
+        friend struct BorrowedPtr;
+
         HANDLE_T object = {};
 
         void cleanup()
@@ -91,6 +95,46 @@ namespace daxa
         }
     };
 
+    /// @brief  Non owning handle, creating, copying and destroying it never touches the refcount.
+    ///         Converts to a reference of the handle it borrows, so it can be passed wherever a handle reference is taken.
+    ///         Meant for hot paths and task callbacks, where copies of owning handles cause refcount traffic between threads.
+    ///
+    /// THREADSAFETY:
+    /// * MUST NOT outlive the handle it was created from, nothing keeps the object alive.
+    template <typename T>
+    struct BorrowedPtr
+    {
+        BorrowedPtr(T const & owner) { borrow(owner.get()); }
+        BorrowedPtr(BorrowedPtr const & other) { borrow(other.get()); }
+        auto operator=(BorrowedPtr const & other) -> BorrowedPtr &
+        {
+            managed().object = other.get();
+            return *this;
+        }
+        // The borrowed handle is never destroyed, so its refcount is never decremented.
+        ~BorrowedPtr() {}
+
+        auto operator->() const -> T * { return value(); }
+        auto operator*() const -> T & { return *value(); }
+        operator T const &() const { return *value(); }
+
+        auto is_valid() const -> bool { return value()->is_valid(); }
+        auto get() const { return value()->get(); }
+
+      private:
+        alignas(T) mutable std::byte storage[sizeof(T)] = {};
+
+        auto value() const -> T * { return std::launder(reinterpret_cast<T *>(storage)); }
+        auto managed() const -> typename T::ManagedPtr & { return *value(); }
+
+        template <typename HANDLE_T>
+        void borrow(HANDLE_T handle)
+        {
+            new (storage) T{};
+            managed().object = handle;
+        }
+    };
+
     struct NoneT
     {
     };
@@ -1278,6 +1322,13 @@ namespace daxa
         static inline constexpr ImageUsageFlags TRANSIENT_ATTACHMENT = {0x00000040};
         static inline constexpr ImageUsageFlags FRAGMENT_DENSITY_MAP = {0x00000200};
         static inline constexpr ImageUsageFlags FRAGMENT_SHADING_RATE_ATTACHMENT = {0x00000100};
+        /// @brief  Video usages require ImplicitFeatureFlagBits::VIDEO, DPB images also need ImageInfo::video_profile.
+        static inline constexpr ImageUsageFlags VIDEO_DECODE_DST = {0x00000400};
+        static inline constexpr ImageUsageFlags VIDEO_DECODE_SRC = {0x00000800};
+        static inline constexpr ImageUsageFlags VIDEO_DECODE_DPB = {0x00001000};
+        static inline constexpr ImageUsageFlags VIDEO_ENCODE_DST = {0x00002000};
+        static inline constexpr ImageUsageFlags VIDEO_ENCODE_SRC = {0x00004000};
+        static inline constexpr ImageUsageFlags VIDEO_ENCODE_DPB = {0x00008000};
     };
 
     [[nodiscard]] auto to_string(ImageUsageFlags const &) -> std::string;
@@ -1296,6 +1347,18 @@ namespace daxa
         static inline constexpr MemoryFlags HOST_ACCESS_RANDOM = {0x00000800};
         static inline constexpr MemoryFlags STRATEGY_MIN_MEMORY = {0x00010000};
         static inline constexpr MemoryFlags STRATEGY_MIN_TIME = {0x00020000};
+        /// @brief  Allows Device::begin_defragmentation_pass to move the resource to a new allocation.
+        ///         Only valid for buffers and images that are not placed in a MemoryBlock.
+        static inline constexpr MemoryFlags MOVABLE = {0x10000000};
+        /// @brief  Implies HOST_ACCESS_RANDOM and prefers host cached memory, which is much faster to read back on discrete gpus.
+        ///         Cached memory may be non coherent. Call Device::invalidate_ranges before reading gpu writes on the host
+        ///         and Device::flush_ranges after host writes.
+        static inline constexpr MemoryFlags HOST_CACHED = {0x20000000};
+        /// @brief  Implies HOST_ACCESS_SEQUENTIAL_WRITE and prefers device local host visible memory (bar / resizable bar).
+        ///         The host writes directly into vram, so per frame data needs no staging copy.
+        ///         Falls back to host memory when no such memory type exists or its heap is exhausted.
+        ///         DeviceProperties::device_local_host_visible_heap_size tells how much of this memory exists.
+        static inline constexpr MemoryFlags PREFER_DEVICE_LOCAL_HOST_VISIBLE = {0x40000000};
     };
 
     enum struct ColorSpace
@@ -1330,6 +1393,10 @@ namespace daxa
         READ_ONLY_OPTIMAL = 1000314000,
         ATTACHMENT_OPTIMAL = 1000314001,
         PRESENT_SRC = 1000001002,
+        VIDEO_DECODE_DST = 1000024000,
+        VIDEO_DECODE_DPB = 1000024002,
+        VIDEO_ENCODE_SRC = 1000299001,
+        VIDEO_ENCODE_DPB = 1000299002,
         MAX_ENUM = 0x7fffffff,
     };
 
@@ -1398,6 +1465,14 @@ namespace daxa
         MAX_ENUM = 0x7fffffff,
     };
 
+    struct Offset2D
+    {
+        i32 x = {};
+        i32 y = {};
+
+        friend auto operator<=>(Offset2D const &, Offset2D const &) = default;
+    };
+
     struct Offset3D
     {
         i32 x = {};
@@ -1484,6 +1559,10 @@ namespace daxa
         static inline constexpr PipelineStageFlags MESH_SHADER = {0x00100000ull};
         static inline constexpr PipelineStageFlags ACCELERATION_STRUCTURE_BUILD = {0x02000000ull};
         static inline constexpr PipelineStageFlags RAY_TRACING_SHADER = {0x00200000ull};
+        static inline constexpr PipelineStageFlags CONDITIONAL_RENDERING = {0x00040000ull};
+        static inline constexpr PipelineStageFlags MICROMAP_BUILD = {0x40000000ull};
+        static inline constexpr PipelineStageFlags VIDEO_DECODE = {0x04000000ull};
+        static inline constexpr PipelineStageFlags VIDEO_ENCODE = {0x08000000ull};
     };
 
     [[nodiscard]] auto to_string(PipelineStageFlags flags) -> std::string;
@@ -1531,6 +1610,10 @@ namespace daxa
         static inline constexpr Access MESH_SHADER_READ = {.stages = PipelineStageFlagBits::MESH_SHADER, .type = AccessTypeFlagBits::READ};
         static inline constexpr Access ACCELERATION_STRUCTURE_BUILD_READ = {.stages = PipelineStageFlagBits::ACCELERATION_STRUCTURE_BUILD, .type = AccessTypeFlagBits::READ};
         static inline constexpr Access RAY_TRACING_SHADER_READ = {.stages = PipelineStageFlagBits::RAY_TRACING_SHADER, .type = AccessTypeFlagBits::READ};
+        static inline constexpr Access CONDITIONAL_RENDERING_READ = {.stages = PipelineStageFlagBits::CONDITIONAL_RENDERING, .type = AccessTypeFlagBits::READ};
+        static inline constexpr Access MICROMAP_BUILD_READ = {.stages = PipelineStageFlagBits::MICROMAP_BUILD, .type = AccessTypeFlagBits::READ};
+        static inline constexpr Access VIDEO_DECODE_READ = {.stages = PipelineStageFlagBits::VIDEO_DECODE, .type = AccessTypeFlagBits::READ};
+        static inline constexpr Access VIDEO_ENCODE_READ = {.stages = PipelineStageFlagBits::VIDEO_ENCODE, .type = AccessTypeFlagBits::READ};
 
         static inline constexpr Access TOP_OF_PIPE_WRITE = {.stages = PipelineStageFlagBits::TOP_OF_PIPE, .type = AccessTypeFlagBits::WRITE};
         static inline constexpr Access DRAW_INDIRECT_WRITE = {.stages = PipelineStageFlagBits::DRAW_INDIRECT, .type = AccessTypeFlagBits::WRITE};
@@ -1558,6 +1641,9 @@ namespace daxa
         static inline constexpr Access MESH_SHADER_WRITE = {.stages = PipelineStageFlagBits::MESH_SHADER, .type = AccessTypeFlagBits::WRITE};
         static inline constexpr Access ACCELERATION_STRUCTURE_BUILD_WRITE = {.stages = PipelineStageFlagBits::ACCELERATION_STRUCTURE_BUILD, .type = AccessTypeFlagBits::WRITE};
         static inline constexpr Access RAY_TRACING_SHADER_WRITE = {.stages = PipelineStageFlagBits::RAY_TRACING_SHADER, .type = AccessTypeFlagBits::WRITE};
+        static inline constexpr Access MICROMAP_BUILD_WRITE = {.stages = PipelineStageFlagBits::MICROMAP_BUILD, .type = AccessTypeFlagBits::WRITE};
+        static inline constexpr Access VIDEO_DECODE_WRITE = {.stages = PipelineStageFlagBits::VIDEO_DECODE, .type = AccessTypeFlagBits::WRITE};
+        static inline constexpr Access VIDEO_ENCODE_WRITE = {.stages = PipelineStageFlagBits::VIDEO_ENCODE, .type = AccessTypeFlagBits::WRITE};
 
         static inline constexpr Access TOP_OF_PIPE_READ_WRITE = {.stages = PipelineStageFlagBits::TOP_OF_PIPE, .type = AccessTypeFlagBits::READ_WRITE};
         static inline constexpr Access DRAW_INDIRECT_READ_WRITE = {.stages = PipelineStageFlagBits::DRAW_INDIRECT, .type = AccessTypeFlagBits::READ_WRITE};
@@ -1826,6 +1912,96 @@ namespace daxa
         static auto dec_refcnt(ImplHandle const * object) -> u64;
     };
 
+    enum struct QueryType
+    {
+        OCCLUSION = 0,
+        PIPELINE_STATISTICS = 1,
+        /// @brief  Written by write_blas_compacted_sizes, requires ImplicitFeatureFlagBits::BASIC_RAY_TRACING.
+        ACCELERATION_STRUCTURE_COMPACTED_SIZE = 1000150000,
+        /// @brief  Written by encode_video inside a query scope, requires ImplicitFeatureFlagBits::VIDEO and QueryPoolInfo::video_profile.
+        VIDEO_ENCODE_FEEDBACK = 1000299000,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    /// @brief  Values match VkVideoCodecOperationFlagBitsKHR.
+    enum struct VideoCodecOperation
+    {
+        NONE = 0,
+        DECODE_H264 = 0x00000001,
+        DECODE_H265 = 0x00000002,
+        ENCODE_H264 = 0x00010000,
+        ENCODE_H265 = 0x00020000,
+        MAX_ENUM = 0x7fffffff,
+    };
+
+    /// @brief  Describes the coded video stream of a video session and the images and queries used with it.
+    struct VideoProfileInfo
+    {
+        VideoCodecOperation codec_operation = VideoCodecOperation::NONE;
+        /// @brief  VkVideoChromaSubsamplingFlagsKHR, 0x2 is 4:2:0.
+        u32 chroma_subsampling = 0x2;
+        /// @brief  VkVideoComponentBitDepthFlagsKHR, 0x1 is 8 bit.
+        u32 luma_bit_depth = 0x1;
+        u32 chroma_bit_depth = 0x1;
+        /// @brief  StdVideoH264ProfileIdc or StdVideoH265ProfileIdc, matching the codec operation.
+        u32 std_profile_idc = {};
+    };
+
+    struct PipelineStatisticFlagsProperties
+    {
+        using Data = u32;
+    };
+    using PipelineStatisticFlags = Flags<PipelineStatisticFlagsProperties>;
+    struct PipelineStatisticFlagBits
+    {
+        static inline constexpr PipelineStatisticFlags NONE = {0x00000000};
+        static inline constexpr PipelineStatisticFlags INPUT_ASSEMBLY_VERTICES = {0x00000001};
+        static inline constexpr PipelineStatisticFlags INPUT_ASSEMBLY_PRIMITIVES = {0x00000002};
+        static inline constexpr PipelineStatisticFlags VERTEX_SHADER_INVOCATIONS = {0x00000004};
+        static inline constexpr PipelineStatisticFlags GEOMETRY_SHADER_INVOCATIONS = {0x00000008};
+        static inline constexpr PipelineStatisticFlags GEOMETRY_SHADER_PRIMITIVES = {0x00000010};
+        static inline constexpr PipelineStatisticFlags CLIPPING_INVOCATIONS = {0x00000020};
+        static inline constexpr PipelineStatisticFlags CLIPPING_PRIMITIVES = {0x00000040};
+        static inline constexpr PipelineStatisticFlags FRAGMENT_SHADER_INVOCATIONS = {0x00000080};
+        static inline constexpr PipelineStatisticFlags TESSELLATION_CONTROL_SHADER_PATCHES = {0x00000100};
+        static inline constexpr PipelineStatisticFlags TESSELLATION_EVALUATION_SHADER_INVOCATIONS = {0x00000200};
+        static inline constexpr PipelineStatisticFlags COMPUTE_SHADER_INVOCATIONS = {0x00000400};
+        static inline constexpr PipelineStatisticFlags TASK_SHADER_INVOCATIONS = {0x00000800};
+        static inline constexpr PipelineStatisticFlags MESH_SHADER_INVOCATIONS = {0x00001000};
+    };
+
+    struct QueryPoolInfo
+    {
+        QueryType query_type = QueryType::OCCLUSION;
+        /// @brief  Only used for QueryType::PIPELINE_STATISTICS, requires ImplicitFeatureFlagBits::PIPELINE_STATISTICS_QUERY.
+        PipelineStatisticFlags pipeline_statistics = {};
+        u32 query_count = {};
+        SmallString name = {};
+        /// @brief  Only used for QueryType::VIDEO_ENCODE_FEEDBACK, the profile of the encode session the queries are used in.
+        VideoProfileInfo video_profile = {};
+    };
+
+    struct DAXA_EXPORT_CXX QueryPool : ManagedPtr<QueryPool, daxa_QueryPool>
+    {
+        QueryPool() = default;
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        [[nodiscard]] auto info() const -> QueryPoolInfo const &;
+
+        /// @brief  Returns the values of each query followed by its availability, without waiting for the gpu.
+        ///         Occlusion and compacted size queries have one value, pipeline statistics queries one per enabled statistic ordered by bit position.
+        ///         Video encode feedback queries have two values, the offset and the bytes written of the encoded bitstream.
+        [[nodiscard]] auto get_query_results(u32 start_index, u32 count) -> std::vector<u64>;
+
+      protected:
+        template <typename T, typename H_T>
+        friend struct ManagedPtr;
+        static auto inc_refcnt(ImplHandle const * object) -> u64;
+        static auto dec_refcnt(ImplHandle const * object) -> u64;
+    };
+
     enum struct IndexType
     {
         uint16 = 0,
@@ -1854,7 +2030,11 @@ namespace daxa
     {
         MAIN,
         COMPUTE,
-        TRANSFER
+        TRANSFER,
+        /// @brief  Only present with ImplicitFeatureFlagBits::VIDEO, see DeviceProperties::video_decode_queue_count.
+        VIDEO_DECODE,
+        /// @brief  Only present with ImplicitFeatureFlagBits::VIDEO, see DeviceProperties::video_encode_queue_count.
+        VIDEO_ENCODE,
     };
 
     auto to_string(QueueFamily family) -> std::string_view;
@@ -18,6 +18,8 @@ namespace daxa
         void resize(UpscaleSizeInfo const & info);
         void upscale(CommandRecorder & command_list, UpscaleInfo const & info);
         auto get_jitter(u64 index) const -> daxa_f32vec2;
+        /// @brief  Jitter for a dynamic render size, see UpscaleInfo::render_size.
+        auto get_jitter(u64 index, u32 render_size_x) const -> daxa_f32vec2;
 
       protected:
         template <typename T, typename H_T>
@@ -0,0 +1,72 @@
+#pragma once
+#include "../daxa.inl"
+
+/**
+ * GPU arena:
+ *   A device address range that shaders sub allocate from with one atomic add per allocation.
+ *   The buffer starts with a daxa_GpuArena header, the arena memory follows at DAXA_GPU_ARENA_HEADER_SIZE.
+ *   All allocation sizes are rounded up to DAXA_GPU_ARENA_ALIGNMENT, so all returned addresses share that alignment.
+ *
+ *   Allocations that do not fit return 0 and increment failed_allocation_count.
+ *   The offset keeps growing on failed allocations, after a frame it holds the number of bytes all allocations requested.
+ *
+ *   TaskGraph::create_transient_gpu_arena creates the buffer and resets the header every execution.
+ */
+
+#define DAXA_GPU_ARENA_HEADER_SIZE 16
+#define DAXA_GPU_ARENA_ALIGNMENT 16
+
+struct daxa_GpuArena
+{
+    daxa_u32 offset;
+    daxa_u32 capacity;
+    daxa_u32 failed_allocation_count;
+    daxa_u32 padding;
+};
+
+#if DAXA_SHADER
+#if DAXA_SHADERLANG == DAXA_SHADERLANG_GLSL
+DAXA_DECL_BUFFER_PTR(daxa_GpuArena)
+
+/// @brief  Allocates size bytes from the arena.
+/// @return Device address of the allocation or 0 when the arena is full.
+daxa_u64 daxa_gpu_arena_allocate(daxa_RWBufferPtr(daxa_GpuArena) arena, daxa_u32 size)
+{
+    daxa_u32 aligned_size = (size + (DAXA_GPU_ARENA_ALIGNMENT - 1)) & ~daxa_u32(DAXA_GPU_ARENA_ALIGNMENT - 1);
+    daxa_u32 offset = atomicAdd(deref(arena).offset, aligned_size);
+    daxa_u32 capacity = deref(arena).capacity;
+    if (aligned_size > capacity || offset > capacity - aligned_size)
+    {
+        atomicAdd(deref(arena).failed_allocation_count, 1);
+        return daxa_u64(0);
+    }
+    return as_address(arena) + DAXA_GPU_ARENA_HEADER_SIZE + offset;
+}
+
+daxa_b32 daxa_gpu_arena_overflowed(daxa_BufferPtr(daxa_GpuArena) arena)
+{
+    return deref(arena).failed_allocation_count != 0;
+}
+#elif DAXA_SHADERLANG == DAXA_SHADERLANG_SLANG
+/// @brief  Allocates size bytes from the arena.
+/// @return Device address of the allocation or 0 when the arena is full.
+daxa_u64 daxa_gpu_arena_allocate(Ptr<daxa_GpuArena> arena, daxa_u32 size)
+{
+    daxa_u32 aligned_size = (size + (DAXA_GPU_ARENA_ALIGNMENT - 1)) & ~daxa_u32(DAXA_GPU_ARENA_ALIGNMENT - 1);
+    daxa_u32 offset;
+    InterlockedAdd(arena->offset, aligned_size, offset);
+    daxa_u32 capacity = arena->capacity;
+    if (aligned_size > capacity || offset > capacity - aligned_size)
+    {
+        InterlockedAdd(arena->failed_allocation_count, 1);
+        return daxa_u64(0);
+    }
+    return as_address(arena) + DAXA_GPU_ARENA_HEADER_SIZE + offset;
+}
+
+bool daxa_gpu_arena_overflowed(Ptr<daxa_GpuArena> arena)
+{
+    return arena->failed_allocation_count != 0;
+}
+#endif
+#endif
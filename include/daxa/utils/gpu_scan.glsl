@@ -0,0 +1,241 @@
+// Kernels of GpuScan and GpuSort, see daxa/utils/gpu_scan.inl.
+// Compiled once per kernel with one of DAXA_GPU_SCAN_KERNEL_SCAN, DAXA_GPU_SORT_KERNEL_HISTOGRAM, DAXA_GPU_SORT_KERNEL_SCATTER or DAXA_GPU_DRAW_COMPACTION_KERNEL defined.
+#extension GL_EXT_shader_atomic_int64 : require
+
+#include <daxa/utils/gpu_scan.inl>
+#include <daxa/utils/subgroup.inl>
+
+#if defined(DAXA_GPU_SCAN_KERNEL_SCAN)
+DAXA_DECL_PUSH_CONSTANT(daxa_GpuScanPush, push)
+DAXA_DECL_WORKGROUP_SCAN(daxa_gpu_scan_workgroup_scan, DAXA_GPU_SCAN_MAX_SUBGROUPS)
+
+shared daxa_u32 s_tile_index;
+shared daxa_u32 s_tile_prefix;
+
+daxa_u64 daxa_gpu_scan_tile_state(daxa_u32 flag, daxa_u32 value)
+{
+    return (daxa_u64(flag) << 32) | daxa_u64(value);
+}
+
+layout(local_size_x = DAXA_GPU_SCAN_WORKGROUP_SIZE) in;
+void main()
+{
+    // Tiles are taken in launch order, so all tiles this one looks back on are already running.
+    if (gl_LocalInvocationIndex == 0)
+    {
+        s_tile_index = daxa_u32(atomicAdd(deref_i(push.scratch, 0), daxa_u64(1)));
+    }
+    barrier();
+    daxa_u32 tile_index = s_tile_index;
+
+    daxa_u32 values[DAXA_GPU_SCAN_ITEMS_PER_THREAD];
+    daxa_u32 thread_sum = 0;
+    daxa_u32 first_index = tile_index * DAXA_GPU_SCAN_TILE_SIZE + gl_LocalInvocationIndex * DAXA_GPU_SCAN_ITEMS_PER_THREAD;
+    [[unroll]] for (daxa_u32 i = 0; i < DAXA_GPU_SCAN_ITEMS_PER_THREAD; ++i)
+    {
+        daxa_u32 index = first_index + i;
+        values[i] = index < push.count ? deref_i(push.src, index) : 0;
+        thread_sum += values[i];
+    }
+    daxa_u32 tile_sum;
+    daxa_u32 thread_prefix = daxa_gpu_scan_workgroup_scan(thread_sum, tile_sum);
+
+    if (gl_SubgroupID == 0)
+    {
+        daxa_RWBufferPtr(daxa_u64) tile_states = advance(push.scratch, 1);
+        daxa_u32 tile_prefix = 0;
+        if (tile_index == 0)
+        {
+            if (subgroupElect())
+            {
+                atomicExchange(deref_i(tile_states, 0), daxa_gpu_scan_tile_state(DAXA_GPU_SCAN_TILE_INCLUSIVE, tile_sum));
+            }
+        }
+        else
+        {
+            if (subgroupElect())
+            {
+                atomicExchange(deref_i(tile_states, tile_index), daxa_gpu_scan_tile_state(DAXA_GPU_SCAN_TILE_AGGREGATE, tile_sum));
+            }
+            // Each lane reads one predecessor, lane 0 the closest one.
+            // The window is summed up to the closest inclusive prefix, it is read again while a tile before that is not ready.
+            daxa_i32 window_start = daxa_i32(tile_index) - 1;
+            while (true)
+            {
+                daxa_i32 predecessor = window_start - daxa_i32(gl_SubgroupInvocationID);
+                daxa_u64 state = predecessor >= 0 ? atomicOr(deref_i(tile_states, predecessor), daxa_u64(0)) : daxa_gpu_scan_tile_state(DAXA_GPU_SCAN_TILE_INCLUSIVE, 0);
+                daxa_u32 flag = daxa_u32(state >> 32);
+                daxa_u32vec4 inclusive_ballot = subgroupBallot(flag == DAXA_GPU_SCAN_TILE_INCLUSIVE);
+                daxa_u32vec4 not_ready_ballot = subgroupBallot(flag == DAXA_GPU_SCAN_TILE_NOT_READY);
+                daxa_u32 first_inclusive = subgroupBallotBitCount(inclusive_ballot) > 0 ? subgroupBallotFindLSB(inclusive_ballot) : gl_SubgroupSize;
+                daxa_u32 first_not_ready = subgroupBallotBitCount(not_ready_ballot) > 0 ? subgroupBallotFindLSB(not_ready_ballot) : gl_SubgroupSize;
+                if (first_not_ready < first_inclusive)
+                {
+                    continue;
+                }
+                tile_prefix += subgroupAdd(gl_SubgroupInvocationID <= first_inclusive ? daxa_u32(state) : 0);
+                if (first_inclusive < gl_SubgroupSize)
+                {
+                    break;
+                }
+                window_start -= daxa_i32(gl_SubgroupSize);
+            }
+            if (subgroupElect())
+            {
+                atomicExchange(deref_i(tile_states, tile_index), daxa_gpu_scan_tile_state(DAXA_GPU_SCAN_TILE_INCLUSIVE, tile_prefix + tile_sum));
+            }
+        }
+        if (subgroupElect())
+        {
+            s_tile_prefix = tile_prefix;
+        }
+    }
+    barrier();
+
+    daxa_u32 running = s_tile_prefix + thread_prefix;
+    [[unroll]] for (daxa_u32 i = 0; i < DAXA_GPU_SCAN_ITEMS_PER_THREAD; ++i)
+    {
+        daxa_u32 index = first_index + i;
+        daxa_u32 exclusive = running;
+        running += values[i];
+        if (index < push.count)
+        {
+            deref_i(push.dst, index) = push.inclusive ? running : exclusive;
+        }
+    }
+}
+#endif
+
+#if defined(DAXA_GPU_SORT_KERNEL_HISTOGRAM)
+DAXA_DECL_PUSH_CONSTANT(daxa_GpuSortPush, push)
+
+shared daxa_u32 s_digit_counts[DAXA_GPU_SORT_RADIX];
+
+layout(local_size_x = DAXA_GPU_SORT_WORKGROUP_SIZE) in;
+void main()
+{
+    if (gl_LocalInvocationIndex < DAXA_GPU_SORT_RADIX)
+    {
+        s_digit_counts[gl_LocalInvocationIndex] = 0;
+    }
+    barrier();
+    daxa_u32 tile_index = gl_WorkGroupID.x;
+    [[unroll]] for (daxa_u32 i = 0; i < DAXA_GPU_SORT_KEYS_PER_THREAD; ++i)
+    {
+        daxa_u32 index = tile_index * DAXA_GPU_SORT_TILE_SIZE + i * DAXA_GPU_SORT_WORKGROUP_SIZE + gl_LocalInvocationIndex;
+        if (index < push.count)
+        {
+            daxa_u32 digit = (deref_i(push.src_keys, index) >> push.shift) & (DAXA_GPU_SORT_RADIX - 1);
+            atomicAdd(s_digit_counts[digit], 1);
+        }
+    }
+    barrier();
+    if (gl_LocalInvocationIndex < DAXA_GPU_SORT_RADIX)
+    {
+        deref_i(push.histogram, gl_LocalInvocationIndex * push.tile_count + tile_index) = s_digit_counts[gl_LocalInvocationIndex];
+    }
+}
+#endif
+
+#if defined(DAXA_GPU_SORT_KERNEL_SCATTER)
+DAXA_DECL_PUSH_CONSTANT(daxa_GpuSortPush, push)
+
+// Destination of the next key of each digit, starts at the tiles offsets in the scanned histogram.
+shared daxa_u32 s_digit_offsets[DAXA_GPU_SORT_RADIX];
+// Per subgroup digit counts, turned into per subgroup destinations after each round.
+shared daxa_u32 s_subgroup_digit_offsets[DAXA_GPU_SORT_MAX_SUBGROUPS][DAXA_GPU_SORT_RADIX];
+
+layout(local_size_x = DAXA_GPU_SORT_WORKGROUP_SIZE) in;
+void main()
+{
+    daxa_u32 tile_index = gl_WorkGroupID.x;
+    if (gl_LocalInvocationIndex < DAXA_GPU_SORT_RADIX)
+    {
+        s_digit_offsets[gl_LocalInvocationIndex] = deref_i(push.histogram, gl_LocalInvocationIndex * push.tile_count + tile_index);
+    }
+    // Keys are ranked a workgroup wide round at a time, in index order, which keeps the sort stable.
+    [[unroll]] for (daxa_u32 i = 0; i < DAXA_GPU_SORT_KEYS_PER_THREAD; ++i)
+    {
+        daxa_u32 index = tile_index * DAXA_GPU_SORT_TILE_SIZE + i * DAXA_GPU_SORT_WORKGROUP_SIZE + gl_LocalInvocationIndex;
+        bool valid = index < push.count;
+        daxa_u32 key = valid ? deref_i(push.src_keys, index) : 0;
+        daxa_u32 digit = valid ? (key >> push.shift) & (DAXA_GPU_SORT_RADIX - 1) : DAXA_GPU_SORT_RADIX;
+        daxa_u32 subgroup_rank = 0;
+        [[unroll]] for (daxa_u32 d = 0; d < DAXA_GPU_SORT_RADIX; ++d)
+        {
+            daxa_u32vec4 digit_ballot = subgroupBallot(digit == d);
+            if (digit == d)
+            {
+                subgroup_rank = subgroupBallotExclusiveBitCount(digit_ballot);
+            }
+            if (subgroupElect())
+            {
+                s_subgroup_digit_offsets[gl_SubgroupID][d] = subgroupBallotBitCount(digit_ballot);
+            }
+        }
+        barrier();
+        if (gl_LocalInvocationIndex < DAXA_GPU_SORT_RADIX)
+        {
+            daxa_u32 running = s_digit_offsets[gl_LocalInvocationIndex];
+            for (daxa_u32 subgroup = 0; subgroup < gl_NumSubgroups; ++subgroup)
+            {
+                daxa_u32 subgroup_count = s_subgroup_digit_offsets[subgroup][gl_LocalInvocationIndex];
+                s_subgroup_digit_offsets[subgroup][gl_LocalInvocationIndex] = running;
+                running += subgroup_count;
+            }
+            s_digit_offsets[gl_LocalInvocationIndex] = running;
+        }
+        barrier();
+        if (valid)
+        {
+            daxa_u32 dst_index = s_subgroup_digit_offsets[gl_SubgroupID][digit] + subgroup_rank;
+            deref_i(push.dst_keys, dst_index) = key;
+            if (push.has_values)
+            {
+                deref_i(push.dst_values, dst_index) = deref_i(push.src_values, index);
+            }
+        }
+        barrier();
+    }
+}
+#endif
+
+#if defined(DAXA_GPU_DRAW_COMPACTION_KERNEL)
+DAXA_DECL_PUSH_CONSTANT(daxa_GpuDrawCompactionPush, push)
+
+layout(local_size_x = DAXA_GPU_DRAW_COMPACTION_WORKGROUP_SIZE) in;
+void main()
+{
+    daxa_u32 instance_index = gl_GlobalInvocationID.x;
+    if (instance_index >= push.instance_count || deref_i(push.visibility, instance_index) == 0)
+    {
+        return;
+    }
+    daxa_GpuDrawCompactionInstance instance = deref_i(push.instances, instance_index);
+    if (instance.material >= push.material_count)
+    {
+        return;
+    }
+    // Each iteration appends the instances sharing the material of the first remaining invocation, with one atomic.
+    while (true)
+    {
+        daxa_u32 material = subgroupBroadcastFirst(instance.material);
+        if (instance.material == material)
+        {
+            daxa_u32 slot = daxa_subgroup_append(advance(push.counts, material), true);
+            // Draws past the capacity are dropped, the count is clamped by the max draw count of draw_indirect_count.
+            if (slot < push.max_draws_per_material)
+            {
+                daxa_DrawIndexedIndirectStruct draw;
+                draw.index_count = instance.index_count;
+                draw.instance_count = 1;
+                draw.first_index = instance.first_index;
+                draw.vertex_offset = instance.vertex_offset;
+                draw.first_instance = instance_index;
+                deref_i(push.draws, material * push.max_draws_per_material + slot) = draw;
+            }
+            break;
+        }
+    }
+}
+#endif
@@ -0,0 +1,187 @@
+#pragma once
+
+#if !DAXA_BUILT_WITH_UTILS_TASK_GRAPH || !DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+#error "[package management error] You must build Daxa with the DAXA_ENABLE_UTILS_TASK_GRAPH and DAXA_ENABLE_UTILS_PIPELINE_MANAGER_GLSLANG CMake options enabled, or request the utils-task-graph and utils-pipeline-manager-glslang features in vcpkg"
+#endif
+
+#include <daxa/device.hpp>
+#include <daxa/utils/task_graph.hpp>
+#include <daxa/utils/gpu_scan.inl>
+
+#include <memory>
+
+namespace daxa
+{
+    struct GpuScanInfo
+    {
+        /// @brief  Requires ImplicitFeatureFlagBits::SHADER_ATOMIC_INT64, the tile states are 64 bit atomics.
+        Device device = {};
+        std::string name = {};
+    };
+
+    struct GpuScanRecordInfo
+    {
+        BufferId src = {};
+        /// @brief  May be src for an in place scan.
+        BufferId dst = {};
+        /// @brief  At least GpuScan::scratch_size(count) bytes, cleared by record.
+        BufferId scratch = {};
+        u32 count = {};
+        bool inclusive = {};
+    };
+
+    struct GpuScanTaskInfo
+    {
+        TaskBufferView src = {};
+        /// @brief  Must be a different task buffer than src, record an in place scan with GpuScan::record in an own task instead.
+        TaskBufferView dst = {};
+        u32 count = {};
+        bool inclusive = {};
+        std::string name = "gpu scan";
+    };
+
+    /// @brief  Device wide add scan of u32 values in one dispatch, using decoupled look-back between the workgroups.
+    ///         The kernel is compiled from daxa/utils/gpu_scan.glsl when the scan is created.
+    /// THREADSAFETY:
+    /// * record and add_task may be called from multiple threads at the same time.
+    struct GpuScan
+    {
+        DAXA_EXPORT_CXX GpuScan(GpuScanInfo a_info);
+
+        /// @return Bytes of scratch memory a scan of count values needs.
+        DAXA_EXPORT_CXX static auto scratch_size(u32 count) -> usize;
+        /// @brief  Clears the scratch memory and dispatches the scan, including the barrier between them.
+        ///         The caller synchronizes src, dst and scratch with the surrounding commands.
+        DAXA_EXPORT_CXX void record(CommandRecorder & recorder, GpuScanRecordInfo const & info) const;
+        /// @brief  Adds a task clearing a transient scratch buffer and a task scanning src into dst.
+        DAXA_EXPORT_CXX void add_task(TaskGraph & task_graph, GpuScanTaskInfo const & info) const;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> GpuScanInfo const &;
+
+      private:
+        friend struct GpuSort;
+        GpuScanInfo m_info = {};
+        // Shared with the tasks, so they stay valid after the scan is destroyed.
+        std::shared_ptr<ComputePipeline> pipeline = {};
+    };
+
+    struct GpuSortInfo
+    {
+        /// @brief  Requires ImplicitFeatureFlagBits::SHADER_ATOMIC_INT64, see GpuScanInfo.
+        Device device = {};
+        std::string name = {};
+    };
+
+    struct GpuSortRecordInfo
+    {
+        /// @brief  Sorted in place.
+        BufferId keys = {};
+        /// @brief  Optional, reordered like the keys.
+        BufferId values = {};
+        /// @brief  At least GpuSort::scratch_size(count, !values.is_empty()) bytes.
+        BufferId scratch = {};
+        u32 count = {};
+        /// @brief  Only the lowest key_bits bits of the keys are sorted by.
+        u32 key_bits = 32;
+    };
+
+    struct GpuSortTaskInfo
+    {
+        TaskBufferView keys = {};
+        /// @brief  Optional, an empty view sorts only the keys.
+        TaskBufferView values = {};
+        u32 count = {};
+        u32 key_bits = 32;
+        std::string name = "gpu sort";
+    };
+
+    /// @brief  Stable radix sort of u32 keys with optional u32 values, DAXA_GPU_SORT_RADIX_BITS per pass.
+    ///         Each pass is a histogram, a GpuScan of the histogram and a scatter dispatch.
+    /// THREADSAFETY:
+    /// * record and add_task may be called from multiple threads at the same time.
+    struct GpuSort
+    {
+        DAXA_EXPORT_CXX GpuSort(GpuSortInfo a_info);
+
+        /// @return Bytes of scratch memory a sort of count keys needs.
+        DAXA_EXPORT_CXX static auto scratch_size(u32 count, bool has_values) -> usize;
+        /// @brief  Records all passes, including the barriers between them.
+        ///         The caller synchronizes keys, values and scratch with the surrounding commands.
+        DAXA_EXPORT_CXX void record(CommandRecorder & recorder, GpuSortRecordInfo const & info) const;
+        /// @brief  Adds a task clearing a transient scratch buffer and a task sorting keys and values.
+        DAXA_EXPORT_CXX void add_task(TaskGraph & task_graph, GpuSortTaskInfo const & info) const;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> GpuSortInfo const &;
+
+      private:
+        GpuSortInfo m_info = {};
+        GpuScan scan;
+        std::shared_ptr<ComputePipeline> histogram_pipeline = {};
+        std::shared_ptr<ComputePipeline> scatter_pipeline = {};
+    };
+
+    struct GpuDrawCompactionInfo
+    {
+        Device device = {};
+        std::string name = {};
+    };
+
+    struct GpuDrawCompactionRecordInfo
+    {
+        // instance_count daxa_GpuDrawCompactionInstance.
+        BufferId instances = {};
+        // instance_count u32, non zero for visible instances.
+        BufferId visibility = {};
+        // material_count * max_draws_per_material daxa_DrawIndexedIndirectStruct.
+        BufferId draws = {};
+        /// @brief  material_count u32 draw counts, cleared by record.
+        BufferId counts = {};
+        u32 instance_count = {};
+        u32 material_count = {};
+        u32 max_draws_per_material = {};
+    };
+
+    struct GpuDrawCompactionTaskInfo
+    {
+        TaskBufferView instances = {};
+        TaskBufferView visibility = {};
+        TaskBufferView draws = {};
+        TaskBufferView counts = {};
+        u32 instance_count = {};
+        u32 material_count = {};
+        u32 max_draws_per_material = {};
+        std::string name = "gpu draw compaction";
+    };
+
+    /// @brief  Appends an indexed draw for every visible instance to the indirect draw array of its material and counts them.
+    ///         The draw of an instance has instance_count 1 and the instance index as first_instance, so shaders can read the instance with it.
+    ///         Each material is then drawn with one draw_indirect_count, see draw_indirect_count_info.
+    ///         The kernel is compiled from daxa/utils/gpu_scan.glsl when the compaction is created.
+    /// THREADSAFETY:
+    /// * record and add_task may be called from multiple threads at the same time.
+    struct GpuDrawCompaction
+    {
+        DAXA_EXPORT_CXX GpuDrawCompaction(GpuDrawCompactionInfo a_info);
+
+        /// @brief  Clears the counts and dispatches the compaction, including the barrier between them.
+        ///         The caller synchronizes the buffers with the surrounding commands, the draws and counts are read as DRAW_INDIRECT.
+        DAXA_EXPORT_CXX void record(CommandRecorder & recorder, GpuDrawCompactionRecordInfo const & info) const;
+        /// @brief  Adds a task clearing the counts and a task compacting the draws.
+        ///         Tasks drawing them attach draws and counts with TaskBufferAccess::DRAW_INDIRECT_INFO_READ.
+        DAXA_EXPORT_CXX void add_task(TaskGraph & task_graph, GpuDrawCompactionTaskInfo const & info) const;
+        /// @return Arguments drawing the compacted draws of a material.
+        DAXA_EXPORT_CXX static auto draw_indirect_count_info(BufferId draws, BufferId counts, u32 material, u32 max_draws_per_material) -> DrawIndirectCountInfo;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> GpuDrawCompactionInfo const &;
+
+      private:
+        GpuDrawCompactionInfo m_info = {};
+        std::shared_ptr<ComputePipeline> pipeline = {};
+    };
+} // namespace daxa
@@ -0,0 +1,102 @@
+#pragma once
+#include "../daxa.inl"
+
+/**
+ * GPU scan and sort:
+ *   Push constants and sizes shared by daxa/utils/gpu_scan.glsl and GpuScan/GpuSort in daxa/utils/gpu_scan.hpp.
+ *
+ *   The scan is a single pass decoupled look-back prefix sum over u32 values.
+ *   Each workgroup takes the next tile from a counter in the scratch buffer, scans it and publishes its aggregate.
+ *   It then walks back over the published tiles of its predecessors a subgroup at a time until it finds an inclusive prefix.
+ *   The scratch buffer holds the tile counter followed by one u64 state per tile and must be zeroed before each scan.
+ *
+ *   The sort is a stable least significant digit radix sort of u32 keys with optional u32 values, DAXA_GPU_SORT_RADIX_BITS per pass.
+ *   Each pass counts the digits per tile, scans the digit major histogram with the scan kernel and scatters the keys.
+ *
+ *   The draw compaction appends the draws of all visible instances to per material indirect draw arrays and counts them,
+ *   ready for draw_indirect_count. Each subgroup issues one atomic per distinct material among its visible instances.
+ *   The order of the draws within a material is not deterministic.
+ */
+
+#define DAXA_GPU_SCAN_WORKGROUP_SIZE 256
+#define DAXA_GPU_SCAN_ITEMS_PER_THREAD 4
+#define DAXA_GPU_SCAN_TILE_SIZE (DAXA_GPU_SCAN_WORKGROUP_SIZE * DAXA_GPU_SCAN_ITEMS_PER_THREAD)
+
+#define DAXA_GPU_SORT_WORKGROUP_SIZE 256
+#define DAXA_GPU_SORT_KEYS_PER_THREAD 4
+#define DAXA_GPU_SORT_TILE_SIZE (DAXA_GPU_SORT_WORKGROUP_SIZE * DAXA_GPU_SORT_KEYS_PER_THREAD)
+#define DAXA_GPU_SORT_RADIX_BITS 4
+#define DAXA_GPU_SORT_RADIX (1 << DAXA_GPU_SORT_RADIX_BITS)
+
+#define DAXA_GPU_DRAW_COMPACTION_WORKGROUP_SIZE 128
+
+// Workgroup size divided by the smallest subgroup size vulkan allows.
+#define DAXA_GPU_SCAN_MAX_SUBGROUPS (DAXA_GPU_SCAN_WORKGROUP_SIZE / 4)
+#define DAXA_GPU_SORT_MAX_SUBGROUPS (DAXA_GPU_SORT_WORKGROUP_SIZE / 4)
+
+// Tile state flags, stored in the upper 32 bits of a tile state, the lower 32 bits hold the value.
+#define DAXA_GPU_SCAN_TILE_NOT_READY 0
+#define DAXA_GPU_SCAN_TILE_AGGREGATE 1
+#define DAXA_GPU_SCAN_TILE_INCLUSIVE 2
+
+struct daxa_GpuScanPush
+{
+    daxa_BufferPtr(daxa_u32) src;
+    daxa_RWBufferPtr(daxa_u32) dst;
+    // Tile counter followed by one state per tile, see daxa_gpu_scan_scratch_size.
+    daxa_RWBufferPtr(daxa_u64) scratch;
+    daxa_u32 count;
+    daxa_b32 inclusive;
+};
+
+struct daxa_GpuSortPush
+{
+    daxa_BufferPtr(daxa_u32) src_keys;
+    daxa_BufferPtr(daxa_u32) src_values;
+    daxa_RWBufferPtr(daxa_u32) dst_keys;
+    daxa_RWBufferPtr(daxa_u32) dst_values;
+    // DAXA_GPU_SORT_RADIX rows of tile_count counts, exclusively scanned between the histogram and scatter dispatch.
+    daxa_RWBufferPtr(daxa_u32) histogram;
+    daxa_u32 count;
+    daxa_u32 tile_count;
+    daxa_u32 shift;
+    daxa_b32 has_values;
+};
+
+// Layout of VkDrawIndexedIndirectCommand.
+struct daxa_DrawIndexedIndirectStruct
+{
+    daxa_u32 index_count;
+    daxa_u32 instance_count;
+    daxa_u32 first_index;
+    daxa_i32 vertex_offset;
+    daxa_u32 first_instance;
+};
+DAXA_DECL_BUFFER_PTR(daxa_DrawIndexedIndirectStruct)
+
+struct daxa_GpuDrawCompactionInstance
+{
+    daxa_u32 material;
+    daxa_u32 index_count;
+    daxa_u32 first_index;
+    daxa_i32 vertex_offset;
+};
+DAXA_DECL_BUFFER_PTR(daxa_GpuDrawCompactionInstance)
+
+struct daxa_GpuDrawCompactionPush
+{
+    daxa_BufferPtr(daxa_GpuDrawCompactionInstance) instances;
+    // One u32 per instance, non zero for visible instances.
+    daxa_BufferPtr(daxa_u32) visibility;
+    // max_draws_per_material draws per material. first_instance is the instance index, instance_count is 1.
+    daxa_RWBufferPtr(daxa_DrawIndexedIndirectStruct) draws;
+    // One draw count per material, must be zeroed before the dispatch.
+    daxa_RWBufferPtr(daxa_u32) counts;
+    daxa_u32 instance_count;
+    daxa_u32 material_count;
+    daxa_u32 max_draws_per_material;
+};
+
+#define daxa_gpu_scan_tile_count(COUNT) (((COUNT) + DAXA_GPU_SCAN_TILE_SIZE - 1) / DAXA_GPU_SCAN_TILE_SIZE)
+#define daxa_gpu_scan_scratch_size(COUNT) ((1 + daxa_gpu_scan_tile_count(COUNT)) * 8)
+#define daxa_gpu_sort_tile_count(COUNT) (((COUNT) + DAXA_GPU_SORT_TILE_SIZE - 1) / DAXA_GPU_SORT_TILE_SIZE)
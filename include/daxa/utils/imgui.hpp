@@ -43,6 +43,17 @@ namespace daxa
 
         void record_commands(ImDrawData * draw_data, CommandRecorder & recorder, ImageId target_image, u32 size_x, u32 size_y);
 #if DAXA_BUILT_WITH_UTILS_TASK_GRAPH
+        /// @brief  Texture id of a task image, sampled with the given sampler. Unlike create_texture_id, it stays valid across frames.
+        ///         Its image view is resolved every time the imgui task runs.
+        auto create_task_texture_id(TaskImageView task_image, SamplerId sampler) -> ImTextureID;
+        /// @brief  Adds a task drawing draw_data into task_swapchain_image, so ui rendering is synchronized and batched by the graph.
+        ///         The swapchain image and the images of all task texture ids created so far are declared as attachments.
+        ///         Only those are synchronized by the graph. Texture ids from create_texture_id are not declared,
+        ///         they must only refer to images the graph never writes, like the font atlas, that are already in a sampleable layout.
+        ///         Images written by the graph must be sampled through create_task_texture_id.
+        ///         Geometry is written into the task graph staging memory, frames that do not fit fall back to the renderer's ring buffer.
+        ///         draw_data is read when the graph executes, when it is null ImGui::GetDrawData() is used instead.
+        ///         A size_x or size_y of zero uses the size of the swapchain image at execution.
         void record_task(ImDrawData * draw_data, TaskGraph & task_graph, TaskImageView task_swapchain_image, u32 size_x, u32 size_y);
 #endif
       protected:
@@ -7,7 +7,16 @@
 #include <daxa/core.hpp>
 #include <daxa/device.hpp>
 
+#include <atomic>
 #include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <shared_mutex>
+#include <span>
+#include <optional>
+#include <cstring>
 
 namespace daxa
 {
@@ -15,8 +24,16 @@ namespace daxa
     {
         Device device = {};
         u32 capacity = 1 << 25;
+        // Places the ring in device local host visible memory when available, see MemoryFlagBits::PREFER_DEVICE_LOCAL_HOST_VISIBLE.
         bool use_bar_memory = {};
         std::string name = {};
+        /// @brief  When the ring is full, allocations are placed in additional blocks instead of failing.
+        ///         These allocations are in other buffers, use Allocation::buffer instead of TransferMemoryPool::buffer.
+        bool growable = {};
+        // Size of the additional blocks, zero uses the capacity. Larger allocations get a block of their own size.
+        u32 growth_block_size = {};
+        // Additional blocks are destroyed after they were unused for this many timeline values.
+        u64 growth_block_release_delay = 64;
     };
 
     /// @brief Ring buffer based transfer memory allocator for easy and efficient cpu gpu communication.
@@ -34,6 +51,8 @@ namespace daxa
             u32 buffer_offset = {};
             usize size = {};
             u64 timeline_index = {};
+            // Buffer containing the allocation, differs from TransferMemoryPool::buffer for allocations in additional blocks.
+            daxa::BufferId buffer = {};
         };
         // Returns nullopt if the allocation fails.
         DAXA_EXPORT_CXX auto allocate(u32 size, u32 alignment_requirement = 16 /* 16 is a save default for most gpu data*/) -> std::optional<Allocation>;
@@ -63,16 +82,31 @@ namespace daxa
         /// * reference MUST NOT be read after the object is destroyed.
         /// @return reference to info of object.
         DAXA_EXPORT_CXX auto info() const -> TransferMemoryPoolInfo const &;
+        // Number of additional blocks currently allocated by a growable pool.
+        DAXA_EXPORT_CXX auto growth_block_count() const -> usize;
 
       private:
         // Reclaim expired memory allocations.
         DAXA_EXPORT_CXX void reclaim_unused_memory();
+        // Resets the additional blocks the gpu is done with and destroys the ones that stayed unused for too long.
+        DAXA_EXPORT_CXX void reclaim_growth_blocks();
+        DAXA_EXPORT_CXX auto allocate_in_growth_block(u32 size, u32 alignment_requirement) -> Allocation;
         struct TrackedAllocation
         {
             usize timeline_index = {};
             u32 offset = {};
             u32 size = {};
         };
+        // Linear allocator, reset once the gpu passed the timeline index of its latest allocation.
+        struct GrowthBlock
+        {
+            BufferId buffer = {};
+            daxa::DeviceAddress device_address = {};
+            void * host_address = {};
+            u32 size = {};
+            u32 used = {};
+            u64 timeline_index = {};
+        };
 
         TransferMemoryPoolInfo m_info = {};
         TimelineSemaphore gpu_timeline = {};
@@ -85,5 +119,834 @@ namespace daxa
         void * buffer_host_address = {};
         u32 claimed_start = {};
         u32 claimed_size = {};
+        std::vector<GrowthBlock> growth_blocks = {};
+    };
+
+    /// @brief  Ring buffer transfer memory allocator that many threads can allocate from at the same time.
+    ///         Allocations bump an atomic offset, they are not tracked individually.
+    ///         Instead the allocations between two inc_timeline_value calls form one epoch that is reclaimed as a whole.
+    ///         Each submit using the memory must signal the timeline semaphore with the value returned by inc_timeline_value.
+    /// THREADSAFETY:
+    /// * allocate and allocate_fill are threadsafe and lock free unless the ring is full.
+    /// * inc_timeline_value may be called concurrently to allocate, but all allocations used by a submit must return before the call for that submit.
+    /// * moves must be externally synchronized.
+    struct ConcurrentTransferMemoryPool
+    {
+        DAXA_EXPORT_CXX ConcurrentTransferMemoryPool(TransferMemoryPoolInfo a_info);
+        DAXA_EXPORT_CXX ConcurrentTransferMemoryPool(ConcurrentTransferMemoryPool && other);
+        DAXA_EXPORT_CXX ConcurrentTransferMemoryPool & operator=(ConcurrentTransferMemoryPool && other);
+        DAXA_EXPORT_CXX ~ConcurrentTransferMemoryPool();
+
+        using Allocation = TransferMemoryPool::Allocation;
+        // Returns nullopt if the allocation fails.
+        DAXA_EXPORT_CXX auto allocate(u32 size, u32 alignment_requirement = 16) -> std::optional<Allocation>;
+        template <typename T>
+        auto allocate_fill(T const & value, u32 alignment_requirement = 1) -> std::optional<Allocation>
+        {
+            auto allocation_o = allocate(sizeof(T), alignment_requirement);
+            if (allocation_o.has_value())
+            {
+                *reinterpret_cast<T *>(allocation_o->host_address) = value;
+                return allocation_o.value();
+            }
+            return std::nullopt;
+        }
+        // Returns the current timeline index, allocations of the current epoch are reclaimed once the gpu passed the next index.
+        DAXA_EXPORT_CXX auto timeline_value() const -> usize;
+        // Ends the current epoch and returns the timeline value the submit using its allocations must signal.
+        DAXA_EXPORT_CXX auto inc_timeline_value() -> usize;
+        DAXA_EXPORT_CXX auto timeline_semaphore() -> TimelineSemaphore const &;
+        DAXA_EXPORT_CXX auto buffer() const -> daxa::BufferId;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> TransferMemoryPoolInfo const &;
+
+      private:
+        // Reclaims all epochs the gpu is done with.
+        DAXA_EXPORT_CXX void reclaim_unused_memory();
+        struct Epoch
+        {
+            u64 timeline_index = {};
+            // Monotonic ring position of the end of the last allocation in the epoch.
+            u64 end = {};
+        };
+
+        TransferMemoryPoolInfo m_info = {};
+        TimelineSemaphore gpu_timeline = {};
+        BufferId m_buffer = {};
+        daxa::DeviceAddress buffer_device_address = {};
+        void * buffer_host_address = {};
+        // Positions grow monotonically, the buffer offset is the position modulo the capacity.
+        std::atomic<u64> claimed_end = {};
+        std::atomic<u64> claimed_start = {};
+        std::atomic<u64> current_timeline_value = {};
+        std::mutex epochs_mtx = {};
+        std::deque<Epoch> epochs = {};
+    };
+
+    struct ReadbackMemoryPoolInfo
+    {
+        Device device = {};
+        u32 capacity = 1 << 22;
+        std::string name = {};
+    };
+
+    /// @brief  Ring buffer in host cached memory for gpu to cpu readbacks.
+    ///         The gpu writes to buffer() at the allocation offset, the submit must signal the timeline semaphore with timeline_value().
+    ///         Allocations stay readable until they are released, memory is reused in allocation order.
+    struct ReadbackMemoryPool
+    {
+        DAXA_EXPORT_CXX ReadbackMemoryPool(ReadbackMemoryPoolInfo a_info);
+        DAXA_EXPORT_CXX ReadbackMemoryPool(ReadbackMemoryPool && other);
+        DAXA_EXPORT_CXX ReadbackMemoryPool & operator=(ReadbackMemoryPool && other);
+        DAXA_EXPORT_CXX ~ReadbackMemoryPool();
+
+        struct Allocation
+        {
+            daxa::DeviceAddress device_address = {};
+            u32 buffer_offset = {};
+            usize size = {};
+            u64 timeline_index = {};
+        };
+        // Returns nullopt if the allocation fails.
+        DAXA_EXPORT_CXX auto allocate(u32 size, u32 alignment_requirement = 16) -> std::optional<Allocation>;
+        /// @brief  Never blocks. Returns the written data once the gpu passed the timeline index of the allocation, nullopt before.
+        DAXA_EXPORT_CXX auto try_read(Allocation const & allocation) -> std::optional<std::span<std::byte const>>;
+        template <typename T>
+        auto try_read_as(Allocation const & allocation) -> std::optional<T>
+        {
+            auto data = try_read(allocation);
+            if (data.has_value())
+            {
+                DAXA_DBG_ASSERT_TRUE_M(data->size() >= sizeof(T), "readback allocation is smaller than the read type");
+                T value = {};
+                std::memcpy(&value, data->data(), sizeof(T));
+                return value;
+            }
+            return std::nullopt;
+        }
+        // The memory of the allocation may be reused once the gpu is done with it.
+        DAXA_EXPORT_CXX void release(Allocation const & allocation);
+        // Returns current timeline index.
+        DAXA_EXPORT_CXX auto timeline_value() const -> usize;
+        // Returns and then increments the current timeline index.
+        DAXA_EXPORT_CXX auto inc_timeline_value() -> usize;
+        DAXA_EXPORT_CXX auto timeline_semaphore() -> TimelineSemaphore const &;
+        DAXA_EXPORT_CXX auto buffer() const -> daxa::BufferId;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> ReadbackMemoryPoolInfo const &;
+
+      private:
+        // Reclaims the released allocations at the front of the ring the gpu is done with.
+        DAXA_EXPORT_CXX void reclaim_unused_memory();
+        struct TrackedAllocation
+        {
+            u64 timeline_index = {};
+            u32 size = {};
+            bool released = {};
+        };
+
+        ReadbackMemoryPoolInfo m_info = {};
+        TimelineSemaphore gpu_timeline = {};
+        BufferId m_buffer = {};
+        daxa::DeviceAddress buffer_device_address = {};
+        std::byte const * buffer_host_address = {};
+        u64 current_timeline_value = {};
+        // Sorted by timeline index, every allocation has a unique one.
+        std::deque<TrackedAllocation> live_allocations = {};
+        u32 claimed_start = {};
+        u32 claimed_size = {};
+    };
+
+    struct UploadQueueInfo
+    {
+        Device device = {};
+        /// @brief  Queue the copies are submitted to. Resources must be usable on its queue family.
+        Queue queue = QUEUE_MAIN;
+        // Size of the staging ring. Single image uploads must fit into a quarter of it, buffer uploads are split.
+        u32 staging_capacity = 1 << 25;
+        std::string name = {};
+    };
+
+    /// @brief  Completes once the gpu finished the flush containing the upload.
+    ///         Gpu work can wait on it with the pair {UploadQueue::timeline_semaphore(), timeline_value}.
+    struct UploadToken
+    {
+        u64 timeline_value = {};
+    };
+
+    /// @brief  Collects uploads from many threads into a staging ring and submits them with few copy commands per flush.
+    ///         Adjacent buffer uploads to the same buffer are merged into a single copy.
+    /// THREADSAFETY:
+    /// * upload_buffer and upload_image are threadsafe and copy into the staging memory concurrently.
+    /// * flush is threadsafe, it waits for uploads that are currently copying.
+    /// * moves must be externally synchronized.
+    struct UploadQueue
+    {
+        DAXA_EXPORT_CXX UploadQueue(UploadQueueInfo a_info);
+        DAXA_EXPORT_CXX UploadQueue(UploadQueue && other);
+        DAXA_EXPORT_CXX UploadQueue & operator=(UploadQueue && other);
+        DAXA_EXPORT_CXX ~UploadQueue();
+
+        DAXA_EXPORT_CXX auto upload_buffer(BufferId buffer, usize offset, std::span<std::byte const> data) -> UploadToken;
+        /// @brief  Uploads a whole mip level of the slice, the data must be tightly packed.
+        DAXA_EXPORT_CXX auto upload_image(ImageId image, ImageArraySlice slice, std::span<std::byte const> data, ImageLayout layout = ImageLayout::TRANSFER_DST_OPTIMAL) -> UploadToken;
+        // Records and submits all pending uploads. Returns the token of the last flush when nothing is pending.
+        DAXA_EXPORT_CXX auto flush() -> UploadToken;
+        DAXA_EXPORT_CXX auto is_complete(UploadToken token) const -> bool;
+        DAXA_EXPORT_CXX void wait(UploadToken token);
+        DAXA_EXPORT_CXX auto timeline_semaphore() const -> TimelineSemaphore const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> UploadQueueInfo const &;
+
+      private:
+        // Allocates staging memory while holding the shared flush lock, flushes and waits when the ring is full.
+        DAXA_EXPORT_CXX auto allocate_staging(std::shared_lock<std::shared_mutex> & lock, u32 size) -> ConcurrentTransferMemoryPool::Allocation;
+        DAXA_EXPORT_CXX auto flush_locked() -> UploadToken;
+        struct PendingBufferCopy
+        {
+            BufferId dst_buffer = {};
+            usize dst_offset = {};
+            u32 src_offset = {};
+            u32 size = {};
+        };
+
+        UploadQueueInfo m_info = {};
+        ConcurrentTransferMemoryPool staging;
+        TimelineSemaphore gpu_timeline = {};
+        // Uploads hold it shared while writing staging memory, flushes hold it exclusively.
+        std::shared_mutex flush_mtx = {};
+        std::mutex pending_mtx = {};
+        u64 submitted_timeline_value = {};
+        std::vector<PendingBufferCopy> pending_buffer_copies = {};
+        std::vector<BufferImageCopyInfo> pending_image_copies = {};
+    };
+
+    struct GpuDecompressionUploaderInfo
+    {
+        Device device = {};
+        // Staging memory for the compressed bytes, images also stage their decompressed bytes here.
+        u32 staging_capacity = 1 << 25;
+        std::string name = {};
+    };
+
+    /// @brief  One GDeflate 1.0 stream of at most GPU_DECOMPRESSION_MAX_PAGE_SIZE decompressed bytes.
+    ///         The compressed bytes can point directly into a memory mapped asset file.
+    struct CompressedPage
+    {
+        std::span<std::byte const> compressed = {};
+        u32 decompressed_size = {};
+    };
+
+    static inline constexpr u32 GPU_DECOMPRESSION_MAX_PAGE_SIZE = 1 << 16;
+
+    /// @brief  Copies compressed pages into staging memory and records their decompression on the gpu.
+    ///         The cpu only touches compressed bytes, decompression is done by CommandRecorder::decompress_memory.
+    ///         Requires ImplicitFeatureFlagBits::MEMORY_DECOMPRESSION.
+    ///         The recorded commands must signal timeline_semaphore() with timeline_value() like a TransferMemoryPool.
+    struct GpuDecompressionUploader
+    {
+        DAXA_EXPORT_CXX GpuDecompressionUploader(GpuDecompressionUploaderInfo a_info);
+        DAXA_EXPORT_CXX GpuDecompressionUploader(GpuDecompressionUploader && other);
+        DAXA_EXPORT_CXX GpuDecompressionUploader & operator=(GpuDecompressionUploader && other);
+        DAXA_EXPORT_CXX ~GpuDecompressionUploader();
+
+        /// @brief  Decompresses the pages back to back into the buffer starting at offset, which must be 4 byte aligned.
+        ///         The writes must be made visible with a barrier from AccessConsts::READ_WRITE.
+        /// @return false when the compressed pages do not fit into the free staging memory, nothing is recorded then.
+        DAXA_EXPORT_CXX auto upload_buffer(CommandRecorder & recorder, BufferId buffer, usize offset, std::span<CompressedPage const> pages) -> bool;
+        /// @brief  Decompresses the pages into staging memory and copies them to a whole mip level of the slice.
+        ///         The decompressed data must be tightly packed, the image must be in layout.
+        /// @return false when the compressed and decompressed pages do not fit into the free staging memory, nothing is recorded then.
+        DAXA_EXPORT_CXX auto upload_image(CommandRecorder & recorder, ImageId image, ImageArraySlice slice, std::span<CompressedPage const> pages, ImageLayout layout = ImageLayout::TRANSFER_DST_OPTIMAL) -> bool;
+        // Returns current timeline index.
+        DAXA_EXPORT_CXX auto timeline_value() const -> usize;
+        // Returns timeline semaphore that needs to be signaled with the latest timeline value,
+        // on a queue that uses memory from this uploader.
+        DAXA_EXPORT_CXX auto timeline_semaphore() -> TimelineSemaphore const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> GpuDecompressionUploaderInfo const &;
+
+      private:
+        // Copies the compressed pages into one staging allocation and sets the regions targeting dst_address.
+        // Without dst_address the allocation starts with room for the decompressed pages, which the regions target instead.
+        DAXA_EXPORT_CXX auto stage_pages(std::span<CompressedPage const> pages, std::optional<DeviceAddress> dst_address) -> std::optional<TransferMemoryPool::Allocation>;
+
+        GpuDecompressionUploaderInfo m_info = {};
+        TransferMemoryPool staging;
+        std::vector<MemoryDecompressionRegion> regions = {};
+    };
+
+    struct BufferSuballocatorInfo
+    {
+        Device device = {};
+        // Size of each internal buffer. Allocations larger than this fail.
+        u64 block_size = 1 << 26;
+        // Smallest allocation granularity, must be a power of two. Every allocation is aligned to at least this.
+        u64 min_allocation_size = 256;
+        MemoryFlags memory_flags = MemoryFlagBits::NONE;
+        std::string name = {};
+    };
+
+    /// @brief  Buddy allocator that carves many small logical buffers out of a few large buffers.
+    ///         Saves a buffer, a memory allocation, a bindless slot and a descriptor write per small buffer.
+    ///         Frees are deferred until the gpu timeline of the suballocator reached the timeline value at the time of the free.
+    /// THREADSAFETY:
+    /// * Not threadsafe, externally synchronize all calls.
+    struct BufferSuballocator
+    {
+        DAXA_EXPORT_CXX BufferSuballocator(BufferSuballocatorInfo a_info);
+        DAXA_EXPORT_CXX BufferSuballocator(BufferSuballocator && other);
+        DAXA_EXPORT_CXX BufferSuballocator & operator=(BufferSuballocator && other);
+        DAXA_EXPORT_CXX ~BufferSuballocator();
+
+        struct Allocation
+        {
+            daxa::BufferId buffer = {};
+            daxa::DeviceAddress device_address = {};
+            // Null unless the suballocator was created with host accessible memory flags.
+            void * host_address = {};
+            u64 buffer_offset = {};
+            u64 size = {};
+            u32 block_index = {};
+            u32 order = {};
+        };
+        // Returns nullopt if the allocation fails.
+        // The alignment must be a power of two.
+        DAXA_EXPORT_CXX auto allocate(u64 size, u64 alignment_requirement = 16) -> std::optional<Allocation>;
+        // The memory is reused once the gpu timeline reached the current timeline value.
+        DAXA_EXPORT_CXX void deferred_free(Allocation const & allocation);
+        // Returns current timeline index.
+        DAXA_EXPORT_CXX auto timeline_value() const -> u64;
+        // Returns and then increments the current timeline index.
+        DAXA_EXPORT_CXX auto inc_timeline_value() -> u64;
+        // Returns timeline semaphore that needs to be signaled with the latest timeline value,
+        // on a queue that uses memory from this suballocator.
+        DAXA_EXPORT_CXX auto timeline_semaphore() -> TimelineSemaphore const &;
+        // Number of internal buffers.
+        DAXA_EXPORT_CXX auto block_count() const -> usize;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> BufferSuballocatorInfo const &;
+
+      private:
+        // Releases all deferred frees the gpu is done with.
+        DAXA_EXPORT_CXX void reclaim_unused_memory();
+        DAXA_EXPORT_CXX auto try_allocate_in_block(u32 block_index, u32 order) -> std::optional<u64>;
+        DAXA_EXPORT_CXX void free_in_block(u32 block_index, u64 offset, u32 order);
+        struct Block
+        {
+            BufferId buffer = {};
+            daxa::DeviceAddress device_address = {};
+            void * host_address = {};
+            // Free offsets, indexed by order. Order 0 is min_allocation_size, the last order is the whole block.
+            std::vector<std::set<u64>> free_lists = {};
+        };
+        struct PendingFree
+        {
+            u64 timeline_index = {};
+            u32 block_index = {};
+            u32 order = {};
+            u64 offset = {};
+        };
+
+        BufferSuballocatorInfo m_info = {};
+        TimelineSemaphore gpu_timeline = {};
+        u32 max_order = {};
+        u64 current_timeline_value = {};
+        std::vector<Block> blocks = {};
+        std::deque<PendingFree> pending_frees = {};
+    };
+
+    struct AccelerationStructureBuilderInfo
+    {
+        Device device = {};
+        // Blas memory is suballocated from buffers of this size. Blas larger than this fail to enqueue.
+        u64 result_block_size = 1 << 27;
+        // Initial size of the scratch buffer shared by all builds of a batch. Grows to fit the largest single build.
+        u64 scratch_size = 1 << 26;
+        // Limits the summed size of the blas built per record_builds call, spreading large scenes over multiple frames.
+        u64 batch_byte_budget = 1 << 26;
+        // Limits the blas awaiting their compacted size at once, builds beyond it are not compacted.
+        u32 max_pending_compactions = 256;
+        std::string name = {};
+    };
+
+    struct BlasCompaction
+    {
+        BlasId original = {};
+        BlasId compacted = {};
+    };
+
+    /// @brief  Creates blas in pooled buffers and records their builds in budgeted batches.
+    ///         All builds of a batch share one scratch buffer, each build gets a range aligned to min_acceleration_structure_scratch_offset_alignment.
+    ///         The recorded builds must signal timeline_semaphore() with timeline_value(), see BufferSuballocator.
+    ///         Blas built with AccelerationStructureBuildFlagBits::ALLOW_COMPACTION are compacted over the following record_builds calls:
+    ///         The batch writes their compacted sizes into queries, once it finished a compacting copy into a new blas is recorded.
+    ///         Once the copy finished, take_compactions returns the new blas in place of the original.
+    ///         Requires ImplicitFeatureFlagBits::BASIC_RAY_TRACING.
+    /// THREADSAFETY:
+    /// * Not threadsafe, externally synchronize all calls.
+    /// * All batches must be submitted to the same queue, consecutive batches are ordered by a barrier on the shared scratch buffer.
+    struct AccelerationStructureBuilder
+    {
+        DAXA_EXPORT_CXX AccelerationStructureBuilder(AccelerationStructureBuilderInfo a_info);
+        DAXA_EXPORT_CXX AccelerationStructureBuilder(AccelerationStructureBuilder && other);
+        DAXA_EXPORT_CXX AccelerationStructureBuilder & operator=(AccelerationStructureBuilder && other);
+        DAXA_EXPORT_CXX ~AccelerationStructureBuilder();
+
+        /// @brief  Creates the blas in pooled memory and queues its build. dst_blas and scratch_data of info are ignored.
+        ///         The geometry infos are copied, the geometry data they point to must stay valid until the build executed.
+        /// @return The blas, it is built once the batch recording it finished on the gpu.
+        DAXA_EXPORT_CXX auto enqueue(BlasBuildInfo const & info, SmallString const & name = {}) -> BlasId;
+        /// @brief  Queues an in place refit of a blas created by enqueue, for deforming geometry that keeps its topology.
+        ///         The blas must be built with ALLOW_UPDATE, flags and geometry counts of info must match its build.
+        ///         dst_blas, src_blas, update and scratch_data of info are ignored.
+        DAXA_EXPORT_CXX void enqueue_refit(BlasId blas, BlasBuildInfo const & info);
+        /// @brief  Records queued builds in enqueue order until the batch byte budget or the scratch buffer is used up.
+        ///         At least one build is recorded per call, so blas larger than the budget still get built.
+        ///         Ends with a barrier that makes the blas visible to ray tracing shaders and tlas builds.
+        ///         Also records the compacting copies of blas whose compacted sizes are available.
+        /// @return Number of recorded builds.
+        DAXA_EXPORT_CXX auto record_builds(CommandRecorder & recorder) -> u32;
+        DAXA_EXPORT_CXX auto pending_build_count() const -> usize;
+        // Returns the number of blas still being compacted, record_builds must keep being called while it is not zero.
+        DAXA_EXPORT_CXX auto pending_compaction_count() const -> usize;
+        /// @brief  Returns the blas whose compacting copy finished on the gpu and destroys their originals.
+        ///         Tlas referencing an original must be rebuilt with the compacted blas before their next use.
+        ///         Compacted blas are owned by the builder like enqueued ones, destroy them with destroy_blas.
+        DAXA_EXPORT_CXX auto take_compactions() -> std::vector<BlasCompaction>;
+        // Destroys a blas created by enqueue, its memory is reused once the gpu reached the current timeline value.
+        DAXA_EXPORT_CXX void destroy_blas(BlasId blas);
+        // Returns current timeline index.
+        DAXA_EXPORT_CXX auto timeline_value() const -> u64;
+        // Returns and then increments the current timeline index.
+        DAXA_EXPORT_CXX auto inc_timeline_value() -> u64;
+        // Returns timeline semaphore that needs to be signaled with the latest timeline value,
+        // on the queue the builds are submitted to.
+        DAXA_EXPORT_CXX auto timeline_semaphore() -> TimelineSemaphore const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> AccelerationStructureBuilderInfo const &;
+
+      private:
+        struct PendingBuild
+        {
+            BlasBuildInfo info = {};
+            std::vector<BlasTriangleGeometryInfo> triangle_geometries = {};
+            std::vector<BlasAabbGeometryInfo> aabb_geometries = {};
+            u64 blas_size = {};
+            u64 scratch_size = {};
+        };
+
+        struct PendingCompaction
+        {
+            BlasId blas = {};
+            u32 query_index = {};
+            // The compacted size is available once the timeline semaphore reached this value.
+            u64 timeline_value = {};
+        };
+
+        auto pending_build_of(BlasBuildInfo const & info) -> PendingBuild;
+        void record_compactions(CommandRecorder & recorder);
+
+        AccelerationStructureBuilderInfo m_info = {};
+        BufferSuballocator result_memory;
+        BufferId scratch_buffer = {};
+        u64 scratch_buffer_size = {};
+        u64 scratch_alignment = {};
+        std::deque<PendingBuild> pending_builds = {};
+        // Result memory of each blas created by enqueue, keyed by the blas id bits.
+        std::unordered_map<u64, BufferSuballocator::Allocation> blas_allocations = {};
+        QueryPool compaction_queries = {};
+        std::vector<u32> free_compaction_queries = {};
+        std::deque<PendingCompaction> pending_compactions = {};
+        // The copies are finished once the timeline semaphore reached the timeline value stored in pending compaction.
+        std::deque<std::pair<PendingCompaction, BlasId>> compacting_copies = {};
+    };
+
+    enum struct ShaderBindingTableRegion
+    {
+        RAYGEN = 0,
+        MISS = 1,
+        HIT = 2,
+        CALLABLE = 3,
+    };
+
+    struct ShaderBindingTableRegionInfo
+    {
+        // Pipeline shader group index of each record, in record order.
+        std::vector<u32> groups = {};
+        // Bytes of record data following the group handle of each record, readable as shaderRecordEXT in shaders.
+        u32 record_data_size = {};
+    };
+
+    struct ShaderBindingTableBuilderInfo
+    {
+        Device device = {};
+        RayTracingPipeline pipeline = {};
+        ShaderBindingTableRegionInfo raygen = {};
+        ShaderBindingTableRegionInfo miss = {};
+        ShaderBindingTableRegionInfo hit = {};
+        ShaderBindingTableRegionInfo callable = {};
+        std::string name = {};
+    };
+
+    /// @brief  Lays out group handles and record data in a device local shader binding table.
+    ///         Records are aligned to shader_group_handle_alignment, regions and raygen records to shader_group_base_alignment.
+    ///         Changes are kept in a host copy of the table, record_upload copies only the changed records through one staging buffer.
+    ///         Requires ImplicitFeatureFlagBits::BASIC_RAY_TRACING.
+    /// THREADSAFETY:
+    /// * Not threadsafe, externally synchronize all calls.
+    struct ShaderBindingTableBuilder
+    {
+        DAXA_EXPORT_CXX ShaderBindingTableBuilder(ShaderBindingTableBuilderInfo a_info);
+        DAXA_EXPORT_CXX ShaderBindingTableBuilder(ShaderBindingTableBuilder && other);
+        DAXA_EXPORT_CXX ShaderBindingTableBuilder & operator=(ShaderBindingTableBuilder && other);
+        DAXA_EXPORT_CXX ~ShaderBindingTableBuilder();
+
+        /// @brief  Replaces the record data of a record, data larger than the record data size of the region is cut off.
+        DAXA_EXPORT_CXX void set_record_data(ShaderBindingTableRegion region, u32 record_index, std::span<std::byte const> data);
+        template <typename T>
+        void set_record_data(ShaderBindingTableRegion region, u32 record_index, T const & data)
+        {
+            set_record_data(region, record_index, std::span{reinterpret_cast<std::byte const *>(&data), sizeof(T)});
+        }
+        DAXA_EXPORT_CXX void set_record_group(ShaderBindingTableRegion region, u32 record_index, u32 group_index);
+        /// @brief  Rewrites the handles of all records from a pipeline with the same shader groups, for example after a shader reload.
+        DAXA_EXPORT_CXX void set_pipeline(RayTracingPipeline const & pipeline);
+        /// @brief  Copies the records changed since the last upload into the table, the first call uploads the whole table.
+        ///         The copies are ordered after previous traces and before following traces by barriers.
+        /// @return Whether anything was uploaded.
+        DAXA_EXPORT_CXX auto record_upload(CommandRecorder & recorder) -> bool;
+        // Returns the regions of the table, usable for trace_rays once the first upload executed.
+        DAXA_EXPORT_CXX auto table() const -> RayTracingShaderBindingTable;
+        DAXA_EXPORT_CXX auto buffer() const -> BufferId;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> ShaderBindingTableBuilderInfo const &;
+
+      private:
+        struct Region
+        {
+            u64 offset = {};
+            u64 stride = {};
+            u64 size = {};
+            // One flag per record, set until the record was uploaded.
+            std::vector<u8> dirty = {};
+        };
+
+        auto region_info(ShaderBindingTableRegion region) -> ShaderBindingTableRegionInfo &;
+        void write_handle(ShaderBindingTableRegion region, u32 record_index);
+
+        ShaderBindingTableBuilderInfo m_info = {};
+        BufferId m_buffer = {};
+        DeviceAddress buffer_address = {};
+        u32 handle_size = {};
+        std::array<Region, 4> regions = {};
+        // Group handles of the pipeline, indexed by shader group.
+        std::vector<std::byte> group_handles = {};
+        // Host copy of the whole table.
+        std::vector<std::byte> table_data = {};
+    };
+
+    struct GpuTimerInfo
+    {
+        Device device = {};
+        /// @brief  Signaled with the frame value by the last submit of each frame, for example Swapchain::gpu_timeline_semaphore().
+        TimelineSemaphore frame_timeline = {};
+        /// @brief  Frames whose timestamps can be pending at once, should be at least Swapchain max_allowed_frames_in_flight + 1.
+        u32 frame_count = 4;
+        u32 timestamps_per_frame = 64;
+        std::string name = {};
+    };
+
+    /// @brief  Ring of timestamp query ranges and a readback buffer with one slot per frame.
+    ///         Queries are reset in the recorder and resolved on the gpu with copy_timestamps_to_buffer, the cpu never waits on them.
+    ///         Results of a frame are read from the readback buffer once frame_timeline reached the frame value.
+    /// THREADSAFETY:
+    /// * Not threadsafe, externally synchronize all calls.
+    struct GpuTimer
+    {
+        DAXA_EXPORT_CXX GpuTimer(GpuTimerInfo a_info);
+        DAXA_EXPORT_CXX GpuTimer(GpuTimer && other);
+        DAXA_EXPORT_CXX GpuTimer & operator=(GpuTimer && other);
+        DAXA_EXPORT_CXX ~GpuTimer();
+
+        /// @brief  Starts timing the frame, for example with Swapchain::current_cpu_timeline_value(). Frame values must increase.
+        ///         Resets the queries of the frame's slot in the recorder.
+        /// @return false when the slot is still used by a frame frame_timeline did not reach yet, the frame is not timed then.
+        DAXA_EXPORT_CXX auto begin_frame(CommandRecorder & recorder, u64 frame_value) -> bool;
+        /// @brief  Timestamps past timestamps_per_frame or of untimed frames are dropped.
+        /// @return Index of the timestamp within the frame.
+        DAXA_EXPORT_CXX auto write_timestamp(CommandRecorder & recorder, PipelineStageFlags stage = PipelineStageFlagBits::ALL_COMMANDS) -> std::optional<u32>;
+        /// @brief  Records the copy of the frame's timestamps into the readback buffer, must be recorded after all timestamps of the frame.
+        DAXA_EXPORT_CXX void end_frame(CommandRecorder & recorder);
+        /// @brief  Never waits.
+        /// @return Timestamps of the frame in device ticks, nullopt while the frame is pending, after its slot was reused
+        ///         or when a timestamp of the frame was not available to the copy.
+        DAXA_EXPORT_CXX auto results(u64 frame_value) -> std::optional<std::span<u64 const>>;
+        /// @return Milliseconds between two timestamps of a finished frame, see DeviceProperties::limits.timestamp_period.
+        DAXA_EXPORT_CXX auto elapsed_ms(u64 frame_value, u32 begin_timestamp, u32 end_timestamp) -> std::optional<f64>;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> GpuTimerInfo const &;
+
+      private:
+        struct Slot
+        {
+            u64 frame_value = {};
+            u32 timestamp_count = {};
+            bool ended = {};
+            // Filled from the readback buffer on the first results call after the frame finished.
+            std::vector<u64> results = {};
+            bool resolved = {};
+            // False when the copy found any timestamp of the frame unwritten.
+            bool available = {};
+        };
+
+        GpuTimerInfo m_info = {};
+        TimelineQueryPool query_pool = {};
+        BufferId readback_buffer = {};
+        std::vector<Slot> slots = {};
+        // Slot of the frame between begin_frame and end_frame, ~0u when no frame is timed.
+        u32 current_slot = ~0u;
+    };
+
+    struct TextureStreamerInfo
+    {
+        Device device = {};
+        /// @brief  Signaled with the frame value by the last submit of each frame, see GpuTimerInfo::frame_timeline.
+        TimelineSemaphore frame_timeline = {};
+        /// @brief  Frames whose feedback can be pending at once, should be at least Swapchain max_allowed_frames_in_flight + 1.
+        u32 frame_count = 4;
+        /// @brief  Size of the feedback buffer and the view table, texture indices are below it.
+        u32 max_texture_count = 4096;
+        // Summed memory of all streamed images. When exceeded, the textures whose last request is the oldest lose their finest mips first.
+        u64 memory_budget = 1ull << 30;
+        // Bytes of mip data uploaded per record_updates call. The mip tail of a new texture is always uploaded at once.
+        u32 upload_budget = 1 << 24;
+        // Staging ring of the uploads, must fit the largest mip level.
+        u32 staging_capacity = 1 << 26;
+        std::string name = {};
+    };
+
+    struct StreamedTextureInfo
+    {
+        u32 dimensions = 2;
+        Format format = Format::R8G8B8A8_UNORM;
+        Extent3D size = {0, 0, 0};
+        u32 mip_level_count = 1;
+        // Tightly packed mip data is made of blocks, BC formats for example use 4x4 texel blocks of 8 or 16 bytes.
+        u32 block_byte_size = 4;
+        Extent2D block_extent = {1, 1};
+        // Mips whose width and height are at most this form the mip tail, which is always resident.
+        u32 mip_tail_extent = 128;
+        /// @brief  Writes the tightly packed data of a mip level into dst, which is exactly the size of the mip level.
+        ///         Returning false defers the mip to a later record_updates call, for example while it is still read from disk.
+        std::function<bool(u32 mip_level, std::span<std::byte> dst)> load_mip = {};
+        SmallString name = {};
+    };
+
+    /// @brief  Element of TextureStreamer::view_table(), shaders mirror this layout.
+    ///         view is empty until the mip tail of the texture is resident.
+    struct StreamedTextureView
+    {
+        ImageViewId view = {};
+        // Mip level of the full mip chain that is mip 0 of view.
+        u32 first_mip = {};
+        u32 mip_count = {};
+    };
+
+    /// @brief  Streams mip levels of textures into images that only hold their resident mips, within a memory budget.
+    ///         Every texture has a fixed index. Shaders read its current view from view_table() at that index and report the finest
+    ///         mip of the full chain they wanted with an atomicMin on the u32 at that index of feedback_buffer().
+    ///         A texture whose resident mips change gets a new image: the kept mips are copied on the gpu, the new ones are uploaded
+    ///         through a TransferMemoryPool and the default view of the new image is written to the view table. The old image is destroyed deferred.
+    ///         The memory budget is planned with the tightly packed mip sizes.
+    ///         Sampling the smaller image with the same uvs selects the same mips, so shaders only need the view table for feedback.
+    ///         Streamed images are always in ImageLayout::GENERAL and shared concurrently, so the updates can be recorded for a transfer queue.
+    ///         The recorded updates must signal timeline_semaphore() with timeline_value(), see TransferMemoryPool.
+    /// THREADSAFETY:
+    /// * Not threadsafe, externally synchronize all calls.
+    struct TextureStreamer
+    {
+        DAXA_EXPORT_CXX TextureStreamer(TextureStreamerInfo a_info);
+        DAXA_EXPORT_CXX TextureStreamer(TextureStreamer && other);
+        DAXA_EXPORT_CXX TextureStreamer & operator=(TextureStreamer && other);
+        DAXA_EXPORT_CXX ~TextureStreamer();
+
+        /// @brief  Nothing is resident until a record_updates call uploaded the mip tail of the texture.
+        /// @return Index of the texture in the feedback buffer and the view table.
+        DAXA_EXPORT_CXX auto create_texture(StreamedTextureInfo const & info) -> u32;
+        /// @brief  The image is destroyed deferred in the next record_updates call, the index is reused afterwards.
+        DAXA_EXPORT_CXX void destroy_texture(u32 texture);
+        /// @brief  Requests a mip level from the cpu, for example for textures known to become visible soon.
+        ///         Merged with the gpu feedback of the frame, like a shader request.
+        DAXA_EXPORT_CXX void request_mip(u32 texture, u32 mip_level);
+        /// @brief  Copies the feedback of the frame into a readback slot and clears the feedback buffer for the next frame.
+        ///         Must be recorded after all shaders writing feedback in the frame. Frame values must increase.
+        DAXA_EXPORT_CXX void record_feedback(CommandRecorder & recorder, u64 frame_value);
+        /// @brief  Reads the feedback of finished frames, applies the memory budget and records the image changes it results in.
+        ///         Reductions are recorded first, then the textures with the most recent requests get their new mips within the upload budget.
+        ///         Ends with a barrier making the images and the view table visible to all following commands.
+        ///         The first call clears the view table and the feedback buffer, it must be recorded before the first frame writing feedback.
+        /// @return Number of uploaded mip levels.
+        DAXA_EXPORT_CXX auto record_updates(CommandRecorder & recorder) -> u32;
+        DAXA_EXPORT_CXX auto view(u32 texture) const -> StreamedTextureView;
+        // Buffer of max_texture_count StreamedTextureView.
+        DAXA_EXPORT_CXX auto view_table() const -> BufferId;
+        // Buffer of max_texture_count u32, cleared to ~0u by record_feedback.
+        DAXA_EXPORT_CXX auto feedback_buffer() const -> BufferId;
+        // Summed memory of all streamed images.
+        DAXA_EXPORT_CXX auto resident_memory() const -> u64;
+        // Returns current timeline index.
+        DAXA_EXPORT_CXX auto timeline_value() const -> usize;
+        // Returns and then increments the current timeline index.
+        DAXA_EXPORT_CXX auto inc_timeline_value() -> usize;
+        // Returns timeline semaphore that needs to be signaled with the latest timeline value,
+        // on the queue the updates are submitted to.
+        DAXA_EXPORT_CXX auto timeline_semaphore() -> TimelineSemaphore const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> TextureStreamerInfo const &;
+
+      private:
+        struct Texture
+        {
+            StreamedTextureInfo info = {};
+            ImageId image = {};
+            // Mips [first_resident_mip, mip_level_count) are in the image, mip_level_count while nothing is resident.
+            u32 first_resident_mip = {};
+            // Finest mip of the mip tail.
+            u32 mip_tail_first_mip = {};
+            // Finest mip requested since the last record_updates, ~0u without requests.
+            u32 requested_mip = ~0u;
+            // Finest mip the texture should have, follows the requests and the memory budget.
+            u32 target_mip = {};
+            // Feedback frame of the latest request, textures with older requests are reduced first.
+            u64 last_request_frame = {};
+            u64 memory_size = {};
+            bool alive = {};
+        };
+        struct FeedbackSlot
+        {
+            u64 frame_value = {};
+            bool pending = {};
+        };
+
+        auto mip_byte_size(Texture const & texture, u32 mip_level) const -> u32;
+        auto image_info_of(Texture const & texture, u32 first_mip) const -> ImageInfo;
+        void read_feedback();
+        // Records the new image of a texture holding mips [first_mip, mip_level_count), the uploads are the mips [first_mip, first_resident_mip).
+        void record_texture_change(CommandRecorder & recorder, u32 texture, u32 first_mip, std::span<TransferMemoryPool::Allocation const> uploads);
+        void record_view_write(CommandRecorder & recorder, u32 texture);
+
+        TextureStreamerInfo m_info = {};
+        TransferMemoryPool staging;
+        BufferId m_view_table = {};
+        BufferId m_feedback_buffer = {};
+        BufferId readback_buffer = {};
+        std::vector<FeedbackSlot> feedback_slots = {};
+        std::vector<Texture> textures = {};
+        std::vector<u32> free_textures = {};
+        std::vector<u32> destroyed_textures = {};
+        u64 m_resident_memory = {};
+        u64 latest_feedback_frame = {};
+        bool buffers_cleared = {};
+    };
+
+    struct ShaderDebugRingInfo
+    {
+        Device device = {};
+        /// @brief  Signaled with the frame value by the last submit of each frame, see GpuTimerInfo::frame_timeline.
+        TimelineSemaphore frame_timeline = {};
+        /// @brief  Frames whose messages can be pending at once, should be at least Swapchain max_allowed_frames_in_flight + 1.
+        u32 frame_count = 4;
+        // Messages kept per frame, further messages of the frame are dropped and counted.
+        u32 message_capacity = 1024;
+        std::string name = {};
+    };
+
+    /// @brief  Matches DAXA_SHADER_DEBUG_MESSAGE_ASSERT and DAXA_SHADER_DEBUG_MESSAGE_PRINTF in daxa.inl.
+    enum struct ShaderDebugMessageType : u32
+    {
+        ASSERT = 1,
+        PRINTF = 2,
+    };
+
+    /// @brief  A message written by daxa_assert or daxa_printf, mirrors the DAXA_SHADER_DEBUG_MESSAGE_SIZE bytes of the shader layout.
+    struct ShaderDebugMessage
+    {
+        ShaderDebugMessageType type = {};
+        // The id passed to the shader macro, shaders have no strings so the application formats messages by it.
+        u32 id = {};
+        u32 line = {};
+        u32 padding = {};
+        std::array<u32, 4> args = {};
+    };
+
+    /// @brief  Ring that daxa_assert and daxa_printf in shaders write into, with a readback buffer with one slot per frame.
+    ///         The ring address is set with Device::set_shader_debug_address, shaders load it from the resource table.
+    ///         Passing asserts only cost that load, so the macros can stay enabled in profiling builds.
+    ///         Define DAXA_DISABLE_SHADER_DEBUG in shaders to compile them out entirely.
+    ///         The ring lives in host writable memory, so it is ready for the first frame without recorded initialization.
+    ///         Messages of a frame are read from the readback buffer once frame_timeline reached the frame value, the cpu never waits on them.
+    ///         A device has a single ring address, the ring constructed last is the active one.
+    ///         Destroying the active ring disables shader debug output, destroying any other ring leaves the address untouched.
+    /// THREADSAFETY:
+    /// * Not threadsafe, externally synchronize all calls.
+    struct ShaderDebugRing
+    {
+        DAXA_EXPORT_CXX ShaderDebugRing(ShaderDebugRingInfo a_info);
+        DAXA_EXPORT_CXX ShaderDebugRing(ShaderDebugRing && other);
+        DAXA_EXPORT_CXX ShaderDebugRing & operator=(ShaderDebugRing && other);
+        /// @brief  Resets the ring address of the device to 0, disabling the shader macros.
+        DAXA_EXPORT_CXX ~ShaderDebugRing();
+
+        /// @brief  Copies the messages of the frame into a readback slot and resets the message count for the next frame.
+        ///         Must be recorded after all shaders of the frame. Frame values must increase.
+        ///         When the slot of the frame is still in flight nothing is recorded, the messages are read back with a later frame instead.
+        DAXA_EXPORT_CXX void record_readback(CommandRecorder & recorder, u64 frame_value);
+        /// @brief  Never waits.
+        /// @return Messages of the frames finished since the last call, in frame order.
+        DAXA_EXPORT_CXX auto drain() -> std::vector<ShaderDebugMessage>;
+        /// @return Messages dropped because a frame exceeded message_capacity, summed over all drained frames.
+        DAXA_EXPORT_CXX auto dropped_message_count() const -> u64;
+        DAXA_EXPORT_CXX auto buffer() const -> BufferId;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> ShaderDebugRingInfo const &;
+
+      private:
+        struct Slot
+        {
+            u64 frame_value = {};
+            bool pending = {};
+        };
+
+        auto ring_size() const -> usize;
+        // Appends the messages of finished slots to messages.
+        void read_slots();
+
+        ShaderDebugRingInfo m_info = {};
+        BufferId ring_buffer = {};
+        BufferId readback_buffer = {};
+        std::vector<Slot> slots = {};
+        std::vector<ShaderDebugMessage> messages = {};
+        u64 m_dropped_message_count = {};
     };
 } // namespace daxa
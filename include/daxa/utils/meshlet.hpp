@@ -0,0 +1,52 @@
+#pragma once
+
+#if !DAXA_BUILT_WITH_UTILS_MEM
+#error "[package management error] You must build Daxa with the DAXA_ENABLE_UTILS_MEM CMake option enabled, or request the utils-mem feature in vcpkg"
+#endif
+
+#include <daxa/core.hpp>
+#include <daxa/utils/meshlet.inl>
+
+#include <span>
+#include <vector>
+
+namespace daxa
+{
+    struct MeshletBuildInfo
+    {
+        // Triangle list.
+        std::span<u32 const> indices = {};
+        // Used for the bounds, indexed by indices.
+        std::span<daxa_f32vec3 const> positions = {};
+        // At most DAXA_MESHLET_MAX_VERTICES.
+        u32 max_vertices = DAXA_MESHLET_MAX_VERTICES;
+        // At most DAXA_MESHLET_MAX_TRIANGLES.
+        u32 max_triangles = DAXA_MESHLET_MAX_TRIANGLES;
+        /// @brief  The triangles are split into jobs of this many triangles, built in parallel. Meshlets never span two jobs.
+        ///         Larger jobs fill the meshlets better, smaller ones spread better over the threads.
+        u32 triangles_per_job = 1 << 14;
+        // Zero uses std::thread::hardware_concurrency.
+        u32 thread_count = {};
+    };
+
+    struct MeshletBuildResult
+    {
+        std::vector<daxa_Meshlet> meshlets = {};
+        std::vector<daxa_MeshletBounds> bounds = {};
+        std::vector<u32> vertices = {};
+        std::vector<u32> triangles = {};
+
+        /// @return Bytes write needs, all arrays with 16 byte aligned starts.
+        DAXA_EXPORT_CXX auto byte_size() const -> usize;
+        /// @brief  Writes the arrays one after another into dst, for example a TransferMemoryPool allocation or a mapped buffer.
+        ///         device_address is the address the start of dst has on the gpu once uploaded, it must be 16 byte aligned.
+        /// @return Mesh referencing the arrays at their gpu addresses.
+        DAXA_EXPORT_CXX auto write(std::span<std::byte> dst, DeviceAddress device_address) const -> daxa_MeshletMesh;
+    };
+
+    /// @brief  Greedily fills meshlets with the triangles in index buffer order, so the index buffer should already be optimized for locality.
+    ///         Computes a bounding sphere and a normal cone per meshlet, see daxa/utils/meshlet.inl for the layout and the culling helpers.
+    /// THREADSAFETY:
+    /// * May be called from multiple threads at the same time.
+    DAXA_EXPORT_CXX auto build_meshlets(MeshletBuildInfo const & info) -> MeshletBuildResult;
+} // namespace daxa
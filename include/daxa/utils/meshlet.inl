@@ -0,0 +1,196 @@
+#pragma once
+#include "../daxa.inl"
+
+/**
+ * Meshlets:
+ *   Gpu layout of the meshlets built by daxa::build_meshlets in daxa/utils/meshlet.hpp and task and mesh shader helpers for them.
+ *
+ *   A mesh is split into meshlets of at most DAXA_MESHLET_MAX_VERTICES vertices and DAXA_MESHLET_MAX_TRIANGLES triangles.
+ *   Each meshlet references a range of vertices, the indices into the vertex buffer of the mesh,
+ *   and a range of triangles, each packing three 8 bit indices into the vertices of the meshlet into one u32.
+ *
+ *   The bounds of a meshlet are a bounding sphere and a normal cone in the space of the vertex positions.
+ *   A meshlet whose cone faces away from the camera has only backfacing triangles.
+ *
+ *   Task shaders cull DAXA_MESHLET_TASK_WORKGROUP_SIZE meshlets per workgroup, one per invocation,
+ *   and launch one mesh shader workgroup per visible meshlet with the functions declared by DAXA_DECL_MESHLET_TASK_EMIT.
+ */
+
+#define DAXA_MESHLET_MAX_VERTICES 64
+#define DAXA_MESHLET_MAX_TRIANGLES 124
+#define DAXA_MESHLET_TASK_WORKGROUP_SIZE 32
+
+struct daxa_Meshlet
+{
+    daxa_u32 vertex_offset;
+    daxa_u32 triangle_offset;
+    daxa_u32 vertex_count;
+    daxa_u32 triangle_count;
+};
+DAXA_DECL_BUFFER_PTR(daxa_Meshlet)
+
+struct daxa_MeshletBounds
+{
+    daxa_f32vec3 center;
+    daxa_f32 radius;
+    daxa_f32vec3 cone_axis;
+    // Sine of the cone half angle, 1 disables cone culling.
+    daxa_f32 cone_cutoff;
+};
+DAXA_DECL_BUFFER_PTR(daxa_MeshletBounds)
+
+struct daxa_MeshletMesh
+{
+    daxa_BufferPtr(daxa_Meshlet) meshlets;
+    daxa_BufferPtr(daxa_MeshletBounds) bounds;
+    // Indices into the vertex buffer of the mesh.
+    daxa_BufferPtr(daxa_u32) vertices;
+    // Three 8 bit indices into the vertices of the meshlet per u32.
+    daxa_BufferPtr(daxa_u32) triangles;
+    daxa_u32 meshlet_count;
+};
+DAXA_DECL_BUFFER_PTR(daxa_MeshletMesh)
+
+struct daxa_MeshletTaskPayload
+{
+    daxa_u32 meshlet_indices[DAXA_MESHLET_TASK_WORKGROUP_SIZE];
+};
+
+#if DAXA_SHADER
+/// @return Index into the vertex buffer of a vertex of the meshlet.
+daxa_u32 daxa_meshlet_vertex(daxa_MeshletMesh mesh, daxa_Meshlet meshlet, daxa_u32 vertex)
+{
+    return deref_i(mesh.vertices, meshlet.vertex_offset + vertex);
+}
+
+/// @return Indices into the vertices of the meshlet, as written to gl_PrimitiveTriangleIndicesEXT or the OutputIndices of a mesh shader.
+daxa_u32vec3 daxa_meshlet_triangle(daxa_MeshletMesh mesh, daxa_Meshlet meshlet, daxa_u32 triangle)
+{
+    daxa_u32 packed = deref_i(mesh.triangles, meshlet.triangle_offset + triangle);
+    return daxa_u32vec3(packed & 0xFF, (packed >> 8) & 0xFF, (packed >> 16) & 0xFF);
+}
+
+/// @brief  camera_position must be in the space of the bounds, the object space of the mesh unless the bounds were transformed.
+/// @return True when all triangles of the meshlet face away from the camera.
+daxa_b32 daxa_meshlet_cone_culled(daxa_MeshletBounds bounds, daxa_f32vec3 camera_position)
+{
+    daxa_f32vec3 to_center = bounds.center - camera_position;
+    return dot(to_center, bounds.cone_axis) >= bounds.cone_cutoff * length(to_center) + bounds.radius;
+}
+
+/// @brief  Planes are (normal, distance) with normals pointing into the frustum, in the same space as center.
+/// @return True when the sphere is completely outside of one of the planes.
+daxa_b32 daxa_meshlet_frustum_culled(daxa_f32vec4 planes[6], daxa_f32vec3 center, daxa_f32 radius)
+{
+    for (daxa_u32 i = 0; i < 6; ++i)
+    {
+        if (dot(planes[i].xyz, center) + planes[i].w < -radius)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief  Projects a view space sphere to a conservative uv rectangle, with the camera looking along +z and a symmetric perspective projection.
+///         p00 and p11 are the x and y scale of the projection matrix.
+///         2D Polyhedral Bounds of a Clipped, Perspective-Projected 3D Sphere, Mara and McGuire 2013.
+/// @return False when the sphere intersects the near plane, the rectangle is not valid then.
+daxa_b32 daxa_meshlet_project_sphere(daxa_f32vec3 center, daxa_f32 radius, daxa_f32 znear, daxa_f32 p00, daxa_f32 p11, out daxa_f32vec4 uv_rect)
+{
+    uv_rect = daxa_f32vec4(0, 0, 0, 0);
+    if (center.z < radius + znear)
+    {
+        return false;
+    }
+    daxa_f32vec2 cx = daxa_f32vec2(center.x, center.z);
+    daxa_f32vec2 vx = daxa_f32vec2(sqrt(dot(cx, cx) - radius * radius), radius);
+    daxa_f32vec2 min_x = daxa_f32vec2(vx.x * cx.x - vx.y * cx.y, vx.y * cx.x + vx.x * cx.y) * vx.x;
+    daxa_f32vec2 max_x = daxa_f32vec2(vx.x * cx.x + vx.y * cx.y, -vx.y * cx.x + vx.x * cx.y) * vx.x;
+    daxa_f32vec2 cy = daxa_f32vec2(center.y, center.z);
+    daxa_f32vec2 vy = daxa_f32vec2(sqrt(dot(cy, cy) - radius * radius), radius);
+    daxa_f32vec2 min_y = daxa_f32vec2(vy.x * cy.x - vy.y * cy.y, vy.y * cy.x + vy.x * cy.y) * vy.x;
+    daxa_f32vec2 max_y = daxa_f32vec2(vy.x * cy.x + vy.y * cy.y, -vy.y * cy.x + vy.x * cy.y) * vy.x;
+    daxa_f32vec4 ndc_rect = daxa_f32vec4(min_x.x / min_x.y * p00, min_y.x / min_y.y * p11, max_x.x / max_x.y * p00, max_y.x / max_y.y * p11);
+    uv_rect = ndc_rect * 0.5 + 0.5;
+    return true;
+}
+#endif
+
+#if DAXA_SHADER
+#if DAXA_SHADERLANG == DAXA_SHADERLANG_GLSL
+/// @brief  Tests a uv rectangle against a hierarchical depth buffer with reverse z, holding the farthest depth of each texel.
+///         min_sampler must use ReductionMode::MIN and clamp to edge, hiz_size is the size of mip 0 of the hiz.
+///         nearest_depth is the depth of the point of the bounds closest to the camera.
+/// @return True when the rectangle is behind the hiz everywhere.
+daxa_b32 daxa_meshlet_occlusion_culled(daxa_ImageViewId hiz, daxa_SamplerId min_sampler, daxa_f32vec2 hiz_size, daxa_f32vec4 uv_rect, daxa_f32 nearest_depth)
+{
+    daxa_f32vec2 extent = (uv_rect.zw - uv_rect.xy) * hiz_size;
+    // The mip where the rectangle covers at most 2x2 texels, the min sampler reduces them in one fetch.
+    daxa_f32 level = ceil(log2(max(max(extent.x, extent.y), 1.0)));
+    daxa_f32 hiz_depth = textureLod(daxa_sampler2D(hiz, min_sampler), (uv_rect.xy + uv_rect.zw) * 0.5, level).x;
+    return nearest_depth < hiz_depth;
+}
+
+/// @brief  Declares NAME(meshlet_index, visible, local_index) for task shaders with DAXA_MESHLET_TASK_WORKGROUP_SIZE invocations.
+///         Compacts the visible meshlets into the task payload NAME##_payload and launches one mesh shader workgroup per visible meshlet.
+///         local_index is gl_LocalInvocationIndex. Must be called once by all invocations of the workgroup in uniform control flow.
+///         Mesh shaders declare the payload with DAXA_DECL_MESHLET_MESH_PAYLOAD and read meshlet_indices[gl_WorkGroupID.x].
+#define DAXA_DECL_MESHLET_TASK_EMIT(NAME)                                                   \
+    taskPayloadSharedEXT daxa_MeshletTaskPayload NAME##_payload;                            \
+    shared daxa_u32 NAME##_count;                                                           \
+    void NAME(daxa_u32 meshlet_index, bool visible, daxa_u32 local_index)                   \
+    {                                                                                       \
+        if (local_index == 0)                                                               \
+        {                                                                                   \
+            NAME##_count = 0;                                                               \
+        }                                                                                   \
+        barrier();                                                                          \
+        if (visible)                                                                        \
+        {                                                                                   \
+            NAME##_payload.meshlet_indices[atomicAdd(NAME##_count, 1)] = meshlet_index;     \
+        }                                                                                   \
+        barrier();                                                                          \
+        EmitMeshTasksEXT(NAME##_count, 1, 1);                                               \
+    }
+
+#define DAXA_DECL_MESHLET_MESH_PAYLOAD(NAME) taskPayloadSharedEXT daxa_MeshletTaskPayload NAME;
+#elif DAXA_SHADERLANG == DAXA_SHADERLANG_SLANG
+/// @brief  Tests a uv rectangle against a hierarchical depth buffer with reverse z, holding the farthest depth of each texel.
+///         min_sampler must use ReductionMode::MIN and clamp to edge, hiz_size is the size of mip 0 of the hiz.
+///         nearest_depth is the depth of the point of the bounds closest to the camera.
+/// @return True when the rectangle is behind the hiz everywhere.
+daxa_b32 daxa_meshlet_occlusion_culled(daxa_ImageViewId hiz, daxa_SamplerId min_sampler, daxa_f32vec2 hiz_size, daxa_f32vec4 uv_rect, daxa_f32 nearest_depth)
+{
+    daxa_f32vec2 extent = (uv_rect.zw - uv_rect.xy) * hiz_size;
+    // The mip where the rectangle covers at most 2x2 texels, the min sampler reduces them in one fetch.
+    daxa_f32 level = ceil(log2(max(max(extent.x, extent.y), 1.0)));
+    daxa_f32 hiz_depth = Texture2D<float>::get(hiz).SampleLevel(SamplerState::get(min_sampler), (uv_rect.xy + uv_rect.zw) * 0.5, level);
+    return nearest_depth < hiz_depth;
+}
+
+/// @brief  Declares NAME(meshlet_index, visible, local_index) for task (amplification) shaders with DAXA_MESHLET_TASK_WORKGROUP_SIZE invocations.
+///         Compacts the visible meshlets into the payload NAME##_payload and launches one mesh shader workgroup per visible meshlet.
+///         local_index is SV_GroupIndex. Must be called once by all invocations of the workgroup in uniform control flow.
+///         Mesh shaders take the payload as `in payload daxa_MeshletTaskPayload` and read meshlet_indices[SV_GroupID.x].
+#define DAXA_DECL_MESHLET_TASK_EMIT(NAME)                                                   \
+    groupshared daxa_MeshletTaskPayload NAME##_payload;                                     \
+    groupshared daxa_u32 NAME##_count;                                                      \
+    void NAME(daxa_u32 meshlet_index, bool visible, daxa_u32 local_index)                   \
+    {                                                                                       \
+        if (local_index == 0)                                                               \
+        {                                                                                   \
+            NAME##_count = 0;                                                               \
+        }                                                                                   \
+        GroupMemoryBarrierWithGroupSync();                                                  \
+        if (visible)                                                                        \
+        {                                                                                   \
+            daxa_u32 slot;                                                                  \
+            InterlockedAdd(NAME##_count, 1, slot);                                          \
+            NAME##_payload.meshlet_indices[slot] = meshlet_index;                           \
+        }                                                                                   \
+        GroupMemoryBarrierWithGroupSync();                                                  \
+        DispatchMesh(NAME##_count, 1, 1, NAME##_payload);                                   \
+    }
+#endif
+#endif
@@ -8,6 +8,8 @@
 
 #include <filesystem>
 #include <functional>
+#include <memory>
+#include <span>
 
 namespace daxa
 {
@@ -37,6 +39,14 @@ namespace daxa
         MAX_ENUM = 0x7fffffff,
     };
 
+    enum struct ShaderOptimization
+    {
+        NONE,
+        PERFORMANCE,
+        SIZE,
+        MAX_ENUM = 0x7fffffff,
+    };
+
     struct ShaderModel
     {
         u32 major, minor;
@@ -54,6 +64,14 @@ namespace daxa
         std::optional<bool> enable_debug_info = {};
         std::optional<ShaderCreateFlags> create_flags = {};
         std::optional<u32> required_subgroup_size = {};
+        /// Runs spirv-opt over the compiled code before it is cached.
+        /// Needs DAXA_ENABLE_UTILS_PIPELINE_MANAGER_SPIRV_OPTIMIZATION, the code is left unchanged otherwise.
+        std::optional<ShaderOptimization> optimization = {};
+        /// Removes debug and non-semantic instructions from the compiled code. Ignored when enable_debug_info is set.
+        std::optional<bool> strip_debug_info = {};
+        /// Applied when the pipeline is created and not part of the shader cache key,
+        /// so variants differing only in these share one compile. Constants set here win over inherited ones.
+        std::vector<SpecializationConstant> specialization_constants = {};
 
         void inherit(ShaderCompileOptions const & other);
     };
@@ -99,17 +117,69 @@ namespace daxa
         TesselationInfo tesselation = {};
         u32 push_constant_size = {};
         std::string name = {};
+        RasterPipelineLinkMode link_mode = RasterPipelineLinkMode::MONOLITHIC;
     };
 
+    /// @brief  Shader objects skip pipeline compilation, hot reloading them only waits on the shader compiler.
+    struct ShaderObjectCompileInfo
+    {
+        ShaderCompileInfo shader_info = {};
+        ShaderObjectStage stage = ShaderObjectStage::COMPUTE;
+        u32 push_constant_size = {};
+        bool no_task_shader = false;
+        std::string name = {};
+    };
+
+    /// @brief  Storage for compiled SPIR-V, keyed by a hash of the compiler version, source, stage and compile options.
+    ///         Entries only refer to files relative to the root paths, so machines with different checkout locations can share them.
+    ///         Implement this to pull SPIR-V from a team or CI cache, for example over HTTP or from an object store.
+    /// THREADSAFETY:
+    /// * called from the compile threads at the same time, must be internally synchronized.
+    struct DAXA_EXPORT_CXX ShaderCacheBackend
+    {
+        virtual ~ShaderCacheBackend() = default;
+        /// @brief  Returns the entry stored under key, or std::nullopt on a miss.
+        virtual auto load(u64 key) -> std::optional<std::vector<std::byte>> = 0;
+        /// @brief  Stores an entry, replacing an earlier one with the same key.
+        virtual void store(u64 key, std::span<std::byte const> entry) = 0;
+    };
+
+    /// @brief  All entries in one memory mapped archive file inside folder. spirv_cache_folder uses this backend.
+    [[nodiscard]] DAXA_EXPORT_CXX auto create_archive_shader_cache(std::filesystem::path const & folder) -> std::shared_ptr<ShaderCacheBackend>;
+    /// @brief  One file per entry inside folder, named by the key. Easy to sync with file based tools.
+    [[nodiscard]] DAXA_EXPORT_CXX auto create_folder_shader_cache(std::filesystem::path const & folder) -> std::shared_ptr<ShaderCacheBackend>;
+    /// @brief  Looks the entries up in the backends in order and copies hits into the earlier backends. Stores go to all backends.
+    ///         Put a local cache first and the shared team or CI backend after it.
+    [[nodiscard]] DAXA_EXPORT_CXX auto create_layered_shader_cache(std::vector<std::shared_ptr<ShaderCacheBackend>> backends) -> std::shared_ptr<ShaderCacheBackend>;
+
     struct PipelineManagerInfo
     {
         Device device;
         ShaderCompileOptions shader_compile_options = {};
         bool register_null_pipelines_when_first_compile_fails = false;
+        /// @brief  Called from the compile threads, but never from more than one thread at a time.
         std::function<void(std::string &, std::filesystem::path const & path)> custom_preprocessor = {};
+        /// @brief  Threads used by the batched add functions and reload_all. 0 uses std::thread::hardware_concurrency().
+        u32 compile_thread_count = 0;
+        /// @brief  Used for every shader when set, spirv_cache_folder is then ignored.
+        std::shared_ptr<ShaderCacheBackend> shader_cache_backend = {};
+        /// @brief  Bundle written by write_pipeline_bundle or the daxa_compile_pipelines CMake function.
+        ///         When set, all shaders are taken from the bundle. Nothing is compiled, no shader file is opened and hot reload has nothing to watch.
+        ///         Shaders are matched by source path as given, stage, entry point, defines and options, root paths are ignored.
+        ///         Bundles never contain device dependent defines like DAXA_COOPERATIVE_MATRIX, they are ignored when matching.
+        std::optional<std::filesystem::path> pipeline_bundle = {};
         std::string name = {};
     };
 
+    /// @brief  Only the shader infos are used, the pipelines are never created.
+    struct PipelineBundleInfo
+    {
+        std::vector<RayTracingPipelineCompileInfo> ray_tracing_pipelines = {};
+        std::vector<ComputePipelineCompileInfo> compute_pipelines = {};
+        std::vector<RasterPipelineCompileInfo> raster_pipelines = {};
+        std::vector<ShaderObjectCompileInfo> shader_objects = {};
+    };
+
     struct VirtualFileInfo
     {
         std::string name = {};
@@ -137,12 +207,35 @@ namespace daxa
         auto add_ray_tracing_pipeline(RayTracingPipelineCompileInfo const & info) -> Result<std::shared_ptr<RayTracingPipeline>>;
         auto add_compute_pipeline(ComputePipelineCompileInfo const & info) -> Result<std::shared_ptr<ComputePipeline>>;
         auto add_raster_pipeline(RasterPipelineCompileInfo const & info) -> Result<std::shared_ptr<RasterPipeline>>;
+        /// @brief  Requires ImplicitFeatureFlagBits::SHADER_OBJECT on the device.
+        auto add_shader_object(ShaderObjectCompileInfo const & info) -> Result<std::shared_ptr<ShaderObject>>;
+        /// @brief  Compiles all infos in parallel. The results are in the same order as the infos.
+        auto add_ray_tracing_pipelines(std::span<RayTracingPipelineCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<RayTracingPipeline>>>;
+        /// @brief  Compiles all infos in parallel. The results are in the same order as the infos.
+        auto add_compute_pipelines(std::span<ComputePipelineCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<ComputePipeline>>>;
+        /// @brief  Compiles all infos in parallel. The results are in the same order as the infos.
+        auto add_raster_pipelines(std::span<RasterPipelineCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<RasterPipeline>>>;
+        /// @brief  Compiles all infos in parallel. The results are in the same order as the infos.
+        auto add_shader_objects(std::span<ShaderObjectCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<ShaderObject>>>;
         void remove_ray_tracing_pipeline(std::shared_ptr<RayTracingPipeline> const & pipeline);
         void remove_compute_pipeline(std::shared_ptr<ComputePipeline> const & pipeline);
         void remove_raster_pipeline(std::shared_ptr<RasterPipeline> const & pipeline);
+        void remove_shader_object(std::shared_ptr<ShaderObject> const & shader_object);
         void add_virtual_file(VirtualFileInfo const & info);
+        /// @brief  Recompiles all changed pipelines in parallel.
+        ///         Every pipeline that compiled is swapped in, the first error in add order is returned.
         auto reload_all() -> PipelineReloadResult;
+        /// @brief  Starts recompiling all changed pipelines on a background thread and returns immediately.
+        ///         The old pipelines stay in use until poll_reload swaps in the new ones.
+        /// @return false when nothing changed or when an earlier async reload was not polled to completion yet.
+        auto reload_all_async() -> bool;
+        /// @brief  Call once per frame. Swaps in the pipelines of a finished reload_all_async.
+        /// @return NoPipelineChanged while the background compile is still running.
+        auto poll_reload() -> PipelineReloadResult;
         auto all_pipelines_valid() const -> bool;
+        /// @brief  Compiles the shaders of all infos and writes them to a bundle for PipelineManagerInfo::pipeline_bundle.
+        ///         Creates no pipelines, so the manager does not need a device.
+        auto write_pipeline_bundle(PipelineBundleInfo const & info, std::filesystem::path const & path) -> Result<void>;
 
       protected:
         template <typename T, typename H_T>
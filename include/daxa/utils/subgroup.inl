@@ -0,0 +1,237 @@
+#pragma once
+#include "../daxa.inl"
+
+/**
+ * Subgroup helpers:
+ *   Reductions, scans, ballot compaction and aggregated atomics built on subgroup (wave) intrinsics.
+ *   Unless noted otherwise, the functions must be called from all invocations that take part, in uniform control flow per subgroup.
+ *
+ *   Aggregated atomics reduce the value across the subgroup and issue one atomic per subgroup instead of one per invocation.
+ *   Each invocation still gets its own result, as if it had done the atomic itself in invocation order.
+ *
+ *   DAXA_DECL_WORKGROUP_SCAN declares a workgroup wide exclusive add scan using one shared u32 per subgroup.
+ *   daxa/utils/gpu_scan.hpp builds the device wide prefix sum and radix sort on top of these helpers.
+ */
+
+#if DAXA_SHADER
+#if DAXA_SHADERLANG == DAXA_SHADERLANG_GLSL
+/// @return Number of active invocations in the subgroup passing keep.
+daxa_u32 daxa_subgroup_count(bool keep)
+{
+    return subgroupBallotBitCount(subgroupBallot(keep));
+}
+
+/// @return Number of active invocations with a lower subgroup invocation id passing keep, the compacted index of this invocation.
+daxa_u32 daxa_subgroup_compact_index(bool keep)
+{
+    return subgroupBallotExclusiveBitCount(subgroupBallot(keep));
+}
+
+/// @brief  Aggregated atomicAdd, one atomic per subgroup.
+/// @return Value of the counter before this invocations value was added.
+daxa_u32 daxa_subgroup_atomic_add(daxa_RWBufferPtr(daxa_u32) counter, daxa_u32 value)
+{
+    daxa_u32 subgroup_total = subgroupAdd(value);
+    daxa_u32 subgroup_prefix = subgroupExclusiveAdd(value);
+    daxa_u32 base = 0;
+    if (subgroupElect())
+    {
+        base = atomicAdd(deref(counter), subgroup_total);
+    }
+    return subgroupBroadcastFirst(base) + subgroup_prefix;
+}
+
+/// @brief  Appends the invocations passing keep to a list, one atomic per subgroup. Slots are handed out in subgroup invocation order.
+/// @return Slot of this invocation or ~0 when keep is false.
+daxa_u32 daxa_subgroup_append(daxa_RWBufferPtr(daxa_u32) counter, bool keep)
+{
+    daxa_u32 slot = daxa_subgroup_atomic_add(counter, keep ? 1 : 0);
+    return keep ? slot : ~daxa_u32(0);
+}
+
+/// @brief  Aggregated atomicMin, one atomic per subgroup.
+void daxa_subgroup_atomic_min(daxa_RWBufferPtr(daxa_u32) dst, daxa_u32 value)
+{
+    daxa_u32 subgroup_min = subgroupMin(value);
+    if (subgroupElect())
+    {
+        atomicMin(deref(dst), subgroup_min);
+    }
+}
+
+/// @brief  Aggregated atomicMax, one atomic per subgroup.
+void daxa_subgroup_atomic_max(daxa_RWBufferPtr(daxa_u32) dst, daxa_u32 value)
+{
+    daxa_u32 subgroup_max = subgroupMax(value);
+    if (subgroupElect())
+    {
+        atomicMax(deref(dst), subgroup_max);
+    }
+}
+
+/// @brief  Aggregated atomicOr, one atomic per subgroup.
+void daxa_subgroup_atomic_or(daxa_RWBufferPtr(daxa_u32) dst, daxa_u32 value)
+{
+    daxa_u32 subgroup_or = subgroupOr(value);
+    if (subgroupElect())
+    {
+        atomicOr(deref(dst), subgroup_or);
+    }
+}
+
+/// @brief  Declares NAME(value, out total), a workgroup wide exclusive add scan.
+///         Must be called by all invocations of the workgroup in uniform control flow, the workgroup size must be a multiple of the subgroup size.
+///         MAX_SUBGROUPS is the workgroup size divided by the smallest supported subgroup size.
+///         Ends with a barrier, so it can be called repeatedly, for example once per loop iteration.
+/// Usage example:
+///     DAXA_DECL_WORKGROUP_SCAN(workgroup_scan, 64)
+///     ...
+///     daxa_u32 total;
+///     daxa_u32 offset = workgroup_scan(count, total);
+#define DAXA_DECL_WORKGROUP_SCAN(NAME, MAX_SUBGROUPS)                                      \
+    shared daxa_u32 NAME##_subgroup_sums[MAX_SUBGROUPS];                                   \
+    shared daxa_u32 NAME##_total;                                                          \
+    daxa_u32 NAME(daxa_u32 value, out daxa_u32 total)                                      \
+    {                                                                                      \
+        daxa_u32 subgroup_sum = subgroupAdd(value);                                        \
+        if (subgroupElect())                                                               \
+        {                                                                                  \
+            NAME##_subgroup_sums[gl_SubgroupID] = subgroup_sum;                            \
+        }                                                                                  \
+        barrier();                                                                         \
+        if (gl_SubgroupID == 0)                                                            \
+        {                                                                                  \
+            daxa_u32 carry = 0;                                                            \
+            for (daxa_u32 base = 0; base < gl_NumSubgroups; base += gl_SubgroupSize)       \
+            {                                                                              \
+                daxa_u32 i = base + gl_SubgroupInvocationID;                               \
+                daxa_u32 sum = i < gl_NumSubgroups ? NAME##_subgroup_sums[i] : 0;          \
+                daxa_u32 prefix = carry + subgroupExclusiveAdd(sum);                       \
+                if (i < gl_NumSubgroups)                                                   \
+                {                                                                          \
+                    NAME##_subgroup_sums[i] = prefix;                                      \
+                }                                                                          \
+                carry += subgroupAdd(sum);                                                 \
+            }                                                                              \
+            if (subgroupElect())                                                           \
+            {                                                                              \
+                NAME##_total = carry;                                                      \
+            }                                                                              \
+        }                                                                                  \
+        barrier();                                                                         \
+        daxa_u32 result = NAME##_subgroup_sums[gl_SubgroupID] + subgroupExclusiveAdd(value); \
+        total = NAME##_total;                                                              \
+        barrier();                                                                         \
+        return result;                                                                     \
+    }
+#elif DAXA_SHADERLANG == DAXA_SHADERLANG_SLANG
+/// @return Number of active invocations in the subgroup passing keep.
+daxa_u32 daxa_subgroup_count(bool keep)
+{
+    return WaveActiveCountBits(keep);
+}
+
+/// @return Number of active invocations with a lower lane index passing keep, the compacted index of this invocation.
+daxa_u32 daxa_subgroup_compact_index(bool keep)
+{
+    return WavePrefixCountBits(keep);
+}
+
+/// @brief  Aggregated InterlockedAdd, one atomic per subgroup.
+/// @return Value of the counter before this invocations value was added.
+daxa_u32 daxa_subgroup_atomic_add(Ptr<daxa_u32> counter, daxa_u32 value)
+{
+    daxa_u32 subgroup_total = WaveActiveSum(value);
+    daxa_u32 subgroup_prefix = WavePrefixSum(value);
+    daxa_u32 base = 0;
+    if (WaveIsFirstLane())
+    {
+        InterlockedAdd(*counter, subgroup_total, base);
+    }
+    return WaveReadLaneFirst(base) + subgroup_prefix;
+}
+
+/// @brief  Appends the invocations passing keep to a list, one atomic per subgroup. Slots are handed out in lane order.
+/// @return Slot of this invocation or ~0 when keep is false.
+daxa_u32 daxa_subgroup_append(Ptr<daxa_u32> counter, bool keep)
+{
+    daxa_u32 slot = daxa_subgroup_atomic_add(counter, keep ? 1 : 0);
+    return keep ? slot : ~daxa_u32(0);
+}
+
+/// @brief  Aggregated InterlockedMin, one atomic per subgroup.
+void daxa_subgroup_atomic_min(Ptr<daxa_u32> dst, daxa_u32 value)
+{
+    daxa_u32 subgroup_min = WaveActiveMin(value);
+    if (WaveIsFirstLane())
+    {
+        InterlockedMin(*dst, subgroup_min);
+    }
+}
+
+/// @brief  Aggregated InterlockedMax, one atomic per subgroup.
+void daxa_subgroup_atomic_max(Ptr<daxa_u32> dst, daxa_u32 value)
+{
+    daxa_u32 subgroup_max = WaveActiveMax(value);
+    if (WaveIsFirstLane())
+    {
+        InterlockedMax(*dst, subgroup_max);
+    }
+}
+
+/// @brief  Aggregated InterlockedOr, one atomic per subgroup.
+void daxa_subgroup_atomic_or(Ptr<daxa_u32> dst, daxa_u32 value)
+{
+    daxa_u32 subgroup_or = WaveActiveBitOr(value);
+    if (WaveIsFirstLane())
+    {
+        InterlockedOr(*dst, subgroup_or);
+    }
+}
+
+/// @brief  Declares NAME(value, local_index, total), a workgroup wide exclusive add scan.
+///         local_index is SV_GroupIndex, WORKGROUP_SIZE must be the flattened workgroup size.
+///         Must be called by all invocations of the workgroup in uniform control flow, the workgroup size must be a multiple of the wave size.
+///         MAX_SUBGROUPS is the workgroup size divided by the smallest supported wave size.
+///         Ends with a barrier, so it can be called repeatedly, for example once per loop iteration.
+#define DAXA_DECL_WORKGROUP_SCAN(NAME, MAX_SUBGROUPS, WORKGROUP_SIZE)                      \
+    groupshared daxa_u32 NAME##_subgroup_sums[MAX_SUBGROUPS];                              \
+    groupshared daxa_u32 NAME##_total;                                                     \
+    daxa_u32 NAME(daxa_u32 value, daxa_u32 local_index, out daxa_u32 total)                \
+    {                                                                                      \
+        daxa_u32 wave_size = WaveGetLaneCount();                                           \
+        daxa_u32 wave_index = local_index / wave_size;                                     \
+        daxa_u32 wave_count = (WORKGROUP_SIZE) / wave_size;                                \
+        daxa_u32 wave_sum = WaveActiveSum(value);                                          \
+        if (WaveIsFirstLane())                                                             \
+        {                                                                                  \
+            NAME##_subgroup_sums[wave_index] = wave_sum;                                   \
+        }                                                                                  \
+        GroupMemoryBarrierWithGroupSync();                                                 \
+        if (wave_index == 0)                                                               \
+        {                                                                                  \
+            daxa_u32 carry = 0;                                                            \
+            for (daxa_u32 base = 0; base < wave_count; base += wave_size)                  \
+            {                                                                              \
+                daxa_u32 i = base + WaveGetLaneIndex();                                    \
+                daxa_u32 sum = i < wave_count ? NAME##_subgroup_sums[i] : 0;               \
+                daxa_u32 prefix = carry + WavePrefixSum(sum);                              \
+                if (i < wave_count)                                                        \
+                {                                                                          \
+                    NAME##_subgroup_sums[i] = prefix;                                      \
+                }                                                                          \
+                carry += WaveActiveSum(sum);                                               \
+            }                                                                              \
+            if (WaveIsFirstLane())                                                         \
+            {                                                                              \
+                NAME##_total = carry;                                                      \
+            }                                                                              \
+        }                                                                                  \
+        GroupMemoryBarrierWithGroupSync();                                                 \
+        daxa_u32 result = NAME##_subgroup_sums[wave_index] + WavePrefixSum(value);         \
+        total = NAME##_total;                                                              \
+        GroupMemoryBarrierWithGroupSync();                                                 \
+        return result;                                                                     \
+    }
+#endif
+#endif
@@ -23,6 +23,13 @@ namespace daxa
         std::string name = {};
     };
 
+    struct TaskTransientGpuArenaInfo
+    {
+        // Bytes shaders can allocate per execution, rounded up to DAXA_GPU_ARENA_ALIGNMENT.
+        u32 capacity = {};
+        std::string name = {};
+    };
+
     struct TaskTransientImageInfo
     {
         u32 dimensions = 2;
@@ -48,6 +55,48 @@ namespace daxa
         Variant<TaskBufferView, std::string> aliased_buffer = {};
     };
 
+    enum struct TaskGraphScheduling
+    {
+        /// @brief  Each task is placed into the earliest possible batch when it is added, in recording order.
+        GREEDY,
+        /// @brief  At complete, the dependency graph of each submit scope is built and the tasks are rescheduled by dependency level.
+        ///         Reads of the same resource no longer wait on each other, which widens batches and lets them share one barrier.
+        DEPENDENCY_GRAPH,
+    };
+
+    struct TransientMemoryHeapInfo
+    {
+        Device device = {};
+        std::string name = {};
+    };
+
+    struct ImplTransientMemoryHeap;
+
+    /// @brief  Memory the transient resources of several task graphs alias into.
+    ///         Every graph reserves the size of its largest permutation when it is completed.
+    ///         The memory is allocated on the first execution of a graph using the heap, so all graphs completed before that share it.
+    ///         Graphs sharing a heap must not run at the same time on the gpu. Submitting them to the same queue is enough.
+    /// THREADSAFETY:
+    /// * must be externally synchronized, like the task graphs using it.
+    struct DAXA_EXPORT_CXX TransientMemoryHeap : ManagedPtr<TransientMemoryHeap, ImplTransientMemoryHeap *>
+    {
+        TransientMemoryHeap() = default;
+        TransientMemoryHeap(TransientMemoryHeapInfo const & info);
+
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        auto info() const -> TransientMemoryHeapInfo const &;
+        /// @brief  Size of the currently allocated memory, summed over all memory types.
+        auto size() const -> usize;
+
+      protected:
+        template <typename T, typename H_T>
+        friend struct ManagedPtr;
+        static auto inc_refcnt(ImplHandle const * object) -> u64;
+        static auto dec_refcnt(ImplHandle const * object) -> u64;
+    };
+
     struct TaskGraphInfo
     {
         Device device = {};
@@ -56,17 +105,37 @@ namespace daxa
         /// @brief  Task reordering can drastically improve performance,
         ///         yet is it also nice to have sequential callback execution.
         bool reorder_tasks = true;
+        /// @brief  Only used when reorder_tasks is set. The debug string reports batch and barrier counts before and after rescheduling.
+        TaskGraphScheduling scheduling = TaskGraphScheduling::GREEDY;
         /// @brief  Allows task graph to alias transient resources memory (ofc only when that wont break the program)
         bool alias_transients = {};
+        /// @brief  When set, the transient resources are placed into this heap instead of memory owned by the task graph.
+        ///         Transient resources are then created on the first execution instead of in complete.
+        std::optional<TransientMemoryHeap> transient_memory_heap = {};
         /// @brief  Some drivers have bad implementations for split barriers.
         ///         If that is the case for you, you can turn off all use of split barriers.
         ///         Daxa will use pipeline barriers instead if this is set.
         bool use_split_barriers = true;
+        /// @brief  Signaling and waiting on a split barrier costs more than a pipeline barrier, it only pays off with enough work in between.
+        ///         Within a submit, a split barrier is used when the accesses are at least this many batches apart.
+        ///         Closer accesses are synchronized with a pipeline barrier in the batch of the later access.
+        u32 split_barrier_min_batch_distance = 2;
+        /// @brief  Also use a split barrier for closer accesses when at least this many tasks are recorded in the batches between them.
+        ///         Zero only considers the batch distance.
+        u32 split_barrier_min_tasks_between = 0;
+        /// @brief  Consecutive raster tasks rendering to the same attachments continue one renderpass when the later tasks load the attachments
+        ///         and only attachment to attachment barriers are recorded between them, see CommandRecorderInfo::merge_renderpasses.
+        ///         The pipeline statistics and occlusion queries of gpu profiling end renderpasses, fewer are merged while collecting them.
+        bool merge_renderpasses = {};
         /// @brief  Each condition doubled the number of permutations.
         ///         For a low number of permutations its is preferable to precompile all permutations.
         ///         For a large number of permutations it might be preferable to only create the permutations actually used on the fly just before they are needed.
         ///         The second option is enabled by using jit (just in time) compilation.
+        ///         Jit compiled permutations are cached, each owning its transient resources and memory.
         bool jit_compile_permutations = {};
+        /// @brief  Only used with jit_compile_permutations. Maximum number of compiled permutations kept alive.
+        ///         Executing another permutation evicts the least recently executed one and frees its transient resources.
+        u32 jit_permutation_cache_size = 16;
         /// @brief  Task graph can branch the execution based on conditionals. All conditionals must be set before execution and stay constant while executing.
         ///         This is useful to create permutations of a task graph without having to create a separate task graph.
         ///         Another benefit is that task graph can generate synch between executions of permutations while it can not generate synch between two separate task graphs.
@@ -78,10 +147,45 @@ namespace daxa
         std::array<f32, 4> task_label_color = {0.663f, 0.533f, 0.871f, 1.0f};
         /// @brief  Records debug information about the execution if enabled. This string is retrievable with the function get_debug_string.
         bool record_debug_information = {};
+        /// @brief  Writes timestamps around every batch and task, the durations are retrievable with TaskGraph::get_timings.
+        ///         The timestamps of the last few executions are kept in a ring of query pools, so reading them never waits on the gpu.
+        bool enable_gpu_profiling = {};
+        /// @brief  Only used with enable_gpu_profiling. Collects these pipeline statistics for every task, requires ImplicitFeatureFlagBits::PIPELINE_STATISTICS_QUERY.
+        PipelineStatisticFlags gpu_profiling_pipeline_statistics = {};
+        /// @brief  Only used with enable_gpu_profiling. Counts the samples passed by the draws of every task.
+        bool gpu_profiling_occlusion = {};
         /// @brief  Sets the size of the linear allocator of device local, host visible memory used by the linear staging allocator.
         ///         This memory is used internally as well as by tasks via the TaskInterface::get_allocator().
         ///         Setting the size to 0, disables a few task list features but also eliminates the memory allocation.
         u32 staging_memory_pool_size = 262'144; // 2^16 bytes.
+        /// @brief  Threads recording the batches of a submit scope. With more than one, contiguous runs of batches are recorded into separate command lists in parallel.
+        ///         The lists are submitted in batch order, so the generated barriers stay valid.
+        ///         Task callbacks must be safe to run concurrently. Each thread hands its tasks a separate staging memory pool of staging_memory_pool_size bytes.
+        ///         The executing thread records one range, the others are recorded by worker threads the graph starts once and keeps until it is destroyed.
+        u32 record_thread_count = 1;
+        /// @brief  Executions record into one of this many execution contexts, taken in turn.
+        ///         With more than one, execute can be called from another thread while earlier executions still record or submit.
+        ///         Executions begin in call order: they synchronize against the previous execution and read the runtime resources of the persistent resources then.
+        ///         Changing persistent resources afterwards only affects later executions. Submits and presents are made in the order the executions began.
+        ///         Each context owns its own staging memory pools. Task callbacks must be safe to run concurrently.
+        ///         The swapchain image of the next frame can only be acquired once the previous execution presented.
+        ///         Changing tasks or transient resources of the graph requires all executions to have returned.
+        u32 execution_context_count = 1;
+        /// @brief  When set, TaskType::COMPUTE tasks run on this queue, overlapping the main queue tasks they do not depend on.
+        ///         The task graph splits the main queue submits only where one queue waits on the other and orders them with timeline semaphores.
+        ///         Offloaded tasks do not wait on the semaphores of their scope, only on the tasks they depend on. The last submit of a scope waits on all of them.
+        ///         Images must be shared concurrently to be used on both queues. Transient images are, tasks using exclusive persistent images stay on the main queue.
+        ///         Only submitted scopes are split, the work after the last submit stays on the main queue.
+        std::optional<Queue> async_compute_queue = {};
+        /// @brief  When set, TaskType::TRANSFER tasks run on this queue, so uploads overlap the rendering on the main queue.
+        ///         Follows the same rules as async_compute_queue. Uploads into resources the earlier tasks did not use wait on nothing,
+        ///         tasks on other async queues depending on them wait on the transfer queue directly. Without it, transfer tasks run on the main queue.
+        std::optional<Queue> async_transfer_queue = {};
+        /// @brief  TaskType::VIDEO_DECODE and VIDEO_ENCODE tasks only run on these queues, the main queue can not record video commands.
+        ///         Follows the same rules as async_compute_queue, so decoding and encoding overlap the rendering without a readback through the host.
+        ///         Video tasks must be part of a submitted scope and only use concurrently shared images.
+        std::optional<Queue> async_video_decode_queue = {};
+        std::optional<Queue> async_video_encode_queue = {};
         std::string name = {};
     };
 
@@ -118,6 +222,50 @@ namespace daxa
         std::function<void()> when_false = {};
     };
 
+    struct TaskGpuTiming
+    {
+        std::string_view name = {};
+        u32 submit_scope_index = {};
+        u32 batch_index = {};
+        /// @brief  Relative to the begin of the first batch of the execution.
+        u64 begin_ns = {};
+        u64 duration_ns = {};
+        /// @brief  Only with TaskGraphInfo::gpu_profiling_pipeline_statistics or gpu_profiling_occlusion.
+        ///         Transfer tasks and tasks running on async queues are not queried.
+        bool queried = {};
+        /// @brief  Only with TaskGraphInfo::gpu_profiling_occlusion.
+        u64 samples_passed = {};
+        /// @brief  std::chrono::steady_clock nanoseconds around the task callback recording the commands on the cpu.
+        u64 record_begin_host_ns = {};
+        u64 record_duration_ns = {};
+    };
+
+    struct TaskBatchGpuTiming
+    {
+        u32 submit_scope_index = {};
+        u32 batch_index = {};
+        /// @brief  Relative to the begin of the first batch of the execution.
+        u64 begin_ns = {};
+        /// @brief  Includes the barriers of the batch. Tasks offloaded to async queues are not part of it.
+        u64 duration_ns = {};
+    };
+
+    struct TaskGraphGpuTimings
+    {
+        /// @brief  Counts the executions of the graph starting at one, zero while no execution is resolved.
+        u64 execution_index = {};
+        u32 permutation_index = {};
+        std::vector<TaskBatchGpuTiming> batches = {};
+        std::vector<TaskGpuTiming> tasks = {};
+        /// @brief  Only with ImplicitFeatureFlagBits::CALIBRATED_TIMESTAMPS, zero otherwise.
+        ///         std::chrono::steady_clock nanoseconds of the begin of the first batch, relative gpu times add onto it.
+        u64 host_begin_ns = {};
+        /// @brief  Only with TaskGraphInfo::gpu_profiling_pipeline_statistics.
+        ///         Holds pipeline_statistic_count values per task, ordered like tasks and by bit position of the statistic.
+        u32 pipeline_statistic_count = {};
+        std::vector<u64> pipeline_statistics = {};
+    };
+
     struct ExecutionInfo
     {
         std::span<bool> permutation_condition_values = {};
@@ -134,11 +282,30 @@ namespace daxa
     . '. \_____\.
     */
 
+    struct TaskPredicateInfo
+    {
+        /// @brief  Written by earlier tasks, for example a culling pass. With multiple runtime buffers, the first one is used.
+        TaskBufferView buffer = {};
+        /// @brief  Must be a multiple of 4.
+        usize offset = {};
+        bool inverted = {};
+    };
+
     struct InlineTaskInfo
     {
         std::vector<TaskAttachmentInfo> attachments = {};
         std::function<void(TaskInterface)> task = {};
         std::string_view name = "unnamed";
+        TaskType type = TaskType::GENERAL;
+        /// @brief  Discards the draws and dispatches of the task when the 32 bit value in the buffer is zero, or non zero when inverted.
+        ///         Requires ImplicitFeatureFlagBits::CONDITIONAL_RENDERING.
+        ///         The buffer is attached as CONDITIONAL_RENDERING_READ, so the graph synchronizes it with the tasks writing the value.
+        ///         Dispatch sizes produced on the gpu need no predicate, attach the indirect buffer as DRAW_INDIRECT_INFO_READ instead.
+        std::optional<TaskPredicateInfo> predicate = {};
+        /// @brief  Physical devices of a DeviceInfo2::device_group device that execute the task, bit i selects device i. Zero selects all of them.
+        ///         The barriers around the task still run on all devices of the submit.
+        ///         Split a frame by giving each device its own tasks and attachments, and compose it with copies into peer memory, see MemoryBlockBufferInfo::peer_device_index.
+        u32 device_mask = {};
     };
 
     struct InlineTask : ITask
@@ -148,6 +315,31 @@ namespace daxa
             _attachments = info.attachments;
             _callback = info.task;
             _name = info.name;
+            _type = info.type;
+            if (info.predicate.has_value())
+            {
+                TaskPredicateInfo const predicate = info.predicate.value();
+                _attachments.push_back(inl_attachment(TaskBufferAccess::CONDITIONAL_RENDERING_READ, predicate.buffer));
+                _callback = [predicate, callback = info.task](TaskInterface ti)
+                {
+                    ti.recorder.begin_conditional_rendering({
+                        .buffer = ti.get(predicate.buffer).ids[0],
+                        .offset = predicate.offset,
+                        .inverted = predicate.inverted,
+                    });
+                    callback(ti);
+                    ti.recorder.end_conditional_rendering();
+                };
+            }
+            if (info.device_mask != 0)
+            {
+                _callback = [device_mask = info.device_mask, callback = _callback](TaskInterface ti)
+                {
+                    ti.recorder.set_device_mask(device_mask);
+                    callback(ti);
+                    ti.recorder.set_device_mask(0);
+                };
+            }
         }
         constexpr virtual auto attachments() -> std::span<TaskAttachmentInfo> override
         {
@@ -158,6 +350,7 @@ namespace daxa
             return _attachments;
         }
         constexpr virtual std::string_view name() const override { return _name; };
+        constexpr virtual auto type() const -> TaskType override { return _type; }
         virtual void callback(TaskInterface ti) override
         {
             _callback(ti);
@@ -167,6 +360,7 @@ namespace daxa
         std::vector<TaskAttachmentInfo> _attachments = {};
         std::function<void(TaskInterface)> _callback = {};
         std::string_view _name = {};
+        TaskType _type = TaskType::GENERAL;
     };
 
     struct ImplTaskGraph;
@@ -185,6 +379,10 @@ namespace daxa
 
         DAXA_EXPORT_CXX auto create_transient_buffer(TaskTransientBufferInfo const & info) -> TaskBufferView;
         DAXA_EXPORT_CXX auto create_transient_image(TaskTransientImageInfo const & info) -> TaskImageView;
+        /// @brief  Creates a transient buffer holding a daxa_GpuArena header followed by the arena memory, see daxa/utils/gpu_arena.inl.
+        ///         A task resetting the header is added at this point, the arena is empty for all following tasks in every execution.
+        ///         Shaders allocate from the arena with daxa_gpu_arena_allocate, using the buffers device address as the arena pointer.
+        DAXA_EXPORT_CXX auto create_transient_gpu_arena(TaskTransientGpuArenaInfo const & info) -> TaskBufferView;
 
         template <typename TTask>
             requires std::is_base_of_v<IPartialTask, TTask>
@@ -265,6 +463,10 @@ namespace daxa
         {
             add_task(std::make_unique<InlineTask>(inline_task_info));
         }
+        /// @brief  Adds one task filling the mips of the views slice, each mip is blitted from the previous one with a linear filter.
+        ///         The first mip of the slice is read, all following mips are written. The slice must contain at least two mips.
+        ///         The barriers between the mips are recorded within the task, so the whole chain is one task in one batch.
+        DAXA_EXPORT_CXX void add_mip_generation(TaskImageView image, std::string_view name = "mip generation");
 
         DAXA_EXPORT_CXX void conditional(TaskGraphConditionalInfo const & conditional_info);
         DAXA_EXPORT_CXX void submit(TaskSubmitInfo const & info);
@@ -275,8 +477,38 @@ namespace daxa
 
         DAXA_EXPORT_CXX void execute(ExecutionInfo const & info);
 
+        /// @brief  Patches a completed task graph, executions submitted before keep their resources.
+        ///         The schedule and barriers are kept, only the transient memory is placed again and the transient resources are recreated.
+        DAXA_EXPORT_CXX void resize_transient_buffer(TaskBufferView buffer, usize size);
+        /// @brief  Same as resize_transient_buffer for a transient image. Format, dimensions, mips and layers stay the same.
+        DAXA_EXPORT_CXX void resize_transient_image(TaskImageView image, Extent3D size);
+        /// @brief  Replaces the callback of all tasks with the given name. The attachments stay the same, so the barriers stay valid.
+        DAXA_EXPORT_CXX void set_task_callback(std::string_view task_name, std::function<void(TaskInterface)> callback);
+        /// @brief  Disabled tasks are skipped on execution while their barriers stay in place.
+        ///         This is only correct for leaf tasks, no other task may depend on the results of a disabled task.
+        DAXA_EXPORT_CXX void set_task_enabled(std::string_view task_name, bool enabled);
+
         DAXA_EXPORT_CXX auto get_debug_string() -> std::string;
+        /// @brief  Number of executions that had to grow the scratch storage execute reuses on the calling thread.
+        ///         Stays the same once executions reached their steady state, unless the executed permutation changes.
+        DAXA_EXPORT_CXX auto get_execution_scratch_growth_count() -> daxa::u64;
+        /// @brief  Total size of the memory blocks backing the transient resources, summed over all heaps.
         DAXA_EXPORT_CXX auto get_transient_memory_size() -> daxa::usize;
+        /// @brief  Peak size of the transient resources alive within one batch, summed over all heaps.
+        ///         No placement can use less memory, compare it with get_transient_memory_size to judge the aliasing.
+        DAXA_EXPORT_CXX auto get_transient_memory_lower_bound() -> daxa::usize;
+
+        /// @brief  Requires TaskGraphInfo::enable_gpu_profiling.
+        ///         Returns the timings of the most recent execution the gpu finished, without waiting for pending ones.
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the next call to get_timings or the destruction of the graph.
+        DAXA_EXPORT_CXX auto get_timings() -> TaskGraphGpuTimings const &;
+        /// @brief  Writes the last execution as a Chrome trace event json, which can be opened in Perfetto or chrome://tracing.
+        ///         Shows submit scopes, batches, tasks, barriers with their accesses, split barriers as flows and the transient memory aliasing.
+        ///         With TaskGraphInfo::enable_gpu_profiling, the gpu durations resolved by the last get_timings are used.
+        ///         With ImplicitFeatureFlagBits::CALIBRATED_TIMESTAMPS as well, the cpu recording of every task is shown on the same timeline.
+        ///         Otherwise every batch lasts one microsecond, so only the ordering is meaningful.
+        DAXA_EXPORT_CXX auto get_execution_trace() -> std::string;
 
       protected:
         template <typename T, typename H_T>
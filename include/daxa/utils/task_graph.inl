@@ -29,6 +29,7 @@
  * DAXA_TH_BUFFER_PTR:
  *   Declares a buffer attachment.
  *   The first runtime buffer will be represented with its buffer device address within the blob.
+ *   The address is resolved when the task is recorded, so shaders skip the lookup daxa_id_to_address does for ids.
  *
  * DAXA_TH_BUFFER_ID_ARRAY:
  *   Declares a buffer attachment.
@@ -36,7 +37,7 @@
  *
  * DAXA_TH_BUFFER_PTR_ARRAY:
  *   Declares a buffer attachment.
- *   A partial array of the attachments runtime buffers are represented with their buffer device addresses within an id array in the blob.
+ *   A partial array of the attachments runtime buffers are represented with their buffer device addresses within an address array in the blob.
  *
  */
 
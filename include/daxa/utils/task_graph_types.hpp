@@ -69,6 +69,7 @@ namespace daxa
         FRAGMENT_SHADER_READ_WRITE_CONCURRENT,
         INDEX_READ,
         DRAW_INDIRECT_INFO_READ,
+        CONDITIONAL_RENDERING_READ,
         TRANSFER_READ,
         TRANSFER_WRITE,
         HOST_TRANSFER_READ,
@@ -76,11 +77,20 @@ namespace daxa
         ACCELERATION_STRUCTURE_BUILD_READ,
         ACCELERATION_STRUCTURE_BUILD_WRITE,
         ACCELERATION_STRUCTURE_BUILD_READ_WRITE,
+        // Micromap builds read the opacity data and triangle arrays, the write is the buffer backing the micromap.
+        // Blas builds referencing a micromap read it with ACCELERATION_STRUCTURE_BUILD_READ.
+        MICROMAP_BUILD_READ,
+        MICROMAP_BUILD_WRITE,
+        // Bitstream buffers, read by decodes and written by encodes.
+        VIDEO_DECODE_READ,
+        VIDEO_ENCODE_WRITE,
         MAX_ENUM = 0x7fffffff,
     };
 
     auto to_string(TaskBufferAccess const & usage) -> std::string_view;
 
+    /// @brief  In place refits of a blas are BUILD_READ_WRITE accesses.
+    ///         Shader reads are the traces through tlas referencing the blas, declaring them orders later refits after the traces.
     enum struct TaskBlasAccess
     {
         NONE = static_cast<u32>(TaskBufferAccess::NONE),
@@ -94,6 +104,10 @@ namespace daxa
         BUILD_READ = static_cast<u32>(TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_READ),
         BUILD_WRITE = static_cast<u32>(TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_WRITE),
         BUILD_READ_WRITE = static_cast<u32>(TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_READ_WRITE),
+        GRAPHICS_SHADER_READ = static_cast<u32>(TaskBufferAccess::GRAPHICS_SHADER_READ),
+        COMPUTE_SHADER_READ = static_cast<u32>(TaskBufferAccess::COMPUTE_SHADER_READ),
+        RAY_TRACING_SHADER_READ = static_cast<u32>(TaskBufferAccess::RAY_TRACING_SHADER_READ),
+        FRAGMENT_SHADER_READ = static_cast<u32>(TaskBufferAccess::FRAGMENT_SHADER_READ),
         MAX_ENUM = 0x7fffffff,
     };
 
@@ -191,6 +205,12 @@ namespace daxa
         DEPTH_STENCIL_ATTACHMENT_READ,
         RESOLVE_WRITE,
         PRESENT,
+        // Decode output and encode input pictures, DPB accesses are the reference pictures of both.
+        // DPB images need ImageInfo::video_profile, so they have to be persistent images.
+        VIDEO_DECODE_WRITE,
+        VIDEO_DECODE_DPB,
+        VIDEO_ENCODE_READ,
+        VIDEO_ENCODE_DPB,
         MAX_ENUM = 0x7fffffff,
     };
 
@@ -577,6 +597,14 @@ namespace daxa
         TaskTlasAttachmentInfo,
         TaskImageAttachmentInfo>;
 
+    /// @brief  Entry of the view lookup table of a TaskInterface.
+    ///         The key combines the task graph index and index of a view, entries are sorted by key.
+    struct TaskAttachmentViewLookupEntry
+    {
+        u64 key = {};
+        u32 attachment_index = {};
+    };
+
     struct DAXA_EXPORT_CXX TaskInterface
     {
         Device & device;
@@ -585,6 +613,8 @@ namespace daxa
         // optional:
         TransferMemoryPool * allocator = {};
         std::span<std::byte const> attachment_shader_blob = {};
+        /// @brief  Speeds up get(view) for tasks with many attachments. When empty, get(view) searches the attachments linearly.
+        std::span<TaskAttachmentViewLookupEntry const> attachment_view_lookup = {};
 
         [[deprecated("Use AttachmentBlob(std::span<std::byte const>) constructor instead")]] void assign_attachment_shader_blob(std::span<std::byte> arr) const
         {
@@ -604,6 +634,36 @@ namespace daxa
         auto get(TaskImageView view) const -> TaskImageAttachmentInfo const &;
         auto get(usize index) const -> TaskAttachmentInfo const &;
 
+        /// @brief  Resolves a task head attachment index known at compile time directly, e.g. ti.get<AT.color>().
+        template <TaskAttachmentIndex auto INDEX>
+        auto get() const -> auto const &
+        {
+            // Class type template parameters are const, the index type is compared without it.
+            using IndexT = std::remove_cvref_t<decltype(INDEX)>;
+            DAXA_DBG_ASSERT_TRUE_M(INDEX.value < attachment_infos.size(), "Detected out of bounds attachment index!");
+            TaskAttachmentInfo const & attachment = attachment_infos[INDEX.value];
+            if constexpr (std::is_same_v<IndexT, TaskBufferAttachmentIndex>)
+            {
+                DAXA_DBG_ASSERT_TRUE_M(attachment.type == TaskAttachmentType::BUFFER, "Detected buffer index for non buffer attachment!");
+                return attachment.value.buffer;
+            }
+            else if constexpr (std::is_same_v<IndexT, TaskBlasAttachmentIndex>)
+            {
+                DAXA_DBG_ASSERT_TRUE_M(attachment.type == TaskAttachmentType::BLAS, "Detected blas index for non blas attachment!");
+                return attachment.value.blas;
+            }
+            else if constexpr (std::is_same_v<IndexT, TaskTlasAttachmentIndex>)
+            {
+                DAXA_DBG_ASSERT_TRUE_M(attachment.type == TaskAttachmentType::TLAS, "Detected tlas index for non tlas attachment!");
+                return attachment.value.tlas;
+            }
+            else
+            {
+                DAXA_DBG_ASSERT_TRUE_M(attachment.type == TaskAttachmentType::IMAGE, "Detected image index for non image attachment!");
+                return attachment.value.image;
+            }
+        }
+
         auto info(TaskIndexOrView auto tresource, u32 array_index = 0)
         {
             return this->device.info(this->get(tresource).ids[array_index]);
@@ -657,6 +717,19 @@ namespace daxa
         }
     } // namespace detail
 
+    enum struct TaskType
+    {
+        GENERAL,
+        /// @brief  Records only compute and transfer commands, so TaskGraphInfo::async_compute_queue may run it.
+        COMPUTE,
+        /// @brief  Records only transfer commands, so TaskGraphInfo::async_transfer_queue may run it.
+        TRANSFER,
+        /// @brief  Records video decode commands, must run on TaskGraphInfo::async_video_decode_queue.
+        VIDEO_DECODE,
+        /// @brief  Records video encode commands, must run on TaskGraphInfo::async_video_encode_queue.
+        VIDEO_ENCODE,
+    };
+
     struct ITask
     {
         constexpr virtual ~ITask() {}
@@ -668,6 +741,7 @@ namespace daxa
         constexpr virtual auto attachments() -> std::span<TaskAttachmentInfo> = 0;
         constexpr virtual auto attachments() const -> std::span<TaskAttachmentInfo const> = 0;
         constexpr virtual std::string_view name() const = 0;
+        constexpr virtual auto type() const -> TaskType { return TaskType::GENERAL; }
         virtual void callback(TaskInterface){};
     };
 
@@ -886,7 +960,7 @@ namespace daxa
 #define DAXA_TH_BUFFER_ID(TASK_ACCESS, NAME) _DAXA_HELPER_TH_BUFFER(NAME, TASK_ACCESS, .shader_array_size = 1, .shader_as_address = false)
 #define DAXA_TH_BUFFER_PTR(TASK_ACCESS, PTR_TYPE, NAME) _DAXA_HELPER_TH_BUFFER(NAME, TASK_ACCESS, .shader_array_size = 1, .shader_as_address = true)
 #define DAXA_TH_BUFFER_ID_ARRAY(TASK_ACCESS, NAME, SIZE) _DAXA_HELPER_TH_BUFFER(NAME, TASK_ACCESS, .shader_array_size = SIZE, .shader_as_address = false)
-#define DAXA_TH_BUFFER_PTR_ARRAY(TASK_ACCESS, PTR_TYPE, NAME, SIZE) _DAXA_HELPER_TH_BUFFER(NAME, TASK_ACCESS, .shader_array_size = SIZE, .shader_as_address = false)
+#define DAXA_TH_BUFFER_PTR_ARRAY(TASK_ACCESS, PTR_TYPE, NAME, SIZE) _DAXA_HELPER_TH_BUFFER(NAME, TASK_ACCESS, .shader_array_size = SIZE, .shader_as_address = true)
 #define DAXA_TH_BLAS(TASK_ACCESS, NAME) _DAXA_HELPER_TH_BLAS(NAME, TASK_ACCESS)
 #define DAXA_TH_TLAS(TASK_ACCESS, NAME) _DAXA_HELPER_TH_TLAS(NAME, TASK_ACCESS, .shader_array_size = 0)
 #define DAXA_TH_TLAS_PTR(TASK_ACCESS, NAME) _DAXA_HELPER_TH_TLAS(NAME, TASK_ACCESS, .shader_as_address = true)
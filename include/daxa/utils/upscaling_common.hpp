@@ -3,6 +3,9 @@
 #include <daxa/core.hpp>
 #include <daxa/device.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace daxa
 {
     struct UpscaleSizeInfo
@@ -29,6 +32,10 @@ namespace daxa
         bool should_reset = false;
         f32 delta_time;
         daxa_f32vec2 jitter;
+        /// @brief  Size of the rendered area in the top left corner of color, depth and motion_vectors.
+        ///         Allows dynamic resolution without recreating the images or the upscaler, the images stay at the max render size.
+        ///         Zero uses the size of the color image.
+        daxa_u32vec2 render_size = {};
 
         bool should_sharpen = false;
         f32 sharpening = 0.0f;
@@ -41,4 +48,64 @@ namespace daxa
         };
         CameraInfo camera_info = {};
     };
+
+    struct DynamicResolutionInfo
+    {
+        /// @brief  Size the render targets are allocated with, the render size never exceeds it.
+        u32 max_render_size_x = {};
+        u32 max_render_size_y = {};
+        f32 min_scale = 0.5f;
+        f32 max_scale = 1.0f;
+        /// @brief  Gpu time budget of a frame, e.g. slightly below the refresh duration.
+        f32 target_gpu_time_ms = 15.0f;
+        /// @brief  Weight of the newest frame time in the smoothed frame time, lower values react slower but flicker less.
+        f32 smoothing = 0.1f;
+        /// @brief  Largest scale change per update.
+        f32 max_scale_step = 0.05f;
+        /// @brief  The scale is kept while the smoothed time is within this fraction of the target.
+        f32 tolerance = 0.05f;
+        /// @brief  Render sizes are rounded down to multiples of this, keeping dispatch sizes and the jitter sequence stable.
+        u32 size_granularity = 8;
+    };
+
+    /// @brief  Picks a per frame render size from measured gpu frame times.
+    ///         Gpu time is assumed to scale with the pixel count, so the scale moves with the square root of the time ratio.
+    ///         Feed it gpu frame times, for example from TimelineQueryPool timestamps written around the frame.
+    ///         Pass render_size() to UpscaleInfo::render_size and use it as the viewport of the rendering tasks.
+    struct DynamicResolutionController
+    {
+        DynamicResolutionInfo info = {};
+        f32 scale = 1.0f;
+        f32 smoothed_gpu_time_ms = 0.0f;
+
+        DynamicResolutionController() = default;
+        DynamicResolutionController(DynamicResolutionInfo const & a_info)
+            : info{a_info}, scale{a_info.max_scale}
+        {
+        }
+
+        void update(f32 gpu_time_ms)
+        {
+            smoothed_gpu_time_ms = smoothed_gpu_time_ms == 0.0f ? gpu_time_ms : std::lerp(smoothed_gpu_time_ms, gpu_time_ms, info.smoothing);
+            f32 const ratio = info.target_gpu_time_ms / std::max(smoothed_gpu_time_ms, 0.001f);
+            if (std::abs(ratio - 1.0f) <= info.tolerance)
+            {
+                return;
+            }
+            f32 const ideal_scale = scale * std::sqrt(ratio);
+            f32 const stepped_scale = std::clamp(ideal_scale, scale - info.max_scale_step, scale + info.max_scale_step);
+            scale = std::clamp(stepped_scale, info.min_scale, info.max_scale);
+        }
+
+        [[nodiscard]] auto render_size() const -> daxa_u32vec2
+        {
+            auto scaled = [&](u32 max_size) -> u32
+            {
+                u32 const granularity = std::max(info.size_granularity, 1u);
+                u32 const size = static_cast<u32>(static_cast<f32>(max_size) * scale) / granularity * granularity;
+                return std::clamp(size, std::min(granularity, max_size), max_size);
+            };
+            return {scaled(info.max_render_size_x), scaled(info.max_render_size_y)};
+        }
+    };
 } // namespace daxa
@@ -11,8 +11,10 @@ vcpkg_check_features(OUT_FEATURE_OPTIONS FEATURE_OPTIONS
     utils-pipeline-manager-glslang WITH_UTILS_PIPELINE_MANAGER_GLSLANG
     utils-pipeline-manager-slang WITH_UTILS_PIPELINE_MANAGER_SLANG
     utils-pipeline-manager-spirv-validation WITH_UTILS_PIPELINE_MANAGER_SPIRV_VALIDATION
+    utils-pipeline-manager-spirv-optimization WITH_UTILS_PIPELINE_MANAGER_SPIRV_OPTIMIZATION
     utils-task-graph WITH_UTILS_TASK_GRAPH
     utils-fsr2 WITH_UTILS_FSR2
+    profiling-tracy WITH_PROFILING_TRACY
 )
 set(DAXA_DEFINES "-DDAXA_INSTALL=true")
 
@@ -31,12 +33,18 @@ endif()
 if(WITH_UTILS_PIPELINE_MANAGER_SPIRV_VALIDATION)
     list(APPEND DAXA_DEFINES "-DDAXA_ENABLE_UTILS_PIPELINE_MANAGER_SPIRV_VALIDATION=true")
 endif()
+if(WITH_UTILS_PIPELINE_MANAGER_SPIRV_OPTIMIZATION)
+    list(APPEND DAXA_DEFINES "-DDAXA_ENABLE_UTILS_PIPELINE_MANAGER_SPIRV_OPTIMIZATION=true")
+endif()
 if(WITH_UTILS_TASK_GRAPH)
     list(APPEND DAXA_DEFINES "-DDAXA_ENABLE_UTILS_TASK_GRAPH=true")
 endif()
 if(WITH_UTILS_FSR2)
     list(APPEND DAXA_DEFINES "-DDAXA_ENABLE_UTILS_FSR2=true")
 endif()
+if(WITH_PROFILING_TRACY)
+    list(APPEND DAXA_DEFINES "-DDAXA_ENABLE_PROFILING_TRACY=true")
+endif()
 
 vcpkg_configure_cmake(
     SOURCE_PATH "${SOURCE_PATH}"
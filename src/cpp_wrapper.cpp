@@ -14,6 +14,49 @@
 
 static_assert(sizeof(daxa::Queue) == sizeof(daxa_Queue));
 static_assert(alignof(daxa::Queue) == alignof(daxa_Queue));
+static_assert(sizeof(daxa::MemoryReport) == sizeof(daxa_MemoryReport));
+static_assert(sizeof(daxa::CalibratedTimestamps) == sizeof(daxa_CalibratedTimestamps));
+static_assert(sizeof(daxa::ReplayStats) == sizeof(daxa_ReplayStats));
+static_assert(sizeof(daxa::SwapchainFrameStatistics) == sizeof(daxa_SwapchainFrameStatistics));
+static_assert(daxa::SWAPCHAIN_FRAME_STATISTICS_COUNT == DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT);
+static_assert(sizeof(daxa::SparseImageMemoryRequirements) == sizeof(daxa_SparseImageMemoryRequirements));
+static_assert(sizeof(daxa::SparseBufferBind) == sizeof(daxa_SparseBufferBind));
+static_assert(sizeof(daxa::SparseImageOpaqueBind) == sizeof(daxa_SparseImageOpaqueBind));
+static_assert(sizeof(daxa::SparseImageBind) == sizeof(daxa_SparseImageBind));
+static_assert(sizeof(daxa::BufferRange) == sizeof(daxa_BufferRange));
+static_assert(sizeof(daxa::CommandRecorderStats) == sizeof(daxa_CommandRecorderStats));
+static_assert(sizeof(daxa::DrawRange) == sizeof(daxa_DrawRange));
+static_assert(sizeof(daxa::DrawIndexedRange) == sizeof(daxa_DrawIndexedRange));
+static_assert(sizeof(daxa::DrawMultiInfo) == sizeof(daxa_DrawMultiInfo));
+static_assert(sizeof(daxa::DrawMultiIndexedInfo) == sizeof(daxa_DrawMultiIndexedInfo));
+static_assert(sizeof(daxa::IndirectCommandsToken) == sizeof(daxa_IndirectCommandsToken));
+static_assert(sizeof(daxa::IndirectCommandsLayoutInfo) == sizeof(daxa_IndirectCommandsLayoutInfo));
+static_assert(sizeof(daxa::IndirectExecutionSetInfo) == sizeof(daxa_IndirectExecutionSetInfo));
+static_assert(sizeof(daxa::ShaderObjectInfo) == sizeof(daxa_ShaderObjectInfo));
+static_assert(sizeof(daxa::ShaderInfo) == sizeof(daxa_ShaderInfo));
+static_assert(sizeof(daxa::SpecializationConstant) == sizeof(daxa_SpecializationConstant));
+static_assert(sizeof(daxa::SetRasterShaderObjectsInfo) == sizeof(daxa_SetRasterShaderObjectsInfo));
+static_assert(sizeof(daxa::GeneratedCommandsMemoryRequirementsInfo) == sizeof(daxa_GeneratedCommandsMemoryRequirementsInfo));
+static_assert(sizeof(daxa::ExecuteGeneratedCommandsInfo) == sizeof(daxa_ExecuteGeneratedCommandsInfo));
+static_assert(sizeof(daxa::MemoryDecompressionRegion) == sizeof(daxa_MemoryDecompressionRegion));
+static_assert(sizeof(daxa::DecompressMemoryInfo) == sizeof(daxa_DecompressMemoryInfo));
+static_assert(sizeof(daxa::WriteBlasCompactedSizesInfo) == sizeof(daxa_WriteBlasCompactedSizesInfo));
+static_assert(sizeof(daxa::CopyAccelerationStructureInfo) == sizeof(daxa_CopyAccelerationStructureInfo));
+static_assert(sizeof(daxa::MicromapInfo) == sizeof(daxa_MicromapInfo));
+static_assert(sizeof(daxa::MicromapBuildInfo) == sizeof(daxa_MicromapBuildInfo));
+static_assert(sizeof(daxa::MicromapBuildSizesInfo) == sizeof(daxa_MicromapBuildSizesInfo));
+static_assert(sizeof(daxa::BlasTriangleGeometryInfo) == sizeof(daxa_BlasTriangleGeometryInfo));
+static_assert(sizeof(daxa::BuildMicromapsInfo) == sizeof(daxa_BuildMicromapsInfo));
+static_assert(sizeof(daxa::CopyTimestampsToBufferInfo) == sizeof(daxa_CopyTimestampsToBufferInfo));
+static_assert(sizeof(daxa::VideoProfileInfo) == sizeof(daxa_VideoProfileInfo));
+static_assert(sizeof(daxa::VideoSessionInfo) == sizeof(daxa_VideoSessionInfo));
+static_assert(sizeof(daxa::VideoPictureResource) == sizeof(daxa_VideoPictureResource));
+static_assert(sizeof(daxa::VideoReferenceSlot) == sizeof(daxa_VideoReferenceSlot));
+static_assert(sizeof(daxa::BeginVideoCodingInfo) == sizeof(daxa_BeginVideoCodingInfo));
+static_assert(sizeof(daxa::VideoCodingControlInfo) == sizeof(daxa_VideoCodingControlInfo));
+static_assert(sizeof(daxa::VideoDecodeInfo) == sizeof(daxa_VideoDecodeInfo));
+static_assert(sizeof(daxa::VideoEncodeInfo) == sizeof(daxa_VideoEncodeInfo));
+static_assert(sizeof(daxa::ProfileZone) == sizeof(daxa_ProfileZone));
 
 // --- Begin Helpers ---
 
@@ -136,6 +179,36 @@ auto daxa_result_to_string(daxa_Result result) -> std::string_view
     case daxa_Result::DAXA_RESULT_ERROR_DEVICE_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_DEVICE_NOT_SUPPORTED";
     case daxa_Result::DAXA_RESULT_DEVICE_DOES_NOT_SUPPORT_ACCELERATION_STRUCTURE_COUNT: return "DAXA_RESULT_DEVICE_DOES_NOT_SUPPORT_ACCELERATION_STRUCTURE_COUNT";
     case daxa_Result::DAXA_RESULT_ERROR_NO_SUITABLE_DEVICE_FOUND: return "DAXA_RESULT_ERROR_NO_SUITABLE_DEVICE_FOUND";
+    case daxa_Result::DAXA_RESULT_ERROR_SUBMIT_BATCH_QUEUE_MISMATCH: return "DAXA_RESULT_ERROR_SUBMIT_BATCH_QUEUE_MISMATCH";
+    case daxa_Result::DAXA_RESULT_ERROR_DEFRAGMENTATION_PASS_MISMATCH: return "DAXA_RESULT_ERROR_DEFRAGMENTATION_PASS_MISMATCH";
+    case daxa_Result::DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH: return "DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH";
+    case daxa_Result::DAXA_RESULT_ERROR_REUSABLE_COMMAND_LIST_OUTDATED: return "DAXA_RESULT_ERROR_REUSABLE_COMMAND_LIST_OUTDATED";
+    case daxa_Result::DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT: return "DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT";
+    case daxa_Result::DAXA_RESULT_ERROR_PIPELINE_CACHE_WRITE_FAILED: return "DAXA_RESULT_ERROR_PIPELINE_CACHE_WRITE_FAILED";
+    case daxa_Result::DAXA_RESULT_ERROR_SHADER_OBJECT_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_SHADER_OBJECT_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE: return "DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE";
+    case daxa_Result::DAXA_RESULT_ERROR_SHADER_OBJECT_PUSH_CONSTANT_SIZE_MISMATCH: return "DAXA_RESULT_ERROR_SHADER_OBJECT_PUSH_CONSTANT_SIZE_MISMATCH";
+    case daxa_Result::DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_SCOPE_MISMATCH: return "DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_SCOPE_MISMATCH";
+    case daxa_Result::DAXA_RESULT_ERROR_PIPELINE_STATISTICS_QUERY_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_PIPELINE_STATISTICS_QUERY_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_PRECISE_OCCLUSION_QUERY_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_PRECISE_OCCLUSION_QUERY_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_INVALID_QUERY_TYPE: return "DAXA_RESULT_ERROR_INVALID_QUERY_TYPE";
+    case daxa_Result::DAXA_RESULT_ERROR_MEMORY_DECOMPRESSION_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_MEMORY_DECOMPRESSION_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_ACCELERATION_STRUCTURE_UPDATE_WITHOUT_ALLOW_UPDATE: return "DAXA_RESULT_ERROR_ACCELERATION_STRUCTURE_UPDATE_WITHOUT_ALLOW_UPDATE";
+    case daxa_Result::DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_CALIBRATED_TIMESTAMPS_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_CALIBRATED_TIMESTAMPS_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_EXCEEDED_MAX_PUSH_CONSTANT_SIZE: return "DAXA_RESULT_ERROR_EXCEEDED_MAX_PUSH_CONSTANT_SIZE";
+    case daxa_Result::DAXA_RESULT_ERROR_INVALID_DEVICE_MASK: return "DAXA_RESULT_ERROR_INVALID_DEVICE_MASK";
+    case daxa_Result::DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED: return "DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED";
+    case daxa_Result::DAXA_RESULT_ERROR_DEVICE_NOT_CAPTURABLE: return "DAXA_RESULT_ERROR_DEVICE_NOT_CAPTURABLE";
+    case daxa_Result::DAXA_RESULT_ERROR_CAPTURE_MISMATCH: return "DAXA_RESULT_ERROR_CAPTURE_MISMATCH";
+    case daxa_Result::DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID: return "DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID";
+    case daxa_Result::DAXA_RESULT_ERROR_REPLAY_ID_CONFLICT: return "DAXA_RESULT_ERROR_REPLAY_ID_CONFLICT";
+    case daxa_Result::DAXA_RESULT_ERROR_PIPELINE_NOT_READY: return "DAXA_RESULT_ERROR_PIPELINE_NOT_READY";
+    case daxa_Result::DAXA_RESULT_ERROR_INVALID_IMAGE_LAYOUT: return "DAXA_RESULT_ERROR_INVALID_IMAGE_LAYOUT";
     case daxa_Result::DAXA_RESULT_MAX_ENUM: return "DAXA_RESULT_MAX_ENUM";
     default: return "UNIMPLEMENTED";
     }
@@ -161,6 +234,32 @@ void check_result(daxa_Result result, char const * message, std::array<daxa_Resu
     }
 }
 
+auto to_c_command_submit_info(daxa::CommandSubmitInfo const & submit_info) -> daxa_CommandSubmitInfo
+{
+    DAXA_DBG_ASSERT_TRUE_M(
+        submit_info.wait_binary_semaphore_stages.empty() || submit_info.wait_binary_semaphore_stages.size() == submit_info.wait_binary_semaphores.size(),
+        "wait_binary_semaphore_stages must be empty or match the wait binary semaphore count");
+    DAXA_DBG_ASSERT_TRUE_M(
+        submit_info.wait_timeline_semaphore_stages.empty() || submit_info.wait_timeline_semaphore_stages.size() == submit_info.wait_timeline_semaphores.size(),
+        "wait_timeline_semaphore_stages must be empty or match the wait timeline semaphore count");
+    return daxa_CommandSubmitInfo{
+        .queue = std::bit_cast<daxa_Queue>(submit_info.queue),
+        .wait_stages = static_cast<VkPipelineStageFlags2>(submit_info.wait_stages.data),
+        .command_lists = reinterpret_cast<daxa_ExecutableCommandList const *>(submit_info.command_lists.data()),
+        .command_list_count = submit_info.command_lists.size(),
+        .wait_binary_semaphores = reinterpret_cast<daxa_BinarySemaphore const *>(submit_info.wait_binary_semaphores.data()),
+        .wait_binary_semaphore_count = submit_info.wait_binary_semaphores.size(),
+        .signal_binary_semaphores = reinterpret_cast<daxa_BinarySemaphore const *>(submit_info.signal_binary_semaphores.data()),
+        .signal_binary_semaphore_count = submit_info.signal_binary_semaphores.size(),
+        .wait_timeline_semaphores = reinterpret_cast<daxa_TimelinePair const *>(submit_info.wait_timeline_semaphores.data()),
+        .wait_timeline_semaphore_count = submit_info.wait_timeline_semaphores.size(),
+        .signal_timeline_semaphores = reinterpret_cast<daxa_TimelinePair const *>(submit_info.signal_timeline_semaphores.data()),
+        .signal_timeline_semaphore_count = submit_info.signal_timeline_semaphores.size(),
+        .wait_binary_semaphore_stages = submit_info.wait_binary_semaphore_stages.empty() ? nullptr : reinterpret_cast<VkPipelineStageFlags2 const *>(submit_info.wait_binary_semaphore_stages.data()),
+        .wait_timeline_semaphore_stages = submit_info.wait_timeline_semaphore_stages.empty() ? nullptr : reinterpret_cast<VkPipelineStageFlags2 const *>(submit_info.wait_timeline_semaphore_stages.data()),
+    };
+}
+
 // --- End Helpers ---
 
 namespace daxa
@@ -237,6 +336,26 @@ namespace daxa
 
     /// --- End Instance ---
 
+    /// --- Begin Profiling ---
+
+    auto collect_profile_zones() -> std::vector<ProfileZone>
+    {
+        std::vector<ProfileZone> ret = {};
+        daxa_Result result = DAXA_RESULT_INCOMPLETE;
+        while (result == DAXA_RESULT_INCOMPLETE)
+        {
+            usize const offset = ret.size();
+            daxa_u32 count = 1024;
+            ret.resize(offset + count);
+            result = daxa_collect_profile_zones(r_cast<daxa_ProfileZone *>(ret.data() + offset), &count);
+            check_result(result, "failed to collect profile zones", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_INCOMPLETE});
+            ret.resize(offset + count);
+        }
+        return ret;
+    }
+
+    /// --- End Profiling ---
+
     /// --- Begin Device ---
 
     auto default_device_score(DeviceProperties const & device_props) -> i32
@@ -271,6 +390,34 @@ namespace daxa
                 r_cast<daxa_ImageInfo const *>(&info)));
     }
 
+    auto Device::sparse_buffer_memory_requirements(BufferInfo const & info) const -> MemoryRequirements
+    {
+        return std::bit_cast<MemoryRequirements>(
+            daxa_dvc_sparse_buffer_memory_requirements(
+                rc_cast<daxa_Device>(this->object),
+                r_cast<daxa_BufferInfo const *>(&info)));
+    }
+
+    auto Device::sparse_image_memory_requirements(ImageInfo const & info) const -> SparseImageMemoryRequirements
+    {
+        SparseImageMemoryRequirements ret = {};
+        check_result(
+            daxa_dvc_sparse_image_memory_requirements(
+                rc_cast<daxa_Device>(this->object),
+                r_cast<daxa_ImageInfo const *>(&info),
+                r_cast<daxa_SparseImageMemoryRequirements *>(&ret)),
+            "failed to get sparse image memory requirements");
+        return ret;
+    }
+
+    auto Device::generated_commands_memory_requirements(GeneratedCommandsMemoryRequirementsInfo const & info) const -> MemoryRequirements
+    {
+        return std::bit_cast<MemoryRequirements>(
+            daxa_dvc_generated_commands_memory_requirements(
+                rc_cast<daxa_Device>(this->object),
+                r_cast<daxa_GeneratedCommandsMemoryRequirementsInfo const *>(&info)));
+    }
+
     auto Device::tlas_build_sizes(TlasBuildInfo const & info)
         -> AccelerationStructureBuildSizesInfo
     {
@@ -295,6 +442,18 @@ namespace daxa
         return ret;
     }
 
+    auto Device::micromap_build_sizes(MicromapBuildInfo const & info)
+        -> MicromapBuildSizesInfo
+    {
+        MicromapBuildSizesInfo ret = {};
+        check_result(daxa_dvc_get_micromap_build_sizes(
+                         rc_cast<daxa_Device>(this->object),
+                         r_cast<daxa_MicromapBuildInfo const *>(&info),
+                         r_cast<daxa_MicromapBuildSizesInfo *>(&ret)),
+                     "failed to get micromap build sizes");
+        return ret;
+    }
+
 #define DAXA_DECL_GPU_RES_FN(Name, name)                                \
     auto Device::create_##name(Name##Info const & info) -> Name##Id     \
     {                                                                   \
@@ -334,6 +493,17 @@ namespace daxa
         return {};                                                      \
     }
 
+    auto Device::create_sparse_buffer(BufferInfo const & info) -> BufferId
+    {
+        BufferId id = {};
+        check_result(
+            daxa_dvc_create_sparse_buffer(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_BufferInfo const *>(&info),
+                r_cast<daxa_BufferId *>(&id)),
+            "failed to create sparse buffer");
+        return id;
+    }
     auto Device::create_buffer_from_memory_block(MemoryBlockBufferInfo const & info) -> BufferId
     {
         BufferId id = {};
@@ -378,6 +548,54 @@ namespace daxa
             "failed to create blas from buffer");
         return id;
     }
+    auto Device::create_buffers(std::span<BufferInfo const> infos) -> std::vector<BufferId>
+    {
+        std::vector<BufferId> ids(infos.size());
+        check_result(
+            daxa_dvc_create_buffers(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_BufferInfo const *>(infos.data()),
+                infos.size(),
+                r_cast<daxa_BufferId *>(ids.data())),
+            "failed to create buffers");
+        return ids;
+    }
+    auto Device::create_images(std::span<ImageInfo const> infos) -> std::vector<ImageId>
+    {
+        std::vector<ImageId> ids(infos.size());
+        check_result(
+            daxa_dvc_create_images(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_ImageInfo const *>(infos.data()),
+                infos.size(),
+                r_cast<daxa_ImageId *>(ids.data())),
+            "failed to create images");
+        return ids;
+    }
+    auto Device::create_image_views(std::span<ImageViewInfo const> infos) -> std::vector<ImageViewId>
+    {
+        std::vector<ImageViewId> ids(infos.size());
+        check_result(
+            daxa_dvc_create_image_views(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_ImageViewInfo const *>(infos.data()),
+                infos.size(),
+                r_cast<daxa_ImageViewId *>(ids.data())),
+            "failed to create image views");
+        return ids;
+    }
+    auto Device::create_images_from_memory_block(std::span<MemoryBlockImageInfo const> infos) -> std::vector<ImageId>
+    {
+        std::vector<ImageId> ids(infos.size());
+        check_result(
+            daxa_dvc_create_images_from_block(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_MemoryBlockImageInfo const *>(infos.data()),
+                infos.size(),
+                r_cast<daxa_ImageId *>(ids.data())),
+            "failed to create images from memory block");
+        return ids;
+    }
     DAXA_DECL_GPU_RES_FN(Buffer, buffer)
     DAXA_DECL_GPU_RES_FN(Image, image)
     DAXA_DECL_GPU_RES_FN(ImageView, image_view)
@@ -385,6 +603,20 @@ namespace daxa
     DAXA_DECL_GPU_RES_FN(Tlas, tlas)
     DAXA_DECL_GPU_RES_FN(Blas, blas)
 
+#define DAXA_DECL_GPU_RES_BULK_DESTROY_FN(Name, name)               \
+    void Device::destroy_##name##s(std::span<Name##Id const> ids)   \
+    {                                                               \
+        auto result = daxa_dvc_destroy_##name##s(                   \
+            r_cast<daxa_Device>(this->object),                      \
+            r_cast<daxa_##Name##Id const *>(ids.data()),            \
+            ids.size());                                            \
+        check_result(result, "invalid resource id");                \
+    }
+    DAXA_DECL_GPU_RES_BULK_DESTROY_FN(Buffer, buffer)
+    DAXA_DECL_GPU_RES_BULK_DESTROY_FN(Image, image)
+    DAXA_DECL_GPU_RES_BULK_DESTROY_FN(ImageView, image_view)
+    DAXA_DECL_GPU_RES_BULK_DESTROY_FN(Sampler, sampler)
+
     auto Device::buffer_device_address(BufferId id) const -> Optional<DeviceAddress>
     {
         DeviceAddress ret = 0;
@@ -445,6 +677,42 @@ namespace daxa
         return {};
     }
 
+    auto Device::export_memory(BufferId id) const -> u64
+    {
+        u64 ret = {};
+        check_result(
+            daxa_dvc_export_buffer_memory(rc_cast<daxa_Device>(this->object), static_cast<daxa_BufferId>(id), &ret),
+            "failed to export buffer memory");
+        return ret;
+    }
+
+    auto Device::export_memory(ImageId id) const -> u64
+    {
+        u64 ret = {};
+        check_result(
+            daxa_dvc_export_image_memory(rc_cast<daxa_Device>(this->object), static_cast<daxa_ImageId>(id), &ret),
+            "failed to export image memory");
+        return ret;
+    }
+
+    void Device::flush_ranges(std::span<BufferRange const> ranges)
+    {
+        check_result(daxa_dvc_flush_buffer_ranges(
+                         r_cast<daxa_Device>(this->object),
+                         r_cast<daxa_BufferRange const *>(ranges.data()),
+                         static_cast<u32>(ranges.size())),
+                     "failed to flush buffer ranges");
+    }
+
+    void Device::invalidate_ranges(std::span<BufferRange const> ranges)
+    {
+        check_result(daxa_dvc_invalidate_buffer_ranges(
+                         r_cast<daxa_Device>(this->object),
+                         r_cast<daxa_BufferRange const *>(ranges.data()),
+                         static_cast<u32>(ranges.size())),
+                     "failed to invalidate buffer ranges");
+    }
+
 #define DAXA_DECL_DVC_CREATE_FN(Name, name)                        \
     auto Device::create_##name(Name##Info const & info) -> Name    \
     {                                                              \
@@ -505,11 +773,53 @@ namespace daxa
     DAXA_DECL_DVC_CREATE_FN(RasterPipeline, raster_pipeline)
     DAXA_DECL_DVC_CREATE_FN(ComputePipeline, compute_pipeline)
     DAXA_DECL_DVC_CREATE_FN(RayTracingPipeline, ray_tracing_pipeline)
+
+    auto Device::create_compute_pipeline_async(ComputePipelineInfo const & info, ComputePipeline const & fallback) -> ComputePipeline
+    {
+        ComputePipeline ret = {};
+        check_result(daxa_dvc_create_compute_pipeline_async(
+                         r_cast<daxa_Device>(this->object),
+                         r_cast<daxa_ComputePipelineInfo const *>(&info),
+                         *r_cast<daxa_ComputePipeline const *>(&fallback),
+                         r_cast<daxa_ComputePipeline *>(&ret)),
+                     "failed to create compute pipeline async");
+        return ret;
+    }
+
+    auto Device::create_raster_pipeline_async(RasterPipelineInfo const & info, RasterPipeline const & fallback) -> RasterPipeline
+    {
+        RasterPipeline ret = {};
+        check_result(daxa_dvc_create_raster_pipeline_async(
+                         r_cast<daxa_Device>(this->object),
+                         r_cast<daxa_RasterPipelineInfo const *>(&info),
+                         *r_cast<daxa_RasterPipeline const *>(&fallback),
+                         r_cast<daxa_RasterPipeline *>(&ret)),
+                     "failed to create raster pipeline async");
+        return ret;
+    }
+
+    auto Device::create_compute_pipelines(std::span<ComputePipelineInfo const> infos) -> std::vector<ComputePipeline>
+    {
+        std::vector<ComputePipeline> ret(infos.size());
+        check_result(daxa_dvc_create_compute_pipelines(
+                         r_cast<daxa_Device>(this->object),
+                         r_cast<daxa_ComputePipelineInfo const *>(infos.data()),
+                         infos.size(),
+                         r_cast<daxa_ComputePipeline *>(ret.data())),
+                     "failed to create compute pipelines");
+        return ret;
+    }
     DAXA_DECL_DVC_CREATE_FN(Swapchain, swapchain)
     DAXA_DECL_DVC_CREATE_FN(BinarySemaphore, binary_semaphore)
     DAXA_DECL_DVC_CREATE_FN(TimelineSemaphore, timeline_semaphore)
     DAXA_DECL_DVC_CREATE_FN(Event, event)
     DAXA_DECL_DVC_CREATE_FN(TimelineQueryPool, timeline_query_pool)
+    DAXA_DECL_DVC_CREATE_FN(QueryPool, query_pool)
+    DAXA_DECL_DVC_CREATE_FN(IndirectCommandsLayout, indirect_commands_layout)
+    DAXA_DECL_DVC_CREATE_FN(IndirectExecutionSet, indirect_execution_set)
+    DAXA_DECL_DVC_CREATE_FN(ShaderObject, shader_object)
+    DAXA_DECL_DVC_CREATE_FN(Micromap, micromap)
+    DAXA_DECL_DVC_CREATE_FN(VideoSession, video_session)
 
     auto Device::info() const -> DeviceInfo2 const &
     {
@@ -522,6 +832,39 @@ namespace daxa
         check_result(result, "failed to wait idle device");
     }
 
+    auto Device::wait_semaphores(std::span<std::pair<TimelineSemaphore, u64> const> pairs, bool wait_any, u64 timeout_nanos) -> bool
+    {
+        auto result = daxa_dvc_wait_semaphores(
+            r_cast<daxa_Device>(this->object),
+            r_cast<daxa_TimelinePair const *>(pairs.data()),
+            pairs.size(),
+            static_cast<daxa_Bool8>(wait_any),
+            timeout_nanos);
+        check_result(result, "failed to wait for semaphores", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_TIMEOUT});
+        return result == DAXA_RESULT_SUCCESS;
+    }
+
+    void Device::on_timeline(TimelineSemaphore const & semaphore, u64 value, std::function<void()> callback)
+    {
+        auto const pair = std::pair{semaphore, value};
+        auto * user_data = new std::function<void()>{std::move(callback)};
+        auto trampoline = [](void * data, daxa_Bool8 reached)
+        {
+            auto * function = r_cast<std::function<void()> *>(data);
+            if (reached != 0)
+            {
+                (*function)();
+            }
+            delete function;
+        };
+        auto result = daxa_dvc_on_timeline(r_cast<daxa_Device>(this->object), r_cast<daxa_TimelinePair const *>(&pair), trampoline, user_data);
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            delete user_data;
+        }
+        check_result(result, "failed to register timeline callback");
+    }
+
     void Device::queue_wait_idle(Queue queue)
     {
         auto result = daxa_dvc_queue_wait_idle(r_cast<daxa_Device>(this->object), std::bit_cast<daxa_Queue>(queue));
@@ -538,25 +881,61 @@ namespace daxa
 
     void Device::submit_commands(CommandSubmitInfo const & submit_info)
     {
-        daxa_CommandSubmitInfo const c_submit_info = {
-            .queue = std::bit_cast<daxa_Queue>(submit_info.queue),
-            .wait_stages = static_cast<VkPipelineStageFlags>(submit_info.wait_stages.data),
-            .command_lists = reinterpret_cast<daxa_ExecutableCommandList const *>(submit_info.command_lists.data()),
-            .command_list_count = submit_info.command_lists.size(),
-            .wait_binary_semaphores = reinterpret_cast<daxa_BinarySemaphore const *>(submit_info.wait_binary_semaphores.data()),
-            .wait_binary_semaphore_count = submit_info.wait_binary_semaphores.size(),
-            .signal_binary_semaphores = reinterpret_cast<daxa_BinarySemaphore const *>(submit_info.signal_binary_semaphores.data()),
-            .signal_binary_semaphore_count = submit_info.signal_binary_semaphores.size(),
-            .wait_timeline_semaphores = reinterpret_cast<daxa_TimelinePair const *>(submit_info.wait_timeline_semaphores.data()),
-            .wait_timeline_semaphore_count = submit_info.wait_timeline_semaphores.size(),
-            .signal_timeline_semaphores = reinterpret_cast<daxa_TimelinePair const *>(submit_info.signal_timeline_semaphores.data()),
-            .signal_timeline_semaphore_count = submit_info.signal_timeline_semaphores.size(),
-        };
+        daxa_CommandSubmitInfo const c_submit_info = to_c_command_submit_info(submit_info);
         check_result(
             daxa_dvc_submit(r_cast<daxa_Device>(this->object), &c_submit_info),
             "failed to submit commands");
     }
 
+    auto Device::latest_submit_index() const -> u64
+    {
+        return daxa_dvc_latest_submit_index(rc_cast<daxa_Device>(this->object));
+    }
+
+    auto Device::completed_submit_index() const -> u64
+    {
+        u64 ret = {};
+        check_result(daxa_dvc_completed_submit_index(rc_cast<daxa_Device>(this->object), &ret), "failed to get completed submit index");
+        return ret;
+    }
+
+    void Device::submit_batch(std::span<CommandSubmitInfo const> submit_infos)
+    {
+        thread_local std::vector<daxa_CommandSubmitInfo> tl_c_submit_infos = {};
+        tl_c_submit_infos.clear();
+        for (auto const & submit_info : submit_infos)
+        {
+            tl_c_submit_infos.push_back(to_c_command_submit_info(submit_info));
+        }
+        check_result(
+            daxa_dvc_submit_batch(r_cast<daxa_Device>(this->object), tl_c_submit_infos.data(), tl_c_submit_infos.size()),
+            "failed to submit command batch");
+    }
+
+    void Device::bind_sparse(BindSparseInfo const & info)
+    {
+        daxa_BindSparseInfo const c_info = {
+            .queue = std::bit_cast<daxa_Queue>(info.queue),
+            .buffer_binds = reinterpret_cast<daxa_SparseBufferBind const *>(info.buffer_binds.data()),
+            .buffer_bind_count = info.buffer_binds.size(),
+            .image_opaque_binds = reinterpret_cast<daxa_SparseImageOpaqueBind const *>(info.image_opaque_binds.data()),
+            .image_opaque_bind_count = info.image_opaque_binds.size(),
+            .image_binds = reinterpret_cast<daxa_SparseImageBind const *>(info.image_binds.data()),
+            .image_bind_count = info.image_binds.size(),
+            .wait_binary_semaphores = reinterpret_cast<daxa_BinarySemaphore const *>(info.wait_binary_semaphores.data()),
+            .wait_binary_semaphore_count = info.wait_binary_semaphores.size(),
+            .signal_binary_semaphores = reinterpret_cast<daxa_BinarySemaphore const *>(info.signal_binary_semaphores.data()),
+            .signal_binary_semaphore_count = info.signal_binary_semaphores.size(),
+            .wait_timeline_semaphores = reinterpret_cast<daxa_TimelinePair const *>(info.wait_timeline_semaphores.data()),
+            .wait_timeline_semaphore_count = info.wait_timeline_semaphores.size(),
+            .signal_timeline_semaphores = reinterpret_cast<daxa_TimelinePair const *>(info.signal_timeline_semaphores.data()),
+            .signal_timeline_semaphore_count = info.signal_timeline_semaphores.size(),
+        };
+        check_result(
+            daxa_dvc_bind_sparse(r_cast<daxa_Device>(this->object), &c_info),
+            "failed to bind sparse memory");
+    }
+
     void Device::present_frame(PresentInfo const & info)
     {
         daxa_PresentInfo const c_present_info = {
@@ -576,6 +955,112 @@ namespace daxa
             "failed to collect garbage");
     }
 
+    void Device::save_pipeline_cache()
+    {
+        check_result(
+            daxa_dvc_save_pipeline_cache(r_cast<daxa_Device>(this->object)),
+            "failed to save pipeline cache");
+    }
+
+    auto Device::collect_garbage_incremental(GarbageCollectInfo const & info) -> bool
+    {
+        auto const result = daxa_dvc_collect_garbage_incremental(r_cast<daxa_Device>(this->object), r_cast<daxa_GarbageCollectInfo const *>(&info));
+        check_result(
+            result,
+            "failed to collect garbage incrementally", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_INCOMPLETE, DAXA_RESULT_NOT_READY});
+        return result == DAXA_RESULT_SUCCESS;
+    }
+
+    auto Device::memory_report() const -> MemoryReport
+    {
+        MemoryReport ret = {};
+        check_result(
+            daxa_dvc_memory_report(rc_cast<daxa_Device>(this->object), r_cast<daxa_MemoryReport *>(&ret)),
+            "failed to create memory report");
+        return ret;
+    }
+
+    auto Device::calibrated_timestamps() const -> CalibratedTimestamps
+    {
+        CalibratedTimestamps ret = {};
+        check_result(
+            daxa_dvc_calibrated_timestamps(rc_cast<daxa_Device>(this->object), r_cast<daxa_CalibratedTimestamps *>(&ret)),
+            "failed to calibrate timestamps");
+        return ret;
+    }
+
+    auto CalibratedTimestamps::device_ticks_to_host_ns(u64 ticks, f32 timestamp_period) const -> u64
+    {
+        // The difference is converted separately, absolute tick counts lose precision as doubles.
+        f64 const delta_ns = (static_cast<f64>(static_cast<i64>(ticks - this->device_ticks))) * static_cast<f64>(timestamp_period);
+        return this->host_ns + static_cast<u64>(static_cast<i64>(delta_ns));
+    }
+
+    auto CalibratedTimestamps::host_ns_to_device_ticks(u64 ns, f32 timestamp_period) const -> u64
+    {
+        f64 const delta_ticks = static_cast<f64>(static_cast<i64>(ns - this->host_ns)) / static_cast<f64>(timestamp_period);
+        return this->device_ticks + static_cast<u64>(static_cast<i64>(delta_ticks));
+    }
+
+    auto Device::begin_defragmentation_pass(DefragmentationPassInfo const & info) -> u32
+    {
+        daxa_DefragmentationPassInfo const c_info = {
+            .command_recorder = *r_cast<daxa_CommandRecorder const *>(&info.command_recorder),
+            .max_bytes_per_pass = info.max_bytes_per_pass,
+            .max_allocations_per_pass = info.max_allocations_per_pass,
+            .image_layout = static_cast<daxa_ImageLayout>(info.image_layout),
+        };
+        u32 ret = {};
+        check_result(
+            daxa_dvc_begin_defragmentation_pass(r_cast<daxa_Device>(this->object), &c_info, &ret),
+            "failed to begin defragmentation pass");
+        return ret;
+    }
+
+    auto Device::end_defragmentation_pass() -> bool
+    {
+        auto const result = daxa_dvc_end_defragmentation_pass(r_cast<daxa_Device>(this->object));
+        check_result(result, "failed to end defragmentation pass", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_INCOMPLETE});
+        return result == DAXA_RESULT_SUCCESS;
+    }
+
+    void Device::begin_capture(CaptureInfo const & info)
+    {
+        daxa_CaptureInfo const c_info = {
+            .path = info.path,
+            .capture_buffer_contents = static_cast<daxa_Bool8>(info.capture_buffer_contents),
+        };
+        check_result(daxa_dvc_begin_capture(r_cast<daxa_Device>(this->object), &c_info), "failed to begin capture");
+    }
+
+    void Device::end_capture()
+    {
+        check_result(daxa_dvc_end_capture(r_cast<daxa_Device>(this->object)), "failed to end capture");
+    }
+
+    auto Device::replay_capture(ReplayInfo const & info) -> ReplayStats
+    {
+        daxa_ReplayInfo const c_info = {
+            .path = info.path,
+            .repeat_count = info.repeat_count,
+        };
+        ReplayStats ret = {};
+        check_result(
+            daxa_dvc_replay_capture(r_cast<daxa_Device>(this->object), &c_info, r_cast<daxa_ReplayStats *>(&ret)),
+            "failed to replay capture");
+        return ret;
+    }
+
+    void Device::set_shader_debug_address(DeviceAddress address)
+    {
+        daxa_dvc_set_shader_debug_address(r_cast<daxa_Device>(this->object), static_cast<daxa_DeviceAddress>(address));
+    }
+
+    auto Device::shader_debug_address() const -> DeviceAddress
+    {
+        return static_cast<DeviceAddress>(daxa_dvc_shader_debug_address(rc_cast<daxa_Device>(this->object)));
+    }
+
     auto Device::properties() const -> DeviceProperties const &
     {
         return *r_cast<DeviceProperties const *>(daxa_dvc_properties(rc_cast<daxa_Device>(object)));
@@ -680,6 +1165,15 @@ namespace daxa
         return result == DAXA_RESULT_SUCCESS;
     }
 
+    auto TimelineSemaphore::export_handle() const -> u64
+    {
+        u64 ret = {};
+        check_result(
+            daxa_timeline_semaphore_export_handle(rc_cast<daxa_TimelineSemaphore>(this->object), &ret),
+            "failed to export timeline semaphore");
+        return ret;
+    }
+
     auto TimelineSemaphore::inc_refcnt(ImplHandle const * object) -> u64
     {
         return daxa_timeline_semaphore_inc_refcnt(rc_cast<daxa_TimelineSemaphore>(object));
@@ -758,6 +1252,79 @@ namespace daxa
 
     /// --- End TimelineQueryPool ---
 
+    /// --- Begin QueryPool ---
+
+    auto QueryPool::info() const -> QueryPoolInfo const &
+    {
+        return *r_cast<QueryPoolInfo const *>(daxa_query_pool_info(rc_cast<daxa_QueryPool>(this->object)));
+    }
+
+    auto QueryPool::get_query_results(u32 start_index, u32 count) -> std::vector<u64>
+    {
+        QueryPoolInfo const & pool_info = this->info();
+        u32 const value_count = pool_info.query_type == QueryType::PIPELINE_STATISTICS ? static_cast<u32>(std::popcount(pool_info.pipeline_statistics.data)) : 1u;
+        std::vector<u64> ret = {};
+        ret.resize(count * (value_count + 1));
+        check_result(
+            daxa_query_pool_query_results(rc_cast<daxa_QueryPool>(this->object), start_index, count, ret.data()),
+            "failed to query results of query pool", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_NOT_READY});
+        return ret;
+    }
+
+    auto QueryPool::inc_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_query_pool_inc_refcnt(rc_cast<daxa_QueryPool>(object));
+    }
+    auto QueryPool::dec_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_query_pool_dec_refcnt(rc_cast<daxa_QueryPool>(object));
+    }
+
+    /// --- End QueryPool ---
+
+    /// --- Begin Micromap ---
+
+    auto Micromap::info() const -> MicromapInfo const &
+    {
+        return *r_cast<MicromapInfo const *>(daxa_micromap_info(rc_cast<daxa_Micromap>(this->object)));
+    }
+
+    auto Micromap::buffer_id() const -> BufferId
+    {
+        return std::bit_cast<BufferId>(daxa_micromap_buffer_id(rc_cast<daxa_Micromap>(this->object)));
+    }
+
+    auto Micromap::inc_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_micromap_inc_refcnt(rc_cast<daxa_Micromap>(object));
+    }
+
+    auto Micromap::dec_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_micromap_dec_refcnt(rc_cast<daxa_Micromap>(object));
+    }
+
+    /// --- End Micromap ---
+
+    /// --- Begin VideoSession ---
+
+    auto VideoSession::info() const -> VideoSessionInfo const &
+    {
+        return *r_cast<VideoSessionInfo const *>(daxa_video_session_info(rc_cast<daxa_VideoSession>(this->object)));
+    }
+
+    auto VideoSession::inc_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_video_session_inc_refcnt(rc_cast<daxa_VideoSession>(object));
+    }
+
+    auto VideoSession::dec_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_video_session_dec_refcnt(rc_cast<daxa_VideoSession>(object));
+    }
+
+    /// --- End VideoSession ---
+
     /// --- Begin Swapchain ---
 
     void Swapchain::resize()
@@ -774,6 +1341,13 @@ namespace daxa
             "failed to set swapchain present mode");
     }
 
+    void Swapchain::wait_for_frame_start()
+    {
+        check_result(
+            daxa_swp_wait_for_frame_start(r_cast<daxa_Swapchain>(this->object)),
+            "failed to wait for frame start", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_ERROR_OUT_OF_DATE_KHR, DAXA_RESULT_ERROR_SURFACE_LOST_KHR});
+    }
+
     auto Swapchain::acquire_next_image() -> ImageId
     {
         ImageId ret = {};
@@ -822,6 +1396,12 @@ namespace daxa
         return std::pair{gpu_value, cpu_value};
     }
 
+    auto Swapchain::frame_statistics() const -> std::span<SwapchainFrameStatistics const, SWAPCHAIN_FRAME_STATISTICS_COUNT>
+    {
+        auto const * statistics = r_cast<SwapchainFrameStatistics const *>(daxa_swp_frame_statistics(rc_cast<daxa_Swapchain>(this->object)));
+        return std::span<SwapchainFrameStatistics const, SWAPCHAIN_FRAME_STATISTICS_COUNT>{statistics, SWAPCHAIN_FRAME_STATISTICS_COUNT};
+    }
+
     auto Swapchain::info() const -> SwapchainInfo const &
     {
         return *r_cast<SwapchainInfo const *>(daxa_swp_info(rc_cast<daxa_Swapchain>(this->object)));
@@ -889,6 +1469,16 @@ namespace daxa
         return *r_cast<ComputePipelineInfo const *>(rc_cast<daxa_ComputePipeline>(this->object));
     }
 
+    auto ComputePipeline::status() const -> PipelineStatus
+    {
+        return static_cast<PipelineStatus>(daxa_compute_pipeline_status(rc_cast<daxa_ComputePipeline>(this->object)));
+    }
+
+    void ComputePipeline::wait() const
+    {
+        check_result(daxa_compute_pipeline_wait(rc_cast<daxa_ComputePipeline>(this->object)), "failed to compile compute pipeline");
+    }
+
     auto ComputePipeline::inc_refcnt(ImplHandle const * object) -> u64
     {
         return daxa_compute_pipeline_inc_refcnt(rc_cast<daxa_ComputePipeline>(object));
@@ -904,6 +1494,16 @@ namespace daxa
         return *r_cast<RasterPipelineInfo const *>(rc_cast<daxa_RasterPipeline>(this->object));
     }
 
+    auto RasterPipeline::status() const -> PipelineStatus
+    {
+        return static_cast<PipelineStatus>(daxa_raster_pipeline_status(rc_cast<daxa_RasterPipeline>(this->object)));
+    }
+
+    void RasterPipeline::wait() const
+    {
+        check_result(daxa_raster_pipeline_wait(rc_cast<daxa_RasterPipeline>(this->object)), "failed to compile raster pipeline");
+    }
+
     auto RasterPipeline::inc_refcnt(ImplHandle const * object) -> u64
     {
         return daxa_raster_pipeline_inc_refcnt(rc_cast<daxa_RasterPipeline>(object));
@@ -914,6 +1514,71 @@ namespace daxa
         return daxa_raster_pipeline_dec_refcnt(rc_cast<daxa_RasterPipeline>(object));
     }
 
+    auto IndirectCommandsLayout::info() const -> IndirectCommandsLayoutInfo const &
+    {
+        return *r_cast<IndirectCommandsLayoutInfo const *>(daxa_indirect_commands_layout_info(rc_cast<daxa_IndirectCommandsLayout>(this->object)));
+    }
+
+    auto IndirectCommandsLayout::inc_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_indirect_commands_layout_inc_refcnt(rc_cast<daxa_IndirectCommandsLayout>(object));
+    }
+
+    auto IndirectCommandsLayout::dec_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_indirect_commands_layout_dec_refcnt(rc_cast<daxa_IndirectCommandsLayout>(object));
+    }
+
+    auto IndirectExecutionSet::info() const -> IndirectExecutionSetInfo const &
+    {
+        return *r_cast<IndirectExecutionSetInfo const *>(daxa_indirect_execution_set_info(rc_cast<daxa_IndirectExecutionSet>(this->object)));
+    }
+
+    void IndirectExecutionSet::write_pipeline(u32 index, ComputePipeline const & pipeline)
+    {
+        check_result(
+            daxa_indirect_execution_set_write_compute_pipeline(
+                rc_cast<daxa_IndirectExecutionSet>(this->object),
+                index,
+                *r_cast<daxa_ComputePipeline const *>(&pipeline)),
+            "failed to write compute pipeline into indirect execution set");
+    }
+
+    void IndirectExecutionSet::write_pipeline(u32 index, RasterPipeline const & pipeline)
+    {
+        check_result(
+            daxa_indirect_execution_set_write_raster_pipeline(
+                rc_cast<daxa_IndirectExecutionSet>(this->object),
+                index,
+                *r_cast<daxa_RasterPipeline const *>(&pipeline)),
+            "failed to write raster pipeline into indirect execution set");
+    }
+
+    auto IndirectExecutionSet::inc_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_indirect_execution_set_inc_refcnt(rc_cast<daxa_IndirectExecutionSet>(object));
+    }
+
+    auto IndirectExecutionSet::dec_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_indirect_execution_set_dec_refcnt(rc_cast<daxa_IndirectExecutionSet>(object));
+    }
+
+    auto ShaderObject::info() const -> ShaderObjectInfo const &
+    {
+        return *r_cast<ShaderObjectInfo const *>(daxa_shader_object_info(rc_cast<daxa_ShaderObject>(this->object)));
+    }
+
+    auto ShaderObject::inc_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_shader_object_inc_refcnt(rc_cast<daxa_ShaderObject>(object));
+    }
+
+    auto ShaderObject::dec_refcnt(ImplHandle const * object) -> u64
+    {
+        return daxa_shader_object_dec_refcnt(rc_cast<daxa_ShaderObject>(object));
+    }
+
     /// --- End Pipelines
 
     /// --- Begin ExecutableCommandList
@@ -982,6 +1647,26 @@ namespace daxa
         return ret;
     }
 
+    auto RenderCommandRecorder::create_secondary_recorder(CommandRecorderInfo const & info) -> SecondaryRenderCommandRecorder
+    {
+        SecondaryRenderCommandRecorder ret = {};
+        auto result = daxa_cmd_create_secondary_command_recorder(
+            this->internal,
+            r_cast<daxa_CommandRecorderInfo const *>(&info),
+            &ret.internal);
+        check_result(result, "failed to create secondary command recorder");
+        return ret;
+    }
+
+    void RenderCommandRecorder::execute_commands(std::span<ExecutableCommandList const> executable_commands)
+    {
+        auto result = daxa_cmd_execute_commands(
+            this->internal,
+            r_cast<daxa_ExecutableCommandList const *>(executable_commands.data()),
+            executable_commands.size());
+        check_result(result, "failed to execute commands");
+    }
+
     void RenderCommandRecorder::set_viewport(ViewportInfo const & info)
     {
         daxa_cmd_set_viewport(
@@ -1006,7 +1691,10 @@ namespace daxa
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER_CHECK_RESULT(set_index_buffer, SetIndexBufferInfo)
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER(draw, DrawInfo)
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER(draw_indexed, DrawIndexedInfo)
+    DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER(draw_multi, DrawMultiInfo)
+    DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER(draw_multi_indexed, DrawMultiIndexedInfo)
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER_CHECK_RESULT(draw_indirect, DrawIndirectInfo)
+    DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER_CHECK_RESULT(execute_generated_commands, ExecuteGeneratedCommandsInfo)
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER_CHECK_RESULT(draw_indirect_count, DrawIndirectCountInfo)
 
     void RenderCommandRecorder::draw_mesh_tasks(u32 x, u32 y, u32 z)
@@ -1025,6 +1713,14 @@ namespace daxa
             *r_cast<daxa_RasterPipeline const *>(&pipeline));
     }
 
+    void RenderCommandRecorder::set_shader_objects(SetRasterShaderObjectsInfo const & info)
+    {
+        auto result = daxa_cmd_set_raster_shader_objects(
+            this->internal,
+            r_cast<daxa_SetRasterShaderObjectsInfo const *>(&info));
+        check_result(result, "failed in set_shader_objects");
+    }
+
     void RenderCommandRecorder::push_constant_vptr(PushConstantInfo const & info)
     {
         auto c_info = std::bit_cast<daxa_PushConstantInfo>(info);
@@ -1033,6 +1729,33 @@ namespace daxa
         check_result(result, "failed in push_constant_vptr");
     }
 
+    void RenderCommandRecorder::push_constant_range(std::span<PushConstantInfo const> fields)
+    {
+        auto result = daxa_cmd_push_constant_range(
+            this->internal,
+            r_cast<daxa_PushConstantInfo const *>(fields.data()),
+            fields.size());
+        check_result(result, "failed in push_constant_range");
+    }
+
+    auto SecondaryRenderCommandRecorder::complete_current_commands() -> ExecutableCommandList
+    {
+        ExecutableCommandList ret = {};
+        auto result = daxa_cmd_complete_current_commands(this->internal, r_cast<daxa_ExecutableCommandList *>(&ret));
+        check_result(result, "failed to complete current commands");
+        return ret;
+    }
+
+    auto RenderCommandRecorder::stats() const -> CommandRecorderStats const &
+    {
+        return *r_cast<CommandRecorderStats const *>(daxa_cmd_stats(this->internal));
+    }
+
+    auto SecondaryRenderCommandRecorder::info() const -> CommandRecorderInfo const &
+    {
+        return *r_cast<CommandRecorderInfo const *>(daxa_cmd_info(this->internal));
+    }
+
     /// --- End RenderCommandBuffer
 
     /// --- Begin CommandRecorder ---
@@ -1067,8 +1790,12 @@ namespace daxa
             r_cast<daxa_BuildAccelerationStucturesInfo const *>(&info));
         check_result(result, "failed to build acceleration structures");
     }
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, write_blas_compacted_sizes, WriteBlasCompactedSizesInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, copy_acceleration_structure, CopyAccelerationStructureInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, build_micromaps, BuildMicromapsInfo)
     DAXA_DECL_COMMAND_LIST_WRAPPER(TransferCommandRecorder, pipeline_barrier, MemoryBarrierInfo)
     DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(TransferCommandRecorder, pipeline_barrier_image_transition, ImageMemoryBarrierInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(TransferCommandRecorder, pipeline_barriers, PipelineBarriersInfo)
     DAXA_DECL_COMMAND_LIST_WRAPPER(TransferCommandRecorder, signal_event, EventSignalInfo)
 
     void TransferCommandRecorder::wait_events(std::span<EventWaitInfo const> const & infos)
@@ -1101,6 +1828,15 @@ namespace daxa
         check_result(result, "failed in push_constant_vptr");
     }
 
+    void ComputeCommandRecorder::push_constant_range(std::span<PushConstantInfo const> fields)
+    {
+        auto result = daxa_cmd_push_constant_range(
+            this->internal,
+            r_cast<daxa_PushConstantInfo const *>(fields.data()),
+            fields.size());
+        check_result(result, "failed in push_constant_range");
+    }
+
     void ComputeCommandRecorder::set_pipeline(ComputePipeline const & pipeline)
     {
         daxa_cmd_set_compute_pipeline(
@@ -1108,6 +1844,14 @@ namespace daxa
             *r_cast<daxa_ComputePipeline const *>(&pipeline));
     }
 
+    void ComputeCommandRecorder::set_shader_object(ShaderObject const & shader_object)
+    {
+        auto result = daxa_cmd_set_compute_shader_object(
+            this->internal,
+            *r_cast<daxa_ShaderObject const *>(&shader_object));
+        check_result(result, "failed in set_shader_object");
+    }
+
     void ComputeCommandRecorder::dispatch(DispatchInfo const & info)
     {
         auto result = daxa_cmd_dispatch(
@@ -1117,6 +1861,7 @@ namespace daxa
     }
 
     DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, dispatch_indirect, DispatchIndirectInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, execute_generated_commands, ExecuteGeneratedCommandsInfo)
     DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, trace_rays, TraceRaysInfo)
     DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, trace_rays_indirect, TraceRaysIndirectInfo)
 
@@ -1140,6 +1885,7 @@ namespace daxa
     }
     DAXA_DECL_COMMAND_LIST_WRAPPER(TransferCommandRecorder, write_timestamp, WriteTimestampInfo)
     DAXA_DECL_COMMAND_LIST_WRAPPER(TransferCommandRecorder, reset_timestamps, ResetTimestampsInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(TransferCommandRecorder, copy_timestamps_to_buffer, CopyTimestampsToBufferInfo)
     DAXA_DECL_COMMAND_LIST_WRAPPER(TransferCommandRecorder, begin_label, CommandLabelInfo)
 
     void TransferCommandRecorder::end_label()
@@ -1147,6 +1893,38 @@ namespace daxa
         daxa_cmd_end_label(this->internal);
     }
 
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(TransferCommandRecorder, begin_video_coding, BeginVideoCodingInfo)
+
+    void TransferCommandRecorder::end_video_coding()
+    {
+        auto result = daxa_cmd_end_video_coding(this->internal);
+        check_result(result, "failed in end_video_coding");
+    }
+
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(TransferCommandRecorder, control_video_coding, VideoCodingControlInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(TransferCommandRecorder, decode_video, VideoDecodeInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(TransferCommandRecorder, encode_video, VideoEncodeInfo)
+
+    void TransferCommandRecorder::set_device_mask(u32 device_mask)
+    {
+        auto result = daxa_cmd_set_device_mask(this->internal, device_mask);
+        check_result(result, "failed in set_device_mask");
+    }
+
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, begin_conditional_rendering, ConditionalRenderingInfo)
+
+    void ComputeCommandRecorder::end_conditional_rendering()
+    {
+        auto result = daxa_cmd_end_conditional_rendering(this->internal);
+        check_result(result, "failed in end_conditional_rendering");
+    }
+
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, decompress_memory, DecompressMemoryInfo)
+
+    DAXA_DECL_COMMAND_LIST_WRAPPER_CHECK_RESULT(ComputeCommandRecorder, begin_query, BeginQueryInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER(ComputeCommandRecorder, end_query, EndQueryInfo)
+    DAXA_DECL_COMMAND_LIST_WRAPPER(ComputeCommandRecorder, reset_queries, ResetQueriesInfo)
+
     auto TransferCommandRecorder::complete_current_commands() -> ExecutableCommandList
     {
         ExecutableCommandList ret = {};
@@ -1160,6 +1938,11 @@ namespace daxa
         return *r_cast<CommandRecorderInfo const *>(daxa_cmd_info(*rc_cast<daxa_CommandRecorder *>(this)));
     }
 
+    auto TransferCommandRecorder::stats() const -> CommandRecorderStats const &
+    {
+        return *r_cast<CommandRecorderStats const *>(daxa_cmd_stats(*rc_cast<daxa_CommandRecorder *>(this)));
+    }
+
     TransferCommandRecorder::~TransferCommandRecorder()
     {
         if (this->internal != nullptr)
@@ -1243,6 +2026,10 @@ namespace daxa
         case ImageLayout::READ_ONLY_OPTIMAL: return "READ_ONLY_OPTIMAL";
         case ImageLayout::ATTACHMENT_OPTIMAL: return "ATTACHMENT_OPTIMAL";
         case ImageLayout::PRESENT_SRC: return "PRESENT_SRC";
+        case ImageLayout::VIDEO_DECODE_DST: return "VIDEO_DECODE_DST";
+        case ImageLayout::VIDEO_DECODE_DPB: return "VIDEO_DECODE_DPB";
+        case ImageLayout::VIDEO_ENCODE_SRC: return "VIDEO_ENCODE_SRC";
+        case ImageLayout::VIDEO_ENCODE_DPB: return "VIDEO_ENCODE_DPB";
         default: DAXA_DBG_ASSERT_TRUE_M(false, "invalid ImageLayout");
         }
         return "invalid ImageLayout";
@@ -1337,6 +2124,54 @@ namespace daxa
             }
             ret += "FRAGMENT_SHADING_RATE_ATTACHMENT";
         }
+        if ((flags & ImageUsageFlagBits::VIDEO_DECODE_DST) != ImageUsageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_DECODE_DST";
+        }
+        if ((flags & ImageUsageFlagBits::VIDEO_DECODE_SRC) != ImageUsageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_DECODE_SRC";
+        }
+        if ((flags & ImageUsageFlagBits::VIDEO_DECODE_DPB) != ImageUsageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_DECODE_DPB";
+        }
+        if ((flags & ImageUsageFlagBits::VIDEO_ENCODE_DST) != ImageUsageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_ENCODE_DST";
+        }
+        if ((flags & ImageUsageFlagBits::VIDEO_ENCODE_SRC) != ImageUsageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_ENCODE_SRC";
+        }
+        if ((flags & ImageUsageFlagBits::VIDEO_ENCODE_DPB) != ImageUsageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_ENCODE_DPB";
+        }
         return ret;
     }
 
@@ -1736,6 +2571,38 @@ namespace daxa
             }
             ret += "RAY_TRACING_SHADER";
         }
+        if ((flags & PipelineStageFlagBits::CONDITIONAL_RENDERING) != PipelineStageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "CONDITIONAL_RENDERING";
+        }
+        if ((flags & PipelineStageFlagBits::MICROMAP_BUILD) != PipelineStageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "MICROMAP_BUILD";
+        }
+        if ((flags & PipelineStageFlagBits::VIDEO_DECODE) != PipelineStageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_DECODE";
+        }
+        if ((flags & PipelineStageFlagBits::VIDEO_ENCODE) != PipelineStageFlagBits::NONE)
+        {
+            if (!ret.empty())
+            {
+                ret += " | ";
+            }
+            ret += "VIDEO_ENCODE";
+        }
         if ((flags & PipelineStageFlagBits::TRANSFER) != PipelineStageFlagBits::NONE)
         {
             if (!ret.empty())
@@ -1839,6 +2706,8 @@ namespace daxa
         case QueueFamily::MAIN: return "MAIN";
         case QueueFamily::COMPUTE: return "COMPUTE";
         case QueueFamily::TRANSFER: return "TRANSFER";
+        case QueueFamily::VIDEO_DECODE: return "VIDEO_DECODE";
+        case QueueFamily::VIDEO_ENCODE: return "VIDEO_ENCODE";
         };
     }
 
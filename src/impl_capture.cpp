@@ -0,0 +1,1775 @@
+#include "impl_capture.hpp"
+
+#include "impl_device.hpp"
+#include "impl_pipeline.hpp"
+#include "impl_command_recorder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <unordered_set>
+
+namespace
+{
+    struct CaptureBufferRecord
+    {
+        daxa_BufferId id = {};
+        // Address of the buffer while it was captured, replays translate it to the address of the recreated buffer.
+        u64 device_address = {};
+        daxa_BufferInfo info = {};
+    };
+
+    struct CaptureImageRecord
+    {
+        daxa_ImageId id = {};
+        daxa_ImageInfo info = {};
+    };
+
+    struct CaptureImageViewRecord
+    {
+        daxa_ImageViewId id = {};
+        daxa_ImageViewInfo info = {};
+    };
+
+    struct CaptureSamplerRecord
+    {
+        daxa_SamplerId id = {};
+        daxa_SamplerInfo info = {};
+    };
+
+    // Followed by size bytes.
+    struct CaptureBufferContentsRecord
+    {
+        daxa_BufferId id = {};
+        u64 offset = {};
+        u64 size = {};
+    };
+
+    // Followed by the create info and the spirv, see capture_pipeline_record.
+    struct CapturePipelineRecord
+    {
+        u64 index = {};
+    };
+
+    // Followed by the captured commands.
+    struct CaptureCommandListRecord
+    {
+        u64 index = {};
+        daxa_CommandRecorderInfo info = {};
+    };
+
+    // Followed by command_list_count command list indices, CAPTURE_MISSING_INDEX for lists that were not captured.
+    struct CaptureSubmitRecord
+    {
+        daxa_Queue queue = {};
+        u32 device_mask = {};
+        u64 command_list_count = {};
+    };
+
+    // Device local buffers are read back through a staging buffer of this size at the start of a capture.
+    static inline constexpr u64 CAPTURE_READBACK_STAGING_SIZE = 1ull << 26;
+
+    auto write_capture_record(std::ofstream & file, CaptureRecordType type, std::initializer_list<std::span<std::byte const>> parts) -> bool
+    {
+        CaptureRecordHeader header = {.type = type};
+        for (auto const & part : parts)
+        {
+            header.size += part.size();
+        }
+        file.write(r_cast<char const *>(&header), sizeof(header));
+        for (auto const & part : parts)
+        {
+            file.write(r_cast<char const *>(part.data()), static_cast<std::streamsize>(part.size()));
+        }
+        return static_cast<bool>(file);
+    }
+
+    void append_capture_shader(std::vector<std::byte> & record, daxa_ShaderInfo const & shader)
+    {
+        u64 const word_count = shader.byte_code_size;
+        append_captured_bytes(record, capture_bytes(word_count));
+        append_captured_bytes(record, std::as_bytes(std::span{shader.byte_code, shader.byte_code_size}));
+        u64 const constant_count = shader.specialization_constants.size;
+        append_captured_bytes(record, capture_bytes(constant_count));
+        append_captured_bytes(record, std::as_bytes(std::span{shader.specialization_constants.data, shader.specialization_constants.size}));
+    }
+
+    // The optional shaders of a raster pipeline, in the order their spirv is stored in capture records.
+    template <typename InfoT, typename FnT>
+    void for_each_raster_shader(InfoT & info, FnT && fn)
+    {
+        fn(info.mesh_shader_info);
+        fn(info.vertex_shader_info);
+        fn(info.tesselation_control_shader_info);
+        fn(info.tesselation_evaluation_shader_info);
+        fn(info.fragment_shader_info);
+        fn(info.task_shader_info);
+    }
+
+    // FNV-1a over 8 byte words. Only compared against earlier hashes of the same page, a changed word always changes the hash.
+    auto capture_page_hash(std::span<std::byte const> page) -> u64
+    {
+        u64 hash = 0xcbf29ce484222325ull;
+        usize i = 0;
+        for (; i + sizeof(u64) <= page.size(); i += sizeof(u64))
+        {
+            u64 word = {};
+            std::memcpy(&word, page.data() + i, sizeof(u64));
+            hash = (hash ^ word) * 0x100000001b3ull;
+        }
+        for (; i < page.size(); ++i)
+        {
+            hash = (hash ^ static_cast<u64>(page[i])) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // Indices of zombie slots. Zombies keep their slot data until they are collected, captures must skip them.
+    struct CaptureZombieIndices
+    {
+        std::unordered_set<u64> buffers = {};
+        std::unordered_set<u64> images = {};
+        std::unordered_set<u64> samplers = {};
+    };
+
+    auto capture_zombie_indices(daxa_Device self) -> CaptureZombieIndices
+    {
+        CaptureZombieIndices ret = {};
+        std::unique_lock const lock{self->zombies_mtx};
+        for (auto const & [timeline_value, id] : self->buffer_zombies)
+        {
+            ret.buffers.insert(id.index);
+        }
+        for (auto const & [timeline_value, id] : self->image_zombies)
+        {
+            ret.images.insert(id.index);
+        }
+        for (auto const & [timeline_value, id] : self->image_view_zombies)
+        {
+            ret.images.insert(id.index);
+        }
+        for (auto const & [timeline_value, id] : self->sampler_zombies)
+        {
+            ret.samplers.insert(id.index);
+        }
+        return ret;
+    }
+
+    // The lifetime lock must be held, so that no zombie slot is cleared while it is read.
+    template <typename PoolT, typename FnT>
+    void for_each_captured_slot(PoolT const & pool, std::unordered_set<u64> const & zombie_indices, FnT && fn)
+    {
+        u32 const count = pool.allocated_count();
+        for (u32 index = 0; index < count; ++index)
+        {
+            if ((static_cast<usize>(index) >> PoolT::PAGE_BITS) >= pool.valid_page_count.load(std::memory_order_relaxed) || zombie_indices.contains(index))
+            {
+                continue;
+            }
+            GPUResourceId const id = pool.slot_id(index);
+            fn(id, pool.unsafe_get(id));
+        }
+    }
+
+    void capture_buffer_record(CaptureState & state, daxa_BufferId id, ImplBufferSlot const & slot)
+    {
+        CaptureBufferRecord const record = {.id = id, .device_address = slot.device_address, .info = slot.info};
+        state.write_failed |= !write_capture_record(state.file, CaptureRecordType::CREATE_BUFFER, {capture_bytes(record)});
+    }
+
+    void capture_image_record(CaptureState & state, daxa_ImageId id, ImplImageSlot const & slot)
+    {
+        CaptureImageRecord const record = {.id = id, .info = slot.info};
+        state.write_failed |= !write_capture_record(state.file, CaptureRecordType::CREATE_IMAGE, {capture_bytes(record)});
+    }
+
+    void capture_image_view_record(CaptureState & state, daxa_ImageViewId id, ImplImageViewSlot const & slot)
+    {
+        CaptureImageViewRecord const record = {.id = id, .info = slot.info};
+        state.write_failed |= !write_capture_record(state.file, CaptureRecordType::CREATE_IMAGE_VIEW, {capture_bytes(record)});
+    }
+
+    void capture_sampler_record(CaptureState & state, daxa_SamplerId id, ImplSamplerSlot const & slot)
+    {
+        CaptureSamplerRecord const record = {.id = id, .info = slot.info};
+        state.write_failed |= !write_capture_record(state.file, CaptureRecordType::CREATE_SAMPLER, {capture_bytes(record)});
+    }
+
+    // Writes the pages of a host visible buffer that changed since their hashes were taken, adjacent changed pages form one record.
+    void capture_changed_buffer_pages(CaptureState & state, daxa_BufferId id, std::byte const * host_address, u64 size, std::vector<u64> & page_hashes)
+    {
+        usize const page_count = static_cast<usize>((size + CAPTURE_CONTENT_PAGE_SIZE - 1) / CAPTURE_CONTENT_PAGE_SIZE);
+        bool const first_capture = page_hashes.size() != page_count;
+        if (first_capture)
+        {
+            page_hashes.assign(page_count, 0);
+        }
+        auto write_pages = [&](usize first_page, usize end_page)
+        {
+            u64 const offset = first_page * CAPTURE_CONTENT_PAGE_SIZE;
+            u64 const end = std::min(static_cast<u64>(end_page * CAPTURE_CONTENT_PAGE_SIZE), size);
+            CaptureBufferContentsRecord const record = {.id = id, .offset = offset, .size = end - offset};
+            state.write_failed |= !write_capture_record(
+                state.file, CaptureRecordType::BUFFER_CONTENTS,
+                {capture_bytes(record), std::span{host_address + offset, static_cast<usize>(end - offset)}});
+        };
+        std::optional<usize> run_begin = {};
+        for (usize page = 0; page < page_count; ++page)
+        {
+            u64 const offset = page * CAPTURE_CONTENT_PAGE_SIZE;
+            u64 const page_size = std::min(static_cast<u64>(CAPTURE_CONTENT_PAGE_SIZE), size - offset);
+            u64 const hash = capture_page_hash(std::span{host_address + offset, static_cast<usize>(page_size)});
+            bool const changed = first_capture || hash != page_hashes[page];
+            page_hashes[page] = hash;
+            if (changed && !run_begin.has_value())
+            {
+                run_begin = page;
+            }
+            if (!changed && run_begin.has_value())
+            {
+                write_pages(run_begin.value(), page);
+                run_begin.reset();
+            }
+        }
+        if (run_begin.has_value())
+        {
+            write_pages(run_begin.value(), page_count);
+        }
+    }
+
+    // Compares all host visible buffers against their last captured contents. Buffers missing in the hashes are written whole.
+    // Hashes of buffers that are no longer alive are dropped.
+    void capture_host_visible_buffer_contents(daxa_Device self, std::unordered_set<u64> const & zombie_buffer_indices)
+    {
+        CaptureState & state = self->capture;
+        std::unordered_map<u64, std::vector<u64>> page_hashes = {};
+        for_each_captured_slot(
+            self->gpu_sro_table.buffer_slots, zombie_buffer_indices,
+            [&](GPUResourceId id, ImplBufferSlot const & slot)
+            {
+                if (slot.vk_buffer == VK_NULL_HANDLE || slot.host_address == nullptr)
+                {
+                    return;
+                }
+                auto const buffer_id = std::bit_cast<daxa_BufferId>(id);
+                auto & hashes = page_hashes[buffer_id.value];
+                if (auto old_hashes = state.content_page_hashes.find(buffer_id.value); old_hashes != state.content_page_hashes.end())
+                {
+                    hashes = std::move(old_hashes->second);
+                }
+                capture_changed_buffer_pages(state, buffer_id, r_cast<std::byte const *>(slot.host_address), slot.info.size, hashes);
+            });
+        state.content_page_hashes = std::move(page_hashes);
+    }
+
+    // Copies all device local buffers into a host visible staging buffer, batch by batch, and writes their contents.
+    // Runs before the capture is active, so neither the staging buffer nor the copies are captured.
+    auto capture_device_local_buffer_contents(daxa_Device self, std::ofstream & file) -> daxa_Result
+    {
+        std::vector<std::pair<daxa_BufferId, u64>> buffers = {};
+        {
+            std::shared_lock const lifetime_lock{self->gpu_sro_table.lifetime_lock};
+            auto const zombies = capture_zombie_indices(self);
+            for_each_captured_slot(
+                self->gpu_sro_table.buffer_slots, zombies.buffers,
+                [&](GPUResourceId id, ImplBufferSlot const & slot)
+                {
+                    if (slot.vk_buffer != VK_NULL_HANDLE && slot.host_address == nullptr && slot.info.size > 0)
+                    {
+                        buffers.push_back({std::bit_cast<daxa_BufferId>(id), slot.info.size});
+                    }
+                });
+        }
+        if (buffers.empty())
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+
+        u64 total_size = 0;
+        for (auto const & [id, size] : buffers)
+        {
+            total_size += size;
+        }
+        daxa_BufferInfo const staging_info = {
+            .size = std::min(total_size, CAPTURE_READBACK_STAGING_SIZE),
+            .allocate_info = DAXA_MEMORY_FLAG_HOST_ACCESS_RANDOM,
+            .name = std::bit_cast<daxa_SmallString>(SmallString{"capture readback staging"}),
+        };
+        daxa_BufferId staging_buffer = {};
+        auto result = daxa_dvc_create_buffer(self, &staging_info, &staging_buffer);
+        _DAXA_RETURN_IF_ERROR(result, result)
+        daxa_CommandRecorder recorder = {};
+        daxa_CommandRecorderInfo const recorder_info = {.queue_family = DAXA_QUEUE_FAMILY_MAIN};
+        result = daxa_dvc_create_command_recorder(self, &recorder_info, &recorder);
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_buffer(self, staging_buffer);
+            return result;
+        }
+        defer
+        {
+            daxa_destroy_command_recorder(recorder);
+            [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_buffer(self, staging_buffer);
+        };
+        auto const * staging_host_address = r_cast<std::byte const *>(self->slot(staging_buffer).host_address);
+
+        struct Piece
+        {
+            daxa_BufferId id = {};
+            u64 offset = {};
+            u64 size = {};
+            u64 staging_offset = {};
+        };
+        std::vector<Piece> pieces = {};
+        u64 staging_offset = 0;
+        auto read_back_pieces = [&]() -> daxa_Result
+        {
+            if (pieces.empty())
+            {
+                return DAXA_RESULT_SUCCESS;
+            }
+            daxa_MemoryBarrierInfo const barrier = {.src_access = DAXA_ACCESS_TRANSFER_WRITE, .dst_access = DAXA_ACCESS_HOST_READ};
+            daxa_cmd_pipeline_barrier(recorder, &barrier);
+            daxa_ExecutableCommandList commands = {};
+            auto piece_result = daxa_cmd_complete_current_commands(recorder, &commands);
+            _DAXA_RETURN_IF_ERROR(piece_result, piece_result)
+            daxa_CommandSubmitInfo submit_info = DAXA_DEFAULT_COMMAND_SUBMIT_INFO;
+            submit_info.queue = DAXA_QUEUE_MAIN;
+            submit_info.command_lists = &commands;
+            submit_info.command_list_count = 1;
+            piece_result = daxa_dvc_submit(self, &submit_info);
+            if (piece_result == DAXA_RESULT_SUCCESS)
+            {
+                piece_result = daxa_dvc_queue_wait_idle(self, DAXA_QUEUE_MAIN);
+            }
+            daxa_executable_commands_dec_refcnt(commands);
+            _DAXA_RETURN_IF_ERROR(piece_result, piece_result)
+            for (auto const & piece : pieces)
+            {
+                CaptureBufferContentsRecord const record = {.id = piece.id, .offset = piece.offset, .size = piece.size};
+                if (!write_capture_record(file, CaptureRecordType::BUFFER_CONTENTS, {capture_bytes(record), std::span{staging_host_address + piece.staging_offset, static_cast<usize>(piece.size)}}))
+                {
+                    return DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID;
+                }
+            }
+            pieces.clear();
+            staging_offset = 0;
+            return DAXA_RESULT_SUCCESS;
+        };
+        for (auto const & [id, size] : buffers)
+        {
+            for (u64 offset = 0; offset < size;)
+            {
+                if (staging_offset == staging_info.size)
+                {
+                    result = read_back_pieces();
+                    _DAXA_RETURN_IF_ERROR(result, result)
+                }
+                u64 const piece_size = std::min(size - offset, staging_info.size - staging_offset);
+                daxa_BufferCopyInfo const copy_info = {
+                    .src_buffer = id,
+                    .dst_buffer = staging_buffer,
+                    .src_offset = offset,
+                    .dst_offset = staging_offset,
+                    .size = piece_size,
+                };
+                // Buffers destroyed by other threads in the meantime fail the copy and are left out.
+                if (daxa_cmd_copy_buffer_to_buffer(recorder, &copy_info) != DAXA_RESULT_SUCCESS)
+                {
+                    break;
+                }
+                pieces.push_back({.id = id, .offset = offset, .size = piece_size, .staging_offset = staging_offset});
+                offset += piece_size;
+                staging_offset += piece_size;
+            }
+        }
+        return read_back_pieces();
+    }
+
+    auto read_capture_file(char const * path) -> std::vector<std::byte>
+    {
+        std::ifstream file{path, std::ios::binary | std::ios::ate};
+        if (!file.is_open())
+        {
+            return {};
+        }
+        auto const size = static_cast<usize>(file.tellg());
+        std::vector<std::byte> data(size);
+        file.seekg(0);
+        file.read(r_cast<char *>(data.data()), static_cast<std::streamsize>(size));
+        if (!file)
+        {
+            return {};
+        }
+        return data;
+    }
+
+    struct CaptureReader
+    {
+        std::span<std::byte const> bytes = {};
+        usize offset = {};
+
+        template <typename T>
+        auto read(T & out) -> bool
+        {
+            if (this->bytes.size() - this->offset < sizeof(T))
+            {
+                return false;
+            }
+            std::memcpy(&out, this->bytes.data() + this->offset, sizeof(T));
+            this->offset += sizeof(T);
+            return true;
+        }
+
+        auto read_bytes(u64 size) -> std::optional<std::span<std::byte const>>
+        {
+            if (this->bytes.size() - this->offset < size)
+            {
+                return std::nullopt;
+            }
+            auto const ret = this->bytes.subspan(this->offset, static_cast<usize>(size));
+            this->offset += static_cast<usize>(size);
+            return ret;
+        }
+
+        auto rest() const -> std::span<std::byte const>
+        {
+            return this->bytes.subspan(this->offset);
+        }
+
+        auto at_end() const -> bool
+        {
+            return this->offset == this->bytes.size();
+        }
+    };
+
+    struct ReplayContents
+    {
+        daxa_BufferId id = {};
+        u64 offset = {};
+        std::span<std::byte const> bytes = {};
+    };
+
+    struct ReplayPipeline
+    {
+        CaptureRecordType type = {};
+        std::span<std::byte const> record = {};
+    };
+
+    struct ReplayCommandList
+    {
+        daxa_CommandRecorderInfo info = {};
+        std::span<std::byte const> commands = {};
+    };
+
+    struct ReplayStep
+    {
+        // Host writes the application made before the submit.
+        std::vector<ReplayContents> contents = {};
+        daxa_Queue queue = {};
+        u32 device_mask = {};
+        std::vector<u64> command_lists = {};
+    };
+
+    // Parsed capture, referencing the bytes of the file.
+    struct ReplayCapture
+    {
+        // Keyed by the slot index. Images and image views share the slots of the image pool.
+        std::map<u32, CaptureBufferRecord> buffers = {};
+        std::map<u32, CaptureImageRecord> images = {};
+        std::map<u32, CaptureImageViewRecord> image_views = {};
+        std::map<u32, CaptureSamplerRecord> samplers = {};
+        // Resources reusing the slot of an earlier captured resource. Only the earlier one can be recreated.
+        u32 conflicting_resource_count = {};
+        std::vector<ReplayContents> initial_contents = {};
+        // Indexed by the capture index.
+        std::vector<std::optional<ReplayPipeline>> pipelines = {};
+        std::vector<std::optional<ReplayCommandList>> command_lists = {};
+        std::vector<ReplayStep> steps = {};
+    };
+
+    template <typename RecordT, typename OtherRecordT>
+    void insert_replay_resource(ReplayCapture & capture, std::map<u32, RecordT> & records, std::map<u32, OtherRecordT> const * other_records, RecordT const & record)
+    {
+        u32 const index = static_cast<u32>(std::bit_cast<GPUResourceId>(record.id).index);
+        if (other_records != nullptr && other_records->contains(index))
+        {
+            capture.conflicting_resource_count += 1;
+            return;
+        }
+        auto [iter, inserted] = records.try_emplace(index, record);
+        if (inserted)
+        {
+            return;
+        }
+        // The same resource is written twice when it was created while the capture began.
+        if (iter->second.id.value == record.id.value)
+        {
+            iter->second = record;
+        }
+        else
+        {
+            capture.conflicting_resource_count += 1;
+        }
+    }
+
+    template <typename T>
+    void store_at_capture_index(std::vector<std::optional<T>> & items, u64 index, T const & item)
+    {
+        // Indices are handed out in order, a larger one means a corrupt file.
+        if (index > items.size())
+        {
+            return;
+        }
+        if (index == items.size())
+        {
+            items.emplace_back();
+        }
+        items[index] = item;
+    }
+
+    auto parse_capture(std::span<std::byte const> bytes, ReplayCapture & out) -> bool
+    {
+        CaptureReader reader = {.bytes = bytes};
+        CaptureFileHeader header = {};
+        if (!reader.read(header) || header.magic != CAPTURE_FILE_MAGIC || header.version != CAPTURE_FILE_VERSION)
+        {
+            return false;
+        }
+        std::vector<ReplayContents> pending_contents = {};
+        bool submitted = false;
+        while (!reader.at_end())
+        {
+            CaptureRecordHeader record_header = {};
+            if (!reader.read(record_header))
+            {
+                return false;
+            }
+            auto const payload = reader.read_bytes(record_header.size);
+            if (!payload.has_value())
+            {
+                return false;
+            }
+            CaptureReader record = {.bytes = payload.value()};
+            switch (record_header.type)
+            {
+            case CaptureRecordType::CREATE_BUFFER:
+            {
+                CaptureBufferRecord buffer = {};
+                if (!record.read(buffer))
+                {
+                    return false;
+                }
+                insert_replay_resource(out, out.buffers, static_cast<std::map<u32, CaptureBufferRecord> const *>(nullptr), buffer);
+                break;
+            }
+            case CaptureRecordType::CREATE_IMAGE:
+            {
+                CaptureImageRecord image = {};
+                if (!record.read(image))
+                {
+                    return false;
+                }
+                insert_replay_resource(out, out.images, &out.image_views, image);
+                break;
+            }
+            case CaptureRecordType::CREATE_IMAGE_VIEW:
+            {
+                CaptureImageViewRecord image_view = {};
+                if (!record.read(image_view))
+                {
+                    return false;
+                }
+                insert_replay_resource(out, out.image_views, &out.images, image_view);
+                break;
+            }
+            case CaptureRecordType::CREATE_SAMPLER:
+            {
+                CaptureSamplerRecord sampler = {};
+                if (!record.read(sampler))
+                {
+                    return false;
+                }
+                insert_replay_resource(out, out.samplers, static_cast<std::map<u32, CaptureSamplerRecord> const *>(nullptr), sampler);
+                break;
+            }
+            case CaptureRecordType::BUFFER_CONTENTS:
+            {
+                CaptureBufferContentsRecord contents = {};
+                if (!record.read(contents))
+                {
+                    return false;
+                }
+                auto const contents_bytes = record.read_bytes(contents.size);
+                if (!contents_bytes.has_value())
+                {
+                    return false;
+                }
+                pending_contents.push_back({.id = contents.id, .offset = contents.offset, .bytes = contents_bytes.value()});
+                break;
+            }
+            case CaptureRecordType::COMPUTE_PIPELINE:
+            case CaptureRecordType::RASTER_PIPELINE:
+            {
+                CapturePipelineRecord pipeline = {};
+                if (!record.read(pipeline))
+                {
+                    return false;
+                }
+                store_at_capture_index(out.pipelines, pipeline.index, ReplayPipeline{.type = record_header.type, .record = record.rest()});
+                break;
+            }
+            case CaptureRecordType::COMMAND_LIST:
+            {
+                CaptureCommandListRecord command_list = {};
+                if (!record.read(command_list))
+                {
+                    return false;
+                }
+                store_at_capture_index(out.command_lists, command_list.index, ReplayCommandList{.info = command_list.info, .commands = record.rest()});
+                break;
+            }
+            case CaptureRecordType::SUBMIT:
+            {
+                CaptureSubmitRecord submit = {};
+                if (!record.read(submit))
+                {
+                    return false;
+                }
+                ReplayStep step = {.queue = submit.queue, .device_mask = submit.device_mask};
+                step.command_lists.resize(static_cast<usize>(std::min(submit.command_list_count, static_cast<u64>(record.rest().size() / sizeof(u64)))));
+                for (auto & command_list : step.command_lists)
+                {
+                    record.read(command_list);
+                }
+                // Contents captured before the first submit are the state the replay starts from.
+                if (submitted)
+                {
+                    step.contents = std::move(pending_contents);
+                }
+                else
+                {
+                    out.initial_contents = std::move(pending_contents);
+                }
+                pending_contents.clear();
+                submitted = true;
+                out.steps.push_back(std::move(step));
+                break;
+            }
+            default:
+                // Unknown records of newer minor revisions are skipped.
+                break;
+            }
+        }
+        if (!submitted)
+        {
+            out.initial_contents = std::move(pending_contents);
+        }
+        return true;
+    }
+
+    // Device address of each replayed buffer during the capture and now, sorted by the captured address.
+    struct ReplayAddressRange
+    {
+        u64 captured = {};
+        u64 size = {};
+        u64 replayed = {};
+    };
+
+    // Replaces 8 byte aligned values inside of a captured buffer address range with the address in the replayed buffer.
+    // base_offset is the offset of bytes in the buffer or push constant block, alignment is relative to it.
+    void replay_translate_addresses(std::vector<ReplayAddressRange> const & ranges, std::span<std::byte> bytes, u64 base_offset)
+    {
+        if (ranges.empty())
+        {
+            return;
+        }
+        for (usize i = static_cast<usize>((sizeof(u64) - base_offset % sizeof(u64)) % sizeof(u64)); i + sizeof(u64) <= bytes.size(); i += sizeof(u64))
+        {
+            u64 value = {};
+            std::memcpy(&value, bytes.data() + i, sizeof(u64));
+            if (value == 0)
+            {
+                continue;
+            }
+            auto range = std::upper_bound(
+                ranges.begin(), ranges.end(), value,
+                [](u64 v, ReplayAddressRange const & r)
+                { return v < r.captured; });
+            if (range == ranges.begin())
+            {
+                continue;
+            }
+            --range;
+            if (value - range->captured < range->size)
+            {
+                value = range->replayed + (value - range->captured);
+                std::memcpy(bytes.data() + i, &value, sizeof(u64));
+            }
+        }
+    }
+
+    // Everything the replay created, destroyed when it ends.
+    struct ReplayResources
+    {
+        std::vector<daxa_BufferId> buffers = {};
+        std::vector<daxa_ImageId> images = {};
+        std::vector<daxa_ImageViewId> image_views = {};
+        std::vector<daxa_SamplerId> samplers = {};
+        // Indexed by the capture index, null for pipelines of the other type and pipelines that failed to create.
+        std::vector<daxa_ComputePipeline> compute_pipelines = {};
+        std::vector<daxa_RasterPipeline> raster_pipelines = {};
+        // Indexed by the capture index, null for lists that failed to record.
+        std::vector<daxa_ExecutableCommandList> command_lists = {};
+        daxa_BufferId staging_buffer = {};
+        // Copies of captured contents out of the staging buffer. The first one applies the initial contents, then one per step.
+        std::vector<daxa_ExecutableCommandList> upload_lists = {};
+        std::vector<ReplayAddressRange> address_ranges = {};
+    };
+
+    void destroy_replay_resources(daxa_Device self, ReplayResources & resources)
+    {
+        [[maybe_unused]] auto const _wait_result = daxa_dvc_wait_idle(self);
+        for (auto * commands : resources.command_lists)
+        {
+            if (commands != nullptr)
+            {
+                daxa_executable_commands_dec_refcnt(commands);
+            }
+        }
+        for (auto * commands : resources.upload_lists)
+        {
+            if (commands != nullptr)
+            {
+                daxa_executable_commands_dec_refcnt(commands);
+            }
+        }
+        for (auto * pipeline : resources.compute_pipelines)
+        {
+            if (pipeline != nullptr)
+            {
+                daxa_compute_pipeline_dec_refcnt(pipeline);
+            }
+        }
+        for (auto * pipeline : resources.raster_pipelines)
+        {
+            if (pipeline != nullptr)
+            {
+                daxa_raster_pipeline_dec_refcnt(pipeline);
+            }
+        }
+        for (auto id : resources.image_views)
+        {
+            [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_image_view(self, id);
+        }
+        for (auto id : resources.images)
+        {
+            [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_image(self, id);
+        }
+        for (auto id : resources.buffers)
+        {
+            [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_buffer(self, id);
+        }
+        for (auto id : resources.samplers)
+        {
+            [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_sampler(self, id);
+        }
+        if (resources.staging_buffer.value != 0)
+        {
+            [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_buffer(self, resources.staging_buffer);
+        }
+    }
+
+    // Claimed fresh indices of a pool, see GpuResourcePool::unsafe_claim_indices.
+    struct ReplayClaim
+    {
+        u32 first = {};
+        u32 end = {};
+    };
+
+    template <typename PoolT>
+    auto claim_replay_indices(PoolT & pool, std::vector<u32> const & indices, ReplayClaim & out) -> bool
+    {
+        if (indices.empty())
+        {
+            return true;
+        }
+        u32 const first = *std::min_element(indices.begin(), indices.end());
+        u32 const end = *std::max_element(indices.begin(), indices.end()) + 1;
+        auto const first_claimed = pool.unsafe_claim_indices(first, end);
+        if (!first_claimed.has_value())
+        {
+            return false;
+        }
+        out = {.first = first_claimed.value(), .end = std::max(end, first_claimed.value())};
+        return true;
+    }
+
+    // Claimed indices that were prepared already went through the free list, the rest are pushed into it.
+    template <typename PoolT>
+    void release_replay_indices(PoolT & pool, ReplayClaim const & claim, std::unordered_set<u32> const & prepared_indices)
+    {
+        for (u32 index = claim.first; index < claim.end; ++index)
+        {
+            if (!prepared_indices.contains(index))
+            {
+                pool.push_free_index(index);
+            }
+        }
+    }
+
+    auto create_replay_resources(daxa_Device self, ReplayCapture const & capture, ReplayResources & resources, daxa_ReplayStats & stats) -> daxa_Result
+    {
+        auto & buffer_pool = self->gpu_sro_table.buffer_slots;
+        auto & image_pool = self->gpu_sro_table.image_slots;
+        auto & sampler_pool = self->gpu_sro_table.sampler_slots;
+
+        std::vector<u32> buffer_indices = {};
+        std::vector<u32> image_indices = {};
+        std::vector<u32> sampler_indices = {};
+        for (auto const & [index, record] : capture.buffers)
+        {
+            buffer_indices.push_back(index);
+        }
+        for (auto const & [index, record] : capture.images)
+        {
+            image_indices.push_back(index);
+        }
+        for (auto const & [index, record] : capture.image_views)
+        {
+            image_indices.push_back(index);
+        }
+        for (auto const & [index, record] : capture.samplers)
+        {
+            sampler_indices.push_back(index);
+        }
+
+        // All ids are claimed before anything is created, a conflict leaves the device untouched.
+        ReplayClaim buffer_claim = {};
+        ReplayClaim image_claim = {};
+        ReplayClaim sampler_claim = {};
+        bool claimed = claim_replay_indices(buffer_pool, buffer_indices, buffer_claim);
+        claimed = claimed && claim_replay_indices(image_pool, image_indices, image_claim);
+        claimed = claimed && claim_replay_indices(sampler_pool, sampler_indices, sampler_claim);
+        if (!claimed)
+        {
+            release_replay_indices(buffer_pool, buffer_claim, {});
+            release_replay_indices(image_pool, image_claim, {});
+            release_replay_indices(sampler_pool, sampler_claim, {});
+            return DAXA_RESULT_ERROR_REPLAY_ID_CONFLICT;
+        }
+
+        for (auto const & [index, record] : capture.buffers)
+        {
+            buffer_pool.unsafe_prepare_claimed_slot(std::bit_cast<GPUResourceId>(record.id));
+            daxa_BufferInfo info = record.info;
+            info.external_memory = {};
+            daxa_BufferId id = {};
+            if (daxa_dvc_create_buffer(self, &info, &id) != DAXA_RESULT_SUCCESS)
+            {
+                stats.failed_creation_count += 1;
+                continue;
+            }
+            resources.buffers.push_back(id);
+            resources.address_ranges.push_back({.captured = record.device_address, .size = record.info.size, .replayed = self->slot(id).device_address});
+        }
+        for (auto const & [index, record] : capture.images)
+        {
+            image_pool.unsafe_prepare_claimed_slot(std::bit_cast<GPUResourceId>(record.id));
+            daxa_ImageInfo info = record.info;
+            info.external_memory = {};
+            daxa_ImageId id = {};
+            if (daxa_dvc_create_image(self, &info, &id) != DAXA_RESULT_SUCCESS)
+            {
+                stats.failed_creation_count += 1;
+                continue;
+            }
+            resources.images.push_back(id);
+        }
+        for (auto const & [index, record] : capture.image_views)
+        {
+            image_pool.unsafe_prepare_claimed_slot(std::bit_cast<GPUResourceId>(record.id));
+            daxa_ImageViewId id = {};
+            if (daxa_dvc_create_image_view(self, &record.info, &id) != DAXA_RESULT_SUCCESS)
+            {
+                stats.failed_creation_count += 1;
+                continue;
+            }
+            resources.image_views.push_back(id);
+        }
+        for (auto const & [index, record] : capture.samplers)
+        {
+            sampler_pool.unsafe_prepare_claimed_slot(std::bit_cast<GPUResourceId>(record.id));
+            daxa_SamplerId id = {};
+            if (daxa_dvc_create_sampler(self, &record.info, &id) != DAXA_RESULT_SUCCESS)
+            {
+                stats.failed_creation_count += 1;
+                continue;
+            }
+            resources.samplers.push_back(id);
+        }
+
+        release_replay_indices(buffer_pool, buffer_claim, std::unordered_set<u32>(buffer_indices.begin(), buffer_indices.end()));
+        release_replay_indices(image_pool, image_claim, std::unordered_set<u32>(image_indices.begin(), image_indices.end()));
+        release_replay_indices(sampler_pool, sampler_claim, std::unordered_set<u32>(sampler_indices.begin(), sampler_indices.end()));
+
+        std::sort(
+            resources.address_ranges.begin(), resources.address_ranges.end(),
+            [](ReplayAddressRange const & a, ReplayAddressRange const & b)
+            { return a.captured < b.captured; });
+        stats.buffer_count = static_cast<u32>(resources.buffers.size());
+        stats.image_count = static_cast<u32>(resources.images.size());
+        stats.image_view_count = static_cast<u32>(resources.image_views.size());
+        stats.sampler_count = static_cast<u32>(resources.samplers.size());
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    // Owns the spirv and specialization constants a replayed shader info points to.
+    struct ReplayShaderStorage
+    {
+        std::vector<u32> byte_code = {};
+        std::vector<daxa_SpecializationConstant> specialization_constants = {};
+    };
+
+    auto read_replay_shader(CaptureReader & reader, daxa_ShaderInfo & shader, ReplayShaderStorage & storage) -> bool
+    {
+        u64 word_count = {};
+        if (!reader.read(word_count))
+        {
+            return false;
+        }
+        auto const byte_code = reader.read_bytes(word_count * sizeof(u32));
+        u64 constant_count = {};
+        if (!byte_code.has_value() || !reader.read(constant_count))
+        {
+            return false;
+        }
+        auto const constants = reader.read_bytes(constant_count * sizeof(daxa_SpecializationConstant));
+        if (!constants.has_value())
+        {
+            return false;
+        }
+        storage.byte_code.resize(static_cast<usize>(word_count));
+        std::memcpy(storage.byte_code.data(), byte_code->data(), byte_code->size());
+        storage.specialization_constants.resize(static_cast<usize>(constant_count));
+        std::memcpy(storage.specialization_constants.data(), constants->data(), constants->size());
+        shader.byte_code = storage.byte_code.data();
+        shader.byte_code_size = static_cast<u32>(word_count);
+        shader.specialization_constants.data = storage.specialization_constants.data();
+        shader.specialization_constants.size = storage.specialization_constants.size();
+        return true;
+    }
+
+    void create_replay_pipelines(daxa_Device self, ReplayCapture const & capture, ReplayResources & resources, daxa_ReplayStats & stats)
+    {
+        resources.compute_pipelines.resize(capture.pipelines.size());
+        resources.raster_pipelines.resize(capture.pipelines.size());
+        for (usize index = 0; index < capture.pipelines.size(); ++index)
+        {
+            auto const & pipeline = capture.pipelines[index];
+            if (!pipeline.has_value())
+            {
+                continue;
+            }
+            CaptureReader reader = {.bytes = pipeline->record};
+            bool created = false;
+            if (pipeline->type == CaptureRecordType::COMPUTE_PIPELINE)
+            {
+                daxa_ComputePipelineInfo info = {};
+                ReplayShaderStorage storage = {};
+                bool const valid = reader.read(info) && read_replay_shader(reader, info.shader_info, storage);
+                // Replays never record generated commands.
+                info.indirect_bindable = 0;
+                created = valid && daxa_dvc_create_compute_pipeline(self, &info, &resources.compute_pipelines[index]) == DAXA_RESULT_SUCCESS;
+            }
+            else
+            {
+                daxa_RasterPipelineInfo info = {};
+                std::array<ReplayShaderStorage, 6> storages = {};
+                usize shader_count = 0;
+                bool valid = reader.read(info);
+                for_each_raster_shader(
+                    info,
+                    [&](auto & shader)
+                    {
+                        if (valid && shader.has_value)
+                        {
+                            valid = read_replay_shader(reader, shader.value, storages.at(shader_count++));
+                        }
+                    });
+                info.indirect_bindable = 0;
+                created = valid && daxa_dvc_create_raster_pipeline(self, &info, &resources.raster_pipelines[index]) == DAXA_RESULT_SUCCESS;
+            }
+            if (created)
+            {
+                stats.pipeline_count += 1;
+            }
+            else
+            {
+                resources.compute_pipelines[index] = {};
+                resources.raster_pipelines[index] = {};
+                stats.failed_creation_count += 1;
+            }
+        }
+    }
+
+    // Queues missing on the replaying device fall back to the main queue.
+    auto replay_queue(daxa_Device self, daxa_Queue queue) -> daxa_Queue
+    {
+        u32 queue_count = 0;
+        if (daxa_dvc_queue_count(self, queue.family, &queue_count) != DAXA_RESULT_SUCCESS || queue_count == 0)
+        {
+            return DAXA_QUEUE_MAIN;
+        }
+        if (queue.index >= queue_count)
+        {
+            queue.index = 0;
+        }
+        return queue;
+    }
+
+    auto replay_device_mask(daxa_Device self, u32 device_mask) -> u32
+    {
+        return device_mask & ((1u << self->device_group_size) - 1u);
+    }
+
+    // Reads the info a command was called with and calls it. Returns if the command was recorded.
+    template <typename InfoT, typename FnT>
+    auto replay_info_command(CaptureReader & payload, FnT && fn) -> bool
+    {
+        InfoT info = {};
+        if (!payload.read(info))
+        {
+            return false;
+        }
+        if constexpr (std::is_void_v<std::invoke_result_t<FnT, InfoT const *>>)
+        {
+            fn(&info);
+            return true;
+        }
+        else
+        {
+            return fn(&info) == DAXA_RESULT_SUCCESS;
+        }
+    }
+
+    template <typename InfoT, typename RangeT, typename FnT>
+    auto replay_draw_multi(CaptureReader & payload, FnT && fn) -> bool
+    {
+        InfoT info = {};
+        if (!payload.read(info))
+        {
+            return false;
+        }
+        auto const range_bytes = payload.read_bytes(info.range_count * sizeof(RangeT));
+        if (!range_bytes.has_value())
+        {
+            return false;
+        }
+        std::vector<RangeT> ranges(info.range_count);
+        std::memcpy(ranges.data(), range_bytes->data(), range_bytes->size());
+        info.ranges = ranges.data();
+        fn(&info);
+        return true;
+    }
+
+    auto replay_push_constant_field(CaptureReader & payload, ReplayResources const & resources, std::vector<std::byte> & data, daxa_PushConstantInfo & out) -> bool
+    {
+        u32 offset = {};
+        u64 size = {};
+        if (!payload.read(offset) || !payload.read(size))
+        {
+            return false;
+        }
+        auto const bytes = payload.read_bytes(size);
+        if (!bytes.has_value())
+        {
+            return false;
+        }
+        data.assign(bytes->begin(), bytes->end());
+        replay_translate_addresses(resources.address_ranges, data, offset);
+        out = {.data = data.data(), .size = size, .offset = offset};
+        return true;
+    }
+
+    auto replay_command(daxa_Device self, daxa_CommandRecorder recorder, ReplayResources const & resources, CaptureCommand command, CaptureReader & payload) -> bool
+    {
+        switch (command)
+        {
+        case CaptureCommand::SET_RASTERIZATION_SAMPLES:
+        {
+            VkSampleCountFlagBits samples = {};
+            return payload.read(samples) && daxa_cmd_set_rasterization_samples(recorder, samples) == DAXA_RESULT_SUCCESS;
+        }
+        case CaptureCommand::COPY_BUFFER_TO_BUFFER:
+            return replay_info_command<daxa_BufferCopyInfo>(payload, [&](auto const * info)
+                                                            { return daxa_cmd_copy_buffer_to_buffer(recorder, info); });
+        case CaptureCommand::COPY_BUFFER_TO_IMAGE:
+            return replay_info_command<daxa_BufferImageCopyInfo>(payload, [&](auto const * info)
+                                                                 { return daxa_cmd_copy_buffer_to_image(recorder, info); });
+        case CaptureCommand::COPY_IMAGE_TO_BUFFER:
+            return replay_info_command<daxa_ImageBufferCopyInfo>(payload, [&](auto const * info)
+                                                                 { return daxa_cmd_copy_image_to_buffer(recorder, info); });
+        case CaptureCommand::COPY_IMAGE_TO_IMAGE:
+            return replay_info_command<daxa_ImageCopyInfo>(payload, [&](auto const * info)
+                                                           { return daxa_cmd_copy_image_to_image(recorder, info); });
+        case CaptureCommand::BLIT_IMAGE_TO_IMAGE:
+            return replay_info_command<daxa_ImageBlitInfo>(payload, [&](auto const * info)
+                                                           { return daxa_cmd_blit_image_to_image(recorder, info); });
+        case CaptureCommand::CLEAR_BUFFER:
+            return replay_info_command<daxa_BufferClearInfo>(payload, [&](auto const * info)
+                                                             { return daxa_cmd_clear_buffer(recorder, info); });
+        case CaptureCommand::CLEAR_IMAGE:
+            return replay_info_command<daxa_ImageClearInfo>(payload, [&](auto const * info)
+                                                            { return daxa_cmd_clear_image(recorder, info); });
+        case CaptureCommand::PIPELINE_BARRIER:
+            return replay_info_command<daxa_MemoryBarrierInfo>(payload, [&](auto const * info)
+                                                               { daxa_cmd_pipeline_barrier(recorder, info); });
+        case CaptureCommand::PIPELINE_BARRIER_IMAGE_TRANSITION:
+            return replay_info_command<daxa_ImageMemoryBarrierInfo>(payload, [&](auto const * info)
+                                                                    { return daxa_cmd_pipeline_barrier_image_transition(recorder, info); });
+        case CaptureCommand::PUSH_CONSTANT:
+        {
+            std::vector<std::byte> data = {};
+            daxa_PushConstantInfo info = {};
+            return replay_push_constant_field(payload, resources, data, info) && daxa_cmd_push_constant(recorder, &info) == DAXA_RESULT_SUCCESS;
+        }
+        case CaptureCommand::PUSH_CONSTANT_RANGE:
+        {
+            usize field_count = {};
+            if (!payload.read(field_count) || field_count > payload.rest().size())
+            {
+                return false;
+            }
+            std::vector<std::vector<std::byte>> datas(field_count);
+            std::vector<daxa_PushConstantInfo> fields(field_count);
+            for (usize i = 0; i < field_count; ++i)
+            {
+                if (!replay_push_constant_field(payload, resources, datas[i], fields[i]))
+                {
+                    return false;
+                }
+            }
+            return daxa_cmd_push_constant_range(recorder, fields.data(), field_count) == DAXA_RESULT_SUCCESS;
+        }
+        case CaptureCommand::SET_COMPUTE_PIPELINE:
+        {
+            u64 index = {};
+            if (!payload.read(index) || index >= resources.compute_pipelines.size() || resources.compute_pipelines[index] == nullptr)
+            {
+                return false;
+            }
+            daxa_cmd_set_compute_pipeline(recorder, resources.compute_pipelines[index]);
+            return true;
+        }
+        case CaptureCommand::SET_RASTER_PIPELINE:
+        {
+            u64 index = {};
+            if (!payload.read(index) || index >= resources.raster_pipelines.size() || resources.raster_pipelines[index] == nullptr)
+            {
+                return false;
+            }
+            daxa_cmd_set_raster_pipeline(recorder, resources.raster_pipelines[index]);
+            return true;
+        }
+        case CaptureCommand::DISPATCH:
+            return replay_info_command<daxa_DispatchInfo>(payload, [&](auto const * info)
+                                                          { return daxa_cmd_dispatch(recorder, info); });
+        case CaptureCommand::DISPATCH_INDIRECT:
+            return replay_info_command<daxa_DispatchIndirectInfo>(payload, [&](auto const * info)
+                                                                  { return daxa_cmd_dispatch_indirect(recorder, info); });
+        case CaptureCommand::BEGIN_CONDITIONAL_RENDERING:
+            return replay_info_command<daxa_ConditionalRenderingInfo>(payload, [&](auto const * info)
+                                                                      { return daxa_cmd_begin_conditional_rendering(recorder, info); });
+        case CaptureCommand::END_CONDITIONAL_RENDERING:
+            return daxa_cmd_end_conditional_rendering(recorder) == DAXA_RESULT_SUCCESS;
+        case CaptureCommand::BEGIN_RENDERPASS:
+            return replay_info_command<daxa_RenderPassBeginInfo>(payload, [&](auto const * info)
+                                                                 { return daxa_cmd_begin_renderpass(recorder, info); });
+        case CaptureCommand::END_RENDERPASS:
+            daxa_cmd_end_renderpass(recorder);
+            return true;
+        case CaptureCommand::SET_VIEWPORT:
+            return replay_info_command<VkViewport>(payload, [&](auto const * info)
+                                                   { daxa_cmd_set_viewport(recorder, info); });
+        case CaptureCommand::SET_SCISSOR:
+            return replay_info_command<VkRect2D>(payload, [&](auto const * info)
+                                                 { daxa_cmd_set_scissor(recorder, info); });
+        case CaptureCommand::SET_DEPTH_BIAS:
+            return replay_info_command<daxa_DepthBiasInfo>(payload, [&](auto const * info)
+                                                           { daxa_cmd_set_depth_bias(recorder, info); });
+        case CaptureCommand::SET_INDEX_BUFFER:
+            return replay_info_command<daxa_SetIndexBufferInfo>(payload, [&](auto const * info)
+                                                                { return daxa_cmd_set_index_buffer(recorder, info); });
+        case CaptureCommand::DRAW:
+            return replay_info_command<daxa_DrawInfo>(payload, [&](auto const * info)
+                                                      { daxa_cmd_draw(recorder, info); });
+        case CaptureCommand::DRAW_INDEXED:
+            return replay_info_command<daxa_DrawIndexedInfo>(payload, [&](auto const * info)
+                                                             { daxa_cmd_draw_indexed(recorder, info); });
+        case CaptureCommand::DRAW_MULTI:
+            return replay_draw_multi<daxa_DrawMultiInfo, daxa_DrawRange>(payload, [&](auto const * info)
+                                                                         { daxa_cmd_draw_multi(recorder, info); });
+        case CaptureCommand::DRAW_MULTI_INDEXED:
+            return replay_draw_multi<daxa_DrawMultiIndexedInfo, daxa_DrawIndexedRange>(payload, [&](auto const * info)
+                                                                                       { daxa_cmd_draw_multi_indexed(recorder, info); });
+        case CaptureCommand::DRAW_INDIRECT:
+            return replay_info_command<daxa_DrawIndirectInfo>(payload, [&](auto const * info)
+                                                              { return daxa_cmd_draw_indirect(recorder, info); });
+        case CaptureCommand::DRAW_INDIRECT_COUNT:
+            return replay_info_command<daxa_DrawIndirectCountInfo>(payload, [&](auto const * info)
+                                                                   { return daxa_cmd_draw_indirect_count(recorder, info); });
+        case CaptureCommand::DRAW_MESH_TASKS:
+        {
+            std::array<u32, 3> group_counts = {};
+            if (!payload.read(group_counts))
+            {
+                return false;
+            }
+            daxa_cmd_draw_mesh_tasks(recorder, group_counts[0], group_counts[1], group_counts[2]);
+            return true;
+        }
+        case CaptureCommand::DRAW_MESH_TASKS_INDIRECT:
+            return replay_info_command<daxa_DrawMeshTasksIndirectInfo>(payload, [&](auto const * info)
+                                                                       { return daxa_cmd_draw_mesh_tasks_indirect(recorder, info); });
+        case CaptureCommand::DRAW_MESH_TASKS_INDIRECT_COUNT:
+            return replay_info_command<daxa_DrawMeshTasksIndirectCountInfo>(payload, [&](auto const * info)
+                                                                            { return daxa_cmd_draw_mesh_tasks_indirect_count(recorder, info); });
+        case CaptureCommand::BEGIN_LABEL:
+            return replay_info_command<daxa_CommandLabelInfo>(payload, [&](auto const * info)
+                                                              { daxa_cmd_begin_label(recorder, info); });
+        case CaptureCommand::END_LABEL:
+            daxa_cmd_end_label(recorder);
+            return true;
+        case CaptureCommand::SET_DEVICE_MASK:
+        {
+            u32 device_mask = {};
+            return payload.read(device_mask) && daxa_cmd_set_device_mask(recorder, replay_device_mask(self, device_mask)) == DAXA_RESULT_SUCCESS;
+        }
+        default:
+            return false;
+        }
+    }
+
+    auto record_replay_command_list(daxa_Device self, ReplayCommandList const & command_list, ReplayResources const & resources, daxa_ReplayStats & stats) -> daxa_ExecutableCommandList
+    {
+        daxa_CommandRecorderInfo info = command_list.info;
+        info.queue_family = replay_queue(self, daxa_Queue{.family = info.queue_family, .index = 0}).family;
+        // Submitted once per repetition.
+        info.reusable = 1;
+        daxa_CommandRecorder recorder = {};
+        if (daxa_dvc_create_command_recorder(self, &info, &recorder) != DAXA_RESULT_SUCCESS)
+        {
+            return nullptr;
+        }
+        CaptureReader reader = {.bytes = command_list.commands};
+        while (!reader.at_end())
+        {
+            CaptureCommandHeader header = {};
+            if (!reader.read(header))
+            {
+                break;
+            }
+            auto const payload = reader.read_bytes(header.size);
+            if (!payload.has_value())
+            {
+                break;
+            }
+            stats.command_count += 1;
+            CaptureReader payload_reader = {.bytes = payload.value()};
+            if (!replay_command(self, recorder, resources, header.command, payload_reader))
+            {
+                stats.skipped_command_count += 1;
+            }
+        }
+        daxa_ExecutableCommandList commands = {};
+        auto const result = daxa_cmd_complete_current_commands(recorder, &commands);
+        // The executable command list keeps the recorder alive.
+        daxa_destroy_command_recorder(recorder);
+        return result == DAXA_RESULT_SUCCESS ? commands : nullptr;
+    }
+
+    // A host write of the capture, applied to the replayed buffer.
+    struct ReplayHostWrite
+    {
+        std::byte * dst = {};
+        std::vector<std::byte> data = {};
+    };
+
+    struct ReplayUpload
+    {
+        daxa_BufferId dst = {};
+        u64 dst_offset = {};
+        u64 staging_offset = {};
+        u64 size = {};
+    };
+
+    // Splits the captured contents into direct host writes for the initial contents of host visible buffers
+    // and copies out of one staging buffer for everything else. The staging buffer is filled once.
+    auto prepare_replay_contents(daxa_Device self, ReplayCapture const & capture, ReplayResources & resources, std::vector<ReplayHostWrite> & host_writes) -> daxa_Result
+    {
+        std::vector<std::vector<ReplayUpload>> uploads(capture.steps.size() + 1);
+        std::vector<std::byte> staging_data = {};
+        auto add_contents = [&](ReplayContents const & contents, usize upload_index, bool allow_host_write)
+        {
+            auto const & buffer_pool = self->gpu_sro_table.buffer_slots;
+            if (!buffer_pool.is_id_valid(std::bit_cast<GPUResourceId>(contents.id)))
+            {
+                return;
+            }
+            ImplBufferSlot const & slot = self->slot(contents.id);
+            if (contents.offset > slot.info.size || contents.bytes.size() > slot.info.size - contents.offset)
+            {
+                return;
+            }
+            std::vector<std::byte> data(contents.bytes.begin(), contents.bytes.end());
+            replay_translate_addresses(resources.address_ranges, data, contents.offset);
+            if (allow_host_write && slot.host_address != nullptr)
+            {
+                host_writes.push_back({.dst = r_cast<std::byte *>(slot.host_address) + contents.offset, .data = std::move(data)});
+                return;
+            }
+            u64 const staging_offset = (staging_data.size() + 15) & ~u64{15};
+            staging_data.resize(static_cast<usize>(staging_offset) + data.size());
+            std::memcpy(staging_data.data() + staging_offset, data.data(), data.size());
+            uploads[upload_index].push_back({.dst = contents.id, .dst_offset = contents.offset, .staging_offset = staging_offset, .size = data.size()});
+        };
+        for (auto const & contents : capture.initial_contents)
+        {
+            add_contents(contents, 0, true);
+        }
+        for (usize step = 0; step < capture.steps.size(); ++step)
+        {
+            for (auto const & contents : capture.steps[step].contents)
+            {
+                add_contents(contents, step + 1, false);
+            }
+        }
+        resources.upload_lists.resize(uploads.size());
+        if (staging_data.empty())
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+
+        daxa_BufferInfo const staging_info = {
+            .size = staging_data.size(),
+            .allocate_info = DAXA_MEMORY_FLAG_HOST_ACCESS_SEQUENTIAL_WRITE,
+            .name = std::bit_cast<daxa_SmallString>(SmallString{"replay staging"}),
+        };
+        auto result = daxa_dvc_create_buffer(self, &staging_info, &resources.staging_buffer);
+        _DAXA_RETURN_IF_ERROR(result, result)
+        std::memcpy(self->slot(resources.staging_buffer).host_address, staging_data.data(), staging_data.size());
+
+        for (usize i = 0; i < uploads.size(); ++i)
+        {
+            if (uploads[i].empty())
+            {
+                continue;
+            }
+            daxa_CommandRecorderInfo const recorder_info = {.queue_family = DAXA_QUEUE_FAMILY_MAIN, .reusable = 1};
+            daxa_CommandRecorder recorder = {};
+            result = daxa_dvc_create_command_recorder(self, &recorder_info, &recorder);
+            _DAXA_RETURN_IF_ERROR(result, result)
+            daxa_MemoryBarrierInfo const before = {.src_access = DAXA_ACCESS_READ_WRITE, .dst_access = DAXA_ACCESS_TRANSFER_WRITE};
+            daxa_cmd_pipeline_barrier(recorder, &before);
+            for (auto const & upload : uploads[i])
+            {
+                daxa_BufferCopyInfo const copy_info = {
+                    .src_buffer = resources.staging_buffer,
+                    .dst_buffer = upload.dst,
+                    .src_offset = upload.staging_offset,
+                    .dst_offset = upload.dst_offset,
+                    .size = upload.size,
+                };
+                [[maybe_unused]] auto const _ignore = daxa_cmd_copy_buffer_to_buffer(recorder, &copy_info);
+            }
+            daxa_MemoryBarrierInfo const after = {.src_access = DAXA_ACCESS_TRANSFER_WRITE, .dst_access = DAXA_ACCESS_READ_WRITE};
+            daxa_cmd_pipeline_barrier(recorder, &after);
+            result = daxa_cmd_complete_current_commands(recorder, &resources.upload_lists[i]);
+            daxa_destroy_command_recorder(recorder);
+            _DAXA_RETURN_IF_ERROR(result, result)
+        }
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    // Replays the captured submits once. Queue switches wait for the previous queue to be idle, as captured semaphores are not replayed.
+    auto replay_steps(daxa_Device self, ReplayCapture const & capture, ReplayResources const & resources, std::vector<ReplayHostWrite> const & host_writes, u64 & out_ns) -> daxa_Result
+    {
+        for (auto const & write : host_writes)
+        {
+            std::memcpy(write.dst, write.data.data(), write.data.size());
+        }
+        daxa_Queue previous_queue = DAXA_QUEUE_MAIN;
+        auto submit = [&](daxa_Queue queue, u32 device_mask, std::span<daxa_ExecutableCommandList const> command_lists) -> daxa_Result
+        {
+            if (command_lists.empty())
+            {
+                return DAXA_RESULT_SUCCESS;
+            }
+            if (queue.family != previous_queue.family || queue.index != previous_queue.index)
+            {
+                auto const wait_result = daxa_dvc_queue_wait_idle(self, previous_queue);
+                _DAXA_RETURN_IF_ERROR(wait_result, wait_result)
+                previous_queue = queue;
+            }
+            daxa_CommandSubmitInfo submit_info = DAXA_DEFAULT_COMMAND_SUBMIT_INFO;
+            submit_info.queue = queue;
+            submit_info.command_lists = command_lists.data();
+            submit_info.command_list_count = command_lists.size();
+            submit_info.device_mask = device_mask;
+            return daxa_dvc_submit(self, &submit_info);
+        };
+        auto submit_upload = [&](usize index) -> daxa_Result
+        {
+            if (resources.upload_lists[index] == nullptr)
+            {
+                return DAXA_RESULT_SUCCESS;
+            }
+            return submit(DAXA_QUEUE_MAIN, 0, std::span{&resources.upload_lists[index], 1});
+        };
+
+        auto result = submit_upload(0);
+        _DAXA_RETURN_IF_ERROR(result, result)
+        result = daxa_dvc_wait_idle(self);
+        _DAXA_RETURN_IF_ERROR(result, result)
+
+        std::vector<daxa_ExecutableCommandList> command_lists = {};
+        auto const start = std::chrono::steady_clock::now();
+        for (usize step_index = 0; step_index < capture.steps.size(); ++step_index)
+        {
+            auto const & step = capture.steps[step_index];
+            result = submit_upload(step_index + 1);
+            _DAXA_RETURN_IF_ERROR(result, result)
+            command_lists.clear();
+            for (u64 index : step.command_lists)
+            {
+                if (index < resources.command_lists.size() && resources.command_lists[index] != nullptr)
+                {
+                    command_lists.push_back(resources.command_lists[index]);
+                }
+            }
+            result = submit(replay_queue(self, step.queue), replay_device_mask(self, step.device_mask), command_lists);
+            _DAXA_RETURN_IF_ERROR(result, result)
+        }
+        result = daxa_dvc_wait_idle(self);
+        _DAXA_RETURN_IF_ERROR(result, result)
+        out_ns = static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        return DAXA_RESULT_SUCCESS;
+    }
+} // namespace
+
+auto begin_captured_command(std::vector<std::byte> & stream, CaptureCommand command) -> usize
+{
+    usize const begin = stream.size();
+    CaptureCommandHeader const header = {.command = command};
+    append_captured_bytes(stream, capture_bytes(header));
+    return begin;
+}
+
+void append_captured_bytes(std::vector<std::byte> & stream, std::span<std::byte const> bytes)
+{
+    stream.insert(stream.end(), bytes.begin(), bytes.end());
+}
+
+void end_captured_command(std::vector<std::byte> & stream, usize begin)
+{
+    auto const size = static_cast<u32>(stream.size() - begin - sizeof(CaptureCommandHeader));
+    std::memcpy(stream.data() + begin + offsetof(CaptureCommandHeader, size), &size, sizeof(size));
+}
+
+void capture_command(std::vector<std::byte> & stream, CaptureCommand command, std::initializer_list<std::span<std::byte const>> payload)
+{
+    usize const begin = begin_captured_command(stream, command);
+    for (auto const & part : payload)
+    {
+        append_captured_bytes(stream, part);
+    }
+    end_captured_command(stream, begin);
+}
+
+void capture_buffer_created(daxa_Device self, daxa_BufferId id)
+{
+    CaptureState & state = self->capture;
+    std::unique_lock const lock{state.mtx};
+    if (state.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_buffer_record(state, id, self->slot(id));
+    }
+}
+
+void capture_image_created(daxa_Device self, daxa_ImageId id)
+{
+    CaptureState & state = self->capture;
+    std::unique_lock const lock{state.mtx};
+    if (state.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_image_record(state, id, self->slot(id));
+    }
+}
+
+void capture_image_view_created(daxa_Device self, daxa_ImageViewId id)
+{
+    CaptureState & state = self->capture;
+    std::unique_lock const lock{state.mtx};
+    if (state.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_image_view_record(state, id, self->slot(id));
+    }
+}
+
+void capture_sampler_created(daxa_Device self, daxa_SamplerId id)
+{
+    CaptureState & state = self->capture;
+    std::unique_lock const lock{state.mtx};
+    if (state.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_sampler_record(state, id, self->slot(id));
+    }
+}
+
+auto capture_pipeline(daxa_Device self, ImplPipeline & pipeline, CaptureRecordType type, u64 generation) -> u64
+{
+    CaptureState & state = self->capture;
+    std::unique_lock const lock{state.mtx};
+    if (state.active_generation.load(std::memory_order_relaxed) != generation)
+    {
+        return CAPTURE_MISSING_INDEX;
+    }
+    if (pipeline.capture_generation != generation)
+    {
+        pipeline.capture_generation = generation;
+        pipeline.capture_index = state.next_pipeline_index++;
+        CapturePipelineRecord const record = {.index = pipeline.capture_index};
+        state.write_failed |= !write_capture_record(state.file, type, {capture_bytes(record), pipeline.capture_record});
+    }
+    return pipeline.capture_index;
+}
+
+void capture_submits(daxa_Device self, std::span<daxa_CommandSubmitInfo const> infos)
+{
+    CaptureState & state = self->capture;
+    std::unique_lock const lock{state.mtx};
+    u64 const generation = state.active_generation.load(std::memory_order_relaxed);
+    if (generation == 0)
+    {
+        return;
+    }
+    for (auto const & info : infos)
+    {
+        for (auto const & commands : std::span{info.command_lists, info.command_list_count})
+        {
+            ExecutableCommandListData & data = commands->data;
+            if (data.capture_generation != generation || data.capture_index.has_value())
+            {
+                continue;
+            }
+            data.capture_index = state.next_command_list_index++;
+            CaptureCommandListRecord const record = {.index = data.capture_index.value(), .info = commands->cmd_recorder->info};
+            state.write_failed |= !write_capture_record(state.file, CaptureRecordType::COMMAND_LIST, {capture_bytes(record), data.capture_commands});
+        }
+    }
+    // The submit holds the lifetime lock, zombie slots can not be cleared while the contents are compared.
+    if (state.capture_buffer_contents)
+    {
+        capture_host_visible_buffer_contents(self, capture_zombie_indices(self).buffers);
+    }
+    std::vector<u64> indices = {};
+    for (auto const & info : infos)
+    {
+        indices.clear();
+        for (auto const & commands : std::span{info.command_lists, info.command_list_count})
+        {
+            bool const captured = commands->data.capture_generation == generation && commands->data.capture_index.has_value();
+            indices.push_back(captured ? commands->data.capture_index.value() : CAPTURE_MISSING_INDEX);
+        }
+        CaptureSubmitRecord const record = {.queue = info.queue, .device_mask = info.device_mask, .command_list_count = indices.size()};
+        state.write_failed |= !write_capture_record(state.file, CaptureRecordType::SUBMIT, {capture_bytes(record), std::as_bytes(std::span{indices})});
+    }
+}
+
+auto capture_pipeline_record(daxa_ComputePipelineInfo const & info) -> std::vector<std::byte>
+{
+    std::vector<std::byte> record = {};
+    append_captured_bytes(record, capture_bytes(info));
+    append_capture_shader(record, info.shader_info);
+    return record;
+}
+
+auto capture_pipeline_record(daxa_RasterPipelineInfo const & info) -> std::vector<std::byte>
+{
+    std::vector<std::byte> record = {};
+    append_captured_bytes(record, capture_bytes(info));
+    for_each_raster_shader(
+        info,
+        [&](auto const & shader)
+        {
+            if (shader.has_value)
+            {
+                append_capture_shader(record, shader.value);
+            }
+        });
+    return record;
+}
+
+auto daxa_dvc_begin_capture(daxa_Device self, daxa_CaptureInfo const * info) -> daxa_Result
+{
+    if (!self->info.capturable)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_NOT_CAPTURABLE;
+    }
+    CaptureState & state = self->capture;
+    if (state.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        return DAXA_RESULT_ERROR_CAPTURE_MISMATCH;
+    }
+
+    std::ofstream file{info->path, std::ios::binary | std::ios::trunc};
+    CaptureFileHeader const header = {};
+    file.write(r_cast<char const *>(&header), sizeof(header));
+    if (!file)
+    {
+        return DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID;
+    }
+    if (info->capture_buffer_contents != 0)
+    {
+        auto const result = capture_device_local_buffer_contents(self, file);
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+
+    std::shared_lock const lifetime_lock{self->gpu_sro_table.lifetime_lock};
+    std::unique_lock const lock{state.mtx};
+    if (state.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        return DAXA_RESULT_ERROR_CAPTURE_MISMATCH;
+    }
+    state.file = std::move(file);
+    state.capture_buffer_contents = info->capture_buffer_contents != 0;
+    state.write_failed = false;
+    state.next_pipeline_index = 0;
+    state.next_command_list_index = 0;
+    state.content_page_hashes.clear();
+    // Resources created from here on are written by their creation, the ones alive now by the snapshot below.
+    // Resources created during the snapshot may be written twice, replays keep the later record.
+    state.active_generation.store(++state.last_generation, std::memory_order_relaxed);
+
+    auto const zombies = capture_zombie_indices(self);
+    for_each_captured_slot(
+        self->gpu_sro_table.buffer_slots, zombies.buffers,
+        [&](GPUResourceId id, ImplBufferSlot const & slot)
+        {
+            if (slot.vk_buffer != VK_NULL_HANDLE)
+            {
+                capture_buffer_record(state, std::bit_cast<daxa_BufferId>(id), slot);
+            }
+        });
+    for_each_captured_slot(
+        self->gpu_sro_table.image_slots, zombies.images,
+        [&](GPUResourceId id, ImplImageSlot const & slot)
+        {
+            // Image view slots without an image are views created with daxa_dvc_create_image_view.
+            if (slot.vk_image != VK_NULL_HANDLE)
+            {
+                capture_image_record(state, std::bit_cast<daxa_ImageId>(id), slot);
+            }
+            else if (slot.view_slot.vk_image_view != VK_NULL_HANDLE)
+            {
+                capture_image_view_record(state, std::bit_cast<daxa_ImageViewId>(id), slot.view_slot);
+            }
+        });
+    for_each_captured_slot(
+        self->gpu_sro_table.sampler_slots, zombies.samplers,
+        [&](GPUResourceId id, ImplSamplerSlot const & slot)
+        {
+            if (slot.vk_sampler != VK_NULL_HANDLE)
+            {
+                capture_sampler_record(state, std::bit_cast<daxa_SamplerId>(id), slot);
+            }
+        });
+    if (state.capture_buffer_contents)
+    {
+        capture_host_visible_buffer_contents(self, zombies.buffers);
+    }
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_end_capture(daxa_Device self) -> daxa_Result
+{
+    CaptureState & state = self->capture;
+    std::unique_lock const lock{state.mtx};
+    if (state.active_generation.load(std::memory_order_relaxed) == 0)
+    {
+        return DAXA_RESULT_ERROR_CAPTURE_MISMATCH;
+    }
+    state.active_generation.store(0, std::memory_order_relaxed);
+    state.file.close();
+    bool const failed = state.write_failed || state.file.fail();
+    state.file = {};
+    state.content_page_hashes.clear();
+    return failed ? DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID : DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_replay_capture(daxa_Device self, daxa_ReplayInfo const * info, daxa_ReplayStats * out_stats) -> daxa_Result
+{
+    std::vector<std::byte> const file = read_capture_file(info->path);
+    ReplayCapture capture = {};
+    if (file.empty() || !parse_capture(file, capture))
+    {
+        return DAXA_RESULT_ERROR_CAPTURE_FILE_INVALID;
+    }
+    daxa_ReplayStats stats = {};
+    stats.failed_creation_count = capture.conflicting_resource_count;
+    ReplayResources resources = {};
+    defer
+    {
+        destroy_replay_resources(self, resources);
+        *out_stats = stats;
+    };
+
+    auto result = create_replay_resources(self, capture, resources, stats);
+    _DAXA_RETURN_IF_ERROR(result, result)
+    create_replay_pipelines(self, capture, resources, stats);
+
+    resources.command_lists.resize(capture.command_lists.size());
+    for (usize index = 0; index < capture.command_lists.size(); ++index)
+    {
+        if (capture.command_lists[index].has_value())
+        {
+            resources.command_lists[index] = record_replay_command_list(self, capture.command_lists[index].value(), resources, stats);
+            stats.command_list_count += resources.command_lists[index] != nullptr ? 1 : 0;
+        }
+    }
+    for (auto const & step : capture.steps)
+    {
+        for (u64 index : step.command_lists)
+        {
+            if (index >= resources.command_lists.size() || resources.command_lists[index] == nullptr)
+            {
+                stats.skipped_command_list_count += 1;
+            }
+        }
+    }
+    stats.submit_count = static_cast<u32>(capture.steps.size());
+
+    std::vector<ReplayHostWrite> host_writes = {};
+    result = prepare_replay_contents(self, capture, resources, host_writes);
+    _DAXA_RETURN_IF_ERROR(result, result)
+
+    u32 const repeat_count = std::max(info->repeat_count, 1u);
+    stats.min_ns = ~0ull;
+    u64 total_ns = 0;
+    for (u32 repetition = 0; repetition < repeat_count; ++repetition)
+    {
+        u64 ns = 0;
+        result = replay_steps(self, capture, resources, host_writes, ns);
+        _DAXA_RETURN_IF_ERROR(result, result)
+        stats.min_ns = std::min(stats.min_ns, ns);
+        stats.max_ns = std::max(stats.max_ns, ns);
+        total_ns += ns;
+    }
+    stats.mean_ns = total_ns / repeat_count;
+    return DAXA_RESULT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "impl_core.hpp"
+
+#include <daxa/c/device.h>
+
+#include <atomic>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Capture files, see daxa_dvc_begin_capture and daxa_dvc_replay_capture.
+// A CaptureFileHeader followed by records, each a CaptureRecordHeader and its payload.
+// Payloads are the raw daxa C structs, captures are only replayable by builds for the same platform of the same daxa version.
+
+static inline constexpr u32 CAPTURE_FILE_MAGIC = 0x50435844; // "DXCP"
+static inline constexpr u32 CAPTURE_FILE_VERSION = 1;
+// Host visible buffer contents are compared and captured in pages of this size.
+static inline constexpr usize CAPTURE_CONTENT_PAGE_SIZE = 4096;
+// Index of a command list or pipeline that is not part of the capture.
+static inline constexpr u64 CAPTURE_MISSING_INDEX = ~0ull;
+
+struct CaptureFileHeader
+{
+    u32 magic = CAPTURE_FILE_MAGIC;
+    u32 version = CAPTURE_FILE_VERSION;
+};
+
+enum struct CaptureRecordType : u32
+{
+    CREATE_BUFFER = 1,
+    CREATE_IMAGE = 2,
+    CREATE_IMAGE_VIEW = 3,
+    CREATE_SAMPLER = 4,
+    BUFFER_CONTENTS = 5,
+    COMPUTE_PIPELINE = 6,
+    RASTER_PIPELINE = 7,
+    COMMAND_LIST = 8,
+    SUBMIT = 9,
+};
+
+struct CaptureRecordHeader
+{
+    CaptureRecordType type = {};
+    u32 padding = {};
+    u64 size = {};
+};
+
+// Commands of a captured command list, each a CaptureCommandHeader followed by the raw info the command was called with.
+enum struct CaptureCommand : u32
+{
+    // Commands that can not be replayed, like acceleration structure builds, queries and secondary command lists.
+    UNSUPPORTED = 0,
+    SET_RASTERIZATION_SAMPLES,
+    COPY_BUFFER_TO_BUFFER,
+    COPY_BUFFER_TO_IMAGE,
+    COPY_IMAGE_TO_BUFFER,
+    COPY_IMAGE_TO_IMAGE,
+    BLIT_IMAGE_TO_IMAGE,
+    CLEAR_BUFFER,
+    CLEAR_IMAGE,
+    PIPELINE_BARRIER,
+    PIPELINE_BARRIER_IMAGE_TRANSITION,
+    // Offset, size and the pushed bytes.
+    PUSH_CONSTANT,
+    // Field count, then offset, size and the pushed bytes of each field.
+    PUSH_CONSTANT_RANGE,
+    // Index of the pipeline in the capture.
+    SET_COMPUTE_PIPELINE,
+    SET_RASTER_PIPELINE,
+    DISPATCH,
+    DISPATCH_INDIRECT,
+    BEGIN_CONDITIONAL_RENDERING,
+    END_CONDITIONAL_RENDERING,
+    BEGIN_RENDERPASS,
+    END_RENDERPASS,
+    SET_VIEWPORT,
+    SET_SCISSOR,
+    SET_DEPTH_BIAS,
+    SET_INDEX_BUFFER,
+    DRAW,
+    DRAW_INDEXED,
+    // The info followed by the ranges.
+    DRAW_MULTI,
+    DRAW_MULTI_INDEXED,
+    DRAW_INDIRECT,
+    DRAW_INDIRECT_COUNT,
+    // The three workgroup counts.
+    DRAW_MESH_TASKS,
+    DRAW_MESH_TASKS_INDIRECT,
+    DRAW_MESH_TASKS_INDIRECT_COUNT,
+    BEGIN_LABEL,
+    END_LABEL,
+    SET_DEVICE_MASK,
+};
+
+struct CaptureCommandHeader
+{
+    CaptureCommand command = {};
+    u32 size = {};
+};
+
+struct CaptureState
+{
+    // Nonzero while a capture is active, unique for each capture of the device.
+    // Command lists remember it when they begin recording, only lists begun during a capture are written into it.
+    std::atomic_uint64_t active_generation = {};
+    // Guards everything below and the capture indices of pipelines and command lists.
+    // Taken after the resource lifetime lock, never before it.
+    std::mutex mtx = {};
+    u64 last_generation = {};
+    std::ofstream file = {};
+    bool capture_buffer_contents = {};
+    bool write_failed = {};
+    u64 next_pipeline_index = {};
+    u64 next_command_list_index = {};
+    // Page hashes of the host visible buffer contents last written, keyed by the buffer id.
+    std::unordered_map<u64, std::vector<u64>> content_page_hashes = {};
+};
+
+struct ImplPipeline;
+
+// Appending a command is split into begin, append and end, for commands with a variable number of parts.
+auto begin_captured_command(std::vector<std::byte> & stream, CaptureCommand command) -> usize;
+void append_captured_bytes(std::vector<std::byte> & stream, std::span<std::byte const> bytes);
+void end_captured_command(std::vector<std::byte> & stream, usize begin);
+void capture_command(std::vector<std::byte> & stream, CaptureCommand command, std::initializer_list<std::span<std::byte const>> payload);
+
+template <typename T>
+auto capture_bytes(T const & value) -> std::span<std::byte const>
+{
+    return std::as_bytes(std::span<T const, 1>{&value, 1});
+}
+
+// Called by the resource creation functions while a capture is active.
+void capture_buffer_created(daxa_Device self, daxa_BufferId id);
+void capture_image_created(daxa_Device self, daxa_ImageId id);
+void capture_image_view_created(daxa_Device self, daxa_ImageViewId id);
+void capture_sampler_created(daxa_Device self, daxa_SamplerId id);
+// Writes the pipeline on its first use in the capture of the given generation.
+// Returns its index in the capture, CAPTURE_MISSING_INDEX when that capture already ended.
+auto capture_pipeline(daxa_Device self, ImplPipeline & pipeline, CaptureRecordType type, u64 generation) -> u64;
+// Writes the submitted command lists not written yet, the changed host visible buffer contents and the submits.
+void capture_submits(daxa_Device self, std::span<daxa_CommandSubmitInfo const> infos);
+
+// Create info and spirv of a pipeline, kept by pipelines of capturable devices and written into captures when first used.
+auto capture_pipeline_record(daxa_ComputePipelineInfo const & info) -> std::vector<std::byte>;
+auto capture_pipeline_record(daxa_RasterPipelineInfo const & info) -> std::vector<std::byte>;
@@ -2,6 +2,9 @@
 
 #include <daxa/c/types.h>
 #include <utility>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
 
 #include "impl_sync.hpp"
 #include "impl_device.hpp"
@@ -56,40 +59,89 @@ auto get_vk_dependency_info(
     };
 }
 
-auto CommandPoolPool::get(daxa_Device device) -> VkCommandPool
+auto CommandPoolPool::current_thread_shard() -> u32
 {
-    VkCommandPool pool = {};
-    if (pools_and_buffers.empty())
-    {
-        VkCommandPoolCreateInfo const vk_command_pool_create_info{
-            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-            .queueFamilyIndex = this->queue_family_index,
-        };
+    static std::atomic_uint32_t next_shard = {};
+    thread_local u32 const shard = next_shard.fetch_add(1, std::memory_order_relaxed) % COMMAND_POOL_POOL_SHARD_COUNT;
+    return shard;
+}
 
-        vkCreateCommandPool(device->vk_device, &vk_command_pool_create_info, nullptr, &pool);
+auto CommandPoolPool::get(daxa_Device device, u32 shard, RecycledCommandPool & out_pool) -> daxa_Result
+{
+    {
+        std::unique_lock const lock{shards.at(shard).mtx};
+        auto & pools = shards.at(shard).pools;
+        if (!pools.empty())
+        {
+            out_pool = std::move(pools.back());
+            pools.pop_back();
+            return DAXA_RESULT_SUCCESS;
+        }
     }
-    else
+    // Command buffers are never reset on their own, only with their whole pool.
+    VkCommandPoolCreateInfo const vk_command_pool_create_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = {},
+        .queueFamilyIndex = this->queue_family_index,
+    };
+    out_pool = {};
+    return static_cast<daxa_Result>(vkCreateCommandPool(device->vk_device, &vk_command_pool_create_info, nullptr, &out_pool.vk_cmd_pool));
+}
+
+void CommandPoolPool::put_back(u32 shard, RecycledCommandPool && pool)
+{
+    std::unique_lock const lock{shards.at(shard).mtx};
+    shards.at(shard).pools.push_back(std::move(pool));
+}
+
+auto ExecutableCommandListDataPool::get(u32 shard) -> ExecutableCommandListData
+{
+    std::unique_lock const lock{shards.at(shard).mtx};
+    auto & datas = shards.at(shard).datas;
+    if (datas.empty())
     {
-        pool = pools_and_buffers.back();
-        pools_and_buffers.pop_back();
+        return {};
     }
-    return pool;
+    ExecutableCommandListData data = std::move(datas.back());
+    datas.pop_back();
+    return data;
 }
 
-void CommandPoolPool::put_back(VkCommandPool pool)
+void ExecutableCommandListDataPool::put_back(u32 shard, ExecutableCommandListData && data)
 {
-    pools_and_buffers.push_back(pool);
+    data.vk_cmd_buffer = {};
+    data.deferred_destructions.clear();
+    data.submit_timeline_listeners.clear();
+    data.used_buffers.clear();
+    data.used_images.clear();
+    data.used_image_views.clear();
+    data.used_samplers.clear();
+    data.used_tlass.clear();
+    data.used_blass.clear();
+    data.secondary_command_lists.clear();
+    data.capture_generation = {};
+    data.capture_commands.clear();
+    data.capture_index = {};
+    std::unique_lock const lock{shards.at(shard).mtx};
+    if (shards.at(shard).datas.size() < SHARD_CAPACITY)
+    {
+        shards.at(shard).datas.push_back(std::move(data));
+    }
 }
 
 void CommandPoolPool::cleanup(daxa_Device device)
 {
-    for (auto * pool : pools_and_buffers)
+    for (auto & shard : shards)
     {
-        vkDestroyCommandPool(device->vk_device, pool, nullptr);
+        std::unique_lock const lock{shard.mtx};
+        // Destroying the pools frees their command buffers.
+        for (auto & pool : shard.pools)
+        {
+            vkDestroyCommandPool(device->vk_device, pool.vk_cmd_pool, nullptr);
+        }
+        shard.pools.clear();
     }
-    pools_and_buffers.clear();
 }
 
 template <typename T>
@@ -226,6 +278,10 @@ auto check_ids(daxa_CommandRecorder self, Args... args) -> daxa_Result
 template <typename... Args>
 void remember_ids(daxa_CommandRecorder self, Args... args)
 {
+    if (self->info.disable_submit_id_validation != 0)
+    {
+        return;
+    }
     (remember_ids(self, args), ...);
 }
 
@@ -241,12 +297,387 @@ void remember_ids(daxa_CommandRecorder self, Args... args)
     _DAXA_CHECK_IDS(__VA_ARGS__)         \
     _DAXA_REMEMBER_IDS(__VA_ARGS__)
 
+// Appends the command and its raw payload to the capture stream of command lists begun during a capture.
+#define _DAXA_CAPTURE_COMMAND(SELF, COMMAND, ...)                                                                              \
+    if ((SELF)->current_command_data.capture_generation != 0)                                                                 \
+    {                                                                                                                         \
+        capture_command((SELF)->current_command_data.capture_commands, CaptureCommand::COMMAND, {__VA_ARGS__});               \
+    }
+
+// Draws and dispatches are dropped while a pending pipeline is bound, see daxa_dvc_create_compute_pipeline_async.
+#define _DAXA_SKIP_IF_PIPELINE_PENDING(SELF, ...)             \
+    if ((SELF)->bound_state.pending_pipeline)                 \
+    {                                                         \
+        (SELF)->stats.skipped_pending_pipeline_commands += 1; \
+        return __VA_ARGS__;                                   \
+    }
+
+auto gpu_sro_table_bind_point_index(VkPipelineBindPoint bind_point) -> usize
+{
+    switch (bind_point)
+    {
+    case VK_PIPELINE_BIND_POINT_COMPUTE: return 0;
+    case VK_PIPELINE_BIND_POINT_GRAPHICS: return 1;
+    default: return 2;
+    }
+}
+
+void bind_gpu_sro_table(daxa_CommandRecorder self, VkPipelineBindPoint bind_point, VkPipelineLayout vk_pipeline_layout)
+{
+    auto const & table = self->device->gpu_sro_table;
+    // Bound sets stay valid for all pipelines of identical layout, only a layout with another push constant size disturbs them.
+    auto & binding = self->bound_state.gpu_sro_table_bindings.at(gpu_sro_table_bind_point_index(bind_point));
+    bool const sets_current = table.uses_descriptor_buffer || table.generation.load(std::memory_order_acquire) == binding.generation;
+    if (binding.layout == vk_pipeline_layout && sets_current)
+    {
+        self->stats.filtered_gpu_sro_table_binds += 1;
+        return;
+    }
+    binding.layout = vk_pipeline_layout;
+    if (!table.uses_descriptor_buffer)
+    {
+        auto const sets = table.current_descriptor_sets(self->bound_gpu_sro_table_generation);
+        binding.generation = self->bound_gpu_sro_table_generation;
+        self->current_command_data.oldest_bound_gpu_sro_table_generation = std::min(self->current_command_data.oldest_bound_gpu_sro_table_generation, self->bound_gpu_sro_table_generation);
+        vkCmdBindDescriptorSets(self->current_command_data.vk_cmd_buffer, bind_point, vk_pipeline_layout, 0, static_cast<u32>(sets.size()), sets.data(), 0, nullptr);
+        return;
+    }
+    // The descriptor buffer only has to be bound once per command buffer, pipeline changes only need to reset the set offsets.
+    if (!self->current_command_data.descriptor_buffer_bound)
+    {
+        VkDescriptorBufferBindingInfoEXT const binding_info{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+            .pNext = nullptr,
+            .address = table.descriptor_buffer_device_address,
+            .usage = table.descriptor_buffer_usage,
+        };
+        self->device->vkCmdBindDescriptorBuffersEXT(self->current_command_data.vk_cmd_buffer, 1, &binding_info);
+        self->current_command_data.descriptor_buffer_bound = true;
+    }
+    std::array<u32, DESCRIPTOR_SET_COUNT> const buffer_indices = {};
+    self->device->vkCmdSetDescriptorBufferOffsetsEXT(
+        self->current_command_data.vk_cmd_buffer,
+        bind_point,
+        vk_pipeline_layout,
+        0,
+        DESCRIPTOR_SET_COUNT,
+        buffer_indices.data(),
+        table.descriptor_buffer_set_offsets.data());
+}
+
+// Shader objects read the WithCount viewport and scissor state, pipelines the plain one.
+void emit_viewport(daxa_CommandRecorder self, VkViewport const & viewport)
+{
+    if (self->bound_state.graphics_shader_objects)
+    {
+        vkCmdSetViewportWithCount(self->current_command_data.vk_cmd_buffer, 1, &viewport);
+    }
+    else
+    {
+        vkCmdSetViewport(self->current_command_data.vk_cmd_buffer, 0, 1, &viewport);
+    }
+}
+
+void emit_scissor(daxa_CommandRecorder self, VkRect2D const & scissor)
+{
+    if (self->bound_state.graphics_shader_objects)
+    {
+        vkCmdSetScissorWithCount(self->current_command_data.vk_cmd_buffer, 1, &scissor);
+    }
+    else
+    {
+        vkCmdSetScissor(self->current_command_data.vk_cmd_buffer, 0, 1, &scissor);
+    }
+}
+
+// Switching between shader objects and pipelines changes which viewport and scissor state is read, the cached values are set again in the other form.
+void set_graphics_shader_objects_bound(daxa_CommandRecorder self, bool graphics_shader_objects)
+{
+    if (self->bound_state.graphics_shader_objects == graphics_shader_objects)
+    {
+        return;
+    }
+    self->bound_state.graphics_shader_objects = graphics_shader_objects;
+    if (self->bound_state.viewport.has_value())
+    {
+        emit_viewport(self, self->bound_state.viewport.value());
+    }
+    if (self->bound_state.scissor.has_value())
+    {
+        emit_scissor(self, self->bound_state.scissor.value());
+    }
+}
+
+// The table may have grown since the pipeline was set, new ids are only visible in the new descriptor sets.
+void rebind_gpu_sro_table_if_grown(daxa_CommandRecorder self)
+{
+    auto const & table = self->device->gpu_sro_table;
+    if (table.generation.load(std::memory_order_acquire) == self->bound_gpu_sro_table_generation)
+    {
+        return;
+    }
+    if (auto const * compute_pipeline = daxa::get_if<daxa_ComputePipeline>(&self->current_pipeline))
+    {
+        bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_COMPUTE, (*compute_pipeline)->vk_pipeline_layout);
+    }
+    else if (auto const * raster_pipeline = daxa::get_if<daxa_RasterPipeline>(&self->current_pipeline))
+    {
+        bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_GRAPHICS, (*raster_pipeline)->vk_pipeline_layout);
+    }
+    else if (auto const * ray_tracing_pipeline = daxa::get_if<daxa_RayTracingPipeline>(&self->current_pipeline))
+    {
+        bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, (*ray_tracing_pipeline)->vk_pipeline_layout);
+    }
+    else if (auto const * compute_shader_object = daxa::get_if<daxa_ShaderObject>(&self->current_pipeline))
+    {
+        bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_COMPUTE, (*compute_shader_object)->vk_pipeline_layout);
+    }
+    else if (auto const * raster_shader_objects = daxa::get_if<daxa_ImplCommandRecorder::RasterShaderObjects>(&self->current_pipeline))
+    {
+        bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_GRAPHICS, raster_shader_objects->vk_pipeline_layout);
+    }
+}
+
+// Pending pipelines are replaced by their fallback while it is ready, nullptr when neither can be bound.
+template <typename PipelineT>
+auto resolve_async_pipeline(PipelineT pipeline) -> PipelineT
+{
+    if (pipeline->load_status() == DAXA_PIPELINE_STATUS_READY)
+    {
+        return pipeline;
+    }
+    auto const fallback = static_cast<PipelineT>(pipeline->async_fallback);
+    if (fallback != nullptr && fallback->load_status() == DAXA_PIPELINE_STATUS_READY)
+    {
+        return fallback;
+    }
+    return nullptr;
+}
+
+// Binds only the layout of a pipeline that can not be bound yet, so push constants and the resource table keep working.
+void bind_pending_pipeline_layout(daxa_CommandRecorder self, VkPipelineBindPoint bind_point, ImplPipeline const & pipeline, u32 push_constant_size)
+{
+    daxa_cmd_flush_barriers(self);
+    self->bound_state.pipeline = {};
+    self->bound_state.pending_pipeline = true;
+    self->bound_state.pipeline_layout = pipeline.vk_pipeline_layout;
+    self->bound_state.push_constant_size = push_constant_size;
+    bind_gpu_sro_table(self, bind_point, pipeline.vk_pipeline_layout);
+}
+
+// Memory barriers with identical stage masks are equivalent to one barrier with the combined access masks.
+// Returns the number of barriers removed.
+auto merge_memory_barriers(std::vector<VkMemoryBarrier2> & barriers) -> u64
+{
+    usize merged_count = 0;
+    for (auto const & barrier : barriers)
+    {
+        auto const merged_end = barriers.begin() + static_cast<isize>(merged_count);
+        auto const match = std::find_if(barriers.begin(), merged_end, [&](VkMemoryBarrier2 const & merged)
+                                        { return merged.srcStageMask == barrier.srcStageMask && merged.dstStageMask == barrier.dstStageMask; });
+        if (match != merged_end)
+        {
+            match->srcAccessMask |= barrier.srcAccessMask;
+            match->dstAccessMask |= barrier.dstAccessMask;
+            continue;
+        }
+        barriers[merged_count++] = barrier;
+    }
+    auto const removed = static_cast<u64>(barriers.size() - merged_count);
+    barriers.resize(merged_count);
+    return removed;
+}
+
+// Extends a by b when both make the same transition and b continues a's mip or array layer range.
+auto try_collapse_image_barrier(VkImageMemoryBarrier2 & a, VkImageMemoryBarrier2 const & b) -> bool
+{
+    auto const & ar = a.subresourceRange;
+    auto const & br = b.subresourceRange;
+    bool const same_transition =
+        a.image == b.image &&
+        a.oldLayout == b.oldLayout && a.newLayout == b.newLayout &&
+        a.srcStageMask == b.srcStageMask && a.srcAccessMask == b.srcAccessMask &&
+        a.dstStageMask == b.dstStageMask && a.dstAccessMask == b.dstAccessMask &&
+        a.srcQueueFamilyIndex == b.srcQueueFamilyIndex && a.dstQueueFamilyIndex == b.dstQueueFamilyIndex &&
+        ar.aspectMask == br.aspectMask;
+    if (!same_transition || ar.levelCount == VK_REMAINING_MIP_LEVELS || ar.layerCount == VK_REMAINING_ARRAY_LAYERS)
+    {
+        return false;
+    }
+    bool const same_mips = ar.baseMipLevel == br.baseMipLevel && ar.levelCount == br.levelCount;
+    bool const same_layers = ar.baseArrayLayer == br.baseArrayLayer && ar.layerCount == br.layerCount;
+    if (same_mips && br.baseArrayLayer == ar.baseArrayLayer + ar.layerCount)
+    {
+        a.subresourceRange.layerCount += br.layerCount;
+        return true;
+    }
+    if (same_layers && br.baseMipLevel == ar.baseMipLevel + ar.levelCount)
+    {
+        a.subresourceRange.levelCount += br.levelCount;
+        return true;
+    }
+    return false;
+}
+
+// Only neighbouring barriers are collapsed, transitions of whole mip chains or array slices are usually recorded in order.
+// Returns the number of barriers removed.
+auto merge_image_barriers(std::vector<VkImageMemoryBarrier2> & barriers) -> u64
+{
+    usize merged_count = 0;
+    for (auto const & barrier : barriers)
+    {
+        if (merged_count > 0 && try_collapse_image_barrier(barriers[merged_count - 1], barrier))
+        {
+            continue;
+        }
+        barriers[merged_count++] = barrier;
+    }
+    auto const removed = static_cast<u64>(barriers.size() - merged_count);
+    barriers.resize(merged_count);
+    return removed;
+}
+
+// The next renderpass continues the pending one when it renders to the same attachments in the same area
+// without clearing them and the pending one kept their contents. Resolves happen at the end of a renderpass,
+// renderpasses with resolves are never continued as the intermediate resolve would be lost.
+auto continues_renderpass(daxa_RenderPassBeginInfo const & pending, daxa_RenderPassBeginInfo const & next) -> bool
+{
+    auto continues_attachment = [](daxa_RenderAttachmentInfo const & a, daxa_RenderAttachmentInfo const & b)
+    {
+        return std::bit_cast<u64>(a.image_view) == std::bit_cast<u64>(b.image_view) && a.layout == b.layout &&
+               a.store_op == VK_ATTACHMENT_STORE_OP_STORE &&
+               b.load_op == VK_ATTACHMENT_LOAD_OP_LOAD &&
+               a.resolve.has_value == 0 && b.resolve.has_value == 0;
+    };
+    auto continues_optional_attachment = [&](auto const & a, auto const & b)
+    {
+        return a.has_value == b.has_value && (a.has_value == 0 || continues_attachment(a.value, b.value));
+    };
+    if (pending.secondary_command_lists != 0 || next.secondary_command_lists != 0 ||
+        pending.color_attachments.size != next.color_attachments.size ||
+        std::memcmp(&pending.render_area, &next.render_area, sizeof(VkRect2D)) != 0)
+    {
+        return false;
+    }
+    for (usize i = 0; i < next.color_attachments.size; ++i)
+    {
+        if (!continues_attachment(pending.color_attachments.data[i], next.color_attachments.data[i]))
+        {
+            return false;
+        }
+    }
+    return continues_optional_attachment(pending.depth_attachment, next.depth_attachment) &&
+           continues_optional_attachment(pending.stencil_attachment, next.stencil_attachment);
+}
+
+// Barriers only between attachment accesses of the continued attachments are not needed, rasterization order
+// already orders the attachment accesses of the draws within a renderpass. Layout transitions still end it.
+auto elides_attachment_barriers(daxa_CommandRecorder self, daxa_RenderPassBeginInfo const & next) -> bool
+{
+    constexpr VkPipelineStageFlags2 ATTACHMENT_STAGES =
+        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    if (!self->memory_barrier_batch.empty())
+    {
+        return false;
+    }
+    auto attachment_covers = [&](daxa_ImageViewId view, VkImageMemoryBarrier2 const & barrier)
+    {
+        auto const & view_slot = self->device->slot(view);
+        daxa_ImageMipArraySlice const & slice = view_slot.info.slice;
+        VkImageSubresourceRange const & range = barrier.subresourceRange;
+        return self->device->slot(view_slot.info.image).vk_image == barrier.image &&
+               range.baseMipLevel >= slice.base_mip_level && range.baseMipLevel + range.levelCount <= slice.base_mip_level + slice.level_count &&
+               range.baseArrayLayer >= slice.base_array_layer && range.baseArrayLayer + range.layerCount <= slice.base_array_layer + slice.layer_count;
+    };
+    for (auto const & barrier : self->image_barrier_batch)
+    {
+        bool covered = (barrier.srcStageMask & ~ATTACHMENT_STAGES) == 0 && (barrier.dstStageMask & ~ATTACHMENT_STAGES) == 0 &&
+                       barrier.oldLayout == barrier.newLayout;
+        bool attachment = false;
+        for (usize i = 0; i < next.color_attachments.size; ++i)
+        {
+            attachment = attachment || attachment_covers(next.color_attachments.data[i].image_view, barrier);
+        }
+        attachment = attachment || (next.depth_attachment.has_value != 0 && attachment_covers(next.depth_attachment.value.image_view, barrier));
+        attachment = attachment || (next.stencil_attachment.has_value != 0 && attachment_covers(next.stencil_attachment.value.image_view, barrier));
+        if (!covered || !attachment)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void end_pending_renderpass(daxa_CommandRecorder self)
+{
+    if (self->renderpass_end_pending)
+    {
+        vkCmdEndRendering(self->current_command_data.vk_cmd_buffer);
+        self->renderpass_end_pending = false;
+        self->rendering = {};
+    }
+}
+
+// Labels and timestamps may be recorded inside of renderpasses, they do not end a pending one unless barriers must be flushed.
+void flush_barriers_keeping_pending_renderpass(daxa_CommandRecorder self)
+{
+    if (!self->renderpass_end_pending || !self->memory_barrier_batch.empty() || !self->image_barrier_batch.empty())
+    {
+        daxa_cmd_flush_barriers(self);
+    }
+}
+
+// Secondary recorders are created with the renderpass they continue.
+auto create_command_recorder(daxa_Device device, daxa_CommandRecorderInfo const * info, RenderingInheritance const * opt_inheritance, daxa_CommandRecorder * out_cmd_list) -> daxa_Result
+{
+    auto ret = daxa_ImplCommandRecorder{};
+    ret.device = device;
+    ret.info = *info;
+    ret.cmd_pool_shard = CommandPoolPool::current_thread_shard();
+    ret.memory_barrier_batch.reserve(COMMAND_LIST_BARRIER_INITIAL_BATCH_CAPACITY);
+    ret.image_barrier_batch.reserve(COMMAND_LIST_BARRIER_INITIAL_BATCH_CAPACITY);
+    auto result = device->command_pool_pools[info->queue_family].get(device, ret.cmd_pool_shard, ret.cmd_pool);
+    _DAXA_RETURN_IF_ERROR(result, result)
+    if (opt_inheritance != nullptr)
+    {
+        ret.is_secondary = true;
+        ret.in_renderpass = true;
+        ret.rendering = *opt_inheritance;
+    }
+    result = ret.generate_new_current_command_data();
+    if (result != DAXA_RESULT_SUCCESS)
+    {
+        device->command_pool_pools[info->queue_family].put_back(ret.cmd_pool_shard, std::move(ret.cmd_pool));
+        return result;
+    }
+    if ((ret.device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && ret.info.name.size != 0)
+    {
+        auto cmd_pool_name = ret.info.name;
+        VkDebugUtilsObjectNameInfoEXT const cmd_pool_name_info{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            .pNext = nullptr,
+            .objectType = VK_OBJECT_TYPE_COMMAND_POOL,
+            .objectHandle = std::bit_cast<uint64_t>(ret.cmd_pool.vk_cmd_pool),
+            .pObjectName = cmd_pool_name.data,
+        };
+        ret.device->vkSetDebugUtilsObjectNameEXT(ret.device->vk_device, &cmd_pool_name_info);
+    }
+    // TODO(lifetime): Maybe we should have a try lock variant?
+    ret.device->gpu_sro_table.lifetime_lock.lock_shared();
+    ret.strong_count = 1;
+    device->inc_weak_refcnt();
+    *out_cmd_list = new daxa_ImplCommandRecorder{};
+    **out_cmd_list = std::move(ret);
+    return DAXA_RESULT_SUCCESS;
+}
+
 /// --- End Helpers ---
 
 /// --- Begin API Functions ---
 
 auto daxa_cmd_set_rasterization_samples(daxa_CommandRecorder self, VkSampleCountFlagBits samples) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, SET_RASTERIZATION_SAMPLES, capture_bytes(samples))
     if (self->device->vkCmdSetRasterizationSamplesEXT == nullptr)
     {
         return DAXA_RESULT_ERROR_EXTENSION_NOT_PRESENT;
@@ -258,6 +689,7 @@ auto daxa_cmd_set_rasterization_samples(daxa_CommandRecorder self, VkSampleCount
 
 auto daxa_cmd_copy_buffer_to_buffer(daxa_CommandRecorder self, daxa_BufferCopyInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, COPY_BUFFER_TO_BUFFER, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->src_buffer, info->dst_buffer)
     auto const * vk_buffer_copy = reinterpret_cast<VkBufferCopy const *>(&info->src_offset);
@@ -281,6 +713,7 @@ auto daxa_cmd_copy_buffer_to_buffer(daxa_CommandRecorder self, daxa_BufferCopyIn
 
 auto daxa_cmd_copy_buffer_to_image(daxa_CommandRecorder self, daxa_BufferImageCopyInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, COPY_BUFFER_TO_IMAGE, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     //_DAXA_CHECK_AND_REMEMBER_IDS(self, info->buffer, info->image)
     auto const & img_slot = self->device->slot(info->image);
@@ -305,6 +738,7 @@ auto daxa_cmd_copy_buffer_to_image(daxa_CommandRecorder self, daxa_BufferImageCo
 
 auto daxa_cmd_copy_image_to_buffer(daxa_CommandRecorder self, daxa_ImageBufferCopyInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, COPY_IMAGE_TO_BUFFER, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->image, info->buffer)
     auto const & img_slot = self->device->slot(info->image);
@@ -329,6 +763,7 @@ auto daxa_cmd_copy_image_to_buffer(daxa_CommandRecorder self, daxa_ImageBufferCo
 
 auto daxa_cmd_copy_image_to_image(daxa_CommandRecorder self, daxa_ImageCopyInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, COPY_IMAGE_TO_IMAGE, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->src_image, info->dst_image)
     auto const & src_slot = self->device->slot(info->src_image);
@@ -353,6 +788,7 @@ auto daxa_cmd_copy_image_to_image(daxa_CommandRecorder self, daxa_ImageCopyInfo
 
 auto daxa_cmd_blit_image_to_image(daxa_CommandRecorder self, daxa_ImageBlitInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, BLIT_IMAGE_TO_IMAGE, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->src_image, info->dst_image)
     auto const & src_slot = self->device->slot(info->src_image);
@@ -377,32 +813,65 @@ auto daxa_cmd_blit_image_to_image(daxa_CommandRecorder self, daxa_ImageBlitInfo
 
 auto daxa_cmd_build_acceleration_structures(daxa_CommandRecorder self, daxa_BuildAccelerationStucturesInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     daxa_Result result = DAXA_RESULT_SUCCESS;
     if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING) == 0)
     {
         result = DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING;
     }
     _DAXA_RETURN_IF_ERROR(result, result)
+    // Refits are only valid for structures built with ALLOW_UPDATE, the flags of a refit must match the ones of the original build.
+    for (auto const & tb_info : std::span{info->tlas_build_infos, info->tlas_build_info_count})
+    {
+        if (tb_info.update != 0 && (tb_info.flags & DAXA_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE) == 0)
+        {
+            return DAXA_RESULT_ERROR_ACCELERATION_STRUCTURE_UPDATE_WITHOUT_ALLOW_UPDATE;
+        }
+    }
+    for (auto const & bb_info : std::span{info->blas_build_infos, info->blas_build_info_count})
+    {
+        if (bb_info.update != 0 && (bb_info.flags & DAXA_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE) == 0)
+        {
+            return DAXA_RESULT_ERROR_ACCELERATION_STRUCTURE_UPDATE_WITHOUT_ALLOW_UPDATE;
+        }
+    }
     daxa_cmd_flush_barriers(self);
     for (auto const & tb_info : std::span{info->tlas_build_infos, info->tlas_build_info_count})
     {
         _DAXA_CHECK_IDS(self, tb_info.dst_tlas)
+        if (tb_info.update != 0 && tb_info.src_tlas.value != 0)
+        {
+            _DAXA_CHECK_IDS(self, tb_info.src_tlas)
+        }
     }
     for (auto const & bb_info : std::span{info->blas_build_infos, info->blas_build_info_count})
     {
         _DAXA_CHECK_IDS(self, bb_info.dst_blas)
+        if (bb_info.update != 0 && bb_info.src_blas.value != 0)
+        {
+            _DAXA_CHECK_IDS(self, bb_info.src_blas)
+        }
     }
     for (auto const & tb_info : std::span{info->tlas_build_infos, info->tlas_build_info_count})
     {
         _DAXA_REMEMBER_IDS(self, tb_info.dst_tlas)
+        if (tb_info.update != 0 && tb_info.src_tlas.value != 0)
+        {
+            _DAXA_REMEMBER_IDS(self, tb_info.src_tlas)
+        }
     }
     for (auto const & bb_info : std::span{info->blas_build_infos, info->blas_build_info_count})
     {
         _DAXA_REMEMBER_IDS(self, bb_info.dst_blas)
+        if (bb_info.update != 0 && bb_info.src_blas.value != 0)
+        {
+            _DAXA_REMEMBER_IDS(self, bb_info.src_blas)
+        }
     }
     // TODO(Raytracing): properties validation!
     std::vector<VkAccelerationStructureBuildGeometryInfoKHR> vk_build_geometry_infos;
     std::vector<VkAccelerationStructureGeometryKHR> vk_geometry_infos;
+    std::vector<VkAccelerationStructureTrianglesOpacityMicromapEXT> vk_opacity_micromaps;
     std::vector<u32> primitive_counts;
     std::vector<u32 const *> primitive_counts_ptrs;
     daxa_as_build_info_to_vk(
@@ -413,6 +882,7 @@ auto daxa_cmd_build_acceleration_structures(daxa_CommandRecorder self, daxa_Buil
         info->blas_build_info_count,
         vk_build_geometry_infos,
         vk_geometry_infos,
+        vk_opacity_micromaps,
         primitive_counts,
         primitive_counts_ptrs);
     // Convert the primitive count arrays to build range arrays:
@@ -442,8 +912,242 @@ auto daxa_cmd_build_acceleration_structures(daxa_CommandRecorder self, daxa_Buil
     return result;
 }
 
+auto daxa_cmd_write_blas_compacted_sizes(daxa_CommandRecorder self, daxa_WriteBlasCompactedSizesInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING) == 0)
+    {
+        return DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING;
+    }
+    daxa_ImplQueryPool const & query_pool = **info->query_pool;
+    if (query_pool.info.query_type != VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR)
+    {
+        return DAXA_RESULT_ERROR_INVALID_QUERY_TYPE;
+    }
+    if (info->first_query_index + info->blas_count > query_pool.info.query_count)
+    {
+        return DAXA_RESULT_RANGE_OUT_OF_BOUNDS;
+    }
+    daxa_cmd_flush_barriers(self);
+    for (auto const & blas : std::span{info->blas, info->blas_count})
+    {
+        _DAXA_CHECK_IDS(self, blas)
+    }
+    for (auto const & blas : std::span{info->blas, info->blas_count})
+    {
+        _DAXA_REMEMBER_IDS(self, blas)
+    }
+    std::vector<VkAccelerationStructureKHR> vk_acceleration_structures = {};
+    vk_acceleration_structures.reserve(info->blas_count);
+    for (auto const & blas : std::span{info->blas, info->blas_count})
+    {
+        vk_acceleration_structures.push_back(self->device->slot(blas).vk_acceleration_structure);
+    }
+    self->device->vkCmdWriteAccelerationStructuresPropertiesKHR(
+        self->current_command_data.vk_cmd_buffer,
+        static_cast<u32>(vk_acceleration_structures.size()),
+        vk_acceleration_structures.data(),
+        VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+        query_pool.vk_query_pool,
+        info->first_query_index);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_copy_acceleration_structure(daxa_CommandRecorder self, daxa_CopyAccelerationStructureInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING) == 0)
+    {
+        return DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING;
+    }
+    daxa_cmd_flush_barriers(self);
+    DAXA_CHECK_AND_REMEMBER_IDS(self, info->src_blas, info->dst_blas)
+    VkCopyAccelerationStructureInfoKHR const vk_copy_info{
+        .sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR,
+        .pNext = nullptr,
+        .src = self->device->slot(info->src_blas).vk_acceleration_structure,
+        .dst = self->device->slot(info->dst_blas).vk_acceleration_structure,
+        .mode = info->mode,
+    };
+    self->device->vkCmdCopyAccelerationStructureKHR(self->current_command_data.vk_cmd_buffer, &vk_copy_info);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_build_micromaps(daxa_CommandRecorder self, daxa_BuildMicromapsInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP) == 0)
+    {
+        return DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED;
+    }
+    daxa_cmd_flush_barriers(self);
+    std::vector<VkMicromapBuildInfoEXT> vk_build_infos = {};
+    vk_build_infos.reserve(info->build_count);
+    for (auto const & build : std::span{info->builds, info->build_count})
+    {
+        vk_build_infos.push_back(daxa_micromap_build_info_to_vk(build));
+    }
+    self->device->vkCmdBuildMicromapsEXT(
+        self->current_command_data.vk_cmd_buffer,
+        static_cast<u32>(vk_build_infos.size()),
+        vk_build_infos.data());
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_begin_video_coding(daxa_CommandRecorder self, daxa_BeginVideoCodingInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0)
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+    daxa_cmd_flush_barriers(self);
+    for (auto const & slot : std::span{info->reference_slots, info->reference_slot_count})
+    {
+        DAXA_CHECK_AND_REMEMBER_IDS(self, slot.picture.view)
+    }
+    std::vector<VkVideoPictureResourceInfoKHR> vk_pictures = {};
+    std::vector<VkVideoReferenceSlotInfoKHR> vk_slots = {};
+    daxa_video_reference_slots_to_vk(self->device, std::span{info->reference_slots, info->reference_slot_count}, vk_pictures, vk_slots);
+    VkVideoBeginCodingInfoKHR const vk_begin_info{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_BEGIN_CODING_INFO_KHR,
+        .pNext = nullptr,
+        .flags = {},
+        .videoSession = info->session->vk_video_session,
+        .videoSessionParameters = info->session->vk_video_session_parameters,
+        .referenceSlotCount = static_cast<u32>(vk_slots.size()),
+        .pReferenceSlots = vk_slots.data(),
+    };
+    self->device->vkCmdBeginVideoCodingKHR(self->current_command_data.vk_cmd_buffer, &vk_begin_info);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_end_video_coding(daxa_CommandRecorder self) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0)
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+    VkVideoEndCodingInfoKHR const vk_end_info{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_END_CODING_INFO_KHR,
+        .pNext = nullptr,
+        .flags = {},
+    };
+    self->device->vkCmdEndVideoCodingKHR(self->current_command_data.vk_cmd_buffer, &vk_end_info);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_control_video_coding(daxa_CommandRecorder self, daxa_VideoCodingControlInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0)
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+    VkVideoCodingControlInfoKHR const vk_control_info{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_CODING_CONTROL_INFO_KHR,
+        .pNext = info->next,
+        .flags = info->flags,
+    };
+    self->device->vkCmdControlVideoCodingKHR(self->current_command_data.vk_cmd_buffer, &vk_control_info);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_decode_video(daxa_CommandRecorder self, daxa_VideoDecodeInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0)
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+    daxa_cmd_flush_barriers(self);
+    DAXA_CHECK_AND_REMEMBER_IDS(self, info->src_buffer, info->dst_picture.view)
+    for (auto const & slot : std::span{info->reference_slots, info->reference_slot_count})
+    {
+        DAXA_CHECK_AND_REMEMBER_IDS(self, slot.picture.view)
+    }
+    std::vector<VkVideoPictureResourceInfoKHR> vk_pictures = {};
+    std::vector<VkVideoReferenceSlotInfoKHR> vk_slots = {};
+    daxa_video_reference_slots_to_vk(self->device, std::span{info->reference_slots, info->reference_slot_count}, vk_pictures, vk_slots);
+    VkVideoPictureResourceInfoKHR vk_setup_picture = {};
+    VkVideoReferenceSlotInfoKHR vk_setup_slot = {};
+    if (info->setup_reference_slot.has_value)
+    {
+        DAXA_CHECK_AND_REMEMBER_IDS(self, info->setup_reference_slot.value.picture.view)
+        vk_setup_picture = daxa_video_picture_resource_to_vk(self->device, info->setup_reference_slot.value.picture);
+        vk_setup_slot = VkVideoReferenceSlotInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_REFERENCE_SLOT_INFO_KHR,
+            .pNext = info->setup_reference_slot.value.codec_info,
+            .slotIndex = info->setup_reference_slot.value.slot_index,
+            .pPictureResource = &vk_setup_picture,
+        };
+    }
+    VkVideoDecodeInfoKHR const vk_decode_info{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_DECODE_INFO_KHR,
+        .pNext = info->codec_info,
+        .flags = {},
+        .srcBuffer = self->device->slot(info->src_buffer).vk_buffer,
+        .srcBufferOffset = info->src_offset,
+        .srcBufferRange = info->src_range,
+        .dstPictureResource = daxa_video_picture_resource_to_vk(self->device, info->dst_picture),
+        .pSetupReferenceSlot = info->setup_reference_slot.has_value ? &vk_setup_slot : nullptr,
+        .referenceSlotCount = static_cast<u32>(vk_slots.size()),
+        .pReferenceSlots = vk_slots.data(),
+    };
+    self->device->vkCmdDecodeVideoKHR(self->current_command_data.vk_cmd_buffer, &vk_decode_info);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_encode_video(daxa_CommandRecorder self, daxa_VideoEncodeInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0)
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+    daxa_cmd_flush_barriers(self);
+    DAXA_CHECK_AND_REMEMBER_IDS(self, info->dst_buffer, info->src_picture.view)
+    for (auto const & slot : std::span{info->reference_slots, info->reference_slot_count})
+    {
+        DAXA_CHECK_AND_REMEMBER_IDS(self, slot.picture.view)
+    }
+    std::vector<VkVideoPictureResourceInfoKHR> vk_pictures = {};
+    std::vector<VkVideoReferenceSlotInfoKHR> vk_slots = {};
+    daxa_video_reference_slots_to_vk(self->device, std::span{info->reference_slots, info->reference_slot_count}, vk_pictures, vk_slots);
+    VkVideoPictureResourceInfoKHR vk_setup_picture = {};
+    VkVideoReferenceSlotInfoKHR vk_setup_slot = {};
+    if (info->setup_reference_slot.has_value)
+    {
+        DAXA_CHECK_AND_REMEMBER_IDS(self, info->setup_reference_slot.value.picture.view)
+        vk_setup_picture = daxa_video_picture_resource_to_vk(self->device, info->setup_reference_slot.value.picture);
+        vk_setup_slot = VkVideoReferenceSlotInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_REFERENCE_SLOT_INFO_KHR,
+            .pNext = info->setup_reference_slot.value.codec_info,
+            .slotIndex = info->setup_reference_slot.value.slot_index,
+            .pPictureResource = &vk_setup_picture,
+        };
+    }
+    VkVideoEncodeInfoKHR const vk_encode_info{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_INFO_KHR,
+        .pNext = info->codec_info,
+        .flags = {},
+        .dstBuffer = self->device->slot(info->dst_buffer).vk_buffer,
+        .dstBufferOffset = info->dst_offset,
+        .dstBufferRange = info->dst_range,
+        .srcPictureResource = daxa_video_picture_resource_to_vk(self->device, info->src_picture),
+        .pSetupReferenceSlot = info->setup_reference_slot.has_value ? &vk_setup_slot : nullptr,
+        .referenceSlotCount = static_cast<u32>(vk_slots.size()),
+        .pReferenceSlots = vk_slots.data(),
+        .precedingExternallyEncodedBytes = 0,
+    };
+    self->device->vkCmdEncodeVideoKHR(self->current_command_data.vk_cmd_buffer, &vk_encode_info);
+    return DAXA_RESULT_SUCCESS;
+}
+
 auto daxa_cmd_clear_buffer(daxa_CommandRecorder self, daxa_BufferClearInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, CLEAR_BUFFER, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->buffer)
     vkCmdFillBuffer(
@@ -457,6 +1161,7 @@ auto daxa_cmd_clear_buffer(daxa_CommandRecorder self, daxa_BufferClearInfo const
 
 auto daxa_cmd_clear_image(daxa_CommandRecorder self, daxa_ImageClearInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, CLEAR_IMAGE, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->image)
     auto const & img_slot = self->device->slot(info->image);
@@ -502,18 +1207,8 @@ auto daxa_cmd_clear_image(daxa_CommandRecorder self, daxa_ImageClearInfo const *
 /// @param info parameters.
 void daxa_cmd_pipeline_barrier(daxa_CommandRecorder self, daxa_MemoryBarrierInfo const * info)
 {
-    if (self->memory_barrier_batch_count == COMMAND_LIST_BARRIER_MAX_BATCH_SIZE)
-    {
-        daxa_cmd_flush_barriers(self);
-    }
-    self->memory_barrier_batch.at(self->memory_barrier_batch_count++) = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
-        .pNext = nullptr,
-        .srcStageMask = info->src_access.stages,
-        .srcAccessMask = info->src_access.access_type,
-        .dstStageMask = info->dst_access.stages,
-        .dstAccessMask = info->dst_access.access_type,
-    };
+    _DAXA_CAPTURE_COMMAND(self, PIPELINE_BARRIER, capture_bytes(*info))
+    self->memory_barrier_batch.push_back(get_vk_memory_barrier(*info));
 }
 
 /// @brief  Successive pipeline barrier calls are combined.
@@ -521,13 +1216,10 @@ void daxa_cmd_pipeline_barrier(daxa_CommandRecorder self, daxa_MemoryBarrierInfo
 /// @param info parameters.
 auto daxa_cmd_pipeline_barrier_image_transition(daxa_CommandRecorder self, daxa_ImageMemoryBarrierInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, PIPELINE_BARRIER_IMAGE_TRANSITION, capture_bytes(*info))
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->image_id)
-    if (self->image_barrier_batch_count == COMMAND_LIST_BARRIER_MAX_BATCH_SIZE)
-    {
-        daxa_cmd_flush_barriers(self);
-    }
     auto const & img_slot = self->device->slot(info->image_id);
-    self->image_barrier_batch.at(self->image_barrier_batch_count++) = {
+    self->image_barrier_batch.push_back({
         .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
         .pNext = nullptr,
         .srcStageMask = info->src_access.stages,
@@ -540,7 +1232,27 @@ auto daxa_cmd_pipeline_barrier_image_transition(daxa_CommandRecorder self, daxa_
         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
         .image = img_slot.vk_image,
         .subresourceRange = make_subresource_range(info->image_slice, img_slot.aspect_flags),
-    };
+    });
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_pipeline_barriers(daxa_CommandRecorder self, daxa_PipelineBarriersInfo const * info) -> daxa_Result
+{
+    self->memory_barrier_batch.reserve(self->memory_barrier_batch.size() + info->memory_barrier_count);
+    for (u64 index = 0; index < info->memory_barrier_count; ++index)
+    {
+        _DAXA_CAPTURE_COMMAND(self, PIPELINE_BARRIER, capture_bytes(info->memory_barriers[index]))
+        self->memory_barrier_batch.push_back(get_vk_memory_barrier(info->memory_barriers[index]));
+    }
+    self->image_barrier_batch.reserve(self->image_barrier_batch.size() + info->image_memory_barrier_count);
+    for (u64 index = 0; index < info->image_memory_barrier_count; ++index)
+    {
+        auto result = daxa_cmd_pipeline_barrier_image_transition(self, &info->image_memory_barriers[index]);
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
     return DAXA_RESULT_SUCCESS;
 }
 struct SplitBarrierDependencyInfoBuffer
@@ -555,6 +1267,7 @@ inline static thread_local std::vector<VkEvent> tl_split_barrier_events_buffer =
 
 void daxa_cmd_signal_event(daxa_CommandRecorder self, daxa_EventSignalInfo const * info)
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     daxa_cmd_flush_barriers(self);
     tl_split_barrier_dependency_infos_aux_buffer.push_back({});
     auto & dependency_infos_aux_buffer = tl_split_barrier_dependency_infos_aux_buffer.back();
@@ -581,6 +1294,7 @@ void daxa_cmd_signal_event(daxa_CommandRecorder self, daxa_EventSignalInfo const
 
 void daxa_cmd_wait_events(daxa_CommandRecorder self, daxa_EventWaitInfo const * infos, size_t info_count)
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     daxa_cmd_flush_barriers(self);
     for (u64 i = 0; i < info_count; ++i)
     {
@@ -623,6 +1337,7 @@ void daxa_cmd_wait_event(daxa_CommandRecorder self, daxa_EventWaitInfo const * i
 
 void daxa_cmd_reset_event(daxa_CommandRecorder self, daxa_ResetEventInfo const * info)
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     daxa_cmd_flush_barriers(self);
     vkCmdResetEvent2(
         self->current_command_data.vk_cmd_buffer,
@@ -632,67 +1347,320 @@ void daxa_cmd_reset_event(daxa_CommandRecorder self, daxa_ResetEventInfo const *
 
 auto daxa_cmd_push_constant(daxa_CommandRecorder self, daxa_PushConstantInfo const * info) -> daxa_Result
 {
-    daxa_cmd_flush_barriers(self);
-    if (daxa::holds_alternative<daxa_ImplCommandRecorder::NoPipeline>(self->current_pipeline))
+    _DAXA_CAPTURE_COMMAND(self, PUSH_CONSTANT, capture_bytes(info->offset), capture_bytes(info->size), std::span{static_cast<std::byte const *>(info->data), info->size})
+    auto const & bound = self->bound_state;
+    if (bound.pipeline_layout == VK_NULL_HANDLE)
     {
         return DAXA_RESULT_NO_PIPELINE_BOUND;
     }
-    VkPipelineLayout vk_pipeline_layout = {};
-    u32 current_pipeline_push_constant_size = {};
-    if (auto * pipeline = daxa::get_if<daxa_ComputePipeline>(&self->current_pipeline))
+    if (bound.push_constant_size < (info->offset + info->size))
     {
-        current_pipeline_push_constant_size = (**pipeline).info.push_constant_size;
-        vk_pipeline_layout = (**pipeline).vk_pipeline_layout;
+        return DAXA_RESULT_PUSHCONSTANT_RANGE_EXCEEDED;
     }
-    if (auto * pipeline = daxa::get_if<daxa_RasterPipeline>(&self->current_pipeline))
+    std::memcpy(self->push_constant_shadow.data() + info->offset, info->data, info->size);
+    vkCmdPushConstants(self->current_command_data.vk_cmd_buffer, bound.pipeline_layout, VK_SHADER_STAGE_ALL, info->offset, static_cast<u32>(info->size), info->data);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_push_constant_range(daxa_CommandRecorder self, daxa_PushConstantInfo const * fields, size_t field_count) -> daxa_Result
+{
+    if (self->current_command_data.capture_generation != 0)
     {
-        current_pipeline_push_constant_size = (**pipeline).info.push_constant_size;
-        vk_pipeline_layout = (**pipeline).vk_pipeline_layout;
+        auto & stream = self->current_command_data.capture_commands;
+        usize const begin = begin_captured_command(stream, CaptureCommand::PUSH_CONSTANT_RANGE);
+        append_captured_bytes(stream, capture_bytes(field_count));
+        for (auto const & field : std::span{fields, field_count})
+        {
+            append_captured_bytes(stream, capture_bytes(field.offset));
+            append_captured_bytes(stream, capture_bytes(field.size));
+            append_captured_bytes(stream, std::span{static_cast<std::byte const *>(field.data), field.size});
+        }
+        end_captured_command(stream, begin);
     }
-    if (auto * pipeline = daxa::get_if<daxa_RayTracingPipeline>(&self->current_pipeline))
+    auto const & bound = self->bound_state;
+    if (bound.pipeline_layout == VK_NULL_HANDLE)
     {
-        current_pipeline_push_constant_size = (**pipeline).info.push_constant_size;
-        vk_pipeline_layout = (**pipeline).vk_pipeline_layout;
+        return DAXA_RESULT_NO_PIPELINE_BOUND;
     }
-    if (current_pipeline_push_constant_size < (info->offset + info->size))
+    if (field_count == 0)
     {
-        return DAXA_RESULT_PUSHCONSTANT_RANGE_EXCEEDED;
+        return DAXA_RESULT_SUCCESS;
     }
-    vkCmdPushConstants(self->current_command_data.vk_cmd_buffer, vk_pipeline_layout, VK_SHADER_STAGE_ALL, info->offset, static_cast<u32>(info->size), info->data);
+    u64 range_begin = ~0ull;
+    u64 range_end = 0;
+    for (auto const & field : std::span{fields, field_count})
+    {
+        if (bound.push_constant_size < (field.offset + field.size))
+        {
+            return DAXA_RESULT_PUSHCONSTANT_RANGE_EXCEEDED;
+        }
+        std::memcpy(self->push_constant_shadow.data() + field.offset, field.data, field.size);
+        range_begin = std::min(range_begin, static_cast<u64>(field.offset));
+        range_end = std::max(range_end, field.offset + field.size);
+    }
+    // Push constant ranges are word aligned, the layout size is rounded up to words as well.
+    range_begin = range_begin & ~3ull;
+    range_end = (range_end + 3) & ~3ull;
+    vkCmdPushConstants(
+        self->current_command_data.vk_cmd_buffer,
+        bound.pipeline_layout,
+        VK_SHADER_STAGE_ALL,
+        static_cast<u32>(range_begin),
+        static_cast<u32>(range_end - range_begin),
+        self->push_constant_shadow.data() + range_begin);
     return DAXA_RESULT_SUCCESS;
 }
 
 void daxa_cmd_set_ray_tracing_pipeline(daxa_CommandRecorder self, daxa_RayTracingPipeline pipeline)
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if (self->bound_state.pipeline == pipeline->vk_pipeline)
+    {
+        self->stats.filtered_pipeline_binds += 1;
+        return;
+    }
     daxa_cmd_flush_barriers(self);
     self->current_pipeline = pipeline;
-    vkCmdBindDescriptorSets(self->current_command_data.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline->vk_pipeline_layout, 0, 1, &self->device->gpu_sro_table.vk_descriptor_set, 0, nullptr);
+    self->bound_state.pending_pipeline = false;
+    self->bound_state.pipeline = pipeline->vk_pipeline;
+    self->bound_state.pipeline_layout = pipeline->vk_pipeline_layout;
+    self->bound_state.push_constant_size = pipeline->info.push_constant_size;
+    bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline->vk_pipeline_layout);
     vkCmdBindPipeline(self->current_command_data.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline->vk_pipeline);
 }
 
-void daxa_cmd_set_compute_pipeline(daxa_CommandRecorder self, daxa_ComputePipeline pipeline)
+void daxa_cmd_set_compute_pipeline(daxa_CommandRecorder self, daxa_ComputePipeline requested_pipeline)
 {
+    daxa_ComputePipeline const pipeline = resolve_async_pipeline(requested_pipeline);
+    if (pipeline == nullptr)
+    {
+        _DAXA_CAPTURE_COMMAND(self, SET_COMPUTE_PIPELINE, capture_bytes(capture_pipeline(self->device, *requested_pipeline, CaptureRecordType::COMPUTE_PIPELINE, self->current_command_data.capture_generation)))
+        bind_pending_pipeline_layout(self, VK_PIPELINE_BIND_POINT_COMPUTE, *requested_pipeline, requested_pipeline->info.push_constant_size);
+        self->current_pipeline = requested_pipeline;
+        return;
+    }
+    _DAXA_CAPTURE_COMMAND(self, SET_COMPUTE_PIPELINE, capture_bytes(capture_pipeline(self->device, *pipeline, CaptureRecordType::COMPUTE_PIPELINE, self->current_command_data.capture_generation)))
+    if (self->bound_state.pipeline == pipeline->vk_pipeline)
+    {
+        self->stats.filtered_pipeline_binds += 1;
+        return;
+    }
     daxa_cmd_flush_barriers(self);
     self->current_pipeline = pipeline;
-    vkCmdBindDescriptorSets(self->current_command_data.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline_layout, 0, 1, &self->device->gpu_sro_table.vk_descriptor_set, 0, nullptr);
+    self->bound_state.pending_pipeline = false;
+    self->bound_state.pipeline = pipeline->vk_pipeline;
+    self->bound_state.pipeline_layout = pipeline->vk_pipeline_layout;
+    self->bound_state.push_constant_size = pipeline->info.push_constant_size;
+    bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline_layout);
     vkCmdBindPipeline(self->current_command_data.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline);
 }
 
-void daxa_cmd_set_raster_pipeline(daxa_CommandRecorder self, daxa_RasterPipeline pipeline)
+void daxa_cmd_set_raster_pipeline(daxa_CommandRecorder self, daxa_RasterPipeline requested_pipeline)
 {
+    daxa_RasterPipeline const pipeline = resolve_async_pipeline(requested_pipeline);
+    if (pipeline == nullptr)
+    {
+        _DAXA_CAPTURE_COMMAND(self, SET_RASTER_PIPELINE, capture_bytes(capture_pipeline(self->device, *requested_pipeline, CaptureRecordType::RASTER_PIPELINE, self->current_command_data.capture_generation)))
+        bind_pending_pipeline_layout(self, VK_PIPELINE_BIND_POINT_GRAPHICS, *requested_pipeline, requested_pipeline->info.push_constant_size);
+        self->current_pipeline = requested_pipeline;
+        set_graphics_shader_objects_bound(self, false);
+        return;
+    }
+    _DAXA_CAPTURE_COMMAND(self, SET_RASTER_PIPELINE, capture_bytes(capture_pipeline(self->device, *pipeline, CaptureRecordType::RASTER_PIPELINE, self->current_command_data.capture_generation)))
+    if (self->bound_state.pipeline == pipeline->vk_pipeline)
+    {
+        self->stats.filtered_pipeline_binds += 1;
+        return;
+    }
     daxa_cmd_flush_barriers(self);
     self->current_pipeline = pipeline;
-    vkCmdBindDescriptorSets(self->current_command_data.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline_layout, 0, 1, &self->device->gpu_sro_table.vk_descriptor_set, 0, nullptr);
+    self->bound_state.pending_pipeline = false;
+    self->bound_state.pipeline = pipeline->vk_pipeline;
+    self->bound_state.pipeline_layout = pipeline->vk_pipeline_layout;
+    self->bound_state.push_constant_size = pipeline->info.push_constant_size;
+    bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline_layout);
     vkCmdBindPipeline(self->current_command_data.vk_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline);
+    set_graphics_shader_objects_bound(self, false);
+}
+
+auto daxa_cmd_set_compute_shader_object(daxa_CommandRecorder self, daxa_ShaderObject shader_object) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT) == 0)
+    {
+        return DAXA_RESULT_ERROR_SHADER_OBJECT_NOT_SUPPORTED;
+    }
+    if (shader_object->info.stage != VK_SHADER_STAGE_COMPUTE_BIT)
+    {
+        return DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE;
+    }
+    if (auto const * bound = daxa::get_if<daxa_ShaderObject>(&self->current_pipeline); bound != nullptr && *bound == shader_object)
+    {
+        self->stats.filtered_pipeline_binds += 1;
+        return DAXA_RESULT_SUCCESS;
+    }
+    daxa_cmd_flush_barriers(self);
+    self->current_pipeline = shader_object;
+    // Shader objects are not pipelines, the next pipeline bind must not be filtered.
+    self->bound_state.pipeline = {};
+    self->bound_state.pending_pipeline = false;
+    self->bound_state.pipeline_layout = shader_object->vk_pipeline_layout;
+    self->bound_state.push_constant_size = shader_object->info.push_constant_size;
+    bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_COMPUTE, shader_object->vk_pipeline_layout);
+    VkShaderStageFlagBits const stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    self->device->vkCmdBindShadersEXT(self->current_command_data.vk_cmd_buffer, 1, &stage, &shader_object->vk_shader);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_set_raster_shader_objects(daxa_CommandRecorder self, daxa_SetRasterShaderObjectsInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT) == 0)
+    {
+        return DAXA_RESULT_ERROR_SHADER_OBJECT_NOT_SUPPORTED;
+    }
+    bool const mesh_shaders = (self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER) != 0;
+    // Every graphics stage the device supports is bound, stages without a shader object are unbound.
+    std::array<VkShaderStageFlagBits, 6> const stages = {
+        VK_SHADER_STAGE_VERTEX_BIT,
+        VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+        VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+        VK_SHADER_STAGE_FRAGMENT_BIT,
+        VK_SHADER_STAGE_TASK_BIT_EXT,
+        VK_SHADER_STAGE_MESH_BIT_EXT,
+    };
+    std::array<daxa_ShaderObject, 6> const shader_objects = {
+        info->vertex,
+        info->tesselation_control,
+        info->tesselation_evaluation,
+        info->fragment,
+        info->task,
+        info->mesh,
+    };
+    u32 const stage_count = mesh_shaders ? 6 : 4;
+    if ((info->vertex == nullptr) == (info->mesh == nullptr) || (!mesh_shaders && (info->task != nullptr || info->mesh != nullptr)))
+    {
+        return DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE;
+    }
+    std::optional<u32> push_constant_size = {};
+    VkPipelineLayout vk_pipeline_layout = {};
+    std::array<VkShaderEXT, 6> vk_shaders = {};
+    for (u32 i = 0; i < stage_count; ++i)
+    {
+        if (shader_objects.at(i) == nullptr)
+        {
+            continue;
+        }
+        if (shader_objects.at(i)->info.stage != stages.at(i))
+        {
+            return DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE;
+        }
+        if (push_constant_size.has_value() && push_constant_size.value() != shader_objects.at(i)->info.push_constant_size)
+        {
+            return DAXA_RESULT_ERROR_SHADER_OBJECT_PUSH_CONSTANT_SIZE_MISMATCH;
+        }
+        push_constant_size = shader_objects.at(i)->info.push_constant_size;
+        vk_pipeline_layout = shader_objects.at(i)->vk_pipeline_layout;
+        vk_shaders.at(i) = shader_objects.at(i)->vk_shader;
+    }
+
+    daxa_cmd_flush_barriers(self);
+    self->current_pipeline = daxa_ImplCommandRecorder::RasterShaderObjects{.vk_pipeline_layout = vk_pipeline_layout};
+    // Shader objects are not pipelines, the next pipeline bind must not be filtered.
+    self->bound_state.pipeline = {};
+    self->bound_state.pending_pipeline = false;
+    self->bound_state.pipeline_layout = vk_pipeline_layout;
+    self->bound_state.push_constant_size = push_constant_size.value();
+    bind_gpu_sro_table(self, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipeline_layout);
+    VkCommandBuffer const cmd = self->current_command_data.vk_cmd_buffer;
+    self->device->vkCmdBindShadersEXT(cmd, stage_count, stages.data(), vk_shaders.data());
+    set_graphics_shader_objects_bound(self, true);
+
+    // All state a raster pipeline holds statically has to be set before drawing with shader objects.
+    auto const & raster = info->raster;
+    vkCmdSetRasterizerDiscardEnable(cmd, static_cast<VkBool32>(raster.rasterizer_discard_enable));
+    self->device->vkCmdSetPolygonModeEXT(cmd, raster.polygon_mode);
+    VkSampleCountFlagBits const samples = raster.static_state_sample_count.has_value != 0 ? raster.static_state_sample_count.value : self->rendering.rasterization_samples;
+    self->device->vkCmdSetRasterizationSamplesEXT(cmd, samples);
+    VkSampleMask const sample_mask = ~VkSampleMask{0};
+    self->device->vkCmdSetSampleMaskEXT(cmd, samples, &sample_mask);
+    self->device->vkCmdSetAlphaToCoverageEnableEXT(cmd, VK_FALSE);
+    vkCmdSetCullMode(cmd, raster.face_culling);
+    vkCmdSetFrontFace(cmd, raster.front_face_winding);
+    vkCmdSetDepthTestEnable(cmd, static_cast<VkBool32>(info->depth_test.has_value));
+    vkCmdSetDepthWriteEnable(cmd, static_cast<VkBool32>(info->depth_test.has_value != 0 && info->depth_test.value.enable_depth_write != 0));
+    vkCmdSetDepthCompareOp(cmd, info->depth_test.has_value != 0 ? info->depth_test.value.depth_test_compare_op : VK_COMPARE_OP_LESS_OR_EQUAL);
+    vkCmdSetDepthBoundsTestEnable(cmd, VK_FALSE);
+    vkCmdSetDepthBiasEnable(cmd, static_cast<VkBool32>(raster.depth_bias_enable));
+    if (raster.depth_bias_enable != 0)
+    {
+        vkCmdSetDepthBias(cmd, raster.depth_bias_constant_factor, raster.depth_bias_clamp, raster.depth_bias_slope_factor);
+    }
+    vkCmdSetStencilTestEnable(cmd, VK_FALSE);
+    self->device->vkCmdSetDepthClampEnableEXT(cmd, static_cast<VkBool32>(raster.depth_clamp_enable));
+    vkCmdSetLineWidth(cmd, raster.line_width);
+    constexpr std::array<f32, 4> blend_constants = {1.0f, 1.0f, 1.0f, 1.0f};
+    vkCmdSetBlendConstants(cmd, blend_constants.data());
+    u32 const color_attachment_count = static_cast<u32>(info->color_attachments.size);
+    if (color_attachment_count > 0)
+    {
+        std::array<VkBool32, 8> blend_enables = {};
+        std::array<VkColorBlendEquationEXT, 8> blend_equations = {};
+        std::array<VkColorComponentFlags, 8> write_masks = {};
+        for (u32 i = 0; i < color_attachment_count; ++i)
+        {
+            auto const & blend = info->color_attachments.data[i].blend;
+            daxa_BlendInfo const blend_info = blend.has_value != 0 ? blend.value : DAXA_DEFAULT_BLEND_INFO;
+            blend_enables.at(i) = static_cast<VkBool32>(blend.has_value);
+            blend_equations.at(i) = VkColorBlendEquationEXT{
+                .srcColorBlendFactor = blend_info.src_color_blend_factor,
+                .dstColorBlendFactor = blend_info.dst_color_blend_factor,
+                .colorBlendOp = blend_info.color_blend_op,
+                .srcAlphaBlendFactor = blend_info.src_alpha_blend_factor,
+                .dstAlphaBlendFactor = blend_info.dst_alpha_blend_factor,
+                .alphaBlendOp = blend_info.alpha_blend_op,
+            };
+            write_masks.at(i) = blend_info.color_write_mask;
+        }
+        self->device->vkCmdSetColorBlendEnableEXT(cmd, 0, color_attachment_count, blend_enables.data());
+        self->device->vkCmdSetColorBlendEquationEXT(cmd, 0, color_attachment_count, blend_equations.data());
+        self->device->vkCmdSetColorWriteMaskEXT(cmd, 0, color_attachment_count, write_masks.data());
+    }
+    if (info->vertex != nullptr)
+    {
+        // Daxa pulls vertices in the shader, there are never vertex bindings.
+        self->device->vkCmdSetVertexInputEXT(cmd, 0, nullptr, 0, nullptr);
+        vkCmdSetPrimitiveTopology(cmd, raster.primitive_topology);
+        vkCmdSetPrimitiveRestartEnable(cmd, static_cast<VkBool32>(raster.primitive_restart_enable));
+    }
+    if (info->tesselation_control != nullptr || info->tesselation_evaluation != nullptr)
+    {
+        daxa_TesselationInfo const tesselation = info->tesselation.has_value != 0 ? info->tesselation.value : daxa_TesselationInfo{.control_points = 3, .origin = VK_TESSELLATION_DOMAIN_ORIGIN_UPPER_LEFT};
+        self->device->vkCmdSetPatchControlPointsEXT(cmd, tesselation.control_points);
+        self->device->vkCmdSetTessellationDomainOriginEXT(cmd, tesselation.origin);
+    }
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_CONSERVATIVE_RASTERIZATION) != 0)
+    {
+        bool const conservative = raster.conservative_raster_info.has_value != 0;
+        self->device->vkCmdSetConservativeRasterizationModeEXT(cmd, conservative ? raster.conservative_raster_info.value.mode : VK_CONSERVATIVE_RASTERIZATION_MODE_DISABLED_EXT);
+        if (conservative)
+        {
+            self->device->vkCmdSetExtraPrimitiveOverestimationSizeEXT(cmd, raster.conservative_raster_info.value.size);
+        }
+    }
+    return DAXA_RESULT_SUCCESS;
 }
 
 auto daxa_cmd_trace_rays(daxa_CommandRecorder self, daxa_TraceRaysInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     // TODO: Check if those offsets are in range?
     if (!daxa::holds_alternative<daxa_RayTracingPipeline>(self->current_pipeline))
     {
         return DAXA_RESULT_NO_RAYTRACING_PIPELINE_BOUND;
     }
+    daxa_cmd_flush_barriers(self);
+    rebind_gpu_sro_table_if_grown(self);
     auto const & binding_table = info->shader_binding_table;
     auto raygen_handle = binding_table.raygen_region;
     raygen_handle.deviceAddress += binding_table.raygen_region.stride * info->raygen_handle_offset;
@@ -714,11 +1682,14 @@ auto daxa_cmd_trace_rays(daxa_CommandRecorder self, daxa_TraceRaysInfo const * i
 
 auto daxa_cmd_trace_rays_indirect(daxa_CommandRecorder self, daxa_TraceRaysIndirectInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     // TODO: Check if those offsets are in range?
     if (!daxa::holds_alternative<daxa_RayTracingPipeline>(self->current_pipeline))
     {
         return DAXA_RESULT_NO_RAYTRACING_PIPELINE_BOUND;
     }
+    daxa_cmd_flush_barriers(self);
+    rebind_gpu_sro_table_if_grown(self);
     auto const & binding_table = info->shader_binding_table;
     auto raygen_handle = binding_table.raygen_region;
     raygen_handle.deviceAddress += binding_table.raygen_region.stride * info->raygen_handle_offset;
@@ -740,26 +1711,161 @@ auto daxa_cmd_trace_rays_indirect(daxa_CommandRecorder self, daxa_TraceRaysIndir
 
 auto daxa_cmd_dispatch(daxa_CommandRecorder self, daxa_DispatchInfo const * info) -> daxa_Result
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self, DAXA_RESULT_SUCCESS)
+    _DAXA_CAPTURE_COMMAND(self, DISPATCH, capture_bytes(*info))
     // TODO: Check if those offsets are in range?
-    if (!daxa::holds_alternative<daxa_ComputePipeline>(self->current_pipeline))
+    if (!daxa::holds_alternative<daxa_ComputePipeline>(self->current_pipeline) && !daxa::holds_alternative<daxa_ShaderObject>(self->current_pipeline))
     {
         return DAXA_RESULT_NO_COMPUTE_PIPELINE_BOUND;
     }
+    daxa_cmd_flush_barriers(self);
+    rebind_gpu_sro_table_if_grown(self);
     vkCmdDispatch(self->current_command_data.vk_cmd_buffer, info->x, info->y, info->z);
     return DAXA_RESULT_SUCCESS;
 }
 
 auto daxa_cmd_dispatch_indirect(daxa_CommandRecorder self, daxa_DispatchIndirectInfo const * info) -> daxa_Result
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self, DAXA_RESULT_SUCCESS)
+    _DAXA_CAPTURE_COMMAND(self, DISPATCH_INDIRECT, capture_bytes(*info))
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer)
-    if (!daxa::holds_alternative<daxa_ComputePipeline>(self->current_pipeline))
+    if (!daxa::holds_alternative<daxa_ComputePipeline>(self->current_pipeline) && !daxa::holds_alternative<daxa_ShaderObject>(self->current_pipeline))
     {
         return DAXA_RESULT_NO_COMPUTE_PIPELINE_BOUND;
     }
+    daxa_cmd_flush_barriers(self);
+    rebind_gpu_sro_table_if_grown(self);
     vkCmdDispatchIndirect(self->current_command_data.vk_cmd_buffer, self->device->slot(info->indirect_buffer).vk_buffer, info->offset);
     return DAXA_RESULT_SUCCESS;
 }
 
+auto daxa_cmd_begin_conditional_rendering(daxa_CommandRecorder self, daxa_ConditionalRenderingInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, BEGIN_CONDITIONAL_RENDERING, capture_bytes(*info))
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING) == 0)
+    {
+        return DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_NOT_SUPPORTED;
+    }
+    if (self->conditional_rendering_active)
+    {
+        return DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_SCOPE_MISMATCH;
+    }
+    DAXA_CHECK_AND_REMEMBER_IDS(self, info->buffer)
+    daxa_cmd_flush_barriers(self);
+    VkConditionalRenderingBeginInfoEXT const vk_conditional_rendering_begin_info{
+        .sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT,
+        .pNext = nullptr,
+        .buffer = self->device->slot(info->buffer).vk_buffer,
+        .offset = info->offset,
+        .flags = info->inverted != 0 ? VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT : VkConditionalRenderingFlagsEXT{},
+    };
+    self->device->vkCmdBeginConditionalRenderingEXT(self->current_command_data.vk_cmd_buffer, &vk_conditional_rendering_begin_info);
+    self->conditional_rendering_active = true;
+    self->conditional_rendering_in_renderpass = self->in_renderpass;
+    return DAXA_RESULT_SUCCESS;
+}
+
+inline static thread_local std::vector<VkDecompressMemoryRegionNV> tl_vk_decompression_regions = {}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+auto daxa_cmd_decompress_memory(daxa_CommandRecorder self, daxa_DecompressMemoryInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_DECOMPRESSION) == 0)
+    {
+        return DAXA_RESULT_ERROR_MEMORY_DECOMPRESSION_NOT_SUPPORTED;
+    }
+    daxa_cmd_flush_barriers(self);
+    std::vector<VkDecompressMemoryRegionNV> & vk_regions = tl_vk_decompression_regions;
+    vk_regions.clear();
+    for (usize i = 0; i < info->region_count; ++i)
+    {
+        daxa_MemoryDecompressionRegion const & region = info->regions[i];
+        vk_regions.push_back(VkDecompressMemoryRegionNV{
+            .srcAddress = region.src_address,
+            .dstAddress = region.dst_address,
+            .compressedSize = region.compressed_size,
+            .decompressedSize = region.decompressed_size,
+            .decompressionMethod = VK_MEMORY_DECOMPRESSION_METHOD_GDEFLATE_1_0_BIT_NV,
+        });
+    }
+    if (!vk_regions.empty())
+    {
+        self->device->vkCmdDecompressMemoryNV(self->current_command_data.vk_cmd_buffer, static_cast<u32>(vk_regions.size()), vk_regions.data());
+    }
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_end_conditional_rendering(daxa_CommandRecorder self) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, END_CONDITIONAL_RENDERING)
+    if (!self->conditional_rendering_active || self->conditional_rendering_in_renderpass != self->in_renderpass)
+    {
+        return DAXA_RESULT_ERROR_CONDITIONAL_RENDERING_SCOPE_MISMATCH;
+    }
+    daxa_cmd_flush_barriers(self);
+    self->device->vkCmdEndConditionalRenderingEXT(self->current_command_data.vk_cmd_buffer);
+    self->conditional_rendering_active = false;
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_execute_generated_commands(daxa_CommandRecorder self, daxa_ExecuteGeneratedCommandsInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED;
+    }
+    DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer, info->preprocess_buffer)
+    bool const has_sequence_count_buffer = info->sequence_count_buffer.value != 0;
+    if (has_sequence_count_buffer)
+    {
+        DAXA_CHECK_AND_REMEMBER_IDS(self, info->sequence_count_buffer)
+    }
+    if (daxa::holds_alternative<daxa_ImplCommandRecorder::NoPipeline>(self->current_pipeline))
+    {
+        return DAXA_RESULT_NO_PIPELINE_BOUND;
+    }
+    // The indirect range runs to the end of the buffer, the preprocess range has an explicit size.
+    auto const & indirect_slot = self->device->slot(info->indirect_buffer);
+    if (info->indirect_offset >= indirect_slot.info.size)
+    {
+        return DAXA_RESULT_INVALID_BUFFER_OFFSET;
+    }
+    auto const & preprocess_slot = self->device->slot(info->preprocess_buffer);
+    if (info->preprocess_offset > preprocess_slot.info.size || info->preprocess_size > preprocess_slot.info.size - info->preprocess_offset)
+    {
+        return DAXA_RESULT_INVALID_BUFFER_RANGE;
+    }
+    daxa_cmd_flush_barriers(self);
+    rebind_gpu_sro_table_if_grown(self);
+    VkGeneratedCommandsInfoEXT const vk_generated_commands_info{
+        .sType = VK_STRUCTURE_TYPE_GENERATED_COMMANDS_INFO_EXT,
+        .pNext = nullptr,
+        .shaderStages = info->layout->vk_shader_stages,
+        .indirectExecutionSet = info->execution_set->vk_indirect_execution_set,
+        .indirectCommandsLayout = info->layout->vk_indirect_commands_layout,
+        .indirectAddress = indirect_slot.device_address + info->indirect_offset,
+        .indirectAddressSize = indirect_slot.info.size - info->indirect_offset,
+        .preprocessAddress = preprocess_slot.device_address + info->preprocess_offset,
+        .preprocessSize = info->preprocess_size,
+        .maxSequenceCount = info->max_sequence_count,
+        .sequenceCountAddress = has_sequence_count_buffer ? self->device->slot(info->sequence_count_buffer).device_address + info->sequence_count_offset : VkDeviceAddress{},
+        .maxDrawCount = info->max_draw_count,
+    };
+    self->device->vkCmdExecuteGeneratedCommandsEXT(self->current_command_data.vk_cmd_buffer, VK_FALSE, &vk_generated_commands_info);
+    // The execution set may switch pipelines and the tokens may overwrite push constants and the index buffer.
+    self->bound_state.pipeline = {};
+    self->bound_state.pending_pipeline = false;
+    self->bound_state.gpu_sro_table_bindings = {};
+    self->bound_state.pipeline_layout = {};
+    self->bound_state.push_constant_size = {};
+    self->bound_state.index_buffer = {};
+    self->bound_state.index_buffer_offset = {};
+    self->bound_state.index_type = {};
+    self->current_pipeline = daxa_ImplCommandRecorder::NoPipeline{};
+    return DAXA_RESULT_SUCCESS;
+}
+
 auto daxa_cmd_destroy_buffer_deferred(daxa_CommandRecorder self, daxa_BufferId id) -> daxa_Result
 {
     DAXA_CHECK_AND_REMEMBER_IDS(self, id)
@@ -790,6 +1896,36 @@ auto daxa_cmd_destroy_sampler_deferred(daxa_CommandRecorder self, daxa_SamplerId
 
 auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginInfo const * info) -> daxa_Result
 {
+    _DAXA_CAPTURE_COMMAND(self, BEGIN_RENDERPASS, capture_bytes(*info))
+    if (self->renderpass_end_pending &&
+        continues_renderpass(self->pending_renderpass, *info) &&
+        elides_attachment_barriers(self, *info))
+    {
+        // The attachments stay bound, only the state begin_renderpass sets up is reset.
+        self->image_barrier_batch.clear();
+        self->renderpass_end_pending = false;
+        self->pending_renderpass = *info;
+        VkRect2D const render_area = *reinterpret_cast<VkRect2D const *>(&info->render_area);
+        VkViewport const vk_viewport = {
+            .x = static_cast<f32>(render_area.offset.x),
+            .y = static_cast<f32>(render_area.offset.y),
+            .width = static_cast<f32>(render_area.extent.width),
+            .height = static_cast<f32>(render_area.extent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f,
+        };
+        emit_scissor(self, render_area);
+        emit_viewport(self, vk_viewport);
+        self->bound_state.viewport = vk_viewport;
+        self->bound_state.scissor = render_area;
+        if (self->device->vkCmdSetRasterizationSamplesEXT != nullptr)
+        {
+            self->device->vkCmdSetRasterizationSamplesEXT(self->current_command_data.vk_cmd_buffer, VK_SAMPLE_COUNT_1_BIT);
+        }
+        self->stats.merged_renderpasses += 1;
+        self->in_renderpass = true;
+        return DAXA_RESULT_SUCCESS;
+    }
     daxa_cmd_flush_barriers(self);
 
     auto fill_rendering_attachment_info = [&](daxa_RenderAttachmentInfo const & in, VkRenderingAttachmentInfo & out)
@@ -853,26 +1989,53 @@ auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginIn
         }
         fill_rendering_attachment_info(info->stencil_attachment.value, stencil_attachment_info);
     };
+    if (self->info.disable_submit_id_validation == 0)
+    {
+        for (usize i = 0; i < info->color_attachments.size; ++i)
+        {
+            self->current_command_data.used_image_views.push_back(std::bit_cast<ImageViewId>(info->color_attachments.data[i].image_view));
+            self->current_command_data.used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->color_attachments.data[i].image_view).info.image));
+        }
+        if (info->depth_attachment.has_value != 0)
+        {
+            self->current_command_data.used_image_views.push_back(std::bit_cast<ImageViewId>(info->depth_attachment.value.image_view));
+            self->current_command_data.used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->depth_attachment.value.image_view).info.image));
+        }
+        if (info->stencil_attachment.has_value != 0)
+        {
+            self->current_command_data.used_image_views.push_back(std::bit_cast<ImageViewId>(info->stencil_attachment.value.image_view));
+            self->current_command_data.used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->stencil_attachment.value.image_view).info.image));
+        }
+    }
+
+    self->rendering = RenderingInheritance{
+        .color_attachment_count = static_cast<u32>(info->color_attachments.size),
+        .render_area = info->render_area,
+        .secondary_command_lists = info->secondary_command_lists != 0,
+    };
     for (usize i = 0; i < info->color_attachments.size; ++i)
     {
-        self->current_command_data.used_image_views.push_back(std::bit_cast<ImageViewId>(info->color_attachments.data[i].image_view));
-        self->current_command_data.used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->color_attachments.data[i].image_view).info.image));
+        auto const & view_slot = self->device->slot(info->color_attachments.data[i].image_view);
+        self->rendering.color_attachment_formats.at(i) = view_slot.info.format;
+        self->rendering.rasterization_samples = static_cast<VkSampleCountFlagBits>(self->device->slot(view_slot.info.image).info.sample_count);
     }
     if (info->depth_attachment.has_value != 0)
     {
-        self->current_command_data.used_image_views.push_back(std::bit_cast<ImageViewId>(info->depth_attachment.value.image_view));
-        self->current_command_data.used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->depth_attachment.value.image_view).info.image));
+        auto const & view_slot = self->device->slot(info->depth_attachment.value.image_view);
+        self->rendering.depth_attachment_format = view_slot.info.format;
+        self->rendering.rasterization_samples = static_cast<VkSampleCountFlagBits>(self->device->slot(view_slot.info.image).info.sample_count);
     }
     if (info->stencil_attachment.has_value != 0)
     {
-        self->current_command_data.used_image_views.push_back(std::bit_cast<ImageViewId>(info->stencil_attachment.value.image_view));
-        self->current_command_data.used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->stencil_attachment.value.image_view).info.image));
+        auto const & view_slot = self->device->slot(info->stencil_attachment.value.image_view);
+        self->rendering.stencil_attachment_format = view_slot.info.format;
+        self->rendering.rasterization_samples = static_cast<VkSampleCountFlagBits>(self->device->slot(view_slot.info.image).info.sample_count);
     }
 
     VkRenderingInfo const vk_rendering_info{
         .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
         .pNext = nullptr,
-        .flags = {},
+        .flags = self->rendering.secondary_command_lists ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : VkRenderingFlags{},
         .renderArea = info->render_area,
         .layerCount = 1,
         .viewMask = {},
@@ -881,7 +2044,7 @@ auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginIn
         .pDepthAttachment = info->depth_attachment.has_value != 0 ? &depth_attachment_info : nullptr,
         .pStencilAttachment = info->stencil_attachment.has_value != 0 ? &stencil_attachment_info : nullptr,
     };
-    vkCmdSetScissor(self->current_command_data.vk_cmd_buffer, 0, 1, reinterpret_cast<VkRect2D const *>(&info->render_area));
+    emit_scissor(self, *reinterpret_cast<VkRect2D const *>(&info->render_area));
     VkViewport const vk_viewport = {
         .x = static_cast<f32>(info->render_area.offset.x),
         .y = static_cast<f32>(info->render_area.offset.y),
@@ -890,61 +2053,241 @@ auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginIn
         .minDepth = 0.0f,
         .maxDepth = 1.0f,
     };
-    vkCmdSetViewport(self->current_command_data.vk_cmd_buffer, 0, 1, &vk_viewport);
+    emit_viewport(self, vk_viewport);
+    self->bound_state.viewport = vk_viewport;
+    self->bound_state.scissor = *reinterpret_cast<VkRect2D const *>(&info->render_area);
     vkCmdBeginRendering(self->current_command_data.vk_cmd_buffer, &vk_rendering_info);
-    if (self->device->vkCmdSetRasterizationSamplesEXT != nullptr)
+    // Commands can only be recorded into the secondary command buffers of such renderpasses.
+    if (self->device->vkCmdSetRasterizationSamplesEXT != nullptr && !self->rendering.secondary_command_lists)
     {
         self->device->vkCmdSetRasterizationSamplesEXT(self->current_command_data.vk_cmd_buffer, VK_SAMPLE_COUNT_1_BIT);
     }
+    if (self->info.merge_renderpasses != 0)
+    {
+        self->pending_renderpass = *info;
+    }
     self->in_renderpass = true;
     return DAXA_RESULT_SUCCESS;
 }
 
 void daxa_cmd_end_renderpass(daxa_CommandRecorder self)
 {
+    _DAXA_CAPTURE_COMMAND(self, END_RENDERPASS)
     daxa_cmd_flush_barriers(self);
+    if (self->info.merge_renderpasses != 0 && !self->rendering.secondary_command_lists)
+    {
+        // Ended by the next command that can not be recorded inside of the renderpass, or continued by the next renderpass.
+        self->renderpass_end_pending = true;
+        self->in_renderpass = false;
+        return;
+    }
     vkCmdEndRendering(self->current_command_data.vk_cmd_buffer);
     self->in_renderpass = false;
+    self->rendering = {};
+}
+
+auto daxa_cmd_create_secondary_command_recorder(daxa_CommandRecorder self, daxa_CommandRecorderInfo const * info, daxa_CommandRecorder * out_cmd_enc) -> daxa_Result
+{
+    if (self->is_secondary || !self->in_renderpass || !self->rendering.secondary_command_lists)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH, DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH);
+    }
+    daxa_CommandRecorderInfo secondary_info = *info;
+    secondary_info.queue_family = self->info.queue_family;
+    // Reusable command lists can only execute secondaries that are reusable as well.
+    secondary_info.reusable = static_cast<daxa_Bool8>(info->reusable != 0 || self->info.reusable != 0);
+    return create_command_recorder(self->device, &secondary_info, &self->rendering, out_cmd_enc);
+}
+
+auto daxa_cmd_execute_commands(daxa_CommandRecorder self, daxa_ExecutableCommandList const * executable_cmds, size_t executable_cmd_count) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    if (self->is_secondary || !self->in_renderpass || !self->rendering.secondary_command_lists)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH, DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH);
+    }
+    auto const secondaries = std::span{executable_cmds, executable_cmd_count};
+    for (daxa_ExecutableCommandList secondary : secondaries)
+    {
+        if (!secondary->cmd_recorder->is_secondary)
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH, DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH);
+        }
+        if (secondary->cmd_recorder->info.queue_family != self->info.queue_family)
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_CMD_LIST_SUBMIT_QUEUE_FAMILY_MISMATCH, DAXA_RESULT_ERROR_CMD_LIST_SUBMIT_QUEUE_FAMILY_MISMATCH);
+        }
+    }
+    daxa_cmd_flush_barriers(self);
+    ExecutableCommandListData & data = self->current_command_data;
+    std::vector<VkCommandBuffer> vk_cmd_buffers = {};
+    vk_cmd_buffers.reserve(secondaries.size());
+    for (daxa_ExecutableCommandList secondary : secondaries)
+    {
+        vk_cmd_buffers.push_back(secondary->data.vk_cmd_buffer);
+        // Submits only see the primary command list, so it takes over the validation and destruction work of the secondaries.
+        if (self->info.disable_submit_id_validation == 0)
+        {
+            data.used_buffers.insert(data.used_buffers.end(), secondary->data.used_buffers.begin(), secondary->data.used_buffers.end());
+            data.used_images.insert(data.used_images.end(), secondary->data.used_images.begin(), secondary->data.used_images.end());
+            data.used_image_views.insert(data.used_image_views.end(), secondary->data.used_image_views.begin(), secondary->data.used_image_views.end());
+            data.used_samplers.insert(data.used_samplers.end(), secondary->data.used_samplers.begin(), secondary->data.used_samplers.end());
+            data.used_tlass.insert(data.used_tlass.end(), secondary->data.used_tlass.begin(), secondary->data.used_tlass.end());
+            data.used_blass.insert(data.used_blass.end(), secondary->data.used_blass.begin(), secondary->data.used_blass.end());
+        }
+        data.deferred_destructions.insert(data.deferred_destructions.end(), secondary->data.deferred_destructions.begin(), secondary->data.deferred_destructions.end());
+        data.submit_timeline_listeners.insert(data.submit_timeline_listeners.end(), secondary->data.submit_timeline_listeners.begin(), secondary->data.submit_timeline_listeners.end());
+        secondary->data.submit_timeline_listeners.clear();
+        data.oldest_bound_gpu_sro_table_generation = std::min(data.oldest_bound_gpu_sro_table_generation, secondary->data.oldest_bound_gpu_sro_table_generation);
+        secondary->data.deferred_destructions.clear();
+        secondary->inc_refcnt();
+        data.secondary_command_lists.push_back(secondary);
+    }
+    vkCmdExecuteCommands(data.vk_cmd_buffer, static_cast<u32>(vk_cmd_buffers.size()), vk_cmd_buffers.data());
+    // The bound state of the primary command buffer is undefined after executing secondaries.
+    self->bound_state = {};
+    self->current_pipeline = daxa_ImplCommandRecorder::NoPipeline{};
+    data.descriptor_buffer_bound = false;
+    return DAXA_RESULT_SUCCESS;
 }
 
 void daxa_cmd_set_viewport(daxa_CommandRecorder self, VkViewport const * info)
 {
+    _DAXA_CAPTURE_COMMAND(self, SET_VIEWPORT, capture_bytes(*info))
+    if (self->bound_state.viewport.has_value() && std::memcmp(&self->bound_state.viewport.value(), info, sizeof(VkViewport)) == 0)
+    {
+        self->stats.filtered_viewports += 1;
+        return;
+    }
     daxa_cmd_flush_barriers(self);
-    vkCmdSetViewport(self->current_command_data.vk_cmd_buffer, 0, 1, info);
+    self->bound_state.viewport = *info;
+    emit_viewport(self, *info);
 }
 
 void daxa_cmd_set_scissor(daxa_CommandRecorder self, VkRect2D const * info)
 {
+    _DAXA_CAPTURE_COMMAND(self, SET_SCISSOR, capture_bytes(*info))
+    if (self->bound_state.scissor.has_value() && std::memcmp(&self->bound_state.scissor.value(), info, sizeof(VkRect2D)) == 0)
+    {
+        self->stats.filtered_scissors += 1;
+        return;
+    }
     daxa_cmd_flush_barriers(self);
-    vkCmdSetScissor(self->current_command_data.vk_cmd_buffer, 0, 1, info);
+    self->bound_state.scissor = *info;
+    emit_scissor(self, *info);
 }
 
 void daxa_cmd_set_depth_bias(daxa_CommandRecorder self, daxa_DepthBiasInfo const * info)
 {
+    _DAXA_CAPTURE_COMMAND(self, SET_DEPTH_BIAS, capture_bytes(*info))
     daxa_cmd_flush_barriers(self);
     vkCmdSetDepthBias(self->current_command_data.vk_cmd_buffer, info->constant_factor, info->clamp, info->slope_factor);
 }
 
 auto daxa_cmd_set_index_buffer(daxa_CommandRecorder self, daxa_SetIndexBufferInfo const * info) -> daxa_Result
 {
-    DAXA_CHECK_AND_REMEMBER_IDS(self, info->buffer)
-    vkCmdBindIndexBuffer(self->current_command_data.vk_cmd_buffer, self->device->slot(info->buffer).vk_buffer, info->offset, info->index_type);
+    _DAXA_CAPTURE_COMMAND(self, SET_INDEX_BUFFER, capture_bytes(*info))
+    _DAXA_CHECK_IDS(self, info->buffer)
+    VkBuffer const vk_buffer = self->device->slot(info->buffer).vk_buffer;
+    auto & bound = self->bound_state;
+    // The id was already remembered when the buffer was bound.
+    if (bound.index_buffer == vk_buffer && bound.index_buffer_offset == info->offset && bound.index_type == info->index_type)
+    {
+        self->stats.filtered_index_buffer_binds += 1;
+        return DAXA_RESULT_SUCCESS;
+    }
+    _DAXA_REMEMBER_IDS(self, info->buffer)
+    bound.index_buffer = vk_buffer;
+    bound.index_buffer_offset = info->offset;
+    bound.index_type = info->index_type;
+    vkCmdBindIndexBuffer(self->current_command_data.vk_cmd_buffer, vk_buffer, info->offset, info->index_type);
     return DAXA_RESULT_SUCCESS;
 }
 
 void daxa_cmd_draw(daxa_CommandRecorder self, daxa_DrawInfo const * info)
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self)
+    _DAXA_CAPTURE_COMMAND(self, DRAW, capture_bytes(*info))
+    rebind_gpu_sro_table_if_grown(self);
     vkCmdDraw(self->current_command_data.vk_cmd_buffer, info->vertex_count, info->instance_count, info->first_vertex, info->first_instance);
 }
 
 void daxa_cmd_draw_indexed(daxa_CommandRecorder self, daxa_DrawIndexedInfo const * info)
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_INDEXED, capture_bytes(*info))
+    rebind_gpu_sro_table_if_grown(self);
     vkCmdDrawIndexed(self->current_command_data.vk_cmd_buffer, info->index_count, info->instance_count, info->first_index, info->vertex_offset, info->first_instance);
 }
 
+static_assert(sizeof(daxa_DrawRange) == sizeof(VkMultiDrawInfoEXT));
+static_assert(sizeof(daxa_DrawIndexedRange) == sizeof(VkMultiDrawIndexedInfoEXT));
+
+void daxa_cmd_draw_multi(daxa_CommandRecorder self, daxa_DrawMultiInfo const * info)
+{
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_MULTI, capture_bytes(*info), std::as_bytes(std::span{info->ranges, info->range_count}))
+    rebind_gpu_sro_table_if_grown(self);
+    auto const ranges = std::span{info->ranges, info->range_count};
+    if (self->device->vkCmdDrawMultiEXT != nullptr)
+    {
+        // The draw count of a single call is limited by the device.
+        auto const max_batch = static_cast<usize>(self->device->multi_draw_properties.maxMultiDrawCount);
+        for (usize offset = 0; offset < ranges.size(); offset += max_batch)
+        {
+            auto const batch = ranges.subspan(offset, std::min(max_batch, ranges.size() - offset));
+            self->device->vkCmdDrawMultiEXT(
+                self->current_command_data.vk_cmd_buffer,
+                static_cast<u32>(batch.size()),
+                r_cast<VkMultiDrawInfoEXT const *>(batch.data()),
+                info->instance_count,
+                info->first_instance,
+                sizeof(daxa_DrawRange));
+        }
+        return;
+    }
+    for (auto const & range : ranges)
+    {
+        vkCmdDraw(self->current_command_data.vk_cmd_buffer, range.vertex_count, info->instance_count, range.first_vertex, info->first_instance);
+    }
+}
+
+void daxa_cmd_draw_multi_indexed(daxa_CommandRecorder self, daxa_DrawMultiIndexedInfo const * info)
+{
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_MULTI_INDEXED, capture_bytes(*info), std::as_bytes(std::span{info->ranges, info->range_count}))
+    rebind_gpu_sro_table_if_grown(self);
+    auto const ranges = std::span{info->ranges, info->range_count};
+    if (self->device->vkCmdDrawMultiIndexedEXT != nullptr)
+    {
+        auto const max_batch = static_cast<usize>(self->device->multi_draw_properties.maxMultiDrawCount);
+        for (usize offset = 0; offset < ranges.size(); offset += max_batch)
+        {
+            auto const batch = ranges.subspan(offset, std::min(max_batch, ranges.size() - offset));
+            // Without a shared vertex offset the per range vertex offsets are used.
+            self->device->vkCmdDrawMultiIndexedEXT(
+                self->current_command_data.vk_cmd_buffer,
+                static_cast<u32>(batch.size()),
+                r_cast<VkMultiDrawIndexedInfoEXT const *>(batch.data()),
+                info->instance_count,
+                info->first_instance,
+                sizeof(daxa_DrawIndexedRange),
+                nullptr);
+        }
+        return;
+    }
+    for (auto const & range : ranges)
+    {
+        vkCmdDrawIndexed(self->current_command_data.vk_cmd_buffer, range.index_count, info->instance_count, range.first_index, range.vertex_offset, info->first_instance);
+    }
+}
+
 auto daxa_cmd_draw_indirect(daxa_CommandRecorder self, daxa_DrawIndirectInfo const * info) -> daxa_Result
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self, DAXA_RESULT_SUCCESS)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_INDIRECT, capture_bytes(*info))
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer)
+    rebind_gpu_sro_table_if_grown(self);
     if (info->is_indexed != 0)
     {
         vkCmdDrawIndexedIndirect(
@@ -968,7 +2311,10 @@ auto daxa_cmd_draw_indirect(daxa_CommandRecorder self, daxa_DrawIndirectInfo con
 
 auto daxa_cmd_draw_indirect_count(daxa_CommandRecorder self, daxa_DrawIndirectCountInfo const * info) -> daxa_Result
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self, DAXA_RESULT_SUCCESS)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_INDIRECT_COUNT, capture_bytes(*info))
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer, info->count_buffer)
+    rebind_gpu_sro_table_if_grown(self);
     if (info->is_indexed != 0)
     {
         vkCmdDrawIndexedIndirectCount(
@@ -996,6 +2342,9 @@ auto daxa_cmd_draw_indirect_count(daxa_CommandRecorder self, daxa_DrawIndirectCo
 
 void daxa_cmd_draw_mesh_tasks(daxa_CommandRecorder self, uint32_t x, uint32_t y, uint32_t z)
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_MESH_TASKS, capture_bytes(x), capture_bytes(y), capture_bytes(z))
+    rebind_gpu_sro_table_if_grown(self);
     if (self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER)
     {
         self->device->vkCmdDrawMeshTasksEXT(self->current_command_data.vk_cmd_buffer, x, y, z);
@@ -1004,7 +2353,10 @@ void daxa_cmd_draw_mesh_tasks(daxa_CommandRecorder self, uint32_t x, uint32_t y,
 
 auto daxa_cmd_draw_mesh_tasks_indirect(daxa_CommandRecorder self, daxa_DrawMeshTasksIndirectInfo const * info) -> daxa_Result
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self, DAXA_RESULT_SUCCESS)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_MESH_TASKS_INDIRECT, capture_bytes(*info))
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer)
+    rebind_gpu_sro_table_if_grown(self);
     if (self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER)
     {
         self->device->vkCmdDrawMeshTasksIndirectEXT(
@@ -1021,7 +2373,10 @@ auto daxa_cmd_draw_mesh_tasks_indirect_count(
     daxa_CommandRecorder self,
     daxa_DrawMeshTasksIndirectCountInfo const * info) -> daxa_Result
 {
+    _DAXA_SKIP_IF_PIPELINE_PENDING(self, DAXA_RESULT_SUCCESS)
+    _DAXA_CAPTURE_COMMAND(self, DRAW_MESH_TASKS_INDIRECT_COUNT, capture_bytes(*info))
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer, info->count_buffer)
+    rebind_gpu_sro_table_if_grown(self);
     if (self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER)
     {
         self->device->vkCmdDrawMeshTasksIndirectCountEXT(
@@ -1038,7 +2393,8 @@ auto daxa_cmd_draw_mesh_tasks_indirect_count(
 
 void daxa_cmd_write_timestamp(daxa_CommandRecorder self, daxa_WriteTimestampInfo const * info)
 {
-    daxa_cmd_flush_barriers(self);
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    flush_barriers_keeping_pending_renderpass(self);
     vkCmdWriteTimestamp2(
         self->current_command_data.vk_cmd_buffer,
         info->pipeline_stage,
@@ -1048,6 +2404,7 @@ void daxa_cmd_write_timestamp(daxa_CommandRecorder self, daxa_WriteTimestampInfo
 
 void daxa_cmd_reset_timestamps(daxa_CommandRecorder self, daxa_ResetTimestampsInfo const * info)
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     daxa_cmd_flush_barriers(self);
     vkCmdResetQueryPool(
         self->current_command_data.vk_cmd_buffer,
@@ -1056,9 +2413,88 @@ void daxa_cmd_reset_timestamps(daxa_CommandRecorder self, daxa_ResetTimestampsIn
         info->count);
 }
 
-void daxa_cmd_begin_label(daxa_CommandRecorder self, daxa_CommandLabelInfo const * info)
+auto daxa_cmd_copy_timestamps_to_buffer(daxa_CommandRecorder self, daxa_CopyTimestampsToBufferInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    daxa_cmd_flush_barriers(self);
+    DAXA_CHECK_AND_REMEMBER_IDS(self, info->dst_buffer)
+    daxa_ImplTimelineQueryPool const & query_pool = **info->query_pool;
+    if (static_cast<u64>(info->start_index) + static_cast<u64>(info->count) > static_cast<u64>(query_pool.info.query_count))
+    {
+        return DAXA_RESULT_RANGE_OUT_OF_BOUNDS;
+    }
+    // Timestamp followed by availability.
+    u64 const stride = 2ull * sizeof(u64);
+    ImplBufferSlot const & dst_slot = self->device->slot(info->dst_buffer);
+    if (static_cast<u64>(info->dst_offset) + stride * info->count > static_cast<u64>(dst_slot.info.size))
+    {
+        return DAXA_RESULT_ERROR_COPY_OUT_OF_BOUNDS;
+    }
+    vkCmdCopyQueryPoolResults(
+        self->current_command_data.vk_cmd_buffer,
+        query_pool.vk_timeline_query_pool,
+        info->start_index,
+        info->count,
+        dst_slot.vk_buffer,
+        info->dst_offset,
+        stride,
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_cmd_begin_query(daxa_CommandRecorder self, daxa_BeginQueryInfo const * info) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    daxa_ImplQueryPool const & query_pool = **info->query_pool;
+    if (query_pool.info.query_type == VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR)
+    {
+        return DAXA_RESULT_ERROR_INVALID_QUERY_TYPE;
+    }
+    if (info->precise != 0)
+    {
+        if (query_pool.info.query_type != VK_QUERY_TYPE_OCCLUSION)
+        {
+            return DAXA_RESULT_ERROR_INVALID_QUERY_TYPE;
+        }
+        if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_PRECISE_OCCLUSION_QUERY) == 0)
+        {
+            return DAXA_RESULT_ERROR_PRECISE_OCCLUSION_QUERY_NOT_SUPPORTED;
+        }
+    }
+    daxa_cmd_flush_barriers(self);
+    vkCmdBeginQuery(
+        self->current_command_data.vk_cmd_buffer,
+        query_pool.vk_query_pool,
+        info->query_index,
+        info->precise != 0 ? VK_QUERY_CONTROL_PRECISE_BIT : VkQueryControlFlags{});
+    return DAXA_RESULT_SUCCESS;
+}
+
+void daxa_cmd_end_query(daxa_CommandRecorder self, daxa_EndQueryInfo const * info)
 {
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
     daxa_cmd_flush_barriers(self);
+    vkCmdEndQuery(
+        self->current_command_data.vk_cmd_buffer,
+        (**info->query_pool).vk_query_pool,
+        info->query_index);
+}
+
+void daxa_cmd_reset_queries(daxa_CommandRecorder self, daxa_ResetQueriesInfo const * info)
+{
+    _DAXA_CAPTURE_COMMAND(self, UNSUPPORTED)
+    daxa_cmd_flush_barriers(self);
+    vkCmdResetQueryPool(
+        self->current_command_data.vk_cmd_buffer,
+        (**info->query_pool).vk_query_pool,
+        info->start_index,
+        info->count);
+}
+
+void daxa_cmd_begin_label(daxa_CommandRecorder self, daxa_CommandLabelInfo const * info)
+{
+    _DAXA_CAPTURE_COMMAND(self, BEGIN_LABEL, capture_bytes(*info))
+    flush_barriers_keeping_pending_renderpass(self);
     VkDebugUtilsLabelEXT const vk_debug_label_info{
         .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
         .pNext = {},
@@ -1078,33 +2514,56 @@ void daxa_cmd_begin_label(daxa_CommandRecorder self, daxa_CommandLabelInfo const
 
 void daxa_cmd_end_label(daxa_CommandRecorder self)
 {
-    daxa_cmd_flush_barriers(self);
+    _DAXA_CAPTURE_COMMAND(self, END_LABEL)
+    flush_barriers_keeping_pending_renderpass(self);
     if ((self->device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE)
     {
         self->device->vkCmdEndDebugUtilsLabelEXT(self->current_command_data.vk_cmd_buffer);
     }
 }
 
+auto daxa_cmd_set_device_mask(daxa_CommandRecorder self, daxa_u32 device_mask) -> daxa_Result
+{
+    _DAXA_CAPTURE_COMMAND(self, SET_DEVICE_MASK, capture_bytes(device_mask))
+    u32 const group_size = self->device->device_group_size;
+    if ((device_mask >> group_size) != 0)
+    {
+        return DAXA_RESULT_ERROR_INVALID_DEVICE_MASK;
+    }
+    daxa_cmd_flush_barriers(self);
+    if (group_size > 1)
+    {
+        vkCmdSetDeviceMask(self->current_command_data.vk_cmd_buffer, device_mask != 0 ? device_mask : (1u << group_size) - 1u);
+    }
+    return DAXA_RESULT_SUCCESS;
+}
+
 void daxa_cmd_flush_barriers(daxa_CommandRecorder self)
 {
-    if (self->memory_barrier_batch_count > 0 || self->image_barrier_batch_count > 0)
+    end_pending_renderpass(self);
+    if (!self->memory_barrier_batch.empty() || !self->image_barrier_batch.empty())
     {
+        if (self->info.merge_barriers != 0)
+        {
+            self->stats.merged_barriers += merge_memory_barriers(self->memory_barrier_batch);
+            self->stats.merged_barriers += merge_image_barriers(self->image_barrier_batch);
+        }
         VkDependencyInfo const vk_dependency_info{
             .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
             .pNext = nullptr,
             .dependencyFlags = {},
-            .memoryBarrierCount = static_cast<u32>(self->memory_barrier_batch_count),
+            .memoryBarrierCount = static_cast<u32>(self->memory_barrier_batch.size()),
             .pMemoryBarriers = self->memory_barrier_batch.data(),
             .bufferMemoryBarrierCount = 0,
             .pBufferMemoryBarriers = nullptr,
-            .imageMemoryBarrierCount = static_cast<u32>(self->image_barrier_batch_count),
+            .imageMemoryBarrierCount = static_cast<u32>(self->image_barrier_batch.size()),
             .pImageMemoryBarriers = self->image_barrier_batch.data(),
         };
 
         vkCmdPipelineBarrier2(self->current_command_data.vk_cmd_buffer, &vk_dependency_info);
 
-        self->memory_barrier_batch_count = 0;
-        self->image_barrier_batch_count = 0;
+        self->memory_barrier_batch.clear();
+        self->image_barrier_batch.clear();
     }
 }
 
@@ -1125,6 +2584,12 @@ auto daxa_cmd_complete_current_commands(
         self->current_command_data = std::move(cmd_data);
         return result;
     }
+    // Keeps descriptor pools retired after this point alive until the list is submitted or destroyed.
+    if (cmd_data.oldest_bound_gpu_sro_table_generation != std::numeric_limits<u64>::max())
+    {
+        self->device->gpu_sro_table.unsubmitted_bound_command_lists.fetch_add(1, std::memory_order_acq_rel);
+        cmd_data.counted_as_unsubmitted = true;
+    }
     *out_executable_cmds = new daxa_ImplExecutableCommandList{
         .cmd_recorder = self,
         .data = std::move(cmd_data),
@@ -1139,6 +2604,11 @@ auto daxa_cmd_info(daxa_CommandRecorder self) -> daxa_CommandRecorderInfo const
     return &self->info;
 }
 
+auto daxa_cmd_stats(daxa_CommandRecorder self) -> daxa_CommandRecorderStats const *
+{
+    return &self->stats;
+}
+
 auto daxa_cmd_get_vk_command_buffer(daxa_CommandRecorder self) -> VkCommandBuffer
 {
     return self->current_command_data.vk_cmd_buffer;
@@ -1146,7 +2616,7 @@ auto daxa_cmd_get_vk_command_buffer(daxa_CommandRecorder self) -> VkCommandBuffe
 
 auto daxa_cmd_get_vk_command_pool(daxa_CommandRecorder self) -> VkCommandPool
 {
-    return self->vk_cmd_pool;
+    return self->cmd_pool.vk_cmd_pool;
 }
 
 void daxa_destroy_command_recorder(daxa_CommandRecorder self)
@@ -1159,41 +2629,7 @@ void daxa_destroy_command_recorder(daxa_CommandRecorder self)
 
 auto daxa_dvc_create_command_recorder(daxa_Device device, daxa_CommandRecorderInfo const * info, daxa_CommandRecorder * out_cmd_list) -> daxa_Result
 {
-    VkCommandPool vk_cmd_pool = [&]()
-    {
-        std::unique_lock lock{device->command_pool_pools[info->queue_family].mtx};
-        return device->command_pool_pools[info->queue_family].get(device);
-    }();
-    auto ret = daxa_ImplCommandRecorder{};
-    ret.device = device;
-    ret.info = *info;
-    ret.vk_cmd_pool = vk_cmd_pool;
-    auto result = ret.generate_new_current_command_data();
-    if (result != DAXA_RESULT_SUCCESS)
-    {
-        std::unique_lock lock{device->command_pool_pools[info->queue_family].mtx};
-        device->command_pool_pools[info->queue_family].put_back(vk_cmd_pool);
-        return result;
-    }
-    if ((ret.device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && ret.info.name.size != 0)
-    {
-        auto cmd_pool_name = ret.info.name;
-        VkDebugUtilsObjectNameInfoEXT const cmd_pool_name_info{
-            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
-            .pNext = nullptr,
-            .objectType = VK_OBJECT_TYPE_COMMAND_POOL,
-            .objectHandle = std::bit_cast<uint64_t>(ret.vk_cmd_pool),
-            .pObjectName = cmd_pool_name.data,
-        };
-        ret.device->vkSetDebugUtilsObjectNameEXT(ret.device->vk_device, &cmd_pool_name_info);
-    }
-    // TODO(lifetime): Maybe we should have a try lock variant?
-    ret.device->gpu_sro_table.lifetime_lock.lock_shared();
-    ret.strong_count = 1;
-    device->inc_weak_refcnt();
-    *out_cmd_list = new daxa_ImplCommandRecorder{};
-    **out_cmd_list = std::move(ret);
-    return DAXA_RESULT_SUCCESS;
+    return create_command_recorder(device, info, nullptr, out_cmd_list);
 }
 
 auto daxa_executable_commands_inc_refcnt(daxa_ExecutableCommandList self) -> u64
@@ -1212,53 +2648,153 @@ auto daxa_executable_commands_dec_refcnt(daxa_ExecutableCommandList self) -> u64
 
 /// --- Begin Internals ---
 
+struct DeferredDestructionScratchBuffers
+{
+    std::vector<daxa_BufferId> buffers = {};
+    std::vector<daxa_ImageId> images = {};
+    std::vector<daxa_ImageViewId> image_views = {};
+    std::vector<daxa_SamplerId> samplers = {};
+};
+
+inline static thread_local DeferredDestructionScratchBuffers tl_deferred_destruction_scratch_buffers = {}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
 void executable_cmd_list_execute_deferred_destructions(daxa_Device device, ExecutableCommandListData & cmd_list)
 {
+    if (cmd_list.deferred_destructions.empty())
+    {
+        return;
+    }
+    // Grouped by type, so that each type is zombified in bulk with a single zombie lock acquisition.
+    DeferredDestructionScratchBuffers & scratch = tl_deferred_destruction_scratch_buffers;
+    scratch.buffers.clear();
+    scratch.images.clear();
+    scratch.image_views.clear();
+    scratch.samplers.clear();
     for (auto [id, index] : cmd_list.deferred_destructions)
     {
-        // TODO(lifetime): check these and report errors if these were destroyed too early.
-        [[maybe_unused]] daxa_Result _ignore = {};
         switch (index)
         {
-        case DEFERRED_DESTRUCTION_BUFFER_INDEX: _ignore = daxa_dvc_destroy_buffer(device, std::bit_cast<daxa_BufferId>(id)); break;
-        case DEFERRED_DESTRUCTION_IMAGE_INDEX: _ignore = daxa_dvc_destroy_image(device, std::bit_cast<daxa_ImageId>(id)); break;
-        case DEFERRED_DESTRUCTION_IMAGE_VIEW_INDEX: _ignore = daxa_dvc_destroy_image_view(device, std::bit_cast<daxa_ImageViewId>(id)); break;
+        case DEFERRED_DESTRUCTION_BUFFER_INDEX: scratch.buffers.push_back(std::bit_cast<daxa_BufferId>(id)); break;
+        case DEFERRED_DESTRUCTION_IMAGE_INDEX: scratch.images.push_back(std::bit_cast<daxa_ImageId>(id)); break;
+        case DEFERRED_DESTRUCTION_IMAGE_VIEW_INDEX: scratch.image_views.push_back(std::bit_cast<daxa_ImageViewId>(id)); break;
         case DEFERRED_DESTRUCTION_SAMPLER_INDEX:
-            _ignore = daxa_dvc_destroy_sampler(device, std::bit_cast<daxa_SamplerId>(id));
+            scratch.samplers.push_back(std::bit_cast<daxa_SamplerId>(id));
             break;
             // TODO(capi): DO NOT THROW FROM A C FUNCTION
             // default: DAXA_DBG_ASSERT_TRUE_M(false, "unreachable");
         }
     }
+    // TODO(lifetime): check these and report errors if these were destroyed too early.
+    // Views are destroyed before images, matching the order of the zombie collection.
+    [[maybe_unused]] daxa_Result _ignore = {};
+    _ignore = daxa_dvc_destroy_image_views(device, scratch.image_views.data(), scratch.image_views.size());
+    _ignore = daxa_dvc_destroy_images(device, scratch.images.data(), scratch.images.size());
+    _ignore = daxa_dvc_destroy_buffers(device, scratch.buffers.data(), scratch.buffers.size());
+    _ignore = daxa_dvc_destroy_samplers(device, scratch.samplers.data(), scratch.samplers.size());
     cmd_list.deferred_destructions.clear();
 }
 
+void executable_cmd_list_notify_submit_timeline_listeners(ExecutableCommandListData & cmd_list, u64 submit_timeline_value)
+{
+    for (auto & listener : cmd_list.submit_timeline_listeners)
+    {
+        listener->store(submit_timeline_value, std::memory_order::release);
+    }
+    cmd_list.submit_timeline_listeners.clear();
+}
+
 auto daxa_ImplCommandRecorder::generate_new_current_command_data() -> daxa_Result
 {
-    VkCommandBufferAllocateInfo const vk_command_buffer_allocate_info{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+    this->current_command_data = this->device->command_list_data_pool.get(CommandPoolPool::current_thread_shard());
+    this->bound_state = {};
+    // Secondary command lists are executed by primary ones, they can not be replayed on their own.
+    this->current_command_data.capture_generation = this->is_secondary ? 0 : this->device->capture.active_generation.load(std::memory_order_relaxed);
+    auto vk_result = VK_SUCCESS;
+    auto & free_command_buffers = this->is_secondary ? this->cmd_pool.secondary_command_buffers : this->cmd_pool.primary_command_buffers;
+    if (!free_command_buffers.empty())
+    {
+        // Recycled pools were reset, their command buffers are in the initial state.
+        this->current_command_data.vk_cmd_buffer = free_command_buffers.back();
+        free_command_buffers.pop_back();
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo const vk_command_buffer_allocate_info{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .commandPool = this->cmd_pool.vk_cmd_pool,
+            .level = this->is_secondary ? VK_COMMAND_BUFFER_LEVEL_SECONDARY : VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1,
+        };
+        vk_result = vkAllocateCommandBuffers(this->device->vk_device, &vk_command_buffer_allocate_info, &this->current_command_data.vk_cmd_buffer);
+        if (vk_result != VK_SUCCESS)
+        {
+            return std::bit_cast<daxa_Result>(vk_result);
+        }
+    }
+    VkCommandBufferInheritanceRenderingInfo const vk_inheritance_rendering_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
         .pNext = nullptr,
-        .commandPool = this->vk_cmd_pool,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1,
+        .flags = {},
+        .viewMask = {},
+        .colorAttachmentCount = this->rendering.color_attachment_count,
+        .pColorAttachmentFormats = this->rendering.color_attachment_formats.data(),
+        .depthAttachmentFormat = this->rendering.depth_attachment_format,
+        .stencilAttachmentFormat = this->rendering.stencil_attachment_format,
+        .rasterizationSamples = this->rendering.rasterization_samples,
     };
-    auto vk_result = vkAllocateCommandBuffers(this->device->vk_device, &vk_command_buffer_allocate_info, &this->current_command_data.vk_cmd_buffer);
-    if (vk_result != VK_SUCCESS)
+    VkCommandBufferInheritanceInfo const vk_inheritance_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = &vk_inheritance_rendering_info,
+        .renderPass = VK_NULL_HANDLE,
+        .subpass = 0,
+        .framebuffer = VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = {},
+        .pipelineStatistics = {},
+    };
+    // Reusable command buffers may be pending multiple times, for example once per frame in flight.
+    VkCommandBufferUsageFlags usage_flags = this->info.reusable != 0 ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (this->is_secondary)
     {
-        return std::bit_cast<daxa_Result>(vk_result);
+        usage_flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
     }
     VkCommandBufferBeginInfo const vk_command_buffer_begin_info{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .pNext = nullptr,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = {},
+        .flags = usage_flags,
+        .pInheritanceInfo = this->is_secondary ? &vk_inheritance_info : nullptr,
     };
     vk_result = vkBeginCommandBuffer(this->current_command_data.vk_cmd_buffer, &vk_command_buffer_begin_info);
     if (vk_result != VK_SUCCESS)
     {
         return std::bit_cast<daxa_Result>(vk_result);
     }
+    if (this->is_secondary)
+    {
+        // Secondary command buffers inherit no dynamic state, start out like a freshly begun renderpass.
+        vkCmdSetScissor(this->current_command_data.vk_cmd_buffer, 0, 1, &this->rendering.render_area);
+        VkViewport const vk_viewport = {
+            .x = static_cast<f32>(this->rendering.render_area.offset.x),
+            .y = static_cast<f32>(this->rendering.render_area.offset.y),
+            .width = static_cast<f32>(this->rendering.render_area.extent.width),
+            .height = static_cast<f32>(this->rendering.render_area.extent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f,
+        };
+        vkCmdSetViewport(this->current_command_data.vk_cmd_buffer, 0, 1, &vk_viewport);
+        this->bound_state.viewport = vk_viewport;
+        this->bound_state.scissor = this->rendering.render_area;
+        if (this->device->vkCmdSetRasterizationSamplesEXT != nullptr)
+        {
+            this->device->vkCmdSetRasterizationSamplesEXT(this->current_command_data.vk_cmd_buffer, VK_SAMPLE_COUNT_1_BIT);
+        }
+    }
     this->allocated_command_buffers.push_back(this->current_command_data.vk_cmd_buffer);
+    this->current_command_data.descriptor_buffer_bound = false;
+    this->current_command_data.oldest_bound_gpu_sro_table_generation = std::numeric_limits<u64>::max();
+    this->current_command_data.counted_as_unsubmitted = false;
+    // Only freshly created data has no capacity yet, recycled data keeps what previous command lists grew it to.
     this->current_command_data.used_buffers.reserve(12);
     this->current_command_data.used_images.reserve(12);
     this->current_command_data.used_image_views.reserve(12);
@@ -1266,18 +2802,45 @@ auto daxa_ImplCommandRecorder::generate_new_current_command_data() -> daxa_Resul
     return DAXA_RESULT_SUCCESS;
 }
 
+void executable_cmd_list_release_secondaries(ExecutableCommandListData & cmd_list)
+{
+    for (daxa_ExecutableCommandList secondary : cmd_list.secondary_command_lists)
+    {
+        [[maybe_unused]] auto const _ignore = daxa_executable_commands_dec_refcnt(secondary);
+    }
+    cmd_list.secondary_command_lists.clear();
+}
+
+void executable_cmd_list_release_unsubmitted_count(daxa_Device device, ExecutableCommandListData & cmd_list)
+{
+    if (cmd_list.counted_as_unsubmitted)
+    {
+        device->gpu_sro_table.unsubmitted_bound_command_lists.fetch_sub(1, std::memory_order_acq_rel);
+        cmd_list.counted_as_unsubmitted = false;
+    }
+}
+
 void daxa_ImplCommandRecorder::zero_ref_callback(ImplHandle const * handle)
 {
     auto * self = rc_cast<daxa_CommandRecorder>(handle);
+    // Released before taking the zombie lock, as the secondary recorders take it when they die.
+    executable_cmd_list_release_secondaries(self->current_command_data);
     u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    // Unsubmitted commands never run, their listeners are released like their deferred destructions.
+    executable_cmd_list_notify_submit_timeline_listeners(self->current_command_data, submit_timeline);
     std::unique_lock const lock{self->device->zombies_mtx};
     executable_cmd_list_execute_deferred_destructions(self->device, self->current_command_data);
+    // All command buffers used by this recorder become reusable once the pool is reset.
+    auto & free_command_buffers = self->is_secondary ? self->cmd_pool.secondary_command_buffers : self->cmd_pool.primary_command_buffers;
+    free_command_buffers.insert(free_command_buffers.end(), self->allocated_command_buffers.begin(), self->allocated_command_buffers.end());
     self->device->command_list_zombies.emplace_front(
         submit_timeline,
         CommandRecorderZombie{
-            .vk_cmd_pool = self->vk_cmd_pool,
-            .allocated_command_buffers = std::move(self->allocated_command_buffers),
+            .queue_family = self->info.queue_family,
+            .cmd_pool_shard = self->cmd_pool_shard,
+            .cmd_pool = std::move(self->cmd_pool),
         });
+    self->device->command_list_data_pool.put_back(CommandPoolPool::current_thread_shard(), std::move(self->current_command_data));
     self->device->dec_weak_refcnt(
         &daxa_ImplDevice::zero_ref_callback,
         self->device->instance);
@@ -1287,7 +2850,12 @@ void daxa_ImplCommandRecorder::zero_ref_callback(ImplHandle const * handle)
 void daxa_ImplExecutableCommandList::zero_ref_callback(ImplHandle const * handle)
 {
     auto * self = rc_cast<daxa_ExecutableCommandList>(handle);
+    // Lists destroyed without being submitted still hold their listeners.
+    executable_cmd_list_notify_submit_timeline_listeners(self->data, self->cmd_recorder->device->global_submit_timeline.load(std::memory_order::relaxed));
     executable_cmd_list_execute_deferred_destructions(self->cmd_recorder->device, self->data);
+    executable_cmd_list_release_secondaries(self->data);
+    executable_cmd_list_release_unsubmitted_count(self->cmd_recorder->device, self->data);
+    self->cmd_recorder->device->command_list_data_pool.put_back(CommandPoolPool::current_thread_shard(), std::move(self->data));
     self->cmd_recorder->dec_refcnt(
         daxa_ImplCommandRecorder::zero_ref_callback,
         self->cmd_recorder->device->instance);
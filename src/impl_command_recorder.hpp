@@ -7,6 +7,8 @@
 #include <daxa/c/command_recorder.h>
 #include <daxa/command_recorder.hpp>
 
+#include <optional>
+
 using namespace daxa;
 
 struct ImplDevice;
@@ -19,36 +21,57 @@ static inline constexpr u8 DEFERRED_DESTRUCTION_TIMELINE_QUERY_POOL_INDEX = 4;
 // TODO: maybe reintroduce this in some fashion?
 // static inline constexpr usize DEFERRED_DESTRUCTION_COUNT_MAX = 32;
 
-static inline constexpr usize COMMAND_LIST_BARRIER_MAX_BATCH_SIZE = 16;
+// Barrier batches grow on demand and keep their capacity for the lifetime of the recorder.
+static inline constexpr usize COMMAND_LIST_BARRIER_INITIAL_BATCH_CAPACITY = 64;
 static inline constexpr usize COMMAND_LIST_COLOR_ATTACHMENT_MAX = 16;
 
+static inline constexpr u32 COMMAND_POOL_POOL_SHARD_COUNT = 16;
+
+// Pools are reset as a whole and keep their command buffers, the next recorder using the pool begins them again instead of allocating new ones.
+struct RecycledCommandPool
+{
+    VkCommandPool vk_cmd_pool = {};
+    std::vector<VkCommandBuffer> primary_command_buffers = {};
+    std::vector<VkCommandBuffer> secondary_command_buffers = {};
+};
+
+// Pools are sharded by thread. Each thread takes pools from and recycles pools into its own shard,
+// so that at steady state recorder creation only takes an uncontended shard lock.
 struct CommandPoolPool
 {
-    auto get(daxa_Device device) -> VkCommandPool;
+    static auto current_thread_shard() -> u32;
 
-    void put_back(VkCommandPool pool_and_buffer);
+    auto get(daxa_Device device, u32 shard, RecycledCommandPool & out_pool) -> daxa_Result;
+
+    void put_back(u32 shard, RecycledCommandPool && pool);
 
     void cleanup(daxa_Device device);
 
-    std::vector<VkCommandPool> pools_and_buffers = {};
+    struct Shard
+    {
+        std::vector<RecycledCommandPool> pools = {};
+        std::mutex mtx = {};
+    };
+    std::array<Shard, COMMAND_POOL_POOL_SHARD_COUNT> shards = {};
     u32 queue_family_index = { ~0u };
-    std::mutex mtx = {};
 };
 
 struct CommandRecorderZombie
 {
     daxa_QueueFamily queue_family = {};
-    VkCommandPool vk_cmd_pool = {};
-    std::vector<VkCommandBuffer> allocated_command_buffers = {};
+    u32 cmd_pool_shard = {};
+    RecycledCommandPool cmd_pool = {};
 };
 
 struct ExecutableCommandListData
 {
     VkCommandBuffer vk_cmd_buffer = {};
     std::vector<std::pair<GPUResourceId, u8>> deferred_destructions = {};
-    // TODO:    These vectors seem to be fast enough. overhead is around 1-4% in cmd recording.
-    //          It might be cool to have some slab allocator for these.
-    // If there is demand, we could make an instance or cmd list flag to disable the submit checks.
+    // Internal users, like the imgui renderer, get the global submit timeline value of the first submit written into these.
+    // Until then the values stay at u64 max. Lists destroyed unsubmitted write the submit timeline value at their destruction.
+    std::vector<std::shared_ptr<std::atomic_uint64_t>> submit_timeline_listeners = {};
+    // The vectors are recycled with their capacity through ExecutableCommandListDataPool, so steady state recording does not allocate.
+    // These stay empty when the recorder was created with disable_submit_id_validation.
     // TODO:    Also collect ref counted handles.
     std::vector<BufferId> used_buffers = {};
     std::vector<ImageId> used_images = {};
@@ -56,22 +79,114 @@ struct ExecutableCommandListData
     std::vector<SamplerId> used_samplers = {};
     std::vector<TlasId> used_tlass = {};
     std::vector<BlasId> used_blass = {};
+    // Only used when the device table is backed by a descriptor buffer.
+    bool descriptor_buffer_bound = {};
+    // Oldest resource table generation bound by these commands, reusable lists referencing retired descriptor sets are rejected on submit.
+    u64 oldest_bound_gpu_sro_table_generation = std::numeric_limits<u64>::max();
+    // Set while the list counts towards GPUShaderResourceTable::unsubmitted_bound_command_lists, cleared on the first submit or destruction.
+    bool counted_as_unsubmitted = {};
+    // Secondary command lists executed in these commands, each holds a reference.
+    std::vector<daxa_ExecutableCommandList> secondary_command_lists = {};
+    // Generation of the capture these commands are recorded for, zero when they are not captured, see daxa_dvc_begin_capture.
+    u64 capture_generation = {};
+    std::vector<std::byte> capture_commands = {};
+    // Index in the capture, assigned when the commands are first submitted. Guarded by CaptureState::mtx.
+    std::optional<u64> capture_index = {};
+};
+
+// Recycles the command data of destroyed command lists, cleared but with their vector capacities intact.
+// Sharded by thread like CommandPoolPool.
+struct ExecutableCommandListDataPool
+{
+    // Bounds the memory held by each shard.
+    static inline constexpr usize SHARD_CAPACITY = 64;
+
+    auto get(u32 shard) -> ExecutableCommandListData;
+
+    void put_back(u32 shard, ExecutableCommandListData && data);
+
+    struct Shard
+    {
+        std::vector<ExecutableCommandListData> datas = {};
+        std::mutex mtx = {};
+    };
+    std::array<Shard, COMMAND_POOL_POOL_SHARD_COUNT> shards = {};
+};
+
+// Attachment formats of a renderpass, inherited by the secondary command buffers recorded for it.
+struct RenderingInheritance
+{
+    std::array<VkFormat, COMMAND_LIST_COLOR_ATTACHMENT_MAX> color_attachment_formats = {};
+    u32 color_attachment_count = {};
+    VkFormat depth_attachment_format = VK_FORMAT_UNDEFINED;
+    VkFormat stencil_attachment_format = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits rasterization_samples = VK_SAMPLE_COUNT_1_BIT;
+    VkRect2D render_area = {};
+    bool secondary_command_lists = {};
 };
 
 struct daxa_ImplCommandRecorder final : ImplHandle
 {
     daxa_Device device = {};
     bool in_renderpass = {};
+    // Conditional rendering may not cross renderpass boundaries, so the scope it was begun in is remembered.
+    bool conditional_rendering_active = {};
+    bool conditional_rendering_in_renderpass = {};
+    // Secondary recorders record command buffers continuing the renderpass described by rendering.
+    bool is_secondary = {};
+    // For primary recorders the current renderpass, for secondary recorders the inherited one.
+    RenderingInheritance rendering = {};
+    // With info.merge_renderpasses, ending a renderpass is deferred so that a following compatible renderpass can continue it.
+    // pending_renderpass is the begin info of the current or pending renderpass, the attachment lists are stored inline.
+    bool renderpass_end_pending = {};
+    daxa_RenderPassBeginInfo pending_renderpass = {};
     daxa_CommandRecorderInfo info = {};
-    VkCommandPool vk_cmd_pool = {};
+    // Command buffers of the recorders level left in the pool are reused before allocating new ones.
+    RecycledCommandPool cmd_pool = {};
+    u32 cmd_pool_shard = {};
     std::vector<VkCommandBuffer> allocated_command_buffers = {};
-    std::array<VkMemoryBarrier2, COMMAND_LIST_BARRIER_MAX_BATCH_SIZE> memory_barrier_batch = {};
-    std::array<VkImageMemoryBarrier2, COMMAND_LIST_BARRIER_MAX_BATCH_SIZE> image_barrier_batch = {};
-    usize image_barrier_batch_count = {};
-    usize memory_barrier_batch_count = {};
+    // All barriers recorded between two non barrier commands, flushed with a single vkCmdPipelineBarrier2.
+    std::vector<VkMemoryBarrier2> memory_barrier_batch = {};
+    std::vector<VkImageMemoryBarrier2> image_barrier_batch = {};
     usize split_barrier_batch_count = {};
     struct NoPipeline {};
-    Variant<NoPipeline, daxa_ComputePipeline, daxa_RasterPipeline, daxa_RayTracingPipeline> current_pipeline = NoPipeline{};
+    // Graphics shader objects are bound per stage, only their shared layout is needed afterwards.
+    struct RasterShaderObjects
+    {
+        VkPipelineLayout vk_pipeline_layout = {};
+    };
+    Variant<NoPipeline, daxa_ComputePipeline, daxa_RasterPipeline, daxa_RayTracingPipeline, daxa_ShaderObject, RasterShaderObjects> current_pipeline = NoPipeline{};
+    // Generation of the device resource table sets that were last bound, see GPUShaderResourceTable::generation.
+    u64 bound_gpu_sro_table_generation = {};
+    // Shadow of the state bound in the current command buffer, used to drop redundant state commands.
+    struct BoundState
+    {
+        VkPipeline pipeline = {};
+        // Set while an asynchronously created pipeline without a ready fallback is bound, only its layout is bound then.
+        bool pending_pipeline = {};
+        // Cached with the pipeline, push constants are written without looking at the pipeline.
+        VkPipelineLayout pipeline_layout = {};
+        u32 push_constant_size = {};
+        std::optional<VkViewport> viewport = {};
+        std::optional<VkRect2D> scissor = {};
+        // Shader objects require the WithCount variants of the viewport and scissor state, pipelines the plain ones.
+        bool graphics_shader_objects = {};
+        VkBuffer index_buffer = {};
+        VkDeviceSize index_buffer_offset = {};
+        VkIndexType index_type = {};
+        // Layout and table generation the device table sets were last bound with, indexed by compute, graphics and ray tracing bind point.
+        // Pipelines with the same push constant size share their layout, switching between them keeps the sets bound.
+        struct GpuSroTableBinding
+        {
+            VkPipelineLayout layout = {};
+            u64 generation = {};
+        };
+        std::array<GpuSroTableBinding, 3> gpu_sro_table_bindings = {};
+    };
+    BoundState bound_state = {};
+    // Last pushed bytes, fills the gaps between the fields of a push constant range.
+    std::array<std::byte, MAX_PUSH_CONSTANT_BYTE_SIZE> push_constant_shadow = {};
+    daxa_CommandRecorderStats stats = {};
 
     ExecutableCommandListData current_command_data = {};
 
@@ -88,4 +203,10 @@ struct daxa_ImplExecutableCommandList final : ImplHandle
     static void zero_ref_callback(ImplHandle const * handle);
 };
 
-void executable_cmd_list_execute_deferred_destructions(daxa_Device device, ExecutableCommandListData & cmd_list);
\ No newline at end of file
+void executable_cmd_list_execute_deferred_destructions(daxa_Device device, ExecutableCommandListData & cmd_list);
+
+void executable_cmd_list_notify_submit_timeline_listeners(ExecutableCommandListData & cmd_list, u64 submit_timeline_value);
+
+void executable_cmd_list_release_secondaries(ExecutableCommandListData & cmd_list);
+
+void executable_cmd_list_release_unsubmitted_count(daxa_Device device, ExecutableCommandListData & cmd_list);
\ No newline at end of file
@@ -234,6 +234,18 @@ auto construct_daxa_physical_device_properties(VkPhysicalDevice physical_device)
         ret.mesh_shader_properties.value.prefers_compact_primitive_output = static_cast<daxa_Bool8>(vk_physical_device_mesh_shader_properties_ext.prefersCompactPrimitiveOutput);
     }
 
+    VkPhysicalDeviceMemoryProperties vk_memory_properties = {};
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &vk_memory_properties);
+    VkMemoryPropertyFlags const bar_memory_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    for (u32 type = 0; type < vk_memory_properties.memoryTypeCount; ++type)
+    {
+        if ((vk_memory_properties.memoryTypes[type].propertyFlags & bar_memory_flags) == bar_memory_flags)
+        {
+            u64 const heap_size = vk_memory_properties.memoryHeaps[vk_memory_properties.memoryTypes[type].heapIndex].size;
+            ret.device_local_host_visible_heap_size = std::max(ret.device_local_host_visible_heap_size, heap_size);
+        }
+    }
+
     u32 queue_family_props_count = 0;
     std::vector<VkQueueFamilyProperties> queue_props;
     vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_props_count, nullptr);
@@ -283,6 +295,7 @@ void daxa_as_build_info_to_vk(
     usize blas_count,
     std::vector<VkAccelerationStructureBuildGeometryInfoKHR> & vk_build_geometry_infos,
     std::vector<VkAccelerationStructureGeometryKHR> & vk_geometry_infos,
+    std::vector<VkAccelerationStructureTrianglesOpacityMicromapEXT> & vk_opacity_micromaps,
     std::vector<u32> & primitive_counts,
     std::vector<u32 const *> & primitive_counts_ptrs)
 {
@@ -299,6 +312,8 @@ void daxa_as_build_info_to_vk(
         geo_infos_count += blas_infos[blas_i].geometries.values.triangles.count;
     }
     vk_geometry_infos.reserve(geo_infos_count);
+    // Geometries point into this vector, it must never reallocate.
+    vk_opacity_micromaps.reserve(geo_infos_count);
     primitive_counts.reserve(geo_infos_count);
     for (u32 tlas_i = 0; tlas_i < tlas_count; ++tlas_i)
     {
@@ -333,6 +348,8 @@ void daxa_as_build_info_to_vk(
             .mode = info.update ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR  : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR,
             .srcAccelerationStructure = info.src_tlas.value != 0
                     ? device->slot(info.src_tlas).vk_acceleration_structure
+                : (info.update != 0 && info.dst_tlas.value != 0)
+                    ? device->slot(info.dst_tlas).vk_acceleration_structure
                     : nullptr,
             .dstAccelerationStructure =
                 info.dst_tlas.value != 0
@@ -373,6 +390,23 @@ void daxa_as_build_info_to_vk(
                     .indexData = std::bit_cast<VkDeviceOrHostAddressConstKHR>(info.geometries.values.triangles.triangles[geo_i].index_data),
                     .transformData = std::bit_cast<VkDeviceOrHostAddressConstKHR>(info.geometries.values.triangles.triangles[geo_i].transform_data),
                 };
+                daxa_BlasTriangleGeometryInfo const & tri_info = info.geometries.values.triangles.triangles[geo_i];
+                if (tri_info.opacity_micromap != nullptr)
+                {
+                    vk_opacity_micromaps.push_back(VkAccelerationStructureTrianglesOpacityMicromapEXT{
+                        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_TRIANGLES_OPACITY_MICROMAP_EXT,
+                        .pNext = nullptr,
+                        .indexType = tri_info.opacity_micromap_index_type,
+                        .indexBuffer = std::bit_cast<VkDeviceOrHostAddressConstKHR>(tri_info.opacity_micromap_index_data),
+                        .indexStride = tri_info.opacity_micromap_index_stride,
+                        .baseTriangle = tri_info.opacity_micromap_base_triangle,
+                        .usageCountsCount = static_cast<u32>(tri_info.opacity_micromap_usage_count),
+                        .pUsageCounts = tri_info.opacity_micromap_usage_counts,
+                        .ppUsageCounts = nullptr,
+                        .micromap = tri_info.opacity_micromap->vk_micromap,
+                    });
+                    geo_info.geometry.triangles.pNext = &vk_opacity_micromaps.back();
+                }
                 primitive_counts.push_back(info.geometries.values.triangles.triangles[geo_i].count);
             }
             else // aabbs
@@ -397,6 +431,8 @@ void daxa_as_build_info_to_vk(
             .mode = info.update ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR  : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR,
             .srcAccelerationStructure = info.src_blas.value != 0
                     ? device->slot(info.src_blas).vk_acceleration_structure
+                : (info.update != 0 && info.dst_blas.value != 0)
+                    ? device->slot(info.dst_blas).vk_acceleration_structure
                     : nullptr,
             .dstAccelerationStructure =
                 info.dst_blas.value != 0
@@ -555,6 +591,7 @@ auto daxa_dvc_create_memory(daxa_Device self, daxa_MemoryBlockInfo const * info,
         return std::bit_cast<daxa_Result>(result);
     }
 
+    self->memory_block_bytes.fetch_add(ret.alloc_info.size, std::memory_order_relaxed);
     ret.strong_count = 1;
     self->inc_weak_refcnt();
     *out_memory_block = new daxa_ImplMemoryBlock{};
@@ -583,6 +620,7 @@ auto daxa_memory_block_dec_refcnt(daxa_MemoryBlock self) -> u64
 void daxa_ImplMemoryBlock::zero_ref_callback(ImplHandle const * handle)
 {
     auto * self = rc_cast<daxa_ImplMemoryBlock *>(handle);
+    self->device->memory_block_bytes.fetch_sub(self->alloc_info.size, std::memory_order_relaxed);
     std::unique_lock const lock{self->device->zombies_mtx};
     u64 const submit_timeline_value = self->device->global_submit_timeline.load(std::memory_order::relaxed);
     self->device->memory_block_zombies.emplace_front(
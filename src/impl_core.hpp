@@ -111,6 +111,7 @@ void daxa_as_build_info_to_vk(
     usize blas_count,
     std::vector<VkAccelerationStructureBuildGeometryInfoKHR> & vk_build_geometry_infos,
     std::vector<VkAccelerationStructureGeometryKHR> & vk_geometry_infos,
+    std::vector<VkAccelerationStructureTrianglesOpacityMicromapEXT> & vk_opacity_micromaps,
     std::vector<u32> & primitive_counts,
     std::vector<u32 const *> & primitive_counts_ptrs);
 
@@ -1,7 +1,11 @@
 #include "impl_device.hpp"
+#include "impl_profiling.hpp"
 
 #include <utility>
 #include <functional>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
 #include "impl_features.hpp"
 
 #include "impl_device.hpp"
@@ -10,7 +14,8 @@
 
 namespace
 {
-    auto initialize_image_create_info_from_image_info(daxa_Device self, daxa_ImageInfo const & image_info) -> VkImageCreateInfo
+    // Video images need the profile structs chained into the create info, they are initialized into video_profile.
+    auto initialize_image_create_info_from_image_info(daxa_Device self, daxa_ImageInfo const & image_info, ImplVideoProfile & video_profile) -> VkImageCreateInfo
     {
         DAXA_DBG_ASSERT_TRUE_M(std::popcount(image_info.sample_count) == 1 && image_info.sample_count <= 8, "image samples must be power of two and between 1 and 64(inclusive)");
         DAXA_DBG_ASSERT_TRUE_M(
@@ -35,7 +40,8 @@ namespace
             .mipLevels = image_info.mip_level_count,
             .arrayLayers = image_info.array_layer_count,
             .samples = static_cast<VkSampleCountFlagBits>(image_info.sample_count),
-            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            // Other apis import dma-bufs without a drm format modifier as linear images.
+            .tiling = image_info.external_memory.handle_type == DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF ? VK_IMAGE_TILING_LINEAR : VK_IMAGE_TILING_OPTIMAL,
             .usage = image_info.usage,
             .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
             .queueFamilyIndexCount = 1,
@@ -48,6 +54,21 @@ namespace
             vk_image_create_info.queueFamilyIndexCount = self->valid_vk_queue_family_count;
             vk_image_create_info.pQueueFamilyIndices = self->valid_vk_queue_families.data();
         }
+        constexpr VkImageUsageFlags VIDEO_IMAGE_USAGES =
+            VK_IMAGE_USAGE_VIDEO_DECODE_DST_BIT_KHR | VK_IMAGE_USAGE_VIDEO_DECODE_SRC_BIT_KHR | VK_IMAGE_USAGE_VIDEO_DECODE_DPB_BIT_KHR |
+            VK_IMAGE_USAGE_VIDEO_ENCODE_DST_BIT_KHR | VK_IMAGE_USAGE_VIDEO_ENCODE_SRC_BIT_KHR | VK_IMAGE_USAGE_VIDEO_ENCODE_DPB_BIT_KHR;
+        if ((image_info.usage & VIDEO_IMAGE_USAGES) != 0)
+        {
+            if (image_info.video_profile.codec_operation == DAXA_VIDEO_CODEC_OPERATION_NONE)
+            {
+                vk_image_create_info.flags |= VK_IMAGE_CREATE_VIDEO_PROFILE_INDEPENDENT_BIT_KHR;
+            }
+            else
+            {
+                video_profile.initialize(image_info.video_profile);
+                vk_image_create_info.pNext = &video_profile.vk_profile_list;
+            }
+        }
         return vk_image_create_info;
     }
     using namespace daxa::types;
@@ -66,12 +87,345 @@ namespace
                       VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
                       VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR;
         }
+        if (self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING)
+        {
+            result |= VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT;
+        }
+        if (self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP)
+        {
+            result |= VK_BUFFER_USAGE_MICROMAP_BUILD_INPUT_READ_ONLY_BIT_EXT |
+                      VK_BUFFER_USAGE_MICROMAP_STORAGE_BIT_EXT;
+        }
+        return result;
+    }
+
+    // Video usages are only added to bitstream buffers, other buffers would pay for them in memory requirements and driver paths.
+    inline auto create_buffer_use_flags(daxa_Device self, daxa_BufferInfo const & info) -> VkBufferUsageFlags
+    {
+        VkBufferUsageFlags result = create_buffer_use_flags(self);
+        if (info.video_bitstream)
+        {
+            if (self->properties.video_decode_queue_count > 0)
+            {
+                result |= VK_BUFFER_USAGE_VIDEO_DECODE_SRC_BIT_KHR |
+                          VK_BUFFER_USAGE_VIDEO_DECODE_DST_BIT_KHR;
+            }
+            if (self->properties.video_encode_queue_count > 0)
+            {
+                result |= VK_BUFFER_USAGE_VIDEO_ENCODE_SRC_BIT_KHR |
+                          VK_BUFFER_USAGE_VIDEO_ENCODE_DST_BIT_KHR;
+            }
+        }
         return result;
     }
+
+    // Bitstream buffers are created independent of any video profile.
+    inline auto create_buffer_create_flags(daxa_BufferInfo const & info) -> VkBufferCreateFlags
+    {
+        if (info.video_bitstream)
+        {
+            return VK_BUFFER_CREATE_VIDEO_PROFILE_INDEPENDENT_BIT_KHR;
+        }
+        return {};
+    }
+
+    // With device generated commands all buffers may be used as preprocess buffers, the usage then has to be given as flags2.
+    // usage_flags2 holds the chained struct, it must outlive the create info.
+    inline auto buffer_create_info_pnext(daxa_Device self, daxa_BufferInfo const & info, VkBufferUsageFlags2CreateInfoKHR & usage_flags2) -> void const *
+    {
+        if (self->buffer_usage_flags2_info.sType != VK_STRUCTURE_TYPE_BUFFER_USAGE_FLAGS_2_CREATE_INFO_KHR)
+        {
+            return nullptr;
+        }
+        usage_flags2 = self->buffer_usage_flags2_info;
+        usage_flags2.usage |= static_cast<VkBufferUsageFlags2KHR>(create_buffer_use_flags(self, info));
+        return &usage_flags2;
+    }
+
+    static constexpr std::string_view PIPELINE_CACHE_FILE_PREFIX = "daxa_pipeline_cache_";
+    static constexpr std::string_view PIPELINE_BINARY_ARCHIVE_FILE_PREFIX = "daxa_pipeline_binaries_";
+
+    // Reads the whole file with a single read, returns an empty blob when the file is missing.
+    auto read_binary_file(std::filesystem::path const & path) -> std::vector<std::byte>
+    {
+        std::ifstream file{path, std::ios::binary | std::ios::ate};
+        if (!file.is_open())
+        {
+            return {};
+        }
+        auto const size = static_cast<usize>(file.tellg());
+        std::vector<std::byte> data(size);
+        file.seekg(0);
+        file.read(r_cast<char *>(data.data()), static_cast<std::streamsize>(size));
+        if (!file)
+        {
+            return {};
+        }
+        return data;
+    }
+
+    // Written next to the final file and renamed, so a crash mid write never leaves a truncated file behind.
+    auto write_binary_file(std::filesystem::path const & path, std::span<std::byte const> data) -> bool
+    {
+        std::error_code error = {};
+        std::filesystem::create_directories(path.parent_path(), error);
+        auto temp_path = path;
+        temp_path += ".tmp";
+        {
+            std::ofstream file{temp_path, std::ios::binary | std::ios::trunc};
+            file.write(r_cast<char const *>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file)
+            {
+                return false;
+            }
+        }
+        std::filesystem::rename(temp_path, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+        return true;
+    }
+
+    // Returns an empty blob when the file is missing or was written by a different driver or device.
+    // Drivers are required to reject foreign caches themselves, checking the header here just avoids handing them garbage.
+    auto read_pipeline_cache_file(daxa_Device self) -> std::vector<std::byte>
+    {
+        auto data = read_binary_file(self->pipeline_cache_file_path(PIPELINE_CACHE_FILE_PREFIX));
+        if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+        {
+            return {};
+        }
+        VkPipelineCacheHeaderVersionOne header = {};
+        std::memcpy(&header, data.data(), sizeof(header));
+        bool const matches_driver =
+            header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+            header.vendorID == self->properties.vendor_id &&
+            header.deviceID == self->properties.device_id &&
+            std::memcmp(header.pipelineCacheUUID, self->properties.pipeline_cache_uuid, VK_UUID_SIZE) == 0;
+        if (!matches_driver)
+        {
+            return {};
+        }
+        return data;
+    }
+
+    // Allocations of movable resources carry their slot in the vma user data, so that defragmentation moves can find their slot.
+    // Bit 0 marks movable allocations, bit 1 marks images and the remaining bits hold the slot index.
+    auto movable_allocation_user_data(daxa_MemoryFlags flags, u32 slot_index, bool is_image) -> void *
+    {
+        if ((flags & DAXA_MEMORY_FLAG_MOVABLE) == 0)
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<void *>((static_cast<uintptr_t>(slot_index) << 2) | (is_image ? 0x2u : 0x0u) | 0x1u);
+    }
+
+    // Strips the daxa only memory flags and translates them into their vma equivalent.
+    auto vma_allocation_flags_from_memory_flags(daxa_MemoryFlags flags) -> VmaAllocationCreateFlags
+    {
+        auto ret = static_cast<VmaAllocationCreateFlags>(flags & ~(DAXA_MEMORY_FLAG_MOVABLE | DAXA_MEMORY_FLAG_HOST_CACHED | DAXA_MEMORY_FLAG_PREFER_DEVICE_LOCAL_HOST_VISIBLE));
+        if ((flags & DAXA_MEMORY_FLAG_HOST_CACHED) != 0)
+        {
+            ret |= VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+        }
+        if ((flags & DAXA_MEMORY_FLAG_PREFER_DEVICE_LOCAL_HOST_VISIBLE) != 0)
+        {
+            ret |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        }
+        return ret;
+    }
+
+    auto vma_preferred_memory_flags(daxa_MemoryFlags flags) -> VkMemoryPropertyFlags
+    {
+        VkMemoryPropertyFlags ret = {};
+        if ((flags & DAXA_MEMORY_FLAG_HOST_CACHED) != 0)
+        {
+            ret |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        }
+        if ((flags & DAXA_MEMORY_FLAG_PREFER_DEVICE_LOCAL_HOST_VISIBLE) != 0)
+        {
+            ret |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        }
+        return ret;
+    }
+
+    // Opaque handles only exist on their own platform, dma-bufs additionally need VK_EXT_external_memory_dma_buf.
+    auto validate_external_memory_info(daxa_Device self, daxa_ExternalMemoryInfo const & info) -> daxa_Result
+    {
+        if (info.handle_type == DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_NONE)
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+        if ((self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_EXTERNAL_MEMORY) == 0)
+        {
+            return DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED;
+        }
+#if defined(_WIN32)
+        bool const supported = info.handle_type == DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32;
+#else
+        bool const supported = info.handle_type == DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD ||
+                               (info.handle_type == DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF && self->physical_device_features.external_memory_dma_buf);
+#endif
+        return supported ? DAXA_RESULT_SUCCESS : DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED;
+    }
+
+    // vma can not chain export or import infos into its allocations, so external memory is a dedicated vkAllocateMemory.
+    // Exactly one of vk_buffer and vk_image is set.
+    auto allocate_external_memory(
+        daxa_Device self,
+        daxa_ExternalMemoryInfo const & info,
+        VkMemoryRequirements const & requirements,
+        VkBuffer vk_buffer,
+        VkImage vk_image,
+        VkDeviceMemory * out_memory) -> daxa_Result
+    {
+        auto const vk_handle_type = static_cast<VkExternalMemoryHandleTypeFlagBits>(info.handle_type);
+        u32 memory_type_bits = requirements.memoryTypeBits;
+        void const * chain = nullptr;
+
+        VkMemoryAllocateFlagsInfo vk_allocate_flags_info{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+            .pNext = nullptr,
+            .flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+            .deviceMask = {},
+        };
+        if (vk_buffer != VK_NULL_HANDLE)
+        {
+            chain = &vk_allocate_flags_info;
+        }
+        VkExportMemoryAllocateInfo vk_export_info{
+            .sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO,
+            .pNext = chain,
+            .handleTypes = static_cast<VkExternalMemoryHandleTypeFlags>(vk_handle_type),
+        };
+#if defined(_WIN32)
+        VkImportMemoryWin32HandleInfoKHR vk_import_info{
+            .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_WIN32_HANDLE_INFO_KHR,
+            .pNext = chain,
+            .handleType = vk_handle_type,
+            .handle = reinterpret_cast<HANDLE>(info.import_handle.value),
+            .name = nullptr,
+        };
+#else
+        VkImportMemoryFdInfoKHR vk_import_info{
+            .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR,
+            .pNext = chain,
+            .handleType = vk_handle_type,
+            .fd = static_cast<int>(info.import_handle.value),
+        };
+        if (info.import_handle.has_value && vk_handle_type == VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT)
+        {
+            // dma-bufs may come from other drivers, only some memory types can import them.
+            VkMemoryFdPropertiesKHR vk_fd_properties{
+                .sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR,
+                .pNext = nullptr,
+                .memoryTypeBits = {},
+            };
+            auto const result = static_cast<daxa_Result>(self->vkGetMemoryFdPropertiesKHR(self->vk_device, vk_handle_type, vk_import_info.fd, &vk_fd_properties));
+            _DAXA_RETURN_IF_ERROR(result, result)
+            memory_type_bits &= vk_fd_properties.memoryTypeBits;
+        }
+#endif
+        chain = info.import_handle.has_value ? static_cast<void const *>(&vk_import_info) : static_cast<void const *>(&vk_export_info);
+        VkMemoryDedicatedAllocateInfo const vk_dedicated_info{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+            .pNext = chain,
+            .image = vk_image,
+            .buffer = vk_buffer,
+        };
+
+        // Prefers device local memory, falls back to any type the import allows.
+        VkPhysicalDeviceMemoryProperties const * vk_memory_properties = {};
+        vmaGetMemoryProperties(self->vma_allocator, &vk_memory_properties);
+        u32 memory_type_index = ~0u;
+        for (u32 i = 0; i < vk_memory_properties->memoryTypeCount; ++i)
+        {
+            if ((memory_type_bits & (1u << i)) == 0)
+            {
+                continue;
+            }
+            bool const device_local = (vk_memory_properties->memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+            if (memory_type_index == ~0u || (device_local && (vk_memory_properties->memoryTypes[memory_type_index].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == 0))
+            {
+                memory_type_index = i;
+            }
+        }
+        if (memory_type_index == ~0u)
+        {
+            return DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED;
+        }
+
+        VkMemoryAllocateInfo const vk_memory_allocate_info{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .pNext = &vk_dedicated_info,
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = memory_type_index,
+        };
+        return static_cast<daxa_Result>(vkAllocateMemory(self->vk_device, &vk_memory_allocate_info, nullptr, out_memory));
+    }
+
+    // Imported memory was not allocated exportable, only memory daxa allocated itself can be exported.
+    auto export_external_memory(daxa_Device self, daxa_ExternalMemoryInfo const & info, VkDeviceMemory vk_memory, uint64_t * out_handle) -> daxa_Result
+    {
+        if (vk_memory == VK_NULL_HANDLE || info.import_handle.has_value)
+        {
+            return DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED;
+        }
+#if defined(_WIN32)
+        VkMemoryGetWin32HandleInfoKHR const vk_get_handle_info{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR,
+            .pNext = nullptr,
+            .memory = vk_memory,
+            .handleType = static_cast<VkExternalMemoryHandleTypeFlagBits>(info.handle_type),
+        };
+        HANDLE handle = {};
+        auto const result = static_cast<daxa_Result>(self->vkGetMemoryWin32HandleKHR(self->vk_device, &vk_get_handle_info, &handle));
+        _DAXA_RETURN_IF_ERROR(result, result)
+        *out_handle = reinterpret_cast<uint64_t>(handle);
+#else
+        VkMemoryGetFdInfoKHR const vk_get_fd_info{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR,
+            .pNext = nullptr,
+            .memory = vk_memory,
+            .handleType = static_cast<VkExternalMemoryHandleTypeFlagBits>(info.handle_type),
+        };
+        int fd = -1;
+        auto const result = static_cast<daxa_Result>(self->vkGetMemoryFdKHR(self->vk_device, &vk_get_fd_info, &fd));
+        _DAXA_RETURN_IF_ERROR(result, result)
+        *out_handle = static_cast<uint64_t>(fd);
+#endif
+        return DAXA_RESULT_SUCCESS;
+    }
 } // namespace
 
 auto daxa_ImplDevice::ImplQueue::initialize(VkDevice vk_device, u32 queue_family_index, u32 queue_index) -> daxa_Result
 {
+    this->vk_queue_family_index = queue_family_index;
+    vkGetDeviceQueue(vk_device, queue_family_index, queue_index, &this->vk_queue);
+    daxa_Result result = DAXA_RESULT_SUCCESS;
+    if (this->vk_queue == VK_NULL_HANDLE)
+    {
+        result = DAXA_RESULT_ERROR_COULD_NOT_QUERY_QUEUE;
+    }
+    _DAXA_RETURN_IF_ERROR(result, result)
+
+    return result;
+}
+
+auto daxa_ImplDevice::ImplQueue::ensure_timeline(daxa_Device device) -> daxa_Result
+{
+    if (this->gpu_queue_local_timeline.load(std::memory_order::acquire) != VK_NULL_HANDLE)
+    {
+        return DAXA_RESULT_SUCCESS;
+    }
+    std::unique_lock const lock{this->gpu_queue_local_timeline_creation_mtx};
+    if (this->gpu_queue_local_timeline.load(std::memory_order::relaxed) != VK_NULL_HANDLE)
+    {
+        return DAXA_RESULT_SUCCESS;
+    }
+
     VkSemaphoreTypeCreateInfo timeline_ci{
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
         .pNext = nullptr,
@@ -85,35 +439,45 @@ auto daxa_ImplDevice::ImplQueue::initialize(VkDevice vk_device, u32 queue_family
         .flags = {},
     };
 
-    this->vk_queue_family_index = queue_family_index;
-    vkGetDeviceQueue(vk_device, queue_family_index, queue_index, &this->vk_queue);
-    daxa_Result result = DAXA_RESULT_SUCCESS;
-    if (this->vk_queue == VK_NULL_HANDLE)
-    {
-        result = DAXA_RESULT_ERROR_COULD_NOT_QUERY_QUEUE;
-    }
+    VkSemaphore timeline = {};
+    auto result = static_cast<daxa_Result>(vkCreateSemaphore(device->vk_device, &vk_semaphore_create_info, nullptr, &timeline));
     _DAXA_RETURN_IF_ERROR(result, result)
 
-    result = static_cast<daxa_Result>(vkCreateSemaphore(vk_device, &vk_semaphore_create_info, nullptr, &this->gpu_queue_local_timeline));
-    _DAXA_RETURN_IF_ERROR(result, result)
+    if ((device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE)
+    {
+        std::string timeline_name = {"[DAXA DEVICE] Queue timeline semaphore "};
+        timeline_name += to_string(static_cast<QueueFamily>(this->family));
 
-    return result;
+        VkDebugUtilsObjectNameInfoEXT const timeline_semaphore_name_info{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            .pNext = nullptr,
+            .objectType = VK_OBJECT_TYPE_SEMAPHORE,
+            .objectHandle = std::bit_cast<uint64_t>(timeline),
+            .pObjectName = timeline_name.data(),
+        };
+        device->vkSetDebugUtilsObjectNameEXT(device->vk_device, &timeline_semaphore_name_info);
+    }
+
+    this->gpu_queue_local_timeline.store(timeline, std::memory_order::release);
+    return DAXA_RESULT_SUCCESS;
 }
 
 void daxa_ImplDevice::ImplQueue::cleanup(VkDevice device)
 {
-    if (this->gpu_queue_local_timeline)
+    VkSemaphore const timeline = this->gpu_queue_local_timeline.load(std::memory_order::relaxed);
+    if (timeline != VK_NULL_HANDLE)
     {
-        vkDestroySemaphore(device, this->gpu_queue_local_timeline, nullptr);
+        vkDestroySemaphore(device, timeline, nullptr);
     }
 }
 
 auto daxa_ImplDevice::ImplQueue::get_oldest_pending_submit(VkDevice vk_device, std::optional<u64> & out) -> daxa_Result
 {
-    if (this->gpu_queue_local_timeline)
+    VkSemaphore const timeline = this->gpu_queue_local_timeline.load(std::memory_order::acquire);
+    if (timeline != VK_NULL_HANDLE)
     {
         u64 latest_gpu = {};
-        auto result = static_cast<daxa_Result>(vkGetSemaphoreCounterValue(vk_device, this->gpu_queue_local_timeline, &latest_gpu));
+        auto result = static_cast<daxa_Result>(vkGetSemaphoreCounterValue(vk_device, timeline, &latest_gpu));
         _DAXA_RETURN_IF_ERROR(result, result);
 
         u64 latest_cpu = this->latest_pending_submit_timeline_value.load(std::memory_order::acquire);
@@ -127,8 +491,29 @@ auto daxa_ImplDevice::ImplQueue::get_oldest_pending_submit(VkDevice vk_device, s
     return DAXA_RESULT_SUCCESS;
 }
 
-auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_BufferId * out_id, daxa_MemoryBlock opt_memory_block, usize opt_offset) -> daxa_Result
+// Images are written into the storage and sampled image sets, both must be able to hold the image index.
+auto ensure_image_descriptor_capacity(daxa_Device self, GPUResourceId id) -> daxa_Result
+{
+    auto result = self->gpu_sro_table.ensure_capacity(self->vk_device, DAXA_STORAGE_IMAGE_BINDING, id.index + 1);
+    _DAXA_RETURN_IF_ERROR(result, result)
+    return self->gpu_sro_table.ensure_capacity(self->vk_device, DAXA_SAMPLED_IMAGE_BINDING, id.index + 1);
+}
+
+// When opt_reserved_id is set, the helper fills that slot from try_create_slots instead of creating one.
+// Reserved slots stay owned by the caller on failure.
+// When opt_descriptor_writes is set, the descriptor writes are recorded into it and the caller must flush them.
+auto create_buffer_helper(
+    daxa_Device self,
+    daxa_BufferInfo const * info,
+    daxa_BufferId * out_id,
+    daxa_MemoryBlock opt_memory_block,
+    usize opt_offset,
+    GPUResourceId const * opt_reserved_id = nullptr,
+    DescriptorWriteBatch * opt_descriptor_writes = nullptr,
+    bool sparse = false,
+    daxa_u32 const * opt_peer_device_index = nullptr) -> daxa_Result
 {
+    DAXA_PROFILE_ZONE("daxa_dvc_create_buffer");
     daxa_Result result = DAXA_RESULT_SUCCESS;
     // --- Begin Parameter Validation ---
 
@@ -140,10 +525,30 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
         result = DAXA_RESULT_INVALID_BUFFER_INFO;
     }
     _DAXA_RETURN_IF_ERROR(result, result)
+    if (sparse && (self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING) == 0)
+    {
+        result = DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED;
+    }
+    _DAXA_RETURN_IF_ERROR(result, result)
+    if (info->video_bitstream && (self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0)
+    {
+        result = DAXA_RESULT_INVALID_BUFFER_INFO;
+    }
+    _DAXA_RETURN_IF_ERROR(result, result)
+    bool const external = info->external_memory.handle_type != DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_NONE;
+    if (external && (sparse || opt_memory_block != nullptr))
+    {
+        result = DAXA_RESULT_INVALID_BUFFER_INFO;
+    }
+    _DAXA_RETURN_IF_ERROR(result, result)
+    result = validate_external_memory_info(self, info->external_memory);
+    _DAXA_RETURN_IF_ERROR(result, result)
 
     // --- End Parameter Validation ---
 
-    auto slot_opt = self->gpu_sro_table.buffer_slots.try_create_slot();
+    auto slot_opt = opt_reserved_id != nullptr
+                        ? std::optional{std::pair<GPUResourceId, ImplBufferSlot &>(*opt_reserved_id, self->gpu_sro_table.buffer_slots.unsafe_get_reserved_slot(*opt_reserved_id))}
+                        : self->gpu_sro_table.buffer_slots.try_create_slot();
     if (!slot_opt.has_value())
     {
         result = DAXA_RESULT_EXCEEDED_MAX_BUFFERS;
@@ -156,22 +561,34 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
     {
         if (result != DAXA_RESULT_SUCCESS)
         {
-            self->gpu_sro_table.buffer_slots.unsafe_destroy_zombie_slot(id);
+            if (opt_reserved_id == nullptr)
+            {
+                self->gpu_sro_table.buffer_slots.unsafe_destroy_zombie_slot(id);
+            }
             if (ret.vk_buffer)
             {
                 vkDestroyBuffer(self->vk_device, ret.vk_buffer, nullptr);
             }
+            if (ret.vk_external_memory)
+            {
+                vkFreeMemory(self->vk_device, ret.vk_external_memory, nullptr);
+                ret.vk_external_memory = {};
+            }
         }
     };
 
+    result = self->gpu_sro_table.ensure_capacity(self->vk_device, DAXA_STORAGE_BUFFER_BINDING, id.index + 1);
+    _DAXA_RETURN_IF_ERROR(result, result)
+
     ret.info = *info;
 
+    VkBufferUsageFlags2CreateInfoKHR vk_usage_flags2 = {};
     VkBufferCreateInfo const vk_buffer_create_info{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = {},
+        .pNext = buffer_create_info_pnext(self, *info, vk_usage_flags2),
+        .flags = create_buffer_create_flags(*info) | (sparse ? VkBufferCreateFlags{VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT} : VkBufferCreateFlags{}),
         .size = static_cast<VkDeviceSize>(ret.info.size),
-        .usage = create_buffer_use_flags(self),
+        .usage = create_buffer_use_flags(self, *info),
         .sharingMode = VK_SHARING_MODE_CONCURRENT,                  // Buffers are always shared.
         .queueFamilyIndexCount = self->valid_vk_queue_family_count, // Buffers are always shared across all queues.
         .pQueueFamilyIndices = self->valid_vk_queue_families.data(),
@@ -179,9 +596,36 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
 
     bool host_accessible = false;
     VmaAllocationInfo vma_allocation_info = {};
-    if (opt_memory_block == nullptr)
+    if (sparse)
+    {
+        // Memory is bound later with daxa_dvc_bind_sparse.
+        ret.info.allocate_info = DAXA_MEMORY_FLAG_NONE;
+        result = static_cast<daxa_Result>(vkCreateBuffer(self->vk_device, &vk_buffer_create_info, nullptr, &ret.vk_buffer));
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+    else if (external)
+    {
+        ret.info.allocate_info = DAXA_MEMORY_FLAG_NONE;
+        VkExternalMemoryBufferCreateInfo const vk_external_memory_buffer_create_info{
+            .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+            .pNext = vk_buffer_create_info.pNext,
+            .handleTypes = static_cast<VkExternalMemoryHandleTypeFlags>(info->external_memory.handle_type),
+        };
+        VkBufferCreateInfo vk_external_buffer_create_info = vk_buffer_create_info;
+        vk_external_buffer_create_info.pNext = &vk_external_memory_buffer_create_info;
+        result = static_cast<daxa_Result>(vkCreateBuffer(self->vk_device, &vk_external_buffer_create_info, nullptr, &ret.vk_buffer));
+        _DAXA_RETURN_IF_ERROR(result, result)
+
+        VkMemoryRequirements vk_memory_requirements = {};
+        vkGetBufferMemoryRequirements(self->vk_device, ret.vk_buffer, &vk_memory_requirements);
+        result = allocate_external_memory(self, info->external_memory, vk_memory_requirements, ret.vk_buffer, VK_NULL_HANDLE, &ret.vk_external_memory);
+        _DAXA_RETURN_IF_ERROR(result, result)
+        result = static_cast<daxa_Result>(vkBindBufferMemory(self->vk_device, ret.vk_buffer, ret.vk_external_memory, 0));
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+    else if (opt_memory_block == nullptr)
     {
-        auto vma_allocation_flags = static_cast<VmaAllocationCreateFlags>(info->allocate_info);
+        auto vma_allocation_flags = vma_allocation_flags_from_memory_flags(info->allocate_info);
         if (((vma_allocation_flags & VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT) != 0u) ||
             ((vma_allocation_flags & VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT) != 0u) ||
             ((vma_allocation_flags & VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT) != 0u))
@@ -194,10 +638,10 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
             .flags = vma_allocation_flags,
             .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
             .requiredFlags = {},
-            .preferredFlags = {},
+            .preferredFlags = vma_preferred_memory_flags(info->allocate_info),
             .memoryTypeBits = std::numeric_limits<u32>::max(),
             .pool = nullptr,
-            .pUserData = nullptr,
+            .pUserData = movable_allocation_user_data(info->allocate_info, id.index, false),
             .priority = 0.5f,
         };
 
@@ -219,12 +663,24 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
         result = static_cast<daxa_Result>(vkCreateBuffer(self->vk_device, &vk_buffer_create_info, nullptr, &ret.vk_buffer));
         _DAXA_RETURN_IF_ERROR(result, result)
 
+        // Every physical device of the group binds the memory instance of the peer device.
+        std::array<u32, VK_MAX_DEVICE_GROUP_SIZE> peer_device_indices = {};
+        if (opt_peer_device_index != nullptr)
+        {
+            peer_device_indices.fill(*opt_peer_device_index);
+        }
+        VkBindBufferMemoryDeviceGroupInfo const vk_bind_device_group_info = {
+            .sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_DEVICE_GROUP_INFO,
+            .pNext = nullptr,
+            .deviceIndexCount = self->device_group_size,
+            .pDeviceIndices = peer_device_indices.data(),
+        };
         result = static_cast<daxa_Result>(vmaBindBufferMemory2(
             self->vma_allocator,
             mem_block.allocation,
             opt_offset,
             ret.vk_buffer,
-            {}));
+            opt_peer_device_index != nullptr ? &vk_bind_device_group_info : nullptr));
         _DAXA_RETURN_IF_ERROR(result, result)
     }
 
@@ -239,6 +695,10 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
     ret.host_address = host_accessible ? vma_allocation_info.pMappedData : nullptr;
 
     self->buffer_device_address_buffer_host_ptr[id.index] = ret.device_address;
+    self->gpu_sro_table.buffer_slots.unsafe_get_hot_mut(id) = ImplBufferHotSlot{
+        .device_address = ret.device_address,
+        .host_address = ret.host_address,
+    };
 
     if ((self->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE &&
         info->name.size != 0)
@@ -259,18 +719,32 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
         write_descriptor_set_buffer(
             self->vk_device,
-            self->gpu_sro_table.vk_descriptor_set, ret.vk_buffer,
+            self->gpu_sro_table, ret.vk_buffer,
             0,
             static_cast<VkDeviceSize>(ret.info.size),
-            id.index);
+            id.index,
+            opt_descriptor_writes);
     }
 
     *out_id = std::bit_cast<daxa_BufferId>(id);
+    if (self->capture.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_buffer_created(self, *out_id);
+    }
     return result;
 }
 
-auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_ImageId * out_id, daxa_MemoryBlock opt_memory_block, usize opt_offset) -> daxa_Result
+// Reserved slots and descriptor writes are handled like in create_buffer_helper.
+auto create_image_helper(
+    daxa_Device self,
+    daxa_ImageInfo const * info,
+    daxa_ImageId * out_id,
+    daxa_MemoryBlock opt_memory_block,
+    usize opt_offset,
+    GPUResourceId const * opt_reserved_id = nullptr,
+    DescriptorWriteBatch * opt_descriptor_writes = nullptr) -> daxa_Result
 {
+    DAXA_PROFILE_ZONE("daxa_dvc_create_image");
     daxa_Result result = DAXA_RESULT_SUCCESS;
     /// --- Begin Validation ---
 
@@ -278,10 +752,24 @@ auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_Ima
     {
         return DAXA_RESULT_INVALID_IMAGE_INFO;
     }
+    bool const sparse = (info->flags & DAXA_IMAGE_FLAG_SPARSE_BINDING) != 0;
+    if (sparse && (self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING) == 0)
+    {
+        return DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED;
+    }
+    bool const external = info->external_memory.handle_type != DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_NONE;
+    if (external && (sparse || opt_memory_block != nullptr))
+    {
+        return DAXA_RESULT_INVALID_IMAGE_INFO;
+    }
+    result = validate_external_memory_info(self, info->external_memory);
+    _DAXA_RETURN_IF_ERROR(result, result)
 
     /// --- End Validation ---
 
-    auto slot_opt = self->gpu_sro_table.image_slots.try_create_slot();
+    auto slot_opt = opt_reserved_id != nullptr
+                        ? std::optional{std::pair<GPUResourceId, ImplImageSlot &>(*opt_reserved_id, self->gpu_sro_table.image_slots.unsafe_get_reserved_slot(*opt_reserved_id))}
+                        : self->gpu_sro_table.image_slots.try_create_slot();
     if (!slot_opt.has_value())
     {
         result = DAXA_RESULT_EXCEEDED_MAX_IMAGES;
@@ -293,6 +781,10 @@ auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_Ima
     {
         if (result != DAXA_RESULT_SUCCESS)
         {
+            if (opt_reserved_id == nullptr)
+            {
+                self->gpu_sro_table.image_slots.unsafe_destroy_zombie_slot(id);
+            }
             if (ret.vk_image)
             {
                 vmaDestroyImage(self->vma_allocator, ret.vk_image, ret.vma_allocation);
@@ -301,9 +793,17 @@ auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_Ima
             {
                 vkDestroyImageView(self->vk_device, ret.view_slot.vk_image_view, nullptr);
             }
+            if (ret.vk_external_memory)
+            {
+                vkFreeMemory(self->vk_device, ret.vk_external_memory, nullptr);
+                ret.vk_external_memory = {};
+            }
         }
     };
 
+    result = ensure_image_descriptor_capacity(self, id);
+    _DAXA_RETURN_IF_ERROR(result, result)
+
     ret.info = *info;
     ret.view_slot.info = std::bit_cast<daxa_ImageViewInfo>(ImageViewInfo{
         .type = static_cast<ImageViewType>(info->dimensions - 1),
@@ -350,17 +850,52 @@ auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_Ima
             .layerCount = info->array_layer_count,
         },
     };
-    VkImageCreateInfo const vk_image_create_info = initialize_image_create_info_from_image_info(self, *info);
-    if (opt_memory_block == nullptr)
+    ImplVideoProfile video_profile = {};
+    VkImageCreateInfo const vk_image_create_info = initialize_image_create_info_from_image_info(self, *info, video_profile);
+    if (sparse)
+    {
+        // Memory is bound later with daxa_dvc_bind_sparse.
+        result = static_cast<daxa_Result>(vkCreateImage(self->vk_device, &vk_image_create_info, nullptr, &ret.vk_image));
+        _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_CREATE_IMAGE);
+
+        vk_image_view_create_info.image = ret.vk_image;
+        result = static_cast<daxa_Result>(vkCreateImageView(self->vk_device, &vk_image_view_create_info, nullptr, &ret.view_slot.vk_image_view));
+        _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_CREATE_DEFAULT_IMAGE_VIEW);
+    }
+    else if (external)
+    {
+        ret.info.allocate_info = DAXA_MEMORY_FLAG_NONE;
+        VkExternalMemoryImageCreateInfo const vk_external_memory_image_create_info{
+            .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO,
+            .pNext = vk_image_create_info.pNext,
+            .handleTypes = static_cast<VkExternalMemoryHandleTypeFlags>(info->external_memory.handle_type),
+        };
+        VkImageCreateInfo vk_external_image_create_info = vk_image_create_info;
+        vk_external_image_create_info.pNext = &vk_external_memory_image_create_info;
+        result = static_cast<daxa_Result>(vkCreateImage(self->vk_device, &vk_external_image_create_info, nullptr, &ret.vk_image));
+        _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_CREATE_IMAGE);
+
+        VkMemoryRequirements vk_memory_requirements = {};
+        vkGetImageMemoryRequirements(self->vk_device, ret.vk_image, &vk_memory_requirements);
+        result = allocate_external_memory(self, info->external_memory, vk_memory_requirements, VK_NULL_HANDLE, ret.vk_image, &ret.vk_external_memory);
+        _DAXA_RETURN_IF_ERROR(result, result);
+        result = static_cast<daxa_Result>(vkBindImageMemory(self->vk_device, ret.vk_image, ret.vk_external_memory, 0));
+        _DAXA_RETURN_IF_ERROR(result, result);
+
+        vk_image_view_create_info.image = ret.vk_image;
+        result = static_cast<daxa_Result>(vkCreateImageView(self->vk_device, &vk_image_view_create_info, nullptr, &ret.view_slot.vk_image_view));
+        _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_CREATE_DEFAULT_IMAGE_VIEW);
+    }
+    else if (opt_memory_block == nullptr)
     {
         VmaAllocationCreateInfo const vma_allocation_create_info{
-            .flags = static_cast<VmaAllocationCreateFlags>(info->allocate_info),
+            .flags = vma_allocation_flags_from_memory_flags(info->allocate_info),
             .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
             .requiredFlags = {},
             .preferredFlags = {},
             .memoryTypeBits = std::numeric_limits<u32>::max(),
             .pool = nullptr,
-            .pUserData = nullptr,
+            .pUserData = movable_allocation_user_data(info->allocate_info, id.index, true),
             .priority = 0.5f,
         };
 
@@ -420,12 +955,17 @@ auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_Ima
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
         write_descriptor_set_image(
             self->vk_device,
-            self->gpu_sro_table.vk_descriptor_set,
+            self->gpu_sro_table,
             ret.view_slot.vk_image_view,
             std::bit_cast<ImageUsageFlags>(ret.info.usage),
-            id.index);
+            id.index,
+            opt_descriptor_writes);
     }
     *out_id = std::bit_cast<daxa_ImageId>(id);
+    if (self->capture.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_image_created(self, *out_id);
+    }
     return result;
 }
 
@@ -438,6 +978,7 @@ auto create_acceleration_structure_helper(
     u64 const * offset,
     auto * out_id) -> daxa_Result
 {
+    DAXA_PROFILE_ZONE("daxa_dvc_create_acceleration_structure");
     daxa_Result result = DAXA_RESULT_SUCCESS;
     // --- Begin Parameter Validation ---
 
@@ -520,6 +1061,7 @@ auto create_acceleration_structure_helper(
     ret.device_address = self->vkGetAccelerationStructureDeviceAddressKHR(
         self->vk_device,
         &vk_acceleration_structure_device_address_info_khr);
+    table.unsafe_get_hot_mut(id).device_address = ret.device_address;
 
     if ((self->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && ret.info.name.size != 0)
     {
@@ -540,8 +1082,9 @@ auto create_acceleration_structure_helper(
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
         write_descriptor_set_acceleration_structure(
             self->vk_device,
-            self->gpu_sro_table.vk_descriptor_set,
+            self->gpu_sro_table,
             ret.vk_acceleration_structure,
+            ret.device_address,
             id.index);
     }
 
@@ -572,12 +1115,13 @@ auto daxa_default_device_score(daxa_DeviceProperties const * c_properties) -> i3
 
 auto daxa_dvc_buffer_memory_requirements(daxa_Device self, daxa_BufferInfo const * info) -> VkMemoryRequirements
 {
+    VkBufferUsageFlags2CreateInfoKHR vk_usage_flags2 = {};
     VkBufferCreateInfo const vk_buffer_create_info{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = {},
+        .pNext = buffer_create_info_pnext(self, *info, vk_usage_flags2),
+        .flags = create_buffer_create_flags(*info),
         .size = static_cast<VkDeviceSize>(info->size),
-        .usage = create_buffer_use_flags(self),
+        .usage = create_buffer_use_flags(self, *info),
         .sharingMode = VK_SHARING_MODE_CONCURRENT,                  // Buffers are always shared.
         .queueFamilyIndexCount = self->valid_vk_queue_family_count, // Buffers are always shared across all queues.
         .pQueueFamilyIndices = self->valid_vk_queue_families.data(),
@@ -599,7 +1143,18 @@ auto daxa_dvc_buffer_memory_requirements(daxa_Device self, daxa_BufferInfo const
 
 auto daxa_dvc_image_memory_requirements(daxa_Device self, daxa_ImageInfo const * info) -> VkMemoryRequirements
 {
-    VkImageCreateInfo vk_image_create_info = initialize_image_create_info_from_image_info(self, *info);
+    ImplVideoProfile video_profile = {};
+    VkImageCreateInfo vk_image_create_info = initialize_image_create_info_from_image_info(self, *info, video_profile);
+    // External memory can change the requirements, it is exported and imported with the size reported here.
+    VkExternalMemoryImageCreateInfo const vk_external_memory_image_create_info{
+        .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO,
+        .pNext = vk_image_create_info.pNext,
+        .handleTypes = static_cast<VkExternalMemoryHandleTypeFlags>(info->external_memory.handle_type),
+    };
+    if (info->external_memory.handle_type != DAXA_EXTERNAL_MEMORY_HANDLE_TYPE_NONE)
+    {
+        vk_image_create_info.pNext = &vk_external_memory_image_create_info;
+    }
     VkDeviceImageMemoryRequirements image_requirement_info{
         .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
         .pNext = {},
@@ -615,19 +1170,89 @@ auto daxa_dvc_image_memory_requirements(daxa_Device self, daxa_ImageInfo const *
     return mem_requirements.memoryRequirements;
 }
 
-auto daxa_dvc_get_tlas_build_sizes(
-    daxa_Device self,
-    daxa_TlasBuildInfo const * build_info,
-    daxa_AccelerationStructureBuildSizesInfo * out)
-    -> daxa_Result
+auto daxa_dvc_sparse_buffer_memory_requirements(daxa_Device self, daxa_BufferInfo const * info) -> VkMemoryRequirements
 {
-    if ((self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING) == 0)
-    {
-        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING, DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING);
-    }
-    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> vk_build_geometry_infos = {};
-    std::vector<VkAccelerationStructureGeometryKHR> vk_geometry_infos = {};
-    std::vector<u32> primitive_counts = {};
+    VkBufferUsageFlags2CreateInfoKHR vk_usage_flags2 = {};
+    VkBufferCreateInfo const vk_buffer_create_info{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = buffer_create_info_pnext(self, *info, vk_usage_flags2),
+        .flags = create_buffer_create_flags(*info) | VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT,
+        .size = static_cast<VkDeviceSize>(info->size),
+        .usage = create_buffer_use_flags(self, *info),
+        .sharingMode = VK_SHARING_MODE_CONCURRENT,
+        .queueFamilyIndexCount = self->valid_vk_queue_family_count,
+        .pQueueFamilyIndices = self->valid_vk_queue_families.data(),
+    };
+    VkDeviceBufferMemoryRequirements buffer_requirement_info{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS,
+        .pNext = {},
+        .pCreateInfo = &vk_buffer_create_info,
+    };
+    VkMemoryRequirements2 mem_requirements = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = {},
+        .memoryRequirements = {},
+    };
+    vkGetDeviceBufferMemoryRequirements(self->vk_device, &buffer_requirement_info, &mem_requirements);
+    return mem_requirements.memoryRequirements;
+}
+
+auto daxa_dvc_sparse_image_memory_requirements(daxa_Device self, daxa_ImageInfo const * info, daxa_SparseImageMemoryRequirements * out_requirements) -> daxa_Result
+{
+    *out_requirements = {};
+    if ((info->flags & DAXA_IMAGE_FLAG_SPARSE_RESIDENCY) == 0)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_IMAGE_INFO, DAXA_RESULT_INVALID_IMAGE_INFO);
+    }
+    if ((self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING) == 0)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED, DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED);
+    }
+    ImplVideoProfile video_profile = {};
+    VkImageCreateInfo const vk_image_create_info = initialize_image_create_info_from_image_info(self, *info, video_profile);
+    VkDeviceImageMemoryRequirements const image_requirement_info{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+        .pNext = {},
+        .pCreateInfo = &vk_image_create_info,
+        .planeAspect = static_cast<VkImageAspectFlagBits>(infer_aspect_from_format(info->format)),
+    };
+    u32 requirement_count = 0;
+    vkGetDeviceImageSparseMemoryRequirements(self->vk_device, &image_requirement_info, &requirement_count, nullptr);
+    // Zero requirements means the format does not support sparse residency with these parameters.
+    if (requirement_count == 0)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED, DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED);
+    }
+    std::vector<VkSparseImageMemoryRequirements2> requirements(
+        requirement_count,
+        VkSparseImageMemoryRequirements2{.sType = VK_STRUCTURE_TYPE_SPARSE_IMAGE_MEMORY_REQUIREMENTS_2, .pNext = {}, .memoryRequirements = {}});
+    vkGetDeviceImageSparseMemoryRequirements(self->vk_device, &image_requirement_info, &requirement_count, requirements.data());
+    VkSparseImageMemoryRequirements const & first = requirements[0].memoryRequirements;
+    *out_requirements = daxa_SparseImageMemoryRequirements{
+        .image_granularity = first.formatProperties.imageGranularity,
+        .single_mip_tail = (first.formatProperties.flags & VK_SPARSE_IMAGE_FORMAT_SINGLE_MIPTAIL_BIT) != 0,
+        .mip_tail_first_lod = first.imageMipTailFirstLod,
+        .mip_tail_size = first.imageMipTailSize,
+        .mip_tail_offset = first.imageMipTailOffset,
+        .mip_tail_stride = first.imageMipTailStride,
+    };
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_get_tlas_build_sizes(
+    daxa_Device self,
+    daxa_TlasBuildInfo const * build_info,
+    daxa_AccelerationStructureBuildSizesInfo * out)
+    -> daxa_Result
+{
+    if ((self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING) == 0)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING, DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING);
+    }
+    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> vk_build_geometry_infos = {};
+    std::vector<VkAccelerationStructureGeometryKHR> vk_geometry_infos = {};
+    std::vector<VkAccelerationStructureTrianglesOpacityMicromapEXT> vk_opacity_micromaps = {};
+    std::vector<u32> primitive_counts = {};
     std::vector<u32 const *> primitive_counts_ptrs = {};
     daxa_as_build_info_to_vk(
         self,
@@ -637,6 +1262,7 @@ auto daxa_dvc_get_tlas_build_sizes(
         0,          // blas array size
         vk_build_geometry_infos,
         vk_geometry_infos,
+        vk_opacity_micromaps,
         primitive_counts,
         primitive_counts_ptrs);
     VkAccelerationStructureBuildSizesInfoKHR vk_acceleration_structure_build_sizes_info_khr = {
@@ -667,6 +1293,7 @@ auto daxa_dvc_get_blas_build_sizes(
     }
     std::vector<VkAccelerationStructureBuildGeometryInfoKHR> vk_build_geometry_infos = {};
     std::vector<VkAccelerationStructureGeometryKHR> vk_geometry_infos = {};
+    std::vector<VkAccelerationStructureTrianglesOpacityMicromapEXT> vk_opacity_micromaps = {};
     std::vector<u32> primitive_counts = {};
     std::vector<u32 const *> primitive_counts_ptrs = {};
     daxa_as_build_info_to_vk(
@@ -677,6 +1304,7 @@ auto daxa_dvc_get_blas_build_sizes(
         1,          // blas array size
         vk_build_geometry_infos,
         vk_geometry_infos,
+        vk_opacity_micromaps,
         primitive_counts,
         primitive_counts_ptrs);
     VkAccelerationStructureBuildSizesInfoKHR vk_acceleration_structure_build_sizes_info_khr = {
@@ -705,9 +1333,19 @@ auto daxa_dvc_create_image(daxa_Device self, daxa_ImageInfo const * info, daxa_I
     return create_image_helper(self, info, out_id, nullptr, 0);
 }
 
+auto daxa_dvc_create_sparse_buffer(daxa_Device self, daxa_BufferInfo const * info, daxa_BufferId * out_id) -> daxa_Result
+{
+    return create_buffer_helper(self, info, out_id, nullptr, 0, nullptr, nullptr, true);
+}
+
 auto daxa_dvc_create_buffer_from_memory_block(daxa_Device self, daxa_MemoryBlockBufferInfo const * info, daxa_BufferId * out_id) -> daxa_Result
 {
-    return create_buffer_helper(self, &info->buffer_info, out_id, *info->memory_block, info->offset);
+    if (info->peer_device_index.has_value && info->peer_device_index.value >= self->device_group_size)
+    {
+        return DAXA_RESULT_ERROR_INVALID_DEVICE_INDEX;
+    }
+    daxa_u32 const * opt_peer_device_index = info->peer_device_index.has_value ? &info->peer_device_index.value : nullptr;
+    return create_buffer_helper(self, &info->buffer_info, out_id, *info->memory_block, info->offset, nullptr, nullptr, false, opt_peer_device_index);
 }
 
 auto daxa_dvc_create_image_from_block(daxa_Device self, daxa_MemoryBlockImageInfo const * info, daxa_ImageId * out_id) -> daxa_Result
@@ -763,14 +1401,23 @@ auto daxa_dvc_create_blas_from_buffer(daxa_Device self, daxa_BufferBlasInfo cons
         out_id);
 }
 
-auto daxa_dvc_create_image_view(daxa_Device self, daxa_ImageViewInfo const * info, daxa_ImageViewId * out_id) -> daxa_Result
+// Reserved slots and descriptor writes are handled like in create_buffer_helper.
+auto create_image_view_helper(
+    daxa_Device self,
+    daxa_ImageViewInfo const * info,
+    daxa_ImageViewId * out_id,
+    GPUResourceId const * opt_reserved_id = nullptr,
+    DescriptorWriteBatch * opt_descriptor_writes = nullptr) -> daxa_Result
 {
+    DAXA_PROFILE_ZONE("daxa_dvc_create_image_view");
     daxa_Result result = DAXA_RESULT_SUCCESS;
     /// --- Begin Validation ---
 
     /// --- End Validation ---
 
-    auto slot_opt = self->gpu_sro_table.image_slots.try_create_slot();
+    auto slot_opt = opt_reserved_id != nullptr
+                        ? std::optional{std::pair<GPUResourceId, ImplImageSlot &>(*opt_reserved_id, self->gpu_sro_table.image_slots.unsafe_get_reserved_slot(*opt_reserved_id))}
+                        : self->gpu_sro_table.image_slots.try_create_slot();
     if (!slot_opt.has_value())
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_EXCEEDED_MAX_IMAGE_VIEWS, DAXA_RESULT_EXCEEDED_MAX_IMAGE_VIEWS);
@@ -780,7 +1427,10 @@ auto daxa_dvc_create_image_view(daxa_Device self, daxa_ImageViewInfo const * inf
     {
         if (result != DAXA_RESULT_SUCCESS)
         {
-            self->gpu_sro_table.image_slots.unsafe_destroy_zombie_slot(id);
+            if (opt_reserved_id == nullptr)
+            {
+                self->gpu_sro_table.image_slots.unsafe_destroy_zombie_slot(id);
+            }
             if (image_slot.view_slot.vk_image_view)
             {
                 vkDestroyImageView(self->vk_device, image_slot.view_slot.vk_image_view, nullptr);
@@ -788,6 +1438,9 @@ auto daxa_dvc_create_image_view(daxa_Device self, daxa_ImageViewInfo const * inf
         }
     };
 
+    result = ensure_image_descriptor_capacity(self, id);
+    _DAXA_RETURN_IF_ERROR(result, result)
+
     ImplImageSlot const & parent_image_slot = self->slot(info->image);
     image_slot = {};
     auto & ret = image_slot.view_slot;
@@ -829,17 +1482,133 @@ auto daxa_dvc_create_image_view(daxa_Device self, daxa_ImageViewInfo const * inf
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
         write_descriptor_set_image(
             self->vk_device,
-            self->gpu_sro_table.vk_descriptor_set,
+            self->gpu_sro_table,
             ret.vk_image_view,
             std::bit_cast<ImageUsageFlags>(parent_image_slot.info.usage),
-            id.index);
+            id.index,
+            opt_descriptor_writes);
         *out_id = std::bit_cast<daxa_ImageViewId>(id);
+        if (self->capture.active_generation.load(std::memory_order_relaxed) != 0)
+        {
+            capture_image_view_created(self, *out_id);
+        }
     }
     return result;
 }
 
+auto daxa_dvc_create_image_view(daxa_Device self, daxa_ImageViewInfo const * info, daxa_ImageViewId * out_id) -> daxa_Result
+{
+    return create_image_view_helper(self, info, out_id);
+}
+
+struct BulkCreateScratchBuffers
+{
+    std::vector<GPUResourceId> reserved_ids = {};
+    DescriptorWriteBatch descriptor_writes = {};
+};
+
+inline static thread_local BulkCreateScratchBuffers tl_bulk_create_scratch_buffers = {}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Creates all resources or none.
+// Slots are reserved with a single pool operation and all descriptors are written with a single vkUpdateDescriptorSets.
+template <typename InfoT, typename IdT>
+auto create_resources_bulk(
+    daxa_Device self,
+    auto & pool,
+    daxa_Result exceeded_result,
+    InfoT const * infos,
+    usize count,
+    IdT * out_ids,
+    auto && create_one,
+    auto && destroy_one) -> daxa_Result
+{
+    DAXA_PROFILE_ZONE("daxa_dvc_create_resources");
+    if (count == 0)
+    {
+        return DAXA_RESULT_SUCCESS;
+    }
+    BulkCreateScratchBuffers & scratch = tl_bulk_create_scratch_buffers;
+    scratch.reserved_ids.resize(count);
+    scratch.descriptor_writes.clear();
+    if (!pool.try_create_slots(std::span{scratch.reserved_ids}))
+    {
+        _DAXA_RETURN_IF_ERROR(exceeded_result, exceeded_result);
+    }
+
+    daxa_Result result = DAXA_RESULT_SUCCESS;
+    usize created_count = 0;
+    for (; created_count < count; ++created_count)
+    {
+        result = create_one(&infos[created_count], &out_ids[created_count], &scratch.reserved_ids[created_count], &scratch.descriptor_writes);
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    if (result != DAXA_RESULT_SUCCESS)
+    {
+        // The created resources are destroyed like any other, the remaining reserved slots never became visible.
+        for (usize i = 0; i < created_count; ++i)
+        {
+            [[maybe_unused]] auto const destroy_result = destroy_one(out_ids[i]);
+        }
+        for (usize i = created_count; i < count; ++i)
+        {
+            pool.unsafe_destroy_zombie_slot(scratch.reserved_ids[i]);
+        }
+        scratch.descriptor_writes.clear();
+        return result;
+    }
+
+    // Does not need external sync given we use update after bind.
+    scratch.descriptor_writes.flush(self->vk_device, self->gpu_sro_table);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_create_buffers(daxa_Device self, daxa_BufferInfo const * infos, usize count, daxa_BufferId * out_ids) -> daxa_Result
+{
+    return create_resources_bulk(
+        self, self->gpu_sro_table.buffer_slots, DAXA_RESULT_EXCEEDED_MAX_BUFFERS, infos, count, out_ids,
+        [&](daxa_BufferInfo const * info, daxa_BufferId * out_id, GPUResourceId const * reserved_id, DescriptorWriteBatch * descriptor_writes)
+        { return create_buffer_helper(self, info, out_id, nullptr, 0, reserved_id, descriptor_writes); },
+        [&](daxa_BufferId id)
+        { return daxa_dvc_destroy_buffer(self, id); });
+}
+
+auto daxa_dvc_create_images(daxa_Device self, daxa_ImageInfo const * infos, usize count, daxa_ImageId * out_ids) -> daxa_Result
+{
+    return create_resources_bulk(
+        self, self->gpu_sro_table.image_slots, DAXA_RESULT_EXCEEDED_MAX_IMAGES, infos, count, out_ids,
+        [&](daxa_ImageInfo const * info, daxa_ImageId * out_id, GPUResourceId const * reserved_id, DescriptorWriteBatch * descriptor_writes)
+        { return create_image_helper(self, info, out_id, nullptr, 0, reserved_id, descriptor_writes); },
+        [&](daxa_ImageId id)
+        { return daxa_dvc_destroy_image(self, id); });
+}
+
+auto daxa_dvc_create_image_views(daxa_Device self, daxa_ImageViewInfo const * infos, usize count, daxa_ImageViewId * out_ids) -> daxa_Result
+{
+    return create_resources_bulk(
+        self, self->gpu_sro_table.image_slots, DAXA_RESULT_EXCEEDED_MAX_IMAGE_VIEWS, infos, count, out_ids,
+        [&](daxa_ImageViewInfo const * info, daxa_ImageViewId * out_id, GPUResourceId const * reserved_id, DescriptorWriteBatch * descriptor_writes)
+        { return create_image_view_helper(self, info, out_id, reserved_id, descriptor_writes); },
+        [&](daxa_ImageViewId id)
+        { return daxa_dvc_destroy_image_view(self, id); });
+}
+
+auto daxa_dvc_create_images_from_block(daxa_Device self, daxa_MemoryBlockImageInfo const * infos, usize count, daxa_ImageId * out_ids) -> daxa_Result
+{
+    return create_resources_bulk(
+        self, self->gpu_sro_table.image_slots, DAXA_RESULT_EXCEEDED_MAX_IMAGES, infos, count, out_ids,
+        [&](daxa_MemoryBlockImageInfo const * info, daxa_ImageId * out_id, GPUResourceId const * reserved_id, DescriptorWriteBatch * descriptor_writes)
+        { return create_image_helper(self, &info->image_info, out_id, *info->memory_block, info->offset, reserved_id, descriptor_writes); },
+        [&](daxa_ImageId id)
+        { return daxa_dvc_destroy_image(self, id); });
+}
+
 auto daxa_dvc_create_sampler(daxa_Device self, daxa_SamplerInfo const * info, daxa_SamplerId * out_id) -> daxa_Result
 {
+    DAXA_PROFILE_ZONE("daxa_dvc_create_sampler");
     daxa_Result result = DAXA_RESULT_SUCCESS;
     /// --- Begin Validation ---
 
@@ -915,9 +1684,13 @@ auto daxa_dvc_create_sampler(daxa_Device self, daxa_SamplerInfo const * info, da
     {
         // Does not need external sync given we use update after bind.
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
-        write_descriptor_set_sampler(self->vk_device, self->gpu_sro_table.vk_descriptor_set, ret.vk_sampler, id.index);
+        write_descriptor_set_sampler(self->vk_device, self->gpu_sro_table, ret.vk_sampler, id.index);
     }
     *out_id = std::bit_cast<daxa_SamplerId>(id);
+    if (self->capture.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_sampler_created(self, *out_id);
+    }
     return result;
 }
 
@@ -966,13 +1739,60 @@ _DAXA_DECL_COMMON_GP_RES_FUNCTIONS(sampler, Sampler, SAMPLER, sampler_slots, sam
 _DAXA_DECL_COMMON_GP_RES_FUNCTIONS(tlas, Tlas, TLAS, tlas_slots, acceleration_structure, VkAccelerationStructureKHR)
 _DAXA_DECL_COMMON_GP_RES_FUNCTIONS(blas, Blas, BLAS, blas_slots, acceleration_structure, VkAccelerationStructureKHR)
 
+#define _DAXA_DECL_BULK_DESTROY_FUNCTION(name, Name, NAME, SLOT_NAME)                                                           \
+    auto daxa_dvc_destroy_##name##s(daxa_Device self, daxa_##Name##Id const * ids, usize id_count) -> daxa_Result               \
+    {                                                                                                                           \
+        _DAXA_TEST_PRINT("STRONG daxa_dvc_destroy_%ss\n", #name);                                                               \
+        thread_local std::vector<Name##Id> zombified_ids = {}; /* NOLINT(cppcoreguidelines-avoid-non-const-global-variables) */ \
+        zombified_ids.clear();                                                                                                  \
+        daxa_Result result = DAXA_RESULT_SUCCESS;                                                                               \
+        for (usize i = 0; i < id_count; ++i)                                                                                    \
+        {                                                                                                                       \
+            if (self->gpu_sro_table.SLOT_NAME.try_zombify(std::bit_cast<GPUResourceId>(ids[i])))                                \
+            {                                                                                                                   \
+                zombified_ids.push_back(std::bit_cast<Name##Id>(ids[i]));                                                       \
+            }                                                                                                                   \
+            else                                                                                                                \
+            {                                                                                                                   \
+                result = DAXA_RESULT_INVALID_##NAME##_ID;                                                                       \
+            }                                                                                                                   \
+        }                                                                                                                       \
+        self->zombify_##name##s(zombified_ids);                                                                                 \
+        return result;                                                                                                          \
+    }
+
+_DAXA_DECL_BULK_DESTROY_FUNCTION(buffer, Buffer, BUFFER, buffer_slots)
+_DAXA_DECL_BULK_DESTROY_FUNCTION(image, Image, IMAGE, image_slots)
+_DAXA_DECL_BULK_DESTROY_FUNCTION(image_view, ImageView, IMAGE_VIEW, image_slots)
+_DAXA_DECL_BULK_DESTROY_FUNCTION(sampler, Sampler, SAMPLER, sampler_slots)
+
+static_assert(sizeof(ImplBufferHotSlot) == sizeof(daxa_BufferHotSlot));
+static_assert(offsetof(ImplBufferHotSlot, host_address) == offsetof(daxa_BufferHotSlot, host_address));
+static_assert(offsetof(ImplBufferSlot, info) == 0);
+
+auto daxa_dvc_buffer_pool_view(daxa_Device self) -> daxa_BufferPoolView
+{
+    auto const & pool = self->gpu_sro_table.buffer_slots;
+    using PoolT = std::remove_cvref_t<decltype(pool)>;
+    using PageT = PoolT::PageT;
+    return daxa_BufferPoolView{
+        .pages = r_cast<void const * const *>(pool.page_pointers.data()),
+        .valid_page_count = &pool.valid_page_count,
+        .page_bits = static_cast<u32>(PoolT::PAGE_BITS),
+        .versions_offset = static_cast<u32>(offsetof(PageT, versions)),
+        .hot_slots_offset = static_cast<u32>(offsetof(PageT, hot_slots)),
+        .slots_offset = static_cast<u32>(offsetof(PageT, slots)),
+        .slot_stride = static_cast<u32>(sizeof(ImplBufferSlot)),
+    };
+}
+
 auto daxa_dvc_buffer_device_address(daxa_Device self, daxa_BufferId id, daxa_DeviceAddress * out_addr) -> daxa_Result
 {
     if (!daxa_dvc_is_buffer_valid(self, id))
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_BUFFER_ID, DAXA_RESULT_INVALID_BUFFER_ID);
     }
-    *out_addr = static_cast<daxa_DeviceAddress>(self->slot(std::bit_cast<BufferId>(id)).device_address);
+    *out_addr = static_cast<daxa_DeviceAddress>(self->gpu_sro_table.buffer_slots.unsafe_get_hot(std::bit_cast<GPUResourceId>(id)).device_address);
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -982,21 +1802,87 @@ auto daxa_dvc_buffer_host_address(daxa_Device self, daxa_BufferId id, void ** ou
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_BUFFER_ID, DAXA_RESULT_INVALID_BUFFER_ID);
     }
-    if (self->slot(std::bit_cast<BufferId>(id)).host_address == 0)
+    void * host_address = self->gpu_sro_table.buffer_slots.unsafe_get_hot(std::bit_cast<GPUResourceId>(id)).host_address;
+    if (host_address == nullptr)
     {
         return DAXA_RESULT_BUFFER_NOT_HOST_VISIBLE;
     }
-    *out_addr = self->slot(std::bit_cast<BufferId>(id)).host_address;
+    *out_addr = host_address;
     return DAXA_RESULT_SUCCESS;
 }
 
+auto daxa_dvc_export_buffer_memory(daxa_Device self, daxa_BufferId id, uint64_t * out_handle) -> daxa_Result
+{
+    if (!daxa_dvc_is_buffer_valid(self, id))
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_BUFFER_ID, DAXA_RESULT_INVALID_BUFFER_ID);
+    }
+    ImplBufferSlot const & slot = self->gpu_sro_table.buffer_slots.unsafe_get(std::bit_cast<GPUResourceId>(id));
+    return export_external_memory(self, slot.info.external_memory, slot.vk_external_memory, out_handle);
+}
+
+auto daxa_dvc_export_image_memory(daxa_Device self, daxa_ImageId id, uint64_t * out_handle) -> daxa_Result
+{
+    if (!daxa_dvc_is_image_valid(self, id))
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_IMAGE_ID, DAXA_RESULT_INVALID_IMAGE_ID);
+    }
+    ImplImageSlot const & slot = self->gpu_sro_table.image_slots.unsafe_get(std::bit_cast<GPUResourceId>(id));
+    return export_external_memory(self, slot.info.external_memory, slot.vk_external_memory, out_handle);
+}
+
+namespace
+{
+    template <typename VmaRangesFn>
+    auto buffer_ranges_to_vma(daxa_Device self, daxa_BufferRange const * ranges, u32 range_count, VmaRangesFn vma_fn) -> daxa_Result
+    {
+        std::vector<VmaAllocation> allocations = {};
+        std::vector<VkDeviceSize> offsets = {};
+        std::vector<VkDeviceSize> sizes = {};
+        allocations.reserve(range_count);
+        offsets.reserve(range_count);
+        sizes.reserve(range_count);
+        for (u32 i = 0; i < range_count; ++i)
+        {
+            daxa_BufferRange const & range = ranges[i];
+            if (!daxa_dvc_is_buffer_valid(self, range.buffer))
+            {
+                _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_BUFFER_ID, DAXA_RESULT_INVALID_BUFFER_ID);
+            }
+            auto const & slot = self->gpu_sro_table.buffer_slots.unsafe_get(std::bit_cast<GPUResourceId>(range.buffer));
+            if (slot.host_address == nullptr)
+            {
+                return DAXA_RESULT_BUFFER_NOT_HOST_VISIBLE;
+            }
+            allocations.push_back(slot.vma_allocation);
+            offsets.push_back(range.offset);
+            sizes.push_back(range.size);
+        }
+        if (allocations.empty())
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+        return static_cast<daxa_Result>(vma_fn(self->vma_allocator, static_cast<u32>(allocations.size()), allocations.data(), offsets.data(), sizes.data()));
+    }
+} // namespace
+
+auto daxa_dvc_flush_buffer_ranges(daxa_Device self, daxa_BufferRange const * ranges, u32 range_count) -> daxa_Result
+{
+    return buffer_ranges_to_vma(self, ranges, range_count, vmaFlushAllocations);
+}
+
+auto daxa_dvc_invalidate_buffer_ranges(daxa_Device self, daxa_BufferRange const * ranges, u32 range_count) -> daxa_Result
+{
+    return buffer_ranges_to_vma(self, ranges, range_count, vmaInvalidateAllocations);
+}
+
 auto daxa_dvc_tlas_device_address(daxa_Device self, daxa_TlasId id, daxa_DeviceAddress * out_addr) -> daxa_Result
 {
     if (!daxa_dvc_is_tlas_valid(self, id))
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_TLAS_ID, DAXA_RESULT_INVALID_TLAS_ID);
     }
-    *out_addr = static_cast<daxa_DeviceAddress>(self->slot(std::bit_cast<TlasId>(id)).device_address);
+    *out_addr = static_cast<daxa_DeviceAddress>(self->gpu_sro_table.tlas_slots.unsafe_get_hot(std::bit_cast<GPUResourceId>(id)).device_address);
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -1006,10 +1892,20 @@ auto daxa_dvc_blas_device_address(daxa_Device self, daxa_BlasId id, daxa_DeviceA
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_BLAS_ID, DAXA_RESULT_INVALID_BLAS_ID);
     }
-    *out_addr = static_cast<daxa_DeviceAddress>(self->slot(std::bit_cast<BlasId>(id)).device_address);
+    *out_addr = static_cast<daxa_DeviceAddress>(self->gpu_sro_table.blas_slots.unsafe_get_hot(std::bit_cast<GPUResourceId>(id)).device_address);
     return DAXA_RESULT_SUCCESS;
 }
 
+void daxa_dvc_set_shader_debug_address(daxa_Device self, daxa_DeviceAddress address)
+{
+    self->buffer_device_address_buffer_host_ptr[self->info.max_allowed_buffers] = address;
+}
+
+auto daxa_dvc_shader_debug_address(daxa_Device self) -> daxa_DeviceAddress
+{
+    return self->buffer_device_address_buffer_host_ptr[self->info.max_allowed_buffers];
+}
+
 auto daxa_dvc_info(daxa_Device self) -> daxa_DeviceInfo2 const *
 {
     return r_cast<daxa_DeviceInfo2 const *>(&self->info);
@@ -1030,6 +1926,69 @@ auto daxa_dvc_wait_idle(daxa_Device self) -> daxa_Result
     return std::bit_cast<daxa_Result>(vkDeviceWaitIdle(self->vk_device));
 }
 
+auto daxa_dvc_wait_semaphores(daxa_Device self, daxa_TimelinePair const * pairs, size_t pair_count, daxa_Bool8 wait_any, u64 timeout) -> daxa_Result
+{
+    std::vector<VkSemaphore> vk_semaphores = {};
+    std::vector<u64> values = {};
+    vk_semaphores.reserve(pair_count);
+    values.reserve(pair_count);
+    for (auto const & pair : std::span{pairs, pair_count})
+    {
+        vk_semaphores.push_back(pair.semaphore->vk_semaphore);
+        values.push_back(pair.value);
+    }
+    VkSemaphoreWaitInfo const wait_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext = nullptr,
+        .flags = wait_any != 0 ? VK_SEMAPHORE_WAIT_ANY_BIT : VkSemaphoreWaitFlags{},
+        .semaphoreCount = static_cast<u32>(pair_count),
+        .pSemaphores = vk_semaphores.data(),
+        .pValues = values.data(),
+    };
+    return static_cast<daxa_Result>(vkWaitSemaphores(self->vk_device, &wait_info, timeout));
+}
+
+auto daxa_dvc_on_timeline(daxa_Device self, daxa_TimelinePair const * pair, daxa_TimelineCallback callback, void * user_data) -> daxa_Result
+{
+    std::unique_lock lock{self->timeline_callbacks_mtx};
+    if (self->timeline_reactor_wake_semaphore == VK_NULL_HANDLE)
+    {
+        VkSemaphoreTypeCreateInfo const timeline_create_info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .pNext = nullptr,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0,
+        };
+        VkSemaphoreCreateInfo const semaphore_create_info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &timeline_create_info,
+            .flags = {},
+        };
+        auto result = static_cast<daxa_Result>(vkCreateSemaphore(self->vk_device, &semaphore_create_info, nullptr, &self->timeline_reactor_wake_semaphore));
+        _DAXA_RETURN_IF_ERROR(result, result)
+        self->timeline_reactor_thread = std::thread{[self]()
+                                                    { self->timeline_reactor_loop(); }};
+    }
+    daxa_timeline_semaphore_inc_refcnt(pair->semaphore);
+    self->timeline_callbacks.push_back(daxa_ImplDevice::TimelineCallback{
+        .semaphore = pair->semaphore,
+        .value = pair->value,
+        .callback = callback,
+        .user_data = user_data,
+    });
+    self->timeline_reactor_wake_value += 1;
+    VkSemaphoreSignalInfo const wake_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO,
+        .pNext = nullptr,
+        .semaphore = self->timeline_reactor_wake_semaphore,
+        .value = self->timeline_reactor_wake_value,
+    };
+    auto result = static_cast<daxa_Result>(vkSignalSemaphore(self->vk_device, &wake_info));
+    lock.unlock();
+    self->timeline_callbacks_cv.notify_one();
+    return result;
+}
+
 auto daxa_dvc_queue_wait_idle(daxa_Device self, daxa_Queue queue) -> daxa_Result
 {
     if (!self->valid_queue(queue))
@@ -1053,148 +2012,269 @@ auto daxa_dvc_queue_count(daxa_Device self, daxa_QueueFamily queue_family, u32 *
     return DAXA_RESULT_SUCCESS;
 }
 
-auto daxa_dvc_submit(daxa_Device self, daxa_CommandSubmitInfo const * info) -> daxa_Result
+struct SubmitScratchBuffers
 {
-    if (!self->valid_queue(info->queue))
-    {
-        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_QUEUE, DAXA_RESULT_ERROR_INVALID_QUEUE);
-    }
+    std::vector<VkCommandBufferSubmitInfo> command_buffer_infos = {};
+    std::vector<VkSemaphoreSubmitInfo> wait_semaphore_infos = {};
+    std::vector<VkSemaphoreSubmitInfo> signal_semaphore_infos = {};
+    std::vector<VkSubmitInfo2> submit_infos = {};
 
-    std::shared_lock lifetime_lock{self->gpu_sro_table.lifetime_lock};
-
-    if (static_cast<u32>(info->queue.index) >= self->queue_families[info->queue.family].queue_count)
+    void clear()
     {
-        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_QUEUE, DAXA_RESULT_ERROR_INVALID_QUEUE);
+        command_buffer_infos.clear();
+        wait_semaphore_infos.clear();
+        signal_semaphore_infos.clear();
+        submit_infos.clear();
     }
+};
+
+inline static thread_local SubmitScratchBuffers tl_submit_scratch_buffers = {}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
-    for (daxa_ExecutableCommandList commands : std::span{info->command_lists, info->command_list_count})
+namespace
+{
+    auto validate_submit_info(daxa_Device self, daxa_CommandSubmitInfo const & info) -> daxa_Result
     {
-        if (commands->cmd_recorder->info.queue_family != info->queue.family)
+        if ((info.device_mask >> self->device_group_size) != 0)
         {
-            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_CMD_LIST_SUBMIT_QUEUE_FAMILY_MISMATCH, DAXA_RESULT_ERROR_CMD_LIST_SUBMIT_QUEUE_FAMILY_MISMATCH);
+            return DAXA_RESULT_ERROR_INVALID_DEVICE_MASK;
         }
-        for (BufferId id : commands->data.used_buffers)
+        for (daxa_ExecutableCommandList commands : std::span{info.command_lists, info.command_list_count})
         {
-            if (!daxa_dvc_is_buffer_valid(self, id))
+            if (commands->cmd_recorder->info.queue_family != info.queue.family)
             {
-                _DAXA_RETURN_IF_ERROR(DAXA_RESULT_COMMAND_REFERENCES_INVALID_BUFFER_ID, DAXA_RESULT_COMMAND_REFERENCES_INVALID_BUFFER_ID);
+                return DAXA_RESULT_ERROR_CMD_LIST_SUBMIT_QUEUE_FAMILY_MISMATCH;
             }
-        }
-        for (ImageId id : commands->data.used_images)
-        {
-            if (!daxa_dvc_is_image_valid(self, id))
+            // Secondary command lists can only be executed from primary command lists.
+            if (commands->cmd_recorder->is_secondary)
             {
-                _DAXA_RETURN_IF_ERROR(DAXA_RESULT_COMMAND_REFERENCES_INVALID_IMAGE_ID, DAXA_RESULT_COMMAND_REFERENCES_INVALID_IMAGE_ID);
+                return DAXA_RESULT_ERROR_COMMAND_LIST_LEVEL_MISMATCH;
             }
-        }
-        for (ImageViewId id : commands->data.used_image_views)
-        {
-            if (!daxa_dvc_is_image_view_valid(self, id))
+            // Descriptor sets retired by a table growth may already be destroyed when reusable lists are submitted again.
+            // Other lists are submitted once, retired pools are not destroyed while unsubmitted lists are alive.
+            u64 const oldest_generation = commands->data.oldest_bound_gpu_sro_table_generation;
+            if (commands->cmd_recorder->info.reusable != 0 &&
+                oldest_generation != std::numeric_limits<u64>::max() &&
+                oldest_generation != self->gpu_sro_table.generation.load(std::memory_order_acquire))
             {
-                _DAXA_RETURN_IF_ERROR(DAXA_RESULT_COMMAND_REFERENCES_INVALID_IMAGE_VIEW_ID, DAXA_RESULT_COMMAND_REFERENCES_INVALID_IMAGE_VIEW_ID);
+                return DAXA_RESULT_ERROR_REUSABLE_COMMAND_LIST_OUTDATED;
             }
-        }
-        for (SamplerId id : commands->data.used_samplers)
-        {
-            if (!daxa_dvc_is_sampler_valid(self, id))
+            for (BufferId id : commands->data.used_buffers)
             {
-                _DAXA_RETURN_IF_ERROR(DAXA_RESULT_COMMAND_REFERENCES_INVALID_SAMPLER_ID, DAXA_RESULT_COMMAND_REFERENCES_INVALID_SAMPLER_ID);
+                if (!daxa_dvc_is_buffer_valid(self, id))
+                {
+                    return DAXA_RESULT_COMMAND_REFERENCES_INVALID_BUFFER_ID;
+                }
+            }
+            for (ImageId id : commands->data.used_images)
+            {
+                if (!daxa_dvc_is_image_valid(self, id))
+                {
+                    return DAXA_RESULT_COMMAND_REFERENCES_INVALID_IMAGE_ID;
+                }
+            }
+            for (ImageViewId id : commands->data.used_image_views)
+            {
+                if (!daxa_dvc_is_image_view_valid(self, id))
+                {
+                    return DAXA_RESULT_COMMAND_REFERENCES_INVALID_IMAGE_VIEW_ID;
+                }
+            }
+            for (SamplerId id : commands->data.used_samplers)
+            {
+                if (!daxa_dvc_is_sampler_valid(self, id))
+                {
+                    return DAXA_RESULT_COMMAND_REFERENCES_INVALID_SAMPLER_ID;
+                }
             }
         }
+        return DAXA_RESULT_SUCCESS;
     }
 
-    daxa_ImplDevice::ImplQueue & queue = self->get_queue(info->queue);
-    u64 const current_timeline_value = self->global_submit_timeline.fetch_add(1) + 1;
-    queue.latest_pending_submit_timeline_value.store(current_timeline_value);
-
-    for (auto const & commands : std::span{info->command_lists, info->command_list_count})
+    auto make_semaphore_submit_info(VkSemaphore semaphore, u64 value, VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT) -> VkSemaphoreSubmitInfo
     {
-        executable_cmd_list_execute_deferred_destructions(self, commands->data);
+        return VkSemaphoreSubmitInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .pNext = nullptr,
+            .semaphore = semaphore,
+            .value = value,
+            .stageMask = stages,
+            .deviceIndex = 0,
+        };
     }
+} // namespace
 
-    std::vector<VkCommandBuffer> submit_vk_command_buffers = {};
-    for (auto const & commands : std::span{info->command_lists, info->command_list_count})
-    {
-        submit_vk_command_buffers.push_back(commands->data.vk_cmd_buffer);
-    }
+auto daxa_dvc_submit(daxa_Device self, daxa_CommandSubmitInfo const * info) -> daxa_Result
+{
+    return daxa_dvc_submit_batch(self, info, 1);
+}
 
-    std::vector<VkSemaphore> submit_semaphore_signals = {}; // All timeline semaphores come first, then binary semaphores follow.
-    std::vector<u64> submit_semaphore_signal_values = {};   // Used for timeline semaphores. Ignored (push dummy value) for binary semaphores.
+auto daxa_dvc_latest_submit_index(daxa_Device self) -> u64
+{
+    return self->global_submit_timeline.load(std::memory_order::acquire);
+}
 
-    // Add main queue timeline signaling as first timeline semaphore signaling:
-    submit_semaphore_signals.push_back(queue.gpu_queue_local_timeline);
-    submit_semaphore_signal_values.push_back(current_timeline_value);
+auto daxa_dvc_completed_submit_index(daxa_Device self, u64 * out_index) -> daxa_Result
+{
+    u64 retired = {};
+    auto const result = self->get_retired_submit_timeline_value(retired);
+    _DAXA_RETURN_IF_ERROR(result, result)
+    // Without pending submits everything submitted so far completed.
+    *out_index = std::min(retired, self->global_submit_timeline.load(std::memory_order::acquire));
+    return DAXA_RESULT_SUCCESS;
+}
 
-    for (auto const & pair : std::span{info->signal_timeline_semaphores, info->signal_timeline_semaphore_count})
+auto daxa_dvc_submit_batch(daxa_Device self, daxa_CommandSubmitInfo const * infos, usize info_count) -> daxa_Result
+{
+    DAXA_PROFILE_ZONE("daxa_dvc_submit_batch");
+    if (info_count == 0)
     {
-        submit_semaphore_signals.push_back(pair.semaphore->vk_semaphore);
-        submit_semaphore_signal_values.push_back(pair.value);
+        return DAXA_RESULT_SUCCESS;
     }
 
-    for (auto const & binary_semaphore : std::span{info->signal_binary_semaphores, info->signal_binary_semaphore_count})
+    daxa_Queue const batch_queue = infos[0].queue;
+    if (!self->valid_queue(batch_queue))
     {
-        submit_semaphore_signals.push_back(binary_semaphore->vk_semaphore);
-        submit_semaphore_signal_values.push_back(0); // The vulkan spec requires to have dummy values for binary semaphores.
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_QUEUE, DAXA_RESULT_ERROR_INVALID_QUEUE);
     }
 
-    // used to synchronize with previous submits:
-    std::vector<VkSemaphore> submit_semaphore_waits = {}; // All timeline semaphores come first, then binary semaphores follow.
-    std::vector<VkPipelineStageFlags> submit_semaphore_wait_stage_masks = {};
-    std::vector<u64> submit_semaphore_wait_values = {}; // Used for timeline semaphores. Ignored (push dummy value) for binary semaphores.
+    std::shared_lock lifetime_lock{self->gpu_sro_table.lifetime_lock};
 
-    for (auto const & pair : std::span{info->wait_timeline_semaphores, info->wait_timeline_semaphore_count})
+    if (static_cast<u32>(batch_queue.index) >= self->queue_families[batch_queue.family].queue_count)
     {
-        submit_semaphore_waits.push_back(pair.semaphore->vk_semaphore);
-        submit_semaphore_wait_stage_masks.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
-        submit_semaphore_wait_values.push_back(pair.value);
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_QUEUE, DAXA_RESULT_ERROR_INVALID_QUEUE);
     }
 
-    for (auto const & binary_semaphore : std::span{info->wait_binary_semaphores, info->wait_binary_semaphore_count})
+    auto const submit_infos = std::span{infos, info_count};
+    for (auto const & info : submit_infos)
     {
-        submit_semaphore_waits.push_back(binary_semaphore->vk_semaphore);
-        submit_semaphore_wait_stage_masks.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
-        submit_semaphore_wait_values.push_back(0);
+        if (info.queue.family != batch_queue.family || info.queue.index != batch_queue.index)
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_SUBMIT_BATCH_QUEUE_MISMATCH, DAXA_RESULT_ERROR_SUBMIT_BATCH_QUEUE_MISMATCH);
+        }
+        auto const result = validate_submit_info(self, info);
+        _DAXA_RETURN_IF_ERROR(result, result)
     }
 
-    VkTimelineSemaphoreSubmitInfo timeline_info{
-        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
-        .pNext = nullptr,
-        .waitSemaphoreValueCount = static_cast<u32>(submit_semaphore_wait_values.size()),
-        .pWaitSemaphoreValues = submit_semaphore_wait_values.data(),
-        .signalSemaphoreValueCount = static_cast<u32>(submit_semaphore_signal_values.size()),
-        .pSignalSemaphoreValues = submit_semaphore_signal_values.data(),
-    };
-
-    VkSubmitInfo const vk_submit_info{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext = r_cast<void *>(&timeline_info),
-        .waitSemaphoreCount = static_cast<u32>(submit_semaphore_waits.size()),
-        .pWaitSemaphores = submit_semaphore_waits.data(),
-        .pWaitDstStageMask = submit_semaphore_wait_stage_masks.data(),
-        .commandBufferCount = static_cast<u32>(submit_vk_command_buffers.size()),
-        .pCommandBuffers = submit_vk_command_buffers.data(),
-        .signalSemaphoreCount = static_cast<u32>(submit_semaphore_signals.size()),
-        .pSignalSemaphores = submit_semaphore_signals.data(),
-    };
-    auto result = static_cast<daxa_Result>(vkQueueSubmit(queue.vk_queue, 1, &vk_submit_info, VK_NULL_HANDLE));
-    _DAXA_RETURN_IF_ERROR(result, result)
-
-    std::unique_lock const lock{self->zombies_mtx};
+    // Captured before the deferred destructions of the command lists, the host visible contents are compared against the capture.
+    if (self->capture.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_submits(self, submit_infos);
+    }
 
-    return DAXA_RESULT_SUCCESS;
-}
+    // The whole batch shares one timeline value.
+    // Only the last submit signals the queue timeline, which by submission order also covers all earlier submits of the batch.
+    daxa_ImplDevice::ImplQueue & queue = self->get_queue(batch_queue);
+    auto const timeline_result = queue.ensure_timeline(self);
+    _DAXA_RETURN_IF_ERROR(timeline_result, timeline_result)
+    u64 const current_timeline_value = self->global_submit_timeline.fetch_add(1) + 1;
+    queue.latest_pending_submit_timeline_value.store(current_timeline_value);
 
-auto daxa_dvc_present(daxa_Device self, daxa_PresentInfo const * info) -> daxa_Result
-{
-    if (info->queue.family != static_cast<daxa_QueueFamily>(info->swapchain->info.queue_family))
+    for (auto const & info : submit_infos)
     {
-        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_PRESENT_QUEUE_FAMILY_MISMATCH, DAXA_RESULT_ERROR_PRESENT_QUEUE_FAMILY_MISMATCH)
+        for (auto const & commands : std::span{info.command_lists, info.command_list_count})
+        {
+            executable_cmd_list_execute_deferred_destructions(self, commands->data);
+            executable_cmd_list_notify_submit_timeline_listeners(commands->data, current_timeline_value);
+            executable_cmd_list_release_unsubmitted_count(self, commands->data);
+        }
     }
-    if (!self->valid_queue(info->queue))
+
+    // All submit arrays are built in thread local scratch buffers.
+    // They are cleared but never shrunk, so steady state submits do not allocate.
+    // Reserving the total counts up front keeps the pointers into them stable while they are filled.
+    SubmitScratchBuffers & scratch = tl_submit_scratch_buffers;
+    scratch.clear();
+    usize total_command_buffer_count = 0;
+    usize total_wait_count = 0;
+    usize total_signal_count = 1; // Queue timeline signal.
+    for (auto const & info : submit_infos)
     {
-        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_QUEUE, DAXA_RESULT_ERROR_INVALID_QUEUE)
+        total_command_buffer_count += info.command_list_count;
+        total_wait_count += info.wait_timeline_semaphore_count + info.wait_binary_semaphore_count;
+        total_signal_count += info.signal_timeline_semaphore_count + info.signal_binary_semaphore_count;
     }
-    // used to synchronize with previous submits:
+    scratch.command_buffer_infos.reserve(total_command_buffer_count);
+    scratch.wait_semaphore_infos.reserve(total_wait_count);
+    scratch.signal_semaphore_infos.reserve(total_signal_count);
+    scratch.submit_infos.reserve(submit_infos.size());
+
+    for (usize submit_i = 0; submit_i < submit_infos.size(); ++submit_i)
+    {
+        auto const & info = submit_infos[submit_i];
+        usize const command_buffer_offset = scratch.command_buffer_infos.size();
+        usize const wait_offset = scratch.wait_semaphore_infos.size();
+        usize const signal_offset = scratch.signal_semaphore_infos.size();
+
+        for (auto const & commands : std::span{info.command_lists, info.command_list_count})
+        {
+            scratch.command_buffer_infos.push_back(VkCommandBufferSubmitInfo{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+                .pNext = nullptr,
+                .commandBuffer = commands->data.vk_cmd_buffer,
+                .deviceMask = info.device_mask,
+            });
+        }
+
+        // Used to synchronize with previous submits.
+        // Each wait only blocks the stages given for it, instead of the whole submission.
+        // Timeline values are ignored for binary semaphores.
+        VkPipelineStageFlags2 const default_wait_stages = info.wait_stages != 0 ? info.wait_stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        for (usize i = 0; i < info.wait_timeline_semaphore_count; ++i)
+        {
+            auto const & pair = info.wait_timeline_semaphores[i];
+            VkPipelineStageFlags2 const stages = info.wait_timeline_semaphore_stages != nullptr ? info.wait_timeline_semaphore_stages[i] : default_wait_stages;
+            scratch.wait_semaphore_infos.push_back(make_semaphore_submit_info(pair.semaphore->vk_semaphore, pair.value, stages));
+        }
+        for (usize i = 0; i < info.wait_binary_semaphore_count; ++i)
+        {
+            VkPipelineStageFlags2 const stages = info.wait_binary_semaphore_stages != nullptr ? info.wait_binary_semaphore_stages[i] : default_wait_stages;
+            scratch.wait_semaphore_infos.push_back(make_semaphore_submit_info(info.wait_binary_semaphores[i]->vk_semaphore, 0, stages));
+        }
+
+        if (submit_i == submit_infos.size() - 1)
+        {
+            scratch.signal_semaphore_infos.push_back(make_semaphore_submit_info(queue.gpu_queue_local_timeline.load(std::memory_order::relaxed), current_timeline_value));
+        }
+        for (auto const & pair : std::span{info.signal_timeline_semaphores, info.signal_timeline_semaphore_count})
+        {
+            scratch.signal_semaphore_infos.push_back(make_semaphore_submit_info(pair.semaphore->vk_semaphore, pair.value));
+        }
+        for (auto const & binary_semaphore : std::span{info.signal_binary_semaphores, info.signal_binary_semaphore_count})
+        {
+            scratch.signal_semaphore_infos.push_back(make_semaphore_submit_info(binary_semaphore->vk_semaphore, 0));
+        }
+
+        scratch.submit_infos.push_back(VkSubmitInfo2{
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .pNext = nullptr,
+            .flags = {},
+            .waitSemaphoreInfoCount = static_cast<u32>(scratch.wait_semaphore_infos.size() - wait_offset),
+            .pWaitSemaphoreInfos = scratch.wait_semaphore_infos.data() + wait_offset,
+            .commandBufferInfoCount = static_cast<u32>(scratch.command_buffer_infos.size() - command_buffer_offset),
+            .pCommandBufferInfos = scratch.command_buffer_infos.data() + command_buffer_offset,
+            .signalSemaphoreInfoCount = static_cast<u32>(scratch.signal_semaphore_infos.size() - signal_offset),
+            .pSignalSemaphoreInfos = scratch.signal_semaphore_infos.data() + signal_offset,
+        });
+    }
+
+    auto result = static_cast<daxa_Result>(vkQueueSubmit2(queue.vk_queue, static_cast<u32>(scratch.submit_infos.size()), scratch.submit_infos.data(), VK_NULL_HANDLE));
+    _DAXA_RETURN_IF_ERROR(result, result)
+
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_present(daxa_Device self, daxa_PresentInfo const * info) -> daxa_Result
+{
+    DAXA_PROFILE_ZONE("daxa_dvc_present");
+    if (info->queue.family != static_cast<daxa_QueueFamily>(info->swapchain->info.queue_family))
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_PRESENT_QUEUE_FAMILY_MISMATCH, DAXA_RESULT_ERROR_PRESENT_QUEUE_FAMILY_MISMATCH)
+    }
+    if (!self->valid_queue(info->queue))
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_QUEUE, DAXA_RESULT_ERROR_INVALID_QUEUE)
+    }
+    // used to synchronize with previous submits:
     std::vector<VkSemaphore> submit_semaphore_waits = {};
 
     for (auto const & binary_semaphore : std::span{info->wait_binary_semaphores, info->wait_binary_semaphore_count})
@@ -1202,9 +2282,43 @@ auto daxa_dvc_present(daxa_Device self, daxa_PresentInfo const * info) -> daxa_R
         submit_semaphore_waits.push_back(binary_semaphore->vk_semaphore);
     }
 
+    // Frames are identified by their cpu timeline value, pacing waits and latency markers refer to them.
+    daxa_Swapchain swapchain = info->swapchain;
+    u64 const present_id = swapchain->cpu_frame_timeline;
+    bool const use_present_id = swapchain->info.latency_mode != SwapchainLatencyMode::DEFAULT;
+    VkPresentIdKHR const present_id_info{
+        .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+        .pNext = nullptr,
+        .swapchainCount = 1,
+        .pPresentIds = &present_id,
+    };
+    VkPresentTimeGOOGLE const present_time{
+        .presentID = static_cast<u32>(present_id),
+        .desiredPresentTime = 0,
+    };
+    bool const use_display_timing = (self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING) != 0;
+    VkPresentTimesInfoGOOGLE const present_times_info{
+        .sType = VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE,
+        .pNext = use_present_id ? &present_id_info : nullptr,
+        .swapchainCount = 1,
+        .pTimes = &present_time,
+    };
+    bool const low_latency = swapchain->info.latency_mode == SwapchainLatencyMode::LOW_LATENCY;
+    if (low_latency)
+    {
+        swapchain->set_latency_marker(present_id, VK_LATENCY_MARKER_PRESENT_START_NV);
+    }
+    if (auto * statistics = swapchain->frame_statistics_of(present_id); statistics != nullptr)
+    {
+        statistics->present_call_time_ns = static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        statistics->cpu_frame_time_ns = statistics->present_call_time_ns - std::min(statistics->present_call_time_ns, swapchain->acquire_end_time_ns);
+    }
+
+    void const * present_next = use_present_id ? static_cast<void const *>(&present_id_info) : nullptr;
+    present_next = use_display_timing ? static_cast<void const *>(&present_times_info) : present_next;
     VkPresentInfoKHR const present_info{
         .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .pNext = nullptr,
+        .pNext = present_next,
         .waitSemaphoreCount = static_cast<u32>(submit_semaphore_waits.size()),
         .pWaitSemaphores = submit_semaphore_waits.data(),
         .swapchainCount = static_cast<u32>(1),
@@ -1214,138 +2328,1004 @@ auto daxa_dvc_present(daxa_Device self, daxa_PresentInfo const * info) -> daxa_R
     };
 
     auto result = static_cast<daxa_Result>(vkQueuePresentKHR(self->get_queue(info->queue).vk_queue, &present_info));
+    if (low_latency)
+    {
+        swapchain->set_latency_marker(present_id, VK_LATENCY_MARKER_PRESENT_END_NV);
+    }
     _DAXA_RETURN_IF_ERROR(result, result)
 
+    if (use_present_id)
+    {
+        swapchain->first_present_id = swapchain->first_present_id == 0 ? present_id : swapchain->first_present_id;
+        swapchain->last_present_id = present_id;
+    }
+
     return std::bit_cast<daxa_Result>(result);
 }
 
-auto daxa_dvc_collect_garbage(daxa_Device self) -> daxa_Result
+auto daxa_dvc_bind_sparse(daxa_Device self, daxa_BindSparseInfo const * info) -> daxa_Result
 {
-    std::unique_lock lifetime_lock{self->gpu_sro_table.lifetime_lock};
-    std::unique_lock lock{self->zombies_mtx};
+    if (!self->valid_queue(info->queue) || static_cast<u32>(info->queue.index) >= self->queue_families[info->queue.family].queue_count)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_QUEUE, DAXA_RESULT_ERROR_INVALID_QUEUE);
+    }
+    if ((self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING) == 0 ||
+        !self->queue_families[info->queue.family].supports_sparse_binding)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED, DAXA_RESULT_ERROR_SPARSE_BINDING_NOT_SUPPORTED);
+    }
 
-    u64 min_pending_device_timeline_value_of_all_queues = std::numeric_limits<u64>::max();
-    for (auto & queue : self->queues)
+    std::shared_lock lifetime_lock{self->gpu_sro_table.lifetime_lock};
+
+    auto to_vk_memory = [](daxa_MemoryBlock memory_block, u64 memory_block_offset) -> std::pair<VkDeviceMemory, VkDeviceSize>
     {
-        std::optional<u64> latest_pending_submit = {};
-        auto result = queue.get_oldest_pending_submit(self->vk_device, latest_pending_submit);
+        if (memory_block == nullptr)
+        {
+            return {VK_NULL_HANDLE, 0};
+        }
+        return {memory_block->alloc_info.deviceMemory, memory_block->alloc_info.offset + memory_block_offset};
+    };
+
+    // One bind info per bind, vulkan allows several bind infos for the same resource.
+    std::vector<VkSparseMemoryBind> vk_memory_binds = {};
+    std::vector<VkSparseImageMemoryBind> vk_image_memory_binds = {};
+    vk_memory_binds.reserve(info->buffer_bind_count + info->image_opaque_bind_count);
+    vk_image_memory_binds.reserve(info->image_bind_count);
+    std::vector<VkSparseBufferMemoryBindInfo> vk_buffer_bind_infos = {};
+    std::vector<VkSparseImageOpaqueMemoryBindInfo> vk_image_opaque_bind_infos = {};
+    std::vector<VkSparseImageMemoryBindInfo> vk_image_bind_infos = {};
+
+    for (auto const & bind : std::span{info->buffer_binds, info->buffer_bind_count})
+    {
+        if (!daxa_dvc_is_buffer_valid(self, bind.buffer))
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_BUFFER_ID, DAXA_RESULT_INVALID_BUFFER_ID);
+        }
+        auto const [vk_memory, vk_memory_offset] = to_vk_memory(bind.memory_block, bind.memory_block_offset);
+        vk_memory_binds.push_back(VkSparseMemoryBind{
+            .resourceOffset = bind.offset,
+            .size = bind.size,
+            .memory = vk_memory,
+            .memoryOffset = vk_memory_offset,
+            .flags = {},
+        });
+        vk_buffer_bind_infos.push_back(VkSparseBufferMemoryBindInfo{
+            .buffer = self->slot(bind.buffer).vk_buffer,
+            .bindCount = 1,
+            .pBinds = &vk_memory_binds.back(),
+        });
+    }
+    for (auto const & bind : std::span{info->image_opaque_binds, info->image_opaque_bind_count})
+    {
+        if (!daxa_dvc_is_image_valid(self, bind.image))
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_IMAGE_ID, DAXA_RESULT_INVALID_IMAGE_ID);
+        }
+        auto const [vk_memory, vk_memory_offset] = to_vk_memory(bind.memory_block, bind.memory_block_offset);
+        vk_memory_binds.push_back(VkSparseMemoryBind{
+            .resourceOffset = bind.offset,
+            .size = bind.size,
+            .memory = vk_memory,
+            .memoryOffset = vk_memory_offset,
+            .flags = {},
+        });
+        vk_image_opaque_bind_infos.push_back(VkSparseImageOpaqueMemoryBindInfo{
+            .image = self->slot(bind.image).vk_image,
+            .bindCount = 1,
+            .pBinds = &vk_memory_binds.back(),
+        });
+    }
+    for (auto const & bind : std::span{info->image_binds, info->image_bind_count})
+    {
+        if (!daxa_dvc_is_image_valid(self, bind.image))
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_INVALID_IMAGE_ID, DAXA_RESULT_INVALID_IMAGE_ID);
+        }
+        ImplImageSlot const & image_slot = self->slot(bind.image);
+        auto const [vk_memory, vk_memory_offset] = to_vk_memory(bind.memory_block, bind.memory_block_offset);
+        vk_image_memory_binds.push_back(VkSparseImageMemoryBind{
+            .subresource = VkImageSubresource{
+                .aspectMask = image_slot.aspect_flags,
+                .mipLevel = bind.slice.mip_level,
+                .arrayLayer = bind.slice.array_layer,
+            },
+            .offset = bind.offset,
+            .extent = bind.extent,
+            .memory = vk_memory,
+            .memoryOffset = vk_memory_offset,
+            .flags = {},
+        });
+        vk_image_bind_infos.push_back(VkSparseImageMemoryBindInfo{
+            .image = image_slot.vk_image,
+            .bindCount = 1,
+            .pBinds = &vk_image_memory_binds.back(),
+        });
+    }
+
+    // Sparse binding has no VkSemaphoreSubmitInfo, timeline values go into a parallel array.
+    // Values are ignored for binary semaphores.
+    daxa_ImplDevice::ImplQueue & queue = self->get_queue(info->queue);
+    auto const timeline_result = queue.ensure_timeline(self);
+    _DAXA_RETURN_IF_ERROR(timeline_result, timeline_result)
+    u64 const current_timeline_value = self->global_submit_timeline.fetch_add(1) + 1;
+    queue.latest_pending_submit_timeline_value.store(current_timeline_value);
+
+    std::vector<VkSemaphore> wait_semaphores = {};
+    std::vector<u64> wait_values = {};
+    for (auto const & pair : std::span{info->wait_timeline_semaphores, info->wait_timeline_semaphore_count})
+    {
+        wait_semaphores.push_back(pair.semaphore->vk_semaphore);
+        wait_values.push_back(pair.value);
+    }
+    for (auto const & binary_semaphore : std::span{info->wait_binary_semaphores, info->wait_binary_semaphore_count})
+    {
+        wait_semaphores.push_back(binary_semaphore->vk_semaphore);
+        wait_values.push_back(0);
+    }
+    // Lets the garbage collector know when the binding is done.
+    std::vector<VkSemaphore> signal_semaphores = {queue.gpu_queue_local_timeline.load(std::memory_order::relaxed)};
+    std::vector<u64> signal_values = {current_timeline_value};
+    for (auto const & pair : std::span{info->signal_timeline_semaphores, info->signal_timeline_semaphore_count})
+    {
+        signal_semaphores.push_back(pair.semaphore->vk_semaphore);
+        signal_values.push_back(pair.value);
+    }
+    for (auto const & binary_semaphore : std::span{info->signal_binary_semaphores, info->signal_binary_semaphore_count})
+    {
+        signal_semaphores.push_back(binary_semaphore->vk_semaphore);
+        signal_values.push_back(0);
+    }
+
+    VkTimelineSemaphoreSubmitInfo const timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext = nullptr,
+        .waitSemaphoreValueCount = static_cast<u32>(wait_values.size()),
+        .pWaitSemaphoreValues = wait_values.data(),
+        .signalSemaphoreValueCount = static_cast<u32>(signal_values.size()),
+        .pSignalSemaphoreValues = signal_values.data(),
+    };
+    VkBindSparseInfo const vk_bind_sparse_info{
+        .sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+        .pNext = &timeline_info,
+        .waitSemaphoreCount = static_cast<u32>(wait_semaphores.size()),
+        .pWaitSemaphores = wait_semaphores.data(),
+        .bufferBindCount = static_cast<u32>(vk_buffer_bind_infos.size()),
+        .pBufferBinds = vk_buffer_bind_infos.data(),
+        .imageOpaqueBindCount = static_cast<u32>(vk_image_opaque_bind_infos.size()),
+        .pImageOpaqueBinds = vk_image_opaque_bind_infos.data(),
+        .imageBindCount = static_cast<u32>(vk_image_bind_infos.size()),
+        .pImageBinds = vk_image_bind_infos.data(),
+        .signalSemaphoreCount = static_cast<u32>(signal_semaphores.size()),
+        .pSignalSemaphores = signal_semaphores.data(),
+    };
+    auto result = static_cast<daxa_Result>(vkQueueBindSparse(queue.vk_queue, 1, &vk_bind_sparse_info, VK_NULL_HANDLE));
+    _DAXA_RETURN_IF_ERROR(result, result)
+
+    return DAXA_RESULT_SUCCESS;
+}
+
+namespace
+{
+    struct GarbageCollectBudget
+    {
+        u64 max_destroyed_zombies = 0;
+        std::optional<std::chrono::steady_clock::time_point> deadline = {};
+        u64 destroyed_zombies = 0;
+        bool ran_out = false;
+
+        auto exhausted() -> bool
+        {
+            if (max_destroyed_zombies != 0 && destroyed_zombies >= max_destroyed_zombies)
+            {
+                ran_out = true;
+            }
+            else if (deadline.has_value() && std::chrono::steady_clock::now() >= deadline.value())
+            {
+                ran_out = true;
+            }
+            return ran_out;
+        }
+    };
+
+    // The caller must hold the lifetime lock exclusively and the zombies_mtx.
+    auto collect_garbage_within_budget(daxa_Device self, GarbageCollectBudget & budget) -> daxa_Result
+    {
+        u64 min_pending_device_timeline_value_of_all_queues = {};
+        auto result = self->get_retired_submit_timeline_value(min_pending_device_timeline_value_of_all_queues);
         _DAXA_RETURN_IF_ERROR(result, result)
 
-        if (latest_pending_submit.has_value())
+        self->gpu_sro_table.collect_retired_descriptor_pools(
+            self->vk_device,
+            self->global_submit_timeline.load(std::memory_order::relaxed),
+            min_pending_device_timeline_value_of_all_queues);
+
+        auto check_and_cleanup_gpu_resources = [&](auto & zombies, auto const & cleanup_fn)
+        {
+            while (!zombies.empty())
+            {
+                auto & [timeline_value, object] = zombies.back();
+
+                if (timeline_value >= min_pending_device_timeline_value_of_all_queues || budget.exhausted())
+                {
+                    break;
+                }
+
+                cleanup_fn(object);
+                zombies.pop_back();
+                budget.destroyed_zombies += 1;
+            }
+        };
+        check_and_cleanup_gpu_resources(
+            self->buffer_zombies,
+            [&](auto id)
+            {
+                self->cleanup_buffer(id);
+            });
+        check_and_cleanup_gpu_resources(
+            self->image_view_zombies,
+            [&](auto id)
+            {
+                self->cleanup_image_view(id);
+            });
+        check_and_cleanup_gpu_resources(
+            self->image_zombies,
+            [&](auto id)
+            {
+                self->cleanup_image(id);
+            });
+        check_and_cleanup_gpu_resources(
+            self->sampler_zombies,
+            [&](auto id)
+            {
+                self->cleanup_sampler(id);
+            });
+        check_and_cleanup_gpu_resources(
+            self->tlas_zombies,
+            [&](auto id)
+            {
+                self->cleanup_tlas(id);
+            });
+        check_and_cleanup_gpu_resources(
+            self->blas_zombies,
+            [&](auto id)
+            {
+                self->cleanup_blas(id);
+            });
+        check_and_cleanup_gpu_resources(
+            self->pipeline_zombies,
+            [&](auto & pipeline_zombie)
+            {
+                vkDestroyPipeline(self->vk_device, pipeline_zombie.vk_pipeline, nullptr);
+            });
+        check_and_cleanup_gpu_resources(
+            self->semaphore_zombies,
+            [&](auto & semaphore_zombie)
+            {
+                vkDestroySemaphore(self->vk_device, semaphore_zombie.vk_semaphore, nullptr);
+            });
+        check_and_cleanup_gpu_resources(
+            self->split_barrier_zombies,
+            [&](auto & split_barrier_zombie)
+            {
+                vkDestroyEvent(self->vk_device, split_barrier_zombie.vk_event, nullptr);
+            });
+        check_and_cleanup_gpu_resources(
+            self->timeline_query_pool_zombies,
+            [&](auto & timeline_query_pool_zombie)
+            {
+                vkDestroyQueryPool(self->vk_device, timeline_query_pool_zombie.vk_timeline_query_pool, nullptr);
+            });
+        check_and_cleanup_gpu_resources(
+            self->query_pool_zombies,
+            [&](auto & query_pool_zombie)
+            {
+                vkDestroyQueryPool(self->vk_device, query_pool_zombie.vk_query_pool, nullptr);
+            });
+        check_and_cleanup_gpu_resources(
+            self->generated_commands_zombies,
+            [&](auto & generated_commands_zombie)
+            {
+                if (generated_commands_zombie.vk_indirect_commands_layout != VK_NULL_HANDLE)
+                {
+                    self->vkDestroyIndirectCommandsLayoutEXT(self->vk_device, generated_commands_zombie.vk_indirect_commands_layout, nullptr);
+                }
+                if (generated_commands_zombie.vk_indirect_execution_set != VK_NULL_HANDLE)
+                {
+                    self->vkDestroyIndirectExecutionSetEXT(self->vk_device, generated_commands_zombie.vk_indirect_execution_set, nullptr);
+                }
+            });
+        check_and_cleanup_gpu_resources(
+            self->shader_object_zombies,
+            [&](auto & shader_object_zombie)
+            {
+                self->vkDestroyShaderEXT(self->vk_device, shader_object_zombie.vk_shader, nullptr);
+            });
+        check_and_cleanup_gpu_resources(
+            self->micromap_zombies,
+            [&](auto & micromap_zombie)
+            {
+                self->vkDestroyMicromapEXT(self->vk_device, micromap_zombie.vk_micromap, nullptr);
+            });
+        check_and_cleanup_gpu_resources(
+            self->video_session_zombies,
+            [&](auto & video_session_zombie)
+            {
+                if (video_session_zombie.vk_video_session_parameters != VK_NULL_HANDLE)
+                {
+                    self->vkDestroyVideoSessionParametersKHR(self->vk_device, video_session_zombie.vk_video_session_parameters, nullptr);
+                }
+                self->vkDestroyVideoSessionKHR(self->vk_device, video_session_zombie.vk_video_session, nullptr);
+                for (auto allocation : video_session_zombie.allocations)
+                {
+                    vmaFreeMemory(self->vma_allocator, allocation);
+                }
+            });
+        check_and_cleanup_gpu_resources(
+            self->memory_block_zombies,
+            [&](auto & memory_block_zombie)
+            {
+                vmaFreeMemory(self->vma_allocator, memory_block_zombie.allocation);
+            });
+        while (!self->command_list_zombies.empty())
         {
-            min_pending_device_timeline_value_of_all_queues = std::min(min_pending_device_timeline_value_of_all_queues, latest_pending_submit.value());
+            auto & [timeline_value, zombie] = self->command_list_zombies.back();
+
+            // Zombies are sorted. When we see a single zombie that is too young, we can dismiss the rest as they are the same age or even younger.
+            if (timeline_value >= min_pending_device_timeline_value_of_all_queues || budget.exhausted())
+            {
+                break;
+            }
+
+            // One reset recycles the pool with all its command buffers, they are reused instead of freed.
+            auto result = static_cast<daxa_Result>(vkResetCommandPool(self->vk_device, zombie.cmd_pool.vk_cmd_pool, {}));
+            _DAXA_RETURN_IF_ERROR(result, result)
+
+            // Returned to the shard of the thread that created the recorder, keeping pools thread affine.
+            self->command_pool_pools[zombie.queue_family].put_back(zombie.cmd_pool_shard, std::move(zombie.cmd_pool));
+            self->command_list_zombies.pop_back();
+            budget.destroyed_zombies += 1;
         }
+        return budget.ran_out ? DAXA_RESULT_INCOMPLETE : DAXA_RESULT_SUCCESS;
+    }
+} // namespace
+
+auto daxa_dvc_save_pipeline_cache(daxa_Device self) -> daxa_Result
+{
+    if (self->pipeline_cache_directory.empty())
+    {
+        return DAXA_RESULT_SUCCESS;
     }
+    usize size = {};
+    auto vk_result = vkGetPipelineCacheData(self->vk_device, self->vk_pipeline_cache, &size, nullptr);
+    if (vk_result != VK_SUCCESS)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+    std::vector<std::byte> data(size);
+    vk_result = vkGetPipelineCacheData(self->vk_device, self->vk_pipeline_cache, &size, data.data());
+    // VK_INCOMPLETE is returned when the cache grew between the calls, the written prefix is still a valid cache.
+    if (vk_result != VK_SUCCESS && vk_result != VK_INCOMPLETE)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+    if (!write_binary_file(self->pipeline_cache_file_path(PIPELINE_CACHE_FILE_PREFIX), std::span{data.data(), size}))
+    {
+        return DAXA_RESULT_ERROR_PIPELINE_CACHE_WRITE_FAILED;
+    }
+    auto & archive = self->pipeline_binary_archive;
+    bool archive_dirty = {};
+    {
+        std::unique_lock const lock{archive.mtx};
+        archive_dirty = archive.dirty;
+    }
+    if (archive.enabled && archive_dirty)
+    {
+        auto const archive_data = archive.serialize(self->properties.pipeline_cache_uuid);
+        if (!write_binary_file(self->pipeline_cache_file_path(PIPELINE_BINARY_ARCHIVE_FILE_PREFIX), archive_data))
+        {
+            return DAXA_RESULT_ERROR_PIPELINE_CACHE_WRITE_FAILED;
+        }
+    }
+    return DAXA_RESULT_SUCCESS;
+}
 
-    auto check_and_cleanup_gpu_resources = [&](auto & zombies, auto const & cleanup_fn)
+auto daxa_dvc_collect_garbage(daxa_Device self) -> daxa_Result
+{
+    DAXA_PROFILE_ZONE("daxa_dvc_collect_garbage");
+    std::unique_lock lifetime_lock{self->gpu_sro_table.lifetime_lock};
+    std::unique_lock lock{self->zombies_mtx};
+
+    GarbageCollectBudget budget = {};
+    return collect_garbage_within_budget(self, budget);
+}
+
+auto daxa_dvc_collect_garbage_incremental(daxa_Device self, daxa_GarbageCollectInfo const * info) -> daxa_Result
+{
+    DAXA_PROFILE_ZONE("daxa_dvc_collect_garbage_incremental");
+    std::unique_lock lifetime_lock{self->gpu_sro_table.lifetime_lock, std::defer_lock};
+    if (info->non_blocking != 0)
     {
-        while (!zombies.empty())
+        if (!lifetime_lock.try_lock())
         {
-            auto & [timeline_value, object] = zombies.back();
+            return DAXA_RESULT_NOT_READY;
+        }
+    }
+    else
+    {
+        lifetime_lock.lock();
+    }
+    std::unique_lock lock{self->zombies_mtx};
+
+    GarbageCollectBudget budget = {.max_destroyed_zombies = info->max_destroyed_zombies};
+    if (info->max_nanoseconds != 0)
+    {
+        budget.deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds{info->max_nanoseconds};
+    }
+    return collect_garbage_within_budget(self, budget);
+}
+
+auto daxa_dvc_properties(daxa_Device device) -> daxa_DeviceProperties const *
+{
+    return &device->properties;
+}
+
+auto daxa_dvc_calibrated_timestamps(daxa_Device self, daxa_CalibratedTimestamps * out_timestamps) -> daxa_Result
+{
+    if ((self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS) == 0)
+    {
+        return DAXA_RESULT_ERROR_CALIBRATED_TIMESTAMPS_NOT_SUPPORTED;
+    }
+    std::array<VkCalibratedTimestampInfoKHR, 2> const infos = {
+        VkCalibratedTimestampInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR,
+            .pNext = nullptr,
+            .timeDomain = VK_TIME_DOMAIN_DEVICE_KHR,
+        },
+        VkCalibratedTimestampInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR,
+            .pNext = nullptr,
+            .timeDomain = self->calibration_host_time_domain,
+        },
+    };
+    std::array<u64, 2> timestamps = {};
+    u64 max_deviation_ns = {};
+    auto const vk_result = self->vkGetCalibratedTimestampsKHR(self->vk_device, static_cast<u32>(infos.size()), infos.data(), timestamps.data(), &max_deviation_ns);
+    if (vk_result != VK_SUCCESS)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+    u64 host_ns = timestamps[1];
+    if (self->calibration_host_time_domain == VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_KHR)
+    {
+        // Same split as steady_clock on windows, so the result matches it to the nanosecond without overflowing.
+        u64 const frequency = self->calibration_host_ticks_per_second;
+        host_ns = (timestamps[1] / frequency) * 1'000'000'000ull + (timestamps[1] % frequency) * 1'000'000'000ull / frequency;
+    }
+    *out_timestamps = daxa_CalibratedTimestamps{
+        .device_ticks = timestamps[0],
+        .host_ns = host_ns,
+        .max_deviation_ns = max_deviation_ns,
+    };
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_memory_report(daxa_Device self, daxa_MemoryReport * out_report) -> daxa_Result
+{
+    *out_report = {};
+
+    VkPhysicalDeviceMemoryProperties const * memory_properties = {};
+    vmaGetMemoryProperties(self->vma_allocator, &memory_properties);
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+    vmaGetHeapBudgets(self->vma_allocator, budgets.data());
+    u32 const heap_count = std::min(memory_properties->memoryHeapCount, static_cast<u32>(DAXA_MEMORY_REPORT_MAX_HEAPS));
+    for (u32 heap = 0; heap < heap_count; ++heap)
+    {
+        out_report->heaps.data[heap] = daxa_MemoryHeapReport{
+            .device_local = (memory_properties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+            .size = memory_properties->memoryHeaps[heap].size,
+            .budget = budgets[heap].budget,
+            .usage = budgets[heap].usage,
+            .block_bytes = budgets[heap].statistics.blockBytes,
+            .allocation_bytes = budgets[heap].statistics.allocationBytes,
+        };
+    }
+    out_report->heaps.size = static_cast<_DAXA_FIXED_LIST_SIZE_T>(heap_count);
+    out_report->memory_block_bytes = self->memory_block_bytes.load(std::memory_order_relaxed);
 
-            if (timeline_value >= min_pending_device_timeline_value_of_all_queues)
+    // Keeps the garbage collector from destroying allocations while they are inspected.
+    // Same order as the garbage collection, lifetime lock first.
+    std::shared_lock const lifetime_lock{self->gpu_sro_table.lifetime_lock};
+    std::unique_lock const lock{self->zombies_mtx};
+    auto & largest = out_report->largest_allocations;
+    auto track_allocation = [&](daxa_SmallString const & name, daxa_MemoryReportResourceType type, u64 size)
+    {
+        // Insertion into the small sorted list, the smallest entry falls out when it is full.
+        usize index = largest.size;
+        if (index == DAXA_MEMORY_REPORT_MAX_LARGEST_ALLOCATIONS)
+        {
+            if (largest.data[index - 1].size >= size)
+            {
+                return;
+            }
+            --index;
+        }
+        else
+        {
+            ++largest.size;
+        }
+        while (index > 0 && largest.data[index - 1].size < size)
+        {
+            largest.data[index] = largest.data[index - 1];
+            --index;
+        }
+        largest.data[index] = daxa_MemoryReportAllocation{.name = name, .type = type, .size = size};
+    };
+    auto for_each_slot = [](auto & pool, auto && callback)
+    {
+        using PoolT = std::remove_cvref_t<decltype(pool)>;
+        u32 const slot_count = pool.allocated_count();
+        for (u32 index = 0; index < slot_count; ++index)
+        {
+            // Indices are taken before their page is allocated, pages past the valid count may still be written by a create.
+            usize const page = static_cast<usize>(index) >> PoolT::PAGE_BITS;
+            if (page >= pool.valid_page_count.load(std::memory_order_acquire))
             {
                 break;
             }
+            callback(pool.pages[page]->slots[static_cast<usize>(index) & PoolT::PAGE_MASK]);
+        }
+    };
 
-            cleanup_fn(object);
-            zombies.pop_back();
+    auto track_buffer = [&](ImplBufferSlot const & slot)
+    {
+        if (slot.vk_buffer == VK_NULL_HANDLE)
+        {
+            return;
+        }
+        out_report->buffer_count += 1;
+        if (slot.vma_allocation != nullptr)
+        {
+            VmaAllocationInfo allocation_info = {};
+            vmaGetAllocationInfo(self->vma_allocator, slot.vma_allocation, &allocation_info);
+            out_report->buffer_bytes += allocation_info.size;
+            track_allocation(slot.info.name, DAXA_MEMORY_REPORT_RESOURCE_TYPE_BUFFER, allocation_info.size);
         }
     };
-    check_and_cleanup_gpu_resources(
-        self->buffer_zombies,
-        [&](auto id)
+    auto track_image = [&](ImplImageSlot const & slot)
+    {
+        // Swapchain images are owned by the swapchain, not by daxa allocations.
+        if (slot.vk_image == VK_NULL_HANDLE || slot.swapchain_image_index != NOT_OWNED_BY_SWAPCHAIN)
         {
-            self->cleanup_buffer(id);
-        });
-    check_and_cleanup_gpu_resources(
-        self->image_view_zombies,
-        [&](auto id)
+            return;
+        }
+        out_report->image_count += 1;
+        if (slot.vma_allocation != nullptr)
         {
-            self->cleanup_image_view(id);
-        });
-    check_and_cleanup_gpu_resources(
-        self->image_zombies,
-        [&](auto id)
+            VmaAllocationInfo allocation_info = {};
+            vmaGetAllocationInfo(self->vma_allocator, slot.vma_allocation, &allocation_info);
+            out_report->image_bytes += allocation_info.size;
+            track_allocation(slot.info.name, DAXA_MEMORY_REPORT_RESOURCE_TYPE_IMAGE, allocation_info.size);
+        }
+    };
+    auto track_acceleration_structure = [&](auto const & slot)
+    {
+        if (slot.vk_acceleration_structure != VK_NULL_HANDLE)
         {
-            self->cleanup_image(id);
-        });
-    check_and_cleanup_gpu_resources(
-        self->sampler_zombies,
-        [&](auto id)
+            out_report->acceleration_structure_count += 1;
+            out_report->acceleration_structure_bytes += slot.info.size;
+        }
+    };
+    for_each_slot(self->gpu_sro_table.buffer_slots, track_buffer);
+    for_each_slot(self->gpu_sro_table.image_slots, track_image);
+    for_each_slot(self->gpu_sro_table.tlas_slots, track_acceleration_structure);
+    for_each_slot(self->gpu_sro_table.blas_slots, track_acceleration_structure);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_begin_defragmentation_pass(daxa_Device self, daxa_DefragmentationPassInfo const * info, daxa_u32 * out_move_count) -> daxa_Result
+{
+    *out_move_count = 0;
+    if (info->image_layout == DAXA_IMAGE_LAYOUT_UNDEFINED)
+    {
+        return DAXA_RESULT_ERROR_INVALID_IMAGE_LAYOUT;
+    }
+    std::unique_lock const lock{self->defragmentation_mtx};
+    if (self->defragmentation_pass_open)
+    {
+        return DAXA_RESULT_ERROR_DEFRAGMENTATION_PASS_MISMATCH;
+    }
+    // Keeps the garbage collector from destroying the slots read below.
+    std::shared_lock const lifetime_lock{self->gpu_sro_table.lifetime_lock};
+
+    daxa_Result result = DAXA_RESULT_SUCCESS;
+    if (self->vma_defragmentation_context == nullptr)
+    {
+        VmaDefragmentationInfo const vma_defragmentation_info{
+            .flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT,
+            .pool = nullptr,
+            .maxBytesPerPass = info->max_bytes_per_pass,
+            .maxAllocationsPerPass = info->max_allocations_per_pass,
+        };
+        result = static_cast<daxa_Result>(vmaBeginDefragmentation(self->vma_allocator, &vma_defragmentation_info, &self->vma_defragmentation_context));
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+
+    result = static_cast<daxa_Result>(vmaBeginDefragmentationPass(self->vma_allocator, self->vma_defragmentation_context, &self->vma_defragmentation_pass));
+    if (result != DAXA_RESULT_INCOMPLETE)
+    {
+        // Either there is nothing left to move or the pass failed, both end the defragmentation.
+        vmaEndDefragmentation(self->vma_allocator, self->vma_defragmentation_context, nullptr);
+        self->vma_defragmentation_context = {};
+        self->vma_defragmentation_pass = {};
+        // An empty pass is still open, so that every begin is matched by an end.
+        self->defragmentation_pass_open = result == DAXA_RESULT_SUCCESS;
+        return result;
+    }
+    result = DAXA_RESULT_SUCCESS;
+    self->defragmentation_pass_open = true;
+
+    auto & pass = self->vma_defragmentation_pass;
+    self->defragmentation_moves.clear();
+    self->defragmentation_moves.resize(pass.moveCount);
+    auto const vk_image_layout = static_cast<VkImageLayout>(info->image_layout);
+    std::vector<VkImageMemoryBarrier2> pre_copy_image_barriers = {};
+    std::vector<VkImageMemoryBarrier2> post_copy_image_barriers = {};
+    for (u32 move_index = 0; move_index < pass.moveCount; ++move_index)
+    {
+        auto & vma_move = pass.pMoves[move_index];
+        auto & move = self->defragmentation_moves[move_index];
+        VmaAllocationInfo allocation_info = {};
+        vmaGetAllocationInfo(self->vma_allocator, vma_move.srcAllocation, &allocation_info);
+        auto const user_data = reinterpret_cast<uintptr_t>(allocation_info.pUserData);
+        // Allocations without the movable mark are not owned by movable daxa resources.
+        if ((user_data & 0x1u) == 0)
         {
-            self->cleanup_sampler(id);
-        });
-    check_and_cleanup_gpu_resources(
-        self->tlas_zombies,
-        [&](auto id)
+            vma_move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+        move.slot_index = static_cast<u32>(user_data >> 2);
+        move.is_image = (user_data & 0x2u) != 0;
+        auto const slot_id = GPUResourceId{.index = move.slot_index};
+
+        VkResult vk_result = VK_SUCCESS;
+        if (!move.is_image)
         {
-            self->cleanup_tlas(id);
-        });
-    check_and_cleanup_gpu_resources(
-        self->blas_zombies,
-        [&](auto id)
+            ImplBufferSlot const & slot = self->gpu_sro_table.buffer_slots.unsafe_get(slot_id);
+            VkBufferUsageFlags2CreateInfoKHR vk_usage_flags2 = {};
+            VkBufferCreateInfo const vk_buffer_create_info{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                .pNext = buffer_create_info_pnext(self, slot.info, vk_usage_flags2),
+                .flags = create_buffer_create_flags(slot.info),
+                .size = static_cast<VkDeviceSize>(slot.info.size),
+                .usage = create_buffer_use_flags(self, slot.info),
+                .sharingMode = VK_SHARING_MODE_CONCURRENT,
+                .queueFamilyIndexCount = self->valid_vk_queue_family_count,
+                .pQueueFamilyIndices = self->valid_vk_queue_families.data(),
+            };
+            vk_result = vkCreateBuffer(self->vk_device, &vk_buffer_create_info, nullptr, &move.new_vk_buffer);
+            if (vk_result == VK_SUCCESS)
+            {
+                vk_result = vmaBindBufferMemory(self->vma_allocator, vma_move.dstTmpAllocation, move.new_vk_buffer);
+            }
+        }
+        else
         {
-            self->cleanup_blas(id);
-        });
-    check_and_cleanup_gpu_resources(
-        self->pipeline_zombies,
-        [&](auto & pipeline_zombie)
+            ImplImageSlot const & slot = self->gpu_sro_table.image_slots.unsafe_get(slot_id);
+            ImplVideoProfile video_profile = {};
+            VkImageCreateInfo const vk_image_create_info = initialize_image_create_info_from_image_info(self, slot.info, video_profile);
+            vk_result = vkCreateImage(self->vk_device, &vk_image_create_info, nullptr, &move.new_vk_image);
+            if (vk_result == VK_SUCCESS)
+            {
+                vk_result = vmaBindImageMemory(self->vma_allocator, vma_move.dstTmpAllocation, move.new_vk_image);
+            }
+            if (vk_result == VK_SUCCESS)
+            {
+                VkImageSubresourceRange const subresource_range{
+                    .aspectMask = slot.aspect_flags,
+                    .baseMipLevel = 0,
+                    .levelCount = slot.info.mip_level_count,
+                    .baseArrayLayer = 0,
+                    .layerCount = slot.info.array_layer_count,
+                };
+                auto image_barrier = [&](VkImage vk_image, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags2 src_access, VkAccessFlags2 dst_access)
+                {
+                    return VkImageMemoryBarrier2{
+                        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                        .pNext = nullptr,
+                        .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                        .srcAccessMask = src_access,
+                        .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                        .dstAccessMask = dst_access,
+                        .oldLayout = old_layout,
+                        .newLayout = new_layout,
+                        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .image = vk_image,
+                        .subresourceRange = subresource_range,
+                    };
+                };
+                pre_copy_image_barriers.push_back(image_barrier(slot.vk_image, vk_image_layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_2_MEMORY_WRITE_BIT, VK_ACCESS_2_TRANSFER_READ_BIT));
+                pre_copy_image_barriers.push_back(image_barrier(move.new_vk_image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_2_NONE, VK_ACCESS_2_TRANSFER_WRITE_BIT));
+                post_copy_image_barriers.push_back(image_barrier(move.new_vk_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, vk_image_layout, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT));
+            }
+        }
+        // Resources that can not be recreated simply stay where they are.
+        if (vk_result != VK_SUCCESS)
         {
-            vkDestroyPipeline(self->vk_device, pipeline_zombie.vk_pipeline, nullptr);
-        });
-    check_and_cleanup_gpu_resources(
-        self->semaphore_zombies,
-        [&](auto & semaphore_zombie)
+            if (move.new_vk_buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(self->vk_device, move.new_vk_buffer, nullptr);
+            }
+            if (move.new_vk_image != VK_NULL_HANDLE)
+            {
+                vkDestroyImage(self->vk_device, move.new_vk_image, nullptr);
+            }
+            move = {};
+            vma_move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+        *out_move_count += 1;
+    }
+
+    if (*out_move_count == 0)
+    {
+        return result;
+    }
+
+    daxa_CommandRecorder cmd = info->command_recorder;
+    daxa_cmd_flush_barriers(cmd);
+    // Prior commands in the recorder may still write the old allocations.
+    VkMemoryBarrier2 const all_commands_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+        .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+    };
+    VkDependencyInfo const pre_copy_dependency_info{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .pNext = nullptr,
+        .dependencyFlags = {},
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &all_commands_barrier,
+        .bufferMemoryBarrierCount = 0,
+        .pBufferMemoryBarriers = nullptr,
+        .imageMemoryBarrierCount = static_cast<u32>(pre_copy_image_barriers.size()),
+        .pImageMemoryBarriers = pre_copy_image_barriers.data(),
+    };
+    vkCmdPipelineBarrier2(cmd->current_command_data.vk_cmd_buffer, &pre_copy_dependency_info);
+
+    std::vector<VkImageCopy> mip_copies = {};
+    for (u32 move_index = 0; move_index < pass.moveCount; ++move_index)
+    {
+        auto const & move = self->defragmentation_moves[move_index];
+        auto const slot_id = GPUResourceId{.index = move.slot_index};
+        if (move.new_vk_buffer != VK_NULL_HANDLE)
         {
-            vkDestroySemaphore(self->vk_device, semaphore_zombie.vk_semaphore, nullptr);
-        });
-    check_and_cleanup_gpu_resources(
-        self->split_barrier_zombies,
-        [&](auto & split_barrier_zombie)
+            ImplBufferSlot const & slot = self->gpu_sro_table.buffer_slots.unsafe_get(slot_id);
+            VkBufferCopy const region{
+                .srcOffset = 0,
+                .dstOffset = 0,
+                .size = static_cast<VkDeviceSize>(slot.info.size),
+            };
+            vkCmdCopyBuffer(cmd->current_command_data.vk_cmd_buffer, slot.vk_buffer, move.new_vk_buffer, 1, &region);
+        }
+        else if (move.new_vk_image != VK_NULL_HANDLE)
         {
-            vkDestroyEvent(self->vk_device, split_barrier_zombie.vk_event, nullptr);
-        });
-    check_and_cleanup_gpu_resources(
-        self->timeline_query_pool_zombies,
-        [&](auto & timeline_query_pool_zombie)
+            ImplImageSlot const & slot = self->gpu_sro_table.image_slots.unsafe_get(slot_id);
+            mip_copies.clear();
+            for (u32 mip = 0; mip < slot.info.mip_level_count; ++mip)
+            {
+                VkImageSubresourceLayers const subresource{
+                    .aspectMask = slot.aspect_flags,
+                    .mipLevel = mip,
+                    .baseArrayLayer = 0,
+                    .layerCount = slot.info.array_layer_count,
+                };
+                mip_copies.push_back(VkImageCopy{
+                    .srcSubresource = subresource,
+                    .srcOffset = {},
+                    .dstSubresource = subresource,
+                    .dstOffset = {},
+                    .extent = {
+                        .width = std::max(slot.info.size.width >> mip, 1u),
+                        .height = std::max(slot.info.size.height >> mip, 1u),
+                        .depth = std::max(slot.info.size.depth >> mip, 1u),
+                    },
+                });
+            }
+            vkCmdCopyImage(
+                cmd->current_command_data.vk_cmd_buffer,
+                slot.vk_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                move.new_vk_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<u32>(mip_copies.size()), mip_copies.data());
+        }
+    }
+
+    // Later commands in the recorder may already use the new allocations.
+    // The old images stay in the transfer layout, they are destroyed by the end of the pass.
+    VkDependencyInfo const post_copy_dependency_info{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .pNext = nullptr,
+        .dependencyFlags = {},
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &all_commands_barrier,
+        .bufferMemoryBarrierCount = 0,
+        .pBufferMemoryBarriers = nullptr,
+        .imageMemoryBarrierCount = static_cast<u32>(post_copy_image_barriers.size()),
+        .pImageMemoryBarriers = post_copy_image_barriers.data(),
+    };
+    vkCmdPipelineBarrier2(cmd->current_command_data.vk_cmd_buffer, &post_copy_dependency_info);
+    return result;
+}
+
+auto daxa_dvc_end_defragmentation_pass(daxa_Device self) -> daxa_Result
+{
+    std::unique_lock const lock{self->defragmentation_mtx};
+    if (!self->defragmentation_pass_open)
+    {
+        return DAXA_RESULT_ERROR_DEFRAGMENTATION_PASS_MISMATCH;
+    }
+    self->defragmentation_pass_open = false;
+    if (self->vma_defragmentation_context == nullptr)
+    {
+        return DAXA_RESULT_SUCCESS;
+    }
+    // Keeps the garbage collector from destroying the slots walked and rewritten below.
+    std::shared_lock const lifetime_lock{self->gpu_sro_table.lifetime_lock};
+
+    auto & pass = self->vma_defragmentation_pass;
+    auto & image_slots = self->gpu_sro_table.image_slots;
+    std::vector<u32> moved_image_indices = {};
+    for (auto const & move : self->defragmentation_moves)
+    {
+        if (move.new_vk_image != VK_NULL_HANDLE)
         {
-            vkDestroyQueryPool(self->vk_device, timeline_query_pool_zombie.vk_timeline_query_pool, nullptr);
-        });
-    check_and_cleanup_gpu_resources(
-        self->memory_block_zombies,
-        [&](auto & memory_block_zombie)
+            moved_image_indices.push_back(move.slot_index);
+        }
+    }
+    std::sort(moved_image_indices.begin(), moved_image_indices.end());
+
+    // Views created with daxa_dvc_create_image_view on moved images are recreated as well.
+    // Image view slots have no image of their own.
+    std::vector<u32> moved_image_view_indices = {};
+    if (!moved_image_indices.empty())
+    {
+        using ImagePool = std::remove_cvref_t<decltype(image_slots)>;
+        u32 const slot_count = image_slots.allocated_count();
+        for (u32 index = 0; index < slot_count; ++index)
         {
-            vmaFreeMemory(self->vma_allocator, memory_block_zombie.allocation);
-        });
+            // Pages past the valid count may still be allocated by a concurrent creation.
+            usize const page_index = static_cast<usize>(index) >> ImagePool::PAGE_BITS;
+            if (page_index >= image_slots.valid_page_count.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+            auto const & page = image_slots.pages[page_index];
+            ImplImageSlot & slot = page->slots[static_cast<usize>(index) & ImagePool::PAGE_MASK];
+            u32 const parent_index = static_cast<u32>(std::bit_cast<GPUResourceId>(slot.view_slot.info.image).index);
+            if (slot.vk_image == VK_NULL_HANDLE &&
+                slot.view_slot.vk_image_view != VK_NULL_HANDLE &&
+                std::binary_search(moved_image_indices.begin(), moved_image_indices.end(), parent_index))
+            {
+                vkDestroyImageView(self->vk_device, slot.view_slot.vk_image_view, nullptr);
+                slot.view_slot.vk_image_view = {};
+                moved_image_view_indices.push_back(index);
+            }
+        }
+    }
+
+    for (auto const & move : self->defragmentation_moves)
+    {
+        auto const slot_id = GPUResourceId{.index = move.slot_index};
+        if (move.new_vk_buffer != VK_NULL_HANDLE)
+        {
+            ImplBufferSlot & slot = self->gpu_sro_table.buffer_slots.unsafe_get_reserved_slot(slot_id);
+            vkDestroyBuffer(self->vk_device, slot.vk_buffer, nullptr);
+            slot.vk_buffer = move.new_vk_buffer;
+        }
+        else if (move.new_vk_image != VK_NULL_HANDLE)
+        {
+            ImplImageSlot & slot = image_slots.unsafe_get_reserved_slot(slot_id);
+            vkDestroyImageView(self->vk_device, slot.view_slot.vk_image_view, nullptr);
+            slot.view_slot.vk_image_view = {};
+            vkDestroyImage(self->vk_device, slot.vk_image, nullptr);
+            slot.vk_image = move.new_vk_image;
+        }
+    }
+
+    // Moved allocations now point to their new memory.
+    daxa_Result result = static_cast<daxa_Result>(vmaEndDefragmentationPass(self->vma_allocator, self->vma_defragmentation_context, &pass));
+    daxa_Result const pass_result = result;
+
+    auto recreate_image_view = [&](ImplImageViewSlot & view_slot, ImplImageSlot const & image_slot, VkImageViewType vk_image_view_type, u32 index)
+    {
+        VkImageViewCreateInfo const vk_image_view_create_info{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = {},
+            .image = image_slot.vk_image,
+            .viewType = vk_image_view_type,
+            .format = *r_cast<VkFormat const *>(&view_slot.info.format),
+            .components = VkComponentMapping{
+                .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .a = VK_COMPONENT_SWIZZLE_IDENTITY,
+            },
+            .subresourceRange = make_subresource_range(view_slot.info.slice, image_slot.aspect_flags),
+        };
+        auto const view_result = static_cast<daxa_Result>(vkCreateImageView(self->vk_device, &vk_image_view_create_info, nullptr, &view_slot.vk_image_view));
+        if (view_result != DAXA_RESULT_SUCCESS)
+        {
+            result = DAXA_RESULT_FAILED_TO_CREATE_IMAGE_VIEW;
+            return;
+        }
+        write_descriptor_set_image(
+            self->vk_device,
+            self->gpu_sro_table,
+            view_slot.vk_image_view,
+            std::bit_cast<ImageUsageFlags>(image_slot.info.usage),
+            index);
+    };
+
+    for (auto const & move : self->defragmentation_moves)
     {
-        std::unique_lock const main_queue_lock{self->command_pool_pools[DAXA_QUEUE_FAMILY_MAIN].mtx};
-        std::unique_lock const compute_queue_lock{self->command_pool_pools[DAXA_QUEUE_FAMILY_COMPUTE].mtx};
-        std::unique_lock const transfer_queue_lock{self->command_pool_pools[DAXA_QUEUE_FAMILY_TRANSFER].mtx};
-        while (!self->command_list_zombies.empty())
+        auto const slot_id = GPUResourceId{.index = move.slot_index};
+        if (move.new_vk_buffer != VK_NULL_HANDLE)
         {
-            auto & [timeline_value, zombie] = self->command_list_zombies.back();
-
-            // Zombies are sorted. When we see a single zombie that is too young, we can dismiss the rest as they are the same age or even younger.
-            if (timeline_value >= min_pending_device_timeline_value_of_all_queues)
+            ImplBufferSlot & slot = self->gpu_sro_table.buffer_slots.unsafe_get_reserved_slot(slot_id);
+            VkBufferDeviceAddressInfo const vk_buffer_device_address_info{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .pNext = nullptr,
+                .buffer = slot.vk_buffer,
+            };
+            slot.device_address = vkGetBufferDeviceAddress(self->vk_device, &vk_buffer_device_address_info);
+            if (slot.host_address != nullptr)
             {
-                break;
+                VmaAllocationInfo allocation_info = {};
+                vmaGetAllocationInfo(self->vma_allocator, slot.vma_allocation, &allocation_info);
+                slot.host_address = allocation_info.pMappedData;
             }
-
-            vkFreeCommandBuffers(self->vk_device, zombie.vk_cmd_pool, static_cast<u32>(zombie.allocated_command_buffers.size()), zombie.allocated_command_buffers.data());
-            auto result = static_cast<daxa_Result>(vkResetCommandPool(self->vk_device, zombie.vk_cmd_pool, {}));
-            _DAXA_RETURN_IF_ERROR(result, result)
-
-            self->command_pool_pools[zombie.queue_family].put_back(zombie.vk_cmd_pool);
-            self->command_list_zombies.pop_back();
+            self->buffer_device_address_buffer_host_ptr[move.slot_index] = slot.device_address;
+            self->gpu_sro_table.buffer_slots.unsafe_get_hot_mut(slot_id) = ImplBufferHotSlot{
+                .device_address = slot.device_address,
+                .host_address = slot.host_address,
+            };
+            write_descriptor_set_buffer(
+                self->vk_device,
+                self->gpu_sro_table,
+                slot.vk_buffer,
+                0,
+                static_cast<VkDeviceSize>(slot.info.size),
+                move.slot_index);
+        }
+        else if (move.new_vk_image != VK_NULL_HANDLE)
+        {
+            ImplImageSlot & slot = image_slots.unsafe_get_reserved_slot(slot_id);
+            auto const vk_image_view_type = slot.info.array_layer_count > 1
+                                                ? static_cast<VkImageViewType>(slot.info.dimensions + 3)
+                                                : static_cast<VkImageViewType>(slot.info.dimensions - 1);
+            recreate_image_view(slot.view_slot, slot, vk_image_view_type, move.slot_index);
         }
     }
-    return DAXA_RESULT_SUCCESS;
-}
 
-auto daxa_dvc_properties(daxa_Device device) -> daxa_DeviceProperties const *
-{
-    return &device->properties;
+    for (u32 const index : moved_image_view_indices)
+    {
+        ImplImageSlot & slot = image_slots.unsafe_get_reserved_slot(GPUResourceId{.index = index});
+        ImplImageSlot const & parent_slot = image_slots.unsafe_get(std::bit_cast<GPUResourceId>(slot.view_slot.info.image));
+        recreate_image_view(slot.view_slot, parent_slot, static_cast<VkImageViewType>(slot.view_slot.info.type), index);
+    }
+
+    self->defragmentation_moves.clear();
+    if (pass_result != DAXA_RESULT_INCOMPLETE)
+    {
+        vmaEndDefragmentation(self->vma_allocator, self->vma_defragmentation_context, nullptr);
+        self->vma_defragmentation_context = {};
+        self->vma_defragmentation_pass = {};
+    }
+    return result;
 }
 
 auto daxa_dvc_inc_refcnt(daxa_Device self) -> u64
@@ -1377,6 +3357,12 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
     self->properties = properties;
     self->instance = instance;
     self->info = std::bit_cast<DeviceInfo2>(info);
+    // The info only borrows the string, the device keeps its own copy.
+    if (info.pipeline_cache_directory != nullptr)
+    {
+        self->pipeline_cache_directory = info.pipeline_cache_directory;
+        self->info.pipeline_cache_directory = self->pipeline_cache_directory.c_str();
+    }
 
     // Verify DeviceOptions:
     if (self->info.max_allowed_buffers > self->properties.limits.max_descriptor_set_storage_buffers || self->info.max_allowed_buffers == 0)
@@ -1410,15 +3396,10 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
 
     // Queue Selection and Verification
     u32 vk_queue_request_count = {};
-    std::array<VkDeviceQueueCreateInfo, 3> queues_ci = {};
+    std::array<VkDeviceQueueCreateInfo, QUEUE_FAMILY_COUNT> queues_ci = {};
     {
-        u32 queue_family_props_count = 0;
-        std::vector<VkQueueFamilyProperties> queue_props;
-        vkGetPhysicalDeviceQueueFamilyProperties(self->vk_physical_device, &queue_family_props_count, nullptr);
-        queue_props.resize(queue_family_props_count);
-        vkGetPhysicalDeviceQueueFamilyProperties(self->vk_physical_device, &queue_family_props_count, queue_props.data());
-        std::vector<VkBool32> supports_present;
-        supports_present.resize(queue_family_props_count);
+        auto const & queue_props = physical_device.queue_family_properties;
+        u32 const queue_family_props_count = static_cast<u32>(queue_props.size());
 
         // SELECT QUEUE FAMILIES
         struct QueueRequest
@@ -1426,7 +3407,7 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             u32 vk_family_index;
             u32 count;
         };
-        std::array<QueueRequest, 3> vk_queue_requests = {};
+        std::array<QueueRequest, QUEUE_FAMILY_COUNT> vk_queue_requests = {};
         for (u32 i = 0; i < queue_family_props_count; i++)
         {
             bool const supports_graphics = queue_props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT;
@@ -1436,6 +3417,7 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             {
                 self->queue_families[DAXA_QUEUE_FAMILY_MAIN].vk_index = i;
                 self->queue_families[DAXA_QUEUE_FAMILY_MAIN].queue_count = 1;
+                self->queue_families[DAXA_QUEUE_FAMILY_MAIN].supports_sparse_binding = (queue_props[i].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0;
                 self->command_pool_pools[DAXA_QUEUE_FAMILY_MAIN].queue_family_index = i;
                 self->valid_vk_queue_families[self->valid_vk_queue_family_count++] = i;
                 vk_queue_requests[vk_queue_request_count++] = QueueRequest{i, 1};
@@ -1444,19 +3426,48 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             {
                 self->queue_families[DAXA_QUEUE_FAMILY_COMPUTE].vk_index = i;
                 self->queue_families[DAXA_QUEUE_FAMILY_COMPUTE].queue_count = std::min(queue_props[i].queueCount, DAXA_MAX_COMPUTE_QUEUE_COUNT);
+                self->queue_families[DAXA_QUEUE_FAMILY_COMPUTE].supports_sparse_binding = (queue_props[i].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0;
                 self->command_pool_pools[DAXA_QUEUE_FAMILY_COMPUTE].queue_family_index = i;
                 self->valid_vk_queue_families[self->valid_vk_queue_family_count++] = i;
                 vk_queue_requests[vk_queue_request_count++] = QueueRequest{i, self->queue_families[DAXA_QUEUE_FAMILY_COMPUTE].queue_count};
             }
-            if (self->queue_families[DAXA_QUEUE_FAMILY_TRANSFER].vk_index == ~0u && !supports_graphics && !supports_compute && supports_transfer)
+            if (self->queue_families[DAXA_QUEUE_FAMILY_TRANSFER].vk_index == ~0u && is_dedicated_transfer_queue_family(queue_props[i]))
             {
                 self->queue_families[DAXA_QUEUE_FAMILY_TRANSFER].vk_index = i;
                 self->queue_families[DAXA_QUEUE_FAMILY_TRANSFER].queue_count = std::min(queue_props[i].queueCount, DAXA_MAX_TRANSFER_QUEUE_COUNT);
+                self->queue_families[DAXA_QUEUE_FAMILY_TRANSFER].supports_sparse_binding = (queue_props[i].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0;
                 self->command_pool_pools[DAXA_QUEUE_FAMILY_TRANSFER].queue_family_index = i;
                 self->valid_vk_queue_families[self->valid_vk_queue_family_count++] = i;
                 vk_queue_requests[vk_queue_request_count++] = QueueRequest{i, self->queue_families[DAXA_QUEUE_FAMILY_TRANSFER].queue_count};
             }
         }
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO)
+        {
+            struct VideoFamily
+            {
+                daxa_QueueFamily family;
+                VkQueueFlagBits vk_flag;
+                u32 max_queue_count;
+            };
+            for (auto const [family, vk_flag, max_queue_count] : std::array{
+                     VideoFamily{DAXA_QUEUE_FAMILY_VIDEO_DECODE, VK_QUEUE_VIDEO_DECODE_BIT_KHR, DAXA_MAX_VIDEO_DECODE_QUEUE_COUNT},
+                     VideoFamily{DAXA_QUEUE_FAMILY_VIDEO_ENCODE, VK_QUEUE_VIDEO_ENCODE_BIT_KHR, DAXA_MAX_VIDEO_ENCODE_QUEUE_COUNT},
+                 })
+            {
+                u32 const i = find_video_queue_family(queue_props, physical_device.queue_family_video_properties, vk_flag);
+                // Families exposing decode and encode are only used for decoding.
+                if (i == ~0u || i == self->queue_families[DAXA_QUEUE_FAMILY_VIDEO_DECODE].vk_index)
+                {
+                    continue;
+                }
+                self->queue_families[family].vk_index = i;
+                self->queue_families[family].queue_count = std::min(queue_props[i].queueCount, max_queue_count);
+                self->queue_families[family].supports_sparse_binding = (queue_props[i].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0;
+                self->command_pool_pools[family].queue_family_index = i;
+                self->valid_vk_queue_families[self->valid_vk_queue_family_count++] = i;
+                vk_queue_requests[vk_queue_request_count++] = QueueRequest{i, self->queue_families[family].queue_count};
+            }
+        }
 
         if (self->queue_families[DAXA_QUEUE_FAMILY_MAIN].vk_index == ~0u)
         {
@@ -1483,9 +3494,18 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
     enabled_features.initialize(physical_device.extensions);
     fill_create_features(enabled_features, properties.implicit_features, info.explicit_features);
 
+    // Memory allocations of a device group get one instance per physical device, all other objects are shared.
+    self->device_group_size = info.device_group != 0 ? static_cast<u32>(physical_device.device_group.size()) : 1u;
+    VkDeviceGroupDeviceCreateInfo const device_group_ci = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO,
+        .pNext = r_cast<void const *>(&enabled_features.physical_device_features_2),
+        .physicalDeviceCount = self->device_group_size,
+        .pPhysicalDevices = physical_device.device_group.data(),
+    };
+
     VkDeviceCreateInfo const device_ci = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext = r_cast<void const *>(&enabled_features.physical_device_features_2),
+        .pNext = self->device_group_size > 1 ? r_cast<void const *>(&device_group_ci) : r_cast<void const *>(&enabled_features.physical_device_features_2),
         .flags = {},
         .queueCreateInfoCount = static_cast<u32>(vk_queue_request_count),
         .pQueueCreateInfos = queues_ci.data(),
@@ -1505,6 +3525,34 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
         }
     };
 
+    // Pipeline cache initialization:
+    {
+        auto const initial_data = self->pipeline_cache_directory.empty() ? std::vector<std::byte>{} : read_pipeline_cache_file(self);
+        VkPipelineCacheCreateInfo vk_pipeline_cache_create_info{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = {},
+            .initialDataSize = initial_data.size(),
+            .pInitialData = initial_data.data(),
+        };
+        result = static_cast<daxa_Result>(vkCreatePipelineCache(self->vk_device, &vk_pipeline_cache_create_info, nullptr, &self->vk_pipeline_cache));
+        if (result != DAXA_RESULT_SUCCESS && !initial_data.empty())
+        {
+            // A cache the driver refuses is not an error, compilation just starts cold.
+            vk_pipeline_cache_create_info.initialDataSize = 0;
+            vk_pipeline_cache_create_info.pInitialData = nullptr;
+            result = static_cast<daxa_Result>(vkCreatePipelineCache(self->vk_device, &vk_pipeline_cache_create_info, nullptr, &self->vk_pipeline_cache));
+        }
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+    defer
+    {
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            vkDestroyPipelineCache(self->vk_device, self->vk_pipeline_cache, nullptr);
+        }
+    };
+
     // Queue initialization:
     defer
     {
@@ -1548,6 +3596,154 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             self->vkCmdDrawMeshTasksIndirectCountEXT = r_cast<PFN_vkCmdDrawMeshTasksIndirectCountEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdDrawMeshTasksIndirectCountEXT"));
         }
 
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW)
+        {
+            self->vkCmdDrawMultiEXT = r_cast<PFN_vkCmdDrawMultiEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdDrawMultiEXT"));
+            self->vkCmdDrawMultiIndexedEXT = r_cast<PFN_vkCmdDrawMultiIndexedEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdDrawMultiIndexedEXT"));
+            self->multi_draw_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT;
+            VkPhysicalDeviceProperties2 vk_properties2 = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &self->multi_draw_properties,
+                .properties = {},
+            };
+            vkGetPhysicalDeviceProperties2(self->vk_physical_device, &vk_properties2);
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS)
+        {
+            self->vkCreateIndirectCommandsLayoutEXT = r_cast<PFN_vkCreateIndirectCommandsLayoutEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCreateIndirectCommandsLayoutEXT"));
+            self->vkDestroyIndirectCommandsLayoutEXT = r_cast<PFN_vkDestroyIndirectCommandsLayoutEXT>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyIndirectCommandsLayoutEXT"));
+            self->vkCreateIndirectExecutionSetEXT = r_cast<PFN_vkCreateIndirectExecutionSetEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCreateIndirectExecutionSetEXT"));
+            self->vkDestroyIndirectExecutionSetEXT = r_cast<PFN_vkDestroyIndirectExecutionSetEXT>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyIndirectExecutionSetEXT"));
+            self->vkUpdateIndirectExecutionSetPipelineEXT = r_cast<PFN_vkUpdateIndirectExecutionSetPipelineEXT>(vkGetDeviceProcAddr(self->vk_device, "vkUpdateIndirectExecutionSetPipelineEXT"));
+            self->vkGetGeneratedCommandsMemoryRequirementsEXT = r_cast<PFN_vkGetGeneratedCommandsMemoryRequirementsEXT>(vkGetDeviceProcAddr(self->vk_device, "vkGetGeneratedCommandsMemoryRequirementsEXT"));
+            self->vkCmdExecuteGeneratedCommandsEXT = r_cast<PFN_vkCmdExecuteGeneratedCommandsEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdExecuteGeneratedCommandsEXT"));
+            self->device_generated_commands_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEVICE_GENERATED_COMMANDS_PROPERTIES_EXT;
+            VkPhysicalDeviceProperties2 vk_properties2 = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &self->device_generated_commands_properties,
+                .properties = {},
+            };
+            vkGetPhysicalDeviceProperties2(self->vk_physical_device, &vk_properties2);
+            self->buffer_usage_flags2_info = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_USAGE_FLAGS_2_CREATE_INFO_KHR,
+                .pNext = nullptr,
+                .usage = static_cast<VkBufferUsageFlags2KHR>(create_buffer_use_flags(self)) | VK_BUFFER_USAGE_2_PREPROCESS_BUFFER_BIT_EXT,
+            };
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_BINARY)
+        {
+            self->vkCreatePipelineBinariesKHR = r_cast<PFN_vkCreatePipelineBinariesKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCreatePipelineBinariesKHR"));
+            self->vkDestroyPipelineBinaryKHR = r_cast<PFN_vkDestroyPipelineBinaryKHR>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyPipelineBinaryKHR"));
+            self->vkGetPipelineKeyKHR = r_cast<PFN_vkGetPipelineKeyKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetPipelineKeyKHR"));
+            self->vkGetPipelineBinaryDataKHR = r_cast<PFN_vkGetPipelineBinaryDataKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetPipelineBinaryDataKHR"));
+            self->vkReleaseCapturedPipelineDataKHR = r_cast<PFN_vkReleaseCapturedPipelineDataKHR>(vkGetDeviceProcAddr(self->vk_device, "vkReleaseCapturedPipelineDataKHR"));
+            self->pipeline_binary_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_BINARY_PROPERTIES_KHR;
+            VkPhysicalDeviceProperties2 vk_properties2 = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &self->pipeline_binary_properties,
+                .properties = {},
+            };
+            vkGetPhysicalDeviceProperties2(self->vk_physical_device, &vk_properties2);
+            // Binaries only pay off when they are persisted and the driver does not already hold them in its own cache.
+            self->pipeline_binary_archive.enabled = !self->pipeline_cache_directory.empty() && !self->pipeline_binary_properties.pipelineBinaryPrefersInternalCache;
+            if (self->pipeline_binary_archive.enabled)
+            {
+                auto const archive_data = read_binary_file(self->pipeline_cache_file_path(PIPELINE_BINARY_ARCHIVE_FILE_PREFIX));
+                self->pipeline_binary_archive.deserialize(archive_data, self->properties.pipeline_cache_uuid);
+            }
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_GRAPHICS_PIPELINE_LIBRARY)
+        {
+            self->graphics_pipeline_library_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+            VkPhysicalDeviceProperties2 vk_properties2 = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &self->graphics_pipeline_library_properties,
+                .properties = {},
+            };
+            vkGetPhysicalDeviceProperties2(self->vk_physical_device, &vk_properties2);
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT)
+        {
+            self->vkCreateShadersEXT = r_cast<PFN_vkCreateShadersEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCreateShadersEXT"));
+            self->vkDestroyShaderEXT = r_cast<PFN_vkDestroyShaderEXT>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyShaderEXT"));
+            self->vkCmdBindShadersEXT = r_cast<PFN_vkCmdBindShadersEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdBindShadersEXT"));
+            self->vkCmdSetPolygonModeEXT = r_cast<PFN_vkCmdSetPolygonModeEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetPolygonModeEXT"));
+            self->vkCmdSetSampleMaskEXT = r_cast<PFN_vkCmdSetSampleMaskEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetSampleMaskEXT"));
+            self->vkCmdSetAlphaToCoverageEnableEXT = r_cast<PFN_vkCmdSetAlphaToCoverageEnableEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetAlphaToCoverageEnableEXT"));
+            self->vkCmdSetColorBlendEnableEXT = r_cast<PFN_vkCmdSetColorBlendEnableEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetColorBlendEnableEXT"));
+            self->vkCmdSetColorBlendEquationEXT = r_cast<PFN_vkCmdSetColorBlendEquationEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetColorBlendEquationEXT"));
+            self->vkCmdSetColorWriteMaskEXT = r_cast<PFN_vkCmdSetColorWriteMaskEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetColorWriteMaskEXT"));
+            self->vkCmdSetDepthClampEnableEXT = r_cast<PFN_vkCmdSetDepthClampEnableEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetDepthClampEnableEXT"));
+            self->vkCmdSetVertexInputEXT = r_cast<PFN_vkCmdSetVertexInputEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetVertexInputEXT"));
+            self->vkCmdSetPatchControlPointsEXT = r_cast<PFN_vkCmdSetPatchControlPointsEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetPatchControlPointsEXT"));
+            self->vkCmdSetTessellationDomainOriginEXT = r_cast<PFN_vkCmdSetTessellationDomainOriginEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetTessellationDomainOriginEXT"));
+            self->vkCmdSetConservativeRasterizationModeEXT = r_cast<PFN_vkCmdSetConservativeRasterizationModeEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetConservativeRasterizationModeEXT"));
+            self->vkCmdSetExtraPrimitiveOverestimationSizeEXT = r_cast<PFN_vkCmdSetExtraPrimitiveOverestimationSizeEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetExtraPrimitiveOverestimationSizeEXT"));
+            // Also provided by VK_EXT_shader_object, so it is available without dynamic state 3.
+            if (self->vkCmdSetRasterizationSamplesEXT == nullptr)
+            {
+                self->vkCmdSetRasterizationSamplesEXT = r_cast<PFN_vkCmdSetRasterizationSamplesEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetRasterizationSamplesEXT"));
+            }
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING)
+        {
+            self->vkCmdBeginConditionalRenderingEXT = r_cast<PFN_vkCmdBeginConditionalRenderingEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdBeginConditionalRenderingEXT"));
+            self->vkCmdEndConditionalRenderingEXT = r_cast<PFN_vkCmdEndConditionalRenderingEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdEndConditionalRenderingEXT"));
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_DECOMPRESSION)
+        {
+            self->vkCmdDecompressMemoryNV = r_cast<PFN_vkCmdDecompressMemoryNV>(vkGetDeviceProcAddr(self->vk_device, "vkCmdDecompressMemoryNV"));
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_PRESENT_WAIT)
+        {
+            self->vkWaitForPresentKHR = r_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(self->vk_device, "vkWaitForPresentKHR"));
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_LOW_LATENCY)
+        {
+            self->vkSetLatencySleepModeNV = r_cast<PFN_vkSetLatencySleepModeNV>(vkGetDeviceProcAddr(self->vk_device, "vkSetLatencySleepModeNV"));
+            self->vkLatencySleepNV = r_cast<PFN_vkLatencySleepNV>(vkGetDeviceProcAddr(self->vk_device, "vkLatencySleepNV"));
+            self->vkSetLatencyMarkerNV = r_cast<PFN_vkSetLatencyMarkerNV>(vkGetDeviceProcAddr(self->vk_device, "vkSetLatencyMarkerNV"));
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING)
+        {
+            self->vkGetRefreshCycleDurationGOOGLE = r_cast<PFN_vkGetRefreshCycleDurationGOOGLE>(vkGetDeviceProcAddr(self->vk_device, "vkGetRefreshCycleDurationGOOGLE"));
+            self->vkGetPastPresentationTimingGOOGLE = r_cast<PFN_vkGetPastPresentationTimingGOOGLE>(vkGetDeviceProcAddr(self->vk_device, "vkGetPastPresentationTimingGOOGLE"));
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS)
+        {
+            self->vkGetCalibratedTimestampsKHR = r_cast<PFN_vkGetCalibratedTimestampsKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetCalibratedTimestampsKHR"));
+            self->calibration_host_time_domain = physical_device.calibration_host_time_domain;
+#if defined(_WIN32)
+            LARGE_INTEGER frequency = {};
+            QueryPerformanceFrequency(&frequency);
+            self->calibration_host_ticks_per_second = static_cast<u64>(frequency.QuadPart);
+#endif
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_EXTERNAL_MEMORY)
+        {
+#if defined(_WIN32)
+            self->vkGetMemoryWin32HandleKHR = r_cast<PFN_vkGetMemoryWin32HandleKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetMemoryWin32HandleKHR"));
+            self->vkGetSemaphoreWin32HandleKHR = r_cast<PFN_vkGetSemaphoreWin32HandleKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetSemaphoreWin32HandleKHR"));
+            self->vkImportSemaphoreWin32HandleKHR = r_cast<PFN_vkImportSemaphoreWin32HandleKHR>(vkGetDeviceProcAddr(self->vk_device, "vkImportSemaphoreWin32HandleKHR"));
+#else
+            self->vkGetMemoryFdKHR = r_cast<PFN_vkGetMemoryFdKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetMemoryFdKHR"));
+            self->vkGetMemoryFdPropertiesKHR = r_cast<PFN_vkGetMemoryFdPropertiesKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetMemoryFdPropertiesKHR"));
+            self->vkGetSemaphoreFdKHR = r_cast<PFN_vkGetSemaphoreFdKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetSemaphoreFdKHR"));
+            self->vkImportSemaphoreFdKHR = r_cast<PFN_vkImportSemaphoreFdKHR>(vkGetDeviceProcAddr(self->vk_device, "vkImportSemaphoreFdKHR"));
+#endif
+        }
+
         if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING)
         {
             self->vkGetAccelerationStructureBuildSizesKHR = r_cast<PFN_vkGetAccelerationStructureBuildSizesKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetAccelerationStructureBuildSizesKHR"));
@@ -1555,9 +3751,33 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             self->vkDestroyAccelerationStructureKHR = r_cast<PFN_vkDestroyAccelerationStructureKHR>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyAccelerationStructureKHR"));
             self->vkCmdWriteAccelerationStructuresPropertiesKHR = r_cast<PFN_vkCmdWriteAccelerationStructuresPropertiesKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdWriteAccelerationStructuresPropertiesKHR"));
             self->vkCmdBuildAccelerationStructuresKHR = r_cast<PFN_vkCmdBuildAccelerationStructuresKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdBuildAccelerationStructuresKHR"));
+            self->vkCmdCopyAccelerationStructureKHR = r_cast<PFN_vkCmdCopyAccelerationStructureKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdCopyAccelerationStructureKHR"));
             self->vkGetAccelerationStructureDeviceAddressKHR = r_cast<PFN_vkGetAccelerationStructureDeviceAddressKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetAccelerationStructureDeviceAddressKHR"));
         }
 
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP)
+        {
+            self->vkCreateMicromapEXT = r_cast<PFN_vkCreateMicromapEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCreateMicromapEXT"));
+            self->vkDestroyMicromapEXT = r_cast<PFN_vkDestroyMicromapEXT>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyMicromapEXT"));
+            self->vkCmdBuildMicromapsEXT = r_cast<PFN_vkCmdBuildMicromapsEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdBuildMicromapsEXT"));
+            self->vkGetMicromapBuildSizesEXT = r_cast<PFN_vkGetMicromapBuildSizesEXT>(vkGetDeviceProcAddr(self->vk_device, "vkGetMicromapBuildSizesEXT"));
+        }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO)
+        {
+            self->vkCreateVideoSessionKHR = r_cast<PFN_vkCreateVideoSessionKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCreateVideoSessionKHR"));
+            self->vkDestroyVideoSessionKHR = r_cast<PFN_vkDestroyVideoSessionKHR>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyVideoSessionKHR"));
+            self->vkGetVideoSessionMemoryRequirementsKHR = r_cast<PFN_vkGetVideoSessionMemoryRequirementsKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetVideoSessionMemoryRequirementsKHR"));
+            self->vkBindVideoSessionMemoryKHR = r_cast<PFN_vkBindVideoSessionMemoryKHR>(vkGetDeviceProcAddr(self->vk_device, "vkBindVideoSessionMemoryKHR"));
+            self->vkCreateVideoSessionParametersKHR = r_cast<PFN_vkCreateVideoSessionParametersKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCreateVideoSessionParametersKHR"));
+            self->vkDestroyVideoSessionParametersKHR = r_cast<PFN_vkDestroyVideoSessionParametersKHR>(vkGetDeviceProcAddr(self->vk_device, "vkDestroyVideoSessionParametersKHR"));
+            self->vkCmdBeginVideoCodingKHR = r_cast<PFN_vkCmdBeginVideoCodingKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdBeginVideoCodingKHR"));
+            self->vkCmdEndVideoCodingKHR = r_cast<PFN_vkCmdEndVideoCodingKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdEndVideoCodingKHR"));
+            self->vkCmdControlVideoCodingKHR = r_cast<PFN_vkCmdControlVideoCodingKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdControlVideoCodingKHR"));
+            self->vkCmdDecodeVideoKHR = r_cast<PFN_vkCmdDecodeVideoKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdDecodeVideoKHR"));
+            self->vkCmdEncodeVideoKHR = r_cast<PFN_vkCmdEncodeVideoKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdEncodeVideoKHR"));
+        }
+
         if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_RAY_TRACING_PIPELINE)
         {
             self->vkCreateRayTracingPipelinesKHR = r_cast<PFN_vkCreateRayTracingPipelinesKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCreateRayTracingPipelinesKHR"));
@@ -1565,6 +3785,12 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             self->vkCmdTraceRaysIndirectKHR = r_cast<PFN_vkCmdTraceRaysIndirectKHR>(vkGetDeviceProcAddr(self->vk_device, "vkCmdTraceRaysIndirectKHR"));
             self->vkGetRayTracingShaderGroupHandlesKHR = r_cast<PFN_vkGetRayTracingShaderGroupHandlesKHR>(vkGetDeviceProcAddr(self->vk_device, "vkGetRayTracingShaderGroupHandlesKHR"));
         }
+
+        if ((self->info.explicit_features & ExplicitFeatureFlagBits::DESCRIPTOR_BUFFER) != ExplicitFeatureFlagBits::NONE)
+        {
+            self->vkCmdBindDescriptorBuffersEXT = r_cast<PFN_vkCmdBindDescriptorBuffersEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdBindDescriptorBuffersEXT"));
+            self->vkCmdSetDescriptorBufferOffsetsEXT = r_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdSetDescriptorBufferOffsetsEXT"));
+        }
     }
 
     VkCommandPool init_cmd_pool = {};
@@ -1645,8 +3871,13 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
 #endif
     };
 
+    VmaAllocatorCreateFlags vma_allocator_flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    if (self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_BUDGET)
+    {
+        vma_allocator_flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
     VmaAllocatorCreateInfo const vma_allocator_create_info{
-        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+        .flags = vma_allocator_flags,
         .physicalDevice = self->vk_physical_device,
         .device = self->vk_device,
         .preferredLargeHeapBlockSize = 0, // Sets it to lib internal default (256MiB).
@@ -1698,9 +3929,10 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
     {
         auto buffer_data = std::array<u8, 4>{0xff, 0x00, 0xff, 0xff};
 
+        VkBufferUsageFlags2CreateInfoKHR vk_usage_flags2 = {};
         VkBufferCreateInfo const null_buffer_buffer_create_info{
             .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .pNext = nullptr,
+            .pNext = buffer_create_info_pnext(self, DAXA_DEFAULT_BUFFER_INFO, vk_usage_flags2),
             .flags = {},
             .size = sizeof(u8) * 4,
             .usage = create_buffer_use_flags(self),
@@ -1755,8 +3987,9 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             .sharing_mode = SharingMode::CONCURRENT,
             .allocate_info = MemoryFlagBits::DEDICATED_MEMORY,
         };
+        ImplVideoProfile video_profile = {};
         VkImageCreateInfo const vk_image_create_info = initialize_image_create_info_from_image_info(
-            self, *r_cast<daxa_ImageInfo const *>(&image_info));
+            self, *r_cast<daxa_ImageInfo const *>(&image_info), video_profile);
 
         VmaAllocationCreateInfo const null_img_allocation_create_info{
             .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
@@ -1898,6 +4131,7 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
         }
 
         VkBufferUsageFlags const usage_flags =
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
             VK_BUFFER_USAGE_TRANSFER_DST_BIT |
             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
@@ -1906,7 +4140,8 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
             .pNext = nullptr,
             .flags = {},
-            .size = self->info.max_allowed_buffers * sizeof(u64),
+            // The entry past the buffer addresses holds the shader debug ring address, see daxa_dvc_set_shader_debug_address.
+            .size = (self->info.max_allowed_buffers + 1) * sizeof(u64),
             .usage = usage_flags,
             .sharingMode = VK_SHARING_MODE_CONCURRENT,                  // Buffers are always shared.
             .queueFamilyIndexCount = self->valid_vk_queue_family_count, // Buffers are always shared across all queues.
@@ -1928,6 +4163,7 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
         _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_CREATE_BDA_BUFFER)
         result = static_cast<daxa_Result>(vmaMapMemory(self->vma_allocator, self->buffer_device_address_buffer_allocation, r_cast<void **>(&self->buffer_device_address_buffer_host_ptr)));
         _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_CREATE_BDA_BUFFER)
+        self->buffer_device_address_buffer_host_ptr[self->info.max_allowed_buffers] = 0;
     }
 
     // Set debug names:
@@ -1968,18 +4204,6 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
                     .pObjectName = name.data(),
                 };
                 self->vkSetDebugUtilsObjectNameEXT(self->vk_device, &queue_name_info);
-
-                std::string timeline_name = {"[DAXA DEVICE] Queue timeline semaphore "};
-                timeline_name += to_string(static_cast<QueueFamily>(queue.family));
-
-                VkDebugUtilsObjectNameInfoEXT const timeline_semaphore_name_info{
-                    .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
-                    .pNext = nullptr,
-                    .objectType = VK_OBJECT_TYPE_SEMAPHORE,
-                    .objectHandle = std::bit_cast<uint64_t>(queue.gpu_queue_local_timeline),
-                    .pObjectName = timeline_name.data(),
-                };
-                self->vkSetDebugUtilsObjectNameEXT(self->vk_device, &timeline_semaphore_name_info);
             }
         }
     }
@@ -1990,6 +4214,9 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
         self->info.max_allowed_samplers,
         (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING) ? self->info.max_allowed_acceleration_structures : (~0u),
         self->vk_device,
+        self->vk_physical_device,
+        self->vma_allocator,
+        (self->info.explicit_features & ExplicitFeatureFlagBits::DESCRIPTOR_BUFFER) != ExplicitFeatureFlagBits::NONE,
         self->buffer_device_address_buffer,
         self->vkSetDebugUtilsObjectNameEXT);
     _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_SUBMIT_DEVICE_INIT_COMMANDS)
@@ -2017,15 +4244,232 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
     result = static_cast<daxa_Result>(vkDeviceWaitIdle(self->vk_device));
     _DAXA_RETURN_IF_ERROR(result, DAXA_RESULT_FAILED_TO_SUBMIT_DEVICE_INIT_COMMANDS)
 
+    if (self->info.background_garbage_collection)
+    {
+        self->background_gc_thread = std::thread{[self]()
+                                                 { self->background_gc_loop(); }};
+    }
+
     return DAXA_RESULT_SUCCESS;
 }
 
+auto daxa_ImplDevice::pipeline_cache_file_path(std::string_view prefix) const -> std::filesystem::path
+{
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    std::string file_name = std::string{prefix};
+    for (char const byte : this->properties.pipeline_cache_uuid)
+    {
+        file_name.push_back(HEX_DIGITS[(static_cast<u8>(byte) >> 4) & 0xF]);
+        file_name.push_back(HEX_DIGITS[static_cast<u8>(byte) & 0xF]);
+    }
+    file_name += ".bin";
+    return std::filesystem::path{this->pipeline_cache_directory} / file_name;
+}
+
+void daxa_ImplDevice::background_gc_loop()
+{
+    // Bounds how long the thread sleeps when nothing is in flight, and how long stopping the thread can take.
+    static constexpr u64 WAIT_TIMEOUT_NANOS = 10'000'000;
+    std::array<VkSemaphore, std::tuple_size_v<decltype(this->queues)>> wait_semaphores = {};
+    std::array<u64, std::tuple_size_v<decltype(this->queues)>> wait_values = {};
+    while (!this->background_gc_stop.load(std::memory_order_relaxed))
+    {
+        // Wait until any queue retires its next submit.
+        u32 wait_count = 0;
+        for (auto & queue : this->queues)
+        {
+            VkSemaphore const timeline = queue.gpu_queue_local_timeline.load(std::memory_order::acquire);
+            if (timeline == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+            u64 latest_gpu = {};
+            if (vkGetSemaphoreCounterValue(this->vk_device, timeline, &latest_gpu) != VK_SUCCESS)
+            {
+                continue;
+            }
+            if (queue.latest_pending_submit_timeline_value.load(std::memory_order::acquire) > latest_gpu)
+            {
+                wait_semaphores[wait_count] = timeline;
+                wait_values[wait_count] = latest_gpu + 1;
+                ++wait_count;
+            }
+        }
+        if (wait_count > 0)
+        {
+            VkSemaphoreWaitInfo const wait_info{
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                .pNext = nullptr,
+                .flags = VK_SEMAPHORE_WAIT_ANY_BIT,
+                .semaphoreCount = wait_count,
+                .pSemaphores = wait_semaphores.data(),
+                .pValues = wait_values.data(),
+            };
+            [[maybe_unused]] auto const wait_result = vkWaitSemaphores(this->vk_device, &wait_info, WAIT_TIMEOUT_NANOS);
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::nanoseconds{WAIT_TIMEOUT_NANOS});
+        }
+
+        daxa_GarbageCollectInfo const gc_info = {.non_blocking = 1};
+        [[maybe_unused]] auto const gc_result = daxa_dvc_collect_garbage_incremental(this, &gc_info);
+    }
+}
+
+void daxa_ImplDevice::timeline_reactor_loop()
+{
+    // Bounds how long a lost wake up can delay callbacks.
+    static constexpr u64 WAIT_TIMEOUT_NANOS = 100'000'000;
+    std::vector<VkSemaphore> wait_semaphores = {};
+    std::vector<u64> wait_values = {};
+    std::vector<TimelineCallback> ready_callbacks = {};
+    while (true)
+    {
+        {
+            std::unique_lock lock{this->timeline_callbacks_mtx};
+            this->timeline_callbacks_cv.wait(lock, [&]()
+                                             { return this->timeline_reactor_stop || !this->timeline_callbacks.empty(); });
+            if (this->timeline_reactor_stop)
+            {
+                return;
+            }
+            // The wake semaphore ends the wait as soon as a new callback is registered.
+            wait_semaphores.clear();
+            wait_values.clear();
+            wait_semaphores.push_back(this->timeline_reactor_wake_semaphore);
+            wait_values.push_back(this->timeline_reactor_wake_value + 1);
+            for (auto const & callback : this->timeline_callbacks)
+            {
+                wait_semaphores.push_back(callback.semaphore->vk_semaphore);
+                wait_values.push_back(callback.value);
+            }
+        }
+
+        VkSemaphoreWaitInfo const wait_info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .pNext = nullptr,
+            .flags = VK_SEMAPHORE_WAIT_ANY_BIT,
+            .semaphoreCount = static_cast<u32>(wait_semaphores.size()),
+            .pSemaphores = wait_semaphores.data(),
+            .pValues = wait_values.data(),
+        };
+        [[maybe_unused]] auto const wait_result = vkWaitSemaphores(this->vk_device, &wait_info, WAIT_TIMEOUT_NANOS);
+
+        {
+            std::unique_lock lock{this->timeline_callbacks_mtx};
+            auto pending_end = std::partition(
+                this->timeline_callbacks.begin(), this->timeline_callbacks.end(),
+                [&](TimelineCallback const & callback)
+                {
+                    u64 value = {};
+                    return vkGetSemaphoreCounterValue(this->vk_device, callback.semaphore->vk_semaphore, &value) != VK_SUCCESS || value < callback.value;
+                });
+            ready_callbacks.assign(pending_end, this->timeline_callbacks.end());
+            this->timeline_callbacks.erase(pending_end, this->timeline_callbacks.end());
+        }
+        // Called without the lock, callbacks may register new callbacks.
+        for (auto const & callback : ready_callbacks)
+        {
+            callback.callback(callback.user_data, 1);
+            daxa_timeline_semaphore_dec_refcnt(callback.semaphore);
+        }
+        ready_callbacks.clear();
+    }
+}
+
+void daxa_ImplDevice::stop_timeline_reactor()
+{
+    if (!this->timeline_reactor_thread.joinable())
+    {
+        return;
+    }
+    {
+        std::unique_lock lock{this->timeline_callbacks_mtx};
+        this->timeline_reactor_stop = true;
+        this->timeline_reactor_wake_value += 1;
+        VkSemaphoreSignalInfo const wake_info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO,
+            .pNext = nullptr,
+            .semaphore = this->timeline_reactor_wake_semaphore,
+            .value = this->timeline_reactor_wake_value,
+        };
+        [[maybe_unused]] auto const signal_result = vkSignalSemaphore(this->vk_device, &wake_info);
+    }
+    this->timeline_callbacks_cv.notify_one();
+    this->timeline_reactor_thread.join();
+    for (auto const & callback : this->timeline_callbacks)
+    {
+        callback.callback(callback.user_data, 0);
+        daxa_timeline_semaphore_dec_refcnt(callback.semaphore);
+    }
+    this->timeline_callbacks.clear();
+    vkDestroySemaphore(this->vk_device, this->timeline_reactor_wake_semaphore, nullptr);
+    this->timeline_reactor_wake_semaphore = VK_NULL_HANDLE;
+}
+
+void daxa_ImplDevice::enqueue_pipeline_compile(PipelineCompileJob job)
+{
+    {
+        std::unique_lock lock{this->pipeline_compile_mtx};
+        if (this->pipeline_compile_threads.empty())
+        {
+            u32 const thread_count = std::max(1u, std::thread::hardware_concurrency() / 2);
+            for (u32 i = 0; i < thread_count; ++i)
+            {
+                this->pipeline_compile_threads.emplace_back([this]()
+                                                            { this->pipeline_compile_loop(); });
+            }
+        }
+        this->pipeline_compile_jobs.push_back(job);
+    }
+    this->pipeline_compile_cv.notify_one();
+}
+
+void daxa_ImplDevice::pipeline_compile_loop()
+{
+    while (true)
+    {
+        PipelineCompileJob job = {};
+        {
+            std::unique_lock lock{this->pipeline_compile_mtx};
+            this->pipeline_compile_cv.wait(lock, [&]()
+                                           { return this->pipeline_compile_stop || !this->pipeline_compile_jobs.empty(); });
+            if (this->pipeline_compile_stop)
+            {
+                return;
+            }
+            job = this->pipeline_compile_jobs.front();
+            this->pipeline_compile_jobs.pop_front();
+        }
+        // Compiled without the lock, destroying the pending pipeline waits for the status the job publishes.
+        job.compile(*job.pipeline);
+    }
+}
+
+void daxa_ImplDevice::stop_pipeline_compile_workers()
+{
+    // Pending pipelines keep the device alive, so no jobs are left when it is destroyed.
+    {
+        std::unique_lock lock{this->pipeline_compile_mtx};
+        this->pipeline_compile_stop = true;
+    }
+    this->pipeline_compile_cv.notify_all();
+    for (auto & thread : this->pipeline_compile_threads)
+    {
+        thread.join();
+    }
+    this->pipeline_compile_threads.clear();
+}
+
 auto daxa_ImplDevice::get_queue(daxa_Queue queue) -> daxa_ImplDevice::ImplQueue &
 {
-    u32 offsets[3] = {
-        0,
-        1,
-        1 + DAXA_MAX_COMPUTE_QUEUE_COUNT,
+    u32 offsets[QUEUE_FAMILY_COUNT] = {
+        MAIN_QUEUE_INDEX,
+        FIRST_COMPUTE_QUEUE_IDX,
+        FIRST_TRANSFER_QUEUE_IDX,
+        FIRST_VIDEO_DECODE_QUEUE_IDX,
+        FIRST_VIDEO_ENCODE_QUEUE_IDX,
     };
     return this->queues[offsets[queue.family] + queue.index];
 }
@@ -2035,6 +4479,23 @@ auto daxa_ImplDevice::valid_queue(daxa_Queue queue) -> bool
     return queue.family < DAXA_QUEUE_FAMILY_MAX_ENUM && queue.index < this->queue_families[queue.family].queue_count;
 }
 
+auto daxa_ImplDevice::get_retired_submit_timeline_value(u64 & out) -> daxa_Result
+{
+    out = std::numeric_limits<u64>::max();
+    for (auto & queue : this->queues)
+    {
+        std::optional<u64> latest_pending_submit = {};
+        auto result = queue.get_oldest_pending_submit(this->vk_device, latest_pending_submit);
+        _DAXA_RETURN_IF_ERROR(result, result)
+
+        if (latest_pending_submit.has_value())
+        {
+            out = std::min(out, latest_pending_submit.value());
+        }
+    }
+    return DAXA_RESULT_SUCCESS;
+}
+
 auto daxa_ImplDevice::validate_image_slice(daxa_ImageMipArraySlice const & slice, daxa_ImageId id) -> daxa_ImageMipArraySlice
 {
     if (slice.level_count == std::numeric_limits<u32>::max() || slice.level_count == 0)
@@ -2080,6 +4541,9 @@ auto daxa_ImplDevice::new_swapchain_image(VkImage swapchain_image, VkFormat form
         }
     };
 
+    result = ensure_image_descriptor_capacity(this, id);
+    _DAXA_RETURN_IF_ERROR(result, result)
+
     ret.vk_image = swapchain_image;
     ret.view_slot.info = std::bit_cast<daxa_ImageViewInfo>(ImageViewInfo{
         .type = static_cast<ImageViewType>(image_info.dimensions - 1),
@@ -2147,10 +4611,15 @@ auto daxa_ImplDevice::new_swapchain_image(VkImage swapchain_image, VkFormat form
     {
         // Does not need external sync given we use update after bind.
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
-        write_descriptor_set_image(this->vk_device, this->gpu_sro_table.vk_descriptor_set, ret.view_slot.vk_image_view, usage, id.index);
+        write_descriptor_set_image(this->vk_device, this->gpu_sro_table, ret.view_slot.vk_image_view, usage, id.index);
     }
 
     *out = ImageId{id};
+    // Replays create swapchain images as plain images of the same info.
+    if (this->capture.active_generation.load(std::memory_order_relaxed) != 0)
+    {
+        capture_image_created(this, *out);
+    }
 
     return result;
 }
@@ -2163,11 +4632,14 @@ void daxa_ImplDevice::cleanup_buffer(BufferId id)
     {
         // Does not need external sync given we use update after bind.
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
-        write_descriptor_set_buffer(this->vk_device, this->gpu_sro_table.vk_descriptor_set, this->vk_null_buffer, 0, VK_WHOLE_SIZE, gid.index);
+        // Descriptor buffers need the explicit size of the null buffer, descriptor sets keep the whole size range.
+        VkDeviceSize const null_range = this->gpu_sro_table.uses_descriptor_buffer ? sizeof(u8) * 4 : VK_WHOLE_SIZE;
+        write_descriptor_set_buffer(this->vk_device, this->gpu_sro_table, this->vk_null_buffer, 0, null_range, gid.index);
     }
-    if (buffer_slot.opt_memory_block != nullptr)
+    if (buffer_slot.opt_memory_block != nullptr || buffer_slot.vk_external_memory != VK_NULL_HANDLE)
     {
         vkDestroyBuffer(this->vk_device, buffer_slot.vk_buffer, {});
+        vkFreeMemory(this->vk_device, buffer_slot.vk_external_memory, {});
     }
     else
     {
@@ -2186,7 +4658,7 @@ void daxa_ImplDevice::cleanup_image(ImageId id)
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
         write_descriptor_set_image(
             this->vk_device,
-            this->gpu_sro_table.vk_descriptor_set,
+            this->gpu_sro_table,
             this->vk_null_image_view,
             std::bit_cast<ImageUsageFlags>(image_slot.info.usage),
             gid.index);
@@ -2194,9 +4666,10 @@ void daxa_ImplDevice::cleanup_image(ImageId id)
     vkDestroyImageView(vk_device, image_slot.view_slot.vk_image_view, nullptr);
     if (image_slot.swapchain_image_index == NOT_OWNED_BY_SWAPCHAIN)
     {
-        if (image_slot.opt_memory_block != nullptr)
+        if (image_slot.opt_memory_block != nullptr || image_slot.vk_external_memory != VK_NULL_HANDLE)
         {
             vkDestroyImage(this->vk_device, image_slot.vk_image, {});
+            vkFreeMemory(this->vk_device, image_slot.vk_external_memory, {});
         }
         else
         {
@@ -2213,7 +4686,7 @@ void daxa_ImplDevice::cleanup_image_view(ImageViewId id)
     {
         // Does not need external sync given we use update after bind.
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
-        write_descriptor_set_image(this->vk_device, this->gpu_sro_table.vk_descriptor_set, this->vk_null_image_view, ImageUsageFlagBits::SHADER_STORAGE | ImageUsageFlagBits::SHADER_SAMPLED, std::bit_cast<daxa::ImageViewId>(id).index);
+        write_descriptor_set_image(this->vk_device, this->gpu_sro_table, this->vk_null_image_view, ImageUsageFlagBits::SHADER_STORAGE | ImageUsageFlagBits::SHADER_SAMPLED, std::bit_cast<daxa::ImageViewId>(id).index);
     }
     vkDestroyImageView(vk_device, image_slot.vk_image_view, nullptr);
     gpu_sro_table.image_slots.unsafe_destroy_zombie_slot(std::bit_cast<GPUResourceId>(id));
@@ -2225,7 +4698,7 @@ void daxa_ImplDevice::cleanup_sampler(SamplerId id)
     {
         // Does not need external sync given we use update after bind.
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
-        write_descriptor_set_sampler(this->vk_device, this->gpu_sro_table.vk_descriptor_set, this->vk_null_sampler, std::bit_cast<GPUResourceId>(id).index);
+        write_descriptor_set_sampler(this->vk_device, this->gpu_sro_table, this->vk_null_sampler, std::bit_cast<GPUResourceId>(id).index);
     }
     vkDestroySampler(this->vk_device, sampler_slot.vk_sampler, nullptr);
     gpu_sro_table.sampler_slots.unsafe_destroy_zombie_slot(std::bit_cast<GPUResourceId>(id));
@@ -2235,7 +4708,7 @@ void daxa_ImplDevice::cleanup_tlas(TlasId id)
 {
     ImplTlasSlot const & tlas_slot = this->gpu_sro_table.tlas_slots.unsafe_get(std::bit_cast<GPUResourceId>(id));
     // TODO(Raytracing): Add null acceleration structure:
-    // write_descriptor_set_acceleration_structure(this->vk_device, this->gpu_sro_table.vk_descriptor_set, this->vk_null_acceleration_structure, std::bit_cast<GPUResourceId>(id).index);
+    // write_descriptor_set_acceleration_structure(this->vk_device, this->gpu_sro_table, this->vk_null_acceleration_structure, std::bit_cast<GPUResourceId>(id).index);
     this->vkDestroyAccelerationStructureKHR(this->vk_device, tlas_slot.vk_acceleration_structure, nullptr);
     gpu_sro_table.tlas_slots.unsafe_destroy_zombie_slot(std::bit_cast<GPUResourceId>(id));
 }
@@ -2281,17 +4754,39 @@ void daxa_ImplDevice::zero_ref_callback(ImplHandle const * handle)
 {
     _DAXA_TEST_PRINT("daxa_ImplDevice::zero_ref_callback\n");
     auto self = rc_cast<daxa_Device>(handle);
+    if (self->background_gc_thread.joinable())
+    {
+        self->background_gc_stop.store(true, std::memory_order_relaxed);
+        self->background_gc_thread.join();
+    }
+    // Releases the semaphores of pending callbacks, they are zombified and collected below.
+    self->stop_timeline_reactor();
+    self->stop_pipeline_compile_workers();
     auto result = daxa_dvc_wait_idle(self);
     DAXA_DBG_ASSERT_TRUE_M(result == DAXA_RESULT_SUCCESS, "failed to wait idle");
+    if (self->defragmentation_pass_open)
+    {
+        // The gpu is idle, so the copies of the open pass are done.
+        result = daxa_dvc_end_defragmentation_pass(self);
+        DAXA_DBG_ASSERT_TRUE_M(result == DAXA_RESULT_SUCCESS || result == DAXA_RESULT_INCOMPLETE, "failed to end defragmentation pass");
+    }
+    if (self->vma_defragmentation_context != nullptr)
+    {
+        vmaEndDefragmentation(self->vma_allocator, self->vma_defragmentation_context, nullptr);
+    }
     result = daxa_dvc_collect_garbage(self);
     DAXA_DBG_ASSERT_TRUE_M(result == DAXA_RESULT_SUCCESS, "failed to wait idle");
     for (auto & pool_pool : self->command_pool_pools)
     {
         pool_pool.cleanup(self);
     }
+    // Failing to persist the cache only costs compile time on the next run.
+    [[maybe_unused]] auto const save_result = daxa_dvc_save_pipeline_cache(self);
+    self->graphics_pipeline_libraries.cleanup(self->vk_device);
+    vkDestroyPipelineCache(self->vk_device, self->vk_pipeline_cache, nullptr);
     vmaUnmapMemory(self->vma_allocator, self->buffer_device_address_buffer_allocation);
     vmaDestroyBuffer(self->vma_allocator, self->buffer_device_address_buffer, self->buffer_device_address_buffer_allocation);
-    self->gpu_sro_table.cleanup(self->vk_device);
+    self->gpu_sro_table.cleanup(self->vk_device, self->vma_allocator);
     vmaDestroyImage(self->vma_allocator, self->vk_null_image, self->vk_null_image_vma_allocation);
     vmaDestroyBuffer(self->vma_allocator, self->vk_null_buffer, self->vk_null_buffer_vma_allocation);
     vmaDestroyAllocator(self->vma_allocator);
@@ -2309,32 +4804,48 @@ void daxa_ImplDevice::zero_ref_callback(ImplHandle const * handle)
 }
 
 template <typename T>
-void zombiefy(daxa_Device self, T id, auto & slots, auto & zombies)
+void zombiefy_many(daxa_Device self, std::span<T const> ids, auto & slots, auto & zombies)
 {
-    [[maybe_unused]] auto & slot = slots.unsafe_get(std::bit_cast<GPUResourceId>(id));
-    if constexpr (std::is_same_v<T, BufferId> || std::is_same_v<T, ImageId>)
+    if (ids.empty())
     {
-        if (slot.opt_memory_block != nullptr)
-        {
-            slot.opt_memory_block->dec_weak_refcnt(
-                daxa_ImplMemoryBlock::zero_ref_callback,
-                self->instance);
-        }
+        return;
     }
-    if constexpr (std::is_same_v<T, TlasId> || std::is_same_v<T, BlasId>)
+    for (T const id : ids)
     {
-        if (slot.owns_buffer)
+        [[maybe_unused]] auto & slot = slots.unsafe_get(std::bit_cast<GPUResourceId>(id));
+        if constexpr (std::is_same_v<T, BufferId> || std::is_same_v<T, ImageId>)
+        {
+            if (slot.opt_memory_block != nullptr)
+            {
+                slot.opt_memory_block->dec_weak_refcnt(
+                    daxa_ImplMemoryBlock::zero_ref_callback,
+                    self->instance);
+            }
+        }
+        if constexpr (std::is_same_v<T, TlasId> || std::is_same_v<T, BlasId>)
         {
-            self->zombify_buffer(slot.buffer_id);
+            if (slot.owns_buffer)
+            {
+                self->zombify_buffer(slot.buffer_id);
+            }
         }
     }
     u64 const submit_timeline_value = self->global_submit_timeline.load(std::memory_order::relaxed);
     {
         std::unique_lock const lock{self->zombies_mtx};
-        zombies.push_front(std::pair{submit_timeline_value, id});
+        for (T const id : ids)
+        {
+            zombies.push_front(std::pair{submit_timeline_value, id});
+        }
     }
 }
 
+template <typename T>
+void zombiefy(daxa_Device self, T id, auto & slots, auto & zombies)
+{
+    zombiefy_many(self, std::span<T const>{&id, 1}, slots, zombies);
+}
+
 void daxa_ImplDevice::zombify_buffer(BufferId id)
 {
     _DAXA_TEST_PRINT("daxa_ImplDevice::zombify_buffer\n");
@@ -2371,4 +4882,28 @@ void daxa_ImplDevice::zombify_blas(BlasId id)
     zombiefy(this, id, gpu_sro_table.blas_slots, this->blas_zombies);
 }
 
+void daxa_ImplDevice::zombify_buffers(std::span<BufferId const> ids)
+{
+    _DAXA_TEST_PRINT("daxa_ImplDevice::zombify_buffers\n");
+    zombiefy_many(this, ids, gpu_sro_table.buffer_slots, this->buffer_zombies);
+}
+
+void daxa_ImplDevice::zombify_images(std::span<ImageId const> ids)
+{
+    _DAXA_TEST_PRINT("daxa_ImplDevice::zombify_images\n");
+    zombiefy_many(this, ids, gpu_sro_table.image_slots, this->image_zombies);
+}
+
+void daxa_ImplDevice::zombify_image_views(std::span<ImageViewId const> ids)
+{
+    _DAXA_TEST_PRINT("daxa_ImplDevice::zombify_image_views\n");
+    zombiefy_many(this, ids, gpu_sro_table.image_slots, this->image_view_zombies);
+}
+
+void daxa_ImplDevice::zombify_samplers(std::span<SamplerId const> ids)
+{
+    _DAXA_TEST_PRINT("daxa_ImplDevice::zombify_samplers\n");
+    zombiefy_many(this, ids, gpu_sro_table.sampler_slots, this->sampler_zombies);
+}
+
 // --- End Internal Functions ---
\ No newline at end of file
@@ -8,11 +8,20 @@
 #include "impl_swapchain.hpp"
 #include "impl_gpu_resources.hpp"
 #include "impl_timeline_query.hpp"
+#include "impl_generated_commands.hpp"
+#include "impl_shader_object.hpp"
+#include "impl_micromap.hpp"
+#include "impl_video.hpp"
 #include "impl_features.hpp"
+#include "impl_capture.hpp"
 
 #include <daxa/c/device.h>
 
 #include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <filesystem>
+#include <string>
 
 using namespace daxa;
 
@@ -26,6 +35,9 @@ static inline constexpr u64 MAX_PENDING_SUBMISSIONS_PER_QUEUE = 64;
 static inline constexpr u64 MAIN_QUEUE_INDEX = 0;
 static inline constexpr u64 FIRST_COMPUTE_QUEUE_IDX = 1;
 static inline constexpr u64 FIRST_TRANSFER_QUEUE_IDX = FIRST_COMPUTE_QUEUE_IDX + DAXA_MAX_COMPUTE_QUEUE_COUNT;
+static inline constexpr u64 FIRST_VIDEO_DECODE_QUEUE_IDX = FIRST_TRANSFER_QUEUE_IDX + DAXA_MAX_TRANSFER_QUEUE_COUNT;
+static inline constexpr u64 FIRST_VIDEO_ENCODE_QUEUE_IDX = FIRST_VIDEO_DECODE_QUEUE_IDX + DAXA_MAX_VIDEO_DECODE_QUEUE_COUNT;
+static inline constexpr u32 QUEUE_FAMILY_COUNT = 5;
 
 struct daxa_ImplDevice final : public ImplHandle
 {
@@ -34,6 +46,8 @@ struct daxa_ImplDevice final : public ImplHandle
     DeviceInfo2 info = {};
     VkPhysicalDevice vk_physical_device = {};
     daxa_DeviceProperties properties = {};
+    // Physical devices the device spans, one unless created with DeviceInfo2::device_group.
+    u32 device_group_size = 1;
     PhysicalDeviceFeaturesStruct physical_device_features = {};
     VkDevice vk_device = {};
     VmaAllocator vma_allocator = {};
@@ -52,18 +66,125 @@ struct daxa_ImplDevice final : public ImplHandle
     PFN_vkCmdDrawMeshTasksIndirectCountEXT vkCmdDrawMeshTasksIndirectCountEXT = {};
     VkPhysicalDeviceMeshShaderPropertiesEXT mesh_shader_properties = {};
 
+    // Multi draw:
+    PFN_vkCmdDrawMultiEXT vkCmdDrawMultiEXT = {};
+    PFN_vkCmdDrawMultiIndexedEXT vkCmdDrawMultiIndexedEXT = {};
+    VkPhysicalDeviceMultiDrawPropertiesEXT multi_draw_properties = {};
+
+    // Device generated commands:
+    PFN_vkCreateIndirectCommandsLayoutEXT vkCreateIndirectCommandsLayoutEXT = {};
+    PFN_vkDestroyIndirectCommandsLayoutEXT vkDestroyIndirectCommandsLayoutEXT = {};
+    PFN_vkCreateIndirectExecutionSetEXT vkCreateIndirectExecutionSetEXT = {};
+    PFN_vkDestroyIndirectExecutionSetEXT vkDestroyIndirectExecutionSetEXT = {};
+    PFN_vkUpdateIndirectExecutionSetPipelineEXT vkUpdateIndirectExecutionSetPipelineEXT = {};
+    PFN_vkGetGeneratedCommandsMemoryRequirementsEXT vkGetGeneratedCommandsMemoryRequirementsEXT = {};
+    PFN_vkCmdExecuteGeneratedCommandsEXT vkCmdExecuteGeneratedCommandsEXT = {};
+    VkPhysicalDeviceDeviceGeneratedCommandsPropertiesEXT device_generated_commands_properties = {};
+    // Chained into all buffer create infos when device generated commands are enabled.
+    VkBufferUsageFlags2CreateInfoKHR buffer_usage_flags2_info = {};
+
+    // Pipeline binaries:
+    PFN_vkCreatePipelineBinariesKHR vkCreatePipelineBinariesKHR = {};
+    PFN_vkDestroyPipelineBinaryKHR vkDestroyPipelineBinaryKHR = {};
+    PFN_vkGetPipelineKeyKHR vkGetPipelineKeyKHR = {};
+    PFN_vkGetPipelineBinaryDataKHR vkGetPipelineBinaryDataKHR = {};
+    PFN_vkReleaseCapturedPipelineDataKHR vkReleaseCapturedPipelineDataKHR = {};
+    VkPhysicalDevicePipelineBinaryPropertiesKHR pipeline_binary_properties = {};
+    // Only used when the pipeline cache directory is set and the driver does not prefer its internal cache.
+    PipelineBinaryArchive pipeline_binary_archive = {};
+
+    // Graphics pipeline library:
+    VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphics_pipeline_library_properties = {};
+    GraphicsPipelineLibraryCache graphics_pipeline_libraries = {};
+
+    // Shader objects:
+    PFN_vkCreateShadersEXT vkCreateShadersEXT = {};
+    PFN_vkDestroyShaderEXT vkDestroyShaderEXT = {};
+    PFN_vkCmdBindShadersEXT vkCmdBindShadersEXT = {};
+    // Shader objects have no pipeline state, all of it is set dynamically with these.
+    PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT = {};
+    PFN_vkCmdSetSampleMaskEXT vkCmdSetSampleMaskEXT = {};
+    PFN_vkCmdSetAlphaToCoverageEnableEXT vkCmdSetAlphaToCoverageEnableEXT = {};
+    PFN_vkCmdSetColorBlendEnableEXT vkCmdSetColorBlendEnableEXT = {};
+    PFN_vkCmdSetColorBlendEquationEXT vkCmdSetColorBlendEquationEXT = {};
+    PFN_vkCmdSetColorWriteMaskEXT vkCmdSetColorWriteMaskEXT = {};
+    PFN_vkCmdSetDepthClampEnableEXT vkCmdSetDepthClampEnableEXT = {};
+    PFN_vkCmdSetVertexInputEXT vkCmdSetVertexInputEXT = {};
+    PFN_vkCmdSetPatchControlPointsEXT vkCmdSetPatchControlPointsEXT = {};
+    PFN_vkCmdSetTessellationDomainOriginEXT vkCmdSetTessellationDomainOriginEXT = {};
+    PFN_vkCmdSetConservativeRasterizationModeEXT vkCmdSetConservativeRasterizationModeEXT = {};
+    PFN_vkCmdSetExtraPrimitiveOverestimationSizeEXT vkCmdSetExtraPrimitiveOverestimationSizeEXT = {};
+
+    // Conditional rendering:
+    PFN_vkCmdBeginConditionalRenderingEXT vkCmdBeginConditionalRenderingEXT = {};
+    PFN_vkCmdEndConditionalRenderingEXT vkCmdEndConditionalRenderingEXT = {};
+
+    // Memory decompression:
+    PFN_vkCmdDecompressMemoryNV vkCmdDecompressMemoryNV = {};
+
+    // Frame pacing:
+    PFN_vkWaitForPresentKHR vkWaitForPresentKHR = {};
+    PFN_vkSetLatencySleepModeNV vkSetLatencySleepModeNV = {};
+    PFN_vkLatencySleepNV vkLatencySleepNV = {};
+    PFN_vkSetLatencyMarkerNV vkSetLatencyMarkerNV = {};
+    PFN_vkGetRefreshCycleDurationGOOGLE vkGetRefreshCycleDurationGOOGLE = {};
+    PFN_vkGetPastPresentationTimingGOOGLE vkGetPastPresentationTimingGOOGLE = {};
+
+    // Calibrated timestamps:
+    PFN_vkGetCalibratedTimestampsKHR vkGetCalibratedTimestampsKHR = {};
+    // The host domain matching std::chrono::steady_clock.
+    VkTimeDomainKHR calibration_host_time_domain = {};
+    // Only for VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_KHR, ticks per second of the counter.
+    u64 calibration_host_ticks_per_second = {};
+
+    // External memory:
+#if defined(_WIN32)
+    PFN_vkGetMemoryWin32HandleKHR vkGetMemoryWin32HandleKHR = {};
+    PFN_vkGetSemaphoreWin32HandleKHR vkGetSemaphoreWin32HandleKHR = {};
+    PFN_vkImportSemaphoreWin32HandleKHR vkImportSemaphoreWin32HandleKHR = {};
+#else
+    PFN_vkGetMemoryFdKHR vkGetMemoryFdKHR = {};
+    PFN_vkGetMemoryFdPropertiesKHR vkGetMemoryFdPropertiesKHR = {};
+    PFN_vkGetSemaphoreFdKHR vkGetSemaphoreFdKHR = {};
+    PFN_vkImportSemaphoreFdKHR vkImportSemaphoreFdKHR = {};
+#endif
+
     // Ray tracing:
     PFN_vkGetAccelerationStructureBuildSizesKHR vkGetAccelerationStructureBuildSizesKHR = {};
     PFN_vkCreateAccelerationStructureKHR vkCreateAccelerationStructureKHR = {};
     PFN_vkDestroyAccelerationStructureKHR vkDestroyAccelerationStructureKHR = {};
     PFN_vkCmdWriteAccelerationStructuresPropertiesKHR vkCmdWriteAccelerationStructuresPropertiesKHR = {};
     PFN_vkCmdBuildAccelerationStructuresKHR vkCmdBuildAccelerationStructuresKHR = {};
+    PFN_vkCmdCopyAccelerationStructureKHR vkCmdCopyAccelerationStructureKHR = {};
     PFN_vkGetAccelerationStructureDeviceAddressKHR vkGetAccelerationStructureDeviceAddressKHR = {};
     PFN_vkCreateRayTracingPipelinesKHR vkCreateRayTracingPipelinesKHR = {};
     PFN_vkGetRayTracingShaderGroupHandlesKHR vkGetRayTracingShaderGroupHandlesKHR = {};
     PFN_vkCmdTraceRaysKHR vkCmdTraceRaysKHR = {};
     PFN_vkCmdTraceRaysIndirectKHR vkCmdTraceRaysIndirectKHR = {};
 
+    // Opacity micromaps:
+    PFN_vkCreateMicromapEXT vkCreateMicromapEXT = {};
+    PFN_vkDestroyMicromapEXT vkDestroyMicromapEXT = {};
+    PFN_vkCmdBuildMicromapsEXT vkCmdBuildMicromapsEXT = {};
+    PFN_vkGetMicromapBuildSizesEXT vkGetMicromapBuildSizesEXT = {};
+
+    // Video:
+    PFN_vkCreateVideoSessionKHR vkCreateVideoSessionKHR = {};
+    PFN_vkDestroyVideoSessionKHR vkDestroyVideoSessionKHR = {};
+    PFN_vkGetVideoSessionMemoryRequirementsKHR vkGetVideoSessionMemoryRequirementsKHR = {};
+    PFN_vkBindVideoSessionMemoryKHR vkBindVideoSessionMemoryKHR = {};
+    PFN_vkCreateVideoSessionParametersKHR vkCreateVideoSessionParametersKHR = {};
+    PFN_vkDestroyVideoSessionParametersKHR vkDestroyVideoSessionParametersKHR = {};
+    PFN_vkCmdBeginVideoCodingKHR vkCmdBeginVideoCodingKHR = {};
+    PFN_vkCmdEndVideoCodingKHR vkCmdEndVideoCodingKHR = {};
+    PFN_vkCmdControlVideoCodingKHR vkCmdControlVideoCodingKHR = {};
+    PFN_vkCmdDecodeVideoKHR vkCmdDecodeVideoKHR = {};
+    PFN_vkCmdEncodeVideoKHR vkCmdEncodeVideoKHR = {};
+
+    // Descriptor buffer extension functions
+    PFN_vkCmdBindDescriptorBuffersEXT vkCmdBindDescriptorBuffersEXT = {};
+    PFN_vkCmdSetDescriptorBufferOffsetsEXT vkCmdSetDescriptorBufferOffsetsEXT = {};
+
     VkBuffer buffer_device_address_buffer = {};
     u64 * buffer_device_address_buffer_host_ptr = {};
     VmaAllocation buffer_device_address_buffer_allocation = {};
@@ -82,7 +203,8 @@ struct daxa_ImplDevice final : public ImplHandle
 
     // Command Buffer/Pool recycling:
     // Index with daxa_QueueFamily.
-    std::array<CommandPoolPool, 3> command_pool_pools = {};
+    std::array<CommandPoolPool, QUEUE_FAMILY_COUNT> command_pool_pools = {};
+    ExecutableCommandListDataPool command_list_data_pool = {};
 
     // Gpu Shader Resource Object table:
     GPUShaderResourceTable gpu_sro_table = {};
@@ -105,7 +227,77 @@ struct daxa_ImplDevice final : public ImplHandle
     std::deque<std::pair<u64, EventZombie>> split_barrier_zombies = {};
     std::deque<std::pair<u64, PipelineZombie>> pipeline_zombies = {};
     std::deque<std::pair<u64, TimelineQueryPoolZombie>> timeline_query_pool_zombies = {};
+    std::deque<std::pair<u64, QueryPoolZombie>> query_pool_zombies = {};
+    std::deque<std::pair<u64, GeneratedCommandsZombie>> generated_commands_zombies = {};
+    std::deque<std::pair<u64, ShaderObjectZombie>> shader_object_zombies = {};
+    std::deque<std::pair<u64, MicromapZombie>> micromap_zombies = {};
+    std::deque<std::pair<u64, VideoSessionZombie>> video_session_zombies = {};
     std::deque<std::pair<u64, MemoryBlockZombie>> memory_block_zombies = {};
+    // Size of all live memory blocks, see daxa_dvc_memory_report.
+    std::atomic_uint64_t memory_block_bytes = {};
+
+    // Defragmentation, see daxa_dvc_begin_defragmentation_pass.
+    // Each move of the open pass has an entry at the same index, ignored moves keep null handles.
+    struct DefragmentationMove
+    {
+        u32 slot_index = {};
+        bool is_image = {};
+        VkBuffer new_vk_buffer = {};
+        VkImage new_vk_image = {};
+    };
+    std::mutex defragmentation_mtx = {};
+    VmaDefragmentationContext vma_defragmentation_context = {};
+    VmaDefragmentationPassMoveInfo vma_defragmentation_pass = {};
+    std::vector<DefragmentationMove> defragmentation_moves = {};
+    bool defragmentation_pass_open = {};
+
+    // Command capture, see daxa_dvc_begin_capture.
+    CaptureState capture = {};
+
+    // Optional device owned garbage collection thread, see DeviceInfo2::background_garbage_collection.
+    std::thread background_gc_thread = {};
+    std::atomic_bool background_gc_stop = {};
+    void background_gc_loop();
+
+    // Timeline callbacks, see daxa_dvc_on_timeline.
+    // The reactor thread is started with the first callback. Registrations signal the host side wake semaphore,
+    // which is part of every wait of the reactor, so new callbacks are picked up immediately.
+    struct TimelineCallback
+    {
+        daxa_TimelineSemaphore semaphore = {};
+        u64 value = {};
+        daxa_TimelineCallback callback = {};
+        void * user_data = {};
+    };
+    std::mutex timeline_callbacks_mtx = {};
+    std::condition_variable timeline_callbacks_cv = {};
+    std::vector<TimelineCallback> timeline_callbacks = {};
+    VkSemaphore timeline_reactor_wake_semaphore = {};
+    u64 timeline_reactor_wake_value = {};
+    std::thread timeline_reactor_thread = {};
+    bool timeline_reactor_stop = {};
+    void timeline_reactor_loop();
+    void stop_timeline_reactor();
+
+    // Compilation of pipelines created with daxa_dvc_create_*_pipeline_async.
+    // The workers are started with the first asynchronous creation. Jobs hold no references,
+    // destroying a pending pipeline removes its job or waits for the worker running it.
+    std::mutex pipeline_compile_mtx = {};
+    std::condition_variable pipeline_compile_cv = {};
+    // Notified when a pending pipeline becomes ready or failed.
+    std::condition_variable pipeline_compiled_cv = {};
+    std::deque<PipelineCompileJob> pipeline_compile_jobs = {};
+    std::vector<std::thread> pipeline_compile_threads = {};
+    bool pipeline_compile_stop = {};
+    void enqueue_pipeline_compile(PipelineCompileJob job);
+    void pipeline_compile_loop();
+    void stop_pipeline_compile_workers();
+
+    // Used by all pipeline creations. Loaded from and saved to the pipeline cache directory, when one is set.
+    VkPipelineCache vk_pipeline_cache = {};
+    // Backs info.pipeline_cache_directory.
+    std::string pipeline_cache_directory = {};
+    auto pipeline_cache_file_path(std::string_view prefix) const -> std::filesystem::path;
 
     // Queues
     struct ImplQueue
@@ -115,15 +307,19 @@ struct daxa_ImplDevice final : public ImplHandle
         u32 queue_index = {};
         u32 vk_queue_family_index = ~0u;
         VkQueue vk_queue = {};
-        VkSemaphore gpu_queue_local_timeline = {};
         // atomically synchronized:
+        // Created by the first submit or sparse binding, queues that are never used do not get one.
+        std::atomic<VkSemaphore> gpu_queue_local_timeline = {};
+        std::mutex gpu_queue_local_timeline_creation_mtx = {};
         std::atomic_uint64_t latest_pending_submit_timeline_value = {};
 
         auto initialize(VkDevice vk_device, u32 queue_family_index, u32 queue_index) -> daxa_Result;
+        // Must be called before latest_pending_submit_timeline_value is raised.
+        auto ensure_timeline(daxa_Device device) -> daxa_Result;
         void cleanup(VkDevice device);
         auto get_oldest_pending_submit(VkDevice vk_device, std::optional<u64> & out) -> daxa_Result;
     };
-    std::array<ImplQueue, DAXA_MAX_COMPUTE_QUEUE_COUNT + DAXA_MAX_TRANSFER_QUEUE_COUNT + 1> queues = {
+    std::array<ImplQueue, DAXA_MAX_COMPUTE_QUEUE_COUNT + DAXA_MAX_TRANSFER_QUEUE_COUNT + DAXA_MAX_VIDEO_DECODE_QUEUE_COUNT + DAXA_MAX_VIDEO_ENCODE_QUEUE_COUNT + 1> queues = {
         ImplQueue{DAXA_QUEUE_FAMILY_MAIN, 0},
         ImplQueue{DAXA_QUEUE_FAMILY_COMPUTE, 0},
         ImplQueue{DAXA_QUEUE_FAMILY_COMPUTE, 1},
@@ -135,19 +331,25 @@ struct daxa_ImplDevice final : public ImplHandle
         ImplQueue{DAXA_QUEUE_FAMILY_COMPUTE, 7},
         ImplQueue{DAXA_QUEUE_FAMILY_TRANSFER, 0},
         ImplQueue{DAXA_QUEUE_FAMILY_TRANSFER, 1},
+        ImplQueue{DAXA_QUEUE_FAMILY_VIDEO_DECODE, 0},
+        ImplQueue{DAXA_QUEUE_FAMILY_VIDEO_ENCODE, 0},
     };
 
     auto get_queue(daxa_Queue queue) -> ImplQueue&;
     auto valid_queue(daxa_Queue queue) -> bool;
+    // Minimum completed timeline value of all queues with pending submits, u64 max when all queues are idle.
+    // Every submit with a global submit timeline value at or below it has finished executing.
+    auto get_retired_submit_timeline_value(u64 & out) -> daxa_Result;
 
     struct ImplQueueFamily
     {
         u32 queue_count = {};
         u32 vk_index = ~0u;
+        bool supports_sparse_binding = {};
     };
-    std::array<ImplQueueFamily, 3> queue_families = {};
+    std::array<ImplQueueFamily, QUEUE_FAMILY_COUNT> queue_families = {};
 
-    std::array<u32,3> valid_vk_queue_families = {};
+    std::array<u32, QUEUE_FAMILY_COUNT> valid_vk_queue_families = {};
     u32 valid_vk_queue_family_count = {};
 
     auto validate_image_slice(daxa_ImageMipArraySlice const & slice, daxa_ImageId id) -> daxa_ImageMipArraySlice;
@@ -174,6 +376,11 @@ struct daxa_ImplDevice final : public ImplHandle
     void zombify_sampler(SamplerId id);
     void zombify_tlas(TlasId id);
     void zombify_blas(BlasId id);
+    // Zombify many ids with a single timeline read and zombies_mtx acquisition.
+    void zombify_buffers(std::span<BufferId const> ids);
+    void zombify_images(std::span<ImageId const> ids);
+    void zombify_image_views(std::span<ImageViewId const> ids);
+    void zombify_samplers(std::span<SamplerId const> ids);
 
     static auto create_2(daxa_Instance instance, daxa_DeviceInfo2 const& info, ImplPhysicalDevice const & physical_device, daxa_DeviceProperties const & properties, daxa_Device device) -> daxa_Result;
     static auto create(daxa_Instance instance, daxa_DeviceInfo const & info, VkPhysicalDevice physical_device, daxa_Device device) -> daxa_Result;
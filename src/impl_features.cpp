@@ -150,8 +150,128 @@ namespace daxa
             chain = static_cast<void *>(&physical_device_shader_atomic_float_features_ext);
         }
 
+        if (extensions.extensions_present[extensions.physical_device_descriptor_buffer_ext])
+        {
+            physical_device_descriptor_buffer_features_ext.pNext = chain;
+            physical_device_descriptor_buffer_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_descriptor_buffer_features_ext);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_multi_draw_ext])
+        {
+            physical_device_multi_draw_features_ext.pNext = chain;
+            physical_device_multi_draw_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_multi_draw_features_ext);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_maintenance_5_khr])
+        {
+            physical_device_maintenance5_features_khr.pNext = chain;
+            physical_device_maintenance5_features_khr.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR;
+            chain = static_cast<void *>(&physical_device_maintenance5_features_khr);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_device_generated_commands_ext])
+        {
+            physical_device_device_generated_commands_features_ext.pNext = chain;
+            physical_device_device_generated_commands_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEVICE_GENERATED_COMMANDS_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_device_generated_commands_features_ext);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_pipeline_binary_khr])
+        {
+            physical_device_pipeline_binary_features_khr.pNext = chain;
+            physical_device_pipeline_binary_features_khr.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_BINARY_FEATURES_KHR;
+            chain = static_cast<void *>(&physical_device_pipeline_binary_features_khr);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_pipeline_library_khr] &&
+            extensions.extensions_present[extensions.physical_device_graphics_pipeline_library_ext])
+        {
+            physical_device_graphics_pipeline_library_features_ext.pNext = chain;
+            physical_device_graphics_pipeline_library_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_graphics_pipeline_library_features_ext);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_shader_object_ext])
+        {
+            physical_device_shader_object_features_ext.pNext = chain;
+            physical_device_shader_object_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_shader_object_features_ext);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_conditional_rendering_ext])
+        {
+            physical_device_conditional_rendering_features_ext.pNext = chain;
+            physical_device_conditional_rendering_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_conditional_rendering_features_ext);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_memory_decompression_nv])
+        {
+            physical_device_memory_decompression_features_nv.pNext = chain;
+            physical_device_memory_decompression_features_nv.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_DECOMPRESSION_FEATURES_NV;
+            chain = static_cast<void *>(&physical_device_memory_decompression_features_nv);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_present_id_khr])
+        {
+            physical_device_present_id_features_khr.pNext = chain;
+            physical_device_present_id_features_khr.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+            chain = static_cast<void *>(&physical_device_present_id_features_khr);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_present_wait_khr])
+        {
+            physical_device_present_wait_features_khr.pNext = chain;
+            physical_device_present_wait_features_khr.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+            chain = static_cast<void *>(&physical_device_present_wait_features_khr);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_opacity_micromap_ext])
+        {
+            physical_device_opacity_micromap_features_ext.pNext = chain;
+            physical_device_opacity_micromap_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_OPACITY_MICROMAP_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_opacity_micromap_features_ext);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_cooperative_matrix_khr])
+        {
+            physical_device_cooperative_matrix_features_khr.pNext = chain;
+            physical_device_cooperative_matrix_features_khr.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_KHR;
+            chain = static_cast<void *>(&physical_device_cooperative_matrix_features_khr);
+        }
+
+        if (extensions.extensions_present[extensions.physical_device_video_maintenance_1_khr])
+        {
+            physical_device_video_maintenance1_features_khr.pNext = chain;
+            physical_device_video_maintenance1_features_khr.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VIDEO_MAINTENANCE_1_FEATURES_KHR;
+            chain = static_cast<void *>(&physical_device_video_maintenance1_features_khr);
+        }
+
         conservative_rasterization = extensions.extensions_present[extensions.physical_device_conservative_rasterization_ext];
         swapchain = extensions.extensions_present[extensions.physical_device_swapchain_khr];
+        memory_budget = extensions.extensions_present[extensions.physical_device_memory_budget_ext] ? VK_TRUE : VK_FALSE;
+        low_latency2 = extensions.extensions_present[extensions.physical_device_low_latency2_nv] ? VK_TRUE : VK_FALSE;
+        display_timing = extensions.extensions_present[extensions.physical_device_display_timing_google] ? VK_TRUE : VK_FALSE;
+        calibrated_timestamps = extensions.extensions_present[extensions.physical_device_calibrated_timestamps_khr] ? VK_TRUE : VK_FALSE;
+#if defined(_WIN32)
+        external_memory = (extensions.extensions_present[extensions.physical_device_external_memory_win32_khr] &&
+                           extensions.extensions_present[extensions.physical_device_external_semaphore_win32_khr])
+                              ? VK_TRUE
+                              : VK_FALSE;
+#else
+        external_memory = (extensions.extensions_present[extensions.physical_device_external_memory_fd_khr] &&
+                           extensions.extensions_present[extensions.physical_device_external_semaphore_fd_khr])
+                              ? VK_TRUE
+                              : VK_FALSE;
+#endif
+        external_memory_dma_buf = (external_memory && extensions.extensions_present[extensions.physical_device_external_memory_dma_buf_ext]) ? VK_TRUE : VK_FALSE;
+        video_queue = (extensions.extensions_present[extensions.physical_device_video_queue_khr] &&
+                       (extensions.extensions_present[extensions.physical_device_video_decode_queue_khr] ||
+                        extensions.extensions_present[extensions.physical_device_video_encode_queue_khr]))
+                          ? VK_TRUE
+                          : VK_FALSE;
 
         physical_device_features_2.pNext = chain;
         physical_device_features_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
@@ -276,6 +396,87 @@ namespace daxa
         offsetof(PhysicalDeviceFeaturesStruct, swapchain),
     };
 
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_BUDGET_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, memory_budget),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_features_2.features.sparseBinding),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_features_2.features.sparseResidencyBuffer),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_features_2.features.sparseResidencyImage2D),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_multi_draw_features_ext.multiDraw),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_maintenance5_features_khr.maintenance5),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_device_generated_commands_features_ext.deviceGeneratedCommands),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_BINARY_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_maintenance5_features_khr.maintenance5),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_pipeline_binary_features_khr.pipelineBinaries),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_GRAPHICS_PIPELINE_LIBRARY_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_graphics_pipeline_library_features_ext.graphicsPipelineLibrary),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_shader_object_features_ext.shaderObject),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_conditional_rendering_features_ext.conditionalRendering),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_STATISTICS_QUERY_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_features_2.features.pipelineStatisticsQuery),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_PRECISE_OCCLUSION_QUERY_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_features_2.features.occlusionQueryPrecise),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_DECOMPRESSION_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_memory_decompression_features_nv.memoryDecompression),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_PRESENT_WAIT_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_present_id_features_khr.presentId),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_present_wait_features_khr.presentWait),
+    };
+
+    // Latency markers are tagged with present ids, so low latency also needs present ids.
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_LOW_LATENCY_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_present_id_features_khr.presentId),
+        offsetof(PhysicalDeviceFeaturesStruct, low_latency2),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, display_timing),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_opacity_micromap_features_ext.micromap),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, calibrated_timestamps),
+    };
+
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_EXTERNAL_MEMORY_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, external_memory),
+    };
+
+    // Video maintenance 1 allows video profile independent images and buffers, so daxa resources do not need to know their video session.
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_VIDEO_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, video_queue),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_video_maintenance1_features_khr.videoMaintenance1),
+    };
+
     constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_SHADER_ATOMIC_FLOAT_VK_FEATURES = std::array{
         offsetof(PhysicalDeviceFeaturesStruct, physical_device_shader_atomic_float_features_ext.shaderBufferFloat32Atomics),
         offsetof(PhysicalDeviceFeaturesStruct, physical_device_shader_atomic_float_features_ext.shaderBufferFloat32AtomicAdd),
@@ -299,6 +500,24 @@ namespace daxa
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_DYNAMIC_STATE_3_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_DYNAMIC_STATE_3},
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_SHADER_ATOMIC_FLOAT_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_SHADER_ATOMIC_FLOAT},
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_SWAPCHAIN_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_SWAPCHAIN},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_BUDGET_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_BUDGET},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_SPARSE_BINDING},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_BINARY_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_BINARY},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_GRAPHICS_PIPELINE_LIBRARY_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_GRAPHICS_PIPELINE_LIBRARY},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_CONDITIONAL_RENDERING},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_STATISTICS_QUERY_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_STATISTICS_QUERY},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_PRECISE_OCCLUSION_QUERY_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_PRECISE_OCCLUSION_QUERY},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_DECOMPRESSION_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_MEMORY_DECOMPRESSION},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_PRESENT_WAIT_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_PRESENT_WAIT},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_LOW_LATENCY_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_LOW_LATENCY},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_EXTERNAL_MEMORY_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_EXTERNAL_MEMORY},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_VIDEO_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_VIDEO},
     };
 
     // === Explicit Features ===
@@ -333,11 +552,24 @@ namespace daxa
         offsetof(PhysicalDeviceFeaturesStruct, physical_device_vulkan_memory_model_features.vulkanMemoryModelDeviceScope),
     };
 
+    constexpr static std::array PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_descriptor_buffer_features_ext.descriptorBuffer),
+    };
+
+    // GL_KHR_cooperative_matrix and slangs CoopMat require the vulkan memory model.
+    constexpr static std::array PHYSICAL_DEVICE_COOPERATIVE_MATRIX_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_cooperative_matrix_features_khr.cooperativeMatrix),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_vulkan_memory_model_features.vulkanMemoryModel),
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_vulkan_memory_model_features.vulkanMemoryModelDeviceScope),
+    };
+
     constexpr static std::array EXPLICIT_FEATURES = std::array{
         ExplicitFeature{PHYSICAL_DEVICE_ROBUSTNESS_2_EXT_VK_FEATURES, DAXA_EXPLICIT_FEATURE_FLAG_ROBUSTNESS_2},
         ExplicitFeature{PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_CAPTURE_REPLAY_VK_FEATURES, DAXA_EXPLICIT_FEATURE_FLAG_BUFFER_DEVICE_ADDRESS_CAPTURE_REPLAY},
         ExplicitFeature{PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_CAPTURE_REPLAY_VK_FEATURES, DAXA_EXPLICIT_FEATURE_FLAG_ACCELERATION_STRUCTURE_CAPTURE_REPLAY},
         ExplicitFeature{PHYSICAL_DEVICE_VK_MEMORY_MODEL_VK_FEATURES, DAXA_EXPLICIT_FEATURE_FLAG_VK_MEMORY_MODEL},
+        ExplicitFeature{PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_VK_FEATURES, DAXA_EXPLICIT_FEATURE_FLAG_DESCRIPTOR_BUFFER},
+        ExplicitFeature{PHYSICAL_DEVICE_COOPERATIVE_MATRIX_VK_FEATURES, DAXA_EXPLICIT_FEATURE_FLAG_COOPERATIVE_MATRIX},
     };
 
     // === Feature Processing ===
@@ -427,7 +659,7 @@ namespace daxa
         }
     }
 
-    void DevicePropertiesStruct::initialize(daxa_DeviceImplicitFeatureFlagBits implicit_features)
+    void DevicePropertiesStruct::initialize(daxa_DeviceImplicitFeatureFlagBits implicit_features, daxa_DeviceExplicitFeatureFlagBits explicit_features)
     {
         void * chain = {};
 
@@ -459,11 +691,37 @@ namespace daxa
             chain = static_cast<void *>(&physical_device_mesh_shader_properties_ext);
         }
 
+        if (explicit_features & DAXA_EXPLICIT_FEATURE_FLAG_COOPERATIVE_MATRIX)
+        {
+            physical_device_cooperative_matrix_properties_khr.pNext = chain;
+            physical_device_cooperative_matrix_properties_khr.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_PROPERTIES_KHR;
+            chain = static_cast<void *>(&physical_device_cooperative_matrix_properties_khr);
+        }
+
         physical_device_properties_2.pNext = chain;
         physical_device_properties_2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
     }
 
-    void fill_daxa_device_properties(PhysicalDeviceExtensionsStruct const & extensions, PhysicalDeviceFeaturesStruct const & features, VkPhysicalDevice physical_device, daxa_DeviceProperties * out)
+    auto is_dedicated_transfer_queue_family(VkQueueFamilyProperties const & queue_props) -> bool
+    {
+        return (queue_props.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_VIDEO_DECODE_BIT_KHR | VK_QUEUE_VIDEO_ENCODE_BIT_KHR)) == 0 &&
+               (queue_props.queueFlags & VK_QUEUE_TRANSFER_BIT) != 0;
+    }
+
+    auto find_video_queue_family(std::span<VkQueueFamilyProperties const> queue_props, std::span<VkQueueFamilyVideoPropertiesKHR const> queue_video_props, VkQueueFlagBits video_bit) -> u32
+    {
+        for (u32 i = 0; i < static_cast<u32>(queue_video_props.size()); ++i)
+        {
+            bool const supports_graphics_or_compute = (queue_props[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) != 0;
+            if (!supports_graphics_or_compute && (queue_props[i].queueFlags & video_bit) != 0 && queue_video_props[i].videoCodecOperations != 0)
+            {
+                return i;
+            }
+        }
+        return ~0u;
+    }
+
+    void fill_daxa_device_properties(PhysicalDeviceExtensionsStruct const & extensions, PhysicalDeviceFeaturesStruct const & features, VkPhysicalDevice physical_device, std::span<VkQueueFamilyProperties const> queue_props, std::span<VkQueueFamilyVideoPropertiesKHR const> queue_video_props, daxa_DeviceProperties * out)
     {
         auto flags = create_feature_flags(features);
         out->implicit_features = flags.first;
@@ -472,7 +730,7 @@ namespace daxa
         out->missing_required_feature = create_problem_flags(features);
 
         DevicePropertiesStruct properties_struct = {};
-        properties_struct.initialize(out->implicit_features);
+        properties_struct.initialize(out->implicit_features, out->explicit_features);
 
         vkGetPhysicalDeviceProperties2(physical_device, &properties_struct.physical_device_properties_2);
 
@@ -519,14 +777,14 @@ namespace daxa
             out->mesh_shader_properties.value.prefers_compact_vertex_output = static_cast<daxa_Bool8>(properties_struct.physical_device_mesh_shader_properties_ext.prefersCompactVertexOutput);
             out->mesh_shader_properties.value.prefers_compact_primitive_output = static_cast<daxa_Bool8>(properties_struct.physical_device_mesh_shader_properties_ext.prefersCompactPrimitiveOutput);
         }
+        if (out->explicit_features & DAXA_EXPLICIT_FEATURE_FLAG_COOPERATIVE_MATRIX)
+        {
+            // The shapes are queried with an instance function, see daxa_ImplInstance::initialize_physical_devices.
+            out->cooperative_matrix_properties.has_value = 1;
+            out->cooperative_matrix_properties.value.supported_stages = properties_struct.physical_device_cooperative_matrix_properties_khr.cooperativeMatrixSupportedStages;
+        }
 
-        u32 queue_family_props_count = 0;
-        std::vector<VkQueueFamilyProperties> queue_props;
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_props_count, nullptr);
-        queue_props.resize(queue_family_props_count);
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_props_count, queue_props.data());
-        std::vector<VkBool32> supports_present;
-        supports_present.resize(queue_family_props_count);
+        u32 const queue_family_props_count = static_cast<u32>(queue_props.size());
 
         out->compute_queue_count = ~0u;
         out->transfer_queue_count = ~0u;
@@ -539,7 +797,7 @@ namespace daxa
             {
                 out->compute_queue_count = std::min(queue_props[i].queueCount, DAXA_MAX_COMPUTE_QUEUE_COUNT);
             }
-            if (out->transfer_queue_count == ~0u && !supports_graphics && !supports_compute && supports_transfer)
+            if (out->transfer_queue_count == ~0u && is_dedicated_transfer_queue_family(queue_props[i]))
             {
                 out->transfer_queue_count = std::min(queue_props[i].queueCount, DAXA_MAX_TRANSFER_QUEUE_COUNT);
             }
@@ -552,5 +810,21 @@ namespace daxa
         {
             out->transfer_queue_count = 0u;
         }
+        if (out->implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO)
+        {
+            u32 const decode_family = find_video_queue_family(queue_props, queue_video_props, VK_QUEUE_VIDEO_DECODE_BIT_KHR);
+            if (decode_family != ~0u)
+            {
+                out->video_decode_queue_count = std::min(queue_props[decode_family].queueCount, DAXA_MAX_VIDEO_DECODE_QUEUE_COUNT);
+                out->video_decode_codec_operations = queue_video_props[decode_family].videoCodecOperations;
+            }
+            u32 const encode_family = find_video_queue_family(queue_props, queue_video_props, VK_QUEUE_VIDEO_ENCODE_BIT_KHR);
+            // Families exposing decode and encode are only used for decoding.
+            if (encode_family != ~0u && encode_family != decode_family)
+            {
+                out->video_encode_queue_count = std::min(queue_props[encode_family].queueCount, DAXA_MAX_VIDEO_ENCODE_QUEUE_COUNT);
+                out->video_encode_codec_operations = queue_video_props[encode_family].videoCodecOperations;
+            }
+        }
     }
 } // namespace daxa
\ No newline at end of file
@@ -58,6 +58,36 @@ namespace daxa
             physical_device_mesh_shader_ext,
             physical_device_ray_tracing_invocation_reorder_nv,
             physical_device_shader_atomic_float_ext,
+            physical_device_descriptor_buffer_ext,
+            physical_device_memory_budget_ext,
+            physical_device_multi_draw_ext,
+            physical_device_maintenance_5_khr,
+            physical_device_device_generated_commands_ext,
+            physical_device_pipeline_binary_khr,
+            physical_device_graphics_pipeline_library_ext,
+            physical_device_shader_object_ext,
+            physical_device_conditional_rendering_ext,
+            physical_device_memory_decompression_nv,
+            physical_device_present_id_khr,
+            physical_device_present_wait_khr,
+            physical_device_low_latency2_nv,
+            physical_device_display_timing_google,
+            physical_device_opacity_micromap_ext,
+            physical_device_calibrated_timestamps_khr,
+            physical_device_cooperative_matrix_khr,
+            physical_device_video_queue_khr,
+            physical_device_video_decode_queue_khr,
+            physical_device_video_encode_queue_khr,
+            physical_device_video_decode_h264_khr,
+            physical_device_video_decode_h265_khr,
+            physical_device_video_encode_h264_khr,
+            physical_device_video_encode_h265_khr,
+            physical_device_video_maintenance_1_khr,
+            physical_device_external_memory_fd_khr,
+            physical_device_external_semaphore_fd_khr,
+            physical_device_external_memory_dma_buf_ext,
+            physical_device_external_memory_win32_khr,
+            physical_device_external_semaphore_win32_khr,
             COUNT
         };
         constexpr static std::array<char const *, COUNT> extension_names = {
@@ -76,6 +106,42 @@ namespace daxa
             VK_EXT_MESH_SHADER_EXTENSION_NAME,
             VK_NV_RAY_TRACING_INVOCATION_REORDER_EXTENSION_NAME,
             VK_EXT_SHADER_ATOMIC_FLOAT_EXTENSION_NAME,
+            VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+            VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+            VK_EXT_MULTI_DRAW_EXTENSION_NAME,
+            VK_KHR_MAINTENANCE_5_EXTENSION_NAME,
+            VK_EXT_DEVICE_GENERATED_COMMANDS_EXTENSION_NAME,
+            VK_KHR_PIPELINE_BINARY_EXTENSION_NAME,
+            VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+            VK_EXT_SHADER_OBJECT_EXTENSION_NAME,
+            VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME,
+            VK_NV_MEMORY_DECOMPRESSION_EXTENSION_NAME,
+            VK_KHR_PRESENT_ID_EXTENSION_NAME,
+            VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+            VK_NV_LOW_LATENCY_2_EXTENSION_NAME,
+            VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
+            VK_EXT_OPACITY_MICROMAP_EXTENSION_NAME,
+            VK_KHR_CALIBRATED_TIMESTAMPS_EXTENSION_NAME,
+            VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME,
+            VK_KHR_VIDEO_QUEUE_EXTENSION_NAME,
+            VK_KHR_VIDEO_DECODE_QUEUE_EXTENSION_NAME,
+            VK_KHR_VIDEO_ENCODE_QUEUE_EXTENSION_NAME,
+            VK_KHR_VIDEO_DECODE_H264_EXTENSION_NAME,
+            VK_KHR_VIDEO_DECODE_H265_EXTENSION_NAME,
+            VK_KHR_VIDEO_ENCODE_H264_EXTENSION_NAME,
+            VK_KHR_VIDEO_ENCODE_H265_EXTENSION_NAME,
+            VK_KHR_VIDEO_MAINTENANCE_1_EXTENSION_NAME,
+            VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME,
+            VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME,
+            VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME,
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+            VK_KHR_EXTERNAL_MEMORY_WIN32_EXTENSION_NAME,
+            VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME,
+#else
+            // vulkan_win32.h is only included on windows, the extensions are never present elsewhere.
+            "VK_KHR_external_memory_win32",
+            "VK_KHR_external_semaphore_win32",
+#endif
         };
         char const * extension_name_list[COUNT] = {};
         u32 extension_name_list_size = {};
@@ -109,7 +175,35 @@ namespace daxa
         VkPhysicalDeviceRayTracingPositionFetchFeaturesKHR physical_device_ray_tracing_position_fetch_features_khr = {};
         VkPhysicalDeviceRayTracingInvocationReorderFeaturesNV physical_device_ray_tracing_invocation_reorder_features_nv = {};
         VkPhysicalDeviceShaderAtomicFloatFeaturesEXT physical_device_shader_atomic_float_features_ext = {};
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT physical_device_descriptor_buffer_features_ext = {};
+        VkPhysicalDeviceMultiDrawFeaturesEXT physical_device_multi_draw_features_ext = {};
+        VkPhysicalDeviceMaintenance5FeaturesKHR physical_device_maintenance5_features_khr = {};
+        VkPhysicalDeviceDeviceGeneratedCommandsFeaturesEXT physical_device_device_generated_commands_features_ext = {};
+        VkPhysicalDevicePipelineBinaryFeaturesKHR physical_device_pipeline_binary_features_khr = {};
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT physical_device_graphics_pipeline_library_features_ext = {};
+        VkPhysicalDeviceShaderObjectFeaturesEXT physical_device_shader_object_features_ext = {};
+        VkPhysicalDeviceConditionalRenderingFeaturesEXT physical_device_conditional_rendering_features_ext = {};
+        VkPhysicalDeviceMemoryDecompressionFeaturesNV physical_device_memory_decompression_features_nv = {};
+        VkPhysicalDevicePresentIdFeaturesKHR physical_device_present_id_features_khr = {};
+        VkPhysicalDevicePresentWaitFeaturesKHR physical_device_present_wait_features_khr = {};
+        VkPhysicalDeviceOpacityMicromapFeaturesEXT physical_device_opacity_micromap_features_ext = {};
+        VkPhysicalDeviceCooperativeMatrixFeaturesKHR physical_device_cooperative_matrix_features_khr = {};
+        VkPhysicalDeviceVideoMaintenance1FeaturesKHR physical_device_video_maintenance1_features_khr = {};
         VkPhysicalDeviceFeatures2 physical_device_features_2 = {};
+        // No feature struct, set when VK_EXT_memory_budget is present.
+        VkBool32 memory_budget = {};
+        // No feature struct, set when VK_NV_low_latency2 is present.
+        VkBool32 low_latency2 = {};
+        // No feature struct, set when VK_GOOGLE_display_timing is present.
+        VkBool32 display_timing = {};
+        // No feature struct, set when VK_KHR_calibrated_timestamps is present.
+        VkBool32 calibrated_timestamps = {};
+        // No feature struct, set when the external memory and semaphore extensions of the platform are present.
+        VkBool32 external_memory = {};
+        // No feature struct, set when VK_EXT_external_memory_dma_buf is present.
+        VkBool32 external_memory_dma_buf = {};
+        // No feature struct, set when VK_KHR_video_queue and the decode or encode queue extension are present.
+        VkBool32 video_queue = {};
         bool conservative_rasterization = {};
         bool swapchain = {};
 
@@ -128,10 +222,16 @@ namespace daxa
         VkPhysicalDeviceAccelerationStructurePropertiesKHR physical_device_acceleration_structure_properties_khr = {};
         VkPhysicalDeviceRayTracingInvocationReorderPropertiesNV physical_device_ray_tracing_invocation_reorder_properties_nv = {};
         VkPhysicalDeviceMeshShaderPropertiesEXT physical_device_mesh_shader_properties_ext = {};
+        VkPhysicalDeviceCooperativeMatrixPropertiesKHR physical_device_cooperative_matrix_properties_khr = {};
         VkPhysicalDeviceProperties2 physical_device_properties_2 = {};
 
-        void initialize(daxa_DeviceImplicitFeatureFlagBits implicit_features);
+        void initialize(daxa_DeviceImplicitFeatureFlagBits implicit_features, daxa_DeviceExplicitFeatureFlagBits explicit_features);
     };
     
-    void fill_daxa_device_properties(PhysicalDeviceExtensionsStruct const & extensions, PhysicalDeviceFeaturesStruct const & features, VkPhysicalDevice physical_device, daxa_DeviceProperties * out);
+    // Transfer families are dedicated transfer families without video support, video families are picked separately.
+    auto is_dedicated_transfer_queue_family(VkQueueFamilyProperties const & queue_props) -> bool;
+    // Returns the first family with video_bit and codecs that supports neither graphics nor compute, ~0u when there is none.
+    auto find_video_queue_family(std::span<VkQueueFamilyProperties const> queue_props, std::span<VkQueueFamilyVideoPropertiesKHR const> queue_video_props, VkQueueFlagBits video_bit) -> u32;
+
+    void fill_daxa_device_properties(PhysicalDeviceExtensionsStruct const & extensions, PhysicalDeviceFeaturesStruct const & features, VkPhysicalDevice physical_device, std::span<VkQueueFamilyProperties const> queue_props, std::span<VkQueueFamilyVideoPropertiesKHR const> queue_video_props, daxa_DeviceProperties * out);
 } // namespace daxa
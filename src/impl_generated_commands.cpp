@@ -0,0 +1,388 @@
+#include "impl_generated_commands.hpp"
+
+#include <utility>
+
+#include "impl_device.hpp"
+#include "impl_pipeline.hpp"
+
+/// --- Begin Helpers ---
+
+namespace
+{
+    auto is_action_token(daxa_IndirectCommandsTokenType type) -> bool
+    {
+        switch (type)
+        {
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_INDEXED:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_INDEXED_COUNT:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_COUNT:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DISPATCH:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_MESH_TASKS:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_MESH_TASKS_COUNT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // The action token decides which pipeline kind the layout generates commands for.
+    auto action_token_shader_stages(daxa_IndirectCommandsTokenType type) -> VkShaderStageFlags
+    {
+        switch (type)
+        {
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DISPATCH:
+            return VK_SHADER_STAGE_COMPUTE_BIT;
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_MESH_TASKS:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_DRAW_MESH_TASKS_COUNT:
+            return VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        default:
+            return VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        }
+    }
+
+    auto validate_indirect_commands_tokens(daxa_IndirectCommandsLayoutInfo const & info) -> daxa_Result
+    {
+        if (info.token_count < 2 ||
+            info.tokens[0].type != DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_EXECUTION_SET ||
+            !is_action_token(info.tokens[info.token_count - 1].type))
+        {
+            return DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT;
+        }
+        for (u64 i = 1; i < info.token_count - 1; ++i)
+        {
+            auto const & token = info.tokens[i];
+            if (token.type == DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_EXECUTION_SET || is_action_token(token.type))
+            {
+                return DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT;
+            }
+            bool const writes_push_constants =
+                token.type == DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_PUSH_CONSTANT ||
+                token.type == DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_SEQUENCE_INDEX;
+            if (writes_push_constants && token.push_constant_offset + token.push_constant_size > info.push_constant_size)
+            {
+                return DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT;
+            }
+        }
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    void set_debug_name(daxa_Device device, VkObjectType type, u64 handle, daxa_SmallString const & name)
+    {
+        if ((device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) == InstanceFlagBits::NONE || name.size == 0)
+        {
+            return;
+        }
+        std::string const c_name = std::string{std::string_view{name.data, name.size}};
+        VkDebugUtilsObjectNameInfoEXT const name_info{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            .pNext = nullptr,
+            .objectType = type,
+            .objectHandle = handle,
+            .pObjectName = c_name.c_str(),
+        };
+        device->vkSetDebugUtilsObjectNameEXT(device->vk_device, &name_info);
+    }
+
+    void release_pipeline(ImplPipeline * pipeline)
+    {
+        if (pipeline != nullptr)
+        {
+            pipeline->dec_refcnt(&ImplPipeline::zero_ref_callback, pipeline->device->instance);
+        }
+    }
+
+    auto write_pipeline(daxa_IndirectExecutionSet self, u32 index, ImplPipeline * pipeline) -> daxa_Result
+    {
+        if (index >= self->info.max_pipeline_count)
+        {
+            return DAXA_RESULT_RANGE_OUT_OF_BOUNDS;
+        }
+        // Execution sets reference the vk pipeline directly, pending pipelines have none yet.
+        if (pipeline->load_status() != DAXA_PIPELINE_STATUS_READY)
+        {
+            return DAXA_RESULT_ERROR_PIPELINE_NOT_READY;
+        }
+        VkWriteIndirectExecutionSetPipelineEXT const vk_write{
+            .sType = VK_STRUCTURE_TYPE_WRITE_INDIRECT_EXECUTION_SET_PIPELINE_EXT,
+            .pNext = nullptr,
+            .index = index,
+            .pipeline = pipeline->vk_pipeline,
+        };
+        pipeline->inc_refcnt();
+        ImplPipeline * previous = nullptr;
+        {
+            std::unique_lock const lock{self->pipelines_mtx};
+            self->device->vkUpdateIndirectExecutionSetPipelineEXT(self->device->vk_device, self->vk_indirect_execution_set, 1, &vk_write);
+            previous = std::exchange(self->pipelines[index], pipeline);
+        }
+        release_pipeline(previous);
+        return DAXA_RESULT_SUCCESS;
+    }
+} // namespace
+
+/// --- End Helpers ---
+
+// --- Begin API Functions ---
+
+auto daxa_dvc_create_indirect_commands_layout(daxa_Device device, daxa_IndirectCommandsLayoutInfo const * info, daxa_IndirectCommandsLayout * out_layout) -> daxa_Result
+{
+    if ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED;
+    }
+    auto result = validate_indirect_commands_tokens(*info);
+    _DAXA_RETURN_IF_ERROR(result, result)
+    VkPipelineLayout vk_pipeline_layout = {};
+    result = device->gpu_sro_table.pipeline_layout(device->vk_device, info->push_constant_size, vk_pipeline_layout);
+    _DAXA_RETURN_IF_ERROR(result, result)
+
+    auto ret = daxa_ImplIndirectCommandsLayout{};
+    ret.device = device;
+    ret.info = *info;
+    ret.tokens.assign(info->tokens, info->tokens + info->token_count);
+    ret.info.tokens = ret.tokens.data();
+    ret.vk_shader_stages =
+        action_token_shader_stages(info->tokens[info->token_count - 1].type) &
+        device->device_generated_commands_properties.supportedIndirectCommandsShaderStages;
+
+    // Token data is referenced by pointer, the vectors are sized up front so the pointers stay stable.
+    std::vector<VkIndirectCommandsPushConstantTokenEXT> vk_push_constant_tokens = {};
+    vk_push_constant_tokens.reserve(info->token_count);
+    VkIndirectCommandsExecutionSetTokenEXT const vk_execution_set_token{
+        .type = VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT,
+        .shaderStages = ret.vk_shader_stages,
+    };
+    VkIndirectCommandsIndexBufferTokenEXT const vk_index_buffer_token{
+        .mode = VK_INDIRECT_COMMANDS_INPUT_MODE_VULKAN_INDEX_BUFFER_EXT,
+    };
+    std::vector<VkIndirectCommandsLayoutTokenEXT> vk_tokens = {};
+    vk_tokens.reserve(info->token_count);
+    for (auto const & token : ret.tokens)
+    {
+        VkIndirectCommandsTokenDataEXT vk_data = {};
+        switch (token.type)
+        {
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_EXECUTION_SET:
+            vk_data.pExecutionSet = &vk_execution_set_token;
+            break;
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_PUSH_CONSTANT:
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_SEQUENCE_INDEX:
+            vk_data.pPushConstant = &vk_push_constant_tokens.emplace_back(VkIndirectCommandsPushConstantTokenEXT{
+                .updateRange = VkPushConstantRange{
+                    .stageFlags = VK_SHADER_STAGE_ALL,
+                    .offset = token.push_constant_offset,
+                    .size = token.push_constant_size,
+                },
+            });
+            break;
+        case DAXA_INDIRECT_COMMANDS_TOKEN_TYPE_INDEX_BUFFER:
+            vk_data.pIndexBuffer = &vk_index_buffer_token;
+            break;
+        default:
+            break;
+        }
+        vk_tokens.push_back(VkIndirectCommandsLayoutTokenEXT{
+            .sType = VK_STRUCTURE_TYPE_INDIRECT_COMMANDS_LAYOUT_TOKEN_EXT,
+            .pNext = nullptr,
+            .type = static_cast<VkIndirectCommandsTokenTypeEXT>(token.type),
+            .data = vk_data,
+            .offset = token.offset,
+        });
+    }
+
+    VkIndirectCommandsLayoutCreateInfoEXT const vk_create_info{
+        .sType = VK_STRUCTURE_TYPE_INDIRECT_COMMANDS_LAYOUT_CREATE_INFO_EXT,
+        .pNext = nullptr,
+        .flags = info->unordered_sequences != 0 ? static_cast<VkIndirectCommandsLayoutUsageFlagsEXT>(VK_INDIRECT_COMMANDS_LAYOUT_USAGE_UNORDERED_SEQUENCES_BIT_EXT) : VkIndirectCommandsLayoutUsageFlagsEXT{},
+        .shaderStages = ret.vk_shader_stages,
+        .indirectStride = info->indirect_stride,
+        .pipelineLayout = vk_pipeline_layout,
+        .tokenCount = static_cast<u32>(vk_tokens.size()),
+        .pTokens = vk_tokens.data(),
+    };
+    auto vk_result = device->vkCreateIndirectCommandsLayoutEXT(device->vk_device, &vk_create_info, nullptr, &ret.vk_indirect_commands_layout);
+    if (vk_result != VK_SUCCESS)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+    set_debug_name(device, VK_OBJECT_TYPE_INDIRECT_COMMANDS_LAYOUT_EXT, std::bit_cast<u64>(ret.vk_indirect_commands_layout), ret.info.name);
+
+    ret.strong_count = 1;
+    device->inc_weak_refcnt();
+    *out_layout = new daxa_ImplIndirectCommandsLayout{};
+    **out_layout = std::move(ret);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_indirect_commands_layout_info(daxa_IndirectCommandsLayout self) -> daxa_IndirectCommandsLayoutInfo const *
+{
+    return &self->info;
+}
+
+auto daxa_indirect_commands_layout_inc_refcnt(daxa_IndirectCommandsLayout self) -> u64
+{
+    return self->inc_refcnt();
+}
+
+auto daxa_indirect_commands_layout_dec_refcnt(daxa_IndirectCommandsLayout self) -> u64
+{
+    return self->dec_refcnt(
+        &daxa_ImplIndirectCommandsLayout::zero_ref_callback,
+        self->device->instance);
+}
+
+auto daxa_dvc_create_indirect_execution_set(daxa_Device device, daxa_IndirectExecutionSetInfo const * info, daxa_IndirectExecutionSet * out_execution_set) -> daxa_Result
+{
+    if ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED;
+    }
+    ImplPipeline * initial_pipeline = nullptr;
+    if (info->initial_compute_pipeline != nullptr && info->initial_raster_pipeline == nullptr)
+    {
+        initial_pipeline = info->initial_compute_pipeline;
+    }
+    else if (info->initial_compute_pipeline == nullptr && info->initial_raster_pipeline != nullptr)
+    {
+        initial_pipeline = info->initial_raster_pipeline;
+    }
+    else
+    {
+        return DAXA_RESULT_ERROR_INVALID_INDIRECT_COMMANDS_LAYOUT;
+    }
+    if (info->max_pipeline_count == 0)
+    {
+        return DAXA_RESULT_RANGE_OUT_OF_BOUNDS;
+    }
+    if (initial_pipeline->load_status() != DAXA_PIPELINE_STATUS_READY)
+    {
+        return DAXA_RESULT_ERROR_PIPELINE_NOT_READY;
+    }
+
+    VkIndirectExecutionSetPipelineInfoEXT const vk_pipeline_info{
+        .sType = VK_STRUCTURE_TYPE_INDIRECT_EXECUTION_SET_PIPELINE_INFO_EXT,
+        .pNext = nullptr,
+        .initialPipeline = initial_pipeline->vk_pipeline,
+        .maxPipelineCount = info->max_pipeline_count,
+    };
+    VkIndirectExecutionSetCreateInfoEXT const vk_create_info{
+        .sType = VK_STRUCTURE_TYPE_INDIRECT_EXECUTION_SET_CREATE_INFO_EXT,
+        .pNext = nullptr,
+        .type = VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT,
+        .info = VkIndirectExecutionSetInfoEXT{.pPipelineInfo = &vk_pipeline_info},
+    };
+    VkIndirectExecutionSetEXT vk_indirect_execution_set = {};
+    auto vk_result = device->vkCreateIndirectExecutionSetEXT(device->vk_device, &vk_create_info, nullptr, &vk_indirect_execution_set);
+    if (vk_result != VK_SUCCESS)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+    set_debug_name(device, VK_OBJECT_TYPE_INDIRECT_EXECUTION_SET_EXT, std::bit_cast<u64>(vk_indirect_execution_set), info->name);
+
+    // Holds a mutex, so it is built in place instead of moved in.
+    auto * ret = new daxa_ImplIndirectExecutionSet{};
+    ret->device = device;
+    ret->info = *info;
+    ret->vk_indirect_execution_set = vk_indirect_execution_set;
+    ret->pipelines.resize(info->max_pipeline_count, nullptr);
+    ret->pipelines[0] = initial_pipeline;
+    initial_pipeline->inc_refcnt();
+    ret->strong_count = 1;
+    device->inc_weak_refcnt();
+    *out_execution_set = ret;
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_indirect_execution_set_info(daxa_IndirectExecutionSet self) -> daxa_IndirectExecutionSetInfo const *
+{
+    return &self->info;
+}
+
+auto daxa_indirect_execution_set_write_compute_pipeline(daxa_IndirectExecutionSet self, u32 index, daxa_ComputePipeline pipeline) -> daxa_Result
+{
+    return write_pipeline(self, index, pipeline);
+}
+
+auto daxa_indirect_execution_set_write_raster_pipeline(daxa_IndirectExecutionSet self, u32 index, daxa_RasterPipeline pipeline) -> daxa_Result
+{
+    return write_pipeline(self, index, pipeline);
+}
+
+auto daxa_indirect_execution_set_inc_refcnt(daxa_IndirectExecutionSet self) -> u64
+{
+    return self->inc_refcnt();
+}
+
+auto daxa_indirect_execution_set_dec_refcnt(daxa_IndirectExecutionSet self) -> u64
+{
+    return self->dec_refcnt(
+        &daxa_ImplIndirectExecutionSet::zero_ref_callback,
+        self->device->instance);
+}
+
+auto daxa_dvc_generated_commands_memory_requirements(daxa_Device self, daxa_GeneratedCommandsMemoryRequirementsInfo const * info) -> VkMemoryRequirements
+{
+    if ((self->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return VkMemoryRequirements{};
+    }
+    VkGeneratedCommandsMemoryRequirementsInfoEXT const vk_info{
+        .sType = VK_STRUCTURE_TYPE_GENERATED_COMMANDS_MEMORY_REQUIREMENTS_INFO_EXT,
+        .pNext = nullptr,
+        .indirectExecutionSet = info->execution_set->vk_indirect_execution_set,
+        .indirectCommandsLayout = info->layout->vk_indirect_commands_layout,
+        .maxSequenceCount = info->max_sequence_count,
+        .maxDrawCount = info->max_draw_count,
+    };
+    VkMemoryRequirements2 mem_requirements{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = nullptr,
+        .memoryRequirements = {},
+    };
+    self->vkGetGeneratedCommandsMemoryRequirementsEXT(self->vk_device, &vk_info, &mem_requirements);
+    return mem_requirements.memoryRequirements;
+}
+
+// --- End API Functions ---
+
+// --- Begin Internals ---
+
+void daxa_ImplIndirectCommandsLayout::zero_ref_callback(ImplHandle const * handle)
+{
+    auto * self = rc_cast<daxa_IndirectCommandsLayout>(handle);
+    std::unique_lock const lock{self->device->zombies_mtx};
+    u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    self->device->generated_commands_zombies.emplace_back(
+        submit_timeline,
+        GeneratedCommandsZombie{
+            .vk_indirect_commands_layout = self->vk_indirect_commands_layout,
+        });
+    self->device->dec_weak_refcnt(
+        daxa_ImplDevice::zero_ref_callback,
+        self->device->instance);
+    delete self;
+}
+
+void daxa_ImplIndirectExecutionSet::zero_ref_callback(ImplHandle const * handle)
+{
+    auto * self = rc_cast<daxa_IndirectExecutionSet>(handle);
+    // The pipelines become zombies on the same timeline value as the set, so they outlive every pending use of it.
+    for (auto * pipeline : self->pipelines)
+    {
+        release_pipeline(pipeline);
+    }
+    std::unique_lock const lock{self->device->zombies_mtx};
+    u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    self->device->generated_commands_zombies.emplace_back(
+        submit_timeline,
+        GeneratedCommandsZombie{
+            .vk_indirect_execution_set = self->vk_indirect_execution_set,
+        });
+    self->device->dec_weak_refcnt(
+        daxa_ImplDevice::zero_ref_callback,
+        self->device->instance);
+    delete self;
+}
+
+// --- End Internals ---
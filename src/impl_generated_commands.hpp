@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <daxa/c/pipeline.h>
+
+#include "impl_core.hpp"
+
+namespace daxa
+{
+    struct GeneratedCommandsZombie
+    {
+        VkIndirectCommandsLayoutEXT vk_indirect_commands_layout = {};
+        VkIndirectExecutionSetEXT vk_indirect_execution_set = {};
+    };
+} // namespace daxa
+
+struct ImplPipeline;
+
+struct daxa_ImplIndirectCommandsLayout final : ImplHandle
+{
+    daxa_Device device = {};
+    daxa_IndirectCommandsLayoutInfo info = {};
+    // Backs info.tokens.
+    std::vector<daxa_IndirectCommandsToken> tokens = {};
+    VkShaderStageFlags vk_shader_stages = {};
+    VkIndirectCommandsLayoutEXT vk_indirect_commands_layout = {};
+
+    static void zero_ref_callback(ImplHandle const * handle);
+};
+
+struct daxa_ImplIndirectExecutionSet final : ImplHandle
+{
+    daxa_Device device = {};
+    daxa_IndirectExecutionSetInfo info = {};
+    VkIndirectExecutionSetEXT vk_indirect_execution_set = {};
+    // One strong ref per written slot, released when overwritten or when the set dies.
+    std::mutex pipelines_mtx = {};
+    std::vector<ImplPipeline *> pipelines = {};
+
+    static void zero_ref_callback(ImplHandle const * handle);
+};
@@ -34,8 +34,62 @@ namespace daxa
         }
     }
 
+    namespace
+    {
+        auto growable_set_index(u32 binding) -> usize
+        {
+            switch (binding)
+            {
+            case DAXA_STORAGE_BUFFER_BINDING: return DAXA_STORAGE_BUFFER_SET - 1;
+            case DAXA_STORAGE_IMAGE_BINDING: return DAXA_STORAGE_IMAGE_SET - 1;
+            case DAXA_SAMPLED_IMAGE_BINDING: return DAXA_SAMPLED_IMAGE_SET - 1;
+            default: return ~usize{0};
+            }
+        }
+
+        auto allocate_growable_descriptor_set(VkDevice device, GrowableDescriptorSet const & growable_set, u32 capacity, VkDescriptorPool & out_pool, VkDescriptorSet & out_set) -> daxa_Result
+        {
+            VkDescriptorPoolSize const pool_size{
+                .type = growable_set.vk_descriptor_type,
+                .descriptorCount = capacity,
+            };
+            VkDescriptorPoolCreateInfo const vk_descriptor_pool_create_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .pNext = nullptr,
+                .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+                .maxSets = 1,
+                .poolSizeCount = 1,
+                .pPoolSizes = &pool_size,
+            };
+            auto result = static_cast<daxa_Result>(vkCreateDescriptorPool(device, &vk_descriptor_pool_create_info, nullptr, &out_pool));
+            _DAXA_RETURN_IF_ERROR(result, result)
+
+            VkDescriptorSetVariableDescriptorCountAllocateInfo const variable_count_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+                .pNext = nullptr,
+                .descriptorSetCount = 1,
+                .pDescriptorCounts = &capacity,
+            };
+            VkDescriptorSetAllocateInfo const vk_descriptor_set_allocate_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .pNext = &variable_count_info,
+                .descriptorPool = out_pool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &growable_set.vk_descriptor_set_layout,
+            };
+            result = static_cast<daxa_Result>(vkAllocateDescriptorSets(device, &vk_descriptor_set_allocate_info, &out_set));
+            if (result != DAXA_RESULT_SUCCESS)
+            {
+                vkDestroyDescriptorPool(device, out_pool, nullptr);
+                out_pool = {};
+            }
+            return result;
+        }
+    } // namespace
+
     auto GPUShaderResourceTable::initialize(u32 max_buffers, u32 max_images, u32 max_samplers, u32 max_acceleration_structures,
-                                            VkDevice device, VkBuffer device_address_buffer,
+                                            VkDevice device, VkPhysicalDevice physical_device, VmaAllocator vma_allocator,
+                                            bool use_descriptor_buffer, VkBuffer device_address_buffer,
                                             PFN_vkSetDebugUtilsObjectNameEXT vkSetDebugUtilsObjectNameEXT) -> daxa_Result
     {
         daxa_Result result = DAXA_RESULT_SUCCESS;
@@ -43,6 +97,22 @@ namespace daxa
         {
             if (result != DAXA_RESULT_SUCCESS)
             {
+                if (this->vk_descriptor_buffer)
+                {
+                    vmaDestroyBuffer(vma_allocator, this->vk_descriptor_buffer, this->descriptor_buffer_allocation);
+                    this->vk_descriptor_buffer = {};
+                }
+                for (auto & growable_set : this->growable_sets)
+                {
+                    if (growable_set.vk_descriptor_pool)
+                    {
+                        vkDestroyDescriptorPool(device, growable_set.vk_descriptor_pool, nullptr);
+                    }
+                    if (growable_set.vk_descriptor_set_layout)
+                    {
+                        vkDestroyDescriptorSetLayout(device, growable_set.vk_descriptor_set_layout, nullptr);
+                    }
+                }
                 if (this->vk_descriptor_pool)
                 {
                     vkDestroyDescriptorPool(device, this->vk_descriptor_pool, nullptr);
@@ -65,89 +135,30 @@ namespace daxa
             blas_slots.max_resources = 1'000'000; // TODO(Raytracing): Should we have a smarter limit?
         }
 
-        VkDescriptorPoolSize const buffer_descriptor_pool_size{
-            .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            .descriptorCount = buffer_slots.max_resources + 1,
-        };
-
-        VkDescriptorPoolSize const storage_image_descriptor_pool_size{
-            .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-            .descriptorCount = image_slots.max_resources,
-        };
-
-        VkDescriptorPoolSize const sampled_image_descriptor_pool_size{
-            .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-            .descriptorCount = image_slots.max_resources,
-        };
-
-        VkDescriptorPoolSize const sampler_descriptor_pool_size{
-            .type = VK_DESCRIPTOR_TYPE_SAMPLER,
-            .descriptorCount = sampler_slots.max_resources,
-        };
-
-        auto pool_sizes = std::vector{
-            buffer_descriptor_pool_size,
-            storage_image_descriptor_pool_size,
-            sampled_image_descriptor_pool_size,
-            sampler_descriptor_pool_size,
-        };
-        if (ray_tracing_enabled)
+        this->uses_descriptor_buffer = use_descriptor_buffer;
+        if (use_descriptor_buffer)
         {
-            VkDescriptorPoolSize const as_descriptor_pool_size{
-                .type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
-                .descriptorCount = tlas_slots.max_resources,
+            this->descriptor_buffer_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+            this->descriptor_buffer_properties.pNext = nullptr;
+            VkPhysicalDeviceProperties2 vk_properties2{
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &this->descriptor_buffer_properties,
+                .properties = {},
             };
-            pool_sizes.push_back(as_descriptor_pool_size);
+            vkGetPhysicalDeviceProperties2(physical_device, &vk_properties2);
+            this->vkGetDescriptorEXT = r_cast<PFN_vkGetDescriptorEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorEXT"));
+            this->pipeline_create_flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
         }
 
-        VkDescriptorPoolCreateInfo const vk_descriptor_pool_create_info{
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT | VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
-            .maxSets = 1,
-            .poolSizeCount = static_cast<u32>(pool_sizes.size()),
-            .pPoolSizes = pool_sizes.data(),
-        };
-
-        result = static_cast<daxa_Result>(vkCreateDescriptorPool(device, &vk_descriptor_pool_create_info, nullptr, &this->vk_descriptor_pool));
-        _DAXA_RETURN_IF_ERROR(result, result)
-
-        if (vkSetDebugUtilsObjectNameEXT != nullptr)
-        {
-            auto const * descriptor_pool_name = "mega descriptor pool";
-            VkDebugUtilsObjectNameInfoEXT const descriptor_pool_name_info{
-                .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
-                .pNext = nullptr,
-                .objectType = VK_OBJECT_TYPE_DESCRIPTOR_POOL,
-                .objectHandle = std::bit_cast<uint64_t>(vk_descriptor_pool),
-                .pObjectName = descriptor_pool_name,
-            };
-            vkSetDebugUtilsObjectNameEXT(device, &descriptor_pool_name_info);
-        }
-
-        VkDescriptorSetLayoutBinding const buffer_descriptor_set_layout_binding{
-            .binding = DAXA_STORAGE_BUFFER_BINDING,
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            .descriptorCount = static_cast<u32>(buffer_slots.max_resources),
-            .stageFlags = VK_SHADER_STAGE_ALL,
-            .pImmutableSamplers = nullptr,
-        };
-
-        VkDescriptorSetLayoutBinding const storage_image_descriptor_set_layout_binding{
-            .binding = DAXA_STORAGE_IMAGE_BINDING,
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-            .descriptorCount = static_cast<u32>(image_slots.max_resources),
-            .stageFlags = VK_SHADER_STAGE_ALL,
-            .pImmutableSamplers = nullptr,
-        };
+        // Descriptor buffers are always updatable after binding, the update after bind flags are not allowed on them.
+        VkDescriptorBindingFlags const binding_flags = use_descriptor_buffer
+                                                           ? VkDescriptorBindingFlags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT}
+                                                           : VkDescriptorBindingFlags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT};
+        VkDescriptorSetLayoutCreateFlags const layout_flags = use_descriptor_buffer
+                                                                  ? VkDescriptorSetLayoutCreateFlags{VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT}
+                                                                  : VkDescriptorSetLayoutCreateFlags{VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT};
 
-        VkDescriptorSetLayoutBinding const sampled_image_descriptor_set_layout_binding{
-            .binding = DAXA_SAMPLED_IMAGE_BINDING,
-            .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-            .descriptorCount = static_cast<u32>(image_slots.max_resources),
-            .stageFlags = VK_SHADER_STAGE_ALL,
-            .pImmutableSamplers = nullptr,
-        };
+        // --- Fixed set ---
 
         VkDescriptorSetLayoutBinding const sampler_descriptor_set_layout_binding{
             .binding = DAXA_SAMPLER_BINDING,
@@ -166,9 +177,6 @@ namespace daxa
         };
 
         auto descriptor_set_layout_bindings = std::vector{
-            buffer_descriptor_set_layout_binding,
-            storage_image_descriptor_set_layout_binding,
-            sampled_image_descriptor_set_layout_binding,
             sampler_descriptor_set_layout_binding,
             buffer_address_buffer_descriptor_set_layout_binding,
         };
@@ -185,17 +193,7 @@ namespace daxa
             descriptor_set_layout_bindings.push_back(as_descriptor_set_layout_binding);
         }
 
-        auto vk_descriptor_binding_flags = std::vector{
-            VkDescriptorBindingFlags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT},
-            VkDescriptorBindingFlags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT},
-            VkDescriptorBindingFlags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT},
-            VkDescriptorBindingFlags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT},
-            VkDescriptorBindingFlags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT},
-        };
-        if (ray_tracing_enabled)
-        {
-            vk_descriptor_binding_flags.push_back({VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT});
-        }
+        auto vk_descriptor_binding_flags = std::vector(descriptor_set_layout_bindings.size(), binding_flags);
 
         VkDescriptorSetLayoutBindingFlagsCreateInfo vk_descriptor_set_layout_binding_flags_create_info{
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
@@ -207,7 +205,7 @@ namespace daxa
         VkDescriptorSetLayoutCreateInfo const vk_descriptor_set_layout_create_info{
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
             .pNext = &vk_descriptor_set_layout_binding_flags_create_info,
-            .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+            .flags = layout_flags,
             .bindingCount = static_cast<u32>(descriptor_set_layout_bindings.size()),
             .pBindings = descriptor_set_layout_bindings.data(),
         };
@@ -228,81 +226,252 @@ namespace daxa
             vkSetDebugUtilsObjectNameEXT(device, &name_info);
         }
 
-        VkDescriptorSetAllocateInfo const vk_descriptor_set_allocate_info{
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-            .pNext = nullptr,
-            .descriptorPool = this->vk_descriptor_pool,
-            .descriptorSetCount = 1,
-            .pSetLayouts = &this->vk_descriptor_set_layout,
-        };
+        // --- Growable sets ---
 
-        result = static_cast<daxa_Result>(vkAllocateDescriptorSets(device, &vk_descriptor_set_allocate_info, &this->vk_descriptor_set));
-        _DAXA_RETURN_IF_ERROR(result, result)
-
-        if (vkSetDebugUtilsObjectNameEXT != nullptr)
+        auto const growable_set_infos = std::array{
+            std::tuple{u32{DAXA_STORAGE_BUFFER_BINDING}, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffer_slots.max_resources, "storage buffer"},
+            std::tuple{u32{DAXA_STORAGE_IMAGE_BINDING}, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, image_slots.max_resources, "storage image"},
+            std::tuple{u32{DAXA_SAMPLED_IMAGE_BINDING}, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, image_slots.max_resources, "sampled image"},
+        };
+        for (auto const & [binding, vk_descriptor_type, max_capacity, name] : growable_set_infos)
         {
-            auto const * name = "mega descriptor set";
-            VkDebugUtilsObjectNameInfoEXT const name_info{
-                .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            auto & growable_set = this->growable_sets.at(growable_set_index(binding));
+            growable_set.binding = binding;
+            growable_set.vk_descriptor_type = vk_descriptor_type;
+            growable_set.max_capacity = max_capacity;
+
+            // The layout always declares the maximum capacity, the actual count is chosen on allocation.
+            VkDescriptorSetLayoutBinding const growable_binding{
+                .binding = binding,
+                .descriptorType = vk_descriptor_type,
+                .descriptorCount = max_capacity,
+                .stageFlags = VK_SHADER_STAGE_ALL,
+                .pImmutableSamplers = nullptr,
+            };
+            VkDescriptorBindingFlags const growable_binding_flags = binding_flags | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+            VkDescriptorSetLayoutBindingFlagsCreateInfo const growable_binding_flags_create_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
                 .pNext = nullptr,
-                .objectType = VK_OBJECT_TYPE_DESCRIPTOR_SET,
-                .objectHandle = std::bit_cast<uint64_t>(vk_descriptor_set),
-                .pObjectName = name,
+                .bindingCount = 1,
+                .pBindingFlags = &growable_binding_flags,
             };
-            vkSetDebugUtilsObjectNameEXT(device, &name_info);
-        }
+            VkDescriptorSetLayoutCreateInfo const growable_layout_create_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                .pNext = &growable_binding_flags_create_info,
+                .flags = layout_flags,
+                .bindingCount = 1,
+                .pBindings = &growable_binding,
+            };
+            result = static_cast<daxa_Result>(vkCreateDescriptorSetLayout(device, &growable_layout_create_info, nullptr, &growable_set.vk_descriptor_set_layout));
+            _DAXA_RETURN_IF_ERROR(result, result)
 
-        auto vk_descriptor_set_layouts = std::array{this->vk_descriptor_set_layout};
-        VkPipelineLayoutCreateInfo vk_pipeline_create_info{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = {},
-            .setLayoutCount = static_cast<u32>(vk_descriptor_set_layouts.size()),
-            .pSetLayouts = vk_descriptor_set_layouts.data(),
-            .pushConstantRangeCount = 0,
-            .pPushConstantRanges = nullptr,
-        };
+            if (vkSetDebugUtilsObjectNameEXT != nullptr)
+            {
+                auto layout_name = fmt::format("mega {} descriptor set layout", name);
+                VkDebugUtilsObjectNameInfoEXT const name_info{
+                    .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+                    .pNext = nullptr,
+                    .objectType = VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+                    .objectHandle = std::bit_cast<uint64_t>(growable_set.vk_descriptor_set_layout),
+                    .pObjectName = layout_name.c_str(),
+                };
+                vkSetDebugUtilsObjectNameEXT(device, &name_info);
+            }
+        }
 
-        result = static_cast<daxa_Result>(vkCreatePipelineLayout(device, &vk_pipeline_create_info, nullptr, pipeline_layouts.data()));
-        _DAXA_RETURN_IF_ERROR(result, result)
+        auto & vk_descriptor_set_layouts = this->vk_descriptor_set_layouts;
+        vk_descriptor_set_layouts.at(DAXA_GPU_TABLE_SET_BINDING) = this->vk_descriptor_set_layout;
+        for (auto const & growable_set : this->growable_sets)
+        {
+            vk_descriptor_set_layouts.at(growable_set_index(growable_set.binding) + 1) = growable_set.vk_descriptor_set_layout;
+        }
 
-        if (vkSetDebugUtilsObjectNameEXT != nullptr)
+        if (use_descriptor_buffer)
         {
-            auto const * name = "pipeline layout (push constant size 0)";
-            VkDebugUtilsObjectNameInfoEXT const name_info{
-                .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSizeEXT = r_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutSizeEXT"));
+            PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffsetEXT = r_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutBindingOffsetEXT"));
+            // All sets are placed back to back in one buffer, each at their maximum size.
+            VkDeviceSize const alignment = this->descriptor_buffer_properties.descriptorBufferOffsetAlignment;
+            VkDeviceSize buffer_size = {};
+            for (u32 set = 0; set < DESCRIPTOR_SET_COUNT; ++set)
+            {
+                this->descriptor_buffer_set_offsets.at(set) = buffer_size;
+                VkDeviceSize layout_size = {};
+                vkGetDescriptorSetLayoutSizeEXT(device, vk_descriptor_set_layouts.at(set), &layout_size);
+                buffer_size += (layout_size + alignment - 1) / alignment * alignment;
+            }
+            auto store_binding_offset = [&](u32 set, u32 binding)
+            {
+                VkDeviceSize binding_offset = {};
+                vkGetDescriptorSetLayoutBindingOffsetEXT(device, vk_descriptor_set_layouts.at(set), binding, &binding_offset);
+                this->descriptor_buffer_binding_offsets.at(binding) = this->descriptor_buffer_set_offsets.at(set) + binding_offset;
+            };
+            for (auto const & binding : descriptor_set_layout_bindings)
+            {
+                store_binding_offset(DAXA_GPU_TABLE_SET_BINDING, binding.binding);
+            }
+            for (auto & growable_set : this->growable_sets)
+            {
+                store_binding_offset(static_cast<u32>(growable_set_index(growable_set.binding) + 1), growable_set.binding);
+                growable_set.capacity.store(growable_set.max_capacity, std::memory_order_relaxed);
+            }
+
+            // The table contains samplers, so the buffer must be usable as both resource and sampler descriptor buffer.
+            this->descriptor_buffer_usage =
+                VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+            VkBufferCreateInfo const descriptor_buffer_create_info{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
                 .pNext = nullptr,
-                .objectType = VK_OBJECT_TYPE_PIPELINE_LAYOUT,
-                .objectHandle = std::bit_cast<uint64_t>(*pipeline_layouts.data()),
-                .pObjectName = name,
+                .flags = {},
+                .size = buffer_size,
+                .usage = this->descriptor_buffer_usage,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .queueFamilyIndexCount = 0,
+                .pQueueFamilyIndices = nullptr,
             };
-            vkSetDebugUtilsObjectNameEXT(device, &name_info);
-        }
+            VmaAllocationCreateInfo const descriptor_buffer_allocation_create_info{
+                .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+                .usage = VMA_MEMORY_USAGE_AUTO,
+                .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                .preferredFlags = {},
+                .memoryTypeBits = std::numeric_limits<u32>::max(),
+                .pool = nullptr,
+                .pUserData = nullptr,
+                .priority = 0.5f,
+            };
+            VmaAllocationInfo descriptor_buffer_allocation_info = {};
+            result = static_cast<daxa_Result>(vmaCreateBuffer(vma_allocator, &descriptor_buffer_create_info, &descriptor_buffer_allocation_create_info, &this->vk_descriptor_buffer, &this->descriptor_buffer_allocation, &descriptor_buffer_allocation_info));
+            _DAXA_RETURN_IF_ERROR(result, result)
+            this->descriptor_buffer_host_ptr = r_cast<std::byte *>(descriptor_buffer_allocation_info.pMappedData);
+            // Start out with a zeroed table, slots that were never written are treated like unwritten partially bound descriptors.
+            std::memset(this->descriptor_buffer_host_ptr, 0, descriptor_buffer_create_info.size);
+
+            VkBufferDeviceAddressInfo const descriptor_buffer_address_info{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .pNext = nullptr,
+                .buffer = this->vk_descriptor_buffer,
+            };
+            this->descriptor_buffer_device_address = vkGetBufferDeviceAddress(device, &descriptor_buffer_address_info);
 
-        for (usize i = 1; i < PIPELINE_LAYOUT_COUNT; ++i)
+            if (vkSetDebugUtilsObjectNameEXT != nullptr)
+            {
+                auto const * name = "mega descriptor buffer";
+                VkDebugUtilsObjectNameInfoEXT const name_info{
+                    .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+                    .pNext = nullptr,
+                    .objectType = VK_OBJECT_TYPE_BUFFER,
+                    .objectHandle = std::bit_cast<uint64_t>(this->vk_descriptor_buffer),
+                    .pObjectName = name,
+                };
+                vkSetDebugUtilsObjectNameEXT(device, &name_info);
+            }
+        }
+        else
         {
-            VkPushConstantRange const vk_push_constant_range{
-                .stageFlags = VK_SHADER_STAGE_ALL,
-                .offset = 0,
-                .size = static_cast<u32>(i * 4),
+            auto pool_sizes = std::vector{
+                VkDescriptorPoolSize{
+                    .type = VK_DESCRIPTOR_TYPE_SAMPLER,
+                    .descriptorCount = sampler_slots.max_resources,
+                },
+                VkDescriptorPoolSize{
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .descriptorCount = 1,
+                },
+            };
+            if (ray_tracing_enabled)
+            {
+                pool_sizes.push_back(VkDescriptorPoolSize{
+                    .type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+                    .descriptorCount = tlas_slots.max_resources,
+                });
+            }
+
+            VkDescriptorPoolCreateInfo const vk_descriptor_pool_create_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .pNext = nullptr,
+                .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT | VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+                .maxSets = 1,
+                .poolSizeCount = static_cast<u32>(pool_sizes.size()),
+                .pPoolSizes = pool_sizes.data(),
             };
-            vk_pipeline_create_info.pushConstantRangeCount = 1;
-            vk_pipeline_create_info.pPushConstantRanges = &vk_push_constant_range;
-            result = static_cast<daxa_Result>(vkCreatePipelineLayout(device, &vk_pipeline_create_info, nullptr, &pipeline_layouts.at(i)));
+
+            result = static_cast<daxa_Result>(vkCreateDescriptorPool(device, &vk_descriptor_pool_create_info, nullptr, &this->vk_descriptor_pool));
             _DAXA_RETURN_IF_ERROR(result, result)
 
             if (vkSetDebugUtilsObjectNameEXT != nullptr)
             {
-                auto name = fmt::format("pipeline layout (push constant size {})", i * 4);
+                auto const * descriptor_pool_name = "mega descriptor pool";
+                VkDebugUtilsObjectNameInfoEXT const descriptor_pool_name_info{
+                    .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+                    .pNext = nullptr,
+                    .objectType = VK_OBJECT_TYPE_DESCRIPTOR_POOL,
+                    .objectHandle = std::bit_cast<uint64_t>(vk_descriptor_pool),
+                    .pObjectName = descriptor_pool_name,
+                };
+                vkSetDebugUtilsObjectNameEXT(device, &descriptor_pool_name_info);
+            }
+
+            VkDescriptorSetAllocateInfo const vk_descriptor_set_allocate_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .pNext = nullptr,
+                .descriptorPool = this->vk_descriptor_pool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &this->vk_descriptor_set_layout,
+            };
+
+            result = static_cast<daxa_Result>(vkAllocateDescriptorSets(device, &vk_descriptor_set_allocate_info, &this->vk_descriptor_set));
+            _DAXA_RETURN_IF_ERROR(result, result)
+
+            if (vkSetDebugUtilsObjectNameEXT != nullptr)
+            {
+                auto const * name = "mega descriptor set";
                 VkDebugUtilsObjectNameInfoEXT const name_info{
                     .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
                     .pNext = nullptr,
-                    .objectType = VK_OBJECT_TYPE_PIPELINE_LAYOUT,
-                    .objectHandle = std::bit_cast<uint64_t>(pipeline_layouts.at(i)),
-                    .pObjectName = name.c_str(),
+                    .objectType = VK_OBJECT_TYPE_DESCRIPTOR_SET,
+                    .objectHandle = std::bit_cast<uint64_t>(vk_descriptor_set),
+                    .pObjectName = name,
                 };
                 vkSetDebugUtilsObjectNameEXT(device, &name_info);
             }
+
+            // Growable sets start out with a single page of the resource pool and grow on demand.
+            for (auto & growable_set : this->growable_sets)
+            {
+                u32 const initial_capacity = std::min(growable_set.max_capacity, static_cast<u32>(GpuResourcePool<ImplBufferSlot>::PAGE_SIZE));
+                result = allocate_growable_descriptor_set(device, growable_set, initial_capacity, growable_set.vk_descriptor_pool, growable_set.vk_descriptor_set);
+                _DAXA_RETURN_IF_ERROR(result, result)
+                growable_set.capacity.store(initial_capacity, std::memory_order_relaxed);
+            }
+        }
+
+        // Pipeline layouts are created by pipeline_layout on first use of their push constant size.
+        this->vkSetDebugUtilsObjectNameEXT = vkSetDebugUtilsObjectNameEXT;
+
+        if (use_descriptor_buffer)
+        {
+            VkBufferDeviceAddressInfo const address_info{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .pNext = nullptr,
+                .buffer = device_address_buffer,
+            };
+            VkDescriptorAddressInfoEXT const descriptor_address_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                .pNext = nullptr,
+                .address = vkGetBufferDeviceAddress(device, &address_info),
+                .range = static_cast<VkDeviceSize>(max_buffers + 1) * sizeof(u64),
+                .format = VK_FORMAT_UNDEFINED,
+            };
+            VkDescriptorGetInfoEXT const get_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .pNext = nullptr,
+                .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .data = {.pStorageBuffer = &descriptor_address_info},
+            };
+            this->write_descriptor(device, get_info, DAXA_BUFFER_DEVICE_ADDRESS_BUFFER_BINDING, 0, this->descriptor_buffer_properties.storageBufferDescriptorSize);
+            return result;
         }
 
         VkDescriptorBufferInfo const write_buffer{
@@ -329,7 +498,7 @@ namespace daxa
         return result;
     }
 
-    void GPUShaderResourceTable::cleanup(VkDevice device)
+    void GPUShaderResourceTable::cleanup(VkDevice device, VmaAllocator vma_allocator)
     {
         [[maybe_unused]] auto print_remaining = [&](std::string prefix, auto & pages)
         {
@@ -338,24 +507,24 @@ namespace daxa
             {
                 if (page)
                 {
-                    for (auto & slot : *page)
+                    for (auto & slot : page->slots)
                     {
                         bool handle_invalid = {};
-                        if constexpr (std::is_same_v<decltype(slot.first), ImplBufferSlot>)
+                        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(slot)>, ImplBufferSlot>)
                         {
-                            handle_invalid = slot.first.vk_buffer == VK_NULL_HANDLE;
+                            handle_invalid = slot.vk_buffer == VK_NULL_HANDLE;
                         }
-                        if constexpr (std::is_same_v<decltype(slot.first), ImplImageSlot>)
+                        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(slot)>, ImplImageSlot>)
                         {
-                            handle_invalid = slot.first.vk_image == VK_NULL_HANDLE;
+                            handle_invalid = slot.vk_image == VK_NULL_HANDLE;
                         }
-                        if constexpr (std::is_same_v<decltype(slot.first), ImplSamplerSlot>)
+                        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(slot)>, ImplSamplerSlot>)
                         {
-                            handle_invalid = slot.first.vk_sampler == VK_NULL_HANDLE;
+                            handle_invalid = slot.vk_sampler == VK_NULL_HANDLE;
                         }
                         if (!handle_invalid)
                         {
-                            ret += fmt::format("debug name : \"{}\"", r_cast<SmallString const *>(&slot.first.info.name)->view());
+                            ret += fmt::format("debug name : \"{}\"", r_cast<SmallString const *>(&slot.info.name)->view());
                             ret += "\n";
                         }
                     }
@@ -363,20 +532,254 @@ namespace daxa
             }
             return ret;
         };
-        DAXA_DBG_ASSERT_TRUE_M(buffer_slots.free_index_stack.size() == buffer_slots.next_index, print_remaining("Detected leaked buffers; not all buffers have been destroyed before destroying the device;", buffer_slots.pages));
-        DAXA_DBG_ASSERT_TRUE_M(image_slots.free_index_stack.size() == image_slots.next_index, print_remaining("Detected leaked images; not all images have been destroyed before destroying the device;", image_slots.pages));
-        DAXA_DBG_ASSERT_TRUE_M(sampler_slots.free_index_stack.size() == sampler_slots.next_index, print_remaining("Detected leaked samplers; not all samplers have been destroyed before destroying the device;", sampler_slots.pages));
-        for (usize i = 0; i < PIPELINE_LAYOUT_COUNT; ++i)
+        DAXA_DBG_ASSERT_TRUE_M(buffer_slots.free_count() == buffer_slots.allocated_count(), print_remaining("Detected leaked buffers; not all buffers have been destroyed before destroying the device;", buffer_slots.pages));
+        DAXA_DBG_ASSERT_TRUE_M(image_slots.free_count() == image_slots.allocated_count(), print_remaining("Detected leaked images; not all images have been destroyed before destroying the device;", image_slots.pages));
+        DAXA_DBG_ASSERT_TRUE_M(sampler_slots.free_count() == sampler_slots.allocated_count(), print_remaining("Detected leaked samplers; not all samplers have been destroyed before destroying the device;", sampler_slots.pages));
+        for (auto const & pipeline_layout : this->pipeline_layouts)
         {
-            vkDestroyPipelineLayout(device, pipeline_layouts.at(i), nullptr);
+            VkPipelineLayout const vk_pipeline_layout = pipeline_layout.load(std::memory_order_relaxed);
+            if (vk_pipeline_layout != VK_NULL_HANDLE)
+            {
+                vkDestroyPipelineLayout(device, vk_pipeline_layout, nullptr);
+            }
         }
         vkDestroyDescriptorSetLayout(device, this->vk_descriptor_set_layout, nullptr);
+        for (auto & growable_set : this->growable_sets)
+        {
+            vkDestroyDescriptorSetLayout(device, growable_set.vk_descriptor_set_layout, nullptr);
+            if (growable_set.vk_descriptor_pool)
+            {
+                vkDestroyDescriptorPool(device, growable_set.vk_descriptor_pool, nullptr);
+            }
+        }
+        for (auto & retired_pool : this->retired_descriptor_pools)
+        {
+            vkDestroyDescriptorPool(device, retired_pool.vk_descriptor_pool, nullptr);
+        }
+        this->retired_descriptor_pools.clear();
+        if (this->uses_descriptor_buffer)
+        {
+            vmaDestroyBuffer(vma_allocator, this->vk_descriptor_buffer, this->descriptor_buffer_allocation);
+            return;
+        }
         vkResetDescriptorPool(device, this->vk_descriptor_pool, {});
         vkDestroyDescriptorPool(device, this->vk_descriptor_pool, nullptr);
     }
 
-    void write_descriptor_set_sampler(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkSampler vk_sampler, u32 index)
+    auto GPUShaderResourceTable::pipeline_layout(VkDevice device, u32 push_constant_size, VkPipelineLayout & out_layout) -> daxa_Result
+    {
+        u32 const push_constant_word_size = (push_constant_size + 3) / 4;
+        if (push_constant_word_size >= PIPELINE_LAYOUT_COUNT)
+        {
+            return DAXA_RESULT_ERROR_EXCEEDED_MAX_PUSH_CONSTANT_SIZE;
+        }
+        auto & cached_layout = this->pipeline_layouts.at(push_constant_word_size);
+        out_layout = cached_layout.load(std::memory_order_acquire);
+        if (out_layout != VK_NULL_HANDLE)
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+        std::unique_lock const lock{this->pipeline_layout_creation_mtx};
+        out_layout = cached_layout.load(std::memory_order_relaxed);
+        if (out_layout != VK_NULL_HANDLE)
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+
+        VkPushConstantRange const vk_push_constant_range{
+            .stageFlags = VK_SHADER_STAGE_ALL,
+            .offset = 0,
+            .size = push_constant_word_size * 4,
+        };
+        VkPipelineLayoutCreateInfo const vk_pipeline_create_info{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = {},
+            .setLayoutCount = static_cast<u32>(this->vk_descriptor_set_layouts.size()),
+            .pSetLayouts = this->vk_descriptor_set_layouts.data(),
+            .pushConstantRangeCount = push_constant_word_size > 0 ? 1u : 0u,
+            .pPushConstantRanges = push_constant_word_size > 0 ? &vk_push_constant_range : nullptr,
+        };
+        VkPipelineLayout vk_pipeline_layout = {};
+        auto result = static_cast<daxa_Result>(vkCreatePipelineLayout(device, &vk_pipeline_create_info, nullptr, &vk_pipeline_layout));
+        _DAXA_RETURN_IF_ERROR(result, result)
+
+        if (this->vkSetDebugUtilsObjectNameEXT != nullptr)
+        {
+            auto name = fmt::format("pipeline layout (push constant size {})", push_constant_word_size * 4);
+            VkDebugUtilsObjectNameInfoEXT const name_info{
+                .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+                .pNext = nullptr,
+                .objectType = VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+                .objectHandle = std::bit_cast<uint64_t>(vk_pipeline_layout),
+                .pObjectName = name.c_str(),
+            };
+            this->vkSetDebugUtilsObjectNameEXT(device, &name_info);
+        }
+
+        cached_layout.store(vk_pipeline_layout, std::memory_order_release);
+        out_layout = vk_pipeline_layout;
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    auto GPUShaderResourceTable::ensure_capacity(VkDevice device, u32 binding, u32 required_capacity) -> daxa_Result
+    {
+        auto & growable_set = this->growable_sets.at(growable_set_index(binding));
+        if (growable_set.capacity.load(std::memory_order_acquire) >= required_capacity)
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+        std::unique_lock const lock{this->growth_mtx};
+        u32 const old_capacity = growable_set.capacity.load(std::memory_order_relaxed);
+        if (old_capacity >= required_capacity)
+        {
+            return DAXA_RESULT_SUCCESS;
+        }
+        DAXA_DBG_ASSERT_TRUE_M(required_capacity <= growable_set.max_capacity, "descriptor set capacity exceeds the maximum set on device creation");
+
+        // Grow at least by a page of the resource pool and at least double, so that growing stays rare.
+        constexpr auto PAGE_SIZE = static_cast<u32>(GpuResourcePool<ImplBufferSlot>::PAGE_SIZE);
+        u32 const page_aligned_capacity = (required_capacity + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        u32 const new_capacity = std::min(growable_set.max_capacity, std::max(old_capacity * 2, page_aligned_capacity));
+
+        VkDescriptorPool new_pool = {};
+        VkDescriptorSet new_set = {};
+        auto result = allocate_growable_descriptor_set(device, growable_set, new_capacity, new_pool, new_set);
+        _DAXA_RETURN_IF_ERROR(result, result)
+
+        // Copies every descriptor that could have been written so far, ids stay valid across the growth.
+        VkCopyDescriptorSet const copy{
+            .sType = VK_STRUCTURE_TYPE_COPY_DESCRIPTOR_SET,
+            .pNext = nullptr,
+            .srcSet = growable_set.vk_descriptor_set,
+            .srcBinding = growable_set.binding,
+            .srcArrayElement = 0,
+            .dstSet = new_set,
+            .dstBinding = growable_set.binding,
+            .dstArrayElement = 0,
+            .descriptorCount = old_capacity,
+        };
+        vkUpdateDescriptorSets(device, 0, nullptr, 1, &copy);
+
+        this->retired_descriptor_pools.push_back(RetiredDescriptorPool{.vk_descriptor_pool = growable_set.vk_descriptor_pool});
+        growable_set.vk_descriptor_pool = new_pool;
+        growable_set.vk_descriptor_set = new_set;
+        growable_set.capacity.store(new_capacity, std::memory_order_release);
+        this->generation.fetch_add(1, std::memory_order_release);
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    auto GPUShaderResourceTable::descriptor_set_of_binding(u32 binding) const -> VkDescriptorSet
+    {
+        auto const set_index = growable_set_index(binding);
+        return set_index < GROWABLE_DESCRIPTOR_SET_COUNT ? this->growable_sets.at(set_index).vk_descriptor_set : this->vk_descriptor_set;
+    }
+
+    auto GPUShaderResourceTable::current_descriptor_sets(u64 & out_generation) const -> std::array<VkDescriptorSet, DESCRIPTOR_SET_COUNT>
+    {
+        std::shared_lock const lock{this->growth_mtx};
+        out_generation = this->generation.load(std::memory_order_relaxed);
+        auto ret = std::array<VkDescriptorSet, DESCRIPTOR_SET_COUNT>{};
+        ret.at(DAXA_GPU_TABLE_SET_BINDING) = this->vk_descriptor_set;
+        for (usize i = 0; i < GROWABLE_DESCRIPTOR_SET_COUNT; ++i)
+        {
+            ret.at(i + 1) = this->growable_sets.at(i).vk_descriptor_set;
+        }
+        return ret;
+    }
+
+    void GPUShaderResourceTable::collect_retired_descriptor_pools(VkDevice device, u64 submit_timeline_value, u64 min_pending_timeline_value)
+    {
+        std::unique_lock const lock{this->growth_mtx};
+        std::erase_if(
+            this->retired_descriptor_pools,
+            [&](RetiredDescriptorPool & retired_pool)
+            {
+                if (!retired_pool.timeline_value.has_value())
+                {
+                    if (this->unsubmitted_bound_command_lists.load(std::memory_order_acquire) != 0)
+                    {
+                        return false;
+                    }
+                    // No command recorders or unsubmitted command lists are alive, every submit that might use the old set has at most this timeline value.
+                    retired_pool.timeline_value = submit_timeline_value;
+                }
+                if (retired_pool.timeline_value.value() >= min_pending_timeline_value)
+                {
+                    return false;
+                }
+                vkDestroyDescriptorPool(device, retired_pool.vk_descriptor_pool, nullptr);
+                return true;
+            });
+    }
+
+    void DescriptorWriteBatch::push_image_write(VkWriteDescriptorSet const & write, VkDescriptorImageInfo const & image_info)
     {
+        this->writes.push_back(write);
+        this->writes.back().pImageInfo = nullptr;
+        this->image_infos.push_back(image_info);
+    }
+
+    void DescriptorWriteBatch::push_buffer_write(VkWriteDescriptorSet const & write, VkDescriptorBufferInfo const & buffer_info)
+    {
+        this->writes.push_back(write);
+        this->writes.back().pBufferInfo = nullptr;
+        this->buffer_infos.push_back(buffer_info);
+    }
+
+    void DescriptorWriteBatch::flush(VkDevice vk_device, GPUShaderResourceTable const & table)
+    {
+        if (this->writes.empty())
+        {
+            return;
+        }
+        std::shared_lock const lock{table.growth_mtx};
+        usize image_info_index = 0;
+        usize buffer_info_index = 0;
+        for (auto & write : this->writes)
+        {
+            write.dstSet = table.descriptor_set_of_binding(write.dstBinding);
+            if (write.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+            {
+                write.pBufferInfo = &this->buffer_infos[buffer_info_index++];
+            }
+            else
+            {
+                write.pImageInfo = &this->image_infos[image_info_index++];
+            }
+        }
+        vkUpdateDescriptorSets(vk_device, static_cast<u32>(this->writes.size()), this->writes.data(), 0, nullptr);
+        this->clear();
+    }
+
+    void DescriptorWriteBatch::clear()
+    {
+        this->writes.clear();
+        this->image_infos.clear();
+        this->buffer_infos.clear();
+    }
+
+    void GPUShaderResourceTable::write_descriptor(VkDevice device, VkDescriptorGetInfoEXT const & get_info, u32 binding, u32 index, usize descriptor_size) const
+    {
+        // The descriptor buffer memory is host coherent, the write is visible to the gpu without any flush.
+        std::byte * dst = this->descriptor_buffer_host_ptr + this->descriptor_buffer_binding_offsets.at(binding) + static_cast<usize>(index) * descriptor_size;
+        this->vkGetDescriptorEXT(device, &get_info, descriptor_size, dst);
+    }
+
+    void write_descriptor_set_sampler(VkDevice vk_device, GPUShaderResourceTable const & table, VkSampler vk_sampler, u32 index, DescriptorWriteBatch * opt_batch)
+    {
+        if (table.uses_descriptor_buffer)
+        {
+            VkDescriptorGetInfoEXT const get_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .pNext = nullptr,
+                .type = VK_DESCRIPTOR_TYPE_SAMPLER,
+                .data = {.pSampler = &vk_sampler},
+            };
+            table.write_descriptor(vk_device, get_info, DAXA_SAMPLER_BINDING, index, table.descriptor_buffer_properties.samplerDescriptorSize);
+            return;
+        }
+
         VkDescriptorImageInfo const vk_descriptor_image_info{
             .sampler = vk_sampler,
             .imageView = VK_NULL_HANDLE,
@@ -386,7 +789,7 @@ namespace daxa
         VkWriteDescriptorSet const vk_write_descriptor_set_storage{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext = nullptr,
-            .dstSet = vk_descriptor_set,
+            .dstSet = table.vk_descriptor_set,
             .dstBinding = DAXA_SAMPLER_BINDING,
             .dstArrayElement = index,
             .descriptorCount = 1,
@@ -396,21 +799,53 @@ namespace daxa
             .pTexelBufferView = nullptr,
         };
 
+        if (opt_batch != nullptr)
+        {
+            opt_batch->push_image_write(vk_write_descriptor_set_storage, vk_descriptor_image_info);
+            return;
+        }
         vkUpdateDescriptorSets(vk_device, 1, &vk_write_descriptor_set_storage, 0, nullptr);
     }
 
-    void write_descriptor_set_buffer(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkBuffer vk_buffer, VkDeviceSize offset, VkDeviceSize range, u32 index)
+    void write_descriptor_set_buffer(VkDevice vk_device, GPUShaderResourceTable const & table, VkBuffer vk_buffer, VkDeviceSize offset, VkDeviceSize range, u32 index, DescriptorWriteBatch * opt_batch)
     {
+        if (table.uses_descriptor_buffer)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(range != VK_WHOLE_SIZE, "descriptor buffer writes require an explicit range");
+            VkBufferDeviceAddressInfo const address_info{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .pNext = nullptr,
+                .buffer = vk_buffer,
+            };
+            VkDescriptorAddressInfoEXT const descriptor_address_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                .pNext = nullptr,
+                .address = vkGetBufferDeviceAddress(vk_device, &address_info) + offset,
+                .range = range,
+                .format = VK_FORMAT_UNDEFINED,
+            };
+            VkDescriptorGetInfoEXT const get_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .pNext = nullptr,
+                .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .data = {.pStorageBuffer = &descriptor_address_info},
+            };
+            table.write_descriptor(vk_device, get_info, DAXA_STORAGE_BUFFER_BINDING, index, table.descriptor_buffer_properties.storageBufferDescriptorSize);
+            return;
+        }
+
         VkDescriptorBufferInfo const vk_descriptor_image_info{
             .buffer = vk_buffer,
             .offset = offset,
             .range = range,
         };
 
+        // Keeps the set from being replaced by a growth until the write is done.
+        std::shared_lock const lock{table.growth_mtx};
         VkWriteDescriptorSet const vk_write_descriptor_set{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext = nullptr,
-            .dstSet = vk_descriptor_set,
+            .dstSet = table.descriptor_set_of_binding(DAXA_STORAGE_BUFFER_BINDING),
             .dstBinding = DAXA_STORAGE_BUFFER_BINDING,
             .dstArrayElement = index,
             .descriptorCount = 1,
@@ -420,10 +855,15 @@ namespace daxa
             .pTexelBufferView = nullptr,
         };
 
+        if (opt_batch != nullptr)
+        {
+            opt_batch->push_buffer_write(vk_write_descriptor_set, vk_descriptor_image_info);
+            return;
+        }
         vkUpdateDescriptorSets(vk_device, 1, &vk_write_descriptor_set, 0, nullptr);
     }
 
-    void write_descriptor_set_image(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkImageView vk_image_view, ImageUsageFlags usage, u32 index)
+    void write_descriptor_set_image(VkDevice vk_device, GPUShaderResourceTable const & table, VkImageView vk_image_view, ImageUsageFlags usage, u32 index, DescriptorWriteBatch * opt_batch)
     {
         u32 descriptor_set_write_count = 0;
         std::array<VkWriteDescriptorSet, 2> descriptor_set_writes = {};
@@ -434,10 +874,43 @@ namespace daxa
             .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
         };
 
+        VkDescriptorImageInfo const vk_descriptor_image_info_sampled{
+            .sampler = VK_NULL_HANDLE,
+            .imageView = vk_image_view,
+            .imageLayout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL,
+        };
+
+        if (table.uses_descriptor_buffer)
+        {
+            if ((usage & ImageUsageFlagBits::SHADER_STORAGE) != ImageUsageFlagBits::NONE)
+            {
+                VkDescriptorGetInfoEXT const get_info{
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                    .pNext = nullptr,
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                    .data = {.pStorageImage = &vk_descriptor_image_info},
+                };
+                table.write_descriptor(vk_device, get_info, DAXA_STORAGE_IMAGE_BINDING, index, table.descriptor_buffer_properties.storageImageDescriptorSize);
+            }
+            if ((usage & ImageUsageFlagBits::SHADER_SAMPLED) != ImageUsageFlagBits::NONE)
+            {
+                VkDescriptorGetInfoEXT const get_info{
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                    .pNext = nullptr,
+                    .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                    .data = {.pSampledImage = &vk_descriptor_image_info_sampled},
+                };
+                table.write_descriptor(vk_device, get_info, DAXA_SAMPLED_IMAGE_BINDING, index, table.descriptor_buffer_properties.sampledImageDescriptorSize);
+            }
+            return;
+        }
+
+        // Keeps the sets from being replaced by a growth until the writes are done.
+        std::shared_lock const lock{table.growth_mtx};
         VkWriteDescriptorSet const vk_write_descriptor_set{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext = nullptr,
-            .dstSet = vk_descriptor_set,
+            .dstSet = table.descriptor_set_of_binding(DAXA_STORAGE_IMAGE_BINDING),
             .dstBinding = DAXA_STORAGE_IMAGE_BINDING,
             .dstArrayElement = index,
             .descriptorCount = 1,
@@ -449,19 +922,17 @@ namespace daxa
 
         if ((usage & ImageUsageFlagBits::SHADER_STORAGE) != ImageUsageFlagBits::NONE)
         {
+            if (opt_batch != nullptr)
+            {
+                opt_batch->push_image_write(vk_write_descriptor_set, vk_descriptor_image_info);
+            }
             descriptor_set_writes.at(descriptor_set_write_count++) = vk_write_descriptor_set;
         }
 
-        VkDescriptorImageInfo const vk_descriptor_image_info_sampled{
-            .sampler = VK_NULL_HANDLE,
-            .imageView = vk_image_view,
-            .imageLayout = VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL,
-        };
-
         VkWriteDescriptorSet const vk_write_descriptor_set_sampled{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext = nullptr,
-            .dstSet = vk_descriptor_set,
+            .dstSet = table.descriptor_set_of_binding(DAXA_SAMPLED_IMAGE_BINDING),
             .dstBinding = DAXA_SAMPLED_IMAGE_BINDING,
             .dstArrayElement = index,
             .descriptorCount = 1,
@@ -473,14 +944,34 @@ namespace daxa
 
         if ((usage & ImageUsageFlagBits::SHADER_SAMPLED) != ImageUsageFlagBits::NONE)
         {
+            if (opt_batch != nullptr)
+            {
+                opt_batch->push_image_write(vk_write_descriptor_set_sampled, vk_descriptor_image_info_sampled);
+            }
             descriptor_set_writes.at(descriptor_set_write_count++) = vk_write_descriptor_set_sampled;
         }
 
+        if (opt_batch != nullptr)
+        {
+            return;
+        }
         vkUpdateDescriptorSets(vk_device, descriptor_set_write_count, descriptor_set_writes.data(), 0, nullptr);
     }
 
-    void write_descriptor_set_acceleration_structure(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkAccelerationStructureKHR vk_acceleration_structure, u32 index)
+    void write_descriptor_set_acceleration_structure(VkDevice vk_device, GPUShaderResourceTable const & table, VkAccelerationStructureKHR vk_acceleration_structure, VkDeviceAddress device_address, u32 index)
     {
+        if (table.uses_descriptor_buffer)
+        {
+            VkDescriptorGetInfoEXT const get_info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .pNext = nullptr,
+                .type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+                .data = {.accelerationStructure = device_address},
+            };
+            table.write_descriptor(vk_device, get_info, DAXA_ACCELERATION_STRUCTURE_BINDING, index, table.descriptor_buffer_properties.accelerationStructureDescriptorSize);
+            return;
+        }
+
         VkWriteDescriptorSetAccelerationStructureKHR vk_write_descriptor_set_as = {
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
             .pNext = nullptr,
@@ -491,7 +982,7 @@ namespace daxa
         VkWriteDescriptorSet const vk_write_descriptor_set{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext = &vk_write_descriptor_set_as,
-            .dstSet = vk_descriptor_set,
+            .dstSet = table.vk_descriptor_set,
             .dstBinding = DAXA_ACCELERATION_STRUCTURE_BINDING,
             .dstArrayElement = index,
             .descriptorCount = 1,
@@ -3,8 +3,11 @@
 #include "impl_core.hpp"
 
 #include <daxa/gpu_resources.hpp>
+#include <daxa/daxa.inl>
 
 #include <atomic>
+#include <optional>
+#include <span>
 
 namespace daxa
 {
@@ -14,6 +17,8 @@ namespace daxa
         VkBuffer vk_buffer = {};
         VmaAllocation vma_allocation = {};
         daxa_MemoryBlock opt_memory_block = {};
+        // Dedicated allocation of buffers with external memory, vma can not allocate exportable or imported memory.
+        VkDeviceMemory vk_external_memory = {};
         VkDeviceAddress device_address = {};
         void * host_address = {};
     };
@@ -33,6 +38,8 @@ namespace daxa
         VkImage vk_image = {};
         VmaAllocation vma_allocation = {};
         daxa_MemoryBlock opt_memory_block = {};
+        // Dedicated allocation of images with external memory.
+        VkDeviceMemory vk_external_memory = {};
         i32 swapchain_image_index = NOT_OWNED_BY_SWAPCHAIN;
         VkImageAspectFlags aspect_flags = {}; // Inferred from format.
     };
@@ -65,6 +72,23 @@ namespace daxa
         bool owns_buffer = {};
     };
 
+    // Hot slot data is a copy of the few fields read on hot paths.
+    // It is stored densely next to the versions, apart from the large cold slots holding infos and names.
+    struct ImplNoHotSlot
+    {
+    };
+
+    struct ImplBufferHotSlot
+    {
+        VkDeviceAddress device_address = {};
+        void * host_address = {};
+    };
+
+    struct ImplAccelerationStructureHotSlot
+    {
+        VkDeviceAddress device_address = {};
+    };
+
     /**
      * @brief GpuResourcePool is intended to be used akin to a specialized memory allocator, specific to gpu resource types (like image views).
      *
@@ -76,7 +100,7 @@ namespace daxa
      * To check if these assumptions are met at runtime, the debug define DAXA_GPU_ID_VALIDATION can be enabled.
      * The define enables runtime checking to detect use after free and double free at the cost of performance.
      */
-    template <typename ResourceT>
+    template <typename ResourceT, typename HotT = ImplNoHotSlot>
     struct GpuResourcePool
     {
         static constexpr inline usize MAX_RESOURCE_COUNT = 1u << 20u;
@@ -85,19 +109,82 @@ namespace daxa
         static constexpr inline usize PAGE_MASK = PAGE_SIZE - 1u;
         static constexpr inline usize PAGE_COUNT = MAX_RESOURCE_COUNT / PAGE_SIZE;
         using VersionAndRefcntT = std::atomic_uint64_t;
-        // TODO: split up slots into hot and cold data.
-        using PageT = std::array<std::pair<ResourceT, VersionAndRefcntT>, PAGE_SIZE>;
+        // Structure of arrays, so that version checks and hot data lookups do not drag the cold slot data into cache.
+        struct PageT
+        {
+            std::array<VersionAndRefcntT, PAGE_SIZE> versions = {};
+            std::array<HotT, PAGE_SIZE> hot_slots = {};
+            std::array<ResourceT, PAGE_SIZE> slots = {};
+        };
+        // Per slot link to the next free slot, stored as index + 1. Zero terminates the list.
+        using FreeListPageT = std::array<std::atomic_uint32_t, PAGE_SIZE>;
+        static constexpr inline u64 FREE_LIST_INDEX_MASK = 0xFFFFFFFFull;
+        static constexpr inline u64 FREE_LIST_TAG_SHIFT = 32ull;
 
-        // TODO: replace with lockless queue.
-        std::vector<u32> free_index_stack = {};
-        u32 next_index = {};
+        // Lock free stack of recycled slot indices (Treiber stack).
+        // The lower 32 bits hold the top index + 1 (zero when empty), the upper 32 bits a tag that changes with every push and pop.
+        // The tag protects the compare exchange against ABA, when a slot is popped and pushed again between the load and the exchange.
+        std::atomic_uint64_t free_list_head = {};
+        std::atomic_uint32_t free_index_count = {};
+        std::atomic_uint32_t next_index = {};
         u32 max_resources = {};
 
-        mutable std::mutex mut = {};
         std::mutex page_alloc_mtx = {};
         std::array<std::unique_ptr<PageT>, PAGE_COUNT> pages = {};
+        std::array<std::unique_ptr<FreeListPageT>, PAGE_COUNT> free_list_pages = {};
+        // Plain pointers to the pages, handed out to the header only lookups, see daxa_BufferPoolView.
+        std::array<PageT const *, PAGE_COUNT> page_pointers = {};
         std::atomic_uint32_t valid_page_count = {};
 
+        auto free_list_link(u32 index) -> std::atomic_uint32_t &
+        {
+            return (*this->free_list_pages[static_cast<usize>(index) >> PAGE_BITS])[static_cast<usize>(index) & PAGE_MASK];
+        }
+
+        void push_free_index(u32 index)
+        {
+            u64 head = this->free_list_head.load(std::memory_order_relaxed);
+            u64 new_head = {};
+            do
+            {
+                this->free_list_link(index).store(static_cast<u32>(head & FREE_LIST_INDEX_MASK), std::memory_order_relaxed);
+                u64 const tag = (head >> FREE_LIST_TAG_SHIFT) + 1;
+                new_head = (tag << FREE_LIST_TAG_SHIFT) | (static_cast<u64>(index) + 1);
+                // Release, so that the link and the cleared slot are visible to the thread popping the index.
+            } while (!this->free_list_head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+            this->free_index_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto try_pop_free_index() -> std::optional<u32>
+        {
+            u64 head = this->free_list_head.load(std::memory_order_acquire);
+            while ((head & FREE_LIST_INDEX_MASK) != 0)
+            {
+                u32 const index = static_cast<u32>(head & FREE_LIST_INDEX_MASK) - 1;
+                // The link may be stale when another thread popped the index in the meantime.
+                // In that case the tag changed and the exchange fails.
+                u32 const next = this->free_list_link(index).load(std::memory_order_relaxed);
+                u64 const tag = (head >> FREE_LIST_TAG_SHIFT) + 1;
+                u64 const new_head = (tag << FREE_LIST_TAG_SHIFT) | next;
+                if (this->free_list_head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    this->free_index_count.fetch_sub(1, std::memory_order_relaxed);
+                    return index;
+                }
+            }
+            return std::nullopt;
+        }
+
+        auto free_count() const -> u32
+        {
+            return this->free_index_count.load(std::memory_order_relaxed);
+        }
+
+        auto allocated_count() const -> u32
+        {
+            return this->next_index.load(std::memory_order_relaxed);
+        }
+
         /**
          * @brief   Destroys a slot.
          *          After calling this function, the id of the slot will be forever invalid.
@@ -111,15 +198,15 @@ namespace daxa
         {
             auto const page = static_cast<usize>(id.index) >> PAGE_BITS;
             auto const offset = static_cast<usize>(id.index) & PAGE_MASK;
-            auto const version = this->pages[page]->at(offset).second.load(std::memory_order_relaxed);
+            auto const version = this->pages[page]->versions[offset].load(std::memory_order_relaxed);
             // Slots that reached max version CAN NOT be recycled.
             // That is because we can not guarantee uniqueness of ids when the version wraps back to 0.
             // Clear slot MUST HAPPEN before pushing into free list.
-            this->pages[page]->at(offset).first = {};
+            this->pages[page]->slots[offset] = {};
+            this->pages[page]->hot_slots[offset] = {};
             if (version != DAXA_ID_VERSION_MASK /* this is the maximum value a version is allowed to reach */)
             {
-                std::unique_lock l{mut};
-                this->free_index_stack.push_back(id.index);
+                this->push_free_index(static_cast<u32>(id.index));
             }
         }
 
@@ -134,45 +221,156 @@ namespace daxa
          */
         auto try_create_slot() -> std::optional<std::pair<GPUResourceId, ResourceT &>>
         {
-            u32 index;
+            u32 index = {};
+            if (auto recycled_index = this->try_pop_free_index(); recycled_index.has_value())
             {
-                std::unique_lock l{mut};
-                if (this->free_index_stack.empty())
+                index = recycled_index.value();
+            }
+            else
+            {
+                // No recycled slots, take a fresh index. Never increments past the limit, as the leak check compares against next_index.
+                index = this->next_index.load(std::memory_order_relaxed);
+                do
                 {
-                    index = this->next_index++;
                     if (index >= this->max_resources || index >= MAX_RESOURCE_COUNT)
                     {
                         return std::nullopt;
                     }
-                }
-                else
+                } while (!this->next_index.compare_exchange_weak(index, index + 1, std::memory_order_relaxed, std::memory_order_relaxed));
+            }
+
+            this->ensure_page_allocated(static_cast<usize>(index) >> PAGE_BITS);
+            auto const id = this->slot_id(index);
+            return std::optional{std::pair<GPUResourceId, ResourceT &>(id, this->unsafe_get_reserved_slot(id))};
+        }
+
+        /**
+         * @brief   Creates multiple slots at once, recycled indices are used first.
+         *          All fresh indices are claimed with a single atomic operation.
+         *          The slots must be filled via unsafe_get_reserved_slot and each destroyed with unsafe_destroy_zombie_slot when unused.
+         *
+         * Always threadsafe.
+         *
+         * @return If the slots were created. Fails without creating any slot if max resources would be exceeded.
+         */
+        auto try_create_slots(std::span<GPUResourceId> out_ids) -> bool
+        {
+            usize recycled_count = 0;
+            while (recycled_count < out_ids.size())
+            {
+                auto recycled_index = this->try_pop_free_index();
+                if (!recycled_index.has_value())
                 {
-                    index = this->free_index_stack.back();
-                    this->free_index_stack.pop_back();
+                    break;
                 }
+                out_ids[recycled_count++].index = recycled_index.value();
             }
+            u32 const fresh_count = static_cast<u32>(out_ids.size() - recycled_count);
+            u32 first_fresh_index = this->next_index.load(std::memory_order_relaxed);
+            if (fresh_count > 0)
+            {
+                do
+                {
+                    if (static_cast<u64>(first_fresh_index) + fresh_count > std::min(static_cast<u64>(this->max_resources), static_cast<u64>(MAX_RESOURCE_COUNT)))
+                    {
+                        for (usize i = 0; i < recycled_count; ++i)
+                        {
+                            this->push_free_index(static_cast<u32>(out_ids[i].index));
+                        }
+                        return false;
+                    }
+                } while (!this->next_index.compare_exchange_weak(first_fresh_index, first_fresh_index + fresh_count, std::memory_order_relaxed, std::memory_order_relaxed));
+                this->ensure_page_allocated(static_cast<usize>(first_fresh_index + fresh_count - 1) >> PAGE_BITS);
+            }
+            for (usize i = 0; i < out_ids.size(); ++i)
+            {
+                u32 const index = i < recycled_count ? static_cast<u32>(out_ids[i].index) : first_fresh_index + static_cast<u32>(i - recycled_count);
+                out_ids[i] = this->slot_id(index);
+            }
+            return true;
+        }
+
+        /**
+         * @brief   Returns the mutable slot of an id created by try_create_slot or try_create_slots.
+         *
+         * Only Threadsafe when:
+         * * used before the id is handed out.
+         *
+         * @returns resource.
+         */
+        auto unsafe_get_reserved_slot(GPUResourceId id) -> ResourceT &
+        {
+            auto const page = static_cast<usize>(id.index) >> PAGE_BITS;
+            auto const offset = static_cast<usize>(id.index) & PAGE_MASK;
+            return this->pages[page]->slots[offset];
+        }
 
+        /**
+         * @brief   Claims all fresh indices below end, so that unsafe_prepare_claimed_slot can hand out any of them with a chosen version.
+         *          Used by capture replays to recreate resources with their captured ids.
+         *          Claimed indices that are never prepared must be pushed into the free list, or they are reported as leaked.
+         *
+         * Only Threadsafe when:
+         * * no other thread creates slots in the pool until all claimed indices are prepared or freed.
+         *
+         * @return The first claimed index. Fails when an index at or above first was already handed out or end exceeds max resources.
+         */
+        auto unsafe_claim_indices(u32 first, u32 end) -> std::optional<u32>
+        {
+            u32 const first_claimed = this->next_index.load(std::memory_order_relaxed);
+            if (first_claimed > first || end > this->max_resources || end > MAX_RESOURCE_COUNT)
+            {
+                return std::nullopt;
+            }
+            if (end > first_claimed)
+            {
+                this->ensure_page_allocated(static_cast<usize>(end - 1) >> PAGE_BITS);
+                this->next_index.store(end, std::memory_order_relaxed);
+            }
+            return first_claimed;
+        }
+
+        /**
+         * @brief   Makes the next created slot use the given claimed index and version.
+         *
+         * Only Threadsafe when:
+         * * no other thread creates slots in the pool until the slot is created.
+         */
+        void unsafe_prepare_claimed_slot(GPUResourceId id)
+        {
+            auto const page = static_cast<usize>(id.index) >> PAGE_BITS;
+            auto const offset = static_cast<usize>(id.index) & PAGE_MASK;
+            this->pages[page]->versions[offset].store(id.version, std::memory_order_relaxed);
+            this->push_free_index(static_cast<u32>(id.index));
+        }
+
+        auto slot_id(u32 index) const -> GPUResourceId
+        {
             auto const page = static_cast<usize>(index) >> PAGE_BITS;
             auto const offset = static_cast<usize>(index) & PAGE_MASK;
+            u64 const version = this->pages[page]->versions[offset].load(std::memory_order_relaxed);
+            return GPUResourceId{.index = static_cast<u64>(index), .version = version};
+        }
 
+        // Pages are allocated in order, so all pages up to and including the given one are valid afterwards.
+        void ensure_page_allocated(usize page)
+        {
             if (page >= this->valid_page_count.load(std::memory_order_seq_cst))
             {
                 std::unique_lock l{page_alloc_mtx};
-                if (page >= this->valid_page_count.load(std::memory_order_relaxed))
+                for (usize new_page = this->valid_page_count.load(std::memory_order_relaxed); new_page <= page; ++new_page)
                 {
-                    this->pages[page] = std::make_unique<PageT>();
+                    this->pages[new_page] = std::make_unique<PageT>();
+                    this->free_list_pages[new_page] = std::make_unique<FreeListPageT>();
                     for (u32 i = 0; i < PAGE_SIZE; ++i)
                     {
-                        this->pages[page]->at(i).second.store(1ull, std::memory_order_relaxed);
+                        this->pages[new_page]->versions[i].store(1ull, std::memory_order_relaxed);
                     }
+                    this->page_pointers[new_page] = this->pages[new_page].get();
                     // Needs to be sequential, so that the 0 writes to the versions are visible before the atomic op.
                     this->valid_page_count.fetch_add(1, std::memory_order_seq_cst);
                 }
             }
-            u64 version = this->pages[page]->at(offset).second.load(std::memory_order_relaxed);
-
-            auto const id = GPUResourceId{.index = static_cast<u64>(index), .version = version};
-            return std::optional{std::pair<GPUResourceId, ResourceT &>(id, this->pages[page]->at(offset).first)};
         }
 
         auto try_zombify(GPUResourceId id) -> bool
@@ -185,7 +383,7 @@ namespace daxa
             auto const offset = static_cast<usize>(id.index) & PAGE_MASK;
             u64 version = id.version;
             u64 const new_version = version + 1;
-            return (*this->pages[page])[offset].second.compare_exchange_strong(
+            return this->pages[page]->versions[offset].compare_exchange_strong(
                 version, new_version,
                 std::memory_order_relaxed,
                 std::memory_order_relaxed);
@@ -205,7 +403,7 @@ namespace daxa
             {
                 return false;
             }
-            u64 const slot_version = (*this->pages[page])[offset].second.load(std::memory_order_relaxed);
+            u64 const slot_version = this->pages[page]->versions[offset].load(std::memory_order_relaxed);
             return slot_version == id.version;
         }
 
@@ -225,26 +423,114 @@ namespace daxa
             // Clamp so we get some random slot in error case but never invalid memory!
             page = std::min(static_cast<usize>(this->valid_page_count.load(std::memory_order_relaxed)) - 1, page);
             auto const offset = static_cast<usize>(id.index) & PAGE_MASK;
-            return pages[page]->at(offset).first;
+            return pages[page]->slots[offset];
         }
+
+        /**
+         * @brief   Returns the hot data of a slot, with the same guarantees as unsafe_get.
+         *
+         * @returns hot resource data.
+         */
+        auto unsafe_get_hot(GPUResourceId id) const -> HotT const &
+        {
+            auto page = static_cast<usize>(id.index) >> PAGE_BITS;
+            page = std::min(static_cast<usize>(this->valid_page_count.load(std::memory_order_relaxed)) - 1, page);
+            auto const offset = static_cast<usize>(id.index) & PAGE_MASK;
+            return pages[page]->hot_slots[offset];
+        }
+
+        /**
+         * @brief   Mutable hot data of a slot.
+         *
+         * Only Threadsafe when:
+         * * used on a slot returned by try_create_slot, before the id is handed out.
+         *
+         * @returns hot resource data.
+         */
+        auto unsafe_get_hot_mut(GPUResourceId id) -> HotT &
+        {
+            auto const page = static_cast<usize>(id.index) >> PAGE_BITS;
+            auto const offset = static_cast<usize>(id.index) & PAGE_MASK;
+            return pages[page]->hot_slots[offset];
+        }
+    };
+
+    // The bindless table is split into a fixed set (samplers, buffer device address buffer and acceleration structures)
+    // and one set per large binding array. The large arrays use a variable descriptor count, so their sets can be reallocated
+    // with a larger count without changing any set layout. This keeps all pipeline layouts, and thereby all pipelines, compatible.
+    static inline constexpr u32 DESCRIPTOR_SET_COUNT = 4;
+    static inline constexpr u32 GROWABLE_DESCRIPTOR_SET_COUNT = DESCRIPTOR_SET_COUNT - 1;
+
+    struct GrowableDescriptorSet
+    {
+        u32 binding = {};
+        VkDescriptorType vk_descriptor_type = {};
+        VkDescriptorSetLayout vk_descriptor_set_layout = {};
+        VkDescriptorPool vk_descriptor_pool = {};
+        VkDescriptorSet vk_descriptor_set = {};
+        // Number of descriptors the current set was allocated with. Only ever grows, up to max_capacity.
+        std::atomic_uint32_t capacity = {};
+        u32 max_capacity = {};
+    };
+
+    struct RetiredDescriptorPool
+    {
+        VkDescriptorPool vk_descriptor_pool = {};
+        // Assigned by the first garbage collection after retirement, as only then all command recorders that could have bound the old set are gone.
+        std::optional<u64> timeline_value = {};
     };
 
     struct GPUShaderResourceTable
     {
         std::shared_mutex lifetime_lock = {};
-        GpuResourcePool<ImplBufferSlot> buffer_slots = {};
+        GpuResourcePool<ImplBufferSlot, ImplBufferHotSlot> buffer_slots = {};
         GpuResourcePool<ImplImageSlot> image_slots = {};
         GpuResourcePool<ImplSamplerSlot> sampler_slots = {};
-        GpuResourcePool<ImplTlasSlot> tlas_slots = {};
-        GpuResourcePool<ImplBlasSlot> blas_slots = {};
+        GpuResourcePool<ImplTlasSlot, ImplAccelerationStructureHotSlot> tlas_slots = {};
+        GpuResourcePool<ImplBlasSlot, ImplAccelerationStructureHotSlot> blas_slots = {};
 
+        // Fixed set, always bound at set DAXA_GPU_TABLE_SET_BINDING.
         VkDescriptorSetLayout vk_descriptor_set_layout = {};
         VkDescriptorSet vk_descriptor_set = {};
         VkDescriptorPool vk_descriptor_pool = {};
 
-        // Contains pipeline layouts with varying push constant range size.
-        // The first size is 0 word, second is 1 word, all others are a power of two (maximum is MAX_PUSH_CONSTANT_BYTE_SIZE).
-        std::array<VkPipelineLayout, PIPELINE_LAYOUT_COUNT> pipeline_layouts = {};
+        // Indexed by set - 1, see DAXA_STORAGE_BUFFER_SET, DAXA_STORAGE_IMAGE_SET and DAXA_SAMPLED_IMAGE_SET.
+        std::array<GrowableDescriptorSet, GROWABLE_DESCRIPTOR_SET_COUNT> growable_sets = {};
+        // Descriptor writes lock shared, growing a set locks exclusive. This way no write can get lost in a set that is being replaced.
+        mutable std::shared_mutex growth_mtx = {};
+        // Incremented on every growth, command recorders compare it to rebind the table.
+        std::atomic_uint64_t generation = {};
+        std::vector<RetiredDescriptorPool> retired_descriptor_pools = {};
+        // Completed command lists that bound the table and were not submitted or destroyed yet.
+        // They may reference retired sets after their recorder died, retired pools are not timed while any exist.
+        std::atomic_uint64_t unsubmitted_bound_command_lists = {};
+
+        // Pipeline layouts indexed by push constant size in words, up to MAX_PUSH_CONSTANT_WORD_SIZE.
+        // Created on first use with pipeline_layout, most devices only ever use a handful of sizes.
+        std::array<std::atomic<VkPipelineLayout>, PIPELINE_LAYOUT_COUNT> pipeline_layouts = {};
+        std::mutex pipeline_layout_creation_mtx = {};
+        PFN_vkSetDebugUtilsObjectNameEXT vkSetDebugUtilsObjectNameEXT = {};
+        // The set layouts of all pipeline layouts, indexed by set. Shader objects take them directly.
+        std::array<VkDescriptorSetLayout, DESCRIPTOR_SET_COUNT> vk_descriptor_set_layouts = {};
+
+        // Descriptor buffer backend, used when the device enables ExplicitFeatureFlagBits::DESCRIPTOR_BUFFER.
+        // The table then lives in a persistently mapped descriptor buffer instead of the descriptor sets above.
+        // Descriptors are written straight into the mapped memory with vkGetDescriptorEXT, no vkUpdateDescriptorSets needed.
+        // The buffer is sized for the maximum capacity of all sets up front, it does not grow.
+        bool uses_descriptor_buffer = {};
+        VkBuffer vk_descriptor_buffer = {};
+        VmaAllocation descriptor_buffer_allocation = {};
+        std::byte * descriptor_buffer_host_ptr = {};
+        VkDeviceAddress descriptor_buffer_device_address = {};
+        VkBufferUsageFlags descriptor_buffer_usage = {};
+        // Indexed by set.
+        std::array<VkDeviceSize, DESCRIPTOR_SET_COUNT> descriptor_buffer_set_offsets = {};
+        // Indexed by binding, already includes the offset of the set the binding lives in.
+        std::array<VkDeviceSize, DAXA_ACCELERATION_STRUCTURE_BINDING + 1> descriptor_buffer_binding_offsets = {};
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties = {};
+        PFN_vkGetDescriptorEXT vkGetDescriptorEXT = {};
+        // Flags every pipeline must be created with to be usable with this table.
+        VkPipelineCreateFlags pipeline_create_flags = {};
 
         auto initialize(
             u32 max_buffers, 
@@ -252,16 +538,55 @@ namespace daxa
             u32 max_samplers, 
             u32 max_acceleration_structures,
             VkDevice device, 
+            VkPhysicalDevice physical_device,
+            VmaAllocator vma_allocator,
+            bool use_descriptor_buffer,
             VkBuffer device_address_buffer, 
             PFN_vkSetDebugUtilsObjectNameEXT vkSetDebugUtilsObjectNameEXT) -> daxa_Result;
-        void cleanup(VkDevice device);
+        void cleanup(VkDevice device, VmaAllocator vma_allocator);
+        void write_descriptor(VkDevice device, VkDescriptorGetInfoEXT const & get_info, u32 binding, u32 index, usize descriptor_size) const;
+
+        /**
+         * @brief   Grows the set holding the given binding, so that it can hold at least required_capacity descriptors.
+         *          Existing descriptors are copied into the new set, ids stay valid.
+         *          The old pool is retired and destroyed by collect_retired_descriptor_pools once the gpu is done with it.
+         *
+         * Threadsafe.
+         */
+        auto ensure_capacity(VkDevice device, u32 binding, u32 required_capacity) -> daxa_Result;
+        // The layout for push_constant_size rounded up to words, created and cached on the first call for that size.
+        // Threadsafe.
+        auto pipeline_layout(VkDevice device, u32 push_constant_size, VkPipelineLayout & out_layout) -> daxa_Result;
+        // The set a binding is currently written to. Caller must hold growth_mtx.
+        auto descriptor_set_of_binding(u32 binding) const -> VkDescriptorSet;
+        // All currently bound sets, ordered by set index. Takes growth_mtx.
+        auto current_descriptor_sets(u64 & out_generation) const -> std::array<VkDescriptorSet, DESCRIPTOR_SET_COUNT>;
+        // Caller must guarantee that there are no command recorders alive, see GarbageCollectBudget.
+        void collect_retired_descriptor_pools(VkDevice device, u64 submit_timeline_value, u64 min_pending_timeline_value);
+    };
+
+    // Collects descriptor writes, so that creating many resources at once costs a single vkUpdateDescriptorSets call.
+    struct DescriptorWriteBatch
+    {
+        std::vector<VkWriteDescriptorSet> writes = {};
+        // Image and buffer infos are only linked into the writes on flush, as the vectors may reallocate while recording.
+        std::vector<VkDescriptorImageInfo> image_infos = {};
+        std::vector<VkDescriptorBufferInfo> buffer_infos = {};
+
+        void push_image_write(VkWriteDescriptorSet const & write, VkDescriptorImageInfo const & image_info);
+        void push_buffer_write(VkWriteDescriptorSet const & write, VkDescriptorBufferInfo const & buffer_info);
+        // The destination sets are only resolved on flush, as the table may have grown while recording.
+        void flush(VkDevice vk_device, GPUShaderResourceTable const & table);
+        void clear();
     };
 
-    void write_descriptor_set_sampler(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkSampler vk_sampler, u32 index);
+    // When opt_batch is set, the writes are recorded into it instead of being executed immediately.
+    // When the table uses a descriptor buffer, descriptors are always written immediately and opt_batch is ignored.
+    void write_descriptor_set_sampler(VkDevice vk_device, GPUShaderResourceTable const & table, VkSampler vk_sampler, u32 index, DescriptorWriteBatch * opt_batch = nullptr);
 
-    void write_descriptor_set_buffer(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkBuffer vk_buffer, VkDeviceSize offset, VkDeviceSize range, u32 index);
+    void write_descriptor_set_buffer(VkDevice vk_device, GPUShaderResourceTable const & table, VkBuffer vk_buffer, VkDeviceSize offset, VkDeviceSize range, u32 index, DescriptorWriteBatch * opt_batch = nullptr);
 
-    void write_descriptor_set_image(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkImageView vk_image_view, ImageUsageFlags usage, u32 index);
+    void write_descriptor_set_image(VkDevice vk_device, GPUShaderResourceTable const & table, VkImageView vk_image_view, ImageUsageFlags usage, u32 index, DescriptorWriteBatch * opt_batch = nullptr);
 
-    void write_descriptor_set_acceleration_structure(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkAccelerationStructureKHR vk_acceleration_structure, u32 index);
+    void write_descriptor_set_acceleration_structure(VkDevice vk_device, GPUShaderResourceTable const & table, VkAccelerationStructureKHR vk_acceleration_structure, VkDeviceAddress device_address, u32 index);
 } // namespace daxa
@@ -4,8 +4,87 @@
 #include "impl_features.hpp"
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
+/// --- Begin Helpers ---
+
+namespace
+{
+    // Calibrations are only exposed against std::chrono::steady_clock, so they compare to std::chrono timestamps of the application.
+    // libstdc++ and libc++ implement steady_clock with CLOCK_MONOTONIC, msvc with the performance counter.
+    auto find_steady_clock_time_domain([[maybe_unused]] VkInstance vk_instance, [[maybe_unused]] VkPhysicalDevice physical_device, [[maybe_unused]] VkTimeDomainKHR & out_domain) -> bool
+    {
+#if defined(_WIN32) || defined(__linux__)
+#if defined(_WIN32)
+        constexpr VkTimeDomainKHR STEADY_CLOCK_TIME_DOMAIN = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_KHR;
+#else
+        constexpr VkTimeDomainKHR STEADY_CLOCK_TIME_DOMAIN = VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR;
+#endif
+        auto * vkGetPhysicalDeviceCalibrateableTimeDomainsKHR = r_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsKHR>(
+            vkGetInstanceProcAddr(vk_instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsKHR"));
+        if (vkGetPhysicalDeviceCalibrateableTimeDomainsKHR == nullptr)
+        {
+            return false;
+        }
+        u32 domain_count = {};
+        if (vkGetPhysicalDeviceCalibrateableTimeDomainsKHR(physical_device, &domain_count, nullptr) != VK_SUCCESS)
+        {
+            return false;
+        }
+        std::vector<VkTimeDomainKHR> domains(domain_count);
+        if (vkGetPhysicalDeviceCalibrateableTimeDomainsKHR(physical_device, &domain_count, domains.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+        bool const has_device_domain = std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_KHR) != domains.end();
+        bool const has_host_domain = std::find(domains.begin(), domains.end(), STEADY_CLOCK_TIME_DOMAIN) != domains.end();
+        out_domain = STEADY_CLOCK_TIME_DOMAIN;
+        return has_device_domain && has_host_domain;
+#else
+        return false;
+#endif
+    }
+
+    auto fill_cooperative_matrix_shapes(VkInstance vk_instance, VkPhysicalDevice physical_device, daxa_CooperativeMatrixProperties & out) -> bool
+    {
+        auto * vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR = r_cast<PFN_vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR>(
+            vkGetInstanceProcAddr(vk_instance, "vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR"));
+        if (vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR == nullptr)
+        {
+            return false;
+        }
+        u32 shape_count = {};
+        if (vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR(physical_device, &shape_count, nullptr) != VK_SUCCESS)
+        {
+            return false;
+        }
+        std::vector<VkCooperativeMatrixPropertiesKHR> shapes(shape_count, VkCooperativeMatrixPropertiesKHR{.sType = VK_STRUCTURE_TYPE_COOPERATIVE_MATRIX_PROPERTIES_KHR});
+        if (vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR(physical_device, &shape_count, shapes.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+        out.shape_count = std::min(shape_count, u32{DAXA_MAX_COOPERATIVE_MATRIX_SHAPES});
+        for (u32 i = 0; i < out.shape_count; ++i)
+        {
+            out.shapes[i] = daxa_CooperativeMatrixShape{
+                .m_size = shapes[i].MSize,
+                .n_size = shapes[i].NSize,
+                .k_size = shapes[i].KSize,
+                .a_type = static_cast<daxa_ComponentType>(shapes[i].AType),
+                .b_type = static_cast<daxa_ComponentType>(shapes[i].BType),
+                .c_type = static_cast<daxa_ComponentType>(shapes[i].CType),
+                .result_type = static_cast<daxa_ComponentType>(shapes[i].ResultType),
+                .saturating_accumulation = static_cast<daxa_Bool8>(shapes[i].saturatingAccumulation),
+                .scope = static_cast<daxa_Scope>(shapes[i].scope),
+            };
+        }
+        return out.shape_count > 0;
+    }
+} // namespace
+
+/// --- End Helpers ---
+
 // --- Begin API Functions ---
 
 auto daxa_create_instance(daxa_InstanceInfo const * info, daxa_Instance * out_instance) -> daxa_Result
@@ -100,22 +179,99 @@ auto daxa_ImplInstance::initialize_physical_devices() -> daxa_Result
     result = static_cast<daxa_Result>(vkEnumeratePhysicalDevices(this->vk_instance, &device_count, vk_physical_devices.data()));
     _DAXA_RETURN_IF_ERROR(result, result);
 
-    for (u32 i = 0; i < device_count; ++i)
+    // Physical device queries need no external synchronization, so every device is probed on its own thread.
+    // Devices are created from these results, creating many devices per instance never probes again.
+    std::vector<daxa_Result> results(device_count, DAXA_RESULT_SUCCESS);
+    auto probe = [&](u32 i)
     {
         auto & internals = this->device_internals[i];
         auto & properties = this->device_properties[i];
         internals.vk_handle = vk_physical_devices[i];
 
         // Init extensions:
-        result = internals.extensions.initialize(internals.vk_handle);
-        _DAXA_RETURN_IF_ERROR(result, result);
+        results[i] = internals.extensions.initialize(internals.vk_handle);
+        if (results[i] != DAXA_RESULT_SUCCESS)
+        {
+            return;
+        }
 
         // Init features:
         internals.features.initialize(internals.extensions);
         vkGetPhysicalDeviceFeatures2(internals.vk_handle, &internals.features.physical_device_features_2);
+        if (internals.features.calibrated_timestamps != VK_FALSE &&
+            !find_steady_clock_time_domain(this->vk_instance, internals.vk_handle, internals.calibration_host_time_domain))
+        {
+            internals.features.calibrated_timestamps = VK_FALSE;
+        }
+
+        // Init queue families:
+        u32 queue_family_props_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(internals.vk_handle, &queue_family_props_count, nullptr);
+        internals.queue_family_properties.resize(queue_family_props_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(internals.vk_handle, &queue_family_props_count, internals.queue_family_properties.data());
+        if (internals.features.video_queue != VK_FALSE)
+        {
+            internals.queue_family_video_properties.resize(queue_family_props_count, VkQueueFamilyVideoPropertiesKHR{.sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_VIDEO_PROPERTIES_KHR});
+            std::vector<VkQueueFamilyProperties2> queue_family_props2(queue_family_props_count);
+            for (u32 i = 0; i < queue_family_props_count; ++i)
+            {
+                queue_family_props2[i].sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_PROPERTIES_2;
+                queue_family_props2[i].pNext = &internals.queue_family_video_properties[i];
+            }
+            vkGetPhysicalDeviceQueueFamilyProperties2(internals.vk_handle, &queue_family_props_count, queue_family_props2.data());
+        }
 
         // Init properties:
-        fill_daxa_device_properties(internals.extensions, internals.features, internals.vk_handle, &properties);
+        fill_daxa_device_properties(internals.extensions, internals.features, internals.vk_handle, internals.queue_family_properties, internals.queue_family_video_properties, &properties);
+        if (properties.cooperative_matrix_properties.has_value &&
+            !fill_cooperative_matrix_shapes(this->vk_instance, internals.vk_handle, properties.cooperative_matrix_properties.value))
+        {
+            // A device without a single supported shape can not multiply any matrix.
+            properties.cooperative_matrix_properties = {};
+            properties.explicit_features = static_cast<daxa_ExplicitFeatureFlags>(properties.explicit_features & ~DAXA_EXPLICIT_FEATURE_FLAG_COOPERATIVE_MATRIX);
+        }
+    };
+    std::vector<std::thread> probe_threads = {};
+    probe_threads.reserve(device_count > 0 ? device_count - 1 : 0);
+    for (u32 i = 1; i < device_count; ++i)
+    {
+        probe_threads.emplace_back(probe, i);
+    }
+    if (device_count > 0)
+    {
+        probe(0);
+    }
+    for (auto & thread : probe_threads)
+    {
+        thread.join();
+    }
+    for (auto const probe_result : results)
+    {
+        _DAXA_RETURN_IF_ERROR(probe_result, probe_result);
+    }
+
+    u32 group_count = {};
+    result = static_cast<daxa_Result>(vkEnumeratePhysicalDeviceGroups(this->vk_instance, &group_count, nullptr));
+    _DAXA_RETURN_IF_ERROR(result, result);
+    std::vector<VkPhysicalDeviceGroupProperties> groups(group_count, VkPhysicalDeviceGroupProperties{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES});
+    result = static_cast<daxa_Result>(vkEnumeratePhysicalDeviceGroups(this->vk_instance, &group_count, groups.data()));
+    _DAXA_RETURN_IF_ERROR(result, result);
+    for (u32 i = 0; i < device_count; ++i)
+    {
+        auto & internals = this->device_internals[i];
+        for (auto const & group : groups)
+        {
+            auto const members = std::span{group.physicalDevices, group.physicalDeviceCount};
+            if (std::find(members.begin(), members.end(), internals.vk_handle) != members.end())
+            {
+                internals.device_group.assign(members.begin(), members.end());
+            }
+        }
+        if (internals.device_group.empty())
+        {
+            internals.device_group.push_back(internals.vk_handle);
+        }
+        this->device_properties[i].device_group_size = static_cast<u32>(internals.device_group.size());
     }
 
     return DAXA_RESULT_SUCCESS;
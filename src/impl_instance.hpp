@@ -10,6 +10,14 @@ struct ImplPhysicalDevice
     PhysicalDeviceExtensionsStruct extensions = {};
     PhysicalDeviceFeaturesStruct features = {};
     VkPhysicalDevice vk_handle = {};
+    // Queried once per instance, device creation selects its queues from these.
+    std::vector<VkQueueFamilyProperties> queue_family_properties = {};
+    // One per queue family when VK_KHR_video_queue is usable, empty otherwise.
+    std::vector<VkQueueFamilyVideoPropertiesKHR> queue_family_video_properties = {};
+    // Only with DAXA_IMPLICIT_FEATURE_FLAG_CALIBRATED_TIMESTAMPS, the host domain matching std::chrono::steady_clock.
+    VkTimeDomainKHR calibration_host_time_domain = {};
+    // Members of the vulkan device group of this device in group order, including vk_handle.
+    std::vector<VkPhysicalDevice> device_group = {};
 };
 
 struct daxa_ImplInstance final : ImplHandle
@@ -0,0 +1,147 @@
+#include "impl_micromap.hpp"
+
+#include <string>
+
+#include "impl_device.hpp"
+
+static_assert(sizeof(VkMicromapUsageEXT) == sizeof(daxa::MicromapUsage));
+
+// --- Begin API Functions ---
+
+auto daxa_dvc_create_micromap(daxa_Device device, daxa_MicromapInfo const * info, daxa_Micromap * out_micromap) -> daxa_Result
+{
+    if ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP) == 0)
+    {
+        return DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED;
+    }
+
+    auto ret = daxa_ImplMicromap{};
+    ret.device = device;
+    ret.info = *info;
+
+    auto const buffer_info = daxa_BufferInfo{
+        .size = info->size,
+        .allocate_info = DAXA_MEMORY_FLAG_NONE,
+        .name = info->name,
+    };
+    auto result = daxa_dvc_create_buffer(device, &buffer_info, &ret.buffer_id);
+    _DAXA_RETURN_IF_ERROR(result, result);
+
+    VkMicromapCreateInfoEXT const vk_create_info{
+        .sType = VK_STRUCTURE_TYPE_MICROMAP_CREATE_INFO_EXT,
+        .pNext = nullptr,
+        .createFlags = {},
+        .buffer = device->slot(ret.buffer_id).vk_buffer,
+        .offset = 0,
+        .size = info->size,
+        .type = VK_MICROMAP_TYPE_OPACITY_MICROMAP_EXT,
+        .deviceAddress = {},
+    };
+    auto vk_result = device->vkCreateMicromapEXT(device->vk_device, &vk_create_info, nullptr, &ret.vk_micromap);
+    if (vk_result != VK_SUCCESS)
+    {
+        [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_buffer(device, ret.buffer_id);
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+
+    if ((device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && info->name.size != 0)
+    {
+        std::string const c_name = std::string{info->name.view()};
+        VkDebugUtilsObjectNameInfoEXT const name_info{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            .pNext = nullptr,
+            .objectType = VK_OBJECT_TYPE_MICROMAP_EXT,
+            .objectHandle = std::bit_cast<u64>(ret.vk_micromap),
+            .pObjectName = c_name.c_str(),
+        };
+        device->vkSetDebugUtilsObjectNameEXT(device->vk_device, &name_info);
+    }
+
+    ret.strong_count = 1;
+    device->inc_weak_refcnt();
+    *out_micromap = new daxa_ImplMicromap{};
+    **out_micromap = std::move(ret);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_dvc_get_micromap_build_sizes(daxa_Device device, daxa_MicromapBuildInfo const * build_info, daxa_MicromapBuildSizesInfo * out) -> daxa_Result
+{
+    if ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP) == 0)
+    {
+        return DAXA_RESULT_ERROR_OPACITY_MICROMAP_NOT_SUPPORTED;
+    }
+    VkMicromapBuildInfoEXT const vk_build_info = daxa_micromap_build_info_to_vk(*build_info);
+    VkMicromapBuildSizesInfoEXT vk_build_sizes = {
+        .sType = VK_STRUCTURE_TYPE_MICROMAP_BUILD_SIZES_INFO_EXT,
+        .pNext = nullptr,
+    };
+    device->vkGetMicromapBuildSizesEXT(device->vk_device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &vk_build_info, &vk_build_sizes);
+    out->micromap_size = vk_build_sizes.micromapSize;
+    out->build_scratch_size = vk_build_sizes.buildScratchSize;
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_micromap_info(daxa_Micromap self) -> daxa_MicromapInfo const *
+{
+    return &self->info;
+}
+
+auto daxa_micromap_buffer_id(daxa_Micromap self) -> daxa_BufferId
+{
+    return self->buffer_id;
+}
+
+auto daxa_micromap_inc_refcnt(daxa_Micromap self) -> u64
+{
+    return self->inc_refcnt();
+}
+
+auto daxa_micromap_dec_refcnt(daxa_Micromap self) -> u64
+{
+    return self->dec_refcnt(
+        &daxa_ImplMicromap::zero_ref_callback,
+        self->device->instance);
+}
+
+// --- End API Functions ---
+
+// --- Begin Internals ---
+
+auto daxa_micromap_build_info_to_vk(daxa_MicromapBuildInfo const & info) -> VkMicromapBuildInfoEXT
+{
+    return VkMicromapBuildInfoEXT{
+        .sType = VK_STRUCTURE_TYPE_MICROMAP_BUILD_INFO_EXT,
+        .pNext = nullptr,
+        .type = VK_MICROMAP_TYPE_OPACITY_MICROMAP_EXT,
+        .flags = info.flags,
+        .mode = VK_BUILD_MICROMAP_MODE_BUILD_EXT,
+        .dstMicromap = info.dst_micromap != nullptr ? info.dst_micromap->vk_micromap : VK_NULL_HANDLE,
+        .usageCountsCount = static_cast<u32>(info.usage_count),
+        .pUsageCounts = info.usage_counts,
+        .ppUsageCounts = nullptr,
+        .data = std::bit_cast<VkDeviceOrHostAddressConstKHR>(info.data),
+        .scratchData = std::bit_cast<VkDeviceOrHostAddressKHR>(info.scratch_data),
+        .triangleArray = std::bit_cast<VkDeviceOrHostAddressConstKHR>(info.triangle_array),
+        .triangleArrayStride = info.triangle_array_stride,
+    };
+}
+
+void daxa_ImplMicromap::zero_ref_callback(ImplHandle const * handle)
+{
+    auto * self = rc_cast<daxa_Micromap>(handle);
+    // Destroying the buffer zombifies it under the zombie lock, so it has to happen before taking the lock here.
+    [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_buffer(self->device, self->buffer_id);
+    std::unique_lock const lock{self->device->zombies_mtx};
+    u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    self->device->micromap_zombies.emplace_back(
+        submit_timeline,
+        MicromapZombie{
+            .vk_micromap = self->vk_micromap,
+        });
+    self->device->dec_weak_refcnt(
+        daxa_ImplDevice::zero_ref_callback,
+        self->device->instance);
+    delete self;
+}
+
+// --- End Internals ---
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <daxa/c/gpu_resources.h>
+
+#include "impl_core.hpp"
+
+namespace daxa
+{
+    struct MicromapZombie
+    {
+        VkMicromapEXT vk_micromap = {};
+    };
+} // namespace daxa
+
+struct daxa_ImplMicromap final : ImplHandle
+{
+    daxa_Device device = {};
+    daxa_MicromapInfo info = {};
+    VkMicromapEXT vk_micromap = {};
+    // Dedicated storage buffer, destroyed together with the micromap.
+    daxa_BufferId buffer_id = {};
+
+    static void zero_ref_callback(ImplHandle const * handle);
+};
+
+// The usage counts of the returned info point into the daxa info, it must outlive the vk info.
+auto daxa_micromap_build_info_to_vk(daxa_MicromapBuildInfo const & info) -> VkMicromapBuildInfoEXT;
@@ -1,6 +1,538 @@
 #include "impl_device.hpp"
 #include "impl_pipeline.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    // Creates the pipeline from binaries of an earlier run. pipelineCache must be null when binaries are given.
+    template <typename VkCreateInfoT, typename CreateFnT>
+    auto create_vk_pipeline_from_binaries(daxa_Device device, VkCreateInfoT create_info, std::vector<PipelineBinaryArchive::Binary> const & binaries, CreateFnT & create, VkPipeline * out_pipeline) -> VkResult
+    {
+        std::vector<VkPipelineBinaryKeyKHR> vk_keys = {};
+        std::vector<VkPipelineBinaryDataKHR> vk_datas = {};
+        vk_keys.reserve(binaries.size());
+        vk_datas.reserve(binaries.size());
+        for (auto const & binary : binaries)
+        {
+            auto & vk_key = vk_keys.emplace_back(VkPipelineBinaryKeyKHR{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR,
+                .pNext = nullptr,
+                .keySize = static_cast<u32>(binary.key.size()),
+                .key = {},
+            });
+            std::memcpy(vk_key.key, binary.key.data(), binary.key.size());
+            vk_datas.push_back(VkPipelineBinaryDataKHR{
+                .dataSize = binary.data.size(),
+                .pData = const_cast<std::byte *>(binary.data.data()),
+            });
+        }
+        VkPipelineBinaryKeysAndDataKHR const vk_keys_and_data{
+            .binaryCount = static_cast<u32>(binaries.size()),
+            .pPipelineBinaryKeys = vk_keys.data(),
+            .pPipelineBinaryData = vk_datas.data(),
+        };
+        VkPipelineBinaryCreateInfoKHR const vk_binary_create_info{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_CREATE_INFO_KHR,
+            .pNext = nullptr,
+            .pKeysAndDataInfo = &vk_keys_and_data,
+            .pipeline = VK_NULL_HANDLE,
+            .pPipelineCreateInfo = nullptr,
+        };
+        std::vector<VkPipelineBinaryKHR> vk_binaries(binaries.size());
+        VkPipelineBinaryHandlesInfoKHR vk_handles{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_HANDLES_INFO_KHR,
+            .pNext = nullptr,
+            .pipelineBinaryCount = static_cast<u32>(vk_binaries.size()),
+            .pPipelineBinaries = vk_binaries.data(),
+        };
+        auto result = device->vkCreatePipelineBinariesKHR(device->vk_device, &vk_binary_create_info, nullptr, &vk_handles);
+        if (result == VK_SUCCESS)
+        {
+            VkPipelineBinaryInfoKHR const vk_binary_info{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_INFO_KHR,
+                .pNext = create_info.pNext,
+                .binaryCount = vk_handles.pipelineBinaryCount,
+                .pPipelineBinaries = vk_binaries.data(),
+            };
+            create_info.pNext = &vk_binary_info;
+            result = create(VK_NULL_HANDLE, create_info, out_pipeline);
+        }
+        for (u32 i = 0; i < vk_handles.pipelineBinaryCount; ++i)
+        {
+            if (vk_binaries[i] != VK_NULL_HANDLE)
+            {
+                device->vkDestroyPipelineBinaryKHR(device->vk_device, vk_binaries[i], nullptr);
+            }
+        }
+        return result;
+    }
+
+    // Reads back the binaries of a pipeline created with VK_PIPELINE_CREATE_2_CAPTURE_DATA_BIT_KHR and stores them in the archive.
+    void capture_vk_pipeline_binaries(daxa_Device device, VkPipeline vk_pipeline, std::string pipeline_key)
+    {
+        VkPipelineBinaryCreateInfoKHR const vk_binary_create_info{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_CREATE_INFO_KHR,
+            .pNext = nullptr,
+            .pKeysAndDataInfo = nullptr,
+            .pipeline = vk_pipeline,
+            .pPipelineCreateInfo = nullptr,
+        };
+        VkPipelineBinaryHandlesInfoKHR vk_handles{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_HANDLES_INFO_KHR,
+            .pNext = nullptr,
+            .pipelineBinaryCount = 0,
+            .pPipelineBinaries = nullptr,
+        };
+        auto result = device->vkCreatePipelineBinariesKHR(device->vk_device, &vk_binary_create_info, nullptr, &vk_handles);
+        std::vector<VkPipelineBinaryKHR> vk_binaries(vk_handles.pipelineBinaryCount);
+        vk_handles.pPipelineBinaries = vk_binaries.data();
+        if (result == VK_SUCCESS)
+        {
+            result = device->vkCreatePipelineBinariesKHR(device->vk_device, &vk_binary_create_info, nullptr, &vk_handles);
+        }
+        std::vector<PipelineBinaryArchive::Binary> binaries = {};
+        for (u32 i = 0; i < vk_handles.pipelineBinaryCount && result == VK_SUCCESS; ++i)
+        {
+            VkPipelineBinaryDataInfoKHR const vk_data_info{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_DATA_INFO_KHR,
+                .pNext = nullptr,
+                .pipelineBinary = vk_binaries[i],
+            };
+            VkPipelineBinaryKeyKHR vk_key{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR,
+                .pNext = nullptr,
+                .keySize = {},
+                .key = {},
+            };
+            usize size = {};
+            result = device->vkGetPipelineBinaryDataKHR(device->vk_device, &vk_data_info, &vk_key, &size, nullptr);
+            auto & binary = binaries.emplace_back();
+            binary.data.resize(size);
+            if (result == VK_SUCCESS)
+            {
+                result = device->vkGetPipelineBinaryDataKHR(device->vk_device, &vk_data_info, &vk_key, &size, binary.data.data());
+            }
+            binary.key.assign(r_cast<char const *>(vk_key.key), vk_key.keySize);
+        }
+        for (auto vk_binary : vk_binaries)
+        {
+            if (vk_binary != VK_NULL_HANDLE)
+            {
+                device->vkDestroyPipelineBinaryKHR(device->vk_device, vk_binary, nullptr);
+            }
+        }
+        VkReleaseCapturedPipelineDataInfoKHR const vk_release_info{
+            .sType = VK_STRUCTURE_TYPE_RELEASE_CAPTURED_PIPELINE_DATA_INFO_KHR,
+            .pNext = nullptr,
+            .pipeline = vk_pipeline,
+        };
+        device->vkReleaseCapturedPipelineDataKHR(device->vk_device, &vk_release_info, nullptr);
+        if (result != VK_SUCCESS || binaries.empty())
+        {
+            return;
+        }
+        auto & archive = device->pipeline_binary_archive;
+        std::unique_lock const lock{archive.mtx};
+        // Entries are never replaced, other threads may be creating pipelines from them right now.
+        if (archive.pipelines.try_emplace(std::move(pipeline_key), std::move(binaries)).second)
+        {
+            archive.dirty = true;
+        }
+    }
+
+    // Creates a pipeline through the pipeline binary archive when it is enabled, otherwise through the pipeline cache.
+    // Extra flags only exist as flags2 bits. When chained, the flags2 replace the flags of the create info, so the regular flags are carried over.
+    template <typename VkCreateInfoT, typename CreateFnT>
+    auto create_vk_pipeline(daxa_Device device, VkCreateInfoT create_info, VkPipelineCreateFlags2KHR extra_flags, CreateFnT && create, VkPipeline * out_pipeline) -> VkResult
+    {
+        VkPipelineCreateFlags2CreateInfoKHR vk_flags2{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_FLAGS_2_CREATE_INFO_KHR,
+            .pNext = create_info.pNext,
+            .flags = static_cast<VkPipelineCreateFlags2KHR>(create_info.flags) | extra_flags,
+        };
+        auto & archive = device->pipeline_binary_archive;
+        if (!archive.enabled)
+        {
+            if (extra_flags != 0)
+            {
+                create_info.pNext = &vk_flags2;
+            }
+            return create(device->vk_pipeline_cache, create_info, out_pipeline);
+        }
+
+        create_info.pNext = &vk_flags2;
+        VkPipelineCreateInfoKHR const vk_key_create_info{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_INFO_KHR,
+            .pNext = &create_info,
+        };
+        VkPipelineBinaryKeyKHR vk_pipeline_key{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR,
+            .pNext = nullptr,
+            .keySize = {},
+            .key = {},
+        };
+        if (device->vkGetPipelineKeyKHR(device->vk_device, &vk_key_create_info, &vk_pipeline_key) != VK_SUCCESS)
+        {
+            return create(device->vk_pipeline_cache, create_info, out_pipeline);
+        }
+        std::string pipeline_key{r_cast<char const *>(vk_pipeline_key.key), vk_pipeline_key.keySize};
+        // Map nodes are stable and never erased after loading, so the binaries can be used after unlocking.
+        std::vector<PipelineBinaryArchive::Binary> const * binaries = nullptr;
+        {
+            std::unique_lock const lock{archive.mtx};
+            auto iter = archive.pipelines.find(pipeline_key);
+            if (iter != archive.pipelines.end())
+            {
+                binaries = &iter->second;
+            }
+        }
+        if (binaries != nullptr)
+        {
+            auto const result = create_vk_pipeline_from_binaries(device, create_info, *binaries, create, out_pipeline);
+            if (result == VK_SUCCESS)
+            {
+                return result;
+            }
+            // Binaries the driver refuses fall back to a regular compile.
+            return create(device->vk_pipeline_cache, create_info, out_pipeline);
+        }
+
+        vk_flags2.flags |= VK_PIPELINE_CREATE_2_CAPTURE_DATA_BIT_KHR;
+        auto const result = create(device->vk_pipeline_cache, create_info, out_pipeline);
+        if (result == VK_SUCCESS)
+        {
+            capture_vk_pipeline_binaries(device, *out_pipeline, std::move(pipeline_key));
+        }
+        return result;
+    }
+
+    template <typename... T>
+    void append_key(std::string & key, T const &... values)
+    {
+        (key.append(r_cast<char const *>(&values), sizeof(T)), ...);
+    }
+
+    void append_shader_key(std::string & key, Optional<ShaderInfo> const & shader_info)
+    {
+        append_key(key, shader_info.has_value());
+        if (!shader_info.has_value())
+        {
+            return;
+        }
+        auto const & info = shader_info.value();
+        append_key(key, info.byte_code_size, info.create_flags, info.required_subgroup_size.value_or(0));
+        key.append(r_cast<char const *>(info.byte_code), info.byte_code_size * sizeof(u32));
+        key.append(info.entry_point.view());
+        key.push_back('\0');
+        append_key(key, info.specialization_constants.size());
+        for (usize i = 0; i < info.specialization_constants.size(); ++i)
+        {
+            append_key(key, info.specialization_constants[i].constant_id, info.specialization_constants[i].value);
+        }
+    }
+
+    // Returns the cached library part for the key, compiling it on a miss.
+    // The key only has to describe the state specific to the part, the flags and dynamic states are added here.
+    auto get_or_create_pipeline_library(daxa_Device device, VkGraphicsPipelineLibraryFlagsEXT subset, std::string key, VkGraphicsPipelineCreateInfo create_info, VkPipeline * out_library) -> VkResult
+    {
+        append_key(key, subset, create_info.flags);
+        key.append(r_cast<char const *>(create_info.pDynamicState->pDynamicStates), create_info.pDynamicState->dynamicStateCount * sizeof(VkDynamicState));
+        auto & cache = device->graphics_pipeline_libraries;
+        {
+            std::unique_lock const lock{cache.mtx};
+            auto iter = cache.parts.find(key);
+            if (iter != cache.parts.end())
+            {
+                *out_library = iter->second;
+                return VK_SUCCESS;
+            }
+        }
+        VkGraphicsPipelineLibraryCreateInfoEXT const vk_library_info{
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+            .pNext = create_info.pNext,
+            .flags = subset,
+        };
+        create_info.pNext = &vk_library_info;
+        // Link time optimization info is always retained, so parts can be shared between fast and optimized links.
+        create_info.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+        VkPipeline vk_library = {};
+        auto const result = vkCreateGraphicsPipelines(device->vk_device, device->vk_pipeline_cache, 1u, &create_info, nullptr, &vk_library);
+        if (result != VK_SUCCESS)
+        {
+            return result;
+        }
+        std::unique_lock const lock{cache.mtx};
+        auto const [iter, inserted] = cache.parts.try_emplace(std::move(key), vk_library);
+        if (!inserted)
+        {
+            // Another thread compiled the same part in the meantime.
+            vkDestroyPipeline(device->vk_device, vk_library, nullptr);
+        }
+        *out_library = iter->second;
+        return VK_SUCCESS;
+    }
+
+    // Splits a complete graphics pipeline create info into the four library parts and links them.
+    // Mesh shading pipelines have no vertex input part.
+    auto create_vk_pipeline_from_libraries(daxa_Device device, RasterPipelineInfo const & info, VkGraphicsPipelineCreateInfo const & create_info, bool link_time_optimization, VkPipeline * out_pipeline) -> VkResult
+    {
+        auto const * vk_rendering = static_cast<VkPipelineRenderingCreateInfo const *>(create_info.pNext);
+        std::vector<VkPipelineShaderStageCreateInfo> pre_rasterization_stages = {};
+        std::vector<VkPipelineShaderStageCreateInfo> fragment_stages = {};
+        for (u32 i = 0; i < create_info.stageCount; ++i)
+        {
+            auto & stages = create_info.pStages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT ? fragment_stages : pre_rasterization_stages;
+            stages.push_back(create_info.pStages[i]);
+        }
+        VkGraphicsPipelineCreateInfo const empty_create_info{
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = create_info.flags,
+            .stageCount = 0,
+            .pStages = nullptr,
+            .pVertexInputState = nullptr,
+            .pInputAssemblyState = nullptr,
+            .pTessellationState = nullptr,
+            .pViewportState = nullptr,
+            .pRasterizationState = nullptr,
+            .pMultisampleState = nullptr,
+            .pDepthStencilState = nullptr,
+            .pColorBlendState = nullptr,
+            .pDynamicState = create_info.pDynamicState,
+            .layout = VK_NULL_HANDLE,
+            .renderPass = nullptr,
+            .subpass = 0,
+            .basePipelineHandle = VK_NULL_HANDLE,
+            .basePipelineIndex = 0,
+        };
+        std::array<VkPipeline, 4> vk_libraries = {};
+        u32 library_count = 0;
+        auto result = VK_SUCCESS;
+
+        if (!info.mesh_shader_info.has_value())
+        {
+            auto vertex_input_info = empty_create_info;
+            vertex_input_info.pVertexInputState = create_info.pVertexInputState;
+            vertex_input_info.pInputAssemblyState = create_info.pInputAssemblyState;
+            std::string key = {};
+            append_key(key, create_info.pInputAssemblyState->topology, create_info.pInputAssemblyState->primitiveRestartEnable);
+            result = get_or_create_pipeline_library(device, VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, std::move(key), vertex_input_info, &vk_libraries.at(library_count++));
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            auto pre_rasterization_info = empty_create_info;
+            pre_rasterization_info.pNext = vk_rendering;
+            pre_rasterization_info.stageCount = static_cast<u32>(pre_rasterization_stages.size());
+            pre_rasterization_info.pStages = pre_rasterization_stages.data();
+            pre_rasterization_info.pTessellationState = create_info.pTessellationState;
+            pre_rasterization_info.pViewportState = create_info.pViewportState;
+            pre_rasterization_info.pRasterizationState = create_info.pRasterizationState;
+            pre_rasterization_info.layout = create_info.layout;
+            std::string key = {};
+            append_shader_key(key, info.vertex_shader_info);
+            append_shader_key(key, info.tesselation_control_shader_info);
+            append_shader_key(key, info.tesselation_evaluation_shader_info);
+            append_shader_key(key, info.task_shader_info);
+            append_shader_key(key, info.mesh_shader_info);
+            auto const & raster = *create_info.pRasterizationState;
+            append_key(
+                key,
+                raster.depthClampEnable, raster.rasterizerDiscardEnable, raster.polygonMode, raster.cullMode, raster.frontFace,
+                raster.depthBiasEnable, raster.depthBiasConstantFactor, raster.depthBiasClamp, raster.depthBiasSlopeFactor, raster.lineWidth);
+            append_key(key, raster.pNext != nullptr);
+            if (raster.pNext != nullptr)
+            {
+                auto const & conservative = *static_cast<VkPipelineRasterizationConservativeStateCreateInfoEXT const *>(raster.pNext);
+                append_key(key, conservative.conservativeRasterizationMode, conservative.extraPrimitiveOverestimationSize);
+            }
+            auto const & tesselation_origin = *static_cast<VkPipelineTessellationDomainOriginStateCreateInfo const *>(create_info.pTessellationState->pNext);
+            append_key(key, create_info.pTessellationState->patchControlPoints, tesselation_origin.domainOrigin, create_info.layout, vk_rendering->viewMask);
+            result = get_or_create_pipeline_library(device, VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, std::move(key), pre_rasterization_info, &vk_libraries.at(library_count++));
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            auto fragment_shader_info = empty_create_info;
+            fragment_shader_info.pNext = vk_rendering;
+            fragment_shader_info.stageCount = static_cast<u32>(fragment_stages.size());
+            fragment_shader_info.pStages = fragment_stages.data();
+            fragment_shader_info.pMultisampleState = create_info.pMultisampleState;
+            fragment_shader_info.pDepthStencilState = create_info.pDepthStencilState;
+            fragment_shader_info.layout = create_info.layout;
+            std::string key = {};
+            append_shader_key(key, info.fragment_shader_info);
+            auto const & depth_stencil = *create_info.pDepthStencilState;
+            append_key(
+                key,
+                depth_stencil.depthTestEnable, depth_stencil.depthWriteEnable, depth_stencil.depthCompareOp,
+                depth_stencil.minDepthBounds, depth_stencil.maxDepthBounds,
+                create_info.pMultisampleState->rasterizationSamples, create_info.layout, vk_rendering->viewMask, vk_rendering->depthAttachmentFormat);
+            result = get_or_create_pipeline_library(device, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, std::move(key), fragment_shader_info, &vk_libraries.at(library_count++));
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            auto fragment_output_info = empty_create_info;
+            fragment_output_info.pNext = vk_rendering;
+            fragment_output_info.pMultisampleState = create_info.pMultisampleState;
+            fragment_output_info.pColorBlendState = create_info.pColorBlendState;
+            std::string key = {};
+            auto const & color_blend = *create_info.pColorBlendState;
+            append_key(key, color_blend.attachmentCount, color_blend.blendConstants, create_info.pMultisampleState->rasterizationSamples, vk_rendering->depthAttachmentFormat);
+            key.append(r_cast<char const *>(color_blend.pAttachments), color_blend.attachmentCount * sizeof(VkPipelineColorBlendAttachmentState));
+            key.append(r_cast<char const *>(vk_rendering->pColorAttachmentFormats), vk_rendering->colorAttachmentCount * sizeof(VkFormat));
+            result = get_or_create_pipeline_library(device, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, std::move(key), fragment_output_info, &vk_libraries.at(library_count++));
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            return result;
+        }
+        VkPipelineLibraryCreateInfoKHR const vk_library_link_info{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+            .pNext = nullptr,
+            .libraryCount = library_count,
+            .pLibraries = vk_libraries.data(),
+        };
+        auto link_info = empty_create_info;
+        link_info.pNext = &vk_library_link_info;
+        link_info.pDynamicState = nullptr;
+        link_info.layout = create_info.layout;
+        if (link_time_optimization)
+        {
+            link_info.flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+        }
+        return vkCreateGraphicsPipelines(device->vk_device, device->vk_pipeline_cache, 1u, &link_info, nullptr, out_pipeline);
+    }
+
+    template <typename T>
+    void append_bytes(std::vector<std::byte> & out, T const & value)
+    {
+        auto const offset = out.size();
+        out.resize(offset + sizeof(T));
+        std::memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    void append_bytes(std::vector<std::byte> & out, void const * data, usize size)
+    {
+        auto const offset = out.size();
+        out.resize(offset + size);
+        std::memcpy(out.data() + offset, data, size);
+    }
+
+    struct ByteReader
+    {
+        std::span<std::byte const> bytes = {};
+        usize offset = {};
+
+        template <typename T>
+        auto read(T & value) -> bool
+        {
+            if (bytes.size() - offset < sizeof(T))
+            {
+                return false;
+            }
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        }
+
+        auto read(void * data, usize size) -> bool
+        {
+            if (bytes.size() - offset < size)
+            {
+                return false;
+            }
+            std::memcpy(data, bytes.data() + offset, size);
+            offset += size;
+            return true;
+        }
+    };
+
+    static constexpr u32 PIPELINE_BINARY_ARCHIVE_MAGIC = 0x42505844; // "DXPB"
+    static constexpr u32 PIPELINE_BINARY_ARCHIVE_VERSION = 1;
+
+    // Copies the byte code and specialization constants of the shaders into the pipeline and repoints the shader infos at the copies.
+    void copy_async_shader_infos(ImplPipeline & pipeline, std::span<ShaderInfo * const> shader_infos)
+    {
+        usize byte_code_size = {};
+        usize specialization_constant_count = {};
+        for (ShaderInfo const * shader_info : shader_infos)
+        {
+            byte_code_size += shader_info->byte_code_size;
+            specialization_constant_count += shader_info->specialization_constants.size();
+        }
+        // Reserved up front, the repointed infos must stay valid while the copies grow.
+        pipeline.async_byte_code.reserve(byte_code_size);
+        pipeline.async_specialization_constants.reserve(specialization_constant_count);
+        for (ShaderInfo * shader_info : shader_infos)
+        {
+            usize const byte_code_offset = pipeline.async_byte_code.size();
+            pipeline.async_byte_code.insert(pipeline.async_byte_code.end(), shader_info->byte_code, shader_info->byte_code + shader_info->byte_code_size);
+            shader_info->byte_code = pipeline.async_byte_code.data() + byte_code_offset;
+            usize const constant_offset = pipeline.async_specialization_constants.size();
+            for (usize i = 0; i < shader_info->specialization_constants.size(); ++i)
+            {
+                pipeline.async_specialization_constants.push_back(shader_info->specialization_constants[i]);
+            }
+            shader_info->specialization_constants = {pipeline.async_specialization_constants.data() + constant_offset, shader_info->specialization_constants.size()};
+        }
+    }
+
+    void start_async_pipeline(daxa_Device device, ImplPipeline & pipeline, ImplPipeline * fallback, void (*compile)(ImplPipeline & pipeline))
+    {
+        if (fallback != nullptr)
+        {
+            fallback->inc_refcnt();
+            pipeline.async_fallback = fallback;
+        }
+        pipeline.status = DAXA_PIPELINE_STATUS_PENDING;
+        pipeline.strong_count = 1;
+        device->inc_weak_refcnt();
+        device->enqueue_pipeline_compile({.pipeline = &pipeline, .compile = compile});
+    }
+
+    // Adopts the vk pipeline of the synchronously created one and publishes the status.
+    // The pending pipeline may be destroyed as soon as the status is published, so it is not touched afterwards.
+    void finish_async_pipeline(ImplPipeline & pending, daxa_Result result, ImplPipeline * created)
+    {
+        daxa_Device device = pending.device;
+        if (result == DAXA_RESULT_SUCCESS)
+        {
+            pending.vk_pipeline = std::exchange(created->vk_pipeline, VK_NULL_HANDLE);
+            created->dec_refcnt(&ImplPipeline::zero_ref_callback, device->instance);
+        }
+        pending.async_result = result;
+        {
+            std::unique_lock const lock{device->pipeline_compile_mtx};
+            std::atomic_ref{pending.status}.store(result == DAXA_RESULT_SUCCESS ? DAXA_PIPELINE_STATUS_READY : DAXA_PIPELINE_STATUS_FAILED, std::memory_order::release);
+        }
+        device->pipeline_compiled_cv.notify_all();
+    }
+
+    void compile_async_compute_pipeline(ImplPipeline & pipeline)
+    {
+        auto & pending = static_cast<daxa_ImplComputePipeline &>(pipeline);
+        daxa_ComputePipeline created = {};
+        auto const result = daxa_dvc_create_compute_pipeline(pending.device, reinterpret_cast<daxa_ComputePipelineInfo const *>(&pending.info), &created);
+        finish_async_pipeline(pending, result, created);
+    }
+
+    void compile_async_raster_pipeline(ImplPipeline & pipeline)
+    {
+        auto & pending = static_cast<daxa_ImplRasterPipeline &>(pipeline);
+        daxa_RasterPipeline created = {};
+        auto const result = daxa_dvc_create_raster_pipeline(pending.device, reinterpret_cast<daxa_RasterPipelineInfo const *>(&pending.info), &created);
+        finish_async_pipeline(pending, result, created);
+    }
+} // namespace
+
 // --- Begin API Functions ---
 
 auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo const * info, daxa_RasterPipeline * out_pipeline) -> daxa_Result
@@ -9,6 +541,12 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
     daxa_ImplRasterPipeline ret = {};
     ret.device = device;
     ret.info = *reinterpret_cast<RasterPipelineInfo const *>(info);
+    if (ret.info.indirect_bindable && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED;
+    }
+    auto const layout_result = device->gpu_sro_table.pipeline_layout(device->vk_device, ret.info.push_constant_size, ret.vk_pipeline_layout);
+    _DAXA_RETURN_IF_ERROR(layout_result, layout_result)
     std::vector<VkShaderModule> vk_shader_modules = {};
     // NOTE: Temporarily holds 0 terminated strings, incoming strings are data + size, not null terminated!
     std::vector<std::unique_ptr<std::string>> entry_point_names = {};
@@ -18,6 +556,8 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
     // Necessary to prevent re-allocation
     auto const MAXIMUM_GRAPHICS_STAGES = 6;
     require_subgroup_size_vkstructs.reserve(MAXIMUM_GRAPHICS_STAGES);
+    std::vector<SpecializationInfoStorage> specialization_infos = {};
+    specialization_infos.reserve(MAXIMUM_GRAPHICS_STAGES);
 
     auto create_shader_module = [&](ShaderInfo const & shader_info, VkShaderStageFlagBits shader_stage) -> VkResult
     {
@@ -48,7 +588,7 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
             .stage = shader_stage,
             .module = vk_shader_module,
             .pName = entry_point_names.back()->c_str(),
-            .pSpecializationInfo = nullptr,
+            .pSpecializationInfo = specialization_infos.emplace_back().fill(shader_info),
         };
         vk_pipeline_shader_stage_create_infos.push_back(vk_pipeline_shader_stage_create_info);
         return result;
@@ -88,7 +628,6 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
         }
     }
 
-    ret.vk_pipeline_layout = ret.device->gpu_sro_table.pipeline_layouts.at((ret.info.push_constant_size + 3) / 4);
     constexpr VkPipelineVertexInputStateCreateInfo vk_vertex_input_state{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext = nullptr,
@@ -260,7 +799,7 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
     VkGraphicsPipelineCreateInfo const vk_graphics_pipeline_create_info{
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
         .pNext = &vk_pipeline_rendering,
-        .flags = {},
+        .flags = ret.device->gpu_sro_table.pipeline_create_flags,
         .stageCount = static_cast<u32>(vk_pipeline_shader_stage_create_infos.size()),
         .pStages = vk_pipeline_shader_stage_create_infos.data(),
         .pVertexInputState = &vk_vertex_input_state,
@@ -278,13 +817,32 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0,
     };
-    auto result = vkCreateGraphicsPipelines(
-        ret.device->vk_device,
-        VK_NULL_HANDLE,
-        1u,
-        &vk_graphics_pipeline_create_info,
-        nullptr,
-        &ret.vk_pipeline);
+    // Linking only pays off when it is cheaper than compiling the whole pipeline.
+    bool const link_from_libraries =
+        ret.info.link_mode != RasterPipelineLinkMode::MONOLITHIC &&
+        !ret.info.indirect_bindable &&
+        (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_GRAPHICS_PIPELINE_LIBRARY) &&
+        device->graphics_pipeline_library_properties.graphicsPipelineLibraryFastLinking;
+    auto result = VK_SUCCESS;
+    if (link_from_libraries)
+    {
+        result = create_vk_pipeline_from_libraries(
+            ret.device,
+            ret.info,
+            vk_graphics_pipeline_create_info,
+            ret.info.link_mode == RasterPipelineLinkMode::OPTIMIZED_LINK,
+            &ret.vk_pipeline);
+    }
+    else
+    {
+        result = create_vk_pipeline(
+            ret.device,
+            vk_graphics_pipeline_create_info,
+            ret.info.indirect_bindable ? VK_PIPELINE_CREATE_2_INDIRECT_BINDABLE_BIT_EXT : VkPipelineCreateFlags2KHR{},
+            [&](VkPipelineCache vk_pipeline_cache, VkGraphicsPipelineCreateInfo const & create_info, VkPipeline * out_vk_pipeline)
+            { return vkCreateGraphicsPipelines(ret.device->vk_device, vk_pipeline_cache, 1u, &create_info, nullptr, out_vk_pipeline); },
+            &ret.vk_pipeline);
+    }
     for (auto & vk_shader_module : vk_shader_modules)
     {
         vkDestroyShaderModule(ret.device->vk_device, vk_shader_module, nullptr);
@@ -305,6 +863,10 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
         };
         ret.device->vkSetDebugUtilsObjectNameEXT(ret.device->vk_device, &name_info);
     }
+    if (device->info.capturable)
+    {
+        ret.capture_record = capture_pipeline_record(*info);
+    }
     ret.strong_count = 1;
     device->inc_weak_refcnt();
     *out_pipeline = new daxa_ImplRasterPipeline{};
@@ -329,12 +891,74 @@ auto daxa_raster_pipeline_dec_refcnt(daxa_RasterPipeline self) -> u64
         self->device->instance);
 }
 
+auto daxa_dvc_create_raster_pipeline_async(daxa_Device device, daxa_RasterPipelineInfo const * info, daxa_RasterPipeline fallback, daxa_RasterPipeline * out_pipeline) -> daxa_Result
+{
+    _DAXA_TEST_PRINT("daxa_dvc_create_raster_pipeline_async\n");
+    auto const & cpp_info = *reinterpret_cast<RasterPipelineInfo const *>(info);
+    if (cpp_info.indirect_bindable && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED;
+    }
+    if ((device->properties.implicit_features & ImplicitFeatureFlagBits::MESH_SHADER) == DeviceFlagBits::NONE &&
+        (cpp_info.mesh_shader_info.has_value() || cpp_info.task_shader_info.has_value()))
+    {
+        return DAXA_RESULT_MESH_SHADER_NOT_DEVICE_ENABLED;
+    }
+    VkPipelineLayout vk_pipeline_layout = {};
+    auto const layout_result = device->gpu_sro_table.pipeline_layout(device->vk_device, cpp_info.push_constant_size, vk_pipeline_layout);
+    _DAXA_RETURN_IF_ERROR(layout_result, layout_result)
+    // Created in place, the copied shader infos point into the pipeline.
+    auto * ret = new daxa_ImplRasterPipeline{};
+    ret->device = device;
+    ret->info = cpp_info;
+    ret->vk_pipeline_layout = vk_pipeline_layout;
+    std::vector<ShaderInfo *> shader_infos = {};
+    for (Optional<ShaderInfo> * shader_info : {
+             &ret->info.mesh_shader_info,
+             &ret->info.vertex_shader_info,
+             &ret->info.tesselation_control_shader_info,
+             &ret->info.tesselation_evaluation_shader_info,
+             &ret->info.fragment_shader_info,
+             &ret->info.task_shader_info,
+         })
+    {
+        if (shader_info->has_value())
+        {
+            shader_infos.push_back(&shader_info->value());
+        }
+    }
+    copy_async_shader_infos(*ret, shader_infos);
+    if (device->info.capturable)
+    {
+        ret->capture_record = capture_pipeline_record(*info);
+    }
+    start_async_pipeline(device, *ret, fallback, &compile_async_raster_pipeline);
+    *out_pipeline = ret;
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_raster_pipeline_status(daxa_RasterPipeline self) -> daxa_PipelineStatus
+{
+    return self->load_status();
+}
+
+auto daxa_raster_pipeline_wait(daxa_RasterPipeline self) -> daxa_Result
+{
+    return self->wait_for_compilation();
+}
+
 auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineInfo const * info, daxa_ComputePipeline * out_pipeline) -> daxa_Result
 {
     _DAXA_TEST_PRINT("daxa_dvc_create_compute_pipeline\n");
     daxa_ImplComputePipeline ret = {};
     ret.device = device;
     ret.info = *reinterpret_cast<ComputePipelineInfo const *>(info);
+    if (ret.info.indirect_bindable && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED;
+    }
+    auto const layout_result = device->gpu_sro_table.pipeline_layout(device->vk_device, ret.info.push_constant_size, ret.vk_pipeline_layout);
+    _DAXA_RETURN_IF_ERROR(layout_result, layout_result)
     VkShaderModule vk_shader_module = {};
     VkShaderModuleCreateInfo const shader_module_ci{
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
@@ -348,16 +972,16 @@ auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineIn
     {
         return std::bit_cast<daxa_Result>(module_result);
     }
-    ret.vk_pipeline_layout = ret.device->gpu_sro_table.pipeline_layouts.at((ret.info.push_constant_size + 3) / 4);
     VkPipelineShaderStageRequiredSubgroupSizeCreateInfo require_subgroup_size_vkstruct{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO,
         .pNext = nullptr,
         .requiredSubgroupSize = ret.info.shader_info.required_subgroup_size.value_or(0),
     };
+    SpecializationInfoStorage specialization_info = {};
     VkComputePipelineCreateInfo const vk_compute_pipeline_create_info{
         .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
         .pNext = nullptr,
-        .flags = {},
+        .flags = ret.device->gpu_sro_table.pipeline_create_flags,
         .stage = VkPipelineShaderStageCreateInfo{
             .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
             .pNext = ret.info.shader_info.required_subgroup_size.has_value() ? &require_subgroup_size_vkstruct : nullptr,
@@ -365,18 +989,18 @@ auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineIn
             .stage = VkShaderStageFlagBits::VK_SHADER_STAGE_COMPUTE_BIT,
             .module = vk_shader_module,
             .pName = ret.info.shader_info.entry_point.data(),
-            .pSpecializationInfo = nullptr,
+            .pSpecializationInfo = specialization_info.fill(ret.info.shader_info),
         },
         .layout = ret.vk_pipeline_layout,
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0,
     };
-    auto pipeline_result = vkCreateComputePipelines(
-        ret.device->vk_device,
-        VK_NULL_HANDLE,
-        1u,
-        &vk_compute_pipeline_create_info,
-        nullptr,
+    auto pipeline_result = create_vk_pipeline(
+        ret.device,
+        vk_compute_pipeline_create_info,
+        ret.info.indirect_bindable ? VK_PIPELINE_CREATE_2_INDIRECT_BINDABLE_BIT_EXT : VkPipelineCreateFlags2KHR{},
+        [&](VkPipelineCache vk_pipeline_cache, VkComputePipelineCreateInfo const & create_info, VkPipeline * out_vk_pipeline)
+        { return vkCreateComputePipelines(ret.device->vk_device, vk_pipeline_cache, 1u, &create_info, nullptr, out_vk_pipeline); },
         &ret.vk_pipeline);
     vkDestroyShaderModule(ret.device->vk_device, vk_shader_module, nullptr);
     if (pipeline_result != VK_SUCCESS)
@@ -395,6 +1019,10 @@ auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineIn
         };
         ret.device->vkSetDebugUtilsObjectNameEXT(ret.device->vk_device, &name_info);
     }
+    if (device->info.capturable)
+    {
+        ret.capture_record = capture_pipeline_record(*info);
+    }
     ret.strong_count = 1;
     device->inc_weak_refcnt();
     *out_pipeline = new daxa_ImplComputePipeline{};
@@ -402,6 +1030,50 @@ auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineIn
     return DAXA_RESULT_SUCCESS;
 }
 
+auto daxa_dvc_create_compute_pipelines(daxa_Device device, daxa_ComputePipelineInfo const * infos, usize info_count, daxa_ComputePipeline * out_pipelines) -> daxa_Result
+{
+    _DAXA_TEST_PRINT("daxa_dvc_create_compute_pipelines\n");
+    // The shared pipeline cache is internally synchronized, so the workers only contend on the next index.
+    std::vector<daxa_Result> results(info_count, DAXA_RESULT_SUCCESS);
+    std::atomic<usize> next_index = 0;
+    auto worker = [&]()
+    {
+        for (usize i = next_index.fetch_add(1, std::memory_order_relaxed); i < info_count; i = next_index.fetch_add(1, std::memory_order_relaxed))
+        {
+            out_pipelines[i] = {};
+            results[i] = daxa_dvc_create_compute_pipeline(device, &infos[i], &out_pipelines[i]);
+        }
+    };
+    usize const thread_count = std::min<usize>(info_count, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads = {};
+    threads.reserve(thread_count > 0 ? thread_count - 1 : 0);
+    for (usize t = 1; t < thread_count; ++t)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    auto const first_failure = std::find_if(results.begin(), results.end(), [](daxa_Result r)
+                                            { return r != DAXA_RESULT_SUCCESS; });
+    if (first_failure == results.end())
+    {
+        return DAXA_RESULT_SUCCESS;
+    }
+    for (usize i = 0; i < info_count; ++i)
+    {
+        if (out_pipelines[i] != nullptr)
+        {
+            daxa_compute_pipeline_dec_refcnt(out_pipelines[i]);
+            out_pipelines[i] = {};
+        }
+    }
+    return *first_failure;
+}
+
 auto daxa_compute_pipeline_info(daxa_ComputePipeline self) -> daxa_ComputePipelineInfo const *
 {
     return reinterpret_cast<daxa_ComputePipelineInfo const *>(&self->info);
@@ -419,12 +1091,50 @@ auto daxa_compute_pipeline_dec_refcnt(daxa_ComputePipeline self) -> u64
         self->device->instance);
 }
 
+auto daxa_dvc_create_compute_pipeline_async(daxa_Device device, daxa_ComputePipelineInfo const * info, daxa_ComputePipeline fallback, daxa_ComputePipeline * out_pipeline) -> daxa_Result
+{
+    _DAXA_TEST_PRINT("daxa_dvc_create_compute_pipeline_async\n");
+    auto const & cpp_info = *reinterpret_cast<ComputePipelineInfo const *>(info);
+    if (cpp_info.indirect_bindable && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DEVICE_GENERATED_COMMANDS) == 0)
+    {
+        return DAXA_RESULT_ERROR_DEVICE_GENERATED_COMMANDS_NOT_SUPPORTED;
+    }
+    VkPipelineLayout vk_pipeline_layout = {};
+    auto const layout_result = device->gpu_sro_table.pipeline_layout(device->vk_device, cpp_info.push_constant_size, vk_pipeline_layout);
+    _DAXA_RETURN_IF_ERROR(layout_result, layout_result)
+    // Created in place, the copied shader info points into the pipeline.
+    auto * ret = new daxa_ImplComputePipeline{};
+    ret->device = device;
+    ret->info = cpp_info;
+    ret->vk_pipeline_layout = vk_pipeline_layout;
+    copy_async_shader_infos(*ret, std::array{&ret->info.shader_info});
+    if (device->info.capturable)
+    {
+        ret->capture_record = capture_pipeline_record(*info);
+    }
+    start_async_pipeline(device, *ret, fallback, &compile_async_compute_pipeline);
+    *out_pipeline = ret;
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_compute_pipeline_status(daxa_ComputePipeline self) -> daxa_PipelineStatus
+{
+    return self->load_status();
+}
+
+auto daxa_compute_pipeline_wait(daxa_ComputePipeline self) -> daxa_Result
+{
+    return self->wait_for_compilation();
+}
+
 auto daxa_dvc_create_ray_tracing_pipeline(daxa_Device device, daxa_RayTracingPipelineInfo const * info, daxa_RayTracingPipeline * out_pipeline) -> daxa_Result
 {
     _DAXA_TEST_PRINT("daxa_dvc_create_ray_tracing_pipeline\n");
     daxa_ImplRayTracingPipeline ret = {};
     ret.device = device;
     ret.info = *reinterpret_cast<RayTracingPipelineInfo const *>(info);
+    auto const layout_result = device->gpu_sro_table.pipeline_layout(device->vk_device, ret.info.push_constant_size, ret.vk_pipeline_layout);
+    _DAXA_RETURN_IF_ERROR(layout_result, layout_result)
 
     ret.shader_groups.resize(ret.info.shader_groups.size());
     for (int i = 0; i < ret.shader_groups.size(); ++i)
@@ -469,6 +1179,8 @@ auto daxa_dvc_create_ray_tracing_pipeline(daxa_Device device, daxa_RayTracingPip
     std::vector<VkPipelineShaderStageRequiredSubgroupSizeCreateInfo> require_subgroup_size_vkstructs = {};
     // Necessary to prevent re-allocation
     require_subgroup_size_vkstructs.reserve(all_stages_count);
+    std::vector<SpecializationInfoStorage> specialization_infos = {};
+    specialization_infos.reserve(all_stages_count);
 
     auto create_shader_module = [&](ShaderInfo const & shader_info, VkShaderStageFlagBits shader_stage) -> VkResult
     {
@@ -499,7 +1211,7 @@ auto daxa_dvc_create_ray_tracing_pipeline(daxa_Device device, daxa_RayTracingPip
             .stage = shader_stage,
             .module = vk_shader_module,
             .pName = entry_point_names.back()->c_str(),
-            .pSpecializationInfo = nullptr,
+            .pSpecializationInfo = specialization_infos.emplace_back().fill(shader_info),
         };
         stages.push_back(vk_pipeline_shader_stage_create_info);
         return result;
@@ -567,11 +1279,12 @@ auto daxa_dvc_create_ray_tracing_pipeline(daxa_Device device, daxa_RayTracingPip
     u32 const group_count = static_cast<u32>(groups.size());
     u32 const stages_count = static_cast<u32>(stages.size());
 
-    ret.vk_pipeline_layout = ret.device->gpu_sro_table.pipeline_layouts.at((ret.info.push_constant_size + 3) / 4);
     VkRayTracingPipelineCreateInfoKHR const vk_ray_tracing_pipeline_create_info{
         .sType = VK_STRUCTURE_TYPE_RAY_TRACING_PIPELINE_CREATE_INFO_KHR,
         .pNext = nullptr,
-        .flags = {},
+        // Without the flag, traces through blas with opacity micromaps are undefined.
+        .flags = ret.device->gpu_sro_table.pipeline_create_flags |
+                 ((ret.device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_OPACITY_MICROMAP) != 0 ? VkPipelineCreateFlags{VK_PIPELINE_CREATE_RAY_TRACING_OPACITY_MICROMAP_BIT_EXT} : VkPipelineCreateFlags{}),
         .stageCount = stages_count,
         .pStages = stages.data(),
         .groupCount = group_count,
@@ -587,7 +1300,7 @@ auto daxa_dvc_create_ray_tracing_pipeline(daxa_Device device, daxa_RayTracingPip
     auto pipeline_result = ret.device->vkCreateRayTracingPipelinesKHR(
         ret.device->vk_device,
         VK_NULL_HANDLE,
-        VK_NULL_HANDLE,
+        ret.device->vk_pipeline_cache,
         1u,
         &vk_ray_tracing_pipeline_create_info,
         nullptr,
@@ -851,10 +1564,156 @@ auto daxa_ray_tracing_pipeline_dec_refcnt(daxa_RayTracingPipeline self) -> u64
 
 // --- Begin Internals ---
 
+auto SpecializationInfoStorage::fill(ShaderInfo const & shader_info) -> VkSpecializationInfo const *
+{
+    if (shader_info.specialization_constants.empty())
+    {
+        return nullptr;
+    }
+    this->map_entries.clear();
+    this->data.clear();
+    for (usize i = 0; i < shader_info.specialization_constants.size(); ++i)
+    {
+        auto const & constant = shader_info.specialization_constants[i];
+        this->map_entries.push_back(VkSpecializationMapEntry{
+            .constantID = constant.constant_id,
+            .offset = static_cast<u32>(this->data.size() * sizeof(u32)),
+            .size = sizeof(u32),
+        });
+        this->data.push_back(constant.value);
+    }
+    this->vk_specialization_info = VkSpecializationInfo{
+        .mapEntryCount = static_cast<u32>(this->map_entries.size()),
+        .pMapEntries = this->map_entries.data(),
+        .dataSize = this->data.size() * sizeof(u32),
+        .pData = this->data.data(),
+    };
+    return &this->vk_specialization_info;
+}
+
+auto PipelineBinaryArchive::serialize(std::span<char const, VK_UUID_SIZE> pipeline_cache_uuid) -> std::vector<std::byte>
+{
+    std::unique_lock const lock{this->mtx};
+    std::vector<std::byte> ret = {};
+    append_bytes(ret, PIPELINE_BINARY_ARCHIVE_MAGIC);
+    append_bytes(ret, PIPELINE_BINARY_ARCHIVE_VERSION);
+    append_bytes(ret, pipeline_cache_uuid.data(), pipeline_cache_uuid.size());
+    append_bytes(ret, static_cast<u32>(this->pipelines.size()));
+    for (auto const & [pipeline_key, binaries] : this->pipelines)
+    {
+        append_bytes(ret, static_cast<u32>(pipeline_key.size()));
+        append_bytes(ret, pipeline_key.data(), pipeline_key.size());
+        append_bytes(ret, static_cast<u32>(binaries.size()));
+        for (auto const & binary : binaries)
+        {
+            append_bytes(ret, static_cast<u32>(binary.key.size()));
+            append_bytes(ret, binary.key.data(), binary.key.size());
+            append_bytes(ret, static_cast<u64>(binary.data.size()));
+            append_bytes(ret, binary.data.data(), binary.data.size());
+        }
+    }
+    this->dirty = false;
+    return ret;
+}
+
+void PipelineBinaryArchive::deserialize(std::span<std::byte const> blob, std::span<char const, VK_UUID_SIZE> pipeline_cache_uuid)
+{
+    std::unique_lock const lock{this->mtx};
+    this->pipelines.clear();
+    ByteReader reader{.bytes = blob};
+    u32 magic = {};
+    u32 version = {};
+    std::array<char, VK_UUID_SIZE> uuid = {};
+    u32 pipeline_count = {};
+    bool valid =
+        reader.read(magic) && magic == PIPELINE_BINARY_ARCHIVE_MAGIC &&
+        reader.read(version) && version == PIPELINE_BINARY_ARCHIVE_VERSION &&
+        reader.read(uuid.data(), uuid.size()) && std::equal(uuid.begin(), uuid.end(), pipeline_cache_uuid.begin()) &&
+        reader.read(pipeline_count);
+    for (u32 pipeline_i = 0; valid && pipeline_i < pipeline_count; ++pipeline_i)
+    {
+        u32 key_size = {};
+        u32 binary_count = {};
+        valid = reader.read(key_size) && key_size <= VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR;
+        std::string pipeline_key(valid ? key_size : 0, '\0');
+        valid = valid && reader.read(pipeline_key.data(), key_size) && reader.read(binary_count);
+        std::vector<Binary> binaries = {};
+        for (u32 binary_i = 0; valid && binary_i < binary_count; ++binary_i)
+        {
+            auto & binary = binaries.emplace_back();
+            u32 binary_key_size = {};
+            u64 data_size = {};
+            valid = reader.read(binary_key_size) && binary_key_size <= VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR;
+            binary.key.resize(valid ? binary_key_size : 0);
+            valid = valid && reader.read(binary.key.data(), binary_key_size) && reader.read(data_size) && data_size <= blob.size() - reader.offset;
+            binary.data.resize(valid ? static_cast<usize>(data_size) : 0);
+            valid = valid && reader.read(binary.data.data(), binary.data.size());
+        }
+        if (valid)
+        {
+            this->pipelines.emplace(std::move(pipeline_key), std::move(binaries));
+        }
+    }
+    if (!valid)
+    {
+        this->pipelines.clear();
+    }
+    this->dirty = false;
+}
+
+void GraphicsPipelineLibraryCache::cleanup(VkDevice vk_device)
+{
+    for (auto const & [key, vk_library] : this->parts)
+    {
+        vkDestroyPipeline(vk_device, vk_library, nullptr);
+    }
+    this->parts.clear();
+}
+
+auto ImplPipeline::load_status() -> daxa_PipelineStatus
+{
+    return static_cast<daxa_PipelineStatus>(std::atomic_ref{this->status}.load(std::memory_order::acquire));
+}
+
+auto ImplPipeline::wait_for_compilation() -> daxa_Result
+{
+    if (this->load_status() == DAXA_PIPELINE_STATUS_PENDING)
+    {
+        std::unique_lock lock{this->device->pipeline_compile_mtx};
+        this->device->pipeline_compiled_cv.wait(lock, [&]()
+                                                { return this->load_status() != DAXA_PIPELINE_STATUS_PENDING; });
+    }
+    return this->async_result;
+}
+
 void ImplPipeline::zero_ref_callback(ImplHandle const * handle)
 {
     _DAXA_TEST_PRINT("ImplPipeline::zero_ref_callback\n");
     auto * self = rc_cast<ImplPipeline *>(handle);
+    if (self->load_status() == DAXA_PIPELINE_STATUS_PENDING)
+    {
+        // Removes the job when no worker took it yet, otherwise waits for the worker compiling it.
+        bool cancelled = false;
+        {
+            std::unique_lock const lock{self->device->pipeline_compile_mtx};
+            auto & jobs = self->device->pipeline_compile_jobs;
+            auto const job = std::find_if(jobs.begin(), jobs.end(), [&](PipelineCompileJob const & j)
+                                          { return j.pipeline == self; });
+            if (job != jobs.end())
+            {
+                jobs.erase(job);
+                cancelled = true;
+            }
+        }
+        if (!cancelled)
+        {
+            [[maybe_unused]] auto const result = self->wait_for_compilation();
+        }
+    }
+    if (self->async_fallback != nullptr)
+    {
+        self->async_fallback->dec_refcnt(&ImplPipeline::zero_ref_callback, self->device->instance);
+    }
     std::unique_lock const lock{self->device->zombies_mtx};
     u64 const submit_timeline_value = self->device->global_submit_timeline.load(std::memory_order::relaxed);
     self->device->pipeline_zombies.emplace_front(
@@ -1,6 +1,13 @@
 #pragma once
 
 #include <daxa/pipeline.hpp>
+#include <daxa/c/pipeline.h>
+
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "impl_core.hpp"
 
@@ -13,15 +20,82 @@ struct PipelineZombie
     VkPipeline vk_pipeline = {};
 };
 
+// Binaries captured with VK_KHR_pipeline_binary, keyed by the global key of the pipeline create info.
+// Persisted next to the pipeline cache, a hit recreates the pipeline without compiling it.
+struct PipelineBinaryArchive
+{
+    struct Binary
+    {
+        std::string key = {};
+        std::vector<std::byte> data = {};
+    };
+
+    bool enabled = {};
+    std::mutex mtx = {};
+    std::unordered_map<std::string, std::vector<Binary>> pipelines = {};
+    // Set when pipelines were added since the archive was loaded or saved.
+    bool dirty = {};
+
+    auto serialize(std::span<char const, VK_UUID_SIZE> pipeline_cache_uuid) -> std::vector<std::byte>;
+    // Leaves the archive empty when the blob is truncated or was written by a different driver.
+    void deserialize(std::span<std::byte const> blob, std::span<char const, VK_UUID_SIZE> pipeline_cache_uuid);
+};
+
+// Graphics pipeline library parts shared by all raster pipelines that are linked from libraries.
+// Keyed by the state a part depends on, so pipelines differing only in other parts reuse it without compiling.
+// Linked pipelines do not reference their libraries, parts live until the device is destroyed.
+struct GraphicsPipelineLibraryCache
+{
+    std::mutex mtx = {};
+    std::unordered_map<std::string, VkPipeline> parts = {};
+
+    void cleanup(VkDevice vk_device);
+};
+
+// Backs the VkSpecializationInfo of one shader stage until its pipeline is created.
+struct SpecializationInfoStorage
+{
+    std::vector<VkSpecializationMapEntry> map_entries = {};
+    std::vector<u32> data = {};
+    VkSpecializationInfo vk_specialization_info = {};
+
+    // Returns nullptr when the shader has no specialization constants.
+    auto fill(ShaderInfo const & shader_info) -> VkSpecializationInfo const *;
+};
+
 struct ImplPipeline : ImplHandle
 {
     daxa_Device device = {};
     VkPipeline vk_pipeline = {};
     VkPipelineLayout vk_pipeline_layout = {};
+    // Only kept with DeviceInfo2::capturable, see capture_pipeline_record.
+    std::vector<std::byte> capture_record = {};
+    // Capture the pipeline was last written into and its index there, guarded by CaptureState::mtx.
+    u64 capture_generation = {};
+    u64 capture_index = {};
+    // daxa_PipelineStatus, only pipelines created asynchronously start out pending.
+    // Accessed with atomic refs. The worker writes vk_pipeline and async_result before publishing the status under the pipeline compile lock of the device.
+    u32 status = DAXA_PIPELINE_STATUS_READY;
+    daxa_Result async_result = DAXA_RESULT_SUCCESS;
+    // Bound in place of the pipeline while it is pending, strong reference released with the pipeline.
+    ImplPipeline * async_fallback = {};
+    // Own the byte code and specialization constants the info points to, the caller's may be gone when the worker compiles.
+    std::vector<u32> async_byte_code = {};
+    std::vector<SpecializationConstant> async_specialization_constants = {};
 
+    auto load_status() -> daxa_PipelineStatus;
+    auto wait_for_compilation() -> daxa_Result;
     static void zero_ref_callback(ImplHandle const * handle);
 };
 
+// Compilation of an asynchronously created pipeline, run by the pipeline compile workers of the device.
+struct PipelineCompileJob
+{
+    ImplPipeline * pipeline = {};
+    // Creates the pipeline synchronously and moves its vk pipeline into the pending one.
+    void (*compile)(ImplPipeline & pipeline) = {};
+};
+
 struct daxa_ImplRasterPipeline final : ImplPipeline
 {
     RasterPipelineInfo info = {};
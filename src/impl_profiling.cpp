@@ -0,0 +1,126 @@
+#include "impl_core.hpp"
+#include "impl_profiling.hpp"
+
+#include <atomic>
+#include <chrono>
+
+#if DAXA_BUILT_WITH_PROFILING_BUILTIN && !DAXA_BUILT_WITH_PROFILING_TRACY
+
+/// --- Begin Helpers ---
+
+namespace
+{
+    // Every slot is a seqlock: odd sequences are being written, even ones hold the zone of write index (sequence / 2 - 1).
+    // Writers never wait, readers skip slots that are written or overwritten while they read them.
+    struct ProfileZoneSlot
+    {
+        std::atomic<u64> sequence = {};
+        std::atomic<char const *> name = {};
+        std::atomic<u64> begin_ns = {};
+        std::atomic<u64> end_ns = {};
+        std::atomic<u32> thread_index = {};
+        std::atomic<u32> depth = {};
+    };
+
+    struct ProfileZoneRing
+    {
+        std::array<ProfileZoneSlot, DAXA_PROFILE_ZONE_RING_CAPACITY> slots = {};
+        std::atomic<u64> write_index = {};
+        std::atomic<u32> thread_count = {};
+        // Only accessed with the read mutex locked.
+        std::mutex read_mtx = {};
+        u64 read_index = {};
+    };
+
+    auto profile_zone_ring() -> ProfileZoneRing &
+    {
+        static ProfileZoneRing ring = {};
+        return ring;
+    }
+
+    thread_local u32 profile_zone_thread_depth = {};
+    thread_local u32 profile_zone_thread_index = ~0u;
+} // namespace
+
+/// --- End Helpers ---
+
+namespace daxa
+{
+    auto profile_zone_now_ns() -> u64
+    {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    auto profile_zone_enter() -> u32
+    {
+        return profile_zone_thread_depth++;
+    }
+
+    void profile_zone_exit(char const * name, u64 begin_ns, u32 depth)
+    {
+        u64 const end_ns = profile_zone_now_ns();
+        profile_zone_thread_depth = depth;
+        auto & ring = profile_zone_ring();
+        if (profile_zone_thread_index == ~0u)
+        {
+            profile_zone_thread_index = ring.thread_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        u64 const index = ring.write_index.fetch_add(1, std::memory_order_relaxed);
+        ProfileZoneSlot & slot = ring.slots[index % DAXA_PROFILE_ZONE_RING_CAPACITY];
+        slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+        slot.end_ns.store(end_ns, std::memory_order_relaxed);
+        slot.thread_index.store(profile_zone_thread_index, std::memory_order_relaxed);
+        slot.depth.store(depth, std::memory_order_relaxed);
+        slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    }
+} // namespace daxa
+
+#endif
+
+// --- Begin API Functions ---
+
+auto daxa_collect_profile_zones(daxa_ProfileZone * out_zones, daxa_u32 * inout_count) -> daxa_Result
+{
+#if DAXA_BUILT_WITH_PROFILING_BUILTIN && !DAXA_BUILT_WITH_PROFILING_TRACY
+    auto & ring = profile_zone_ring();
+    std::unique_lock const lock{ring.read_mtx};
+    u64 const write_index = ring.write_index.load(std::memory_order_acquire);
+    u64 index = std::max(ring.read_index, write_index > DAXA_PROFILE_ZONE_RING_CAPACITY ? write_index - DAXA_PROFILE_ZONE_RING_CAPACITY : 0ull);
+    u32 count = 0;
+    for (; index < write_index && count < *inout_count; ++index)
+    {
+        ProfileZoneSlot const & slot = ring.slots[index % DAXA_PROFILE_ZONE_RING_CAPACITY];
+        u64 const sequence = slot.sequence.load(std::memory_order_acquire);
+        // Zones still being written are dropped, waiting for them would stall on preempted writers.
+        if (sequence != index * 2 + 2)
+        {
+            continue;
+        }
+        daxa_ProfileZone const zone = {
+            .name = slot.name.load(std::memory_order_relaxed),
+            .begin_ns = slot.begin_ns.load(std::memory_order_relaxed),
+            .end_ns = slot.end_ns.load(std::memory_order_relaxed),
+            .thread_index = slot.thread_index.load(std::memory_order_relaxed),
+            .depth = slot.depth.load(std::memory_order_relaxed),
+        };
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            continue;
+        }
+        out_zones[count++] = zone;
+    }
+    ring.read_index = index;
+    *inout_count = count;
+    return index < write_index ? DAXA_RESULT_INCOMPLETE : DAXA_RESULT_SUCCESS;
+#else
+    (void)out_zones;
+    *inout_count = 0;
+    return DAXA_RESULT_SUCCESS;
+#endif
+}
+
+// --- End API Functions ---
@@ -0,0 +1,42 @@
+#pragma once
+
+// Cpu zones of the hot paths of daxa. Without a profiling backend the macros expand to nothing.
+// NAME must be a string literal.
+//   DAXA_ENABLE_PROFILING_TRACY:   zones are sent to tracy, so they show up in the captures of the application.
+//   DAXA_ENABLE_PROFILING_BUILTIN: zones are written into a ring, read with daxa_collect_profile_zones.
+
+#define _DAXA_PROFILE_CONCAT_IMPL(A, B) A##B
+#define _DAXA_PROFILE_CONCAT(A, B) _DAXA_PROFILE_CONCAT_IMPL(A, B)
+
+#if DAXA_BUILT_WITH_PROFILING_TRACY
+#include <tracy/Tracy.hpp>
+
+#define DAXA_PROFILE_ZONE(NAME) ZoneScopedN(NAME)
+#elif DAXA_BUILT_WITH_PROFILING_BUILTIN
+#include <daxa/types.hpp>
+
+namespace daxa
+{
+    auto profile_zone_now_ns() -> u64;
+    auto profile_zone_enter() -> u32;
+    void profile_zone_exit(char const * name, u64 begin_ns, u32 depth);
+
+    struct ProfileZoneScope
+    {
+        char const * name = {};
+        u64 begin_ns = {};
+        u32 depth = {};
+
+        explicit ProfileZoneScope(char const * a_name) : name{a_name}, begin_ns{profile_zone_now_ns()}, depth{profile_zone_enter()} {}
+        ~ProfileZoneScope() { profile_zone_exit(name, begin_ns, depth); }
+        ProfileZoneScope(ProfileZoneScope const &) = delete;
+        ProfileZoneScope(ProfileZoneScope &&) = delete;
+        auto operator=(ProfileZoneScope const &) -> ProfileZoneScope & = delete;
+        auto operator=(ProfileZoneScope &&) -> ProfileZoneScope & = delete;
+    };
+} // namespace daxa
+
+#define DAXA_PROFILE_ZONE(NAME) ::daxa::ProfileZoneScope const _DAXA_PROFILE_CONCAT(daxa_profile_zone_, __LINE__){NAME}
+#else
+#define DAXA_PROFILE_ZONE(NAME) static_cast<void>(0)
+#endif
@@ -0,0 +1,184 @@
+#include "impl_shader_object.hpp"
+
+#include <string>
+
+#include "impl_device.hpp"
+#include "impl_pipeline.hpp"
+
+/// --- Begin Helpers ---
+
+namespace
+{
+    // Stages a shader may be followed by. Geometry shaders are not enabled by daxa, so they are never listed.
+    auto next_shader_stages(VkShaderStageFlagBits stage) -> VkShaderStageFlags
+    {
+        switch (stage)
+        {
+        case VK_SHADER_STAGE_VERTEX_BIT: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT: return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case VK_SHADER_STAGE_TASK_BIT_EXT: return VK_SHADER_STAGE_MESH_BIT_EXT;
+        case VK_SHADER_STAGE_MESH_BIT_EXT: return VK_SHADER_STAGE_FRAGMENT_BIT;
+        default: return {};
+        }
+    }
+
+    auto is_valid_shader_object_stage(VkShaderStageFlagBits stage) -> bool
+    {
+        switch (stage)
+        {
+        case VK_SHADER_STAGE_VERTEX_BIT:
+        case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+        case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+        case VK_SHADER_STAGE_FRAGMENT_BIT:
+        case VK_SHADER_STAGE_COMPUTE_BIT:
+        case VK_SHADER_STAGE_TASK_BIT_EXT:
+        case VK_SHADER_STAGE_MESH_BIT_EXT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // The subgroup size control flags have different bit positions for pipeline stages and shader objects.
+    auto shader_create_flags(daxa_ShaderObjectInfo const & info) -> VkShaderCreateFlagsEXT
+    {
+        VkShaderCreateFlagsEXT flags = {};
+        if ((info.shader_info.create_flags & VK_PIPELINE_SHADER_STAGE_CREATE_ALLOW_VARYING_SUBGROUP_SIZE_BIT) != 0)
+        {
+            flags |= VK_SHADER_CREATE_ALLOW_VARYING_SUBGROUP_SIZE_BIT_EXT;
+        }
+        if ((info.shader_info.create_flags & VK_PIPELINE_SHADER_STAGE_CREATE_REQUIRE_FULL_SUBGROUPS_BIT) != 0)
+        {
+            flags |= VK_SHADER_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT;
+        }
+        if (info.stage == VK_SHADER_STAGE_MESH_BIT_EXT && info.no_task_shader != 0)
+        {
+            flags |= VK_SHADER_CREATE_NO_TASK_SHADER_BIT_EXT;
+        }
+        return flags;
+    }
+} // namespace
+
+/// --- End Helpers ---
+
+// --- Begin API Functions ---
+
+auto daxa_dvc_create_shader_object(daxa_Device device, daxa_ShaderObjectInfo const * info, daxa_ShaderObject * out_shader_object) -> daxa_Result
+{
+    if ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_SHADER_OBJECT) == 0)
+    {
+        return DAXA_RESULT_ERROR_SHADER_OBJECT_NOT_SUPPORTED;
+    }
+    if (!is_valid_shader_object_stage(info->stage))
+    {
+        return DAXA_RESULT_ERROR_INVALID_SHADER_OBJECT_STAGE;
+    }
+    bool const is_mesh_stage = info->stage == VK_SHADER_STAGE_TASK_BIT_EXT || info->stage == VK_SHADER_STAGE_MESH_BIT_EXT;
+    if (is_mesh_stage && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER) == 0)
+    {
+        return DAXA_RESULT_MESH_SHADER_NOT_DEVICE_ENABLED;
+    }
+    if (info->push_constant_size > MAX_PUSH_CONSTANT_BYTE_SIZE)
+    {
+        return DAXA_RESULT_ERROR_SHADER_OBJECT_PUSH_CONSTANT_SIZE_MISMATCH;
+    }
+
+    auto ret = daxa_ImplShaderObject{};
+    ret.device = device;
+    ret.info = *info;
+    auto const layout_result = device->gpu_sro_table.pipeline_layout(device->vk_device, info->push_constant_size, ret.vk_pipeline_layout);
+    _DAXA_RETURN_IF_ERROR(layout_result, layout_result)
+
+    std::string const entry_point = std::string{info->shader_info.entry_point.view()};
+    VkShaderRequiredSubgroupSizeCreateInfoEXT const require_subgroup_size_vkstruct{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO,
+        .pNext = nullptr,
+        .requiredSubgroupSize = info->shader_info.required_subgroup_size.value_or(0),
+    };
+    SpecializationInfoStorage specialization_info = {};
+    VkPushConstantRange const vk_push_constant_range{
+        .stageFlags = VK_SHADER_STAGE_ALL,
+        .offset = 0,
+        .size = ((info->push_constant_size + 3) / 4) * 4,
+    };
+    VkShaderCreateInfoEXT const vk_shader_create_info{
+        .sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+        .pNext = info->shader_info.required_subgroup_size.has_value() ? &require_subgroup_size_vkstruct : nullptr,
+        .flags = shader_create_flags(*info),
+        .stage = info->stage,
+        .nextStage = next_shader_stages(info->stage),
+        .codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+        .codeSize = info->shader_info.byte_code_size * sizeof(u32),
+        .pCode = info->shader_info.byte_code,
+        .pName = entry_point.c_str(),
+        .setLayoutCount = static_cast<u32>(device->gpu_sro_table.vk_descriptor_set_layouts.size()),
+        .pSetLayouts = device->gpu_sro_table.vk_descriptor_set_layouts.data(),
+        .pushConstantRangeCount = info->push_constant_size > 0 ? 1u : 0u,
+        .pPushConstantRanges = info->push_constant_size > 0 ? &vk_push_constant_range : nullptr,
+        .pSpecializationInfo = specialization_info.fill(*reinterpret_cast<ShaderInfo const *>(&info->shader_info)),
+    };
+    auto vk_result = device->vkCreateShadersEXT(device->vk_device, 1, &vk_shader_create_info, nullptr, &ret.vk_shader);
+    if (vk_result != VK_SUCCESS)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+
+    if ((device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && info->name.size != 0)
+    {
+        std::string const c_name = std::string{info->name.view()};
+        VkDebugUtilsObjectNameInfoEXT const name_info{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            .pNext = nullptr,
+            .objectType = VK_OBJECT_TYPE_SHADER_EXT,
+            .objectHandle = std::bit_cast<u64>(ret.vk_shader),
+            .pObjectName = c_name.c_str(),
+        };
+        device->vkSetDebugUtilsObjectNameEXT(device->vk_device, &name_info);
+    }
+
+    ret.strong_count = 1;
+    device->inc_weak_refcnt();
+    *out_shader_object = new daxa_ImplShaderObject{};
+    **out_shader_object = std::move(ret);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_shader_object_info(daxa_ShaderObject self) -> daxa_ShaderObjectInfo const *
+{
+    return &self->info;
+}
+
+auto daxa_shader_object_inc_refcnt(daxa_ShaderObject self) -> u64
+{
+    return self->inc_refcnt();
+}
+
+auto daxa_shader_object_dec_refcnt(daxa_ShaderObject self) -> u64
+{
+    return self->dec_refcnt(
+        &daxa_ImplShaderObject::zero_ref_callback,
+        self->device->instance);
+}
+
+// --- End API Functions ---
+
+// --- Begin Internals ---
+
+void daxa_ImplShaderObject::zero_ref_callback(ImplHandle const * handle)
+{
+    auto * self = rc_cast<daxa_ShaderObject>(handle);
+    std::unique_lock const lock{self->device->zombies_mtx};
+    u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    self->device->shader_object_zombies.emplace_back(
+        submit_timeline,
+        ShaderObjectZombie{
+            .vk_shader = self->vk_shader,
+        });
+    self->device->dec_weak_refcnt(
+        daxa_ImplDevice::zero_ref_callback,
+        self->device->instance);
+    delete self;
+}
+
+// --- End Internals ---
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <daxa/c/pipeline.h>
+
+#include "impl_core.hpp"
+
+namespace daxa
+{
+    struct ShaderObjectZombie
+    {
+        VkShaderEXT vk_shader = {};
+    };
+} // namespace daxa
+
+struct daxa_ImplShaderObject final : ImplHandle
+{
+    daxa_Device device = {};
+    daxa_ShaderObjectInfo info = {};
+    VkShaderEXT vk_shader = {};
+    // The table layout matching info.push_constant_size, bound together with the shader.
+    VkPipelineLayout vk_pipeline_layout = {};
+
+    static void zero_ref_callback(ImplHandle const * handle);
+};
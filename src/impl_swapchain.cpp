@@ -4,6 +4,36 @@
 
 #include <utility>
 #include <bit>
+#include <chrono>
+
+/// --- Begin Helpers ---
+
+namespace
+{
+    // Present waits time out so that hidden or minimized windows do not block the frame forever.
+    constexpr u64 PRESENT_WAIT_TIMEOUT_NS = 100'000'000;
+
+    auto supported_latency_mode(daxa_Device device, SwapchainLatencyMode mode) -> SwapchainLatencyMode
+    {
+        if (mode == SwapchainLatencyMode::LOW_LATENCY && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_LOW_LATENCY) == 0)
+        {
+            mode = SwapchainLatencyMode::PRESENT_WAIT;
+        }
+        if (mode == SwapchainLatencyMode::PRESENT_WAIT && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_PRESENT_WAIT) == 0)
+        {
+            mode = SwapchainLatencyMode::DEFAULT;
+        }
+        return mode;
+    }
+
+    // On linux steady_clock is CLOCK_MONOTONIC, the clock of VK_GOOGLE_display_timing.
+    auto now_ns() -> u64
+    {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+} // namespace
+
+/// --- End Helpers ---
 
 // --- Begin API Functions ---
 
@@ -25,6 +55,7 @@ auto daxa_dvc_create_swapchain(daxa_Device device, daxa_SwapchainInfo const * in
     auto ret = daxa_ImplSwapchain{};
     ret.device = device;
     ret.info = *reinterpret_cast<SwapchainInfo const *>(info);
+    ret.info.latency_mode = supported_latency_mode(device, ret.info.latency_mode);
     auto result = ret.recreate_surface();
     if (result != DAXA_RESULT_SUCCESS)
     {
@@ -141,6 +172,21 @@ auto daxa_dvc_create_swapchain(daxa_Device device, daxa_SwapchainInfo const * in
         return result;
     }
 
+    if (ret.info.latency_mode == SwapchainLatencyMode::LOW_LATENCY)
+    {
+        auto latency_sema_name = SmallString(std::string{ret.info.name.view()} + " latency sleep");
+        auto latency_sema_info = daxa_TimelineSemaphoreInfo{
+            .initial_value = 0,
+            .name = std::bit_cast<daxa_SmallString>(latency_sema_name),
+        };
+        result = daxa_dvc_create_timeline_semaphore(device, &latency_sema_info, r_cast<daxa_TimelineSemaphore *>(&ret.latency_sleep_semaphore));
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            ret.full_cleanup();
+            return result;
+        }
+    }
+
     ret.strong_count = 1;
     *out_swapchain = new daxa_ImplSwapchain{};
     **out_swapchain = std::move(ret);
@@ -162,7 +208,6 @@ auto daxa_swp_resize(daxa_Swapchain self) -> daxa_Result
     auto result = self->recreate();
     if (result != DAXA_RESULT_SUCCESS)
     {
-        [[maybe_unused]] auto ignored = vkDeviceWaitIdle(self->device->vk_device);
         self->full_cleanup();
     }
     return result;
@@ -174,14 +219,60 @@ auto daxa_swp_set_present_mode(daxa_Swapchain self, VkPresentModeKHR present_mod
     auto result = self->recreate();
     if (result != DAXA_RESULT_SUCCESS)
     {
-        [[maybe_unused]] auto ignored = vkDeviceWaitIdle(self->device->vk_device);
         self->full_cleanup();
     }
     return result;
 }
 
+auto daxa_swp_wait_for_frame_start(daxa_Swapchain self) -> daxa_Result
+{
+    // The frame started now is presented with the id of the next acquire.
+    u64 const next_present_id = self->cpu_frame_timeline + 1;
+    switch (self->info.latency_mode)
+    {
+    case SwapchainLatencyMode::LOW_LATENCY:
+    {
+        self->latency_sleep_value += 1;
+        VkLatencySleepInfoNV const sleep_info{
+            .sType = VK_STRUCTURE_TYPE_LATENCY_SLEEP_INFO_NV,
+            .pNext = nullptr,
+            .signalSemaphore = (**r_cast<daxa_TimelineSemaphore *>(&self->latency_sleep_semaphore)).vk_semaphore,
+            .value = self->latency_sleep_value,
+        };
+        auto result = static_cast<daxa_Result>(self->device->vkLatencySleepNV(self->device->vk_device, self->vk_swapchain, &sleep_info));
+        _DAXA_RETURN_IF_ERROR(result, result)
+        [[maybe_unused]] auto _ignored = self->latency_sleep_semaphore.wait_for_value(self->latency_sleep_value);
+        self->set_latency_marker(next_present_id, VK_LATENCY_MARKER_SIMULATION_START_NV);
+        break;
+    }
+    case SwapchainLatencyMode::PRESENT_WAIT:
+    {
+        // With one frame in flight, the cpu waits until the previous frame is on screen.
+        u64 const wait_id = next_present_id - std::min<u64>(next_present_id, self->info.max_allowed_frames_in_flight);
+        if (self->first_present_id != 0 && wait_id >= self->first_present_id && wait_id <= self->last_present_id)
+        {
+            auto vk_result = self->device->vkWaitForPresentKHR(self->device->vk_device, self->vk_swapchain, wait_id, PRESENT_WAIT_TIMEOUT_NS);
+            // A timed out wait only starts the frame early.
+            if (vk_result != VK_SUCCESS && vk_result != VK_TIMEOUT && vk_result != VK_SUBOPTIMAL_KHR)
+            {
+                return std::bit_cast<daxa_Result>(vk_result);
+            }
+            auto * statistics = self->frame_statistics_of(wait_id);
+            if (vk_result != VK_TIMEOUT && statistics != nullptr && statistics->actual_present_time_ns == 0)
+            {
+                statistics->actual_present_time_ns = now_ns();
+            }
+        }
+        break;
+    }
+    default: break;
+    }
+    return DAXA_RESULT_SUCCESS;
+}
+
 auto daxa_swp_acquire_next_image(daxa_Swapchain self, daxa_ImageId * out_image_id) -> daxa_Result
 {
+    u64 const acquire_start_time_ns = now_ns();
     [[maybe_unused]] auto _ignored = self->gpu_frame_timeline.wait_for_value(
         static_cast<u64>(
             std::max<i64>(
@@ -199,6 +290,14 @@ auto daxa_swp_acquire_next_image(daxa_Swapchain self, daxa_ImageId * out_image_i
     // We only bump the cpu timeline, when the acquire succeeds.
     self->cpu_frame_timeline += 1;
     *out_image_id = static_cast<daxa_ImageId>(self->images[self->current_image_index]);
+
+    self->acquire_end_time_ns = now_ns();
+    self->update_frame_statistics(self->acquire_end_time_ns);
+    self->frame_statistics[self->cpu_frame_timeline % DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT] = SwapchainFrameStatistics{
+        .frame_index = self->cpu_frame_timeline,
+        .acquire_wait_ns = self->acquire_end_time_ns - acquire_start_time_ns,
+        .refresh_duration_ns = self->refresh_duration_ns,
+    };
     return std::bit_cast<daxa_Result>(result);
 }
 
@@ -217,6 +316,11 @@ auto daxa_swp_gpu_timeline_semaphore(daxa_Swapchain self) -> daxa_TimelineSemaph
     return r_cast<daxa_TimelineSemaphore *>(&self->gpu_frame_timeline);
 }
 
+auto daxa_swp_frame_statistics(daxa_Swapchain self) -> daxa_SwapchainFrameStatistics const *
+{
+    return r_cast<daxa_SwapchainFrameStatistics const *>(self->frame_statistics.data());
+}
+
 auto daxa_swp_current_cpu_timeline_value(daxa_Swapchain self) -> u64
 {
     return self->cpu_frame_timeline;
@@ -283,18 +387,23 @@ auto daxa_ImplSwapchain::recreate() -> daxa_Result
 
     auto * old_swapchain = this->vk_swapchain;
 
-    // NOTE: this is a hack that allows us to ignore issues caused
-    // by things that are just underspecified in the Vulkan spec.
-    result = daxa_dvc_wait_idle(this->device);
+    // Presents can not be tracked with timeline semaphores, waiting for the present queues makes sure none of the old swapchain are pending.
+    // Other queues keep running, the old images are zombified in partial_cleanup.
+    result = this->wait_present_queues_idle();
     _DAXA_RETURN_IF_ERROR(result, result)
 
     this->partial_cleanup();
 
     ImageUsageFlags const usage = std::bit_cast<ImageUsageFlags>(info.image_usage) | ImageUsageFlagBits::COLOR_ATTACHMENT;
 
+    VkSwapchainLatencyCreateInfoNV const latency_create_info{
+        .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_LATENCY_CREATE_INFO_NV,
+        .pNext = nullptr,
+        .latencyModeEnable = VK_TRUE,
+    };
     VkSwapchainCreateInfoKHR const swapchain_create_info{
         .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
-        .pNext = nullptr,
+        .pNext = info.latency_mode == SwapchainLatencyMode::LOW_LATENCY ? &latency_create_info : nullptr,
         .flags = 0,
         .surface = this->vk_surface,
         .minImageCount = 3,
@@ -376,12 +485,124 @@ auto daxa_ImplSwapchain::recreate() -> daxa_Result
 
     if (old_swapchain != VK_NULL_HANDLE)
     {
-        vkDestroySwapchainKHR(this->device->vk_device, old_swapchain, nullptr);
+        this->retired_vk_swapchains.emplace_back(this->device->global_submit_timeline.load(std::memory_order::relaxed), old_swapchain);
+    }
+    result = this->destroy_finished_retired_vk_swapchains();
+    _DAXA_RETURN_IF_ERROR(result, result)
+    this->first_present_id = 0;
+    this->last_present_id = 0;
+
+    this->refresh_duration_ns = 0;
+    if ((this->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING) != 0)
+    {
+        VkRefreshCycleDurationGOOGLE refresh_cycle = {};
+        if (this->device->vkGetRefreshCycleDurationGOOGLE(this->device->vk_device, this->vk_swapchain, &refresh_cycle) == VK_SUCCESS)
+        {
+            this->refresh_duration_ns = refresh_cycle.refreshDuration;
+        }
+    }
+
+    if (info.latency_mode == SwapchainLatencyMode::LOW_LATENCY)
+    {
+        VkLatencySleepModeInfoNV const sleep_mode_info{
+            .sType = VK_STRUCTURE_TYPE_LATENCY_SLEEP_MODE_INFO_NV,
+            .pNext = nullptr,
+            .lowLatencyMode = VK_TRUE,
+            .lowLatencyBoost = VK_TRUE,
+            .minimumIntervalUs = 0,
+        };
+        result = static_cast<daxa_Result>(this->device->vkSetLatencySleepModeNV(this->device->vk_device, this->vk_swapchain, &sleep_mode_info));
+        _DAXA_RETURN_IF_ERROR(result, result)
     }
     
     return DAXA_RESULT_SUCCESS;
 }
 
+auto daxa_ImplSwapchain::wait_present_queues_idle() -> daxa_Result
+{
+    auto const family = static_cast<daxa_QueueFamily>(this->info.queue_family);
+    for (u32 index = 0; index < this->device->queue_families[family].queue_count; ++index)
+    {
+        auto result = daxa_dvc_queue_wait_idle(this->device, daxa_Queue{.family = family, .index = index});
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_ImplSwapchain::destroy_finished_retired_vk_swapchains() -> daxa_Result
+{
+    u64 min_pending_timeline_value = {};
+    auto result = this->device->get_retired_submit_timeline_value(min_pending_timeline_value);
+    _DAXA_RETURN_IF_ERROR(result, result)
+    while (!this->retired_vk_swapchains.empty() && this->retired_vk_swapchains.front().first < min_pending_timeline_value)
+    {
+        vkDestroySwapchainKHR(this->device->vk_device, this->retired_vk_swapchains.front().second, nullptr);
+        this->retired_vk_swapchains.pop_front();
+    }
+    return DAXA_RESULT_SUCCESS;
+}
+
+void daxa_ImplSwapchain::set_latency_marker(u64 present_id, VkLatencyMarkerNV marker)
+{
+    VkSetLatencyMarkerInfoNV const marker_info{
+        .sType = VK_STRUCTURE_TYPE_SET_LATENCY_MARKER_INFO_NV,
+        .pNext = nullptr,
+        .presentID = present_id,
+        .marker = marker,
+    };
+    this->device->vkSetLatencyMarkerNV(this->device->vk_device, this->vk_swapchain, &marker_info);
+}
+
+auto daxa_ImplSwapchain::frame_statistics_of(u64 frame_index) -> SwapchainFrameStatistics *
+{
+    auto & statistics = this->frame_statistics[frame_index % DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT];
+    return statistics.frame_index == frame_index && frame_index != 0 ? &statistics : nullptr;
+}
+
+void daxa_ImplSwapchain::update_frame_statistics(u64 now_ns)
+{
+    u64 const gpu_value = this->gpu_frame_timeline.value();
+    // Frames older than the ring are lost, there is no need to walk over them.
+    u64 const first_unobserved_frame = std::max(this->gpu_completion_observed_frame + 1, gpu_value - std::min<u64>(gpu_value, DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT - 1));
+    for (u64 frame_index = first_unobserved_frame; frame_index <= gpu_value; ++frame_index)
+    {
+        auto * statistics = this->frame_statistics_of(frame_index);
+        if (statistics != nullptr && statistics->present_call_time_ns != 0)
+        {
+            statistics->gpu_completion_time_ns = now_ns - std::min(now_ns, statistics->present_call_time_ns);
+        }
+    }
+    this->gpu_completion_observed_frame = std::max(this->gpu_completion_observed_frame, gpu_value);
+
+    if ((this->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_DISPLAY_TIMING) == 0)
+    {
+        return;
+    }
+    u32 timing_count = 0;
+    if (this->device->vkGetPastPresentationTimingGOOGLE(this->device->vk_device, this->vk_swapchain, &timing_count, nullptr) != VK_SUCCESS || timing_count == 0)
+    {
+        return;
+    }
+    this->past_presentation_timings.resize(timing_count);
+    auto vk_result = this->device->vkGetPastPresentationTimingGOOGLE(this->device->vk_device, this->vk_swapchain, &timing_count, this->past_presentation_timings.data());
+    if (vk_result != VK_SUCCESS && vk_result != VK_INCOMPLETE)
+    {
+        return;
+    }
+    for (u32 i = 0; i < timing_count; ++i)
+    {
+        auto const & timing = this->past_presentation_timings[i];
+        // Display timing present ids are 32 bit, all frames of the ring are within 2^32 of the current frame.
+        u64 const frame_index = (this->cpu_frame_timeline & ~u64{0xFFFFFFFF}) | timing.presentID;
+        auto * statistics = this->frame_statistics_of(frame_index > this->cpu_frame_timeline ? frame_index - (u64{1} << 32) : frame_index);
+        if (statistics != nullptr)
+        {
+            statistics->actual_present_time_ns = timing.actualPresentTime;
+            statistics->earliest_present_time_ns = timing.earliestPresentTime;
+        }
+    }
+}
+
 void daxa_ImplSwapchain::partial_cleanup()
 {
     for (auto & image : this->images)
@@ -396,10 +617,19 @@ void daxa_ImplSwapchain::partial_cleanup()
 void daxa_ImplSwapchain::full_cleanup()
 {
     this->partial_cleanup();
-    if (this->vk_swapchain != VK_NULL_HANDLE)
+    if (this->device != nullptr)
     {
         // Due to wsi limitations we need to wait idle before destroying the swapchain.
+        // Swapchains retired by recreation must be destroyed before the surface too.
         vkDeviceWaitIdle(this->device->vk_device);
+        for (auto const & [timeline_value, retired_vk_swapchain] : this->retired_vk_swapchains)
+        {
+            vkDestroySwapchainKHR(this->device->vk_device, retired_vk_swapchain, nullptr);
+        }
+        this->retired_vk_swapchains.clear();
+    }
+    if (this->vk_swapchain != VK_NULL_HANDLE)
+    {
         vkDestroySwapchainKHR(this->device->vk_device, this->vk_swapchain, nullptr);
     }
     if (this->vk_surface != VK_NULL_HANDLE)
@@ -34,7 +34,12 @@
 ///
 /// WARNING: The swapchain only works on the main queue! It is directly tied to it.
 ///
-/// TODO: investigate if wsi is improved enough to use zombies for swapchain.
+/// Recreation does not idle the device. It only waits for the queues of the present queue family,
+/// which guarantees that all presents of the old swapchain are done.
+/// Work of other queues may still use the old images, so the old images are zombified
+/// and destroyed by the garbage collection once all submits up to the recreation are finished.
+/// The old vk swapchains are retired on the swapchain itself, as they must be destroyed before its surface.
+/// Later recreations destroy the retired ones whose submits finished, full_cleanup destroys the rest after idling the device.
 struct daxa_ImplSwapchain final : ImplHandle
 {
     daxa_Device device = {};
@@ -59,11 +64,33 @@ struct daxa_ImplSwapchain final : ImplHandle
     // This is the swapchain image index that acquire returns. THis is not necessarily linear.
     // This index must be used for present semaphores as they are paired to the images.
     u32 current_image_index = {};
+    // Present ids are the cpu frame timeline values of the presented frames.
+    // Only ids presented to the current vk swapchain can be waited on, so the range is reset on recreation.
+    u64 first_present_id = {};
+    u64 last_present_id = {};
+    // Signaled by vkLatencySleepNV when the cpu should start the next frame.
+    TimelineSemaphore latency_sleep_semaphore = {};
+    u64 latency_sleep_value = {};
+    // Ring indexed by frame_index % DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT.
+    std::array<SwapchainFrameStatistics, DAXA_SWAPCHAIN_FRAME_STATISTICS_COUNT> frame_statistics = {};
+    // Frames up to this value have their gpu completion time set.
+    u64 gpu_completion_observed_frame = {};
+    u64 acquire_end_time_ns = {};
+    u64 refresh_duration_ns = {};
+    std::vector<VkPastPresentationTimingGOOGLE> past_presentation_timings = {};
+    // Vk swapchains replaced by recreation, paired with the global submit timeline value at their retirement.
+    std::deque<std::pair<u64, VkSwapchainKHR>> retired_vk_swapchains = {};
 
     void partial_cleanup();
     void full_cleanup();
     auto recreate_surface() -> daxa_Result;
     auto recreate() -> daxa_Result;
+    auto wait_present_queues_idle() -> daxa_Result;
+    auto destroy_finished_retired_vk_swapchains() -> daxa_Result;
+
+    void set_latency_marker(u64 present_id, VkLatencyMarkerNV marker);
+    auto frame_statistics_of(u64 frame_index) -> SwapchainFrameStatistics *;
+    void update_frame_statistics(u64 now_ns);
 
     static auto create(daxa_Device device, daxa_SwapchainInfo const * info, daxa_Swapchain swapchain) -> daxa_Result;
     static void zero_ref_callback(ImplHandle const * handle);
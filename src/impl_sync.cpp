@@ -61,12 +61,32 @@ auto daxa_binary_semaphore_dec_refcnt(daxa_BinarySemaphore self) -> u64
 
 auto daxa_dvc_create_timeline_semaphore(daxa_Device device, daxa_TimelineSemaphoreInfo const * info, daxa_TimelineSemaphore * out_semaphore) -> daxa_Result
 {
+    auto const handle_type = info->external_semaphore.handle_type;
+    if (handle_type != DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_NONE)
+    {
+#if defined(_WIN32)
+        bool const platform_handle = handle_type == DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32;
+#else
+        bool const platform_handle = handle_type == DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD;
+#endif
+        if ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_EXTERNAL_MEMORY) == 0 || !platform_handle)
+        {
+            return DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED;
+        }
+    }
     auto ret = daxa_ImplTimelineSemaphore{};
     ret.device = device;
     ret.info = *reinterpret_cast<TimelineSemaphoreInfo const *>(info);
+    // Imported semaphores take over the payload of the handle, they are created like any other semaphore first.
+    VkExportSemaphoreCreateInfo const vk_export_semaphore_create_info{
+        .sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO,
+        .pNext = nullptr,
+        .handleTypes = static_cast<VkExternalSemaphoreHandleTypeFlags>(handle_type),
+    };
+    bool const exportable = handle_type != DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_NONE && !info->external_semaphore.import_handle.has_value;
     VkSemaphoreTypeCreateInfo timeline_vk_semaphore{
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
-        .pNext = nullptr,
+        .pNext = exportable ? &vk_export_semaphore_create_info : nullptr,
         .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
         .initialValue = info->initial_value,
     };
@@ -80,6 +100,36 @@ auto daxa_dvc_create_timeline_semaphore(daxa_Device device, daxa_TimelineSemapho
     {
         return std::bit_cast<daxa_Result>(vk_result);
     }
+    if (handle_type != DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_NONE && info->external_semaphore.import_handle.has_value)
+    {
+#if defined(_WIN32)
+        VkImportSemaphoreWin32HandleInfoKHR const vk_import_info{
+            .sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_WIN32_HANDLE_INFO_KHR,
+            .pNext = nullptr,
+            .semaphore = ret.vk_semaphore,
+            .flags = {},
+            .handleType = static_cast<VkExternalSemaphoreHandleTypeFlagBits>(handle_type),
+            .handle = reinterpret_cast<HANDLE>(info->external_semaphore.import_handle.value),
+            .name = nullptr,
+        };
+        vk_result = device->vkImportSemaphoreWin32HandleKHR(device->vk_device, &vk_import_info);
+#else
+        VkImportSemaphoreFdInfoKHR const vk_import_info{
+            .sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR,
+            .pNext = nullptr,
+            .semaphore = ret.vk_semaphore,
+            .flags = {},
+            .handleType = static_cast<VkExternalSemaphoreHandleTypeFlagBits>(handle_type),
+            .fd = static_cast<int>(info->external_semaphore.import_handle.value),
+        };
+        vk_result = device->vkImportSemaphoreFdKHR(device->vk_device, &vk_import_info);
+#endif
+        if (vk_result != VK_SUCCESS)
+        {
+            vkDestroySemaphore(device->vk_device, ret.vk_semaphore, nullptr);
+            return std::bit_cast<daxa_Result>(vk_result);
+        }
+    }
     if ((device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && (!ret.info.name.span().empty()))
     {
         auto c_str = ret.info.name.c_str();
@@ -140,6 +190,40 @@ auto daxa_timeline_semaphore_get_vk_semaphore(daxa_TimelineSemaphore self) -> Vk
     return self->vk_semaphore;
 }
 
+auto daxa_timeline_semaphore_export_handle(daxa_TimelineSemaphore self, uint64_t * out_handle) -> daxa_Result
+{
+    // Imported semaphores were not created exportable.
+    daxa_ExternalSemaphoreInfo const & external_semaphore = *reinterpret_cast<daxa_ExternalSemaphoreInfo const *>(&self->info.external_semaphore);
+    if (external_semaphore.handle_type == DAXA_EXTERNAL_SEMAPHORE_HANDLE_TYPE_NONE || external_semaphore.import_handle.has_value)
+    {
+        return DAXA_RESULT_ERROR_EXTERNAL_HANDLE_NOT_SUPPORTED;
+    }
+#if defined(_WIN32)
+    VkSemaphoreGetWin32HandleInfoKHR const vk_get_handle_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_WIN32_HANDLE_INFO_KHR,
+        .pNext = nullptr,
+        .semaphore = self->vk_semaphore,
+        .handleType = static_cast<VkExternalSemaphoreHandleTypeFlagBits>(external_semaphore.handle_type),
+    };
+    HANDLE handle = {};
+    auto const result = static_cast<daxa_Result>(self->device->vkGetSemaphoreWin32HandleKHR(self->device->vk_device, &vk_get_handle_info, &handle));
+    _DAXA_RETURN_IF_ERROR(result, result)
+    *out_handle = reinterpret_cast<uint64_t>(handle);
+#else
+    VkSemaphoreGetFdInfoKHR const vk_get_fd_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
+        .pNext = nullptr,
+        .semaphore = self->vk_semaphore,
+        .handleType = static_cast<VkExternalSemaphoreHandleTypeFlagBits>(external_semaphore.handle_type),
+    };
+    int fd = -1;
+    auto const result = static_cast<daxa_Result>(self->device->vkGetSemaphoreFdKHR(self->device->vk_device, &vk_get_fd_info, &fd));
+    _DAXA_RETURN_IF_ERROR(result, result)
+    *out_handle = static_cast<uint64_t>(fd);
+#endif
+    return DAXA_RESULT_SUCCESS;
+}
+
 auto daxa_timeline_semaphore_inc_refcnt(daxa_TimelineSemaphore self) -> u64
 {
     return self->inc_refcnt();
@@ -1,5 +1,6 @@
 #include "impl_timeline_query.hpp"
 
+#include <bit>
 #include <utility>
 
 #include "impl_device.hpp"
@@ -80,6 +81,111 @@ auto daxa_timeline_query_pool_dec_refcnt(daxa_TimelineQueryPool self) -> u64
         self->device->instance);
 }
 
+auto daxa_dvc_create_query_pool(daxa_Device device, daxa_QueryPoolInfo const * info, daxa_QueryPool * out_qp) -> daxa_Result
+{
+    if (info->query_type != VK_QUERY_TYPE_OCCLUSION && info->query_type != VK_QUERY_TYPE_PIPELINE_STATISTICS && info->query_type != VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR && info->query_type != VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR)
+    {
+        return DAXA_RESULT_ERROR_INVALID_QUERY_TYPE;
+    }
+    if (info->query_type == VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR &&
+        ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0 || device->properties.video_encode_queue_count == 0))
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+    if (info->query_type == VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING) == 0)
+    {
+        return DAXA_RESULT_INVALID_WITHOUT_ENABLING_RAY_TRACING;
+    }
+    if (info->query_type == VK_QUERY_TYPE_PIPELINE_STATISTICS && (device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_PIPELINE_STATISTICS_QUERY) == 0)
+    {
+        return DAXA_RESULT_ERROR_PIPELINE_STATISTICS_QUERY_NOT_SUPPORTED;
+    }
+    auto ret = daxa_ImplQueryPool{};
+    ret.device = device;
+    ret.info = *info;
+    ret.result_value_count = info->query_type == VK_QUERY_TYPE_PIPELINE_STATISTICS ? static_cast<u32>(std::popcount(info->pipeline_statistics)) : 1u;
+    // Encode feedback queries report the bitstream offset and the bytes written of the encode, in that order.
+    ImplVideoProfile video_profile = {};
+    VkQueryPoolVideoEncodeFeedbackCreateInfoKHR vk_encode_feedback_create_info = {};
+    if (info->query_type == VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR)
+    {
+        ret.result_value_count = 2u;
+        video_profile.initialize(info->video_profile);
+        vk_encode_feedback_create_info = VkQueryPoolVideoEncodeFeedbackCreateInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_VIDEO_ENCODE_FEEDBACK_CREATE_INFO_KHR,
+            .pNext = &video_profile.vk_profile,
+            .encodeFeedbackFlags = VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BUFFER_OFFSET_BIT_KHR | VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BYTES_WRITTEN_BIT_KHR,
+        };
+    }
+    VkQueryPoolCreateInfo const vk_query_pool_create_info{
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext = info->query_type == VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR ? &vk_encode_feedback_create_info : nullptr,
+        .flags = 0,
+        .queryType = info->query_type,
+        .queryCount = info->query_count,
+        .pipelineStatistics = info->query_type == VK_QUERY_TYPE_PIPELINE_STATISTICS ? info->pipeline_statistics : VkQueryPipelineStatisticFlags{},
+    };
+    auto vk_result = vkCreateQueryPool(device->vk_device, &vk_query_pool_create_info, nullptr, &ret.vk_query_pool);
+    if (vk_result != VK_SUCCESS)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+    vkResetQueryPool(device->vk_device, ret.vk_query_pool, 0, info->query_count);
+    if ((device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && info->name.size != 0)
+    {
+        std::string const c_name = std::string{info->name.view()};
+        VkDebugUtilsObjectNameInfoEXT const query_pool_name_info{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            .pNext = nullptr,
+            .objectType = VK_OBJECT_TYPE_QUERY_POOL,
+            .objectHandle = std::bit_cast<uint64_t>(ret.vk_query_pool),
+            .pObjectName = c_name.c_str(),
+        };
+        device->vkSetDebugUtilsObjectNameEXT(device->vk_device, &query_pool_name_info);
+    }
+    ret.strong_count = 1;
+    device->inc_weak_refcnt();
+    *out_qp = new daxa_ImplQueryPool{};
+    **out_qp = std::move(ret);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_query_pool_info(daxa_QueryPool self) -> daxa_QueryPoolInfo const *
+{
+    return &self->info;
+}
+
+auto daxa_query_pool_query_results(daxa_QueryPool self, u32 start, u32 count, u64 * out_results) -> daxa_Result
+{
+    if (!(start + count - 1 < self->info.query_count))
+    {
+        return DAXA_RESULT_RANGE_OUT_OF_BOUNDS;
+    }
+    u64 const stride = (self->result_value_count + 1ul) * sizeof(u64);
+    auto vk_result = vkGetQueryPoolResults(
+        self->device->vk_device,
+        self->vk_query_pool,
+        start,
+        count,
+        count * stride,
+        out_results,
+        stride,
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    return std::bit_cast<daxa_Result>(vk_result);
+}
+
+auto daxa_query_pool_inc_refcnt(daxa_QueryPool self) -> u64
+{
+    return self->inc_refcnt();
+}
+
+auto daxa_query_pool_dec_refcnt(daxa_QueryPool self) -> u64
+{
+    return self->dec_refcnt(
+        &daxa_ImplQueryPool::zero_ref_callback,
+        self->device->instance);
+}
+
 // --- End API Functions ---
 
 // --- Begin Internals ---
@@ -100,4 +206,20 @@ void daxa_ImplTimelineQueryPool::zero_ref_callback(ImplHandle const * handle)
     delete self;
 }
 
+void daxa_ImplQueryPool::zero_ref_callback(ImplHandle const * handle)
+{
+    auto * self = rc_cast<daxa_QueryPool>(handle);
+    std::unique_lock const lock{self->device->zombies_mtx};
+    u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    self->device->query_pool_zombies.emplace_back(
+        submit_timeline,
+        QueryPoolZombie{
+            .vk_query_pool = self->vk_query_pool,
+        });
+    self->device->dec_weak_refcnt(
+        daxa_ImplDevice::zero_ref_callback,
+        self->device->instance);
+    delete self;
+}
+
 // --- End Internals ---
\ No newline at end of file
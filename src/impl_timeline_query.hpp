@@ -12,6 +12,11 @@ namespace daxa
     {
         VkQueryPool vk_timeline_query_pool = {};
     };
+
+    struct QueryPoolZombie
+    {
+        VkQueryPool vk_query_pool = {};
+    };
 } // namespace daxa
 
 struct daxa_ImplTimelineQueryPool final : ImplHandle
@@ -23,3 +28,14 @@ struct daxa_ImplTimelineQueryPool final : ImplHandle
 
     static void zero_ref_callback(ImplHandle const * handle);
 };
+
+struct daxa_ImplQueryPool final : ImplHandle
+{
+    daxa_Device device = {};
+    daxa_QueryPoolInfo info = {};
+    VkQueryPool vk_query_pool = {};
+    // Values written per query by vkGetQueryPoolResults, not counting the availability.
+    u32 result_value_count = {};
+
+    static void zero_ref_callback(ImplHandle const * handle);
+};
@@ -0,0 +1,311 @@
+#include "impl_video.hpp"
+
+#include <cstring>
+#include <string>
+
+#include "impl_device.hpp"
+
+static_assert(sizeof(VkOffset2D) == sizeof(daxa::Offset2D));
+
+namespace
+{
+    auto video_std_header_version(daxa_VideoCodecOperation codec_operation) -> VkExtensionProperties
+    {
+        VkExtensionProperties ret = {};
+        auto const set = [&](char const * name, u32 spec_version)
+        {
+            std::strncpy(ret.extensionName, name, VK_MAX_EXTENSION_NAME_SIZE - 1);
+            ret.specVersion = spec_version;
+        };
+        switch (codec_operation)
+        {
+        case DAXA_VIDEO_CODEC_OPERATION_DECODE_H264: set(VK_STD_VULKAN_VIDEO_CODEC_H264_DECODE_EXTENSION_NAME, VK_STD_VULKAN_VIDEO_CODEC_H264_DECODE_SPEC_VERSION); break;
+        case DAXA_VIDEO_CODEC_OPERATION_DECODE_H265: set(VK_STD_VULKAN_VIDEO_CODEC_H265_DECODE_EXTENSION_NAME, VK_STD_VULKAN_VIDEO_CODEC_H265_DECODE_SPEC_VERSION); break;
+        case DAXA_VIDEO_CODEC_OPERATION_ENCODE_H264: set(VK_STD_VULKAN_VIDEO_CODEC_H264_ENCODE_EXTENSION_NAME, VK_STD_VULKAN_VIDEO_CODEC_H264_ENCODE_SPEC_VERSION); break;
+        case DAXA_VIDEO_CODEC_OPERATION_ENCODE_H265: set(VK_STD_VULKAN_VIDEO_CODEC_H265_ENCODE_EXTENSION_NAME, VK_STD_VULKAN_VIDEO_CODEC_H265_ENCODE_SPEC_VERSION); break;
+        default: break;
+        }
+        return ret;
+    }
+
+    void destroy_video_session_objects(daxa_Device device, daxa_ImplVideoSession & session)
+    {
+        if (session.vk_video_session_parameters != VK_NULL_HANDLE)
+        {
+            device->vkDestroyVideoSessionParametersKHR(device->vk_device, session.vk_video_session_parameters, nullptr);
+        }
+        if (session.vk_video_session != VK_NULL_HANDLE)
+        {
+            device->vkDestroyVideoSessionKHR(device->vk_device, session.vk_video_session, nullptr);
+        }
+        for (auto allocation : session.allocations)
+        {
+            vmaFreeMemory(device->vma_allocator, allocation);
+        }
+    }
+} // namespace
+
+// --- Begin API Functions ---
+
+auto daxa_dvc_create_video_session(daxa_Device device, daxa_VideoSessionInfo const * info, daxa_VideoSession * out_video_session) -> daxa_Result
+{
+    if ((device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_VIDEO) == 0)
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+    daxa_QueueFamily const queue_family = daxa_video_codec_operation_queue_family(info->profile.codec_operation);
+    if (queue_family == DAXA_QUEUE_FAMILY_MAX_ENUM || device->queue_families[queue_family].queue_count == 0)
+    {
+        return DAXA_RESULT_ERROR_VIDEO_NOT_SUPPORTED;
+    }
+
+    auto ret = daxa_ImplVideoSession{};
+    ret.device = device;
+    ret.info = *info;
+    // Only read during creation.
+    ret.info.codec_parameters = nullptr;
+
+    ImplVideoProfile profile = {};
+    profile.initialize(info->profile);
+    VkExtensionProperties const std_header_version = video_std_header_version(info->profile.codec_operation);
+    VkVideoSessionCreateInfoKHR const vk_create_info{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_CREATE_INFO_KHR,
+        .pNext = nullptr,
+        .queueFamilyIndex = device->queue_families[queue_family].vk_index,
+        .flags = {},
+        .pVideoProfile = &profile.vk_profile,
+        .pictureFormat = info->picture_format,
+        .maxCodedExtent = info->max_coded_extent,
+        .referencePictureFormat = info->reference_picture_format,
+        .maxDpbSlots = info->max_dpb_slots,
+        .maxActiveReferencePictures = info->max_active_reference_pictures,
+        .pStdHeaderVersion = &std_header_version,
+    };
+    auto vk_result = device->vkCreateVideoSessionKHR(device->vk_device, &vk_create_info, nullptr, &ret.vk_video_session);
+    if (vk_result != VK_SUCCESS)
+    {
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+
+    // The session state lives in memory the application binds, one allocation per bind index.
+    u32 requirement_count = 0;
+    device->vkGetVideoSessionMemoryRequirementsKHR(device->vk_device, ret.vk_video_session, &requirement_count, nullptr);
+    std::vector<VkVideoSessionMemoryRequirementsKHR> requirements(requirement_count, VkVideoSessionMemoryRequirementsKHR{.sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_MEMORY_REQUIREMENTS_KHR});
+    device->vkGetVideoSessionMemoryRequirementsKHR(device->vk_device, ret.vk_video_session, &requirement_count, requirements.data());
+    std::vector<VkBindVideoSessionMemoryInfoKHR> binds = {};
+    binds.reserve(requirement_count);
+    for (auto const & requirement : requirements)
+    {
+        VmaAllocationCreateInfo const vma_allocation_create_info{
+            .flags = {},
+            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+            .requiredFlags = {},
+            .preferredFlags = {},
+            .memoryTypeBits = {},
+            .pool = {},
+            .pUserData = {},
+            .priority = 0.5f,
+        };
+        VmaAllocation allocation = {};
+        VmaAllocationInfo allocation_info = {};
+        vk_result = vmaAllocateMemory(device->vma_allocator, &requirement.memoryRequirements, &vma_allocation_create_info, &allocation, &allocation_info);
+        if (vk_result != VK_SUCCESS)
+        {
+            destroy_video_session_objects(device, ret);
+            return std::bit_cast<daxa_Result>(vk_result);
+        }
+        ret.allocations.push_back(allocation);
+        binds.push_back(VkBindVideoSessionMemoryInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_BIND_VIDEO_SESSION_MEMORY_INFO_KHR,
+            .pNext = nullptr,
+            .memoryBindIndex = requirement.memoryBindIndex,
+            .memory = allocation_info.deviceMemory,
+            .memoryOffset = allocation_info.offset,
+            .memorySize = requirement.memoryRequirements.size,
+        });
+    }
+    vk_result = device->vkBindVideoSessionMemoryKHR(device->vk_device, ret.vk_video_session, static_cast<u32>(binds.size()), binds.data());
+    if (vk_result != VK_SUCCESS)
+    {
+        destroy_video_session_objects(device, ret);
+        return std::bit_cast<daxa_Result>(vk_result);
+    }
+
+    if (info->codec_parameters != nullptr)
+    {
+        VkVideoSessionParametersCreateInfoKHR const vk_parameters_create_info{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_PARAMETERS_CREATE_INFO_KHR,
+            .pNext = info->codec_parameters,
+            .flags = {},
+            .videoSessionParametersTemplate = VK_NULL_HANDLE,
+            .videoSession = ret.vk_video_session,
+        };
+        vk_result = device->vkCreateVideoSessionParametersKHR(device->vk_device, &vk_parameters_create_info, nullptr, &ret.vk_video_session_parameters);
+        if (vk_result != VK_SUCCESS)
+        {
+            destroy_video_session_objects(device, ret);
+            return std::bit_cast<daxa_Result>(vk_result);
+        }
+    }
+
+    if ((device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && info->name.size != 0)
+    {
+        std::string const c_name = std::string{info->name.view()};
+        VkDebugUtilsObjectNameInfoEXT const name_info{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+            .pNext = nullptr,
+            .objectType = VK_OBJECT_TYPE_VIDEO_SESSION_KHR,
+            .objectHandle = std::bit_cast<u64>(ret.vk_video_session),
+            .pObjectName = c_name.c_str(),
+        };
+        device->vkSetDebugUtilsObjectNameEXT(device->vk_device, &name_info);
+    }
+
+    ret.strong_count = 1;
+    device->inc_weak_refcnt();
+    *out_video_session = new daxa_ImplVideoSession{};
+    **out_video_session = std::move(ret);
+    return DAXA_RESULT_SUCCESS;
+}
+
+auto daxa_video_session_info(daxa_VideoSession self) -> daxa_VideoSessionInfo const *
+{
+    return &self->info;
+}
+
+auto daxa_video_session_inc_refcnt(daxa_VideoSession self) -> u64
+{
+    return self->inc_refcnt();
+}
+
+auto daxa_video_session_dec_refcnt(daxa_VideoSession self) -> u64
+{
+    return self->dec_refcnt(
+        &daxa_ImplVideoSession::zero_ref_callback,
+        self->device->instance);
+}
+
+// --- End API Functions ---
+
+// --- Begin Internals ---
+
+void ImplVideoProfile::initialize(daxa_VideoProfileInfo const & info)
+{
+    void const * codec_profile = nullptr;
+    switch (info.codec_operation)
+    {
+    case DAXA_VIDEO_CODEC_OPERATION_DECODE_H264:
+        decode_h264 = VkVideoDecodeH264ProfileInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_DECODE_H264_PROFILE_INFO_KHR,
+            .pNext = nullptr,
+            .stdProfileIdc = static_cast<StdVideoH264ProfileIdc>(info.std_profile_idc),
+            .pictureLayout = VK_VIDEO_DECODE_H264_PICTURE_LAYOUT_PROGRESSIVE_KHR,
+        };
+        codec_profile = &decode_h264;
+        break;
+    case DAXA_VIDEO_CODEC_OPERATION_DECODE_H265:
+        decode_h265 = VkVideoDecodeH265ProfileInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_DECODE_H265_PROFILE_INFO_KHR,
+            .pNext = nullptr,
+            .stdProfileIdc = static_cast<StdVideoH265ProfileIdc>(info.std_profile_idc),
+        };
+        codec_profile = &decode_h265;
+        break;
+    case DAXA_VIDEO_CODEC_OPERATION_ENCODE_H264:
+        encode_h264 = VkVideoEncodeH264ProfileInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_PROFILE_INFO_KHR,
+            .pNext = nullptr,
+            .stdProfileIdc = static_cast<StdVideoH264ProfileIdc>(info.std_profile_idc),
+        };
+        codec_profile = &encode_h264;
+        break;
+    case DAXA_VIDEO_CODEC_OPERATION_ENCODE_H265:
+        encode_h265 = VkVideoEncodeH265ProfileInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H265_PROFILE_INFO_KHR,
+            .pNext = nullptr,
+            .stdProfileIdc = static_cast<StdVideoH265ProfileIdc>(info.std_profile_idc),
+        };
+        codec_profile = &encode_h265;
+        break;
+    default: break;
+    }
+    vk_profile = VkVideoProfileInfoKHR{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_PROFILE_INFO_KHR,
+        .pNext = codec_profile,
+        .videoCodecOperation = static_cast<VkVideoCodecOperationFlagBitsKHR>(info.codec_operation),
+        .chromaSubsampling = info.chroma_subsampling,
+        .lumaBitDepth = info.luma_bit_depth,
+        .chromaBitDepth = info.chroma_bit_depth,
+    };
+    vk_profile_list = VkVideoProfileListInfoKHR{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_PROFILE_LIST_INFO_KHR,
+        .pNext = nullptr,
+        .profileCount = 1,
+        .pProfiles = &vk_profile,
+    };
+}
+
+auto daxa_video_codec_operation_queue_family(daxa_VideoCodecOperation codec_operation) -> daxa_QueueFamily
+{
+    switch (codec_operation)
+    {
+    case DAXA_VIDEO_CODEC_OPERATION_DECODE_H264: [[fallthrough]];
+    case DAXA_VIDEO_CODEC_OPERATION_DECODE_H265: return DAXA_QUEUE_FAMILY_VIDEO_DECODE;
+    case DAXA_VIDEO_CODEC_OPERATION_ENCODE_H264: [[fallthrough]];
+    case DAXA_VIDEO_CODEC_OPERATION_ENCODE_H265: return DAXA_QUEUE_FAMILY_VIDEO_ENCODE;
+    default: return DAXA_QUEUE_FAMILY_MAX_ENUM;
+    }
+}
+
+auto daxa_video_picture_resource_to_vk(daxa_Device device, daxa_VideoPictureResource const & picture) -> VkVideoPictureResourceInfoKHR
+{
+    return VkVideoPictureResourceInfoKHR{
+        .sType = VK_STRUCTURE_TYPE_VIDEO_PICTURE_RESOURCE_INFO_KHR,
+        .pNext = nullptr,
+        .codedOffset = picture.coded_offset,
+        .codedExtent = picture.coded_extent,
+        .baseArrayLayer = picture.base_array_layer,
+        .imageViewBinding = device->slot(picture.view).vk_image_view,
+    };
+}
+
+void daxa_video_reference_slots_to_vk(
+    daxa_Device device,
+    std::span<daxa_VideoReferenceSlot const> slots,
+    std::vector<VkVideoPictureResourceInfoKHR> & out_pictures,
+    std::vector<VkVideoReferenceSlotInfoKHR> & out_slots)
+{
+    // Reserved up front, the slot infos point into the pictures.
+    out_pictures.reserve(slots.size());
+    out_slots.reserve(slots.size());
+    for (auto const & slot : slots)
+    {
+        out_pictures.push_back(daxa_video_picture_resource_to_vk(device, slot.picture));
+        out_slots.push_back(VkVideoReferenceSlotInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_VIDEO_REFERENCE_SLOT_INFO_KHR,
+            .pNext = slot.codec_info,
+            .slotIndex = slot.slot_index,
+            .pPictureResource = &out_pictures.back(),
+        });
+    }
+}
+
+void daxa_ImplVideoSession::zero_ref_callback(ImplHandle const * handle)
+{
+    auto * self = rc_cast<daxa_VideoSession>(handle);
+    std::unique_lock const lock{self->device->zombies_mtx};
+    u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    self->device->video_session_zombies.emplace_back(
+        submit_timeline,
+        VideoSessionZombie{
+            .vk_video_session = self->vk_video_session,
+            .vk_video_session_parameters = self->vk_video_session_parameters,
+            .allocations = std::move(self->allocations),
+        });
+    self->device->dec_weak_refcnt(
+        daxa_ImplDevice::zero_ref_callback,
+        self->device->instance);
+    delete self;
+}
+
+// --- End Internals ---
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <daxa/c/gpu_resources.h>
+#include <daxa/c/command_recorder.h>
+
+#include "impl_core.hpp"
+
+#include <vector>
+
+namespace daxa
+{
+    struct VideoSessionZombie
+    {
+        VkVideoSessionKHR vk_video_session = {};
+        VkVideoSessionParametersKHR vk_video_session_parameters = {};
+        std::vector<VmaAllocation> allocations = {};
+    };
+} // namespace daxa
+
+struct daxa_ImplVideoSession final : ImplHandle
+{
+    daxa_Device device = {};
+    daxa_VideoSessionInfo info = {};
+    VkVideoSessionKHR vk_video_session = {};
+    VkVideoSessionParametersKHR vk_video_session_parameters = {};
+    // One allocation per memory bind index of the session.
+    std::vector<VmaAllocation> allocations = {};
+
+    static void zero_ref_callback(ImplHandle const * handle);
+};
+
+// Vulkan profile structs of a daxa profile, chained into session, image and query pool create infos.
+// The structs point at each other, so the profile must not be copied or moved after initialize.
+struct ImplVideoProfile
+{
+    VkVideoDecodeH264ProfileInfoKHR decode_h264 = {};
+    VkVideoDecodeH265ProfileInfoKHR decode_h265 = {};
+    VkVideoEncodeH264ProfileInfoKHR encode_h264 = {};
+    VkVideoEncodeH265ProfileInfoKHR encode_h265 = {};
+    VkVideoProfileInfoKHR vk_profile = {};
+    VkVideoProfileListInfoKHR vk_profile_list = {};
+
+    void initialize(daxa_VideoProfileInfo const & info);
+};
+
+// Returns DAXA_QUEUE_FAMILY_MAX_ENUM for DAXA_VIDEO_CODEC_OPERATION_NONE.
+auto daxa_video_codec_operation_queue_family(daxa_VideoCodecOperation codec_operation) -> daxa_QueueFamily;
+
+auto daxa_video_picture_resource_to_vk(daxa_Device device, daxa_VideoPictureResource const & picture) -> VkVideoPictureResourceInfoKHR;
+
+// The slot infos point into the picture resources, both vectors must outlive their use.
+void daxa_video_reference_slots_to_vk(
+    daxa_Device device,
+    std::span<daxa_VideoReferenceSlot const> slots,
+    std::vector<VkVideoPictureResourceInfoKHR> & out_pictures,
+    std::vector<VkVideoReferenceSlotInfoKHR> & out_slots);
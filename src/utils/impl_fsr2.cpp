@@ -25,10 +25,16 @@ namespace daxa
     }
 
     auto Fsr2Context::get_jitter(u64 index) const -> daxa_f32vec2
+    {
+        auto const & impl = *r_cast<ImplFsr2Context *>(this->object);
+        return get_jitter(index, impl.info.size_info.render_size_x);
+    }
+
+    auto Fsr2Context::get_jitter(u64 index, u32 render_size_x) const -> daxa_f32vec2
     {
         auto const & impl = *r_cast<ImplFsr2Context *>(this->object);
         daxa_f32vec2 result{};
-        i32 const jitter_phase_count = ffxFsr2GetJitterPhaseCount(static_cast<i32>(impl.info.size_info.render_size_x), static_cast<i32>(impl.info.size_info.display_size_x));
+        i32 const jitter_phase_count = ffxFsr2GetJitterPhaseCount(static_cast<i32>(render_size_x), static_cast<i32>(impl.info.size_info.display_size_x));
         ffxFsr2GetJitterOffset(&result.x, &result.y, static_cast<i32>(index), jitter_phase_count);
         return result;
     }
@@ -66,6 +72,8 @@ namespace daxa
         fsr2_context_description.device = ffxGetDeviceVK(logical_device);
         fsr2_context_description.flags = {};
         fsr2_context_description.flags |= FFX_FSR2_ENABLE_AUTO_EXPOSURE;
+        // UpscaleInfo::render_size may change every frame below the max render size.
+        fsr2_context_description.flags |= FFX_FSR2_ENABLE_DYNAMIC_RESOLUTION;
         if (this->info.color_hdr) {
             fsr2_context_description.flags |= FFX_FSR2_ENABLE_HIGH_DYNAMIC_RANGE;
         }
@@ -165,17 +173,22 @@ namespace daxa
             output_extent.x, output_extent.y,
             output_format, fsr_output_upscaled_color, FFX_RESOURCE_STATE_UNORDERED_ACCESS);
 
+        // With dynamic resolution only the top left render size area of the inputs is valid.
+        bool const dynamic_render_size = upscale_info.render_size.x != 0 && upscale_info.render_size.y != 0;
+        u32 const render_size_x = dynamic_render_size ? upscale_info.render_size.x : color_extent.x;
+        u32 const render_size_y = dynamic_render_size ? upscale_info.render_size.y : color_extent.y;
+
         dispatch_description.jitterOffset.x = upscale_info.jitter.x;
         dispatch_description.jitterOffset.y = upscale_info.jitter.y;
-        dispatch_description.motionVectorScale.x = static_cast<daxa_f32>(velocity_extent.x);
-        dispatch_description.motionVectorScale.y = static_cast<daxa_f32>(velocity_extent.y);
+        dispatch_description.motionVectorScale.x = static_cast<daxa_f32>(dynamic_render_size ? render_size_x : velocity_extent.x);
+        dispatch_description.motionVectorScale.y = static_cast<daxa_f32>(dynamic_render_size ? render_size_y : velocity_extent.y);
         dispatch_description.reset = upscale_info.should_reset;
         dispatch_description.enableSharpening = upscale_info.should_sharpen;
         dispatch_description.sharpness = upscale_info.sharpening;
         dispatch_description.frameTimeDelta = upscale_info.delta_time * 1000.0f;
         dispatch_description.preExposure = 1.0f;
-        dispatch_description.renderSize.width = color_extent.x;
-        dispatch_description.renderSize.height = color_extent.y;
+        dispatch_description.renderSize.width = render_size_x;
+        dispatch_description.renderSize.height = render_size_y;
         dispatch_description.cameraFar = upscale_info.camera_info.far_plane;
         dispatch_description.cameraNear = upscale_info.camera_info.near_plane;
         dispatch_description.cameraFovAngleVertical = upscale_info.camera_info.vertical_fov;
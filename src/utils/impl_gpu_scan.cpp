@@ -0,0 +1,402 @@
+#if DAXA_BUILT_WITH_UTILS_TASK_GRAPH && DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+
+#include <daxa/utils/gpu_scan.hpp>
+#include <daxa/utils/pipeline_manager.hpp>
+#include <limits>
+
+namespace daxa
+{
+    namespace
+    {
+        // Keys are at most 32 bits wide.
+        constexpr u32 GPU_SORT_MAX_PASS_COUNT = (32 + DAXA_GPU_SORT_RADIX_BITS - 1) / DAXA_GPU_SORT_RADIX_BITS;
+
+        constexpr auto GPU_SCAN_COMPUTE_BARRIER = MemoryBarrierInfo{
+            .src_access = AccessConsts::COMPUTE_SHADER_READ_WRITE,
+            .dst_access = AccessConsts::COMPUTE_SHADER_READ_WRITE,
+        };
+
+        constexpr auto GPU_SCAN_CLEAR_BARRIER = MemoryBarrierInfo{
+            .src_access = AccessConsts::TRANSFER_WRITE,
+            .dst_access = AccessConsts::COMPUTE_SHADER_READ_WRITE,
+        };
+
+        auto align_scratch(usize size) -> usize
+        {
+            return (size + 7) & ~usize{7};
+        }
+
+        auto create_gpu_scan_pipeline_manager(Device const & device, std::string const & name) -> PipelineManager
+        {
+            return PipelineManager({
+                .device = device,
+                .shader_compile_options = {
+                    .root_paths = {DAXA_SHADER_INCLUDE_DIR},
+                    .language = ShaderLanguage::GLSL,
+                    .enable_debug_info = false,
+                },
+                .name = name,
+            });
+        }
+
+        auto compile_gpu_scan_kernel(PipelineManager & pipeline_manager, std::string_view kernel, u32 push_constant_size, std::string name) -> std::shared_ptr<ComputePipeline>
+        {
+            return pipeline_manager.add_compute_pipeline({
+                                       .shader_info = {
+                                           .source = ShaderFile{"daxa/utils/gpu_scan.glsl"},
+                                           .compile_options = {.defines = {{std::string{kernel}, "1"}}},
+                                       },
+                                       .push_constant_size = push_constant_size,
+                                       .name = std::move(name),
+                                   })
+                .value();
+        }
+
+        void record_scan_dispatch(CommandRecorder & recorder, ComputePipeline const & pipeline, daxa_GpuScanPush const & push)
+        {
+            recorder.set_pipeline(pipeline);
+            recorder.push_constant(push);
+            recorder.dispatch({.x = daxa_gpu_scan_tile_count(push.count)});
+        }
+
+        void record_draw_compaction_dispatch(CommandRecorder & recorder, ComputePipeline const & pipeline, daxa_GpuDrawCompactionPush const & push)
+        {
+            recorder.set_pipeline(pipeline);
+            recorder.push_constant(push);
+            recorder.dispatch({.x = (push.instance_count + DAXA_GPU_DRAW_COMPACTION_WORKGROUP_SIZE - 1) / DAXA_GPU_DRAW_COMPACTION_WORKGROUP_SIZE});
+        }
+
+        // All passes share one scratch buffer, each pass scans with its own zeroed scan scratch range.
+        struct GpuSortScratchLayout
+        {
+            u32 tile_count = {};
+            u32 histogram_count = {};
+            usize temp_keys_offset = {};
+            usize temp_values_offset = {};
+            usize histogram_offset = {};
+            usize scan_scratch_offset = {};
+            usize scan_scratch_stride = {};
+            usize size = {};
+        };
+
+        auto gpu_sort_scratch_layout(u32 count, bool has_values) -> GpuSortScratchLayout
+        {
+            GpuSortScratchLayout layout = {};
+            layout.tile_count = daxa_gpu_sort_tile_count(count);
+            layout.histogram_count = DAXA_GPU_SORT_RADIX * layout.tile_count;
+            layout.temp_keys_offset = 0;
+            layout.temp_values_offset = layout.temp_keys_offset + align_scratch(usize{count} * sizeof(u32));
+            layout.histogram_offset = layout.temp_values_offset + (has_values ? align_scratch(usize{count} * sizeof(u32)) : 0);
+            layout.scan_scratch_offset = layout.histogram_offset + align_scratch(usize{layout.histogram_count} * sizeof(u32));
+            layout.scan_scratch_stride = GpuScan::scratch_size(layout.histogram_count);
+            layout.size = layout.scan_scratch_offset + layout.scan_scratch_stride * GPU_SORT_MAX_PASS_COUNT;
+            return layout;
+        }
+
+        struct GpuSortPipelines
+        {
+            ComputePipeline const & histogram;
+            ComputePipeline const & scan;
+            ComputePipeline const & scatter;
+        };
+
+        // Expects the scan scratch ranges to be zeroed.
+        void record_sort_passes(CommandRecorder & recorder, GpuSortPipelines const & pipelines, DeviceAddress keys, DeviceAddress values, DeviceAddress scratch, u32 count, u32 key_bits)
+        {
+            GpuSortScratchLayout const layout = gpu_sort_scratch_layout(count, values != 0);
+            // An even pass count ends in the keys buffer. Passes over bits past key_bits see one digit and keep the order.
+            u32 pass_count = (key_bits + DAXA_GPU_SORT_RADIX_BITS - 1) / DAXA_GPU_SORT_RADIX_BITS;
+            pass_count += pass_count % 2;
+            DeviceAddress const histogram = scratch + layout.histogram_offset;
+            for (u32 pass = 0; pass < pass_count; ++pass)
+            {
+                bool const from_temp = (pass % 2) == 1;
+                DeviceAddress const temp_keys = scratch + layout.temp_keys_offset;
+                DeviceAddress const temp_values = values != 0 ? scratch + layout.temp_values_offset : 0;
+                daxa_GpuSortPush const push = {
+                    .src_keys = from_temp ? temp_keys : keys,
+                    .src_values = from_temp ? temp_values : values,
+                    .dst_keys = from_temp ? keys : temp_keys,
+                    .dst_values = from_temp ? values : temp_values,
+                    .histogram = histogram,
+                    .count = count,
+                    .tile_count = layout.tile_count,
+                    .shift = pass * DAXA_GPU_SORT_RADIX_BITS,
+                    .has_values = values != 0,
+                };
+                recorder.set_pipeline(pipelines.histogram);
+                recorder.push_constant(push);
+                recorder.dispatch({.x = layout.tile_count});
+                recorder.pipeline_barrier(GPU_SCAN_COMPUTE_BARRIER);
+                record_scan_dispatch(recorder, pipelines.scan, {
+                                                                   .src = histogram,
+                                                                   .dst = histogram,
+                                                                   .scratch = scratch + layout.scan_scratch_offset + layout.scan_scratch_stride * pass,
+                                                                   .count = layout.histogram_count,
+                                                                   .inclusive = false,
+                                                               });
+                recorder.pipeline_barrier(GPU_SCAN_COMPUTE_BARRIER);
+                recorder.set_pipeline(pipelines.scatter);
+                recorder.push_constant(push);
+                recorder.dispatch({.x = layout.tile_count});
+                if (pass + 1 < pass_count)
+                {
+                    recorder.pipeline_barrier(GPU_SCAN_COMPUTE_BARRIER);
+                }
+            }
+        }
+    } // namespace
+
+    GpuScan::GpuScan(GpuScanInfo a_info)
+        : m_info{std::move(a_info)}
+    {
+        DAXA_DBG_ASSERT_TRUE_M(
+            (this->m_info.device.properties().implicit_features & ImplicitFeatureFlagBits::SHADER_ATOMIC_INT64) != ImplicitFeatureFlagBits::NONE,
+            "GpuScan and GpuSort require ImplicitFeatureFlagBits::SHADER_ATOMIC_INT64");
+        auto pipeline_manager = create_gpu_scan_pipeline_manager(this->m_info.device, this->m_info.name);
+        this->pipeline = compile_gpu_scan_kernel(pipeline_manager, "DAXA_GPU_SCAN_KERNEL_SCAN", sizeof(daxa_GpuScanPush), this->m_info.name);
+    }
+
+    auto GpuScan::scratch_size(u32 count) -> usize
+    {
+        return daxa_gpu_scan_scratch_size(usize{count});
+    }
+
+    void GpuScan::record(CommandRecorder & recorder, GpuScanRecordInfo const & info) const
+    {
+        if (info.count == 0)
+        {
+            return;
+        }
+        recorder.clear_buffer({.buffer = info.scratch, .size = scratch_size(info.count)});
+        recorder.pipeline_barrier(GPU_SCAN_CLEAR_BARRIER);
+        record_scan_dispatch(recorder, *this->pipeline, {
+                                                            .src = this->m_info.device.buffer_device_address(info.src).value(),
+                                                            .dst = this->m_info.device.buffer_device_address(info.dst).value(),
+                                                            .scratch = this->m_info.device.buffer_device_address(info.scratch).value(),
+                                                            .count = info.count,
+                                                            .inclusive = info.inclusive,
+                                                        });
+    }
+
+    void GpuScan::add_task(TaskGraph & task_graph, GpuScanTaskInfo const & info) const
+    {
+        usize const scratch_bytes = scratch_size(info.count);
+        TaskBufferView const scratch = task_graph.create_transient_buffer({
+            .size = static_cast<u32>(scratch_bytes),
+            .name = info.name + " scratch",
+        });
+        // Transient memory is aliased between executions, so the tile states must be cleared every execution.
+        task_graph.add_task(InlineTaskInfo{
+            .attachments = {inl_attachment(TaskBufferAccess::TRANSFER_WRITE, scratch)},
+            .task = [scratch, scratch_bytes](TaskInterface ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(scratch).ids[0], .size = scratch_bytes});
+            },
+            .name = info.name + " clear",
+        });
+        task_graph.add_task(InlineTaskInfo{
+            .attachments = {
+                inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ, info.src),
+                inl_attachment(TaskBufferAccess::COMPUTE_SHADER_WRITE, info.dst),
+                inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ_WRITE, scratch),
+            },
+            .task = [pipeline = this->pipeline, info, scratch](TaskInterface ti)
+            {
+                if (info.count == 0)
+                {
+                    return;
+                }
+                record_scan_dispatch(ti.recorder, *pipeline, {
+                                                                 .src = ti.device_address(info.src).value(),
+                                                                 .dst = ti.device_address(info.dst).value(),
+                                                                 .scratch = ti.device_address(scratch).value(),
+                                                                 .count = info.count,
+                                                                 .inclusive = info.inclusive,
+                                                             });
+            },
+            .name = info.name,
+        });
+    }
+
+    auto GpuScan::info() const -> GpuScanInfo const &
+    {
+        return this->m_info;
+    }
+
+    GpuSort::GpuSort(GpuSortInfo a_info)
+        : m_info{std::move(a_info)},
+          scan{GpuScanInfo{.device = this->m_info.device, .name = this->m_info.name + " scan"}}
+    {
+        auto pipeline_manager = create_gpu_scan_pipeline_manager(this->m_info.device, this->m_info.name);
+        this->histogram_pipeline = compile_gpu_scan_kernel(pipeline_manager, "DAXA_GPU_SORT_KERNEL_HISTOGRAM", sizeof(daxa_GpuSortPush), this->m_info.name + " histogram");
+        this->scatter_pipeline = compile_gpu_scan_kernel(pipeline_manager, "DAXA_GPU_SORT_KERNEL_SCATTER", sizeof(daxa_GpuSortPush), this->m_info.name + " scatter");
+    }
+
+    auto GpuSort::scratch_size(u32 count, bool has_values) -> usize
+    {
+        return gpu_sort_scratch_layout(count, has_values).size;
+    }
+
+    void GpuSort::record(CommandRecorder & recorder, GpuSortRecordInfo const & info) const
+    {
+        if (info.count == 0)
+        {
+            return;
+        }
+        GpuSortScratchLayout const layout = gpu_sort_scratch_layout(info.count, !info.values.is_empty());
+        recorder.clear_buffer({
+            .buffer = info.scratch,
+            .offset = layout.scan_scratch_offset,
+            .size = layout.size - layout.scan_scratch_offset,
+        });
+        recorder.pipeline_barrier(GPU_SCAN_CLEAR_BARRIER);
+        record_sort_passes(
+            recorder,
+            {.histogram = *this->histogram_pipeline, .scan = *this->scan.pipeline, .scatter = *this->scatter_pipeline},
+            this->m_info.device.buffer_device_address(info.keys).value(),
+            info.values.is_empty() ? DeviceAddress{0} : this->m_info.device.buffer_device_address(info.values).value(),
+            this->m_info.device.buffer_device_address(info.scratch).value(),
+            info.count,
+            info.key_bits);
+    }
+
+    void GpuSort::add_task(TaskGraph & task_graph, GpuSortTaskInfo const & info) const
+    {
+        bool const has_values = !info.values.is_empty();
+        GpuSortScratchLayout const layout = gpu_sort_scratch_layout(info.count, has_values);
+        DAXA_DBG_ASSERT_TRUE_M(layout.size <= std::numeric_limits<u32>::max(), "GpuSort scratch exceeds the transient buffer size limit");
+        TaskBufferView const scratch = task_graph.create_transient_buffer({
+            .size = static_cast<u32>(layout.size),
+            .name = info.name + " scratch",
+        });
+        task_graph.add_task(InlineTaskInfo{
+            .attachments = {inl_attachment(TaskBufferAccess::TRANSFER_WRITE, scratch)},
+            .task = [scratch, layout](TaskInterface ti)
+            {
+                ti.recorder.clear_buffer({
+                    .buffer = ti.get(scratch).ids[0],
+                    .offset = layout.scan_scratch_offset,
+                    .size = layout.size - layout.scan_scratch_offset,
+                });
+            },
+            .name = info.name + " clear",
+        });
+        std::vector<TaskAttachmentInfo> attachments = {
+            inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ_WRITE, info.keys),
+            inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ_WRITE, scratch),
+        };
+        if (has_values)
+        {
+            attachments.push_back(inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ_WRITE, info.values));
+        }
+        task_graph.add_task(InlineTaskInfo{
+            .attachments = std::move(attachments),
+            .task = [histogram_pipeline = this->histogram_pipeline, scan_pipeline = this->scan.pipeline, scatter_pipeline = this->scatter_pipeline, info, scratch, has_values](TaskInterface ti)
+            {
+                if (info.count == 0)
+                {
+                    return;
+                }
+                record_sort_passes(
+                    ti.recorder,
+                    {.histogram = *histogram_pipeline, .scan = *scan_pipeline, .scatter = *scatter_pipeline},
+                    ti.device_address(info.keys).value(),
+                    has_values ? ti.device_address(info.values).value() : DeviceAddress{0},
+                    ti.device_address(scratch).value(),
+                    info.count,
+                    info.key_bits);
+            },
+            .name = info.name,
+        });
+    }
+
+    auto GpuSort::info() const -> GpuSortInfo const &
+    {
+        return this->m_info;
+    }
+
+    GpuDrawCompaction::GpuDrawCompaction(GpuDrawCompactionInfo a_info)
+        : m_info{std::move(a_info)}
+    {
+        auto pipeline_manager = create_gpu_scan_pipeline_manager(this->m_info.device, this->m_info.name);
+        this->pipeline = compile_gpu_scan_kernel(pipeline_manager, "DAXA_GPU_DRAW_COMPACTION_KERNEL", sizeof(daxa_GpuDrawCompactionPush), this->m_info.name);
+    }
+
+    void GpuDrawCompaction::record(CommandRecorder & recorder, GpuDrawCompactionRecordInfo const & info) const
+    {
+        recorder.clear_buffer({.buffer = info.counts, .size = usize{info.material_count} * sizeof(u32)});
+        if (info.instance_count == 0)
+        {
+            return;
+        }
+        recorder.pipeline_barrier(GPU_SCAN_CLEAR_BARRIER);
+        record_draw_compaction_dispatch(recorder, *this->pipeline, {
+                                                                       .instances = this->m_info.device.buffer_device_address(info.instances).value(),
+                                                                       .visibility = this->m_info.device.buffer_device_address(info.visibility).value(),
+                                                                       .draws = this->m_info.device.buffer_device_address(info.draws).value(),
+                                                                       .counts = this->m_info.device.buffer_device_address(info.counts).value(),
+                                                                       .instance_count = info.instance_count,
+                                                                       .material_count = info.material_count,
+                                                                       .max_draws_per_material = info.max_draws_per_material,
+                                                                   });
+    }
+
+    void GpuDrawCompaction::add_task(TaskGraph & task_graph, GpuDrawCompactionTaskInfo const & info) const
+    {
+        // The counts are cleared in their own task, so the compaction waits on the clear through the task graph.
+        task_graph.add_task(InlineTaskInfo{
+            .attachments = {inl_attachment(TaskBufferAccess::TRANSFER_WRITE, info.counts)},
+            .task = [counts = info.counts, material_count = info.material_count](TaskInterface ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(counts).ids[0], .size = usize{material_count} * sizeof(u32)});
+            },
+            .name = info.name + " clear",
+        });
+        task_graph.add_task(InlineTaskInfo{
+            .attachments = {
+                inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ, info.instances),
+                inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ, info.visibility),
+                inl_attachment(TaskBufferAccess::COMPUTE_SHADER_WRITE, info.draws),
+                inl_attachment(TaskBufferAccess::COMPUTE_SHADER_READ_WRITE, info.counts),
+            },
+            .task = [pipeline = this->pipeline, info](TaskInterface ti)
+            {
+                if (info.instance_count == 0)
+                {
+                    return;
+                }
+                record_draw_compaction_dispatch(ti.recorder, *pipeline, {
+                                                                            .instances = ti.device_address(info.instances).value(),
+                                                                            .visibility = ti.device_address(info.visibility).value(),
+                                                                            .draws = ti.device_address(info.draws).value(),
+                                                                            .counts = ti.device_address(info.counts).value(),
+                                                                            .instance_count = info.instance_count,
+                                                                            .material_count = info.material_count,
+                                                                            .max_draws_per_material = info.max_draws_per_material,
+                                                                        });
+            },
+            .name = info.name,
+        });
+    }
+
+    auto GpuDrawCompaction::draw_indirect_count_info(BufferId draws, BufferId counts, u32 material, u32 max_draws_per_material) -> DrawIndirectCountInfo
+    {
+        return DrawIndirectCountInfo{
+            .draw_command_buffer = draws,
+            .indirect_buffer = usize{material} * max_draws_per_material * sizeof(daxa_DrawIndexedIndirectStruct),
+            .count_buffer = counts,
+            .count_buffer_offset = usize{material} * sizeof(u32),
+            .max_draw_count = max_draws_per_material,
+            .draw_command_stride = sizeof(daxa_DrawIndexedIndirectStruct),
+            .is_indexed = true,
+        };
+    }
+
+    auto GpuDrawCompaction::info() const -> GpuDrawCompactionInfo const &
+    {
+        return this->m_info;
+    }
+} // namespace daxa
+
+#endif
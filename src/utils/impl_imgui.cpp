@@ -28,6 +28,11 @@ struct Push
 #include <cstring>
 #include <utility>
 #include <algorithm>
+#include <limits>
+#include <optional>
+
+#include "../impl_device.hpp"
+#include "../impl_command_recorder.hpp"
 
 void set_imgui_style()
 {
@@ -135,169 +140,333 @@ namespace daxa
         return std::bit_cast<ImTextureID>(impl.image_sampler_pairs.size() - 1);
     }
 
-#if DAXA_BUILT_WITH_UTILS_TASK_GRAPH
-    void ImGuiRenderer::record_task(ImDrawData * /* draw_data */, TaskGraph & /* task_graph */, TaskImageView /* task_swapchain_image */, u32 /* size_x */, u32 /* size_y */)
+    // Section sizes are rounded up to this, so that the vertex and index pointers meet any buffer reference alignment.
+    static constexpr usize IMGUI_RING_ALIGNMENT = 64;
+
+    struct ImGuiGeometryLayout
     {
+        usize indices_offset = {};
+        usize size = {};
+    };
+
+    // Vertices come first, followed by the indices.
+    static auto geometry_layout(ImDrawData const * draw_data) -> ImGuiGeometryLayout
+    {
+        auto const align_up = [](usize value)
+        { return (value + IMGUI_RING_ALIGNMENT - 1) & ~(IMGUI_RING_ALIGNMENT - 1); };
+        usize const vertices_size = static_cast<usize>(draw_data->TotalVtxCount) * sizeof(ImDrawVert);
+        usize const indices_size = static_cast<usize>(draw_data->TotalIdxCount) * sizeof(ImDrawIdx);
+        return ImGuiGeometryLayout{
+            .indices_offset = align_up(vertices_size),
+            .size = align_up(vertices_size) + align_up(indices_size),
+        };
     }
-#endif
 
-    void ImplImGuiRenderer::recreate_vbuffer(usize vbuffer_new_size)
+    static void write_geometry(ImDrawData * draw_data, std::byte * dst, usize indices_offset)
     {
-        vbuffer = info.device.create_buffer({
-            .size = static_cast<u32>(vbuffer_new_size),
-            .name = std::string("dear ImGui vertex buffer"),
-        });
+        // Host writes done before the submit are visible to the device without a barrier.
+        auto * vtx_dst = r_cast<ImDrawVert *>(dst);
+        auto * idx_dst = r_cast<ImDrawIdx *>(dst + indices_offset);
+        for (i32 n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            ImDrawList const * draws = draw_data->CmdLists[n];
+            std::memcpy(vtx_dst, draws->VtxBuffer.Data, static_cast<usize>(draws->VtxBuffer.Size) * sizeof(ImDrawVert));
+            std::memcpy(idx_dst, draws->IdxBuffer.Data, static_cast<usize>(draws->IdxBuffer.Size) * sizeof(ImDrawIdx));
+            vtx_dst += draws->VtxBuffer.Size;
+            idx_dst += draws->IdxBuffer.Size;
+        }
+    }
+
+#if DAXA_BUILT_WITH_UTILS_TASK_GRAPH
+    auto ImGuiRenderer::create_task_texture_id(TaskImageView task_image, SamplerId sampler) -> ImTextureID
+    {
+        auto & impl = *r_cast<ImplImGuiRenderer *>(this->object);
+        impl.task_image_contexts.push_back({.task_image = task_image, .sampler = sampler});
+        return std::bit_cast<ImTextureID>((impl.task_image_contexts.size() - 1) | ImplImGuiRenderer::TASK_TEXTURE_ID_BIT);
     }
-    void ImplImGuiRenderer::recreate_ibuffer(usize ibuffer_new_size)
+
+    void ImGuiRenderer::record_task(ImDrawData * draw_data, TaskGraph & task_graph, TaskImageView task_swapchain_image, u32 size_x, u32 size_y)
     {
-        ibuffer = info.device.create_buffer({
-            .size = static_cast<u32>(ibuffer_new_size),
-            .name = std::string("dear ImGui index buffer"),
+        auto & impl = *r_cast<ImplImGuiRenderer *>(this->object);
+        std::vector<TaskAttachmentInfo> attachments = {};
+        attachments.reserve(impl.task_image_contexts.size() + 1);
+        attachments.push_back(inl_attachment(TaskImageAccess::COLOR_ATTACHMENT, ImageViewType::REGULAR_2D, task_swapchain_image));
+        for (auto const & context : impl.task_image_contexts)
+        {
+            attachments.push_back(inl_attachment(TaskImageAccess::FRAGMENT_SHADER_SAMPLED, ImageViewType::REGULAR_2D, context.task_image));
+        }
+        // The task keeps the renderer alive for as long as the graph exists.
+        task_graph.add_task(InlineTaskInfo{
+            .attachments = std::move(attachments),
+            .task = [renderer = *this, draw_data, task_swapchain_image, size_x, size_y](TaskInterface ti)
+            {
+                renderer.get()->record_task_commands(ti, draw_data != nullptr ? draw_data : ImGui::GetDrawData(), task_swapchain_image, size_x, size_y);
+            },
+            .name = "dear ImGui",
         });
     }
 
-    void ImplImGuiRenderer::record_commands(ImDrawData * draw_data, CommandRecorder & recorder, ImageId target_image, u32 size_x, u32 size_y)
+    void ImplImGuiRenderer::record_task_commands(TaskInterface & ti, ImDrawData * draw_data, TaskImageView task_swapchain_image, u32 size_x, u32 size_y)
     {
         ++frame_count;
+        auto const & swapchain_attachment = ti.get(task_swapchain_image);
         if ((draw_data != nullptr) && draw_data->TotalIdxCount > 0)
         {
-            auto vbuffer_current_size = info.device.buffer_info(vbuffer).value().size;
-            auto vbuffer_needed_size = static_cast<usize>(draw_data->TotalVtxCount) * sizeof(ImDrawVert);
-            auto ibuffer_current_size = info.device.buffer_info(ibuffer).value().size;
-            auto ibuffer_needed_size = static_cast<usize>(draw_data->TotalIdxCount) * sizeof(ImDrawIdx);
+            if (size_x == 0 || size_y == 0)
+            {
+                Extent3D const extent = ti.device.image_info(swapchain_attachment.ids[0]).value().size;
+                size_x = extent.x;
+                size_y = extent.y;
+            }
+            this->task_image_sampler_pairs.clear();
+            for (auto const & context : this->task_image_contexts)
+            {
+                this->task_image_sampler_pairs.push_back(ImGuiImageContext{
+                    .image_view_id = ti.get(context.task_image).view_ids[0],
+                    .sampler_id = context.sampler,
+                });
+            }
 
-            if (vbuffer_needed_size > vbuffer_current_size)
+            // The graph retires its staging memory itself, the ring only backs frames that do not fit into it.
+            auto const [indices_offset, geometry_size] = geometry_layout(draw_data);
+            std::optional<TransferMemoryPool::Allocation> allocation = {};
+            if (ti.allocator != nullptr && geometry_size <= std::numeric_limits<u32>::max())
             {
-                auto vbuffer_new_size = vbuffer_needed_size + 4096;
-                info.device.destroy_buffer(vbuffer);
-                recreate_vbuffer(vbuffer_new_size);
+                allocation = ti.allocator->allocate(static_cast<u32>(geometry_size), static_cast<u32>(IMGUI_RING_ALIGNMENT));
             }
-            if (ibuffer_needed_size > ibuffer_current_size)
+            if (allocation.has_value())
             {
-                auto ibuffer_new_size = ibuffer_needed_size + 4096;
-                info.device.destroy_buffer(ibuffer);
-                recreate_ibuffer(ibuffer_new_size);
+                write_geometry(draw_data, r_cast<std::byte *>(allocation->host_address), indices_offset);
+                usize const offset = allocation->buffer_offset;
+                record_draws(draw_data, ti.recorder, swapchain_attachment.view_ids[0], size_x, size_y, allocation->buffer, offset, offset + indices_offset);
             }
+            else
+            {
+                usize const section_offset = allocate_ring_section(geometry_size, ti.recorder);
+                write_geometry(draw_data, info.device.buffer_host_address(ring_buffer).value() + section_offset, indices_offset);
+                record_draws(draw_data, ti.recorder, swapchain_attachment.view_ids[0], size_x, size_y, ring_buffer, section_offset, section_offset + indices_offset);
+            }
+        }
+        this->image_sampler_pairs.resize(1);
+    }
+#endif
 
-            constexpr usize IMGUI_RESOURCE_NAME_MAX_NUMBER = 8;
+    void ImplImGuiRenderer::recreate_ring_buffer(usize new_capacity)
+    {
+        ring_buffer = info.device.create_buffer({
+            .size = new_capacity,
+            .allocate_info = daxa::MemoryFlagBits::PREFER_DEVICE_LOCAL_HOST_VISIBLE,
+            .name = std::string("dear ImGui vertex and index ring buffer"),
+        });
+        ring_capacity = new_capacity;
+        ring_head = 0;
+        ring_sections.clear();
+    }
 
-            auto staging_vbuffer = info.device.create_buffer({
-                .size = static_cast<u32>(vbuffer_needed_size),
-                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                .name = std::string("dear ImGui vertex staging buffer ") + std::to_string(frame_count % IMGUI_RESOURCE_NAME_MAX_NUMBER),
-            });
-            auto * vtx_dst = info.device.buffer_host_address_as<ImDrawVert>(staging_vbuffer).value();
-            for (i32 n = 0; n < draw_data->CmdListsCount; n++)
+    auto ImplImGuiRenderer::allocate_ring_section(usize size, CommandRecorder & recorder) -> usize
+    {
+        auto * device = r_cast<daxa_Device>(info.device.get());
+        u64 retired_submit_timeline_value = {};
+        if (device->get_retired_submit_timeline_value(retired_submit_timeline_value) != DAXA_RESULT_SUCCESS)
+        {
+            retired_submit_timeline_value = 0;
+        }
+        while (!ring_sections.empty())
+        {
+            // Sections of commands that were not submitted yet keep u64 max.
+            u64 const submit_timeline_value = ring_sections.front().submit_timeline_value->load(std::memory_order::acquire);
+            if (submit_timeline_value == std::numeric_limits<u64>::max() || submit_timeline_value > retired_submit_timeline_value)
             {
-                ImDrawList const * draws = draw_data->CmdLists[n];
-                std::memcpy(vtx_dst, draws->VtxBuffer.Data, static_cast<usize>(draws->VtxBuffer.Size) * sizeof(ImDrawVert));
-                vtx_dst += draws->VtxBuffer.Size;
+                break;
             }
-            recorder.destroy_buffer_deferred(staging_vbuffer);
-            auto staging_ibuffer = info.device.create_buffer({
-                .size = static_cast<u32>(ibuffer_needed_size),
-                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
-                .name = std::string("dear ImGui index staging buffer ") + std::to_string(frame_count % IMGUI_RESOURCE_NAME_MAX_NUMBER),
-            });
-            auto * idx_dst = info.device.buffer_host_address_as<ImDrawIdx>(staging_ibuffer).value();
-            for (i32 n = 0; n < draw_data->CmdListsCount; n++)
+            ring_sections.pop_front();
+        }
+
+        usize offset = ring_head;
+        bool fits = {};
+        if (ring_sections.empty())
+        {
+            offset = 0;
+            fits = size <= ring_capacity;
+        }
+        else
+        {
+            usize const tail = ring_sections.front().offset;
+            if (ring_head > tail)
+            {
+                fits = ring_head + size <= ring_capacity;
+                if (!fits && size <= tail)
+                {
+                    offset = 0;
+                    fits = true;
+                }
+            }
+            else
+            {
+                fits = ring_head + size <= tail;
+            }
+        }
+        if (!fits)
+        {
+            // The old ring dies once these commands retire, so sections still in flight stay valid.
+            recorder.destroy_buffer_deferred(ring_buffer);
+            recreate_ring_buffer(std::max(ring_capacity * 2, size * 2));
+            offset = 0;
+        }
+
+        auto submit_timeline_value = std::make_shared<std::atomic_uint64_t>(std::numeric_limits<u64>::max());
+        r_cast<daxa_CommandRecorder>(recorder.get())->current_command_data.submit_timeline_listeners.push_back(submit_timeline_value);
+        ring_sections.push_back(RingSection{
+            .offset = offset,
+            .size = size,
+            .submit_timeline_value = std::move(submit_timeline_value),
+        });
+        ring_head = offset + size;
+        return offset;
+    }
+
+    auto ImplImGuiRenderer::texture_context(ImTextureID texture_id) const -> ImGuiImageContext
+    {
+        auto const index = std::bit_cast<usize>(texture_id);
+#if DAXA_BUILT_WITH_UTILS_TASK_GRAPH
+        if ((index & TASK_TEXTURE_ID_BIT) != 0)
+        {
+            return this->task_image_sampler_pairs.at(index & ~TASK_TEXTURE_ID_BIT);
+        }
+#endif
+        return this->image_sampler_pairs.at(index);
+    }
+
+    void ImplImGuiRenderer::record_commands(ImDrawData * draw_data, CommandRecorder & recorder, ImageId target_image, u32 size_x, u32 size_y)
+    {
+        ++frame_count;
+        if ((draw_data != nullptr) && draw_data->TotalIdxCount > 0)
+        {
+            auto const [indices_offset, geometry_size] = geometry_layout(draw_data);
+            usize const section_offset = allocate_ring_section(geometry_size, recorder);
+            write_geometry(draw_data, info.device.buffer_host_address(ring_buffer).value() + section_offset, indices_offset);
+            record_draws(draw_data, recorder, target_image.default_view(), size_x, size_y, ring_buffer, section_offset, section_offset + indices_offset);
+        }
+        this->image_sampler_pairs.resize(1);
+    }
+
+    void ImplImGuiRenderer::record_draws(ImDrawData * draw_data, CommandRecorder & recorder, ImageViewId target_view, u32 size_x, u32 size_y, BufferId geometry_buffer, usize vertices_offset, usize indices_offset)
+    {
+        auto render_recorder = std::move(recorder).begin_renderpass({
+            .color_attachments = std::array{RenderAttachmentInfo{.image_view = target_view, .load_op = AttachmentLoadOp::LOAD}},
+            .render_area = {.x = 0, .y = 0, .width = size_x, .height = size_y},
+        });
+
+        render_recorder.set_pipeline(raster_pipeline);
+
+        render_recorder.set_index_buffer({
+            .id = geometry_buffer,
+            .offset = indices_offset,
+            .index_type = IndexType::uint16,
+        });
+
+        auto push = Push{};
+        push.scale = {2.0f / draw_data->DisplaySize.x, 2.0f / draw_data->DisplaySize.y};
+        push.translate = {-1.0f - draw_data->DisplayPos.x * push.scale.x, -1.0f - draw_data->DisplayPos.y * push.scale.y};
+        ImVec2 const clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
+        ImVec2 const clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+        i32 global_vtx_offset = 0;
+        i32 global_idx_offset = 0;
+        push.vbuffer_ptr = this->info.device.device_address(geometry_buffer).value() + vertices_offset;
+        push.ibuffer_ptr = this->info.device.device_address(geometry_buffer).value() + indices_offset;
+
+        // Consecutive commands with the same scissor and texture are merged into one multi draw.
+        // The vertex shader indexes with gl_VertexIndex, which includes the vertex offset of each draw,
+        // so push constants only change with the texture.
+        std::optional<Rect2D> current_scissor = {};
+        std::optional<ImGuiImageContext> current_image_context = {};
+        this->draw_ranges.clear();
+        auto const flush_draws = [&]()
+        {
+            if (!this->draw_ranges.empty())
             {
-                ImDrawList const * draws = draw_data->CmdLists[n];
-                std::memcpy(idx_dst, draws->IdxBuffer.Data, static_cast<usize>(draws->IdxBuffer.Size) * sizeof(ImDrawIdx));
-                idx_dst += draws->IdxBuffer.Size;
+                render_recorder.draw_multi_indexed({.ranges = this->draw_ranges});
+                this->draw_ranges.clear();
             }
-            recorder.destroy_buffer_deferred(staging_ibuffer);
-            recorder.pipeline_barrier({
-                .src_access = daxa::AccessConsts::HOST_WRITE,
-                .dst_access = daxa::AccessConsts::TRANSFER_READ,
-            });
-            recorder.copy_buffer_to_buffer({
-                .src_buffer = staging_ibuffer,
-                .dst_buffer = ibuffer,
-                .size = ibuffer_needed_size,
-            });
-            recorder.copy_buffer_to_buffer({
-                .src_buffer = staging_vbuffer,
-                .dst_buffer = vbuffer,
-                .size = vbuffer_needed_size,
-            });
-            recorder.pipeline_barrier({
-                .src_access = daxa::AccessConsts::TRANSFER_WRITE,
-                .dst_access = daxa::AccessConsts::VERTEX_SHADER_READ | daxa::AccessConsts::INDEX_INPUT_READ,
-            });
-
-            auto render_recorder = std::move(recorder).begin_renderpass({
-                .color_attachments = std::array{RenderAttachmentInfo{.image_view = target_image.default_view(), .load_op = AttachmentLoadOp::LOAD}},
-                .render_area = {.x = 0, .y = 0, .width = size_x, .height = size_y},
-            });
-
-            render_recorder.set_pipeline(raster_pipeline);
-
-            render_recorder.set_index_buffer({
-                .id = ibuffer,
-                .offset = 0,
-                .index_type = IndexType::uint16,
-            });
-
-            auto push = Push{};
-            push.scale = {2.0f / draw_data->DisplaySize.x, 2.0f / draw_data->DisplaySize.y};
-            push.translate = {-1.0f - draw_data->DisplayPos.x * push.scale.x, -1.0f - draw_data->DisplayPos.y * push.scale.y};
-            ImVec2 const clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
-            ImVec2 const clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
-            i32 global_vtx_offset = 0;
-            i32 global_idx_offset = 0;
-            push.vbuffer_ptr = this->info.device.device_address(vbuffer).value();
-            push.ibuffer_ptr = this->info.device.device_address(ibuffer).value();
-
-            for (i32 n = 0; n < draw_data->CmdListsCount; n++)
+        };
+
+        for (i32 n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            ImDrawList const * draws = draw_data->CmdLists[n];
+            for (i32 cmd_i = 0; cmd_i < draws->CmdBuffer.Size; cmd_i++)
             {
-                ImDrawList const * draws = draw_data->CmdLists[n];
-                for (i32 cmd_i = 0; cmd_i < draws->CmdBuffer.Size; cmd_i++)
+                ImDrawCmd const * pcmd = &draws->CmdBuffer[cmd_i];
+
+                // Project scissor/clipping rectangles into framebuffer space
+                ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
+                ImVec2 const clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
+
+                // Clamp to viewport as vkCmdSetScissor() won't accept values that are off bounds
+                clip_min.x = std::clamp(clip_min.x, 0.0f, static_cast<f32>(size_x));
+                clip_min.y = std::clamp(clip_min.y, 0.0f, static_cast<f32>(size_y));
+                if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
                 {
-                    ImDrawCmd const * pcmd = &draws->CmdBuffer[cmd_i];
-
-                    // Project scissor/clipping rectangles into framebuffer space
-                    ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
-                    ImVec2 const clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
-
-                    // Clamp to viewport as vkCmdSetScissor() won't accept values that are off bounds
-                    clip_min.x = std::clamp(clip_min.x, 0.0f, static_cast<f32>(size_x));
-                    clip_min.y = std::clamp(clip_min.y, 0.0f, static_cast<f32>(size_y));
-                    if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
-                    {
-                        continue;
-                    }
-
-                    // Apply scissor/clipping rectangle
-                    Rect2D scissor;
-                    scissor.x = static_cast<i32>(clip_min.x);
-                    scissor.y = static_cast<i32>(clip_min.y);
-                    scissor.width = static_cast<u32>(clip_max.x - clip_min.x);
-                    scissor.height = static_cast<u32>(clip_max.y - clip_min.y);
-                    render_recorder.set_scissor(scissor);
+                    continue;
+                }
 
-                    // Draw
-                    auto const image_context = this->image_sampler_pairs.at(std::bit_cast<usize>(pcmd->TextureId));
+                // Apply scissor/clipping rectangle
+                Rect2D scissor;
+                scissor.x = static_cast<i32>(clip_min.x);
+                scissor.y = static_cast<i32>(clip_min.y);
+                scissor.width = static_cast<u32>(clip_max.x - clip_min.x);
+                scissor.height = static_cast<u32>(clip_max.y - clip_min.y);
+                bool const scissor_changed =
+                    !current_scissor.has_value() ||
+                    current_scissor->x != scissor.x || current_scissor->y != scissor.y ||
+                    current_scissor->width != scissor.width || current_scissor->height != scissor.height;
+
+                auto const image_context = this->texture_context(pcmd->TextureId);
+                bool const image_context_changed =
+                    !current_image_context.has_value() ||
+                    current_image_context->image_view_id != image_context.image_view_id ||
+                    current_image_context->sampler_id != image_context.sampler_id;
+
+                if (scissor_changed || image_context_changed)
+                {
+                    flush_draws();
+                }
+                if (scissor_changed)
+                {
+                    render_recorder.set_scissor(scissor);
+                    current_scissor = scissor;
+                }
+                if (image_context_changed)
+                {
                     push.texture0_id = image_context.image_view_id;
                     push.sampler0_id = image_context.sampler_id;
-
-                    push.vbuffer_offset = pcmd->VtxOffset + static_cast<u32>(global_vtx_offset);
-                    push.ibuffer_offset = pcmd->IdxOffset + static_cast<u32>(global_idx_offset);
-
                     render_recorder.push_constant(push);
-                    render_recorder.draw_indexed({
+                    current_image_context = image_context;
+                }
+
+                // Draw, commands that continue the previous range of indices extend it.
+                u32 const first_index = pcmd->IdxOffset + static_cast<u32>(global_idx_offset);
+                i32 const vertex_offset = static_cast<i32>(pcmd->VtxOffset) + global_vtx_offset;
+                if (!this->draw_ranges.empty() &&
+                    this->draw_ranges.back().vertex_offset == vertex_offset &&
+                    this->draw_ranges.back().first_index + this->draw_ranges.back().index_count == first_index)
+                {
+                    this->draw_ranges.back().index_count += pcmd->ElemCount;
+                }
+                else
+                {
+                    this->draw_ranges.push_back(DrawIndexedRange{
+                        .first_index = first_index,
                         .index_count = pcmd->ElemCount,
-                        .first_index = pcmd->IdxOffset + static_cast<u32>(global_idx_offset),
-                        .vertex_offset = static_cast<i32>(pcmd->VtxOffset) + global_vtx_offset,
+                        .vertex_offset = vertex_offset,
                     });
                 }
-                global_idx_offset += draws->IdxBuffer.Size;
-                global_vtx_offset += draws->VtxBuffer.Size;
             }
-
-            recorder = std::move(render_recorder).end_renderpass();
+            global_idx_offset += draws->IdxBuffer.Size;
+            global_vtx_offset += draws->VtxBuffer.Size;
         }
-        this->image_sampler_pairs.resize(1);
+        flush_draws();
+
+        recorder = std::move(render_recorder).end_renderpass();
     }
 
     ImplImGuiRenderer::ImplImGuiRenderer(ImGuiRendererInfo a_info)
@@ -346,8 +515,7 @@ namespace daxa
         {
             set_imgui_style();
         }
-        recreate_vbuffer(4096);
-        recreate_ibuffer(4096);
+        recreate_ring_buffer(1 << 16);
 
         ImGuiIO & io = ImGui::GetIO();
         io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
@@ -423,8 +591,7 @@ namespace daxa
 
     ImplImGuiRenderer::~ImplImGuiRenderer()
     {
-        this->info.device.destroy_buffer(this->vbuffer);
-        this->info.device.destroy_buffer(this->ibuffer);
+        this->info.device.destroy_buffer(this->ring_buffer);
         this->info.device.destroy_image(this->font_sheet);
         this->info.device.destroy_sampler(this->font_sampler);
     }
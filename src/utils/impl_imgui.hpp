@@ -3,6 +3,7 @@
 #include "../impl_core.hpp"
 
 #include <daxa/utils/imgui.hpp>
+#include <atomic>
 #include <deque>
 
 namespace daxa
@@ -11,17 +12,47 @@ namespace daxa
     {
         ImGuiRendererInfo info = {};
         RasterPipeline raster_pipeline = {};
-        BufferId vbuffer = {};
-        BufferId ibuffer = {};
+        // Vertices and indices are written straight into this host visible ring, each record_commands call takes one section.
+        // Sections are reused once the submit containing them retired, the ring doubles when it runs out of space.
+        struct RingSection
+        {
+            usize offset = {};
+            usize size = {};
+            // Set to the global submit timeline value when the recorded commands are submitted.
+            std::shared_ptr<std::atomic_uint64_t> submit_timeline_value = {};
+        };
+        BufferId ring_buffer = {};
+        usize ring_capacity = {};
+        usize ring_head = {};
+        std::deque<RingSection> ring_sections = {};
         ImageId font_sheet = {};
         SamplerId font_sampler = {};
         usize frame_count = {};
 
         std::vector<ImGuiImageContext> image_sampler_pairs = {};
+        // Reused by record_draws, so steady state recording does not allocate.
+        std::vector<DrawIndexedRange> draw_ranges = {};
 
-        void recreate_vbuffer(usize vbuffer_new_size);
-        void recreate_ibuffer(usize ibuffer_new_size);
+#if DAXA_BUILT_WITH_UTILS_TASK_GRAPH
+        // Set in the texture ids of create_task_texture_id, the remaining bits index task_image_contexts.
+        static constexpr usize TASK_TEXTURE_ID_BIT = usize{1} << 63;
+        struct TaskImageContext
+        {
+            TaskImageView task_image = {};
+            SamplerId sampler = {};
+        };
+        std::vector<TaskImageContext> task_image_contexts = {};
+        // Resolved from task_image_contexts every time the imgui task runs.
+        std::vector<ImGuiImageContext> task_image_sampler_pairs = {};
+
+        void record_task_commands(TaskInterface & ti, ImDrawData * draw_data, TaskImageView task_swapchain_image, u32 size_x, u32 size_y);
+#endif
+
+        void recreate_ring_buffer(usize new_capacity);
+        auto allocate_ring_section(usize size, CommandRecorder & recorder) -> usize;
+        auto texture_context(ImTextureID texture_id) const -> ImGuiImageContext;
         void record_commands(ImDrawData * draw_data, CommandRecorder & recorder, ImageId target_image, u32 size_x, u32 size_y);
+        void record_draws(ImDrawData * draw_data, CommandRecorder & recorder, ImageViewId target_view, u32 size_x, u32 size_y, BufferId geometry_buffer, usize vertices_offset, usize indices_offset);
 
         ImplImGuiRenderer(ImGuiRendererInfo a_info);
         ~ImplImGuiRenderer();
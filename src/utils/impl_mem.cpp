@@ -2,6 +2,10 @@
 
 #include <daxa/utils/mem.hpp>
 #include <utility>
+#include <bit>
+#include <algorithm>
+#include <cstring>
+#include <string>
 
 namespace daxa
 {
@@ -13,7 +17,7 @@ namespace daxa
           })},
           m_buffer{this->m_info.device.create_buffer({
               .size = this->m_info.capacity,
-              .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE | (a_info.use_bar_memory ? daxa::MemoryFlagBits::DEDICATED_MEMORY : daxa::MemoryFlagBits::NONE),
+              .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE | (a_info.use_bar_memory ? daxa::MemoryFlagBits::PREFER_DEVICE_LOCAL_HOST_VISIBLE : daxa::MemoryFlagBits::NONE),
               .name = this->m_info.name,
           })},
           buffer_device_address{this->m_info.device.device_address(this->m_buffer).value()},
@@ -32,6 +36,7 @@ namespace daxa
         std::swap(this->buffer_host_address, other.buffer_host_address);
         std::swap(this->claimed_start, other.claimed_start);
         std::swap(this->claimed_size, other.claimed_size);
+        std::swap(this->growth_blocks, other.growth_blocks);
     }
 
     auto TransferMemoryPool::operator=(TransferMemoryPool && other) -> TransferMemoryPool &
@@ -40,6 +45,11 @@ namespace daxa
         {
             this->m_info.device.destroy_buffer(this->m_buffer);
         }
+        for (auto const & block : this->growth_blocks)
+        {
+            this->m_info.device.destroy_buffer(block.buffer);
+        }
+        this->growth_blocks.clear();
         std::swap(this->m_info, other.m_info);
         std::swap(this->gpu_timeline, other.gpu_timeline);
         std::swap(this->current_timeline_value, other.current_timeline_value);
@@ -49,6 +59,7 @@ namespace daxa
         std::swap(this->buffer_host_address, other.buffer_host_address);
         std::swap(this->claimed_start, other.claimed_start);
         std::swap(this->claimed_size, other.claimed_size);
+        std::swap(this->growth_blocks, other.growth_blocks);
         return *this;
     }
 
@@ -58,6 +69,11 @@ namespace daxa
         {
             this->m_info.device.destroy_buffer(this->m_buffer);
         }
+        // Buffer destruction is deferred by the device, so outstanding submits may still use the blocks.
+        for (auto const & block : this->growth_blocks)
+        {
+            this->m_info.device.destroy_buffer(block.buffer);
+        }
     }
 
     auto TransferMemoryPool::allocate(u32 allocation_size, u32 alignment_requirement) -> std::optional<TransferMemoryPool::Allocation>
@@ -95,6 +111,10 @@ namespace daxa
             zero_offset_allocation_possible = calc_zero_offset_allocation_possible();
             if (!tail_allocation_possible && !zero_offset_allocation_possible)
             {
+                if (this->m_info.growable)
+                {
+                    return this->allocate_in_growth_block(allocation_size, alignment_requirement);
+                }
                 return std::nullopt;
             }
         }
@@ -127,9 +147,70 @@ namespace daxa
             .buffer_offset = returned_allocation_offset,
             .size = allocation_size,
             .timeline_index = this->current_timeline_value,
+            .buffer = this->m_buffer,
+        };
+    }
+
+    auto TransferMemoryPool::allocate_in_growth_block(u32 allocation_size, u32 alignment_requirement) -> Allocation
+    {
+        this->reclaim_growth_blocks();
+        auto up_align_offset = [](auto value, auto alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        };
+        auto block_iter = std::find_if(this->growth_blocks.begin(), this->growth_blocks.end(), [&](GrowthBlock const & block)
+                                       { return up_align_offset(block.used, alignment_requirement) + allocation_size <= block.size; });
+        if (block_iter == this->growth_blocks.end())
+        {
+            u32 const block_size = std::max(this->m_info.growth_block_size != 0 ? this->m_info.growth_block_size : this->m_info.capacity, allocation_size);
+            GrowthBlock block = {};
+            block.buffer = this->m_info.device.create_buffer({
+                .size = block_size,
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE | (this->m_info.use_bar_memory ? daxa::MemoryFlagBits::PREFER_DEVICE_LOCAL_HOST_VISIBLE : daxa::MemoryFlagBits::NONE),
+                .name = this->m_info.name + " growth block " + std::to_string(this->growth_blocks.size()),
+            });
+            block.device_address = this->m_info.device.device_address(block.buffer).value();
+            block.host_address = this->m_info.device.buffer_host_address(block.buffer).value();
+            block.size = block_size;
+            this->growth_blocks.push_back(block);
+            block_iter = std::prev(this->growth_blocks.end());
+        }
+        current_timeline_value += 1;
+        u32 const offset = up_align_offset(block_iter->used, alignment_requirement);
+        block_iter->used = offset + allocation_size;
+        block_iter->timeline_index = this->current_timeline_value;
+        return Allocation{
+            .device_address = block_iter->device_address + offset,
+            .host_address = reinterpret_cast<void *>(reinterpret_cast<u8 *>(block_iter->host_address) + offset),
+            .buffer_offset = offset,
+            .size = allocation_size,
+            .timeline_index = this->current_timeline_value,
+            .buffer = block_iter->buffer,
         };
     }
 
+    void TransferMemoryPool::reclaim_growth_blocks()
+    {
+        if (this->growth_blocks.empty())
+        {
+            return;
+        }
+        auto const current_gpu_timeline_value = this->gpu_timeline.value();
+        std::erase_if(this->growth_blocks, [&](GrowthBlock & block)
+                      {
+            if (block.timeline_index > current_gpu_timeline_value)
+            {
+                return false;
+            }
+            block.used = 0;
+            if (this->current_timeline_value - block.timeline_index < this->m_info.growth_block_release_delay)
+            {
+                return false;
+            }
+            this->m_info.device.destroy_buffer(block.buffer);
+            return true; });
+    }
+
     auto TransferMemoryPool::timeline_value() const -> usize
     {
         return this->current_timeline_value;
@@ -137,9 +218,15 @@ namespace daxa
 
     auto TransferMemoryPool::inc_timeline_value() -> usize
     {
+        this->reclaim_growth_blocks();
         return ++this->current_timeline_value;
     }
 
+    auto TransferMemoryPool::growth_block_count() const -> usize
+    {
+        return this->growth_blocks.size();
+    }
+
     void TransferMemoryPool::reclaim_unused_memory()
     {
         auto const current_gpu_timeline_value = this->gpu_timeline.value();
@@ -165,6 +252,2240 @@ namespace daxa
     {
         return this->m_buffer;
     }
+
+    ConcurrentTransferMemoryPool::ConcurrentTransferMemoryPool(TransferMemoryPoolInfo a_info)
+        : m_info{std::move(a_info)},
+          gpu_timeline{this->m_info.device.create_timeline_semaphore({
+              .initial_value = {},
+              .name = this->m_info.name,
+          })},
+          m_buffer{this->m_info.device.create_buffer({
+              .size = this->m_info.capacity,
+              .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE | (this->m_info.use_bar_memory ? daxa::MemoryFlagBits::PREFER_DEVICE_LOCAL_HOST_VISIBLE : daxa::MemoryFlagBits::NONE),
+              .name = this->m_info.name,
+          })},
+          buffer_device_address{this->m_info.device.device_address(this->m_buffer).value()},
+          buffer_host_address{this->m_info.device.buffer_host_address(this->m_buffer).value()}
+    {
+    }
+
+    ConcurrentTransferMemoryPool::ConcurrentTransferMemoryPool(ConcurrentTransferMemoryPool && other)
+    {
+        *this = std::move(other);
+    }
+
+    auto ConcurrentTransferMemoryPool::operator=(ConcurrentTransferMemoryPool && other) -> ConcurrentTransferMemoryPool &
+    {
+        auto swap_atomic = [](std::atomic<u64> & a, std::atomic<u64> & b)
+        {
+            b.store(a.exchange(b.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+        };
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->gpu_timeline, other.gpu_timeline);
+        std::swap(this->m_buffer, other.m_buffer);
+        std::swap(this->buffer_device_address, other.buffer_device_address);
+        std::swap(this->buffer_host_address, other.buffer_host_address);
+        swap_atomic(this->claimed_end, other.claimed_end);
+        swap_atomic(this->claimed_start, other.claimed_start);
+        swap_atomic(this->current_timeline_value, other.current_timeline_value);
+        std::swap(this->epochs, other.epochs);
+        return *this;
+    }
+
+    ConcurrentTransferMemoryPool::~ConcurrentTransferMemoryPool()
+    {
+        if (!this->m_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->m_buffer);
+        }
+    }
+
+    auto ConcurrentTransferMemoryPool::allocate(u32 allocation_size, u32 alignment_requirement) -> std::optional<Allocation>
+    {
+        u64 const capacity = this->m_info.capacity;
+        if (allocation_size > capacity)
+        {
+            return std::nullopt;
+        }
+        bool reclaimed = false;
+        u64 end = this->claimed_end.load(std::memory_order_relaxed);
+        u64 allocation_start = {};
+        u64 timeline_index = {};
+        while (true)
+        {
+            // Read before the claim, an inc_timeline_value ending an epoch that contains the claim read claimed_end after it.
+            // Its timeline value is therefore at least this one. Read after the claim, it could belong to an epoch that already ended.
+            timeline_index = this->current_timeline_value.load(std::memory_order_acquire) + 1;
+            u64 const offset = end % capacity;
+            u64 const aligned_offset = (offset + alignment_requirement - 1) / alignment_requirement * alignment_requirement;
+            // Allocations never wrap around the end of the buffer, the remaining tail space is skipped instead.
+            allocation_start = aligned_offset + allocation_size <= capacity ? end + (aligned_offset - offset) : end + (capacity - offset);
+            u64 const allocation_end = allocation_start + allocation_size;
+            if (allocation_end - this->claimed_start.load(std::memory_order_acquire) > capacity)
+            {
+                if (reclaimed)
+                {
+                    return std::nullopt;
+                }
+                this->reclaim_unused_memory();
+                reclaimed = true;
+                end = this->claimed_end.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (this->claimed_end.compare_exchange_weak(end, allocation_end, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        u64 const buffer_offset = allocation_start % capacity;
+        return Allocation{
+            .device_address = this->buffer_device_address + buffer_offset,
+            .host_address = reinterpret_cast<void *>(reinterpret_cast<u8 *>(this->buffer_host_address) + buffer_offset),
+            .buffer_offset = static_cast<u32>(buffer_offset),
+            .size = allocation_size,
+            .timeline_index = timeline_index,
+        };
+    }
+
+    auto ConcurrentTransferMemoryPool::timeline_value() const -> usize
+    {
+        return this->current_timeline_value.load(std::memory_order_acquire);
+    }
+
+    auto ConcurrentTransferMemoryPool::inc_timeline_value() -> usize
+    {
+        std::unique_lock const lock{this->epochs_mtx};
+        u64 const timeline_index = this->current_timeline_value.load(std::memory_order_relaxed) + 1;
+        u64 const end = this->claimed_end.load(std::memory_order_acquire);
+        // Epochs without allocations have nothing to reclaim.
+        if (this->epochs.empty() ? end != this->claimed_start.load(std::memory_order_relaxed) : end != this->epochs.back().end)
+        {
+            this->epochs.push_back(Epoch{.timeline_index = timeline_index, .end = end});
+        }
+        this->current_timeline_value.store(timeline_index, std::memory_order_release);
+        return timeline_index;
+    }
+
+    void ConcurrentTransferMemoryPool::reclaim_unused_memory()
+    {
+        std::unique_lock const lock{this->epochs_mtx};
+        auto const current_gpu_timeline_value = this->gpu_timeline.value();
+        while (!this->epochs.empty() && this->epochs.front().timeline_index <= current_gpu_timeline_value)
+        {
+            this->claimed_start.store(this->epochs.front().end, std::memory_order_release);
+            this->epochs.pop_front();
+        }
+    }
+
+    auto ConcurrentTransferMemoryPool::timeline_semaphore() -> TimelineSemaphore const &
+    {
+        return this->gpu_timeline;
+    }
+
+    auto ConcurrentTransferMemoryPool::info() const -> TransferMemoryPoolInfo const &
+    {
+        return this->m_info;
+    }
+
+    auto ConcurrentTransferMemoryPool::buffer() const -> daxa::BufferId
+    {
+        return this->m_buffer;
+    }
+
+    ReadbackMemoryPool::ReadbackMemoryPool(ReadbackMemoryPoolInfo a_info)
+        : m_info{std::move(a_info)},
+          gpu_timeline{this->m_info.device.create_timeline_semaphore({
+              .initial_value = {},
+              .name = this->m_info.name,
+          })},
+          m_buffer{this->m_info.device.create_buffer({
+              .size = this->m_info.capacity,
+              .allocate_info = daxa::MemoryFlagBits::HOST_CACHED,
+              .name = this->m_info.name,
+          })},
+          buffer_device_address{this->m_info.device.device_address(this->m_buffer).value()},
+          buffer_host_address{this->m_info.device.buffer_host_address(this->m_buffer).value()}
+    {
+    }
+
+    ReadbackMemoryPool::ReadbackMemoryPool(ReadbackMemoryPool && other)
+    {
+        *this = std::move(other);
+    }
+
+    auto ReadbackMemoryPool::operator=(ReadbackMemoryPool && other) -> ReadbackMemoryPool &
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->gpu_timeline, other.gpu_timeline);
+        std::swap(this->m_buffer, other.m_buffer);
+        std::swap(this->buffer_device_address, other.buffer_device_address);
+        std::swap(this->buffer_host_address, other.buffer_host_address);
+        std::swap(this->current_timeline_value, other.current_timeline_value);
+        std::swap(this->live_allocations, other.live_allocations);
+        std::swap(this->claimed_start, other.claimed_start);
+        std::swap(this->claimed_size, other.claimed_size);
+        return *this;
+    }
+
+    ReadbackMemoryPool::~ReadbackMemoryPool()
+    {
+        if (!this->m_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->m_buffer);
+        }
+    }
+
+    auto ReadbackMemoryPool::allocate(u32 allocation_size, u32 alignment_requirement) -> std::optional<Allocation>
+    {
+        auto try_place = [&]() -> std::optional<std::pair<u32, u32>>
+        {
+            u32 const capacity = this->m_info.capacity;
+            u32 const tail = (this->claimed_start + this->claimed_size) % capacity;
+            u32 const tail_aligned = (tail + alignment_requirement - 1) / alignment_requirement * alignment_requirement;
+            bool const wrapped = this->claimed_start + this->claimed_size > capacity || (this->claimed_size != 0 && tail <= this->claimed_start);
+            u32 const end = wrapped ? this->claimed_start : capacity;
+            // Returns the offset of the allocation and the claimed size including padding.
+            if (tail_aligned + allocation_size <= end)
+            {
+                return std::pair{tail_aligned, tail_aligned - tail + allocation_size};
+            }
+            // Skips the space left at the end of the buffer and places the allocation at offset zero.
+            if (!wrapped && allocation_size <= this->claimed_start)
+            {
+                return std::pair{0u, capacity - tail + allocation_size};
+            }
+            return std::nullopt;
+        };
+        auto placement = try_place();
+        if (!placement.has_value())
+        {
+            this->reclaim_unused_memory();
+            placement = try_place();
+            if (!placement.has_value())
+            {
+                return std::nullopt;
+            }
+        }
+        auto const [offset, claimed] = placement.value();
+        this->claimed_size += claimed;
+        this->current_timeline_value += 1;
+        this->live_allocations.push_back(TrackedAllocation{
+            .timeline_index = this->current_timeline_value,
+            .size = claimed,
+        });
+        return Allocation{
+            .device_address = this->buffer_device_address + offset,
+            .buffer_offset = offset,
+            .size = allocation_size,
+            .timeline_index = this->current_timeline_value,
+        };
+    }
+
+    auto ReadbackMemoryPool::try_read(Allocation const & allocation) -> std::optional<std::span<std::byte const>>
+    {
+        if (this->gpu_timeline.value() < allocation.timeline_index)
+        {
+            return std::nullopt;
+        }
+        // Host cached memory may be non coherent.
+        this->m_info.device.invalidate_ranges(std::array{BufferRange{
+            .buffer = this->m_buffer,
+            .offset = allocation.buffer_offset,
+            .size = allocation.size,
+        }});
+        return std::span{this->buffer_host_address + allocation.buffer_offset, allocation.size};
+    }
+
+    void ReadbackMemoryPool::release(Allocation const & allocation)
+    {
+        // inc_timeline_value() leaves gaps in the indices, so the allocation is searched for instead of indexed.
+        auto iter = std::lower_bound(
+            this->live_allocations.begin(), this->live_allocations.end(), allocation.timeline_index,
+            [](TrackedAllocation const & tracked, u64 timeline_index)
+            { return tracked.timeline_index < timeline_index; });
+        bool const found = iter != this->live_allocations.end() && iter->timeline_index == allocation.timeline_index;
+        DAXA_DBG_ASSERT_TRUE_M(found, "readback allocation was already reclaimed");
+        if (found)
+        {
+            iter->released = true;
+        }
+    }
+
+    void ReadbackMemoryPool::reclaim_unused_memory()
+    {
+        auto const current_gpu_timeline_value = this->gpu_timeline.value();
+        while (!this->live_allocations.empty() && this->live_allocations.front().released && this->live_allocations.front().timeline_index <= current_gpu_timeline_value)
+        {
+            this->claimed_start = (this->claimed_start + this->live_allocations.front().size) % this->m_info.capacity;
+            this->claimed_size -= this->live_allocations.front().size;
+            this->live_allocations.pop_front();
+        }
+    }
+
+    auto ReadbackMemoryPool::timeline_value() const -> usize
+    {
+        return this->current_timeline_value;
+    }
+
+    auto ReadbackMemoryPool::inc_timeline_value() -> usize
+    {
+        return ++this->current_timeline_value;
+    }
+
+    auto ReadbackMemoryPool::timeline_semaphore() -> TimelineSemaphore const &
+    {
+        return this->gpu_timeline;
+    }
+
+    auto ReadbackMemoryPool::buffer() const -> daxa::BufferId
+    {
+        return this->m_buffer;
+    }
+
+    auto ReadbackMemoryPool::info() const -> ReadbackMemoryPoolInfo const &
+    {
+        return this->m_info;
+    }
+
+    UploadQueue::UploadQueue(UploadQueueInfo a_info)
+        : m_info{std::move(a_info)},
+          staging{TransferMemoryPoolInfo{
+              .device = this->m_info.device,
+              .capacity = this->m_info.staging_capacity,
+              .name = this->m_info.name + " staging",
+          }},
+          gpu_timeline{this->m_info.device.create_timeline_semaphore({
+              .initial_value = {},
+              .name = this->m_info.name,
+          })}
+    {
+    }
+
+    UploadQueue::UploadQueue(UploadQueue && other)
+        : staging{std::move(other.staging)}
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->gpu_timeline, other.gpu_timeline);
+        std::swap(this->submitted_timeline_value, other.submitted_timeline_value);
+        std::swap(this->pending_buffer_copies, other.pending_buffer_copies);
+        std::swap(this->pending_image_copies, other.pending_image_copies);
+    }
+
+    auto UploadQueue::operator=(UploadQueue && other) -> UploadQueue &
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->staging, other.staging);
+        std::swap(this->gpu_timeline, other.gpu_timeline);
+        std::swap(this->submitted_timeline_value, other.submitted_timeline_value);
+        std::swap(this->pending_buffer_copies, other.pending_buffer_copies);
+        std::swap(this->pending_image_copies, other.pending_image_copies);
+        return *this;
+    }
+
+    UploadQueue::~UploadQueue()
+    {
+        // Pending uploads are submitted, so the staging memory is not dropped silently.
+        if (!this->m_info.device.is_valid())
+        {
+            return;
+        }
+        this->flush();
+    }
+
+    auto UploadQueue::allocate_staging(std::shared_lock<std::shared_mutex> & lock, u32 size) -> ConcurrentTransferMemoryPool::Allocation
+    {
+        DAXA_DBG_ASSERT_TRUE_M(size <= this->m_info.staging_capacity / 4, "upload does not fit into the staging ring");
+        while (true)
+        {
+            auto allocation = this->staging.allocate(size, 16);
+            if (allocation.has_value())
+            {
+                return allocation.value();
+            }
+            // The ring is full of pending uploads, submit them and wait for the gpu to release the memory.
+            lock.unlock();
+            UploadToken const token = this->flush();
+            this->wait(token);
+            lock.lock();
+        }
+    }
+
+    auto UploadQueue::upload_buffer(BufferId buffer, usize offset, std::span<std::byte const> data) -> UploadToken
+    {
+        std::shared_lock lock{this->flush_mtx};
+        u32 const max_chunk_size = this->m_info.staging_capacity / 4;
+        for (usize chunk_offset = 0; chunk_offset < data.size(); chunk_offset += max_chunk_size)
+        {
+            u32 const chunk_size = static_cast<u32>(std::min<usize>(max_chunk_size, data.size() - chunk_offset));
+            auto const allocation = this->allocate_staging(lock, chunk_size);
+            std::memcpy(allocation.host_address, data.data() + chunk_offset, chunk_size);
+            std::unique_lock const pending_lock{this->pending_mtx};
+            this->pending_buffer_copies.push_back(PendingBufferCopy{
+                .dst_buffer = buffer,
+                .dst_offset = offset + chunk_offset,
+                .src_offset = allocation.buffer_offset,
+                .size = chunk_size,
+            });
+        }
+        return UploadToken{this->submitted_timeline_value + 1};
+    }
+
+    auto UploadQueue::upload_image(ImageId image, ImageArraySlice slice, std::span<std::byte const> data, ImageLayout layout) -> UploadToken
+    {
+        Extent3D const size = this->m_info.device.image_info(image).value().size;
+        std::shared_lock lock{this->flush_mtx};
+        auto const allocation = this->allocate_staging(lock, static_cast<u32>(data.size()));
+        std::memcpy(allocation.host_address, data.data(), data.size());
+        std::unique_lock const pending_lock{this->pending_mtx};
+        this->pending_image_copies.push_back(BufferImageCopyInfo{
+            .buffer = this->staging.buffer(),
+            .buffer_offset = allocation.buffer_offset,
+            .image = image,
+            .image_layout = layout,
+            .image_slice = slice,
+            .image_offset = {},
+            .image_extent = {
+                std::max(1u, size.x >> slice.mip_level),
+                std::max(1u, size.y >> slice.mip_level),
+                std::max(1u, size.z >> slice.mip_level),
+            },
+        });
+        return UploadToken{this->submitted_timeline_value + 1};
+    }
+
+    auto UploadQueue::flush() -> UploadToken
+    {
+        std::unique_lock const lock{this->flush_mtx};
+        return this->flush_locked();
+    }
+
+    auto UploadQueue::flush_locked() -> UploadToken
+    {
+        if (this->pending_buffer_copies.empty() && this->pending_image_copies.empty())
+        {
+            return UploadToken{this->submitted_timeline_value};
+        }
+        // Uploads of consecutive ranges usually land in consecutive staging memory, those become one copy.
+        std::sort(this->pending_buffer_copies.begin(), this->pending_buffer_copies.end(), [](PendingBufferCopy const & a, PendingBufferCopy const & b)
+                  { return std::pair{std::bit_cast<u64>(a.dst_buffer), a.dst_offset} < std::pair{std::bit_cast<u64>(b.dst_buffer), b.dst_offset}; });
+        CommandRecorder recorder = this->m_info.device.create_command_recorder({
+            .queue_family = this->m_info.queue.family,
+            .name = this->m_info.name,
+        });
+        for (usize i = 0; i < this->pending_buffer_copies.size();)
+        {
+            PendingBufferCopy merged = this->pending_buffer_copies[i++];
+            while (i < this->pending_buffer_copies.size())
+            {
+                PendingBufferCopy const & next = this->pending_buffer_copies[i];
+                bool const adjacent =
+                    next.dst_buffer == merged.dst_buffer &&
+                    next.dst_offset == merged.dst_offset + merged.size &&
+                    next.src_offset == merged.src_offset + merged.size;
+                if (!adjacent)
+                {
+                    break;
+                }
+                merged.size += next.size;
+                ++i;
+            }
+            recorder.copy_buffer_to_buffer({
+                .src_buffer = this->staging.buffer(),
+                .dst_buffer = merged.dst_buffer,
+                .src_offset = merged.src_offset,
+                .dst_offset = merged.dst_offset,
+                .size = merged.size,
+            });
+        }
+        for (auto const & image_copy : this->pending_image_copies)
+        {
+            recorder.copy_buffer_to_image(image_copy);
+        }
+        this->pending_buffer_copies.clear();
+        this->pending_image_copies.clear();
+        this->submitted_timeline_value += 1;
+        auto const signals = std::array{
+            std::pair{this->gpu_timeline, this->submitted_timeline_value},
+            std::pair{this->staging.timeline_semaphore(), static_cast<u64>(this->staging.inc_timeline_value())},
+        };
+        this->m_info.device.submit_commands({
+            .queue = this->m_info.queue,
+            .command_lists = std::array{recorder.complete_current_commands()},
+            .signal_timeline_semaphores = signals,
+        });
+        return UploadToken{this->submitted_timeline_value};
+    }
+
+    auto UploadQueue::is_complete(UploadToken token) const -> bool
+    {
+        return this->gpu_timeline.value() >= token.timeline_value;
+    }
+
+    void UploadQueue::wait(UploadToken token)
+    {
+        [[maybe_unused]] bool const reached = this->gpu_timeline.wait_for_value(token.timeline_value);
+    }
+
+    auto UploadQueue::timeline_semaphore() const -> TimelineSemaphore const &
+    {
+        return this->gpu_timeline;
+    }
+
+    auto UploadQueue::info() const -> UploadQueueInfo const &
+    {
+        return this->m_info;
+    }
+
+    GpuDecompressionUploader::GpuDecompressionUploader(GpuDecompressionUploaderInfo a_info)
+        : m_info{std::move(a_info)},
+          staging{TransferMemoryPoolInfo{
+              .device = this->m_info.device,
+              .capacity = this->m_info.staging_capacity,
+              .name = this->m_info.name + " staging",
+          }}
+    {
+        DAXA_DBG_ASSERT_TRUE_M(
+            (this->m_info.device.properties().implicit_features & ImplicitFeatureFlagBits::MEMORY_DECOMPRESSION) != ImplicitFeatureFlagBits::NONE,
+            "gpu decompression requires ImplicitFeatureFlagBits::MEMORY_DECOMPRESSION");
+    }
+
+    GpuDecompressionUploader::GpuDecompressionUploader(GpuDecompressionUploader && other)
+        : staging{std::move(other.staging)}
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->regions, other.regions);
+    }
+
+    auto GpuDecompressionUploader::operator=(GpuDecompressionUploader && other) -> GpuDecompressionUploader &
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->staging, other.staging);
+        std::swap(this->regions, other.regions);
+        return *this;
+    }
+
+    GpuDecompressionUploader::~GpuDecompressionUploader() = default;
+
+    auto GpuDecompressionUploader::stage_pages(std::span<CompressedPage const> pages, std::optional<DeviceAddress> dst_address) -> std::optional<TransferMemoryPool::Allocation>
+    {
+        // Without a destination the pages are decompressed into the front of the staging allocation.
+        // A single allocation for both leaves nothing claimed in the ring when it fails.
+        usize decompressed_size = 0;
+        usize compressed_size = 0;
+        for (auto const & page : pages)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(page.decompressed_size <= GPU_DECOMPRESSION_MAX_PAGE_SIZE, "compressed pages must not decompress to more than GPU_DECOMPRESSION_MAX_PAGE_SIZE bytes");
+            decompressed_size += page.decompressed_size;
+            // Each compressed stream must start 4 byte aligned.
+            compressed_size += (page.compressed.size() + 3) & ~usize{3};
+        }
+        usize const compressed_offset = dst_address.has_value() ? 0 : (decompressed_size + 15) & ~usize{15};
+        auto const allocation = this->staging.allocate(static_cast<u32>(compressed_offset + compressed_size), 16);
+        if (!allocation.has_value())
+        {
+            return std::nullopt;
+        }
+        this->regions.clear();
+        DeviceAddress page_dst_address = dst_address.value_or(allocation->device_address);
+        usize src_offset = compressed_offset;
+        for (auto const & page : pages)
+        {
+            std::memcpy(static_cast<std::byte *>(allocation->host_address) + src_offset, page.compressed.data(), page.compressed.size());
+            this->regions.push_back(MemoryDecompressionRegion{
+                .src_address = allocation->device_address + src_offset,
+                .dst_address = page_dst_address,
+                .compressed_size = page.compressed.size(),
+                .decompressed_size = page.decompressed_size,
+            });
+            src_offset += (page.compressed.size() + 3) & ~usize{3};
+            page_dst_address += page.decompressed_size;
+        }
+        return allocation;
+    }
+
+    auto GpuDecompressionUploader::upload_buffer(CommandRecorder & recorder, BufferId buffer, usize offset, std::span<CompressedPage const> pages) -> bool
+    {
+        DAXA_DBG_ASSERT_TRUE_M((offset & 3) == 0, "gpu decompression destinations must be 4 byte aligned");
+        if (!this->stage_pages(pages, this->m_info.device.device_address(buffer).value() + offset).has_value())
+        {
+            return false;
+        }
+        recorder.decompress_memory({.regions = this->regions});
+        return true;
+    }
+
+    auto GpuDecompressionUploader::upload_image(CommandRecorder & recorder, ImageId image, ImageArraySlice slice, std::span<CompressedPage const> pages, ImageLayout layout) -> bool
+    {
+        for ([[maybe_unused]] auto const & page : pages)
+        {
+            DAXA_DBG_ASSERT_TRUE_M((page.decompressed_size & 3) == 0, "decompressed image pages must be a multiple of 4 bytes, so the following pages stay aligned");
+        }
+        auto const staged = this->stage_pages(pages, std::nullopt);
+        if (!staged.has_value())
+        {
+            return false;
+        }
+        recorder.decompress_memory({.regions = this->regions});
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::READ_WRITE,
+            .dst_access = AccessConsts::TRANSFER_READ,
+        });
+        Extent3D const size = this->m_info.device.image_info(image).value().size;
+        recorder.copy_buffer_to_image({
+            .buffer = staged->buffer,
+            .buffer_offset = staged->buffer_offset,
+            .image = image,
+            .image_layout = layout,
+            .image_slice = slice,
+            .image_offset = {},
+            .image_extent = {
+                std::max(1u, size.x >> slice.mip_level),
+                std::max(1u, size.y >> slice.mip_level),
+                std::max(1u, size.z >> slice.mip_level),
+            },
+        });
+        return true;
+    }
+
+    auto GpuDecompressionUploader::timeline_value() const -> usize
+    {
+        return this->staging.timeline_value();
+    }
+
+    auto GpuDecompressionUploader::timeline_semaphore() -> TimelineSemaphore const &
+    {
+        return this->staging.timeline_semaphore();
+    }
+
+    auto GpuDecompressionUploader::info() const -> GpuDecompressionUploaderInfo const &
+    {
+        return this->m_info;
+    }
+
+    BufferSuballocator::BufferSuballocator(BufferSuballocatorInfo a_info)
+        : m_info{std::move(a_info)},
+          gpu_timeline{this->m_info.device.create_timeline_semaphore({
+              .initial_value = {},
+              .name = this->m_info.name,
+          })}
+    {
+        DAXA_DBG_ASSERT_TRUE_M(std::has_single_bit(this->m_info.min_allocation_size), "min_allocation_size must be a power of two");
+        DAXA_DBG_ASSERT_TRUE_M(std::has_single_bit(this->m_info.block_size), "block_size must be a power of two");
+        DAXA_DBG_ASSERT_TRUE_M(this->m_info.min_allocation_size <= this->m_info.block_size, "min_allocation_size must not be larger than block_size");
+        this->max_order = static_cast<u32>(std::countr_zero(this->m_info.block_size) - std::countr_zero(this->m_info.min_allocation_size));
+    }
+
+    BufferSuballocator::BufferSuballocator(BufferSuballocator && other)
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->gpu_timeline, other.gpu_timeline);
+        std::swap(this->max_order, other.max_order);
+        std::swap(this->current_timeline_value, other.current_timeline_value);
+        std::swap(this->blocks, other.blocks);
+        std::swap(this->pending_frees, other.pending_frees);
+    }
+
+    auto BufferSuballocator::operator=(BufferSuballocator && other) -> BufferSuballocator &
+    {
+        for (auto const & block : this->blocks)
+        {
+            this->m_info.device.destroy_buffer(block.buffer);
+        }
+        this->blocks.clear();
+        this->pending_frees.clear();
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->gpu_timeline, other.gpu_timeline);
+        std::swap(this->max_order, other.max_order);
+        std::swap(this->current_timeline_value, other.current_timeline_value);
+        std::swap(this->blocks, other.blocks);
+        std::swap(this->pending_frees, other.pending_frees);
+        return *this;
+    }
+
+    BufferSuballocator::~BufferSuballocator()
+    {
+        // Buffer destruction is deferred by the device, so outstanding submits may still use the blocks.
+        for (auto const & block : this->blocks)
+        {
+            this->m_info.device.destroy_buffer(block.buffer);
+        }
+    }
+
+    auto BufferSuballocator::allocate(u64 size, u64 alignment_requirement) -> std::optional<BufferSuballocator::Allocation>
+    {
+        DAXA_DBG_ASSERT_TRUE_M(std::has_single_bit(alignment_requirement), "alignment_requirement must be a power of two");
+        // Buddy nodes are aligned to their own size, so rounding the size up to the alignment also aligns the offset.
+        u64 const node_size = std::bit_ceil(std::max({size, alignment_requirement, this->m_info.min_allocation_size}));
+        if (node_size > this->m_info.block_size)
+        {
+            return std::nullopt;
+        }
+        u32 const order = static_cast<u32>(std::countr_zero(node_size) - std::countr_zero(this->m_info.min_allocation_size));
+
+        auto try_allocate_in_any_block = [&]() -> std::optional<std::pair<u32, u64>>
+        {
+            for (u32 block_index = 0; block_index < static_cast<u32>(this->blocks.size()); ++block_index)
+            {
+                auto offset = this->try_allocate_in_block(block_index, order);
+                if (offset.has_value())
+                {
+                    return std::pair{block_index, offset.value()};
+                }
+            }
+            return std::nullopt;
+        };
+
+        auto block_and_offset = try_allocate_in_any_block();
+        if (!block_and_offset.has_value() && !this->pending_frees.empty())
+        {
+            this->reclaim_unused_memory();
+            block_and_offset = try_allocate_in_any_block();
+        }
+        if (!block_and_offset.has_value())
+        {
+            auto const block_name = this->m_info.name + " block " + std::to_string(this->blocks.size());
+            Block block = {};
+            block.buffer = this->m_info.device.create_buffer({
+                .size = this->m_info.block_size,
+                .allocate_info = this->m_info.memory_flags,
+                .name = block_name,
+            });
+            block.device_address = this->m_info.device.device_address(block.buffer).value();
+            auto const host_address = this->m_info.device.buffer_host_address(block.buffer);
+            block.host_address = host_address.has_value() ? host_address.value() : nullptr;
+            block.free_lists.resize(this->max_order + 1);
+            block.free_lists.at(this->max_order).insert(0);
+            this->blocks.push_back(std::move(block));
+            auto const block_index = static_cast<u32>(this->blocks.size() - 1);
+            block_and_offset = std::pair{block_index, this->try_allocate_in_block(block_index, order).value()};
+        }
+
+        auto const [block_index, offset] = block_and_offset.value();
+        Block const & block = this->blocks.at(block_index);
+        return Allocation{
+            .buffer = block.buffer,
+            .device_address = block.device_address + offset,
+            .host_address = block.host_address != nullptr ? reinterpret_cast<void *>(reinterpret_cast<u8 *>(block.host_address) + offset) : nullptr,
+            .buffer_offset = offset,
+            .size = size,
+            .block_index = block_index,
+            .order = order,
+        };
+    }
+
+    void BufferSuballocator::deferred_free(Allocation const & allocation)
+    {
+        this->pending_frees.push_back(PendingFree{
+            .timeline_index = this->current_timeline_value,
+            .block_index = allocation.block_index,
+            .order = allocation.order,
+            .offset = allocation.buffer_offset,
+        });
+    }
+
+    auto BufferSuballocator::try_allocate_in_block(u32 block_index, u32 order) -> std::optional<u64>
+    {
+        auto & free_lists = this->blocks.at(block_index).free_lists;
+        // Finds the smallest free node that fits and splits it down to the requested order.
+        u32 found_order = order;
+        while (found_order <= this->max_order && free_lists.at(found_order).empty())
+        {
+            ++found_order;
+        }
+        if (found_order > this->max_order)
+        {
+            return std::nullopt;
+        }
+        u64 const offset = *free_lists.at(found_order).begin();
+        free_lists.at(found_order).erase(free_lists.at(found_order).begin());
+        while (found_order > order)
+        {
+            --found_order;
+            u64 const buddy_offset = offset + (this->m_info.min_allocation_size << found_order);
+            free_lists.at(found_order).insert(buddy_offset);
+        }
+        return offset;
+    }
+
+    void BufferSuballocator::free_in_block(u32 block_index, u64 offset, u32 order)
+    {
+        auto & free_lists = this->blocks.at(block_index).free_lists;
+        // Merges with the buddy as long as it is free.
+        while (order < this->max_order)
+        {
+            u64 const buddy_offset = offset ^ (this->m_info.min_allocation_size << order);
+            auto buddy = free_lists.at(order).find(buddy_offset);
+            if (buddy == free_lists.at(order).end())
+            {
+                break;
+            }
+            free_lists.at(order).erase(buddy);
+            offset = std::min(offset, buddy_offset);
+            ++order;
+        }
+        free_lists.at(order).insert(offset);
+    }
+
+    void BufferSuballocator::reclaim_unused_memory()
+    {
+        auto const current_gpu_timeline_value = this->gpu_timeline.value();
+        while (!this->pending_frees.empty() && this->pending_frees.front().timeline_index <= current_gpu_timeline_value)
+        {
+            auto const & pending_free = this->pending_frees.front();
+            this->free_in_block(pending_free.block_index, pending_free.offset, pending_free.order);
+            this->pending_frees.pop_front();
+        }
+    }
+
+    auto BufferSuballocator::timeline_value() const -> u64
+    {
+        return this->current_timeline_value;
+    }
+
+    auto BufferSuballocator::inc_timeline_value() -> u64
+    {
+        return ++this->current_timeline_value;
+    }
+
+    auto BufferSuballocator::timeline_semaphore() -> TimelineSemaphore const &
+    {
+        return this->gpu_timeline;
+    }
+
+    auto BufferSuballocator::block_count() const -> usize
+    {
+        return this->blocks.size();
+    }
+
+    auto BufferSuballocator::info() const -> BufferSuballocatorInfo const &
+    {
+        return this->m_info;
+    }
+
+    // Required for acceleration structure offsets into buffers by the spec.
+    static constexpr u64 ACCELERATION_STRUCTURE_OFFSET_ALIGNMENT = 256;
+
+    AccelerationStructureBuilder::AccelerationStructureBuilder(AccelerationStructureBuilderInfo a_info)
+        : m_info{std::move(a_info)},
+          result_memory{BufferSuballocatorInfo{
+              .device = this->m_info.device,
+              .block_size = this->m_info.result_block_size,
+              .min_allocation_size = ACCELERATION_STRUCTURE_OFFSET_ALIGNMENT,
+              .name = this->m_info.name + " blas memory",
+          }}
+    {
+        auto const & as_properties = this->m_info.device.properties().acceleration_structure_properties;
+        DAXA_DBG_ASSERT_TRUE_M(as_properties.has_value(), "AccelerationStructureBuilder requires a device with ray tracing support");
+        this->scratch_alignment = std::max<u64>(as_properties.value().min_acceleration_structure_scratch_offset_alignment, 1);
+        if (this->m_info.max_pending_compactions > 0)
+        {
+            this->compaction_queries = this->m_info.device.create_query_pool({
+                .query_type = QueryType::ACCELERATION_STRUCTURE_COMPACTED_SIZE,
+                .query_count = this->m_info.max_pending_compactions,
+                .name = this->m_info.name + " compacted sizes",
+            });
+            // Popped from the back, so queries are handed out in ascending order.
+            for (u32 i = this->m_info.max_pending_compactions; i > 0; --i)
+            {
+                this->free_compaction_queries.push_back(i - 1);
+            }
+        }
+    }
+
+    AccelerationStructureBuilder::AccelerationStructureBuilder(AccelerationStructureBuilder && other)
+        : result_memory{std::move(other.result_memory)}
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->scratch_buffer, other.scratch_buffer);
+        std::swap(this->scratch_buffer_size, other.scratch_buffer_size);
+        std::swap(this->scratch_alignment, other.scratch_alignment);
+        std::swap(this->pending_builds, other.pending_builds);
+        std::swap(this->blas_allocations, other.blas_allocations);
+        std::swap(this->compaction_queries, other.compaction_queries);
+        std::swap(this->free_compaction_queries, other.free_compaction_queries);
+        std::swap(this->pending_compactions, other.pending_compactions);
+        std::swap(this->compacting_copies, other.compacting_copies);
+    }
+
+    auto AccelerationStructureBuilder::operator=(AccelerationStructureBuilder && other) -> AccelerationStructureBuilder &
+    {
+        if (!this->scratch_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->scratch_buffer);
+            this->scratch_buffer = {};
+        }
+        this->pending_builds.clear();
+        this->blas_allocations.clear();
+        this->compaction_queries = {};
+        this->free_compaction_queries.clear();
+        this->pending_compactions.clear();
+        this->compacting_copies.clear();
+        this->result_memory = std::move(other.result_memory);
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->scratch_buffer, other.scratch_buffer);
+        std::swap(this->scratch_buffer_size, other.scratch_buffer_size);
+        std::swap(this->scratch_alignment, other.scratch_alignment);
+        std::swap(this->pending_builds, other.pending_builds);
+        std::swap(this->blas_allocations, other.blas_allocations);
+        std::swap(this->compaction_queries, other.compaction_queries);
+        std::swap(this->free_compaction_queries, other.free_compaction_queries);
+        std::swap(this->pending_compactions, other.pending_compactions);
+        std::swap(this->compacting_copies, other.compacting_copies);
+        return *this;
+    }
+
+    AccelerationStructureBuilder::~AccelerationStructureBuilder()
+    {
+        // Destruction is deferred by the device, so outstanding builds may still use the scratch buffer.
+        if (!this->scratch_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->scratch_buffer);
+        }
+    }
+
+    auto AccelerationStructureBuilder::pending_build_of(BlasBuildInfo const & info) -> PendingBuild
+    {
+        PendingBuild build = {};
+        build.info = info;
+        if (auto const * triangles = daxa::get_if<0>(&info.geometries); triangles != nullptr)
+        {
+            for (usize i = 0; i < triangles->size(); ++i)
+            {
+                build.triangle_geometries.push_back((*triangles)[i]);
+            }
+        }
+        else if (auto const * aabbs = daxa::get_if<1>(&info.geometries); aabbs != nullptr)
+        {
+            for (usize i = 0; i < aabbs->size(); ++i)
+            {
+                build.aabb_geometries.push_back((*aabbs)[i]);
+            }
+        }
+
+        auto const build_sizes = this->m_info.device.blas_build_sizes(info);
+        build.blas_size = build_sizes.acceleration_structure_size;
+        build.scratch_size = build.info.update ? build_sizes.update_scratch_size : build_sizes.build_scratch_size;
+        return build;
+    }
+
+    auto AccelerationStructureBuilder::enqueue(BlasBuildInfo const & info, SmallString const & name) -> BlasId
+    {
+        PendingBuild build = this->pending_build_of(info);
+        auto allocation = this->result_memory.allocate(build.blas_size, ACCELERATION_STRUCTURE_OFFSET_ALIGNMENT);
+        DAXA_DBG_ASSERT_TRUE_M(allocation.has_value(), "blas is larger than the result block size of the AccelerationStructureBuilder");
+        if (!allocation.has_value())
+        {
+            return {};
+        }
+        BlasId const blas = this->m_info.device.create_blas_from_buffer({
+            .blas_info = {
+                .size = build.blas_size,
+                .name = name,
+            },
+            .buffer_id = allocation->buffer,
+            .offset = allocation->buffer_offset,
+        });
+        build.info.dst_blas = blas;
+        this->blas_allocations.emplace(std::bit_cast<u64>(blas), allocation.value());
+        this->pending_builds.push_back(std::move(build));
+        return blas;
+    }
+
+    void AccelerationStructureBuilder::enqueue_refit(BlasId blas, BlasBuildInfo const & info)
+    {
+        DAXA_DBG_ASSERT_TRUE_M(this->blas_allocations.contains(std::bit_cast<u64>(blas)), "blas was not created by this AccelerationStructureBuilder");
+        BlasBuildInfo refit_info = info;
+        refit_info.update = true;
+        refit_info.src_blas = blas;
+        refit_info.dst_blas = blas;
+        this->pending_builds.push_back(this->pending_build_of(refit_info));
+    }
+
+    auto AccelerationStructureBuilder::record_builds(CommandRecorder & recorder) -> u32
+    {
+        this->record_compactions(recorder);
+        if (this->pending_builds.empty())
+        {
+            return 0;
+        }
+        auto aligned_scratch_size = [&](PendingBuild const & build)
+        {
+            return (build.scratch_size + this->scratch_alignment - 1) / this->scratch_alignment * this->scratch_alignment;
+        };
+
+        // A single build that does not fit grows the scratch buffer, the old one is destroyed once previous batches finished.
+        u64 const first_scratch_size = aligned_scratch_size(this->pending_builds.front());
+        u64 const required_scratch_size = std::max(first_scratch_size, this->m_info.scratch_size);
+        if (this->scratch_buffer.is_empty() || this->scratch_buffer_size < required_scratch_size)
+        {
+            if (!this->scratch_buffer.is_empty())
+            {
+                this->m_info.device.destroy_buffer(this->scratch_buffer);
+            }
+            this->scratch_buffer_size = std::bit_ceil(required_scratch_size);
+            this->scratch_buffer = this->m_info.device.create_buffer({
+                .size = this->scratch_buffer_size,
+                .name = this->m_info.name + " scratch",
+            });
+        }
+        DeviceAddress const scratch_address = this->m_info.device.device_address(this->scratch_buffer).value();
+
+        std::vector<BlasBuildInfo> build_infos = {};
+        u64 scratch_offset = 0;
+        u64 batch_bytes = 0;
+        for (auto & build : this->pending_builds)
+        {
+            u64 const scratch_size = aligned_scratch_size(build);
+            bool const fits = scratch_offset + scratch_size <= this->scratch_buffer_size && batch_bytes + build.blas_size <= this->m_info.batch_byte_budget;
+            if (!build_infos.empty() && !fits)
+            {
+                break;
+            }
+            build.info.scratch_data = scratch_address + scratch_offset;
+            // The geometry spans point into the pending build, they are reassigned as the deque may have moved them.
+            if (daxa::holds_alternative<Span<BlasTriangleGeometryInfo const>>(build.info.geometries))
+            {
+                build.info.geometries = Span<BlasTriangleGeometryInfo const>{build.triangle_geometries.data(), build.triangle_geometries.size()};
+            }
+            else
+            {
+                build.info.geometries = Span<BlasAabbGeometryInfo const>{build.aabb_geometries.data(), build.aabb_geometries.size()};
+            }
+            build_infos.push_back(build.info);
+            scratch_offset += scratch_size;
+            batch_bytes += build.blas_size;
+        }
+
+        // Orders the scratch writes of this batch after the ones of the previous batch.
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::ACCELERATION_STRUCTURE_BUILD_READ_WRITE,
+            .dst_access = AccessConsts::ACCELERATION_STRUCTURE_BUILD_READ_WRITE,
+        });
+        recorder.build_acceleration_structures({
+            .blas_build_infos = build_infos,
+        });
+
+        std::vector<BlasId> compacted_blas = {};
+        for (auto const & build_info : build_infos)
+        {
+            bool const allows_compaction = (build_info.flags & AccelerationStructureBuildFlagBits::ALLOW_COMPACTION).data != 0;
+            if (!allows_compaction || build_info.update || this->free_compaction_queries.size() <= compacted_blas.size())
+            {
+                continue;
+            }
+            compacted_blas.push_back(build_info.dst_blas);
+        }
+        if (!compacted_blas.empty())
+        {
+            recorder.pipeline_barrier({
+                .src_access = AccessConsts::ACCELERATION_STRUCTURE_BUILD_WRITE,
+                .dst_access = AccessConsts::ACCELERATION_STRUCTURE_BUILD_READ,
+            });
+            // The queries of a batch are not necessarily consecutive, each one is reset and written on its own.
+            for (auto const & blas : compacted_blas)
+            {
+                u32 const query_index = this->free_compaction_queries.back();
+                this->free_compaction_queries.pop_back();
+                recorder.reset_queries({
+                    .query_pool = this->compaction_queries,
+                    .start_index = query_index,
+                    .count = 1,
+                });
+                recorder.write_blas_compacted_sizes({
+                    .blas = std::span{&blas, 1},
+                    .query_pool = this->compaction_queries,
+                    .first_query_index = query_index,
+                });
+                this->pending_compactions.push_back({
+                    .blas = blas,
+                    .query_index = query_index,
+                    .timeline_value = this->timeline_value(),
+                });
+            }
+        }
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::ACCELERATION_STRUCTURE_BUILD_WRITE,
+            .dst_access = AccessConsts::READ,
+        });
+        this->pending_builds.erase(this->pending_builds.begin(), this->pending_builds.begin() + static_cast<isize>(build_infos.size()));
+        return static_cast<u32>(build_infos.size());
+    }
+
+    auto AccelerationStructureBuilder::pending_build_count() const -> usize
+    {
+        return this->pending_builds.size();
+    }
+
+    void AccelerationStructureBuilder::record_compactions(CommandRecorder & recorder)
+    {
+        u64 const gpu_timeline_value = this->timeline_semaphore().value();
+        bool recorded_copies = false;
+        while (!this->pending_compactions.empty() && this->pending_compactions.front().timeline_value <= gpu_timeline_value)
+        {
+            PendingCompaction compaction = this->pending_compactions.front();
+            this->pending_compactions.pop_front();
+            auto const results = this->compaction_queries.get_query_results(compaction.query_index, 1);
+            this->free_compaction_queries.push_back(compaction.query_index);
+            u64 const compacted_size = results[0];
+            auto allocation_iter = this->blas_allocations.find(std::bit_cast<u64>(compaction.blas));
+            // The blas may have been destroyed while its size was being queried.
+            if (results[1] == 0 || allocation_iter == this->blas_allocations.end() || compacted_size == 0 || compacted_size >= allocation_iter->second.size)
+            {
+                continue;
+            }
+            auto allocation = this->result_memory.allocate(compacted_size, ACCELERATION_STRUCTURE_OFFSET_ALIGNMENT);
+            if (!allocation.has_value())
+            {
+                continue;
+            }
+            BlasId const compacted = this->m_info.device.create_blas_from_buffer({
+                .blas_info = {
+                    .size = compacted_size,
+                    .name = this->m_info.device.info(compaction.blas).value().name,
+                },
+                .buffer_id = allocation->buffer,
+                .offset = allocation->buffer_offset,
+            });
+            this->blas_allocations.emplace(std::bit_cast<u64>(compacted), allocation.value());
+            recorder.copy_acceleration_structure({
+                .src_blas = compaction.blas,
+                .dst_blas = compacted,
+                .mode = AccelerationStructureCopyMode::COMPACT,
+            });
+            compaction.timeline_value = this->timeline_value();
+            this->compacting_copies.push_back({compaction, compacted});
+            recorded_copies = true;
+        }
+        if (recorded_copies)
+        {
+            recorder.pipeline_barrier({
+                .src_access = AccessConsts::ACCELERATION_STRUCTURE_BUILD_WRITE,
+                .dst_access = AccessConsts::READ,
+            });
+        }
+    }
+
+    auto AccelerationStructureBuilder::pending_compaction_count() const -> usize
+    {
+        return this->pending_compactions.size() + this->compacting_copies.size();
+    }
+
+    auto AccelerationStructureBuilder::take_compactions() -> std::vector<BlasCompaction>
+    {
+        std::vector<BlasCompaction> ret = {};
+        u64 const gpu_timeline_value = this->timeline_semaphore().value();
+        while (!this->compacting_copies.empty() && this->compacting_copies.front().first.timeline_value <= gpu_timeline_value)
+        {
+            auto const [compaction, compacted] = this->compacting_copies.front();
+            this->compacting_copies.pop_front();
+            // Originals destroyed by the user in the meantime only hand out the compacted blas.
+            if (this->blas_allocations.contains(std::bit_cast<u64>(compaction.blas)))
+            {
+                this->destroy_blas(compaction.blas);
+            }
+            ret.push_back({.original = compaction.blas, .compacted = compacted});
+        }
+        return ret;
+    }
+
+    void AccelerationStructureBuilder::destroy_blas(BlasId blas)
+    {
+        auto iter = this->blas_allocations.find(std::bit_cast<u64>(blas));
+        DAXA_DBG_ASSERT_TRUE_M(iter != this->blas_allocations.end(), "blas was not created by this AccelerationStructureBuilder");
+        if (iter == this->blas_allocations.end())
+        {
+            return;
+        }
+        this->m_info.device.destroy_blas(blas);
+        this->result_memory.deferred_free(iter->second);
+        this->blas_allocations.erase(iter);
+    }
+
+    auto AccelerationStructureBuilder::timeline_value() const -> u64
+    {
+        return this->result_memory.timeline_value();
+    }
+
+    auto AccelerationStructureBuilder::inc_timeline_value() -> u64
+    {
+        return this->result_memory.inc_timeline_value();
+    }
+
+    auto AccelerationStructureBuilder::timeline_semaphore() -> TimelineSemaphore const &
+    {
+        return this->result_memory.timeline_semaphore();
+    }
+
+    auto AccelerationStructureBuilder::info() const -> AccelerationStructureBuilderInfo const &
+    {
+        return this->m_info;
+    }
+
+    ShaderBindingTableBuilder::ShaderBindingTableBuilder(ShaderBindingTableBuilderInfo a_info)
+        : m_info{std::move(a_info)}
+    {
+        auto const & rt_properties = this->m_info.device.properties().ray_tracing_properties;
+        DAXA_DBG_ASSERT_TRUE_M(rt_properties.has_value(), "ShaderBindingTableBuilder requires a device with ray tracing pipeline support");
+        this->handle_size = rt_properties.value().shader_group_handle_size;
+        u64 const handle_alignment = std::max<u64>(rt_properties.value().shader_group_handle_alignment, 1);
+        u64 const base_alignment = std::max<u64>(rt_properties.value().shader_group_base_alignment, 1);
+        auto align_up = [](u64 value, u64 alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        };
+
+        u64 offset = 0;
+        for (u32 i = 0; i < this->regions.size(); ++i)
+        {
+            auto const & r_info = this->region_info(static_cast<ShaderBindingTableRegion>(i));
+            auto & region = this->regions[i];
+            bool const is_raygen = static_cast<ShaderBindingTableRegion>(i) == ShaderBindingTableRegion::RAYGEN;
+            // Raygen regions are a single record, trace_rays selects one by offsetting in whole strides.
+            region.stride = align_up(align_up(this->handle_size + r_info.record_data_size, handle_alignment), is_raygen ? base_alignment : 1);
+            region.size = r_info.groups.empty() ? 0 : align_up(region.stride * r_info.groups.size(), base_alignment);
+            region.offset = offset;
+            region.dirty.assign(r_info.groups.size(), 1);
+            offset += region.size;
+        }
+        DAXA_DBG_ASSERT_TRUE_M(offset > 0, "shader binding table must contain at least one record");
+
+        this->table_data.resize(offset);
+        this->m_buffer = this->m_info.device.create_buffer({
+            .size = offset,
+            .name = this->m_info.name,
+        });
+        this->buffer_address = this->m_info.device.device_address(this->m_buffer).value();
+        this->set_pipeline(this->m_info.pipeline);
+    }
+
+    ShaderBindingTableBuilder::ShaderBindingTableBuilder(ShaderBindingTableBuilder && other)
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->m_buffer, other.m_buffer);
+        std::swap(this->buffer_address, other.buffer_address);
+        std::swap(this->handle_size, other.handle_size);
+        std::swap(this->regions, other.regions);
+        std::swap(this->group_handles, other.group_handles);
+        std::swap(this->table_data, other.table_data);
+    }
+
+    auto ShaderBindingTableBuilder::operator=(ShaderBindingTableBuilder && other) -> ShaderBindingTableBuilder &
+    {
+        if (!this->m_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->m_buffer);
+            this->m_buffer = {};
+        }
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->m_buffer, other.m_buffer);
+        std::swap(this->buffer_address, other.buffer_address);
+        std::swap(this->handle_size, other.handle_size);
+        std::swap(this->regions, other.regions);
+        std::swap(this->group_handles, other.group_handles);
+        std::swap(this->table_data, other.table_data);
+        return *this;
+    }
+
+    ShaderBindingTableBuilder::~ShaderBindingTableBuilder()
+    {
+        if (!this->m_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->m_buffer);
+        }
+    }
+
+    void ShaderBindingTableBuilder::set_record_data(ShaderBindingTableRegion region, u32 record_index, std::span<std::byte const> data)
+    {
+        auto const & r_info = this->region_info(region);
+        auto & r = this->regions[static_cast<u32>(region)];
+        DAXA_DBG_ASSERT_TRUE_M(record_index < r_info.groups.size(), "record index out of bounds of the shader binding table region");
+        std::byte * record_data = this->table_data.data() + r.offset + r.stride * record_index + this->handle_size;
+        std::memcpy(record_data, data.data(), std::min<usize>(data.size(), r_info.record_data_size));
+        r.dirty[record_index] = 1;
+    }
+
+    void ShaderBindingTableBuilder::set_record_group(ShaderBindingTableRegion region, u32 record_index, u32 group_index)
+    {
+        auto & r_info = this->region_info(region);
+        DAXA_DBG_ASSERT_TRUE_M(record_index < r_info.groups.size(), "record index out of bounds of the shader binding table region");
+        r_info.groups[record_index] = group_index;
+        this->write_handle(region, record_index);
+    }
+
+    void ShaderBindingTableBuilder::set_pipeline(RayTracingPipeline const & pipeline)
+    {
+        this->m_info.pipeline = pipeline;
+        this->group_handles.resize(static_cast<usize>(pipeline.info().shader_groups.size()) * this->handle_size);
+        pipeline.get_shader_group_handles(this->group_handles.data());
+        for (u32 i = 0; i < this->regions.size(); ++i)
+        {
+            auto const region = static_cast<ShaderBindingTableRegion>(i);
+            for (u32 record_index = 0; record_index < this->region_info(region).groups.size(); ++record_index)
+            {
+                this->write_handle(region, record_index);
+            }
+        }
+    }
+
+    auto ShaderBindingTableBuilder::record_upload(CommandRecorder & recorder) -> bool
+    {
+        // Ranges of consecutive dirty records, as table offset and size.
+        std::vector<std::pair<u64, u64>> ranges = {};
+        u64 staging_size = 0;
+        for (auto & region : this->regions)
+        {
+            for (u32 record_index = 0; record_index < region.dirty.size(); ++record_index)
+            {
+                if (region.dirty[record_index] == 0)
+                {
+                    continue;
+                }
+                region.dirty[record_index] = 0;
+                u64 const record_offset = region.offset + region.stride * record_index;
+                if (!ranges.empty() && ranges.back().first + ranges.back().second == record_offset)
+                {
+                    ranges.back().second += region.stride;
+                }
+                else
+                {
+                    ranges.push_back({record_offset, region.stride});
+                }
+                staging_size += region.stride;
+            }
+        }
+        if (ranges.empty())
+        {
+            return false;
+        }
+
+        BufferId const staging_buffer = this->m_info.device.create_buffer({
+            .size = staging_size,
+            .allocate_info = MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE,
+            .name = this->m_info.name + " staging",
+        });
+        auto * staging_ptr = this->m_info.device.buffer_host_address_as<std::byte>(staging_buffer).value();
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::RAY_TRACING_SHADER_READ,
+            .dst_access = AccessConsts::TRANSFER_WRITE,
+        });
+        u64 staging_offset = 0;
+        for (auto const & [table_offset, size] : ranges)
+        {
+            std::memcpy(staging_ptr + staging_offset, this->table_data.data() + table_offset, size);
+            recorder.copy_buffer_to_buffer({
+                .src_buffer = staging_buffer,
+                .dst_buffer = this->m_buffer,
+                .src_offset = staging_offset,
+                .dst_offset = table_offset,
+                .size = size,
+            });
+            staging_offset += size;
+        }
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::TRANSFER_WRITE,
+            .dst_access = AccessConsts::RAY_TRACING_SHADER_READ,
+        });
+        recorder.destroy_buffer_deferred(staging_buffer);
+        return true;
+    }
+
+    auto ShaderBindingTableBuilder::table() const -> RayTracingShaderBindingTable
+    {
+        auto region_of = [&](ShaderBindingTableRegion region)
+        {
+            auto const & r = this->regions[static_cast<u32>(region)];
+            if (r.size == 0)
+            {
+                return StridedDeviceAddressRegion{};
+            }
+            return StridedDeviceAddressRegion{
+                .address = this->buffer_address + r.offset,
+                .stride = r.stride,
+                // The raygen region size must equal its stride.
+                .size = region == ShaderBindingTableRegion::RAYGEN ? r.stride : r.size,
+            };
+        };
+        return RayTracingShaderBindingTable{
+            .raygen_region = region_of(ShaderBindingTableRegion::RAYGEN),
+            .miss_region = region_of(ShaderBindingTableRegion::MISS),
+            .hit_region = region_of(ShaderBindingTableRegion::HIT),
+            .callable_region = region_of(ShaderBindingTableRegion::CALLABLE),
+        };
+    }
+
+    auto ShaderBindingTableBuilder::buffer() const -> BufferId
+    {
+        return this->m_buffer;
+    }
+
+    auto ShaderBindingTableBuilder::info() const -> ShaderBindingTableBuilderInfo const &
+    {
+        return this->m_info;
+    }
+
+    auto ShaderBindingTableBuilder::region_info(ShaderBindingTableRegion region) -> ShaderBindingTableRegionInfo &
+    {
+        switch (region)
+        {
+        case ShaderBindingTableRegion::RAYGEN: return this->m_info.raygen;
+        case ShaderBindingTableRegion::MISS: return this->m_info.miss;
+        case ShaderBindingTableRegion::HIT: return this->m_info.hit;
+        default: return this->m_info.callable;
+        }
+    }
+
+    void ShaderBindingTableBuilder::write_handle(ShaderBindingTableRegion region, u32 record_index)
+    {
+        u32 const group_index = this->region_info(region).groups[record_index];
+        DAXA_DBG_ASSERT_TRUE_M(static_cast<usize>(group_index) * this->handle_size < this->group_handles.size(), "shader group index out of bounds of the pipeline shader groups");
+        auto & r = this->regions[static_cast<u32>(region)];
+        std::memcpy(
+            this->table_data.data() + r.offset + r.stride * record_index,
+            this->group_handles.data() + static_cast<usize>(group_index) * this->handle_size,
+            this->handle_size);
+        r.dirty[record_index] = 1;
+    }
+
+    // Each copied query is its timestamp followed by its availability.
+    static constexpr u64 GPU_TIMER_RESULT_STRIDE = 2 * sizeof(u64);
+
+    GpuTimer::GpuTimer(GpuTimerInfo a_info)
+        : m_info{std::move(a_info)}
+    {
+        DAXA_DBG_ASSERT_TRUE_M(this->m_info.frame_count > 0 && this->m_info.timestamps_per_frame > 0, "GpuTimer needs at least one frame and one timestamp per frame");
+        u32 const query_count = this->m_info.frame_count * this->m_info.timestamps_per_frame;
+        this->query_pool = this->m_info.device.create_timeline_query_pool({
+            .query_count = query_count,
+            .name = this->m_info.name,
+        });
+        this->readback_buffer = this->m_info.device.create_buffer({
+            .size = query_count * GPU_TIMER_RESULT_STRIDE,
+            .allocate_info = MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = this->m_info.name,
+        });
+        this->slots.resize(this->m_info.frame_count);
+    }
+
+    GpuTimer::GpuTimer(GpuTimer && other)
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->query_pool, other.query_pool);
+        std::swap(this->readback_buffer, other.readback_buffer);
+        std::swap(this->slots, other.slots);
+        std::swap(this->current_slot, other.current_slot);
+    }
+
+    auto GpuTimer::operator=(GpuTimer && other) -> GpuTimer &
+    {
+        if (!this->readback_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->readback_buffer);
+            this->readback_buffer = {};
+        }
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->query_pool, other.query_pool);
+        std::swap(this->readback_buffer, other.readback_buffer);
+        std::swap(this->slots, other.slots);
+        std::swap(this->current_slot, other.current_slot);
+        return *this;
+    }
+
+    GpuTimer::~GpuTimer()
+    {
+        if (!this->readback_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->readback_buffer);
+        }
+    }
+
+    auto GpuTimer::begin_frame(CommandRecorder & recorder, u64 frame_value) -> bool
+    {
+        DAXA_DBG_ASSERT_TRUE_M(this->current_slot == ~0u, "GpuTimer::begin_frame must be followed by end_frame before the next frame begins");
+        u32 const slot_index = static_cast<u32>(frame_value % this->m_info.frame_count);
+        Slot & slot = this->slots[slot_index];
+        // Resetting queries the gpu may still write or copy would need a wait, the frame is not timed instead.
+        if (slot.ended && slot.frame_value > this->m_info.frame_timeline.value())
+        {
+            return false;
+        }
+        slot.frame_value = frame_value;
+        slot.timestamp_count = 0;
+        slot.ended = false;
+        slot.results.clear();
+        slot.resolved = false;
+        slot.available = false;
+        recorder.reset_timestamps({
+            .query_pool = this->query_pool,
+            .start_index = slot_index * this->m_info.timestamps_per_frame,
+            .count = this->m_info.timestamps_per_frame,
+        });
+        this->current_slot = slot_index;
+        return true;
+    }
+
+    auto GpuTimer::write_timestamp(CommandRecorder & recorder, PipelineStageFlags stage) -> std::optional<u32>
+    {
+        if (this->current_slot == ~0u)
+        {
+            return std::nullopt;
+        }
+        Slot & slot = this->slots[this->current_slot];
+        if (slot.timestamp_count >= this->m_info.timestamps_per_frame)
+        {
+            return std::nullopt;
+        }
+        recorder.write_timestamp({
+            .query_pool = this->query_pool,
+            .pipeline_stage = stage,
+            .query_index = this->current_slot * this->m_info.timestamps_per_frame + slot.timestamp_count,
+        });
+        return slot.timestamp_count++;
+    }
+
+    void GpuTimer::end_frame(CommandRecorder & recorder)
+    {
+        if (this->current_slot == ~0u)
+        {
+            return;
+        }
+        Slot & slot = this->slots[this->current_slot];
+        slot.ended = true;
+        if (slot.timestamp_count > 0)
+        {
+            u32 const first_query = this->current_slot * this->m_info.timestamps_per_frame;
+            recorder.copy_timestamps_to_buffer({
+                .query_pool = this->query_pool,
+                .start_index = first_query,
+                .count = slot.timestamp_count,
+                .dst_buffer = this->readback_buffer,
+                .dst_offset = first_query * GPU_TIMER_RESULT_STRIDE,
+            });
+            recorder.pipeline_barrier({
+                .src_access = AccessConsts::TRANSFER_WRITE,
+                .dst_access = AccessConsts::HOST_READ,
+            });
+        }
+        this->current_slot = ~0u;
+    }
+
+    auto GpuTimer::results(u64 frame_value) -> std::optional<std::span<u64 const>>
+    {
+        Slot & slot = this->slots[frame_value % this->m_info.frame_count];
+        if (slot.frame_value != frame_value || !slot.ended)
+        {
+            return std::nullopt;
+        }
+        if (!slot.resolved)
+        {
+            if (this->m_info.frame_timeline.value() < frame_value)
+            {
+                return std::nullopt;
+            }
+            u32 const slot_index = static_cast<u32>(frame_value % this->m_info.frame_count);
+            u64 const * readback = this->m_info.device.buffer_host_address_as<u64>(this->readback_buffer).value() +
+                                   static_cast<usize>(slot_index) * this->m_info.timestamps_per_frame * 2;
+            // The copy does not wait for the queries, a timestamp the gpu did not write has an availability of zero.
+            slot.results.resize(slot.timestamp_count);
+            slot.available = true;
+            for (u32 i = 0; i < slot.timestamp_count; ++i)
+            {
+                slot.results[i] = readback[i * 2];
+                slot.available = slot.available && readback[i * 2 + 1] != 0;
+            }
+            slot.resolved = true;
+        }
+        if (!slot.available)
+        {
+            return std::nullopt;
+        }
+        return std::span<u64 const>{slot.results};
+    }
+
+    auto GpuTimer::elapsed_ms(u64 frame_value, u32 begin_timestamp, u32 end_timestamp) -> std::optional<f64>
+    {
+        auto const frame_results = this->results(frame_value);
+        if (!frame_results.has_value() || begin_timestamp >= frame_results->size() || end_timestamp >= frame_results->size())
+        {
+            return std::nullopt;
+        }
+        f64 const ticks = static_cast<f64>(frame_results.value()[end_timestamp]) - static_cast<f64>(frame_results.value()[begin_timestamp]);
+        return ticks * static_cast<f64>(this->m_info.device.properties().limits.timestamp_period) / 1'000'000.0;
+    }
+
+    auto GpuTimer::info() const -> GpuTimerInfo const &
+    {
+        return this->m_info;
+    }
+
+    TextureStreamer::TextureStreamer(TextureStreamerInfo a_info)
+        : m_info{std::move(a_info)},
+          staging{TransferMemoryPoolInfo{
+              .device = this->m_info.device,
+              .capacity = this->m_info.staging_capacity,
+              .name = this->m_info.name + " staging",
+          }}
+    {
+        this->m_view_table = this->m_info.device.create_buffer({
+            .size = this->m_info.max_texture_count * sizeof(StreamedTextureView),
+            .name = this->m_info.name + " view table",
+        });
+        this->m_feedback_buffer = this->m_info.device.create_buffer({
+            .size = this->m_info.max_texture_count * sizeof(u32),
+            .name = this->m_info.name + " feedback",
+        });
+        this->readback_buffer = this->m_info.device.create_buffer({
+            .size = static_cast<usize>(this->m_info.frame_count) * this->m_info.max_texture_count * sizeof(u32),
+            .allocate_info = MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = this->m_info.name + " feedback readback",
+        });
+        this->feedback_slots.resize(this->m_info.frame_count);
+    }
+
+    TextureStreamer::TextureStreamer(TextureStreamer && other)
+        : staging{std::move(other.staging)}
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->m_view_table, other.m_view_table);
+        std::swap(this->m_feedback_buffer, other.m_feedback_buffer);
+        std::swap(this->readback_buffer, other.readback_buffer);
+        std::swap(this->feedback_slots, other.feedback_slots);
+        std::swap(this->textures, other.textures);
+        std::swap(this->free_textures, other.free_textures);
+        std::swap(this->destroyed_textures, other.destroyed_textures);
+        std::swap(this->m_resident_memory, other.m_resident_memory);
+        std::swap(this->latest_feedback_frame, other.latest_feedback_frame);
+        std::swap(this->buffers_cleared, other.buffers_cleared);
+    }
+
+    auto TextureStreamer::operator=(TextureStreamer && other) -> TextureStreamer &
+    {
+        for (auto const & texture : this->textures)
+        {
+            if (!texture.image.is_empty())
+            {
+                this->m_info.device.destroy_image(texture.image);
+            }
+        }
+        for (BufferId const buffer : {this->m_view_table, this->m_feedback_buffer, this->readback_buffer})
+        {
+            if (!buffer.is_empty())
+            {
+                this->m_info.device.destroy_buffer(buffer);
+            }
+        }
+        this->m_view_table = {};
+        this->m_feedback_buffer = {};
+        this->readback_buffer = {};
+        this->textures.clear();
+        this->free_textures.clear();
+        this->destroyed_textures.clear();
+        this->m_resident_memory = {};
+        this->staging = std::move(other.staging);
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->m_view_table, other.m_view_table);
+        std::swap(this->m_feedback_buffer, other.m_feedback_buffer);
+        std::swap(this->readback_buffer, other.readback_buffer);
+        std::swap(this->feedback_slots, other.feedback_slots);
+        std::swap(this->textures, other.textures);
+        std::swap(this->free_textures, other.free_textures);
+        std::swap(this->destroyed_textures, other.destroyed_textures);
+        std::swap(this->m_resident_memory, other.m_resident_memory);
+        std::swap(this->latest_feedback_frame, other.latest_feedback_frame);
+        std::swap(this->buffers_cleared, other.buffers_cleared);
+        return *this;
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        // Destruction is deferred by the device, so submitted updates and frames may still use the images.
+        for (auto const & texture : this->textures)
+        {
+            if (!texture.image.is_empty())
+            {
+                this->m_info.device.destroy_image(texture.image);
+            }
+        }
+        for (BufferId const buffer : {this->m_view_table, this->m_feedback_buffer, this->readback_buffer})
+        {
+            if (!buffer.is_empty())
+            {
+                this->m_info.device.destroy_buffer(buffer);
+            }
+        }
+    }
+
+    auto TextureStreamer::create_texture(StreamedTextureInfo const & info) -> u32
+    {
+        u32 index = {};
+        if (!this->free_textures.empty())
+        {
+            index = this->free_textures.back();
+            this->free_textures.pop_back();
+        }
+        else
+        {
+            DAXA_DBG_ASSERT_TRUE_M(this->textures.size() < this->m_info.max_texture_count, "exceeded TextureStreamerInfo::max_texture_count");
+            index = static_cast<u32>(this->textures.size());
+            this->textures.push_back({});
+        }
+        Texture & texture = this->textures[index];
+        texture = Texture{
+            .info = info,
+            .first_resident_mip = info.mip_level_count,
+            .alive = true,
+        };
+        u32 mip_tail_first_mip = 0;
+        while (mip_tail_first_mip + 1 < info.mip_level_count &&
+               std::max(info.size.x >> mip_tail_first_mip, info.size.y >> mip_tail_first_mip) > info.mip_tail_extent)
+        {
+            ++mip_tail_first_mip;
+        }
+        texture.mip_tail_first_mip = mip_tail_first_mip;
+        texture.target_mip = mip_tail_first_mip;
+        texture.last_request_frame = this->latest_feedback_frame;
+        return index;
+    }
+
+    void TextureStreamer::destroy_texture(u32 texture)
+    {
+        DAXA_DBG_ASSERT_TRUE_M(texture < this->textures.size() && this->textures[texture].alive, "invalid streamed texture index");
+        this->textures[texture].alive = false;
+        this->destroyed_textures.push_back(texture);
+    }
+
+    void TextureStreamer::request_mip(u32 texture, u32 mip_level)
+    {
+        DAXA_DBG_ASSERT_TRUE_M(texture < this->textures.size() && this->textures[texture].alive, "invalid streamed texture index");
+        Texture & tex = this->textures[texture];
+        tex.requested_mip = std::min(tex.requested_mip, mip_level);
+        tex.last_request_frame = std::max(tex.last_request_frame, this->latest_feedback_frame);
+    }
+
+    void TextureStreamer::record_feedback(CommandRecorder & recorder, u64 frame_value)
+    {
+        this->read_feedback();
+        u32 const slot_index = static_cast<u32>(frame_value % this->m_info.frame_count);
+        FeedbackSlot & slot = this->feedback_slots[slot_index];
+        // The gpu may still copy into the slot. The feedback is kept and accumulates into the next frame instead.
+        if (slot.pending)
+        {
+            return;
+        }
+        slot.frame_value = frame_value;
+        slot.pending = true;
+        usize const feedback_size = this->m_info.max_texture_count * sizeof(u32);
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::READ_WRITE,
+            .dst_access = AccessConsts::TRANSFER_READ_WRITE,
+        });
+        recorder.copy_buffer_to_buffer({
+            .src_buffer = this->m_feedback_buffer,
+            .dst_buffer = this->readback_buffer,
+            .dst_offset = slot_index * feedback_size,
+            .size = feedback_size,
+        });
+        recorder.clear_buffer({
+            .buffer = this->m_feedback_buffer,
+            .size = feedback_size,
+            .clear_value = ~0u,
+        });
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::TRANSFER_WRITE,
+            .dst_access = AccessConsts::HOST_READ,
+        });
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::TRANSFER_WRITE,
+            .dst_access = AccessConsts::READ_WRITE,
+        });
+    }
+
+    auto TextureStreamer::record_updates(CommandRecorder & recorder) -> u32
+    {
+        if (!this->buffers_cleared)
+        {
+            recorder.clear_buffer({
+                .buffer = this->m_view_table,
+                .size = this->m_info.max_texture_count * sizeof(StreamedTextureView),
+            });
+            recorder.clear_buffer({
+                .buffer = this->m_feedback_buffer,
+                .size = this->m_info.max_texture_count * sizeof(u32),
+                .clear_value = ~0u,
+            });
+            recorder.pipeline_barrier({
+                .src_access = AccessConsts::TRANSFER_WRITE,
+                .dst_access = AccessConsts::TRANSFER_READ_WRITE,
+            });
+            this->buffers_cleared = true;
+        }
+        this->read_feedback();
+
+        for (u32 const index : this->destroyed_textures)
+        {
+            Texture & texture = this->textures[index];
+            if (!texture.image.is_empty())
+            {
+                recorder.destroy_image_deferred(texture.image);
+            }
+            this->m_resident_memory -= texture.memory_size;
+            texture = {};
+            this->record_view_write(recorder, index);
+            this->free_textures.push_back(index);
+        }
+        this->destroyed_textures.clear();
+
+        // Plans the first mip of every texture. Requested mips are added, resident mips are kept as long as the budget allows.
+        std::vector<u32> order = {};
+        std::vector<u32> planned_first_mips(this->textures.size());
+        u64 planned_memory = 0;
+        for (u32 index = 0; index < this->textures.size(); ++index)
+        {
+            Texture & texture = this->textures[index];
+            if (!texture.alive)
+            {
+                continue;
+            }
+            if (texture.requested_mip != ~0u)
+            {
+                texture.target_mip = std::min(texture.requested_mip, texture.mip_tail_first_mip);
+                texture.requested_mip = ~0u;
+            }
+            u32 const first_mip = std::min({texture.target_mip, texture.first_resident_mip, texture.mip_tail_first_mip});
+            planned_first_mips[index] = first_mip;
+            for (u32 mip = first_mip; mip < texture.info.mip_level_count; ++mip)
+            {
+                planned_memory += this->mip_byte_size(texture, mip);
+            }
+            order.push_back(index);
+        }
+        // Oldest requests first.
+        std::sort(order.begin(), order.end(), [&](u32 a, u32 b)
+                  { return this->textures[a].last_request_frame < this->textures[b].last_request_frame; });
+        for (auto iter = order.begin(); iter != order.end() && planned_memory > this->m_info.memory_budget; ++iter)
+        {
+            Texture & texture = this->textures[*iter];
+            u32 & first_mip = planned_first_mips[*iter];
+            while (first_mip < texture.mip_tail_first_mip && planned_memory > this->m_info.memory_budget)
+            {
+                planned_memory -= this->mip_byte_size(texture, first_mip);
+                ++first_mip;
+            }
+            texture.target_mip = std::max(texture.target_mip, first_mip);
+        }
+
+        // Reductions free memory, so they are recorded before any upload.
+        for (u32 const index : order)
+        {
+            Texture const & texture = this->textures[index];
+            if (planned_first_mips[index] > texture.first_resident_mip)
+            {
+                this->record_texture_change(recorder, index, planned_first_mips[index], {});
+            }
+        }
+
+        // Most recent requests first.
+        u32 uploaded_mips = 0;
+        u64 uploaded_bytes = 0;
+        bool staging_full = false;
+        std::vector<TransferMemoryPool::Allocation> uploads = {};
+        for (auto iter = order.rbegin(); iter != order.rend() && !staging_full; ++iter)
+        {
+            Texture const & texture = this->textures[*iter];
+            if (planned_first_mips[*iter] >= texture.first_resident_mip)
+            {
+                continue;
+            }
+            // Mips are loaded from coarse to fine, each one extends the resident mips of the new image.
+            uploads.clear();
+            u32 first_mip = texture.first_resident_mip;
+            while (first_mip > planned_first_mips[*iter])
+            {
+                u32 const mip = first_mip - 1;
+                u32 const size = this->mip_byte_size(texture, mip);
+                // At least one mip is uploaded per call, so mips larger than the budget still stream in.
+                bool const mandatory = mip >= texture.mip_tail_first_mip || uploaded_mips == 0;
+                if (!mandatory && uploaded_bytes + size > this->m_info.upload_budget)
+                {
+                    break;
+                }
+                auto allocation = this->staging.allocate(size, 16);
+                if (!allocation.has_value())
+                {
+                    staging_full = true;
+                    break;
+                }
+                if (!texture.info.load_mip(mip, std::span<std::byte>{reinterpret_cast<std::byte *>(allocation->host_address), size}))
+                {
+                    break;
+                }
+                uploads.insert(uploads.begin(), allocation.value());
+                uploaded_bytes += size;
+                uploaded_mips += 1;
+                first_mip = mip;
+            }
+            // The mip tail is only made resident as a whole.
+            if (first_mip < texture.first_resident_mip && first_mip <= texture.mip_tail_first_mip)
+            {
+                this->record_texture_change(recorder, *iter, first_mip, uploads);
+            }
+            if (uploaded_bytes >= this->m_info.upload_budget)
+            {
+                break;
+            }
+        }
+
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::TRANSFER_WRITE,
+            .dst_access = AccessConsts::READ_WRITE,
+        });
+        return uploaded_mips;
+    }
+
+    void TextureStreamer::record_texture_change(CommandRecorder & recorder, u32 texture, u32 first_mip, std::span<TransferMemoryPool::Allocation const> uploads)
+    {
+        Texture & tex = this->textures[texture];
+        ImageId const old_image = tex.image;
+        u32 const old_first_mip = tex.first_resident_mip;
+        auto const mip_extent = [&](u32 mip)
+        {
+            return Extent3D{
+                std::max(tex.info.size.x >> mip, 1u),
+                std::max(tex.info.size.y >> mip, 1u),
+                tex.info.dimensions == 3 ? std::max(tex.info.size.z >> mip, 1u) : 1u,
+            };
+        };
+        ImageInfo const image_info = this->image_info_of(tex, first_mip);
+        ImageId const new_image = this->m_info.device.create_image(image_info);
+        recorder.pipeline_barrier_image_transition({
+            .dst_access = AccessConsts::TRANSFER_WRITE,
+            .src_layout = ImageLayout::UNDEFINED,
+            .dst_layout = ImageLayout::GENERAL,
+            .image_slice = {.level_count = image_info.mip_level_count},
+            .image_id = new_image,
+        });
+        for (u32 mip = std::max(first_mip, old_first_mip); mip < tex.info.mip_level_count; ++mip)
+        {
+            recorder.copy_image_to_image({
+                .src_image = old_image,
+                .src_image_layout = ImageLayout::GENERAL,
+                .dst_image = new_image,
+                .dst_image_layout = ImageLayout::GENERAL,
+                .src_slice = {.mip_level = mip - old_first_mip},
+                .dst_slice = {.mip_level = mip - first_mip},
+                .extent = mip_extent(mip),
+            });
+        }
+        for (u32 i = 0; i < uploads.size(); ++i)
+        {
+            recorder.copy_buffer_to_image({
+                .buffer = uploads[i].buffer,
+                .buffer_offset = uploads[i].buffer_offset,
+                .image = new_image,
+                .image_layout = ImageLayout::GENERAL,
+                .image_slice = {.mip_level = i},
+                .image_extent = mip_extent(first_mip + i),
+            });
+        }
+        if (!old_image.is_empty())
+        {
+            recorder.destroy_image_deferred(old_image);
+        }
+        this->m_resident_memory -= tex.memory_size;
+        tex.memory_size = this->m_info.device.image_memory_requirements(image_info).size;
+        this->m_resident_memory += tex.memory_size;
+        tex.image = new_image;
+        tex.first_resident_mip = first_mip;
+        this->record_view_write(recorder, texture);
+    }
+
+    void TextureStreamer::record_view_write(CommandRecorder & recorder, u32 texture)
+    {
+        auto allocation = this->staging.allocate_fill(this->view(texture), 16);
+        DAXA_DBG_ASSERT_TRUE_M(allocation.has_value(), "TextureStreamerInfo::staging_capacity is too small for the view table writes");
+        recorder.copy_buffer_to_buffer({
+            .src_buffer = allocation->buffer,
+            .dst_buffer = this->m_view_table,
+            .src_offset = allocation->buffer_offset,
+            .dst_offset = texture * sizeof(StreamedTextureView),
+            .size = sizeof(StreamedTextureView),
+        });
+    }
+
+    void TextureStreamer::read_feedback()
+    {
+        u64 const finished_frame = this->m_info.frame_timeline.value();
+        u32 const * readback = this->m_info.device.buffer_host_address_as<u32>(this->readback_buffer).value();
+        for (u32 slot_index = 0; slot_index < this->feedback_slots.size(); ++slot_index)
+        {
+            FeedbackSlot & slot = this->feedback_slots[slot_index];
+            if (!slot.pending || slot.frame_value > finished_frame)
+            {
+                continue;
+            }
+            u32 const * feedback = readback + static_cast<usize>(slot_index) * this->m_info.max_texture_count;
+            for (u32 index = 0; index < this->textures.size(); ++index)
+            {
+                Texture & texture = this->textures[index];
+                if (!texture.alive || feedback[index] == ~0u)
+                {
+                    continue;
+                }
+                texture.requested_mip = std::min(texture.requested_mip, feedback[index]);
+                texture.last_request_frame = std::max(texture.last_request_frame, slot.frame_value);
+            }
+            this->latest_feedback_frame = std::max(this->latest_feedback_frame, slot.frame_value);
+            slot.pending = false;
+        }
+    }
+
+    auto TextureStreamer::mip_byte_size(Texture const & texture, u32 mip_level) const -> u32
+    {
+        StreamedTextureInfo const & info = texture.info;
+        u32 const width = std::max(info.size.x >> mip_level, 1u);
+        u32 const height = std::max(info.size.y >> mip_level, 1u);
+        u32 const depth = info.dimensions == 3 ? std::max(info.size.z >> mip_level, 1u) : 1u;
+        u32 const blocks_x = (width + info.block_extent.x - 1) / info.block_extent.x;
+        u32 const blocks_y = (height + info.block_extent.y - 1) / info.block_extent.y;
+        return blocks_x * blocks_y * depth * info.block_byte_size;
+    }
+
+    auto TextureStreamer::image_info_of(Texture const & texture, u32 first_mip) const -> ImageInfo
+    {
+        StreamedTextureInfo const & info = texture.info;
+        return ImageInfo{
+            .dimensions = info.dimensions,
+            .format = info.format,
+            .size = {
+                std::max(info.size.x >> first_mip, 1u),
+                std::max(info.size.y >> first_mip, 1u),
+                info.dimensions == 3 ? std::max(info.size.z >> first_mip, 1u) : info.size.z,
+            },
+            .mip_level_count = info.mip_level_count - first_mip,
+            .usage = ImageUsageFlagBits::SHADER_SAMPLED | ImageUsageFlagBits::TRANSFER_SRC | ImageUsageFlagBits::TRANSFER_DST,
+            // Concurrent sharing lets the updates be recorded for a transfer queue without ownership transfers.
+            .sharing_mode = SharingMode::CONCURRENT,
+            .name = info.name,
+        };
+    }
+
+    auto TextureStreamer::view(u32 texture) const -> StreamedTextureView
+    {
+        Texture const & tex = this->textures[texture];
+        if (tex.image.is_empty())
+        {
+            return {};
+        }
+        return StreamedTextureView{
+            .view = tex.image.default_view(),
+            .first_mip = tex.first_resident_mip,
+            .mip_count = tex.info.mip_level_count - tex.first_resident_mip,
+        };
+    }
+
+    auto TextureStreamer::view_table() const -> BufferId
+    {
+        return this->m_view_table;
+    }
+
+    auto TextureStreamer::feedback_buffer() const -> BufferId
+    {
+        return this->m_feedback_buffer;
+    }
+
+    auto TextureStreamer::resident_memory() const -> u64
+    {
+        return this->m_resident_memory;
+    }
+
+    auto TextureStreamer::timeline_value() const -> usize
+    {
+        return this->staging.timeline_value();
+    }
+
+    auto TextureStreamer::inc_timeline_value() -> usize
+    {
+        return this->staging.inc_timeline_value();
+    }
+
+    auto TextureStreamer::timeline_semaphore() -> TimelineSemaphore const &
+    {
+        return this->staging.timeline_semaphore();
+    }
+
+    auto TextureStreamer::info() const -> TextureStreamerInfo const &
+    {
+        return this->m_info;
+    }
+
+    // Message count and capacity, padded to the first message, see DAXA_SHADER_DEBUG_HEADER_SIZE.
+    static constexpr usize SHADER_DEBUG_HEADER_SIZE = 16;
+    static_assert(sizeof(ShaderDebugMessage) == 32, "ShaderDebugMessage must match DAXA_SHADER_DEBUG_MESSAGE_SIZE");
+
+    ShaderDebugRing::ShaderDebugRing(ShaderDebugRingInfo a_info)
+        : m_info{std::move(a_info)}
+    {
+        DAXA_DBG_ASSERT_TRUE_M(this->m_info.frame_count > 0 && this->m_info.message_capacity > 0, "ShaderDebugRing needs at least one frame and one message per frame");
+        // Shaders only touch the ring when writing a message, device local host visible memory keeps their atomics on the gpu when available.
+        this->ring_buffer = this->m_info.device.create_buffer({
+            .size = this->ring_size(),
+            .allocate_info = MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE | MemoryFlagBits::PREFER_DEVICE_LOCAL_HOST_VISIBLE,
+            .name = this->m_info.name,
+        });
+        this->readback_buffer = this->m_info.device.create_buffer({
+            .size = this->m_info.frame_count * this->ring_size(),
+            .allocate_info = MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = this->m_info.name + " readback",
+        });
+        std::array<u32, 2> const header = {0u, this->m_info.message_capacity};
+        std::memcpy(this->m_info.device.buffer_host_address(this->ring_buffer).value(), header.data(), sizeof(header));
+        this->slots.resize(this->m_info.frame_count);
+        this->m_info.device.set_shader_debug_address(this->m_info.device.buffer_device_address(this->ring_buffer).value());
+    }
+
+    ShaderDebugRing::ShaderDebugRing(ShaderDebugRing && other)
+    {
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->ring_buffer, other.ring_buffer);
+        std::swap(this->readback_buffer, other.readback_buffer);
+        std::swap(this->slots, other.slots);
+        std::swap(this->messages, other.messages);
+        std::swap(this->m_dropped_message_count, other.m_dropped_message_count);
+    }
+
+    // Another ring may have been created after this one, it then stays active.
+    static void release_shader_debug_address(Device & device, BufferId ring_buffer)
+    {
+        if (device.shader_debug_address() == device.buffer_device_address(ring_buffer).value())
+        {
+            device.set_shader_debug_address(0);
+        }
+    }
+
+    auto ShaderDebugRing::operator=(ShaderDebugRing && other) -> ShaderDebugRing &
+    {
+        if (!this->ring_buffer.is_empty())
+        {
+            release_shader_debug_address(this->m_info.device, this->ring_buffer);
+        }
+        for (BufferId const buffer : {this->ring_buffer, this->readback_buffer})
+        {
+            if (!buffer.is_empty())
+            {
+                this->m_info.device.destroy_buffer(buffer);
+            }
+        }
+        this->ring_buffer = {};
+        this->readback_buffer = {};
+        std::swap(this->m_info, other.m_info);
+        std::swap(this->ring_buffer, other.ring_buffer);
+        std::swap(this->readback_buffer, other.readback_buffer);
+        std::swap(this->slots, other.slots);
+        std::swap(this->messages, other.messages);
+        std::swap(this->m_dropped_message_count, other.m_dropped_message_count);
+        return *this;
+    }
+
+    ShaderDebugRing::~ShaderDebugRing()
+    {
+        if (!this->ring_buffer.is_empty())
+        {
+            // Destruction is deferred by the device, shaders of submitted frames may still write into the ring.
+            release_shader_debug_address(this->m_info.device, this->ring_buffer);
+            this->m_info.device.destroy_buffer(this->ring_buffer);
+            this->m_info.device.destroy_buffer(this->readback_buffer);
+        }
+    }
+
+    void ShaderDebugRing::record_readback(CommandRecorder & recorder, u64 frame_value)
+    {
+        this->read_slots();
+        u32 const slot_index = static_cast<u32>(frame_value % this->m_info.frame_count);
+        Slot & slot = this->slots[slot_index];
+        // The gpu may still copy into the slot. The messages stay in the ring and are read back with the next frame instead.
+        if (slot.pending)
+        {
+            return;
+        }
+        slot.frame_value = frame_value;
+        slot.pending = true;
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::READ_WRITE,
+            .dst_access = AccessConsts::TRANSFER_READ_WRITE,
+        });
+        recorder.copy_buffer_to_buffer({
+            .src_buffer = this->ring_buffer,
+            .dst_buffer = this->readback_buffer,
+            .dst_offset = slot_index * this->ring_size(),
+            .size = this->ring_size(),
+        });
+        // Only the count is reset, the capacity stays and stale messages past the count are never read.
+        recorder.clear_buffer({
+            .buffer = this->ring_buffer,
+            .size = sizeof(u32),
+        });
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::TRANSFER_WRITE,
+            .dst_access = AccessConsts::HOST_READ,
+        });
+        recorder.pipeline_barrier({
+            .src_access = AccessConsts::TRANSFER_WRITE,
+            .dst_access = AccessConsts::READ_WRITE,
+        });
+    }
+
+    auto ShaderDebugRing::drain() -> std::vector<ShaderDebugMessage>
+    {
+        this->read_slots();
+        return std::exchange(this->messages, {});
+    }
+
+    auto ShaderDebugRing::dropped_message_count() const -> u64
+    {
+        return this->m_dropped_message_count;
+    }
+
+    auto ShaderDebugRing::buffer() const -> BufferId
+    {
+        return this->ring_buffer;
+    }
+
+    auto ShaderDebugRing::info() const -> ShaderDebugRingInfo const &
+    {
+        return this->m_info;
+    }
+
+    auto ShaderDebugRing::ring_size() const -> usize
+    {
+        return SHADER_DEBUG_HEADER_SIZE + static_cast<usize>(this->m_info.message_capacity) * sizeof(ShaderDebugMessage);
+    }
+
+    void ShaderDebugRing::read_slots()
+    {
+        u64 const finished_frame = this->m_info.frame_timeline.value();
+        std::vector<u32> finished_slots = {};
+        for (u32 slot_index = 0; slot_index < this->slots.size(); ++slot_index)
+        {
+            if (this->slots[slot_index].pending && this->slots[slot_index].frame_value <= finished_frame)
+            {
+                finished_slots.push_back(slot_index);
+            }
+        }
+        std::sort(finished_slots.begin(), finished_slots.end(), [&](u32 a, u32 b)
+                  { return this->slots[a].frame_value < this->slots[b].frame_value; });
+        std::byte const * readback = this->m_info.device.buffer_host_address_as<std::byte>(this->readback_buffer).value();
+        for (u32 const slot_index : finished_slots)
+        {
+            std::byte const * ring = readback + slot_index * this->ring_size();
+            u32 message_count = {};
+            std::memcpy(&message_count, ring, sizeof(u32));
+            u32 const kept_count = std::min(message_count, this->m_info.message_capacity);
+            this->m_dropped_message_count += message_count - kept_count;
+            usize const first = this->messages.size();
+            this->messages.resize(first + kept_count);
+            std::memcpy(this->messages.data() + first, ring + SHADER_DEBUG_HEADER_SIZE, kept_count * sizeof(ShaderDebugMessage));
+            this->slots[slot_index].pending = false;
+        }
+    }
 } // namespace daxa
 
 #endif
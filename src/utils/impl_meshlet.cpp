@@ -0,0 +1,250 @@
+#if DAXA_BUILT_WITH_UTILS_MEM
+
+#include <daxa/utils/meshlet.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace daxa
+{
+    namespace
+    {
+        auto meshlet_sub(daxa_f32vec3 a, daxa_f32vec3 b) -> daxa_f32vec3
+        {
+            return {a.x - b.x, a.y - b.y, a.z - b.z};
+        }
+
+        auto meshlet_dot(daxa_f32vec3 a, daxa_f32vec3 b) -> f32
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
+        auto meshlet_cross(daxa_f32vec3 a, daxa_f32vec3 b) -> daxa_f32vec3
+        {
+            return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        }
+
+        auto align_meshlet_array(usize offset) -> usize
+        {
+            return (offset + 15) & ~usize{15};
+        }
+
+        auto compute_meshlet_bounds(MeshletBuildResult const & result, daxa_Meshlet const & meshlet, std::span<daxa_f32vec3 const> positions) -> daxa_MeshletBounds
+        {
+            daxa_MeshletBounds bounds = {};
+            daxa_f32vec3 min = positions[result.vertices[meshlet.vertex_offset]];
+            daxa_f32vec3 max = min;
+            for (u32 i = 1; i < meshlet.vertex_count; ++i)
+            {
+                daxa_f32vec3 const p = positions[result.vertices[meshlet.vertex_offset + i]];
+                min = {std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z)};
+                max = {std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z)};
+            }
+            bounds.center = {(min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f};
+            for (u32 i = 0; i < meshlet.vertex_count; ++i)
+            {
+                daxa_f32vec3 const offset = meshlet_sub(positions[result.vertices[meshlet.vertex_offset + i]], bounds.center);
+                bounds.radius = std::max(bounds.radius, std::sqrt(meshlet_dot(offset, offset)));
+            }
+
+            // The cone axis is the average triangle normal, the cutoff the sine of the largest angle between a normal and the axis.
+            std::array<daxa_f32vec3, DAXA_MESHLET_MAX_TRIANGLES> normals = {};
+            u32 normal_count = 0;
+            daxa_f32vec3 axis = {};
+            for (u32 t = 0; t < meshlet.triangle_count; ++t)
+            {
+                u32 const packed = result.triangles[meshlet.triangle_offset + t];
+                daxa_f32vec3 const p0 = positions[result.vertices[meshlet.vertex_offset + (packed & 0xFF)]];
+                daxa_f32vec3 const p1 = positions[result.vertices[meshlet.vertex_offset + ((packed >> 8) & 0xFF)]];
+                daxa_f32vec3 const p2 = positions[result.vertices[meshlet.vertex_offset + ((packed >> 16) & 0xFF)]];
+                daxa_f32vec3 const normal = meshlet_cross(meshlet_sub(p1, p0), meshlet_sub(p2, p0));
+                f32 const length = std::sqrt(meshlet_dot(normal, normal));
+                // Degenerate triangles are never rasterized, they do not widen the cone.
+                if (length == 0.0f)
+                {
+                    continue;
+                }
+                normals[normal_count] = {normal.x / length, normal.y / length, normal.z / length};
+                axis = {axis.x + normals[normal_count].x, axis.y + normals[normal_count].y, axis.z + normals[normal_count].z};
+                ++normal_count;
+            }
+            f32 const axis_length = std::sqrt(meshlet_dot(axis, axis));
+            bounds.cone_cutoff = 1.0f;
+            if (normal_count == 0 || axis_length == 0.0f)
+            {
+                return bounds;
+            }
+            bounds.cone_axis = {axis.x / axis_length, axis.y / axis_length, axis.z / axis_length};
+            f32 min_dot = 1.0f;
+            for (u32 i = 0; i < normal_count; ++i)
+            {
+                min_dot = std::min(min_dot, meshlet_dot(normals[i], bounds.cone_axis));
+            }
+            // Normals spread over more than a hemisphere, some triangle always faces the camera.
+            if (min_dot > 0.0f)
+            {
+                bounds.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+            }
+            return bounds;
+        }
+
+        void build_meshlet_job(MeshletBuildInfo const & info, u32 first_triangle, u32 triangle_count, MeshletBuildResult & result)
+        {
+            daxa_Meshlet meshlet = {};
+            auto finish_meshlet = [&]()
+            {
+                if (meshlet.triangle_count == 0)
+                {
+                    return;
+                }
+                result.meshlets.push_back(meshlet);
+                result.bounds.push_back(compute_meshlet_bounds(result, meshlet, info.positions));
+                meshlet = {
+                    .vertex_offset = static_cast<u32>(result.vertices.size()),
+                    .triangle_offset = static_cast<u32>(result.triangles.size()),
+                };
+            };
+            for (u32 triangle = first_triangle; triangle < first_triangle + triangle_count; ++triangle)
+            {
+                std::array<u32, 3> local_indices = {~0u, ~0u, ~0u};
+                u32 new_vertex_count = 0;
+                for (u32 corner = 0; corner < 3; ++corner)
+                {
+                    u32 const vertex = info.indices[triangle * 3 + corner];
+                    // Meshlets hold at most DAXA_MESHLET_MAX_VERTICES vertices, a linear search is cheaper than a lookup table.
+                    for (u32 i = 0; i < meshlet.vertex_count; ++i)
+                    {
+                        if (result.vertices[meshlet.vertex_offset + i] == vertex)
+                        {
+                            local_indices[corner] = i;
+                            break;
+                        }
+                    }
+                    bool const repeated = (corner > 0 && vertex == info.indices[triangle * 3]) || (corner > 1 && vertex == info.indices[triangle * 3 + 1]);
+                    new_vertex_count += (local_indices[corner] == ~0u && !repeated) ? 1 : 0;
+                }
+                if (meshlet.vertex_count + new_vertex_count > info.max_vertices || meshlet.triangle_count + 1 > info.max_triangles)
+                {
+                    finish_meshlet();
+                    local_indices = {~0u, ~0u, ~0u};
+                }
+                u32 packed = 0;
+                for (u32 corner = 0; corner < 3; ++corner)
+                {
+                    u32 const vertex = info.indices[triangle * 3 + corner];
+                    if (local_indices[corner] == ~0u)
+                    {
+                        for (u32 i = 0; i < meshlet.vertex_count; ++i)
+                        {
+                            if (result.vertices[meshlet.vertex_offset + i] == vertex)
+                            {
+                                local_indices[corner] = i;
+                                break;
+                            }
+                        }
+                    }
+                    if (local_indices[corner] == ~0u)
+                    {
+                        local_indices[corner] = meshlet.vertex_count++;
+                        result.vertices.push_back(vertex);
+                    }
+                    packed |= local_indices[corner] << (corner * 8);
+                }
+                result.triangles.push_back(packed);
+                meshlet.triangle_count += 1;
+            }
+            finish_meshlet();
+        }
+    } // namespace
+
+    auto build_meshlets(MeshletBuildInfo const & info) -> MeshletBuildResult
+    {
+        DAXA_DBG_ASSERT_TRUE_M(info.max_vertices >= 3 && info.max_vertices <= DAXA_MESHLET_MAX_VERTICES, "max_vertices must be in [3, DAXA_MESHLET_MAX_VERTICES]");
+        DAXA_DBG_ASSERT_TRUE_M(info.max_triangles >= 1 && info.max_triangles <= DAXA_MESHLET_MAX_TRIANGLES, "max_triangles must be in [1, DAXA_MESHLET_MAX_TRIANGLES]");
+        u32 const triangle_count = static_cast<u32>(info.indices.size() / 3);
+        u32 const triangles_per_job = std::max(info.triangles_per_job, 1u);
+        u32 const job_count = (triangle_count + triangles_per_job - 1) / triangles_per_job;
+        std::vector<MeshletBuildResult> job_results(job_count);
+
+        std::atomic<u32> next_job = 0;
+        auto worker = [&]()
+        {
+            for (u32 job = next_job.fetch_add(1, std::memory_order_relaxed); job < job_count; job = next_job.fetch_add(1, std::memory_order_relaxed))
+            {
+                u32 const first_triangle = job * triangles_per_job;
+                build_meshlet_job(info, first_triangle, std::min(triangles_per_job, triangle_count - first_triangle), job_results[job]);
+            }
+        };
+        u32 const max_thread_count = info.thread_count != 0 ? info.thread_count : std::max(1u, std::thread::hardware_concurrency());
+        u32 const thread_count = std::min(job_count, max_thread_count);
+        std::vector<std::thread> threads = {};
+        threads.reserve(thread_count > 0 ? thread_count - 1 : 0);
+        for (u32 t = 1; t < thread_count; ++t)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+
+        // Jobs build with offsets into their own arrays, they are rebased while concatenating.
+        MeshletBuildResult result = {};
+        for (MeshletBuildResult const & job_result : job_results)
+        {
+            u32 const vertex_base = static_cast<u32>(result.vertices.size());
+            u32 const triangle_base = static_cast<u32>(result.triangles.size());
+            for (daxa_Meshlet meshlet : job_result.meshlets)
+            {
+                meshlet.vertex_offset += vertex_base;
+                meshlet.triangle_offset += triangle_base;
+                result.meshlets.push_back(meshlet);
+            }
+            result.bounds.insert(result.bounds.end(), job_result.bounds.begin(), job_result.bounds.end());
+            result.vertices.insert(result.vertices.end(), job_result.vertices.begin(), job_result.vertices.end());
+            result.triangles.insert(result.triangles.end(), job_result.triangles.begin(), job_result.triangles.end());
+        }
+        return result;
+    }
+
+    auto MeshletBuildResult::byte_size() const -> usize
+    {
+        usize size = 0;
+        size = align_meshlet_array(size) + this->meshlets.size() * sizeof(daxa_Meshlet);
+        size = align_meshlet_array(size) + this->bounds.size() * sizeof(daxa_MeshletBounds);
+        size = align_meshlet_array(size) + this->vertices.size() * sizeof(u32);
+        size = align_meshlet_array(size) + this->triangles.size() * sizeof(u32);
+        return size;
+    }
+
+    auto MeshletBuildResult::write(std::span<std::byte> dst, DeviceAddress device_address) const -> daxa_MeshletMesh
+    {
+        DAXA_DBG_ASSERT_TRUE_M(dst.size() >= this->byte_size(), "dst is smaller than MeshletBuildResult::byte_size");
+        usize offset = 0;
+        auto write_array = [&](void const * data, usize size) -> DeviceAddress
+        {
+            offset = align_meshlet_array(offset);
+            if (size > 0)
+            {
+                std::memcpy(dst.data() + offset, data, size);
+            }
+            DeviceAddress const address = device_address + offset;
+            offset += size;
+            return address;
+        };
+        return daxa_MeshletMesh{
+            .meshlets = write_array(this->meshlets.data(), this->meshlets.size() * sizeof(daxa_Meshlet)),
+            .bounds = write_array(this->bounds.data(), this->bounds.size() * sizeof(daxa_MeshletBounds)),
+            .vertices = write_array(this->vertices.data(), this->vertices.size() * sizeof(u32)),
+            .triangles = write_array(this->triangles.data(), this->triangles.size() * sizeof(u32)),
+            .meshlet_count = static_cast<u32>(this->meshlets.size()),
+        };
+    }
+} // namespace daxa
+
+#endif
@@ -1,7 +1,8 @@
-#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG || DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+#if (DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG || DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG) && !DAXA_COMPILE_PIPELINE_BUNDLE
 #include "daxa/utils/pipeline_manager.hpp"
 
 #include "../impl_core.hpp"
+#include "../impl_profiling.hpp"
 #include "impl_pipeline_manager.hpp"
 
 #include <tuple>
@@ -127,7 +128,9 @@ static constexpr TBuiltInResource DAXA_DEFAULT_BUILTIN_RESOURCE = {
 
 // #include <re2/re2.h>
 #include <thread>
+#include <atomic>
 #include <utility>
+#include <type_traits>
 #include <sstream>
 #include <iostream>
 #include <string>
@@ -135,6 +138,18 @@ static constexpr TBuiltInResource DAXA_DEFAULT_BUILTIN_RESOURCE = {
 // for std::hash<std::string>
 #include <unordered_map>
 
+#include <deque>
+#include <cstring>
+#include <bit>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // static auto const PRAGMA_ONCE_REGEX = RE2(R"regex(\s*#\s*pragma\s+once\s*)regex");
 static void shader_preprocess(std::string & file_str, std::filesystem::path const & path)
 {
@@ -196,15 +211,16 @@ namespace daxa
         constexpr static inline usize MAX_INCLUSION_DEPTH = 100;
 
         ImplPipelineManager * impl_pipeline_manager = nullptr;
+        ShaderCompileContext * context = nullptr;
 
         [[nodiscard]] auto process_include(daxa::Result<daxa::ShaderCode> const & shader_code_result, std::filesystem::path const & full_path) const -> IncludeResult *
         {
             auto search_pred = [&](std::filesystem::path const & p)
             { return p == full_path; };
             if (std::find_if(
-                    impl_pipeline_manager->current_seen_shader_files.begin(),
-                    impl_pipeline_manager->current_seen_shader_files.end(),
-                    search_pred) != impl_pipeline_manager->current_seen_shader_files.end())
+                    context->seen_shader_files.begin(),
+                    context->seen_shader_files.end(),
+                    search_pred) != context->seen_shader_files.end())
             {
                 return nullptr;
             }
@@ -212,7 +228,7 @@ namespace daxa
             {
                 return nullptr;
             }
-            impl_pipeline_manager->current_observed_hotload_files->insert({full_path, std::chrono::file_clock::now()});
+            context->observed_hotload_files->insert({full_path, std::chrono::file_clock::now()});
 
             std::string headerName = {};
             char const * headerData = nullptr;
@@ -252,13 +268,13 @@ namespace daxa
             {
                 return process_include(Result{ShaderCode{impl_pipeline_manager->virtual_files.at(header_name_str).contents}}, header_name_str);
             }
-            auto result = impl_pipeline_manager->full_path_to_file(includer_name);
+            auto result = impl_pipeline_manager->full_path_to_file(includer_name, context->shader_info);
             if (result.is_err())
             {
                 return nullptr;
             }
             auto full_path = result.value().parent_path() / header_name;
-            auto shader_code_result = impl_pipeline_manager->load_shader_source_from_file(full_path);
+            auto shader_code_result = impl_pipeline_manager->load_shader_source_from_file(*context, full_path);
             return process_include(shader_code_result, full_path);
         }
 
@@ -274,13 +290,13 @@ namespace daxa
             {
                 return process_include(Result{ShaderCode{impl_pipeline_manager->virtual_files.at(header_name_str).contents}}, header_name_str);
             }
-            auto result = impl_pipeline_manager->full_path_to_file(header_name);
+            auto result = impl_pipeline_manager->full_path_to_file(header_name, context->shader_info);
             if (result.is_err())
             {
                 return nullptr;
             }
             auto full_path = result.value();
-            auto shader_code_result = impl_pipeline_manager->load_shader_source_from_file(full_path);
+            auto shader_code_result = impl_pipeline_manager->load_shader_source_from_file(*context, full_path);
             return process_include(shader_code_result, full_path);
         }
 
@@ -358,6 +374,23 @@ namespace daxa
         {
             this->required_subgroup_size = other.required_subgroup_size;
         }
+        if (!this->optimization.has_value())
+        {
+            this->optimization = other.optimization;
+        }
+        if (!this->strip_debug_info.has_value())
+        {
+            this->strip_debug_info = other.strip_debug_info;
+        }
+        for (auto const & constant : other.specialization_constants)
+        {
+            bool const overridden = std::ranges::any_of(this->specialization_constants, [&](SpecializationConstant const & own)
+                                                        { return own.constant_id == constant.constant_id; });
+            if (!overridden)
+            {
+                this->specialization_constants.push_back(constant);
+            }
+        }
 
         this->root_paths.insert(this->root_paths.begin(), other.root_paths.begin(), other.root_paths.end());
         this->defines.insert(this->defines.end(), other.defines.begin(), other.defines.end());
@@ -386,6 +419,36 @@ namespace daxa
         return impl.add_raster_pipeline(info);
     }
 
+    auto PipelineManager::add_shader_object(ShaderObjectCompileInfo const & info) -> Result<std::shared_ptr<ShaderObject>>
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.add_shader_object(info);
+    }
+
+    auto PipelineManager::add_ray_tracing_pipelines(std::span<RayTracingPipelineCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<RayTracingPipeline>>>
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.add_ray_tracing_pipelines(infos);
+    }
+
+    auto PipelineManager::add_compute_pipelines(std::span<ComputePipelineCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<ComputePipeline>>>
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.add_compute_pipelines(infos);
+    }
+
+    auto PipelineManager::add_raster_pipelines(std::span<RasterPipelineCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<RasterPipeline>>>
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.add_raster_pipelines(infos);
+    }
+
+    auto PipelineManager::add_shader_objects(std::span<ShaderObjectCompileInfo const> infos) -> std::vector<Result<std::shared_ptr<ShaderObject>>>
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.add_shader_objects(infos);
+    }
+
     void PipelineManager::remove_compute_pipeline(std::shared_ptr<ComputePipeline> const & pipeline)
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
@@ -404,6 +467,12 @@ namespace daxa
         return impl.remove_raster_pipeline(pipeline);
     }
 
+    void PipelineManager::remove_shader_object(std::shared_ptr<ShaderObject> const & shader_object)
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.remove_shader_object(shader_object);
+    }
+
     void PipelineManager::add_virtual_file(VirtualFileInfo const & virtual_info)
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
@@ -416,14 +485,34 @@ namespace daxa
         return impl.reload_all();
     }
 
+    auto PipelineManager::reload_all_async() -> bool
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.reload_all_async();
+    }
+
+    auto PipelineManager::poll_reload() -> PipelineReloadResult
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.poll_reload();
+    }
+
     auto PipelineManager::all_pipelines_valid() const -> bool
     {
         auto const & impl = *r_cast<ImplPipelineManager *>(this->object);
         return impl.all_pipelines_valid();
     }
 
+    auto PipelineManager::write_pipeline_bundle(PipelineBundleInfo const & bundle_info, std::filesystem::path const & path) -> Result<void>
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.write_pipeline_bundle(bundle_info, path);
+    }
+
     static std::mutex glslang_init_mtx;
     static i32 pipeline_manager_count = 0;
+    // Derived from the device features, not from the shader infos.
+    static constexpr std::string_view COOPERATIVE_MATRIX_DEFINE = "DAXA_COOPERATIVE_MATRIX";
 
     ImplPipelineManager::ImplPipelineManager(PipelineManagerInfo && a_info)
         : info{std::move(a_info)}
@@ -440,6 +529,12 @@ namespace daxa
         {
             this->info.shader_compile_options.enable_debug_info = {false};
         }
+        // The define is part of the compile options, so cached spirv of devices with and without the feature never mix.
+        if (this->info.device.is_valid() && (this->info.device.info().explicit_features & ExplicitFeatureFlagBits::COOPERATIVE_MATRIX) != ExplicitFeatureFlagBits::NONE)
+        {
+            this->cooperative_matrix = true;
+            this->info.shader_compile_options.defines.push_back({std::string{COOPERATIVE_MATRIX_DEFINE}, "1"});
+        }
 
         {
             auto lock = std::lock_guard{glslang_init_mtx};
@@ -449,15 +544,20 @@ namespace daxa
                 glslang::InitializeProcess();
 #endif
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
-                auto ret = slang::createGlobalSession(slang_backend.global_session.writeRef());
+                SlangBackend::release_global_session(SlangBackend::acquire_global_session());
 #endif
             }
             ++pipeline_manager_count;
         }
+        if (this->info.pipeline_bundle.has_value())
+        {
+            load_pipeline_bundle(this->info.pipeline_bundle.value());
+        }
     }
 
     ImplPipelineManager::~ImplPipelineManager()
     {
+        wait_for_async_reload();
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
         {
             auto lock = std::lock_guard{glslang_init_mtx};
@@ -483,10 +583,8 @@ namespace daxa
         auto pipe_result = RayTracingPipelineState{
             .pipeline_ptr = std::make_shared<RayTracingPipeline>(),
             .info = a_info,
-            .last_hotload_time = std::chrono::file_clock::now(),
             .observed_hotload_files = {},
         };
-        this->current_observed_hotload_files = &pipe_result.observed_hotload_files;
         auto ray_tracing_pipeline_info = RayTracingPipelineInfo{
             .ray_gen_shaders = {},
             .intersection_shaders = {},
@@ -525,7 +623,7 @@ namespace daxa
         {
             for (auto & shader_compile_info : *pipe_result_shader_info)
             {
-                auto spv_result = get_spirv(shader_compile_info, pipe_result.info.name, stage);
+                auto spv_result = get_spirv(shader_compile_info, pipe_result.info.name, stage, pipe_result.observed_hotload_files);
                 if (spv_result.is_err())
                 {
                     if (this->info.register_null_pipelines_when_first_compile_fails)
@@ -548,6 +646,10 @@ namespace daxa
                         shader_compile_info.compile_options.required_subgroup_size.has_value() ? 
                         Optional{shader_compile_info.compile_options.required_subgroup_size.value()} : 
                         daxa::None,
+                    .specialization_constants = {
+                        shader_compile_info.compile_options.specialization_constants.data(),
+                        shader_compile_info.compile_options.specialization_constants.size(),
+                    },
                 });
                 if (shader_compile_info.compile_options.entry_point.has_value() && (shader_compile_info.compile_options.language != ShaderLanguage::SLANG))
                 {
@@ -580,11 +682,9 @@ namespace daxa
         auto pipe_result = ComputePipelineState{
             .pipeline_ptr = std::make_shared<ComputePipeline>(),
             .info = a_info,
-            .last_hotload_time = std::chrono::file_clock::now(),
             .observed_hotload_files = {},
         };
-        this->current_observed_hotload_files = &pipe_result.observed_hotload_files;
-        auto spirv_result = get_spirv(pipe_result.info.shader_info, pipe_result.info.name, ShaderStage::COMP);
+        auto spirv_result = get_spirv(pipe_result.info.shader_info, pipe_result.info.name, ShaderStage::COMP, pipe_result.observed_hotload_files);
         if (spirv_result.is_err())
         {
             if (this->info.register_null_pipelines_when_first_compile_fails)
@@ -613,6 +713,10 @@ namespace daxa
                     Optional{a_info.shader_info.compile_options.required_subgroup_size.value()} : 
                     daxa::None,
                 .entry_point = entry_point,
+                .specialization_constants = {
+                    a_info.shader_info.compile_options.specialization_constants.data(),
+                    a_info.shader_info.compile_options.specialization_constants.size(),
+                },
             },
             .push_constant_size = a_info.push_constant_size,
             .name = a_info.name.c_str(),
@@ -620,6 +724,78 @@ namespace daxa
         return Result<ComputePipelineState>(std::move(pipe_result));
     }
 
+    static auto shader_object_shader_stage(ShaderObjectStage stage) -> ImplPipelineManager::ShaderStage
+    {
+        switch (stage)
+        {
+        case ShaderObjectStage::VERTEX: return ImplPipelineManager::ShaderStage::VERT;
+        case ShaderObjectStage::TESSELLATION_CONTROL: return ImplPipelineManager::ShaderStage::TESS_CONTROL;
+        case ShaderObjectStage::TESSELLATION_EVALUATION: return ImplPipelineManager::ShaderStage::TESS_EVAL;
+        case ShaderObjectStage::FRAGMENT: return ImplPipelineManager::ShaderStage::FRAG;
+        case ShaderObjectStage::TASK: return ImplPipelineManager::ShaderStage::TASK;
+        case ShaderObjectStage::MESH: return ImplPipelineManager::ShaderStage::MESH;
+        default: return ImplPipelineManager::ShaderStage::COMP;
+        }
+    }
+
+    auto ImplPipelineManager::create_shader_object(ShaderObjectCompileInfo const & a_info) -> Result<ShaderObjectState>
+    {
+        if (a_info.push_constant_size > MAX_PUSH_CONSTANT_BYTE_SIZE)
+        {
+            return Result<ShaderObjectState>(std::string("push constant size of ") + std::to_string(a_info.push_constant_size) + std::string(" exceeds the maximum size of ") + std::to_string(MAX_PUSH_CONSTANT_BYTE_SIZE));
+        }
+        if (a_info.push_constant_size % 4 != 0)
+        {
+            return Result<ShaderObjectState>(std::string("push constant size of ") + std::to_string(a_info.push_constant_size) + std::string(" is not a multiple of 4(bytes)"));
+        }
+        auto const shader_stage = shader_object_shader_stage(a_info.stage);
+        auto pipe_result = ShaderObjectState{
+            .pipeline_ptr = std::make_shared<ShaderObject>(),
+            .info = a_info,
+            .observed_hotload_files = {},
+        };
+        auto spirv_result = get_spirv(pipe_result.info.shader_info, pipe_result.info.name, shader_stage, pipe_result.observed_hotload_files);
+        if (spirv_result.is_err())
+        {
+            if (this->info.register_null_pipelines_when_first_compile_fails)
+            {
+                auto result = Result<ShaderObjectState>(pipe_result);
+                result.m = spirv_result.message();
+                return result;
+            }
+            else
+            {
+                return Result<ShaderObjectState>(spirv_result.message());
+            }
+        }
+        char const * entry_point = "main";
+        if (a_info.shader_info.compile_options.entry_point.has_value() && a_info.shader_info.compile_options.language != ShaderLanguage::SLANG)
+        {
+            entry_point = a_info.shader_info.compile_options.entry_point.value().c_str();
+        }
+        (*pipe_result.pipeline_ptr) = this->info.device.create_shader_object({
+            .shader_info = {
+                .byte_code = spirv_result.value().data(),
+                .byte_code_size = static_cast<u32>(spirv_result.value().size()),
+                .create_flags = a_info.shader_info.compile_options.create_flags.value_or(ShaderCreateFlagBits::NONE),
+                .required_subgroup_size =
+                    a_info.shader_info.compile_options.required_subgroup_size.has_value() ?
+                    Optional{a_info.shader_info.compile_options.required_subgroup_size.value()} :
+                    daxa::None,
+                .entry_point = entry_point,
+                .specialization_constants = {
+                    a_info.shader_info.compile_options.specialization_constants.data(),
+                    a_info.shader_info.compile_options.specialization_constants.size(),
+                },
+            },
+            .stage = a_info.stage,
+            .push_constant_size = a_info.push_constant_size,
+            .no_task_shader = a_info.no_task_shader,
+            .name = a_info.name.c_str(),
+        });
+        return Result<ShaderObjectState>(std::move(pipe_result));
+    }
+
     auto ImplPipelineManager::create_raster_pipeline(RasterPipelineCompileInfo const & a_info) -> Result<RasterPipelineState>
     {
         if (a_info.push_constant_size > MAX_PUSH_CONSTANT_BYTE_SIZE)
@@ -633,10 +809,8 @@ namespace daxa
         auto pipe_result = RasterPipelineState{
             .pipeline_ptr = std::make_shared<RasterPipeline>(),
             .info = a_info,
-            .last_hotload_time = std::chrono::file_clock::now(),
             .observed_hotload_files = {},
         };
-        this->current_observed_hotload_files = &pipe_result.observed_hotload_files;
         auto raster_pipeline_info = RasterPipelineInfo{
             .color_attachments = {a_info.color_attachments.data(), a_info.color_attachments.size()},
             .depth_test = a_info.depth_test,
@@ -644,6 +818,7 @@ namespace daxa
             .raster = a_info.raster,
             .push_constant_size = a_info.push_constant_size,
             .name = a_info.name,
+            .link_mode = a_info.link_mode,
         };
         auto vertex_spirv_result = daxa::Result<std::vector<unsigned int>>("useless string");
         auto fragment_spirv_result = daxa::Result<std::vector<unsigned int>>("useless string");
@@ -664,7 +839,7 @@ namespace daxa
         {
             if (pipe_result_shader_info->has_value())
             {
-                *spv_result = get_spirv(pipe_result_shader_info->value(), pipe_result.info.name, stage);
+                *spv_result = get_spirv(pipe_result_shader_info->value(), pipe_result.info.name, stage, pipe_result.observed_hotload_files);
                 if (spv_result->is_err())
                 {
                     if (this->info.register_null_pipelines_when_first_compile_fails)
@@ -686,6 +861,10 @@ namespace daxa
                         pipe_result_shader_info->value().compile_options.required_subgroup_size.has_value() ? 
                         Optional{pipe_result_shader_info->value().compile_options.required_subgroup_size.value()} : 
                         daxa::None,
+                    .specialization_constants = {
+                        pipe_result_shader_info->value().compile_options.specialization_constants.data(),
+                        pipe_result_shader_info->value().compile_options.specialization_constants.size(),
+                    },
                 };
                 if (pipe_result_shader_info->value().compile_options.language != ShaderLanguage::SLANG)
                 {
@@ -697,110 +876,142 @@ namespace daxa
         return Result<RasterPipelineState>(std::move(pipe_result));
     }
 
-    auto ImplPipelineManager::add_ray_tracing_pipeline(RayTracingPipelineCompileInfo const & a_info) -> Result<std::shared_ptr<RayTracingPipeline>>
+    static void prepare_compile_info(RayTracingPipelineCompileInfo & info, ShaderCompileOptions const & manager_options)
     {
-        // DAXA_DBG_ASSERT_TRUE_M(!daxa::holds_alternative<daxa::Monostate>(a_info.shader_info.source), "must provide shader source");
-        auto modified_info = a_info;
-        for (auto & shader_compile_info : modified_info.ray_gen_infos)
-        {
-            shader_compile_info.compile_options.inherit(this->info.shader_compile_options);
-        }
-        for (auto & shader_compile_info : modified_info.intersection_infos)
-        {
-            shader_compile_info.compile_options.inherit(this->info.shader_compile_options);
-        }
-        for (auto & shader_compile_info : modified_info.any_hit_infos)
-        {
-            shader_compile_info.compile_options.inherit(this->info.shader_compile_options);
-        }
-        for (auto & shader_compile_info : modified_info.callable_infos)
-        {
-            shader_compile_info.compile_options.inherit(this->info.shader_compile_options);
-        }
-        for (auto & shader_compile_info : modified_info.closest_hit_infos)
-        {
-            shader_compile_info.compile_options.inherit(this->info.shader_compile_options);
-        }
-        for (auto & shader_compile_info : modified_info.miss_hit_infos)
-        {
-            shader_compile_info.compile_options.inherit(this->info.shader_compile_options);
-        }
-
-        auto pipe_result = create_ray_tracing_pipeline(modified_info);
-        if (pipe_result.is_err())
-        {
-            return Result<std::shared_ptr<RayTracingPipeline>>(pipe_result.m);
-        }
-        this->ray_tracing_pipelines.push_back(pipe_result.value());
-        if (this->info.register_null_pipelines_when_first_compile_fails)
-        {
-            auto result = Result<std::shared_ptr<RayTracingPipeline>>(std::move(pipe_result.value().pipeline_ptr));
-            result.m = std::move(pipe_result.m);
-            return result;
-        }
-        else
+        auto const shader_compile_info_lists = std::array<std::vector<ShaderCompileInfo> *, 6>{
+            &info.ray_gen_infos,
+            &info.intersection_infos,
+            &info.any_hit_infos,
+            &info.callable_infos,
+            &info.closest_hit_infos,
+            &info.miss_hit_infos,
+        };
+        for (auto * shader_compile_infos : shader_compile_info_lists)
         {
-            return Result<std::shared_ptr<RayTracingPipeline>>(std::move(pipe_result.value().pipeline_ptr));
+            for (auto & shader_compile_info : *shader_compile_infos)
+            {
+                shader_compile_info.compile_options.inherit(manager_options);
+            }
         }
     }
 
-    auto ImplPipelineManager::add_compute_pipeline(ComputePipelineCompileInfo const & a_info) -> Result<std::shared_ptr<ComputePipeline>>
+    static void prepare_compile_info(ComputePipelineCompileInfo & info, ShaderCompileOptions const & manager_options)
     {
-        DAXA_DBG_ASSERT_TRUE_M(!daxa::holds_alternative<daxa::Monostate>(a_info.shader_info.source), "must provide shader source");
-        auto modified_info = a_info;
-        modified_info.shader_info.compile_options.inherit(this->info.shader_compile_options);
-        auto pipe_result = create_compute_pipeline(modified_info);
-        if (pipe_result.is_err())
-        {
-            return Result<std::shared_ptr<ComputePipeline>>(pipe_result.m);
-        }
-        this->compute_pipelines.push_back(pipe_result.value());
-        if (this->info.register_null_pipelines_when_first_compile_fails)
-        {
-            auto result = Result<std::shared_ptr<ComputePipeline>>(std::move(pipe_result.value().pipeline_ptr));
-            result.m = std::move(pipe_result.m);
-            return result;
-        }
-        else
-        {
-            return Result<std::shared_ptr<ComputePipeline>>(std::move(pipe_result.value().pipeline_ptr));
-        }
+        DAXA_DBG_ASSERT_TRUE_M(!daxa::holds_alternative<daxa::Monostate>(info.shader_info.source), "must provide shader source");
+        info.shader_info.compile_options.inherit(manager_options);
     }
 
-    auto ImplPipelineManager::add_raster_pipeline(RasterPipelineCompileInfo const & a_info) -> Result<std::shared_ptr<RasterPipeline>>
+    static void prepare_compile_info(RasterPipelineCompileInfo & info, ShaderCompileOptions const & manager_options)
     {
-        auto modified_info = a_info;
-        auto const modified_shader_compile_infos = std::array<Optional<ShaderCompileInfo> *, 6>{
-            &modified_info.vertex_shader_info,
-            &modified_info.tesselation_control_shader_info,
-            &modified_info.tesselation_evaluation_shader_info,
-            &modified_info.fragment_shader_info,
-            &modified_info.mesh_shader_info,
-            &modified_info.task_shader_info,
+        auto const shader_compile_infos = std::array<Optional<ShaderCompileInfo> *, 6>{
+            &info.vertex_shader_info,
+            &info.tesselation_control_shader_info,
+            &info.tesselation_evaluation_shader_info,
+            &info.fragment_shader_info,
+            &info.mesh_shader_info,
+            &info.task_shader_info,
         };
-        for (auto * shader_compile_info : modified_shader_compile_infos)
+        for (auto * shader_compile_info : shader_compile_infos)
         {
             if (shader_compile_info->has_value())
             {
-                shader_compile_info->value().compile_options.inherit(this->info.shader_compile_options);
+                shader_compile_info->value().compile_options.inherit(manager_options);
             }
         }
-        auto pipe_result = create_raster_pipeline(modified_info);
-        if (pipe_result.is_err())
-        {
-            return Result<std::shared_ptr<RasterPipeline>>(pipe_result.m);
-        }
-        this->raster_pipelines.push_back(pipe_result.value());
-        if (this->info.register_null_pipelines_when_first_compile_fails)
+    }
+
+    static void prepare_compile_info(ShaderObjectCompileInfo & info, ShaderCompileOptions const & manager_options)
+    {
+        DAXA_DBG_ASSERT_TRUE_M(!daxa::holds_alternative<daxa::Monostate>(info.shader_info.source), "must provide shader source");
+        info.shader_info.compile_options.inherit(manager_options);
+    }
+
+    // Compiles all infos on the compile threads, then registers the results in input order.
+    template <typename StateT, typename CreateFnT>
+    static auto add_pipelines(ImplPipelineManager & self, std::span<typename StateT::CompileInfo const> a_infos, std::vector<StateT> & states, CreateFnT && create_fn)
+        -> std::vector<Result<std::shared_ptr<typename StateT::Pipeline>>>
+    {
+        using PipeT = typename StateT::Pipeline;
+        self.begin_dependency_content_hashing();
+        auto modified_infos = std::vector<typename StateT::CompileInfo>(a_infos.begin(), a_infos.end());
+        for (auto & modified_info : modified_infos)
         {
-            auto result = Result<std::shared_ptr<RasterPipeline>>(std::move(pipe_result.value().pipeline_ptr));
-            result.m = std::move(pipe_result.m);
-            return result;
+            prepare_compile_info(modified_info, self.info.shader_compile_options);
+            if constexpr (std::is_same_v<typename StateT::CompileInfo, ComputePipelineCompileInfo>)
+            {
+                self.request_slang_entry_point(modified_info.shader_info, ImplPipelineManager::ShaderStage::COMP);
+            }
         }
-        else
+        auto pipe_results = std::vector<std::optional<Result<StateT>>>(modified_infos.size());
+        self.run_compile_jobs(
+            modified_infos.size(),
+            [&](usize i)
+            { pipe_results[i].emplace(create_fn(modified_infos[i])); });
+        self.end_slang_batch();
+
+        auto results = std::vector<Result<std::shared_ptr<PipeT>>>{};
+        results.reserve(pipe_results.size());
+        for (auto & pipe_result : pipe_results)
         {
-            return Result<std::shared_ptr<RasterPipeline>>(std::move(pipe_result.value().pipeline_ptr));
+            if (pipe_result->is_err())
+            {
+                results.push_back(Result<std::shared_ptr<PipeT>>(pipe_result->m));
+                continue;
+            }
+            states.push_back(pipe_result->value());
+            self.add_hotload_dependencies(states.back().pipeline_ptr.get(), states.back().observed_hotload_files);
+            auto result = Result<std::shared_ptr<PipeT>>(std::move(pipe_result->value().pipeline_ptr));
+            if (self.info.register_null_pipelines_when_first_compile_fails)
+            {
+                result.m = std::move(pipe_result->m);
+            }
+            results.push_back(std::move(result));
         }
+        return results;
+    }
+
+    auto ImplPipelineManager::add_ray_tracing_pipelines(std::span<RayTracingPipelineCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<RayTracingPipeline>>>
+    {
+        return add_pipelines(*this, a_infos, this->ray_tracing_pipelines, [this](RayTracingPipelineCompileInfo const & a_info)
+                             { return create_ray_tracing_pipeline(a_info); });
+    }
+
+    auto ImplPipelineManager::add_compute_pipelines(std::span<ComputePipelineCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<ComputePipeline>>>
+    {
+        return add_pipelines(*this, a_infos, this->compute_pipelines, [this](ComputePipelineCompileInfo const & a_info)
+                             { return create_compute_pipeline(a_info); });
+    }
+
+    auto ImplPipelineManager::add_raster_pipelines(std::span<RasterPipelineCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<RasterPipeline>>>
+    {
+        return add_pipelines(*this, a_infos, this->raster_pipelines, [this](RasterPipelineCompileInfo const & a_info)
+                             { return create_raster_pipeline(a_info); });
+    }
+
+    auto ImplPipelineManager::add_shader_objects(std::span<ShaderObjectCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<ShaderObject>>>
+    {
+        return add_pipelines(*this, a_infos, this->shader_objects, [this](ShaderObjectCompileInfo const & a_info)
+                             { return create_shader_object(a_info); });
+    }
+
+    auto ImplPipelineManager::add_ray_tracing_pipeline(RayTracingPipelineCompileInfo const & a_info) -> Result<std::shared_ptr<RayTracingPipeline>>
+    {
+        return std::move(add_ray_tracing_pipelines({&a_info, 1}).front());
+    }
+
+    auto ImplPipelineManager::add_compute_pipeline(ComputePipelineCompileInfo const & a_info) -> Result<std::shared_ptr<ComputePipeline>>
+    {
+        return std::move(add_compute_pipelines({&a_info, 1}).front());
+    }
+
+    auto ImplPipelineManager::add_raster_pipeline(RasterPipelineCompileInfo const & a_info) -> Result<std::shared_ptr<RasterPipeline>>
+    {
+        return std::move(add_raster_pipelines({&a_info, 1}).front());
+    }
+
+    auto ImplPipelineManager::add_shader_object(ShaderObjectCompileInfo const & a_info) -> Result<std::shared_ptr<ShaderObject>>
+    {
+        return std::move(add_shader_objects({&a_info, 1}).front());
     }
 
     void ImplPipelineManager::remove_ray_tracing_pipeline(std::shared_ptr<RayTracingPipeline> const & pipeline)
@@ -816,6 +1027,7 @@ namespace daxa
         {
             return;
         }
+        remove_hotload_dependencies(pipeline_iter->pipeline_ptr.get(), pipeline_iter->observed_hotload_files);
         this->ray_tracing_pipelines.erase(pipeline_iter);
     }
 
@@ -832,6 +1044,7 @@ namespace daxa
         {
             return;
         }
+        remove_hotload_dependencies(pipeline_iter->pipeline_ptr.get(), pipeline_iter->observed_hotload_files);
         this->compute_pipelines.erase(pipeline_iter);
     }
 
@@ -848,183 +1061,515 @@ namespace daxa
         {
             return;
         }
+        remove_hotload_dependencies(pipeline_iter->pipeline_ptr.get(), pipeline_iter->observed_hotload_files);
         this->raster_pipelines.erase(pipeline_iter);
     }
 
-    using FileWriteTimeLookupTable = std::unordered_map<std::string, std::filesystem::file_time_type>;
-
-    static auto check_if_sources_changed(std::chrono::file_clock::time_point & last_hotload_time, ShaderFileTimeSet & observed_hotload_files, VirtualFileSet & virtual_files, FileWriteTimeLookupTable & lookup_table) -> bool
+    void ImplPipelineManager::remove_shader_object(std::shared_ptr<ShaderObject> const & shader_object)
     {
-        using namespace std::chrono_literals;
-        static constexpr auto HOTRELOAD_MIN_TIME = 250ms;
-
-        auto now = std::chrono::file_clock::now();
-        using namespace std::chrono_literals;
-        if (now - last_hotload_time < HOTRELOAD_MIN_TIME)
+        auto shader_object_iter = std::find_if(
+            this->shader_objects.begin(),
+            this->shader_objects.end(),
+            [&shader_object](ShaderObjectState const & other)
+            {
+                return shader_object.get() == other.pipeline_ptr.get();
+            });
+        if (shader_object_iter == this->shader_objects.end())
         {
-            return false;
+            return;
         }
-        last_hotload_time = now;
-        bool reload = false;
+        remove_hotload_dependencies(shader_object_iter->pipeline_ptr.get(), shader_object_iter->observed_hotload_files);
+        this->shader_objects.erase(shader_object_iter);
+    }
 
-        auto get_last_file_write_time = [&](std::filesystem::path const & path)
+#if defined(__linux__)
+    struct HotloadFileWatcher::Platform
+    {
+        struct DirectoryWatch
         {
-            auto full_path_str = std::filesystem::absolute(path).string();
-            auto iter = lookup_table.find(full_path_str);
-            if (iter != lookup_table.end())
-            {
-                return iter->second;
-            }
-            else
-            {
-                auto latest_write_time = std::filesystem::last_write_time(path);
-                lookup_table[full_path_str] = latest_write_time;
-                return latest_write_time;
-            }
+            std::filesystem::path path = {};
+            // Watching a directory again returns the same watch descriptor, the watch is removed with the last file.
+            u32 file_count = {};
         };
+        int inotify_fd = -1;
+        std::map<int, DirectoryWatch> directories = {};
+    };
 
-        for (auto & [path, recorded_write_time] : observed_hotload_files)
+    HotloadFileWatcher::HotloadFileWatcher()
+        : platform{std::make_unique<Platform>()}
+    {
+        platform->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+
+    HotloadFileWatcher::~HotloadFileWatcher()
+    {
+        if (platform->inotify_fd != -1)
         {
-            auto path_str = path.string();
-            if (virtual_files.contains(path_str))
+            for (auto const & directory_entry : platform->directories)
             {
-                auto latest_write_time = virtual_files[path_str].timestamp;
-                if (latest_write_time > recorded_write_time)
-                {
-                    reload = true;
-                }
-            }
-            else // if (std::filesystem::exists(path))
-            {
-                auto latest_write_time = get_last_file_write_time(path);
-                if (latest_write_time > recorded_write_time)
-                {
-                    reload = true;
-                }
+                inotify_rm_watch(platform->inotify_fd, directory_entry.first);
             }
-            // else
-            // {
-            //     std::cout << "How?" << std::endl;
-            // }
+            close(platform->inotify_fd);
         }
-        if (reload)
+    }
+
+    auto HotloadFileWatcher::watch(std::filesystem::path const & file) -> bool
+    {
+        if (platform->inotify_fd == -1)
         {
-            for (auto & pair : observed_hotload_files)
-            {
-                auto path_str = pair.first.string();
-                if (virtual_files.contains(path_str))
-                {
-                    pair.second = virtual_files[path_str].timestamp;
-                }
-                else if (std::filesystem::exists(pair.first))
-                {
-                    pair.second = get_last_file_write_time(pair.first);
-                }
-            }
+            return false;
         }
-        return reload;
-    };
+        // Editors often save by renaming a new file over the old one, so the directory is watched instead of the file.
+        auto directory = file.parent_path();
+        int const watch_descriptor = inotify_add_watch(platform->inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB);
+        if (watch_descriptor == -1)
+        {
+            return false;
+        }
+        auto & directory_watch = platform->directories[watch_descriptor];
+        directory_watch.path = std::move(directory);
+        directory_watch.file_count += 1;
+        return true;
+    }
 
-    void ImplPipelineManager::add_virtual_file(VirtualFileInfo const & virtual_info)
+    void HotloadFileWatcher::unwatch(std::filesystem::path const & file)
     {
-        virtual_files[virtual_info.name] = VirtualFileState{
-            .contents = virtual_info.contents,
-            .timestamp = std::chrono::file_clock::now(),
-        };
-        auto & virtual_file = virtual_files.at(virtual_info.name);
-        if (this->info.custom_preprocessor)
+        auto const directory = file.parent_path();
+        auto directory_iter = std::ranges::find_if(platform->directories, [&](auto const & entry)
+                                                   { return entry.second.path == directory; });
+        if (directory_iter == platform->directories.end())
         {
-            this->info.custom_preprocessor(virtual_file.contents, virtual_info.name);
+            return;
+        }
+        directory_iter->second.file_count -= 1;
+        if (directory_iter->second.file_count == 0)
+        {
+            inotify_rm_watch(platform->inotify_fd, directory_iter->first);
+            platform->directories.erase(directory_iter);
         }
-        shader_preprocess(virtual_file.contents, virtual_info.name);
     }
 
-    auto ImplPipelineManager::reload_all() -> PipelineReloadResult
+    auto HotloadFileWatcher::poll(std::vector<std::filesystem::path> & changed_files) -> bool
     {
-        bool reloaded = false;
-
-        // Optimization for caching the write times so that multiple pipelines don't check the
-        // filesystem for the same file's write-time. Filesystem checks are really slow...
-        auto lookup_table = FileWriteTimeLookupTable{};
-
-        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files] : this->compute_pipelines)
+        if (platform->inotify_fd == -1)
         {
-            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table))
-            {
-                reloaded = true;
-                auto new_pipeline = create_compute_pipeline(compile_info);
-                bool is_valid = true;
-                if (this->info.register_null_pipelines_when_first_compile_fails)
-                {
-                    is_valid = new_pipeline.is_ok() && new_pipeline.value().pipeline_ptr->is_valid();
-                }
-                else
-                {
-                    is_valid = new_pipeline.is_ok();
-                }
-                if (is_valid)
-                {
-                    *pipeline = std::move(*new_pipeline.value().pipeline_ptr);
-                }
-                else
-                {
-                    return PipelineReloadError{new_pipeline.m};
-                }
-            }
+            return true;
         }
-
-        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files] : this->raster_pipelines)
+        bool complete = true;
+        alignas(inotify_event) std::array<char, 4096> buffer = {};
+        while (true)
         {
-            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table))
+            auto const size = read(platform->inotify_fd, buffer.data(), buffer.size());
+            if (size <= 0)
             {
-                reloaded = true;
-                auto new_pipeline = create_raster_pipeline(compile_info);
-                bool is_valid = true;
-                if (this->info.register_null_pipelines_when_first_compile_fails)
-                {
-                    is_valid = new_pipeline.is_ok() && new_pipeline.value().pipeline_ptr->is_valid();
-                }
-                else
-                {
-                    is_valid = new_pipeline.is_ok();
-                }
-                if (is_valid)
+                break;
+            }
+            for (usize offset = 0; offset < static_cast<usize>(size);)
+            {
+                auto const * event = r_cast<inotify_event const *>(buffer.data() + offset);
+                if ((event->mask & IN_Q_OVERFLOW) != 0)
                 {
-                    *pipeline = std::move(*new_pipeline.value().pipeline_ptr);
+                    complete = false;
                 }
-                else
+                else if (auto directory_iter = platform->directories.find(event->wd); directory_iter != platform->directories.end() && event->len > 0)
                 {
-                    return PipelineReloadError{new_pipeline.m};
+                    changed_files.push_back(directory_iter->second.path / event->name);
                 }
+                offset += sizeof(inotify_event) + event->len;
             }
         }
-
-        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files] : this->ray_tracing_pipelines)
+        return complete;
+    }
+#elif defined(_WIN32)
+    struct HotloadFileWatcher::Platform
+    {
+        struct DirectoryWatch
         {
-            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table))
+            std::filesystem::path path = {};
+            HANDLE handle = INVALID_HANDLE_VALUE;
+            OVERLAPPED overlapped = {};
+            // The directory is closed with the last watched file in it.
+            u32 file_count = {};
+            alignas(DWORD) std::array<std::byte, 16 * 1024> buffer = {};
+
+            auto issue_read() -> bool
             {
-                reloaded = true;
-                auto new_pipeline = create_ray_tracing_pipeline(compile_info);
-                bool is_valid = true;
-                if (this->info.register_null_pipelines_when_first_compile_fails)
-                {
-                    is_valid = new_pipeline.is_ok() && new_pipeline.value().pipeline_ptr->is_valid();
-                }
-                else
-                {
-                    is_valid = new_pipeline.is_ok();
+                return ReadDirectoryChangesW(
+                           handle, buffer.data(), static_cast<DWORD>(buffer.size()), FALSE,
+                           FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME,
+                           nullptr, &overlapped, nullptr) != 0;
+            }
+        };
+        std::map<std::filesystem::path, std::unique_ptr<DirectoryWatch>> directories = {};
+    };
+
+    HotloadFileWatcher::HotloadFileWatcher()
+        : platform{std::make_unique<Platform>()}
+    {
+    }
+
+    HotloadFileWatcher::~HotloadFileWatcher()
+    {
+        for (auto & [path, directory] : platform->directories)
+        {
+            CancelIoEx(directory->handle, &directory->overlapped);
+            CloseHandle(directory->handle);
+            CloseHandle(directory->overlapped.hEvent);
+        }
+    }
+
+    auto HotloadFileWatcher::watch(std::filesystem::path const & file) -> bool
+    {
+        // Editors often save by renaming a new file over the old one, so the directory is watched instead of the file.
+        auto directory_path = file.parent_path();
+        if (auto directory_iter = platform->directories.find(directory_path); directory_iter != platform->directories.end())
+        {
+            directory_iter->second->file_count += 1;
+            return true;
+        }
+        auto directory = std::make_unique<Platform::DirectoryWatch>();
+        directory->path = directory_path;
+        directory->handle = CreateFileW(
+            directory_path.c_str(), FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+            OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (directory->handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        directory->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!directory->issue_read())
+        {
+            CloseHandle(directory->handle);
+            CloseHandle(directory->overlapped.hEvent);
+            return false;
+        }
+        directory->file_count = 1;
+        platform->directories[directory_path] = std::move(directory);
+        return true;
+    }
+
+    void HotloadFileWatcher::unwatch(std::filesystem::path const & file)
+    {
+        auto directory_iter = platform->directories.find(file.parent_path());
+        if (directory_iter == platform->directories.end())
+        {
+            return;
+        }
+        auto & directory = *directory_iter->second;
+        directory.file_count -= 1;
+        if (directory.file_count == 0)
+        {
+            CancelIoEx(directory.handle, &directory.overlapped);
+            CloseHandle(directory.handle);
+            CloseHandle(directory.overlapped.hEvent);
+            platform->directories.erase(directory_iter);
+        }
+    }
+
+    auto HotloadFileWatcher::poll(std::vector<std::filesystem::path> & changed_files) -> bool
+    {
+        bool complete = true;
+        for (auto & [path, directory] : platform->directories)
+        {
+            DWORD size = 0;
+            if (GetOverlappedResult(directory->handle, &directory->overlapped, &size, FALSE) == 0)
+            {
+                continue;
+            }
+            // A size of 0 means the buffer overflowed and the changes were dropped.
+            if (size == 0)
+            {
+                complete = false;
+            }
+            for (usize offset = 0; size != 0;)
+            {
+                auto const * notify_info = r_cast<FILE_NOTIFY_INFORMATION const *>(directory->buffer.data() + offset);
+                changed_files.push_back(directory->path / std::wstring{notify_info->FileName, notify_info->FileNameLength / sizeof(WCHAR)});
+                if (notify_info->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                offset += notify_info->NextEntryOffset;
+            }
+            if (!directory->issue_read())
+            {
+                complete = false;
+            }
+        }
+        return complete;
+    }
+#else
+    struct HotloadFileWatcher::Platform
+    {
+    };
+
+    HotloadFileWatcher::HotloadFileWatcher() = default;
+    HotloadFileWatcher::~HotloadFileWatcher() = default;
+
+    auto HotloadFileWatcher::watch(std::filesystem::path const & /*file*/) -> bool
+    {
+        return false;
+    }
+
+    void HotloadFileWatcher::unwatch(std::filesystem::path const & /*file*/)
+    {
+    }
+
+    auto HotloadFileWatcher::poll(std::vector<std::filesystem::path> & /*changed_files*/) -> bool
+    {
+        return true;
+    }
+#endif
+
+    auto ImplPipelineManager::hotload_graph_key(std::filesystem::path const & path) const -> std::filesystem::path
+    {
+        if (virtual_files.contains(path.string()))
+        {
+            return path;
+        }
+        // Includes, cached dependencies and slang report the same file with differently spelled paths.
+        auto error = std::error_code{};
+        auto key = std::filesystem::weakly_canonical(path, error);
+        return error ? path : key;
+    }
+
+    void ImplPipelineManager::add_hotload_dependencies(void const * pipeline, ShaderFileTimeSet const & files)
+    {
+        for (auto const & [path, write_time] : files)
+        {
+            auto key = hotload_graph_key(path);
+            auto [iter, inserted] = hotload_dependency_graph.try_emplace(key, HotloadFileNode{.write_time = write_time});
+            if (inserted && !virtual_files.contains(key.string()))
+            {
+                iter->second.watched = hotload_file_watcher.watch(key);
+                if (!iter->second.watched)
+                {
+                    polled_hotload_files.insert(key);
                 }
-                if (is_valid)
+            }
+            iter->second.dependents.insert(pipeline);
+        }
+    }
+
+    void ImplPipelineManager::remove_hotload_dependencies(void const * pipeline, ShaderFileTimeSet const & files)
+    {
+        for (auto const & [path, write_time] : files)
+        {
+            auto iter = hotload_dependency_graph.find(hotload_graph_key(path));
+            if (iter == hotload_dependency_graph.end())
+            {
+                continue;
+            }
+            iter->second.dependents.erase(pipeline);
+            if (iter->second.dependents.empty())
+            {
+                if (iter->second.watched)
+                {
+                    hotload_file_watcher.unwatch(iter->first);
+                }
+                polled_hotload_files.erase(iter->first);
+                hotload_dependency_graph.erase(iter);
+            }
+        }
+    }
+
+    auto ImplPipelineManager::collect_changed_hotload_dependents() -> std::unordered_set<void const *>
+    {
+        using namespace std::chrono_literals;
+        static constexpr auto HOTRELOAD_MIN_TIME = 250ms;
+
+        auto dependents = std::unordered_set<void const *>{};
+        auto now = std::chrono::file_clock::now();
+        if (now - last_hotload_poll_time < HOTRELOAD_MIN_TIME)
+        {
+            return dependents;
+        }
+        last_hotload_poll_time = now;
+
+        auto mark_if_written = [&](std::filesystem::path const & key, HotloadFileNode & node)
+        {
+            auto write_time = std::chrono::file_clock::time_point{};
+            if (auto virtual_file_iter = virtual_files.find(key.string()); virtual_file_iter != virtual_files.end())
+            {
+                write_time = virtual_file_iter->second.timestamp;
+            }
+            else
+            {
+                // Events also arrive for writes that did not touch the timestamp, and for deleted files.
+                auto error = std::error_code{};
+                write_time = std::filesystem::last_write_time(key, error);
+                if (error)
                 {
-                    *pipeline = std::move(*new_pipeline.value().pipeline_ptr);
+                    return;
                 }
-                else
+            }
+            if (write_time <= node.write_time)
+            {
+                return;
+            }
+            node.write_time = write_time;
+            invalidate_shader_source(key);
+            dependents.insert(node.dependents.begin(), node.dependents.end());
+        };
+
+        auto changed_files = std::move(changed_virtual_files);
+        changed_virtual_files.clear();
+        bool const complete = hotload_file_watcher.poll(changed_files);
+        for (auto const & path : changed_files)
+        {
+            auto iter = hotload_dependency_graph.find(hotload_graph_key(path));
+            if (iter != hotload_dependency_graph.end())
+            {
+                mark_if_written(iter->first, iter->second);
+            }
+        }
+        if (complete)
+        {
+            for (auto const & path : polled_hotload_files)
+            {
+                mark_if_written(path, hotload_dependency_graph.at(path));
+            }
+        }
+        else
+        {
+            for (auto & [path, node] : hotload_dependency_graph)
+            {
+                if (!virtual_files.contains(path.string()))
                 {
-                    return PipelineReloadError{new_pipeline.m};
+                    mark_if_written(path, node);
                 }
             }
         }
+        return dependents;
+    }
 
+    void ImplPipelineManager::add_virtual_file(VirtualFileInfo const & virtual_info)
+    {
+        // The background compile reads the virtual files.
+        wait_for_async_reload();
+        virtual_files[virtual_info.name] = VirtualFileState{
+            .contents = virtual_info.contents,
+            .timestamp = std::chrono::file_clock::now(),
+        };
+        auto & virtual_file = virtual_files.at(virtual_info.name);
+        if (this->info.custom_preprocessor)
+        {
+            this->info.custom_preprocessor(virtual_file.contents, virtual_info.name);
+        }
+        shader_preprocess(virtual_file.contents, virtual_info.name);
+        changed_virtual_files.push_back(virtual_info.name);
+        reset_slang_sessions();
+    }
+
+    template <typename StateT>
+    static void collect_changed_pipelines(std::vector<StateT> & states, std::unordered_set<void const *> const & changed_dependents, std::vector<ImplPipelineManager::PipelineReload<StateT>> & reloads)
+    {
+        for (auto & state : states)
+        {
+            if (changed_dependents.contains(state.pipeline_ptr.get()))
+            {
+                reloads.push_back({.pipeline_ptr = state.pipeline_ptr, .info = state.info});
+            }
+        }
+    }
+
+    template <typename StateT>
+    static void apply_changed_pipelines(ImplPipelineManager & self, std::vector<StateT> & states, std::vector<ImplPipelineManager::PipelineReload<StateT>> & reloads, std::optional<std::string> & first_error)
+    {
+        for (auto & [pipeline_ptr, info, new_state] : reloads)
+        {
+            bool is_valid = new_state->is_ok();
+            if (self.info.register_null_pipelines_when_first_compile_fails)
+            {
+                is_valid = is_valid && new_state->value().pipeline_ptr->is_valid();
+            }
+            if (!is_valid)
+            {
+                if (!first_error.has_value())
+                {
+                    first_error = new_state->m;
+                }
+                continue;
+            }
+            *pipeline_ptr = std::move(*new_state->value().pipeline_ptr);
+            // The new compile may include different files. The pipeline may also have been removed while it compiled.
+            auto state_iter = std::find_if(states.begin(), states.end(), [&](StateT const & state)
+                                           { return state.pipeline_ptr == pipeline_ptr; });
+            if (state_iter != states.end())
+            {
+                self.remove_hotload_dependencies(pipeline_ptr.get(), state_iter->observed_hotload_files);
+                state_iter->observed_hotload_files = std::move(new_state->value().observed_hotload_files);
+                self.add_hotload_dependencies(pipeline_ptr.get(), state_iter->observed_hotload_files);
+            }
+        }
+    }
+
+    auto ImplPipelineManager::collect_pipeline_reloads() -> PipelineReloads
+    {
+        auto reloads = PipelineReloads{};
+        auto const changed_dependents = collect_changed_hotload_dependents();
+        if (changed_dependents.empty())
+        {
+            return reloads;
+        }
+        collect_changed_pipelines(this->compute_pipelines, changed_dependents, reloads.compute_pipelines);
+        collect_changed_pipelines(this->raster_pipelines, changed_dependents, reloads.raster_pipelines);
+        collect_changed_pipelines(this->ray_tracing_pipelines, changed_dependents, reloads.ray_tracing_pipelines);
+        collect_changed_pipelines(this->shader_objects, changed_dependents, reloads.shader_objects);
+        return reloads;
+    }
+
+    void ImplPipelineManager::compile_pipeline_reloads(PipelineReloads & reloads)
+    {
+        DAXA_PROFILE_ZONE("PipelineManager::compile_pipeline_reloads");
+        begin_dependency_content_hashing();
+        // All pipeline kinds go into one job list, so they share the compile threads.
+        auto jobs = std::vector<std::function<void()>>{};
+        for (auto & reload : reloads.compute_pipelines)
+        {
+            request_slang_entry_point(reload.info.shader_info, ShaderStage::COMP);
+            jobs.push_back([this, &reload]()
+                           { reload.new_state.emplace(create_compute_pipeline(reload.info)); });
+        }
+        for (auto & reload : reloads.raster_pipelines)
+        {
+            jobs.push_back([this, &reload]()
+                           { reload.new_state.emplace(create_raster_pipeline(reload.info)); });
+        }
+        for (auto & reload : reloads.ray_tracing_pipelines)
+        {
+            jobs.push_back([this, &reload]()
+                           { reload.new_state.emplace(create_ray_tracing_pipeline(reload.info)); });
+        }
+        for (auto & reload : reloads.shader_objects)
+        {
+            jobs.push_back([this, &reload]()
+                           { reload.new_state.emplace(create_shader_object(reload.info)); });
+        }
+        run_compile_jobs(jobs.size(), [&jobs](usize i)
+                         { jobs[i](); });
+        end_slang_batch();
+    }
+
+    auto ImplPipelineManager::apply_pipeline_reloads(PipelineReloads & reloads) -> PipelineReloadResult
+    {
+        // Swapped in after all jobs finished and in add order, so the reported error does not depend on thread timing.
+        auto first_error = std::optional<std::string>{};
+        apply_changed_pipelines(*this, this->compute_pipelines, reloads.compute_pipelines, first_error);
+        apply_changed_pipelines(*this, this->raster_pipelines, reloads.raster_pipelines, first_error);
+        apply_changed_pipelines(*this, this->ray_tracing_pipelines, reloads.ray_tracing_pipelines, first_error);
+        apply_changed_pipelines(*this, this->shader_objects, reloads.shader_objects, first_error);
+
+        bool const reloaded =
+            !reloads.compute_pipelines.empty() ||
+            !reloads.raster_pipelines.empty() ||
+            !reloads.ray_tracing_pipelines.empty() ||
+            !reloads.shader_objects.empty();
+        if (first_error.has_value())
+        {
+            return PipelineReloadError{first_error.value()};
+        }
         if (reloaded)
         {
             return PipelineReloadSuccess{};
@@ -1035,6 +1580,90 @@ namespace daxa
         }
     }
 
+    auto ImplPipelineManager::reload_all() -> PipelineReloadResult
+    {
+        DAXA_PROFILE_ZONE("PipelineManager::reload_all");
+        // A pending async reload is applied first, so its older results can not overwrite the ones below.
+        wait_for_async_reload();
+        auto async_result = poll_reload();
+
+        auto reloads = collect_pipeline_reloads();
+        compile_pipeline_reloads(reloads);
+        auto result = apply_pipeline_reloads(reloads);
+        if (daxa::holds_alternative<NoPipelineChanged>(result) ||
+            (daxa::holds_alternative<PipelineReloadSuccess>(result) && daxa::holds_alternative<PipelineReloadError>(async_result)))
+        {
+            return async_result;
+        }
+        return result;
+    }
+
+    auto ImplPipelineManager::reload_all_async() -> bool
+    {
+        if (this->async_reload != nullptr)
+        {
+            return false;
+        }
+        auto reloads = collect_pipeline_reloads();
+        if (reloads.compute_pipelines.empty() && reloads.raster_pipelines.empty() && reloads.ray_tracing_pipelines.empty() && reloads.shader_objects.empty())
+        {
+            return false;
+        }
+        this->async_reload = std::make_unique<AsyncReload>();
+        this->async_reload->reloads = std::move(reloads);
+        this->async_reload->thread = std::thread{[this, async_reload = this->async_reload.get()]()
+                                                 {
+                                                     compile_pipeline_reloads(async_reload->reloads);
+                                                     async_reload->finished.store(true, std::memory_order_release);
+                                                 }};
+        return true;
+    }
+
+    auto ImplPipelineManager::poll_reload() -> PipelineReloadResult
+    {
+        if (this->async_reload == nullptr || !this->async_reload->finished.load(std::memory_order_acquire))
+        {
+            return NoPipelineChanged{};
+        }
+        wait_for_async_reload();
+        auto result = apply_pipeline_reloads(this->async_reload->reloads);
+        this->async_reload.reset();
+        return result;
+    }
+
+    void ImplPipelineManager::wait_for_async_reload()
+    {
+        if (this->async_reload != nullptr && this->async_reload->thread.joinable())
+        {
+            this->async_reload->thread.join();
+        }
+    }
+
+    void ImplPipelineManager::run_compile_jobs(usize job_count, std::function<void(usize)> const & job) const
+    {
+        std::atomic<usize> next_index = 0;
+        auto worker = [&]()
+        {
+            for (usize i = next_index.fetch_add(1, std::memory_order_relaxed); i < job_count; i = next_index.fetch_add(1, std::memory_order_relaxed))
+            {
+                job(i);
+            }
+        };
+        u32 const max_thread_count = this->info.compile_thread_count != 0 ? this->info.compile_thread_count : std::max(1u, std::thread::hardware_concurrency());
+        usize const thread_count = std::min<usize>(job_count, max_thread_count);
+        std::vector<std::thread> threads = {};
+        threads.reserve(thread_count > 0 ? thread_count - 1 : 0);
+        for (usize t = 1; t < thread_count; ++t)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+    }
+
     auto ImplPipelineManager::all_pipelines_valid() const -> bool
     {
         for (RasterPipelineState const & raster_pipeline_state : this->raster_pipelines)
@@ -1060,180 +1689,847 @@ namespace daxa
                 return false;
             }
         }
+
+        for (ShaderObjectState const & shader_object_state : this->shader_objects)
+        {
+            if (!shader_object_state.pipeline_ptr->is_valid())
+            {
+                return false;
+            }
+        }
         return true;
     }
 
-    static auto hash_shader_info(std::string const & source_string, ShaderCompileOptions const & compile_options, ImplPipelineManager::ShaderStage shader_stage) -> uint64_t
+    // XXH64. Unlike std::hash, the result is the same for every standard library and run, so it can be persisted.
+    static auto stable_hash(std::span<std::byte const> data, uint64_t seed = 0) -> uint64_t
+    {
+        static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+        static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+        static constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+        static constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+        static constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+        auto read_u64 = [](std::byte const * ptr) -> uint64_t
+        {
+            uint64_t value = {};
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        };
+        auto read_u32 = [](std::byte const * ptr) -> uint64_t
+        {
+            uint32_t value = {};
+            std::memcpy(&value, ptr, sizeof(value));
+            return value;
+        };
+        auto round = [](uint64_t acc, uint64_t input) -> uint64_t
+        {
+            return std::rotl(acc + input * PRIME_2, 31) * PRIME_1;
+        };
+        auto merge_round = [&](uint64_t acc, uint64_t value) -> uint64_t
+        {
+            return (acc ^ round(0, value)) * PRIME_1 + PRIME_4;
+        };
+
+        auto const * ptr = data.data();
+        auto const * const end = data.data() + data.size();
+        uint64_t hash = {};
+        if (data.size() >= 32)
+        {
+            uint64_t v1 = seed + PRIME_1 + PRIME_2;
+            uint64_t v2 = seed + PRIME_2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME_1;
+            for (; ptr + 32 <= end; ptr += 32)
+            {
+                v1 = round(v1, read_u64(ptr));
+                v2 = round(v2, read_u64(ptr + 8));
+                v3 = round(v3, read_u64(ptr + 16));
+                v4 = round(v4, read_u64(ptr + 24));
+            }
+            hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+            hash = merge_round(hash, v1);
+            hash = merge_round(hash, v2);
+            hash = merge_round(hash, v3);
+            hash = merge_round(hash, v4);
+        }
+        else
+        {
+            hash = seed + PRIME_5;
+        }
+        hash += static_cast<uint64_t>(data.size());
+        for (; ptr + 8 <= end; ptr += 8)
+        {
+            hash = std::rotl(hash ^ round(0, read_u64(ptr)), 27) * PRIME_1 + PRIME_4;
+        }
+        if (ptr + 4 <= end)
+        {
+            hash = std::rotl(hash ^ (read_u32(ptr) * PRIME_1), 23) * PRIME_2 + PRIME_3;
+            ptr += 4;
+        }
+        for (; ptr < end; ++ptr)
+        {
+            hash = std::rotl(hash ^ (static_cast<uint64_t>(*ptr) * PRIME_5), 11) * PRIME_1;
+        }
+        hash ^= hash >> 33;
+        hash *= PRIME_2;
+        hash ^= hash >> 29;
+        hash *= PRIME_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    static auto stable_hash(std::string_view data) -> uint64_t
     {
-        auto result = uint64_t{};
+        return stable_hash(std::as_bytes(std::span{data.data(), data.size()}));
+    }
 
-        auto hash_combine = [](uint64_t h1, uint64_t h2) -> uint64_t
+    static auto hash_shader_info(std::string const & source_string, ShaderCompileOptions const & compile_options, ImplPipelineManager::ShaderStage shader_stage, bool include_compiler_version = true) -> uint64_t
+    {
+        // Every input is length prefixed, so different splits of the same bytes can not collide.
+        auto key = std::string{};
+        auto append = [&key](std::string_view value)
         {
-            return h1 ^ (h2 << 1);
+            auto const size = static_cast<uint64_t>(value.size());
+            key.append(r_cast<char const *>(&size), sizeof(size));
+            key.append(value);
         };
+        // A compiler update can change the generated code for the same inputs.
+        if (include_compiler_version)
+        {
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+            auto const glslang_version = glslang::GetVersion();
+            append(std::to_string(glslang_version.major) + "." + std::to_string(glslang_version.minor) + "." + std::to_string(glslang_version.patch));
+#endif
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+            append(spGetBuildTagString());
+#endif
+        }
+        append(source_string);
+        append(stage_string(shader_stage));
+        append(compile_options.entry_point.value_or(""));
+        // Root paths are left out so other checkouts share entries. An include
+        // resolving differently is caught by the dependency content hashes.
+        append(std::to_string(static_cast<uint32_t>(compile_options.language.value_or(ShaderLanguage::GLSL))));
+        for (auto const & define : compile_options.defines)
+        {
+            append(define.name);
+            append(define.value);
+        }
+        append(compile_options.enable_debug_info.value_or(false) ? "debug" : "");
+        append(std::to_string(static_cast<uint32_t>(compile_options.optimization.value_or(ShaderOptimization::NONE))));
+        append(compile_options.strip_debug_info.value_or(false) ? "strip" : "");
+        return stable_hash(key);
+    }
+
+    static constexpr auto CACHE_FILE_MAGIC_NUMBER = std::bit_cast<uint64_t>(std::to_array("daxpipe"));
+    static constexpr auto CACHE_FILE_VERSION = uint64_t{4};
+    static constexpr auto CACHE_DEPENDENCY_FLAG_ROOT_RELATIVE = uint64_t{1};
+    static constexpr auto CACHE_ARCHIVE_FILE_NAME = std::string_view{"spirv_cache.bin"};
+
+    struct ShaderCacheFileHeader
+    {
+        uint64_t magic_number;
+        uint64_t version;
+    };
 
-        auto hash_shader_compile_options = [&hash_combine](ShaderCompileOptions const & options) -> uint64_t
+    struct ShaderCacheEntryHeader
+    {
+        uint64_t key;
+        uint64_t payload_size;
+    };
+
+    // All spirv cache entries of one spirv_cache_folder in one memory mapped file.
+    // The file is a list of entries, new entries are appended and replace earlier ones with the same key.
+    struct ArchiveShaderCache final : ShaderCacheBackend
+    {
+        std::mutex mtx = {};
+        std::filesystem::path path = {};
+        std::span<std::byte const> mapping = {};
+#if defined(_WIN32)
+        HANDLE file_handle = INVALID_HANDLE_VALUE;
+        HANDLE mapping_handle = nullptr;
+#elif !defined(__linux__)
+        std::vector<std::byte> file_contents = {};
+#endif
+        // Entries inserted after the file was mapped. The deque keeps them in place.
+        std::deque<std::vector<std::byte>> appended_payloads = {};
+        std::unordered_map<uint64_t, std::span<std::byte const>> entries = {};
+        usize live_bytes = {};
+        usize dead_bytes = {};
+        std::ofstream out_file = {};
+
+        // Read only archives leave a missing or broken file alone and ignore stores.
+        bool read_only = {};
+
+        explicit ArchiveShaderCache(std::filesystem::path a_path, bool a_read_only = false);
+        ~ArchiveShaderCache();
+        ArchiveShaderCache(ArchiveShaderCache const &) = delete;
+        auto operator=(ArchiveShaderCache const &) -> ArchiveShaderCache & = delete;
+
+        auto map() -> bool;
+        void unmap();
+        void add_entry(uint64_t key, std::span<std::byte const> payload);
+        // Returns an empty span when there is no entry. The span stays valid until the archive is destroyed.
+        auto find(uint64_t key) const -> std::span<std::byte const>;
+        void insert(uint64_t key, std::vector<std::byte> && payload);
+
+        auto load(u64 key) -> std::optional<std::vector<std::byte>> override;
+        void store(u64 key, std::span<std::byte const> entry) override;
+    };
+
+    ArchiveShaderCache::ArchiveShaderCache(std::filesystem::path a_path, bool a_read_only)
+        : path{std::move(a_path)}, read_only{a_read_only}
+    {
+        while (map())
         {
-            auto result = uint64_t{};
-            if (options.entry_point.has_value())
+            auto header = ShaderCacheFileHeader{};
+            if (mapping.size() < sizeof(header))
             {
-                result = hash_combine(result, std::hash<std::string>{}(options.entry_point.value()));
+                unmap();
+                break;
             }
-            for (auto const & path : options.root_paths)
+            std::memcpy(&header, mapping.data(), sizeof(header));
+            if (header.magic_number != CACHE_FILE_MAGIC_NUMBER || header.version != CACHE_FILE_VERSION)
             {
-                result = hash_combine(result, std::hash<std::string>{}(path.string()));
+                unmap();
+                break;
             }
-            if (options.language.has_value())
+            usize offset = sizeof(header);
+            while (offset + sizeof(ShaderCacheEntryHeader) <= mapping.size())
             {
-                result = hash_combine(result, std::hash<uint32_t>{}(static_cast<uint32_t>(options.language.value())));
+                auto entry = ShaderCacheEntryHeader{};
+                std::memcpy(&entry, mapping.data() + offset, sizeof(entry));
+                if (entry.payload_size > mapping.size() - offset - sizeof(entry))
+                {
+                    break;
+                }
+                add_entry(entry.key, mapping.subspan(offset + sizeof(entry), entry.payload_size));
+                offset += sizeof(entry) + entry.payload_size;
             }
-            for (auto const & define : options.defines)
+            if (offset == mapping.size() || read_only)
             {
-                result = hash_combine(result, std::hash<std::string>{}(define.name));
-                result = hash_combine(result, std::hash<std::string>{}(define.value));
+                if (!read_only)
+                {
+                    out_file = std::ofstream{path, std::ios::binary | std::ios::app};
+                }
+                return;
             }
-            if (options.enable_debug_info.has_value())
+            // A process died while appending. The partial entry is cut off, so new entries start at a valid offset.
+            entries.clear();
+            live_bytes = {};
+            dead_bytes = {};
+            unmap();
+            auto error = std::error_code{};
+            std::filesystem::resize_file(path, offset, error);
+            if (error)
             {
-                result = hash_combine(result, std::hash<uint32_t>{}(static_cast<uint32_t>(options.enable_debug_info.value())));
+                break;
             }
-            return result;
+        }
+        entries.clear();
+        live_bytes = {};
+        dead_bytes = {};
+        if (read_only)
+        {
+            return;
+        }
+        auto error = std::error_code{};
+        std::filesystem::create_directories(path.parent_path(), error);
+        out_file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+        auto const header = ShaderCacheFileHeader{
+            .magic_number = CACHE_FILE_MAGIC_NUMBER,
+            .version = CACHE_FILE_VERSION,
         };
+        out_file.write(r_cast<char const *>(&header), sizeof(header));
+        out_file.flush();
+    }
 
-        result = hash_combine(result, std::hash<std::string>{}(source_string));
-        result = hash_combine(result, hash_shader_compile_options(compile_options));
-        result = hash_combine(result, std::hash<uint32_t>{}(static_cast<uint32_t>(shader_stage)));
+    ArchiveShaderCache::~ArchiveShaderCache()
+    {
+        out_file.close();
+        if (read_only || dead_bytes <= live_bytes)
+        {
+            unmap();
+            return;
+        }
+        // Mostly replaced entries, rewrite the archive with only the live ones.
+        auto const temp_path = std::filesystem::path{path}.concat(".tmp");
+        {
+            auto compacted_file = std::ofstream{temp_path, std::ios::binary | std::ios::trunc};
+            auto const header = ShaderCacheFileHeader{
+                .magic_number = CACHE_FILE_MAGIC_NUMBER,
+                .version = CACHE_FILE_VERSION,
+            };
+            compacted_file.write(r_cast<char const *>(&header), sizeof(header));
+            for (auto const & [key, payload] : entries)
+            {
+                auto const entry = ShaderCacheEntryHeader{.key = key, .payload_size = payload.size()};
+                compacted_file.write(r_cast<char const *>(&entry), sizeof(entry));
+                compacted_file.write(r_cast<char const *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+            }
+        }
+        unmap();
+        auto error = std::error_code{};
+        std::filesystem::rename(temp_path, path, error);
+    }
 
-        return result;
+    auto ArchiveShaderCache::map() -> bool
+    {
+#if defined(__linux__)
+        int const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            return false;
+        }
+        struct stat file_stat = {};
+        bool ok = fstat(fd, &file_stat) == 0 && file_stat.st_size > 0;
+        if (ok)
+        {
+            void * address = mmap(nullptr, static_cast<usize>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = address != MAP_FAILED;
+            if (ok)
+            {
+                mapping = {static_cast<std::byte const *>(address), static_cast<usize>(file_stat.st_size)};
+            }
+        }
+        close(fd);
+        return ok;
+#elif defined(_WIN32)
+        file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER file_size = {};
+        if (GetFileSizeEx(file_handle, &file_size) != 0 && file_size.QuadPart > 0)
+        {
+            mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void const * address = mapping_handle != nullptr ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (address != nullptr)
+            {
+                mapping = {static_cast<std::byte const *>(address), static_cast<usize>(file_size.QuadPart)};
+                return true;
+            }
+        }
+        unmap();
+        return false;
+#else
+        auto in_file = std::ifstream{path, std::ios::binary | std::ios::ate};
+        if (!in_file.good() || in_file.tellg() <= 0)
+        {
+            return false;
+        }
+        file_contents.resize(static_cast<usize>(in_file.tellg()));
+        in_file.seekg(0);
+        in_file.read(r_cast<char *>(file_contents.data()), static_cast<std::streamsize>(file_contents.size()));
+        mapping = file_contents;
+        return true;
+#endif
     }
 
-    static constexpr auto CACHE_FILE_MAGIC_NUMBER = std::bit_cast<uint64_t>(std::to_array("daxpipe"));
-    static constexpr auto CACHE_FILE_VERSION = uint64_t{2};
+    void ArchiveShaderCache::unmap()
+    {
+#if defined(__linux__)
+        if (!mapping.empty())
+        {
+            munmap(const_cast<std::byte *>(mapping.data()), mapping.size());
+        }
+#elif defined(_WIN32)
+        if (!mapping.empty())
+        {
+            UnmapViewOfFile(mapping.data());
+        }
+        if (mapping_handle != nullptr)
+        {
+            CloseHandle(mapping_handle);
+            mapping_handle = nullptr;
+        }
+        if (file_handle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file_handle);
+            file_handle = INVALID_HANDLE_VALUE;
+        }
+#else
+        file_contents = {};
+#endif
+        mapping = {};
+    }
 
-    struct ShaderCacheFileHeader
+    void ArchiveShaderCache::add_entry(uint64_t key, std::span<std::byte const> payload)
     {
-        uint64_t magic_number;
-        uint64_t version;
-        uint64_t dependency_n;
-        uint64_t spirv_size;
+        auto [iter, inserted] = entries.try_emplace(key, payload);
+        if (!inserted)
+        {
+            live_bytes -= iter->second.size();
+            dead_bytes += iter->second.size();
+            iter->second = payload;
+        }
+        live_bytes += payload.size();
+    }
+
+    auto ArchiveShaderCache::find(uint64_t key) const -> std::span<std::byte const>
+    {
+        auto iter = entries.find(key);
+        return iter != entries.end() ? iter->second : std::span<std::byte const>{};
+    }
+
+    void ArchiveShaderCache::insert(uint64_t key, std::vector<std::byte> && payload)
+    {
+        auto const entry = ShaderCacheEntryHeader{.key = key, .payload_size = payload.size()};
+        out_file.write(r_cast<char const *>(&entry), sizeof(entry));
+        out_file.write(r_cast<char const *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        out_file.flush();
+        add_entry(key, appended_payloads.emplace_back(std::move(payload)));
+    }
+
+    auto ArchiveShaderCache::load(u64 key) -> std::optional<std::vector<std::byte>>
+    {
+        auto lock = std::lock_guard{mtx};
+        auto const entry = find(key);
+        if (entry.empty())
+        {
+            return std::nullopt;
+        }
+        return std::vector<std::byte>{entry.begin(), entry.end()};
+    }
+
+    void ArchiveShaderCache::store(u64 key, std::span<std::byte const> entry)
+    {
+        if (read_only)
+        {
+            return;
+        }
+        auto lock = std::lock_guard{mtx};
+        insert(key, std::vector<std::byte>{entry.begin(), entry.end()});
+    }
+
+    struct FolderShaderCache final : ShaderCacheBackend
+    {
+        std::filesystem::path folder = {};
+
+        explicit FolderShaderCache(std::filesystem::path a_folder)
+            : folder{std::move(a_folder)}
+        {
+        }
+
+        auto load(u64 key) -> std::optional<std::vector<std::byte>> override
+        {
+            auto in_file = std::ifstream{folder / std::to_string(key), std::ios::binary | std::ios::ate};
+            if (!in_file.good() || in_file.tellg() <= 0)
+            {
+                return std::nullopt;
+            }
+            auto entry = std::vector<std::byte>(static_cast<usize>(in_file.tellg()));
+            in_file.seekg(0);
+            in_file.read(r_cast<char *>(entry.data()), static_cast<std::streamsize>(entry.size()));
+            return entry;
+        }
+
+        void store(u64 key, std::span<std::byte const> entry) override
+        {
+            auto error = std::error_code{};
+            std::filesystem::create_directories(folder, error);
+            // Written next to the entry and renamed over it, so a concurrent load never sees a partial entry.
+            auto const thread_id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+            auto const temp_path = folder / (std::to_string(key) + "." + std::to_string(thread_id) + ".tmp");
+            {
+                auto out_file = std::ofstream{temp_path, std::ios::binary | std::ios::trunc};
+                out_file.write(r_cast<char const *>(entry.data()), static_cast<std::streamsize>(entry.size()));
+            }
+            std::filesystem::rename(temp_path, folder / std::to_string(key), error);
+        }
     };
 
-    void ImplPipelineManager::save_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash, std::vector<u32> const & spirv)
+    struct LayeredShaderCache final : ShaderCacheBackend
+    {
+        std::vector<std::shared_ptr<ShaderCacheBackend>> backends = {};
+
+        explicit LayeredShaderCache(std::vector<std::shared_ptr<ShaderCacheBackend>> a_backends)
+            : backends{std::move(a_backends)}
+        {
+        }
+
+        auto load(u64 key) -> std::optional<std::vector<std::byte>> override
+        {
+            for (usize i = 0; i < backends.size(); ++i)
+            {
+                auto entry = backends[i]->load(key);
+                if (entry.has_value())
+                {
+                    for (usize earlier_i = 0; earlier_i < i; ++earlier_i)
+                    {
+                        backends[earlier_i]->store(key, entry.value());
+                    }
+                    return entry;
+                }
+            }
+            return std::nullopt;
+        }
+
+        void store(u64 key, std::span<std::byte const> entry) override
+        {
+            for (auto & backend : backends)
+            {
+                backend->store(key, entry);
+            }
+        }
+    };
+
+    auto create_archive_shader_cache(std::filesystem::path const & folder) -> std::shared_ptr<ShaderCacheBackend>
+    {
+        return std::make_shared<ArchiveShaderCache>(folder / CACHE_ARCHIVE_FILE_NAME);
+    }
+
+    auto create_folder_shader_cache(std::filesystem::path const & folder) -> std::shared_ptr<ShaderCacheBackend>
+    {
+        return std::make_shared<FolderShaderCache>(folder);
+    }
+
+    auto create_layered_shader_cache(std::vector<std::shared_ptr<ShaderCacheBackend>> backends) -> std::shared_ptr<ShaderCacheBackend>
+    {
+        return std::make_shared<LayeredShaderCache>(std::move(backends));
+    }
+
+    // Paths inside a root path are stored relative to it, so entries stay valid for other checkout locations.
+    static auto relative_to_root_paths(std::filesystem::path const & path, std::vector<std::filesystem::path> const & root_paths) -> std::optional<std::string>
+    {
+        for (auto const & root : root_paths)
+        {
+            auto error = std::error_code{};
+            auto const canonical_root = std::filesystem::weakly_canonical(root, error);
+            if (error)
+            {
+                continue;
+            }
+            auto const relative = path.lexically_relative(canonical_root);
+            if (!relative.empty() && *relative.begin() != "..")
+            {
+                return relative.generic_string();
+            }
+        }
+        return std::nullopt;
+    }
+
+    static auto resolve_in_root_paths(std::filesystem::path const & relative, std::vector<std::filesystem::path> const & root_paths) -> std::optional<std::filesystem::path>
+    {
+        for (auto const & root : root_paths)
+        {
+            auto error = std::error_code{};
+            auto const candidate = root / relative;
+            if (std::filesystem::exists(candidate, error))
+            {
+                return std::filesystem::weakly_canonical(candidate, error);
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Bundles are written without a device, so they must not depend on the device the writing manager may have.
+    static void remove_device_defines(ShaderCompileOptions & compile_options)
+    {
+        std::erase_if(compile_options.defines, [](ShaderDefine const & define)
+                      { return define.name == COOPERATIVE_MATRIX_DEFINE; });
+    }
+
+    // Bundles are read without touching the shader files, so files are keyed by the path given in the compile info.
+    // The compiler version is left out, shipped builds may not match the build of the bundle tool.
+    static auto pipeline_bundle_key(ShaderCompileInfo const & shader_info, ImplPipelineManager::ShaderStage shader_stage) -> uint64_t
+    {
+        auto compile_options = shader_info.compile_options;
+        remove_device_defines(compile_options);
+        auto source_string = std::string{};
+        if (auto const * shader_file = daxa::get_if<ShaderFile>(&shader_info.source))
+        {
+            source_string = "file:" + shader_file->path.generic_string();
+        }
+        else if (auto const * shader_code = daxa::get_if<ShaderCode>(&shader_info.source))
+        {
+            source_string = "code:" + shader_code->string;
+        }
+        return hash_shader_info(source_string, compile_options, shader_stage, false);
+    }
+
+    void ImplPipelineManager::load_pipeline_bundle(std::filesystem::path const & path)
+    {
+        pipeline_bundle = std::make_shared<ArchiveShaderCache>(path, true);
+    }
+
+    auto ImplPipelineManager::load_from_pipeline_bundle(ShaderCompileInfo const & shader_info, std::string const & debug_name, ShaderStage shader_stage) -> Result<std::vector<u32>>
+    {
+        auto const entry = pipeline_bundle->load(pipeline_bundle_key(shader_info, shader_stage));
+        if (!entry.has_value())
+        {
+            return Result<std::vector<u32>>(fmt::format("the {} shader of {} is not in the pipeline bundle {}", stage_string(shader_stage), debug_name, this->info.pipeline_bundle.value().string()));
+        }
+        auto spirv = std::vector<u32>(entry->size() / sizeof(u32));
+        std::memcpy(spirv.data(), entry->data(), spirv.size() * sizeof(u32));
+        return Result<std::vector<u32>>(std::move(spirv));
+    }
+
+    auto ImplPipelineManager::write_pipeline_bundle(PipelineBundleInfo const & bundle_info, std::filesystem::path const & path) -> Result<void>
+    {
+        if (pipeline_bundle != nullptr)
+        {
+            return Result<void>(std::string_view{"can not write a pipeline bundle with a pipeline manager that reads one"});
+        }
+        struct BundleShader
+        {
+            ShaderCompileInfo shader_info;
+            ShaderStage stage;
+            std::string name;
+        };
+        auto shaders = std::vector<BundleShader>{};
+        auto add_shader = [&](ShaderCompileInfo const & shader_info, ShaderStage stage, std::string const & name)
+        {
+            shaders.push_back({.shader_info = shader_info, .stage = stage, .name = name});
+            shaders.back().shader_info.compile_options.inherit(this->info.shader_compile_options);
+            remove_device_defines(shaders.back().shader_info.compile_options);
+        };
+        for (auto const & pipeline_info : bundle_info.ray_tracing_pipelines)
+        {
+            auto const shader_lists = std::array<std::pair<std::vector<ShaderCompileInfo> const *, ShaderStage>, 6>{{
+                {&pipeline_info.ray_gen_infos, ShaderStage::RAY_GEN},
+                {&pipeline_info.intersection_infos, ShaderStage::RAY_INTERSECT},
+                {&pipeline_info.any_hit_infos, ShaderStage::RAY_ANY_HIT},
+                {&pipeline_info.callable_infos, ShaderStage::RAY_CALLABLE},
+                {&pipeline_info.closest_hit_infos, ShaderStage::RAY_CLOSEST_HIT},
+                {&pipeline_info.miss_hit_infos, ShaderStage::RAY_MISS},
+            }};
+            for (auto const & [shader_infos, stage] : shader_lists)
+            {
+                for (auto const & shader_info : *shader_infos)
+                {
+                    add_shader(shader_info, stage, pipeline_info.name);
+                }
+            }
+        }
+        for (auto const & pipeline_info : bundle_info.compute_pipelines)
+        {
+            add_shader(pipeline_info.shader_info, ShaderStage::COMP, pipeline_info.name);
+        }
+        for (auto const & pipeline_info : bundle_info.raster_pipelines)
+        {
+            auto const shader_infos = std::array<std::pair<Optional<ShaderCompileInfo> const *, ShaderStage>, 6>{{
+                {&pipeline_info.mesh_shader_info, ShaderStage::MESH},
+                {&pipeline_info.vertex_shader_info, ShaderStage::VERT},
+                {&pipeline_info.tesselation_control_shader_info, ShaderStage::TESS_CONTROL},
+                {&pipeline_info.tesselation_evaluation_shader_info, ShaderStage::TESS_EVAL},
+                {&pipeline_info.fragment_shader_info, ShaderStage::FRAG},
+                {&pipeline_info.task_shader_info, ShaderStage::TASK},
+            }};
+            for (auto const & [shader_info, stage] : shader_infos)
+            {
+                if (shader_info->has_value())
+                {
+                    add_shader(shader_info->value(), stage, pipeline_info.name);
+                }
+            }
+        }
+        for (auto const & pipeline_info : bundle_info.shader_objects)
+        {
+            add_shader(pipeline_info.shader_info, shader_object_shader_stage(pipeline_info.stage), pipeline_info.name);
+        }
+
+        begin_dependency_content_hashing();
+        auto spirv_results = std::vector<std::optional<Result<std::vector<u32>>>>(shaders.size());
+        run_compile_jobs(
+            shaders.size(),
+            [&](usize i)
+            {
+                auto observed_hotload_files = ShaderFileTimeSet{};
+                spirv_results[i].emplace(get_spirv(shaders[i].shader_info, shaders[i].name, shaders[i].stage, observed_hotload_files));
+            });
+        end_slang_batch();
+        for (auto const & spirv_result : spirv_results)
+        {
+            if (spirv_result->is_err())
+            {
+                return Result<void>(spirv_result->message());
+            }
+        }
+
+        auto error = std::error_code{};
+        std::filesystem::remove(path, error);
+        auto bundle = ArchiveShaderCache{path};
+        for (usize i = 0; i < shaders.size(); ++i)
+        {
+            auto const & spirv = spirv_results[i]->value();
+            bundle.store(pipeline_bundle_key(shaders[i].shader_info, shaders[i].stage), std::as_bytes(std::span{spirv}));
+        }
+        bundle.out_file.flush();
+        if (!bundle.out_file.good())
+        {
+            return Result<void>(fmt::format("failed to write the pipeline bundle {}", path.string()));
+        }
+        return Result<void>(true);
+    }
+
+    auto ImplPipelineManager::dependency_content_hash(std::filesystem::path const & path) -> std::optional<uint64_t>
+    {
+        if (auto virtual_file_iter = virtual_files.find(path.string()); virtual_file_iter != virtual_files.end())
+        {
+            return stable_hash(virtual_file_iter->second.contents);
+        }
+        auto const path_string = path.string();
+        {
+            auto lock = std::lock_guard{dependency_content_hashes_mtx};
+            auto iter = dependency_content_hashes.find(path_string);
+            if (iter != dependency_content_hashes.end())
+            {
+                return iter->second;
+            }
+        }
+        auto in_file = std::ifstream{path, std::ios::binary};
+        if (!in_file.good())
+        {
+            return std::nullopt;
+        }
+        auto const contents = std::string{std::istreambuf_iterator<char>(in_file), std::istreambuf_iterator<char>()};
+        auto const hash = stable_hash(contents);
+        auto lock = std::lock_guard{dependency_content_hashes_mtx};
+        dependency_content_hashes[path_string] = hash;
+        return hash;
+    }
+
+    void ImplPipelineManager::begin_dependency_content_hashing()
+    {
+        auto lock = std::lock_guard{dependency_content_hashes_mtx};
+        dependency_content_hashes.clear();
+    }
+
+    auto ImplPipelineManager::shader_cache_backend(ShaderCompileInfo const & shader_info) -> std::shared_ptr<ShaderCacheBackend>
+    {
+        if (this->info.shader_cache_backend != nullptr)
+        {
+            return this->info.shader_cache_backend;
+        }
+        if (!shader_info.compile_options.spirv_cache_folder.has_value())
+        {
+            return nullptr;
+        }
+        auto const & cache_folder = shader_info.compile_options.spirv_cache_folder.value();
+        auto cache_lock = std::lock_guard{shader_cache_mtx};
+        auto & backend = shader_cache_folders[cache_folder];
+        if (backend == nullptr)
+        {
+            backend = create_archive_shader_cache(cache_folder);
+        }
+        return backend;
+    }
+
+    void ImplPipelineManager::save_shader_cache(ShaderCompileContext & context, ShaderCacheBackend & backend, uint64_t shader_info_hash, std::vector<u32> const & spirv)
+    {
+        auto payload = std::vector<std::byte>{};
+        auto write = [&payload](void const * data, usize size)
+        {
+            auto const * bytes = static_cast<std::byte const *>(data);
+            payload.insert(payload.end(), bytes, bytes + size);
+        };
+        auto const dependency_n = uint64_t{context.observed_hotload_files->size()};
+        write(&dependency_n, sizeof(dependency_n));
+        for (auto const & [path, time_point] : *context.observed_hotload_files)
+        {
+            auto const content_hash = dependency_content_hash(path);
+            if (!content_hash.has_value())
+            {
+                // A dependency that can not be read can not be validated on load either.
+                return;
+            }
+            auto const relative_path = relative_to_root_paths(path, context.shader_info->compile_options.root_paths);
+            auto const flags = relative_path.has_value() ? CACHE_DEPENDENCY_FLAG_ROOT_RELATIVE : uint64_t{0};
+            auto const path_string = relative_path.value_or(path.string());
+            auto const path_string_size = uint64_t{path_string.size()};
+            write(&flags, sizeof(flags));
+            write(&path_string_size, sizeof(path_string_size));
+            write(path_string.data(), path_string.size());
+            write(&content_hash.value(), sizeof(uint64_t));
+        }
+        auto const spirv_size = uint64_t{spirv.size()};
+        write(&spirv_size, sizeof(spirv_size));
+        write(spirv.data(), spirv.size() * sizeof(u32));
+
+        backend.store(shader_info_hash, payload);
+    }
+
+    auto ImplPipelineManager::try_load_shader_cache(ShaderCompileContext & context, ShaderCacheBackend & backend, uint64_t shader_info_hash) -> Result<std::vector<u32>>
     {
-        std::filesystem::create_directories(cache_folder);
-        auto out_file = std::ofstream{cache_folder / std::filesystem::path{std::to_string(shader_info_hash)}, std::ios::binary};
-        auto header = ShaderCacheFileHeader{};
-        header.magic_number = CACHE_FILE_MAGIC_NUMBER;
-        header.version = CACHE_FILE_VERSION;
-        header.dependency_n = current_observed_hotload_files->size();
-        header.spirv_size = spirv.size() * sizeof(u32);
+        auto const entry = backend.load(shader_info_hash);
+        if (!entry.has_value() || entry->empty())
+        {
+            return Result<std::vector<u32>>(std::string_view{"no cache found"});
+        }
+        auto const payload = std::span<std::byte const>{entry.value()};
 
-        out_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
-        // TODO: Save more granular dependency info
-        for (auto const & [path, time_point] : *current_observed_hotload_files)
+        usize offset = 0;
+        auto read = [&payload, &offset](void * data, usize size) -> bool
         {
-            auto flags = uint64_t{};
-            auto path_string = path.string();
-            auto path_string_size = uint64_t{path_string.size()};
-            auto virtual_file_iter = virtual_files.find(path_string);
-            bool is_virtual_file = virtual_file_iter != virtual_files.end();
-            flags |= (is_virtual_file << 0);
-            auto time_since_epoch = time_point.time_since_epoch().count();
-            out_file.write(reinterpret_cast<char const *>(&flags), sizeof(flags));
-            out_file.write(reinterpret_cast<char const *>(&path_string_size), sizeof(path_string_size));
-            out_file.write(path_string.data(), path_string.size());
-            if (is_virtual_file)
-            {
-                auto const & virtual_file_contents = virtual_file_iter->second.contents;
-                auto virtual_file_size = uint64_t{virtual_file_contents.size()};
-                out_file.write(reinterpret_cast<char const *>(&virtual_file_size), sizeof(virtual_file_size));
-                out_file.write(virtual_file_contents.data(), virtual_file_contents.size());
-            }
-            else
+            if (size > payload.size() - offset)
             {
-                out_file.write(reinterpret_cast<char const *>(&time_since_epoch), sizeof(time_since_epoch));
+                return false;
             }
+            std::memcpy(data, payload.data() + offset, size);
+            offset += size;
+            return true;
+        };
+        auto dependency_n = uint64_t{};
+        if (!read(&dependency_n, sizeof(dependency_n)))
+        {
+            return Result<std::vector<u32>>(std::string_view{"bad cache entry"});
         }
-        out_file.write(reinterpret_cast<char const *>(spirv.data()), header.spirv_size);
-    }
-
-    auto ImplPipelineManager::try_load_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash) -> Result<std::vector<u32>>
-    {
-        auto in_file = std::ifstream{cache_folder / std::filesystem::path{std::to_string(shader_info_hash)}, std::ios::binary};
-        if (in_file.good())
+        auto dependencies = std::vector<std::filesystem::path>{};
+        for (uint64_t dep_i = 0; dep_i < dependency_n; ++dep_i)
         {
-            auto header = ShaderCacheFileHeader{};
-            in_file.read(reinterpret_cast<char *>(&header), sizeof(header));
-            if (header.magic_number != CACHE_FILE_MAGIC_NUMBER)
+            auto flags = uint64_t{};
+            auto path_string_size = uint64_t{};
+            if (!read(&flags, sizeof(flags)) || !read(&path_string_size, sizeof(path_string_size)) || path_string_size > payload.size() - offset)
             {
-                return Result<std::vector<u32>>(std::string_view{"bad cache file"});
+                return Result<std::vector<u32>>(std::string_view{"bad cache entry"});
             }
-            if (header.version != CACHE_FILE_VERSION)
+            auto path_string = std::string(path_string_size, '\0');
+            auto content_hash = uint64_t{};
+            if (!read(path_string.data(), path_string_size) || !read(&content_hash, sizeof(content_hash)))
             {
-                return Result<std::vector<u32>>(std::string_view{"needs update"});
+                return Result<std::vector<u32>>(std::string_view{"bad cache entry"});
             }
-
-            for (uint64_t dep_i = 0; dep_i < header.dependency_n; ++dep_i)
-            {
-                auto flags = uint64_t{};
-                auto path = std::filesystem::path{};
-                auto time_since_epoch = std::chrono::system_clock::rep{};
-                auto path_string = std::string{};
-                auto path_string_size = uint64_t{};
-                in_file.read(reinterpret_cast<char *>(&flags), sizeof(flags));
-                auto is_virtual_file = ((flags >> 0) & 1) != 0;
-                in_file.read(reinterpret_cast<char *>(&path_string_size), sizeof(path_string_size));
-                path_string.resize(path_string_size);
-                in_file.read(path_string.data(), path_string_size);
-                path = path_string;
-                if (is_virtual_file)
-                {
-                    auto virtual_file_contents = std::string{};
-                    auto virtual_file_size = uint64_t{};
-
-                    in_file.read(reinterpret_cast<char *>(&virtual_file_size), sizeof(virtual_file_size));
-                    virtual_file_contents.resize(virtual_file_size);
-                    in_file.read(virtual_file_contents.data(), virtual_file_size);
-
-                    auto virtual_file_iter = virtual_files.find(path_string);
-                    if (virtual_file_iter == virtual_files.end())
-                    {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
-                    }
-                    if (virtual_file_iter->second.contents != virtual_file_contents)
-                    {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
-                    }
-                }
-                else
+            auto path = std::filesystem::path{path_string};
+            if ((flags & CACHE_DEPENDENCY_FLAG_ROOT_RELATIVE) != 0)
+            {
+                auto resolved = resolve_in_root_paths(path, context.shader_info->compile_options.root_paths);
+                if (!resolved.has_value())
                 {
-                    in_file.read(reinterpret_cast<char *>(&time_since_epoch), sizeof(time_since_epoch));
-                    if (!std::filesystem::exists(path))
-                    {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
-                    }
-                    auto write_time = std::filesystem::last_write_time(path);
-                    if (write_time.time_since_epoch().count() > time_since_epoch)
-                    {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
-                    }
+                    return Result<std::vector<u32>>(std::string_view{"needs update"});
                 }
-                // NOTE(grundlett): Setting the time to now is fine, as we successfully handle
-                // any temporal changes above. This is a bus sus tho.
-                current_observed_hotload_files->insert({path, std::chrono::file_clock::now()});
+                path = std::move(resolved.value());
             }
-
-            auto spirv = std::vector<u32>{};
-            spirv.resize(header.spirv_size / sizeof(u32));
-            in_file.read(reinterpret_cast<char *>(spirv.data()), header.spirv_size);
-            return Result<std::vector<u32>>{spirv};
+            if (dependency_content_hash(path) != content_hash)
+            {
+                return Result<std::vector<u32>>(std::string_view{"needs update"});
+            }
+            dependencies.push_back(std::move(path));
+        }
+        auto spirv_size = uint64_t{};
+        if (!read(&spirv_size, sizeof(spirv_size)) || spirv_size > (payload.size() - offset) / sizeof(u32))
+        {
+            return Result<std::vector<u32>>(std::string_view{"bad cache entry"});
+        }
+        auto spirv = std::vector<u32>(spirv_size);
+        read(spirv.data(), spirv_size * sizeof(u32));
+        for (auto & path : dependencies)
+        {
+            context.observed_hotload_files->insert({std::move(path), std::chrono::file_clock::now()});
         }
-        return Result<std::vector<u32>>(std::string_view{"no cache found"});
+        return Result<std::vector<u32>>{std::move(spirv)};
     }
 
-    auto ImplPipelineManager::get_spirv(ShaderCompileInfo const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage) -> Result<std::vector<u32>>
+    auto ImplPipelineManager::get_spirv(ShaderCompileInfo const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage, ShaderFileTimeSet & observed_hotload_files) -> Result<std::vector<u32>>
     {
-        // TODO: Not internally threadsafe
-        current_shader_info = &shader_info;
+        if (pipeline_bundle != nullptr)
+        {
+            return load_from_pipeline_bundle(shader_info, debug_name_opt, shader_stage);
+        }
+        auto context = ShaderCompileContext{
+            .shader_info = &shader_info,
+            .observed_hotload_files = &observed_hotload_files,
+        };
         std::vector<u32> spirv = {};
         // if (daxa::holds_alternative<ShaderByteCode>(shader_info.source))
         // {
@@ -1243,6 +2539,7 @@ namespace daxa
         // else
         {
             ShaderCode code;
+            auto cache_key_source = std::optional<std::string>{};
             if (auto const * shader_source = daxa::get_if<ShaderFile>(&shader_info.source))
             {
                 auto ret = [this, &shader_source]() -> daxa::Result<std::filesystem::path>
@@ -1253,7 +2550,7 @@ namespace daxa
                     }
                     else
                     {
-                        return full_path_to_file(shader_source->path);
+                        return full_path_to_file(shader_source->path, &shader_info);
                     }
                 }();
                 if (ret.is_err())
@@ -1262,6 +2559,11 @@ namespace daxa
                 }
                 // This is a hack. Instead of providing the file as source code, we provide the full path.
                 code = {.string = std::string("#include \"") + ret.value().string() + "\"\n"};
+                // The cache key names the file relative to its root path so it does not depend on the checkout location.
+                if (auto const relative_path = relative_to_root_paths(ret.value(), shader_info.compile_options.root_paths); relative_path.has_value())
+                {
+                    cache_key_source = std::string("#include \"") + relative_path.value() + "\"\n";
+                }
                 // auto code_ret = load_shader_source_from_file(ret.value());
                 // if (code_ret.is_err())
                 // {
@@ -1275,10 +2577,11 @@ namespace daxa
             }
 
             // TODO: Test if this is slow, as it's not needed if there's no shader cache.
-            auto shader_info_hash = hash_shader_info(code.string, shader_info.compile_options, shader_stage);
-            if (shader_info.compile_options.spirv_cache_folder.has_value())
+            auto shader_info_hash = hash_shader_info(cache_key_source.value_or(code.string), shader_info.compile_options, shader_stage);
+            auto const cache_backend = shader_cache_backend(shader_info);
+            if (cache_backend != nullptr)
             {
-                auto cache_ret = try_load_shader_cache(shader_info.compile_options.spirv_cache_folder.value(), shader_info_hash);
+                auto cache_ret = try_load_shader_cache(context, *cache_backend, shader_info_hash);
                 if (cache_ret.is_ok())
                 {
                     return cache_ret;
@@ -1294,12 +2597,12 @@ namespace daxa
             {
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
             case ShaderLanguage::GLSL:
-                ret = get_spirv_glslang(shader_info, debug_name_opt, shader_stage, code);
+                ret = get_spirv_glslang(context, debug_name_opt, shader_stage, code);
                 break;
 #endif
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
             case ShaderLanguage::SLANG:
-                ret = get_spirv_slang(shader_info, shader_stage, code);
+                ret = get_spirv_slang(context, shader_stage, code);
                 break;
 #endif
             default: break;
@@ -1307,17 +2610,20 @@ namespace daxa
 
             if (ret.is_err())
             {
-                current_shader_info = nullptr;
                 return Result<std::vector<u32>>(ret.message());
             }
 
-            spirv = ret.value();
-            if (shader_info.compile_options.spirv_cache_folder.has_value())
+            auto optimized = optimize_spirv(shader_info.compile_options, debug_name_opt, std::move(ret.value()));
+            if (optimized.is_err())
+            {
+                return Result<std::vector<u32>>(optimized.message());
+            }
+            spirv = std::move(optimized.value());
+            if (cache_backend != nullptr)
             {
-                save_shader_cache(shader_info.compile_options.spirv_cache_folder.value(), shader_info_hash, spirv);
+                save_shader_cache(context, *cache_backend, shader_info_hash, spirv);
             }
         }
-        current_shader_info = nullptr;
 
         std::string name = "unnamed-shader";
         if (!debug_name_opt.empty())
@@ -1357,6 +2663,7 @@ namespace daxa
         }
 
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SPIRV_VALIDATION
+        auto spirv_tools_lock = std::lock_guard{spirv_tools_mtx};
         spirv_tools.SetMessageConsumer(
             [&](spv_message_level_t level, [[maybe_unused]] char const * source, [[maybe_unused]] spv_position_t const & position, char const * message)
             { DAXA_DBG_ASSERT_TRUE_M(level > SPV_MSG_WARNING, fmt::format("SPIR-V Validation error after compiling {}:\n - {}", debug_name_opt, message)); });
@@ -1368,16 +2675,68 @@ namespace daxa
         return Result<std::vector<u32>>(spirv);
     }
 
-    auto ImplPipelineManager::full_path_to_file(std::filesystem::path const & path) -> Result<std::filesystem::path>
+    auto ImplPipelineManager::optimize_spirv([[maybe_unused]] ShaderCompileOptions const & compile_options, [[maybe_unused]] std::string const & debug_name, std::vector<u32> && spirv) -> Result<std::vector<u32>>
+    {
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SPIRV_OPTIMIZATION
+        auto const optimization = compile_options.optimization.value_or(ShaderOptimization::NONE);
+        bool const strip_debug_info = compile_options.strip_debug_info.value_or(false) && !compile_options.enable_debug_info.value_or(false);
+        if (optimization == ShaderOptimization::NONE && !strip_debug_info)
+        {
+            return Result<std::vector<u32>>(std::move(spirv));
+        }
+        // Optimizers are not thread-safe, every compile job creates its own.
+        auto optimizer = spvtools::Optimizer{SPV_ENV_VULKAN_1_3};
+        auto messages = std::string{};
+        optimizer.SetMessageConsumer(
+            [&](spv_message_level_t level, [[maybe_unused]] char const * source, [[maybe_unused]] spv_position_t const & position, char const * message)
+            {
+                if (level <= SPV_MSG_ERROR)
+                {
+                    messages += fmt::format(" - {}\n", message);
+                }
+            });
+        if (optimization != ShaderOptimization::NONE)
+        {
+            // Specialization constants are set at pipeline creation, they must stay unfrozen in the cached spirv.
+            if (optimization == ShaderOptimization::PERFORMANCE)
+            {
+                optimizer.RegisterPerformancePasses();
+            }
+            else
+            {
+                optimizer.RegisterSizePasses();
+            }
+            optimizer.RegisterPass(spvtools::CreateAggressiveDCEPass());
+        }
+        if (strip_debug_info)
+        {
+            optimizer.RegisterPass(spvtools::CreateStripDebugInfoPass());
+            optimizer.RegisterPass(spvtools::CreateStripNonSemanticInfoPass());
+        }
+        auto optimizer_options = spvtools::OptimizerOptions{};
+        // Validation has its own build option.
+        optimizer_options.set_run_validator(false);
+        auto optimized = std::vector<u32>{};
+        if (!optimizer.Run(spirv.data(), spirv.size(), &optimized, optimizer_options))
+        {
+            return Result<std::vector<u32>>(fmt::format("SPIR-V optimization failed for {}:\n{}", debug_name, messages));
+        }
+        return Result<std::vector<u32>>(std::move(optimized));
+#else
+        return Result<std::vector<u32>>(std::move(spirv));
+#endif
+    }
+
+    auto ImplPipelineManager::full_path_to_file(std::filesystem::path const & path, ShaderCompileInfo const * shader_info) -> Result<std::filesystem::path>
     {
         if (std::filesystem::exists(path))
         {
             return Result<std::filesystem::path>(std::filesystem::canonical(path));
         }
         std::filesystem::path potential_path;
-        if (this->current_shader_info != nullptr)
+        if (shader_info != nullptr)
         {
-            for (auto const & root : this->current_shader_info->compile_options.root_paths)
+            for (auto const & root : shader_info->compile_options.root_paths)
             {
                 potential_path.clear();
                 potential_path = root / path;
@@ -1406,20 +2765,33 @@ namespace daxa
         return Result<std::filesystem::path>(std::string_view(error_msg));
     }
 
-    auto ImplPipelineManager::load_shader_source_from_file(std::filesystem::path const & path) -> Result<ShaderCode>
+    auto ImplPipelineManager::load_shader_source_from_file(ShaderCompileContext & context, std::filesystem::path const & path) -> Result<ShaderCode>
     {
-        auto result_path = full_path_to_file(path);
+        auto result_path = full_path_to_file(path, context.shader_info);
         if (result_path.is_err())
         {
             return Result<ShaderCode>(result_path.message());
         }
+        auto const cache_key = hotload_graph_key(result_path.value()).string();
+        auto write_time_error = std::error_code{};
+        auto const write_time = std::filesystem::last_write_time(result_path.value(), write_time_error);
+        if (!write_time_error)
+        {
+            auto lock = std::lock_guard{shader_source_cache_mtx};
+            auto iter = shader_source_cache.find(cache_key);
+            if (iter != shader_source_cache.end() && iter->second.write_time == write_time)
+            {
+                context.observed_hotload_files->insert({result_path.value(), write_time});
+                return Result(ShaderCode{.string = iter->second.contents});
+            }
+        }
         auto start_time = std::chrono::steady_clock::now();
         using namespace std::chrono_literals;
         while (std::chrono::duration<f32>(std::chrono::steady_clock::now() - start_time) < 0.1s)
         {
             std::ifstream ifs{path};
             DAXA_DBG_ASSERT_TRUE_M(ifs.good(), "Could not open shader file");
-            current_observed_hotload_files->insert({
+            context.observed_hotload_files->insert({
                 result_path.value(),
                 std::filesystem::last_write_time(result_path.value()),
             });
@@ -1435,9 +2807,15 @@ namespace daxa
             }
             if (this->info.custom_preprocessor)
             {
+                auto preprocessor_lock = std::lock_guard{custom_preprocessor_mtx};
                 this->info.custom_preprocessor(str, result_path.value());
             }
             shader_preprocess(str, result_path.value());
+            if (!write_time_error)
+            {
+                auto lock = std::lock_guard{shader_source_cache_mtx};
+                shader_source_cache[cache_key] = ShaderSourceCacheEntry{.write_time = write_time, .contents = str};
+            }
             return Result(ShaderCode{.string = str});
         }
         std::string err = "timeout while trying to read file: \"";
@@ -1445,9 +2823,16 @@ namespace daxa
         return Result<ShaderCode>(err);
     }
 
-    auto ImplPipelineManager::get_spirv_glslang([[maybe_unused]] ShaderCompileInfo const & shader_info, [[maybe_unused]] std::string const & debug_name_opt, [[maybe_unused]] ShaderStage shader_stage, [[maybe_unused]] ShaderCode const & code) -> Result<std::vector<u32>>
+    void ImplPipelineManager::invalidate_shader_source(std::filesystem::path const & key)
+    {
+        auto lock = std::lock_guard{shader_source_cache_mtx};
+        shader_source_cache.erase(key.string());
+    }
+
+    auto ImplPipelineManager::get_spirv_glslang([[maybe_unused]] ShaderCompileContext & context, [[maybe_unused]] std::string const & debug_name_opt, [[maybe_unused]] ShaderStage shader_stage, [[maybe_unused]] ShaderCode const & code) -> Result<std::vector<u32>>
     {
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+        auto const & shader_info = *context.shader_info;
         auto translate_shader_stage = [](ShaderStage stage) -> EShLanguage
         {
             switch (stage)
@@ -1556,13 +2941,15 @@ namespace daxa
         shader.setStringsWithLengthsAndNames(&source_cstr, nullptr, &name_cstr, 1);
         shader.setEntryPoint("main");
         shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_3);
-        shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
+        // SPV_KHR_cooperative_matrix is only emitted for spirv 1.6, which vulkan 1.3 always accepts.
+        shader.setEnvTarget(glslang::EShTargetSpv, this->cooperative_matrix ? glslang::EShTargetSpv_1_6 : glslang::EShTargetSpv_1_5);
 
         // NOTE: For some reason, this causes a crash in GLSLANG
         // shader.setDebugInfo(use_debug_info);
 
         GlslangFileIncluder includer;
         includer.impl_pipeline_manager = this;
+        includer.context = &context;
         auto messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
         TBuiltInResource const resource = DAXA_DEFAULT_BUILTIN_RESOURCE;
 
@@ -1620,138 +3007,417 @@ namespace daxa
 #endif
     }
 
-    auto ImplPipelineManager::get_spirv_slang([[maybe_unused]] ShaderCompileInfo const & shader_info, [[maybe_unused]] ShaderStage shader_stage, [[maybe_unused]] ShaderCode const & code) -> Result<std::vector<u32>>
-    {
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
-        auto session = Slang::ComPtr<slang::ISession>{};
+    static auto slang_stage(ImplPipelineManager::ShaderStage stage) -> SlangStage
+    {
+        switch (stage)
+        {
+        case ImplPipelineManager::ShaderStage::COMP: return SLANG_STAGE_COMPUTE;
+        case ImplPipelineManager::ShaderStage::VERT: return SLANG_STAGE_VERTEX;
+        case ImplPipelineManager::ShaderStage::FRAG: return SLANG_STAGE_FRAGMENT;
+        case ImplPipelineManager::ShaderStage::TESS_CONTROL: return SLANG_STAGE_HULL;
+        case ImplPipelineManager::ShaderStage::TESS_EVAL: return SLANG_STAGE_DOMAIN;
+        case ImplPipelineManager::ShaderStage::TASK: return SLANG_STAGE_AMPLIFICATION;
+        case ImplPipelineManager::ShaderStage::MESH: return SLANG_STAGE_MESH;
+        case ImplPipelineManager::ShaderStage::RAY_GEN: return SLANG_STAGE_RAY_GENERATION;
+        case ImplPipelineManager::ShaderStage::RAY_INTERSECT: return SLANG_STAGE_INTERSECTION;
+        case ImplPipelineManager::ShaderStage::RAY_ANY_HIT: return SLANG_STAGE_ANY_HIT;
+        case ImplPipelineManager::ShaderStage::RAY_CLOSEST_HIT: return SLANG_STAGE_CLOSEST_HIT;
+        case ImplPipelineManager::ShaderStage::RAY_MISS: return SLANG_STAGE_MISS;
+        case ImplPipelineManager::ShaderStage::RAY_CALLABLE: return SLANG_STAGE_CALLABLE;
+        default: return SLANG_STAGE_NONE;
+        }
+    }
 
+    // Everything that goes into the session desc. Compiles with equal keys can share sessions and their parsed modules.
+    static auto slang_session_key(ShaderCompileInfo const & shader_info) -> uint64_t
+    {
+        auto key = std::string{};
+        auto append = [&key](std::string_view value)
         {
-            auto search_paths_strings = std::vector<std::string>{};
-            auto search_paths = std::vector<char const *>{};
-            search_paths_strings.reserve(shader_info.compile_options.root_paths.size());
-            search_paths.reserve(shader_info.compile_options.root_paths.size());
-            for (auto const & path : shader_info.compile_options.root_paths)
-            {
-                search_paths_strings.push_back(path.string());
-                search_paths.push_back(search_paths_strings.back().c_str());
-            }
+            auto const size = static_cast<uint64_t>(value.size());
+            key.append(r_cast<char const *>(&size), sizeof(size));
+            key.append(value);
+        };
+        for (auto const & path : shader_info.compile_options.root_paths)
+        {
+            append(path.string());
+        }
+        for (auto const & define : shader_info.compile_options.defines)
+        {
+            append(define.name);
+            append(define.value);
+        }
+        return stable_hash(key);
+    }
 
-            auto macros = std::vector<slang::PreprocessorMacroDesc>{};
-            macros.reserve(shader_info.compile_options.defines.size());
-            for (auto const & [name, value] : shader_info.compile_options.defines)
+    // Sessions cache parsed modules by this key. The main module is no dependency of itself, so its write time is part of the key.
+    auto ImplPipelineManager::slang_module_key(ShaderCompileInfo const & shader_info) -> std::string
+    {
+        if (auto const * shader_file = daxa::get_if<ShaderFile>(&shader_info.source))
+        {
+            auto const full_path = full_path_to_file(shader_file->path, &shader_info);
+            if (full_path.is_err())
             {
-                macros.push_back({name.c_str(), value.c_str()});
+                return "file:" + shader_file->path.string();
             }
+            auto write_time_error = std::error_code{};
+            auto const write_time = std::filesystem::last_write_time(full_path.value(), write_time_error);
+            return fmt::format("file:{}:{}", full_path.value().string(), write_time_error ? 0 : write_time.time_since_epoch().count());
+        }
+        return "code:" + daxa::get<ShaderCode>(shader_info.source).string;
+    }
 
-            auto target_desc = slang::TargetDesc{};
-            target_desc.format = SlangCompileTarget::SLANG_SPIRV;
-            auto session_lock = std::lock_guard{slang_backend.session_mtx};
-            target_desc.profile = slang_backend.global_session->findProfile("spirv_1_4");
-            target_desc.flags = SLANG_TARGET_FLAG_GENERATE_SPIRV_DIRECTLY;
+    static auto slang_entry_point_key(std::string const & module_key, std::pair<std::string, ImplPipelineManager::ShaderStage> const & entry_point) -> std::string
+    {
+        return module_key + '\0' + entry_point.first + '\0' + std::string{stage_string(entry_point.second)};
+    }
+
+    static auto slang_diagnostics(slang::IBlob * diagnostics) -> std::string
+    {
+        if (diagnostics == nullptr)
+        {
+            return {};
+        }
+        return std::string{static_cast<char const *>(diagnostics->getBufferPointer()), diagnostics->getBufferSize()};
+    }
+
+    ImplPipelineManager::SlangBackend::Session::~Session()
+    {
+        // Everything created from the global session has to be gone before it goes back into the pool.
+        modules.clear();
+        session.setNull();
+        release_global_session(std::move(global_session));
+    }
+#endif
+
+    void ImplPipelineManager::request_slang_entry_point([[maybe_unused]] ShaderCompileInfo const & shader_info, [[maybe_unused]] ShaderStage shader_stage)
+    {
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+        if (shader_info.compile_options.language != ShaderLanguage::SLANG || daxa::holds_alternative<daxa::Monostate>(shader_info.source))
+        {
+            return;
+        }
+        auto lock = std::lock_guard{slang_backend.pools_mtx};
+        auto & pool = slang_backend.session_pools[slang_session_key(shader_info)];
+        pool.requested_entry_points[slang_module_key(shader_info)].emplace_back(shader_info.compile_options.entry_point.value(), shader_stage);
+#endif
+    }
 
-            // NOTE(grundlett): Does GLSL here refer to SPIR-V?
-            target_desc.forceGLSLScalarBufferLayout = true;
+    void ImplPipelineManager::end_slang_batch()
+    {
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+        // Requests left over were served by the shader cache.
+        auto lock = std::lock_guard{slang_backend.pools_mtx};
+        for (auto & [key, pool] : slang_backend.session_pools)
+        {
+            pool.requested_entry_points.clear();
+            pool.claimed_entry_points.clear();
+        }
+#endif
+    }
 
-            auto session_desc = slang::SessionDesc{};
-            session_desc.targets = &target_desc;
-            session_desc.targetCount = 1;
-            session_desc.searchPaths = search_paths.data();
-            session_desc.searchPathCount = search_paths.size();
-            session_desc.preprocessorMacros = macros.data();
-            session_desc.preprocessorMacroCount = macros.size();
-            session_desc.defaultMatrixLayoutMode = SLANG_MATRIX_LAYOUT_COLUMN_MAJOR;
+    void ImplPipelineManager::reset_slang_sessions()
+    {
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+        // New virtual files are only loaded into new sessions.
+        auto lock = std::lock_guard{slang_backend.pools_mtx};
+        slang_backend.session_pools.clear();
+#endif
+    }
 
-            slang_backend.global_session->createSession(session_desc, session.writeRef());
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+    auto ImplPipelineManager::acquire_slang_session(uint64_t session_key, ShaderCompileInfo const & shader_info) -> std::unique_ptr<SlangBackend::Session>
+    {
+        auto session = std::unique_ptr<SlangBackend::Session>{};
+        {
+            auto lock = std::lock_guard{slang_backend.pools_mtx};
+            auto & idle_sessions = slang_backend.session_pools[session_key].idle_sessions;
+            if (!idle_sessions.empty())
+            {
+                session = std::move(idle_sessions.back());
+                idle_sessions.pop_back();
+            }
+        }
+        if (session != nullptr)
+        {
+            bool const is_current = std::ranges::all_of(session->modules, [this](auto const & module_entry)
+                                                        { return std::ranges::all_of(module_entry.second.dependencies, [this](auto const & dependency)
+                                                                                     { return dependency_content_hash(dependency.first) == dependency.second; }); });
+            if (is_current)
+            {
+                return session;
+            }
+            // A file changed, which may also be part of an import the session has cached.
+            session.reset();
         }
 
-        auto name = std::string{"test"};
-        auto error_message_prefix = std::string("SLANG [") + name + "] ";
+        session = std::make_unique<SlangBackend::Session>();
+        session->global_session = SlangBackend::acquire_global_session();
+
+        auto search_paths_strings = std::vector<std::string>{};
+        auto search_paths = std::vector<char const *>{};
+        search_paths_strings.reserve(shader_info.compile_options.root_paths.size());
+        search_paths.reserve(shader_info.compile_options.root_paths.size());
+        for (auto const & path : shader_info.compile_options.root_paths)
+        {
+            search_paths_strings.push_back(path.string());
+            search_paths.push_back(search_paths_strings.back().c_str());
+        }
 
-        Slang::ComPtr<SlangCompileRequest> slangRequest = nullptr;
-        session->createCompileRequest(slangRequest.writeRef());
-        if (slangRequest == nullptr)
+        auto macros = std::vector<slang::PreprocessorMacroDesc>{};
+        macros.reserve(shader_info.compile_options.defines.size());
+        for (auto const & [name, value] : shader_info.compile_options.defines)
         {
-            return Result<std::vector<u32>>(std::string_view{"internal error: session->createCompileRequest(&slangRequest) returned nullptr"});
+            macros.push_back({name.c_str(), value.c_str()});
         }
-        std::array<char const *, 3> cmd_args = {
+
+        auto target_desc = slang::TargetDesc{};
+        target_desc.format = SlangCompileTarget::SLANG_SPIRV;
+        target_desc.profile = session->global_session->findProfile(this->cooperative_matrix ? "spirv_1_6" : "spirv_1_4");
+        target_desc.flags = SLANG_TARGET_FLAG_GENERATE_SPIRV_DIRECTLY;
+
+        // NOTE(grundlett): Does GLSL here refer to SPIR-V?
+        target_desc.forceGLSLScalarBufferLayout = true;
+
+        auto compiler_options = std::vector{
             // https://github.com/shader-slang/slang/issues/3532
             // Disables warning for aliasing bindings.
-            // clang-format off
-            "-warnings-disable", "39001",
-            "-O0",
-            // clang-format on
+            slang::CompilerOptionEntry{
+                .name = slang::CompilerOptionName::DisableWarning,
+                .value = {.kind = slang::CompilerOptionValueKind::String, .stringValue0 = "39001"},
+            },
+            slang::CompilerOptionEntry{
+                .name = slang::CompilerOptionName::Optimization,
+                .value = {.kind = slang::CompilerOptionValueKind::Int, .intValue0 = SLANG_OPTIMIZATION_LEVEL_NONE},
+            },
         };
-        slangRequest->processCommandLineArguments(cmd_args.data(), static_cast<int>(cmd_args.size()));
+        if (this->cooperative_matrix)
+        {
+            // Lets CoopMat lower to SPV_KHR_cooperative_matrix without every shader declaring the capability.
+            compiler_options.push_back(slang::CompilerOptionEntry{
+                .name = slang::CompilerOptionName::Capability,
+                .value = {.kind = slang::CompilerOptionValueKind::Int, .intValue0 = static_cast<int32_t>(session->global_session->findCapability("spvCooperativeMatrixKHR"))},
+            });
+        }
+
+        auto session_desc = slang::SessionDesc{};
+        session_desc.targets = &target_desc;
+        session_desc.targetCount = 1;
+        session_desc.searchPaths = search_paths.data();
+        session_desc.searchPathCount = search_paths.size();
+        session_desc.preprocessorMacros = macros.data();
+        session_desc.preprocessorMacroCount = macros.size();
+        session_desc.defaultMatrixLayoutMode = SLANG_MATRIX_LAYOUT_COLUMN_MAJOR;
+        session_desc.compilerOptionEntries = compiler_options.data();
+        session_desc.compilerOptionEntryCount = static_cast<uint32_t>(compiler_options.size());
 
+        session->global_session->createSession(session_desc, session->session.writeRef());
+
+        // Virtual files are loaded up front, so shaders can import them by name.
         for (auto const & [virtual_path, virtual_file] : virtual_files)
         {
-            int virtualFileIndex = slangRequest->addTranslationUnit(SLANG_SOURCE_LANGUAGE_SLANG, virtual_path.c_str());
-            slangRequest->addTranslationUnitSourceString(virtualFileIndex, virtual_path.c_str(), virtual_file.contents.c_str());
-            current_observed_hotload_files->insert({virtual_path, std::chrono::file_clock::now()});
+            auto const module_name = std::filesystem::path{virtual_path}.replace_extension().generic_string();
+            auto diagnostics = Slang::ComPtr<slang::IBlob>{};
+            session->session->loadModuleFromSourceString(module_name.c_str(), virtual_path.c_str(), virtual_file.contents.c_str(), diagnostics.writeRef());
         }
+        return session;
+    }
 
-        auto const filename = "_daxa_file";
-
-        int translationUnitIndex = slangRequest->addTranslationUnit(SLANG_SOURCE_LANGUAGE_SLANG, filename);
-        slangRequest->addTranslationUnitSourceString(translationUnitIndex, "_daxa_slang_main", code.string.c_str());
+    void ImplPipelineManager::release_slang_session(uint64_t session_key, std::unique_ptr<SlangBackend::Session> && session)
+    {
+        auto lock = std::lock_guard{slang_backend.pools_mtx};
+        slang_backend.session_pools[session_key].idle_sessions.push_back(std::move(session));
+    }
 
-        SlangResult const compileRes = slangRequest->compile();
-        auto diagnostics = slangRequest->getDiagnosticOutput();
+    auto ImplPipelineManager::compile_slang_entry_points(SlangBackend::Session & session, std::string const & module_key, ShaderCode const & code, std::span<std::pair<std::string, ShaderStage> const> entry_points) -> std::vector<SlangBackend::EntryPointResult>
+    {
+        auto const error_message_prefix = std::string("SLANG [") + module_key + "] ";
+        auto results = std::vector<SlangBackend::EntryPointResult>{};
+        auto fail_all = [&](std::string const & message)
+        {
+            results.clear();
+            for (usize i = 0; i < entry_points.size(); ++i)
+            {
+                results.push_back({.spirv = Result<std::vector<u32>>(error_message_prefix + message)});
+            }
+            return results;
+        };
 
-        if (SLANG_FAILED(compileRes))
+        auto module_iter = session.modules.find(module_key);
+        if (module_iter == session.modules.end())
+        {
+            auto diagnostics = Slang::ComPtr<slang::IBlob>{};
+            auto const module_name = std::string("_daxa_module_") + std::to_string(session.modules.size());
+            auto module = Slang::ComPtr<slang::IModule>{};
+            module = session.session->loadModuleFromSourceString(module_name.c_str(), "_daxa_slang_main", code.string.c_str(), diagnostics.writeRef());
+            if (module == nullptr)
+            {
+                return fail_all(slang_diagnostics(diagnostics.get()));
+            }
+            auto entry = SlangBackend::Module{.module = module};
+            auto const dependency_n = module->getDependencyFileCount();
+            for (int32_t dependency_i = 0; dependency_i < dependency_n; ++dependency_i)
+            {
+                auto const * const dep_path = module->getDependencyFilePath(dependency_i);
+                if (std::strcmp(dep_path, "_daxa_slang_main") != 0)
+                {
+                    entry.dependencies.emplace_back(dep_path, dependency_content_hash(dep_path));
+                }
+            }
+            module_iter = session.modules.emplace(module_key, std::move(entry)).first;
+        }
+        auto const & module = module_iter->second;
+        auto dependencies = std::vector<std::filesystem::path>{};
+        for (auto const & [virtual_path, virtual_file] : virtual_files)
+        {
+            dependencies.push_back(virtual_path);
+        }
+        for (auto const & dependency : module.dependencies)
         {
-            return Result<std::vector<u32>>(error_message_prefix + diagnostics);
+            dependencies.push_back(dependency.first);
         }
-        auto const dependency_n = slangRequest->getDependencyFileCount();
-        for (int32_t dependency_i = 0; dependency_i < dependency_n; ++dependency_i)
+
+        // Entry points that can not be found fail on their own, the others are still linked together.
+        results.resize(entry_points.size(), {.spirv = Result<std::vector<u32>>(std::string_view{"No shader was compiled"})});
+        auto components = std::vector<slang::IComponentType *>{module.module.get()};
+        auto entry_point_objects = std::vector<Slang::ComPtr<slang::IEntryPoint>>{};
+        auto linked_entry_points = std::vector<usize>{};
+        for (usize i = 0; i < entry_points.size(); ++i)
         {
-            auto const * const dep_path = slangRequest->getDependencyFilePath(dependency_i);
-            if (std::strcmp(dep_path, "_daxa_slang_main") != 0)
+            auto const & [entry_point_name, stage] = entry_points[i];
+            auto entry_point = Slang::ComPtr<slang::IEntryPoint>{};
+            auto diagnostics = Slang::ComPtr<slang::IBlob>{};
+            module.module->findAndCheckEntryPoint(entry_point_name.c_str(), slang_stage(stage), entry_point.writeRef(), diagnostics.writeRef());
+            if (entry_point == nullptr)
             {
-                current_observed_hotload_files->insert({dep_path, std::chrono::file_clock::now()});
+                results[i].spirv = Result<std::vector<u32>>(error_message_prefix + "Failed to find entry point '" + entry_point_name + "' in module " + slang_diagnostics(diagnostics.get()));
+                continue;
             }
+            components.push_back(entry_point.get());
+            entry_point_objects.push_back(std::move(entry_point));
+            linked_entry_points.push_back(i);
         }
-
-        Slang::ComPtr<slang::IModule> shader_module = {};
-        auto * refl = slangRequest->getReflection();
-        auto entry_point_n = spReflection_getEntryPointCount(refl);
-        int32_t entry_point_index = -1;
-        for (uint32_t i = 0; i < entry_point_n; ++i)
+        if (!linked_entry_points.empty())
         {
-            auto * entry_refl = spReflection_getEntryPointByIndex(refl, i);
-            auto const * entry_name = spReflectionEntryPoint_getName(entry_refl);
-            if (strcmp(entry_name, shader_info.compile_options.entry_point.value().c_str()) == 0)
+            auto diagnostics = Slang::ComPtr<slang::IBlob>{};
+            auto composite = Slang::ComPtr<slang::IComponentType>{};
+            session.session->createCompositeComponentType(components.data(), static_cast<SlangInt>(components.size()), composite.writeRef(), diagnostics.writeRef());
+            auto linked = Slang::ComPtr<slang::IComponentType>{};
+            if (composite != nullptr)
             {
-                entry_point_index = i;
-                break;
+                composite->link(linked.writeRef(), diagnostics.writeRef());
+            }
+            if (linked == nullptr)
+            {
+                return fail_all(slang_diagnostics(diagnostics.get()));
+            }
+            for (usize linked_i = 0; linked_i < linked_entry_points.size(); ++linked_i)
+            {
+                auto & result = results[linked_entry_points[linked_i]];
+                auto spirv_code = Slang::ComPtr<slang::IBlob>{};
+                auto code_diagnostics = Slang::ComPtr<slang::IBlob>{};
+                if (SLANG_FAILED(linked->getEntryPointCode(static_cast<SlangInt>(linked_i), 0, spirv_code.writeRef(), code_diagnostics.writeRef())) || spirv_code == nullptr)
+                {
+                    result.spirv = Result<std::vector<u32>>(error_message_prefix + slang_diagnostics(code_diagnostics.get()));
+                    continue;
+                }
+                auto result_span = std::span<u32 const>{static_cast<u32 const *>(spirv_code->getBufferPointer()), spirv_code->getBufferSize() / sizeof(u32)};
+                result.spirv = Result<std::vector<u32>>(std::vector<u32>{result_span.begin(), result_span.end()});
             }
         }
-        if (entry_point_index == -1)
+        for (auto & result : results)
         {
-            return Result<std::vector<u32>>(error_message_prefix + "Failed to find entry point '" + shader_info.compile_options.entry_point.value() + "' in module");
+            result.dependencies = dependencies;
         }
+        return results;
+    }
+#endif
 
-        slangRequest->getModule(translationUnitIndex, shader_module.writeRef());
+    auto ImplPipelineManager::get_spirv_slang([[maybe_unused]] ShaderCompileContext & context, [[maybe_unused]] ShaderStage shader_stage, [[maybe_unused]] ShaderCode const & code) -> Result<std::vector<u32>>
+    {
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+        auto const & shader_info = *context.shader_info;
+        auto const session_key = slang_session_key(shader_info);
+        auto const module_key = slang_module_key(shader_info);
+        auto entry_points = std::vector<std::pair<std::string, ShaderStage>>{{shader_info.compile_options.entry_point.value(), shader_stage}};
+
+        // Either another compile already links this entry point, or this one links all requested entry points of the module.
+        auto claimed_result = std::optional<std::shared_future<SlangBackend::EntryPointResult>>{};
+        auto promises = std::vector<std::promise<SlangBackend::EntryPointResult>>{};
+        {
+            auto lock = std::lock_guard{slang_backend.pools_mtx};
+            auto & pool = slang_backend.session_pools[session_key];
+            if (auto claim_iter = pool.claimed_entry_points.find(slang_entry_point_key(module_key, entry_points[0])); claim_iter != pool.claimed_entry_points.end())
+            {
+                claimed_result = claim_iter->second;
+            }
+            else if (auto request_iter = pool.requested_entry_points.find(module_key); request_iter != pool.requested_entry_points.end())
+            {
+                for (auto & requested : request_iter->second)
+                {
+                    auto const entry_point_key = slang_entry_point_key(module_key, requested);
+                    if (requested == entry_points[0] || pool.claimed_entry_points.contains(entry_point_key))
+                    {
+                        continue;
+                    }
+                    pool.claimed_entry_points[entry_point_key] = promises.emplace_back().get_future().share();
+                    entry_points.push_back(std::move(requested));
+                }
+                pool.requested_entry_points.erase(request_iter);
+            }
+        }
 
-        auto spirv_code = Slang::ComPtr<slang::IBlob>{};
+        auto result = SlangBackend::EntryPointResult{.spirv = Result<std::vector<u32>>(std::string_view{"No shader was compiled"})};
+        if (claimed_result.has_value())
+        {
+            result = claimed_result->get();
+        }
+        else
         {
-            auto result = slangRequest->getEntryPointCodeBlob(entry_point_index, 0, spirv_code.writeRef());
-            if (result != 0)
+            auto session = acquire_slang_session(session_key, shader_info);
+            auto results = compile_slang_entry_points(*session, module_key, code, entry_points);
+            release_slang_session(session_key, std::move(session));
+            for (usize i = 0; i < promises.size(); ++i)
             {
-                return Result<std::vector<u32>>(error_message_prefix + slangRequest->getDiagnosticOutput());
+                promises[i].set_value(std::move(results[i + 1]));
             }
+            result = std::move(results[0]);
         }
-
-        auto result_span = std::span<u32 const>{static_cast<u32 const *>(spirv_code->getBufferPointer()), spirv_code->getBufferSize() / sizeof(u32)};
-        auto result = std::vector<u32>{};
-        result.insert(result.begin(), result_span.begin(), result_span.end());
-
-        return Result<std::vector<u32>>(result);
+        for (auto & dependency : result.dependencies)
+        {
+            context.observed_hotload_files->insert({std::move(dependency), std::chrono::file_clock::now()});
+        }
+        return std::move(result.spirv);
 #else
         return Result<std::vector<u32>>("Asked for Slang compilation without enabling Slang");
 #endif
     }
 
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+    auto ImplPipelineManager::SlangBackend::acquire_global_session() -> Slang::ComPtr<slang::IGlobalSession>
+    {
+        {
+            auto lock = std::lock_guard{session_mtx};
+            if (!global_sessions.empty())
+            {
+                auto global_session = std::move(global_sessions.back());
+                global_sessions.pop_back();
+                return global_session;
+            }
+        }
+        auto global_session = Slang::ComPtr<slang::IGlobalSession>{};
+        slang::createGlobalSession(global_session.writeRef());
+        return global_session;
+    }
+
+    void ImplPipelineManager::SlangBackend::release_global_session(Slang::ComPtr<slang::IGlobalSession> && global_session)
+    {
+        auto lock = std::lock_guard{session_mtx};
+        global_sessions.push_back(std::move(global_session));
+    }
+#endif
+
     auto ImplPipelineManager::zero_ref_callback(ImplHandle const * handle)
     {
         auto const * self = r_cast<ImplPipelineManager const *>(handle);
@@ -1773,3 +3439,140 @@ namespace daxa
 } // namespace daxa
 
 #endif
+
+#if DAXA_COMPILE_PIPELINE_BUNDLE
+
+// Build tool behind the daxa_compile_pipelines CMake function. Writes the pipeline bundle of the shaders listed in a manifest.
+//
+// Manifest lines, # starts a comment:
+//   root_path <path>                   relative to the manifest
+//   language <glsl|slang>
+//   define <NAME> [VALUE]              added to every shader, like the defines of PipelineManagerInfo::shader_compile_options
+//   <stage> <path> [entry=<name>] [<NAME>[=<VALUE>]]...
+// with stage being one of comp, vert, frag, tess_ctrl, tess_eval, task, mesh, rgen, rint, rahit, rchit, rmiss or rcall.
+// The runtime pipeline manager has to use the same language and defines for the shaders to be found in the bundle.
+
+#include <daxa/utils/pipeline_manager.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+auto main(int argc, char ** argv) -> int
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <manifest> <bundle>\n";
+        return 1;
+    }
+    auto const manifest_path = std::filesystem::path{argv[1]};
+    auto manifest = std::ifstream{manifest_path};
+    if (!manifest.good())
+    {
+        std::cerr << "failed to open the manifest " << manifest_path << "\n";
+        return 1;
+    }
+
+    auto compile_options = daxa::ShaderCompileOptions{};
+#if defined(DAXA_SHADER_INCLUDE_DIR)
+    compile_options.root_paths.push_back(DAXA_SHADER_INCLUDE_DIR);
+#endif
+    auto bundle_info = daxa::PipelineBundleInfo{};
+    auto line = std::string{};
+    auto line_number = 0u;
+    while (std::getline(manifest, line))
+    {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        auto tokens = std::istringstream{line};
+        auto command = std::string{};
+        if (!(tokens >> command))
+        {
+            continue;
+        }
+        auto argument = std::string{};
+        if (!(tokens >> argument))
+        {
+            std::cerr << manifest_path.string() << ":" << line_number << ": missing argument\n";
+            return 1;
+        }
+        if (command == "root_path")
+        {
+            compile_options.root_paths.push_back(manifest_path.parent_path() / argument);
+            continue;
+        }
+        if (command == "language")
+        {
+            compile_options.language = argument == "slang" ? daxa::ShaderLanguage::SLANG : daxa::ShaderLanguage::GLSL;
+            continue;
+        }
+        if (command == "define")
+        {
+            auto value = std::string{};
+            tokens >> value;
+            compile_options.defines.push_back({argument, value});
+            continue;
+        }
+
+        auto shader_info = daxa::ShaderCompileInfo{.source = daxa::ShaderFile{argument}};
+        auto option = std::string{};
+        while (tokens >> option)
+        {
+            if (option.starts_with("entry="))
+            {
+                shader_info.compile_options.entry_point = option.substr(6);
+                continue;
+            }
+            auto const separator = option.find('=');
+            shader_info.compile_options.defines.push_back({
+                option.substr(0, separator),
+                separator == std::string::npos ? std::string{} : option.substr(separator + 1),
+            });
+        }
+        // Each line becomes its own pipeline. The bundle only stores shaders, so grouping them into real pipelines is not needed.
+        auto raster_info = daxa::RasterPipelineCompileInfo{.name = argument};
+        auto ray_tracing_info = daxa::RayTracingPipelineCompileInfo{.name = argument};
+        // clang-format off
+        if (command == "comp") { bundle_info.compute_pipelines.push_back({.shader_info = shader_info, .name = argument}); continue; }
+        if (command == "vert") { raster_info.vertex_shader_info = shader_info; }
+        else if (command == "frag") { raster_info.fragment_shader_info = shader_info; }
+        else if (command == "tess_ctrl") { raster_info.tesselation_control_shader_info = shader_info; }
+        else if (command == "tess_eval") { raster_info.tesselation_evaluation_shader_info = shader_info; }
+        else if (command == "task") { raster_info.task_shader_info = shader_info; }
+        else if (command == "mesh") { raster_info.mesh_shader_info = shader_info; }
+        else if (command == "rgen") { ray_tracing_info.ray_gen_infos.push_back(shader_info); }
+        else if (command == "rint") { ray_tracing_info.intersection_infos.push_back(shader_info); }
+        else if (command == "rahit") { ray_tracing_info.any_hit_infos.push_back(shader_info); }
+        else if (command == "rchit") { ray_tracing_info.closest_hit_infos.push_back(shader_info); }
+        else if (command == "rmiss") { ray_tracing_info.miss_hit_infos.push_back(shader_info); }
+        else if (command == "rcall") { ray_tracing_info.callable_infos.push_back(shader_info); }
+        else
+        {
+            std::cerr << manifest_path.string() << ":" << line_number << ": unknown command " << command << "\n";
+            return 1;
+        }
+        // clang-format on
+        if (command.starts_with('r'))
+        {
+            bundle_info.ray_tracing_pipelines.push_back(std::move(ray_tracing_info));
+        }
+        else
+        {
+            bundle_info.raster_pipelines.push_back(std::move(raster_info));
+        }
+    }
+
+    auto pipeline_manager = daxa::PipelineManager({
+        .shader_compile_options = compile_options,
+        .name = "pipeline_bundle_compiler",
+    });
+    auto result = pipeline_manager.write_pipeline_bundle(bundle_info, argv[2]);
+    if (result.is_err())
+    {
+        std::cerr << result.message() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+#endif
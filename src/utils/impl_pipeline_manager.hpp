@@ -2,6 +2,15 @@
 
 #include <daxa/utils/pipeline_manager.hpp>
 
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
 #undef Bool
 
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
@@ -19,6 +28,10 @@
 #include <spirv-tools/libspirv.hpp>
 #endif
 
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SPIRV_OPTIMIZATION
+#include <spirv-tools/optimizer.hpp>
+#endif
+
 namespace daxa
 {
     struct ImplDevice;
@@ -33,6 +46,51 @@ namespace daxa
 
     using VirtualFileSet = std::map<std::string, VirtualFileState>;
 
+    struct ShaderSourceCacheEntry
+    {
+        std::filesystem::file_time_type write_time;
+        std::string contents;
+    };
+
+    // Watches the directories of the hotload files with inotify or ReadDirectoryChangesW.
+    struct HotloadFileWatcher
+    {
+        struct Platform;
+        std::unique_ptr<Platform> platform = {};
+
+        HotloadFileWatcher();
+        HotloadFileWatcher(HotloadFileWatcher const &) = delete;
+        auto operator=(HotloadFileWatcher const &) -> HotloadFileWatcher & = delete;
+        ~HotloadFileWatcher();
+
+        // Returns false when the file can not be watched, it then has to be polled with last_write_time.
+        auto watch(std::filesystem::path const & file) -> bool;
+        // Undoes a successful watch. The directory watch is removed with the last watched file in it.
+        void unwatch(std::filesystem::path const & file);
+        // Appends the files written since the last call.
+        // Returns false when the OS dropped events, every watched file then has to be checked.
+        auto poll(std::vector<std::filesystem::path> & changed_files) -> bool;
+    };
+
+    struct HotloadFileNode
+    {
+        std::chrono::file_clock::time_point write_time = {};
+        bool watched = false;
+        // The pipeline_ptr objects of the pipelines including this file.
+        std::set<void const *> dependents = {};
+    };
+
+    // Maps every file any pipeline was compiled from to the pipelines depending on it.
+    using HotloadDependencyGraph = std::map<std::filesystem::path, HotloadFileNode>;
+
+    // State of a single shader compile. Every compile job owns its own, so jobs can run on any thread.
+    struct ShaderCompileContext
+    {
+        ShaderCompileInfo const * shader_info = nullptr;
+        ShaderFileTimeSet * observed_hotload_files = nullptr;
+        std::vector<std::filesystem::path> seen_shader_files = {};
+    };
+
     struct ImplPipelineManager final : ImplHandle
     {
         enum class ShaderStage
@@ -53,34 +111,76 @@ namespace daxa
         };
 
         PipelineManagerInfo info = {};
+        // Set when the device enabled ExplicitFeatureFlagBits::COOPERATIVE_MATRIX, raises the spirv targets to 1.6.
+        bool cooperative_matrix = {};
 
-        std::vector<std::filesystem::path> current_seen_shader_files = {};
-        ShaderFileTimeSet * current_observed_hotload_files = nullptr;
-
+        // Only read while compiling, add_virtual_file must not run concurrently to a compile.
         VirtualFileSet virtual_files = {};
+        std::mutex custom_preprocessor_mtx = {};
+        std::mutex shader_cache_mtx = {};
+        // The archive backends of the spirv_cache_folder options.
+        std::map<std::filesystem::path, std::shared_ptr<ShaderCacheBackend>> shader_cache_folders = {};
+        // Read only archive of info.pipeline_bundle. When set, every shader comes from it and nothing is compiled.
+        std::shared_ptr<ShaderCacheBackend> pipeline_bundle = {};
+        // Content hashes of the files read by the current batch of compiles, so each file is read once per batch.
+        std::mutex dependency_content_hashes_mtx = {};
+        std::unordered_map<std::string, uint64_t> dependency_content_hashes = {};
+        // Preprocessed contents of the loaded shader files by hotload_graph_key, so headers shared by many shaders are read once.
+        std::mutex shader_source_cache_mtx = {};
+        std::unordered_map<std::string, ShaderSourceCacheEntry> shader_source_cache = {};
 
         template <typename PipeT, typename InfoT>
         struct PipelineState
         {
+            using Pipeline = PipeT;
+            using CompileInfo = InfoT;
+
             std::shared_ptr<PipeT> pipeline_ptr;
             InfoT info;
-            std::chrono::file_clock::time_point last_hotload_time = {};
             ShaderFileTimeSet observed_hotload_files = {};
         };
 
         using ComputePipelineState = PipelineState<ComputePipeline, ComputePipelineCompileInfo>;
         using RasterPipelineState = PipelineState<RasterPipeline, RasterPipelineCompileInfo>;
         using RayTracingPipelineState = PipelineState<RayTracingPipeline, RayTracingPipelineCompileInfo>;
+        using ShaderObjectState = PipelineState<ShaderObject, ShaderObjectCompileInfo>;
 
         std::vector<ComputePipelineState> compute_pipelines;
         std::vector<RasterPipelineState> raster_pipelines;
         std::vector<RayTracingPipelineState> ray_tracing_pipelines;
+        std::vector<ShaderObjectState> shader_objects;
+
+        // The pipeline and info are copies, so the state vectors may change while a reload compiles.
+        template <typename StateT>
+        struct PipelineReload
+        {
+            std::shared_ptr<typename StateT::Pipeline> pipeline_ptr = {};
+            typename StateT::CompileInfo info = {};
+            std::optional<Result<StateT>> new_state = {};
+        };
+
+        struct PipelineReloads
+        {
+            std::vector<PipelineReload<ComputePipelineState>> compute_pipelines = {};
+            std::vector<PipelineReload<RasterPipelineState>> raster_pipelines = {};
+            std::vector<PipelineReload<RayTracingPipelineState>> ray_tracing_pipelines = {};
+            std::vector<PipelineReload<ShaderObjectState>> shader_objects = {};
+        };
+
+        struct AsyncReload
+        {
+            PipelineReloads reloads = {};
+            std::thread thread = {};
+            std::atomic_bool finished = false;
+        };
+        std::unique_ptr<AsyncReload> async_reload = {};
 
-        // TODO(grundlett): Maybe make the pipeline compiler *internally* thread-safe!
-        // This variable is accessed by the includer, which makes that not thread-safe
-        // PipelineManager is still externally thread-safe. You can create as many
-        // PipelineManagers from as many threads as you'd like!
-        ShaderCompileInfo const * current_shader_info = nullptr;
+        HotloadDependencyGraph hotload_dependency_graph = {};
+        HotloadFileWatcher hotload_file_watcher = {};
+        // Files the watcher can not report, checked with last_write_time on every poll.
+        std::set<std::filesystem::path> polled_hotload_files = {};
+        std::vector<std::filesystem::path> changed_virtual_files = {};
+        std::chrono::file_clock::time_point last_hotload_poll_time = {};
 
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
         struct GlslangBackend
@@ -92,15 +192,54 @@ namespace daxa
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
         struct SlangBackend
         {
-            // NOTE(grundlett): literally global session. Not sure if this is reasonable or not.
-            static inline Slang::ComPtr<slang::IGlobalSession> global_session;
+            // Global sessions are not thread-safe. Each compile takes one out of the pool and puts it back afterwards.
+            static inline std::vector<Slang::ComPtr<slang::IGlobalSession>> global_sessions = {};
             static inline std::mutex session_mtx = {};
+
+            static auto acquire_global_session() -> Slang::ComPtr<slang::IGlobalSession>;
+            static void release_global_session(Slang::ComPtr<slang::IGlobalSession> && global_session);
+
+            struct EntryPointResult
+            {
+                Result<std::vector<u32>> spirv;
+                std::vector<std::filesystem::path> dependencies = {};
+            };
+
+            struct Module
+            {
+                Slang::ComPtr<slang::IModule> module = {};
+                // Checked before the session is reused, imported modules are cached by the session as well.
+                std::vector<std::pair<std::filesystem::path, std::optional<uint64_t>>> dependencies = {};
+            };
+
+            // A session and the modules parsed into it. Sessions are not thread-safe, so each is used by one compile at a time.
+            struct Session
+            {
+                Slang::ComPtr<slang::IGlobalSession> global_session = {};
+                Slang::ComPtr<slang::ISession> session = {};
+                std::unordered_map<std::string, Module> modules = {};
+
+                ~Session();
+            };
+
+            // All sessions created for the same compile options.
+            struct SessionPool
+            {
+                std::vector<std::unique_ptr<Session>> idle_sessions = {};
+                // Entry points of the current batch by module. The first compile of a module compiles all of them in one link.
+                std::unordered_map<std::string, std::vector<std::pair<std::string, ShaderStage>>> requested_entry_points = {};
+                std::unordered_map<std::string, std::shared_future<EntryPointResult>> claimed_entry_points = {};
+            };
+
+            std::mutex pools_mtx = {};
+            std::unordered_map<uint64_t, SessionPool> session_pools = {};
         };
         SlangBackend slang_backend = {};
 #endif
 
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SPIRV_VALIDATION
         spvtools::SpirvTools spirv_tools = spvtools::SpirvTools{SPV_ENV_VULKAN_1_3};
+        std::mutex spirv_tools_mtx = {};
 #endif
 
         ImplPipelineManager(PipelineManagerInfo && a_info);
@@ -109,24 +248,61 @@ namespace daxa
         auto create_ray_tracing_pipeline(RayTracingPipelineCompileInfo const & a_info) -> Result<RayTracingPipelineState>;
         auto create_compute_pipeline(ComputePipelineCompileInfo const & a_info) -> Result<ComputePipelineState>;
         auto create_raster_pipeline(RasterPipelineCompileInfo const & a_info) -> Result<RasterPipelineState>;
+        auto create_shader_object(ShaderObjectCompileInfo const & a_info) -> Result<ShaderObjectState>;
         auto add_ray_tracing_pipeline(RayTracingPipelineCompileInfo const & a_info) -> Result<std::shared_ptr<RayTracingPipeline>>;
         auto add_compute_pipeline(ComputePipelineCompileInfo const & a_info) -> Result<std::shared_ptr<ComputePipeline>>;
         auto add_raster_pipeline(RasterPipelineCompileInfo const & a_info) -> Result<std::shared_ptr<RasterPipeline>>;
+        auto add_shader_object(ShaderObjectCompileInfo const & a_info) -> Result<std::shared_ptr<ShaderObject>>;
+        auto add_ray_tracing_pipelines(std::span<RayTracingPipelineCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<RayTracingPipeline>>>;
+        auto add_compute_pipelines(std::span<ComputePipelineCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<ComputePipeline>>>;
+        auto add_raster_pipelines(std::span<RasterPipelineCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<RasterPipeline>>>;
+        auto add_shader_objects(std::span<ShaderObjectCompileInfo const> a_infos) -> std::vector<Result<std::shared_ptr<ShaderObject>>>;
         void remove_ray_tracing_pipeline(std::shared_ptr<RayTracingPipeline> const & pipeline);
         void remove_compute_pipeline(std::shared_ptr<ComputePipeline> const & pipeline);
         void remove_raster_pipeline(std::shared_ptr<RasterPipeline> const & pipeline);
+        void remove_shader_object(std::shared_ptr<ShaderObject> const & shader_object);
         void add_virtual_file(VirtualFileInfo const & virtual_info);
         auto reload_all() -> PipelineReloadResult;
+        auto reload_all_async() -> bool;
+        auto poll_reload() -> PipelineReloadResult;
+        auto collect_pipeline_reloads() -> PipelineReloads;
+        void compile_pipeline_reloads(PipelineReloads & reloads);
+        auto apply_pipeline_reloads(PipelineReloads & reloads) -> PipelineReloadResult;
+        void wait_for_async_reload();
+        auto hotload_graph_key(std::filesystem::path const & path) const -> std::filesystem::path;
+        void add_hotload_dependencies(void const * pipeline, ShaderFileTimeSet const & files);
+        void remove_hotload_dependencies(void const * pipeline, ShaderFileTimeSet const & files);
+        auto collect_changed_hotload_dependents() -> std::unordered_set<void const *>;
         auto all_pipelines_valid() const -> bool;
 
-        auto try_load_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash) -> Result<std::vector<u32>>;
-        void save_shader_cache(std::filesystem::path const & out_folder, uint64_t shader_info_hash, std::vector<u32> const & spirv);
-        auto full_path_to_file(std::filesystem::path const & path) -> Result<std::filesystem::path>;
-        auto load_shader_source_from_file(std::filesystem::path const & path) -> Result<ShaderCode>;
+        // Calls job(i) for every i below job_count, spread over up to info.compile_thread_count threads including the calling one.
+        void run_compile_jobs(usize job_count, std::function<void(usize)> const & job) const;
+
+        auto dependency_content_hash(std::filesystem::path const & path) -> std::optional<uint64_t>;
+        void begin_dependency_content_hashing();
+        auto shader_cache_backend(ShaderCompileInfo const & shader_info) -> std::shared_ptr<ShaderCacheBackend>;
+        void load_pipeline_bundle(std::filesystem::path const & path);
+        auto load_from_pipeline_bundle(ShaderCompileInfo const & shader_info, std::string const & debug_name, ShaderStage shader_stage) -> Result<std::vector<u32>>;
+        auto write_pipeline_bundle(PipelineBundleInfo const & bundle_info, std::filesystem::path const & path) -> Result<void>;
+        auto try_load_shader_cache(ShaderCompileContext & context, ShaderCacheBackend & backend, uint64_t shader_info_hash) -> Result<std::vector<u32>>;
+        void save_shader_cache(ShaderCompileContext & context, ShaderCacheBackend & backend, uint64_t shader_info_hash, std::vector<u32> const & spirv);
+        auto full_path_to_file(std::filesystem::path const & path, ShaderCompileInfo const * shader_info = nullptr) -> Result<std::filesystem::path>;
+        auto load_shader_source_from_file(ShaderCompileContext & context, std::filesystem::path const & path) -> Result<ShaderCode>;
+        void invalidate_shader_source(std::filesystem::path const & key);
 
-        auto get_spirv(ShaderCompileInfo const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage) -> Result<std::vector<u32>>;
-        auto get_spirv_glslang(ShaderCompileInfo const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage, ShaderCode const & code) -> Result<std::vector<u32>>;
-        auto get_spirv_slang(ShaderCompileInfo const & shader_info, ShaderStage shader_stage, ShaderCode const & code) -> Result<std::vector<u32>>;
+        auto get_spirv(ShaderCompileInfo const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage, ShaderFileTimeSet & observed_hotload_files) -> Result<std::vector<u32>>;
+        auto get_spirv_glslang(ShaderCompileContext & context, std::string const & debug_name_opt, ShaderStage shader_stage, ShaderCode const & code) -> Result<std::vector<u32>>;
+        auto get_spirv_slang(ShaderCompileContext & context, ShaderStage shader_stage, ShaderCode const & code) -> Result<std::vector<u32>>;
+        auto optimize_spirv(ShaderCompileOptions const & compile_options, std::string const & debug_name, std::vector<u32> && spirv) -> Result<std::vector<u32>>;
+        void request_slang_entry_point(ShaderCompileInfo const & shader_info, ShaderStage shader_stage);
+        void end_slang_batch();
+        void reset_slang_sessions();
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+        auto slang_module_key(ShaderCompileInfo const & shader_info) -> std::string;
+        auto acquire_slang_session(uint64_t session_key, ShaderCompileInfo const & shader_info) -> std::unique_ptr<SlangBackend::Session>;
+        void release_slang_session(uint64_t session_key, std::unique_ptr<SlangBackend::Session> && session);
+        auto compile_slang_entry_points(SlangBackend::Session & session, std::string const & module_key, ShaderCode const & code, std::span<std::pair<std::string, ShaderStage> const> entry_points) -> std::vector<SlangBackend::EntryPointResult>;
+#endif
 
         static auto zero_ref_callback(ImplHandle const * handle);
     };
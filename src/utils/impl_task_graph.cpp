@@ -1,33 +1,83 @@
 #if DAXA_BUILT_WITH_UTILS_TASK_GRAPH
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
 #include <iostream>
-#include <set>
+#include <numeric>
+#include <thread>
 
 #include <utility>
 
+#include <daxa/utils/gpu_arena.inl>
+#include <daxa/resource_pool_view.hpp>
+
 #include "impl_task_graph.hpp"
 #include "impl_task_graph_debug.hpp"
+#include "../impl_profiling.hpp"
 
 namespace daxa
 {
-    auto TaskInterface::get(TaskBufferAttachmentIndex index) const -> TaskBufferAttachmentInfo const &
+    auto static attachment_view_lookup_key(TaskGPUResourceView const & view) -> u64
     {
-        return attachment_infos[index.value].value.buffer;
+        return (static_cast<u64>(view.task_graph_index) << 32) | static_cast<u64>(view.index);
     }
 
-    auto TaskInterface::get(TaskBufferView view) const -> TaskBufferAttachmentInfo const &
+    auto static attachment_matches_view(TaskAttachmentInfo const & attachment, TaskBufferView const & view) -> bool
+    {
+        return attachment.type == TaskAttachmentType::BUFFER && (attachment.value.buffer.view == view || attachment.value.buffer.translated_view == view);
+    }
+
+    auto static attachment_matches_view(TaskAttachmentInfo const & attachment, TaskBlasView const & view) -> bool
+    {
+        return attachment.type == TaskAttachmentType::BLAS && (attachment.value.blas.view == view || attachment.value.blas.translated_view == view);
+    }
+
+    auto static attachment_matches_view(TaskAttachmentInfo const & attachment, TaskTlasView const & view) -> bool
+    {
+        return attachment.type == TaskAttachmentType::TLAS && (attachment.value.tlas.view == view || attachment.value.tlas.translated_view == view);
+    }
+
+    auto static attachment_matches_view(TaskAttachmentInfo const & attachment, TaskImageView const & view) -> bool
+    {
+        return attachment.type == TaskAttachmentType::IMAGE && (attachment.value.image.view == view || attachment.value.image.translated_view == view);
+    }
+
+    // Tasks with many attachments query by view often, the lookup narrows the search down to the attachments of the resource.
+    template <typename ViewT>
+    auto static find_attachment_by_view(
+        std::span<TaskAttachmentInfo const> attachment_infos,
+        std::span<TaskAttachmentViewLookupEntry const> lookup,
+        ViewT const & view,
+        [[maybe_unused]] char const * error_message) -> TaskAttachmentInfo const &
     {
-        auto iter = std::find_if(attachment_infos.begin(), attachment_infos.end(), [&](auto const & other)
-                                 { 
-            if (other.type == TaskAttachmentType::BUFFER)
+        if (!lookup.empty())
+        {
+            u64 const key = attachment_view_lookup_key(view);
+            auto iter = std::lower_bound(lookup.begin(), lookup.end(), key, [](TaskAttachmentViewLookupEntry const & entry, u64 k)
+                                         { return entry.key < k; });
+            for (; iter != lookup.end() && iter->key == key; ++iter)
             {
-                return other.value.buffer.view == view || other.value.buffer.translated_view == view;
+                if (attachment_matches_view(attachment_infos[iter->attachment_index], view))
+                {
+                    return attachment_infos[iter->attachment_index];
+                }
             }
-            return false; });
-        DAXA_DBG_ASSERT_TRUE_M(iter != attachment_infos.end(), "Detected invalid task buffer view as index for attachment!");
+        }
+        auto iter = std::find_if(attachment_infos.begin(), attachment_infos.end(), [&](TaskAttachmentInfo const & other)
+                                 { return attachment_matches_view(other, view); });
+        DAXA_DBG_ASSERT_TRUE_M(iter != attachment_infos.end(), error_message);
+        return *iter;
+    }
+
+    auto TaskInterface::get(TaskBufferAttachmentIndex index) const -> TaskBufferAttachmentInfo const &
+    {
+        return attachment_infos[index.value].value.buffer;
+    }
 
-        return iter->value.buffer;
+    auto TaskInterface::get(TaskBufferView view) const -> TaskBufferAttachmentInfo const &
+    {
+        return find_attachment_by_view(attachment_infos, attachment_view_lookup, view, "Detected invalid task buffer view as index for attachment!").value.buffer;
     }
 
     auto TaskInterface::get(TaskBlasAttachmentIndex index) const -> TaskBlasAttachmentInfo const &
@@ -37,16 +87,7 @@ namespace daxa
 
     auto TaskInterface::get(TaskBlasView view) const -> TaskBlasAttachmentInfo const &
     {
-        auto iter = std::find_if(attachment_infos.begin(), attachment_infos.end(), [&](auto const & other)
-                                 { 
-            if (other.type == TaskAttachmentType::BLAS)
-            {
-                return other.value.blas.view == view || other.value.blas.translated_view == view;
-            }
-            return false; });
-        DAXA_DBG_ASSERT_TRUE_M(iter != attachment_infos.end(), "Detected invalid task blas view as index for attachment!");
-
-        return iter->value.blas;
+        return find_attachment_by_view(attachment_infos, attachment_view_lookup, view, "Detected invalid task blas view as index for attachment!").value.blas;
     }
     
     auto TaskInterface::get(TaskTlasAttachmentIndex index) const -> TaskTlasAttachmentInfo const &
@@ -56,16 +97,7 @@ namespace daxa
 
     auto TaskInterface::get(TaskTlasView view) const -> TaskTlasAttachmentInfo const &
     {
-        auto iter = std::find_if(attachment_infos.begin(), attachment_infos.end(), [&](auto const & other)
-                                 { 
-            if (other.type == TaskAttachmentType::TLAS)
-            {
-                return other.value.tlas.view == view || other.value.tlas.translated_view == view;
-            }
-            return false; });
-        DAXA_DBG_ASSERT_TRUE_M(iter != attachment_infos.end(), "Detected invalid task tlas view as index for attachment!");
-
-        return iter->value.tlas;
+        return find_attachment_by_view(attachment_infos, attachment_view_lookup, view, "Detected invalid task tlas view as index for attachment!").value.tlas;
     }
 
     auto TaskInterface::get(TaskImageAttachmentIndex index) const -> TaskImageAttachmentInfo const &
@@ -75,15 +107,7 @@ namespace daxa
 
     auto TaskInterface::get(TaskImageView view) const -> TaskImageAttachmentInfo const &
     {
-        auto iter = std::find_if(attachment_infos.begin(), attachment_infos.end(), [&](auto const & other)
-                                 { 
-            if (other.type == TaskAttachmentType::IMAGE)
-            {
-                return other.value.image.view == view || other.value.image.translated_view == view;
-            }
-            return false; });
-        DAXA_DBG_ASSERT_TRUE_M(iter != attachment_infos.end(), "Detected invalid task buffer view as index for attachment!");
-        return iter->value.image;
+        return find_attachment_by_view(attachment_infos, attachment_view_lookup, view, "Detected invalid task image view as index for attachment!").value.image;
     }
 
     auto TaskInterface::get(usize index) const -> TaskAttachmentInfo const &
@@ -169,6 +193,14 @@ namespace daxa
         case TaskImageAccess::STENCIL_ATTACHMENT_READ: [[fallthrough]];
         case TaskImageAccess::DEPTH_STENCIL_ATTACHMENT_READ:
             return ImageUsageFlagBits::DEPTH_STENCIL_ATTACHMENT;
+        case TaskImageAccess::VIDEO_DECODE_WRITE:
+            return ImageUsageFlagBits::VIDEO_DECODE_DST;
+        case TaskImageAccess::VIDEO_DECODE_DPB:
+            return ImageUsageFlagBits::VIDEO_DECODE_DPB;
+        case TaskImageAccess::VIDEO_ENCODE_READ:
+            return ImageUsageFlagBits::VIDEO_ENCODE_SRC;
+        case TaskImageAccess::VIDEO_ENCODE_DPB:
+            return ImageUsageFlagBits::VIDEO_ENCODE_DPB;
         case TaskImageAccess::PRESENT: [[fallthrough]];
         case TaskImageAccess::NONE: [[fallthrough]];
         default:
@@ -259,6 +291,11 @@ namespace daxa
         case TaskImageAccess::DEPTH_STENCIL_ATTACHMENT_READ: return {ImageLayout::READ_ONLY_OPTIMAL, {PipelineStageFlagBits::EARLY_FRAGMENT_TESTS | PipelineStageFlagBits::LATE_FRAGMENT_TESTS, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
         case TaskImageAccess::RESOLVE_WRITE: return {ImageLayout::ATTACHMENT_OPTIMAL, {PipelineStageFlagBits::RESOLVE, AccessTypeFlagBits::WRITE}, TaskAccessConcurrency::EXCLUSIVE};
         case TaskImageAccess::PRESENT: return {ImageLayout::PRESENT_SRC, {PipelineStageFlagBits::ALL_COMMANDS, AccessTypeFlagBits::READ}, TaskAccessConcurrency::EXCLUSIVE};
+        // See task_buffer_access_to_access for why the video stages are not used.
+        case TaskImageAccess::VIDEO_DECODE_WRITE: return {ImageLayout::VIDEO_DECODE_DST, {PipelineStageFlagBits::ALL_COMMANDS, AccessTypeFlagBits::WRITE}, TaskAccessConcurrency::EXCLUSIVE};
+        case TaskImageAccess::VIDEO_DECODE_DPB: return {ImageLayout::VIDEO_DECODE_DPB, {PipelineStageFlagBits::ALL_COMMANDS, AccessTypeFlagBits::READ_WRITE}, TaskAccessConcurrency::EXCLUSIVE};
+        case TaskImageAccess::VIDEO_ENCODE_READ: return {ImageLayout::VIDEO_ENCODE_SRC, {PipelineStageFlagBits::ALL_COMMANDS, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
+        case TaskImageAccess::VIDEO_ENCODE_DPB: return {ImageLayout::VIDEO_ENCODE_DPB, {PipelineStageFlagBits::ALL_COMMANDS, AccessTypeFlagBits::READ_WRITE}, TaskAccessConcurrency::EXCLUSIVE};
         default: DAXA_DBG_ASSERT_TRUE_M(false, "unreachable");
         }
         return {};
@@ -318,9 +355,16 @@ namespace daxa
         case TaskBufferAccess::HOST_TRANSFER_WRITE: return {{PipelineStageFlagBits::HOST, AccessTypeFlagBits::WRITE}, TaskAccessConcurrency::EXCLUSIVE};
         case TaskBufferAccess::INDEX_READ: return {{PipelineStageFlagBits::INDEX_INPUT, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
         case TaskBufferAccess::DRAW_INDIRECT_INFO_READ: return {{PipelineStageFlagBits::DRAW_INDIRECT, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
+        case TaskBufferAccess::CONDITIONAL_RENDERING_READ: return {{PipelineStageFlagBits::CONDITIONAL_RENDERING, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
         case TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_READ: return {{PipelineStageFlagBits::ACCELERATION_STRUCTURE_BUILD, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
         case TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_WRITE: return {{PipelineStageFlagBits::ACCELERATION_STRUCTURE_BUILD, AccessTypeFlagBits::WRITE}, TaskAccessConcurrency::EXCLUSIVE};
         case TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_READ_WRITE: return {{PipelineStageFlagBits::ACCELERATION_STRUCTURE_BUILD, AccessTypeFlagBits::READ_WRITE}, TaskAccessConcurrency::EXCLUSIVE};
+        case TaskBufferAccess::MICROMAP_BUILD_READ: return {{PipelineStageFlagBits::MICROMAP_BUILD, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
+        case TaskBufferAccess::MICROMAP_BUILD_WRITE: return {{PipelineStageFlagBits::MICROMAP_BUILD, AccessTypeFlagBits::WRITE}, TaskAccessConcurrency::EXCLUSIVE};
+        // Video accesses are synchronized with ALL_COMMANDS, the barriers are recorded on the main queue which lacks the video stages.
+        // The timeline semaphores between the queues order the video work against them.
+        case TaskBufferAccess::VIDEO_DECODE_READ: return {{PipelineStageFlagBits::ALL_COMMANDS, AccessTypeFlagBits::READ}, TaskAccessConcurrency::CONCURRENT};
+        case TaskBufferAccess::VIDEO_ENCODE_WRITE: return {{PipelineStageFlagBits::ALL_COMMANDS, AccessTypeFlagBits::WRITE}, TaskAccessConcurrency::EXCLUSIVE};
         default: DAXA_DBG_ASSERT_TRUE_M(false, "unreachable");
         }
         return {};
@@ -380,13 +424,18 @@ namespace daxa
         case daxa::TaskBufferAccess::FRAGMENT_SHADER_READ_WRITE: return std::string_view{"FRAGMENT_SHADER_READ_WRITE"};
         case daxa::TaskBufferAccess::INDEX_READ: return std::string_view{"INDEX_READ"};
         case daxa::TaskBufferAccess::DRAW_INDIRECT_INFO_READ: return std::string_view{"DRAW_INDIRECT_INFO_READ"};
+        case daxa::TaskBufferAccess::CONDITIONAL_RENDERING_READ: return std::string_view{"CONDITIONAL_RENDERING_READ"};
         case daxa::TaskBufferAccess::TRANSFER_READ: return std::string_view{"TRANSFER_READ"};
         case daxa::TaskBufferAccess::TRANSFER_WRITE: return std::string_view{"TRANSFER_WRITE"};
         case daxa::TaskBufferAccess::HOST_TRANSFER_READ: return std::string_view{"HOST_TRANSFER_READ"};
         case daxa::TaskBufferAccess::HOST_TRANSFER_WRITE: return std::string_view{"HOST_TRANSFER_WRITE"};
-        case daxa::TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_READ: return std::string_view{"HOST_TACCELERATION_STRUCTURE_BUILD_READRANSFER_WRITE"};
+        case daxa::TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_READ: return std::string_view{"ACCELERATION_STRUCTURE_BUILD_READ"};
         case daxa::TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_WRITE: return std::string_view{"ACCELERATION_STRUCTURE_BUILD_WRITE"};
         case daxa::TaskBufferAccess::ACCELERATION_STRUCTURE_BUILD_READ_WRITE: return std::string_view{"ACCELERATION_STRUCTURE_BUILD_READ_WRITE"};
+        case daxa::TaskBufferAccess::MICROMAP_BUILD_READ: return std::string_view{"MICROMAP_BUILD_READ"};
+        case daxa::TaskBufferAccess::MICROMAP_BUILD_WRITE: return std::string_view{"MICROMAP_BUILD_WRITE"};
+        case daxa::TaskBufferAccess::VIDEO_DECODE_READ: return std::string_view{"VIDEO_DECODE_READ"};
+        case daxa::TaskBufferAccess::VIDEO_ENCODE_WRITE: return std::string_view{"VIDEO_ENCODE_WRITE"};
         case daxa::TaskBufferAccess::MAX_ENUM: return std::string_view{"MAX_ENUM"};
         default: DAXA_DBG_ASSERT_TRUE_M(false, "unreachable");
         }
@@ -458,6 +507,10 @@ namespace daxa
         case daxa::TaskImageAccess::STENCIL_ATTACHMENT_READ: return std::string_view{"STENCIL_ATTACHMENT_READ"};
         case daxa::TaskImageAccess::DEPTH_STENCIL_ATTACHMENT_READ: return std::string_view{"DEPTH_STENCIL_ATTACHMENT_READ"};
         case daxa::TaskImageAccess::RESOLVE_WRITE: return std::string_view{"RESOLVE_WRITE"};
+        case daxa::TaskImageAccess::VIDEO_DECODE_WRITE: return std::string_view{"VIDEO_DECODE_WRITE"};
+        case daxa::TaskImageAccess::VIDEO_DECODE_DPB: return std::string_view{"VIDEO_DECODE_DPB"};
+        case daxa::TaskImageAccess::VIDEO_ENCODE_READ: return std::string_view{"VIDEO_ENCODE_READ"};
+        case daxa::TaskImageAccess::VIDEO_ENCODE_DPB: return std::string_view{"VIDEO_ENCODE_DPB"};
         case daxa::TaskImageAccess::PRESENT: return std::string_view{"PRESENT"};
         case daxa::TaskImageAccess::MAX_ENUM: return std::string_view{"MAX_ENUM"};
         default: DAXA_DBG_ASSERT_TRUE_M(false, "unreachable");
@@ -558,6 +611,7 @@ namespace daxa
     void TaskBuffer::set_buffers(TrackedBuffers const & buffers)
     {
         auto & impl = *r_cast<ImplPersistentTaskBufferBlasTlas *>(this->object);
+        std::unique_lock const lock{impl.mtx};
         auto & actual_buffers = std::get<std::vector<BufferId>>(impl.actual_ids);
         actual_buffers.clear();
         actual_buffers.insert(actual_buffers.end(), buffers.buffers.begin(), buffers.buffers.end());
@@ -569,6 +623,7 @@ namespace daxa
         auto & impl = *r_cast<ImplPersistentTaskBufferBlasTlas *>(this->object);
         auto & actual_buffers = std::get<std::vector<BufferId>>(impl.actual_ids);
         auto & impl_other = *r_cast<ImplPersistentTaskBufferBlasTlas *>(other.object);
+        std::scoped_lock const lock{impl.mtx, impl_other.mtx};
         auto & other_actual_buffers = std::get<std::vector<BufferId>>(impl_other.actual_ids);
         std::swap(actual_buffers, other_actual_buffers);
         std::swap(impl.latest_access, impl_other.latest_access);
@@ -625,6 +680,7 @@ namespace daxa
     void TaskBlas::set_blas(TrackedBlas const & other_tracked)
     {
         auto & impl = *r_cast<ImplPersistentTaskBufferBlasTlas *>(this->object);
+        std::unique_lock const lock{impl.mtx};
         auto & actual_ids = std::get<std::vector<BlasId>>(impl.actual_ids);
         actual_ids.clear();
         actual_ids.insert(actual_ids.end(), other_tracked.blas.begin(), other_tracked.blas.end());
@@ -636,6 +692,7 @@ namespace daxa
         auto & impl = *r_cast<ImplPersistentTaskBufferBlasTlas *>(this->object);
         auto & actual_buffers = std::get<std::vector<BlasId>>(impl.actual_ids);
         auto & impl_other = *r_cast<ImplPersistentTaskBufferBlasTlas *>(other.object);
+        std::scoped_lock const lock{impl.mtx, impl_other.mtx};
         auto & other_actual_buffers = std::get<std::vector<BlasId>>(impl_other.actual_ids);
         std::swap(actual_buffers, other_actual_buffers);
         std::swap(impl.latest_access, impl_other.latest_access);
@@ -692,6 +749,7 @@ namespace daxa
     void TaskTlas::set_tlas(TrackedTlas const & other_tracked)
     {
         auto & impl = *r_cast<ImplPersistentTaskBufferBlasTlas *>(this->object);
+        std::unique_lock const lock{impl.mtx};
         auto & actual_ids = std::get<std::vector<TlasId>>(impl.actual_ids);
         actual_ids.clear();
         actual_ids.insert(actual_ids.end(), other_tracked.tlas.begin(), other_tracked.tlas.end());
@@ -703,6 +761,7 @@ namespace daxa
         auto & impl = *r_cast<ImplPersistentTaskBufferBlasTlas *>(this->object);
         auto & actual_buffers = std::get<std::vector<TlasId>>(impl.actual_ids);
         auto & impl_other = *r_cast<ImplPersistentTaskBufferBlasTlas *>(other.object);
+        std::scoped_lock const lock{impl.mtx, impl_other.mtx};
         auto & other_actual_ids = std::get<std::vector<TlasId>>(impl_other.actual_ids);
         std::swap(actual_buffers, other_actual_ids);
         std::swap(impl.latest_access, impl_other.latest_access);
@@ -722,6 +781,93 @@ namespace daxa
 
     // --- TaskTlas End --- 
 
+    // --- TransientMemoryHeap ---
+
+    TransientMemoryHeap::TransientMemoryHeap(TransientMemoryHeapInfo const & info)
+    {
+        this->object = new ImplTransientMemoryHeap{};
+        this->object->info = info;
+    }
+
+    auto TransientMemoryHeap::info() const -> TransientMemoryHeapInfo const &
+    {
+        return this->object->info;
+    }
+
+    auto TransientMemoryHeap::size() const -> usize
+    {
+        usize size = 0;
+        for (auto const & heap : this->object->heaps)
+        {
+            size += heap.memory_block_size;
+        }
+        return size;
+    }
+
+    auto TransientMemoryHeap::inc_refcnt(ImplHandle const * object) -> u64
+    {
+        return object->inc_refcnt();
+    }
+
+    auto TransientMemoryHeap::dec_refcnt(ImplHandle const * object) -> u64
+    {
+        return object->dec_refcnt(
+            ImplTransientMemoryHeap::zero_ref_callback,
+            nullptr);
+    }
+
+    void ImplTransientMemoryHeap::reserve(TransientHeap const & transient_heap)
+    {
+        for (auto & heap : heaps)
+        {
+            if (heap.memory_type_bits == transient_heap.memory_type_bits)
+            {
+                heap.alignment = std::max(heap.alignment, transient_heap.alignment);
+                heap.reserved_size = std::max(heap.reserved_size, transient_heap.size);
+                return;
+            }
+        }
+        heaps.push_back(Heap{
+            .memory_type_bits = transient_heap.memory_type_bits,
+            .alignment = transient_heap.alignment,
+            .reserved_size = transient_heap.size,
+        });
+    }
+
+    auto ImplTransientMemoryHeap::acquire(u32 memory_type_bits) -> MemoryBlock
+    {
+        for (auto & heap : heaps)
+        {
+            if (heap.memory_type_bits != memory_type_bits)
+            {
+                continue;
+            }
+            if (heap.memory_block_size < heap.reserved_size)
+            {
+                heap.memory_block = info.device.create_memory({
+                    .requirements = {
+                        .size = heap.reserved_size,
+                        .alignment = heap.alignment,
+                        .memory_type_bits = heap.memory_type_bits,
+                    },
+                    .flags = MemoryFlagBits::DEDICATED_MEMORY,
+                });
+                heap.memory_block_size = heap.reserved_size;
+            }
+            return heap.memory_block;
+        }
+        DAXA_DBG_ASSERT_TRUE_M(false, "transient memory must be reserved before it is acquired");
+        return {};
+    }
+
+    void ImplTransientMemoryHeap::zero_ref_callback(ImplHandle const * handle)
+    {
+        auto const * self = r_cast<ImplTransientMemoryHeap const *>(handle);
+        delete self;
+    }
+
+    // --- TransientMemoryHeap End ---
+
     TaskImage::TaskImage(TaskImageInfo const & a_info)
     {
         this->object = new ImplPersistentTaskImage(a_info);
@@ -772,6 +918,7 @@ namespace daxa
     void TaskImage::set_images(TrackedImages const & images)
     {
         auto & impl = *r_cast<ImplPersistentTaskImage *>(this->object);
+        std::unique_lock const lock{impl.mtx};
         DAXA_DBG_ASSERT_TRUE_M(!impl.info.swapchain_image || (images.images.size() == 1), "swapchain task image can only have at most one runtime image");
         impl.actual_images.clear();
         impl.actual_images.insert(impl.actual_images.end(), images.images.begin(), images.images.end());
@@ -784,6 +931,7 @@ namespace daxa
     {
         auto & impl = *r_cast<ImplPersistentTaskImage *>(this->object);
         auto & impl_other = *r_cast<ImplPersistentTaskImage *>(other.object);
+        std::scoped_lock const lock{impl.mtx, impl_other.mtx};
         DAXA_DBG_ASSERT_TRUE_M(!impl.info.swapchain_image || (impl_other.actual_images.size() <= 1), "swapchain task image can only have at most one runtime image");
         std::swap(impl.actual_images, impl_other.actual_images);
         std::swap(impl.latest_slice_states, impl_other.latest_slice_states);
@@ -806,7 +954,11 @@ namespace daxa
     {
         this->object = new ImplTaskGraph(info);
         auto & impl = *r_cast<ImplTaskGraph *>(this->object);
-        impl.permutations.resize(usize{1} << info.permutation_condition_count);
+        // Jit compiled permutations are only created once they are executed.
+        if (!info.jit_compile_permutations)
+        {
+            impl.permutations.resize(usize{1} << info.permutation_condition_count);
+        }
         for (auto & permutation : impl.permutations)
         {
             permutation.batch_submit_scopes.push_back({});
@@ -925,12 +1077,46 @@ namespace daxa
         }
         auto const & info_copy = info; // NOTE: (HACK) we must do this because msvc designated init bugs causing it to not generate copy constructors.
         impl.global_buffer_infos.emplace_back(PermIndepTaskBufferInfo{
-            .task_buffer_data = PermIndepTaskBufferInfo::Transient{.info = info_copy}});
+            .task_buffer_data = PermIndepTaskBufferInfo::Transient{
+                .info = info_copy,
+                .condition = {impl.record_active_conditional_scopes, impl.record_conditional_states},
+            }});
 
         impl.buffer_name_to_id[info.name] = task_buffer_id;
         return task_buffer_id;
     }
 
+    auto TaskGraph::create_transient_gpu_arena(TaskTransientGpuArenaInfo const & info) -> TaskBufferView
+    {
+        u32 const capacity = (info.capacity + (DAXA_GPU_ARENA_ALIGNMENT - 1)) & ~static_cast<u32>(DAXA_GPU_ARENA_ALIGNMENT - 1);
+        TaskBufferView const arena = create_transient_buffer({
+            .size = DAXA_GPU_ARENA_HEADER_SIZE + capacity,
+            .name = info.name,
+        });
+        // Transient memory is aliased between executions, so the header must be written every execution.
+        add_task(InlineTaskInfo{
+            .attachments = {inl_attachment(TaskBufferAccess::TRANSFER_WRITE, arena)},
+            .task = [capacity](TaskInterface ti)
+            {
+                auto header = ti.allocator->allocate_fill(daxa_GpuArena{
+                                                              .offset = 0,
+                                                              .capacity = capacity,
+                                                              .failed_allocation_count = 0,
+                                                              .padding = 0,
+                                                          })
+                                  .value();
+                ti.recorder.copy_buffer_to_buffer({
+                    .src_buffer = header.buffer,
+                    .dst_buffer = ti.get(TaskBufferAttachmentIndex{0}).ids[0],
+                    .src_offset = header.buffer_offset,
+                    .size = sizeof(daxa_GpuArena),
+                });
+            },
+            .name = info.name + " reset",
+        });
+        return arena;
+    }
+
     auto TaskGraph::create_transient_image(TaskTransientImageInfo const & info) -> TaskImageView
     {
         auto & impl = *reinterpret_cast<ImplTaskGraph *>(this->object);
@@ -957,6 +1143,7 @@ namespace daxa
         impl.global_image_infos.emplace_back(PermIndepTaskImageInfo{
             .task_image_data = PermIndepTaskImageInfo::Transient{
                 .info = info_copy,
+                .condition = {impl.record_active_conditional_scopes, impl.record_conditional_states},
             }});
         impl.image_name_to_id[info.name] = task_image_view;
         return task_image_view;
@@ -994,8 +1181,10 @@ namespace daxa
         auto const & global_image = global_image_infos.at(id.index);
         if (global_image.is_persistent())
         {
-            return {global_image.get_persistent().actual_images.data(),
-                    global_image.get_persistent().actual_images.size()};
+            auto const & actual_images = recording_context != nullptr && recording_context->task_graph == this
+                                             ? recording_context->persistent_images.at(id.index)
+                                             : global_image.get_persistent().actual_images;
+            return {actual_images.data(), actual_images.size()};
         }
         else
         {
@@ -1081,7 +1270,7 @@ namespace daxa
         }
     }
 
-    void ImplTaskGraph::update_image_view_cache(ImplTask & task, TaskGraphPermutation const & permutation)
+    void ImplTaskGraph::update_image_view_cache(ImplTask const & task, ImplTaskExecutionState & task_state, TaskGraphPermutation const & permutation)
     {
         for_each(
             task.base_task->attachments(),
@@ -1090,8 +1279,8 @@ namespace daxa
             {
                 // TODO:
                 // Replace the validity check with a comparison of last execution actual images vs this frame actual images.
-                auto & view_cache = task.image_view_cache[task_image_attach_index];
-                auto & imgs_last_exec = task.runtime_images_last_execution[task_image_attach_index];
+                auto & view_cache = task_state.image_view_cache[task_image_attach_index];
+                auto & imgs_last_exec = task_state.runtime_images_last_execution[task_image_attach_index];
 
                 if (image_attach.view.is_null())
                 {
@@ -1131,15 +1320,7 @@ namespace daxa
                     validate_image_attachs(*this, permutation, task_image_attach_index, tid.index, image_attach.access, task.base_task->name());
                     for (auto & view : view_cache)
                     {
-                        if (info.device.is_id_valid(view))
-                        {
-                            ImageViewId const parent_image_default_view = info.device.image_view_info(view).value().image.default_view();
-                            // Can not destroy the default view of an image!!!
-                            if (parent_image_default_view != view)
-                            {
-                                info.device.destroy_image_view(view);
-                            }
-                        }
+                        release_image_view(view);
                     }
                     view_cache.clear();
                     if (image_attach.shader_array_type == TaskHeadImageArrayType::RUNTIME_IMAGES)
@@ -1157,20 +1338,9 @@ namespace daxa
                                 printf("bruh image\n");
                             }
 
-                            // When the use image view parameters match the default view,
-                            // then use the default view id and avoid creating a new id here.
-                            bool const is_use_default_slice = view_info.slice == slice;
-                            bool const is_use_default_view_type = use_view_type == view_info.type;
-                            if (is_use_default_slice && is_use_default_view_type)
-                            {
-                                view_cache.push_back(parent.default_view());
-                            }
-                            else
-                            {
-                                view_info.type = use_view_type;
-                                view_info.slice = slice;
-                                view_cache.push_back(info.device.create_image_view(view_info));
-                            }
+                            view_info.type = use_view_type;
+                            view_info.slice = slice;
+                            view_cache.push_back(acquire_image_view(view_info));
                         }
                     }
                     else // image_attach.shader_array_type == TaskHeadImageArrayType::MIP_LEVELS
@@ -1186,7 +1356,7 @@ namespace daxa
                             view_info.slice = image_attach.translated_view.slice;
                             view_info.slice.base_mip_level = base_mip_level + index;
                             view_info.slice.level_count = 1;
-                            view_cache.push_back(info.device.create_image_view(view_info));
+                            view_cache.push_back(acquire_image_view(view_info));
                         }
                         // When the slice is smaller then the array size,
                         // The indices larger then the size are filled with 0 ids.
@@ -1199,6 +1369,131 @@ namespace daxa
             });
     }
 
+    auto ImplTaskGraph::acquire_image_view(ImageViewInfo const & view_info) -> ImageViewId
+    {
+        // When the use image view parameters match the default view,
+        // then use the default view id and avoid creating a new id here.
+        ImageViewInfo const default_view_info = info.device.image_view_info(view_info.image.default_view()).value();
+        if (default_view_info.slice == view_info.slice && default_view_info.type == view_info.type)
+        {
+            return view_info.image.default_view();
+        }
+        // Tasks may be recorded on multiple threads.
+        std::unique_lock const lock{image_views_mtx};
+        auto & cached = image_views[ImageViewCacheKey{.image = view_info.image, .slice = view_info.slice, .type = view_info.type}];
+        if (cached.view.is_empty())
+        {
+            cached.view = info.device.create_image_view(view_info);
+        }
+        cached.use_count += 1;
+        return cached.view;
+    }
+
+    void ImplTaskGraph::release_image_view(ImageViewId view)
+    {
+        if (!info.device.is_id_valid(view))
+        {
+            return;
+        }
+        ImageViewInfo const view_info = info.device.image_view_info(view).value();
+        // Can not destroy the default view of an image!!!
+        if (view_info.image.default_view() == view)
+        {
+            return;
+        }
+        std::unique_lock const lock{image_views_mtx};
+        auto cached = image_views.find(ImageViewCacheKey{.image = view_info.image, .slice = view_info.slice, .type = view_info.type});
+        if (cached != image_views.end() && cached->second.view == view)
+        {
+            cached->second.use_count -= 1;
+        }
+    }
+
+    void ImplTaskGraph::collect_image_views()
+    {
+        // Views of destroyed images can never be used again.
+        // The view is destroyed by the graph, destroying the image does not destroy its non default views.
+        std::unique_lock const lock{image_views_mtx};
+        std::erase_if(
+            image_views,
+            [&](auto const & entry)
+            {
+                auto const & [key, cached] = entry;
+                if (cached.use_count != 0 || info.device.is_id_valid(key.image))
+                {
+                    return false;
+                }
+                if (info.device.is_id_valid(cached.view))
+                {
+                    info.device.destroy_image_view(cached.view);
+                }
+                return true;
+            });
+    }
+
+    auto ImplTaskGraph::begin_gpu_profiling_frame(TaskGraphPermutation const & permutation) -> GpuProfilingFrame &
+    {
+        GpuProfilingFrame & frame = gpu_profiling_frames[gpu_profiling_execution_count % GPU_PROFILING_FRAME_COUNT];
+        gpu_profiling_execution_count += 1;
+        if (!frame.query_pool.is_valid() || frame.query_pool.info().query_count < permutation.profiling_query_count)
+        {
+            frame.query_pool = info.device.create_timeline_query_pool({
+                .query_count = std::max(permutation.profiling_query_count, 1u),
+                .name = SmallString{info.name + std::string(" gpu profiling")},
+            });
+        }
+        frame.query_count = permutation.profiling_query_count;
+        frame.task_count = permutation.profiling_task_count;
+        u32 const task_query_count = std::max(permutation.profiling_task_count, 1u);
+        if (info.gpu_profiling_pipeline_statistics != PipelineStatisticFlagBits::NONE &&
+            (!frame.statistics_query_pool.is_valid() || frame.statistics_query_pool.info().query_count < task_query_count))
+        {
+            frame.statistics_query_pool = info.device.create_query_pool({
+                .query_type = QueryType::PIPELINE_STATISTICS,
+                .pipeline_statistics = info.gpu_profiling_pipeline_statistics,
+                .query_count = task_query_count,
+                .name = SmallString{info.name + std::string(" gpu profiling statistics")},
+            });
+        }
+        if (info.gpu_profiling_occlusion && (!frame.occlusion_query_pool.is_valid() || frame.occlusion_query_pool.info().query_count < task_query_count))
+        {
+            frame.occlusion_query_pool = info.device.create_query_pool({
+                .query_type = QueryType::OCCLUSION,
+                .query_count = task_query_count,
+                .name = SmallString{info.name + std::string(" gpu profiling occlusion")},
+            });
+        }
+        frame.pending = true;
+        frame.submit_index = std::numeric_limits<u64>::max();
+        frame.timings.execution_index = gpu_profiling_execution_count;
+        frame.timings.permutation_index = chosen_permutation_last_execution;
+        frame.timings.batches.clear();
+        frame.timings.tasks.clear();
+        frame.timings.host_begin_ns = 0;
+        frame.timings.pipeline_statistic_count = static_cast<u32>(std::popcount(info.gpu_profiling_pipeline_statistics.data));
+        frame.timings.pipeline_statistics.assign(static_cast<usize>(frame.timings.pipeline_statistic_count) * permutation.profiling_task_count, 0);
+        for (u32 submit_scope_index = 0; submit_scope_index < permutation.batch_submit_scopes.size(); ++submit_scope_index)
+        {
+            auto const & submit_scope = permutation.batch_submit_scopes[submit_scope_index];
+            for (u32 batch_index = 0; batch_index < submit_scope.task_batches.size(); ++batch_index)
+            {
+                frame.timings.batches.push_back(TaskBatchGpuTiming{
+                    .submit_scope_index = submit_scope_index,
+                    .batch_index = batch_index,
+                });
+                for (TaskId const task_id : submit_scope.task_batches[batch_index].tasks)
+                {
+                    frame.timings.tasks.push_back(TaskGpuTiming{
+                        .name = tasks[task_id].base_task->name(),
+                        .submit_scope_index = submit_scope_index,
+                        .batch_index = batch_index,
+                    });
+                }
+            }
+        }
+        return frame;
+    }
+
     void validate_runtime_resources([[maybe_unused]] ImplTaskGraph const & impl, [[maybe_unused]] TaskGraphPermutation const & permutation)
     {
 #if DAXA_VALIDATION
@@ -1270,10 +1565,41 @@ namespace daxa
 #endif // #if DAXA_VALIDATION
     }
 
-    auto write_attachment_shader_blob(Device device, u32 data_size, std::span<TaskAttachmentInfo const> attachments) -> std::vector<std::byte>
+    // Every id the attachment shader blob is written from, in blob order.
+    // Device addresses are a function of the buffer id, so equal ids mean an equal blob.
+    void collect_attachment_shader_blob_ids(std::span<TaskAttachmentInfo const> attachments, std::vector<u64> & out_ids)
+    {
+        out_ids.clear();
+        for_each(
+            attachments,
+            [&](u32, auto const & attach)
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(attach)>, TaskBufferAttachmentInfo>)
+                {
+                    for (u32 shader_array_i = 0; shader_array_i < attach.shader_array_size; ++shader_array_i)
+                    {
+                        out_ids.push_back(std::bit_cast<u64>(attach.ids[shader_array_i]));
+                    }
+                }
+                if constexpr (std::is_same_v<std::decay_t<decltype(attach)>, TaskTlasAttachmentInfo>)
+                {
+                    out_ids.push_back(std::bit_cast<u64>(attach.ids[0]));
+                }
+            },
+            [&](u32, TaskImageAttachmentInfo const & image_attach)
+            {
+                for (u32 shader_array_i = 0; shader_array_i < image_attach.shader_array_size; ++shader_array_i)
+                {
+                    out_ids.push_back(std::bit_cast<u64>(image_attach.view_ids[shader_array_i]));
+                }
+            });
+    }
+
+    void write_attachment_shader_blob(Device device, u32 data_size, std::span<TaskAttachmentInfo const> attachments, std::vector<std::byte> & attachment_shader_blob)
     {
-        std::vector<std::byte> attachment_shader_blob = {};
-        attachment_shader_blob.resize(data_size);
+        attachment_shader_blob.assign(data_size, std::byte{});
+        // Resolves the buffer addresses without a call into the device for each of them.
+        BufferPoolView const buffer_pool{device};
         usize shader_byte_blob_offset = 0;
         auto upalign = [&](size_t align_size)
         {
@@ -1300,7 +1626,7 @@ namespace daxa
                         for (u32 shader_array_i = 0; shader_array_i < buffer_attach.shader_array_size; ++shader_array_i)
                         {
                             BufferId const buf_id = buffer_attach.ids[shader_array_i];
-                            DeviceAddress const buf_address = buffer_attach.view.is_null() ? DeviceAddress{} : device.device_address(buf_id).value();
+                            DeviceAddress const buf_address = buffer_attach.view.is_null() ? DeviceAddress{} : buffer_pool.device_address(buf_id).value();
                             auto mini_blob = std::bit_cast<std::array<std::byte, sizeof(DeviceAddress)>>(buf_address);
                             std::memcpy(attachment_shader_blob.data() + shader_byte_blob_offset, &mini_blob, sizeof(DeviceAddress));
                             shader_byte_blob_offset += sizeof(DeviceAddress);
@@ -1365,19 +1691,50 @@ namespace daxa
                     }
                 }
             });
-        return attachment_shader_blob;
     }
 
-    void ImplTaskGraph::execute_task(ImplTaskRuntimeInterface & impl_runtime, TaskGraphPermutation & permutation, u32 batch_index, TaskBatchId in_batch_task_index, TaskId task_id)
+    // The views of a task never change after it was added, so the lookup is built once per execution context.
+    void build_attachment_view_lookup(std::span<TaskAttachmentInfo const> attachments, std::vector<TaskAttachmentViewLookupEntry> & lookup)
+    {
+        lookup.clear();
+        auto const add_views = [&](u32 index, auto const & attach)
+        {
+            lookup.push_back({attachment_view_lookup_key(attach.view), index});
+            lookup.push_back({attachment_view_lookup_key(attach.translated_view), index});
+        };
+        for_each(attachments, add_views, add_views);
+        std::sort(lookup.begin(), lookup.end(), [](TaskAttachmentViewLookupEntry const & a, TaskAttachmentViewLookupEntry const & b)
+                  { return a.key < b.key || (a.key == b.key && a.attachment_index < b.attachment_index); });
+        lookup.erase(std::unique(lookup.begin(), lookup.end(), [](TaskAttachmentViewLookupEntry const & a, TaskAttachmentViewLookupEntry const & b)
+                                 { return a.key == b.key && a.attachment_index == b.attachment_index; }),
+                     lookup.end());
+    }
+
+    thread_local std::vector<u64> tl_attachment_shader_blob_ids = {};
+
+    void ImplTaskGraph::execute_task(ImplTaskRuntimeInterface & impl_runtime, TaskGraphPermutation & permutation, SmallString const & label, TaskId task_id)
     {
         // We always allow to reuse the last command list ONCE within the task callback.
         // When the get command list function is called in a task this is set to false.
         // TODO(refactor): create discrete validation functions and call them before doing any work here.
         impl_runtime.reuse_last_command_list = true;
         ImplTask & task = tasks[task_id];
-        update_image_view_cache(task, permutation);
+        if (!task.enabled)
+        {
+            return;
+        }
+        ImplTaskExecutionState & task_state = impl_runtime.context.task_states[task_id];
+        auto const base_attachments = task.base_task->attachments();
+        task_state.attachments.assign(base_attachments.begin(), base_attachments.end());
+        task_state.image_view_cache.resize(base_attachments.size());
+        task_state.runtime_images_last_execution.resize(base_attachments.size());
+        update_image_view_cache(task, task_state, permutation);
+        if (task_state.attachment_view_lookup.empty())
+        {
+            build_attachment_view_lookup(task_state.attachments, task_state.attachment_view_lookup);
+        }
         for_each(
-            task.base_task->attachments(),
+            std::span{task_state.attachments},
             [&](u32, auto & attach)
             {
                 attach.ids = this->get_actual_buffer_blas_tlas(attach.translated_view, permutation);
@@ -1386,28 +1743,111 @@ namespace daxa
             [&](u32 index, TaskImageAttachmentInfo & attach)
             {
                 attach.ids = this->get_actual_images(attach.translated_view, permutation);
-                attach.view_ids = std::span{task.image_view_cache[index].data(), task.image_view_cache[index].size()};
+                attach.view_ids = std::span{task_state.image_view_cache[index].data(), task_state.image_view_cache[index].size()};
                 validate_task_image_runtime_data(task, attach);
             });
-        std::vector<std::byte> attachment_shader_blob = write_attachment_shader_blob(
-            info.device,
-            task.base_task->attachment_shader_blob_size(),
-            task.base_task->attachments());
+        // The blob only changes when the resolved ids change, for example after set_buffers, set_images or a permutation switch.
+        collect_attachment_shader_blob_ids(task_state.attachments, tl_attachment_shader_blob_ids);
+        if (!task_state.attachment_shader_blob_valid || tl_attachment_shader_blob_ids != task_state.attachment_shader_blob_ids)
+        {
+            write_attachment_shader_blob(
+                info.device,
+                task.base_task->attachment_shader_blob_size(),
+                task_state.attachments,
+                task_state.attachment_shader_blob);
+            std::swap(task_state.attachment_shader_blob_ids, tl_attachment_shader_blob_ids);
+            task_state.attachment_shader_blob_valid = true;
+        }
         impl_runtime.current_task = &task;
         impl_runtime.recorder.begin_label({
             .label_color = info.task_label_color,
-            .name = std::string("batch ") + std::to_string(batch_index) + std::string(" task ") + std::to_string(in_batch_task_index) + std::string(" \"") + std::string(task.base_task->name()) + std::string("\""),
+            .name = label,
         });
         task.base_task->callback(TaskInterface{
             .device = this->info.device,
             .recorder = impl_runtime.recorder,
-            .attachment_infos = task.base_task->attachments(),
-            .allocator = this->staging_memory.has_value() ? &this->staging_memory.value() : nullptr,
-            .attachment_shader_blob = attachment_shader_blob,
+            .attachment_infos = task_state.attachments,
+            .allocator = impl_runtime.staging_memory,
+            .attachment_shader_blob = task_state.attachment_shader_blob,
+            .attachment_view_lookup = task_state.attachment_view_lookup,
         });
         impl_runtime.recorder.end_label();
     }
 
+    void TaskGraph::add_mip_generation(TaskImageView image, std::string_view name)
+    {
+        DAXA_DBG_ASSERT_TRUE_M(image.slice.level_count >= 2, "mip generation requires a slice of at least two mips");
+        TaskImageView source = image;
+        source.slice.level_count = 1;
+        TaskImageView targets = image;
+        targets.slice.base_mip_level += 1;
+        targets.slice.level_count -= 1;
+        add_task(InlineTaskInfo{
+            .attachments = {
+                inl_attachment(TaskImageAccess::TRANSFER_READ, source),
+                inl_attachment(TaskImageAccess::TRANSFER_WRITE, targets),
+            },
+            .task = [](TaskInterface ti)
+            {
+                TaskImageAttachmentInfo const & source_attach = ti.get(TaskImageAttachmentIndex{0});
+                TaskImageAttachmentInfo const & targets_attach = ti.get(TaskImageAttachmentIndex{1});
+                ImageMipArraySlice const slice = targets_attach.view.slice;
+                for (ImageId const id : targets_attach.ids)
+                {
+                    Extent3D const size = ti.device.image_info(id).value().size;
+                    auto mip_size = [&](u32 mip) -> Offset3D
+                    {
+                        return {
+                            std::max(1, static_cast<i32>(size.x >> mip)),
+                            std::max(1, static_cast<i32>(size.y >> mip)),
+                            std::max(1, static_cast<i32>(size.z >> mip)),
+                        };
+                    };
+                    for (u32 mip = slice.base_mip_level; mip < slice.base_mip_level + slice.level_count; ++mip)
+                    {
+                        // The source mip is already readable, the previously written mips are made readable here.
+                        bool const src_is_target = mip - 1 != source_attach.view.slice.base_mip_level;
+                        if (src_is_target)
+                        {
+                            ti.recorder.pipeline_barrier_image_transition({
+                                .src_access = AccessConsts::TRANSFER_WRITE,
+                                .dst_access = AccessConsts::TRANSFER_READ,
+                                .src_layout = targets_attach.layout,
+                                .dst_layout = ImageLayout::TRANSFER_SRC_OPTIMAL,
+                                .image_slice = {mip - 1, 1, slice.base_array_layer, slice.layer_count},
+                                .image_id = id,
+                            });
+                        }
+                        ti.recorder.blit_image_to_image({
+                            .src_image = id,
+                            .src_image_layout = src_is_target ? ImageLayout::TRANSFER_SRC_OPTIMAL : source_attach.layout,
+                            .dst_image = id,
+                            .dst_image_layout = targets_attach.layout,
+                            .src_slice = {mip - 1, slice.base_array_layer, slice.layer_count},
+                            .src_offsets = {{{0, 0, 0}, mip_size(mip - 1)}},
+                            .dst_slice = {mip, slice.base_array_layer, slice.layer_count},
+                            .dst_offsets = {{{0, 0, 0}, mip_size(mip)}},
+                            .filter = Filter::LINEAR,
+                        });
+                    }
+                    // The task graph tracks all written mips in the layout of the write attachment.
+                    if (slice.level_count > 1)
+                    {
+                        ti.recorder.pipeline_barrier_image_transition({
+                            .src_access = AccessConsts::TRANSFER_READ,
+                            .dst_access = AccessConsts::TRANSFER_WRITE,
+                            .src_layout = ImageLayout::TRANSFER_SRC_OPTIMAL,
+                            .dst_layout = targets_attach.layout,
+                            .image_slice = {slice.base_mip_level, slice.level_count - 1, slice.base_array_layer, slice.layer_count},
+                            .image_id = id,
+                        });
+                    }
+                }
+            },
+            .name = name,
+        });
+    }
+
     void TaskGraph::conditional(TaskGraphConditionalInfo const & conditional_info)
     {
         auto & impl = *reinterpret_cast<ImplTaskGraph *>(this->object);
@@ -1613,20 +2053,23 @@ namespace daxa
 
         TaskId const task_id = impl.tasks.size();
 
-        std::vector<std::vector<ImageViewId>> view_cache = {};
-        view_cache.resize(task->attachments().size(), {});
-        std::vector<std::vector<ImageId>> id_cache = {};
-        id_cache.resize(task->attachments().size(), {});
         auto impl_task = ImplTask{
             .base_task = std::move(task),
-            .image_view_cache = std::move(view_cache),
-            .runtime_images_last_execution = std::move(id_cache),
         };
         translate_persistent_ids(impl, impl_task.base_task.get());
 
+        bool const record_calls = impl.info.reorder_tasks && impl.info.scheduling == TaskGraphScheduling::DEPENDENCY_GRAPH;
         for (auto * permutation : impl.record_active_permutations)
         {
             permutation->add_task(impl, impl_task, task_id);
+            if (record_calls)
+            {
+                permutation->recorded_calls.push_back(task_id);
+            }
+        }
+        if (impl.info.jit_compile_permutations)
+        {
+            impl.jit_recorded_calls.push_back({task_id, {impl.record_active_conditional_scopes, impl.record_conditional_states}});
         }
 
         impl.tasks.emplace_back(std::move(impl_task));
@@ -1750,6 +2193,35 @@ namespace daxa
         }
     }
 
+    auto is_split_barrier_worthwhile(
+        ImplTaskGraph const & impl,
+        TaskGraphPermutation const & permutation,
+        usize src_submit_scope_index,
+        usize src_batch_index,
+        usize dst_submit_scope_index,
+        usize dst_batch_index) -> bool
+    {
+        if (src_submit_scope_index != dst_submit_scope_index)
+        {
+            return true;
+        }
+        if (dst_batch_index - src_batch_index >= impl.info.split_barrier_min_batch_distance)
+        {
+            return true;
+        }
+        if (impl.info.split_barrier_min_tasks_between == 0)
+        {
+            return false;
+        }
+        auto const & task_batches = permutation.batch_submit_scopes[dst_submit_scope_index].task_batches;
+        usize tasks_between = 0;
+        for (usize batch_index = src_batch_index + 1; batch_index < dst_batch_index; ++batch_index)
+        {
+            tasks_between += task_batches[batch_index].tasks.size();
+        }
+        return tasks_between >= impl.info.split_barrier_min_tasks_between;
+    }
+
     // I hate this function.
     thread_local std::vector<ExtendedImageSliceState> tl_tracked_slice_rests = {};
     thread_local std::vector<ImageMipArraySlice> tl_new_use_slices = {};
@@ -1877,12 +2349,14 @@ namespace daxa
                         bool const dst_host_only_access = current_buffer_access.stages == PipelineStageFlagBits::HOST;
                         DAXA_DBG_ASSERT_TRUE_M(!(src_host_only_access && dst_host_only_access), "direct sync between two host accesses on gpu are not allowed");
                         bool const is_host_barrier = src_host_only_access || dst_host_only_access;
-                        // When the distance between src and dst batch is one, we can replace the split barrier with a normal barrier.
+                        // When there is too little work between src and dst batch, we replace the split barrier with a normal barrier.
                         // We also need to make sure we do not use split barriers when the src or dst stage exclusively uses the host stage.
                         // This is because the host stage does not declare an execution dependency on the cpu but only a memory dependency.
                         bool const use_pipeline_barrier =
-                            (task_buffer.latest_access_batch_index + 1 == batch_index &&
-                             current_submit_scope_index == task_buffer.latest_access_submit_scope_index) ||
+                            !is_split_barrier_worthwhile(
+                                task_graph_impl, *this,
+                                task_buffer.latest_access_submit_scope_index, task_buffer.latest_access_batch_index,
+                                current_submit_scope_index, batch_index) ||
                             is_host_barrier;
                         if (use_pipeline_barrier)
                         {
@@ -2084,12 +2558,14 @@ namespace daxa
                             bool const dst_host_only_access = current_image_access.stages == PipelineStageFlagBits::HOST;
                             DAXA_DBG_ASSERT_TRUE_M(!(src_host_only_access && dst_host_only_access), "direct sync between two host accesses on gpu is not allowed");
                             bool const is_host_barrier = src_host_only_access || dst_host_only_access;
-                            // When the distance between src and dst batch is one, we can replace the split barrier with a normal barrier.
+                            // When there is too little work between src and dst batch, we replace the split barrier with a normal barrier.
                             // We also need to make sure we do not use split barriers when the src or dst stage exclusively uses the host stage.
                             // This is because the host stage does not declare an execution dependency on the cpu but only a memory dependency.
                             bool const use_pipeline_barrier =
-                                (tracked_slice.latest_access_batch_index + 1 == batch_index &&
-                                 current_submit_scope_index == tracked_slice.latest_access_submit_scope_index) ||
+                                !is_split_barrier_worthwhile(
+                                    task_graph_impl, *this,
+                                    tracked_slice.latest_access_submit_scope_index, tracked_slice.latest_access_batch_index,
+                                    current_submit_scope_index, batch_index) ||
                                 is_host_barrier;
                             if (use_pipeline_barrier)
                             {
@@ -2173,9 +2649,18 @@ namespace daxa
         auto & impl = *r_cast<ImplTaskGraph *>(this->object);
         DAXA_DBG_ASSERT_TRUE_M(!impl.compiled, "completed task graphs can not record new tasks");
 
+        bool const record_calls = impl.info.reorder_tasks && impl.info.scheduling == TaskGraphScheduling::DEPENDENCY_GRAPH;
         for (auto & permutation : impl.record_active_permutations)
         {
             permutation->submit(info);
+            if (record_calls)
+            {
+                permutation->recorded_calls.push_back(info);
+            }
+        }
+        if (impl.info.jit_compile_permutations)
+        {
+            impl.jit_recorded_calls.push_back({info, {impl.record_active_conditional_scopes, impl.record_conditional_states}});
         }
     }
 
@@ -2195,9 +2680,18 @@ namespace daxa
         DAXA_DBG_ASSERT_TRUE_M(!impl.compiled, "completed task graphs can not record new tasks");
         DAXA_DBG_ASSERT_TRUE_M(impl.info.swapchain.has_value(), "can only present, when a swapchain was provided in creation");
 
+        bool const record_calls = impl.info.reorder_tasks && impl.info.scheduling == TaskGraphScheduling::DEPENDENCY_GRAPH;
         for (auto & permutation : impl.record_active_permutations)
         {
             permutation->present(info);
+            if (record_calls)
+            {
+                permutation->recorded_calls.push_back(info);
+            }
+        }
+        if (impl.info.jit_compile_permutations)
+        {
+            impl.jit_recorded_calls.push_back({info, {impl.record_active_conditional_scopes, impl.record_conditional_states}});
         }
     }
 
@@ -2238,91 +2732,372 @@ namespace daxa
         };
     }
 
-    void ImplTaskGraph::create_transient_runtime_buffers(TaskGraphPermutation & permutation)
+    auto TaskGraphPermutation::schedule_stats() const -> TaskScheduleStats
     {
-        for (u32 buffer_info_idx = 0; buffer_info_idx < u32(global_buffer_infos.size()); buffer_info_idx++)
+        TaskScheduleStats stats = {
+            .barrier_count = this->barriers.size(),
+            .split_barrier_count = this->split_barriers.size(),
+        };
+        for (auto const & submit_scope : this->batch_submit_scopes)
         {
-            auto const & glob_buffer = global_buffer_infos.at(buffer_info_idx);
-            auto & perm_buffer = permutation.buffer_infos.at(buffer_info_idx);
-
-            if (!glob_buffer.is_persistent() && perm_buffer.valid)
-            {
-                auto const & transient_info = daxa::get<PermIndepTaskBufferInfo::Transient>(glob_buffer.task_buffer_data);
-
-                std::get<BufferId>(perm_buffer.actual_id) = info.device.create_buffer_from_memory_block(MemoryBlockBufferInfo{
-                    .buffer_info = BufferInfo{
-                        .size = transient_info.info.size,
-                        .name = transient_info.info.name,
-                    },
-                    .memory_block = transient_data_memory_block,
-                    .offset = perm_buffer.allocation_offset,
-                });
-            }
+            stats.batch_count += submit_scope.task_batches.size();
         }
+        return stats;
     }
 
-    void ImplTaskGraph::create_transient_runtime_images(TaskGraphPermutation & permutation)
+    // Drops everything add_task, submit and present derived from the recorded calls.
+    // Validity, usage and create flags are kept, replaying the same tasks sets them to the same values.
+    void TaskGraphPermutation::reset_schedule()
     {
-        for (u32 image_info_idx = 0; image_info_idx < u32(global_image_infos.size()); image_info_idx++)
+        for (auto & task_buffer : this->buffer_infos)
         {
-            auto const & glob_image = global_image_infos.at(image_info_idx);
-            auto & perm_image = permutation.image_infos.at(image_info_idx);
-
+            task_buffer.latest_access_concurrent = TaskAccessConcurrency::EXCLUSIVE;
+            task_buffer.latest_access = AccessConsts::NONE;
+            task_buffer.latest_access_batch_index = {};
+            task_buffer.latest_access_submit_scope_index = {};
+            task_buffer.first_access_batch_index = {};
+            task_buffer.first_access_submit_scope_index = {};
+            task_buffer.first_access = AccessConsts::NONE;
+            task_buffer.latest_concurrent_access_barrer_index = Monostate{};
+            task_buffer.lifetime = {};
+        }
+        for (auto & task_image : this->image_infos)
+        {
+            task_image.swapchain_semaphore_waited_upon = false;
+            task_image.last_slice_states.clear();
+            task_image.first_slice_states.clear();
+            task_image.lifetime = {};
+        }
+        this->split_barriers.clear();
+        this->barriers.clear();
+        this->initial_barriers.clear();
+        this->batch_submit_scopes.clear();
+        this->batch_submit_scopes.emplace_back();
+        this->swapchain_image_first_use_submit_scope_index = std::numeric_limits<usize>::max();
+        this->swapchain_image_last_use_submit_scope_index = std::numeric_limits<usize>::max();
+    }
+
+    struct ScheduledAccess
+    {
+        bool is_image = {};
+        u32 index = {};
+        ImageMipArraySlice slice = {};
+        Access access = {};
+        TaskAccessConcurrency concurrency = {};
+        ImageLayout layout = {};
+    };
+
+    auto scheduled_accesses(ITask & task) -> std::vector<ScheduledAccess>
+    {
+        std::vector<ScheduledAccess> accesses = {};
+        for_each(
+            task.attachments(),
+            [&](u32, auto const & attach)
+            {
+                if (attach.view.is_null()) return;
+                auto [access, concurrency] = task_buffer_access_to_access(static_cast<TaskBufferAccess>(attach.access));
+                accesses.push_back({.index = attach.translated_view.index, .access = access, .concurrency = concurrency});
+            },
+            [&](u32, TaskImageAttachmentInfo const & attach)
+            {
+                if (attach.view.is_null()) return;
+                auto [layout, access, concurrency] = task_image_access_to_layout_access(attach.access);
+                accesses.push_back({
+                    .is_image = true,
+                    .index = attach.translated_view.index,
+                    .slice = attach.translated_view.slice,
+                    .access = access,
+                    .concurrency = concurrency,
+                    .layout = layout,
+                });
+            });
+        return accesses;
+    }
+
+    // Mirrors the rules of schedule_task: only reads on reads and rw concurrent on rw concurrent in the same layout may share a batch.
+    auto accesses_conflict(ScheduledAccess const & a, ScheduledAccess const & b) -> bool
+    {
+        if (a.is_image != b.is_image || a.index != b.index || (a.is_image && !a.slice.intersects(b.slice)))
+        {
+            return false;
+        }
+        bool const both_read = a.access.type == AccessTypeFlagBits::READ && b.access.type == AccessTypeFlagBits::READ;
+        bool const both_rw_concurrent =
+            a.access.type == AccessTypeFlagBits::READ_WRITE && a.concurrency == TaskAccessConcurrency::CONCURRENT &&
+            b.access.type == AccessTypeFlagBits::READ_WRITE && b.concurrency == TaskAccessConcurrency::CONCURRENT;
+        return !((both_read || both_rw_concurrent) && a.layout == b.layout);
+    }
+
+    // List scheduling over the dependency graph of each run of tasks between submits and presents.
+    // A task's level is one above the highest level task recorded before it that it conflicts with.
+    // Replaying the tasks sorted by level keeps every conflicting pair in recording order,
+    // while tasks that only read a resource no longer get pushed behind other readers of it.
+    void TaskGraphPermutation::reschedule(ImplTaskGraph & task_graph_impl)
+    {
+        this->recording_order_stats = this->schedule_stats();
+        std::vector<std::variant<TaskId, TaskSubmitInfo, TaskPresentInfo>> calls = std::move(this->recorded_calls);
+        this->recorded_calls = {};
+        this->reset_schedule();
+
+        std::vector<TaskId> segment = {};
+        std::vector<std::vector<ScheduledAccess>> segment_accesses = {};
+        std::vector<usize> levels = {};
+        std::vector<usize> order = {};
+        auto schedule_segment = [&]()
+        {
+            segment_accesses.clear();
+            levels.assign(segment.size(), 0);
+            for (usize i = 0; i < segment.size(); ++i)
+            {
+                segment_accesses.push_back(scheduled_accesses(*task_graph_impl.tasks[segment[i]].base_task));
+                for (usize j = 0; j < i; ++j)
+                {
+                    if (levels[j] + 1 <= levels[i])
+                    {
+                        continue;
+                    }
+                    bool conflict = false;
+                    for (auto const & access_i : segment_accesses[i])
+                    {
+                        for (auto const & access_j : segment_accesses[j])
+                        {
+                            conflict = conflict || accesses_conflict(access_i, access_j);
+                        }
+                    }
+                    if (conflict)
+                    {
+                        levels[i] = levels[j] + 1;
+                    }
+                }
+            }
+            order.resize(segment.size());
+            std::iota(order.begin(), order.end(), usize{0});
+            std::stable_sort(order.begin(), order.end(), [&](usize a, usize b)
+                             { return levels[a] < levels[b]; });
+            for (usize const i : order)
+            {
+                this->add_task(task_graph_impl, task_graph_impl.tasks[segment[i]], segment[i]);
+            }
+            segment.clear();
+        };
+        for (auto const & call : calls)
+        {
+            if (TaskId const * task_id = std::get_if<TaskId>(&call))
+            {
+                segment.push_back(*task_id);
+                continue;
+            }
+            schedule_segment();
+            if (TaskSubmitInfo const * submit_info = std::get_if<TaskSubmitInfo>(&call))
+            {
+                this->submit(*submit_info);
+            }
+            else
+            {
+                this->present(std::get<TaskPresentInfo>(call));
+            }
+        }
+        schedule_segment();
+        this->final_stats = this->schedule_stats();
+    }
+
+    void ImplTaskGraph::create_transient_runtime_buffers(TaskGraphPermutation & permutation)
+    {
+        for (u32 buffer_info_idx = 0; buffer_info_idx < u32(global_buffer_infos.size()); buffer_info_idx++)
+        {
+            auto const & glob_buffer = global_buffer_infos.at(buffer_info_idx);
+            auto & perm_buffer = permutation.buffer_infos.at(buffer_info_idx);
+
+            if (!glob_buffer.is_persistent() && perm_buffer.valid)
+            {
+                auto const & transient_info = daxa::get<PermIndepTaskBufferInfo::Transient>(glob_buffer.task_buffer_data);
+
+                std::get<BufferId>(perm_buffer.actual_id) = info.device.create_buffer_from_memory_block(MemoryBlockBufferInfo{
+                    .buffer_info = BufferInfo{
+                        .size = transient_info.info.size,
+                        .name = transient_info.info.name,
+                    },
+                    .memory_block = transient_heaps_of(permutation).at(perm_buffer.heap_index).memory_block,
+                    .offset = perm_buffer.allocation_offset,
+                });
+            }
+        }
+    }
+
+    void ImplTaskGraph::create_transient_runtime_images(TaskGraphPermutation & permutation)
+    {
+        // All transient images of the permutation are created at once, which reserves their slots and writes their descriptors in one go.
+        std::vector<MemoryBlockImageInfo> image_infos = {};
+        std::vector<u32> image_info_indices = {};
+        for (u32 image_info_idx = 0; image_info_idx < u32(global_image_infos.size()); image_info_idx++)
+        {
+            auto const & glob_image = global_image_infos.at(image_info_idx);
+            auto & perm_image = permutation.image_infos.at(image_info_idx);
+
             if (!glob_image.is_persistent() && perm_image.valid)
             {
                 DAXA_DBG_ASSERT_TRUE_M(perm_image.usage != ImageUsageFlagBits::NONE,
                                        std::string("Transient image is not used in this permutation but marked as valid either: ") +
                                            std::string("\t- it was used as PRESENT which is not allowed for transient images") +
                                            std::string("\t- it was used as NONE which makes no sense - just don't mark it as used in the task"));
-                auto const & transient_image_info = daxa::get<PermIndepTaskImageInfo::Transient>(glob_image.task_image_data).info;
-                perm_image.actual_image = info.device.create_image_from_memory_block(
-                    MemoryBlockImageInfo{
-                        .image_info = ImageInfo{
-                            .flags = daxa::ImageCreateFlagBits::ALLOW_ALIAS | perm_image.create_flags,
-                            .dimensions = transient_image_info.dimensions,
-                            .format = transient_image_info.format,
-                            .size = transient_image_info.size,
-                            .mip_level_count = transient_image_info.mip_level_count,
-                            .array_layer_count = transient_image_info.array_layer_count,
-                            .sample_count = transient_image_info.sample_count,
-                            .usage = perm_image.usage,
-                            .name = transient_image_info.name,
-                        },
-                        .memory_block = transient_data_memory_block,
-                        .offset = perm_image.allocation_offset,
-                    });
+                image_infos.push_back(MemoryBlockImageInfo{
+                    .image_info = transient_image_info(image_info_idx, perm_image),
+                    .memory_block = transient_heaps_of(permutation).at(perm_image.heap_index).memory_block,
+                    .offset = perm_image.allocation_offset,
+                });
+                image_info_indices.push_back(image_info_idx);
+            }
+        }
+        std::vector<ImageId> const images = info.device.create_images_from_memory_block(image_infos);
+        for (usize i = 0; i < images.size(); ++i)
+        {
+            permutation.image_infos.at(image_info_indices[i]).actual_image = images[i];
+        }
+    }
+
+    void ImplTaskGraph::create_transient_runtime_resources(std::span<TaskGraphPermutation * const> perms, std::vector<TransientHeap> & heaps)
+    {
+        if (info.transient_memory_heap.has_value())
+        {
+            auto & shared_heap = *info.transient_memory_heap->get();
+            for (auto & heap : heaps)
+            {
+                if (heap.size != 0)
+                {
+                    heap.memory_block = shared_heap.acquire(heap.memory_type_bits);
+                }
+            }
+        }
+        for (TaskGraphPermutation * permutation : perms)
+        {
+            create_transient_runtime_buffers(*permutation);
+            create_transient_runtime_images(*permutation);
+        }
+    }
+
+    void ImplTaskGraph::destroy_transient_runtime_resources(TaskGraphPermutation & permutation)
+    {
+        // because transient buffers are owned by the task graph, we need to destroy them
+        for (u32 buffer_info_idx = 0; buffer_info_idx < static_cast<u32>(global_buffer_infos.size()); buffer_info_idx++)
+        {
+            auto const & global_buffer = global_buffer_infos.at(buffer_info_idx);
+            PerPermTaskBuffer const & perm_buffer = permutation.buffer_infos.at(buffer_info_idx);
+            if (!global_buffer.is_persistent() &&
+                perm_buffer.valid)
+            {
+                if (auto const * id = std::get_if<BufferId>(&perm_buffer.actual_id))
+                {
+                    info.device.destroy_buffer(*id);
+                }
+                if (auto const * id = std::get_if<BlasId>(&perm_buffer.actual_id))
+                {
+                    info.device.destroy_blas(*id);
+                }
+                if (auto const * id = std::get_if<TlasId>(&perm_buffer.actual_id))
+                {
+                    info.device.destroy_tlas(*id);
+                }
+            }
+        }
+        // because transient images are owned by the task graph, we need to destroy them
+        for (u32 image_info_idx = 0; image_info_idx < static_cast<u32>(global_image_infos.size()); image_info_idx++)
+        {
+            auto const & global_image = global_image_infos.at(image_info_idx);
+            auto const & perm_image = permutation.image_infos.at(image_info_idx);
+            if (!global_image.is_persistent() && perm_image.valid)
+            {
+                info.device.destroy_image(get_actual_images(TaskImageView{{.task_graph_index = unique_index, .index = image_info_idx}}, permutation)[0]);
             }
         }
     }
 
-    void ImplTaskGraph::allocate_transient_resources()
+    auto ImplTaskGraph::transient_heaps_of(TaskGraphPermutation & permutation) -> std::vector<TransientHeap> &
+    {
+        return info.jit_compile_permutations ? permutation.jit_transient_heaps : transient_heaps;
+    }
+
+    auto ImplTaskGraph::transient_image_info(u32 image_index, PerPermTaskImage const & perm_image) const -> ImageInfo
+    {
+        auto const & transient_image_info = daxa::get<PermIndepTaskImageInfo::Transient>(global_image_infos.at(image_index).task_image_data).info;
+        return ImageInfo{
+            .flags = daxa::ImageCreateFlagBits::ALLOW_ALIAS | perm_image.create_flags,
+            .dimensions = transient_image_info.dimensions,
+            .format = transient_image_info.format,
+            .size = transient_image_info.size,
+            .mip_level_count = transient_image_info.mip_level_count,
+            .array_layer_count = transient_image_info.array_layer_count,
+            .sample_count = transient_image_info.sample_count,
+            .usage = perm_image.usage,
+            // Tasks on the async queues access images without ownership transfers.
+            .sharing_mode = info.async_compute_queue.has_value() || info.async_transfer_queue.has_value() || info.async_video_decode_queue.has_value() || info.async_video_encode_queue.has_value() ? SharingMode::CONCURRENT : SharingMode::EXCLUSIVE,
+            .name = transient_image_info.name,
+        };
+    }
+
+    auto ImplTaskGraph::transient_image_requirements_of(ImageInfo const & image_info) -> MemoryRequirements
+    {
+        TransientImageRequirementsKey const key = {
+            .flags = image_info.flags.data,
+            .dimensions = image_info.dimensions,
+            .format = image_info.format,
+            .size = image_info.size,
+            .mip_level_count = image_info.mip_level_count,
+            .array_layer_count = image_info.array_layer_count,
+            .sample_count = image_info.sample_count,
+            .usage = image_info.usage.data,
+            .sharing_mode = image_info.sharing_mode,
+        };
+        auto [iter, inserted] = transient_image_requirements.try_emplace(key);
+        if (inserted)
+        {
+            iter->second = info.device.image_memory_requirements(image_info);
+        }
+        return iter->second;
+    }
+
+    auto ImplTaskGraph::transient_buffer_requirements_of(usize size) -> MemoryRequirements
+    {
+        auto [iter, inserted] = transient_buffer_requirements.try_emplace(size);
+        if (inserted)
+        {
+            iter->second = info.device.buffer_memory_requirements({.size = size});
+        }
+        return iter->second;
+    }
+
+    auto ImplTaskGraph::allocate_transient_resources(std::span<TaskGraphPermutation * const> perms, std::vector<TransientHeap> & heaps) -> TransientMemoryStats
     {
+        TransientMemoryStats stats = {};
+        auto heap_index_of = [&](MemoryRequirements const & requirements) -> u32
+        {
+            for (u32 heap_index = 0; heap_index < heaps.size(); ++heap_index)
+            {
+                if (heaps[heap_index].memory_type_bits == requirements.memory_type_bits)
+                {
+                    heaps[heap_index].alignment = std::max(heaps[heap_index].alignment, static_cast<usize>(requirements.alignment));
+                    return heap_index;
+                }
+            }
+            heaps.push_back(TransientHeap{
+                .memory_type_bits = requirements.memory_type_bits,
+                .alignment = std::max(static_cast<usize>(requirements.alignment), usize{1}),
+            });
+            return static_cast<u32>(heaps.size() - 1);
+        };
+
         usize transient_resource_count = 0;
-        usize max_alignment_requirement = 0;
-        for (auto & permutation : permutations)
+        for (TaskGraphPermutation * permutation_ptr : perms)
         {
+            TaskGraphPermutation & permutation = *permutation_ptr;
             for (u32 image_i = 0; image_i < permutation.image_infos.size(); ++image_i)
             {
                 PerPermTaskImage & permut_image = permutation.image_infos[image_i];
-                PermIndepTaskImageInfo & global_image = global_image_infos[image_i];
-                if (!global_image.is_persistent())
+                if (!global_image_infos[image_i].is_persistent() && permut_image.valid)
                 {
                     transient_resource_count += 1;
-                    TaskTransientImageInfo trans_img_info = daxa::get<PermIndepTaskImageInfo::Transient>(global_image.task_image_data).info;
-                    ImageInfo image_info{
-                        // .flags = trans_img_info.flags,
-                        .dimensions = trans_img_info.dimensions,
-                        .format = trans_img_info.format,
-                        .size = trans_img_info.size,
-                        .mip_level_count = trans_img_info.mip_level_count,
-                        .array_layer_count = trans_img_info.array_layer_count,
-                        .sample_count = trans_img_info.sample_count,
-                        .usage = permut_image.usage,
-                        .allocate_info = MemoryFlagBits::DEDICATED_MEMORY,
-                        .name = "Dummy to figure mem requirements",
-                    };
-                    permut_image.memory_requirements = info.device.memory_requirements({image_info});
-                    max_alignment_requirement = std::max(permut_image.memory_requirements.alignment, max_alignment_requirement);
+                    // The requirements depend on the create flags and sharing mode, so they are looked up with the info the image is created with.
+                    permut_image.memory_requirements = transient_image_requirements_of(transient_image_info(image_i, permut_image));
+                    permut_image.heap_index = heap_index_of(permut_image.memory_requirements);
                 }
             }
             for (u32 buffer_i = 0; buffer_i < permutation.buffer_infos.size(); ++buffer_i)
@@ -2332,25 +3107,37 @@ namespace daxa
                 if (!global_buffer.is_persistent())
                 {
                     transient_resource_count += 1;
-                    TaskTransientBufferInfo trans_buf_info = daxa::get<PermIndepTaskBufferInfo::Transient>(global_buffer.task_buffer_data).info;
-                    BufferInfo buffer_info{
-                        .size = trans_buf_info.size,
-                        .allocate_info = MemoryFlagBits::DEDICATED_MEMORY,
-                        .name = "Dummy to figure mem requirements",
-                    };
-                    permut_buffer.memory_requirements = info.device.memory_requirements({buffer_info});
-                    max_alignment_requirement = std::max(permut_buffer.memory_requirements.alignment, max_alignment_requirement);
+                    TaskTransientBufferInfo const & trans_buf_info = daxa::get<PermIndepTaskBufferInfo::Transient>(global_buffer.task_buffer_data).info;
+                    permut_buffer.memory_requirements = transient_buffer_requirements_of(trans_buf_info.size);
+                    permut_buffer.heap_index = heap_index_of(permut_buffer.memory_requirements);
                 }
             }
         }
         if (transient_resource_count == 0)
         {
-            return;
+            return stats;
         }
 
-        // for each permutation figure out the max memory requirements
-        for (auto & permutation : permutations)
+        struct TransientPlacement
         {
+            usize start_batch = {};
+            usize end_batch = {};
+            usize size = {};
+            usize alignment = {};
+            usize offset = {};
+            u32 heap_index = {};
+            bool is_image = {};
+            u32 resource_idx = {};
+        };
+        auto align_up = [](usize value, usize alignment) -> usize
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        };
+
+        std::vector<usize> heap_lower_bounds(heaps.size());
+        for (TaskGraphPermutation * permutation_ptr : perms)
+        {
+            TaskGraphPermutation & permutation = *permutation_ptr;
             usize batches = 0;
             std::vector<usize> submit_batch_offsets(permutation.batch_submit_scopes.size());
             for (u32 submit_scope_idx = 0; submit_scope_idx < permutation.batch_submit_scopes.size(); submit_scope_idx++)
@@ -2359,270 +3146,554 @@ namespace daxa
                 batches += permutation.batch_submit_scopes.at(submit_scope_idx).task_batches.size();
             }
 
-            struct LifetimeLengthResource
+            std::vector<TransientPlacement> placements = {};
+            auto add_placement = [&](ResourceLifetime const & lifetime, MemoryRequirements const & requirements, u32 heap_index, bool is_image, u32 resource_idx)
             {
-                usize start_batch;
-                usize end_batch;
-                usize lifetime_length;
-                bool is_image;
-                u32 resource_idx;
+                placements.push_back(TransientPlacement{
+                    .start_batch = submit_batch_offsets.at(lifetime.first_use.submit_scope_index) + lifetime.first_use.task_batch_index,
+                    .end_batch = submit_batch_offsets.at(lifetime.last_use.submit_scope_index) + lifetime.last_use.task_batch_index,
+                    .size = requirements.size,
+                    .alignment = std::max(static_cast<usize>(requirements.alignment), usize{1}),
+                    .heap_index = heap_index,
+                    .is_image = is_image,
+                    .resource_idx = resource_idx,
+                });
             };
-
-            std::vector<LifetimeLengthResource> lifetime_length_sorted_resources;
-
             for (u32 perm_image_idx = 0; perm_image_idx < permutation.image_infos.size(); perm_image_idx++)
             {
-                if (global_image_infos.at(perm_image_idx).is_persistent() || !permutation.image_infos.at(perm_image_idx).valid)
+                auto & perm_task_image = permutation.image_infos.at(perm_image_idx);
+                if (global_image_infos.at(perm_image_idx).is_persistent() || !perm_task_image.valid)
                 {
                     continue;
                 }
-
-                auto const & perm_task_image = permutation.image_infos.at(perm_image_idx);
-
                 if (perm_task_image.lifetime.first_use.submit_scope_index == std::numeric_limits<u32>::max() ||
                     perm_task_image.lifetime.last_use.submit_scope_index == std::numeric_limits<u32>::max())
                 {
                     // TODO(msakmary) Transient image created but not used - should we somehow warn the user about this?
-                    permutation.image_infos.at(perm_image_idx).valid = false;
+                    perm_task_image.valid = false;
                     continue;
                 }
-
-                usize const start_idx = submit_batch_offsets.at(perm_task_image.lifetime.first_use.submit_scope_index) +
-                                        perm_task_image.lifetime.first_use.task_batch_index;
-                usize const end_idx = submit_batch_offsets.at(perm_task_image.lifetime.last_use.submit_scope_index) +
-                                      perm_task_image.lifetime.last_use.task_batch_index;
-
-                lifetime_length_sorted_resources.emplace_back(LifetimeLengthResource{
-                    .start_batch = start_idx,
-                    .end_batch = end_idx,
-                    .lifetime_length = end_idx - start_idx + 1,
-                    .is_image = true,
-                    .resource_idx = perm_image_idx,
-                });
+                add_placement(perm_task_image.lifetime, perm_task_image.memory_requirements, perm_task_image.heap_index, true, perm_image_idx);
             }
-
             for (u32 perm_buffer_idx = 0; perm_buffer_idx < permutation.buffer_infos.size(); perm_buffer_idx++)
             {
+                auto & perm_task_buffer = permutation.buffer_infos.at(perm_buffer_idx);
                 if (global_buffer_infos.at(perm_buffer_idx).is_persistent())
                 {
                     continue;
                 }
-
-                auto const & perm_task_buffer = permutation.buffer_infos.at(perm_buffer_idx);
-
                 if (perm_task_buffer.lifetime.first_use.submit_scope_index == std::numeric_limits<u32>::max() ||
                     perm_task_buffer.lifetime.last_use.submit_scope_index == std::numeric_limits<u32>::max())
                 {
                     // TODO(msakmary) Transient buffer created but not used - should we somehow warn the user about this?
-                    permutation.buffer_infos.at(perm_buffer_idx).valid = false;
+                    perm_task_buffer.valid = false;
                     continue;
                 }
+                add_placement(perm_task_buffer.lifetime, perm_task_buffer.memory_requirements, perm_task_buffer.heap_index, false, perm_buffer_idx);
+            }
 
-                usize const start_idx = submit_batch_offsets.at(perm_task_buffer.lifetime.first_use.submit_scope_index) +
-                                        perm_task_buffer.lifetime.first_use.task_batch_index;
-                usize const end_idx = submit_batch_offsets.at(perm_task_buffer.lifetime.last_use.submit_scope_index) +
-                                      perm_task_buffer.lifetime.last_use.task_batch_index;
-
-                lifetime_length_sorted_resources.emplace_back(LifetimeLengthResource{
-                    .start_batch = start_idx,
-                    .end_batch = end_idx,
-                    .lifetime_length = end_idx - start_idx + 1,
-                    .is_image = false,
-                    .resource_idx = perm_buffer_idx,
-                });
+            // No placement can get below the peak of memory that is alive within a single batch.
+            for (u32 heap_index = 0; heap_index < heaps.size(); ++heap_index)
+            {
+                std::vector<usize> live_sizes(batches);
+                for (auto const & placement : placements)
+                {
+                    if (placement.heap_index != heap_index) continue;
+                    for (usize batch = placement.start_batch; batch <= placement.end_batch; ++batch)
+                    {
+                        live_sizes[batch] += placement.size;
+                    }
+                }
+                for (usize const live_size : live_sizes)
+                {
+                    heap_lower_bounds[heap_index] = std::max(heap_lower_bounds[heap_index], live_size);
+                }
             }
 
-            std::sort(lifetime_length_sorted_resources.begin(), lifetime_length_sorted_resources.end(),
-                      [](LifetimeLengthResource const & first, LifetimeLengthResource const & second) -> bool
+            // Placing the largest resources first leaves the small ones to fill the gaps between them.
+            std::sort(placements.begin(), placements.end(),
+                      [](TransientPlacement const & first, TransientPlacement const & second) -> bool
                       {
-                          return first.lifetime_length > second.lifetime_length;
+                          if (first.size != second.size)
+                          {
+                              return first.size > second.size;
+                          }
+                          if (first.start_batch != second.start_batch)
+                          {
+                              return first.start_batch < second.start_batch;
+                          }
+                          return first.resource_idx < second.resource_idx;
                       });
-
-            struct Allocation
-            {
-                usize offset = {};
-                usize size = {};
-                usize start_batch = {};
-                usize end_batch = {};
-                bool is_image = {};
-                u32 owning_resource_idx = {};
-                u32 memory_type_bits = {};
-                ImageMipArraySlice intersection_object = {};
-            };
-            // Sort allocations in the set in the following way
-            //      1) sort by offsets into the memory block
-            //  if equal:
-            //      2) sort by start batch of the allocation
-            //  if equal:
-            //      3) sort by owning image index
-            struct AllocCompare
+            std::vector<usize> heap_back_offsets(heaps.size());
+            std::vector<TransientPlacement const *> overlapping = {};
+            for (usize placement_index = 0; placement_index < placements.size(); ++placement_index)
             {
-                constexpr auto operator()(Allocation const & first, Allocation const & second) const -> bool
+                TransientPlacement & placement = placements[placement_index];
+                if (info.alias_transients)
                 {
-                    if (first.offset < second.offset)
-                    {
-                        return true;
-                    }
-                    if (first.offset == second.offset)
+                    // Every already placed resource alive at the same time as this one occupies its range of the heap.
+                    // The free ranges between them form the free list, the resource goes into the smallest one it fits.
+                    overlapping.clear();
+                    for (usize placed_index = 0; placed_index < placement_index; ++placed_index)
                     {
-                        if (first.start_batch < second.start_batch)
+                        TransientPlacement const & placed = placements[placed_index];
+                        if (placed.heap_index == placement.heap_index &&
+                            placed.start_batch <= placement.end_batch &&
+                            placement.start_batch <= placed.end_batch)
                         {
-                            return true;
+                            overlapping.push_back(&placed);
                         }
-                        if (first.start_batch == second.start_batch)
+                    }
+                    std::sort(overlapping.begin(), overlapping.end(),
+                              [](TransientPlacement const * first, TransientPlacement const * second)
+                              { return first->offset < second->offset; });
+                    usize free_begin = 0;
+                    std::optional<usize> best_offset = {};
+                    usize best_gap = std::numeric_limits<usize>::max();
+                    for (TransientPlacement const * placed : overlapping)
+                    {
+                        usize const aligned_offset = align_up(free_begin, placement.alignment);
+                        if (aligned_offset + placement.size <= placed->offset && placed->offset - aligned_offset < best_gap)
                         {
-                            return first.owning_resource_idx < second.owning_resource_idx;
+                            best_gap = placed->offset - aligned_offset;
+                            best_offset = aligned_offset;
                         }
-                        // first.offset == second.offset && first.start_batch > second.start_batch
-                        return false;
+                        free_begin = std::max(free_begin, placed->offset + placed->size);
                     }
-                    // first.offset > second.offset
-                    return false;
-                };
-            };
-            std::set<Allocation, AllocCompare> allocations = {};
-            // Figure out where to allocate each resource
-            usize no_alias_back_offset = {};
-            for (auto const & resource_lifetime : lifetime_length_sorted_resources)
+                    placement.offset = best_offset.value_or(align_up(free_begin, placement.alignment));
+                }
+                else
+                {
+                    placement.offset = align_up(heap_back_offsets[placement.heap_index], placement.alignment);
+                    heap_back_offsets[placement.heap_index] = placement.offset + placement.size;
+                }
+                TransientHeap & heap = heaps[placement.heap_index];
+                heap.size = std::max(heap.size, placement.offset + placement.size);
+            }
+            for (auto const & placement : placements)
             {
-                MemoryRequirements mem_requirements;
-                if (resource_lifetime.is_image)
+                if (placement.is_image)
                 {
-                    mem_requirements = permutation.image_infos.at(resource_lifetime.resource_idx).memory_requirements;
+                    // Resources alive at the same time never overlap, any memory overlap is aliasing.
+                    bool aliased = false;
+                    for (auto const & other : placements)
+                    {
+                        aliased = aliased ||
+                                  (&other != &placement &&
+                                   other.heap_index == placement.heap_index &&
+                                   other.offset < placement.offset + placement.size &&
+                                   placement.offset < other.offset + other.size);
+                    }
+                    permutation.image_infos.at(placement.resource_idx).aliased = aliased;
+                    permutation.image_infos.at(placement.resource_idx).allocation_offset = placement.offset;
                 }
                 else
                 {
-                    mem_requirements = permutation.buffer_infos.at(resource_lifetime.resource_idx).memory_requirements;
-                }
-                // Go through all memory block states in which this resource is alive and try to find a spot for it
-                u8 const resource_lifetime_duration = static_cast<u8>(resource_lifetime.end_batch - resource_lifetime.start_batch + 1);
-                auto new_allocation = Allocation{
-                    .offset = 0,
-                    .size = mem_requirements.size,
-                    .start_batch = resource_lifetime.start_batch,
-                    .end_batch = resource_lifetime.end_batch,
-                    .is_image = resource_lifetime.is_image,
-                    .owning_resource_idx = resource_lifetime.resource_idx,
-                    .memory_type_bits = mem_requirements.memory_type_bits,
-                    .intersection_object = {
-                        .base_mip_level = static_cast<u8>(resource_lifetime.start_batch),
-                        .level_count = resource_lifetime_duration,
-                        .base_array_layer = static_cast<u16>(0),
-                        .layer_count = static_cast<u32>(mem_requirements.size),
-                    }};
-                usize const align = std::max(mem_requirements.alignment, static_cast<size_t>(1ull));
+                    permutation.buffer_infos.at(placement.resource_idx).allocation_offset = placement.offset;
+                }
+            }
+        }
 
-                if (info.alias_transients)
+        for (u32 heap_index = 0; heap_index < heaps.size(); ++heap_index)
+        {
+            TransientHeap & heap = heaps[heap_index];
+            stats.size += heap.size;
+            stats.lower_bound += heap_lower_bounds[heap_index];
+            if (heap.size == 0)
+            {
+                continue;
+            }
+            if (info.transient_memory_heap.has_value())
+            {
+                info.transient_memory_heap->get()->reserve(heap);
+                continue;
+            }
+            heap.memory_block = info.device.create_memory({
+                .requirements = {
+                    .size = heap.size,
+                    .alignment = heap.alignment,
+                    .memory_type_bits = heap.memory_type_bits,
+                },
+                .flags = MemoryFlagBits::DEDICATED_MEMORY,
+            });
+        }
+        return stats;
+    }
+
+    void ImplTaskGraph::schedule_permutation(TaskGraphPermutation & permutation)
+    {
+        if (info.reorder_tasks && info.scheduling == TaskGraphScheduling::DEPENDENCY_GRAPH)
+        {
+            permutation.reschedule(*this);
+        }
+        else
+        {
+            permutation.recording_order_stats = permutation.schedule_stats();
+            permutation.final_stats = permutation.recording_order_stats;
+        }
+    }
+
+    void ImplTaskGraph::finalize_permutation(TaskGraphPermutation & permutation)
+    {
+        // Labels are fixed once the batches are, building them here keeps execute free of string allocations.
+        permutation.profiling_query_count = 0;
+        permutation.profiling_task_count = 0;
+        for (usize submit_scope_index = 0; submit_scope_index < permutation.batch_submit_scopes.size(); ++submit_scope_index)
+        {
+            auto & submit_scope = permutation.batch_submit_scopes[submit_scope_index];
+            submit_scope.label = SmallString{info.name + std::string(", submit ") + std::to_string(submit_scope_index)};
+            for (usize batch_index = 0; batch_index < submit_scope.task_batches.size(); ++batch_index)
+            {
+                auto & task_batch = submit_scope.task_batches[batch_index];
+                task_batch.profiling_query_index = permutation.profiling_query_count;
+                permutation.profiling_query_count += 2 + 2 * static_cast<u32>(task_batch.tasks.size());
+                task_batch.profiling_task_index = permutation.profiling_task_count;
+                permutation.profiling_task_count += static_cast<u32>(task_batch.tasks.size());
+                task_batch.task_labels.clear();
+                for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
                 {
-                    // TODO(msakmary) Fix the intersect functionality so that it is general and does not do hacky stuff like constructing
-                    // a mip array slice
-                    // Find space in memory and time the new allocation fits into.
-                    for (auto const & allocation : allocations)
+                    ImplTask const & task = tasks[task_batch.tasks[task_index]];
+                    task_batch.task_labels.push_back(SmallString{
+                        std::string("batch ") + std::to_string(batch_index + 1) + std::string(" task ") + std::to_string(task_index) + std::string(" \"") + std::string(task.base_task->name()) + std::string("\""),
+                    });
+                }
+            }
+        }
+
+        // Insert static initialization barriers for non persistent resources:
+        // Buffers never need layout initialization, only images.
+        for (u32 task_image_index = 0; task_image_index < permutation.image_infos.size(); ++task_image_index)
+        {
+            TaskImageView const task_image_id = {{unique_index, task_image_index}};
+            auto & task_image = permutation.image_infos[task_image_index];
+            PermIndepTaskImageInfo const & glob_task_image = global_image_infos[task_image_index];
+            if (task_image.valid && !glob_task_image.is_persistent())
+            {
+                // Insert barriers, initializing all the initially accesses subresource ranges to the correct layout.
+                for (auto & first_access : task_image.first_slice_states)
+                {
+                    usize const new_barrier_index = permutation.barriers.size();
+                    permutation.barriers.push_back(TaskBarrier{
+                        .image_id = task_image_id,
+                        .slice = first_access.state.slice,
+                        .layout_before = {},
+                        .layout_after = first_access.state.latest_layout,
+                        .src_access = {},
+                        .dst_access = first_access.state.latest_access,
+                    });
+                    // Because resources may be aliased we need to insert the barrier into the batch in which the resource is first used
+                    // If we just inserted all transitions into the first batch an error as follows might occur:
+                    //      Image A lives in batch 1, Image B lives in batch 2
+                    //      Image A and B are aliased (share the same/part-of memory)
+                    //      Image A is transitioned from UNDEFINED -> TRANSFER_DST in batch 0 BUT
+                    //      Image B is also transitioned from UNDEFINED -> TRANSFER_SRT in batch 0
+                    // This is an erroneous state - task graph assumes they are separate images and thus,
+                    // for example uses Image A thinking it's in TRANSFER_DST which it is not
+                    if (info.alias_transients && task_image.aliased)
                     {
-                        if (new_allocation.intersection_object.intersects(allocation.intersection_object))
-                        {
-                            // assign new offset into the memory block - we need to guarantee correct alignment
-                            usize const curr_offset = allocation.offset + allocation.size;
-                            usize const aligned_curr_offset = (curr_offset + align - 1) / align * align;
-                            new_allocation.offset = aligned_curr_offset;
-                            new_allocation.intersection_object.base_array_layer = static_cast<u32>(new_allocation.offset);
-                        }
+                        // Images that share no memory with other transients are initialized together in the first batch.
+                        auto const submit_scope_index = first_access.latest_access_submit_scope_index;
+                        auto const batch_index = first_access.latest_access_batch_index;
+                        auto & first_used_batch = permutation.batch_submit_scopes[submit_scope_index].task_batches[batch_index];
+                        first_used_batch.pipeline_barrier_indices.push_back(new_barrier_index);
+                    }
+                    else
+                    {
+                        auto & first_used_batch = permutation.batch_submit_scopes[0].task_batches[0];
+                        first_used_batch.pipeline_barrier_indices.push_back(new_barrier_index);
                     }
                 }
-                else
+            }
+        }
+    }
+
+    auto ImplTaskGraph::jit_permutation(u32 permutation_index) -> TaskGraphPermutation &
+    {
+        auto lru_iter = std::find(jit_lru_permutations.begin(), jit_lru_permutations.end(), permutation_index);
+        if (lru_iter != jit_lru_permutations.end())
+        {
+            jit_lru_permutations.erase(lru_iter);
+            jit_lru_permutations.push_back(permutation_index);
+            return jit_permutations.at(permutation_index);
+        }
+
+        auto & permutation = jit_permutations[permutation_index];
+        permutation.batch_submit_scopes.push_back({});
+        for (auto const & global_buffer : global_buffer_infos)
+        {
+            permutation.buffer_infos.push_back(PerPermTaskBuffer{
+                .valid = !global_buffer.is_persistent() && daxa::get<PermIndepTaskBufferInfo::Transient>(global_buffer.task_buffer_data).condition.active_in(permutation_index),
+            });
+        }
+        for (u32 image_index = 0; image_index < global_image_infos.size(); ++image_index)
+        {
+            auto const & global_image = global_image_infos[image_index];
+            permutation.image_infos.emplace_back(PerPermTaskImage{
+                .valid = !global_image.is_persistent() && daxa::get<PermIndepTaskImageInfo::Transient>(global_image.task_image_data).condition.active_in(permutation_index),
+                .swapchain_semaphore_waited_upon = false,
+            });
+            if (global_image.is_persistent() && global_image.get_persistent().info.swapchain_image)
+            {
+                permutation.swapchain_image = TaskImageView{{.task_graph_index = unique_index, .index = image_index}};
+            }
+        }
+        bool const record_calls = info.reorder_tasks && info.scheduling == TaskGraphScheduling::DEPENDENCY_GRAPH;
+        for (auto const & recorded_call : jit_recorded_calls)
+        {
+            if (!recorded_call.condition.active_in(permutation_index))
+            {
+                continue;
+            }
+            if (TaskId const * task_id = std::get_if<TaskId>(&recorded_call.call))
+            {
+                permutation.add_task(*this, tasks[*task_id], *task_id);
+            }
+            else if (TaskSubmitInfo const * submit_info = std::get_if<TaskSubmitInfo>(&recorded_call.call))
+            {
+                permutation.submit(*submit_info);
+            }
+            else
+            {
+                permutation.present(std::get<TaskPresentInfo>(recorded_call.call));
+            }
+            if (record_calls)
+            {
+                permutation.recorded_calls.push_back(recorded_call.call);
+            }
+        }
+        schedule_permutation(permutation);
+        std::array<TaskGraphPermutation *, 1> const perms = {&permutation};
+        permutation.jit_transient_memory_stats = allocate_transient_resources(perms, permutation.jit_transient_heaps);
+        create_transient_runtime_resources(perms, permutation.jit_transient_heaps);
+        finalize_permutation(permutation);
+
+        jit_lru_permutations.push_back(permutation_index);
+        if (jit_lru_permutations.size() > std::max(1u, info.jit_permutation_cache_size))
+        {
+            // Permutations other executions are recording stay, the cache then shrinks back on a later execution.
+            auto const evicted = std::find_if(
+                jit_lru_permutations.begin(), std::prev(jit_lru_permutations.end()),
+                [&](u32 index)
                 {
-                    usize const aligned_curr_offset = (no_alias_back_offset + align - 1) / align * align;
-                    new_allocation.offset = aligned_curr_offset;
-                    no_alias_back_offset = new_allocation.offset + new_allocation.size;
-                }
-                allocations.insert(new_allocation);
+                    return std::none_of(
+                        execution_contexts.begin(), execution_contexts.end(),
+                        [&](TaskGraphExecutionContext const & context)
+                        { return context.permutation == &jit_permutations.at(index); });
+                });
+            if (evicted != std::prev(jit_lru_permutations.end()))
+            {
+                // The gpu may still use the evicted resources, their destruction is deferred by the device.
+                u32 const evicted_index = *evicted;
+                jit_lru_permutations.erase(evicted);
+                destroy_transient_runtime_resources(jit_permutations.at(evicted_index));
+                jit_permutations.erase(evicted_index);
+            }
+        }
+        return permutation;
+    }
+
+    auto ImplTaskGraph::get_permutation(u32 permutation_index) -> TaskGraphPermutation &
+    {
+        if (info.jit_compile_permutations)
+        {
+            return jit_permutation(permutation_index);
+        }
+        if (!transient_resources_created)
+        {
+            std::vector<TaskGraphPermutation *> perms = {};
+            for (auto & permutation : permutations)
+            {
+                perms.push_back(&permutation);
+            }
+            create_transient_runtime_resources(perms, transient_heaps);
+            transient_resources_created = true;
+        }
+        return permutations[permutation_index];
+    }
+
+    void ImplTaskGraph::defer_transient_image_initialization(TaskGraphPermutation & permutation, u32 image_index)
+    {
+        // finalize_permutation put the initialization barriers of the image into the first batch, they are moved to the first use.
+        auto & first_batch_barrier_indices = permutation.batch_submit_scopes[0].task_batches[0].pipeline_barrier_indices;
+        for (auto const & first_access : permutation.image_infos[image_index].first_slice_states)
+        {
+            auto barrier_iter = std::find_if(
+                first_batch_barrier_indices.begin(), first_batch_barrier_indices.end(),
+                [&](usize barrier_index)
+                {
+                    TaskBarrier const & barrier = permutation.barriers[barrier_index];
+                    return barrier.image_id.index == image_index && barrier.layout_before == ImageLayout::UNDEFINED && barrier.slice == first_access.state.slice;
+                });
+            if (barrier_iter == first_batch_barrier_indices.end())
+            {
+                continue;
             }
-            // Once we are done with finding space for all the allocations go through all permutation images and copy over the allocation information
-            for (auto const & allocation : allocations)
+            usize const barrier_index = *barrier_iter;
+            first_batch_barrier_indices.erase(barrier_iter);
+            auto & first_used_batch = permutation.batch_submit_scopes[first_access.latest_access_submit_scope_index].task_batches[first_access.latest_access_batch_index];
+            first_used_batch.pipeline_barrier_indices.push_back(barrier_index);
+        }
+    }
+
+    void ImplTaskGraph::replace_transient_resources()
+    {
+        auto replace = [&](std::span<TaskGraphPermutation * const> perms, std::vector<TransientHeap> & heaps, bool resources_created) -> TransientMemoryStats
+        {
+            std::vector<std::vector<bool>> were_aliased = {};
+            for (TaskGraphPermutation * permutation : perms)
             {
-                if (allocation.is_image)
+                if (resources_created)
                 {
-                    permutation.image_infos.at(allocation.owning_resource_idx).allocation_offset = allocation.offset;
+                    destroy_transient_runtime_resources(*permutation);
                 }
-                else
+                auto & aliased = were_aliased.emplace_back();
+                for (auto const & image : permutation->image_infos)
                 {
-                    permutation.buffer_infos.at(allocation.owning_resource_idx).allocation_offset = allocation.offset;
+                    aliased.push_back(image.aliased);
+                }
+            }
+            heaps.clear();
+            TransientMemoryStats const stats = allocate_transient_resources(perms, heaps);
+            // Images that only became aliased need their initialization deferred to the first use, the other way around the deferred barrier stays correct.
+            for (usize perm_i = 0; perm_i < perms.size(); ++perm_i)
+            {
+                for (u32 image_i = 0; image_i < perms[perm_i]->image_infos.size(); ++image_i)
+                {
+                    if (info.alias_transients && perms[perm_i]->image_infos[image_i].aliased && !were_aliased[perm_i][image_i])
+                    {
+                        defer_transient_image_initialization(*perms[perm_i], image_i);
+                    }
                 }
-                // find the amount of memory this permutation requires
-                memory_block_size = std::max(memory_block_size, allocation.offset + allocation.size);
-                memory_type_bits = memory_type_bits & allocation.memory_type_bits;
             }
+            return stats;
+        };
+
+        if (info.jit_compile_permutations)
+        {
+            for (auto & [permutation_index, permutation] : jit_permutations)
+            {
+                std::array<TaskGraphPermutation *, 1> const perms = {&permutation};
+                permutation.jit_transient_memory_stats = replace(perms, permutation.jit_transient_heaps, true);
+                create_transient_runtime_resources(perms, permutation.jit_transient_heaps);
+            }
+            return;
         }
+        std::vector<TaskGraphPermutation *> perms = {};
+        for (auto & permutation : permutations)
+        {
+            perms.push_back(&permutation);
+        }
+        transient_memory_stats = replace(perms, transient_heaps, transient_resources_created);
+        // With a shared heap, the resources are created on the next execution again, so the heap can grow first.
+        transient_resources_created = !info.transient_memory_heap.has_value();
+        if (transient_resources_created)
+        {
+            create_transient_runtime_resources(perms, transient_heaps);
+        }
+    }
 
-        transient_data_memory_block = info.device.create_memory({
-            .requirements = {
-                .size = memory_block_size,
-                .alignment = max_alignment_requirement,
-                .memory_type_bits = memory_type_bits,
-            },
-            .flags = MemoryFlagBits::DEDICATED_MEMORY,
-        });
+    void TaskGraph::resize_transient_buffer(TaskBufferView buffer, usize size)
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        DAXA_DBG_ASSERT_TRUE_M(impl.compiled, "only completed task graphs can be patched, before that the info can be changed directly");
+        DAXA_DBG_ASSERT_TRUE_M(buffer.task_graph_index == impl.unique_index, "can only resize transient buffers of this task graph");
+        auto & global_buffer = impl.global_buffer_infos.at(buffer.index);
+        DAXA_DBG_ASSERT_TRUE_M(!global_buffer.is_persistent(), "can only resize transient buffers");
+        daxa::get<PermIndepTaskBufferInfo::Transient>(global_buffer.task_buffer_data).info.size = size;
+        impl.replace_transient_resources();
+    }
+
+    void TaskGraph::resize_transient_image(TaskImageView image, Extent3D size)
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        DAXA_DBG_ASSERT_TRUE_M(impl.compiled, "only completed task graphs can be patched, before that the info can be changed directly");
+        DAXA_DBG_ASSERT_TRUE_M(image.task_graph_index == impl.unique_index, "can only resize transient images of this task graph");
+        auto & global_image = impl.global_image_infos.at(image.index);
+        DAXA_DBG_ASSERT_TRUE_M(!global_image.is_persistent(), "can only resize transient images");
+        daxa::get<PermIndepTaskImageInfo::Transient>(global_image.task_image_data).info.size = size;
+        impl.replace_transient_resources();
+    }
+
+    // Keeps the replaced task alive, its attachments and name are referenced by the schedule.
+    struct ReplacedCallbackTask : ITask
+    {
+        std::unique_ptr<ITask> task = {};
+        std::function<void(TaskInterface)> replaced_callback = {};
+
+        virtual auto attachments() -> std::span<TaskAttachmentInfo> override { return task->attachments(); }
+        virtual auto attachments() const -> std::span<TaskAttachmentInfo const> override { return std::as_const(*task).attachments(); }
+        virtual auto name() const -> std::string_view override { return task->name(); }
+        virtual auto type() const -> TaskType override { return task->type(); }
+        virtual void callback(TaskInterface ti) override { replaced_callback(ti); }
+    };
+
+    void TaskGraph::set_task_callback(std::string_view task_name, std::function<void(TaskInterface)> callback)
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        [[maybe_unused]] bool found = false;
+        for (auto & task : impl.tasks)
+        {
+            if (task.base_task->name() == task_name)
+            {
+                found = true;
+                auto replaced = std::make_unique<ReplacedCallbackTask>();
+                replaced->task = std::move(task.base_task);
+                replaced->replaced_callback = callback;
+                task.base_task = std::move(replaced);
+            }
+        }
+        DAXA_DBG_ASSERT_TRUE_M(found, fmt::format("found no task named \"{}\"", task_name));
+    }
+
+    void TaskGraph::set_task_enabled(std::string_view task_name, bool enabled)
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        [[maybe_unused]] bool found = false;
+        for (auto & task : impl.tasks)
+        {
+            if (task.base_task->name() == task_name)
+            {
+                found = true;
+                task.enabled = enabled;
+            }
+        }
+        DAXA_DBG_ASSERT_TRUE_M(found, fmt::format("found no task named \"{}\"", task_name));
     }
 
     void TaskGraph::complete(TaskCompleteInfo const & /*unused*/)
     {
+        DAXA_PROFILE_ZONE("TaskGraph::complete");
         auto & impl = *r_cast<ImplTaskGraph *>(this->object);
         DAXA_DBG_ASSERT_TRUE_M(!impl.compiled, "task graphs can only be completed once");
         impl.compiled = true;
+        // Video commands are not supported on the main queue, video tasks can never fall back to it.
+        for ([[maybe_unused]] auto const & task : impl.tasks)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(
+                task.base_task->type() != TaskType::VIDEO_DECODE || impl.info.async_video_decode_queue.has_value(),
+                fmt::format("video decode task \"{}\" needs TaskGraphInfo::async_video_decode_queue", task.base_task->name()));
+            DAXA_DBG_ASSERT_TRUE_M(
+                task.base_task->type() != TaskType::VIDEO_ENCODE || impl.info.async_video_encode_queue.has_value(),
+                fmt::format("video encode task \"{}\" needs TaskGraphInfo::async_video_encode_queue", task.base_task->name()));
+        }
 
-        impl.allocate_transient_resources();
+        std::vector<TaskGraphPermutation *> perms = {};
+        for (auto & permutation : impl.permutations)
+        {
+            impl.schedule_permutation(permutation);
+            perms.push_back(&permutation);
+        }
+        impl.transient_memory_stats = impl.allocate_transient_resources(perms, impl.transient_heaps);
+        // With a shared heap, the heap is only allocated once all graphs using it had the chance to reserve their memory.
+        if (!impl.info.transient_memory_heap.has_value())
+        {
+            impl.create_transient_runtime_resources(perms, impl.transient_heaps);
+            impl.transient_resources_created = true;
+        }
         // Insert static barriers initializing image layouts.
         for (auto & permutation : impl.permutations)
         {
-            impl.create_transient_runtime_buffers(permutation);
-            impl.create_transient_runtime_images(permutation);
-
-            // Insert static initialization barriers for non persistent resources:
-            // Buffers never need layout initialization, only images.
-            for (u32 task_image_index = 0; task_image_index < permutation.image_infos.size(); ++task_image_index)
-            {
-                TaskImageView const task_image_id = {{impl.unique_index, task_image_index}};
-                auto & task_image = permutation.image_infos[task_image_index];
-                PermIndepTaskImageInfo const & glob_task_image = impl.global_image_infos[task_image_index];
-                if (task_image.valid && !glob_task_image.is_persistent())
-                {
-                    // Insert barriers, initializing all the initially accesses subresource ranges to the correct layout.
-                    for (auto & first_access : task_image.first_slice_states)
-                    {
-                        usize const new_barrier_index = permutation.barriers.size();
-                        permutation.barriers.push_back(TaskBarrier{
-                            .image_id = task_image_id,
-                            .slice = first_access.state.slice,
-                            .layout_before = {},
-                            .layout_after = first_access.state.latest_layout,
-                            .src_access = {},
-                            .dst_access = first_access.state.latest_access,
-                        });
-                        // Because resources may be aliased we need to insert the barrier into the batch in which the resource is first used
-                        // If we just inserted all transitions into the first batch an error as follows might occur:
-                        //      Image A lives in batch 1, Image B lives in batch 2
-                        //      Image A and B are aliased (share the same/part-of memory)
-                        //      Image A is transitioned from UNDEFINED -> TRANSFER_DST in batch 0 BUT
-                        //      Image B is also transitioned from UNDEFINED -> TRANSFER_SRT in batch 0
-                        // This is an erroneous state - task graph assumes they are separate images and thus,
-                        // for example uses Image A thinking it's in TRANSFER_DST which it is not
-                        if (impl.info.alias_transients)
-                        {
-                            // TODO(msakmary) This is only needed when we actually alias two images - should be possible to detect this
-                            // and only defer the initialization barrier for these aliased ones instead of all of them
-                            auto const submit_scope_index = first_access.latest_access_submit_scope_index;
-                            auto const batch_index = first_access.latest_access_batch_index;
-                            auto & first_used_batch = permutation.batch_submit_scopes[submit_scope_index].task_batches[batch_index];
-                            first_used_batch.pipeline_barrier_indices.push_back(new_barrier_index);
-                        }
-                        else
-                        {
-                            auto & first_used_batch = permutation.batch_submit_scopes[0].task_batches[0];
-                            first_used_batch.pipeline_barrier_indices.push_back(new_barrier_index);
-                        }
-                    }
-                }
-            }
+            impl.finalize_permutation(permutation);
         }
     }
 
@@ -2643,26 +3714,253 @@ namespace daxa
                                "in order to have debug string you need to set record_debug_information flag to true on task graph creation");
         DAXA_DBG_ASSERT_TRUE_M(impl.executed_once,
                                "in order to have debug string you need to execute the task graph at least once");
+        std::unique_lock const lock{impl.execution_mtx};
         std::string ret = impl.debug_string_stream.str();
         impl.debug_string_stream.str("");
         return ret;
     }
 
-    auto TaskGraph::get_transient_memory_size() -> daxa::usize
+    auto TaskGraph::get_execution_scratch_growth_count() -> daxa::u64
+    {
+        auto const & impl = *r_cast<ImplTaskGraph const *>(this->object);
+        return impl.execution_scratch_growth_count.load(std::memory_order_relaxed);
+    }
+
+    auto TaskGraph::get_transient_memory_size() -> daxa::usize
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        if (impl.info.jit_compile_permutations)
+        {
+            usize size = 0;
+            for (auto const & [permutation_index, permutation] : impl.jit_permutations)
+            {
+                size += permutation.jit_transient_memory_stats.size;
+            }
+            return size;
+        }
+        return impl.transient_memory_stats.size;
+    }
+
+    auto TaskGraph::get_transient_memory_lower_bound() -> daxa::usize
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        if (impl.info.jit_compile_permutations)
+        {
+            usize lower_bound = 0;
+            for (auto const & [permutation_index, permutation] : impl.jit_permutations)
+            {
+                lower_bound = std::max(lower_bound, permutation.jit_transient_memory_stats.lower_bound);
+            }
+            return lower_bound;
+        }
+        return impl.transient_memory_stats.lower_bound;
+    }
+
+    auto TaskGraph::get_timings() -> TaskGraphGpuTimings const &
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        DAXA_DBG_ASSERT_TRUE_M(impl.info.enable_gpu_profiling, "gpu timings require TaskGraphInfo::enable_gpu_profiling");
+        // Frames of executions that are still recording are never available, they are skipped.
+        std::unique_lock const lock{impl.execution_mtx};
+        f64 const timestamp_period = static_cast<f64>(impl.info.device.properties().limits.timestamp_period);
+        u64 const completed_submit_index = impl.info.device.completed_submit_index();
+        // Newer executions are tried first, the first one fully available replaces all older ones.
+        for (u64 age = 0; age < ImplTaskGraph::GPU_PROFILING_FRAME_COUNT; ++age)
+        {
+            if (impl.gpu_profiling_execution_count <= age)
+            {
+                break;
+            }
+            u64 const execution = impl.gpu_profiling_execution_count - 1 - age;
+            auto & frame = impl.gpu_profiling_frames[execution % ImplTaskGraph::GPU_PROFILING_FRAME_COUNT];
+            if (!frame.pending)
+            {
+                break;
+            }
+            // Until the submits completed, the gpu reset of the queries may not have run yet.
+            if (frame.submit_index > completed_submit_index)
+            {
+                continue;
+            }
+            std::unique_lock const queried_lock{frame.queried_mtx};
+            std::vector<u64> const results = frame.query_pool.get_query_results(0, frame.query_count);
+            bool available = true;
+            for (u32 query = 0; query < frame.query_count; ++query)
+            {
+                available = available && results[query * 2 + 1] != 0;
+            }
+            // Tasks without queries never make their queries available.
+            u32 const statistic_count = frame.timings.pipeline_statistic_count;
+            std::vector<u64> statistics_results = {};
+            std::vector<u64> occlusion_results = {};
+            if (available && frame.statistics_query_pool.is_valid() && frame.task_count != 0)
+            {
+                statistics_results = frame.statistics_query_pool.get_query_results(0, frame.task_count);
+                for (u32 task = 0; task < frame.task_count; ++task)
+                {
+                    available = available && (!frame.timings.tasks[task].queried || statistics_results[task * (statistic_count + 1) + statistic_count] != 0);
+                }
+            }
+            if (available && frame.occlusion_query_pool.is_valid() && frame.task_count != 0)
+            {
+                occlusion_results = frame.occlusion_query_pool.get_query_results(0, frame.task_count);
+                for (u32 task = 0; task < frame.task_count; ++task)
+                {
+                    available = available && (!frame.timings.tasks[task].queried || occlusion_results[task * 2 + 1] != 0);
+                }
+            }
+            if (!available)
+            {
+                continue;
+            }
+            for (u32 task = 0; task < frame.task_count; ++task)
+            {
+                if (!frame.timings.tasks[task].queried)
+                {
+                    continue;
+                }
+                if (!statistics_results.empty())
+                {
+                    std::copy_n(statistics_results.begin() + task * (statistic_count + 1), statistic_count, frame.timings.pipeline_statistics.begin() + task * statistic_count);
+                }
+                if (!occlusion_results.empty())
+                {
+                    frame.timings.tasks[task].samples_passed = occlusion_results[task * 2];
+                }
+            }
+            auto duration_ns = [&](u32 begin_query) -> u64
+            {
+                u64 const ticks = results[(begin_query + 1) * 2] - results[begin_query * 2];
+                return static_cast<u64>(static_cast<f64>(ticks) * timestamp_period);
+            };
+            // Tasks on async queues may start before the first batch of the main queue.
+            auto begin_ns = [&](u32 begin_query) -> u64
+            {
+                u64 const ticks = results[begin_query * 2] > results[0] ? results[begin_query * 2] - results[0] : 0;
+                return static_cast<u64>(static_cast<f64>(ticks) * timestamp_period);
+            };
+            usize batch_timing_index = 0;
+            usize task_timing_index = 0;
+            // The permutation may have been rebuilt since, the query layout is recomputed from the timings skeleton.
+            u32 query = 0;
+            while (batch_timing_index < frame.timings.batches.size())
+            {
+                auto & batch_timing = frame.timings.batches[batch_timing_index++];
+                batch_timing.begin_ns = begin_ns(query);
+                batch_timing.duration_ns = duration_ns(query);
+                query += 2;
+                while (task_timing_index < frame.timings.tasks.size() &&
+                       frame.timings.tasks[task_timing_index].submit_scope_index == batch_timing.submit_scope_index &&
+                       frame.timings.tasks[task_timing_index].batch_index == batch_timing.batch_index)
+                {
+                    frame.timings.tasks[task_timing_index].begin_ns = begin_ns(query);
+                    frame.timings.tasks[task_timing_index++].duration_ns = duration_ns(query);
+                    query += 2;
+                }
+            }
+            // The clocks drift slowly, a calibration taken frames after the execution still places it within microseconds.
+            if ((impl.info.device.properties().implicit_features & ImplicitFeatureFlagBits::CALIBRATED_TIMESTAMPS) != ImplicitFeatureFlagBits::NONE)
+            {
+                CalibratedTimestamps const calibration = impl.info.device.calibrated_timestamps();
+                frame.timings.host_begin_ns = calibration.device_ticks_to_host_ns(results[0], impl.info.device.properties().limits.timestamp_period);
+            }
+            impl.gpu_timings = frame.timings;
+            for (u64 older = age; older < ImplTaskGraph::GPU_PROFILING_FRAME_COUNT && older < impl.gpu_profiling_execution_count; ++older)
+            {
+                impl.gpu_profiling_frames[(impl.gpu_profiling_execution_count - 1 - older) % ImplTaskGraph::GPU_PROFILING_FRAME_COUNT].pending = false;
+            }
+            break;
+        }
+        return impl.gpu_timings;
+    }
+
+    auto TaskGraph::get_execution_trace() -> std::string
     {
         auto & impl = *r_cast<ImplTaskGraph *>(this->object);
-        return impl.memory_block_size;
+        DAXA_DBG_ASSERT_TRUE_M(impl.executed_once, "in order to have an execution trace you need to execute the task graph at least once");
+        std::unique_lock const lock{impl.execution_mtx};
+        u32 const permutation_index = impl.chosen_permutation_last_execution;
+        auto & permutation = impl.info.jit_compile_permutations ? impl.jit_permutations.at(permutation_index) : impl.permutations[permutation_index];
+        std::string ret = {};
+        impl.print_execution_trace_to(ret, permutation);
+        return ret;
     }
 
     thread_local std::vector<EventWaitInfo> tl_split_barrier_wait_infos = {};
+
     thread_local std::vector<ImageMemoryBarrierInfo> tl_image_barrier_infos = {};
     thread_local std::vector<MemoryBarrierInfo> tl_memory_barrier_infos = {};
-    void insert_pipeline_barrier(ImplTaskGraph const & impl, TaskGraphPermutation & perm, CommandRecorder & command_list, TaskBarrier & barrier)
+    struct PendingTaskGraphSubmit
+    {
+        Queue queue = QUEUE_MAIN;
+        PipelineStageFlags wait_stages = {};
+        std::vector<ExecutableCommandList> commands = {};
+        std::vector<BinarySemaphore> wait_binary_semaphores = {};
+        std::vector<BinarySemaphore> signal_binary_semaphores = {};
+        std::vector<std::pair<TimelineSemaphore, u64>> wait_timeline_semaphores = {};
+        std::vector<std::pair<TimelineSemaphore, u64>> signal_timeline_semaphores = {};
+
+        void clear()
+        {
+            queue = QUEUE_MAIN;
+            wait_stages = {};
+            commands.clear();
+            wait_binary_semaphores.clear();
+            signal_binary_semaphores.clear();
+            wait_timeline_semaphores.clear();
+            signal_timeline_semaphores.clear();
+        }
+    };
+
+    // Reused by every execution, so the steady state does not allocate for submits and presents.
+    thread_local std::vector<PendingTaskGraphSubmit> tl_pending_submits = {};
+    thread_local std::vector<CommandSubmitInfo> tl_submit_infos = {};
+    thread_local std::vector<BinarySemaphore> tl_present_wait_semaphores = {};
+    // Per execution state of TaskGraph::execute, reused like the submits above.
+    // Execute binds references to them up front, so recording threads only touch the ones of the executing thread.
+    thread_local std::vector<bool> tl_persistent_synch_buffers = {};
+    thread_local std::vector<bool> tl_persistent_synch_images = {};
+    thread_local std::vector<std::mutex *> tl_persistent_mutexes = {};
+    thread_local std::vector<ExecutableCommandList> tl_scope_command_lists = {};
+
+    // The barriers of a batch are collected and recorded with a single pipeline_barriers call.
+    thread_local std::vector<MemoryBarrierInfo> tl_batch_memory_barrier_infos = {};
+    thread_local std::vector<ImageMemoryBarrierInfo> tl_batch_image_barrier_infos = {};
+
+    // Summed capacity of the execution scratch of the calling thread. The scratch never shrinks, so any growth increases it.
+    auto execution_scratch_capacity() -> usize
+    {
+        usize capacity =
+            tl_split_barrier_wait_infos.capacity() +
+            tl_image_barrier_infos.capacity() +
+            tl_memory_barrier_infos.capacity() +
+            tl_pending_submits.capacity() +
+            tl_submit_infos.capacity() +
+            tl_present_wait_semaphores.capacity() +
+            tl_persistent_synch_buffers.capacity() +
+            tl_persistent_synch_images.capacity() +
+            tl_persistent_mutexes.capacity() +
+            tl_scope_command_lists.capacity() +
+            tl_batch_memory_barrier_infos.capacity() +
+            tl_batch_image_barrier_infos.capacity();
+        for (auto const & pending_submit : tl_pending_submits)
+        {
+            capacity +=
+                pending_submit.commands.capacity() +
+                pending_submit.wait_binary_semaphores.capacity() +
+                pending_submit.signal_binary_semaphores.capacity() +
+                pending_submit.wait_timeline_semaphores.capacity() +
+                pending_submit.signal_timeline_semaphores.capacity();
+        }
+        return capacity;
+    }
+
+    void collect_pipeline_barrier(ImplTaskGraph const & impl, TaskGraphPermutation & perm, TaskBarrier const & barrier)
     {
         // Check if barrier is image barrier or normal barrier (see TaskBarrier struct comments).
         if (barrier.image_id.is_empty())
         {
-            command_list.pipeline_barrier({
+            tl_batch_memory_barrier_infos.push_back({
                 .src_access = barrier.src_access,
                 .dst_access = barrier.dst_access,
             });
@@ -2680,7 +3978,7 @@ namespace daxa
                         std::string(" of task image \"") +
                         std::string(impl.global_image_infos[barrier.image_id.index].get_name()) +
                         std::string("\" is invalid"));
-                command_list.pipeline_barrier_image_transition({
+                tl_batch_image_barrier_infos.push_back({
                     .src_access = barrier.src_access,
                     .dst_access = barrier.dst_access,
                     .src_layout = barrier.layout_before,
@@ -2692,6 +3990,46 @@ namespace daxa
         }
     }
 
+    void record_collected_pipeline_barriers(CommandRecorder & command_list)
+    {
+        if (tl_batch_memory_barrier_infos.empty() && tl_batch_image_barrier_infos.empty())
+        {
+            return;
+        }
+        command_list.pipeline_barriers({
+            .memory_barriers = tl_batch_memory_barrier_infos,
+            .image_barriers = tl_batch_image_barrier_infos,
+        });
+        tl_batch_memory_barrier_infos.clear();
+        tl_batch_image_barrier_infos.clear();
+    }
+
+    // The latest access of a sequence of concurrent reads only holds the last read,
+    // the barrier synchronizing the sequence with the previous write holds all of them.
+    // Remembering all reads lets the next execution skip reads that were already synchronized with the write
+    // and makes its barriers wait on all reads before the next write.
+    auto synchronized_concurrent_access(
+        TaskGraphPermutation const & permutation,
+        Access latest_access,
+        TaskAccessConcurrency latest_access_concurrent,
+        Variant<Monostate, LastConcurrentAccessSplitBarrierIndex, LastConcurrentAccessBarrierIndex> const & latest_concurrent_access_barrier_index) -> Access
+    {
+        // The barrier index is only kept up to date while the accesses are concurrent.
+        if (latest_access.type != AccessTypeFlagBits::READ || latest_access_concurrent != TaskAccessConcurrency::CONCURRENT)
+        {
+            return latest_access;
+        }
+        if (LastConcurrentAccessSplitBarrierIndex const * index0 = daxa::get_if<LastConcurrentAccessSplitBarrierIndex>(&latest_concurrent_access_barrier_index))
+        {
+            return latest_access | permutation.split_barriers[index0->index].dst_access;
+        }
+        if (LastConcurrentAccessBarrierIndex const * index1 = daxa::get_if<LastConcurrentAccessBarrierIndex>(&latest_concurrent_access_barrier_index))
+        {
+            return latest_access | permutation.barriers[index1->index].dst_access;
+        }
+        return latest_access;
+    }
+
     void generate_persistent_resource_synch(
         ImplTaskGraph & impl,
         TaskGraphPermutation & permutation,
@@ -2701,6 +4039,8 @@ namespace daxa
         // as pre generating the transitions between all permutations is not manageable.
         std::string out;
         std::string indent;
+        usize recorded_barrier_count = 0;
+        usize elided_barrier_count = 0;
         if (impl.info.record_debug_information)
         {
             fmt::format_to(std::back_inserter(out), "{}runtime sync memory barriers:\n", indent);
@@ -2714,30 +4054,31 @@ namespace daxa
             {
                 auto & persistent_data = glob_buffer_info.get_persistent();
                 bool const no_prev_access = persistent_data.latest_access == AccessConsts::NONE;
-                bool const read_on_read_same_access =
-                    persistent_data.latest_access == permutation.buffer_infos[task_buffer_index].first_access &&
-                    persistent_data.latest_access.type == AccessTypeFlagBits::READ;
-                // TODO(pahrens,msakmary): read on read should only be set to true whenever the access the same and the STAGES are also the same
-                // otherwise we need to generate barrier
-                //      AS WE CANT MODIFY BARRIERS FROM PREVIOUSLY ALREADY EXECUTED TASK GRAPHS, WE MUST OVER SYNC ON THE LAST WRITE TO READ
-                //      WE CAN ONLY SKIP ON THE SAME ACCESS READ ON READ
-                //      WE MUST REMEMBER THE LAST WRITE
-
-                // bool const read_on_read =
-                //     persistent_data.latest_access.type == AccessTypeFlagBits::READ &&
-                //     permutation.buffer_infos[task_buffer_index].first_access.type == AccessTypeFlagBits::READ;
-                // For now just over sync on reads.
-                if (no_prev_access || read_on_read_same_access)
+                // As we cant modify barriers of previously executed task graphs, a read may only skip synchronization
+                // when the last write was already made visible to all of its stages.
+                // After a sequence of reads, the latest access holds the stages of all reads synchronized with the last write.
+                Access const & first_access = permutation.buffer_infos[task_buffer_index].first_access;
+                bool const read_on_visible_read =
+                    persistent_data.latest_access.type == AccessTypeFlagBits::READ &&
+                    first_access.type == AccessTypeFlagBits::READ &&
+                    (first_access.stages & persistent_data.latest_access.stages) == first_access.stages;
+                if (no_prev_access)
                 {
                     // Skip buffers that have no previous access, as there is nothing to sync on.
                     continue;
                 }
+                if (read_on_visible_read)
+                {
+                    ++elided_barrier_count;
+                    continue;
+                }
 
                 MemoryBarrierInfo const mem_barrier_info{
                     .src_access = persistent_data.latest_access,
                     .dst_access = permutation.buffer_infos[task_buffer_index].first_access,
                 };
                 recorder.pipeline_barrier(mem_barrier_info);
+                ++recorded_barrier_count;
                 if (impl.info.record_debug_information)
                 {
                     fmt::format_to(std::back_inserter(out), "{}{}\n", indent, to_string(mem_barrier_info));
@@ -2792,7 +4133,11 @@ namespace daxa
                         bool const both_layouts_same =
                             remaining_first_accesses[first_access_slice_index].state.latest_layout ==
                             previous_access_slices[previous_access_slice_index].latest_layout;
-                        if (!(both_accesses_read && both_layouts_same))
+                        if (both_accesses_read && both_layouts_same)
+                        {
+                            ++elided_barrier_count;
+                        }
+                        else
                         {
                             for (auto execution_image_id : impl.get_actual_images(TaskImageView{{.task_graph_index = impl.unique_index, .index = task_image_index}}, permutation))
                             {
@@ -2805,6 +4150,7 @@ namespace daxa
                                     .image_id = execution_image_id,
                                 };
                                 recorder.pipeline_barrier_image_transition(img_barrier_info);
+                                ++recorded_barrier_count;
                                 if (impl.info.record_debug_information)
                                 {
                                     fmt::format_to(std::back_inserter(out), "{}{}\n", indent, to_string(img_barrier_info));
@@ -2867,6 +4213,7 @@ namespace daxa
                             .image_id = execution_image_id,
                         };
                         recorder.pipeline_barrier_image_transition(img_barrier_info);
+                        ++recorded_barrier_count;
                         if (impl.info.record_debug_information)
                         {
                             fmt::format_to(std::back_inserter(out), "{}{}\n", indent, to_string(img_barrier_info));
@@ -2883,6 +4230,7 @@ namespace daxa
         if (impl.info.record_debug_information)
         {
             end_indent(out, indent);
+            fmt::format_to(std::back_inserter(out), "{}runtime sync barriers: {} recorded, {} elided\n", indent, recorded_barrier_count, elided_barrier_count);
             impl.debug_string_stream << out;
         }
     }
@@ -2904,26 +4252,582 @@ namespace daxa
     ///     2.3 check if submit scope presents, present if true.
     void TaskGraph::execute(ExecutionInfo const & info)
     {
+        DAXA_PROFILE_ZONE("TaskGraph::execute");
         auto & impl = *r_cast<ImplTaskGraph *>(this->object);
         DAXA_DBG_ASSERT_TRUE_M(info.permutation_condition_values.size() >= impl.info.permutation_condition_count, "Detected invalid permutation condition count");
         DAXA_DBG_ASSERT_TRUE_M(impl.compiled, "task graphs must be completed before execution");
+        usize const scratch_capacity_before = execution_scratch_capacity();
+        defer
+        {
+            if (execution_scratch_capacity() > scratch_capacity_before)
+            {
+                impl.execution_scratch_growth_count.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
 
         u32 permutation_index = {};
         for (u32 index = 0; index < std::min(usize(32), info.permutation_condition_values.size()); ++index)
         {
             permutation_index |= info.permutation_condition_values[index] ? (1u << index) : 0;
         }
+
+        // The contexts are taken in turn, an execution waits until the one that used its context before ended.
+        std::unique_lock execution_lock{impl.execution_mtx};
+        impl.execution_cv.wait(execution_lock, [&]()
+                               { return !impl.execution_contexts[impl.begun_execution_count % impl.execution_contexts.size()].in_use; });
+        u64 const execution_index = impl.begun_execution_count++;
+        TaskGraphExecutionContext & context = impl.execution_contexts[execution_index % impl.execution_contexts.size()];
+        context.in_use = true;
         impl.chosen_permutation_last_execution = permutation_index;
-        TaskGraphPermutation & permutation = impl.permutations[permutation_index];
+        TaskGraphPermutation & permutation = impl.get_permutation(permutation_index);
+        context.permutation = &permutation;
+        impl.collect_image_views();
+
+        CommandRecorder recorder = impl.info.device.create_command_recorder({.merge_renderpasses = impl.info.merge_renderpasses});
+
+        ImplTaskRuntimeInterface impl_runtime{
+            .task_graph = impl,
+            .permutation = permutation,
+            .recorder = recorder,
+            .context = context,
+            .staging_memory = context.staging_memory.has_value() ? &context.staging_memory.value() : nullptr,
+        };
+
+        ImplTaskGraph::GpuProfilingFrame * profiling_frame = nullptr;
+        if (impl.info.enable_gpu_profiling && permutation.profiling_query_count != 0)
+        {
+            profiling_frame = &impl.begin_gpu_profiling_frame(permutation);
+            recorder.reset_timestamps({
+                .query_pool = profiling_frame->query_pool,
+                .start_index = 0,
+                .count = permutation.profiling_query_count,
+            });
+            if (impl.info.gpu_profiling_pipeline_statistics != PipelineStatisticFlagBits::NONE)
+            {
+                recorder.reset_queries({
+                    .query_pool = profiling_frame->statistics_query_pool,
+                    .start_index = 0,
+                    .count = permutation.profiling_task_count,
+                });
+            }
+            if (impl.info.gpu_profiling_occlusion)
+            {
+                recorder.reset_queries({
+                    .query_pool = profiling_frame->occlusion_query_pool,
+                    .start_index = 0,
+                    .count = permutation.profiling_task_count,
+                });
+            }
+        }
+        auto write_profiling_timestamp = [&](ImplTaskRuntimeInterface & runtime, PipelineStageFlags stage, u32 query_index)
+        {
+            if (profiling_frame != nullptr)
+            {
+                runtime.recorder.write_timestamp({
+                    .query_pool = profiling_frame->query_pool,
+                    .pipeline_stage = stage,
+                    .query_index = query_index,
+                });
+            }
+        };
+        // Disabled tasks still write their timestamps, otherwise their queries would never become available.
+        // Statistics and occlusion queries need a graphics queue, so only tasks on the main queue are queried.
+        auto execute_profiled_task = [&](ImplTaskRuntimeInterface & runtime, TaskBatch & task_batch, usize task_index, bool on_main_queue)
+        {
+            [[maybe_unused]] TaskType const task_type = impl.tasks[task_batch.tasks[task_index]].base_task->type();
+            DAXA_DBG_ASSERT_TRUE_M(
+                !on_main_queue || (task_type != TaskType::VIDEO_DECODE && task_type != TaskType::VIDEO_ENCODE),
+                "video tasks need their async video queue, concurrently shared images and a submitted scope");
+            u32 const query_index = task_batch.profiling_query_index + 2 + 2 * static_cast<u32>(task_index);
+            u32 const task_query_index = task_batch.profiling_task_index + static_cast<u32>(task_index);
+            bool const queried =
+                profiling_frame != nullptr && on_main_queue &&
+                (profiling_frame->statistics_query_pool.is_valid() || profiling_frame->occlusion_query_pool.is_valid()) &&
+                impl.tasks[task_batch.tasks[task_index]].base_task->type() != TaskType::TRANSFER;
+            write_profiling_timestamp(runtime, PipelineStageFlagBits::TOP_OF_PIPE, query_index);
+            if (queried)
+            {
+                {
+                    std::unique_lock const queried_lock{profiling_frame->queried_mtx};
+                    profiling_frame->timings.tasks[task_query_index].queried = true;
+                }
+                if (impl.info.gpu_profiling_pipeline_statistics != PipelineStatisticFlagBits::NONE)
+                {
+                    runtime.recorder.begin_query({.query_pool = profiling_frame->statistics_query_pool, .query_index = task_query_index});
+                }
+                if (impl.info.gpu_profiling_occlusion)
+                {
+                    runtime.recorder.begin_query({.query_pool = profiling_frame->occlusion_query_pool, .query_index = task_query_index});
+                }
+            }
+            auto const record_begin = std::chrono::steady_clock::now();
+            impl.execute_task(runtime, permutation, task_batch.task_labels[task_index], task_batch.tasks[task_index]);
+            if (profiling_frame != nullptr)
+            {
+                auto const record_end = std::chrono::steady_clock::now();
+                TaskGpuTiming & timing = profiling_frame->timings.tasks[task_query_index];
+                timing.record_begin_host_ns = static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(record_begin.time_since_epoch()).count());
+                timing.record_duration_ns = static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(record_end - record_begin).count());
+            }
+            if (queried)
+            {
+                if (impl.info.gpu_profiling_occlusion)
+                {
+                    runtime.recorder.end_query({.query_pool = profiling_frame->occlusion_query_pool, .query_index = task_query_index});
+                }
+                if (impl.info.gpu_profiling_pipeline_statistics != PipelineStatisticFlagBits::NONE)
+                {
+                    runtime.recorder.end_query({.query_pool = profiling_frame->statistics_query_pool, .query_index = task_query_index});
+                }
+            }
+            write_profiling_timestamp(runtime, PipelineStageFlagBits::BOTTOM_OF_PIPE, query_index + 1);
+        };
+
+        if (impl.info.transient_memory_heap.has_value())
+        {
+            // Transients of previously executed graphs may alias the ones of this graph.
+            recorder.pipeline_barrier({
+                .src_access = AccessConsts::READ_WRITE,
+                .dst_access = AccessConsts::READ_WRITE,
+            });
+        }
+
+        // Offloaded tasks do not see the barriers recorded on the main queue. These persistent resources are synchronized
+        // with earlier executions at the start of the first main queue submit, offloaded tasks using them wait for it.
+        std::vector<bool> & persistent_synch_buffers = tl_persistent_synch_buffers;
+        std::vector<bool> & persistent_synch_images = tl_persistent_synch_images;
+        {
+            // Other graphs may start executions using the same persistent resources at the same time.
+            // The locks are always taken in address order, so graphs sharing resources can not deadlock.
+            std::vector<std::mutex *> & persistent_mutexes = tl_persistent_mutexes;
+            persistent_mutexes.clear();
+            for (auto & global_buffer : impl.global_buffer_infos)
+            {
+                if (global_buffer.is_persistent())
+                {
+                    persistent_mutexes.push_back(&global_buffer.get_persistent().mtx);
+                }
+            }
+            for (auto & global_image : impl.global_image_infos)
+            {
+                if (global_image.is_persistent())
+                {
+                    persistent_mutexes.push_back(&global_image.get_persistent().mtx);
+                }
+            }
+            std::sort(persistent_mutexes.begin(), persistent_mutexes.end(), std::less<std::mutex *>{});
+            persistent_mutexes.erase(std::unique(persistent_mutexes.begin(), persistent_mutexes.end()), persistent_mutexes.end());
+            usize locked_mutex_count = 0;
+            defer
+            {
+                for (usize mutex_index = locked_mutex_count; mutex_index > 0; --mutex_index)
+                {
+                    persistent_mutexes[mutex_index - 1]->unlock();
+                }
+            };
+            for (std::mutex * mutex : persistent_mutexes)
+            {
+                mutex->lock();
+                ++locked_mutex_count;
+            }
+
+            validate_runtime_resources(impl, permutation);
+            persistent_synch_buffers.assign(permutation.buffer_infos.size(), false);
+            for (usize task_buffer_index = 0; task_buffer_index < permutation.buffer_infos.size(); ++task_buffer_index)
+            {
+                persistent_synch_buffers[task_buffer_index] =
+                    permutation.buffer_infos[task_buffer_index].valid &&
+                    impl.global_buffer_infos[task_buffer_index].is_persistent() &&
+                    impl.global_buffer_infos[task_buffer_index].get_persistent().latest_access != AccessConsts::NONE;
+            }
+            // Images may need a transition out of the undefined layout even on their first use.
+            persistent_synch_images.assign(permutation.image_infos.size(), false);
+            for (usize task_image_index = 0; task_image_index < permutation.image_infos.size(); ++task_image_index)
+            {
+                persistent_synch_images[task_image_index] = permutation.image_infos[task_image_index].valid && impl.global_image_infos[task_image_index].is_persistent();
+            }
+            // Generate and insert synchronization for persistent resources:
+            generate_persistent_resource_synch(impl, permutation, recorder);
+
+            // The recording reads the runtime resources of this moment, later executions may already change them.
+            context.persistent_buffers.resize(impl.global_buffer_infos.size());
+            for (usize task_buffer_index = 0; task_buffer_index < impl.global_buffer_infos.size(); ++task_buffer_index)
+            {
+                if (impl.global_buffer_infos[task_buffer_index].is_persistent())
+                {
+                    context.persistent_buffers[task_buffer_index] = impl.global_buffer_infos[task_buffer_index].get_persistent().actual_ids;
+                }
+            }
+            context.persistent_images.resize(impl.global_image_infos.size());
+            context.task_states.resize(impl.tasks.size());
+            for (usize task_image_index = 0; task_image_index < impl.global_image_infos.size(); ++task_image_index)
+            {
+                if (impl.global_image_infos[task_image_index].is_persistent())
+                {
+                    context.persistent_images[task_image_index] = impl.global_image_infos[task_image_index].get_persistent().actual_images;
+                }
+            }
+
+            // Insert pervious uses into execution info for tje next executions synch.
+            // The final accesses only depend on the permutation, so the next execution may start before this one recorded.
+            for (usize task_buffer_index = 0; task_buffer_index < permutation.buffer_infos.size(); ++task_buffer_index)
+            {
+                bool const is_persistent = daxa::holds_alternative<PermIndepTaskBufferInfo::Persistent>(impl.global_buffer_infos[task_buffer_index].task_buffer_data);
+                if (permutation.buffer_infos[task_buffer_index].valid && is_persistent)
+                {
+                    auto const & task_buffer = permutation.buffer_infos[task_buffer_index];
+                    daxa::get<PermIndepTaskBufferInfo::Persistent>(impl.global_buffer_infos[task_buffer_index].task_buffer_data).get().latest_access =
+                        synchronized_concurrent_access(permutation, task_buffer.latest_access, task_buffer.latest_access_concurrent, task_buffer.latest_concurrent_access_barrer_index);
+                }
+            }
+            for (usize task_image_index = 0; task_image_index < permutation.image_infos.size(); ++task_image_index)
+            {
+                if (
+                    permutation.image_infos[task_image_index].valid &&
+                    impl.global_image_infos[task_image_index].is_persistent())
+                {
+                    auto & persistent_image = impl.global_image_infos[task_image_index].get_persistent();
+                    for (auto const & extended_state : permutation.image_infos[task_image_index].last_slice_states)
+                    {
+                        ImageSliceState state = extended_state.state;
+                        state.latest_access = synchronized_concurrent_access(permutation, state.latest_access, extended_state.latest_access_concurrent, extended_state.latest_concurrent_access_barrer_index);
+                        persistent_image.latest_slice_states.push_back(state);
+                    }
+                }
+            }
+        }
+        execution_lock.unlock();
+        ImplTaskGraph::recording_context = &context;
+
+        // Submits are made in the order the executions began.
+        bool submit_turn = false;
+        auto wait_for_submit_turn = [&]()
+        {
+            if (!submit_turn)
+            {
+                std::unique_lock lock{impl.execution_mtx};
+                impl.execution_cv.wait(lock, [&]()
+                                       { return impl.ended_execution_count == execution_index; });
+                submit_turn = true;
+            }
+        };
+
+        usize pending_submit_count = 0;
+        auto push_pending_submit = [&]() -> PendingTaskGraphSubmit &
+        {
+            if (pending_submit_count == tl_pending_submits.size())
+            {
+                tl_pending_submits.emplace_back();
+            }
+            return tl_pending_submits[pending_submit_count++];
+        };
+        u64 profiling_submit_index = std::numeric_limits<u64>::max();
+        auto flush_pending_submits = [&]()
+        {
+            wait_for_submit_turn();
+            if (pending_submit_count == 0)
+            {
+                return;
+            }
+            for (usize index = 0; index < pending_submit_count; ++index)
+            {
+                PendingTaskGraphSubmit const & pending_submit = tl_pending_submits[index];
+                tl_submit_infos.push_back(CommandSubmitInfo{
+                    .queue = pending_submit.queue,
+                    .wait_stages = pending_submit.wait_stages,
+                    .command_lists = pending_submit.commands,
+                    .wait_binary_semaphores = pending_submit.wait_binary_semaphores,
+                    .signal_binary_semaphores = pending_submit.signal_binary_semaphores,
+                    .wait_timeline_semaphores = pending_submit.wait_timeline_semaphores,
+                    .signal_timeline_semaphores = pending_submit.signal_timeline_semaphores,
+                });
+            }
+            // A batch submit targets one queue, so consecutive submits to the same queue are batched together.
+            usize run_begin = 0;
+            for (usize index = 1; index <= tl_submit_infos.size(); ++index)
+            {
+                bool const run_ends =
+                    index == tl_submit_infos.size() ||
+                    tl_submit_infos[index].queue.family != tl_submit_infos[run_begin].queue.family ||
+                    tl_submit_infos[index].queue.index != tl_submit_infos[run_begin].queue.index;
+                if (run_ends)
+                {
+                    impl.info.device.submit_batch(std::span{tl_submit_infos}.subspan(run_begin, index - run_begin));
+                    // Other threads may have submitted in between, a later index only delays resolving the timings.
+                    profiling_submit_index = impl.info.device.latest_submit_index();
+                    run_begin = index;
+                }
+            }
+            tl_submit_infos.clear();
+            // Clearing releases the command lists and semaphores but keeps the capacity for the next execution.
+            for (usize index = 0; index < pending_submit_count; ++index)
+            {
+                tl_pending_submits[index].clear();
+            }
+            pending_submit_count = 0;
+        };
 
-        CommandRecorder recorder = impl.info.device.create_command_recorder({});
+        // Records the barriers and event waits a batch needs before its tasks run.
+        auto record_batch_waits = [&](ImplTaskRuntimeInterface & runtime, TaskBatch & task_batch)
+        {
+            // Wait on pipeline barriers before batch execution.
+            for (auto barrier_index : task_batch.pipeline_barrier_indices)
+            {
+                collect_pipeline_barrier(impl, permutation, permutation.barriers[barrier_index]);
+            }
+            // Wait on split barriers before batch execution.
+            if (!impl.info.use_split_barriers)
+            {
+                for (auto barrier_index : task_batch.wait_split_barrier_indices)
+                {
+                    // Convert split barrier to normal barrier.
+                    collect_pipeline_barrier(impl, permutation, permutation.split_barriers[barrier_index]);
+                }
+                record_collected_pipeline_barriers(runtime.recorder);
+            }
+            else
+            {
+                record_collected_pipeline_barriers(runtime.recorder);
+                usize needed_image_barriers = 0;
+                for (auto barrier_index : task_batch.wait_split_barrier_indices)
+                {
+                    TaskSplitBarrier const & split_barrier = permutation.split_barriers[barrier_index];
+                    if (!split_barrier.image_id.is_empty())
+                    {
+                        needed_image_barriers += impl.get_actual_images(split_barrier.image_id, permutation).size();
+                    }
+                }
+                tl_split_barrier_wait_infos.reserve(task_batch.wait_split_barrier_indices.size());
+                tl_memory_barrier_infos.reserve(task_batch.wait_split_barrier_indices.size());
+                tl_image_barrier_infos.reserve(needed_image_barriers);
+                for (auto barrier_index : task_batch.wait_split_barrier_indices)
+                {
+                    TaskSplitBarrier & split_barrier = permutation.split_barriers[barrier_index];
+                    if (split_barrier.image_id.is_empty())
+                    {
+                        tl_memory_barrier_infos.push_back(MemoryBarrierInfo{
+                            .src_access = split_barrier.src_access,
+                            .dst_access = split_barrier.dst_access,
+                        });
+                        tl_split_barrier_wait_infos.push_back(EventWaitInfo{
+                            .memory_barriers = std::span{&tl_memory_barrier_infos.back(), 1},
+                            .event = split_barrier.split_barrier_state,
+                        });
+                    }
+                    else
+                    {
+                        usize const img_bar_vec_start_size = tl_image_barrier_infos.size();
+                        for (auto image : impl.get_actual_images(split_barrier.image_id, permutation))
+                        {
+                            tl_image_barrier_infos.push_back(ImageMemoryBarrierInfo{
+                                .src_access = split_barrier.src_access,
+                                .dst_access = split_barrier.dst_access,
+                                .src_layout = split_barrier.layout_before,
+                                .dst_layout = split_barrier.layout_after,
+                                .image_slice = split_barrier.slice,
+                                .image_id = image,
+                            });
+                        }
+                        usize const img_bar_vec_end_size = tl_image_barrier_infos.size();
+                        usize const img_bar_count = img_bar_vec_end_size - img_bar_vec_start_size;
+                        tl_split_barrier_wait_infos.push_back(EventWaitInfo{
+                            .image_barriers = std::span{tl_image_barrier_infos.data() + img_bar_vec_start_size, img_bar_count},
+                            .event = split_barrier.split_barrier_state,
+                        });
+                    }
+                }
+                if (!tl_split_barrier_wait_infos.empty())
+                {
+                    runtime.recorder.wait_events(tl_split_barrier_wait_infos);
+                }
+                tl_split_barrier_wait_infos.clear();
+                tl_image_barrier_infos.clear();
+                tl_memory_barrier_infos.clear();
+            }
+        };
+        // Records the event resets and signals that follow the tasks of a batch.
+        auto record_batch_signals = [&](ImplTaskRuntimeInterface & runtime, TaskBatch & task_batch)
+        {
+            if (impl.info.use_split_barriers)
+            {
+                // Reset all waited upon split barriers here.
+                for (auto barrier_index : task_batch.wait_split_barrier_indices)
+                {
+                    // We wait on the stages, that waited on our split barrier earlier.
+                    // This way, we make sure, that the stages that wait on the split barrier
+                    // executed and saw the split barrier signaled, before we reset them.
+                    runtime.recorder.reset_event({
+                        .event = permutation.split_barriers[barrier_index].split_barrier_state,
+                        .stage = permutation.split_barriers[barrier_index].dst_access.stages,
+                    });
+                }
+                // Signal all signal split barriers after batch execution.
+                for (usize const barrier_index : task_batch.signal_split_barrier_indices)
+                {
+                    TaskSplitBarrier & task_split_barrier = permutation.split_barriers[barrier_index];
+                    if (task_split_barrier.image_id.is_empty())
+                    {
+                        MemoryBarrierInfo memory_barrier{
+                            .src_access = task_split_barrier.src_access,
+                            .dst_access = task_split_barrier.dst_access,
+                        };
+                        runtime.recorder.signal_event({
+                            .memory_barriers = std::span{&memory_barrier, 1},
+                            .event = task_split_barrier.split_barrier_state,
+                        });
+                    }
+                    else
+                    {
+                        for (auto image : impl.get_actual_images(task_split_barrier.image_id, permutation))
+                        {
+                            tl_image_barrier_infos.push_back({
+                                .src_access = task_split_barrier.src_access,
+                                .dst_access = task_split_barrier.dst_access,
+                                .src_layout = task_split_barrier.layout_before,
+                                .dst_layout = task_split_barrier.layout_after,
+                                .image_slice = task_split_barrier.slice,
+                                .image_id = image,
+                            });
+                        }
+                        runtime.recorder.signal_event({
+                            .image_barriers = tl_image_barrier_infos,
+                            .event = task_split_barrier.split_barrier_state,
+                        });
+                        tl_image_barrier_infos.clear();
+                    }
+                }
+            }
+        };
+        // Records one batch, the recording thread owns the given runtime.
+        auto record_batch = [&](ImplTaskRuntimeInterface & runtime, TaskBatch & task_batch)
+        {
+            write_profiling_timestamp(runtime, PipelineStageFlagBits::TOP_OF_PIPE, task_batch.profiling_query_index);
+            record_batch_waits(runtime, task_batch);
+            for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
+            {
+                execute_profiled_task(runtime, task_batch, task_index, true);
+            }
+            record_batch_signals(runtime, task_batch);
+            write_profiling_timestamp(runtime, PipelineStageFlagBits::BOTTOM_OF_PIPE, task_batch.profiling_query_index + 1);
+        };
 
-        ImplTaskRuntimeInterface impl_runtime{.task_graph = impl, .permutation = permutation, .recorder = recorder};
+        std::array<std::optional<Queue>, ASYNC_QUEUE_COUNT> const async_queues = {
+            impl.info.async_compute_queue,
+            impl.info.async_transfer_queue,
+            impl.info.async_video_decode_queue,
+            impl.info.async_video_encode_queue,
+        };
+        bool const uses_async_queues = std::ranges::any_of(async_queues, [](std::optional<Queue> const & queue) { return queue.has_value(); });
+        // Exclusive images would need queue family ownership transfers, tasks using them stay on the main queue.
+        auto async_queue_index = [&](ImplTask const & task) -> std::optional<usize>
+        {
+            std::optional<usize> index = {};
+            switch (task.base_task->type())
+            {
+            case TaskType::COMPUTE: index = ASYNC_QUEUE_COMPUTE; break;
+            case TaskType::TRANSFER: index = ASYNC_QUEUE_TRANSFER; break;
+            case TaskType::VIDEO_DECODE: index = ASYNC_QUEUE_VIDEO_DECODE; break;
+            case TaskType::VIDEO_ENCODE: index = ASYNC_QUEUE_VIDEO_ENCODE; break;
+            default: return std::nullopt;
+            }
+            if (!async_queues[index.value()].has_value())
+            {
+                return std::nullopt;
+            }
+            bool images_shared = true;
+            for_each(
+                task.base_task->attachments(),
+                [](u32, auto const &) {},
+                [&](u32, TaskImageAttachmentInfo const & attach)
+                {
+                    if (attach.view.is_null()) return;
+                    for (auto image : impl.get_actual_images(attach.translated_view, permutation))
+                    {
+                        images_shared = images_shared && impl.info.device.image_info(image).value().sharing_mode == SharingMode::CONCURRENT;
+                    }
+                });
+            return images_shared ? index : std::nullopt;
+        };
 
-        validate_runtime_resources(impl, permutation);
-        // Generate and insert synchronization for persistent resources:
-        generate_persistent_resource_synch(impl, permutation, recorder);
+        usize const record_thread_count = std::max(1u, impl.info.record_thread_count);
+        std::vector<ExecutableCommandList> & scope_command_lists = tl_scope_command_lists;
+        // An execution that threw may have left command lists behind.
+        scope_command_lists.clear();
 
+        // Queue and timeline value of the tasks recorded so far, submits only wait on the ones their tasks depend on.
+        // Main queue tasks carry the value of the async main timeline their submit signals.
+        constexpr usize MAIN_QUEUE = ASYNC_QUEUE_COUNT;
+        struct RecordedTaskAccesses
+        {
+            usize queue = {};
+            u64 value = {};
+            std::vector<ScheduledAccess> accesses = {};
+        };
+        std::vector<RecordedTaskAccesses> recorded_task_accesses = {};
+        u64 const first_main_value = context.async_main_timeline_value + 1;
+        // Highest value of each async timeline the main queue waits on, and the waits the next main submit still has to make.
+        std::array<u64, ASYNC_QUEUE_COUNT> main_waited_values = context.async_queue_timeline_values;
+        std::array<u64, ASYNC_QUEUE_COUNT> main_wait_values = {};
+        // Highest timeline value per queue of the recorded tasks the accesses depend on, MAIN_QUEUE indexes the main queue.
+        auto dependency_values = [&](std::span<ScheduledAccess const> accesses) -> std::array<u64, ASYNC_QUEUE_COUNT + 1>
+        {
+            // Transient resources alias each other and the transients of earlier executions, any of their writes is a dependency.
+            auto is_transient = [&](ScheduledAccess const & access) -> bool
+            {
+                return access.is_image ? !impl.global_image_infos[access.index].is_persistent() : !impl.global_buffer_infos[access.index].is_persistent();
+            };
+            std::array<u64, ASYNC_QUEUE_COUNT + 1> values = {};
+            for (auto const & access : accesses)
+            {
+                bool const synchronized_on_main = is_transient(access) || (access.is_image ? persistent_synch_images[access.index] : persistent_synch_buffers[access.index]);
+                if (synchronized_on_main)
+                {
+                    values[MAIN_QUEUE] = std::max(values[MAIN_QUEUE], first_main_value);
+                }
+            }
+            for (auto const & recorded : recorded_task_accesses)
+            {
+                for (auto const & recorded_access : recorded.accesses)
+                {
+                    for (auto const & access : accesses)
+                    {
+                        bool const aliased =
+                            is_transient(recorded_access) && is_transient(access) &&
+                            !(recorded_access.access.type == AccessTypeFlagBits::READ && access.access.type == AccessTypeFlagBits::READ);
+                        if (aliased || accesses_conflict(recorded_access, access))
+                        {
+                            values[recorded.queue] = std::max(values[recorded.queue], recorded.value);
+                        }
+                    }
+                }
+            }
+            return values;
+        };
+        // The waits of a scope belong to its first main queue submit.
+        std::optional<usize> scope_first_main_submit = {};
+        bool main_submit_recorded = false;
+        // Ends the main queue submit at the current point of the recording, so offloaded tasks and later submits can wait on it.
+        auto cut_main_submit = [&]()
+        {
+            if (!scope_first_main_submit.has_value())
+            {
+                scope_first_main_submit = pending_submit_count;
+            }
+            PendingTaskGraphSubmit & main_submit = push_pending_submit();
+            main_submit.commands.insert(main_submit.commands.end(), std::make_move_iterator(scope_command_lists.begin()), std::make_move_iterator(scope_command_lists.end()));
+            scope_command_lists.clear();
+            main_submit.commands.push_back(recorder.complete_current_commands());
+            for (usize queue_index = 0; queue_index < ASYNC_QUEUE_COUNT; ++queue_index)
+            {
+                if (main_wait_values[queue_index] != 0)
+                {
+                    main_submit.wait_timeline_semaphores.emplace_back(context.async_queue_timelines[queue_index].value(), main_wait_values[queue_index]);
+                }
+            }
+            main_wait_values = {};
+            main_submit.signal_timeline_semaphores.emplace_back(context.async_main_timeline.value(), ++context.async_main_timeline_value);
+            main_submit_recorded = false;
+        };
         usize submit_scope_index = 0;
         for (auto & submit_scope : permutation.batch_submit_scopes)
         {
@@ -2931,150 +4835,254 @@ namespace daxa
             {
                 impl_runtime.recorder.begin_label({
                     .label_color = impl.info.task_graph_label_color,
-                    .name = impl.info.name + std::string(", submit ") + std::to_string(submit_scope_index),
+                    .name = submit_scope.label,
                 });
             }
-            usize batch_index = 0;
-            for (auto & task_batch : submit_scope.task_batches)
+            scope_first_main_submit = {};
+            if (uses_async_queues && &submit_scope != &permutation.batch_submit_scopes.back())
             {
-                batch_index += 1;
-                // Wait on pipeline barriers before batch execution.
-                for (auto barrier_index : task_batch.pipeline_barrier_indices)
-                {
-                    TaskBarrier & barrier = permutation.barriers[barrier_index];
-                    insert_pipeline_barrier(impl, permutation, impl_runtime.recorder, barrier);
-                }
-                // Wait on split barriers before batch execution.
-                if (!impl.info.use_split_barriers)
+                for (auto & task_batch : submit_scope.task_batches)
                 {
-                    for (auto barrier_index : task_batch.wait_split_barrier_indices)
+                    std::vector<std::vector<ScheduledAccess>> task_accesses = {};
+                    std::vector<usize> task_queues = {};
+                    for (TaskId const task_id : task_batch.tasks)
                     {
-                        TaskSplitBarrier const & split_barrier = permutation.split_barriers[barrier_index];
-                        // Convert split barrier to normal barrier.
-                        TaskBarrier barrier = split_barrier;
-                        insert_pipeline_barrier(impl, permutation, impl_runtime.recorder, barrier);
+                        task_accesses.push_back(scheduled_accesses(*impl.tasks[task_id].base_task));
+                        task_queues.push_back(async_queue_index(impl.tasks[task_id]).value_or(MAIN_QUEUE));
                     }
-                }
-                else
-                {
-                    usize needed_image_barriers = 0;
-                    for (auto barrier_index : task_batch.wait_split_barrier_indices)
+
+                    // Main queue tasks wait on the offloaded tasks they depend on.
+                    // The work recorded before them goes into its own submit, so it does not wait as well.
+                    std::array<u64, ASYNC_QUEUE_COUNT> batch_main_waits = {};
+                    for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
                     {
-                        TaskSplitBarrier const & split_barrier = permutation.split_barriers[barrier_index];
-                        if (!split_barrier.image_id.is_empty())
+                        if (task_queues[task_index] != MAIN_QUEUE)
+                        {
+                            continue;
+                        }
+                        auto const dependencies = dependency_values(task_accesses[task_index]);
+                        for (usize queue_index = 0; queue_index < ASYNC_QUEUE_COUNT; ++queue_index)
                         {
-                            needed_image_barriers += impl.get_actual_images(split_barrier.image_id, permutation).size();
+                            batch_main_waits[queue_index] = std::max(batch_main_waits[queue_index], dependencies[queue_index]);
                         }
                     }
-                    tl_split_barrier_wait_infos.reserve(task_batch.wait_split_barrier_indices.size());
-                    tl_memory_barrier_infos.reserve(task_batch.wait_split_barrier_indices.size());
-                    tl_image_barrier_infos.reserve(needed_image_barriers);
-                    for (auto barrier_index : task_batch.wait_split_barrier_indices)
+                    bool batch_main_waits_on_async = false;
+                    for (usize queue_index = 0; queue_index < ASYNC_QUEUE_COUNT; ++queue_index)
                     {
-                        TaskSplitBarrier & split_barrier = permutation.split_barriers[barrier_index];
-                        if (split_barrier.image_id.is_empty())
+                        batch_main_waits_on_async = batch_main_waits_on_async || batch_main_waits[queue_index] > main_waited_values[queue_index];
+                    }
+                    if (batch_main_waits_on_async)
+                    {
+                        if (main_submit_recorded)
                         {
-                            tl_memory_barrier_infos.push_back(MemoryBarrierInfo{
-                                .src_access = split_barrier.src_access,
-                                .dst_access = split_barrier.dst_access,
-                            });
-                            tl_split_barrier_wait_infos.push_back(EventWaitInfo{
-                                .memory_barriers = std::span{&tl_memory_barrier_infos.back(), 1},
-                                .event = split_barrier.split_barrier_state,
-                            });
+                            cut_main_submit();
                         }
-                        else
+                        for (usize queue_index = 0; queue_index < ASYNC_QUEUE_COUNT; ++queue_index)
                         {
-                            usize const img_bar_vec_start_size = tl_image_barrier_infos.size();
-                            for (auto image : impl.get_actual_images(split_barrier.image_id, permutation))
+                            if (batch_main_waits[queue_index] > main_waited_values[queue_index])
                             {
-                                tl_image_barrier_infos.push_back(ImageMemoryBarrierInfo{
-                                    .src_access = split_barrier.src_access,
-                                    .dst_access = split_barrier.dst_access,
-                                    .src_layout = split_barrier.layout_before,
-                                    .dst_layout = split_barrier.layout_after,
-                                    .image_slice = split_barrier.slice,
-                                    .image_id = image,
-                                });
+                                main_wait_values[queue_index] = batch_main_waits[queue_index];
+                                main_waited_values[queue_index] = batch_main_waits[queue_index];
                             }
-                            usize const img_bar_vec_end_size = tl_image_barrier_infos.size();
-                            usize const img_bar_count = img_bar_vec_end_size - img_bar_vec_start_size;
-                            tl_split_barrier_wait_infos.push_back(EventWaitInfo{
-                                .image_barriers = std::span{tl_image_barrier_infos.data() + img_bar_vec_start_size, img_bar_count},
-                                .event = split_barrier.split_barrier_state,
+                        }
+                    }
+
+                    u64 const main_value = context.async_main_timeline_value + 1;
+                    write_profiling_timestamp(impl_runtime, PipelineStageFlagBits::TOP_OF_PIPE, task_batch.profiling_query_index);
+                    record_batch_waits(impl_runtime, task_batch);
+                    // Layout transitions are recorded on the main queue, offloaded tasks using the transitioned images wait for them.
+                    RecordedTaskAccesses transitions = {.queue = MAIN_QUEUE, .value = main_value};
+                    auto add_transition = [&](TaskBarrier const & barrier)
+                    {
+                        if (!barrier.image_id.is_empty() && barrier.layout_before != barrier.layout_after)
+                        {
+                            transitions.accesses.push_back({
+                                .is_image = true,
+                                .index = barrier.image_id.index,
+                                .slice = barrier.slice,
+                                .access = {.stages = barrier.dst_access.stages, .type = AccessTypeFlagBits::WRITE},
+                                .layout = barrier.layout_after,
                             });
                         }
+                    };
+                    for (usize const barrier_index : task_batch.pipeline_barrier_indices)
+                    {
+                        add_transition(permutation.barriers[barrier_index]);
                     }
-                    if (!tl_split_barrier_wait_infos.empty())
+                    for (usize const barrier_index : task_batch.wait_split_barrier_indices)
                     {
-                        impl_runtime.recorder.wait_events(tl_split_barrier_wait_infos);
+                        add_transition(permutation.split_barriers[barrier_index]);
                     }
-                    tl_split_barrier_wait_infos.clear();
-                    tl_image_barrier_infos.clear();
-                    tl_memory_barrier_infos.clear();
-                }
-                // Execute all tasks in the batch.
-                usize task_index = 0;
-                for (TaskId const task_id : task_batch.tasks)
-                {
-                    impl.execute_task(impl_runtime, permutation, batch_index, task_index, task_id);
-                    task_index += 1;
-                }
-                if (impl.info.use_split_barriers)
-                {
-                    // Reset all waited upon split barriers here.
-                    for (auto barrier_index : task_batch.wait_split_barrier_indices)
+                    if (!transitions.accesses.empty())
                     {
-                        // We wait on the stages, that waited on our split barrier earlier.
-                        // This way, we make sure, that the stages that wait on the split barrier
-                        // executed and saw the split barrier signaled, before we reset them.
-                        impl_runtime.recorder.reset_event({
-                            .event = permutation.split_barriers[barrier_index].split_barrier_state,
-                            .stage = permutation.split_barriers[barrier_index].dst_access.stages,
-                        });
+                        recorded_task_accesses.push_back(std::move(transitions));
                     }
-                    // Signal all signal split barriers after batch execution.
-                    for (usize const barrier_index : task_batch.signal_split_barrier_indices)
+                    for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
                     {
-                        TaskSplitBarrier & task_split_barrier = permutation.split_barriers[barrier_index];
-                        if (task_split_barrier.image_id.is_empty())
+                        if (task_queues[task_index] == MAIN_QUEUE)
                         {
-                            MemoryBarrierInfo memory_barrier{
-                                .src_access = task_split_barrier.src_access,
-                                .dst_access = task_split_barrier.dst_access,
-                            };
-                            impl_runtime.recorder.signal_event({
-                                .memory_barriers = std::span{&memory_barrier, 1},
-                                .event = task_split_barrier.split_barrier_state,
-                            });
+                            execute_profiled_task(impl_runtime, task_batch, task_index, true);
+                            recorded_task_accesses.push_back({.queue = MAIN_QUEUE, .value = main_value, .accesses = task_accesses[task_index]});
                         }
-                        else
+                    }
+                    record_batch_signals(impl_runtime, task_batch);
+                    write_profiling_timestamp(impl_runtime, PipelineStageFlagBits::BOTTOM_OF_PIPE, task_batch.profiling_query_index + 1);
+                    main_submit_recorded = true;
+
+                    // Offloaded tasks only wait on the submits of the tasks they depend on, the rest of the main queue work overlaps them.
+                    for (usize queue_index = 0; queue_index < ASYNC_QUEUE_COUNT; ++queue_index)
+                    {
+                        std::array<u64, ASYNC_QUEUE_COUNT + 1> async_waits = {};
+                        bool queue_has_tasks = false;
+                        for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
                         {
-                            for (auto image : impl.get_actual_images(task_split_barrier.image_id, permutation))
+                            if (task_queues[task_index] != queue_index)
                             {
-                                tl_image_barrier_infos.push_back({
-                                    .src_access = task_split_barrier.src_access,
-                                    .dst_access = task_split_barrier.dst_access,
-                                    .src_layout = task_split_barrier.layout_before,
-                                    .dst_layout = task_split_barrier.layout_after,
-                                    .image_slice = task_split_barrier.slice,
-                                    .image_id = image,
-                                });
+                                continue;
+                            }
+                            queue_has_tasks = true;
+                            auto const dependencies = dependency_values(task_accesses[task_index]);
+                            for (usize wait_queue_index = 0; wait_queue_index <= ASYNC_QUEUE_COUNT; ++wait_queue_index)
+                            {
+                                async_waits[wait_queue_index] = std::max(async_waits[wait_queue_index], dependencies[wait_queue_index]);
+                            }
+                        }
+                        if (!queue_has_tasks)
+                        {
+                            continue;
+                        }
+                        // Depending on main queue work that is not submitted yet cuts the main submit after the main queue tasks of this batch.
+                        if (async_waits[MAIN_QUEUE] > context.async_main_timeline_value)
+                        {
+                            cut_main_submit();
+                        }
+                        CommandRecorder async_recorder = impl.info.device.create_command_recorder({.queue_family = async_queues[queue_index]->family});
+                        ImplTaskRuntimeInterface async_runtime{
+                            .task_graph = impl,
+                            .permutation = permutation,
+                            .recorder = async_recorder,
+                            .context = context,
+                            .staging_memory = impl_runtime.staging_memory,
+                        };
+                        for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
+                        {
+                            if (task_queues[task_index] == queue_index)
+                            {
+                                execute_profiled_task(async_runtime, task_batch, task_index, false);
+                            }
+                        }
+                        PendingTaskGraphSubmit & async_submit = push_pending_submit();
+                        async_submit.queue = async_queues[queue_index].value();
+                        async_submit.commands.push_back(async_recorder.complete_current_commands());
+                        if (async_waits[MAIN_QUEUE] != 0)
+                        {
+                            async_submit.wait_timeline_semaphores.emplace_back(context.async_main_timeline.value(), async_waits[MAIN_QUEUE]);
+                        }
+                        // Earlier submits to the same queue are ordered by the queue itself.
+                        for (usize wait_queue_index = 0; wait_queue_index < ASYNC_QUEUE_COUNT; ++wait_queue_index)
+                        {
+                            if (wait_queue_index != queue_index && async_waits[wait_queue_index] != 0)
+                            {
+                                async_submit.wait_timeline_semaphores.emplace_back(context.async_queue_timelines[wait_queue_index].value(), async_waits[wait_queue_index]);
                             }
-                            impl_runtime.recorder.signal_event({
-                                .image_barriers = tl_image_barrier_infos,
-                                .event = task_split_barrier.split_barrier_state,
-                            });
-                            tl_image_barrier_infos.clear();
                         }
+                        async_submit.signal_timeline_semaphores.emplace_back(context.async_queue_timelines[queue_index].value(), ++context.async_queue_timeline_values[queue_index]);
+                        for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
+                        {
+                            if (task_queues[task_index] == queue_index)
+                            {
+                                recorded_task_accesses.push_back({.queue = queue_index, .value = context.async_queue_timeline_values[queue_index], .accesses = task_accesses[task_index]});
+                            }
+                        }
+                    }
+                }
+            }
+            else if (record_thread_count <= 1 || submit_scope.task_batches.size() <= 1)
+            {
+                for (auto & task_batch : submit_scope.task_batches)
+                {
+                    record_batch(impl_runtime, task_batch);
+                }
+            }
+            else
+            {
+                // Contiguous runs of batches with roughly equal task counts are recorded on separate threads.
+                // The barriers recorded for each batch keep their meaning across command lists, as the lists are submitted in batch order.
+                usize scope_task_count = 0;
+                for (auto const & task_batch : submit_scope.task_batches)
+                {
+                    scope_task_count += task_batch.tasks.size();
+                }
+                usize const range_count = std::min<usize>(record_thread_count, submit_scope.task_batches.size());
+                usize const tasks_per_range = (scope_task_count + range_count - 1) / range_count;
+                std::vector<usize> range_ends = {};
+                usize range_task_count = 0;
+                for (usize batch = 0; batch < submit_scope.task_batches.size(); ++batch)
+                {
+                    range_task_count += submit_scope.task_batches[batch].tasks.size();
+                    if (range_task_count >= tasks_per_range && range_ends.size() + 1 < range_count)
+                    {
+                        range_ends.push_back(batch + 1);
+                        range_task_count = 0;
+                    }
+                }
+                range_ends.push_back(submit_scope.task_batches.size());
+
+                scope_command_lists.push_back(recorder.complete_current_commands());
+                std::vector<CommandRecorder> range_recorders = {};
+                std::vector<ImplTaskRuntimeInterface> range_runtimes = {};
+                range_recorders.reserve(range_ends.size());
+                range_runtimes.reserve(range_ends.size());
+                for (usize range = 0; range < range_ends.size(); ++range)
+                {
+                    range_recorders.push_back(impl.info.device.create_command_recorder({.merge_renderpasses = impl.info.merge_renderpasses}));
+                    range_runtimes.push_back(ImplTaskRuntimeInterface{
+                        .task_graph = impl,
+                        .permutation = permutation,
+                        .recorder = range_recorders.back(),
+                        .context = context,
+                        // Without staging memory there are no worker pools and no thread hands out an allocator.
+                        .staging_memory = range == 0 || context.worker_staging_memories.empty() ? impl_runtime.staging_memory : &context.worker_staging_memories.at(range - 1),
+                    });
+                }
+                auto record_range = [&](usize range)
+                {
+                    ImplTaskGraph::recording_context = &context;
+                    for (usize batch = range == 0 ? 0 : range_ends[range - 1]; batch < range_ends[range]; ++batch)
+                    {
+                        record_batch(range_runtimes[range], submit_scope.task_batches[batch]);
                     }
+                };
+                // The calling thread records the first range while the workers record the others.
+                usize pending_range_count = range_ends.size() - 1;
+                for (usize range = 1; range < range_ends.size(); ++range)
+                {
+                    impl.enqueue_record_job(
+                        [&, range]()
+                        {
+                            record_range(range);
+                            // Notified under the lock, the recording thread may return and end the captured locals right after.
+                            std::unique_lock lock{impl.record_worker_mtx};
+                            pending_range_count -= 1;
+                            impl.record_job_done_cv.notify_all();
+                        });
+                }
+                record_range(0);
+                {
+                    std::unique_lock lock{impl.record_worker_mtx};
+                    impl.record_job_done_cv.wait(lock, [&]()
+                                                 { return pending_range_count == 0; });
+                }
+                for (auto & range_recorder : range_recorders)
+                {
+                    scope_command_lists.push_back(range_recorder.complete_current_commands());
                 }
             }
             for (usize const barrier_index : submit_scope.last_minute_barrier_indices)
             {
-                TaskBarrier & barrier = permutation.barriers[barrier_index];
-                insert_pipeline_barrier(impl, permutation, impl_runtime.recorder, barrier);
+                collect_pipeline_barrier(impl, permutation, permutation.barriers[barrier_index]);
             }
+            record_collected_pipeline_barriers(impl_runtime.recorder);
             if (impl.info.enable_command_labels)
             {
                 impl_runtime.recorder.end_label();
@@ -3082,12 +5090,22 @@ namespace daxa
 
             if (&submit_scope != &permutation.batch_submit_scopes.back())
             {
-                PipelineStageFlags const wait_stages = submit_scope.submit_info.wait_stages;
-                std::vector<ExecutableCommandList> commands = {submit_scope.submit_info.command_lists.begin(), submit_scope.submit_info.command_lists.end()};
-                std::vector<BinarySemaphore> wait_binary_semaphores = {submit_scope.submit_info.wait_binary_semaphores.begin(), submit_scope.submit_info.wait_binary_semaphores.end()};
-                std::vector<BinarySemaphore> signal_binary_semaphores = {submit_scope.submit_info.signal_binary_semaphores.begin(), submit_scope.submit_info.signal_binary_semaphores.end()};
-                std::vector<std::pair<TimelineSemaphore, u64>> wait_timeline_semaphores = {submit_scope.submit_info.wait_timeline_semaphores.begin(), submit_scope.submit_info.wait_timeline_semaphores.end()};
-                std::vector<std::pair<TimelineSemaphore, u64>> signal_timeline_semaphores = {submit_scope.submit_info.signal_timeline_semaphores.begin(), submit_scope.submit_info.signal_timeline_semaphores.end()};
+                // Submits are collected and handed to the device in one batch.
+                // The batch is flushed before presenting and after the last submit scope.
+                PendingTaskGraphSubmit & pending_submit = push_pending_submit();
+                pending_submit.wait_stages = submit_scope.submit_info.wait_stages;
+                pending_submit.commands.assign(submit_scope.submit_info.command_lists.begin(), submit_scope.submit_info.command_lists.end());
+                pending_submit.wait_binary_semaphores.assign(submit_scope.submit_info.wait_binary_semaphores.begin(), submit_scope.submit_info.wait_binary_semaphores.end());
+                pending_submit.signal_binary_semaphores.assign(submit_scope.submit_info.signal_binary_semaphores.begin(), submit_scope.submit_info.signal_binary_semaphores.end());
+                pending_submit.wait_timeline_semaphores.assign(submit_scope.submit_info.wait_timeline_semaphores.begin(), submit_scope.submit_info.wait_timeline_semaphores.end());
+                pending_submit.signal_timeline_semaphores.assign(submit_scope.submit_info.signal_timeline_semaphores.begin(), submit_scope.submit_info.signal_timeline_semaphores.end());
+                auto & commands = pending_submit.commands;
+                auto & wait_binary_semaphores = pending_submit.wait_binary_semaphores;
+                auto & signal_binary_semaphores = pending_submit.signal_binary_semaphores;
+                auto & wait_timeline_semaphores = pending_submit.wait_timeline_semaphores;
+                auto & signal_timeline_semaphores = pending_submit.signal_timeline_semaphores;
+                commands.insert(commands.end(), std::make_move_iterator(scope_command_lists.begin()), std::make_move_iterator(scope_command_lists.end()));
+                scope_command_lists.clear();
                 commands.push_back(recorder.complete_current_commands());
                 if (impl.info.swapchain.has_value())
                 {
@@ -3147,21 +5165,52 @@ namespace daxa
                 {
                     signal_timeline_semaphores.insert(signal_timeline_semaphores.end(), submit_scope.user_submit_info.additional_signal_timeline_semaphores->begin(), submit_scope.user_submit_info.additional_signal_timeline_semaphores->end());
                 }
-                signal_timeline_semaphores.emplace_back(impl.staging_memory->timeline_semaphore(), impl.staging_memory->inc_timeline_value());
-                daxa::CommandSubmitInfo const submit_info = {
-                    .wait_stages = wait_stages,
-                    .command_lists = commands,
-                    .wait_binary_semaphores = wait_binary_semaphores,
-                    .signal_binary_semaphores = signal_binary_semaphores,
-                    .wait_timeline_semaphores = wait_timeline_semaphores,
-                    .signal_timeline_semaphores = signal_timeline_semaphores,
-                };
-                impl.info.device.submit_commands(submit_info);
+                if (context.staging_memory.has_value())
+                {
+                    signal_timeline_semaphores.emplace_back(context.staging_memory->timeline_semaphore(), context.staging_memory->inc_timeline_value());
+                }
+                for (auto & worker_staging_memory : context.worker_staging_memories)
+                {
+                    signal_timeline_semaphores.emplace_back(worker_staging_memory.timeline_semaphore(), worker_staging_memory.inc_timeline_value());
+                }
+
+                if (uses_async_queues)
+                {
+                    if (scope_first_main_submit.has_value())
+                    {
+                        // The scope was split around offloaded tasks, its waits belong to the first submit.
+                        PendingTaskGraphSubmit & first_submit = tl_pending_submits[scope_first_main_submit.value()];
+                        first_submit.wait_stages = pending_submit.wait_stages;
+                        pending_submit.wait_stages = {};
+                        first_submit.wait_binary_semaphores.insert(first_submit.wait_binary_semaphores.end(), wait_binary_semaphores.begin(), wait_binary_semaphores.end());
+                        first_submit.wait_timeline_semaphores.insert(first_submit.wait_timeline_semaphores.end(), wait_timeline_semaphores.begin(), wait_timeline_semaphores.end());
+                        wait_binary_semaphores.clear();
+                        wait_timeline_semaphores.clear();
+                    }
+                    // The last submit carries the signals of the scope, so it also waits on the offloaded tasks nothing depended on.
+                    for (usize queue_index = 0; queue_index < ASYNC_QUEUE_COUNT; ++queue_index)
+                    {
+                        if (context.async_queue_timeline_values[queue_index] > main_waited_values[queue_index])
+                        {
+                            main_wait_values[queue_index] = context.async_queue_timeline_values[queue_index];
+                            main_waited_values[queue_index] = context.async_queue_timeline_values[queue_index];
+                        }
+                        if (main_wait_values[queue_index] != 0)
+                        {
+                            wait_timeline_semaphores.emplace_back(context.async_queue_timelines[queue_index].value(), main_wait_values[queue_index]);
+                        }
+                    }
+                    main_wait_values = {};
+                    signal_timeline_semaphores.emplace_back(context.async_main_timeline.value(), ++context.async_main_timeline_value);
+                    main_submit_recorded = false;
+                }
 
                 if (submit_scope.present_info.has_value())
                 {
+                    flush_pending_submits();
                     ImplPresentInfo & impl_present_info = submit_scope.present_info.value();
-                    std::vector<BinarySemaphore> present_wait_semaphores = impl_present_info.binary_semaphores;
+                    std::vector<BinarySemaphore> & present_wait_semaphores = tl_present_wait_semaphores;
+                    present_wait_semaphores.assign(impl_present_info.binary_semaphores.begin(), impl_present_info.binary_semaphores.end());
                     DAXA_DBG_ASSERT_TRUE_M(impl.info.swapchain.has_value(), "must have swapchain registered in info on creation in order to use present.");
                     present_wait_semaphores.push_back(impl.info.swapchain.value().current_present_semaphore());
                     if (impl_present_info.additional_binary_semaphores != nullptr)
@@ -3175,109 +5224,161 @@ namespace daxa
                         .wait_binary_semaphores = present_wait_semaphores,
                         .swapchain = impl.info.swapchain.value(),
                     });
+                    present_wait_semaphores.clear();
                 }
             }
             ++submit_scope_index;
         }
+        flush_pending_submits();
+        ImplTaskGraph::recording_context = nullptr;
 
-        // Insert pervious uses into execution info for tje next executions synch.
-        for (usize task_buffer_index = 0; task_buffer_index < permutation.buffer_infos.size(); ++task_buffer_index)
+        // TODO: reimplement left over commands
+        // context.left_over_command_lists = std::move(impl_runtime.recorder.complete_current_commands());
         {
-            bool const is_persistent = daxa::holds_alternative<PermIndepTaskBufferInfo::Persistent>(impl.global_buffer_infos[task_buffer_index].task_buffer_data);
-            if (permutation.buffer_infos[task_buffer_index].valid && is_persistent)
+            std::unique_lock const lock{impl.execution_mtx};
+            impl.executed_once = true;
+            impl.prev_frame_permutation_index = permutation_index;
+            if (impl.info.record_debug_information)
+            {
+                impl.debug_print();
+            }
+            context.permutation = nullptr;
+            context.in_use = false;
+            impl.ended_execution_count = execution_index + 1;
+            if (profiling_frame != nullptr)
             {
-                daxa::get<PermIndepTaskBufferInfo::Persistent>(impl.global_buffer_infos[task_buffer_index].task_buffer_data).get().latest_access = permutation.buffer_infos[task_buffer_index].latest_access;
+                profiling_frame->submit_index = profiling_submit_index;
             }
         }
-        for (usize task_image_index = 0; task_image_index < permutation.image_infos.size(); ++task_image_index)
+        impl.execution_cv.notify_all();
+    }
+
+    ImplTaskGraph::ImplTaskGraph(TaskGraphInfo a_info)
+        : unique_index{ImplTaskGraph::exec_unique_next_index++}, info{std::move(a_info)}
+    {
+        DAXA_DBG_ASSERT_TRUE_M(
+            !info.enable_gpu_profiling || info.execution_context_count <= GPU_PROFILING_FRAME_COUNT,
+            "gpu profiling keeps the queries of at most GPU_PROFILING_FRAME_COUNT executions, more execution contexts could overwrite recording ones");
+        this->execution_contexts.resize(std::max(1u, info.execution_context_count));
+        for (u32 context_index = 0; context_index < this->execution_contexts.size(); ++context_index)
         {
-            if (
-                permutation.image_infos[task_image_index].valid &&
-                impl.global_image_infos[task_image_index].is_persistent())
+            auto & context = this->execution_contexts[context_index];
+            context.task_graph = this;
+            // Names of the first context stay the same as without execution contexts.
+            std::string const context_suffix = context_index == 0 ? std::string{} : " context " + std::to_string(context_index);
+            if (a_info.staging_memory_pool_size != 0)
             {
-                auto & persistent_image = impl.global_image_infos[task_image_index].get_persistent();
-                for (auto const & extended_state : permutation.image_infos[task_image_index].last_slice_states)
+                context.staging_memory = TransferMemoryPool{TransferMemoryPoolInfo{.device = info.device, .capacity = info.staging_memory_pool_size, .use_bar_memory = true, .name = "Transfer Memory Pool" + context_suffix}};
+                // The pools are not thread safe, every additional recording thread gets its own.
+                for (u32 thread = 1; thread < info.record_thread_count; ++thread)
                 {
-                    persistent_image.latest_slice_states.push_back(extended_state.state);
+                    context.worker_staging_memories.push_back(TransferMemoryPool{TransferMemoryPoolInfo{
+                        .device = info.device,
+                        .capacity = info.staging_memory_pool_size,
+                        .use_bar_memory = true,
+                        .name = "Transfer Memory Pool " + std::to_string(thread) + context_suffix,
+                    }});
                 }
             }
+            if (info.async_compute_queue.has_value() || info.async_transfer_queue.has_value() || info.async_video_decode_queue.has_value() || info.async_video_encode_queue.has_value())
+            {
+                context.async_main_timeline = info.device.create_timeline_semaphore({.name = info.name + " async main timeline" + context_suffix});
+            }
+            if (info.async_compute_queue.has_value())
+            {
+                context.async_queue_timelines[ASYNC_QUEUE_COMPUTE] = info.device.create_timeline_semaphore({.name = info.name + " async compute timeline" + context_suffix});
+            }
+            if (info.async_transfer_queue.has_value())
+            {
+                context.async_queue_timelines[ASYNC_QUEUE_TRANSFER] = info.device.create_timeline_semaphore({.name = info.name + " async transfer timeline" + context_suffix});
+            }
+            if (info.async_video_decode_queue.has_value())
+            {
+                context.async_queue_timelines[ASYNC_QUEUE_VIDEO_DECODE] = info.device.create_timeline_semaphore({.name = info.name + " async video decode timeline" + context_suffix});
+            }
+            if (info.async_video_encode_queue.has_value())
+            {
+                context.async_queue_timelines[ASYNC_QUEUE_VIDEO_ENCODE] = info.device.create_timeline_semaphore({.name = info.name + " async video encode timeline" + context_suffix});
+            }
         }
+    }
 
-        // TODO: reimplement left over commands
-        // impl.left_over_command_lists = std::move(impl_runtime.recorder.complete_current_commands());
-        impl.executed_once = true;
-        impl.prev_frame_permutation_index = permutation_index;
+    void ImplTaskGraph::enqueue_record_job(std::function<void()> job)
+    {
+        {
+            std::unique_lock lock{this->record_worker_mtx};
+            if (this->record_worker_threads.empty())
+            {
+                // The calling thread records one range itself.
+                for (u32 thread = 1; thread < info.record_thread_count; ++thread)
+                {
+                    this->record_worker_threads.emplace_back([this]()
+                                                             { this->record_worker_loop(); });
+                }
+            }
+            this->record_jobs.push_back(std::move(job));
+        }
+        this->record_worker_cv.notify_one();
+    }
 
-        if (impl.info.record_debug_information)
+    void ImplTaskGraph::record_worker_loop()
+    {
+        while (true)
         {
-            impl.debug_print();
+            std::function<void()> job = {};
+            {
+                std::unique_lock lock{this->record_worker_mtx};
+                this->record_worker_cv.wait(lock, [&]()
+                                            { return this->record_worker_stop || !this->record_jobs.empty(); });
+                if (this->record_worker_stop)
+                {
+                    return;
+                }
+                job = std::move(this->record_jobs.front());
+                this->record_jobs.pop_front();
+            }
+            job();
         }
     }
 
-    ImplTaskGraph::ImplTaskGraph(TaskGraphInfo a_info)
-        : unique_index{ImplTaskGraph::exec_unique_next_index++}, info{std::move(a_info)}
+    void ImplTaskGraph::stop_record_workers()
     {
-        if (a_info.staging_memory_pool_size != 0)
+        // Executions wait for their record jobs, so no jobs are left when the graph is destroyed.
+        {
+            std::unique_lock lock{this->record_worker_mtx};
+            this->record_worker_stop = true;
+        }
+        this->record_worker_cv.notify_all();
+        for (auto & thread : this->record_worker_threads)
         {
-            this->staging_memory = TransferMemoryPool{TransferMemoryPoolInfo{.device = info.device, .capacity = info.staging_memory_pool_size, .use_bar_memory = true, .name = "Transfer Memory Pool"}};
+            thread.join();
         }
+        this->record_worker_threads.clear();
     }
 
     ImplTaskGraph::~ImplTaskGraph()
     {
-        for (auto & task : tasks)
+        stop_record_workers();
+        // Every non default view of the tasks is owned by the view cache.
+        for (auto & [key, cached] : image_views)
         {
-            for (auto & view_cache : task.image_view_cache)
+            if (info.device.is_id_valid(cached.view))
             {
-                for (auto & view : view_cache)
-                {
-                    if (info.device.is_id_valid(view))
-                    {
-                        ImageId const parent = info.device.image_view_info(view).value().image;
-                        bool const is_default_view = parent.default_view() == view;
-                        if (!is_default_view)
-                        {
-                            info.device.destroy_image_view(view);
-                        }
-                    }
-                }
+                info.device.destroy_image_view(cached.view);
             }
         }
-        for (auto & permutation : permutations)
+        // With a shared heap, a graph that never executed never created its transient resources.
+        if (transient_resources_created)
         {
-            // because transient buffers are owned by the task graph, we need to destroy them
-            for (u32 buffer_info_idx = 0; buffer_info_idx < static_cast<u32>(global_buffer_infos.size()); buffer_info_idx++)
-            {
-                auto const & global_buffer = global_buffer_infos.at(buffer_info_idx);
-                PerPermTaskBuffer const & perm_buffer = permutation.buffer_infos.at(buffer_info_idx);
-                if (!global_buffer.is_persistent() && 
-                    perm_buffer.valid)
-                {
-                    if (auto const * id = std::get_if<BufferId>(&perm_buffer.actual_id))
-                    {
-                        info.device.destroy_buffer(*id);
-                    }
-                    if (auto const * id = std::get_if<BlasId>(&perm_buffer.actual_id))
-                    {
-                        info.device.destroy_blas(*id);
-                    }
-                    if (auto const * id = std::get_if<TlasId>(&perm_buffer.actual_id))
-                    {
-                        info.device.destroy_tlas(*id);
-                    }
-                }
-            }
-            // because transient images are owned by the task graph, we need to destroy them
-            for (u32 image_info_idx = 0; image_info_idx < static_cast<u32>(global_image_infos.size()); image_info_idx++)
+            for (auto & permutation : permutations)
             {
-                auto const & global_image = global_image_infos.at(image_info_idx);
-                auto const & perm_image = permutation.image_infos.at(image_info_idx);
-                if (!global_image.is_persistent() && perm_image.valid)
-                {
-                    info.device.destroy_image(get_actual_images(TaskImageView{{.task_graph_index = unique_index, .index = image_info_idx}}, permutation)[0]);
-                }
+                destroy_transient_runtime_resources(permutation);
             }
         }
+        for (auto & [permutation_index, permutation] : jit_permutations)
+        {
+            destroy_transient_runtime_resources(permutation);
+        }
     }
 
     void ImplTaskGraph::print_task_image_to(std::string & out, std::string indent, TaskGraphPermutation const & permutation, TaskImageView local_id)
@@ -3454,9 +5555,10 @@ namespace daxa
                                   perm_task_image.lifetime.last_use.task_batch_index;
             fmt::format_to(std::back_inserter(out), "{}", indent);
             print_lifetime(start_idx, end_idx);
-            fmt::format_to(std::back_inserter(out), "  allocation offset: {} allocation size: {} task resource name: {}\n",
+            fmt::format_to(std::back_inserter(out), "  heap: {} allocation offset: {} allocation size: {} task resource name: {}\n",
+                           perm_task_image.heap_index,
                            perm_task_image.allocation_offset,
-                           0, // TODO(msakmary)
+                           perm_task_image.memory_requirements.size,
                            global_image_infos.at(perm_image_idx).get_name());
         }
         for (u32 perm_buffer_idx = 0; perm_buffer_idx < permutation.buffer_infos.size(); perm_buffer_idx++)
@@ -3473,13 +5575,266 @@ namespace daxa
                                   perm_task_buffer.lifetime.last_use.task_batch_index;
             fmt::format_to(std::back_inserter(out), "{}", indent);
             print_lifetime(start_idx, end_idx);
-            fmt::format_to(std::back_inserter(out), "  allocation offset: {} allocation size: {} task resource name: {}\n",
+            fmt::format_to(std::back_inserter(out), "  heap: {} allocation offset: {} allocation size: {} task resource name: {}\n",
+                           perm_task_buffer.heap_index,
                            perm_task_buffer.allocation_offset,
-                           0, // TODO(msakmary)
+                           perm_task_buffer.memory_requirements.size,
                            global_buffer_infos.at(perm_buffer_idx).get_name());
         }
     }
 
+    auto trace_json_escaped(std::string_view str) -> std::string
+    {
+        std::string ret = {};
+        ret.reserve(str.size());
+        for (char const c : str)
+        {
+            switch (c)
+            {
+            case '"': ret.append("\\\""); break;
+            case '\\': ret.append("\\\\"); break;
+            case '\n': ret.append("\\n"); break;
+            case '\t': ret.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    fmt::format_to(std::back_inserter(ret), "\\u{:04x}", static_cast<u32>(c));
+                }
+                else
+                {
+                    ret.push_back(c);
+                }
+            }
+        }
+        return ret;
+    }
+
+    // Chrome trace event format, timestamps are in microseconds.
+    // Process 0 holds the schedule: submit scopes, batches, barriers and one track per task slot of a batch.
+    // Process 1 holds one track per transient resource, spanning the batches of its lifetime.
+    void ImplTaskGraph::print_execution_trace_to(std::string & out, TaskGraphPermutation const & permutation)
+    {
+        constexpr u32 SCHEDULE_PID = 0;
+        constexpr u32 TRANSIENT_PID = 1;
+        constexpr u32 RECORDING_PID = 2;
+        constexpr u32 SUBMIT_TID = 0;
+        constexpr u32 BATCH_TID = 1;
+        constexpr u32 BARRIER_TID = 2;
+        constexpr u32 FIRST_TASK_TID = 3;
+
+        usize batch_count = 0;
+        std::vector<usize> submit_batch_offsets(permutation.batch_submit_scopes.size());
+        for (usize submit_scope_index = 0; submit_scope_index < permutation.batch_submit_scopes.size(); ++submit_scope_index)
+        {
+            submit_batch_offsets[submit_scope_index] = batch_count;
+            batch_count += permutation.batch_submit_scopes[submit_scope_index].task_batches.size();
+        }
+        bool const gpu_timed =
+            info.enable_gpu_profiling &&
+            gpu_timings.execution_index != 0 &&
+            gpu_timings.permutation_index == chosen_permutation_last_execution &&
+            gpu_timings.batches.size() == batch_count &&
+            gpu_timings.tasks.size() == permutation.profiling_task_count;
+        // With calibrated timestamps the trace starts at the earliest cpu recording, gpu times are shifted behind it.
+        bool const host_timed = gpu_timed && gpu_timings.host_begin_ns != 0;
+        u64 host_origin_ns = gpu_timings.host_begin_ns;
+        if (host_timed)
+        {
+            for (TaskGpuTiming const & timing : gpu_timings.tasks)
+            {
+                host_origin_ns = std::min(host_origin_ns, timing.record_begin_host_ns);
+            }
+        }
+        f64 const gpu_offset_us = host_timed ? static_cast<f64>(gpu_timings.host_begin_ns - host_origin_ns) / 1000.0 : 0.0;
+        auto batch_begin_us = [&](usize flat_batch_index) -> f64
+        {
+            return gpu_timed ? gpu_offset_us + static_cast<f64>(gpu_timings.batches[flat_batch_index].begin_ns) / 1000.0 : static_cast<f64>(flat_batch_index);
+        };
+        auto batch_duration_us = [&](usize flat_batch_index) -> f64
+        {
+            return gpu_timed ? static_cast<f64>(gpu_timings.batches[flat_batch_index].duration_ns) / 1000.0 : 1.0;
+        };
+
+        bool first_event = true;
+        auto begin_event = [&]() -> std::string &
+        {
+            out.append(first_event ? "\n" : ",\n");
+            first_event = false;
+            return out;
+        };
+        auto barrier_args = [&](TaskBarrier const & barrier) -> std::string
+        {
+            std::string args = fmt::format(R"("src_access":"{}","dst_access":"{}")", to_string(barrier.src_access), to_string(barrier.dst_access));
+            if (!barrier.image_id.is_empty())
+            {
+                fmt::format_to(std::back_inserter(args), R"(,"image":"{}","slice":"{}","layout_before":"{}","layout_after":"{}")",
+                               trace_json_escaped(global_image_infos[barrier.image_id.index].get_name()),
+                               to_string(barrier.slice),
+                               to_string(barrier.layout_before),
+                               to_string(barrier.layout_after));
+            }
+            return args;
+        };
+        auto print_barrier = [&](std::string_view name, TaskBarrier const & barrier, f64 ts)
+        {
+            fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"{}","ph":"i","s":"t","ts":{:.3f},"pid":{},"tid":{},"args":{{{}}}}})",
+                           name, ts, SCHEDULE_PID, BARRIER_TID, barrier_args(barrier));
+        };
+        auto print_thread_name = [&](u32 pid, u32 tid, std::string_view name, usize sort_index)
+        {
+            fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},"args":{{"name":"{}"}}}})", pid, tid, trace_json_escaped(name));
+            fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"thread_sort_index","ph":"M","pid":{},"tid":{},"args":{{"sort_index":{}}}}})", pid, tid, sort_index);
+        };
+
+        out.append(R"({"displayTimeUnit":"ns","traceEvents":[)");
+        fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":"{}"}}}})", SCHEDULE_PID, trace_json_escaped(info.name));
+        fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":"{} transient memory"}}}})", TRANSIENT_PID, trace_json_escaped(info.name));
+        print_thread_name(SCHEDULE_PID, SUBMIT_TID, "submit scopes", SUBMIT_TID);
+        print_thread_name(SCHEDULE_PID, BATCH_TID, "batches", BATCH_TID);
+        print_thread_name(SCHEDULE_PID, BARRIER_TID, "barriers", BARRIER_TID);
+        usize max_batch_task_count = 0;
+        for (auto const & submit_scope : permutation.batch_submit_scopes)
+        {
+            for (auto const & task_batch : submit_scope.task_batches)
+            {
+                max_batch_task_count = std::max(max_batch_task_count, task_batch.tasks.size());
+            }
+        }
+        for (usize task_slot = 0; task_slot < max_batch_task_count; ++task_slot)
+        {
+            print_thread_name(SCHEDULE_PID, FIRST_TASK_TID + static_cast<u32>(task_slot), fmt::format("tasks {}", task_slot), FIRST_TASK_TID + task_slot);
+        }
+        if (host_timed)
+        {
+            fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"process_name","ph":"M","pid":{},"args":{{"name":"{} cpu recording"}}}})", RECORDING_PID, trace_json_escaped(info.name));
+            for (usize task_slot = 0; task_slot < max_batch_task_count; ++task_slot)
+            {
+                print_thread_name(RECORDING_PID, static_cast<u32>(task_slot), fmt::format("tasks {}", task_slot), task_slot);
+            }
+        }
+
+        for (usize submit_scope_index = 0; submit_scope_index < permutation.batch_submit_scopes.size(); ++submit_scope_index)
+        {
+            auto const & submit_scope = permutation.batch_submit_scopes[submit_scope_index];
+            f64 scope_begin = std::numeric_limits<f64>::max();
+            f64 scope_end = 0.0;
+            for (usize batch_index = 0; batch_index < submit_scope.task_batches.size(); ++batch_index)
+            {
+                auto const & task_batch = submit_scope.task_batches[batch_index];
+                usize const flat_batch_index = submit_batch_offsets[submit_scope_index] + batch_index;
+                f64 const begin = batch_begin_us(flat_batch_index);
+                f64 const duration = batch_duration_us(flat_batch_index);
+                scope_begin = std::min(scope_begin, begin);
+                scope_end = std::max(scope_end, begin + duration);
+                fmt::format_to(std::back_inserter(begin_event()),
+                               R"({{"name":"batch {}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{},"args":{{"submit_scope":{},"tasks":{},"pipeline_barriers":{},"split_barrier_waits":{},"split_barrier_signals":{}}}}})",
+                               batch_index, begin, duration, SCHEDULE_PID, BATCH_TID, submit_scope_index, task_batch.tasks.size(),
+                               task_batch.pipeline_barrier_indices.size(), task_batch.wait_split_barrier_indices.size(), task_batch.signal_split_barrier_indices.size());
+                for (usize const barrier_index : task_batch.pipeline_barrier_indices)
+                {
+                    print_barrier("pipeline barrier", permutation.barriers[barrier_index], begin);
+                }
+                for (usize const barrier_index : task_batch.wait_split_barrier_indices)
+                {
+                    print_barrier(info.use_split_barriers ? "split barrier wait" : "pipeline barrier (converted from split barrier)", permutation.split_barriers[barrier_index], begin);
+                    if (info.use_split_barriers)
+                    {
+                        fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"split barrier","cat":"split barrier","ph":"f","bp":"e","id":{},"ts":{:.3f},"pid":{},"tid":{}}})",
+                                       barrier_index, begin, SCHEDULE_PID, BATCH_TID);
+                    }
+                }
+                if (info.use_split_barriers)
+                {
+                    for (usize const barrier_index : task_batch.signal_split_barrier_indices)
+                    {
+                        print_barrier("split barrier signal", permutation.split_barriers[barrier_index], begin + duration);
+                        fmt::format_to(std::back_inserter(begin_event()), R"({{"name":"split barrier","cat":"split barrier","ph":"s","id":{},"ts":{:.3f},"pid":{},"tid":{}}})",
+                                       barrier_index, begin, SCHEDULE_PID, BATCH_TID);
+                    }
+                }
+                for (usize task_index = 0; task_index < task_batch.tasks.size(); ++task_index)
+                {
+                    ImplTask const & task = tasks[task_batch.tasks[task_index]];
+                    f64 task_begin = begin;
+                    f64 task_duration = duration;
+                    if (gpu_timed)
+                    {
+                        TaskGpuTiming const & timing = gpu_timings.tasks[task_batch.profiling_task_index + task_index];
+                        task_begin = gpu_offset_us + static_cast<f64>(timing.begin_ns) / 1000.0;
+                        task_duration = static_cast<f64>(timing.duration_ns) / 1000.0;
+                        if (host_timed)
+                        {
+                            fmt::format_to(std::back_inserter(begin_event()),
+                                           R"({{"name":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{},"args":{{"task_id":{},"submit_scope":{},"batch":{}}}}})",
+                                           trace_json_escaped(task.base_task->name()), static_cast<f64>(timing.record_begin_host_ns - host_origin_ns) / 1000.0,
+                                           static_cast<f64>(timing.record_duration_ns) / 1000.0, RECORDING_PID, static_cast<u32>(task_index),
+                                           task_batch.tasks[task_index], submit_scope_index, batch_index);
+                        }
+                    }
+                    fmt::format_to(std::back_inserter(begin_event()),
+                                   R"({{"name":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{},"args":{{"task_id":{},"submit_scope":{},"batch":{},"enabled":{}}}}})",
+                                   trace_json_escaped(task.base_task->name()), task_begin, task_duration, SCHEDULE_PID, FIRST_TASK_TID + static_cast<u32>(task_index),
+                                   task_batch.tasks[task_index], submit_scope_index, batch_index, task.enabled);
+                }
+            }
+            if (submit_scope.task_batches.empty())
+            {
+                scope_begin = 0.0;
+            }
+            for (usize const barrier_index : submit_scope.last_minute_barrier_indices)
+            {
+                print_barrier("last minute pipeline barrier", permutation.barriers[barrier_index], scope_end);
+            }
+            bool const submits = &submit_scope != &permutation.batch_submit_scopes.back();
+            fmt::format_to(std::back_inserter(begin_event()),
+                           R"({{"name":"submit scope {}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{},"args":{{"submits":{},"presents":{}}}}})",
+                           submit_scope_index, scope_begin, scope_end - scope_begin, SCHEDULE_PID, SUBMIT_TID, submits, submit_scope.present_info.has_value());
+        }
+
+        // Tracks are sorted by heap and offset, so aliasing resources end up next to each other.
+        struct TransientTrace
+        {
+            std::string_view name = {};
+            u32 heap_index = {};
+            usize offset = {};
+            usize size = {};
+            ResourceLifetime lifetime = {};
+        };
+        std::vector<TransientTrace> transients = {};
+        for (u32 perm_image_idx = 0; perm_image_idx < permutation.image_infos.size(); perm_image_idx++)
+        {
+            auto const & perm_task_image = permutation.image_infos[perm_image_idx];
+            if (!global_image_infos[perm_image_idx].is_persistent() && perm_task_image.valid)
+            {
+                transients.push_back({global_image_infos[perm_image_idx].get_name(), perm_task_image.heap_index, perm_task_image.allocation_offset, perm_task_image.memory_requirements.size, perm_task_image.lifetime});
+            }
+        }
+        for (u32 perm_buffer_idx = 0; perm_buffer_idx < permutation.buffer_infos.size(); perm_buffer_idx++)
+        {
+            auto const & perm_task_buffer = permutation.buffer_infos[perm_buffer_idx];
+            if (!global_buffer_infos[perm_buffer_idx].is_persistent() && perm_task_buffer.valid)
+            {
+                transients.push_back({global_buffer_infos[perm_buffer_idx].get_name(), perm_task_buffer.heap_index, perm_task_buffer.allocation_offset, perm_task_buffer.memory_requirements.size, perm_task_buffer.lifetime});
+            }
+        }
+        std::sort(transients.begin(), transients.end(), [](TransientTrace const & a, TransientTrace const & b)
+                  { return std::pair{a.heap_index, a.offset} < std::pair{b.heap_index, b.offset}; });
+        for (u32 transient_index = 0; transient_index < transients.size(); ++transient_index)
+        {
+            TransientTrace const & transient = transients[transient_index];
+            usize const first_batch = submit_batch_offsets[transient.lifetime.first_use.submit_scope_index] + transient.lifetime.first_use.task_batch_index;
+            usize const last_batch = submit_batch_offsets[transient.lifetime.last_use.submit_scope_index] + transient.lifetime.last_use.task_batch_index;
+            f64 const begin = batch_begin_us(first_batch);
+            f64 const end = batch_begin_us(last_batch) + batch_duration_us(last_batch);
+            print_thread_name(TRANSIENT_PID, transient_index, fmt::format("heap {} offset {}", transient.heap_index, transient.offset), transient_index);
+            fmt::format_to(std::back_inserter(begin_event()),
+                           R"({{"name":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{},"args":{{"heap":{},"offset":{},"size":{}}}}})",
+                           trace_json_escaped(transient.name), begin, std::max(end - begin, 0.0), TRANSIENT_PID, transient_index,
+                           transient.heap_index, transient.offset, transient.size);
+        }
+        out.append("\n]}\n");
+    }
+
     void ImplTaskGraph::debug_print()
     {
         std::string out = {};
@@ -3488,7 +5843,9 @@ namespace daxa
         fmt::format_to(std::back_inserter(out), "device: {}\n", info.device.info().name.view());
         fmt::format_to(std::back_inserter(out), "swapchain: {}\n", (this->info.swapchain.has_value() ? this->info.swapchain.value().info().name.view() : "-"));
         fmt::format_to(std::back_inserter(out), "reorder tasks: {}\n", info.reorder_tasks);
+        fmt::format_to(std::back_inserter(out), "scheduling: {}\n", info.scheduling == TaskGraphScheduling::DEPENDENCY_GRAPH ? "dependency graph" : "greedy");
         fmt::format_to(std::back_inserter(out), "use split barriers: {}\n", info.use_split_barriers);
+        fmt::format_to(std::back_inserter(out), "split barrier min batch distance: {}, min tasks between: {}\n", info.split_barrier_min_batch_distance, info.split_barrier_min_tasks_between);
         fmt::format_to(std::back_inserter(out), "permutation_condition_count: {}\n", info.permutation_condition_count);
         fmt::format_to(std::back_inserter(out), "enable_command_labels: {}\n", info.enable_command_labels);
         fmt::format_to(std::back_inserter(out), "task_graph_label_color: ({},{},{},{})\n",
@@ -3508,13 +5865,25 @@ namespace daxa
                        info.task_label_color[3]);
         fmt::format_to(std::back_inserter(out), "record_debug_information: {}\n", info.record_debug_information);
         fmt::format_to(std::back_inserter(out), "staging_memory_pool_size: {}\n", info.staging_memory_pool_size);
+        fmt::format_to(std::back_inserter(out), "record_thread_count: {}\n", info.record_thread_count);
+        fmt::format_to(std::back_inserter(out), "execution_context_count: {}\n", info.execution_context_count);
+        fmt::format_to(std::back_inserter(out), "transient memory: {} bytes in {} heaps, peak alive lower bound: {} bytes\n",
+                       transient_memory_stats.size, transient_heaps.size(), transient_memory_stats.lower_bound);
         fmt::format_to(std::back_inserter(out), "executed permutation: {}\n", chosen_permutation_last_execution);
         usize permutation_index = this->chosen_permutation_last_execution;
-        auto & permutation = this->permutations[permutation_index];
+        auto & permutation = info.jit_compile_permutations ? this->jit_permutations.at(static_cast<u32>(permutation_index)) : this->permutations[permutation_index];
         {
             this->print_permutation_aliasing_to(out, indent, permutation);
             permutation_index += 1;
             fmt::format_to(std::back_inserter(out), "permutations split barriers: {}\n", info.use_split_barriers);
+            fmt::format_to(std::back_inserter(out), "recording order schedule: {} batches, {} barriers, {} split barriers\n",
+                           permutation.recording_order_stats.batch_count,
+                           permutation.recording_order_stats.barrier_count,
+                           permutation.recording_order_stats.split_barrier_count);
+            fmt::format_to(std::back_inserter(out), "final schedule: {} batches, {} barriers, {} split barriers\n",
+                           permutation.final_stats.batch_count,
+                           permutation.final_stats.barrier_count,
+                           permutation.final_stats.split_barrier_count);
             [[maybe_unused]] FormatIndent const d0{out, indent, true};
             usize submit_scope_index = 0;
             for (auto & submit_scope : permutation.batch_submit_scopes)
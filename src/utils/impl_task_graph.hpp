@@ -4,6 +4,9 @@
 
 #include <variant>
 #include <sstream>
+#include <condition_variable>
+#include <functional>
+#include <thread>
 #include <daxa/utils/task_graph.hpp>
 
 #define DAXA_TASK_GRAPH_MAX_CONDITIONALS 31
@@ -16,6 +19,89 @@ namespace daxa
 
     using TaskId = usize;
 
+    // Indices of the async queues in the per queue arrays of the task graph.
+    static constexpr inline usize ASYNC_QUEUE_COMPUTE = 0;
+    static constexpr inline usize ASYNC_QUEUE_TRANSFER = 1;
+    static constexpr inline usize ASYNC_QUEUE_VIDEO_DECODE = 2;
+    static constexpr inline usize ASYNC_QUEUE_VIDEO_ENCODE = 3;
+    static constexpr inline usize ASYNC_QUEUE_COUNT = 4;
+
+    // Conditional scopes active while something was recorded and their states.
+    struct RecordCondition
+    {
+        u32 active_conditional_scopes = {};
+        u32 conditional_states = {};
+
+        auto active_in(u32 permutation_index) const -> bool
+        {
+            return (active_conditional_scopes & permutation_index) == (active_conditional_scopes & conditional_states);
+        }
+    };
+
+    struct TransientMemoryStats
+    {
+        usize size = {};
+        usize lower_bound = {};
+    };
+
+    struct ImageViewCacheKey
+    {
+        ImageId image = {};
+        ImageMipArraySlice slice = {};
+        ImageViewType type = {};
+
+        friend auto operator==(ImageViewCacheKey const &, ImageViewCacheKey const &) -> bool = default;
+    };
+
+    struct ImageViewCacheKeyHash
+    {
+        auto operator()(ImageViewCacheKey const & key) const -> usize
+        {
+            usize hash = std::hash<u64>{}(std::bit_cast<u64>(key.image));
+            for (u32 value : {key.slice.base_mip_level, key.slice.level_count, key.slice.base_array_layer, key.slice.layer_count, static_cast<u32>(key.type)})
+            {
+                hash ^= std::hash<u32>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+            return hash;
+        }
+    };
+
+    // Everything of a transient image info that affects its memory requirements.
+    struct TransientImageRequirementsKey
+    {
+        u64 flags = {};
+        u32 dimensions = {};
+        Format format = {};
+        Extent3D size = {};
+        u32 mip_level_count = {};
+        u32 array_layer_count = {};
+        u32 sample_count = {};
+        u64 usage = {};
+        SharingMode sharing_mode = {};
+
+        friend auto operator==(TransientImageRequirementsKey const &, TransientImageRequirementsKey const &) -> bool = default;
+    };
+
+    struct TransientImageRequirementsKeyHash
+    {
+        auto operator()(TransientImageRequirementsKey const & key) const -> usize
+        {
+            usize hash = std::hash<u64>{}(key.flags) ^ (std::hash<u64>{}(key.usage) << 1);
+            for (u32 value : {key.dimensions, static_cast<u32>(key.format), key.size.x, key.size.y, key.size.z, key.mip_level_count, key.array_layer_count, key.sample_count, static_cast<u32>(key.sharing_mode)})
+            {
+                hash ^= std::hash<u32>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+            return hash;
+        }
+    };
+
+    struct CachedImageView
+    {
+        ImageViewId view = {};
+        // Number of task attachments currently using the view.
+        u32 use_count = {};
+    };
+
     struct LastConcurrentAccessSplitBarrierIndex
     {
         usize index;
@@ -63,6 +149,7 @@ namespace daxa
         std::variant<BufferId, BlasId, TlasId> actual_id = BufferId{};
 
         ResourceLifetime lifetime = {};
+        u32 heap_index = {};
         usize allocation_offset = {};
         daxa::MemoryRequirements memory_requirements = {};
     };
@@ -91,6 +178,9 @@ namespace daxa
         ImageCreateFlags create_flags = ImageCreateFlagBits::NONE;
         ImageUsageFlags usage = ImageUsageFlagBits::NONE;
         ImageId actual_image = {};
+        // Set when another transient resource of the permutation shares memory with this image.
+        bool aliased = {};
+        u32 heap_index = {};
         usize allocation_offset = {};
         daxa::MemoryRequirements memory_requirements = {};
     };
@@ -115,9 +205,23 @@ namespace daxa
     struct ImplTask
     {
         std::unique_ptr<ITask> base_task = {};
+        bool enabled = true;
+    };
+
+    // What an execution writes per task while recording it.
+    // Kept per execution context, so executions recording at the same time never share it.
+    struct ImplTaskExecutionState
+    {
+        // Copy of the task's attachments with the runtime ids of the execution, handed to the callback.
+        std::vector<TaskAttachmentInfo> attachments = {};
         std::vector<std::vector<ImageViewId>> image_view_cache = {};
         // Used to verify image view cache:
         std::vector<std::vector<ImageId>> runtime_images_last_execution = {};
+        // Attachment shader blob of the last execution and the ids it was written from.
+        std::vector<std::byte> attachment_shader_blob = {};
+        std::vector<u64> attachment_shader_blob_ids = {};
+        bool attachment_shader_blob_valid = {};
+        std::vector<TaskAttachmentViewLookupEntry> attachment_view_lookup = {};
     };
 
     struct ImplPresentInfo
@@ -128,9 +232,16 @@ namespace daxa
 
     struct TaskBatch
     {
+        // Only with TaskGraphInfo::enable_gpu_profiling, the begin and end timestamps of the batch.
+        // The ones of the tasks follow, two per task.
+        u32 profiling_query_index = {};
+        // Index of the first task of the batch in the per task profiling queries and timings.
+        u32 profiling_task_index = {};
         std::vector<usize> pipeline_barrier_indices = {};
         std::vector<usize> wait_split_barrier_indices = {};
         std::vector<TaskId> tasks = {};
+        // Command labels of the tasks, built in complete.
+        std::vector<SmallString> task_labels = {};
         std::vector<usize> signal_split_barrier_indices = {};
     };
 
@@ -143,6 +254,7 @@ namespace daxa
         std::vector<TaskBatch> task_batches = {};
         std::vector<u64> used_swapchain_task_images = {};
         std::optional<ImplPresentInfo> present_info = {};
+        SmallString label = {};
     };
 
     auto task_image_access_to_layout_access(TaskImageAccess const & access) -> std::tuple<ImageLayout, Access, TaskAccessConcurrency>;
@@ -150,6 +262,22 @@ namespace daxa
 
     struct ImplTaskGraph;
 
+    struct TaskScheduleStats
+    {
+        usize batch_count = {};
+        usize barrier_count = {};
+        usize split_barrier_count = {};
+    };
+
+    // Transient resources with the same memory type bits share a heap, each heap is a separate memory block.
+    struct TransientHeap
+    {
+        u32 memory_type_bits = {};
+        usize alignment = 1;
+        usize size = {};
+        MemoryBlock memory_block = {};
+    };
+
     struct TaskGraphPermutation
     {
         // record time information:
@@ -167,10 +295,22 @@ namespace daxa
         std::vector<TaskBatchSubmitScope> batch_submit_scopes = {};
         usize swapchain_image_first_use_submit_scope_index = std::numeric_limits<usize>::max();
         usize swapchain_image_last_use_submit_scope_index = std::numeric_limits<usize>::max();
+        // Calls in recording order, replayed by reschedule for TaskGraphScheduling::DEPENDENCY_GRAPH.
+        std::vector<std::variant<TaskId, TaskSubmitInfo, TaskPresentInfo>> recorded_calls = {};
+        TaskScheduleStats recording_order_stats = {};
+        TaskScheduleStats final_stats = {};
+        // Only with TaskGraphInfo::jit_compile_permutations, each compiled permutation owns its transient memory.
+        std::vector<TransientHeap> jit_transient_heaps = {};
+        TransientMemoryStats jit_transient_memory_stats = {};
+        u32 profiling_query_count = {};
+        u32 profiling_task_count = {};
 
         void add_task(ImplTaskGraph & task_graph_impl, ImplTask & impl_task, TaskId task_id);
         void submit(TaskSubmitInfo const & info);
         void present(TaskPresentInfo const & info);
+        auto schedule_stats() const -> TaskScheduleStats;
+        void reset_schedule();
+        void reschedule(ImplTaskGraph & task_graph_impl);
     };
 
     struct ImplPersistentTaskBufferBlasTlas final : ImplHandle
@@ -181,13 +321,16 @@ namespace daxa
         ImplPersistentTaskBufferBlasTlas(TaskTlasInfo a_info);
         ~ImplPersistentTaskBufferBlasTlas();
 
-        std::variant<
+        using ActualIds = std::variant<
             std::vector<BufferId>,
             std::vector<BlasId>,
             std::vector<TlasId>
-        > actual_ids = {};
+        >;
+        ActualIds actual_ids = {};
 
         Access latest_access = {};
+        // Task graphs may start executions on multiple threads, they read and update the runtime state under this lock.
+        std::mutex mtx = {};
 
         std::variant<
             TaskBufferInfo,
@@ -219,6 +362,8 @@ namespace daxa
         std::vector<ImageSliceState> latest_slice_states = {};
         // Only for swapchain images. Runtime data.
         bool waited_on_acquire = {};
+        // Task graphs may start executions on multiple threads, they read and update the runtime state under this lock.
+        std::mutex mtx = {};
 
         // Used to allocate id - because all persistent resources have unique id we need a single point
         // from which they are generated
@@ -251,6 +396,7 @@ namespace daxa
         {
             // TODO: Add Transient Blas and Tlas
             TaskTransientBufferInfo info = {};
+            RecordCondition condition = {};
         };
         Variant<Persistent, Transient> task_buffer_data;
 
@@ -298,6 +444,7 @@ namespace daxa
         struct Transient
         {
             TaskTransientImageInfo info = {};
+            RecordCondition condition = {};
         };
         Variant<Persistent, Transient> task_image_data;
 
@@ -326,12 +473,63 @@ namespace daxa
         }
     };
 
+    struct ImplTransientMemoryHeap final : ImplHandle
+    {
+        struct Heap
+        {
+            u32 memory_type_bits = {};
+            usize alignment = 1;
+            usize reserved_size = {};
+            MemoryBlock memory_block = {};
+            usize memory_block_size = {};
+        };
+
+        TransientMemoryHeapInfo info = {};
+        std::vector<Heap> heaps = {};
+
+        void reserve(TransientHeap const & transient_heap);
+        // Grows the memory block when a graph reserved more since it was allocated.
+        // Graphs that already created their resources keep the old block alive.
+        auto acquire(u32 memory_type_bits) -> MemoryBlock;
+
+        static void zero_ref_callback(ImplHandle const * handle);
+    };
+
+    // State of one execution that lives until the execution ended, see TaskGraphInfo::execution_context_count.
+    // Executions are handed the contexts in turn, a context is only reused once the execution before ended.
+    struct TaskGraphExecutionContext
+    {
+        ImplTaskGraph const * task_graph = {};
+        std::optional<TransferMemoryPool> staging_memory = {};
+        // One per recording thread after the first, see TaskGraphInfo::record_thread_count.
+        std::vector<TransferMemoryPool> worker_staging_memories = {};
+        // Only with one of the async queues of the TaskGraphInfo.
+        // The main queue signals the main timeline before offloaded tasks, each async queue signals its own timeline after them.
+        std::optional<TimelineSemaphore> async_main_timeline = {};
+        std::array<std::optional<TimelineSemaphore>, ASYNC_QUEUE_COUNT> async_queue_timelines = {};
+        u64 async_main_timeline_value = {};
+        std::array<u64, ASYNC_QUEUE_COUNT> async_queue_timeline_values = {};
+        // Runtime resources of the persistent task resources when the execution started, indexed by the local resource index.
+        // Recording reads these, so persistent resources may be changed for later executions in the meantime.
+        std::vector<std::vector<ImageId>> persistent_images = {};
+        std::vector<ImplPersistentTaskBufferBlasTlas::ActualIds> persistent_buffers = {};
+        // Indexed by task id.
+        std::vector<ImplTaskExecutionState> task_states = {};
+        std::vector<ExecutableCommandList> left_over_command_lists = {};
+        // Only set while an execution uses the context, jit compiled permutations in use are never evicted.
+        TaskGraphPermutation const * permutation = {};
+        bool in_use = {};
+    };
+
     struct ImplTaskRuntimeInterface
     {
         // interface:
         ImplTaskGraph & task_graph;
         TaskGraphPermutation & permutation;
         CommandRecorder & recorder;
+        TaskGraphExecutionContext & context;
+        // Pool of the recording thread, handed to the tasks as their allocator.
+        TransferMemoryPool * staging_memory = {};
         ImplTask * current_task = {};
         types::DeviceAddress device_address = {};
         bool reuse_last_command_list = true;
@@ -364,18 +562,80 @@ namespace daxa
         std::unordered_map<std::string, TaskTlasView> tlas_name_to_id = {};
         std::unordered_map<std::string, TaskImageView> image_name_to_id = {};
 
-        usize memory_block_size = {};
-        u32 memory_type_bits = 0xFFFFFFFFu;
-        MemoryBlock transient_data_memory_block = {};
+        std::vector<TransientHeap> transient_heaps = {};
+        // Sum of the heap sizes and the sum of the per heap peaks of concurrently alive transient memory.
+        TransientMemoryStats transient_memory_stats = {};
+        bool transient_resources_created = {};
+        // Memory requirements of transient resources, shared by all permutations and kept across recompilations.
+        // Requirements only depend on the create info, permutations with the same transient infos query the device once.
+        std::unordered_map<TransientImageRequirementsKey, MemoryRequirements, TransientImageRequirementsKeyHash> transient_image_requirements = {};
+        std::unordered_map<usize, MemoryRequirements> transient_buffer_requirements = {};
+        // Only with TaskGraphInfo::jit_compile_permutations.
+        // Permutations are compiled on their first execution by replaying the recorded calls with matching conditions.
+        // The compiled ones are kept in least recently used order, the front is evicted first.
+        struct JitRecordedCall
+        {
+            std::variant<TaskId, TaskSubmitInfo, TaskPresentInfo> call = {};
+            RecordCondition condition = {};
+        };
+        std::vector<JitRecordedCall> jit_recorded_calls = {};
+        std::unordered_map<u32, TaskGraphPermutation> jit_permutations = {};
+        std::vector<u32> jit_lru_permutations = {};
+        // Only with TaskGraphInfo::enable_gpu_profiling.
+        // An execution is resolved once all its submits completed, older executions are dropped then.
+        // The queries are reset on the gpu, before that their results may still be the ones of the execution that used the frame before.
+        struct GpuProfilingFrame
+        {
+            // Latest device submit index once the execution submitted, u64 max while it records or when it submitted nothing.
+            u64 submit_index = {};
+            // Guards the queried flags of the task timings, written by the recording threads.
+            std::mutex queried_mtx = {};
+            TimelineQueryPool query_pool = {};
+            u32 query_count = {};
+            // Only with TaskGraphInfo::gpu_profiling_pipeline_statistics and gpu_profiling_occlusion, one query per task.
+            QueryPool statistics_query_pool = {};
+            QueryPool occlusion_query_pool = {};
+            u32 task_count = {};
+            bool pending = {};
+            TaskGraphGpuTimings timings = {};
+        };
+        static constexpr inline usize GPU_PROFILING_FRAME_COUNT = 4;
+        std::array<GpuProfilingFrame, GPU_PROFILING_FRAME_COUNT> gpu_profiling_frames = {};
+        u64 gpu_profiling_execution_count = {};
+        TaskGraphGpuTimings gpu_timings = {};
+        // Non default views of the task attachments, shared by all tasks.
+        // Unused views are kept until their image is destroyed, so tasks swapping between the same images reuse them.
+        std::unordered_map<ImageViewCacheKey, CachedImageView, ImageViewCacheKeyHash> image_views = {};
+        std::mutex image_views_mtx = {};
         bool compiled = {};
 
         // execution time information:
-        std::optional<daxa::TransferMemoryPool> staging_memory = {};
+        // Executions begin and end under execution_mtx, in between they record without holding it.
+        // They begin in the order they take their context and submit in that same order.
+        std::vector<TaskGraphExecutionContext> execution_contexts = {};
+        std::mutex execution_mtx = {};
+        std::condition_variable execution_cv = {};
+        u64 begun_execution_count = {};
+        u64 ended_execution_count = {};
+        // Executions that grew the thread local execution scratch, see TaskGraph::get_execution_scratch_growth_count.
+        std::atomic_uint64_t execution_scratch_growth_count = {};
+        // Threads recording batch ranges with record_thread_count above one, started by the first job and shared by all executions.
+        std::mutex record_worker_mtx = {};
+        std::condition_variable record_worker_cv = {};
+        // Notified whenever a record job finished.
+        std::condition_variable record_job_done_cv = {};
+        std::deque<std::function<void()>> record_jobs = {};
+        std::vector<std::thread> record_worker_threads = {};
+        bool record_worker_stop = {};
+        void enqueue_record_job(std::function<void()> job);
+        void record_worker_loop();
+        void stop_record_workers();
+        // The context of the execution the thread records, get_actual_images and co. read the persistent runtime resources from it.
+        static inline thread_local TaskGraphExecutionContext const * recording_context = {};
         std::array<bool, DAXA_TASK_GRAPH_MAX_CONDITIONALS> execution_time_current_conditionals = {};
 
         // post execution information:
         u32 chosen_permutation_last_execution = {};
-        std::vector<ExecutableCommandList> left_over_command_lists = {};
         bool executed_once = {};
         u32 prev_frame_permutation_index = {};
         std::stringstream debug_string_stream = {};
@@ -391,9 +651,12 @@ namespace daxa
             auto const & global_buffer = global_buffer_infos.at(id.index);
             if (global_buffer.is_persistent())
             {
+                auto const & actual_ids = recording_context != nullptr && recording_context->task_graph == this
+                                              ? recording_context->persistent_buffers.at(id.index)
+                                              : global_buffer.get_persistent().actual_ids;
                 return std::span{
-                    std::get<std::vector<typename TaskIdT::ID_T>>(global_buffer.get_persistent().actual_ids).data(),
-                    std::get<std::vector<typename TaskIdT::ID_T>>(global_buffer.get_persistent().actual_ids).size(),
+                    std::get<std::vector<typename TaskIdT::ID_T>>(actual_ids).data(),
+                    std::get<std::vector<typename TaskIdT::ID_T>>(actual_ids).size(),
                 };
             }
             else
@@ -419,10 +682,13 @@ namespace daxa
             auto const & global_buffer = global_buffer_infos.at(id.index);
             if (global_buffer.is_persistent())
             {
+                auto const & actual_ids = recording_context != nullptr && recording_context->task_graph == this
+                                              ? recording_context->persistent_buffers.at(id.index)
+                                              : global_buffer.get_persistent().actual_ids;
                 GetActualIdsVariant ret = std::span{NULL_ID_ARRAY.data(), NULL_ID_ARRAY.size()};
                 std::visit([&](auto const & ids){
                     ret = std::span{ids.data(), ids.size()};
-                }, global_buffer.get_persistent().actual_ids);
+                }, actual_ids);
                 return ret;
             }
             else
@@ -486,17 +752,34 @@ namespace daxa
         auto get_actual_images(TaskImageView id, TaskGraphPermutation const & perm) const -> std::span<ImageId const>;
         auto id_to_local_id(TaskImageView id) const -> TaskImageView;
         void update_active_permutations();
-        void update_image_view_cache(ImplTask & task, TaskGraphPermutation const & permutation);
-        void execute_task(ImplTaskRuntimeInterface & impl_runtime, TaskGraphPermutation & permutation, u32 batch_index, TaskBatchId in_batch_task_index, TaskId task_id);
+        void update_image_view_cache(ImplTask const & task, ImplTaskExecutionState & task_state, TaskGraphPermutation const & permutation);
+        auto acquire_image_view(ImageViewInfo const & view_info) -> ImageViewId;
+        void release_image_view(ImageViewId view);
+        void collect_image_views();
+        auto begin_gpu_profiling_frame(TaskGraphPermutation const & permutation) -> GpuProfilingFrame &;
+        void execute_task(ImplTaskRuntimeInterface & impl_runtime, TaskGraphPermutation & permutation, SmallString const & label, TaskId task_id);
         void insert_pre_batch_barriers(TaskGraphPermutation & permutation);
         void create_transient_runtime_buffers(TaskGraphPermutation & permutation);
         void create_transient_runtime_images(TaskGraphPermutation & permutation);
-        void allocate_transient_resources();
+        auto transient_image_info(u32 image_index, PerPermTaskImage const & perm_image) const -> ImageInfo;
+        auto transient_image_requirements_of(ImageInfo const & image_info) -> MemoryRequirements;
+        auto transient_buffer_requirements_of(usize size) -> MemoryRequirements;
+        void create_transient_runtime_resources(std::span<TaskGraphPermutation * const> perms, std::vector<TransientHeap> & heaps);
+        void destroy_transient_runtime_resources(TaskGraphPermutation & permutation);
+        auto transient_heaps_of(TaskGraphPermutation & permutation) -> std::vector<TransientHeap> &;
+        auto allocate_transient_resources(std::span<TaskGraphPermutation * const> perms, std::vector<TransientHeap> & heaps) -> TransientMemoryStats;
+        void schedule_permutation(TaskGraphPermutation & permutation);
+        void finalize_permutation(TaskGraphPermutation & permutation);
+        auto jit_permutation(u32 permutation_index) -> TaskGraphPermutation &;
+        auto get_permutation(u32 permutation_index) -> TaskGraphPermutation &;
+        void replace_transient_resources();
+        void defer_transient_image_initialization(TaskGraphPermutation & permutation, u32 image_index);
         void print_task_buffer_blas_tlas_to(std::string & out, std::string indent, TaskGraphPermutation const & permutation, TaskGPUResourceView local_id);
         void print_task_image_to(std::string & out, std::string indent, TaskGraphPermutation const & permutation, TaskImageView image);
         void print_task_barrier_to(std::string & out, std::string & indent, TaskGraphPermutation const & permutation, usize index, bool const split_barrier);
         void print_task_to(std::string & out, std::string & indent, TaskGraphPermutation const & permutation, TaskId task_id);
         void print_permutation_aliasing_to(std::string & out, std::string indent, TaskGraphPermutation const & permutation);
+        void print_execution_trace_to(std::string & out, TaskGraphPermutation const & permutation);
         void debug_print();
 
         static void zero_ref_callback(ImplHandle const * handle);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <0_common/window.hpp>
+#include <0_common/gpu_benchmark.hpp>
 
 #include <thread>
 using namespace std::chrono_literals;
@@ -41,13 +42,20 @@ struct BaseApp : AppWindow<T>
         return daxa_ctx.create_device_2(info);
     }();
 
-    daxa::Swapchain swapchain = device.create_swapchain({
+    daxa::Swapchain swapchain = gpu_benchmark().enabled() ? daxa::Swapchain{} : device.create_swapchain({
         .native_window = AppWindow<T>::get_native_handle(),
         .native_window_platform = AppWindow<T>::get_native_platform(),
         .present_mode = daxa::PresentMode::IMMEDIATE,
         .image_usage = daxa::ImageUsageFlagBits::TRANSFER_DST,
         .name = "swapchain",
     });
+    // Takes the place of the swapchain images in benchmark mode.
+    daxa::ImageId offscreen_image = !gpu_benchmark().enabled() ? daxa::ImageId{} : device.create_image({
+        .format = daxa::Format::B8G8R8A8_UNORM,
+        .size = {AppWindow<T>::size_x, AppWindow<T>::size_y, 1},
+        .usage = daxa::ImageUsageFlagBits::TRANSFER_DST | daxa::ImageUsageFlagBits::COLOR_ATTACHMENT,
+        .name = "offscreen_image",
+    });
 
     daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
         .device = device,
@@ -70,6 +78,10 @@ struct BaseApp : AppWindow<T>
     daxa::ImGuiRenderer imgui_renderer = create_imgui_renderer();
     auto create_imgui_renderer() -> daxa::ImGuiRenderer
     {
+        if (gpu_benchmark().enabled())
+        {
+            return {};
+        }
         ImGui::CreateContext();
         ImGui_ImplGlfw_InitForVulkan(AppWindow<T>::glfw_window_ptr, true);
         return daxa::ImGuiRenderer({
@@ -81,29 +93,61 @@ struct BaseApp : AppWindow<T>
     Clock::time_point start = Clock::now(), prev_time = start;
     f32 time = 0.0f, delta_time = 1.0f;
 
-    daxa::TaskImage task_swapchain_image{{.swapchain_image = true, .name = "swapchain_image"}};
+    daxa::TaskImage task_swapchain_image{{.swapchain_image = !gpu_benchmark().enabled(), .name = "swapchain_image"}};
     std::vector<daxa::TaskAttachmentInfo> imgui_task_attachments{};
 
-    BaseApp() : AppWindow<T>(APPNAME)
+    BaseApp() : AppWindow<T>(APPNAME, 800, 600, gpu_benchmark().enabled())
     {
     }
 
     ~BaseApp()
     {
+        if (gpu_benchmark().enabled())
+        {
+            device.wait_idle();
+            device.destroy_image(offscreen_image);
+            device.collect_garbage();
+            return;
+        }
         ImGui_ImplGlfw_Shutdown();
     }
 
     void base_on_update()
     {
-        auto now = Clock::now();
-        time = std::chrono::duration<f32>(now - start).count();
-        delta_time = std::chrono::duration<f32>(now - prev_time).count();
-        prev_time = now;
+        if (gpu_benchmark().enabled())
+        {
+            time = static_cast<f32>(gpu_benchmark().frame_index) * GpuBenchmark::FRAME_DELTA_TIME;
+            delta_time = GpuBenchmark::FRAME_DELTA_TIME;
+        }
+        else
+        {
+            auto now = Clock::now();
+            time = std::chrono::duration<f32>(now - start).count();
+            delta_time = std::chrono::duration<f32>(now - prev_time).count();
+            prev_time = now;
+        }
         reinterpret_cast<T *>(this)->on_update();
     }
 
+    // Returns the offscreen image in benchmark mode.
+    auto acquire_next_image() -> daxa::ImageId
+    {
+        if (gpu_benchmark().enabled())
+        {
+            return offscreen_image;
+        }
+        return swapchain.acquire_next_image();
+    }
+
     auto update() -> bool
     {
+        if (gpu_benchmark().enabled())
+        {
+            base_on_update();
+            gpu_benchmark().end_frame();
+            return gpu_benchmark().finished();
+        }
+
         glfwPollEvents();
         if (glfwWindowShouldClose(AppWindow<T>::glfw_window_ptr))
         {
@@ -124,17 +168,27 @@ struct BaseApp : AppWindow<T>
 
     auto record_loop_task_graph() -> daxa::TaskGraph
     {
+        bool const benchmark = gpu_benchmark().enabled();
         daxa::TaskGraph new_task_graph = daxa::TaskGraph({
             .device = device,
-            .swapchain = swapchain,
+            .swapchain = benchmark ? std::nullopt : std::optional{swapchain},
             .use_split_barriers = false,
             .record_debug_information = true,
+            .enable_gpu_profiling = benchmark,
             .name = "main_task_graph",
         });
         new_task_graph.use_persistent_image(task_swapchain_image);
 
         reinterpret_cast<T *>(this)->record_tasks(new_task_graph);
 
+        if (benchmark)
+        {
+            imgui_task_attachments.clear();
+            new_task_graph.submit({});
+            new_task_graph.complete({});
+            return new_task_graph;
+        }
+
         imgui_task_attachments.push_back(daxa::inl_attachment(daxa::TaskImageAccess::COLOR_ATTACHMENT, task_swapchain_image));
         auto imgui_task_info = daxa::InlineTaskInfo{
             .attachments = std::move(imgui_task_attachments),
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <daxa/daxa.hpp>
+#include <daxa/utils/task_graph.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace daxa::types;
+
+// Headless benchmark mode of the samples, enabled by passing `--benchmark <frame count>`.
+// The samples then render a fixed number of frames into an offscreen image instead of a swapchain,
+// profile their task graphs on the gpu and print percentiles of the graph and task times at the end.
+struct GpuBenchmark
+{
+    // Fixed time step, so every benchmark run simulates the same frames.
+    static constexpr f32 FRAME_DELTA_TIME = 1.0f / 60.0f;
+
+    struct Series
+    {
+        std::string name = {};
+        u64 last_execution_index = {};
+        std::vector<u64> durations_ns = {};
+    };
+
+    u32 frame_count = {};
+    u32 frame_index = {};
+    // These first frames are not recorded, they pay for pipeline creation and driver warm up.
+    u32 warmup_frame_count = {};
+    std::vector<Series> series = {};
+
+    void parse_args(int argc, char const * const * argv)
+    {
+        for (int i = 0; i + 1 < argc; ++i)
+        {
+            if (std::string_view{argv[i]} == "--benchmark")
+            {
+                std::string_view const value = argv[i + 1];
+                std::from_chars(value.data(), value.data() + value.size(), frame_count);
+                warmup_frame_count = frame_count / 10;
+            }
+        }
+    }
+
+    [[nodiscard]] auto enabled() const -> bool { return frame_count != 0; }
+    [[nodiscard]] auto finished() const -> bool { return frame_index >= frame_count; }
+    void end_frame() { ++frame_index; }
+
+    // Records the most recent execution of the graph the gpu finished, the graph needs enable_gpu_profiling.
+    // Reading the timings never waits on the gpu, so executions that finish while others are pending may be skipped.
+    void collect(daxa::TaskGraph & task_graph, std::string_view graph_name)
+    {
+        if (!enabled() || frame_index < warmup_frame_count)
+        {
+            return;
+        }
+        daxa::TaskGraphGpuTimings const & timings = task_graph.get_timings();
+        Series & graph_series = find_series(graph_name);
+        if (timings.execution_index == 0 || timings.execution_index == graph_series.last_execution_index)
+        {
+            return;
+        }
+        u64 graph_duration_ns = 0;
+        for (auto const & batch : timings.batches)
+        {
+            graph_duration_ns = std::max(graph_duration_ns, batch.begin_ns + batch.duration_ns);
+        }
+        graph_series.last_execution_index = timings.execution_index;
+        graph_series.durations_ns.push_back(graph_duration_ns);
+        for (auto const & task : timings.tasks)
+        {
+            // Tasks sharing a name within one execution are summed up.
+            Series & task_series = find_series(std::string{graph_name} + "/" + std::string{task.name});
+            if (task_series.last_execution_index != timings.execution_index)
+            {
+                task_series.last_execution_index = timings.execution_index;
+                task_series.durations_ns.push_back(0);
+            }
+            task_series.durations_ns.back() += task.duration_ns;
+        }
+    }
+
+    void report(std::ostream & out) const
+    {
+        out << "gpu benchmark: " << frame_count << " frames, " << warmup_frame_count << " warmup frames, times in ms\n";
+        out << std::left << std::setw(48) << "name" << std::right
+            << std::setw(8) << "samples"
+            << std::setw(10) << "min"
+            << std::setw(10) << "p50"
+            << std::setw(10) << "p90"
+            << std::setw(10) << "p99"
+            << std::setw(10) << "max" << '\n';
+        for (auto const & s : series)
+        {
+            if (s.durations_ns.empty())
+            {
+                continue;
+            }
+            auto sorted = s.durations_ns;
+            std::sort(sorted.begin(), sorted.end());
+            // Nearest rank percentile.
+            auto const percentile_ms = [&](f64 p)
+            {
+                auto const rank = static_cast<usize>(p * static_cast<f64>(sorted.size() - 1) + 0.5);
+                return static_cast<f64>(sorted[rank]) / 1'000'000.0;
+            };
+            out << std::left << std::setw(48) << s.name << std::right
+                << std::setw(8) << sorted.size()
+                << std::fixed << std::setprecision(3)
+                << std::setw(10) << percentile_ms(0.0)
+                << std::setw(10) << percentile_ms(0.5)
+                << std::setw(10) << percentile_ms(0.9)
+                << std::setw(10) << percentile_ms(0.99)
+                << std::setw(10) << percentile_ms(1.0) << '\n';
+        }
+    }
+
+  private:
+    auto find_series(std::string_view name) -> Series &
+    {
+        auto iter = std::find_if(series.begin(), series.end(), [&](Series const & s)
+                                 { return s.name == name; });
+        if (iter == series.end())
+        {
+            return series.emplace_back(Series{.name = std::string{name}});
+        }
+        return *iter;
+    }
+};
+
+// Set up by the main function of a sample before the app is created.
+inline auto gpu_benchmark() -> GpuBenchmark &
+{
+    static GpuBenchmark benchmark = {};
+    return benchmark;
+}
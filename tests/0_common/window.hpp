@@ -19,8 +19,13 @@ struct AppWindow
     u32 size_x, size_y;
     bool minimized = false;
 
-    explicit AppWindow(char const * window_name, u32 sx = 800, u32 sy = 600) : size_x{sx}, size_y{sy}
+    // A headless window opens nothing, glfw_window_ptr stays null and no callbacks are ever called.
+    explicit AppWindow(char const * window_name, u32 sx = 800, u32 sy = 600, bool headless = false) : glfw_window_ptr{nullptr}, size_x{sx}, size_y{sy}
     {
+        if (headless)
+        {
+            return;
+        }
         glfwInit();
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
         glfw_window_ptr = glfwCreateWindow(static_cast<i32>(size_x), static_cast<i32>(size_y), window_name, nullptr, nullptr);
@@ -57,6 +62,10 @@ struct AppWindow
 
     ~AppWindow()
     {
+        if (glfw_window_ptr == nullptr)
+        {
+            return;
+        }
         glfwDestroyWindow(glfw_window_ptr);
         glfwTerminate();
     }
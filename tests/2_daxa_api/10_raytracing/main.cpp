@@ -3,6 +3,7 @@
 #include <string>
 
 #include <daxa/daxa.hpp>
+#include <daxa/utils/mem.hpp>
 #include <daxa/utils/pipeline_manager.hpp>
 #include <daxa/utils/task_graph.hpp>
 
@@ -16,6 +17,259 @@
 
 namespace tests
 {
+    // Device and ray query pipeline shared by the headless acceleration structure tests.
+    struct RayQueryContext
+    {
+        daxa::Instance daxa_ctx = {};
+        daxa::Device device = {};
+        daxa::PipelineManager pipeline_manager = {};
+        std::shared_ptr<daxa::ComputePipeline> ray_query_pipeline = {};
+        daxa::BufferId triangle_buffer = {};
+        std::array<daxa::BlasTriangleGeometryInfo, 1> geometries = {};
+
+        // Returns false when no device supports ray tracing.
+        auto initialize() -> bool
+        {
+            daxa_ctx = daxa::create_instance({});
+            try
+            {
+                device = daxa_ctx.create_device_2(daxa_ctx.choose_device(daxa::ImplicitFeatureFlagBits::BASIC_RAY_TRACING, {}));
+            }
+            catch (std::runtime_error const &)
+            {
+                return false;
+            }
+            pipeline_manager = daxa::PipelineManager{daxa::PipelineManagerInfo{
+                .device = device,
+                .shader_compile_options = {
+                    .root_paths = {
+                        DAXA_SHADER_INCLUDE_DIR,
+                        "tests/2_daxa_api/10_raytracing/shaders",
+                    },
+                },
+            }};
+            ray_query_pipeline = pipeline_manager.add_compute_pipeline({
+                .shader_info = {.source = daxa::ShaderFile{"ray_query_hit.glsl"}},
+                .push_constant_size = sizeof(RayQueryPush),
+                .name = "ray query hit",
+            }).value();
+            // A triangle in the z = 0.5 plane around the z axis, followed by its indices.
+            struct Triangle
+            {
+                std::array<daxa_f32vec3, 3> vertices;
+                std::array<daxa_u32, 3> indices;
+            };
+            triangle_buffer = device.create_buffer({
+                .size = sizeof(Triangle),
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = "triangle buffer",
+            });
+            *device.buffer_host_address_as<Triangle>(triangle_buffer).value() = Triangle{
+                .vertices = {daxa_f32vec3{-0.5f, -0.5f, 0.5f}, daxa_f32vec3{0.0f, 0.5f, 0.5f}, daxa_f32vec3{0.5f, -0.5f, 0.5f}},
+                .indices = {0, 1, 2},
+            };
+            daxa::DeviceAddress const triangle_address = device.device_address(triangle_buffer).value();
+            geometries[0] = daxa::BlasTriangleGeometryInfo{
+                .vertex_data = triangle_address,
+                .max_vertex = 2,
+                .index_data = triangle_address + offsetof(Triangle, indices),
+                .count = 1,
+            };
+            return true;
+        }
+
+        // Records the queued builds of the builder, builds a tlas with one instance of blas and casts a ray query at the triangle.
+        // Returns whether the ray hit it.
+        auto ray_query_hits(daxa::AccelerationStructureBuilder & builder, daxa::BlasId blas) -> bool
+        {
+            auto hit_buffer = device.create_buffer({
+                .size = sizeof(daxa_u32),
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = "ray query hit buffer",
+            });
+            defer { device.destroy_buffer(hit_buffer); };
+            *device.buffer_host_address_as<daxa_u32>(hit_buffer).value() = 0;
+            auto instance_buffer = device.create_buffer({
+                .size = sizeof(daxa_BlasInstanceData),
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = "ray query instance buffer",
+            });
+            defer { device.destroy_buffer(instance_buffer); };
+            *device.buffer_host_address_as<daxa_BlasInstanceData>(instance_buffer).value() = daxa_BlasInstanceData{
+                .transform = {
+                    {1, 0, 0, 0},
+                    {0, 1, 0, 0},
+                    {0, 0, 1, 0},
+                },
+                .mask = 0xFF,
+                .flags = DAXA_GEOMETRY_INSTANCE_FORCE_OPAQUE,
+                .blas_device_address = device.device_address(blas).value(),
+            };
+            auto instances = std::array{daxa::TlasInstanceInfo{
+                .data = device.device_address(instance_buffer).value(),
+                .count = 1,
+            }};
+            auto tlas_build_info = daxa::TlasBuildInfo{
+                .flags = daxa::AccelerationStructureBuildFlagBits::PREFER_FAST_TRACE,
+                .instances = instances,
+            };
+            daxa::AccelerationStructureBuildSizesInfo const tlas_build_sizes = device.tlas_build_sizes(tlas_build_info);
+            auto tlas = device.create_tlas({
+                .size = tlas_build_sizes.acceleration_structure_size,
+                .name = "ray query tlas",
+            });
+            defer { device.destroy_tlas(tlas); };
+            auto tlas_scratch_buffer = device.create_buffer({
+                .size = tlas_build_sizes.build_scratch_size,
+                .name = "ray query tlas scratch buffer",
+            });
+            defer { device.destroy_buffer(tlas_scratch_buffer); };
+            tlas_build_info.dst_tlas = tlas;
+            tlas_build_info.scratch_data = device.device_address(tlas_scratch_buffer).value();
+
+            auto recorder = device.create_command_recorder({.name = "ray query"});
+            builder.inc_timeline_value();
+            builder.record_builds(recorder);
+            recorder.build_acceleration_structures({
+                .tlas_build_infos = std::array{tlas_build_info},
+            });
+            recorder.pipeline_barrier({
+                .src_access = daxa::AccessConsts::ACCELERATION_STRUCTURE_BUILD_WRITE,
+                .dst_access = daxa::AccessConsts::COMPUTE_SHADER_READ,
+            });
+            recorder.set_pipeline(*ray_query_pipeline);
+            recorder.push_constant(RayQueryPush{
+                .tlas = tlas,
+                .hit = device.device_address(hit_buffer).value(),
+            });
+            recorder.dispatch({});
+            recorder.pipeline_barrier({
+                .src_access = daxa::AccessConsts::COMPUTE_SHADER_WRITE,
+                .dst_access = daxa::AccessConsts::HOST_READ,
+            });
+            device.submit_commands({
+                .command_lists = std::array{recorder.complete_current_commands()},
+                .signal_timeline_semaphores = std::array{std::pair{builder.timeline_semaphore(), builder.timeline_value()}},
+            });
+            device.wait_idle();
+            return *device.buffer_host_address_as<daxa_u32>(hit_buffer).value() == 1;
+        }
+
+        ~RayQueryContext()
+        {
+            if (device.is_valid())
+            {
+                device.destroy_buffer(triangle_buffer);
+                device.wait_idle();
+                device.collect_garbage();
+            }
+        }
+    };
+
+    void acceleration_structure_builder()
+    {
+        // TEST:
+        //    1) Enqueue a triangle blas in an AccelerationStructureBuilder
+        //    2) Record its build, a tlas build over it and a ray query in one submit
+        //    Expected result:
+        //      The blas is placed in pooled memory, built in the batch and hit by the ray.
+        RayQueryContext context = {};
+        if (!context.initialize())
+        {
+            std::cout << "Test skipped. No present device supports raytracing!" << std::endl;
+            return;
+        }
+        daxa::AccelerationStructureBuilder builder{daxa::AccelerationStructureBuilderInfo{
+            .device = context.device,
+            .name = "acceleration structure builder",
+        }};
+        auto blas = builder.enqueue(
+            {
+                .flags = daxa::AccelerationStructureBuildFlagBits::PREFER_FAST_TRACE,
+                .geometries = context.geometries,
+            },
+            "builder blas");
+        if (builder.pending_build_count() != 1)
+        {
+            std::cout << "failed test \"acceleration_structure_builder\": enqueue did not queue the build" << std::endl;
+            exit(-1);
+        }
+        bool const hit = context.ray_query_hits(builder, blas);
+        if (!hit || builder.pending_build_count() != 0)
+        {
+            std::cout << "failed test \"acceleration_structure_builder\": the ray missed the blas built by the builder" << std::endl;
+            exit(-1);
+        }
+        builder.destroy_blas(blas);
+    }
+
+    void blas_compaction()
+    {
+        // TEST:
+        //    1) Enqueue a triangle blas allowing compaction in an AccelerationStructureBuilder
+        //    2) Keep recording batches until the compaction finished
+        //    Expected result:
+        //      The compacted blas replaces the original, is not larger than it and is hit by the ray.
+        RayQueryContext context = {};
+        if (!context.initialize())
+        {
+            std::cout << "Test skipped. No present device supports raytracing!" << std::endl;
+            return;
+        }
+        daxa::AccelerationStructureBuilder builder{daxa::AccelerationStructureBuilderInfo{
+            .device = context.device,
+            .name = "compacting acceleration structure builder",
+        }};
+        auto blas = builder.enqueue(
+            {
+                .flags = daxa::AccelerationStructureBuildFlagBits::PREFER_FAST_TRACE | daxa::AccelerationStructureBuildFlagBits::ALLOW_COMPACTION,
+                .geometries = context.geometries,
+            },
+            "compacted blas");
+        u64 const original_size = context.device.info(blas).value().size;
+        // The first batch builds the blas and queries its compacted size, the second one records the compacting copy.
+        std::vector<daxa::BlasCompaction> compactions = {};
+        for (u32 batch = 0; batch < 4 && (builder.pending_build_count() != 0 || builder.pending_compaction_count() != 0); ++batch)
+        {
+            auto recorder = context.device.create_command_recorder({.name = "blas compaction"});
+            builder.inc_timeline_value();
+            builder.record_builds(recorder);
+            context.device.submit_commands({
+                .command_lists = std::array{recorder.complete_current_commands()},
+                .signal_timeline_semaphores = std::array{std::pair{builder.timeline_semaphore(), builder.timeline_value()}},
+            });
+            context.device.wait_idle();
+            auto const taken = builder.take_compactions();
+            compactions.insert(compactions.end(), taken.begin(), taken.end());
+        }
+        if (builder.pending_compaction_count() != 0)
+        {
+            std::cout << "failed test \"blas_compaction\": the compaction did not finish" << std::endl;
+            exit(-1);
+        }
+        // Compaction is skipped when the driver reports no smaller size.
+        if (compactions.empty())
+        {
+            std::cout << "blas compaction skipped, the compacted size is not smaller than the blas" << std::endl;
+        }
+        else
+        {
+            if (compactions.size() != 1 || compactions[0].original != blas || context.device.is_blas_id_valid(blas) ||
+                context.device.info(compactions[0].compacted).value().size >= original_size)
+            {
+                std::cout << "failed test \"blas_compaction\": the compacted blas did not replace the original" << std::endl;
+                exit(-1);
+            }
+            blas = compactions[0].compacted;
+        }
+        if (!context.ray_query_hits(builder, blas))
+        {
+            std::cout << "failed test \"blas_compaction\": the ray missed the compacted blas" << std::endl;
+            exit(-1);
+        }
+        builder.destroy_blas(blas);
+    }
+
     void ray_query_triangle()
     {
         struct Camera
@@ -38,6 +292,7 @@ namespace tests
             daxa::PipelineManager pipeline_manager = {};
             // std::shared_ptr<daxa::ComputePipeline> comp_pipeline = {};
             std::shared_ptr<daxa::RayTracingPipeline> rt_pipeline = {};
+            std::optional<daxa::ShaderBindingTableBuilder> sbt = {};
             daxa::TlasId tlas = {};
             daxa::BlasId blas = {};
             daxa::BlasId proc_blas = {};
@@ -547,6 +802,16 @@ namespace tests
                     .name = "basic ray tracing pipeline",
                 };
                 rt_pipeline = pipeline_manager.add_ray_tracing_pipeline(ray_tracing_pipe_info).value();
+                // Records in order of the shader groups, instance i uses hit record i.
+                sbt.emplace(daxa::ShaderBindingTableBuilderInfo{
+                    .device = device,
+                    .pipeline = *rt_pipeline,
+                    .raygen = {.groups = {0, 1}},
+                    .miss = {.groups = {2, 3}},
+                    .hit = {.groups = {4, 5}},
+                    .callable = {.groups = {6, 7}},
+                    .name = "basic ray tracing sbt",
+                });
             }
 
             auto update() -> bool
@@ -556,7 +821,10 @@ namespace tests
                 if (auto * reload_err = daxa::get_if<daxa::PipelineReloadError>(&reload_result))
                     std::cout << reload_err->message << std::endl;
                 else if (daxa::get_if<daxa::PipelineReloadSuccess>(&reload_result))
+                {
                     std::cout << "reload success" << std::endl;
+                    sbt->set_pipeline(*rt_pipeline);
+                }
                 glfwPollEvents();
                 if (glfwWindowShouldClose(glfw_window_ptr) != 0)
                 {
@@ -654,6 +922,9 @@ namespace tests
                     .image_id = swapchain_image,
                 });
 
+                // Only uploads the table on the first frame and after shader reloads.
+                sbt->record_upload(recorder);
+
                 recorder.set_pipeline(*rt_pipeline);
 
                 recorder.push_constant(PushConstant{
@@ -670,6 +941,7 @@ namespace tests
                     .height = height,
                     .depth = 1,
                     .raygen_shader_binding_table_offset = raygen_shader_binding_table_offset,
+                    .shader_binding_table = sbt->table(),
                 });
 
 #if ACTIVATE_ATOMIC_FLOAT == 1      
@@ -773,6 +1045,8 @@ namespace tests
 auto main() -> int
 {
     // TODO(Raytracing): Add acceleration structure updates.
+    tests::acceleration_structure_builder();
+    tests::blas_compaction();
     tests::ray_query_triangle();
     return 0;
 }
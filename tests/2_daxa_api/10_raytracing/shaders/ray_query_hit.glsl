@@ -0,0 +1,23 @@
+#define DAXA_RAY_TRACING 1
+#extension GL_EXT_ray_query : enable
+#include <daxa/daxa.inl>
+
+#include "shared.inl"
+
+DAXA_DECL_PUSH_CONSTANT(RayQueryPush, p)
+
+// Casts a single ray from the origin along +z and writes 1 when it hits a triangle, 0 otherwise.
+layout(local_size_x = 1) in;
+void main()
+{
+    rayQueryEXT ray_query;
+    rayQueryInitializeEXT(
+        ray_query, daxa_accelerationStructureEXT(p.tlas),
+        gl_RayFlagsOpaqueEXT,
+        0xff, vec3(0, 0, 0), 0.0f, vec3(0, 0, 1), 100.0f);
+    while (rayQueryProceedEXT(ray_query))
+    {
+    }
+    bool hit = rayQueryGetIntersectionTypeEXT(ray_query, true) == gl_RayQueryCommittedIntersectionTriangleEXT;
+    deref(p.hit) = hit ? 1 : 0;
+}
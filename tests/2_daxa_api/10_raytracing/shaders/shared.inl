@@ -38,6 +38,12 @@ struct PushConstant
     daxa_BufferPtr(Aabbs) aabb_buffer;
 };
 
+struct RayQueryPush
+{
+    daxa_TlasId tlas;
+    daxa_RWBufferPtr(daxa_u32) hit;
+};
+
 struct rayLight
 {
     daxa_f32vec3 inHitPosition;
@@ -0,0 +1,79 @@
+#include <daxa/daxa.hpp>
+#include <daxa/utils/upscaling_common.hpp>
+#include <iostream>
+
+using namespace daxa::types;
+
+namespace tests
+{
+    auto dynamic_resolution() -> bool
+    {
+        daxa::DynamicResolutionController controller{daxa::DynamicResolutionInfo{
+            .max_render_size_x = 1920,
+            .max_render_size_y = 1080,
+            .min_scale = 0.5f,
+            .max_scale = 1.0f,
+            .target_gpu_time_ms = 10.0f,
+            .smoothing = 1.0f,
+            .max_scale_step = 0.05f,
+            .tolerance = 0.05f,
+            .size_granularity = 8,
+        }};
+        if (controller.render_size().x != 1920 || controller.render_size().y != 1080)
+        {
+            std::cout << "dynamic resolution must start at the max render size" << std::endl;
+            return false;
+        }
+
+        // Frames over budget lower the scale by at most one step per update, down to the min scale.
+        for (u32 frame = 0; frame < 100; ++frame)
+        {
+            f32 const previous_scale = controller.scale;
+            controller.update(40.0f);
+            if (controller.scale > previous_scale || previous_scale - controller.scale > controller.info.max_scale_step + 0.0001f)
+            {
+                std::cout << "dynamic resolution scale must decrease in bounded steps while over budget" << std::endl;
+                return false;
+            }
+            daxa_u32vec2 const size = controller.render_size();
+            if (size.x % 8 != 0 || size.y % 8 != 0 || size.x > 1920 || size.y > 1080)
+            {
+                std::cout << "render size " << size.x << "x" << size.y << " is not a multiple of the granularity within the max size" << std::endl;
+                return false;
+            }
+        }
+        if (controller.scale != 0.5f || controller.render_size().x != 960 || controller.render_size().y != 536)
+        {
+            std::cout << "dynamic resolution must settle at the min scale, got " << controller.scale << std::endl;
+            return false;
+        }
+
+        // Frame times within the tolerance keep the scale.
+        controller.update(10.2f);
+        if (controller.scale != 0.5f)
+        {
+            std::cout << "dynamic resolution scale changed within the tolerance" << std::endl;
+            return false;
+        }
+
+        // Frames under budget raise the scale back up to the max scale.
+        for (u32 frame = 0; frame < 100; ++frame)
+        {
+            controller.update(1.0f);
+        }
+        if (controller.scale != 1.0f || controller.render_size().x != 1920 || controller.render_size().y != 1080)
+        {
+            std::cout << "dynamic resolution must return to the max scale under budget, got " << controller.scale << std::endl;
+            return false;
+        }
+        return true;
+    }
+} // namespace tests
+
+auto main() -> int
+{
+    if (!tests::dynamic_resolution())
+    {
+        return -1;
+    }
+}
@@ -1,5 +1,9 @@
 #include <daxa/daxa.hpp>
+#include <daxa/resource_pool_view.hpp>
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <filesystem>
 
 namespace tests
 {
@@ -107,6 +111,129 @@ namespace tests
             exit(-1);
         }
     }
+    void descriptor_buffer_sro_creation(daxa::Instance & instance)
+    {
+        try
+        {
+            daxa::Device device;
+            try
+            {
+                device = instance.create_device_2(instance.choose_device({}, {.explicit_features = daxa::ExplicitFeatureFlagBits::DESCRIPTOR_BUFFER}));
+            }
+            catch (std::runtime_error error)
+            {
+                std::cout << "Test skipped. No present device supports descriptor buffers!" << std::endl;
+                return;
+            }
+
+            auto test_buffer = device.create_buffer(test_buffer_info);
+            auto test_image = device.create_image(test_image_info);
+            auto test_sampler = device.create_sampler({
+                .name = "test sampler",
+            });
+            device.destroy_sampler(test_sampler);
+            device.destroy_image(test_image);
+            device.destroy_buffer(test_buffer);
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"descriptor_buffer_sro_creation\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void bulk_sro_creation(daxa::Instance & instance)
+    {
+        // Compares single resource creation with the bulk creation functions, that batch slot allocation and descriptor writes.
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            u32 const resource_count = 2048;
+            std::vector<daxa::BufferInfo> buffer_infos(resource_count, test_buffer_info);
+            std::vector<daxa::ImageInfo> image_infos(resource_count, test_image_info);
+
+            auto const single_begin = std::chrono::high_resolution_clock::now();
+            std::vector<daxa::BufferId> single_buffers = {};
+            std::vector<daxa::ImageId> single_images = {};
+            for (u32 i = 0; i < resource_count; ++i)
+            {
+                single_buffers.push_back(device.create_buffer(buffer_infos[i]));
+                single_images.push_back(device.create_image(image_infos[i]));
+            }
+            auto const single_time = std::chrono::high_resolution_clock::now() - single_begin;
+
+            auto const bulk_begin = std::chrono::high_resolution_clock::now();
+            auto bulk_buffers = device.create_buffers(buffer_infos);
+            auto bulk_images = device.create_images(image_infos);
+            auto const bulk_time = std::chrono::high_resolution_clock::now() - bulk_begin;
+
+            std::vector<daxa::ImageViewInfo> image_view_infos = {};
+            for (auto image : bulk_images)
+            {
+                image_view_infos.push_back({
+                    .type = daxa::ImageViewType::REGULAR_2D_ARRAY,
+                    .image = image,
+                    .name = "test image view",
+                });
+            }
+            auto bulk_image_views = device.create_image_views(image_view_infos);
+
+            for (u32 i = 0; i < resource_count; ++i)
+            {
+                if (!device.is_id_valid(bulk_buffers[i]) || !device.is_id_valid(bulk_images[i]) || !device.is_id_valid(bulk_image_views[i]))
+                {
+                    throw std::runtime_error("bulk created resource is invalid");
+                }
+                if (device.device_address(bulk_buffers[i]).value() == 0)
+                {
+                    throw std::runtime_error("bulk created buffer has no device address");
+                }
+            }
+
+            auto const single_destroy_begin = std::chrono::high_resolution_clock::now();
+            for (u32 i = 0; i < resource_count; ++i)
+            {
+                device.destroy_image(single_images[i]);
+                device.destroy_buffer(single_buffers[i]);
+            }
+            auto const single_destroy_time = std::chrono::high_resolution_clock::now() - single_destroy_begin;
+
+            device.destroy_image_views(bulk_image_views);
+            auto const bulk_destroy_begin = std::chrono::high_resolution_clock::now();
+            device.destroy_images(bulk_images);
+            device.destroy_buffers(bulk_buffers);
+            auto const bulk_destroy_time = std::chrono::high_resolution_clock::now() - bulk_destroy_begin;
+            for (u32 i = 0; i < resource_count; ++i)
+            {
+                if (device.is_id_valid(bulk_buffers[i]) || device.is_id_valid(bulk_images[i]) || device.is_id_valid(bulk_image_views[i]))
+                {
+                    throw std::runtime_error("bulk destroyed resource is still valid");
+                }
+            }
+            device.collect_garbage();
+
+            std::cout
+                << "creating "
+                << resource_count
+                << " buffers and images one by one took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(single_time).count()
+                << "us, in bulk "
+                << std::chrono::duration_cast<std::chrono::microseconds>(bulk_time).count()
+                << "us"
+                << std::endl;
+            std::cout
+                << "destroying them one by one took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(single_destroy_time).count()
+                << "us, in bulk "
+                << std::chrono::duration_cast<std::chrono::microseconds>(bulk_destroy_time).count()
+                << "us"
+                << std::endl;
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"bulk_sro_creation\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
     void sro_aliased_suballocation(daxa::Instance & instance)
     {
         try
@@ -139,6 +266,222 @@ namespace tests
             exit(-1);
         }
     }
+    void growable_sro_table(daxa::Instance & instance)
+    {
+        // The table starts out small and grows while resources are created, ids created before a growth must stay valid.
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            u32 const resource_count = 4096;
+            std::vector<daxa::BufferId> buffers = {};
+            std::vector<daxa::ImageId> images = {};
+            for (u32 i = 0; i < resource_count; ++i)
+            {
+                buffers.push_back(device.create_buffer(test_buffer_info));
+                images.push_back(device.create_image(test_image_info));
+            }
+            for (u32 i = 0; i < resource_count; ++i)
+            {
+                if (!device.is_id_valid(buffers[i]) || !device.is_id_valid(images[i]))
+                {
+                    std::cout << "failed test \"growable_sro_table\": id became invalid after growth" << std::endl;
+                    exit(-1);
+                }
+                device.destroy_buffer(buffers[i]);
+                device.destroy_image(images[i]);
+            }
+            // Retired descriptor pools are freed like zombies.
+            device.wait_idle();
+            device.collect_garbage();
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"growable_sro_table\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void memory_report(daxa::Instance & instance)
+    {
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            auto large_buffer = device.create_buffer({
+                .size = 1 << 24,
+                .name = "large buffer",
+            });
+            auto small_buffer = device.create_buffer(test_buffer_info);
+            auto const report = device.memory_report();
+            bool const has_heaps = report.heaps.size() > 0;
+            bool const counted_buffers = report.buffer_count >= 2 && report.buffer_bytes >= (1 << 24);
+            bool const largest_first = report.largest_allocations.size() > 0 && report.largest_allocations.at(0).name.view() == "large buffer";
+            device.destroy_buffer(small_buffer);
+            device.destroy_buffer(large_buffer);
+            if (!has_heaps || !counted_buffers || !largest_first)
+            {
+                std::cout << "failed test \"memory_report\": report does not match the live buffers" << std::endl;
+                exit(-1);
+            }
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"memory_report\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void host_cached_ranges(daxa::Instance & instance)
+    {
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            auto readback_buffer = device.create_buffer({
+                .size = sizeof(daxa::u32) * 256,
+                .allocate_info = daxa::MemoryFlagBits::HOST_CACHED,
+                .name = "host cached readback buffer",
+            });
+            auto * host_ptr = device.buffer_host_address_as<daxa::u32>(readback_buffer).value();
+            for (daxa::u32 i = 0; i < 256; ++i)
+            {
+                host_ptr[i] = i;
+            }
+            device.flush_ranges(std::array{daxa::BufferRange{.buffer = readback_buffer}});
+            device.invalidate_ranges(std::array{daxa::BufferRange{.buffer = readback_buffer, .offset = 0, .size = sizeof(daxa::u32) * 256}});
+            bool const values_kept = host_ptr[0] == 0 && host_ptr[255] == 255;
+            device.destroy_buffer(readback_buffer);
+            if (!values_kept)
+            {
+                std::cout << "failed test \"host_cached_ranges\": host writes were lost" << std::endl;
+                exit(-1);
+            }
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"host_cached_ranges\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void defragmentation(daxa::Instance & instance)
+    {
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            // Freeing every second buffer leaves holes that defragmentation can close.
+            std::vector<daxa::BufferId> buffers = {};
+            for (daxa::u32 i = 0; i < 64; ++i)
+            {
+                buffers.push_back(device.create_buffer({
+                    .size = 1 << 16,
+                    .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM | daxa::MemoryFlagBits::MOVABLE,
+                    .name = "movable buffer",
+                }));
+                *device.buffer_host_address_as<daxa::u32>(buffers.back()).value() = i;
+            }
+            for (daxa::u32 i = 0; i < 64; i += 2)
+            {
+                device.destroy_buffer(buffers[i]);
+            }
+            device.collect_garbage();
+
+            bool done = false;
+            while (!done)
+            {
+                auto recorder = device.create_command_recorder({});
+                [[maybe_unused]] auto const moved = device.begin_defragmentation_pass({.command_recorder = recorder});
+                auto exec_cmds = recorder.complete_current_commands();
+                device.submit_commands({.command_lists = std::array{exec_cmds}});
+                device.wait_idle();
+                done = device.end_defragmentation_pass();
+            }
+
+            for (daxa::u32 i = 1; i < 64; i += 2)
+            {
+                if (!device.is_buffer_id_valid(buffers[i]) || *device.buffer_host_address_as<daxa::u32>(buffers[i]).value() != i)
+                {
+                    std::cout << "failed test \"defragmentation\": moved buffer lost its id or contents" << std::endl;
+                    exit(-1);
+                }
+                device.destroy_buffer(buffers[i]);
+            }
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"defragmentation\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void sparse_binding(daxa::Instance & instance)
+    {
+        try
+        {
+            daxa::Device device;
+            try
+            {
+                device = instance.create_device_2(instance.choose_device(daxa::ImplicitFeatureFlagBits::SPARSE_BINDING, {}));
+            }
+            catch (std::runtime_error error)
+            {
+                std::cout << "Test skipped. No present device supports sparse binding!" << std::endl;
+                return;
+            }
+
+            daxa::BufferInfo const sparse_buffer_info = {.size = 1 << 26, .name = "sparse buffer"};
+            auto const buffer_requirements = device.sparse_buffer_memory_requirements(sparse_buffer_info);
+            auto sparse_buffer = device.create_sparse_buffer(sparse_buffer_info);
+
+            daxa::ImageInfo const sparse_image_info = {
+                .flags = daxa::ImageCreateFlagBits::SPARSE_BINDING | daxa::ImageCreateFlagBits::SPARSE_RESIDENCY,
+                .format = daxa::Format::R8G8B8A8_UNORM,
+                .size = {4096, 4096, 1},
+                .usage = daxa::ImageUsageFlagBits::SHADER_SAMPLED | daxa::ImageUsageFlagBits::TRANSFER_DST,
+                .name = "sparse image",
+            };
+            auto const image_requirements = device.image_memory_requirements(sparse_image_info);
+            auto const sparse_requirements = device.sparse_image_memory_requirements(sparse_image_info);
+            auto sparse_image = device.create_image(sparse_image_info);
+
+            // One page each backs the first page of the buffer and the first tile of the image.
+            auto buffer_page = device.create_memory({
+                .requirements = {
+                    .size = buffer_requirements.alignment,
+                    .alignment = buffer_requirements.alignment,
+                    .memory_type_bits = buffer_requirements.memory_type_bits,
+                },
+            });
+            auto image_page = device.create_memory({
+                .requirements = {
+                    .size = image_requirements.alignment,
+                    .alignment = image_requirements.alignment,
+                    .memory_type_bits = image_requirements.memory_type_bits,
+                },
+            });
+            device.bind_sparse({
+                .buffer_binds = std::array{daxa::SparseBufferBind{
+                    .buffer = sparse_buffer,
+                    .size = buffer_requirements.alignment,
+                    .memory_block = buffer_page,
+                }},
+                .image_binds = std::array{daxa::SparseImageBind{
+                    .image = sparse_image,
+                    .extent = sparse_requirements.image_granularity,
+                    .memory_block = image_page,
+                }},
+            });
+            device.wait_idle();
+
+            bool const has_address = device.buffer_device_address(sparse_buffer).value() != 0;
+            device.destroy_image(sparse_image);
+            device.destroy_buffer(sparse_buffer);
+            if (!has_address)
+            {
+                std::cout << "failed test \"sparse_binding\": sparse buffer has no device address" << std::endl;
+                exit(-1);
+            }
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"sparse_binding\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
     void acceleration_structure_creation(daxa::Instance & instance)
     {
         try
@@ -165,15 +508,613 @@ namespace tests
             exit(-1);
         }
     }
+    void cooperative_matrix_properties(daxa::Instance & instance)
+    {
+        try
+        {
+            daxa::Device device;
+            try
+            {
+                device = instance.create_device_2(instance.choose_device({}, {.explicit_features = daxa::ExplicitFeatureFlagBits::COOPERATIVE_MATRIX}));
+            }
+            catch (std::runtime_error error)
+            {
+                std::cout << "Test skipped. No present device supports cooperative matrices!" << std::endl;
+                return;
+            }
+
+            auto const & properties = device.properties().cooperative_matrix_properties;
+            if (!properties.has_value() || properties.value().shape_count == 0)
+            {
+                throw std::runtime_error("device with cooperative matrices reports no shapes");
+            }
+            for (daxa::u32 i = 0; i < properties.value().shape_count; ++i)
+            {
+                auto const & shape = properties.value().shapes[i];
+                std::cout << "cooperative matrix " << shape.m_size << "x" << shape.n_size << "x" << shape.k_size
+                          << " a " << static_cast<daxa::u32>(shape.a_type) << " b " << static_cast<daxa::u32>(shape.b_type)
+                          << " c " << static_cast<daxa::u32>(shape.c_type) << " result " << static_cast<daxa::u32>(shape.result_type) << std::endl;
+            }
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"cooperative_matrix_properties\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void device_group_masks(daxa::Instance & instance)
+    {
+        // TEST:
+        //    1) Create a device spanning its device group, a single gpu is a group of one
+        //    2) Give every device of the group a copy into a buffer bound to the memory of device 0
+        //    3) Masks selecting devices outside of the group are rejected
+        try
+        {
+            auto info = instance.choose_device({}, {});
+            info.device_group = true;
+            auto device = instance.create_device_2(info);
+            daxa::u32 const group_size = device.properties().device_group_size;
+            std::cout << "device group size: " << group_size << std::endl;
+
+            auto src_buffer = device.create_buffer({.size = sizeof(daxa::u32) * 4, .name = "device group src"});
+            auto dst_memory = device.create_memory({.requirements = device.buffer_memory_requirements({.size = sizeof(daxa::u32) * 4})});
+            auto dst_buffer = device.create_buffer_from_memory_block({
+                .buffer_info = {.size = sizeof(daxa::u32) * 4, .name = "device group peer dst"},
+                .memory_block = dst_memory,
+                .peer_device_index = 0u,
+            });
+
+            auto recorder = device.create_command_recorder({});
+            for (daxa::u32 device_i = 0; device_i < group_size; ++device_i)
+            {
+                recorder.set_device_mask(1u << device_i);
+                recorder.copy_buffer_to_buffer({.src_buffer = src_buffer, .dst_buffer = dst_buffer, .size = sizeof(daxa::u32)});
+            }
+            recorder.set_device_mask(0);
+            bool rejected_invalid_mask = false;
+            try
+            {
+                recorder.set_device_mask(1u << group_size);
+            }
+            catch (std::runtime_error const &)
+            {
+                rejected_invalid_mask = true;
+            }
+            if (!rejected_invalid_mask)
+            {
+                throw std::runtime_error("device mask outside of the device group was accepted");
+            }
+            auto exec_cmds = recorder.complete_current_commands();
+            device.submit_commands({.command_lists = std::array{exec_cmds}, .device_mask = (1u << group_size) - 1u});
+            device.wait_idle();
+
+            device.destroy_buffer(dst_buffer);
+            device.destroy_buffer(src_buffer);
+            device.collect_garbage();
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"device_group_masks\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+
+    void external_memory(daxa::Instance & instance)
+    {
+        // TEST:
+        //    1) Export the memory of a buffer and a timeline semaphore
+        //    2) Import both handles again, as another api would
+        //    3) The imported semaphore shares the payload of the exported one
+        try
+        {
+            daxa::Device device;
+            try
+            {
+                device = instance.create_device_2(instance.choose_device(daxa::ImplicitFeatureFlagBits::EXTERNAL_MEMORY, {}));
+            }
+            catch (std::runtime_error error)
+            {
+                std::cout << "Test skipped. No present device supports external memory!" << std::endl;
+                return;
+            }
+#if defined(_WIN32)
+            auto const memory_handle_type = daxa::ExternalMemoryHandleType::OPAQUE_WIN32;
+            auto const semaphore_handle_type = daxa::ExternalSemaphoreHandleType::OPAQUE_WIN32;
+#else
+            auto const memory_handle_type = daxa::ExternalMemoryHandleType::OPAQUE_FD;
+            auto const semaphore_handle_type = daxa::ExternalSemaphoreHandleType::OPAQUE_FD;
+#endif
+            auto exported_buffer = device.create_buffer({
+                .size = 1024,
+                .name = "exported buffer",
+                .external_memory = {.handle_type = memory_handle_type},
+            });
+            auto imported_buffer = device.create_buffer({
+                .size = 1024,
+                .name = "imported buffer",
+                .external_memory = {.handle_type = memory_handle_type, .import_handle = device.export_memory(exported_buffer)},
+            });
+            bool rejected_export_of_import = false;
+            try
+            {
+                [[maybe_unused]] auto handle = device.export_memory(imported_buffer);
+            }
+            catch (std::runtime_error const &)
+            {
+                rejected_export_of_import = true;
+            }
+            if (!rejected_export_of_import)
+            {
+                throw std::runtime_error("exporting imported memory was accepted");
+            }
+
+            auto exported_semaphore = device.create_timeline_semaphore({
+                .name = "exported semaphore",
+                .external_semaphore = {.handle_type = semaphore_handle_type},
+            });
+            auto imported_semaphore = device.create_timeline_semaphore({
+                .name = "imported semaphore",
+                .external_semaphore = {.handle_type = semaphore_handle_type, .import_handle = exported_semaphore.export_handle()},
+            });
+            exported_semaphore.set_value(7);
+            if (imported_semaphore.value() != 7)
+            {
+                throw std::runtime_error("imported semaphore does not share the payload of the exported semaphore");
+            }
+
+            device.destroy_buffer(imported_buffer);
+            device.destroy_buffer(exported_buffer);
+            device.collect_garbage();
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"external_memory\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void capture_replay(daxa::Instance & instance)
+    {
+        // TEST:
+        //    1) Capture a clear and a copy between two buffers
+        //    2) Replay the capture on a second device, which recreates both buffers with their captured ids
+        //    3) Devices created without capturable reject captures
+        try
+        {
+            auto const capture_path = (std::filesystem::temp_directory_path() / "daxa_test_capture.bin").string();
+            {
+                auto device = instance.create_device_2(instance.choose_device({}, {.name = "capture device", .capturable = true}));
+                auto src_buffer = device.create_buffer({.size = 1024, .name = "capture src buffer"});
+                auto dst_buffer = device.create_buffer({
+                    .size = 1024,
+                    .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                    .name = "capture dst buffer",
+                });
+                device.begin_capture({.path = capture_path.c_str(), .capture_buffer_contents = true});
+                auto recorder = device.create_command_recorder({});
+                recorder.clear_buffer({.buffer = src_buffer, .size = 1024, .clear_value = 7});
+                recorder.pipeline_barrier({.src_access = daxa::AccessConsts::TRANSFER_WRITE, .dst_access = daxa::AccessConsts::TRANSFER_READ});
+                recorder.copy_buffer_to_buffer({.src_buffer = src_buffer, .dst_buffer = dst_buffer, .size = 1024});
+                auto exec_cmds = recorder.complete_current_commands();
+                device.submit_commands({.command_lists = std::array{exec_cmds}});
+                device.end_capture();
+                device.wait_idle();
+                device.destroy_buffer(src_buffer);
+                device.destroy_buffer(dst_buffer);
+                device.collect_garbage();
+            }
+            {
+                auto device = instance.create_device_2(instance.choose_device({}, {.name = "replay device", .capturable = true}));
+                auto const stats = device.replay_capture({.path = capture_path.c_str(), .repeat_count = 3});
+                if (stats.buffer_count != 2 || stats.failed_creation_count != 0)
+                {
+                    throw std::runtime_error("replay did not recreate the captured buffers");
+                }
+                if (stats.submit_count != 1 || stats.command_list_count != 1 || stats.command_count != 3 || stats.skipped_command_count != 0)
+                {
+                    throw std::runtime_error("replay did not record the captured commands");
+                }
+                if (stats.min_ns > stats.mean_ns || stats.mean_ns > stats.max_ns)
+                {
+                    throw std::runtime_error("replay timings are inconsistent");
+                }
+                device.collect_garbage();
+            }
+            {
+                auto device = instance.create_device_2(instance.choose_device({}, {.name = "non capturable device"}));
+                bool rejected_capture = false;
+                try
+                {
+                    device.begin_capture({.path = capture_path.c_str()});
+                }
+                catch (std::runtime_error const &)
+                {
+                    rejected_capture = true;
+                }
+                if (!rejected_capture)
+                {
+                    throw std::runtime_error("capture on a device without capturable was accepted");
+                }
+            }
+            std::filesystem::remove(capture_path);
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"capture_replay\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void video_queues(daxa::Instance & instance)
+    {
+        // TEST:
+        //    1) Create a device with video queues
+        //    2) Bitstream buffers are usable by video commands of any profile
+        //    3) Sessions without a codec operation are rejected
+        //    4) Reset a session on each video queue
+        try
+        {
+            daxa::Device device;
+            try
+            {
+                device = instance.create_device_2(instance.choose_device(daxa::ImplicitFeatureFlagBits::VIDEO, {}));
+            }
+            catch (std::runtime_error error)
+            {
+                std::cout << "Test skipped. No present device supports video queues!" << std::endl;
+                return;
+            }
+            auto const & properties = device.properties();
+            std::cout << "video decode queues: " << properties.video_decode_queue_count << ", video encode queues: " << properties.video_encode_queue_count << std::endl;
+            if (properties.video_decode_queue_count == 0 && properties.video_encode_queue_count == 0)
+            {
+                throw std::runtime_error("video feature without a video queue");
+            }
+            auto bitstream_buffer = device.create_buffer({
+                .size = 1024 * 1024,
+                .name = "bitstream buffer",
+                .video_bitstream = true,
+            });
+            bool rejected_session = false;
+            try
+            {
+                [[maybe_unused]] auto session = device.create_video_session({.name = "invalid session"});
+            }
+            catch (std::runtime_error const &)
+            {
+                rejected_session = true;
+            }
+            if (!rejected_session)
+            {
+                throw std::runtime_error("video session without a codec operation was accepted");
+            }
+            auto reset_session = [&](daxa::VideoCodecOperation codec_operation, daxa::QueueFamily queue_family, daxa::Queue queue)
+            {
+                daxa::VideoSession session;
+                try
+                {
+                    // StdVideoH264ProfileIdc main profile.
+                    session = device.create_video_session({
+                        .profile = {.codec_operation = codec_operation, .std_profile_idc = 77},
+                        .max_coded_extent = {128, 128},
+                        .max_dpb_slots = 1,
+                        .name = "reset session",
+                    });
+                }
+                catch (std::runtime_error const &)
+                {
+                    std::cout << "skipped " << daxa::to_string(queue_family) << " session, h264 main profile is not supported" << std::endl;
+                    return;
+                }
+                auto recorder = device.create_transfer_command_recorder({.queue_family = queue_family, .name = "video recorder"});
+                recorder.begin_video_coding({.session = session});
+                recorder.control_video_coding({.flags = daxa::VideoCodingControlFlagBits::RESET});
+                recorder.end_video_coding();
+                auto exec_cmds = recorder.complete_current_commands();
+                device.submit_commands({.queue = queue, .command_lists = std::array{exec_cmds}});
+                device.queue_wait_idle(queue);
+            };
+            if (properties.video_decode_queue_count > 0)
+            {
+                reset_session(daxa::VideoCodecOperation::DECODE_H264, daxa::QueueFamily::VIDEO_DECODE, daxa::QUEUE_VIDEO_DECODE_0);
+            }
+            if (properties.video_encode_queue_count > 0)
+            {
+                reset_session(daxa::VideoCodecOperation::ENCODE_H264, daxa::QueueFamily::VIDEO_ENCODE, daxa::QUEUE_VIDEO_ENCODE_0);
+            }
+            device.destroy_buffer(bitstream_buffer);
+            device.collect_garbage();
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"video_queues\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+
+    void incremental_garbage_collection(daxa::Instance & instance)
+    {
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            for (u32 i = 0; i < 16; ++i)
+            {
+                device.destroy_buffer(device.create_buffer(test_buffer_info));
+            }
+            device.wait_idle();
+
+            // With a budget of a few zombies per call, the 16 destroyed buffers take multiple calls to be collected.
+            u32 calls = 0;
+            while (!device.collect_garbage_incremental({.max_destroyed_zombies = 4, .non_blocking = true}))
+            {
+                ++calls;
+                if (calls > 16)
+                {
+                    std::cout << "failed test \"incremental_garbage_collection\": budgeted collection never finished" << std::endl;
+                    exit(-1);
+                }
+            }
+            if (calls == 0)
+            {
+                std::cout << "failed test \"incremental_garbage_collection\": budget was ignored" << std::endl;
+                exit(-1);
+            }
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"incremental_garbage_collection\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void background_garbage_collection(daxa::Instance & instance)
+    {
+        // Zombies are collected by the device thread once their submit retired, without any collect_garbage call.
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {.background_garbage_collection = true}));
+            u32 const live_buffer_count = device.memory_report().buffer_count;
+            for (u32 i = 0; i < 16; ++i)
+            {
+                device.destroy_buffer(device.create_buffer(test_buffer_info));
+            }
+            {
+                auto recorder = device.create_command_recorder({});
+                auto exec_cmds = recorder.complete_current_commands();
+                device.submit_commands({.command_lists = std::array{exec_cmds}});
+            }
+            device.wait_idle();
+
+            auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while (device.memory_report().buffer_count != live_buffer_count)
+            {
+                if (std::chrono::steady_clock::now() > deadline)
+                {
+                    std::cout << "failed test \"background_garbage_collection\": zombies were not collected" << std::endl;
+                    exit(-1);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"background_garbage_collection\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void pipeline_cache_persistence(daxa::Instance & instance)
+    {
+        try
+        {
+            auto const cache_directory = std::filesystem::temp_directory_path() / "daxa_test_pipeline_cache";
+            std::filesystem::remove_all(cache_directory);
+            auto const directory_string = cache_directory.string();
+            {
+                auto device = instance.create_device_2(instance.choose_device({}, {.pipeline_cache_directory = directory_string.c_str()}));
+                device.save_pipeline_cache();
+            }
+            if (std::filesystem::is_empty(cache_directory))
+            {
+                std::cout << "failed test \"pipeline_cache_persistence\": no cache file was written" << std::endl;
+                exit(-1);
+            }
+            // The second device loads the file written above.
+            {
+                auto device = instance.create_device_2(instance.choose_device({}, {.pipeline_cache_directory = directory_string.c_str()}));
+            }
+            std::filesystem::remove_all(cache_directory);
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"pipeline_cache_persistence\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void parallel_sro_recreation_perf(daxa::Instance & instance)
+    {
+        // Measures resource slot allocation under contention.
+        // Multiple threads create and destroy buffers in parallel, between rounds the garbage is collected so that slots get recycled.
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            u32 const thread_count = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+            u32 const rounds = 32;
+            u32 const buffers_per_round = 256;
+
+            std::chrono::nanoseconds total_time = {};
+            for (u32 round = 0; round < rounds; ++round)
+            {
+                std::vector<std::thread> threads = {};
+                auto const begin = std::chrono::high_resolution_clock::now();
+                for (u32 thread_i = 0; thread_i < thread_count; ++thread_i)
+                {
+                    threads.emplace_back([&]()
+                                         {
+                                             for (u32 i = 0; i < buffers_per_round; ++i)
+                                             {
+                                                 device.destroy_buffer(device.create_buffer(test_buffer_info));
+                                             } });
+                }
+                for (auto & thread : threads)
+                {
+                    thread.join();
+                }
+                total_time += std::chrono::high_resolution_clock::now() - begin;
+                device.collect_garbage();
+            }
+            auto const total_recreations = rounds * thread_count * buffers_per_round;
+            std::cout
+                << "parallel buffer recreation on "
+                << thread_count
+                << " threads took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(total_time).count()
+                << "us for "
+                << total_recreations
+                << " recreations. That is "
+                << static_cast<double>(total_time.count()) / static_cast<double>(total_recreations)
+                << "ns per recreation"
+                << std::endl;
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"parallel_sro_recreation_perf\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void hot_slot_lookup_perf(daxa::Instance & instance)
+    {
+        // Measures the id validation and device address lookups that run on submit and per draw paths.
+        // These only touch the versions and hot slot data of the resource pool.
+        try
+        {
+            auto device = instance.create_device_2(instance.choose_device({}, {}));
+            u32 const buffer_count = 4096;
+            u32 const iterations = 64;
+            std::vector<daxa::BufferId> buffers = {};
+            buffers.reserve(buffer_count);
+            for (u32 i = 0; i < buffer_count; ++i)
+            {
+                buffers.push_back(device.create_buffer(test_buffer_info));
+            }
+
+            u64 address_sum = 0;
+            u32 valid_count = 0;
+            auto const begin = std::chrono::high_resolution_clock::now();
+            for (u32 iteration = 0; iteration < iterations; ++iteration)
+            {
+                for (auto id : buffers)
+                {
+                    valid_count += device.is_id_valid(id) ? 1u : 0u;
+                    address_sum += device.device_address(id).value();
+                }
+            }
+            auto const total_time = std::chrono::high_resolution_clock::now() - begin;
+
+            // Same lookups through the header only view, without a call into daxa per lookup.
+            auto const view = daxa::BufferPoolView{device};
+            u64 view_address_sum = 0;
+            u32 view_valid_count = 0;
+            auto const view_begin = std::chrono::high_resolution_clock::now();
+            for (u32 iteration = 0; iteration < iterations; ++iteration)
+            {
+                for (auto id : buffers)
+                {
+                    view_valid_count += view.is_valid(id) ? 1u : 0u;
+                    view_address_sum += view.device_address(id).value();
+                }
+            }
+            auto const view_total_time = std::chrono::high_resolution_clock::now() - view_begin;
+            for (auto id : buffers)
+            {
+                device.destroy_buffer(id);
+            }
+            if (valid_count != buffer_count * iterations || address_sum == 0)
+            {
+                throw std::runtime_error("buffer lookups returned invalid results");
+            }
+            if (view_valid_count != valid_count || view_address_sum != address_sum)
+            {
+                throw std::runtime_error("buffer pool view lookups differ from device lookups");
+            }
+            if (view.is_valid(buffers.front()) || view.device_address(buffers.front()).has_value())
+            {
+                throw std::runtime_error("buffer pool view must reject destroyed buffers");
+            }
+            auto const total_lookups = buffer_count * iterations;
+            std::cout
+                << "buffer id validation and device address lookup took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(total_time).count()
+                << "us for "
+                << total_lookups
+                << " lookups. That is "
+                << static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(total_time).count()) / static_cast<double>(total_lookups)
+                << "ns per lookup, through the buffer pool view "
+                << static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(view_total_time).count()) / static_cast<double>(total_lookups)
+                << "ns per lookup"
+                << std::endl;
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"hot_slot_lookup_perf\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
+    void startup_time_perf()
+    {
+        // Measures how long headless tools wait before they can record work.
+        // Physical devices are probed once per instance, every further device only pays for its own creation.
+        try
+        {
+            u32 const device_count = 8;
+            auto const instance_begin = std::chrono::high_resolution_clock::now();
+            auto instance = daxa::create_instance({});
+            auto const instance_time = std::chrono::high_resolution_clock::now() - instance_begin;
+
+            std::chrono::nanoseconds devices_time = {};
+            for (u32 i = 0; i < device_count; ++i)
+            {
+                auto const begin = std::chrono::high_resolution_clock::now();
+                auto device = instance.create_device_2(instance.choose_device({}, {.name = "startup time device"}));
+                devices_time += std::chrono::high_resolution_clock::now() - begin;
+            }
+            std::cout
+                << "instance creation took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(instance_time).count()
+                << "us, device creation took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(devices_time).count() / device_count
+                << "us per device"
+                << std::endl;
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "failed test \"startup_time_perf\": " << error.what() << std::endl;
+            exit(-1);
+        }
+    }
 } // namespace tests
 
 auto main() -> int
 {
+    tests::startup_time_perf();
     auto instance = daxa::create_instance({});
     tests::simplest(instance);
     tests::device_selection(instance);
     tests::sro_creation(instance);
+    tests::descriptor_buffer_sro_creation(instance);
+    tests::bulk_sro_creation(instance);
     tests::sro_aliased_suballocation(instance);
+    tests::growable_sro_table(instance);
+    tests::memory_report(instance);
+    tests::host_cached_ranges(instance);
+    tests::defragmentation(instance);
+    tests::sparse_binding(instance);
     tests::acceleration_structure_creation(instance);
+    tests::cooperative_matrix_properties(instance);
+    tests::device_group_masks(instance);
+    tests::external_memory(instance);
+    tests::video_queues(instance);
+    tests::capture_replay(instance);
+    tests::incremental_garbage_collection(instance);
+    tests::background_garbage_collection(instance);
+    tests::pipeline_cache_persistence(instance);
+    tests::parallel_sro_recreation_perf(instance);
+    tests::hot_slot_lookup_perf(instance);
     std::cout << "completed all tests successfully!" << std::endl;
 }
@@ -1,6 +1,10 @@
 #include <daxa/daxa.hpp>
 #include <iostream>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
 #include <chrono>
+#include <thread>
 #include <fmt/format.h>
 #include "../../0_common/shared.hpp"
 
@@ -456,6 +460,109 @@ namespace tests
         }
     }
 
+    void submit_perf(App & app)
+    {
+        // Measures the cpu cost of daxa's submit path.
+        // The command lists are recorded up front so that only the submits themselves are timed.
+        int const batches = 16;
+        int const submits_per_batch = 64;
+
+        auto timeline = app.device.create_timeline_semaphore({.name = "submit perf timeline"});
+        u64 timeline_value = 0;
+
+        std::chrono::microseconds total_time_taken_mics = {};
+        for (int batch_i = 0; batch_i < batches; ++batch_i)
+        {
+            std::vector<daxa::ExecutableCommandList> executable_commands = {};
+            {
+                auto recorder = app.device.create_command_recorder({.name = "submit perf recorder"});
+                for (int i = 0; i < submits_per_batch; ++i)
+                {
+                    executable_commands.push_back(recorder.complete_current_commands());
+                }
+            }
+
+            std::chrono::time_point begin_time_point = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < submits_per_batch; ++i)
+            {
+                app.device.submit_commands({
+                    .command_lists = std::array{executable_commands[static_cast<usize>(i)]},
+                    .wait_timeline_semaphores = std::array{std::pair{timeline, timeline_value}},
+                    .signal_timeline_semaphores = std::array{std::pair{timeline, timeline_value + 1}},
+                });
+                timeline_value += 1;
+            }
+            std::chrono::time_point end_time_point = std::chrono::high_resolution_clock::now();
+            total_time_taken_mics += std::chrono::duration_cast<std::chrono::microseconds>(end_time_point - begin_time_point);
+
+            executable_commands.clear();
+            app.device.wait_idle();
+            app.device.collect_garbage();
+        }
+
+        auto const total_submits = batches * submits_per_batch;
+        std::cout
+            << "submitting "
+            << total_submits
+            << " command lists took: "
+            << total_time_taken_mics.count()
+            << "us. That is "
+            << static_cast<double>(total_time_taken_mics.count()) / static_cast<double>(total_submits)
+            << "us per submit"
+            << std::endl;
+    }
+
+    void recording_perf(App & app)
+    {
+        // Measures the cpu cost of recording commands that reference resources.
+        // Command lists are destroyed after every batch, so after the first batch their id tracking storage is recycled.
+        int const batches = 16;
+        int const lists_per_batch = 64;
+        int const copies_per_list = 256;
+
+        daxa::BufferId src = app.device.create_buffer({.size = 256, .name = "recording perf src"});
+        daxa::BufferId dst = app.device.create_buffer({.size = 256, .name = "recording perf dst"});
+
+        std::chrono::microseconds total_time_taken_mics = {};
+        for (int batch_i = 0; batch_i < batches; ++batch_i)
+        {
+            std::vector<daxa::ExecutableCommandList> executable_commands = {};
+            executable_commands.reserve(static_cast<usize>(lists_per_batch));
+            {
+                auto recorder = app.device.create_command_recorder({.name = "recording perf recorder"});
+                std::chrono::time_point begin_time_point = std::chrono::high_resolution_clock::now();
+                for (int list_i = 0; list_i < lists_per_batch; ++list_i)
+                {
+                    for (int copy_i = 0; copy_i < copies_per_list; ++copy_i)
+                    {
+                        recorder.copy_buffer_to_buffer({.src_buffer = src, .dst_buffer = dst, .size = 4});
+                    }
+                    executable_commands.push_back(recorder.complete_current_commands());
+                }
+                std::chrono::time_point end_time_point = std::chrono::high_resolution_clock::now();
+                total_time_taken_mics += std::chrono::duration_cast<std::chrono::microseconds>(end_time_point - begin_time_point);
+            }
+            executable_commands.clear();
+            app.device.collect_garbage();
+        }
+
+        app.device.destroy_buffer(dst);
+        app.device.destroy_buffer(src);
+
+        auto const total_lists = batches * lists_per_batch;
+        std::cout
+            << "recording "
+            << total_lists
+            << " command lists with "
+            << copies_per_list
+            << " copies each took: "
+            << total_time_taken_mics.count()
+            << "us. That is "
+            << static_cast<double>(total_time_taken_mics.count()) / static_cast<double>(total_lists)
+            << "us per command list"
+            << std::endl;
+    }
+
     void multiple_ecl(App & app)
     {
         daxa::BufferId buf_a = app.device.create_buffer({.size = 4, .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE, .name = "buf_a"});
@@ -508,6 +615,290 @@ namespace tests
         app.device.destroy_buffer(buf_b);
         app.device.destroy_buffer(buf_a);
     }
+    void unvalidated_ecl(App & app)
+    {
+        daxa::BufferId src = app.device.create_buffer({.size = 4, .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE, .name = "src"});
+        daxa::BufferId dst = app.device.create_buffer({.size = 4, .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM, .name = "dst"});
+
+        constexpr daxa::u32 TEST_VALUE = 0x5eed5eed;
+
+        *app.device.buffer_host_address_as<daxa::u32>(src).value() = TEST_VALUE;
+
+        // The used ids are not remembered, the submit skips checking them.
+        daxa::CommandRecorder cmdr = app.device.create_command_recorder({.name = "unvalidated commands", .disable_submit_id_validation = true});
+        cmdr.copy_buffer_to_buffer({
+            .src_buffer = src,
+            .dst_buffer = dst,
+            .size = 4,
+        });
+        daxa::ExecutableCommandList commands = cmdr.complete_current_commands();
+        app.device.submit_commands({.command_lists = std::array{commands}});
+        app.device.wait_idle();
+
+        [[maybe_unused]] daxa::u32 const readback_value = *app.device.buffer_host_address_as<daxa::u32>(dst).value();
+        DAXA_DBG_ASSERT_TRUE_M(readback_value == TEST_VALUE, "UNVALIDATED COMMANDS DID NOT EXECUTE");
+
+        app.device.destroy_buffer(dst);
+        app.device.destroy_buffer(src);
+    }
+    void reusable_ecl(App & app)
+    {
+        daxa::BufferId counter = app.device.create_buffer({.size = 4, .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM, .name = "counter"});
+        daxa::BufferId increment = app.device.create_buffer({.size = 4, .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE, .name = "increment"});
+        *app.device.buffer_host_address_as<daxa::u32>(counter).value() = 0;
+        *app.device.buffer_host_address_as<daxa::u32>(increment).value() = 7;
+
+        // Recorded once, the same command list is submitted every "frame".
+        daxa::CommandRecorder cmdr = app.device.create_command_recorder({.name = "static commands", .reusable = true});
+        cmdr.copy_buffer_to_buffer({
+            .src_buffer = increment,
+            .dst_buffer = counter,
+            .size = 4,
+        });
+        daxa::ExecutableCommandList static_commands = cmdr.complete_current_commands();
+
+        constexpr daxa::u32 SUBMIT_COUNT = 3;
+        for (daxa::u32 i = 0; i < SUBMIT_COUNT; ++i)
+        {
+            app.device.submit_commands({.command_lists = std::array{static_commands}});
+        }
+        app.device.wait_idle();
+
+        [[maybe_unused]] daxa::u32 const readback_value = *app.device.buffer_host_address_as<daxa::u32>(counter).value();
+        DAXA_DBG_ASSERT_TRUE_M(readback_value == 7, "REUSED COMMANDS DID NOT EXECUTE");
+
+        app.device.destroy_buffer(increment);
+        app.device.destroy_buffer(counter);
+    }
+    void secondary_command_lists(App & app)
+    {
+        daxa::ImageId render_target = app.device.create_image({
+            .format = daxa::Format::R8G8B8A8_UNORM,
+            .size = {64, 64, 1},
+            .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT,
+            .name = "secondary render target",
+        });
+
+        daxa::CommandRecorder cmdr = app.device.create_command_recorder({.name = "primary"});
+        cmdr.pipeline_barrier_image_transition({
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_layout = daxa::ImageLayout::ATTACHMENT_OPTIMAL,
+            .image_id = render_target,
+        });
+        daxa::RenderCommandRecorder render_cmdr = std::move(cmdr).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{
+                .image_view = render_target.default_view(),
+                .load_op = daxa::AttachmentLoadOp::CLEAR,
+                .clear_value = std::array<daxa::f32, 4>{0.0f, 0.0f, 0.0f, 1.0f},
+            }},
+            .render_area = {.width = 64, .height = 64},
+            .secondary_command_lists = true,
+        });
+
+        // Secondary recorders are created on the thread owning the renderpass and then record independently.
+        constexpr daxa::u32 WORKER_COUNT = 4;
+        std::vector<daxa::SecondaryRenderCommandRecorder> secondary_cmdrs = {};
+        for (daxa::u32 i = 0; i < WORKER_COUNT; ++i)
+        {
+            secondary_cmdrs.push_back(render_cmdr.create_secondary_recorder({.name = "secondary"}));
+        }
+        std::vector<daxa::ExecutableCommandList> secondary_commands(WORKER_COUNT);
+        std::vector<std::thread> workers = {};
+        for (daxa::u32 i = 0; i < WORKER_COUNT; ++i)
+        {
+            workers.emplace_back([&, i]()
+                                 {
+                                     secondary_cmdrs[i].set_scissor({.x = static_cast<daxa::i32>(i * 16), .width = 16, .height = 64});
+                                     secondary_commands[i] = secondary_cmdrs[i].complete_current_commands(); });
+        }
+        for (auto & worker : workers)
+        {
+            worker.join();
+        }
+        render_cmdr.execute_commands(secondary_commands);
+        cmdr = std::move(render_cmdr).end_renderpass();
+        auto primary_commands = cmdr.complete_current_commands();
+
+        app.device.submit_commands({.command_lists = std::array{primary_commands}});
+        app.device.wait_idle();
+
+        app.device.destroy_image(render_target);
+    }
+    void redundant_state(App & app)
+    {
+        daxa::ImageId render_target = app.device.create_image({
+            .format = daxa::Format::R8G8B8A8_UNORM,
+            .size = {64, 64, 1},
+            .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT,
+            .name = "redundant state render target",
+        });
+
+        daxa::CommandRecorder cmdr = app.device.create_command_recorder({.name = "redundant state"});
+        cmdr.pipeline_barrier_image_transition({
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_layout = daxa::ImageLayout::ATTACHMENT_OPTIMAL,
+            .image_id = render_target,
+        });
+        daxa::RenderCommandRecorder render_cmdr = std::move(cmdr).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{
+                .image_view = render_target.default_view(),
+                .load_op = daxa::AttachmentLoadOp::CLEAR,
+                .clear_value = std::array<daxa::f32, 4>{0.0f, 0.0f, 0.0f, 1.0f},
+            }},
+            .render_area = {.width = 64, .height = 64},
+        });
+        // begin_renderpass already set viewport and scissor to the render area.
+        render_cmdr.set_scissor({.width = 64, .height = 64});
+        render_cmdr.set_viewport({.width = 64.0f, .height = 64.0f, .min_depth = 0.0f, .max_depth = 1.0f});
+        render_cmdr.set_scissor({.width = 32, .height = 32});
+        render_cmdr.set_scissor({.width = 32, .height = 32});
+        DAXA_DBG_ASSERT_TRUE_M(render_cmdr.stats().filtered_scissors == 2, "redundant scissors must be filtered");
+        DAXA_DBG_ASSERT_TRUE_M(render_cmdr.stats().filtered_viewports == 1, "redundant viewports must be filtered");
+        cmdr = std::move(render_cmdr).end_renderpass();
+        auto commands = cmdr.complete_current_commands();
+
+        app.device.submit_commands({.command_lists = std::array{commands}});
+        app.device.wait_idle();
+
+        app.device.destroy_image(render_target);
+    }
+    void calibrated_timestamps(App & app)
+    {
+        if ((app.device.properties().implicit_features & daxa::ImplicitFeatureFlagBits::CALIBRATED_TIMESTAMPS) == daxa::ImplicitFeatureFlagBits::NONE)
+        {
+            return;
+        }
+        constexpr u32 SUBMIT_COUNT = 4;
+        f32 const timestamp_period = app.device.properties().limits.timestamp_period;
+        daxa::TimelineQueryPool timeline_query_pool = app.device.create_timeline_query_pool({
+            .query_count = SUBMIT_COUNT,
+            .name = "calibrated timestamps",
+        });
+        daxa::CalibratedTimestamps const calibration = app.device.calibrated_timestamps();
+        auto host_now_ns = []()
+        { return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()); };
+        // The clocks are sampled up to max_deviation_ns apart, the conversion rounds to whole nanoseconds.
+        [[maybe_unused]] u64 const tolerance_ns = calibration.max_deviation_ns + 1'000'000;
+
+        std::array<u64, SUBMIT_COUNT> host_submit_ns = {};
+        std::array<u64, SUBMIT_COUNT> host_done_ns = {};
+        for (u32 i = 0; i < SUBMIT_COUNT; ++i)
+        {
+            auto recorder = app.device.create_command_recorder({});
+            recorder.reset_timestamps({.query_pool = timeline_query_pool, .start_index = i, .count = 1});
+            recorder.write_timestamp({
+                .query_pool = timeline_query_pool,
+                .pipeline_stage = daxa::PipelineStageFlagBits::BOTTOM_OF_PIPE,
+                .query_index = i,
+            });
+            auto commands = recorder.complete_current_commands();
+            host_submit_ns[i] = host_now_ns();
+            app.device.submit_commands({.command_lists = std::array{commands}});
+            app.device.wait_idle();
+            host_done_ns[i] = host_now_ns();
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        }
+
+        // Each timestamp converted to host time must lie between its submit and the end of the wait, so they increase like the host clock.
+        auto const query_results = timeline_query_pool.get_query_results(0, SUBMIT_COUNT);
+        u64 previous_host_ns = 0;
+        for (u32 i = 0; i < SUBMIT_COUNT; ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(query_results[i * 2 + 1] != 0, "timestamp must be available after the wait");
+            u64 const host_ns = calibration.device_ticks_to_host_ns(query_results[i * 2], timestamp_period);
+            DAXA_DBG_ASSERT_TRUE_M(host_ns + tolerance_ns >= host_submit_ns[i] && host_ns <= host_done_ns[i] + tolerance_ns, "converted timestamp must lie between its submit and the end of the wait");
+            DAXA_DBG_ASSERT_TRUE_M(host_ns > previous_host_ns, "converted timestamps must increase with the host clock");
+            [[maybe_unused]] u64 const round_trip_ticks = calibration.host_ns_to_device_ticks(host_ns, timestamp_period);
+            DAXA_DBG_ASSERT_TRUE_M(std::max(round_trip_ticks, query_results[i * 2]) - std::min(round_trip_ticks, query_results[i * 2]) <= 1 + static_cast<u64>(1.0f / timestamp_period), "host time must convert back to the device ticks");
+            previous_host_ns = host_ns;
+        }
+        std::cout << "calibrated timestamps: max deviation " << calibration.max_deviation_ns << " ns" << std::endl;
+    }
+
+    void merged_barriers(App & app)
+    {
+        constexpr daxa::u32 MIP_COUNT = 7;
+        daxa::ImageId image = app.device.create_image({
+            .format = daxa::Format::R8G8B8A8_UNORM,
+            .size = {64, 64, 1},
+            .mip_level_count = MIP_COUNT,
+            .usage = daxa::ImageUsageFlagBits::TRANSFER_DST,
+            .name = "merged barriers image",
+        });
+
+        daxa::CommandRecorder cmdr = app.device.create_command_recorder({.name = "merged barriers", .merge_barriers = true});
+        for (daxa::u32 mip = 0; mip < MIP_COUNT; ++mip)
+        {
+            cmdr.pipeline_barrier_image_transition({
+                .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
+                .dst_layout = daxa::ImageLayout::TRANSFER_DST_OPTIMAL,
+                .image_slice = {.base_mip_level = mip},
+                .image_id = image,
+            });
+        }
+        cmdr.pipeline_barrier({.src_access = daxa::AccessConsts::TRANSFER_WRITE, .dst_access = daxa::AccessConsts::TRANSFER_READ});
+        cmdr.pipeline_barrier({.src_access = daxa::AccessConsts::TRANSFER_WRITE, .dst_access = daxa::AccessConsts::TRANSFER_WRITE});
+        auto commands = cmdr.complete_current_commands();
+        // All mip transitions collapse into one barrier, the two memory barriers share their stages.
+        DAXA_DBG_ASSERT_TRUE_M(cmdr.stats().merged_barriers == MIP_COUNT, "adjacent barriers must be merged");
+
+        app.device.submit_commands({.command_lists = std::array{commands}});
+        app.device.wait_idle();
+
+        app.device.destroy_image(image);
+    }
+    void merged_renderpasses(App & app)
+    {
+        daxa::ImageId render_target = app.device.create_image({
+            .format = daxa::Format::R8G8B8A8_UNORM,
+            .size = {64, 64, 1},
+            .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT,
+            .name = "merged renderpasses render target",
+        });
+
+        daxa::CommandRecorder cmdr = app.device.create_command_recorder({.name = "merged renderpasses", .merge_renderpasses = true});
+        cmdr.pipeline_barrier_image_transition({
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_READ_WRITE,
+            .dst_layout = daxa::ImageLayout::ATTACHMENT_OPTIMAL,
+            .image_id = render_target,
+        });
+        auto render_to_target = [&](daxa::AttachmentLoadOp load_op)
+        {
+            daxa::RenderCommandRecorder render_cmdr = std::move(cmdr).begin_renderpass({
+                .color_attachments = std::array{daxa::RenderAttachmentInfo{
+                    .image_view = render_target.default_view(),
+                    .load_op = load_op,
+                    .clear_value = std::array<daxa::f32, 4>{0.0f, 0.0f, 0.0f, 1.0f},
+                }},
+                .render_area = {.width = 64, .height = 64},
+            });
+            render_cmdr.set_scissor({.width = 32, .height = 32});
+            cmdr = std::move(render_cmdr).end_renderpass();
+        };
+        // The second and third renderpass load what the first one stored, labels between them do not end the first one.
+        render_to_target(daxa::AttachmentLoadOp::CLEAR);
+        cmdr.begin_label({.name = "decals"});
+        render_to_target(daxa::AttachmentLoadOp::LOAD);
+        cmdr.end_label();
+        // Attachment to attachment barriers without a layout change are dropped instead of ending the renderpass.
+        cmdr.pipeline_barrier_image_transition({
+            .src_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_READ_WRITE,
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_READ_WRITE,
+            .src_layout = daxa::ImageLayout::ATTACHMENT_OPTIMAL,
+            .dst_layout = daxa::ImageLayout::ATTACHMENT_OPTIMAL,
+            .image_id = render_target,
+        });
+        render_to_target(daxa::AttachmentLoadOp::LOAD);
+        // Clearing can not continue the previous renderpass.
+        render_to_target(daxa::AttachmentLoadOp::CLEAR);
+        auto commands = cmdr.complete_current_commands();
+        DAXA_DBG_ASSERT_TRUE_M(cmdr.stats().merged_renderpasses == 2, "renderpasses loading the same attachments must continue the previous one");
+
+        app.device.submit_commands({.command_lists = std::array{commands}});
+        app.device.wait_idle();
+
+        app.device.destroy_image(render_target);
+    }
     void build_acceleration_structure(App & app)
     {
         try
@@ -611,6 +1002,232 @@ namespace tests
             exit(-1);
         }
     }
+    void build_opacity_micromap(App & app)
+    {
+        daxa::Device device;
+        try
+        {
+            device = app.daxa_ctx.create_device_2(app.daxa_ctx.choose_device(daxa::ImplicitFeatureFlagBits::BASIC_RAY_TRACING | daxa::ImplicitFeatureFlagBits::OPACITY_MICROMAP, {}));
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "Test skipped. No present device supports opacity micromaps!" << std::endl;
+            return;
+        }
+        /// A single triangle without subdivision, marked fully opaque in the 2 state format.
+        auto const usage_counts = std::array{daxa::MicromapUsage{.count = 1, .subdivision_level = 0, .format = daxa::OpacityMicromapFormat::OPACITY_2_STATE}};
+        struct MicromapTriangle
+        {
+            u32 data_offset;
+            u16 subdivision_level;
+            u16 format;
+        };
+        // Micromap build inputs must be 256 byte aligned.
+        struct MicromapInput
+        {
+            alignas(256) u32 opacity;
+            alignas(256) MicromapTriangle triangle;
+            alignas(256) u32 index;
+            std::array<std::array<f32, 3>, 3> vertices;
+            std::array<u32, 3> indices;
+        };
+        auto input_buffer = device.create_buffer({
+            .size = sizeof(MicromapInput),
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "micromap input buffer",
+        });
+        defer { device.destroy_buffer(input_buffer); };
+        *device.buffer_host_address_as<MicromapInput>(input_buffer).value() = MicromapInput{
+            .opacity = 1,
+            .triangle = {.data_offset = 0, .subdivision_level = 0, .format = static_cast<u16>(daxa::OpacityMicromapFormat::OPACITY_2_STATE)},
+            .index = 0,
+            .vertices = {{{0.25f, 0.75f, 0.5f}, {0.5f, 0.25f, 0.5f}, {0.75f, 0.75f, 0.5f}}},
+            .indices = {0, 1, 2},
+        };
+        daxa::DeviceAddress const input_address = device.device_address(input_buffer).value();
+
+        auto micromap_build_info = daxa::MicromapBuildInfo{
+            .usage_counts = usage_counts,
+            .data = input_address + offsetof(MicromapInput, opacity),
+            .triangle_array = input_address + offsetof(MicromapInput, triangle),
+            .triangle_array_stride = sizeof(MicromapTriangle),
+        };
+        daxa::MicromapBuildSizesInfo const micromap_sizes = device.micromap_build_sizes(micromap_build_info);
+        daxa::Micromap micromap = device.create_micromap({.size = micromap_sizes.micromap_size, .name = "test micromap"});
+        daxa::BufferId const micromap_buffer = micromap.buffer_id();
+        DAXA_DBG_ASSERT_TRUE_M(device.is_buffer_id_valid(micromap_buffer), "micromap must expose its backing buffer");
+        DAXA_DBG_ASSERT_TRUE_M(device.buffer_info(micromap_buffer).value().size >= micromap_sizes.micromap_size, "micromap buffer must hold the micromap");
+
+        auto geometries = std::array{
+            daxa::BlasTriangleGeometryInfo{
+                .vertex_format = daxa::Format::R32G32B32_SFLOAT,
+                .vertex_data = input_address + offsetof(MicromapInput, vertices),
+                .vertex_stride = sizeof(std::array<f32, 3>),
+                .max_vertex = 2,
+                .index_type = daxa::IndexType::uint32,
+                .index_data = input_address + offsetof(MicromapInput, indices),
+                .count = 1,
+                .flags = {},
+                .opacity_micromap = micromap,
+                .opacity_micromap_usage_counts = usage_counts,
+                .opacity_micromap_index_type = daxa::IndexType::uint32,
+                .opacity_micromap_index_data = input_address + offsetof(MicromapInput, index),
+            }};
+        auto blas_build_info = daxa::BlasBuildInfo{.geometries = geometries};
+        daxa::AccelerationStructureBuildSizesInfo const blas_sizes = device.blas_build_sizes(blas_build_info);
+        auto scratch_buffer = device.create_buffer({
+            .size = std::max(micromap_sizes.build_scratch_size, blas_sizes.build_scratch_size),
+            .name = "micromap scratch buffer",
+        });
+        defer { device.destroy_buffer(scratch_buffer); };
+        daxa::BlasId blas = device.create_blas({.size = blas_sizes.acceleration_structure_size, .name = "micromap blas"});
+        defer { device.destroy_blas(blas); };
+        micromap_build_info.dst_micromap = micromap;
+        micromap_build_info.scratch_data = device.device_address(scratch_buffer).value();
+        blas_build_info.dst_blas = blas;
+        blas_build_info.scratch_data = device.device_address(scratch_buffer).value();
+
+        auto recorder = device.create_command_recorder({});
+        recorder.build_micromaps({.builds = std::array{micromap_build_info}});
+        // The blas build reads the micromap in the acceleration structure build stage, the scratch buffer is reused.
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::MICROMAP_BUILD_WRITE,
+            .dst_access = daxa::AccessConsts::ACCELERATION_STRUCTURE_BUILD_READ_WRITE,
+        });
+        recorder.build_acceleration_structures({.blas_build_infos = std::array{blas_build_info}});
+        auto commands = recorder.complete_current_commands();
+        device.submit_commands({.command_lists = std::array{commands}});
+        device.wait_idle();
+
+        // The backing buffer is destroyed together with the micromap.
+        geometries[0].opacity_micromap = {};
+        micromap_build_info.dst_micromap = {};
+        micromap = {};
+        device.collect_garbage();
+        DAXA_DBG_ASSERT_TRUE_M(!device.is_buffer_id_valid(micromap_buffer), "micromap buffer must be destroyed with the micromap");
+    }
+
+    // Hand assembled SPIR-V of an empty compute shader with a local size of 1, so the tests do not need a shader compiler.
+    static constexpr std::array<u32, 35> EMPTY_COMPUTE_SPIRV = {
+        0x07230203, 0x00010000, 0x00000000, 0x00000005, 0x00000000,
+        0x00020011, 0x00000001,                                                 // OpCapability Shader
+        0x0003000E, 0x00000000, 0x00000001,                                     // OpMemoryModel Logical GLSL450
+        0x0005000F, 0x00000005, 0x00000001, 0x6E69616D, 0x00000000,             // OpEntryPoint GLCompute %1 "main"
+        0x00060010, 0x00000001, 0x00000011, 0x00000001, 0x00000001, 0x00000001, // OpExecutionMode %1 LocalSize 1 1 1
+        0x00020013, 0x00000002,                                                 // %2 = OpTypeVoid
+        0x00030021, 0x00000003, 0x00000002,                                     // %3 = OpTypeFunction %2
+        0x00050036, 0x00000002, 0x00000001, 0x00000000, 0x00000003,             // %1 = OpFunction %2 None %3
+        0x000200F8, 0x00000004,                                                 // %4 = OpLabel
+        0x000100FD,                                                             // OpReturn
+        0x00010038,                                                             // OpFunctionEnd
+    };
+
+    void async_pipelines(App & app)
+    {
+        auto pipeline_info = [](daxa::Span<daxa::SpecializationConstant const> specialization_constants, bool indirect_bindable = false)
+        {
+            return daxa::ComputePipelineInfo{
+                .shader_info = {
+                    .byte_code = EMPTY_COMPUTE_SPIRV.data(),
+                    .byte_code_size = static_cast<u32>(EMPTY_COMPUTE_SPIRV.size()),
+                    .specialization_constants = specialization_constants,
+                },
+                .name = "async pipeline",
+                .indirect_bindable = indirect_bindable,
+            };
+        };
+        // The shader ignores the specialization constants, they only make the pipelines distinct.
+        constexpr u32 QUEUED_PIPELINE_COUNT = 64;
+        std::array<daxa::SpecializationConstant, QUEUED_PIPELINE_COUNT + 1> constants = {};
+        for (u32 i = 0; i < constants.size(); ++i)
+        {
+            constants[i] = {.constant_id = 0, .value = i};
+        }
+
+        // Destroying pending pipelines removes their queued jobs or waits for the worker compiling them.
+        for (u32 i = 0; i < QUEUED_PIPELINE_COUNT; ++i)
+        {
+            [[maybe_unused]] auto const cancelled = app.device.create_compute_pipeline_async(pipeline_info({&constants[i], 1}));
+        }
+
+        // Keep the workers busy, so the tested pipeline is usually still pending while it is bound.
+        std::vector<daxa::ComputePipeline> queued_pipelines = {};
+        for (u32 i = 0; i < QUEUED_PIPELINE_COUNT; ++i)
+        {
+            queued_pipelines.push_back(app.device.create_compute_pipeline_async(pipeline_info({&constants[i], 1})));
+        }
+        daxa::ComputePipeline const fallback = app.device.create_compute_pipeline(pipeline_info({}));
+        DAXA_DBG_ASSERT_TRUE_M(fallback.status() == daxa::PipelineStatus::READY, "synchronously created pipelines must be ready");
+        daxa::ComputePipeline const pipeline = app.device.create_compute_pipeline_async(pipeline_info({&constants[QUEUED_PIPELINE_COUNT], 1}));
+        daxa::ComputePipeline const pipeline_with_fallback = app.device.create_compute_pipeline_async(pipeline_info({&constants[QUEUED_PIPELINE_COUNT], 1}), fallback);
+
+        auto recorder = app.device.create_command_recorder({.name = "async pipelines"});
+        // The status only moves away from pending, so it tells whether the bind saw the pipeline pending.
+        [[maybe_unused]] auto const status_before_bind = pipeline.status();
+        recorder.set_pipeline(pipeline);
+        [[maybe_unused]] auto const status_after_bind = pipeline.status();
+        recorder.dispatch({});
+        DAXA_DBG_ASSERT_TRUE_M(status_after_bind != daxa::PipelineStatus::PENDING || recorder.stats().skipped_pending_pipeline_commands == 1, "dispatches must be skipped while a pending pipeline without fallback is bound");
+        DAXA_DBG_ASSERT_TRUE_M(status_before_bind != daxa::PipelineStatus::READY || recorder.stats().skipped_pending_pipeline_commands == 0, "dispatches with a ready pipeline must not be skipped");
+        [[maybe_unused]] u64 const skipped_without_fallback = recorder.stats().skipped_pending_pipeline_commands;
+
+        // Pending pipelines with a ready fallback bind the fallback instead.
+        recorder.set_pipeline(pipeline_with_fallback);
+        recorder.dispatch({});
+        DAXA_DBG_ASSERT_TRUE_M(recorder.stats().skipped_pending_pipeline_commands == skipped_without_fallback, "dispatches must use the ready fallback");
+
+        pipeline.wait();
+        pipeline_with_fallback.wait();
+        DAXA_DBG_ASSERT_TRUE_M(pipeline.status() == daxa::PipelineStatus::READY, "pipelines must be ready after waiting for them");
+        recorder.set_pipeline(pipeline);
+        recorder.dispatch({});
+        DAXA_DBG_ASSERT_TRUE_M(recorder.stats().skipped_pending_pipeline_commands == skipped_without_fallback, "dispatches must not be skipped once the pipeline is ready");
+        auto commands = recorder.complete_current_commands();
+        app.device.submit_commands({.command_lists = std::array{commands}});
+        app.device.wait_idle();
+        queued_pipelines.clear();
+        app.device.collect_garbage();
+
+        daxa::Device device;
+        try
+        {
+            device = app.daxa_ctx.create_device_2(app.daxa_ctx.choose_device(daxa::ImplicitFeatureFlagBits::DEVICE_GENERATED_COMMANDS, {}));
+        }
+        catch (std::runtime_error error)
+        {
+            std::cout << "Indirect execution set part skipped. No present device supports device generated commands!" << std::endl;
+            return;
+        }
+        daxa::ComputePipeline const initial_pipeline = device.create_compute_pipeline(pipeline_info({}, true));
+        daxa::IndirectExecutionSet execution_set = device.create_indirect_execution_set({
+            .initial_compute_pipeline = initial_pipeline,
+            .max_pipeline_count = 2,
+            .name = "async pipelines",
+        });
+        for (u32 i = 0; i < QUEUED_PIPELINE_COUNT; ++i)
+        {
+            queued_pipelines.push_back(device.create_compute_pipeline_async(pipeline_info({&constants[i], 1}, true)));
+        }
+        daxa::ComputePipeline const indirect_pipeline = device.create_compute_pipeline_async(pipeline_info({&constants[QUEUED_PIPELINE_COUNT], 1}, true));
+        // Execution sets reject pipelines that are not ready with DAXA_RESULT_ERROR_PIPELINE_NOT_READY.
+        [[maybe_unused]] auto const status_before_write = indirect_pipeline.status();
+        [[maybe_unused]] bool written = true;
+        try
+        {
+            execution_set.write_pipeline(1, indirect_pipeline);
+        }
+        catch (std::runtime_error const &)
+        {
+            written = false;
+        }
+        [[maybe_unused]] auto const status_after_write = indirect_pipeline.status();
+        DAXA_DBG_ASSERT_TRUE_M(status_after_write != daxa::PipelineStatus::PENDING || !written, "pending pipelines must not be written into execution sets");
+        DAXA_DBG_ASSERT_TRUE_M(status_before_write != daxa::PipelineStatus::READY || written, "ready pipelines must be written into execution sets");
+        indirect_pipeline.wait();
+        execution_set.write_pipeline(1, indirect_pipeline);
+        queued_pipelines.clear();
+        device.collect_garbage();
+    }
 } // namespace tests
 
 auto main() -> int
@@ -631,10 +1248,54 @@ auto main() -> int
         App app = {};
         tests::multiple_ecl(app);
     }
+    {
+        App app = {};
+        tests::unvalidated_ecl(app);
+    }
+    {
+        App app = {};
+        tests::reusable_ecl(app);
+    }
+    {
+        App app = {};
+        tests::secondary_command_lists(app);
+    }
+    {
+        App app = {};
+        tests::redundant_state(app);
+    }
+    {
+        App app = {};
+        tests::calibrated_timestamps(app);
+    }
+    {
+        App app = {};
+        tests::merged_barriers(app);
+    }
+    {
+        App app = {};
+        tests::merged_renderpasses(app);
+    }
+    {
+        App app = {};
+        tests::async_pipelines(app);
+    }
     {
         App app = {};
         tests::build_acceleration_structure(app);
     }
+    {
+        App app = {};
+        tests::build_opacity_micromap(app);
+    }
+    {
+        App app = {};
+        tests::submit_perf(app);
+    }
+    {
+        App app = {};
+        tests::recording_perf(app);
+    }
     // Tests how long the version in ids can last for a single index.
     // {
     //     App app = {};
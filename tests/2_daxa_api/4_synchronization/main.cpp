@@ -1,5 +1,9 @@
 #include <daxa/daxa.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 struct App
 {
     daxa::Instance daxa_ctx = daxa::create_instance({});
@@ -48,6 +52,67 @@ namespace tests
         });
     }
 
+    void timeline_wait_any(App & app)
+    {
+        auto timeline_a = app.device.create_timeline_semaphore({.name = "timeline a"});
+        auto timeline_b = app.device.create_timeline_semaphore({.name = "timeline b"});
+        auto const pairs = std::array{std::pair{timeline_a, u64{1}}, std::pair{timeline_b, u64{1}}};
+
+        // The waits stay outside of the asserts, so that they are also performed when asserts are compiled out.
+        timeline_b.set_value(1);
+        [[maybe_unused]] bool const any_signaled = app.device.wait_semaphores(pairs, true, 0);
+        DAXA_DBG_ASSERT_TRUE_M(any_signaled, "wait any must succeed once one semaphore is signaled");
+        [[maybe_unused]] bool const one_unsignaled = !app.device.wait_semaphores(pairs, false, 0);
+        DAXA_DBG_ASSERT_TRUE_M(one_unsignaled, "wait all must time out while one semaphore is unsignaled");
+        timeline_a.set_value(1);
+        [[maybe_unused]] bool const all_signaled = app.device.wait_semaphores(pairs, false, 0);
+        DAXA_DBG_ASSERT_TRUE_M(all_signaled, "wait all must succeed once all semaphores are signaled");
+    }
+
+    void timeline_callbacks(App & app)
+    {
+        auto timeline = app.device.create_timeline_semaphore({.name = "callback timeline"});
+        std::atomic_uint32_t called = 0;
+        app.device.on_timeline(timeline, 1, [&]()
+                               { called.fetch_add(1); });
+        app.device.on_timeline(timeline, 2, [&]()
+                               { called.fetch_add(1); });
+
+        timeline.set_value(1);
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (called.load() < 1 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        DAXA_DBG_ASSERT_TRUE_M(called.load() == 1, "only the callback of the reached value must be called");
+
+        timeline.set_value(2);
+        while (called.load() < 2 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        DAXA_DBG_ASSERT_TRUE_M(called.load() == 2, "timeline callback was not called");
+    }
+
+    void borrowed_handles(App & app)
+    {
+        auto timeline = app.device.create_timeline_semaphore({.name = "borrowed timeline"});
+        // Borrowed handles are captured by value without touching the refcount, the owners outlive the thread.
+        daxa::TimelineSemaphoreRef const timeline_ref = timeline;
+        daxa::DeviceRef const device_ref = app.device;
+        auto signaler = std::thread{[timeline_ref, device_ref]()
+                                    {
+                                        timeline_ref->set_value(1);
+                                        DAXA_DBG_ASSERT_TRUE_M(device_ref->is_valid(), "borrowed device must stay usable");
+                                    }};
+        signaler.join();
+        DAXA_DBG_ASSERT_TRUE_M(timeline.value() == 1, "borrowed timeline must signal the owned semaphore");
+        DAXA_DBG_ASSERT_TRUE_M(timeline_ref.get() == timeline.get(), "borrowed timeline must refer to the owned semaphore");
+        auto const pairs = std::array{std::pair{static_cast<daxa::TimelineSemaphore const &>(timeline_ref), u64{1}}};
+        [[maybe_unused]] bool const signaled = device_ref->wait_semaphores(pairs, false, 0);
+        DAXA_DBG_ASSERT_TRUE_M(signaled, "borrowed handles must convert to handle references");
+    }
+
     void memory_barriers(App & app)
     {
         auto recorder = app.device.create_command_recorder({});
@@ -63,6 +128,9 @@ auto main() -> int
 {
     App app = {};
     tests::binary_semaphore(app);
+    tests::timeline_wait_any(app);
+    tests::timeline_callbacks(app);
+    tests::borrowed_handles(app);
     // Useless for now
     tests::memory_barriers(app);
 }
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "common.hpp"
+#include <daxa/utils/gpu_arena.inl>
+#include <daxa/utils/gpu_scan.hpp>
+#include <cstring>
+
 DAXA_DECL_TASK_HEAD_BEGIN(TestTaskHead)
 DAXA_TH_BUFFER(COMPUTE_SHADER_READ, buffer0)
 DAXA_TH_IMAGE(COMPUTE_SHADER_SAMPLED, REGULAR_2D, image0)
@@ -8,17 +12,32 @@ DAXA_TH_IMAGE(COMPUTE_SHADER_SAMPLED, REGULAR_2D, image1)
 DAXA_TH_BUFFER(COMPUTE_SHADER_READ, test_buffer_no_shader)
 DAXA_DECL_TASK_HEAD_END
 
+DAXA_DECL_TASK_HEAD_BEGIN(TypedAccessHead)
+DAXA_TH_BUFFER(TRANSFER_READ, src)
+DAXA_TH_BUFFER(TRANSFER_WRITE, dst0)
+DAXA_TH_BUFFER(TRANSFER_WRITE, dst1)
+DAXA_TH_IMAGE(TRANSFER_WRITE, REGULAR_2D, image)
+DAXA_DECL_TASK_HEAD_END
+
+DAXA_DECL_TASK_HEAD_BEGIN(AddressBlobHead)
+DAXA_TH_BUFFER_ID_ARRAY(COMPUTE_SHADER_READ, ids, 2)
+DAXA_TH_BUFFER_PTR_ARRAY(COMPUTE_SHADER_READ, daxa_BufferPtr(daxa_u32), ptrs, 2)
+DAXA_TH_BUFFER_PTR(COMPUTE_SHADER_READ, daxa_BufferPtr(daxa_u32), ptr)
+DAXA_DECL_TASK_HEAD_END
+
 struct TestTask : TestTaskHead::Task
 {
     AttachmentViews views = {};
     void callback(daxa::TaskInterface ti)
     {
-        // There are two ways to get the info for any attachment:
+        // There are three ways to get the info for any attachment:
         {
             // daxa::TaskBufferAttachmentIndex index:
             [[maybe_unused]] daxa::TaskBufferAttachmentInfo const & buffer0_attachment0 = ti.get(AT.buffer0);
             // daxa::TaskBufferView assigned to the buffer attachment:
             [[maybe_unused]] daxa::TaskBufferAttachmentInfo const & buffer0_attachment1 = ti.get(buffer0_attachment0.view);
+            // daxa::TaskBufferAttachmentIndex as a template argument, resolved at compile time:
+            [[maybe_unused]] daxa::TaskBufferAttachmentInfo const & buffer0_attachment2 = ti.get<AT.buffer0>();
         }
         // The Buffer Attachment info contents:
         {
@@ -976,6 +995,1259 @@ namespace tests
         task_graph.execute({});
         std::cout << task_graph.get_debug_string() << std::endl;
     }
+
+    void merged_renderpasses()
+    {
+        // TEST:
+        //    1) Clear an image in a raster task
+        //    2) Draw over it in two more raster tasks loading it
+        //    Expected result:
+        //      The attachment barriers between the tasks are dropped and the later tasks continue the renderpass of the first.
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .merge_renderpasses = true,
+            .name = APPNAME_PREFIX("task_graph (merged_renderpasses)"),
+        });
+        auto task_image = task_graph.create_transient_image({.size = {64, 64, 1}, .name = "render target"});
+        daxa::u64 merged_renderpasses = 0;
+        auto add_render_task = [&](daxa::AttachmentLoadOp load_op, std::string_view name)
+        {
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskImageAccess::COLOR_ATTACHMENT, task_image)},
+                .task = [=, &merged_renderpasses](daxa::TaskInterface ti)
+                {
+                    auto render_recorder = std::move(ti.recorder).begin_renderpass({
+                        .color_attachments = std::array{
+                            daxa::RenderAttachmentInfo{
+                                .image_view = ti.get(task_image).view_ids[0],
+                                .load_op = load_op,
+                                .clear_value = std::array<daxa::f32, 4>{0.0f, 0.0f, 0.0f, 1.0f},
+                            },
+                        },
+                        .render_area = {.width = 64, .height = 64},
+                    });
+                    ti.recorder = std::move(render_recorder).end_renderpass();
+                    merged_renderpasses = ti.recorder.stats().merged_renderpasses;
+                },
+                .name = name,
+            });
+        };
+        add_render_task(daxa::AttachmentLoadOp::CLEAR, APPNAME_PREFIX("clear (merged_renderpasses)"));
+        add_render_task(daxa::AttachmentLoadOp::LOAD, APPNAME_PREFIX("draw 1 (merged_renderpasses)"));
+        add_render_task(daxa::AttachmentLoadOp::LOAD, APPNAME_PREFIX("draw 2 (merged_renderpasses)"));
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(merged_renderpasses > 0, "raster tasks loading the attachments of the previous task must continue its renderpass");
+        app.device.collect_garbage();
+    }
+
+    void parallel_recording()
+    {
+        // TEST:
+        //  1) Record a chain of tasks, each copying the previous slot of a buffer into the next slot
+        //  2) Every task depends on the previous one, so each gets its own batch
+        //  3) Execute with four recording threads, the batches end up in separate command lists
+        //  Expected result:
+        //      The value cleared into the first slot arrives in every slot,
+        //      the barriers recorded per batch still order the copies across the command lists.
+        AppContext app = {};
+        constexpr daxa::u32 TASK_COUNT = 64;
+        constexpr daxa::u32 VALUE = 42;
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32) * TASK_COUNT,
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "parallel recording buffer",
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .record_thread_count = 4,
+            .name = APPNAME_PREFIX("task_graph (parallel_recording)"),
+        });
+        task_graph.use_persistent_buffer(task_buffer);
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_buffer).ids[0], .offset = 0, .size = sizeof(daxa::u32), .clear_value = VALUE});
+            },
+            .name = APPNAME_PREFIX("clear first slot (parallel_recording)"),
+        });
+        for (daxa::u32 i = 1; i < TASK_COUNT; ++i)
+        {
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::READ_WRITE, task_buffer)},
+                .task = [&, i](daxa::TaskInterface const & ti)
+                {
+                    ti.recorder.copy_buffer_to_buffer({
+                        .src_buffer = ti.get(task_buffer).ids[0],
+                        .dst_buffer = ti.get(task_buffer).ids[0],
+                        .src_offset = sizeof(daxa::u32) * (i - 1),
+                        .dst_offset = sizeof(daxa::u32) * i,
+                        .size = sizeof(daxa::u32),
+                    });
+                },
+                .name = APPNAME_PREFIX("copy slot (parallel_recording)"),
+            });
+        }
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+
+        app.device.wait_idle();
+        daxa::u32 const * values = app.device.buffer_host_address_as<daxa::u32>(buffer).value();
+        for (daxa::u32 i = 0; i < TASK_COUNT; ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(values[i] == VALUE, "parallel recording broke the ordering between batches");
+        }
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    void async_compute()
+    {
+        // TEST:
+        //  1) Record a chain of copies between the slots of a buffer, every other copy is marked as a compute task
+        //  2) Submit the chain, so that its submit scope may be split onto the async compute queue
+        //  3) Execute with the first compute queue as async compute queue
+        //  Expected result:
+        //      The value cleared into the first slot arrives in every slot,
+        //      the timeline semaphores order the copies across the two queues.
+        AppContext app = {};
+        if (app.device.queue_count(daxa::QueueFamily::COMPUTE) == 0)
+        {
+            return;
+        }
+        constexpr daxa::u32 TASK_COUNT = 8;
+        constexpr daxa::u32 VALUE = 42;
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32) * TASK_COUNT,
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "async compute buffer",
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .async_compute_queue = daxa::QUEUE_COMPUTE_0,
+            .name = APPNAME_PREFIX("task_graph (async_compute)"),
+        });
+        task_graph.use_persistent_buffer(task_buffer);
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_buffer).ids[0], .offset = 0, .size = sizeof(daxa::u32), .clear_value = VALUE});
+            },
+            .name = APPNAME_PREFIX("clear first slot (async_compute)"),
+        });
+        for (daxa::u32 i = 1; i < TASK_COUNT; ++i)
+        {
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::READ_WRITE, task_buffer)},
+                .task = [&, i](daxa::TaskInterface const & ti)
+                {
+                    ti.recorder.copy_buffer_to_buffer({
+                        .src_buffer = ti.get(task_buffer).ids[0],
+                        .dst_buffer = ti.get(task_buffer).ids[0],
+                        .src_offset = sizeof(daxa::u32) * (i - 1),
+                        .dst_offset = sizeof(daxa::u32) * i,
+                        .size = sizeof(daxa::u32),
+                    });
+                },
+                .name = APPNAME_PREFIX("copy slot (async_compute)"),
+                .type = (i % 2) == 1 ? daxa::TaskType::COMPUTE : daxa::TaskType::GENERAL,
+            });
+        }
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+
+        app.device.wait_idle();
+        daxa::u32 const * values = app.device.buffer_host_address_as<daxa::u32>(buffer).value();
+        for (daxa::u32 i = 0; i < TASK_COUNT; ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(values[i] == VALUE, "async compute broke the ordering between queues");
+        }
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    void async_compute_overlap()
+    {
+        // TEST:
+        //  1) Record a clear on the main queue and an independent clear into a host visible buffer as a compute task
+        //  2) Submit them in one scope that waits on a timeline semaphore the host has not signaled yet
+        //  3) Execute with the first compute queue as async compute queue
+        //  Expected result:
+        //      The compute task does not depend on anything on the main queue and runs while the main queue is blocked.
+        AppContext app = {};
+        if (app.device.queue_count(daxa::QueueFamily::COMPUTE) == 0)
+        {
+            return;
+        }
+        constexpr daxa::u32 VALUE = 42;
+        auto main_buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .name = "async compute overlap main buffer",
+        });
+        auto async_buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "async compute overlap async buffer",
+        });
+        *app.device.buffer_host_address_as<daxa::u32>(async_buffer).value() = 0;
+        auto task_main_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&main_buffer, 1}}, .name = "main buffer"});
+        auto task_async_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&async_buffer, 1}}, .name = "async buffer"});
+        auto gate = app.device.create_timeline_semaphore({.initial_value = 0, .name = "async compute overlap gate"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .async_compute_queue = daxa::QUEUE_COMPUTE_0,
+            .name = APPNAME_PREFIX("task_graph (async_compute_overlap)"),
+        });
+        task_graph.use_persistent_buffer(task_main_buffer);
+        task_graph.use_persistent_buffer(task_async_buffer);
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_main_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_main_buffer).ids[0], .size = sizeof(daxa::u32), .clear_value = VALUE});
+            },
+            .name = APPNAME_PREFIX("clear on main queue (async_compute_overlap)"),
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_async_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_async_buffer).ids[0], .size = sizeof(daxa::u32), .clear_value = VALUE});
+            },
+            .name = APPNAME_PREFIX("clear on compute queue (async_compute_overlap)"),
+            .type = daxa::TaskType::COMPUTE,
+        });
+        std::vector<std::pair<daxa::TimelineSemaphore, daxa::u64>> gate_waits = {{gate, 1}};
+        task_graph.submit({.additional_wait_timeline_semaphores = &gate_waits});
+        task_graph.complete({});
+        task_graph.execute({});
+
+        // The main queue waits on the gate, the compute queue must finish on its own.
+        daxa::u32 volatile const * async_value = app.device.buffer_host_address_as<daxa::u32>(async_buffer).value();
+        bool overlapped = false;
+        for (daxa::u32 i = 0; i < 5000 && !overlapped; ++i)
+        {
+            overlapped = *async_value == VALUE;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        [[maybe_unused]] bool const main_blocked = gate.value() == 0;
+        gate.set_value(1);
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(main_blocked && overlapped, "independent async compute tasks must not wait on the main queue");
+
+        app.device.destroy_buffer(main_buffer);
+        app.device.destroy_buffer(async_buffer);
+        app.device.collect_garbage();
+    }
+
+    void async_transfer()
+    {
+        // TEST:
+        //  1) Upload a value into a buffer in a transfer task
+        //  2) Copy it into a second slot in a general task on the main queue
+        //  3) Execute with the first transfer queue as async transfer queue
+        //  Expected result:
+        //      The copy on the main queue waits for the upload on the transfer queue.
+        AppContext app = {};
+        if (app.device.queue_count(daxa::QueueFamily::TRANSFER) == 0)
+        {
+            return;
+        }
+        constexpr daxa::u32 VALUE = 42;
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32) * 2,
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "async transfer buffer",
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .async_transfer_queue = daxa::QUEUE_TRANSFER_0,
+            .name = APPNAME_PREFIX("task_graph (async_transfer)"),
+        });
+        task_graph.use_persistent_buffer(task_buffer);
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                auto alloc = ti.allocator->allocate_fill(VALUE).value();
+                ti.recorder.copy_buffer_to_buffer({
+                    .src_buffer = ti.allocator->buffer(),
+                    .dst_buffer = ti.get(task_buffer).ids[0],
+                    .src_offset = alloc.buffer_offset,
+                    .size = sizeof(daxa::u32),
+                });
+            },
+            .name = APPNAME_PREFIX("upload (async_transfer)"),
+            .type = daxa::TaskType::TRANSFER,
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::READ_WRITE, task_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.copy_buffer_to_buffer({
+                    .src_buffer = ti.get(task_buffer).ids[0],
+                    .dst_buffer = ti.get(task_buffer).ids[0],
+                    .dst_offset = sizeof(daxa::u32),
+                    .size = sizeof(daxa::u32),
+                });
+            },
+            .name = APPNAME_PREFIX("copy (async_transfer)"),
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+
+        app.device.wait_idle();
+        daxa::u32 const * values = app.device.buffer_host_address_as<daxa::u32>(buffer).value();
+        DAXA_DBG_ASSERT_TRUE_M(values[0] == VALUE && values[1] == VALUE, "async transfer broke the ordering between queues");
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    void async_transfer_overlap()
+    {
+        // TEST:
+        //  1) Record a clear on the main queue, an upload as a transfer task and a copy of the uploaded value as a compute task
+        //  2) Submit them in one scope that waits on a timeline semaphore the host has not signaled yet
+        //  3) Execute with async transfer and async compute queues
+        //  Expected result:
+        //      The upload and the copy depend on nothing on the main queue and finish while it is blocked,
+        //      the compute queue waits on the transfer queue directly.
+        AppContext app = {};
+        if (app.device.queue_count(daxa::QueueFamily::TRANSFER) == 0 || app.device.queue_count(daxa::QueueFamily::COMPUTE) == 0)
+        {
+            return;
+        }
+        constexpr daxa::u32 VALUE = 42;
+        auto main_buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .name = "async transfer overlap main buffer",
+        });
+        auto upload_buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32) * 2,
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "async transfer overlap upload buffer",
+        });
+        std::memset(app.device.buffer_host_address(upload_buffer).value(), 0, sizeof(daxa::u32) * 2);
+        auto task_main_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&main_buffer, 1}}, .name = "main buffer"});
+        auto task_upload_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&upload_buffer, 1}}, .name = "upload buffer"});
+        auto gate = app.device.create_timeline_semaphore({.initial_value = 0, .name = "async transfer overlap gate"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .async_compute_queue = daxa::QUEUE_COMPUTE_0,
+            .async_transfer_queue = daxa::QUEUE_TRANSFER_0,
+            .name = APPNAME_PREFIX("task_graph (async_transfer_overlap)"),
+        });
+        task_graph.use_persistent_buffer(task_main_buffer);
+        task_graph.use_persistent_buffer(task_upload_buffer);
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_main_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_main_buffer).ids[0], .size = sizeof(daxa::u32), .clear_value = VALUE});
+            },
+            .name = APPNAME_PREFIX("clear on main queue (async_transfer_overlap)"),
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_upload_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                auto alloc = ti.allocator->allocate_fill(VALUE).value();
+                ti.recorder.copy_buffer_to_buffer({
+                    .src_buffer = ti.allocator->buffer(),
+                    .dst_buffer = ti.get(task_upload_buffer).ids[0],
+                    .src_offset = alloc.buffer_offset,
+                    .size = sizeof(daxa::u32),
+                });
+            },
+            .name = APPNAME_PREFIX("upload (async_transfer_overlap)"),
+            .type = daxa::TaskType::TRANSFER,
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::READ_WRITE, task_upload_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.copy_buffer_to_buffer({
+                    .src_buffer = ti.get(task_upload_buffer).ids[0],
+                    .dst_buffer = ti.get(task_upload_buffer).ids[0],
+                    .dst_offset = sizeof(daxa::u32),
+                    .size = sizeof(daxa::u32),
+                });
+            },
+            .name = APPNAME_PREFIX("copy on compute queue (async_transfer_overlap)"),
+            .type = daxa::TaskType::COMPUTE,
+        });
+        std::vector<std::pair<daxa::TimelineSemaphore, daxa::u64>> gate_waits = {{gate, 1}};
+        task_graph.submit({.additional_wait_timeline_semaphores = &gate_waits});
+        task_graph.complete({});
+        task_graph.execute({});
+
+        // The main queue waits on the gate, the transfer and compute queues must finish on their own.
+        daxa::u32 volatile const * values = app.device.buffer_host_address_as<daxa::u32>(upload_buffer).value();
+        bool overlapped = false;
+        for (daxa::u32 i = 0; i < 5000 && !overlapped; ++i)
+        {
+            overlapped = values[0] == VALUE && values[1] == VALUE;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        [[maybe_unused]] bool const main_blocked = gate.value() == 0;
+        gate.set_value(1);
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(main_blocked && overlapped, "uploads must only wait on the tasks they depend on, not on the main queue");
+
+        app.device.destroy_buffer(main_buffer);
+        app.device.destroy_buffer(upload_buffer);
+        app.device.collect_garbage();
+    }
+
+    void jit_permutations()
+    {
+        // TEST:
+        //  1) Record a conditional, both branches fill a transient buffer with a different value and copy it into a persistent buffer
+        //  2) Complete with jit compiled permutations and a cache of a single permutation
+        //  3) Execute the true, false and again the true permutation
+        //  Expected result:
+        //      Every execution compiles its permutation and evicts the previous one,
+        //      the persistent buffer holds the value of the branch executed last.
+        AppContext app = {};
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "jit permutations buffer",
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .jit_compile_permutations = true,
+            .jit_permutation_cache_size = 1,
+            .permutation_condition_count = 1,
+            .name = APPNAME_PREFIX("task_graph (jit_permutations)"),
+        });
+        task_graph.use_persistent_buffer(task_buffer);
+        auto record_branch = [&](daxa::u32 value)
+        {
+            auto transient = task_graph.create_transient_buffer({.size = sizeof(daxa::u32), .name = value == 1 ? "transient true" : "transient false"});
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, transient)},
+                .task = [=](daxa::TaskInterface const & ti)
+                {
+                    ti.recorder.clear_buffer({.buffer = ti.get(transient).ids[0], .size = sizeof(daxa::u32), .clear_value = value});
+                },
+                .name = APPNAME_PREFIX("fill transient (jit_permutations)"),
+            });
+            task_graph.add_task({
+                .attachments = {
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_READ, transient),
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer),
+                },
+                .task = [=](daxa::TaskInterface const & ti)
+                {
+                    ti.recorder.copy_buffer_to_buffer({
+                        .src_buffer = ti.get(transient).ids[0],
+                        .dst_buffer = ti.get(task_buffer).ids[0],
+                        .size = sizeof(daxa::u32),
+                    });
+                },
+                .name = APPNAME_PREFIX("copy transient (jit_permutations)"),
+            });
+        };
+        task_graph.conditional({
+            .condition_index = 0,
+            .when_true = [&]() { record_branch(1); },
+            .when_false = [&]() { record_branch(2); },
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+
+        for (bool condition : {true, false, true})
+        {
+            task_graph.execute({.permutation_condition_values = {&condition, 1}});
+            app.device.wait_idle();
+            daxa::u32 const value = *app.device.buffer_host_address_as<daxa::u32>(buffer).value();
+            DAXA_DBG_ASSERT_TRUE_M(value == (condition ? 1u : 2u), "jit compiled permutation executed the wrong branch");
+            app.device.collect_garbage();
+        }
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    void graph_patching()
+    {
+        // TEST:
+        //  1) Record a task filling a transient buffer, a task copying it into a persistent buffer and a leaf task overwriting the persistent buffer
+        //  2) Complete and execute, then grow the transient buffer, replace the fill callback and disable the leaf task
+        //  3) Execute again without recompleting
+        //  Expected result:
+        //      The first execution leaves the value of the leaf task, the second the value of the replaced fill callback.
+        AppContext app = {};
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "graph patching buffer",
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .name = APPNAME_PREFIX("task_graph (graph_patching)"),
+        });
+        task_graph.use_persistent_buffer(task_buffer);
+        auto transient = task_graph.create_transient_buffer({.size = sizeof(daxa::u32), .name = "transient"});
+        auto fill = [=](daxa::u32 value)
+        {
+            return [=](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(transient).ids[0], .size = sizeof(daxa::u32), .clear_value = value});
+            };
+        };
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, transient)},
+            .task = fill(1),
+            .name = APPNAME_PREFIX("fill transient (graph_patching)"),
+        });
+        task_graph.add_task({
+            .attachments = {
+                daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_READ, transient),
+                daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer),
+            },
+            .task = [=](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.copy_buffer_to_buffer({
+                    .src_buffer = ti.get(transient).ids[0],
+                    .dst_buffer = ti.get(task_buffer).ids[0],
+                    .size = sizeof(daxa::u32),
+                });
+            },
+            .name = APPNAME_PREFIX("copy transient (graph_patching)"),
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+            .task = [=](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_buffer).ids[0], .size = sizeof(daxa::u32), .clear_value = 3});
+            },
+            .name = APPNAME_PREFIX("overwrite buffer (graph_patching)"),
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+
+        task_graph.execute({});
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(buffer).value() == 3u, "leaf task did not overwrite the buffer");
+
+        daxa::usize const old_transient_size = task_graph.get_transient_memory_size();
+        task_graph.resize_transient_buffer(transient, 1024);
+        DAXA_DBG_ASSERT_TRUE_M(task_graph.get_transient_memory_size() >= 1024 && task_graph.get_transient_memory_size() > old_transient_size, "resized transient buffer was not placed again");
+        task_graph.set_task_callback(APPNAME_PREFIX("fill transient (graph_patching)"), fill(2));
+        task_graph.set_task_enabled(APPNAME_PREFIX("overwrite buffer (graph_patching)"), false);
+
+        task_graph.execute({});
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(buffer).value() == 2u, "patched task graph executed the old callback or the disabled task");
+        app.device.collect_garbage();
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    void gpu_profiling()
+    {
+        // TEST:
+        //  1) Record two dependent tasks into a graph with gpu profiling and occlusion queries enabled
+        //  2) Execute and wait for the device
+        //  Expected result:
+        //      get_timings resolves the execution and reports both tasks in two batches, both queried as they run on the main queue.
+        //      The execution trace contains both tasks.
+        AppContext app = {};
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .name = "gpu profiling buffer",
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .enable_gpu_profiling = true,
+            .gpu_profiling_occlusion = true,
+            .name = APPNAME_PREFIX("task_graph (gpu_profiling)"),
+        });
+        task_graph.use_persistent_buffer(task_buffer);
+        for (daxa::u32 value = 0; value < 2; ++value)
+        {
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+                .task = [=](daxa::TaskInterface const & ti)
+                {
+                    ti.recorder.clear_buffer({.buffer = ti.get(task_buffer).ids[0], .size = sizeof(daxa::u32), .clear_value = value});
+                },
+                .name = APPNAME_PREFIX("clear buffer (gpu_profiling)"),
+            });
+        }
+        task_graph.submit({});
+        task_graph.complete({});
+        DAXA_DBG_ASSERT_TRUE_M(task_graph.get_timings().execution_index == 0, "timings reported before any execution");
+
+        task_graph.execute({});
+        app.device.wait_idle();
+        auto const & timings = task_graph.get_timings();
+        DAXA_DBG_ASSERT_TRUE_M(timings.execution_index == 1, "finished execution was not resolved");
+        DAXA_DBG_ASSERT_TRUE_M(timings.tasks.size() == 2 && timings.batches.size() == 2, "timings do not match the recorded tasks");
+        DAXA_DBG_ASSERT_TRUE_M(timings.tasks[0].queried && timings.tasks[1].queried, "tasks on the main queue were not queried");
+        DAXA_DBG_ASSERT_TRUE_M(timings.tasks[0].samples_passed == 0, "clearing a buffer passed samples");
+        std::string const trace = task_graph.get_execution_trace();
+        DAXA_DBG_ASSERT_TRUE_M(trace.starts_with("{\"displayTimeUnit\"") && trace.find("clear buffer (gpu_profiling)") != std::string::npos, "execution trace is missing the tasks");
+        app.device.collect_garbage();
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    void dependency_graph_scheduling()
+    {
+        // TEST:
+        //  1) Record five tasks:
+        //      Task 0) Writes buffer A
+        //      Task 1) Writes buffer B
+        //      Task 2) Reads buffer B, writes buffer C
+        //      Task 3) Reads buffer C, reads buffer A
+        //      Task 4) Reads buffer A
+        //  2) Complete with dependency graph scheduling and execute
+        //  Expected result:
+        //      Greedy scheduling puts task 4 behind task 3, as task 3 is the latest reader of A.
+        //      Task 4 only depends on task 0, so it is rescheduled into the batch after task 0 and runs before task 3.
+        AppContext app = {};
+        std::array<daxa::BufferId, 3> buffers = {};
+        std::array<daxa::TaskBuffer, 3> task_buffers = {};
+        for (daxa::u32 i = 0; i < 3; ++i)
+        {
+            buffers[i] = app.device.create_buffer({.size = sizeof(daxa::u32), .name = "dependency graph buffer"});
+            task_buffers[i] = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffers[i], 1}}, .name = "buffer"});
+        }
+        auto & [a, b, c] = task_buffers;
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .scheduling = daxa::TaskGraphScheduling::DEPENDENCY_GRAPH,
+            .record_debug_information = true,
+            .name = APPNAME_PREFIX("task_graph (dependency_graph_scheduling)"),
+        });
+        for (auto & task_buffer : task_buffers)
+        {
+            task_graph.use_persistent_buffer(task_buffer);
+        }
+        std::vector<daxa::u32> callback_order = {};
+        auto record = [&](daxa::u32 index)
+        {
+            return [&callback_order, index](daxa::TaskInterface const &)
+            { callback_order.push_back(index); };
+        };
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_WRITE, a)},
+            .task = record(0),
+            .name = APPNAME_PREFIX("write A (dependency_graph_scheduling)"),
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_WRITE, b)},
+            .task = record(1),
+            .name = APPNAME_PREFIX("write B (dependency_graph_scheduling)"),
+        });
+        task_graph.add_task({
+            .attachments = {
+                daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_READ, b),
+                daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_WRITE, c),
+            },
+            .task = record(2),
+            .name = APPNAME_PREFIX("read B, write C (dependency_graph_scheduling)"),
+        });
+        task_graph.add_task({
+            .attachments = {
+                daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_READ, c),
+                daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_READ, a),
+            },
+            .task = record(3),
+            .name = APPNAME_PREFIX("read C, read A (dependency_graph_scheduling)"),
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::COMPUTE_SHADER_READ, a)},
+            .task = record(4),
+            .name = APPNAME_PREFIX("read A (dependency_graph_scheduling)"),
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+        std::cout << task_graph.get_debug_string() << std::endl;
+
+        auto position = [&](daxa::u32 index)
+        { return std::find(callback_order.begin(), callback_order.end(), index) - callback_order.begin(); };
+        DAXA_DBG_ASSERT_TRUE_M(callback_order.size() == 5, "every task must run once");
+        DAXA_DBG_ASSERT_TRUE_M(position(0) < position(4) && position(4) < position(3), "the read of A was not moved in front of the other reader");
+        DAXA_DBG_ASSERT_TRUE_M(position(2) < position(3), "rescheduling broke a dependency");
+
+        app.device.wait_idle();
+        for (auto buffer : buffers)
+        {
+            app.device.destroy_buffer(buffer);
+        }
+        app.device.collect_garbage();
+    }
+
+    void concurrent_executions()
+    {
+        // TEST:
+        //  1) Execute a graph with two execution contexts on a second thread, its task blocks while recording
+        //  2) Swap the buffer of the persistent task buffer and execute the graph again on this thread
+        //  3) Release the first execution once the second one recorded
+        //  Expected result:
+        //      Both executions record at the same time, each one writing the buffer it began with.
+        AppContext app = {};
+        std::array<daxa::BufferId, 2> buffers = {};
+        for (auto & buffer : buffers)
+        {
+            buffer = app.device.create_buffer({
+                .size = sizeof(daxa::u32),
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = "concurrent executions buffer",
+            });
+        }
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffers[0], 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .execution_context_count = 2,
+            .name = APPNAME_PREFIX("task_graph (concurrent_executions)"),
+        });
+        std::atomic<daxa::u32> recording_executions = 0;
+        task_graph.use_persistent_buffer(task_buffer);
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                daxa::BufferId const buffer = ti.get(task_buffer).ids[0];
+                auto alloc = ti.allocator->allocate_fill(buffer == buffers[0] ? 1u : 2u).value();
+                ti.recorder.copy_buffer_to_buffer({
+                    .src_buffer = ti.allocator->buffer(),
+                    .dst_buffer = buffer,
+                    .src_offset = alloc.buffer_offset,
+                    .size = sizeof(daxa::u32),
+                });
+                // The first execution only finishes recording once the second one recorded as well.
+                daxa::u32 const recording = ++recording_executions;
+                recording_executions.notify_all();
+                for (daxa::u32 value = recording; value < 2; value = recording_executions.load())
+                {
+                    recording_executions.wait(value);
+                }
+            },
+            .name = APPNAME_PREFIX("write (concurrent_executions)"),
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+
+        std::thread first_execution{[&]()
+                                    { task_graph.execute({}); }};
+        recording_executions.wait(0);
+        task_buffer.set_buffers({.buffers = {&buffers[1], 1}});
+        task_graph.execute({});
+        first_execution.join();
+
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(buffers[0]).value() == 1, "the first execution must write the buffer it began with");
+        DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(buffers[1]).value() == 2, "the second execution must write the swapped in buffer");
+        for (auto const & buffer : buffers)
+        {
+            app.device.destroy_buffer(buffer);
+        }
+        app.device.collect_garbage();
+    }
+
+    void steady_state_executions()
+    {
+        // TEST:
+        //  1) Execute a graph writing a persistent buffer twice a few times to warm up the execution scratch
+        //  2) Keep executing it
+        //  Expected result:
+        //      Executions after the warm up do not grow the scratch storage of execute.
+        AppContext app = {};
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32) * 2,
+            .name = "steady state executions buffer",
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "buffer"});
+
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .name = APPNAME_PREFIX("task_graph (steady_state_executions)"),
+        });
+        task_graph.use_persistent_buffer(task_buffer);
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_buffer).ids[0], .size = sizeof(daxa::u32), .clear_value = 1});
+            },
+            .name = APPNAME_PREFIX("write (steady_state_executions)"),
+        });
+        task_graph.add_task({
+            .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer)},
+            .task = [&](daxa::TaskInterface const & ti)
+            {
+                ti.recorder.clear_buffer({.buffer = ti.get(task_buffer).ids[0], .offset = sizeof(daxa::u32), .size = sizeof(daxa::u32), .clear_value = 2});
+            },
+            .name = APPNAME_PREFIX("overwrite (steady_state_executions)"),
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+
+        for (daxa::u32 execution = 0; execution < 4; ++execution)
+        {
+            task_graph.execute({});
+            app.device.collect_garbage();
+        }
+        daxa::u64 const warm_growth_count = task_graph.get_execution_scratch_growth_count();
+        for (daxa::u32 execution = 0; execution < 16; ++execution)
+        {
+            task_graph.execute({});
+            app.device.collect_garbage();
+        }
+        DAXA_DBG_ASSERT_TRUE_M(task_graph.get_execution_scratch_growth_count() == warm_growth_count, "executions after the warm up must not grow the execution scratch");
+
+        app.device.wait_idle();
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    struct TypedAccessTask : TypedAccessHead::Task
+    {
+        AttachmentViews views = {};
+        daxa::u32 * checked_attachments = {};
+        void callback(daxa::TaskInterface ti)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(&ti.get<AT.src>() == &ti.get(AT.src), "typed access must return the indexed attachment");
+            DAXA_DBG_ASSERT_TRUE_M(&ti.get<AT.dst1>() == &ti.get(AT.dst1), "typed access must return the indexed attachment");
+            DAXA_DBG_ASSERT_TRUE_M(&ti.get<AT.image>() == &ti.get(AT.image), "typed access must return the indexed attachment");
+            DAXA_DBG_ASSERT_TRUE_M(&ti.get(ti.get<AT.dst0>().view) == &ti.get<AT.dst0>(), "view lookup must find the attachment of the view");
+            DAXA_DBG_ASSERT_TRUE_M(&ti.get(ti.get<AT.dst1>().view) == &ti.get<AT.dst1>(), "view lookup must find the attachment of the view");
+            DAXA_DBG_ASSERT_TRUE_M(&ti.get(ti.get<AT.image>().view) == &ti.get<AT.image>(), "view lookup must find the attachment of the view");
+            *checked_attachments += 1;
+        }
+    };
+
+    // Layout of the AddressBlobHead blob on the shader side.
+    struct AddressBlob
+    {
+        daxa::BufferId ids[2];
+        daxa::DeviceAddress ptrs[2];
+        daxa::DeviceAddress ptr;
+    };
+
+    struct AddressBlobTask : AddressBlobHead::Task
+    {
+        AttachmentViews views = {};
+        AddressBlob * blob = {};
+        void callback(daxa::TaskInterface ti)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(ti.attachment_shader_blob.size() == sizeof(AddressBlob), "blob size must match the shader side layout");
+            std::memcpy(blob, ti.attachment_shader_blob.data(), sizeof(AddressBlob));
+        }
+    };
+
+    void attachment_blob_addresses()
+    {
+        // TEST:
+        //  1) Add a task with id array, pointer array and pointer attachments, each with its own runtime buffers
+        //  2) Copy the attachment shader blob in the callback
+        //  Expected result:
+        //      Id attachments hold the buffer ids, pointer attachments the device addresses resolved at record time.
+        AppContext app = {};
+        std::array<daxa::BufferId, 5> buffers = {};
+        for (auto & buffer : buffers)
+        {
+            buffer = app.device.create_buffer({.size = 4, .name = "address blob buffer"});
+        }
+        auto task_ids = daxa::TaskBuffer({.initial_buffers = {.buffers = std::span{buffers.data() + 0, 2}}, .name = "ids"});
+        auto task_ptrs = daxa::TaskBuffer({.initial_buffers = {.buffers = std::span{buffers.data() + 2, 2}}, .name = "ptrs"});
+        auto task_ptr = daxa::TaskBuffer({.initial_buffers = {.buffers = std::span{buffers.data() + 4, 1}}, .name = "ptr"});
+        AddressBlob blob = {};
+        {
+            auto task_graph = daxa::TaskGraph({
+                .device = app.device,
+                .name = APPNAME_PREFIX("task_graph (attachment_blob_addresses)"),
+            });
+            task_graph.use_persistent_buffer(task_ids);
+            task_graph.use_persistent_buffer(task_ptrs);
+            task_graph.use_persistent_buffer(task_ptr);
+            task_graph.add_task(AddressBlobTask{
+                .views = std::array{
+                    daxa::attachment_view(AddressBlobHead::AT.ids, task_ids),
+                    daxa::attachment_view(AddressBlobHead::AT.ptrs, task_ptrs),
+                    daxa::attachment_view(AddressBlobHead::AT.ptr, task_ptr),
+                },
+                .blob = &blob,
+            });
+            task_graph.submit({});
+            task_graph.complete({});
+            task_graph.execute({});
+        }
+        DAXA_DBG_ASSERT_TRUE_M(blob.ids[0] == buffers[0] && blob.ids[1] == buffers[1], "id arrays must hold the buffer ids");
+        DAXA_DBG_ASSERT_TRUE_M(blob.ptrs[0] == app.device.device_address(buffers[2]).value(), "pointer arrays must hold the buffer addresses");
+        DAXA_DBG_ASSERT_TRUE_M(blob.ptrs[1] == app.device.device_address(buffers[3]).value(), "pointer arrays must hold the buffer addresses");
+        DAXA_DBG_ASSERT_TRUE_M(blob.ptr == app.device.device_address(buffers[4]).value(), "pointers must hold the buffer address");
+        app.device.wait_idle();
+        for (auto const & buffer : buffers)
+        {
+            app.device.destroy_buffer(buffer);
+        }
+        app.device.collect_garbage();
+    }
+
+    void typed_attachment_access()
+    {
+        // TEST:
+        //  1) Add a task with a head of several attachments
+        //  2) Query every attachment by compile time index, runtime index and view
+        //  Expected result:
+        //      All queries resolve to the same attachment, across multiple executions.
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .name = APPNAME_PREFIX("task_graph (typed_attachment_access)"),
+        });
+        auto src = task_graph.create_transient_buffer({.size = 4, .name = "src"});
+        auto dst0 = task_graph.create_transient_buffer({.size = 4, .name = "dst0"});
+        auto dst1 = task_graph.create_transient_buffer({.size = 4, .name = "dst1"});
+        auto image = task_graph.create_transient_image({.size = {1, 1, 1}, .name = "image"});
+        daxa::u32 checked_attachments = 0;
+        task_graph.add_task(TypedAccessTask{
+            .views = std::array{
+                daxa::attachment_view(TypedAccessHead::AT.src, src),
+                daxa::attachment_view(TypedAccessHead::AT.dst0, dst0),
+                daxa::attachment_view(TypedAccessHead::AT.dst1, dst1),
+                daxa::attachment_view(TypedAccessHead::AT.image, image),
+            },
+            .checked_attachments = &checked_attachments,
+        });
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+        task_graph.execute({});
+        DAXA_DBG_ASSERT_TRUE_M(checked_attachments == 2, "the task must run once per execution");
+        app.device.wait_idle();
+        app.device.collect_garbage();
+    }
+
+    void mip_generation()
+    {
+        // TEST:
+        //  1) Clear the first mip of an image with four mips
+        //  2) Generate the remaining mips with one task
+        //  3) Copy the last mip to a host visible buffer
+        //  Expected result:
+        //      The uniform color of the first mip is filtered down to the last mip.
+        AppContext app = {};
+        auto image = app.device.create_image({
+            .size = {8, 8, 1},
+            .mip_level_count = 4,
+            .usage = daxa::ImageUsageFlagBits::TRANSFER_SRC | daxa::ImageUsageFlagBits::TRANSFER_DST,
+            .name = APPNAME_PREFIX("mip generation image"),
+        });
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = APPNAME_PREFIX("mip generation readback"),
+        });
+        auto task_image = daxa::TaskImage({.initial_images = {.images = {&image, 1}}, .name = "image"});
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "readback"});
+        daxa::TaskImageView const all_mips = task_image.view().view({.level_count = 4});
+        {
+            auto task_graph = daxa::TaskGraph({
+                .device = app.device,
+                .name = APPNAME_PREFIX("task_graph (mip_generation)"),
+            });
+            task_graph.use_persistent_image(task_image);
+            task_graph.use_persistent_buffer(task_buffer);
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskImageAccess::TRANSFER_WRITE, task_image.view())},
+                .task = [&](daxa::TaskInterface ti)
+                {
+                    ti.recorder.clear_image({
+                        .dst_image_layout = ti.get(task_image.view()).layout,
+                        .clear_value = std::array<daxa::f32, 4>{1.0f, 0.0f, 1.0f, 1.0f},
+                        .dst_image = image,
+                    });
+                },
+                .name = APPNAME_PREFIX("clear first mip"),
+            });
+            task_graph.add_mip_generation(all_mips);
+            daxa::TaskImageView const last_mip = task_image.view().view({.base_mip_level = 3});
+            task_graph.add_task({
+                .attachments = {
+                    daxa::inl_attachment(daxa::TaskImageAccess::TRANSFER_READ, last_mip),
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer),
+                },
+                .task = [&](daxa::TaskInterface ti)
+                {
+                    ti.recorder.copy_image_to_buffer({
+                        .image = image,
+                        .image_layout = ti.get(last_mip).layout,
+                        .image_slice = {.mip_level = 3},
+                        .image_extent = {1, 1, 1},
+                        .buffer = buffer,
+                    });
+                },
+                .name = APPNAME_PREFIX("read last mip"),
+            });
+            task_graph.submit({});
+            task_graph.complete({});
+            task_graph.execute({});
+        }
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(buffer).value() == 0xFFFF00FFu, "the last mip must hold the color of the first mip");
+        app.device.destroy_buffer(buffer);
+        app.device.destroy_image(image);
+        app.device.collect_garbage();
+    }
+
+    void gpu_arena_reset()
+    {
+        // TEST:
+        //  1) Create a transient gpu arena
+        //  2) Dirty the header in a task, simulating shader allocations
+        //  3) Execute the graph twice and copy the header to a host visible buffer after the reset
+        //  Expected result:
+        //      Every execution sees an empty arena with the rounded up capacity.
+        AppContext app = {};
+        auto buffer = app.device.create_buffer({
+            .size = sizeof(daxa_GpuArena),
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = APPNAME_PREFIX("gpu arena readback"),
+        });
+        auto task_buffer = daxa::TaskBuffer({.initial_buffers = {.buffers = {&buffer, 1}}, .name = "readback"});
+        {
+            auto task_graph = daxa::TaskGraph({
+                .device = app.device,
+                .name = APPNAME_PREFIX("task_graph (gpu_arena_reset)"),
+            });
+            task_graph.use_persistent_buffer(task_buffer);
+            daxa::TaskBufferView const arena = task_graph.create_transient_gpu_arena({
+                .capacity = 1000,
+                .name = "arena",
+            });
+            task_graph.add_task({
+                .attachments = {
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_READ, arena),
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, task_buffer),
+                },
+                .task = [&](daxa::TaskInterface ti)
+                {
+                    ti.recorder.copy_buffer_to_buffer({
+                        .src_buffer = ti.get(arena).ids[0],
+                        .dst_buffer = buffer,
+                        .size = sizeof(daxa_GpuArena),
+                    });
+                },
+                .name = APPNAME_PREFIX("read arena header"),
+            });
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, arena)},
+                .task = [&](daxa::TaskInterface ti)
+                {
+                    ti.recorder.clear_buffer({
+                        .buffer = ti.get(arena).ids[0],
+                        .size = sizeof(daxa_GpuArena),
+                        .clear_value = 0xFFFFFFFFu,
+                    });
+                },
+                .name = APPNAME_PREFIX("dirty arena header"),
+            });
+            task_graph.submit({});
+            task_graph.complete({});
+            for (daxa::u32 i = 0; i < 2; ++i)
+            {
+                task_graph.execute({});
+                app.device.wait_idle();
+                daxa_GpuArena const header = *app.device.buffer_host_address_as<daxa_GpuArena>(buffer).value();
+                DAXA_DBG_ASSERT_TRUE_M(header.offset == 0 && header.failed_allocation_count == 0, "arena must be reset every execution");
+                DAXA_DBG_ASSERT_TRUE_M(header.capacity == 1008, "arena capacity must be rounded up to the arena alignment");
+            }
+        }
+        app.device.destroy_buffer(buffer);
+        app.device.collect_garbage();
+    }
+
+    void gpu_scan_and_sort()
+    {
+        // TEST:
+        //  1) Scan values spanning many scan tiles with a GpuScan task
+        //  2) Sort keys with duplicates and their indices as values with a GpuSort task
+        //  Expected result:
+        //      The scan matches a cpu exclusive scan, the sort is ordered and stable.
+        AppContext app = {};
+        constexpr u32 COUNT = 100'000;
+        auto create_host_buffer = [&](char const * name)
+        {
+            return app.device.create_buffer({
+                .size = COUNT * sizeof(u32),
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = name,
+            });
+        };
+        auto scan_src = create_host_buffer("scan src");
+        auto scan_dst = create_host_buffer("scan dst");
+        auto keys = create_host_buffer("sort keys");
+        auto values = create_host_buffer("sort values");
+        u32 * scan_src_ptr = app.device.buffer_host_address_as<u32>(scan_src).value();
+        u32 * keys_ptr = app.device.buffer_host_address_as<u32>(keys).value();
+        u32 * values_ptr = app.device.buffer_host_address_as<u32>(values).value();
+        u32 rng = 12345;
+        for (u32 i = 0; i < COUNT; ++i)
+        {
+            rng = rng * 1664525u + 1013904223u;
+            scan_src_ptr[i] = i % 7;
+            keys_ptr[i] = rng % 1000;
+            values_ptr[i] = i;
+        }
+
+        auto task_scan_src = daxa::TaskBuffer({.initial_buffers = {.buffers = {&scan_src, 1}}, .name = "scan src"});
+        auto task_scan_dst = daxa::TaskBuffer({.initial_buffers = {.buffers = {&scan_dst, 1}}, .name = "scan dst"});
+        auto task_keys = daxa::TaskBuffer({.initial_buffers = {.buffers = {&keys, 1}}, .name = "sort keys"});
+        auto task_values = daxa::TaskBuffer({.initial_buffers = {.buffers = {&values, 1}}, .name = "sort values"});
+        {
+            auto const gpu_scan = daxa::GpuScan({.device = app.device, .name = APPNAME_PREFIX("gpu scan")});
+            auto const gpu_sort = daxa::GpuSort({.device = app.device, .name = APPNAME_PREFIX("gpu sort")});
+            auto task_graph = daxa::TaskGraph({
+                .device = app.device,
+                .name = APPNAME_PREFIX("task_graph (gpu_scan_and_sort)"),
+            });
+            task_graph.use_persistent_buffer(task_scan_src);
+            task_graph.use_persistent_buffer(task_scan_dst);
+            task_graph.use_persistent_buffer(task_keys);
+            task_graph.use_persistent_buffer(task_values);
+            gpu_scan.add_task(task_graph, {.src = task_scan_src, .dst = task_scan_dst, .count = COUNT});
+            gpu_sort.add_task(task_graph, {.keys = task_keys, .values = task_values, .count = COUNT, .key_bits = 10});
+            task_graph.submit({});
+            task_graph.complete({});
+            task_graph.execute({});
+            app.device.wait_idle();
+        }
+
+        u32 const * scan_dst_ptr = app.device.buffer_host_address_as<u32>(scan_dst).value();
+        u32 prefix = 0;
+        for (u32 i = 0; i < COUNT; ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(scan_dst_ptr[i] == prefix, "gpu scan must match the cpu exclusive scan");
+            prefix += i % 7;
+        }
+        for (u32 i = 1; i < COUNT; ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(keys_ptr[i - 1] <= keys_ptr[i], "gpu sort must order the keys");
+            DAXA_DBG_ASSERT_TRUE_M(keys_ptr[i - 1] != keys_ptr[i] || values_ptr[i - 1] < values_ptr[i], "gpu sort must be stable");
+        }
+
+        app.device.destroy_buffer(scan_src);
+        app.device.destroy_buffer(scan_dst);
+        app.device.destroy_buffer(keys);
+        app.device.destroy_buffer(values);
+        app.device.collect_garbage();
+    }
+
+    void gpu_draw_compaction()
+    {
+        // TEST:
+        //  1) Compact the draws of every third of many instances spread over a few materials with a GpuDrawCompaction task
+        //  Expected result:
+        //      Every material counts exactly its visible instances, each one appears once with its own draw arguments.
+        AppContext app = {};
+        constexpr u32 INSTANCE_COUNT = 10'000;
+        constexpr u32 MATERIAL_COUNT = 5;
+        constexpr u32 MAX_DRAWS_PER_MATERIAL = INSTANCE_COUNT;
+        auto create_host_buffer = [&](usize size, char const * name)
+        {
+            return app.device.create_buffer({
+                .size = size,
+                .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = name,
+            });
+        };
+        auto instances = create_host_buffer(INSTANCE_COUNT * sizeof(daxa_GpuDrawCompactionInstance), "instances");
+        auto visibility = create_host_buffer(INSTANCE_COUNT * sizeof(u32), "visibility");
+        auto draws = create_host_buffer(MATERIAL_COUNT * MAX_DRAWS_PER_MATERIAL * sizeof(daxa_DrawIndexedIndirectStruct), "draws");
+        auto counts = create_host_buffer(MATERIAL_COUNT * sizeof(u32), "counts");
+        auto * instances_ptr = app.device.buffer_host_address_as<daxa_GpuDrawCompactionInstance>(instances).value();
+        u32 * visibility_ptr = app.device.buffer_host_address_as<u32>(visibility).value();
+        std::array<u32, MATERIAL_COUNT> expected_counts = {};
+        for (u32 i = 0; i < INSTANCE_COUNT; ++i)
+        {
+            instances_ptr[i] = {.material = (i / 7) % MATERIAL_COUNT, .index_count = i * 3, .first_index = i, .vertex_offset = -static_cast<i32>(i)};
+            visibility_ptr[i] = (i % 3) == 0 ? 1 : 0;
+            expected_counts[instances_ptr[i].material] += visibility_ptr[i];
+        }
+
+        auto task_instances = daxa::TaskBuffer({.initial_buffers = {.buffers = {&instances, 1}}, .name = "instances"});
+        auto task_visibility = daxa::TaskBuffer({.initial_buffers = {.buffers = {&visibility, 1}}, .name = "visibility"});
+        auto task_draws = daxa::TaskBuffer({.initial_buffers = {.buffers = {&draws, 1}}, .name = "draws"});
+        auto task_counts = daxa::TaskBuffer({.initial_buffers = {.buffers = {&counts, 1}}, .name = "counts"});
+        {
+            auto const gpu_draw_compaction = daxa::GpuDrawCompaction({.device = app.device, .name = APPNAME_PREFIX("gpu draw compaction")});
+            auto task_graph = daxa::TaskGraph({
+                .device = app.device,
+                .name = APPNAME_PREFIX("task_graph (gpu_draw_compaction)"),
+            });
+            task_graph.use_persistent_buffer(task_instances);
+            task_graph.use_persistent_buffer(task_visibility);
+            task_graph.use_persistent_buffer(task_draws);
+            task_graph.use_persistent_buffer(task_counts);
+            gpu_draw_compaction.add_task(task_graph, {
+                                                         .instances = task_instances,
+                                                         .visibility = task_visibility,
+                                                         .draws = task_draws,
+                                                         .counts = task_counts,
+                                                         .instance_count = INSTANCE_COUNT,
+                                                         .material_count = MATERIAL_COUNT,
+                                                         .max_draws_per_material = MAX_DRAWS_PER_MATERIAL,
+                                                     });
+            task_graph.submit({});
+            task_graph.complete({});
+            task_graph.execute({});
+            app.device.wait_idle();
+        }
+
+        u32 const * counts_ptr = app.device.buffer_host_address_as<u32>(counts).value();
+        auto const * draws_ptr = app.device.buffer_host_address_as<daxa_DrawIndexedIndirectStruct>(draws).value();
+        std::vector<bool> drawn(INSTANCE_COUNT, false);
+        for (u32 material = 0; material < MATERIAL_COUNT; ++material)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(counts_ptr[material] == expected_counts[material], "gpu draw compaction must count the visible instances per material");
+            for (u32 slot = 0; slot < counts_ptr[material]; ++slot)
+            {
+                daxa_DrawIndexedIndirectStruct const & draw = draws_ptr[material * MAX_DRAWS_PER_MATERIAL + slot];
+                u32 const instance = draw.first_instance;
+                DAXA_DBG_ASSERT_TRUE_M(instance < INSTANCE_COUNT && !drawn[instance] && visibility_ptr[instance] != 0, "gpu draw compaction must draw each visible instance once");
+                DAXA_DBG_ASSERT_TRUE_M(instances_ptr[instance].material == material, "gpu draw compaction must draw instances with their material");
+                DAXA_DBG_ASSERT_TRUE_M(draw.index_count == instance * 3 && draw.first_index == instance && draw.vertex_offset == -static_cast<i32>(instance) && draw.instance_count == 1, "gpu draw compaction must copy the draw arguments");
+                drawn[instance] = true;
+            }
+        }
+
+        app.device.destroy_buffer(instances);
+        app.device.destroy_buffer(visibility);
+        app.device.destroy_buffer(draws);
+        app.device.destroy_buffer(counts);
+        app.device.collect_garbage();
+    }
 } //namespace tests
 
 auto main() -> i32
@@ -994,10 +2266,30 @@ auto main() -> i32
     tests::sharing_persistent_buffer();
     tests::transient_write_aliasing();
     tests::transient_resources();
+    tests::transient_memory_packing();
+    tests::shared_transient_memory_heap();
     tests::shader_integration_inl_use();
     tests::test_concurrent_read_write_buffer();
     tests::test_concurrent_read_write_image();
     tests::test_concurrent_read_write_buffer_cross_graphs();
     tests::mipmapping();
     tests::optional_attachments();
+    tests::merged_renderpasses();
+    tests::parallel_recording();
+    tests::async_compute();
+    tests::async_compute_overlap();
+    tests::async_transfer();
+    tests::async_transfer_overlap();
+    tests::jit_permutations();
+    tests::graph_patching();
+    tests::gpu_profiling();
+    tests::dependency_graph_scheduling();
+    tests::concurrent_executions();
+    tests::steady_state_executions();
+    tests::typed_attachment_access();
+    tests::attachment_blob_addresses();
+    tests::mip_generation();
+    tests::gpu_arena_reset();
+    tests::gpu_scan_and_sort();
+    tests::gpu_draw_compaction();
 }
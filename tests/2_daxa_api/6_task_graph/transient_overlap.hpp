@@ -544,4 +544,105 @@ namespace tests
         device.wait_idle();
         device.collect_garbage();
     }
+
+    void transient_memory_packing()
+    {
+        // TEST:
+        // 1. Create three equally sized transient buffers A, B and C.
+        // 2. Chain their lifetimes, so that only two are alive within any batch: A -> A,B -> B,C -> C.
+        // 3. Complete the graph.
+        // Expected result: C reuses the memory of A, the achieved size matches the peak alive lower bound of two buffers.
+
+        daxa::Instance daxa_ctx = daxa::create_instance({});
+        daxa::Device device = daxa_ctx.create_device_2(daxa_ctx.choose_device({},{}));
+        constexpr daxa::u32 BUFFER_SIZE = 64 * 1024;
+
+        {
+            auto task_graph = daxa::TaskGraph({
+                .device = device,
+                .reorder_tasks = false,
+                .name = "task_graph (transient_memory_packing)",
+            });
+            auto a = task_graph.create_transient_buffer({.size = BUFFER_SIZE, .name = "a"});
+            auto b = task_graph.create_transient_buffer({.size = BUFFER_SIZE, .name = "b"});
+            auto c = task_graph.create_transient_buffer({.size = BUFFER_SIZE, .name = "c"});
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, a)},
+                .task = [](daxa::TaskInterface) {},
+                .name = "write a",
+            });
+            task_graph.add_task({
+                .attachments = {
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_READ, a),
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, b),
+                },
+                .task = [](daxa::TaskInterface) {},
+                .name = "read a, write b",
+            });
+            task_graph.add_task({
+                .attachments = {
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_READ, b),
+                    daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, c),
+                },
+                .task = [](daxa::TaskInterface) {},
+                .name = "read b, write c",
+            });
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_READ, c)},
+                .task = [](daxa::TaskInterface) {},
+                .name = "read c",
+            });
+            task_graph.submit({});
+            task_graph.complete({});
+
+            DAXA_DBG_ASSERT_TRUE_M(task_graph.get_transient_memory_lower_bound() == 2 * BUFFER_SIZE, "peak alive transient memory must be two buffers");
+            DAXA_DBG_ASSERT_TRUE_M(task_graph.get_transient_memory_size() == task_graph.get_transient_memory_lower_bound(), "transient buffers must be packed into the lower bound");
+        }
+        device.wait_idle();
+        device.collect_garbage();
+    }
+
+    void shared_transient_memory_heap()
+    {
+        // TEST:
+        // 1. Create two task graphs sharing one transient memory heap, each with a differently sized transient buffer.
+        // 2. Complete both, then execute both.
+        // Expected result: the heap is sized to the larger graph, not to the sum of both.
+
+        daxa::Instance daxa_ctx = daxa::create_instance({});
+        daxa::Device device = daxa_ctx.create_device_2(daxa_ctx.choose_device({},{}));
+        auto heap = daxa::TransientMemoryHeap({.device = device, .name = "shared transient memory heap"});
+
+        auto make_task_graph = [&](daxa::u32 buffer_size, char const * name)
+        {
+            auto task_graph = daxa::TaskGraph({
+                .device = device,
+                .transient_memory_heap = heap,
+                .name = name,
+            });
+            auto buffer = task_graph.create_transient_buffer({.size = buffer_size, .name = "buffer"});
+            task_graph.add_task({
+                .attachments = {daxa::inl_attachment(daxa::TaskBufferAccess::TRANSFER_WRITE, buffer)},
+                .task = [=](daxa::TaskInterface ti)
+                {
+                    ti.recorder.clear_buffer({.buffer = ti.get(buffer).ids[0], .size = buffer_size, .clear_value = 1});
+                },
+                .name = "clear buffer",
+            });
+            task_graph.submit({});
+            task_graph.complete({});
+            return task_graph;
+        };
+        {
+            auto small_task_graph = make_task_graph(64 * 1024, "task_graph (shared_transient_memory_heap small)");
+            auto large_task_graph = make_task_graph(256 * 1024, "task_graph (shared_transient_memory_heap large)");
+            small_task_graph.execute({});
+            large_task_graph.execute({});
+
+            usize const expected_size = std::max(small_task_graph.get_transient_memory_size(), large_task_graph.get_transient_memory_size());
+            DAXA_DBG_ASSERT_TRUE_M(heap.size() == expected_size, "graphs sharing a heap must alias into one allocation");
+            device.wait_idle();
+        }
+        device.collect_garbage();
+    }
 } // namespace tests
@@ -134,6 +134,62 @@ namespace tests
         return 0;
     }
 
+    auto include_cache_perf(daxa::Device & device) -> i32
+    {
+        daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+            .device = device,
+            .shader_compile_options = {
+                .root_paths = {
+                    DAXA_SHADER_INCLUDE_DIR,
+                    DAXA_SAMPLE_PATH "/shaders",
+                    "tests/0_common/shaders",
+                },
+                .language = daxa::ShaderLanguage::GLSL,
+            },
+            .name = APPNAME_PREFIX("pipeline_manager"),
+        });
+
+        using Clock = std::chrono::high_resolution_clock;
+        auto compile = [&]() -> float
+        {
+            auto t0 = Clock::now();
+            auto compilation_result = pipeline_manager.add_compute_pipeline({
+                .shader_info = {.source = daxa::ShaderFile{"main.glsl"}},
+                .name = APPNAME_PREFIX("compute_pipeline"),
+            });
+            auto t1 = Clock::now();
+            if (compilation_result.is_err())
+            {
+                std::cerr << "Failed to compile the compute_pipeline!\n";
+                std::cerr << compilation_result.message() << std::endl;
+                return -1.0f;
+            }
+            pipeline_manager.remove_compute_pipeline(compilation_result.value());
+            return std::chrono::duration<float, std::milli>(t1 - t0).count();
+        };
+
+        // The first compile loads the includes from disk, the following ones take them from the include cache.
+        auto const cold_duration = compile();
+        if (cold_duration < 0.0f)
+        {
+            return -1;
+        }
+        auto warm_duration = 0.0f;
+        constexpr u32 WARM_COMPILE_COUNT = 50;
+        for (u32 i = 0; i < WARM_COMPILE_COUNT; ++i)
+        {
+            auto const duration = compile();
+            if (duration < 0.0f)
+            {
+                return -1;
+            }
+            warm_duration += duration;
+        }
+        std::cout << "Cold compile: " << cold_duration << "ms, warm compile: " << warm_duration / WARM_COMPILE_COUNT << "ms" << std::endl;
+
+        return 0;
+    }
+
     auto virtual_files(daxa::Device & device) -> i32
     {
         daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
@@ -287,6 +343,10 @@ auto main() -> int
     {
         return ret;
     }
+    if (ret = tests::include_cache_perf(device); ret != 0)
+    {
+        return ret;
+    }
     if (ret = tests::multi_thread(device); ret != 0)
     {
         return ret;
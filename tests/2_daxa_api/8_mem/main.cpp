@@ -2,8 +2,12 @@
 using namespace daxa::types;
 
 #include <daxa/utils/mem.hpp>
+#include <daxa/utils/meshlet.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 static inline constexpr usize ITERATION_COUNT = {1000};
 static inline constexpr usize ELEMENT_COUNT = {17};
@@ -90,6 +94,580 @@ auto main() -> int
         }
     }
     device.destroy_buffer(result_buffer);
+
+    {
+        // Thousands of small buffers share a single block, freed memory is reused after the gpu timeline passed the free.
+        daxa::BufferSuballocator suballocator{daxa::BufferSuballocatorInfo{
+            .device = device,
+            .block_size = 1 << 20,
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "buffer suballocator",
+        }};
+        std::vector<daxa::BufferSuballocator::Allocation> allocations = {};
+        for (u32 i = 0; i < 1024; ++i)
+        {
+            allocations.push_back(suballocator.allocate(200 + i % 56, 64).value());
+            if (allocations.back().buffer_offset % 64 != 0 || allocations.back().host_address == nullptr)
+            {
+                std::cout << "suballocation is misaligned or not host accessible" << std::endl;
+                return -1;
+            }
+        }
+        if (suballocator.block_count() != 1)
+        {
+            std::cout << "suballocations did not share a single block" << std::endl;
+            return -1;
+        }
+        suballocator.inc_timeline_value();
+        for (auto const & allocation : allocations)
+        {
+            suballocator.deferred_free(allocation);
+        }
+        device.submit_commands({
+            .signal_timeline_semaphores = std::array{std::pair{suballocator.timeline_semaphore(), suballocator.timeline_value()}},
+        });
+        device.wait_idle();
+        [[maybe_unused]] auto large_allocation = suballocator.allocate(1 << 20).value();
+        if (suballocator.block_count() != 1)
+        {
+            std::cout << "freed suballocations were not reused" << std::endl;
+            return -1;
+        }
+    }
+
+    {
+        // A growable pool places allocations that do not fit the ring in additional blocks, released once they stayed unused.
+        daxa::TransferMemoryPool growable_tmem{daxa::TransferMemoryPoolInfo{
+            .device = device,
+            .capacity = 256,
+            .name = "growable transfer memory pool",
+            .growable = true,
+            .growth_block_release_delay = 1,
+        }};
+        auto ring_allocation = growable_tmem.allocate(200).value();
+        auto growth_allocation = growable_tmem.allocate(200).value();
+        if (ring_allocation.buffer != growable_tmem.buffer() || growth_allocation.buffer == growable_tmem.buffer() || growable_tmem.growth_block_count() != 1)
+        {
+            std::cout << "growable pool did not place the overflowing allocation in an additional block" << std::endl;
+            return -1;
+        }
+        device.submit_commands({
+            .signal_timeline_semaphores = std::array{std::pair{growable_tmem.timeline_semaphore(), growable_tmem.inc_timeline_value()}},
+        });
+        device.wait_idle();
+        growable_tmem.inc_timeline_value();
+        if (growable_tmem.growth_block_count() != 0)
+        {
+            std::cout << "growable pool did not release the unused additional block" << std::endl;
+            return -1;
+        }
+    }
+
+    {
+        // Several threads allocate from one ring, each epoch is reclaimed as a whole after the gpu signaled it.
+        daxa::ConcurrentTransferMemoryPool concurrent_tmem{daxa::TransferMemoryPoolInfo{
+            .device = device,
+            .capacity = 1 << 12,
+            .name = "concurrent transfer memory pool",
+        }};
+        static constexpr u32 THREAD_COUNT = 4;
+        static constexpr u32 ALLOCATIONS_PER_THREAD = 16;
+        for (u32 epoch = 0; epoch < 8; ++epoch)
+        {
+            std::array<std::vector<daxa::ConcurrentTransferMemoryPool::Allocation>, THREAD_COUNT> thread_allocations = {};
+            std::vector<std::thread> threads = {};
+            for (u32 thread = 0; thread < THREAD_COUNT; ++thread)
+            {
+                threads.emplace_back([&, thread]()
+                                     {
+                    for (u32 i = 0; i < ALLOCATIONS_PER_THREAD; ++i)
+                    {
+                        thread_allocations[thread].push_back(concurrent_tmem.allocate_fill(thread * 1000 + i, 16).value());
+                    } });
+            }
+            for (auto & thread : threads)
+            {
+                thread.join();
+            }
+            std::vector<daxa::ConcurrentTransferMemoryPool::Allocation> allocations = {};
+            for (u32 thread = 0; thread < THREAD_COUNT; ++thread)
+            {
+                for (u32 i = 0; i < ALLOCATIONS_PER_THREAD; ++i)
+                {
+                    auto const & allocation = thread_allocations[thread][i];
+                    if (*reinterpret_cast<u32 const *>(allocation.host_address) != thread * 1000 + i || allocation.buffer_offset % 16 != 0)
+                    {
+                        std::cout << "concurrent allocation was overwritten or misaligned" << std::endl;
+                        return -1;
+                    }
+                    allocations.push_back(allocation);
+                }
+            }
+            std::sort(allocations.begin(), allocations.end(), [](auto const & a, auto const & b)
+                      { return a.buffer_offset < b.buffer_offset; });
+            for (usize i = 1; i < allocations.size(); ++i)
+            {
+                if (allocations[i - 1].buffer_offset + allocations[i - 1].size > allocations[i].buffer_offset)
+                {
+                    std::cout << "concurrent allocations overlap" << std::endl;
+                    return -1;
+                }
+            }
+            device.submit_commands({
+                .signal_timeline_semaphores = std::array{std::pair{concurrent_tmem.timeline_semaphore(), concurrent_tmem.inc_timeline_value()}},
+            });
+            device.wait_idle();
+        }
+    }
+
+    {
+        // Epochs end while other threads allocate. The host signals every ended epoch but the latest,
+        // allocations must stay untouched until the timeline reaches the value they were handed out with.
+        daxa::ConcurrentTransferMemoryPool concurrent_tmem{daxa::TransferMemoryPoolInfo{
+            .device = device,
+            .capacity = 1 << 10,
+            .name = "concurrent epoch transfer memory pool",
+        }};
+        static constexpr u32 THREAD_COUNT = 4;
+        static constexpr u32 ALLOCATIONS_PER_THREAD = 1024;
+        daxa::TimelineSemaphore timeline = concurrent_tmem.timeline_semaphore();
+        std::atomic_uint32_t finished_threads = {};
+        std::atomic_bool reclaimed_too_early = {};
+        std::vector<std::thread> threads = {};
+        for (u32 thread = 0; thread < THREAD_COUNT; ++thread)
+        {
+            threads.emplace_back([&, thread]()
+                                 {
+                for (u32 i = 0; i < ALLOCATIONS_PER_THREAD; ++i)
+                {
+                    auto allocation = concurrent_tmem.allocate(sizeof(u32), 16);
+                    while (!allocation.has_value())
+                    {
+                        std::this_thread::yield();
+                        allocation = concurrent_tmem.allocate(sizeof(u32), 16);
+                    }
+                    u32 const value = thread * ALLOCATIONS_PER_THREAD + i;
+                    std::atomic_ref<u32> memory{*reinterpret_cast<u32 *>(allocation->host_address)};
+                    memory.store(value, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                    // The memory is read before the timeline, a legal reuse would have raised the timeline first.
+                    u32 const read_back = memory.load(std::memory_order_relaxed);
+                    if (read_back != value && timeline.value() < allocation->timeline_index)
+                    {
+                        reclaimed_too_early = true;
+                    }
+                }
+                finished_threads.fetch_add(1); });
+        }
+        while (finished_threads.load() != THREAD_COUNT)
+        {
+            usize const ended_timeline_value = concurrent_tmem.inc_timeline_value();
+            timeline.set_value(ended_timeline_value - 1);
+        }
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+        if (reclaimed_too_early)
+        {
+            std::cout << "concurrent pool reclaimed an allocation before its timeline value was reached" << std::endl;
+            return -1;
+        }
+    }
+
+    {
+        // The gpu writes into the readback ring, the host reads the result without blocking once the gpu is done.
+        daxa::ReadbackMemoryPool readback{daxa::ReadbackMemoryPoolInfo{
+            .device = device,
+            .capacity = 256,
+            .name = "readback memory pool",
+        }};
+        for (u32 frame = 0; frame < 64; ++frame)
+        {
+            auto allocation = readback.allocate(sizeof(u32)).value();
+            if (frame % 3 == 0)
+            {
+                // Skipped timeline values must not confuse the release of older allocations.
+                readback.inc_timeline_value();
+            }
+            daxa::CommandRecorder cmd = device.create_command_recorder({});
+            cmd.clear_buffer({
+                .buffer = readback.buffer(),
+                .offset = allocation.buffer_offset,
+                .size = sizeof(u32),
+                .clear_value = frame,
+            });
+            cmd.pipeline_barrier({
+                .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+                .dst_access = daxa::AccessConsts::HOST_READ,
+            });
+            device.submit_commands({
+                .command_lists = std::array{cmd.complete_current_commands()},
+                .signal_timeline_semaphores = std::array{std::pair{readback.timeline_semaphore(), readback.timeline_value()}},
+            });
+            device.wait_idle();
+            if (readback.try_read_as<u32>(allocation) != frame)
+            {
+                std::cout << "readback returned the wrong value" << std::endl;
+                return -1;
+            }
+            readback.release(allocation);
+        }
+    }
+
+    {
+        // Uploads from many threads are staged concurrently and submitted together with one flush.
+        daxa::UploadQueue upload_queue{daxa::UploadQueueInfo{
+            .device = device,
+            .staging_capacity = 1 << 16,
+            .name = "upload queue",
+        }};
+        static constexpr u32 THREAD_COUNT = 4;
+        static constexpr u32 VALUES_PER_THREAD = 1024;
+        daxa::BufferId upload_target = device.create_buffer({
+            .size = sizeof(u32) * THREAD_COUNT * VALUES_PER_THREAD,
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "upload target",
+        });
+        std::vector<std::thread> threads = {};
+        for (u32 thread = 0; thread < THREAD_COUNT; ++thread)
+        {
+            threads.emplace_back([&, thread]()
+                                 {
+                for (u32 i = 0; i < VALUES_PER_THREAD; ++i)
+                {
+                    u32 const value = thread * VALUES_PER_THREAD + i;
+                    upload_queue.upload_buffer(upload_target, sizeof(u32) * value, std::as_bytes(std::span{&value, 1}));
+                } });
+        }
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+        daxa::UploadToken const token = upload_queue.flush();
+        upload_queue.wait(token);
+        if (!upload_queue.is_complete(token))
+        {
+            std::cout << "upload token did not complete" << std::endl;
+            return -1;
+        }
+        u32 const * uploaded = device.buffer_host_address_as<u32>(upload_target).value();
+        for (u32 value = 0; value < THREAD_COUNT * VALUES_PER_THREAD; ++value)
+        {
+            if (uploaded[value] != value)
+            {
+                std::cout << "uploaded value " << value << " is wrong" << std::endl;
+                return -1;
+            }
+        }
+        device.destroy_buffer(upload_target);
+    }
+
+    {
+        // Bar memory is written by the host and read by the gpu without a staging copy, it falls back to host memory without bar.
+        std::cout << "device local host visible heap: " << device.properties().device_local_host_visible_heap_size << " bytes" << std::endl;
+        daxa::BufferId bar_buffer = device.create_buffer({
+            .size = sizeof(u32),
+            .allocate_info = daxa::MemoryFlagBits::PREFER_DEVICE_LOCAL_HOST_VISIBLE,
+            .name = "bar buffer",
+        });
+        daxa::BufferId bar_readback = device.create_buffer({
+            .size = sizeof(u32),
+            .allocate_info = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "bar readback",
+        });
+        *device.buffer_host_address_as<u32>(bar_buffer).value() = 0xBA2u;
+        daxa::CommandRecorder cmd = device.create_command_recorder({});
+        cmd.copy_buffer_to_buffer({
+            .src_buffer = bar_buffer,
+            .dst_buffer = bar_readback,
+            .size = sizeof(u32),
+        });
+        cmd.pipeline_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .dst_access = daxa::AccessConsts::HOST_READ,
+        });
+        device.submit_commands({.command_lists = std::array{cmd.complete_current_commands()}});
+        device.wait_idle();
+        if (*device.buffer_host_address_as<u32>(bar_readback).value() != 0xBA2u)
+        {
+            std::cout << "host write to bar memory was not visible to the gpu" << std::endl;
+            return -1;
+        }
+        device.destroy_buffer(bar_buffer);
+        device.destroy_buffer(bar_readback);
+    }
+
+    {
+        // Timestamps are copied into a readback buffer on the gpu, results are read once the frame timeline passed the frame.
+        daxa::TimelineSemaphore frame_timeline = device.create_timeline_semaphore({.name = "gpu timer frame timeline"});
+        daxa::GpuTimer gpu_timer{daxa::GpuTimerInfo{
+            .device = device,
+            .frame_timeline = frame_timeline,
+            .frame_count = 2,
+            .timestamps_per_frame = 2,
+            .name = "gpu timer",
+        }};
+        for (u64 frame = 1; frame <= 4; ++frame)
+        {
+            daxa::CommandRecorder cmd = device.create_command_recorder({});
+            if (!gpu_timer.begin_frame(cmd, frame))
+            {
+                std::cout << "gpu timer slot of frame " << frame << " was still in flight" << std::endl;
+                return -1;
+            }
+            [[maybe_unused]] auto const begin = gpu_timer.write_timestamp(cmd);
+            [[maybe_unused]] auto const end = gpu_timer.write_timestamp(cmd);
+            if (gpu_timer.write_timestamp(cmd).has_value())
+            {
+                std::cout << "gpu timer wrote more timestamps than timestamps_per_frame" << std::endl;
+                return -1;
+            }
+            gpu_timer.end_frame(cmd);
+            device.submit_commands({
+                .command_lists = std::array{cmd.complete_current_commands()},
+                .signal_timeline_semaphores = std::array{std::pair{frame_timeline, frame}},
+            });
+            [[maybe_unused]] auto _timeout = frame_timeline.wait_for_value(frame);
+            auto const results = gpu_timer.results(frame);
+            if (!results.has_value() || results->size() != 2 || results.value()[1] < results.value()[0])
+            {
+                std::cout << "gpu timer results of frame " << frame << " are wrong" << std::endl;
+                return -1;
+            }
+            if (frame > 2 && gpu_timer.results(frame - 2).has_value())
+            {
+                std::cout << "gpu timer returned results of a reused slot" << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    {
+        // Messages are written by the host here, as a shader would. The count past the capacity is reported as dropped.
+        daxa::TimelineSemaphore frame_timeline = device.create_timeline_semaphore({.name = "shader debug frame timeline"});
+        daxa::ShaderDebugRing debug_ring{daxa::ShaderDebugRingInfo{
+            .device = device,
+            .frame_timeline = frame_timeline,
+            .frame_count = 2,
+            .message_capacity = 2,
+            .name = "shader debug ring",
+        }};
+        std::byte * ring = device.buffer_host_address(debug_ring.buffer()).value();
+        u32 const written_count = 3;
+        std::memcpy(ring, &written_count, sizeof(u32));
+        // The messages follow the 16 byte header, which is half a message.
+        auto * ring_messages = reinterpret_cast<daxa::ShaderDebugMessage *>(ring + 16);
+        ring_messages[0] = {.type = daxa::ShaderDebugMessageType::ASSERT, .id = 7, .line = 42, .args = {1, 2, 3, 4}};
+        ring_messages[1] = {.type = daxa::ShaderDebugMessageType::PRINTF, .id = 8, .line = 43};
+        for (u64 frame = 1; frame <= 2; ++frame)
+        {
+            daxa::CommandRecorder cmd = device.create_command_recorder({});
+            debug_ring.record_readback(cmd, frame);
+            device.submit_commands({
+                .command_lists = std::array{cmd.complete_current_commands()},
+                .signal_timeline_semaphores = std::array{std::pair{frame_timeline, frame}},
+            });
+            [[maybe_unused]] auto _timeout = frame_timeline.wait_for_value(frame);
+            auto const messages = debug_ring.drain();
+            usize const expected_count = frame == 1 ? 2 : 0;
+            if (messages.size() != expected_count || debug_ring.dropped_message_count() != 1)
+            {
+                std::cout << "shader debug ring drained the wrong messages in frame " << frame << std::endl;
+                return -1;
+            }
+            if (frame == 1 && (messages[0].id != 7 || messages[0].line != 42 || messages[0].args[3] != 4 || messages[1].type != daxa::ShaderDebugMessageType::PRINTF))
+            {
+                std::cout << "shader debug ring messages were not read back intact" << std::endl;
+                return -1;
+            }
+        }
+
+        // Only destroying the active ring clears the address of the device.
+        {
+            std::optional<daxa::ShaderDebugRing> older_ring = daxa::ShaderDebugRing{daxa::ShaderDebugRingInfo{
+                .device = device,
+                .frame_timeline = frame_timeline,
+                .frame_count = 1,
+                .message_capacity = 1,
+                .name = "older shader debug ring",
+            }};
+            daxa::ShaderDebugRing active_ring{daxa::ShaderDebugRingInfo{
+                .device = device,
+                .frame_timeline = frame_timeline,
+                .frame_count = 1,
+                .message_capacity = 1,
+                .name = "active shader debug ring",
+            }};
+            daxa::DeviceAddress const active_address = device.buffer_device_address(active_ring.buffer()).value();
+            older_ring.reset();
+            if (device.shader_debug_address() != active_address)
+            {
+                std::cout << "destroying an inactive shader debug ring changed the ring address" << std::endl;
+                return -1;
+            }
+        }
+        if (device.shader_debug_address() != 0)
+        {
+            std::cout << "destroying the active shader debug ring left its address set" << std::endl;
+            return -1;
+        }
+    }
+
+    {
+        // The mip tail is resident after the first update, requested mips are added to a new image within the upload budget.
+        daxa::TimelineSemaphore frame_timeline = device.create_timeline_semaphore({.name = "texture streamer frame timeline"});
+        daxa::TextureStreamer streamer{daxa::TextureStreamerInfo{
+            .device = device,
+            .frame_timeline = frame_timeline,
+            .frame_count = 2,
+            .max_texture_count = 16,
+            .upload_budget = 64 * 64 * 4,
+            .staging_capacity = 1 << 20,
+            .name = "texture streamer",
+        }};
+        std::vector<u32> loaded_mips = {};
+        u32 const texture = streamer.create_texture({
+            .size = {256, 256, 1},
+            .mip_level_count = 9,
+            .mip_tail_extent = 64,
+            .load_mip = [&](u32 mip_level, std::span<std::byte> dst)
+            {
+                std::memset(dst.data(), static_cast<int>(mip_level), dst.size());
+                loaded_mips.push_back(mip_level);
+                return true;
+            },
+            .name = "streamed texture",
+        });
+        auto update = [&](u64 frame) -> u32
+        {
+            daxa::CommandRecorder cmd = device.create_command_recorder({});
+            u32 const uploaded_mips = streamer.record_updates(cmd);
+            streamer.record_feedback(cmd, frame);
+            device.submit_commands({
+                .command_lists = std::array{cmd.complete_current_commands()},
+                .signal_timeline_semaphores = std::array{std::pair{streamer.timeline_semaphore(), streamer.timeline_value()}, std::pair{frame_timeline, frame}},
+            });
+            [[maybe_unused]] auto _timeout = frame_timeline.wait_for_value(frame);
+            return uploaded_mips;
+        };
+        if (update(1) != 7 || streamer.view(texture).first_mip != 2 || streamer.view(texture).mip_count != 7)
+        {
+            std::cout << "texture streamer did not upload the mip tail" << std::endl;
+            return -1;
+        }
+        // Mip 1 exceeds the upload budget of the second update, it is uploaded alone as the first mip of the call.
+        streamer.request_mip(texture, 0);
+        if (update(2) != 1 || streamer.view(texture).first_mip != 1 || update(3) != 1 || streamer.view(texture).first_mip != 0)
+        {
+            std::cout << "texture streamer did not stream in the requested mips" << std::endl;
+            return -1;
+        }
+        if (loaded_mips.size() != 9 || streamer.resident_memory() == 0)
+        {
+            std::cout << "texture streamer loaded mips more than once" << std::endl;
+            return -1;
+        }
+        streamer.destroy_texture(texture);
+        update(4);
+        if (streamer.resident_memory() != 0 || !streamer.view(texture).view.is_empty())
+        {
+            std::cout << "texture streamer did not release the destroyed texture" << std::endl;
+            return -1;
+        }
+    }
+
+    if ((device.properties().implicit_features & daxa::ImplicitFeatureFlagBits::MEMORY_DECOMPRESSION) != daxa::ImplicitFeatureFlagBits::NONE)
+    {
+        // An image upload that does not fit must leave the staging memory free, so a following smaller upload still fits.
+        // The page is not valid GDeflate, so the recorded commands are never submitted.
+        daxa::GpuDecompressionUploader uploader{daxa::GpuDecompressionUploaderInfo{
+            .device = device,
+            .staging_capacity = 256,
+            .name = "gpu decompression uploader",
+        }};
+        daxa::ImageId const image = device.create_image({
+            .format = daxa::Format::R8G8B8A8_UNORM,
+            .size = {8, 8, 1},
+            .usage = daxa::ImageUsageFlagBits::TRANSFER_DST,
+            .name = "gpu decompression image",
+        });
+        daxa::BufferId const buffer = device.create_buffer({
+            .size = 256,
+            .name = "gpu decompression buffer",
+        });
+        std::array<std::byte, 64> const compressed = {};
+        auto const pages = std::array{daxa::CompressedPage{.compressed = compressed, .decompressed_size = 256}};
+        daxa::CommandRecorder recorder = device.create_command_recorder({});
+        if (uploader.upload_image(recorder, image, {}, pages))
+        {
+            std::cout << "gpu decompression image upload exceeding the staging memory succeeded" << std::endl;
+            return -1;
+        }
+        if (!uploader.upload_buffer(recorder, buffer, 0, pages))
+        {
+            std::cout << "failed gpu decompression image upload kept its staging memory" << std::endl;
+            return -1;
+        }
+        device.destroy_image(image);
+        device.destroy_buffer(buffer);
+    }
+
+    {
+        // Meshlets of a grid, built in many jobs, must reproduce the index buffer in order.
+        constexpr u32 GRID_SIZE = 64;
+        std::vector<daxa_f32vec3> positions = {};
+        std::vector<u32> indices = {};
+        for (u32 y = 0; y <= GRID_SIZE; ++y)
+        {
+            for (u32 x = 0; x <= GRID_SIZE; ++x)
+            {
+                positions.push_back({static_cast<f32>(x), static_cast<f32>(y), 0.0f});
+            }
+        }
+        for (u32 y = 0; y < GRID_SIZE; ++y)
+        {
+            for (u32 x = 0; x < GRID_SIZE; ++x)
+            {
+                u32 const corner = y * (GRID_SIZE + 1) + x;
+                indices.insert(indices.end(), {corner, corner + 1, corner + GRID_SIZE + 1, corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1});
+            }
+        }
+        daxa::MeshletBuildResult const result = daxa::build_meshlets({
+            .indices = indices,
+            .positions = positions,
+            .triangles_per_job = 1000,
+        });
+        std::vector<u32> rebuilt_indices = {};
+        for (daxa_Meshlet const & meshlet : result.meshlets)
+        {
+            if (meshlet.vertex_count > DAXA_MESHLET_MAX_VERTICES || meshlet.triangle_count > DAXA_MESHLET_MAX_TRIANGLES)
+            {
+                std::cout << "meshlet exceeds the vertex or triangle limit" << std::endl;
+                return -1;
+            }
+            for (u32 triangle = 0; triangle < meshlet.triangle_count; ++triangle)
+            {
+                u32 const packed = result.triangles[meshlet.triangle_offset + triangle];
+                for (u32 corner = 0; corner < 3; ++corner)
+                {
+                    rebuilt_indices.push_back(result.vertices[meshlet.vertex_offset + ((packed >> (corner * 8)) & 0xFF)]);
+                }
+            }
+        }
+        if (rebuilt_indices != indices)
+        {
+            std::cout << "meshlets do not reproduce the index buffer" << std::endl;
+            return -1;
+        }
+        // All triangles of the flat grid face +z, so the cones are as narrow as possible.
+        if (result.bounds[0].cone_axis.z < 0.99f || result.bounds[0].cone_cutoff > 0.01f)
+        {
+            std::cout << "meshlet normal cone is wrong" << std::endl;
+            return -1;
+        }
+    }
+
     device.collect_garbage();
     std::cout << std::flush;
 }
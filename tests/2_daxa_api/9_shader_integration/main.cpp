@@ -1,8 +1,11 @@
 #include <iostream>
+#include <algorithm>
+#include <bit>
 
 #include <daxa/daxa.hpp>
 #include <daxa/utils/pipeline_manager.hpp>
 #include <daxa/utils/task_graph.hpp>
+#include <daxa/utils/mem.hpp>
 
 #include <0_common/window.hpp>
 
@@ -283,6 +286,116 @@ namespace tests
         task_graph.execute({});
         device.destroy_sampler(sampler);
     }
+
+    auto shader_debug() -> bool
+    {
+        // TEST:
+        //  1) dispatch a glsl and a slang shader that call daxa_printf and daxa_assert.
+        //  2) read the messages back through the shader debug ring.
+        //  3) validate that every message landed in its own slot with its arguments.
+        daxa::Instance daxa_ctx = daxa::create_instance({});
+        daxa::Device device = daxa_ctx.create_device_2(daxa_ctx.choose_device({},{}));
+        daxa::TimelineSemaphore frame_timeline = device.create_timeline_semaphore({.name = "shader debug frame timeline"});
+        daxa::ShaderDebugRing debug_ring{daxa::ShaderDebugRingInfo{
+            .device = device,
+            .frame_timeline = frame_timeline,
+            .frame_count = 2,
+            .message_capacity = 16,
+            .name = "shader debug ring",
+        }};
+
+        daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+            .device = device,
+            .shader_compile_options = {
+                .root_paths = {
+                    DAXA_SHADER_INCLUDE_DIR,
+                    "tests/2_daxa_api/9_shader_integration/shaders",
+                },
+            },
+            .name = "pipeline manager",
+        });
+
+        struct ShaderSource
+        {
+            std::string_view file = {};
+            std::string_view entry_point = {};
+            daxa::ShaderLanguage language = {};
+        };
+        std::array const sources = {
+            ShaderSource{"shader_debug.glsl", "main", daxa::ShaderLanguage::GLSL},
+            ShaderSource{"shader_debug.slang", "entry_shader_debug", daxa::ShaderLanguage::SLANG},
+        };
+        u64 frame = 0;
+        for (auto const & source : sources)
+        {
+            auto compile_result = pipeline_manager.add_compute_pipeline({
+                .shader_info = {
+                    .source = daxa::ShaderFile{source.file},
+                    .compile_options{
+                        .entry_point = std::string{source.entry_point},
+                        .language = source.language,
+                    },
+                },
+                .push_constant_size = sizeof(ShaderDebugTestPush),
+                .name = std::string{source.file},
+            });
+            if (compile_result.is_err())
+            {
+                std::cout << compile_result.message() << std::endl;
+                return false;
+            }
+            auto pipeline = compile_result.value();
+
+            ++frame;
+            u32 const failing_thread = 2;
+            daxa::CommandRecorder recorder = device.create_command_recorder({});
+            recorder.set_pipeline(*pipeline);
+            recorder.push_constant(ShaderDebugTestPush{.failing_thread = failing_thread});
+            recorder.dispatch({1, 1, 1});
+            debug_ring.record_readback(recorder, frame);
+            device.submit_commands({
+                .command_lists = std::array{recorder.complete_current_commands()},
+                .signal_timeline_semaphores = std::array{std::pair{frame_timeline, frame}},
+            });
+            bool const finished = frame_timeline.wait_for_value(frame);
+            if (!finished)
+            {
+                std::cout << source.file << ": timed out waiting for the frame" << std::endl;
+                return false;
+            }
+
+            auto const messages = debug_ring.drain();
+            std::array<u32, SHADER_DEBUG_TEST_THREAD_COUNT> printf_counts = {};
+            u32 assert_count = 0;
+            for (auto const & message : messages)
+            {
+                if (message.type == daxa::ShaderDebugMessageType::PRINTF && message.id == SHADER_DEBUG_TEST_PRINTF_ID &&
+                    message.args[0] < SHADER_DEBUG_TEST_THREAD_COUNT && std::bit_cast<f32>(message.args[1]) == 0.5f)
+                {
+                    ++printf_counts[message.args[0]];
+                }
+                else if (message.type == daxa::ShaderDebugMessageType::ASSERT && message.id == SHADER_DEBUG_TEST_ASSERT_ID &&
+                         message.args[0] == failing_thread && message.line != 0)
+                {
+                    ++assert_count;
+                }
+                else
+                {
+                    std::cout << source.file << ": unexpected message of id " << message.id << " in line " << message.line << std::endl;
+                    return false;
+                }
+            }
+            // A message overwritten by another thread would leave a thread without its printf.
+            bool const all_printed = std::ranges::all_of(printf_counts, [](u32 count)
+                                                         { return count == 1; });
+            if (messages.size() != SHADER_DEBUG_TEST_THREAD_COUNT + 1 || !all_printed || assert_count != 1)
+            {
+                std::cout << source.file << ": read back " << messages.size() << " messages, expected one printf per thread and one failed assert" << std::endl;
+                return false;
+            }
+        }
+        return debug_ring.dropped_message_count() == 0;
+    }
 } // namespace tests
 
 auto main() -> int
@@ -290,4 +403,8 @@ auto main() -> int
     tests::aligned_types_templates();
     tests::alignment();
     tests::bindless_handles();
+    if (!tests::shader_debug())
+    {
+        return -1;
+    }
 }
@@ -0,0 +1,15 @@
+#include <daxa/daxa.inl>
+#include "shared.inl"
+
+DAXA_DECL_PUSH_CONSTANT(ShaderDebugTestPush, push)
+
+layout(local_size_x = SHADER_DEBUG_TEST_THREAD_COUNT) in;
+void main()
+{
+    const daxa_u32 thread = gl_LocalInvocationIndex;
+    // Every thread writes a message, the ring atomic must hand out a distinct slot to each of them.
+    daxa_printf(SHADER_DEBUG_TEST_PRINTF_ID, daxa_u32vec4(thread, floatBitsToUint(0.5f), 0, 0));
+    daxa_assert_args(thread != push.failing_thread, SHADER_DEBUG_TEST_ASSERT_ID, daxa_u32vec4(thread, 0, 0, 0));
+    // Passing assertions write nothing.
+    daxa_assert(thread < SHADER_DEBUG_TEST_THREAD_COUNT, SHADER_DEBUG_TEST_ASSERT_ID);
+}
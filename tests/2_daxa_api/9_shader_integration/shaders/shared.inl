@@ -100,4 +100,15 @@ DAXA_DECL_BUFFER_PTR(Handles)
 struct BindlessTestFollowPush
 {
     daxa_BufferPtr(Handles) shader_input;
-};
\ No newline at end of file
+};
+
+// Ids the shader debug test shaders pass to daxa_printf and daxa_assert.
+#define SHADER_DEBUG_TEST_PRINTF_ID 1
+#define SHADER_DEBUG_TEST_ASSERT_ID 2
+#define SHADER_DEBUG_TEST_THREAD_COUNT 4
+
+struct ShaderDebugTestPush
+{
+    // The thread whose assertion fails.
+    daxa_u32 failing_thread;
+};
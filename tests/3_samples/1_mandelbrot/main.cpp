@@ -124,9 +124,12 @@ struct App : BaseApp<App>
         if (daxa::get_if<daxa::PipelineReloadSuccess>(&reloaded_result))
             std::cout << "Successfully reloaded!\n";
 
-        ui_update();
+        if (!gpu_benchmark().enabled())
+        {
+            ui_update();
+        }
 
-        auto swapchain_image = swapchain.acquire_next_image();
+        auto swapchain_image = acquire_next_image();
         task_swapchain_image.set_images({.images = std::array{swapchain_image}});
         if (swapchain_image.is_empty())
         {
@@ -134,9 +137,10 @@ struct App : BaseApp<App>
         }
         loop_task_graph.execute({});
         device.collect_garbage();
+        gpu_benchmark().collect(loop_task_graph, "loop");
 
         auto query_results = timeline_query_pool.get_query_results(0, 2);
-        if ((query_results[1] != 0u) && (query_results[3] != 0u))
+        if (!gpu_benchmark().enabled() && (query_results[1] != 0u) && (query_results[3] != 0u))
         {
             std::cout << "gpu execution took " << static_cast<f64>(query_results[2] - query_results[0]) / 1000000.0 << " ms" << std::endl;
         }
@@ -250,8 +254,9 @@ struct App : BaseApp<App>
     }
 };
 
-auto main() -> int
+auto main(int argc, char const * const * argv) -> int
 {
+    gpu_benchmark().parse_args(argc, argv);
     App app = {};
     while (true)
     {
@@ -260,4 +265,8 @@ auto main() -> int
             break;
         }
     }
+    if (gpu_benchmark().enabled())
+    {
+        gpu_benchmark().report(std::cout);
+    }
 }
@@ -68,7 +68,8 @@ inline daxa_f32vec3 operator/(daxa_f32vec3 a, daxa_f32vec3 b)
 struct App : BaseApp<App>
 {
     bool my_toggle = true;
-    bool simulate = false;
+    // Benchmark runs simulate every frame.
+    bool simulate = gpu_benchmark().enabled();
     camera cam = {};
     daxa::TlasId tlas = {};
     daxa::BlasId blas = {};
@@ -489,9 +490,12 @@ struct App : BaseApp<App>
         if (daxa::get_if<daxa::PipelineReloadSuccess>(&reloaded_result))
             std::cout << "Successfully reloaded!\n";
 
-        ui_update();
+        if (!gpu_benchmark().enabled())
+        {
+            ui_update();
+        }
 
-        auto swapchain_image = swapchain.acquire_next_image();
+        auto swapchain_image = acquire_next_image();
         task_swapchain_image.set_images({.images = std::array{swapchain_image}});
         if (swapchain_image.is_empty())
         {
@@ -512,6 +516,7 @@ struct App : BaseApp<App>
         build_accel_structs();
         loop_task_graph.execute({});
         device.collect_garbage();
+        gpu_benchmark().collect(loop_task_graph, "loop");
     }
 
     void on_mouse_move(f32 /*unused*/, f32 /*unused*/) {}
@@ -694,6 +699,7 @@ struct App : BaseApp<App>
         daxa::TaskGraph input_task_graph = daxa::TaskGraph({
             .device = device,
             .use_split_barriers = false,
+            .enable_gpu_profiling = gpu_benchmark().enabled(),
             .name = "input_task_graph",
         });
 
@@ -764,6 +770,7 @@ struct App : BaseApp<App>
         daxa::TaskGraph sim_task_graph = daxa::TaskGraph({
             .device = device,
             .use_split_barriers = false,
+            .enable_gpu_profiling = gpu_benchmark().enabled(),
             .name = "sim_task_graph",
         });
 
@@ -904,6 +911,7 @@ struct App : BaseApp<App>
     void update_input_task()
     {
         _input_task_graph.execute({});
+        gpu_benchmark().collect(_input_task_graph, "input");
     }
 
     void update_sim() {
@@ -911,6 +919,7 @@ struct App : BaseApp<App>
             _sim_task_graph.execute({});
         }
         device.wait_idle();
+        gpu_benchmark().collect(_sim_task_graph, "sim");
     }
 
     void build_accel_structs() {  
@@ -1128,8 +1137,9 @@ struct App : BaseApp<App>
     }
 };
 
-auto main() -> int
+auto main(int argc, char const * const * argv) -> int
 {
+    gpu_benchmark().parse_args(argc, argv);
     App app = {};
     app.particle_set_position();
     app.gpu_status->flags = 0;
@@ -1146,4 +1156,8 @@ auto main() -> int
             break;
         }
     }
+    if (gpu_benchmark().enabled())
+    {
+        gpu_benchmark().report(std::cout);
+    }
 }
@@ -1,4 +1,5 @@
 #include <0_common/window.hpp>
+#include <0_common/gpu_benchmark.hpp>
 #include <thread>
 #include <iostream>
 #include <cmath>
@@ -42,13 +43,20 @@ struct App : AppWindow<App>
     daxa::Instance daxa_ctx = daxa::create_instance({});
     daxa::Device device = daxa_ctx.create_device_2(daxa_ctx.choose_device({},{}));
 
-    daxa::Swapchain swapchain = device.create_swapchain({
+    daxa::Swapchain swapchain = gpu_benchmark().enabled() ? daxa::Swapchain{} : device.create_swapchain({
         .native_window = get_native_handle(),
         .native_window_platform = get_native_platform(),
         .present_mode = daxa::PresentMode::FIFO,
         .image_usage = daxa::ImageUsageFlagBits::TRANSFER_DST,
         .name = ("swapchain"),
     });
+    // Takes the place of the swapchain images in benchmark mode.
+    daxa::ImageId offscreen_image = !gpu_benchmark().enabled() ? daxa::ImageId{} : device.create_image({
+        .format = daxa::Format::B8G8R8A8_UNORM,
+        .size = {size_x, size_y, 1},
+        .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT,
+        .name = ("offscreen image"),
+    });
 
     daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
         .device = device,
@@ -67,7 +75,7 @@ struct App : AppWindow<App>
     std::shared_ptr<daxa::RasterPipeline> draw_pipeline = pipeline_manager.add_raster_pipeline({
         .vertex_shader_info = daxa::ShaderCompileInfo{.source = daxa::ShaderFile{"vert.glsl"}},
         .fragment_shader_info = daxa::ShaderCompileInfo{.source = daxa::ShaderFile{"frag.glsl"}},
-        .color_attachments = {{.format = swapchain.get_format()}},
+        .color_attachments = {{.format = gpu_benchmark().enabled() ? device.image_info(offscreen_image).value().format : swapchain.get_format()}},
         .raster = {},
         .push_constant_size = sizeof(DrawPushConstant),
         .name = ("draw_pipeline"),
@@ -97,7 +105,7 @@ struct App : AppWindow<App>
         .name = ("boids buffer b"),
     });
 
-    daxa::TaskImage task_swapchain_image{{.swapchain_image = true, .name = "swapchain image"}};
+    daxa::TaskImage task_swapchain_image{{.swapchain_image = !gpu_benchmark().enabled(), .name = "swapchain image"}};
     daxa::TaskBuffer task_boids_current{{.initial_buffers = {.buffers = {&boid_buffer, 1}}, .name = "task_boids_current"}};
     daxa::TaskBuffer task_boids_old{{.initial_buffers = {.buffers = {&old_boid_buffer, 1}}, .name = "task_boids_old"}};
 
@@ -105,7 +113,7 @@ struct App : AppWindow<App>
 
     daxa::TaskGraph task_graph = record_tasks();
 
-    App() : AppWindow<App>("boids")
+    App() : AppWindow<App>("boids", 800, 600, gpu_benchmark().enabled())
     {
         auto recorder = device.create_command_recorder({.name = ("boid buffer init commands")});
 
@@ -155,6 +163,10 @@ struct App : AppWindow<App>
     {
         device.destroy_buffer(boid_buffer);
         device.destroy_buffer(old_boid_buffer);
+        if (gpu_benchmark().enabled())
+        {
+            device.destroy_image(offscreen_image);
+        }
     }
 
     // Draw task:
@@ -203,6 +215,13 @@ struct App : AppWindow<App>
 
     auto update() -> bool
     {
+        if (gpu_benchmark().enabled())
+        {
+            draw();
+            gpu_benchmark().end_frame();
+            return gpu_benchmark().finished();
+        }
+
         glfwPollEvents();
         if (glfwWindowShouldClose(glfw_window_ptr) != 0)
         {
@@ -224,7 +243,13 @@ struct App : AppWindow<App>
 
     auto record_tasks() -> daxa::TaskGraph
     {
-        daxa::TaskGraph new_task_graph = daxa::TaskGraph({.device = device, .swapchain = swapchain, .name = ("main task graph")});
+        bool const benchmark = gpu_benchmark().enabled();
+        daxa::TaskGraph new_task_graph = daxa::TaskGraph({
+            .device = device,
+            .swapchain = benchmark ? std::nullopt : std::optional{swapchain},
+            .enable_gpu_profiling = benchmark,
+            .name = ("main task graph"),
+        });
         new_task_graph.use_persistent_image(task_swapchain_image);
         new_task_graph.use_persistent_buffer(task_boids_current);
         new_task_graph.use_persistent_buffer(task_boids_old);
@@ -246,7 +271,10 @@ struct App : AppWindow<App>
             .size_y = &size_y,
         });
         new_task_graph.submit({});
-        new_task_graph.present({});
+        if (!benchmark)
+        {
+            new_task_graph.present({});
+        }
         new_task_graph.complete({});
         return new_task_graph;
     }
@@ -266,7 +294,7 @@ struct App : AppWindow<App>
             std::cout << "Successfully reloaded!\n";
         }
 
-        auto swapchain_image = swapchain.acquire_next_image();
+        auto swapchain_image = gpu_benchmark().enabled() ? offscreen_image : swapchain.acquire_next_image();
         task_swapchain_image.set_images({.images = {&swapchain_image, 1}});
         if (swapchain_image.is_empty())
         {
@@ -276,6 +304,7 @@ struct App : AppWindow<App>
         // Switch boids front and back buffers.
         task_boids_current.swap_buffers(task_boids_old);
         device.collect_garbage();
+        gpu_benchmark().collect(task_graph, "main");
     }
 
     void on_mouse_move(f32 /*unused*/, f32 /*unused*/) {}
@@ -296,8 +325,9 @@ struct App : AppWindow<App>
     }
 };
 
-auto main() -> int
+auto main(int argc, char const * const * argv) -> int
 {
+    gpu_benchmark().parse_args(argc, argv);
     App app = {};
     while (true)
     {
@@ -306,4 +336,8 @@ auto main() -> int
             break;
         }
     }
+    if (gpu_benchmark().enabled())
+    {
+        gpu_benchmark().report(std::cout);
+    }
 }